@@ -11,19 +11,95 @@
 #include "api/audio/audio_frame.h"
 
 #include <string.h>
-#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_counter.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_base/time_utils.h"
 
 namespace webrtc {
 
-AudioFrame::AudioFrame() {
-  // Visual Studio doesn't like this in the class definition.
+// Holds the samples of one or more AudioFrames. Buffers are handed out by
+// Create() and go back to a process-wide pool when the last reference is
+// released, so frames created and destroyed every 10 ms do not allocate.
+class AudioFrame::Buffer {
+ public:
+  static rtc::scoped_refptr<Buffer> Create();
+
+  void AddRef() const { ref_count_.IncRef(); }
+  rtc::RefCountReleaseStatus Release() const;
+  bool HasOneRef() const { return ref_count_.HasOneRef(); }
+
+  int16_t* data() { return data_; }
+
+ private:
+  class Pool;
+
+  Buffer() = default;
+
+  mutable webrtc_impl::RefCounter ref_count_{0};
+  int16_t data_[kMaxDataSizeSamples];
+};
+
+class AudioFrame::Buffer::Pool {
+ public:
+  // Enough for the transient frames of a few hundred streams, at 15 kB each.
+  static constexpr size_t kMaxFreeBuffers = 64;
+
+  static Pool* Get() {
+    static Pool* const pool = new Pool();
+    return pool;
+  }
+
+  Buffer* Take() {
+    {
+      rtc::CritScope lock(&crit_);
+      if (!free_buffers_.empty()) {
+        Buffer* buffer = free_buffers_.back();
+        free_buffers_.pop_back();
+        return buffer;
+      }
+    }
+    return new Buffer();
+  }
+
+  void Return(Buffer* buffer) {
+    {
+      rtc::CritScope lock(&crit_);
+      if (free_buffers_.size() < kMaxFreeBuffers) {
+        free_buffers_.push_back(buffer);
+        return;
+      }
+    }
+    delete buffer;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  std::vector<Buffer*> free_buffers_ RTC_GUARDED_BY(crit_);
+};
+
+// static
+rtc::scoped_refptr<AudioFrame::Buffer> AudioFrame::Buffer::Create() {
   static_assert(sizeof(data_) == kMaxDataSizeBytes, "kMaxDataSizeBytes");
+  return rtc::scoped_refptr<Buffer>(Pool::Get()->Take());
 }
 
+rtc::RefCountReleaseStatus AudioFrame::Buffer::Release() const {
+  const auto status = ref_count_.DecRef();
+  if (status == rtc::RefCountReleaseStatus::kDroppedLastRef) {
+    Pool::Get()->Return(const_cast<Buffer*>(this));
+  }
+  return status;
+}
+
+AudioFrame::AudioFrame() = default;
+
+AudioFrame::~AudioFrame() = default;
+
 void swap(AudioFrame& a, AudioFrame& b) {
   using std::swap;
   swap(a.timestamp_, b.timestamp_);
@@ -37,11 +113,7 @@ void swap(AudioFrame& a, AudioFrame& b) {
   swap(a.vad_activity_, b.vad_activity_);
   swap(a.profile_timestamp_ms_, b.profile_timestamp_ms_);
   swap(a.packet_infos_, b.packet_infos_);
-  const size_t length_a = a.samples_per_channel_ * a.num_channels_;
-  const size_t length_b = b.samples_per_channel_ * b.num_channels_;
-  RTC_DCHECK_LE(length_a, AudioFrame::kMaxDataSizeSamples);
-  RTC_DCHECK_LE(length_b, AudioFrame::kMaxDataSizeSamples);
-  std::swap_ranges(a.data_, a.data_ + std::max(length_a, length_b), b.data_);
+  swap(a.buffer_, b.buffer_);
   swap(a.muted_, b.muted_);
   swap(a.absolute_capture_timestamp_ms_, b.absolute_capture_timestamp_ms_);
 }
@@ -89,7 +161,7 @@ void AudioFrame::UpdateFrame(uint32_t timestamp,
   const size_t length = samples_per_channel * num_channels;
   RTC_CHECK_LE(length, kMaxDataSizeSamples);
   if (data != nullptr) {
-    memcpy(data_, data, sizeof(int16_t) * length);
+    memcpy(UnsharedData(0), data, sizeof(int16_t) * length);
     muted_ = false;
   } else {
     muted_ = true;
@@ -104,7 +176,6 @@ void AudioFrame::CopyFrom(const AudioFrame& src) {
   elapsed_time_ms_ = src.elapsed_time_ms_;
   ntp_time_ms_ = src.ntp_time_ms_;
   packet_infos_ = src.packet_infos_;
-  muted_ = src.muted();
   samples_per_channel_ = src.samples_per_channel_;
   sample_rate_hz_ = src.sample_rate_hz_;
   speech_type_ = src.speech_type_;
@@ -113,11 +184,14 @@ void AudioFrame::CopyFrom(const AudioFrame& src) {
   channel_layout_ = src.channel_layout_;
   absolute_capture_timestamp_ms_ = src.absolute_capture_timestamp_ms();
 
-  const size_t length = samples_per_channel_ * num_channels_;
-  RTC_CHECK_LE(length, kMaxDataSizeSamples);
-  if (!src.muted()) {
-    memcpy(data_, src.data(), sizeof(int16_t) * length);
-    muted_ = false;
+  RTC_CHECK_LE(samples_per_channel_ * num_channels_, kMaxDataSizeSamples);
+  ShareDataFrom(src);
+}
+
+void AudioFrame::ShareDataFrom(const AudioFrame& src) {
+  muted_ = src.muted();
+  if (!muted_) {
+    buffer_ = src.buffer_;
   }
 }
 
@@ -134,17 +208,19 @@ int64_t AudioFrame::ElapsedProfileTimeMs() const {
 }
 
 const int16_t* AudioFrame::data() const {
-  return muted_ ? empty_data() : data_;
+  return muted_ ? empty_data() : buffer_->data();
 }
 
 // TODO(henrik.lundin) Can we skip zeroing the buffer?
 // See https://bugs.chromium.org/p/webrtc/issues/detail?id=5647.
 int16_t* AudioFrame::mutable_data() {
   if (muted_) {
-    memset(data_, 0, kMaxDataSizeBytes);
+    int16_t* data = UnsharedData(0);
+    memset(data, 0, kMaxDataSizeBytes);
     muted_ = false;
+    return data;
   }
-  return data_;
+  return UnsharedData(samples_per_channel_ * num_channels_);
 }
 
 void AudioFrame::Mute() {
@@ -155,6 +231,19 @@ bool AudioFrame::muted() const {
   return muted_;
 }
 
+int16_t* AudioFrame::UnsharedData(size_t samples_to_keep) {
+  if (buffer_ && buffer_->HasOneRef()) {
+    return buffer_->data();
+  }
+  rtc::scoped_refptr<Buffer> buffer = Buffer::Create();
+  if (buffer_ && samples_to_keep > 0) {
+    RTC_DCHECK_LE(samples_to_keep, kMaxDataSizeSamples);
+    memcpy(buffer->data(), buffer_->data(), sizeof(int16_t) * samples_to_keep);
+  }
+  buffer_ = std::move(buffer);
+  return buffer_->data();
+}
+
 // static
 const int16_t* AudioFrame::empty_data() {
   static int16_t* null_data = new int16_t[kMaxDataSizeSamples]();
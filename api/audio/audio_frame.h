@@ -18,6 +18,7 @@
 
 #include "api/audio/channel_layout.h"
 #include "api/rtp_packet_infos.h"
+#include "api/scoped_refptr.h"
 #include "rtc_base/constructor_magic.h"
 
 namespace webrtc {
@@ -32,6 +33,11 @@ namespace webrtc {
  *   should be prepared for that.
  * - The total number of samples is samples_per_channel_ * num_channels_.
  * - Stereo data is interleaved starting with the left channel.
+ * - The samples live in a reference counted buffer taken from a process-wide
+ *   pool. CopyFrom(), ShareDataFrom() and swap() only move references, and
+ *   the samples are copied when a frame sharing its buffer calls
+ *   mutable_data(). Pointers returned by data() and mutable_data() are
+ *   therefore only valid until the next non-const call on the frame.
  */
 class AudioFrame {
  public:
@@ -59,6 +65,7 @@ class AudioFrame {
   };
 
   AudioFrame();
+  ~AudioFrame();
 
   friend void swap(AudioFrame& a, AudioFrame& b);
 
@@ -80,6 +87,10 @@ class AudioFrame {
 
   void CopyFrom(const AudioFrame& src);
 
+  // Makes this frame refer to the samples and mute state of |src|, without
+  // copying the samples or any of the other fields.
+  void ShareDataFrom(const AudioFrame& src);
+
   // Sets a wall-time clock timestamp in milliseconds to be used for profiling
   // of time between two points in the audio chain.
   // Example:
@@ -92,8 +103,9 @@ class AudioFrame {
   int64_t ElapsedProfileTimeMs() const;
 
   // data() returns a zeroed static buffer if the frame is muted.
-  // mutable_frame() always returns a non-static buffer; the first call to
-  // mutable_frame() zeros the non-static buffer and marks the frame unmuted.
+  // mutable_frame() always returns a non-static buffer that is not shared with
+  // any other frame; the first call to mutable_frame() zeros the non-static
+  // buffer and marks the frame unmuted.
   const int16_t* data() const;
   int16_t* mutable_data();
 
@@ -155,12 +167,20 @@ class AudioFrame {
   RtpPacketInfos packet_infos_;
 
  private:
+  class Buffer;
+
+  // Returns the samples of an unshared buffer, taking one from the pool if
+  // needed. The first |samples_to_keep| samples of the current buffer are
+  // copied into it.
+  int16_t* UnsharedData(size_t samples_to_keep);
+
   // A permanently zeroed out buffer to represent muted frames. This is a
   // header-only class, so the only way to avoid creating a separate empty
   // buffer per translation unit is to wrap a static in an inline function.
   static const int16_t* empty_data();
 
-  int16_t data_[kMaxDataSizeSamples];
+  // Null until the frame is first written to.
+  rtc::scoped_refptr<Buffer> buffer_;
   bool muted_ = true;
 
   // Absolute capture timestamp when this audio frame was originally captured.
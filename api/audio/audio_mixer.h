@@ -13,6 +13,7 @@
 
 #include <memory>
 
+#include "absl/types/optional.h"
 #include "api/audio/audio_frame.h"
 #include "rtc_base/ref_count.h"
 
@@ -48,6 +49,13 @@ class AudioMixer : public rtc::RefCountInterface {
     // with this sample rate or higher will not cause quality loss.
     virtual int PreferredSampleRate() const = 0;
 
+    // A cheap estimate of how loud the source's next audio will be, such as
+    // the level of the last received audio level RTP header extension
+    // (RFC 6464), so that a mixer can skip asking quiet sources for audio. The
+    // level is in -dBov, from 0 (loudest) to 127 (silence). Returns nullopt if
+    // unknown.
+    virtual absl::optional<int> AudioLevelHint() const { return absl::nullopt; }
+
     virtual ~Source() {}
   };
 
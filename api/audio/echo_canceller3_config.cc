@@ -265,6 +265,8 @@ bool EchoCanceller3Config::Validate(EchoCanceller3Config* config) {
 
   res = res & Limit(&c->suppressor.floor_first_increase, 0.f, 1000000.f);
 
+  res = res & Limit(&c->multi_channel.num_capture_threads, 1, 16);
+
   return res;
 }
 }  // namespace webrtc
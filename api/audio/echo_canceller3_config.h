@@ -221,6 +221,13 @@ struct RTC_EXPORT EchoCanceller3Config {
 
     float floor_first_increase = 0.00001f;
   } suppressor;
+
+  struct MultiChannel {
+    // Number of threads, including the capture thread, that the independent
+    // per-channel work of the linear filters is spread over. Only worth
+    // raising above 1 for capture arrays with many microphones.
+    size_t num_capture_threads = 1;
+  } multi_channel;
 };
 }  // namespace webrtc
 
@@ -382,6 +382,11 @@ void Aec3ConfigFromJsonString(absl::string_view json_string,
     ReadParam(section, "floor_first_increase",
               &cfg.suppressor.floor_first_increase);
   }
+
+  if (rtc::GetValueFromJsonObject(aec3_root, "multi_channel", &section)) {
+    ReadParam(section, "num_capture_threads",
+              &cfg.multi_channel.num_capture_threads);
+  }
 }
 
 EchoCanceller3Config Aec3ConfigFromJsonString(absl::string_view json_string) {
@@ -673,6 +678,11 @@ std::string Aec3ConfigToJsonString(const EchoCanceller3Config& config) {
       << config.suppressor.high_bands_suppression.anti_howling_gain;
   ost << "},";
   ost << "\"floor_first_increase\": " << config.suppressor.floor_first_increase;
+  ost << "},";
+
+  ost << "\"multi_channel\": {";
+  ost << "\"num_capture_threads\": "
+      << config.multi_channel.num_capture_threads;
   ost << "}";
   ost << "}";
   ost << "}";
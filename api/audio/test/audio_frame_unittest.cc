@@ -133,6 +133,59 @@ TEST(AudioFrameTest, CopyFrom) {
   EXPECT_EQ(0, memcmp(frame2.data(), frame1.data(), sizeof(samples)));
 }
 
+TEST(AudioFrameTest, CopyFromSharesSamplesUntilWritten) {
+  AudioFrame frame1;
+  AudioFrame frame2;
+
+  int16_t samples[kNumChannelsMono * kSamplesPerChannel];
+  for (size_t i = 0; i < kNumChannelsMono * kSamplesPerChannel; ++i) {
+    samples[i] = i;
+  }
+  frame2.UpdateFrame(kTimestamp, samples, kSamplesPerChannel, kSampleRateHz,
+                     AudioFrame::kPLC, AudioFrame::kVadActive,
+                     kNumChannelsMono);
+  frame1.CopyFrom(frame2);
+  EXPECT_EQ(frame2.data(), frame1.data());
+
+  // Writing to either frame leaves the other one unchanged.
+  frame1.mutable_data()[0] = 1000;
+  EXPECT_NE(frame2.data(), frame1.data());
+  EXPECT_EQ(1000, frame1.data()[0]);
+  EXPECT_EQ(0, frame2.data()[0]);
+  EXPECT_EQ(0, memcmp(samples + 1, frame1.data() + 1,
+                      sizeof(samples) - sizeof(samples[0])));
+
+  frame1.CopyFrom(frame2);
+  frame2.mutable_data()[1] = 2000;
+  EXPECT_EQ(1, frame1.data()[1]);
+  EXPECT_EQ(2000, frame2.data()[1]);
+}
+
+TEST(AudioFrameTest, ShareDataFromKeepsOtherFields) {
+  AudioFrame frame1;
+  AudioFrame frame2;
+
+  int16_t samples[kNumChannelsMono * kSamplesPerChannel] = {17};
+  frame2.UpdateFrame(kTimestamp, samples, kSamplesPerChannel, kSampleRateHz,
+                     AudioFrame::kPLC, AudioFrame::kVadActive,
+                     kNumChannelsMono);
+  frame1.UpdateFrame(kTimestamp + 1, nullptr /* data */, kSamplesPerChannel,
+                     kSampleRateHz, AudioFrame::kNormalSpeech,
+                     AudioFrame::kVadPassive, kNumChannelsMono);
+  frame1.ShareDataFrom(frame2);
+
+  EXPECT_FALSE(frame1.muted());
+  EXPECT_EQ(0, memcmp(samples, frame1.data(), sizeof(samples)));
+  EXPECT_EQ(kTimestamp + 1, frame1.timestamp_);
+  EXPECT_EQ(AudioFrame::kNormalSpeech, frame1.speech_type_);
+  EXPECT_EQ(AudioFrame::kVadPassive, frame1.vad_activity_);
+
+  frame2.Mute();
+  frame1.ShareDataFrom(frame2);
+  EXPECT_TRUE(frame1.muted());
+  EXPECT_TRUE(AllSamplesAre(0, frame1));
+}
+
 TEST(AudioFrameTest, SwapFrames) {
   AudioFrame frame1, frame2;
   int16_t samples1[kNumChannelsMono * kSamplesPerChannel];
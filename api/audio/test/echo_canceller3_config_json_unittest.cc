@@ -28,6 +28,7 @@ TEST(EchoCanceller3JsonHelpers, ToStringAndParseJson) {
   cfg.suppressor.subband_nearend_detection.subband1 = {4, 5};
   cfg.suppressor.subband_nearend_detection.nearend_threshold = 2.f;
   cfg.suppressor.subband_nearend_detection.snr_threshold = 100.f;
+  cfg.multi_channel.num_capture_threads = 4;
   std::string json_string = Aec3ConfigToJsonString(cfg);
   EchoCanceller3Config cfg_transformed = Aec3ConfigFromJsonString(json_string);
 
@@ -66,5 +67,7 @@ TEST(EchoCanceller3JsonHelpers, ToStringAndParseJson) {
       cfg_transformed.suppressor.subband_nearend_detection.nearend_threshold);
   EXPECT_EQ(cfg.suppressor.subband_nearend_detection.snr_threshold,
             cfg_transformed.suppressor.subband_nearend_detection.snr_threshold);
+  EXPECT_EQ(cfg.multi_channel.num_capture_threads,
+            cfg_transformed.multi_channel.num_capture_threads);
 }
 }  // namespace webrtc
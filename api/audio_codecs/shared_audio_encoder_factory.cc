@@ -0,0 +1,467 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio_codecs/shared_audio_encoder_factory.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+// Number of 10 ms frames kept after encoding, so that streams that call
+// Encode() a bit later than the one that drove the shared encoder can still
+// pick up the result.
+constexpr size_t kMaxCachedFrames = 50;
+// If no stream has driven the shared encoder for this long, a stream whose
+// input does not match the cached frames may take it over.
+constexpr int64_t kDriverTimeoutMs = 100;
+
+class SharedAudioEncoder;
+
+// One underlying encoder and the frames it has encoded recently.
+class SharedEncoderGroup {
+ public:
+  explicit SharedEncoderGroup(std::unique_ptr<AudioEncoder> encoder)
+      : encoder_(std::move(encoder)) {}
+
+  struct Frame {
+    int64_t index;
+    uint32_t rtp_timestamp;
+    std::vector<int16_t> audio;
+    AudioEncoder::EncodedInfo info;
+    rtc::Buffer encoded;
+  };
+
+  rtc::CriticalSection lock_;
+  const std::unique_ptr<AudioEncoder> encoder_ RTC_GUARDED_BY(lock_);
+  std::vector<SharedAudioEncoder*> subscribers_ RTC_GUARDED_BY(lock_);
+  std::deque<Frame> frames_ RTC_GUARDED_BY(lock_);
+  // Index of the next frame to be encoded by |encoder_|.
+  int64_t next_index_ RTC_GUARDED_BY(lock_) = 0;
+  int64_t last_encode_ms_ RTC_GUARDED_BY(lock_) = 0;
+};
+
+// The AudioEncoder handed out to each send stream.
+class SharedAudioEncoder : public AudioEncoder {
+ public:
+  SharedAudioEncoder(std::shared_ptr<SharedEncoderGroup> group,
+                     rtc::scoped_refptr<AudioEncoderFactory> factory,
+                     int payload_type,
+                     const SdpAudioFormat& format,
+                     absl::optional<AudioCodecPairId> codec_pair_id)
+      : group_(std::move(group)),
+        factory_(std::move(factory)),
+        payload_type_(payload_type),
+        format_(format),
+        codec_pair_id_(codec_pair_id) {
+    rtc::CritScope cs(&group_->lock_);
+    group_->subscribers_.push_back(this);
+  }
+
+  ~SharedAudioEncoder() override {
+    rtc::CritScope cs(&group_->lock_);
+    auto& subscribers = group_->subscribers_;
+    subscribers.erase(std::find(subscribers.begin(), subscribers.end(), this));
+    UpdateSharedRates();
+  }
+
+  int SampleRateHz() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return group_->encoder_->SampleRateHz();
+  }
+
+  size_t NumChannels() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return group_->encoder_->NumChannels();
+  }
+
+  int RtpTimestampRateHz() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return group_->encoder_->RtpTimestampRateHz();
+  }
+
+  size_t Num10MsFramesInNextPacket() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return synced_ || !private_encoder_
+               ? group_->encoder_->Num10MsFramesInNextPacket()
+               : private_encoder_->Num10MsFramesInNextPacket();
+  }
+
+  size_t Max10MsFramesInAPacket() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return group_->encoder_->Max10MsFramesInAPacket();
+  }
+
+  int GetTargetBitrate() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return synced_ || !private_encoder_ ? group_->encoder_->GetTargetBitrate()
+                                        : private_encoder_->GetTargetBitrate();
+  }
+
+  absl::optional<std::pair<TimeDelta, TimeDelta>> GetFrameLengthRange()
+      const override {
+    rtc::CritScope cs(&group_->lock_);
+    return group_->encoder_->GetFrameLengthRange();
+  }
+
+  void Reset() override {
+    rtc::CritScope cs(&group_->lock_);
+    synced_ = false;
+    if (private_encoder_)
+      private_encoder_->Reset();
+  }
+
+  bool SetFec(bool enable) override {
+    rtc::CritScope cs(&group_->lock_);
+    fec_ = enable;
+    if (private_encoder_)
+      private_encoder_->SetFec(enable);
+    return group_->encoder_->SetFec(enable);
+  }
+
+  bool SetDtx(bool enable) override {
+    rtc::CritScope cs(&group_->lock_);
+    dtx_ = enable;
+    if (private_encoder_)
+      private_encoder_->SetDtx(enable);
+    return group_->encoder_->SetDtx(enable);
+  }
+
+  bool GetDtx() const override {
+    rtc::CritScope cs(&group_->lock_);
+    return group_->encoder_->GetDtx();
+  }
+
+  bool SetApplication(Application application) override {
+    rtc::CritScope cs(&group_->lock_);
+    application_ = application;
+    if (private_encoder_)
+      private_encoder_->SetApplication(application);
+    return group_->encoder_->SetApplication(application);
+  }
+
+  void SetMaxPlaybackRate(int frequency_hz) override {
+    rtc::CritScope cs(&group_->lock_);
+    max_playback_rate_hz_ = frequency_hz;
+    if (private_encoder_)
+      private_encoder_->SetMaxPlaybackRate(frequency_hz);
+    UpdateSharedRates();
+  }
+
+  void OnReceivedUplinkPacketLossFraction(
+      float uplink_packet_loss_fraction) override {
+    rtc::CritScope cs(&group_->lock_);
+    packet_loss_fraction_ = uplink_packet_loss_fraction;
+    if (private_encoder_) {
+      private_encoder_->OnReceivedUplinkPacketLossFraction(
+          uplink_packet_loss_fraction);
+    }
+    UpdateSharedRates();
+  }
+
+  void OnReceivedUplinkBandwidth(
+      int target_audio_bitrate_bps,
+      absl::optional<int64_t> bwe_period_ms) override {
+    rtc::CritScope cs(&group_->lock_);
+    target_bitrate_bps_ = target_audio_bitrate_bps;
+    if (private_encoder_) {
+      private_encoder_->OnReceivedUplinkBandwidth(target_audio_bitrate_bps,
+                                                  bwe_period_ms);
+    }
+    UpdateSharedRates();
+  }
+
+  void OnReceivedRtt(int rtt_ms) override {
+    rtc::CritScope cs(&group_->lock_);
+    rtt_ms_ = rtt_ms;
+    if (private_encoder_)
+      private_encoder_->OnReceivedRtt(rtt_ms);
+  }
+
+  void OnReceivedOverhead(size_t overhead_bytes_per_packet) override {
+    rtc::CritScope cs(&group_->lock_);
+    overhead_bytes_per_packet_ = overhead_bytes_per_packet;
+    if (private_encoder_)
+      private_encoder_->OnReceivedOverhead(overhead_bytes_per_packet);
+    UpdateSharedRates();
+  }
+
+  bool EnableAudioNetworkAdaptor(const std::string& config_string,
+                                 RtcEventLog* event_log) override {
+    return false;
+  }
+
+ protected:
+  EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
+                         rtc::ArrayView<const int16_t> audio,
+                         rtc::Buffer* encoded) override {
+    rtc::CritScope cs(&group_->lock_);
+    auto& frames = group_->frames_;
+
+    const SharedEncoderGroup::Frame* frame = nullptr;
+    if (synced_) {
+      if (next_index_ == group_->next_index_) {
+        frame = EncodeShared(audio);
+      } else {
+        frame = FindFrame(next_index_, audio);
+      }
+      synced_ = frame != nullptr;
+    }
+    if (!synced_) {
+      // Join at the newest frame that carries the same audio, or take over
+      // the shared encoder if nobody else is driving it.
+      for (auto it = frames.rbegin(); it != frames.rend() && !frame; ++it) {
+        if (Matches(*it, audio))
+          frame = &*it;
+      }
+      if (!frame && !IsSharedEncoderDriven())
+        frame = EncodeShared(audio);
+      synced_ = frame != nullptr;
+    }
+
+    if (!synced_)
+      return EncodePrivate(rtp_timestamp, audio, encoded);
+
+    next_index_ = frame->index + 1;
+    encoded->AppendData(frame->encoded);
+    EncodedInfo info = frame->info;
+    // Shift the timestamps from the shared encoder's timeline to ours.
+    const uint32_t offset = rtp_timestamp - frame->rtp_timestamp;
+    info.encoded_timestamp += offset;
+    info.payload_type = payload_type_;
+    for (EncodedInfoLeaf& leaf : info.redundant) {
+      leaf.encoded_timestamp += offset;
+      leaf.payload_type = payload_type_;
+    }
+    return info;
+  }
+
+ private:
+  static bool Matches(const SharedEncoderGroup::Frame& frame,
+                      rtc::ArrayView<const int16_t> audio) {
+    return frame.audio.size() == audio.size() &&
+           std::equal(audio.begin(), audio.end(), frame.audio.begin());
+  }
+
+  const SharedEncoderGroup::Frame* FindFrame(
+      int64_t index,
+      rtc::ArrayView<const int16_t> audio) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(group_->lock_) {
+    const auto& frames = group_->frames_;
+    if (frames.empty() || index < frames.front().index)
+      return nullptr;
+    const auto& frame = frames[index - frames.front().index];
+    return Matches(frame, audio) ? &frame : nullptr;
+  }
+
+  bool IsSharedEncoderDriven() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(group_->lock_) {
+    if (rtc::TimeMillis() - group_->last_encode_ms_ > kDriverTimeoutMs)
+      return false;
+    for (const SharedAudioEncoder* subscriber : group_->subscribers_) {
+      if (subscriber->synced_)
+        return true;
+    }
+    return false;
+  }
+
+  const SharedEncoderGroup::Frame* EncodeShared(
+      rtc::ArrayView<const int16_t> audio)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(group_->lock_) {
+    AudioEncoder* encoder = group_->encoder_.get();
+    auto& frames = group_->frames_;
+    if (frames.size() == kMaxCachedFrames)
+      frames.pop_front();
+    frames.emplace_back();
+    SharedEncoderGroup::Frame& frame = frames.back();
+    frame.index = group_->next_index_++;
+    frame.rtp_timestamp = static_cast<uint32_t>(
+        frame.index * encoder->RtpTimestampRateHz() / 100);
+    frame.audio.assign(audio.begin(), audio.end());
+    frame.info = encoder->Encode(frame.rtp_timestamp, audio, &frame.encoded);
+    group_->last_encode_ms_ = rtc::TimeMillis();
+    return &frame;
+  }
+
+  EncodedInfo EncodePrivate(uint32_t rtp_timestamp,
+                            rtc::ArrayView<const int16_t> audio,
+                            rtc::Buffer* encoded)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(group_->lock_) {
+    if (!private_encoder_) {
+      private_encoder_ =
+          factory_->MakeAudioEncoder(payload_type_, format_, codec_pair_id_);
+      RTC_CHECK(private_encoder_);
+      if (fec_)
+        private_encoder_->SetFec(*fec_);
+      if (dtx_)
+        private_encoder_->SetDtx(*dtx_);
+      if (application_)
+        private_encoder_->SetApplication(*application_);
+      if (max_playback_rate_hz_)
+        private_encoder_->SetMaxPlaybackRate(*max_playback_rate_hz_);
+      if (target_bitrate_bps_) {
+        private_encoder_->OnReceivedUplinkBandwidth(*target_bitrate_bps_,
+                                                    absl::nullopt);
+      }
+      if (packet_loss_fraction_) {
+        private_encoder_->OnReceivedUplinkPacketLossFraction(
+            *packet_loss_fraction_);
+      }
+      if (rtt_ms_)
+        private_encoder_->OnReceivedRtt(*rtt_ms_);
+      if (overhead_bytes_per_packet_)
+        private_encoder_->OnReceivedOverhead(*overhead_bytes_per_packet_);
+    }
+    return private_encoder_->Encode(rtp_timestamp, audio, encoded);
+  }
+
+  // Runs the shared encoder at the lowest target bitrate and the highest
+  // packet loss and overhead among the subscribers, so that the output fits
+  // the most constrained receiver.
+  void UpdateSharedRates() RTC_EXCLUSIVE_LOCKS_REQUIRED(group_->lock_) {
+    absl::optional<int> target_bitrate_bps;
+    absl::optional<float> packet_loss_fraction;
+    absl::optional<size_t> overhead_bytes_per_packet;
+    absl::optional<int> max_playback_rate_hz;
+    for (const SharedAudioEncoder* subscriber : group_->subscribers_) {
+      if (subscriber->target_bitrate_bps_) {
+        target_bitrate_bps = std::min(
+            target_bitrate_bps.value_or(*subscriber->target_bitrate_bps_),
+            *subscriber->target_bitrate_bps_);
+      }
+      if (subscriber->packet_loss_fraction_) {
+        packet_loss_fraction = std::max(
+            packet_loss_fraction.value_or(*subscriber->packet_loss_fraction_),
+            *subscriber->packet_loss_fraction_);
+      }
+      if (subscriber->overhead_bytes_per_packet_) {
+        overhead_bytes_per_packet =
+            std::max(overhead_bytes_per_packet.value_or(
+                         *subscriber->overhead_bytes_per_packet_),
+                     *subscriber->overhead_bytes_per_packet_);
+      }
+      if (subscriber->max_playback_rate_hz_) {
+        max_playback_rate_hz = std::min(
+            max_playback_rate_hz.value_or(*subscriber->max_playback_rate_hz_),
+            *subscriber->max_playback_rate_hz_);
+      }
+    }
+    AudioEncoder* encoder = group_->encoder_.get();
+    if (overhead_bytes_per_packet)
+      encoder->OnReceivedOverhead(*overhead_bytes_per_packet);
+    if (max_playback_rate_hz)
+      encoder->SetMaxPlaybackRate(*max_playback_rate_hz);
+    if (packet_loss_fraction)
+      encoder->OnReceivedUplinkPacketLossFraction(*packet_loss_fraction);
+    if (target_bitrate_bps)
+      encoder->OnReceivedUplinkBandwidth(*target_bitrate_bps, absl::nullopt);
+  }
+
+  const std::shared_ptr<SharedEncoderGroup> group_;
+  const rtc::scoped_refptr<AudioEncoderFactory> factory_;
+  const int payload_type_;
+  const SdpAudioFormat format_;
+  const absl::optional<AudioCodecPairId> codec_pair_id_;
+
+  // True while our input matches what the shared encoder is fed.
+  bool synced_ RTC_GUARDED_BY(group_->lock_) = false;
+  // Index of the shared frame that our next input should match.
+  int64_t next_index_ RTC_GUARDED_BY(group_->lock_) = 0;
+  std::unique_ptr<AudioEncoder> private_encoder_ RTC_GUARDED_BY(group_->lock_);
+
+  // Settings, kept so that they can be aggregated into the shared encoder and
+  // applied to |private_encoder_| when it is created.
+  absl::optional<bool> fec_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<bool> dtx_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<Application> application_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<int> max_playback_rate_hz_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<int> target_bitrate_bps_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<float> packet_loss_fraction_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<int> rtt_ms_ RTC_GUARDED_BY(group_->lock_);
+  absl::optional<size_t> overhead_bytes_per_packet_
+      RTC_GUARDED_BY(group_->lock_);
+};
+
+class SharedAudioEncoderFactory : public AudioEncoderFactory {
+ public:
+  explicit SharedAudioEncoderFactory(
+      rtc::scoped_refptr<AudioEncoderFactory> factory)
+      : factory_(std::move(factory)) {}
+
+  std::vector<AudioCodecSpec> GetSupportedEncoders() override {
+    return factory_->GetSupportedEncoders();
+  }
+
+  absl::optional<AudioCodecInfo> QueryAudioEncoder(
+      const SdpAudioFormat& format) override {
+    return factory_->QueryAudioEncoder(format);
+  }
+
+  std::unique_ptr<AudioEncoder> MakeAudioEncoder(
+      int payload_type,
+      const SdpAudioFormat& format,
+      absl::optional<AudioCodecPairId> codec_pair_id) override {
+    rtc::CritScope cs(&lock_);
+    // Drop groups whose encoders have all been destroyed.
+    groups_.erase(std::remove_if(groups_.begin(), groups_.end(),
+                                 [](const auto& entry) {
+                                   return entry.second.expired();
+                                 }),
+                  groups_.end());
+
+    std::shared_ptr<SharedEncoderGroup> group;
+    for (const auto& entry : groups_) {
+      if (entry.first == format) {
+        group = entry.second.lock();
+        break;
+      }
+    }
+    if (!group) {
+      // The shared encoder is not tied to any one receiver's decoder.
+      std::unique_ptr<AudioEncoder> encoder =
+          factory_->MakeAudioEncoder(payload_type, format, absl::nullopt);
+      if (!encoder)
+        return nullptr;
+      group = std::make_shared<SharedEncoderGroup>(std::move(encoder));
+      groups_.emplace_back(format, group);
+    }
+    return std::make_unique<SharedAudioEncoder>(std::move(group), factory_,
+                                                payload_type, format,
+                                                codec_pair_id);
+  }
+
+ private:
+  const rtc::scoped_refptr<AudioEncoderFactory> factory_;
+  rtc::CriticalSection lock_;
+  std::vector<std::pair<SdpAudioFormat, std::weak_ptr<SharedEncoderGroup>>>
+      groups_ RTC_GUARDED_BY(lock_);
+};
+
+}  // namespace
+
+rtc::scoped_refptr<AudioEncoderFactory> CreateSharedAudioEncoderFactory(
+    rtc::scoped_refptr<AudioEncoderFactory> factory) {
+  return new rtc::RefCountedObject<SharedAudioEncoderFactory>(
+      std::move(factory));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_AUDIO_CODECS_SHARED_AUDIO_ENCODER_FACTORY_H_
+#define API_AUDIO_CODECS_SHARED_AUDIO_ENCODER_FACTORY_H_
+
+#include "api/audio_codecs/audio_encoder_factory.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace webrtc {
+
+// Wraps |factory| so that all encoders it makes for the same SdpAudioFormat
+// share one underlying encoder. This is meant for servers that send the same
+// audio, e.g. one mix, to many receivers: every AudioSendStream gets the same
+// 10 ms frames, and the frame is encoded once instead of once per stream.
+//
+// Each encoder made by the returned factory keeps its own RTP timestamps and
+// payload type, so packetization stays per stream. A stream whose input turns
+// out to differ from what the shared encoder was fed, e.g. because it carries
+// another source, transparently falls back to a private encoder made by
+// |factory| until its input matches again.
+//
+// The shared encoder runs at the lowest target bitrate and the highest packet
+// loss fraction reported by its streams. Audio network adaptation is not
+// supported on shared encoders, since it would let one receiver's network
+// change the encoding for all of them.
+RTC_EXPORT rtc::scoped_refptr<AudioEncoderFactory>
+CreateSharedAudioEncoderFactory(
+    rtc::scoped_refptr<AudioEncoderFactory> factory);
+
+}  // namespace webrtc
+
+#endif  // API_AUDIO_CODECS_SHARED_AUDIO_ENCODER_FACTORY_H_
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/audio_codecs/shared_audio_encoder_factory.h"
+
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/ref_counted_object.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kSampleRateHz = 8000;
+constexpr size_t kSamplesPer10Ms = kSampleRateHz / 100;
+const SdpAudioFormat kFormat("fake", kSampleRateHz, 1);
+
+struct EncoderCounters {
+  int encoders_made = 0;
+  int frames_encoded = 0;
+  int last_target_bitrate_bps = 0;
+};
+
+// Emits one packet per 10 ms frame with the first input sample as payload.
+class FakeEncoder : public AudioEncoder {
+ public:
+  FakeEncoder(int payload_type, EncoderCounters* counters)
+      : payload_type_(payload_type), counters_(counters) {}
+
+  int SampleRateHz() const override { return kSampleRateHz; }
+  size_t NumChannels() const override { return 1; }
+  size_t Num10MsFramesInNextPacket() const override { return 1; }
+  size_t Max10MsFramesInAPacket() const override { return 1; }
+  int GetTargetBitrate() const override {
+    return counters_->last_target_bitrate_bps;
+  }
+  absl::optional<std::pair<TimeDelta, TimeDelta>> GetFrameLengthRange()
+      const override {
+    return absl::nullopt;
+  }
+  void Reset() override {}
+  void OnReceivedUplinkBandwidth(
+      int target_audio_bitrate_bps,
+      absl::optional<int64_t> bwe_period_ms) override {
+    counters_->last_target_bitrate_bps = target_audio_bitrate_bps;
+  }
+
+ protected:
+  EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
+                         rtc::ArrayView<const int16_t> audio,
+                         rtc::Buffer* encoded) override {
+    ++counters_->frames_encoded;
+    encoded->AppendData(reinterpret_cast<const uint8_t*>(audio.data()),
+                        sizeof(int16_t));
+    EncodedInfo info;
+    info.encoded_bytes = sizeof(int16_t);
+    info.encoded_timestamp = rtp_timestamp;
+    info.payload_type = payload_type_;
+    return info;
+  }
+
+ private:
+  const int payload_type_;
+  EncoderCounters* const counters_;
+};
+
+class FakeEncoderFactory : public AudioEncoderFactory {
+ public:
+  std::vector<AudioCodecSpec> GetSupportedEncoders() override {
+    return {{kFormat, {kSampleRateHz, 1, 64000}}};
+  }
+  absl::optional<AudioCodecInfo> QueryAudioEncoder(
+      const SdpAudioFormat& format) override {
+    return AudioCodecInfo(kSampleRateHz, 1, 64000);
+  }
+  std::unique_ptr<AudioEncoder> MakeAudioEncoder(
+      int payload_type,
+      const SdpAudioFormat& format,
+      absl::optional<AudioCodecPairId> codec_pair_id) override {
+    ++counters_.encoders_made;
+    return std::make_unique<FakeEncoder>(payload_type, &counters_);
+  }
+
+  EncoderCounters counters_;
+};
+
+std::vector<int16_t> MakeFrame(int16_t value) {
+  return std::vector<int16_t>(kSamplesPer10Ms, value);
+}
+
+int16_t PayloadValue(const rtc::Buffer& encoded) {
+  int16_t value;
+  memcpy(&value, encoded.data(), sizeof(value));
+  return value;
+}
+
+class SharedAudioEncoderFactoryTest : public ::testing::Test {
+ protected:
+  SharedAudioEncoderFactoryTest()
+      : fake_factory_(new rtc::RefCountedObject<FakeEncoderFactory>()),
+        factory_(CreateSharedAudioEncoderFactory(fake_factory_)) {}
+
+  const rtc::scoped_refptr<FakeEncoderFactory> fake_factory_;
+  const rtc::scoped_refptr<AudioEncoderFactory> factory_;
+};
+
+TEST_F(SharedAudioEncoderFactoryTest, EncodesIdenticalInputOnce) {
+  std::unique_ptr<AudioEncoder> encoder1 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+  std::unique_ptr<AudioEncoder> encoder2 =
+      factory_->MakeAudioEncoder(101, kFormat, absl::nullopt);
+  EXPECT_EQ(1, fake_factory_->counters_.encoders_made);
+
+  constexpr int kNumFrames = 10;
+  for (int i = 0; i < kNumFrames; ++i) {
+    const std::vector<int16_t> frame = MakeFrame(i);
+    rtc::Buffer encoded1;
+    rtc::Buffer encoded2;
+    AudioEncoder::EncodedInfo info1 =
+        encoder1->Encode(1000 + i * kSamplesPer10Ms, frame, &encoded1);
+    AudioEncoder::EncodedInfo info2 =
+        encoder2->Encode(5000 + i * kSamplesPer10Ms, frame, &encoded2);
+
+    EXPECT_EQ(1000 + i * kSamplesPer10Ms, info1.encoded_timestamp);
+    EXPECT_EQ(5000 + i * kSamplesPer10Ms, info2.encoded_timestamp);
+    EXPECT_EQ(100, info1.payload_type);
+    EXPECT_EQ(101, info2.payload_type);
+    EXPECT_EQ(encoded1, encoded2);
+    EXPECT_EQ(i, PayloadValue(encoded2));
+  }
+  EXPECT_EQ(kNumFrames, fake_factory_->counters_.frames_encoded);
+}
+
+TEST_F(SharedAudioEncoderFactoryTest, DifferentInputUsesPrivateEncoder) {
+  std::unique_ptr<AudioEncoder> encoder1 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+  std::unique_ptr<AudioEncoder> encoder2 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+
+  for (int i = 0; i < 5; ++i) {
+    rtc::Buffer encoded1;
+    rtc::Buffer encoded2;
+    encoder1->Encode(i * kSamplesPer10Ms, MakeFrame(i), &encoded1);
+    encoder2->Encode(i * kSamplesPer10Ms, MakeFrame(-i - 1), &encoded2);
+    EXPECT_EQ(i, PayloadValue(encoded1));
+    EXPECT_EQ(-i - 1, PayloadValue(encoded2));
+  }
+  EXPECT_EQ(2, fake_factory_->counters_.encoders_made);
+  EXPECT_EQ(10, fake_factory_->counters_.frames_encoded);
+}
+
+TEST_F(SharedAudioEncoderFactoryTest, LateJoinerPicksUpCachedFrames) {
+  std::unique_ptr<AudioEncoder> encoder1 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+  rtc::Buffer encoded;
+  encoder1->Encode(0, MakeFrame(1), &encoded);
+  encoder1->Encode(kSamplesPer10Ms, MakeFrame(2), &encoded);
+
+  std::unique_ptr<AudioEncoder> encoder2 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+  encoded.Clear();
+  encoder2->Encode(0, MakeFrame(2), &encoded);
+  EXPECT_EQ(2, PayloadValue(encoded));
+  EXPECT_EQ(1, fake_factory_->counters_.encoders_made);
+  EXPECT_EQ(2, fake_factory_->counters_.frames_encoded);
+}
+
+TEST_F(SharedAudioEncoderFactoryTest, UsesLowestTargetBitrate) {
+  std::unique_ptr<AudioEncoder> encoder1 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+  std::unique_ptr<AudioEncoder> encoder2 =
+      factory_->MakeAudioEncoder(100, kFormat, absl::nullopt);
+
+  encoder1->OnReceivedUplinkBandwidth(32000, absl::nullopt);
+  encoder2->OnReceivedUplinkBandwidth(24000, absl::nullopt);
+  EXPECT_EQ(24000, fake_factory_->counters_.last_target_bitrate_bps);
+  encoder1->OnReceivedUplinkBandwidth(16000, absl::nullopt);
+  EXPECT_EQ(16000, fake_factory_->counters_.last_target_bitrate_bps);
+  encoder1.reset();
+  EXPECT_EQ(24000, fake_factory_->counters_.last_target_bitrate_bps);
+}
+
+}  // namespace
+
+}  // namespace webrtc
@@ -58,7 +58,11 @@ class FrameDecryptorInterface : public rtc::RefCountInterface {
   // bytes you wrote to in the frame buffer. kOk must be returned if successful,
   // kRecoverable should be returned if the failure was due to something other
   // than a decryption failure. kFailedToDecrypt should be returned in all other
-  // cases.
+  // cases. The frame buffer may start at the same address as encrypted_frame,
+  // so the implementor must support decrypting in place; video frames are
+  // decrypted in place into the buffers they were received in. Decrypt may be
+  // called on a different thread than the one the frames were received on,
+  // but is never called concurrently for the same receiver.
   virtual Result Decrypt(cricket::MediaType media_type,
                          const std::vector<uint32_t>& csrcs,
                          rtc::ArrayView<const uint8_t> additional_data,
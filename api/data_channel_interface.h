@@ -20,6 +20,7 @@
 #include <string>
 
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/priority.h"
 #include "api/rtc_error.h"
 #include "rtc_base/checks.h"
@@ -95,8 +96,20 @@ class DataChannelObserver {
   virtual void OnStateChange() = 0;
   //  A data buffer was successfully received.
   virtual void OnMessage(const DataBuffer& buffer) = 0;
+  // Data buffers that were received together, in order. Observers that
+  // receive many small messages can override this to handle the batch at
+  // once; the default implementation calls OnMessage for each buffer.
+  virtual void OnMessages(rtc::ArrayView<const DataBuffer> buffers) {
+    for (const DataBuffer& buffer : buffers) {
+      OnMessage(buffer);
+    }
+  }
   // The data channel's buffered_amount has changed.
   virtual void OnBufferedAmountChange(uint64_t sent_data_size) {}
+  // The data channel's buffered_amount has decreased from above the threshold
+  // set with SetBufferedAmountLowThreshold to at or below it.
+  // https://w3c.github.io/webrtc-pc/#event-datachannel-bufferedamountlow
+  virtual void OnBufferedAmountLow() {}
 
  protected:
   virtual ~DataChannelObserver() = default;
@@ -174,6 +187,11 @@ class RTC_EXPORT DataChannelInterface : public rtc::RefCountInterface {
   // the SCTP level. See comment above Send below.
   virtual uint64_t buffered_amount() const = 0;
 
+  // The threshold at or below which buffered_amount() is considered low, see
+  // DataChannelObserver::OnBufferedAmountLow. Zero by default.
+  virtual uint64_t buffered_amount_low_threshold() const { return 0; }
+  virtual void SetBufferedAmountLowThreshold(uint64_t threshold) {}
+
   // Begins the graceful data channel closing procedure. See:
   // https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.7
   virtual void Close() = 0;
@@ -183,9 +201,9 @@ class RTC_EXPORT DataChannelInterface : public rtc::RefCountInterface {
   // up to a maximum of 16MB. If Send is called while this buffer is full, the
   // data channel will be closed abruptly.
   //
-  // So, it's important to use buffered_amount() and OnBufferedAmountChange to
-  // ensure the data channel is used efficiently but without filling this
-  // buffer.
+  // So, it's important to use buffered_amount() and OnBufferedAmountChange (or
+  // OnBufferedAmountLow) to ensure the data channel is used efficiently but
+  // without filling this buffer.
   virtual bool Send(const DataBuffer& buffer) = 0;
 
  protected:
@@ -33,6 +33,14 @@ class TransformableFrameInterface {
   // Copies |data| into the owned frame payload data.
   virtual void SetData(rtc::ArrayView<const uint8_t> data) = 0;
 
+  // Resizes the frame payload data to |size| bytes and returns a writable view
+  // of it, to transform the data in place rather than copy the result in with
+  // SetData(). The view starts with the first min(|size|, GetData().size())
+  // bytes of the current data; the rest is uninitialized. The view is valid
+  // until the next non-const method call. Returns an empty view if the frame
+  // can't be modified in place, in which case SetData() must be used.
+  virtual rtc::ArrayView<uint8_t> GetMutableData(size_t size) { return {}; }
+
   virtual uint32_t GetTimestamp() const = 0;
   virtual uint32_t GetSsrc() const = 0;
 };
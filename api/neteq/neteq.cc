@@ -32,6 +32,14 @@ std::string NetEq::Config::ToString() const {
      << ", enable_muted_state=" << (enable_muted_state ? "true" : "false")
      << ", enable_rtx_handling=" << (enable_rtx_handling ? "true" : "false")
      << ", extra_output_delay_ms=" << extra_output_delay_ms;
+  if (skip_decoding_audio_level) {
+    ss << ", skip_decoding_audio_level=" << *skip_decoding_audio_level;
+  }
+  if (low_latency_delay) {
+    ss << ", low_latency_delay={late_packet_rate="
+       << low_latency_delay->late_packet_rate
+       << ", max_delay_ms=" << low_latency_delay->max_delay_ms << "}";
+  }
   return ss.str();
 }
 
@@ -142,6 +142,25 @@ class NetEq {
     // loss behavior. This is mainly for testing. Value must be a non-negative
     // multiple of 10 ms.
     int extra_output_delay_ms = 0;
+    // If set, decoding stops once the received packets have carried an audio
+    // level header extension (RFC 6464) at this level or quieter, in -dBov,
+    // for a while. GetAudio() then outputs muted frames and discards packets
+    // as their playout time passes, which keeps the buffer delay, and decoding
+    // resumes from the next packet once a louder one is received.
+    absl::optional<int> skip_decoding_audio_level;
+
+    // Budgets of the low-latency delay policy, meant for stable networks
+    // where the default policy keeps more buffering than needed. It follows
+    // the relative arrival delay of recent packets within about a second, and
+    // targets the smallest delay at which at most |late_packet_rate| of the
+    // packets arrive too late to be played out. If |max_delay_ms| is positive,
+    // the target never exceeds it, even if that means more late packets.
+    struct LowLatencyDelay {
+      double late_packet_rate = 0.05;
+      int max_delay_ms = 0;
+    };
+    // Selects the low-latency delay policy instead of the default one.
+    absl::optional<LowLatencyDelay> low_latency_delay;
   };
 
   enum ReturnCodes { kOK = 0, kFail = -1 };
@@ -69,6 +69,7 @@ class NetEqController {
     int base_min_delay_ms;
     TickTimer* tick_timer;
     webrtc::Clock* clock = nullptr;
+    absl::optional<NetEq::Config::LowLatencyDelay> low_latency_delay;
   };
 
   struct PacketInfo {
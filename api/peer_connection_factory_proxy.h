@@ -58,6 +58,7 @@ PROXY_METHOD2(rtc::scoped_refptr<AudioTrackInterface>,
               AudioSourceInterface*)
 PROXY_METHOD2(bool, StartAecDump, FILE*, int64_t)
 PROXY_METHOD0(void, StopAecDump)
+PROXY_CONSTMETHOD0(rtc::CpuUsageReport, GetCpuUsage)
 END_PROXY_MAP()
 
 }  // namespace webrtc
@@ -100,6 +100,7 @@
 #include "api/stats/rtc_stats_collector_callback.h"
 #include "api/stats_types.h"
 #include "api/task_queue/task_queue_factory.h"
+#include "api/transport/bandwidth_estimate_cache.h"
 #include "api/transport/bitrate_settings.h"
 #include "api/transport/enums.h"
 #include "api/transport/media/media_transport_interface.h"
@@ -112,6 +113,8 @@
 // inject a PacketSocketFactory and/or NetworkManager, and not expose
 // PortAllocator in the PeerConnection api.
 #include "p2p/base/port_allocator.h"  // nogncheck
+#include "rtc_base/cpu_accounting.h"
+#include "rtc_base/memory/aligned_malloc.h"
 #include "rtc_base/network.h"
 #include "rtc_base/rtc_certificate.h"
 #include "rtc_base/rtc_certificate_generator.h"
@@ -1332,9 +1335,17 @@ struct RTC_EXPORT PeerConnectionFactoryDependencies final {
   std::unique_ptr<NetworkStatePredictorFactoryInterface>
       network_state_predictor_factory;
   std::unique_ptr<NetworkControllerFactoryInterface> network_controller_factory;
+  // If set, the calls of all peer connections start their bandwidth estimate
+  // from the last estimate of an earlier call on a similar network route, see
+  // BandwidthEstimateCache.
+  std::unique_ptr<BandwidthEstimateCache> bandwidth_estimate_cache;
   std::unique_ptr<MediaTransportFactory> media_transport_factory;
   std::unique_ptr<NetEqFactory> neteq_factory;
   std::unique_ptr<WebRtcKeyValueConfig> trials;
+  // If set, replaces the process wide huge page config of AlignedMalloc(),
+  // which video frames and the frame pools allocate from, when the factory is
+  // created. See SetAlignedMallocHugePageConfig().
+  absl::optional<HugePageConfig> huge_page_config;
 };
 
 // PeerConnectionFactoryInterface is the factory interface used for creating
@@ -1460,6 +1471,15 @@ class RTC_EXPORT PeerConnectionFactoryInterface
   // Stops logging the AEC dump.
   virtual void StopAecDump() = 0;
 
+  // Returns the CPU time spent in the encoder, decoder, audio processing,
+  // SRTP, pacing and ICE, per thread and in total. The accounting is process
+  // wide and off until rtc::EnableCpuAccounting(true) is called.
+  // TODO(webrtc:6463): Delete default implementation when downstream mocks
+  // classes are updated.
+  virtual rtc::CpuUsageReport GetCpuUsage() const {
+    return rtc::CpuUsageReport();
+  }
+
  protected:
   // Dtor and ctor protected as objects shouldn't be created or deleted via
   // this interface.
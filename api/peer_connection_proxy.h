@@ -64,14 +64,12 @@ PROXY_METHOD3(bool,
               MediaStreamTrackInterface*,
               StatsOutputLevel)
 PROXY_METHOD1(void, GetStats, RTCStatsCollectorCallback*)
-PROXY_METHOD2(void,
-              GetStats,
-              rtc::scoped_refptr<RtpSenderInterface>,
-              rtc::scoped_refptr<RTCStatsCollectorCallback>)
-PROXY_METHOD2(void,
-              GetStats,
-              rtc::scoped_refptr<RtpReceiverInterface>,
-              rtc::scoped_refptr<RTCStatsCollectorCallback>)
+PROXY_ASYNC_METHOD2(GetStats,
+                    rtc::scoped_refptr<RtpSenderInterface>,
+                    rtc::scoped_refptr<RTCStatsCollectorCallback>)
+PROXY_ASYNC_METHOD2(GetStats,
+                    rtc::scoped_refptr<RtpReceiverInterface>,
+                    rtc::scoped_refptr<RTCStatsCollectorCallback>)
 PROXY_METHOD0(void, ClearStatsCache)
 PROXY_METHOD2(rtc::scoped_refptr<DataChannelInterface>,
               CreateDataChannel,
@@ -105,19 +103,17 @@ PROXY_METHOD2(void,
               SetRemoteDescription,
               SetSessionDescriptionObserver*,
               SessionDescriptionInterface*)
-PROXY_METHOD2(void,
-              SetRemoteDescription,
-              std::unique_ptr<SessionDescriptionInterface>,
-              rtc::scoped_refptr<SetRemoteDescriptionObserverInterface>)
+PROXY_ASYNC_METHOD2(SetRemoteDescription,
+                    std::unique_ptr<SessionDescriptionInterface>,
+                    rtc::scoped_refptr<SetRemoteDescriptionObserverInterface>)
 PROXY_METHOD0(PeerConnectionInterface::RTCConfiguration, GetConfiguration)
 PROXY_METHOD1(RTCError,
               SetConfiguration,
               const PeerConnectionInterface::RTCConfiguration&)
 PROXY_METHOD1(bool, AddIceCandidate, const IceCandidateInterface*)
-PROXY_METHOD2(void,
-              AddIceCandidate,
-              std::unique_ptr<IceCandidateInterface>,
-              std::function<void(RTCError)>)
+PROXY_ASYNC_METHOD2(AddIceCandidate,
+                    std::unique_ptr<IceCandidateInterface>,
+                    std::function<void(RTCError)>)
 PROXY_METHOD1(bool, RemoveIceCandidates, const std::vector<cricket::Candidate>&)
 PROXY_METHOD1(RTCError, SetBitrate, const BitrateSettings&)
 PROXY_METHOD1(void, SetAudioPlayout, bool)
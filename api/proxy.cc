@@ -10,6 +10,11 @@
 
 #include "api/proxy.h"
 
+#include <utility>
+
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/metrics.h"
+
 namespace webrtc {
 namespace internal {
 
@@ -23,15 +28,37 @@ void SynchronousMethodCall::Invoke(const rtc::Location& posted_from,
   if (t->IsCurrent()) {
     proxy_->OnMessage(nullptr);
   } else {
+    posted_us_ = rtc::TimeMicros();
     t->Post(posted_from, this, 0);
     e_.Wait(rtc::Event::kForever);
+    RTC_HISTOGRAM_COUNTS("WebRTC.Proxy.CallBlockingTimeUs",
+                         rtc::TimeMicros() - posted_us_, 1, 1000000, 50);
   }
 }
 
 void SynchronousMethodCall::OnMessage(rtc::Message*) {
+  // The time the call waited behind other work on the target thread.
+  RTC_HISTOGRAM_COUNTS("WebRTC.Proxy.CallQueueingDelayUs",
+                       rtc::TimeMicros() - posted_us_, 1, 1000000, 50);
   proxy_->OnMessage(nullptr);
   e_.Set();
 }
 
+void PostOrRunTask(const rtc::Location& posted_from,
+                   rtc::Thread* t,
+                   std::unique_ptr<QueuedTask> task) {
+  if (t->IsCurrent()) {
+    if (!task->Run()) {
+      task.release();
+    }
+    return;
+  }
+  t->PostTask(posted_from, [task = std::move(task)]() mutable {
+    if (!task->Run()) {
+      task.release();
+    }
+  });
+}
+
 }  // namespace internal
 }  // namespace webrtc
@@ -38,6 +38,10 @@
 // Where the destructor and first two methods are invoked on the signaling
 // thread, and the third is invoked on the worker thread.
 //
+// Methods defined with PROXY_ASYNC_METHOD* must return void and report their
+// result through a callback. When called on another thread they are posted to
+// the signaling thread, and the caller does not wait for them to run.
+//
 // The proxy can be created using
 //
 //   TestProxy::Create(Thread* signaling_thread, Thread* worker_thread,
@@ -58,6 +62,7 @@
 #include <utility>
 
 #include "api/scoped_refptr.h"
+#include "api/task_queue/queued_task.h"
 #include "rtc_base/event.h"
 #include "rtc_base/message_handler.h"
 #include "rtc_base/ref_counted_object.h"
@@ -110,8 +115,15 @@ class RTC_EXPORT SynchronousMethodCall : public rtc::MessageData,
 
   rtc::Event e_;
   rtc::MessageHandler* proxy_;
+  int64_t posted_us_ = 0;
 };
 
+// Runs |task| if on |t|, and posts it to |t| otherwise. Like on a task queue,
+// |task| is deleted after running unless its Run() returns false.
+RTC_EXPORT void PostOrRunTask(const rtc::Location& posted_from,
+                              rtc::Thread* t,
+                              std::unique_ptr<QueuedTask> task);
+
 }  // namespace internal
 
 template <typename C, typename R, typename... Args>
@@ -170,6 +182,31 @@ class ConstMethodCall : public rtc::Message, public rtc::MessageHandler {
   std::tuple<Args&&...> args_;
 };
 
+// Calls a method returning void when run as a task, holding a reference to the
+// object and owning the arguments until then.
+template <typename C, typename... Args>
+class AsyncMethodCall : public QueuedTask {
+ public:
+  typedef void (C::*Method)(Args...);
+  AsyncMethodCall(rtc::scoped_refptr<C> c, Method m, Args&&... args)
+      : c_(std::move(c)), m_(m), args_(std::forward<Args>(args)...) {}
+
+  bool Run() override {
+    Invoke(std::index_sequence_for<Args...>());
+    return true;
+  }
+
+ private:
+  template <size_t... Is>
+  void Invoke(std::index_sequence<Is...>) {
+    ((*c_).*m_)(std::move(std::get<Is>(args_))...);
+  }
+
+  const rtc::scoped_refptr<C> c_;
+  const Method m_;
+  std::tuple<typename std::decay<Args>::type...> args_;
+};
+
 // Helper macros to reduce code duplication.
 #define PROXY_MAP_BOILERPLATE(c)                          \
   template <class INTERNAL_CLASS>                         \
@@ -343,6 +380,27 @@ class ConstMethodCall : public rtc::Message, public rtc::MessageHandler {
     return call.Marshal(RTC_FROM_HERE, signaling_thread_);                   \
   }
 
+// Define methods which are posted to the signaling thread, unless called on
+// it. Their arguments must own or reference count what they refer to, since
+// the call runs after the caller has returned. Other proxied calls are posted
+// too, so the calls made from one thread still run in order. Only for
+// reference counted proxies.
+#define PROXY_ASYNC_METHOD1(method, t1)                                   \
+  void method(t1 a1) override {                                           \
+    std::unique_ptr<QueuedTask> call(                                     \
+        new AsyncMethodCall<C, t1>(c_.get(), &C::method, std::move(a1))); \
+    internal::PostOrRunTask(RTC_FROM_HERE, signaling_thread_,             \
+                            std::move(call));                             \
+  }
+
+#define PROXY_ASYNC_METHOD2(method, t1, t2)                          \
+  void method(t1 a1, t2 a2) override {                               \
+    std::unique_ptr<QueuedTask> call(new AsyncMethodCall<C, t1, t2>( \
+        c_.get(), &C::method, std::move(a1), std::move(a2)));        \
+    internal::PostOrRunTask(RTC_FROM_HERE, signaling_thread_,        \
+                            std::move(call));                        \
+  }
+
 // Define methods which should be invoked on the worker thread.
 #define PROXY_WORKER_METHOD0(r, method)                 \
   r method() override {                                 \
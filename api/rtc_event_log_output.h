@@ -11,7 +11,7 @@
 #ifndef API_RTC_EVENT_LOG_OUTPUT_H_
 #define API_RTC_EVENT_LOG_OUTPUT_H_
 
-#include <string>
+#include "absl/strings/string_view.h"
 
 namespace webrtc {
 
@@ -31,7 +31,7 @@ class RtcEventLogOutput {
   // about how much data was written, if any. The output sink becomes inactive
   // after the first time |false| is returned. Write() may not be called on
   // an inactive output sink.
-  virtual bool Write(const std::string& output) = 0;
+  virtual bool Write(absl::string_view output) = 0;
 
   // Indicates that buffers should be written to disk if applicable.
   virtual void Flush() {}
@@ -54,7 +54,7 @@ bool RtcEventLogOutputFile::IsActive() const {
   return IsActiveInternal();
 }
 
-bool RtcEventLogOutputFile::Write(const std::string& output) {
+bool RtcEventLogOutputFile::Write(absl::string_view output) {
   RTC_DCHECK(IsActiveInternal());
   // No single write may be so big, that it would risk overflowing the
   // calculation of (written_bytes_ + output.length()).
@@ -62,7 +62,7 @@ bool RtcEventLogOutputFile::Write(const std::string& output) {
 
   if (max_size_bytes_ == RtcEventLog::kUnlimitedOutput ||
       written_bytes_ + output.length() <= max_size_bytes_) {
-    if (file_.Write(output.c_str(), output.size())) {
+    if (file_.Write(output.data(), output.size())) {
       written_bytes_ += output.size();
       return true;
     } else {
@@ -16,6 +16,7 @@
 
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "api/rtc_event_log_output.h"
 #include "rtc_base/system/file_wrapper.h"
 
@@ -37,7 +38,7 @@ class RtcEventLogOutputFile final : public RtcEventLogOutput {
 
   bool IsActive() const override;
 
-  bool Write(const std::string& output) override;
+  bool Write(absl::string_view output) override;
 
  private:
   RtcEventLogOutputFile(FileWrapper file, size_t max_size_bytes);
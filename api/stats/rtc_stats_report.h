@@ -62,6 +62,12 @@ class RTC_EXPORT RTCStatsReport : public rtc::RefCountInterface {
   explicit RTCStatsReport(int64_t timestamp_us);
   RTCStatsReport(const RTCStatsReport& other) = delete;
   rtc::scoped_refptr<RTCStatsReport> Copy() const;
+  // Copies the stats objects that are not in |previous|, or that differ from
+  // their counterpart there in any member. Timestamps are not compared, so a
+  // report polled periodically yields only what changed since the last poll.
+  // The copy has the timestamp of this report.
+  rtc::scoped_refptr<RTCStatsReport> CopyChangedSince(
+      const RTCStatsReport& previous) const;
 
   int64_t timestamp_us() const { return timestamp_us_; }
   void AddStats(std::unique_ptr<const RTCStats> stats);
@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_STATS_RTC_STATS_SNAPSHOT_H_
+#define API_STATS_RTC_STATS_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+#include "api/stats/rtc_stats.h"
+#include "api/stats/rtc_stats_report.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace webrtc {
+
+// A snapshot is a compact binary form of an |RTCStatsReport|, meant for
+// shipping and aggregating stats in bulk. It lists a schema for each stats
+// type in the report: the type, and the name and |RTCStatsMemberInterface::
+// Type| of each member in |RTCStats::Members| order. Each member of an object
+// has a slot at a fixed offset given by its index in the schema, so that e.g.
+// the packets received of all the inbound RTP streams are read without looking
+// up names or parsing text.
+//
+// Layout, in host byte order:
+//   uint32 magic ("RTCS"), uint32 version, int64 timestamp_us,
+//   uint32 number of schemas, uint32 number of objects.
+//   Per schema: type, uint16 number of members, then per member: uint8 type,
+//   name. Strings in the header are a uint16 size followed by the characters.
+//   Per object: uint32 size of the object, uint16 schema index,
+//   int64 timestamp_us, id, a bitmap of the defined members, and an 8 byte
+//   slot per member, followed by the data of the variable sized members.
+//   Scalars are stored at the start of their slot. Strings and sequences store
+//   the uint32 offset and uint32 size of their data in their slot. Sequences
+//   of strings are stored as a uint32 size followed by the characters, for
+//   each string.
+
+// Writes |report| as a snapshot to |buffer|, replacing its contents. Apart
+// from the growth of |buffer|, which is avoided by reusing it, this allocates
+// per stats type and object, but not per member.
+RTC_EXPORT void WriteRTCStatsSnapshot(const RTCStatsReport& report,
+                                      std::vector<uint8_t>* buffer);
+
+// Reads a snapshot in place. The snapshot must outlive the reader.
+class RTC_EXPORT RTCStatsSnapshotReader {
+ public:
+  struct Member {
+    absl::string_view name;
+    RTCStatsMemberInterface::Type type;
+  };
+
+  struct Schema {
+    Schema();
+    Schema(const Schema&);
+    ~Schema();
+
+    absl::string_view type;
+    std::vector<Member> members;
+  };
+
+  class Object {
+   public:
+    size_t schema_index() const { return schema_index_; }
+    absl::string_view id() const { return id_; }
+    int64_t timestamp_us() const { return timestamp_us_; }
+
+    bool IsDefined(size_t member_index) const;
+    // Reads a defined scalar member; |T| must match the type of the member.
+    template <typename T>
+    T GetValue(size_t member_index) const {
+      RTC_DCHECK(IsDefined(member_index));
+      T value;
+      memcpy(&value, Slot(member_index), sizeof(T));
+      return value;
+    }
+    // Read defined strings and sequences; |T| must match the type of the
+    // elements.
+    absl::string_view GetString(size_t member_index) const;
+    template <typename T>
+    std::vector<T> GetSequence(size_t member_index) const {
+      rtc::ArrayView<const uint8_t> data = Data(member_index);
+      std::vector<T> sequence;
+      sequence.reserve(data.size() / sizeof(T));
+      for (size_t i = 0; i + sizeof(T) <= data.size(); i += sizeof(T)) {
+        T value;
+        memcpy(&value, &data[i], sizeof(T));
+        sequence.push_back(value);
+      }
+      return sequence;
+    }
+    std::vector<absl::string_view> GetStringSequence(
+        size_t member_index) const;
+
+   private:
+    friend class RTCStatsSnapshotReader;
+
+    const uint8_t* Slot(size_t member_index) const;
+    rtc::ArrayView<const uint8_t> Data(size_t member_index) const;
+
+    size_t schema_index_ = 0;
+    size_t num_members_ = 0;
+    int64_t timestamp_us_ = 0;
+    absl::string_view id_;
+    const uint8_t* defined_members_ = nullptr;
+    const uint8_t* slots_ = nullptr;
+    rtc::ArrayView<const uint8_t> data_;
+  };
+
+  RTCStatsSnapshotReader();
+  ~RTCStatsSnapshotReader();
+
+  // Returns false, leaving the reader empty, if |snapshot| is malformed.
+  bool Parse(rtc::ArrayView<const uint8_t> snapshot);
+
+  int64_t timestamp_us() const { return timestamp_us_; }
+  const std::vector<Schema>& schemas() const { return schemas_; }
+  const std::vector<Object>& objects() const { return objects_; }
+
+  // Return the index of the schema of |type| or of its member |name|, or -1 if
+  // there is none.
+  int FindSchema(absl::string_view type) const;
+  int FindMember(size_t schema_index, absl::string_view name) const;
+
+ private:
+  bool ParseObject(rtc::ArrayView<const uint8_t> data);
+
+  int64_t timestamp_us_ = 0;
+  std::vector<Schema> schemas_;
+  std::vector<Object> objects_;
+};
+
+}  // namespace webrtc
+
+#endif  // API_STATS_RTC_STATS_SNAPSHOT_H_
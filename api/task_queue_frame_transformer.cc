@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/task_queue_frame_transformer.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace {
+
+class TaskQueueFrameTransformer : public FrameTransformerInterface {
+ public:
+  TaskQueueFrameTransformer(
+      rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+      TaskQueueFactory* task_queue_factory)
+      : frame_transformer_(std::move(frame_transformer)),
+        task_queue_factory_(task_queue_factory) {}
+
+  void Transform(std::unique_ptr<TransformableFrameInterface> frame) override {
+    // The task keeps |frame_transformer_| alive rather than |this|, so that
+    // the task queues are never deleted from one of their own tasks.
+    GetTaskQueue(frame->GetSsrc())
+        ->PostTask([frame_transformer = frame_transformer_,
+                    frame = std::move(frame)]() mutable {
+          frame_transformer->Transform(std::move(frame));
+        });
+  }
+
+  void RegisterTransformedFrameCallback(
+      rtc::scoped_refptr<TransformedFrameCallback> callback) override {
+    frame_transformer_->RegisterTransformedFrameCallback(std::move(callback));
+  }
+  void RegisterTransformedFrameSinkCallback(
+      rtc::scoped_refptr<TransformedFrameCallback> callback,
+      uint32_t ssrc) override {
+    frame_transformer_->RegisterTransformedFrameSinkCallback(
+        std::move(callback), ssrc);
+  }
+  void UnregisterTransformedFrameCallback() override {
+    frame_transformer_->UnregisterTransformedFrameCallback();
+  }
+  void UnregisterTransformedFrameSinkCallback(uint32_t ssrc) override {
+    frame_transformer_->UnregisterTransformedFrameSinkCallback(ssrc);
+  }
+
+ private:
+  rtc::TaskQueue* GetTaskQueue(uint32_t ssrc) {
+    rtc::CritScope lock(&lock_);
+    std::unique_ptr<rtc::TaskQueue>& task_queue = task_queues_[ssrc];
+    if (!task_queue) {
+      task_queue = std::make_unique<rtc::TaskQueue>(
+          task_queue_factory_->CreateTaskQueue(
+              "FrameTransformer", TaskQueueFactory::Priority::NORMAL));
+    }
+    return task_queue.get();
+  }
+
+  const rtc::scoped_refptr<FrameTransformerInterface> frame_transformer_;
+  TaskQueueFactory* const task_queue_factory_;
+  rtc::CriticalSection lock_;
+  std::map<uint32_t, std::unique_ptr<rtc::TaskQueue>> task_queues_
+      RTC_GUARDED_BY(lock_);
+};
+
+}  // namespace
+
+rtc::scoped_refptr<FrameTransformerInterface> CreateTaskQueueFrameTransformer(
+    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+    TaskQueueFactory* task_queue_factory) {
+  RTC_DCHECK(frame_transformer);
+  RTC_DCHECK(task_queue_factory);
+  return new rtc::RefCountedObject<TaskQueueFrameTransformer>(
+      std::move(frame_transformer), task_queue_factory);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,32 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_TASK_QUEUE_FRAME_TRANSFORMER_H_
+#define API_TASK_QUEUE_FRAME_TRANSFORMER_H_
+
+#include "api/frame_transformer_interface.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
+
+namespace webrtc {
+
+// Wraps |frame_transformer| so that it transforms the frames on task queues
+// created with |task_queue_factory|, one per SSRC, rather than on the encoder
+// and network threads that pass the frames in. The frames of an SSRC are
+// still transformed one at a time and in order. With a factory from
+// CreateTaskQueuePoolFactory(), all SSRCs share a fixed pool of threads.
+// |task_queue_factory| must outlive the returned transformer.
+rtc::scoped_refptr<FrameTransformerInterface> CreateTaskQueueFrameTransformer(
+    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+    TaskQueueFactory* task_queue_factory);
+
+}  // namespace webrtc
+
+#endif  // API_TASK_QUEUE_FRAME_TRANSFORMER_H_
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/task_queue_frame_transformer.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_base.h"
+#include "rtc_base/event.h"
+#include "rtc_base/ref_counted_object.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/mock_frame_transformer.h"
+#include "test/mock_transformable_frame.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr int kTimeoutMs = 1000;
+
+std::unique_ptr<TransformableFrameInterface> CreateFrame(uint32_t ssrc,
+                                                         uint32_t timestamp) {
+  auto frame = std::make_unique<NiceMock<MockTransformableFrame>>();
+  ON_CALL(*frame, GetSsrc).WillByDefault(Return(ssrc));
+  ON_CALL(*frame, GetTimestamp).WillByDefault(Return(timestamp));
+  return frame;
+}
+
+TEST(TaskQueueFrameTransformerTest, TransformsInOrderOnTaskQueuePerSsrc) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  rtc::scoped_refptr<MockFrameTransformer> mock_frame_transformer =
+      new rtc::RefCountedObject<NiceMock<MockFrameTransformer>>();
+  rtc::scoped_refptr<FrameTransformerInterface> frame_transformer =
+      CreateTaskQueueFrameTransformer(mock_frame_transformer,
+                                      task_queue_factory.get());
+
+  std::vector<uint32_t> timestamps[2];
+  TaskQueueBase* task_queues[2] = {nullptr, nullptr};
+  rtc::Event done[2];
+  ON_CALL(*mock_frame_transformer, Transform)
+      .WillByDefault([&](std::unique_ptr<TransformableFrameInterface> frame) {
+        const uint32_t ssrc = frame->GetSsrc();
+        EXPECT_TRUE(!task_queues[ssrc] ||
+                    task_queues[ssrc] == TaskQueueBase::Current());
+        task_queues[ssrc] = TaskQueueBase::Current();
+        timestamps[ssrc].push_back(frame->GetTimestamp());
+        if (timestamps[ssrc].size() == 3)
+          done[ssrc].Set();
+      });
+
+  for (uint32_t timestamp = 1; timestamp <= 3; ++timestamp) {
+    frame_transformer->Transform(CreateFrame(0, timestamp));
+    frame_transformer->Transform(CreateFrame(1, timestamp));
+  }
+  ASSERT_TRUE(done[0].Wait(kTimeoutMs));
+  ASSERT_TRUE(done[1].Wait(kTimeoutMs));
+
+  EXPECT_THAT(timestamps[0], ElementsAre(1, 2, 3));
+  EXPECT_THAT(timestamps[1], ElementsAre(1, 2, 3));
+  EXPECT_TRUE(task_queues[0]);
+  EXPECT_TRUE(task_queues[1]);
+  EXPECT_NE(task_queues[0], task_queues[1]);
+}
+
+TEST(TaskQueueFrameTransformerTest, ForwardsCallbackRegistration) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  rtc::scoped_refptr<MockFrameTransformer> mock_frame_transformer =
+      new rtc::RefCountedObject<MockFrameTransformer>();
+  rtc::scoped_refptr<FrameTransformerInterface> frame_transformer =
+      CreateTaskQueueFrameTransformer(mock_frame_transformer,
+                                      task_queue_factory.get());
+
+  EXPECT_CALL(*mock_frame_transformer, RegisterTransformedFrameCallback);
+  EXPECT_CALL(*mock_frame_transformer,
+              RegisterTransformedFrameSinkCallback(_, 1u));
+  EXPECT_CALL(*mock_frame_transformer, UnregisterTransformedFrameCallback);
+  EXPECT_CALL(*mock_frame_transformer,
+              UnregisterTransformedFrameSinkCallback(1u));
+  frame_transformer->RegisterTransformedFrameCallback(nullptr);
+  frame_transformer->RegisterTransformedFrameSinkCallback(nullptr, 1);
+  frame_transformer->UnregisterTransformedFrameCallback();
+  frame_transformer->UnregisterTransformedFrameSinkCallback(1);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -17,9 +17,12 @@
 
 namespace webrtc {
 
-// Returns a non-null NetworkEmulationManager instance.
+// Returns a non-null NetworkEmulationManager instance. The emulated nodes
+// and endpoints are spread over |num_task_queues| task queues, which lets
+// large real time emulations use more than one core.
 std::unique_ptr<NetworkEmulationManager> CreateNetworkEmulationManager(
-    TimeMode mode = TimeMode::kRealTime);
+    TimeMode mode = TimeMode::kRealTime,
+    int num_task_queues = 1);
 
 }  // namespace webrtc
 
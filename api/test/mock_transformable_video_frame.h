@@ -23,6 +23,7 @@ class MockTransformableVideoFrame
  public:
   MOCK_METHOD(rtc::ArrayView<const uint8_t>, GetData, (), (const override));
   MOCK_METHOD(void, SetData, (rtc::ArrayView<const uint8_t> data), (override));
+  MOCK_METHOD(rtc::ArrayView<uint8_t>, GetMutableData, (size_t), (override));
   MOCK_METHOD(uint32_t, GetTimestamp, (), (const override));
   MOCK_METHOD(uint32_t, GetSsrc, (), (const, override));
   MOCK_METHOD(bool, IsKeyFrame, (), (const, override));
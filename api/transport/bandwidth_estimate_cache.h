@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_TRANSPORT_BANDWIDTH_ESTIMATE_CACHE_H_
+#define API_TRANSPORT_BANDWIDTH_ESTIMATE_CACHE_H_
+
+#include "absl/types/optional.h"
+#include "api/units/data_rate.h"
+#include "rtc_base/network_route.h"
+
+namespace webrtc {
+
+// Remembers bandwidth estimates between calls, so that a call can start from
+// the estimate that an earlier call on a similar network route ended with,
+// rather than from the configured start bitrate. It is up to the
+// implementation how routes are told apart, e.g. by adapter type and whether
+// they are relayed, and whether the estimates are persisted.
+//
+// Called on the transport controller task queues of all calls that use it, so
+// implementations must be thread safe.
+class BandwidthEstimateCache {
+ public:
+  virtual ~BandwidthEstimateCache() = default;
+
+  // Returns the estimate to start from on |route|, or null to start from the
+  // configured start bitrate. Called when a call first connects.
+  virtual absl::optional<DataRate> GetEstimate(
+      const rtc::NetworkRoute& route) = 0;
+
+  // Called with the last estimate of a call on |route| when the call ends or
+  // moves to another route.
+  virtual void StoreEstimate(const rtc::NetworkRoute& route,
+                             DataRate estimate) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // API_TRANSPORT_BANDWIDTH_ESTIMATE_CACHE_H_
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <utility>
 
@@ -62,6 +63,124 @@ const char EMPTY_TRANSACTION_ID[] = "0000000000000000";
 const uint32_t STUN_FINGERPRINT_XOR_VALUE = 0x5354554E;
 const int SERVER_NOT_REACHABLE_ERROR = 701;
 
+namespace {
+
+// Bounds the HMAC keys cached per thread, each of which holds three digest
+// states. The cache is cleared when full.
+const size_t kMaxCachedHmacKeys = 1024;
+
+// Computes the HMAC-SHA1 of the concatenation of |inputs| with |key|. All
+// checks and responses of a session use the same couple of credentials, so the
+// keyed digest states of the credentials used on this thread are cached, which
+// saves hashing the padded key twice per message.
+size_t ComputeStunHmac(
+    absl::string_view key,
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> inputs,
+    char* hmac,
+    size_t hmac_size) {
+  static thread_local std::map<std::string,
+                               std::unique_ptr<rtc::PrecomputedHmac>,
+                               std::less<>>
+      hmacs_by_key;
+  auto it = hmacs_by_key.find(key);
+  if (it == hmacs_by_key.end()) {
+    if (hmacs_by_key.size() >= kMaxCachedHmacKeys) {
+      hmacs_by_key.clear();
+    }
+    it = hmacs_by_key
+             .emplace(std::string(key),
+                      rtc::PrecomputedHmac::Create(rtc::DIGEST_SHA_1,
+                                                   key.data(), key.size()))
+             .first;
+    RTC_DCHECK(it->second);
+  }
+  return it->second->Compute(inputs, hmac, hmac_size);
+}
+
+// Verifies a STUN message has a valid MESSAGE-INTEGRITY attribute, using the
+// procedure outlined in RFC 5389, section 15.4. The HMAC is computed in place,
+// with the message length of the header adjusted to end at the attribute.
+bool ValidateMessageIntegrityInPlace(int mi_attr_type,
+                                     size_t mi_attr_size,
+                                     const char* data,
+                                     size_t size,
+                                     absl::string_view password) {
+  RTC_DCHECK(mi_attr_size <= kStunMessageIntegritySize);
+
+  // Verifying the size of the message.
+  if ((size % 4) != 0 || size < kStunHeaderSize) {
+    return false;
+  }
+
+  // Getting the message length from the STUN header.
+  uint16_t msg_length = rtc::GetBE16(&data[2]);
+  if (size != (msg_length + kStunHeaderSize)) {
+    return false;
+  }
+
+  // Finding Message Integrity attribute in stun message.
+  size_t current_pos = kStunHeaderSize;
+  bool has_message_integrity_attr = false;
+  while (current_pos + 4 <= size) {
+    uint16_t attr_type, attr_length;
+    // Getting attribute type and length.
+    attr_type = rtc::GetBE16(&data[current_pos]);
+    attr_length = rtc::GetBE16(&data[current_pos + sizeof(attr_type)]);
+
+    // If M-I, sanity check it, and break out.
+    if (attr_type == mi_attr_type) {
+      if (attr_length != mi_attr_size ||
+          current_pos + sizeof(attr_type) + sizeof(attr_length) + attr_length >
+              size) {
+        return false;
+      }
+      has_message_integrity_attr = true;
+      break;
+    }
+
+    // Otherwise, skip to the next attribute.
+    current_pos += sizeof(attr_type) + sizeof(attr_length) + attr_length;
+    if ((attr_length % 4) != 0) {
+      current_pos += (4 - (attr_length % 4));
+    }
+  }
+
+  if (!has_message_integrity_attr) {
+    return false;
+  }
+
+  // The length in the header counts the attributes up to, and including,
+  // MESSAGE-INTEGRITY.
+  //      0                   1                   2                   3
+  //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //     |0 0|     STUN Message Type     |         Message Length        |
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  const size_t mi_pos = current_pos;
+  uint8_t adjusted_length[2];
+  rtc::SetBE16(adjusted_length,
+               static_cast<uint16_t>(mi_pos + kStunAttributeHeaderSize +
+                                     mi_attr_size - kStunHeaderSize));
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  const rtc::ArrayView<const uint8_t> hmac_input[] = {
+      rtc::ArrayView<const uint8_t>(bytes, 2),
+      rtc::ArrayView<const uint8_t>(adjusted_length, 2),
+      rtc::ArrayView<const uint8_t>(bytes + 4, mi_pos - 4)};
+
+  char hmac[kStunMessageIntegritySize];
+  size_t ret = ComputeStunHmac(password, hmac_input, hmac, sizeof(hmac));
+  RTC_DCHECK(ret == sizeof(hmac));
+  if (ret != sizeof(hmac)) {
+    return false;
+  }
+
+  // Comparing the calculated HMAC with the one present in the message.
+  return memcmp(data + mi_pos + kStunAttributeHeaderSize, hmac,
+                mi_attr_size) == 0;
+}
+
+}  // namespace
+
 // StunMessage
 
 StunMessage::StunMessage()
@@ -217,89 +336,13 @@ bool StunMessage::ValidateMessageIntegrity32(const char* data,
                                         password);
 }
 
-// Verifies a STUN message has a valid MESSAGE-INTEGRITY attribute, using the
-// procedure outlined in RFC 5389, section 15.4.
 bool StunMessage::ValidateMessageIntegrityOfType(int mi_attr_type,
                                                  size_t mi_attr_size,
                                                  const char* data,
                                                  size_t size,
                                                  const std::string& password) {
-  RTC_DCHECK(mi_attr_size <= kStunMessageIntegritySize);
-
-  // Verifying the size of the message.
-  if ((size % 4) != 0 || size < kStunHeaderSize) {
-    return false;
-  }
-
-  // Getting the message length from the STUN header.
-  uint16_t msg_length = rtc::GetBE16(&data[2]);
-  if (size != (msg_length + kStunHeaderSize)) {
-    return false;
-  }
-
-  // Finding Message Integrity attribute in stun message.
-  size_t current_pos = kStunHeaderSize;
-  bool has_message_integrity_attr = false;
-  while (current_pos + 4 <= size) {
-    uint16_t attr_type, attr_length;
-    // Getting attribute type and length.
-    attr_type = rtc::GetBE16(&data[current_pos]);
-    attr_length = rtc::GetBE16(&data[current_pos + sizeof(attr_type)]);
-
-    // If M-I, sanity check it, and break out.
-    if (attr_type == mi_attr_type) {
-      if (attr_length != mi_attr_size ||
-          current_pos + sizeof(attr_type) + sizeof(attr_length) + attr_length >
-              size) {
-        return false;
-      }
-      has_message_integrity_attr = true;
-      break;
-    }
-
-    // Otherwise, skip to the next attribute.
-    current_pos += sizeof(attr_type) + sizeof(attr_length) + attr_length;
-    if ((attr_length % 4) != 0) {
-      current_pos += (4 - (attr_length % 4));
-    }
-  }
-
-  if (!has_message_integrity_attr) {
-    return false;
-  }
-
-  // Getting length of the message to calculate Message Integrity.
-  size_t mi_pos = current_pos;
-  std::unique_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
-  if (size > mi_pos + kStunAttributeHeaderSize + mi_attr_size) {
-    // Stun message has other attributes after message integrity.
-    // Adjust the length parameter in stun message to calculate HMAC.
-    size_t extra_offset =
-        size - (mi_pos + kStunAttributeHeaderSize + mi_attr_size);
-    size_t new_adjusted_len = size - extra_offset - kStunHeaderSize;
-
-    // Writing new length of the STUN message @ Message Length in temp buffer.
-    //      0                   1                   2                   3
-    //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    //     |0 0|     STUN Message Type     |         Message Length        |
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2, static_cast<uint16_t>(new_adjusted_len));
-  }
-
-  char hmac[kStunMessageIntegritySize];
-  size_t ret =
-      rtc::ComputeHmac(rtc::DIGEST_SHA_1, password.c_str(), password.size(),
-                       temp_data.get(), mi_pos, hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac)) {
-    return false;
-  }
-
-  // Comparing the calculated HMAC with the one present in the message.
-  return memcmp(data + current_pos + kStunAttributeHeaderSize, hmac,
-                mi_attr_size) == 0;
+  return ValidateMessageIntegrityInPlace(mi_attr_type, mi_attr_size, data,
+                                         size, password);
 }
 
 bool StunMessage::AddMessageIntegrity(const std::string& password) {
@@ -336,11 +379,14 @@ bool StunMessage::AddMessageIntegrityOfType(int attr_type,
   if (!Write(&buf))
     return false;
 
-  int msg_len_for_hmac = static_cast<int>(
-      buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length());
+  size_t msg_len_for_hmac =
+      buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length();
+  const rtc::ArrayView<const uint8_t> hmac_input[] = {
+      rtc::ArrayView<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(buf.Data()), msg_len_for_hmac)};
   char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1, key, keylen, buf.Data(),
-                                msg_len_for_hmac, hmac, sizeof(hmac));
+  size_t ret = ComputeStunHmac(absl::string_view(key, keylen), hmac_input, hmac,
+                               sizeof(hmac));
   RTC_DCHECK(ret == sizeof(hmac));
   if (ret != sizeof(hmac)) {
     RTC_LOG(LS_ERROR) << "HMAC computation failed. Message-Integrity "
@@ -630,6 +676,102 @@ bool StunMessage::EqualAttributes(
   return true;
 }
 
+// StunMessageView
+
+StunMessageView::StunMessageView() : data_(nullptr), size_(0) {}
+
+bool StunMessageView::Parse(const char* data, size_t size) {
+  data_ = nullptr;
+  size_ = 0;
+  if (size < kStunHeaderSize || (size % 4) != 0) {
+    return false;
+  }
+  // Like StunMessage::Read(), reject RTP and RTCP, which set the MSB.
+  if (rtc::GetBE16(data) & 0x8000) {
+    return false;
+  }
+  if (rtc::GetBE16(data + 2) != size - kStunHeaderSize) {
+    return false;
+  }
+  // Since the size is a multiple of 4, so is the start of each attribute, and
+  // every attribute header is inside the message.
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    const size_t length = rtc::GetBE16(data + pos + 2);
+    pos += kStunAttributeHeaderSize + ((length + 3) & ~size_t{3});
+  }
+  if (pos != size) {
+    return false;
+  }
+  data_ = data;
+  size_ = size;
+  return true;
+}
+
+int StunMessageView::type() const {
+  RTC_DCHECK(data_);
+  return rtc::GetBE16(data_);
+}
+
+bool StunMessageView::IsLegacy() const {
+  RTC_DCHECK(data_);
+  return rtc::GetBE32(data_ + kStunTransactionIdOffset -
+                      kStunMagicCookieLength) != kStunMagicCookie;
+}
+
+absl::string_view StunMessageView::transaction_id() const {
+  if (IsLegacy()) {
+    return absl::string_view(
+        data_ + kStunTransactionIdOffset - kStunMagicCookieLength,
+        kStunLegacyTransactionIdLength);
+  }
+  return absl::string_view(data_ + kStunTransactionIdOffset,
+                           kStunTransactionIdLength);
+}
+
+bool StunMessageView::GetAttribute(int type, absl::string_view* value) const {
+  size_t pos = kStunHeaderSize;
+  while (pos < size_) {
+    const size_t length = rtc::GetBE16(data_ + pos + 2);
+    if (rtc::GetBE16(data_ + pos) == type) {
+      if (value) {
+        *value = absl::string_view(data_ + pos + kStunAttributeHeaderSize,
+                                   length);
+      }
+      return true;
+    }
+    pos += kStunAttributeHeaderSize + ((length + 3) & ~size_t{3});
+  }
+  return false;
+}
+
+bool StunMessageView::GetUInt32(int type, uint32_t* value) const {
+  absl::string_view attr;
+  if (!GetAttribute(type, &attr) || attr.size() != StunUInt32Attribute::SIZE) {
+    return false;
+  }
+  *value = rtc::GetBE32(attr.data());
+  return true;
+}
+
+bool StunMessageView::ValidateMessageIntegrity(
+    absl::string_view password) const {
+  return ValidateMessageIntegrityInPlace(STUN_ATTR_MESSAGE_INTEGRITY,
+                                         kStunMessageIntegritySize, data_,
+                                         size_, password);
+}
+
+bool StunMessageView::ValidateMessageIntegrity32(
+    absl::string_view password) const {
+  return ValidateMessageIntegrityInPlace(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32,
+                                         kStunMessageIntegrity32Size, data_,
+                                         size_, password);
+}
+
+bool StunMessageView::ValidateFingerprint() const {
+  return StunMessage::ValidateFingerprint(data_, size_);
+}
+
 // StunAttribute
 
 StunAttribute::StunAttribute(uint16_t type, uint16_t length)
@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
 #include "rtc_base/byte_buffer.h"
 #include "rtc_base/ip_address.h"
 #include "rtc_base/socket_address.h"
@@ -270,6 +272,41 @@ class StunMessage {
   uint32_t stun_magic_cookie_;
 };
 
+// A read-only view of a STUN message in a buffer owned by the caller, for hot
+// paths that only look at the header and a few attributes. Unlike
+// StunMessage::Read(), Parse() neither allocates nor copies: attributes are
+// found by walking the buffer, and are returned as views into it. The buffer
+// must outlive the view.
+class StunMessageView {
+ public:
+  StunMessageView();
+
+  // Checks the header of the |size| bytes of |data|, and that the attributes
+  // exactly fill the message. Returns false, leaving the view empty, if this
+  // is not a well-formed STUN message.
+  bool Parse(const char* data, size_t size);
+
+  int type() const;
+  // See StunMessage::IsLegacy().
+  bool IsLegacy() const;
+  absl::string_view transaction_id() const;
+
+  // Points |value| at the value of the first attribute of |type|, without its
+  // padding, and returns true, or returns false if there is none. |value| may
+  // be null to only check that the attribute is present.
+  bool GetAttribute(int type, absl::string_view* value) const;
+  bool GetUInt32(int type, uint32_t* value) const;
+
+  // Like the StunMessage functions of the same names, on the viewed buffer.
+  bool ValidateMessageIntegrity(absl::string_view password) const;
+  bool ValidateMessageIntegrity32(absl::string_view password) const;
+  bool ValidateFingerprint() const;
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
 // Base class for all STUN/TURN attributes.
 class StunAttribute {
  public:
@@ -12,6 +12,7 @@
 
 #include <string>
 
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "rtc_base/system/rtc_export.h"
 
@@ -27,6 +28,15 @@ class RTC_EXPORT WebRtcKeyValueConfig {
   virtual ~WebRtcKeyValueConfig() = default;
   // The configured value for the given key. Defaults to an empty string.
   virtual std::string Lookup(absl::string_view key) const = 0;
+
+  // Whether the value for |key| starts with "Enabled" or "Disabled",
+  // respectively.
+  bool IsEnabled(absl::string_view key) const {
+    return absl::StartsWith(Lookup(key), "Enabled");
+  }
+  bool IsDisabled(absl::string_view key) const {
+    return absl::StartsWith(Lookup(key), "Disabled");
+  }
 };
 }  // namespace webrtc
 
@@ -20,9 +20,6 @@
 #include "third_party/libyuv/include/libyuv/planar_functions.h"
 #include "third_party/libyuv/include/libyuv/scale.h"
 
-// Aligning pointer to 64 bytes for improved performance, e.g. use SIMD.
-static const int kBufferAlignment = 64;
-
 namespace webrtc {
 
 namespace {
@@ -41,14 +38,30 @@ I420Buffer::I420Buffer(int width,
                        int stride_y,
                        int stride_u,
                        int stride_v)
+    : I420Buffer(width,
+                 height,
+                 stride_y,
+                 stride_u,
+                 stride_v,
+                 GetDefaultBufferAllocator()) {}
+
+I420Buffer::I420Buffer(int width,
+                       int height,
+                       int stride_y,
+                       int stride_u,
+                       int stride_v,
+                       BufferAllocator* allocator)
     : width_(width),
       height_(height),
       stride_y_(stride_y),
       stride_u_(stride_u),
       stride_v_(stride_v),
-      data_(static_cast<uint8_t*>(
-          AlignedMalloc(I420DataSize(height, stride_y, stride_u, stride_v),
-                        kBufferAlignment))) {
+      data_(static_cast<uint8_t*>(allocator->Allocate(
+                I420DataSize(height, stride_y, stride_u, stride_v))),
+            BufferAllocatorDeleter{
+                allocator,
+                static_cast<size_t>(
+                    I420DataSize(height, stride_y, stride_u, stride_v))}) {
   RTC_DCHECK_GT(width, 0);
   RTC_DCHECK_GT(height, 0);
   RTC_DCHECK_GE(stride_y, width);
@@ -104,10 +117,6 @@ rtc::scoped_refptr<I420Buffer> I420Buffer::Copy(int width,
 rtc::scoped_refptr<I420Buffer> I420Buffer::Rotate(
     const I420BufferInterface& src,
     VideoRotation rotation) {
-  RTC_CHECK(src.DataY());
-  RTC_CHECK(src.DataU());
-  RTC_CHECK(src.DataV());
-
   int rotated_width = src.width();
   int rotated_height = src.height();
   if (rotation == webrtc::kVideoRotation_90 ||
@@ -117,15 +126,7 @@ rtc::scoped_refptr<I420Buffer> I420Buffer::Rotate(
 
   rtc::scoped_refptr<webrtc::I420Buffer> buffer =
       I420Buffer::Create(rotated_width, rotated_height);
-
-  RTC_CHECK_EQ(0,
-               libyuv::I420Rotate(
-                   src.DataY(), src.StrideY(), src.DataU(), src.StrideU(),
-                   src.DataV(), src.StrideV(), buffer->MutableDataY(),
-                   buffer->StrideY(), buffer->MutableDataU(), buffer->StrideU(),
-                   buffer->MutableDataV(), buffer->StrideV(), src.width(),
-                   src.height(), static_cast<libyuv::RotationMode>(rotation)));
-
+  buffer->RotateFrom(src, rotation);
   return buffer;
 }
 
@@ -227,6 +228,25 @@ void I420Buffer::ScaleFrom(const I420BufferInterface& src) {
   CropAndScaleFrom(src, 0, 0, src.width(), src.height());
 }
 
+void I420Buffer::RotateFrom(const I420BufferInterface& src,
+                            VideoRotation rotation) {
+  RTC_CHECK(src.DataY());
+  RTC_CHECK(src.DataU());
+  RTC_CHECK(src.DataV());
+  const bool transposed = rotation == webrtc::kVideoRotation_90 ||
+                          rotation == webrtc::kVideoRotation_270;
+  RTC_CHECK_EQ(width(), transposed ? src.height() : src.width());
+  RTC_CHECK_EQ(height(), transposed ? src.width() : src.height());
+
+  RTC_CHECK_EQ(0,
+               libyuv::I420Rotate(
+                   src.DataY(), src.StrideY(), src.DataU(), src.StrideU(),
+                   src.DataV(), src.StrideV(), MutableDataY(), StrideY(),
+                   MutableDataU(), StrideU(), MutableDataV(), StrideV(),
+                   src.width(), src.height(),
+                   static_cast<libyuv::RotationMode>(rotation)));
+}
+
 void I420Buffer::PasteFrom(const I420BufferInterface& picture,
                            int offset_col,
                            int offset_row) {
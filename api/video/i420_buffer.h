@@ -18,7 +18,7 @@
 #include "api/scoped_refptr.h"
 #include "api/video/video_frame_buffer.h"
 #include "api/video/video_rotation.h"
-#include "rtc_base/memory/aligned_malloc.h"
+#include "rtc_base/memory/buffer_allocator.h"
 #include "rtc_base/system/rtc_export.h"
 
 namespace webrtc {
@@ -98,6 +98,10 @@ class RTC_EXPORT I420Buffer : public I420BufferInterface {
   // Scale all of |src| to the size of |this| buffer, with no cropping.
   void ScaleFrom(const I420BufferInterface& src);
 
+  // Writes |src| rotated by |rotation| into |this| buffer, which must have the
+  // size of the rotated |src|.
+  void RotateFrom(const I420BufferInterface& src, VideoRotation rotation);
+
   // Pastes whole picture to canvas at (offset_row, offset_col).
   // Offsets and picture dimensions must be even.
   void PasteFrom(const I420BufferInterface& picture,
@@ -107,6 +111,13 @@ class RTC_EXPORT I420Buffer : public I420BufferInterface {
  protected:
   I420Buffer(int width, int height);
   I420Buffer(int width, int height, int stride_y, int stride_u, int stride_v);
+  // Allocates the planes with |allocator|, which must outlive the buffer.
+  I420Buffer(int width,
+             int height,
+             int stride_y,
+             int stride_u,
+             int stride_v,
+             BufferAllocator* allocator);
 
   ~I420Buffer() override;
 
@@ -116,7 +127,7 @@ class RTC_EXPORT I420Buffer : public I420BufferInterface {
   const int stride_y_;
   const int stride_u_;
   const int stride_v_;
-  const std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
+  const std::unique_ptr<uint8_t, BufferAllocatorDeleter> data_;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video/nv12_buffer.h"
+
+#include "api/video/i420_buffer.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kWidth = 16;
+constexpr int kHeight = 8;
+
+rtc::scoped_refptr<I420Buffer> CreateGradient(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x)
+      buffer->MutableDataY()[y * buffer->StrideY() + x] = x + y;
+  }
+  for (int y = 0; y < buffer->ChromaHeight(); ++y) {
+    for (int x = 0; x < buffer->ChromaWidth(); ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] = 2 * x;
+      buffer->MutableDataV()[y * buffer->StrideV() + x] = 100 + y;
+    }
+  }
+  return buffer;
+}
+
+}  // namespace
+
+TEST(NV12BufferTest, InitialData) {
+  rtc::scoped_refptr<NV12Buffer> buffer = NV12Buffer::Create(kWidth, kHeight);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12, buffer->type());
+  EXPECT_EQ(kWidth, buffer->width());
+  EXPECT_EQ(kHeight, buffer->height());
+  EXPECT_EQ(kWidth, buffer->StrideY());
+  EXPECT_EQ(kWidth, buffer->StrideUV());
+  EXPECT_EQ(kWidth / 2, buffer->ChromaWidth());
+  EXPECT_EQ(kHeight / 2, buffer->ChromaHeight());
+  EXPECT_EQ(buffer.get(), buffer->GetNV12());
+}
+
+TEST(NV12BufferTest, CopyFromI420AndConvertBack) {
+  rtc::scoped_refptr<I420Buffer> i420 = CreateGradient(kWidth, kHeight);
+  rtc::scoped_refptr<NV12Buffer> nv12 = NV12Buffer::Copy(*i420);
+
+  for (int y = 0; y < nv12->ChromaHeight(); ++y) {
+    for (int x = 0; x < nv12->ChromaWidth(); ++x) {
+      const uint8_t* uv = nv12->DataUV() + y * nv12->StrideUV() + 2 * x;
+      EXPECT_EQ(i420->DataU()[y * i420->StrideU() + x], uv[0]);
+      EXPECT_EQ(i420->DataV()[y * i420->StrideV() + x], uv[1]);
+    }
+  }
+
+  rtc::scoped_refptr<I420BufferInterface> converted = nv12->ToI420();
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      EXPECT_EQ(i420->DataY()[y * i420->StrideY() + x],
+                converted->DataY()[y * converted->StrideY() + x]);
+    }
+  }
+  for (int y = 0; y < converted->ChromaHeight(); ++y) {
+    for (int x = 0; x < converted->ChromaWidth(); ++x) {
+      EXPECT_EQ(i420->DataU()[y * i420->StrideU() + x],
+                converted->DataU()[y * converted->StrideU() + x]);
+      EXPECT_EQ(i420->DataV()[y * i420->StrideV() + x],
+                converted->DataV()[y * converted->StrideV() + x]);
+    }
+  }
+}
+
+TEST(NV12BufferTest, CropAndScaleStaysNV12) {
+  rtc::scoped_refptr<NV12Buffer> nv12 =
+      NV12Buffer::Copy(*CreateGradient(kWidth, kHeight));
+  rtc::scoped_refptr<VideoFrameBuffer> cropped =
+      nv12->CropAndScale(4, 2, kWidth / 2, kHeight / 2, kWidth / 2,
+                         kHeight / 2);
+  ASSERT_EQ(VideoFrameBuffer::Type::kNV12, cropped->type());
+  const NV12BufferInterface* result = cropped->GetNV12();
+  EXPECT_EQ(kWidth / 2, result->width());
+  EXPECT_EQ(kHeight / 2, result->height());
+  // An unscaled crop copies the pixels at the offset.
+  EXPECT_EQ(4 + 2, result->DataY()[0]);
+  EXPECT_EQ(2 * 2, result->DataUV()[0]);
+  EXPECT_EQ(100 + 1, result->DataUV()[1]);
+}
+
+}  // namespace webrtc
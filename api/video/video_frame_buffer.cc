@@ -10,6 +10,7 @@
 
 #include "api/video/video_frame_buffer.h"
 
+#include "api/video/i420_buffer.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -20,6 +21,23 @@ const I420BufferInterface* VideoFrameBuffer::GetI420() const {
   return nullptr;
 }
 
+rtc::scoped_refptr<VideoFrameBuffer> VideoFrameBuffer::CropAndScale(
+    int offset_x,
+    int offset_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height) {
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer = ToI420();
+  if (!i420_buffer)
+    return nullptr;
+  rtc::scoped_refptr<I420Buffer> result =
+      I420Buffer::Create(scaled_width, scaled_height);
+  result->CropAndScaleFrom(*i420_buffer, offset_x, offset_y, crop_width,
+                           crop_height);
+  return result;
+}
+
 const I420ABufferInterface* VideoFrameBuffer::GetI420A() const {
   RTC_CHECK(type() == Type::kI420A);
   return static_cast<const I420ABufferInterface*>(this);
@@ -35,6 +53,11 @@ const I010BufferInterface* VideoFrameBuffer::GetI010() const {
   return static_cast<const I010BufferInterface*>(this);
 }
 
+const NV12BufferInterface* VideoFrameBuffer::GetNV12() const {
+  RTC_CHECK(type() == Type::kNV12);
+  return static_cast<const NV12BufferInterface*>(this);
+}
+
 VideoFrameBuffer::Type I420BufferInterface::type() const {
   return Type::kI420;
 }
@@ -83,4 +106,16 @@ int I010BufferInterface::ChromaHeight() const {
   return (height() + 1) / 2;
 }
 
+VideoFrameBuffer::Type NV12BufferInterface::type() const {
+  return Type::kNV12;
+}
+
+int NV12BufferInterface::ChromaWidth() const {
+  return (width() + 1) / 2;
+}
+
+int NV12BufferInterface::ChromaHeight() const {
+  return (height() + 1) / 2;
+}
+
 }  // namespace webrtc
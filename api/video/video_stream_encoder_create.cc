@@ -22,11 +22,12 @@ std::unique_ptr<VideoStreamEncoderInterface> CreateVideoStreamEncoder(
     TaskQueueFactory* task_queue_factory,
     uint32_t number_of_cores,
     VideoStreamEncoderObserver* encoder_stats_observer,
-    const VideoStreamEncoderSettings& settings) {
+    const VideoStreamEncoderSettings& settings,
+    TaskQueueFactory* encoder_queue_factory) {
   return std::make_unique<VideoStreamEncoder>(
       clock, number_of_cores, encoder_stats_observer, settings,
       std::make_unique<OveruseFrameDetector>(encoder_stats_observer),
-      task_queue_factory);
+      task_queue_factory, encoder_queue_factory);
 }
 
 }  // namespace webrtc
@@ -26,12 +26,17 @@ namespace webrtc {
 // TODO(srte): Find a way to avoid this forward declaration.
 class Clock;
 
+// If |encoder_queue_factory| is set, the encoder queue is created from it
+// instead of from |task_queue_factory|. Passing a factory that multiplexes its
+// task queues onto a shared thread pool, e.g. CreateTaskQueuePoolFactory(),
+// lets many encoders share a few threads.
 std::unique_ptr<VideoStreamEncoderInterface> CreateVideoStreamEncoder(
     Clock* clock,
     TaskQueueFactory* task_queue_factory,
     uint32_t number_of_cores,
     VideoStreamEncoderObserver* encoder_stats_observer,
-    const VideoStreamEncoderSettings& settings);
+    const VideoStreamEncoderSettings& settings,
+    TaskQueueFactory* encoder_queue_factory = nullptr);
 }  // namespace webrtc
 
 #endif  // API_VIDEO_VIDEO_STREAM_ENCODER_CREATE_H_
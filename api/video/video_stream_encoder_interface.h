@@ -99,6 +99,12 @@ class VideoStreamEncoderInterface : public rtc::VideoSinkInterface<VideoFrame> {
                                 int64_t round_trip_time_ms,
                                 double cwnd_reduce_ratio) = 0;
 
+  // Pauses encoding of the simulcast streams, or spatial layers, for which
+  // |paused_layers| is true, by allocating them no bitrate. Unlike changing
+  // VideoEncoderConfig, this does not reconfigure the encoder. Used when the
+  // remote side signals that nobody receives these layers.
+  virtual void SetPausedLayers(std::vector<bool> paused_layers) = 0;
+
   // Register observer for the bitrate allocation between the temporal
   // and spatial layers.
   virtual void SetBitrateAllocationObserver(
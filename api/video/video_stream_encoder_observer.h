@@ -66,6 +66,10 @@ class VideoStreamEncoderObserver : public CpuOveruseMetricsObserver {
 
   virtual void OnIncomingFrame(int width, int height) = 0;
 
+  // Reports how long an incoming frame waited for the encoder queue, from
+  // being posted until its task started running.
+  virtual void OnEncoderQueueDelayMeasured(int64_t queue_delay_us) {}
+
   // TODO(nisse): Merge into one callback per encoded frame.
   using CpuOveruseMetricsObserver::OnEncodedFrameTimeMeasured;
   virtual void OnSendEncodedImage(const EncodedImage& encoded_image,
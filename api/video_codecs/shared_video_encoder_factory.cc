@@ -0,0 +1,377 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video_codecs/shared_video_encoder_factory.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/video/video_frame_type.h"
+#include "api/video_codecs/video_codec.h"
+#include "api/video_codecs/video_encoder.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+namespace {
+
+bool SameSettings(const VideoCodec& a, const VideoCodec& b) {
+  if (a.codecType != b.codecType || a.width != b.width ||
+      a.height != b.height || a.maxBitrate != b.maxBitrate ||
+      a.minBitrate != b.minBitrate || a.maxFramerate != b.maxFramerate ||
+      a.qpMax != b.qpMax || a.mode != b.mode ||
+      a.expect_encode_from_texture != b.expect_encode_from_texture ||
+      a.numberOfSimulcastStreams != b.numberOfSimulcastStreams) {
+    return false;
+  }
+  for (int i = 0; i < a.numberOfSimulcastStreams; ++i) {
+    if (a.simulcastStream[i] != b.simulcastStream[i])
+      return false;
+  }
+  switch (a.codecType) {
+    case kVideoCodecVP8:
+      return a.VP8() == b.VP8();
+    case kVideoCodecVP9:
+      if (a.VP9() != b.VP9())
+        return false;
+      for (int i = 0; i < a.VP9().numberOfSpatialLayers; ++i) {
+        if (a.spatialLayers[i] != b.spatialLayers[i])
+          return false;
+      }
+      return true;
+    case kVideoCodecH264:
+      return a.H264() == b.H264();
+    default:
+      return true;
+  }
+}
+
+// One underlying encoder, initialized with one set of codec settings, and the
+// encoders handed out to the streams that use it.
+class Rendition : public EncodedImageCallback {
+ public:
+  Rendition(std::unique_ptr<VideoEncoder> encoder,
+            const VideoCodec& codec_settings,
+            const VideoEncoder::Settings& settings)
+      : encoder_(std::move(encoder)),
+        codec_settings_(codec_settings),
+        settings_(settings) {}
+
+  ~Rendition() override {
+    rtc::CritScope cs(&lock_);
+    encoder_->Release();
+  }
+
+  int32_t InitEncode() {
+    rtc::CritScope cs(&lock_);
+    int32_t result = encoder_->InitEncode(&codec_settings_, settings_);
+    if (result == WEBRTC_VIDEO_CODEC_OK)
+      encoder_->RegisterEncodeCompleteCallback(this);
+    return result;
+  }
+
+  bool Matches(const VideoCodec& codec_settings,
+               const VideoEncoder::Settings& settings) const {
+    return SameSettings(codec_settings_, codec_settings) &&
+           settings_.number_of_cores == settings.number_of_cores &&
+           settings_.max_payload_size == settings.max_payload_size &&
+           settings_.capabilities.loss_notification ==
+               settings.capabilities.loss_notification;
+  }
+
+  void AddSubscriber(EncodedImageCallback* callback) {
+    {
+      rtc::CritScope cs(&callback_lock_);
+      callbacks_.push_back(callback);
+    }
+    rtc::CritScope cs(&lock_);
+    // The new stream can only start decoding from a key frame.
+    key_frame_pending_ = true;
+  }
+
+  void RemoveSubscriber(EncodedImageCallback* callback) {
+    {
+      rtc::CritScope cs(&callback_lock_);
+      callbacks_.erase(
+          std::find(callbacks_.begin(), callbacks_.end(), callback));
+    }
+    rtc::CritScope cs(&lock_);
+    rates_.erase(callback);
+    packet_loss_rates_.erase(callback);
+    ApplyRates();
+  }
+
+  int32_t Encode(const VideoFrame& frame,
+                 const std::vector<VideoFrameType>* frame_types) {
+    rtc::CritScope cs(&lock_);
+    if (frame_types &&
+        std::find(frame_types->begin(), frame_types->end(),
+                  VideoFrameType::kVideoFrameKey) != frame_types->end()) {
+      key_frame_pending_ = true;
+    }
+    // Another stream has already encoded this frame and its output has been
+    // delivered to every stream.
+    if (last_timestamp_ == frame.timestamp())
+      return WEBRTC_VIDEO_CODEC_OK;
+    last_timestamp_ = frame.timestamp();
+
+    const size_t num_streams =
+        frame_types ? frame_types->size()
+                    : std::max<size_t>(codec_settings_.numberOfSimulcastStreams,
+                                       1);
+    std::vector<VideoFrameType> types(
+        num_streams, key_frame_pending_ ? VideoFrameType::kVideoFrameKey
+                                        : VideoFrameType::kVideoFrameDelta);
+    key_frame_pending_ = false;
+    return encoder_->Encode(frame, &types);
+  }
+
+  void SetRates(EncodedImageCallback* subscriber,
+                const VideoEncoder::RateControlParameters& parameters) {
+    rtc::CritScope cs(&lock_);
+    rates_[subscriber] = parameters;
+    ApplyRates();
+  }
+
+  void OnPacketLossRateUpdate(EncodedImageCallback* subscriber,
+                              float packet_loss_rate) {
+    rtc::CritScope cs(&lock_);
+    packet_loss_rates_[subscriber] = packet_loss_rate;
+    float max_packet_loss_rate = 0.0f;
+    for (const auto& entry : packet_loss_rates_)
+      max_packet_loss_rate = std::max(max_packet_loss_rate, entry.second);
+    encoder_->OnPacketLossRateUpdate(max_packet_loss_rate);
+  }
+
+  VideoEncoder::EncoderInfo GetEncoderInfo() const {
+    rtc::CritScope cs(&lock_);
+    return encoder_->GetEncoderInfo();
+  }
+
+  // EncodedImageCallback implementation.
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    rtc::CritScope cs(&callback_lock_);
+    Result result(Result::OK, encoded_image.Timestamp());
+    for (EncodedImageCallback* callback : callbacks_) {
+      Result callback_result = callback->OnEncodedImage(
+          encoded_image, codec_specific_info, fragmentation);
+      if (callback_result.error != Result::OK)
+        result = callback_result;
+    }
+    return result;
+  }
+
+  void OnDroppedFrame(DropReason reason) override {
+    rtc::CritScope cs(&callback_lock_);
+    for (EncodedImageCallback* callback : callbacks_)
+      callback->OnDroppedFrame(reason);
+  }
+
+ private:
+  // Uses the allocation with the lowest total bitrate, so that the output
+  // fits the most constrained stream.
+  void ApplyRates() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    const VideoEncoder::RateControlParameters* lowest = nullptr;
+    for (const auto& entry : rates_) {
+      if (!lowest ||
+          entry.second.bitrate.get_sum_bps() < lowest->bitrate.get_sum_bps()) {
+        lowest = &entry.second;
+      }
+    }
+    if (lowest)
+      encoder_->SetRates(*lowest);
+  }
+
+  rtc::CriticalSection lock_;
+  const std::unique_ptr<VideoEncoder> encoder_ RTC_GUARDED_BY(lock_);
+  const VideoCodec codec_settings_;
+  const VideoEncoder::Settings settings_;
+  absl::optional<uint32_t> last_timestamp_ RTC_GUARDED_BY(lock_);
+  bool key_frame_pending_ RTC_GUARDED_BY(lock_) = true;
+  std::map<EncodedImageCallback*, VideoEncoder::RateControlParameters> rates_
+      RTC_GUARDED_BY(lock_);
+  std::map<EncodedImageCallback*, float> packet_loss_rates_
+      RTC_GUARDED_BY(lock_);
+
+  // Encoded images may be delivered synchronously from Encode(), so the
+  // callbacks are guarded by a lock of their own.
+  rtc::CriticalSection callback_lock_;
+  std::vector<EncodedImageCallback*> callbacks_ RTC_GUARDED_BY(callback_lock_);
+};
+
+class SharedVideoEncoderFactory : public VideoEncoderFactory {
+ public:
+  explicit SharedVideoEncoderFactory(
+      std::unique_ptr<VideoEncoderFactory> factory)
+      : factory_(std::move(factory)) {}
+
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return factory_->GetSupportedFormats();
+  }
+
+  std::vector<SdpVideoFormat> GetImplementations() const override {
+    return factory_->GetImplementations();
+  }
+
+  CodecInfo QueryVideoEncoder(const SdpVideoFormat& format) const override {
+    return factory_->QueryVideoEncoder(format);
+  }
+
+  std::unique_ptr<VideoEncoder> CreateVideoEncoder(
+      const SdpVideoFormat& format) override;
+
+  // Returns a rendition of |format| with the given settings, initializing a
+  // new encoder if there is none. Sets |result| to the InitEncode() result.
+  std::shared_ptr<Rendition> GetRendition(
+      const SdpVideoFormat& format,
+      const VideoCodec& codec_settings,
+      const VideoEncoder::Settings& settings,
+      int32_t* result) {
+    rtc::CritScope cs(&lock_);
+    renditions_.erase(std::remove_if(renditions_.begin(), renditions_.end(),
+                                     [](const auto& entry) {
+                                       return entry.second.expired();
+                                     }),
+                      renditions_.end());
+    for (const auto& entry : renditions_) {
+      std::shared_ptr<Rendition> rendition = entry.second.lock();
+      if (entry.first == format && rendition &&
+          rendition->Matches(codec_settings, settings)) {
+        *result = WEBRTC_VIDEO_CODEC_OK;
+        return rendition;
+      }
+    }
+    std::unique_ptr<VideoEncoder> encoder =
+        factory_->CreateVideoEncoder(format);
+    if (!encoder) {
+      *result = WEBRTC_VIDEO_CODEC_ERROR;
+      return nullptr;
+    }
+    auto rendition = std::make_shared<Rendition>(std::move(encoder),
+                                                 codec_settings, settings);
+    *result = rendition->InitEncode();
+    if (*result != WEBRTC_VIDEO_CODEC_OK)
+      return nullptr;
+    renditions_.emplace_back(format, rendition);
+    return rendition;
+  }
+
+ private:
+  const std::unique_ptr<VideoEncoderFactory> factory_;
+  rtc::CriticalSection lock_;
+  std::vector<std::pair<SdpVideoFormat, std::weak_ptr<Rendition>>> renditions_
+      RTC_GUARDED_BY(lock_);
+};
+
+// The VideoEncoder handed out to each send stream. Calls are made on the
+// stream's encoder queue.
+class SharedVideoEncoder : public VideoEncoder, public EncodedImageCallback {
+ public:
+  SharedVideoEncoder(SharedVideoEncoderFactory* factory,
+                     const SdpVideoFormat& format)
+      : factory_(factory), format_(format) {}
+
+  ~SharedVideoEncoder() override { Release(); }
+
+  int InitEncode(const VideoCodec* codec_settings,
+                 const VideoEncoder::Settings& settings) override {
+    Release();
+    int32_t result = WEBRTC_VIDEO_CODEC_OK;
+    rendition_ =
+        factory_->GetRendition(format_, *codec_settings, settings, &result);
+    if (rendition_)
+      rendition_->AddSubscriber(this);
+    return result;
+  }
+
+  int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) override {
+    rtc::CritScope cs(&callback_lock_);
+    callback_ = callback;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  int32_t Release() override {
+    if (rendition_) {
+      rendition_->RemoveSubscriber(this);
+      rendition_ = nullptr;
+    }
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  int32_t Encode(const VideoFrame& frame,
+                 const std::vector<VideoFrameType>* frame_types) override {
+    if (!rendition_)
+      return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+    return rendition_->Encode(frame, frame_types);
+  }
+
+  void SetRates(const RateControlParameters& parameters) override {
+    if (rendition_)
+      rendition_->SetRates(this, parameters);
+  }
+
+  void OnPacketLossRateUpdate(float packet_loss_rate) override {
+    if (rendition_)
+      rendition_->OnPacketLossRateUpdate(this, packet_loss_rate);
+  }
+
+  EncoderInfo GetEncoderInfo() const override {
+    return rendition_ ? rendition_->GetEncoderInfo() : EncoderInfo();
+  }
+
+  // EncodedImageCallback implementation, called by the rendition.
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    rtc::CritScope cs(&callback_lock_);
+    if (!callback_)
+      return Result(Result::OK, encoded_image.Timestamp());
+    return callback_->OnEncodedImage(encoded_image, codec_specific_info,
+                                     fragmentation);
+  }
+
+  void OnDroppedFrame(DropReason reason) override {
+    rtc::CritScope cs(&callback_lock_);
+    if (callback_)
+      callback_->OnDroppedFrame(reason);
+  }
+
+ private:
+  SharedVideoEncoderFactory* const factory_;
+  const SdpVideoFormat format_;
+  std::shared_ptr<Rendition> rendition_;
+
+  rtc::CriticalSection callback_lock_;
+  EncodedImageCallback* callback_ RTC_GUARDED_BY(callback_lock_) = nullptr;
+};
+
+std::unique_ptr<VideoEncoder> SharedVideoEncoderFactory::CreateVideoEncoder(
+    const SdpVideoFormat& format) {
+  return std::make_unique<SharedVideoEncoder>(this, format);
+}
+
+}  // namespace
+
+std::unique_ptr<VideoEncoderFactory> CreateSharedVideoEncoderFactory(
+    std::unique_ptr<VideoEncoderFactory> factory) {
+  return std::make_unique<SharedVideoEncoderFactory>(std::move(factory));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_VIDEO_CODECS_SHARED_VIDEO_ENCODER_FACTORY_H_
+#define API_VIDEO_CODECS_SHARED_VIDEO_ENCODER_FACTORY_H_
+
+#include <memory>
+
+#include "api/video_codecs/video_encoder_factory.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace webrtc {
+
+// Wraps |factory| so that encoders made for the same SdpVideoFormat and
+// initialized with the same codec settings share one underlying encoder. This
+// is meant for servers that send the same composited video to many
+// receivers: each VideoSendStream passes the same frames, which are encoded
+// once, and the output is delivered to every stream for its own
+// packetization. Streams whose settings differ, e.g. a lower resolution for
+// constrained receivers, form a separate rendition that is shared among
+// them in the same way.
+//
+// Frames are identified by their RTP timestamp, which VideoStreamEncoder
+// derives from the capture time, so streams fed from the same source see the
+// same timestamps. Encoded images are delivered on the thread of whichever
+// stream's Encode() call produced them.
+//
+// A key frame request from any stream, and any stream joining, makes the
+// rendition produce a key frame for all of its streams. Rates are set to the
+// lowest allocation among the streams, and loss notifications are ignored
+// since they describe a single receiver. Encoders made by the returned
+// factory must not outlive it.
+RTC_EXPORT std::unique_ptr<VideoEncoderFactory>
+CreateSharedVideoEncoderFactory(std::unique_ptr<VideoEncoderFactory> factory);
+
+}  // namespace webrtc
+
+#endif  // API_VIDEO_CODECS_SHARED_VIDEO_ENCODER_FACTORY_H_
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video_codecs/shared_video_encoder_factory.h"
+
+#include <memory>
+#include <vector>
+
+#include "api/test/mock_video_encoder.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+using ::testing::_;
+using ::testing::Return;
+
+const SdpVideoFormat kFormat("VP8");
+constexpr int kWidth = 320;
+constexpr int kHeight = 180;
+const VideoEncoder::Capabilities kCapabilities(false);
+const VideoEncoder::Settings kSettings(kCapabilities, 1, 1200);
+
+struct EncoderCounters {
+  int encoders_made = 0;
+  std::vector<VideoFrameType> encoded_frame_types;
+};
+
+// Delivers one encoded image per frame, with the frame's timestamp.
+class FakeEncoder : public VideoEncoder {
+ public:
+  explicit FakeEncoder(EncoderCounters* counters) : counters_(counters) {}
+
+  int InitEncode(const VideoCodec* codec_settings,
+                 const Settings& settings) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) override {
+    callback_ = callback;
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Release() override { return WEBRTC_VIDEO_CODEC_OK; }
+  int32_t Encode(const VideoFrame& frame,
+                 const std::vector<VideoFrameType>* frame_types) override {
+    counters_->encoded_frame_types.push_back((*frame_types)[0]);
+    EncodedImage image;
+    image.SetTimestamp(frame.timestamp());
+    image._frameType = (*frame_types)[0];
+    callback_->OnEncodedImage(image, nullptr, nullptr);
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  void SetRates(const RateControlParameters& parameters) override {}
+
+ private:
+  EncoderCounters* const counters_;
+  EncodedImageCallback* callback_ = nullptr;
+};
+
+class FakeEncoderFactory : public VideoEncoderFactory {
+ public:
+  explicit FakeEncoderFactory(EncoderCounters* counters)
+      : counters_(counters) {}
+
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return {kFormat};
+  }
+  CodecInfo QueryVideoEncoder(const SdpVideoFormat& format) const override {
+    return CodecInfo();
+  }
+  std::unique_ptr<VideoEncoder> CreateVideoEncoder(
+      const SdpVideoFormat& format) override {
+    ++counters_->encoders_made;
+    return std::make_unique<FakeEncoder>(counters_);
+  }
+
+ private:
+  EncoderCounters* const counters_;
+};
+
+VideoCodec MakeCodecSettings(int width, int height) {
+  VideoCodec codec_settings;
+  codec_settings.codecType = kVideoCodecVP8;
+  codec_settings.width = width;
+  codec_settings.height = height;
+  *codec_settings.VP8() = VideoEncoder::GetDefaultVp8Settings();
+  return codec_settings;
+}
+
+VideoFrame MakeFrame(uint32_t timestamp) {
+  return VideoFrame::Builder()
+      .set_video_frame_buffer(I420Buffer::Create(kWidth, kHeight))
+      .set_timestamp_rtp(timestamp)
+      .build();
+}
+
+class SharedVideoEncoderFactoryTest : public ::testing::Test {
+ protected:
+  SharedVideoEncoderFactoryTest()
+      : factory_(CreateSharedVideoEncoderFactory(
+            std::make_unique<FakeEncoderFactory>(&counters_))) {}
+
+  std::unique_ptr<VideoEncoder> MakeEncoder(
+      const VideoCodec& codec_settings,
+      EncodedImageCallback* callback) {
+    std::unique_ptr<VideoEncoder> encoder =
+        factory_->CreateVideoEncoder(kFormat);
+    encoder->RegisterEncodeCompleteCallback(callback);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder->InitEncode(&codec_settings, kSettings));
+    return encoder;
+  }
+
+  EncoderCounters counters_;
+  const std::unique_ptr<VideoEncoderFactory> factory_;
+};
+
+TEST_F(SharedVideoEncoderFactoryTest, EncodesEachFrameOnce) {
+  MockEncodedImageCallback callback1;
+  MockEncodedImageCallback callback2;
+  const VideoCodec codec_settings = MakeCodecSettings(kWidth, kHeight);
+  std::unique_ptr<VideoEncoder> encoder1 =
+      MakeEncoder(codec_settings, &callback1);
+  std::unique_ptr<VideoEncoder> encoder2 =
+      MakeEncoder(codec_settings, &callback2);
+  EXPECT_EQ(1, counters_.encoders_made);
+
+  constexpr int kNumFrames = 3;
+  EXPECT_CALL(callback1, OnEncodedImage)
+      .Times(kNumFrames)
+      .WillRepeatedly(Return(EncodedImageCallback::Result(
+          EncodedImageCallback::Result::OK)));
+  EXPECT_CALL(callback2, OnEncodedImage)
+      .Times(kNumFrames)
+      .WillRepeatedly(Return(EncodedImageCallback::Result(
+          EncodedImageCallback::Result::OK)));
+  const std::vector<VideoFrameType> delta = {VideoFrameType::kVideoFrameDelta};
+  for (int i = 0; i < kNumFrames; ++i) {
+    const VideoFrame frame = MakeFrame(90000 + i * 3000);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder1->Encode(frame, &delta));
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder2->Encode(frame, &delta));
+  }
+  EXPECT_EQ(kNumFrames,
+            static_cast<int>(counters_.encoded_frame_types.size()));
+}
+
+TEST_F(SharedVideoEncoderFactoryTest, DifferentSettingsUseSeparateEncoders) {
+  MockEncodedImageCallback callback;
+  std::unique_ptr<VideoEncoder> encoder1 =
+      MakeEncoder(MakeCodecSettings(kWidth, kHeight), &callback);
+  std::unique_ptr<VideoEncoder> encoder2 =
+      MakeEncoder(MakeCodecSettings(kWidth / 2, kHeight / 2), &callback);
+  std::unique_ptr<VideoEncoder> encoder3 =
+      MakeEncoder(MakeCodecSettings(kWidth / 2, kHeight / 2), &callback);
+  EXPECT_EQ(2, counters_.encoders_made);
+}
+
+TEST_F(SharedVideoEncoderFactoryTest, KeyFrameRequestAppliesToNextFrame) {
+  MockEncodedImageCallback callback;
+  EXPECT_CALL(callback, OnEncodedImage)
+      .WillRepeatedly(Return(
+          EncodedImageCallback::Result(EncodedImageCallback::Result::OK)));
+  const VideoCodec codec_settings = MakeCodecSettings(kWidth, kHeight);
+  std::unique_ptr<VideoEncoder> encoder1 =
+      MakeEncoder(codec_settings, &callback);
+  std::unique_ptr<VideoEncoder> encoder2 =
+      MakeEncoder(codec_settings, &callback);
+
+  const std::vector<VideoFrameType> delta = {VideoFrameType::kVideoFrameDelta};
+  const std::vector<VideoFrameType> key = {VideoFrameType::kVideoFrameKey};
+  encoder1->Encode(MakeFrame(1000), &delta);
+  encoder2->Encode(MakeFrame(1000), &delta);
+  encoder1->Encode(MakeFrame(2000), &delta);
+  // The frame has already been encoded as a delta frame, so the request is
+  // served by the next one.
+  encoder2->Encode(MakeFrame(2000), &key);
+  encoder1->Encode(MakeFrame(3000), &delta);
+  encoder2->Encode(MakeFrame(3000), &delta);
+
+  EXPECT_THAT(counters_.encoded_frame_types,
+              ::testing::ElementsAre(VideoFrameType::kVideoFrameKey,
+                                     VideoFrameType::kVideoFrameDelta,
+                                     VideoFrameType::kVideoFrameKey));
+}
+
+}  // namespace
+
+}  // namespace webrtc
@@ -82,6 +82,7 @@ constexpr VideoEncoder::ScalingSettings::KOff
     VideoEncoder::ScalingSettings::kOff;
 // static
 constexpr uint8_t VideoEncoder::EncoderInfo::kMaxFramerateFraction;
+constexpr size_t VideoEncoder::EncoderInfo::kMaxPreferredPixelFormats;
 
 bool VideoEncoder::ResolutionBitrateLimits::operator==(
     const ResolutionBitrateLimits& rhs) const {
@@ -102,7 +103,8 @@ VideoEncoder::EncoderInfo::EncoderInfo()
       fps_allocation{absl::InlinedVector<uint8_t, kMaxTemporalStreams>(
           1,
           kMaxFramerateFraction)},
-      supports_simulcast(false) {}
+      supports_simulcast(false),
+      preferred_pixel_formats{VideoFrameBuffer::Type::kI420} {}
 
 VideoEncoder::EncoderInfo::EncoderInfo(const EncoderInfo&) = default;
 
@@ -166,7 +168,15 @@ std::string VideoEncoder::EncoderInfo::ToString() const {
   }
   oss << "] "
          ", supports_simulcast = "
-      << supports_simulcast << "}";
+      << supports_simulcast;
+  oss << ", preferred_pixel_formats = [";
+  for (size_t i = 0; i < preferred_pixel_formats.size(); ++i) {
+    if (i > 0) {
+      oss << ", ";
+    }
+    oss << static_cast<int>(preferred_pixel_formats[i]);
+  }
+  oss << "]}";
   return oss.str();
 }
 
@@ -202,7 +212,8 @@ bool VideoEncoder::EncoderInfo::operator==(const EncoderInfo& rhs) const {
   }
 
   if (resolution_bitrate_limits != rhs.resolution_bitrate_limits ||
-      supports_simulcast != rhs.supports_simulcast) {
+      supports_simulcast != rhs.supports_simulcast ||
+      preferred_pixel_formats != rhs.preferred_pixel_formats) {
     return false;
   }
 
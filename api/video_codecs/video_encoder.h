@@ -154,6 +154,7 @@ class RTC_EXPORT VideoEncoder {
   struct RTC_EXPORT EncoderInfo {
     static constexpr uint8_t kMaxFramerateFraction =
         std::numeric_limits<uint8_t>::max();
+    static constexpr size_t kMaxPreferredPixelFormats = 5;
 
     EncoderInfo();
     EncoderInfo(const EncoderInfo&);
@@ -247,6 +248,13 @@ class RTC_EXPORT VideoEncoder {
     // in such case the encoder should return
     // WEBRTC_VIDEO_CODEC_ERR_SIMULCAST_PARAMETERS_NOT_SUPPORTED.
     bool supports_simulcast;
+
+    // The pixel formats the encoder takes without conversion, in order of
+    // preference. Frames of other formats, except native frames if
+    // |supports_native_handle| is set, are converted to I420 before Encode(),
+    // so I420 should always be listed. Defaults to I420 only.
+    absl::InlinedVector<VideoFrameBuffer::Type, kMaxPreferredPixelFormats>
+        preferred_pixel_formats;
   };
 
   struct RTC_EXPORT RateControlParameters {
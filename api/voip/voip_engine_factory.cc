@@ -33,7 +33,8 @@ std::unique_ptr<VoipEngine> CreateVoipEngine(VoipEngineConfig config) {
                        std::move(config.decoder_factory),
                        std::move(config.task_queue_factory),
                        std::move(config.audio_device_module),
-                       std::move(config.audio_processing))) {
+                       std::move(config.audio_processing),
+                       config.neteq_factory)) {
     RTC_DLOG(LS_ERROR) << "Failed to initialize VoIP core.";
     return nullptr;
   }
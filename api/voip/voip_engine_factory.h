@@ -15,6 +15,7 @@
 
 #include "api/audio_codecs/audio_decoder_factory.h"
 #include "api/audio_codecs/audio_encoder_factory.h"
+#include "api/neteq/neteq_factory.h"
 #include "api/scoped_refptr.h"
 #include "api/task_queue/task_queue_factory.h"
 #include "api/voip/voip_engine.h"
@@ -42,7 +43,9 @@ struct VoipEngineConfig {
 
   // Mandatory (e.g. api/task_queue/default_task_queue_factory).
   // TaskQeueuFactory provided for VoipEngine to work asynchronously on its
-  // encoding flow.
+  // encoding flow. Each channel gets an encoder task queue of its own; to
+  // have thousands of channels share a few threads, use a factory from
+  // CreateTaskQueuePoolFactory() (rtc_base/task_queue_pool.h).
   std::unique_ptr<TaskQueueFactory> task_queue_factory;
 
   // Mandatory (e.g. modules/audio_device/include).
@@ -58,6 +61,17 @@ struct VoipEngineConfig {
   // such functionalities to perform on audio input samples received from
   // AudioDeviceModule.
   rtc::scoped_refptr<AudioProcessing> audio_processing;
+
+  // Optional (e.g. modules/audio_coding/neteq/batched_neteq_factory.h).
+  // NetEqFactory that creates the jitter buffer and decoder of each channel.
+  // When set, the received audio is not mixed and played out on
+  // |audio_device_module|; the NetEq instances are expected to be pulled for
+  // their audio by other means. A BatchedNetEqFactory pulls all of them on a
+  // small pool of threads and hands their audio to the application, for
+  // gateways that handle many calls without playing them out. StartPlayout()
+  // and StopPlayout() then only start and stop the reception on a channel.
+  // Must outlive the VoipEngine.
+  NetEqFactory* neteq_factory = nullptr;
 };
 
 // Creates a VoipEngine instance with provided VoipEngineConfig.
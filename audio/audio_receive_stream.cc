@@ -81,7 +81,8 @@ std::unique_ptr<voe::ChannelReceiveInterface> CreateChannelReceive(
       event_log, config.rtp.local_ssrc, config.rtp.remote_ssrc,
       config.jitter_buffer_max_packets, config.jitter_buffer_fast_accelerate,
       config.jitter_buffer_min_delay_ms,
-      config.jitter_buffer_enable_rtx_handling, config.decoder_factory,
+      config.jitter_buffer_enable_rtx_handling,
+      config.jitter_buffer_low_latency_delay, config.decoder_factory,
       config.codec_pair_id, config.frame_decryptor, config.crypto_options,
       std::move(config.frame_transformer));
 }
@@ -299,6 +300,10 @@ int AudioReceiveStream::PreferredSampleRate() const {
   return channel_receive_->PreferredSampleRate();
 }
 
+absl::optional<int> AudioReceiveStream::AudioLevelHint() const {
+  return channel_receive_->GetReceivedAudioLevel();
+}
+
 uint32_t AudioReceiveStream::id() const {
   RTC_DCHECK_RUN_ON(&worker_thread_checker_);
   return config_.rtp.remote_ssrc;
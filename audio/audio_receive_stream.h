@@ -85,6 +85,7 @@ class AudioReceiveStream final : public webrtc::AudioReceiveStream,
                                        AudioFrame* audio_frame) override;
   int Ssrc() const override;
   int PreferredSampleRate() const override;
+  absl::optional<int> AudioLevelHint() const override;
 
   // Syncable
   uint32_t id() const override;
@@ -41,6 +41,7 @@
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/critical_section.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/format_macros.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
@@ -48,6 +49,7 @@
 #include "rtc_base/race_checker.h"
 #include "rtc_base/thread_checker.h"
 #include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
 
 namespace webrtc {
@@ -66,7 +68,9 @@ AudioCodingModule::Config AcmConfig(
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
     absl::optional<AudioCodecPairId> codec_pair_id,
     size_t jitter_buffer_max_packets,
-    bool jitter_buffer_fast_playout) {
+    bool jitter_buffer_fast_playout,
+    const absl::optional<NetEq::Config::LowLatencyDelay>&
+        jitter_buffer_low_latency_delay) {
   AudioCodingModule::Config acm_config;
   acm_config.neteq_factory = neteq_factory;
   acm_config.decoder_factory = decoder_factory;
@@ -74,6 +78,14 @@ AudioCodingModule::Config AcmConfig(
   acm_config.neteq_config.max_packets_in_buffer = jitter_buffer_max_packets;
   acm_config.neteq_config.enable_fast_accelerate = jitter_buffer_fast_playout;
   acm_config.neteq_config.enable_muted_state = true;
+  acm_config.neteq_config.low_latency_delay = jitter_buffer_low_latency_delay;
+
+  // Lets a server in a large conference skip decoding quiet participants.
+  FieldTrialOptional<int> skip_decoding_audio_level("level");
+  ParseFieldTrial({&skip_decoding_audio_level},
+                  field_trial::FindFullName("WebRTC-Audio-SkipSilentDecoding"));
+  acm_config.neteq_config.skip_decoding_audio_level =
+      skip_decoding_audio_level.GetOptional();
 
   return acm_config;
 }
@@ -94,6 +106,8 @@ class ChannelReceive : public ChannelReceiveInterface {
       bool jitter_buffer_fast_playout,
       int jitter_buffer_min_delay_ms,
       bool jitter_buffer_enable_rtx_handling,
+      const absl::optional<NetEq::Config::LowLatencyDelay>&
+          jitter_buffer_low_latency_delay,
       rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
       absl::optional<AudioCodecPairId> codec_pair_id,
       rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
@@ -161,6 +175,8 @@ class ChannelReceive : public ChannelReceiveInterface {
 
   int PreferredSampleRate() const override;
 
+  absl::optional<int> GetReceivedAudioLevel() const override;
+
   // Associate to a send channel.
   // Used for obtaining RTT for a receive-only channel.
   void SetAssociatedSendChannel(const ChannelSendInterface* channel) override;
@@ -226,6 +242,8 @@ class ChannelReceive : public ChannelReceiveInterface {
       RTC_GUARDED_BY(&sync_info_lock_);
   absl::optional<int64_t> last_received_rtp_system_time_ms_
       RTC_GUARDED_BY(&sync_info_lock_);
+  absl::optional<int> last_received_audio_level_
+      RTC_GUARDED_BY(&sync_info_lock_);
 
   // The AcmReceiver is thread safe, using its own lock.
   acm2::AcmReceiver acm_receiver_;
@@ -441,6 +459,11 @@ int ChannelReceive::PreferredSampleRate() const {
                   acm_receiver_.last_output_sample_rate_hz());
 }
 
+absl::optional<int> ChannelReceive::GetReceivedAudioLevel() const {
+  rtc::CritScope cs(&sync_info_lock_);
+  return last_received_audio_level_;
+}
+
 ChannelReceive::ChannelReceive(
     Clock* clock,
     ProcessThread* module_process_thread,
@@ -454,6 +477,8 @@ ChannelReceive::ChannelReceive(
     bool jitter_buffer_fast_playout,
     int jitter_buffer_min_delay_ms,
     bool jitter_buffer_enable_rtx_handling,
+    const absl::optional<NetEq::Config::LowLatencyDelay>&
+        jitter_buffer_low_latency_delay,
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
     absl::optional<AudioCodecPairId> codec_pair_id,
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
@@ -466,7 +491,8 @@ ChannelReceive::ChannelReceive(
                               decoder_factory,
                               codec_pair_id,
                               jitter_buffer_max_packets,
-                              jitter_buffer_fast_playout)),
+                              jitter_buffer_fast_playout,
+                              jitter_buffer_low_latency_delay)),
       _outputAudioLevel(),
       ntp_estimator_(clock),
       playout_timestamp_rtp_(0),
@@ -589,6 +615,10 @@ void ChannelReceive::OnRtpPacket(const RtpPacketReceived& packet) {
 
   RTPHeader header;
   packet_copy.GetHeader(&header);
+  if (header.extension.hasAudioLevel) {
+    rtc::CritScope cs(&sync_info_lock_);
+    last_received_audio_level_ = header.extension.audioLevel;
+  }
 
   // Interpolates absolute capture timestamp RTP header extension.
   header.extension.absolute_capture_time =
@@ -983,6 +1013,8 @@ std::unique_ptr<ChannelReceiveInterface> CreateChannelReceive(
     bool jitter_buffer_fast_playout,
     int jitter_buffer_min_delay_ms,
     bool jitter_buffer_enable_rtx_handling,
+    const absl::optional<NetEq::Config::LowLatencyDelay>&
+        jitter_buffer_low_latency_delay,
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
     absl::optional<AudioCodecPairId> codec_pair_id,
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
@@ -993,8 +1025,8 @@ std::unique_ptr<ChannelReceiveInterface> CreateChannelReceive(
       rtcp_send_transport, rtc_event_log, local_ssrc, remote_ssrc,
       jitter_buffer_max_packets, jitter_buffer_fast_playout,
       jitter_buffer_min_delay_ms, jitter_buffer_enable_rtx_handling,
-      decoder_factory, codec_pair_id, frame_decryptor, crypto_options,
-      std::move(frame_transformer));
+      jitter_buffer_low_latency_delay, decoder_factory, codec_pair_id,
+      frame_decryptor, crypto_options, std::move(frame_transformer));
 }
 
 }  // namespace voe
@@ -33,6 +33,11 @@ class TransformableAudioFrame : public TransformableAudioFrameInterface {
     payload_.SetData(data.data(), data.size());
   }
 
+  rtc::ArrayView<uint8_t> GetMutableData(size_t size) override {
+    payload_.SetSize(size);
+    return payload_;
+  }
+
   uint32_t GetTimestamp() const override { return header_.timestamp; }
   uint32_t GetSsrc() const override { return ssrc_; }
   const RTPHeader& GetHeader() const override { return header_; }
@@ -76,11 +81,26 @@ void ChannelReceiveFrameTransformerDelegate::Transform(
 
 void ChannelReceiveFrameTransformerDelegate::OnTransformedFrame(
     std::unique_ptr<TransformableFrameInterface> frame) {
+  {
+    rtc::CritScope lock(&pending_lock_);
+    pending_frames_.push_back(std::move(frame));
+    // A task is already posted for the frames that are pending.
+    if (pending_frames_.size() > 1)
+      return;
+  }
   rtc::scoped_refptr<ChannelReceiveFrameTransformerDelegate> delegate = this;
   channel_receive_thread_->PostTask(ToQueuedTask(
-      [delegate = std::move(delegate), frame = std::move(frame)]() mutable {
-        delegate->ReceiveFrame(std::move(frame));
-      }));
+      [delegate = std::move(delegate)] { delegate->ReceivePendingFrames(); }));
+}
+
+void ChannelReceiveFrameTransformerDelegate::ReceivePendingFrames() {
+  std::vector<std::unique_ptr<TransformableFrameInterface>> frames;
+  {
+    rtc::CritScope lock(&pending_lock_);
+    frames.swap(pending_frames_);
+  }
+  for (auto& frame : frames)
+    ReceiveFrame(std::move(frame));
 }
 
 void ChannelReceiveFrameTransformerDelegate::ReceiveFrame(
@@ -12,8 +12,10 @@
 #define AUDIO_CHANNEL_RECEIVE_FRAME_TRANSFORMER_DELEGATE_H_
 
 #include <memory>
+#include <vector>
 
 #include "api/frame_transformer_interface.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/synchronization/sequence_checker.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/thread.h"
@@ -61,12 +63,21 @@ class ChannelReceiveFrameTransformerDelegate : public TransformedFrameCallback {
   ~ChannelReceiveFrameTransformerDelegate() override = default;
 
  private:
+  // Receives the frames transformed since the last call, on the
+  // |channel_receive_thread_|.
+  void ReceivePendingFrames();
+
   SequenceChecker sequence_checker_;
   ReceiveFrameCallback receive_frame_callback_
       RTC_GUARDED_BY(sequence_checker_);
   rtc::scoped_refptr<FrameTransformerInterface> frame_transformer_
       RTC_GUARDED_BY(sequence_checker_);
   rtc::Thread* channel_receive_thread_;
+  rtc::CriticalSection pending_lock_;
+  // Transformed frames that wait for a task on the |channel_receive_thread_|,
+  // so that frames transformed back to back need one task between them.
+  std::vector<std::unique_ptr<TransformableFrameInterface>> pending_frames_
+      RTC_GUARDED_BY(pending_lock_);
 };
 
 }  // namespace webrtc
@@ -22,6 +22,8 @@
 namespace webrtc {
 namespace {
 
+using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::NiceMock;
 using ::testing::SaveArg;
 
@@ -94,6 +96,42 @@ TEST(ChannelReceiveFrameTransformerDelegateTest,
   rtc::ThreadManager::ProcessAllMessageQueuesForTesting();
 }
 
+// Test that frames transformed in place, and back to back, are all passed to
+// the channel.
+TEST(ChannelReceiveFrameTransformerDelegateTest,
+     ReceivesFramesTransformedInPlace) {
+  rtc::scoped_refptr<MockFrameTransformer> mock_frame_transformer =
+      new rtc::RefCountedObject<NiceMock<MockFrameTransformer>>();
+  MockChannelReceive mock_channel;
+  rtc::scoped_refptr<ChannelReceiveFrameTransformerDelegate> delegate =
+      new rtc::RefCountedObject<ChannelReceiveFrameTransformerDelegate>(
+          mock_channel.callback(), mock_frame_transformer,
+          rtc::Thread::Current());
+  rtc::scoped_refptr<TransformedFrameCallback> callback;
+  EXPECT_CALL(*mock_frame_transformer, RegisterTransformedFrameCallback)
+      .WillOnce(SaveArg<0>(&callback));
+  delegate->Init();
+  ASSERT_TRUE(callback);
+
+  // Drops the last byte and inverts the others.
+  ON_CALL(*mock_frame_transformer, Transform)
+      .WillByDefault(
+          [&callback](std::unique_ptr<TransformableFrameInterface> frame) {
+            rtc::ArrayView<uint8_t> data =
+                frame->GetMutableData(frame->GetData().size() - 1);
+            for (uint8_t& byte : data)
+              byte = ~byte;
+            callback->OnTransformedFrame(std::move(frame));
+          });
+  const uint8_t data[] = {1, 2, 3, 4};
+  RTPHeader header;
+  EXPECT_CALL(mock_channel, ReceiveFrame(ElementsAre(0xfe, 0xfd, 0xfc), _))
+      .Times(2);
+  delegate->Transform(data, header, 1111 /*ssrc*/);
+  delegate->Transform(data, header, 1111 /*ssrc*/);
+  rtc::ThreadManager::ProcessAllMessageQueuesForTesting();
+}
+
 // Test that if the delegate receives a transformed frame after it has been
 // reset, it does not run the ReceiveFrameCallback, as the channel is destroyed
 // after resetting the delegate.
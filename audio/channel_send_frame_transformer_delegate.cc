@@ -37,6 +37,10 @@ class TransformableAudioFrame : public TransformableFrameInterface {
   void SetData(rtc::ArrayView<const uint8_t> data) override {
     payload_.SetData(data.data(), data.size());
   }
+  rtc::ArrayView<uint8_t> GetMutableData(size_t size) override {
+    payload_.SetSize(size);
+    return payload_;
+  }
   uint32_t GetTimestamp() const override {
     return rtp_timestamp_ + rtp_start_timestamp_;
   }
@@ -79,6 +83,7 @@ void ChannelSendFrameTransformerDelegate::Reset() {
 
   rtc::CritScope lock(&send_lock_);
   send_frame_callback_ = SendFrameCallback();
+  pending_frames_.clear();
 }
 
 void ChannelSendFrameTransformerDelegate::Transform(
@@ -100,11 +105,23 @@ void ChannelSendFrameTransformerDelegate::OnTransformedFrame(
   rtc::CritScope lock(&send_lock_);
   if (!send_frame_callback_)
     return;
+  pending_frames_.push_back(std::move(frame));
+  // A task is already posted for the frames that are pending.
+  if (pending_frames_.size() > 1)
+    return;
   rtc::scoped_refptr<ChannelSendFrameTransformerDelegate> delegate = this;
   encoder_queue_->PostTask(
-      [delegate = std::move(delegate), frame = std::move(frame)]() mutable {
-        delegate->SendFrame(std::move(frame));
-      });
+      [delegate = std::move(delegate)] { delegate->SendPendingFrames(); });
+}
+
+void ChannelSendFrameTransformerDelegate::SendPendingFrames() {
+  std::vector<std::unique_ptr<TransformableFrameInterface>> frames;
+  {
+    rtc::CritScope lock(&send_lock_);
+    frames.swap(pending_frames_);
+  }
+  for (auto& frame : frames)
+    SendFrame(std::move(frame));
 }
 
 void ChannelSendFrameTransformerDelegate::SendFrame(
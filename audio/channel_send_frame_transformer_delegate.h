@@ -12,6 +12,7 @@
 #define AUDIO_CHANNEL_SEND_FRAME_TRANSFORMER_DELEGATE_H_
 
 #include <memory>
+#include <vector>
 
 #include "api/frame_transformer_interface.h"
 #include "modules/audio_coding/include/audio_coding_module_typedefs.h"
@@ -72,10 +73,17 @@ class ChannelSendFrameTransformerDelegate : public TransformedFrameCallback {
   ~ChannelSendFrameTransformerDelegate() override = default;
 
  private:
+  // Sends the frames transformed since the last call, on the |encoder_queue_|.
+  void SendPendingFrames();
+
   rtc::CriticalSection send_lock_;
   SendFrameCallback send_frame_callback_ RTC_GUARDED_BY(send_lock_);
   rtc::scoped_refptr<FrameTransformerInterface> frame_transformer_;
   rtc::TaskQueue* encoder_queue_ RTC_GUARDED_BY(send_lock_);
+  // Transformed frames that wait for a task on the |encoder_queue_|, so that
+  // frames transformed back to back need one task between them.
+  std::vector<std::unique_ptr<TransformableFrameInterface>> pending_frames_
+      RTC_GUARDED_BY(send_lock_);
 };
 }  // namespace webrtc
 #endif  // AUDIO_CHANNEL_SEND_FRAME_TRANSFORMER_DELEGATE_H_
@@ -23,6 +23,8 @@
 namespace webrtc {
 namespace {
 
+using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::NiceMock;
 using ::testing::SaveArg;
 
@@ -105,6 +107,48 @@ TEST(ChannelSendFrameTransformerDelegateTest,
   channel_queue.WaitForPreviouslyPostedTasks();
 }
 
+// Test that frames transformed in place, and back to back, are all passed to
+// the channel.
+TEST(ChannelSendFrameTransformerDelegateTest, SendsFramesTransformedInPlace) {
+  TaskQueueForTest channel_queue("channel_queue");
+  rtc::scoped_refptr<MockFrameTransformer> mock_frame_transformer =
+      new rtc::RefCountedObject<NiceMock<MockFrameTransformer>>();
+  MockChannelSend mock_channel;
+  rtc::scoped_refptr<ChannelSendFrameTransformerDelegate> delegate =
+      new rtc::RefCountedObject<ChannelSendFrameTransformerDelegate>(
+          mock_channel.callback(), mock_frame_transformer, &channel_queue);
+  rtc::scoped_refptr<TransformedFrameCallback> callback;
+  EXPECT_CALL(*mock_frame_transformer, RegisterTransformedFrameCallback)
+      .WillOnce(SaveArg<0>(&callback));
+  delegate->Init();
+  ASSERT_TRUE(callback);
+
+  // Appends a byte and inverts the others.
+  ON_CALL(*mock_frame_transformer, Transform)
+      .WillByDefault(
+          [&callback](std::unique_ptr<TransformableFrameInterface> frame) {
+            const size_t size = frame->GetData().size();
+            rtc::ArrayView<uint8_t> data = frame->GetMutableData(size + 1);
+            for (size_t i = 0; i < size; ++i)
+              data[i] = ~data[i];
+            data[size] = 5;
+            callback->OnTransformedFrame(std::move(frame));
+          });
+  const uint8_t data[] = {1, 2, 3, 4};
+  EXPECT_CALL(mock_channel,
+              SendFrame(_, _, _, ElementsAre(0xfe, 0xfd, 0xfc, 0xfb, 5), _))
+      .Times(2);
+  channel_queue.SendTask(
+      [&] {
+        delegate->Transform(AudioFrameType::kAudioFrameSpeech, 0, 0, 0, data,
+                            sizeof(data), 0, 0);
+        delegate->Transform(AudioFrameType::kAudioFrameSpeech, 0, 0, 0, data,
+                            sizeof(data), 0, 0);
+      },
+      RTC_FROM_HERE);
+  channel_queue.WaitForPreviouslyPostedTasks();
+}
+
 // Test that if the delegate receives a transformed frame after it has been
 // reset, it does not run the SendFrameCallback, as the channel is destroyed
 // after resetting the delegate.
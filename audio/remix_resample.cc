@@ -21,9 +21,16 @@ namespace voe {
 void RemixAndResample(const AudioFrame& src_frame,
                       PushResampler<int16_t>* resampler,
                       AudioFrame* dst_frame) {
-  RemixAndResample(src_frame.data(), src_frame.samples_per_channel_,
-                   src_frame.num_channels_, src_frame.sample_rate_hz_,
-                   resampler, dst_frame);
+  if (src_frame.sample_rate_hz_ == dst_frame->sample_rate_hz_ &&
+      src_frame.num_channels_ == dst_frame->num_channels_) {
+    // Nothing to convert, so share the samples instead of copying them.
+    dst_frame->ShareDataFrom(src_frame);
+    dst_frame->samples_per_channel_ = src_frame.samples_per_channel_;
+  } else {
+    RemixAndResample(src_frame.data(), src_frame.samples_per_channel_,
+                     src_frame.num_channels_, src_frame.sample_rate_hz_,
+                     resampler, dst_frame);
+  }
   dst_frame->timestamp_ = src_frame.timestamp_;
   dst_frame->elapsed_time_ms_ = src_frame.elapsed_time_ms_;
   dst_frame->ntp_time_ms_ = src_frame.ntp_time_ms_;
@@ -34,8 +34,10 @@ AudioChannel::AudioChannel(
     TaskQueueFactory* task_queue_factory,
     ProcessThread* process_thread,
     AudioMixer* audio_mixer,
-    rtc::scoped_refptr<AudioDecoderFactory> decoder_factory)
-    : audio_mixer_(audio_mixer), process_thread_(process_thread) {
+    rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
+    NetEqFactory* neteq_factory)
+    : audio_mixer_(neteq_factory ? nullptr : audio_mixer),
+      process_thread_(process_thread) {
   RTC_DCHECK(task_queue_factory);
   RTC_DCHECK(process_thread);
   RTC_DCHECK(audio_mixer);
@@ -59,15 +61,17 @@ AudioChannel::AudioChannel(
   // ProcessThread periodically services RTP stack for RTCP.
   process_thread_->RegisterModule(rtp_rtcp_.get(), RTC_FROM_HERE);
 
-  ingress_ = std::make_unique<AudioIngress>(rtp_rtcp_.get(), clock,
-                                            receive_statistics_.get(),
-                                            std::move(decoder_factory));
+  ingress_ = std::make_unique<AudioIngress>(
+      rtp_rtcp_.get(), clock, receive_statistics_.get(),
+      std::move(decoder_factory), neteq_factory);
   egress_ =
       std::make_unique<AudioEgress>(rtp_rtcp_.get(), clock, task_queue_factory);
 
   // Set the instance of audio ingress to be part of audio mixer for ADM to
   // fetch audio samples to play.
-  audio_mixer_->AddSource(ingress_.get());
+  if (audio_mixer_) {
+    audio_mixer_->AddSource(ingress_.get());
+  }
 }
 
 AudioChannel::~AudioChannel() {
@@ -78,7 +82,9 @@ AudioChannel::~AudioChannel() {
     StopPlay();
   }
 
-  audio_mixer_->RemoveSource(ingress_.get());
+  if (audio_mixer_) {
+    audio_mixer_->RemoveSource(ingress_.get());
+  }
   process_thread_->DeRegisterModule(rtp_rtcp_.get());
 }
 
@@ -16,6 +16,7 @@
 #include <queue>
 #include <utility>
 
+#include "api/neteq/neteq_factory.h"
 #include "api/task_queue/task_queue_factory.h"
 #include "api/voip/voip_base.h"
 #include "audio/voip/audio_egress.h"
@@ -30,6 +31,10 @@ namespace webrtc {
 // AudioChannel represents a single media session and provides APIs over
 // AudioIngress and AudioEgress. Note that a single RTP stack is shared with
 // these two classes as it has both sending and receiving capabilities.
+//
+// The received audio is mixed by |audio_mixer|, unless a |neteq_factory| is
+// given, in which case the NetEq created by it is pulled for the audio
+// instead, e.g. by a BatchedNetEqFactory.
 class AudioChannel : public rtc::RefCountInterface {
  public:
   AudioChannel(Transport* transport,
@@ -37,7 +42,8 @@ class AudioChannel : public rtc::RefCountInterface {
                TaskQueueFactory* task_queue_factory,
                ProcessThread* process_thread,
                AudioMixer* audio_mixer,
-               rtc::scoped_refptr<AudioDecoderFactory> decoder_factory);
+               rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
+               NetEqFactory* neteq_factory = nullptr);
   ~AudioChannel() override;
 
   // Set and get ChannelId that this audio channel belongs for debugging and
@@ -79,7 +85,8 @@ class AudioChannel : public rtc::RefCountInterface {
   // ChannelId that this audio channel belongs for logging purpose.
   ChannelId id_;
 
-  // Synchronization is handled internally by AudioMixer.
+  // Synchronization is handled internally by AudioMixer. Null if the audio
+  // is not mixed.
   AudioMixer* audio_mixer_;
 
   // Synchronization is handled internally by ProcessThread.
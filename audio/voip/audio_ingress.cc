@@ -26,10 +26,12 @@ namespace webrtc {
 namespace {
 
 AudioCodingModule::Config CreateAcmConfig(
-    rtc::scoped_refptr<AudioDecoderFactory> decoder_factory) {
+    rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
+    NetEqFactory* neteq_factory) {
   AudioCodingModule::Config acm_config;
   acm_config.neteq_config.enable_muted_state = true;
   acm_config.decoder_factory = decoder_factory;
+  acm_config.neteq_factory = neteq_factory;
   return acm_config;
 }
 
@@ -39,13 +41,14 @@ AudioIngress::AudioIngress(
     RtpRtcp* rtp_rtcp,
     Clock* clock,
     ReceiveStatistics* receive_statistics,
-    rtc::scoped_refptr<AudioDecoderFactory> decoder_factory)
+    rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
+    NetEqFactory* neteq_factory)
     : playing_(false),
       remote_ssrc_(0),
       first_rtp_timestamp_(-1),
       rtp_receive_statistics_(receive_statistics),
       rtp_rtcp_(rtp_rtcp),
-      acm_receiver_(CreateAcmConfig(decoder_factory)),
+      acm_receiver_(CreateAcmConfig(decoder_factory, neteq_factory)),
       ntp_estimator_(clock) {}
 
 AudioIngress::~AudioIngress() = default;
@@ -19,6 +19,7 @@
 
 #include "api/array_view.h"
 #include "api/audio/audio_mixer.h"
+#include "api/neteq/neteq_factory.h"
 #include "api/rtp_headers.h"
 #include "api/scoped_refptr.h"
 #include "audio/audio_level.h"
@@ -44,10 +45,13 @@ namespace webrtc {
 // smaller footprint.
 class AudioIngress : public AudioMixer::Source {
  public:
+  // If |neteq_factory| is set, the NetEq is created with it. It must outlive
+  // the AudioIngress.
   AudioIngress(RtpRtcp* rtp_rtcp,
                Clock* clock,
                ReceiveStatistics* receive_statistics,
-               rtc::scoped_refptr<AudioDecoderFactory> decoder_factory);
+               rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
+               NetEqFactory* neteq_factory = nullptr);
   ~AudioIngress() override;
 
   // Start or stop receiving operation of AudioIngress.
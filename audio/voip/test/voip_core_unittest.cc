@@ -12,6 +12,7 @@
 #include "api/audio_codecs/builtin_audio_decoder_factory.h"
 #include "api/audio_codecs/builtin_audio_encoder_factory.h"
 #include "api/task_queue/default_task_queue_factory.h"
+#include "modules/audio_coding/neteq/default_neteq_factory.h"
 #include "modules/audio_device/include/mock_audio_device.h"
 #include "modules/audio_processing/include/mock_audio_processing.h"
 #include "test/gtest.h"
@@ -96,5 +97,27 @@ TEST_F(VoipCoreTest, ExpectFailToUseReleasedChannelId) {
   EXPECT_FALSE(voip_core_->StartPlayout(*channel));
 }
 
+// With a NetEqFactory, the received audio is pulled from the NetEqs rather
+// than played out, so the audio device is left alone.
+TEST_F(VoipCoreTest, PlayoutWithNetEqFactoryDoesNotUseAudioDevice) {
+  DefaultNetEqFactory neteq_factory;
+  auto voip_core = std::make_unique<VoipCore>();
+  voip_core->Init(CreateBuiltinAudioEncoderFactory(),
+                  CreateBuiltinAudioDecoderFactory(),
+                  CreateDefaultTaskQueueFactory(), audio_device_,
+                  /*audio_processing=*/nullptr, &neteq_factory);
+
+  EXPECT_CALL(*audio_device_, InitPlayout()).Times(0);
+  EXPECT_CALL(*audio_device_, StartPlayout()).Times(0);
+  EXPECT_CALL(*audio_device_, StopPlayout()).Times(0);
+
+  auto channel = voip_core->CreateChannel(&transport_, 0xdeadc0de);
+  ASSERT_TRUE(channel);
+  voip_core->SetReceiveCodecs(*channel, {{kPcmuPayload, kPcmuFormat}});
+  EXPECT_TRUE(voip_core->StartPlayout(*channel));
+  EXPECT_TRUE(voip_core->StopPlayout(*channel));
+  voip_core->ReleaseChannel(*channel);
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -15,7 +15,6 @@
 #include <utility>
 
 #include "api/audio_codecs/audio_format.h"
-#include "rtc_base/critical_section.h"
 #include "rtc_base/logging.h"
 
 namespace webrtc {
@@ -42,10 +41,12 @@ bool VoipCore::Init(rtc::scoped_refptr<AudioEncoderFactory> encoder_factory,
                     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
                     std::unique_ptr<TaskQueueFactory> task_queue_factory,
                     rtc::scoped_refptr<AudioDeviceModule> audio_device_module,
-                    rtc::scoped_refptr<AudioProcessing> audio_processing) {
+                    rtc::scoped_refptr<AudioProcessing> audio_processing,
+                    NetEqFactory* neteq_factory) {
   encoder_factory_ = std::move(encoder_factory);
   decoder_factory_ = std::move(decoder_factory);
   task_queue_factory_ = std::move(task_queue_factory);
+  neteq_factory_ = neteq_factory;
   audio_device_module_ = std::move(audio_device_module);
 
   process_thread_ = ProcessThread::Create("ModuleProcessThread");
@@ -131,10 +132,11 @@ absl::optional<ChannelId> VoipCore::CreateChannel(
   rtc::scoped_refptr<AudioChannel> audio_channel =
       new rtc::RefCountedObject<AudioChannel>(
           transport, local_ssrc.value(), task_queue_factory_.get(),
-          process_thread_.get(), audio_mixer_.get(), decoder_factory_);
+          process_thread_.get(), audio_mixer_.get(), decoder_factory_,
+          neteq_factory_);
 
   {
-    rtc::CritScope lock(&lock_);
+    WriteLockScoped lock(*lock_);
 
     channel = static_cast<ChannelId>(next_channel_id_);
     channels_[*channel] = audio_channel;
@@ -154,7 +156,7 @@ void VoipCore::ReleaseChannel(ChannelId channel) {
   // Destroy channel outside of the lock.
   rtc::scoped_refptr<AudioChannel> audio_channel;
   {
-    rtc::CritScope lock(&lock_);
+    WriteLockScoped lock(*lock_);
 
     auto iter = channels_.find(channel);
     if (iter != channels_.end()) {
@@ -170,7 +172,7 @@ void VoipCore::ReleaseChannel(ChannelId channel) {
 rtc::scoped_refptr<AudioChannel> VoipCore::GetChannel(ChannelId channel) {
   rtc::scoped_refptr<AudioChannel> audio_channel;
   {
-    rtc::CritScope lock(&lock_);
+    ReadLockScoped lock(*lock_);
     auto iter = channels_.find(channel);
     if (iter != channels_.end()) {
       audio_channel = iter->second;
@@ -191,11 +193,11 @@ bool VoipCore::UpdateAudioTransportWithSenders() {
   int max_sampling_rate = 8000;
   size_t max_num_channels = 1;
   {
-    rtc::CritScope lock(&lock_);
+    ReadLockScoped lock(*lock_);
     // Reserve to prevent run time vector re-allocation.
     audio_senders.reserve(channels_.size());
-    for (auto kv : channels_) {
-      rtc::scoped_refptr<AudioChannel>& channel = kv.second;
+    for (const auto& kv : channels_) {
+      const rtc::scoped_refptr<AudioChannel>& channel = kv.second;
       if (channel->IsSendingMedia()) {
         auto encoder_format = channel->GetEncoderFormat();
         if (!encoder_format) {
@@ -267,6 +269,11 @@ bool VoipCore::StartPlayout(ChannelId channel) {
 
   audio_channel->StartPlay();
 
+  // Without the mixer, the audio device has nothing to play out.
+  if (neteq_factory_) {
+    return true;
+  }
+
   if (!audio_device_module_->Playing()) {
     if (audio_device_module_->InitPlayout() != 0) {
       RTC_LOG(LS_ERROR) << "InitPlayout failed";
@@ -288,11 +295,15 @@ bool VoipCore::StopPlayout(ChannelId channel) {
 
   audio_channel->StopPlay();
 
+  if (neteq_factory_) {
+    return true;
+  }
+
   bool stop_device = true;
   {
-    rtc::CritScope lock(&lock_);
-    for (auto kv : channels_) {
-      rtc::scoped_refptr<AudioChannel>& channel = kv.second;
+    ReadLockScoped lock(*lock_);
+    for (const auto& kv : channels_) {
+      const rtc::scoped_refptr<AudioChannel>& channel = kv.second;
       if (channel->IsPlaying()) {
         stop_device = false;
         break;
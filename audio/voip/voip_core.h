@@ -19,6 +19,7 @@
 
 #include "api/audio_codecs/audio_decoder_factory.h"
 #include "api/audio_codecs/audio_encoder_factory.h"
+#include "api/neteq/neteq_factory.h"
 #include "api/scoped_refptr.h"
 #include "api/task_queue/task_queue_factory.h"
 #include "api/voip/voip_base.h"
@@ -31,7 +32,7 @@
 #include "modules/audio_mixer/audio_mixer_impl.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "modules/utility/include/process_thread.h"
-#include "rtc_base/critical_section.h"
+#include "rtc_base/synchronization/rw_lock_wrapper.h"
 
 namespace webrtc {
 
@@ -51,13 +52,16 @@ class VoipCore : public VoipEngine,
 
   // Initialize VoipCore components with provided arguments.
   // Returns false only when |audio_device_module| fails to initialize which
-  // would presumably render further processing useless.
+  // would presumably render further processing useless. If |neteq_factory| is
+  // set, the channels decode with NetEqs from it and are not played out on
+  // |audio_device_module| (see VoipEngineConfig).
   // TODO(natim@webrtc.org): Need to report audio device errors to user layer.
   bool Init(rtc::scoped_refptr<AudioEncoderFactory> encoder_factory,
             rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
             std::unique_ptr<TaskQueueFactory> task_queue_factory,
             rtc::scoped_refptr<AudioDeviceModule> audio_device_module,
-            rtc::scoped_refptr<AudioProcessing> audio_processing);
+            rtc::scoped_refptr<AudioProcessing> audio_processing,
+            NetEqFactory* neteq_factory = nullptr);
 
   // Implements VoipEngine interfaces.
   VoipBase& Base() override { return *this; }
@@ -103,6 +107,7 @@ class VoipCore : public VoipEngine,
   rtc::scoped_refptr<AudioEncoderFactory> encoder_factory_;
   rtc::scoped_refptr<AudioDecoderFactory> decoder_factory_;
   std::unique_ptr<TaskQueueFactory> task_queue_factory_;
+  NetEqFactory* neteq_factory_ = nullptr;
 
   // Synchronization is handled internally by AudioProessing.
   // Must be placed before |audio_device_module_| for proper destruction.
@@ -123,15 +128,17 @@ class VoipCore : public VoipEngine,
   // Must be placed before |channels_| for proper destruction.
   std::unique_ptr<ProcessThread> process_thread_;
 
-  rtc::CriticalSection lock_;
+  // Taken shared to look up channels, which happens for every packet, and
+  // exclusively to add or remove them.
+  const std::unique_ptr<RWLockWrapper> lock_{RWLockWrapper::CreateRWLock()};
 
-  // Member to track a next ChannelId for new AudioChannel.
-  int next_channel_id_ RTC_GUARDED_BY(lock_) = 0;
+  // Member to track a next ChannelId for new AudioChannel. Guarded by
+  // |lock_|.
+  int next_channel_id_ = 0;
 
   // Container to track currently active AudioChannel objects mapped by
-  // ChannelId.
-  std::unordered_map<ChannelId, rtc::scoped_refptr<AudioChannel>> channels_
-      RTC_GUARDED_BY(lock_);
+  // ChannelId. Guarded by |lock_|.
+  std::unordered_map<ChannelId, rtc::scoped_refptr<AudioChannel>> channels_;
 };
 
 }  // namespace webrtc
@@ -22,6 +22,7 @@
 #include "api/crypto/crypto_options.h"
 #include "api/crypto/frame_decryptor_interface.h"
 #include "api/frame_transformer_interface.h"
+#include "api/neteq/neteq.h"
 #include "api/rtp_parameters.h"
 #include "api/scoped_refptr.h"
 #include "api/transport/rtp/rtp_source.h"
@@ -131,6 +132,10 @@ class AudioReceiveStream {
     bool jitter_buffer_fast_accelerate = false;
     int jitter_buffer_min_delay_ms = 0;
     bool jitter_buffer_enable_rtx_handling = false;
+    // Selects NetEq's low-latency delay policy for this stream, see
+    // NetEq::Config::LowLatencyDelay.
+    absl::optional<NetEq::Config::LowLatencyDelay>
+        jitter_buffer_low_latency_delay;
 
     // Identifier for an A/V synchronization group. Empty string to disable.
     // TODO(pbos): Synchronize streams in a sync group, not just one video
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <memory>
 #include <utility>
 
@@ -20,6 +21,7 @@
 #include "api/units/data_rate.h"
 #include "api/units/time_delta.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_minmax.h"
 #include "system_wrappers/include/clock.h"
@@ -30,6 +32,7 @@ namespace webrtc {
 
 namespace {
 using bitrate_allocator_impl::AllocatableTrack;
+using bitrate_allocator_impl::AllocationScratch;
 
 // Allow packets to be transmitted in up to 2 times max video bitrate if the
 // bandwidth estimate allows it.
@@ -42,6 +45,9 @@ const uint32_t kMinToggleBitrateBps = 20000;
 
 const int64_t kBweLogIntervalMs = 5000;
 
+const char kAllocationUpdateThreshold[] =
+    "WebRTC-Bwe-AllocationUpdateThreshold";
+
 double MediaRatio(uint32_t allocated_bitrate, uint32_t protection_bitrate) {
   RTC_DCHECK_GT(allocated_bitrate, 0);
   if (protection_bitrate == 0)
@@ -70,75 +76,73 @@ bool EnoughBitrateForAllObservers(
   return true;
 }
 
-// Splits |bitrate| evenly to observers already in |allocation|.
-// |include_zero_allocations| decides if zero allocations should be part of
-// the distribution or not. The allowed max bitrate is |max_multiplier| x
-// observer max bitrate.
+// Splits |bitrate| evenly to observers already in |allocation|, which is
+// indexed like |allocatable_tracks|. |include_zero_allocations| decides if zero
+// allocations should be part of the distribution or not. The allowed max
+// bitrate is |max_multiplier| x observer max bitrate.
 void DistributeBitrateEvenly(
     const std::vector<AllocatableTrack>& allocatable_tracks,
     uint32_t bitrate,
     bool include_zero_allocations,
     int max_multiplier,
-    std::map<BitrateAllocatorObserver*, int>* allocation) {
+    AllocationScratch* scratch,
+    std::vector<int>* allocation) {
   RTC_DCHECK_EQ(allocation->size(), allocatable_tracks.size());
 
-  std::multimap<uint32_t, const AllocatableTrack*> list_max_bitrates;
-  for (const auto& observer_config : allocatable_tracks) {
-    if (include_zero_allocations ||
-        allocation->at(observer_config.observer) != 0) {
-      list_max_bitrates.insert(
-          {observer_config.config.max_bitrate_bps, &observer_config});
-    }
+  // Observers with the lowest max bitrate first, in insertion order otherwise.
+  std::vector<size_t>& order = scratch->order;
+  order.clear();
+  for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+    if (include_zero_allocations || (*allocation)[i] != 0)
+      order.push_back(i);
   }
-  auto it = list_max_bitrates.begin();
-  while (it != list_max_bitrates.end()) {
+  absl::c_sort(order, [&allocatable_tracks](size_t a, size_t b) {
+    uint32_t max_a = allocatable_tracks[a].config.max_bitrate_bps;
+    uint32_t max_b = allocatable_tracks[b].config.max_bitrate_bps;
+    return max_a < max_b || (max_a == max_b && a < b);
+  });
+  for (size_t k = 0; k < order.size(); ++k) {
     RTC_DCHECK_GT(bitrate, 0);
+    const size_t i = order[k];
+    const uint32_t max_bitrate =
+        max_multiplier * allocatable_tracks[i].config.max_bitrate_bps;
     uint32_t extra_allocation =
-        bitrate / static_cast<uint32_t>(list_max_bitrates.size());
-    uint32_t total_allocation =
-        extra_allocation + allocation->at(it->second->observer);
+        bitrate / static_cast<uint32_t>(order.size() - k);
+    uint32_t total_allocation = extra_allocation + (*allocation)[i];
     bitrate -= extra_allocation;
-    if (total_allocation > max_multiplier * it->first) {
+    if (total_allocation > max_bitrate) {
       // There is more than we can fit for this observer, carry over to the
       // remaining observers.
-      bitrate += total_allocation - max_multiplier * it->first;
-      total_allocation = max_multiplier * it->first;
+      bitrate += total_allocation - max_bitrate;
+      total_allocation = max_bitrate;
     }
     // Finally, update the allocation for this observer.
-    allocation->at(it->second->observer) = total_allocation;
-    it = list_max_bitrates.erase(it);
+    (*allocation)[i] = total_allocation;
   }
 }
 
 // From the available |bitrate|, each observer will be allocated a
 // proportional amount based upon its bitrate priority. If that amount is
-// more than the observer's capacity, it will be allocated its capacity, and
-// the excess bitrate is still allocated proportionally to other observers.
-// Allocating the proportional amount means an observer with twice the
-// bitrate_priority of another will be allocated twice the bitrate.
+// more than the observer's capacity, given by |scratch->capacities|, it will be
+// allocated its capacity, and the excess bitrate is still allocated
+// proportionally to other observers. Allocating the proportional amount means
+// an observer with twice the bitrate_priority of another will be allocated
+// twice the bitrate.
 void DistributeBitrateRelatively(
     const std::vector<AllocatableTrack>& allocatable_tracks,
     uint32_t remaining_bitrate,
-    const std::map<BitrateAllocatorObserver*, int>& observers_capacities,
-    std::map<BitrateAllocatorObserver*, int>* allocation) {
+    AllocationScratch* scratch,
+    std::vector<int>* allocation) {
   RTC_DCHECK_EQ(allocation->size(), allocatable_tracks.size());
-  RTC_DCHECK_EQ(observers_capacities.size(), allocatable_tracks.size());
-
-  struct PriorityRateObserverConfig {
-    BitrateAllocatorObserver* allocation_key;
-    // The amount of bitrate bps that can be allocated to this observer.
-    int capacity_bps;
-    double bitrate_priority;
-  };
+  RTC_DCHECK_EQ(scratch->capacities.size(), allocatable_tracks.size());
+  const std::vector<int>& capacities = scratch->capacities;
 
   double bitrate_priority_sum = 0;
-  std::vector<PriorityRateObserverConfig> priority_rate_observers;
-  for (const auto& observer_config : allocatable_tracks) {
-    priority_rate_observers.push_back(PriorityRateObserverConfig{
-        observer_config.observer,
-        observers_capacities.at(observer_config.observer),
-        observer_config.config.bitrate_priority});
-    bitrate_priority_sum += observer_config.config.bitrate_priority;
+  std::vector<size_t>& order = scratch->order;
+  order.clear();
+  for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+    order.push_back(i);
+    bitrate_priority_sum += allocatable_tracks[i].config.bitrate_priority;
   }
 
   // Iterate in the order observers can be allocated their full capacity.
@@ -149,69 +153,70 @@ void DistributeBitrateRelatively(
   // filled. This is because the amount allocated is based upon bitrate
   // priority. We allocate twice as much bitrate to an observer with twice the
   // bitrate priority of another.
-  absl::c_sort(priority_rate_observers, [](const auto& a, const auto& b) {
-    return a.capacity_bps / a.bitrate_priority <
-           b.capacity_bps / b.bitrate_priority;
+  absl::c_sort(order, [&](size_t a, size_t b) {
+    return capacities[a] / allocatable_tracks[a].config.bitrate_priority <
+           capacities[b] / allocatable_tracks[b].config.bitrate_priority;
   });
-  size_t i;
-  for (i = 0; i < priority_rate_observers.size(); ++i) {
-    const auto& priority_rate_observer = priority_rate_observers[i];
+  size_t k;
+  for (k = 0; k < order.size(); ++k) {
+    const size_t i = order[k];
+    const double bitrate_priority =
+        allocatable_tracks[i].config.bitrate_priority;
     // We allocate the full capacity to an observer only if its relative
     // portion from the remaining bitrate is sufficient to allocate its full
     // capacity. This means we aren't greedily allocating the full capacity, but
     // that it is only done when there is also enough bitrate to allocate the
     // proportional amounts to all other observers.
-    double observer_share =
-        priority_rate_observer.bitrate_priority / bitrate_priority_sum;
+    double observer_share = bitrate_priority / bitrate_priority_sum;
     double allocation_bps = observer_share * remaining_bitrate;
-    bool enough_bitrate = allocation_bps >= priority_rate_observer.capacity_bps;
+    bool enough_bitrate = allocation_bps >= capacities[i];
     if (!enough_bitrate)
       break;
-    allocation->at(priority_rate_observer.allocation_key) +=
-        priority_rate_observer.capacity_bps;
-    remaining_bitrate -= priority_rate_observer.capacity_bps;
-    bitrate_priority_sum -= priority_rate_observer.bitrate_priority;
+    (*allocation)[i] += capacities[i];
+    remaining_bitrate -= capacities[i];
+    bitrate_priority_sum -= bitrate_priority;
   }
 
   // From the remaining bitrate, allocate the proportional amounts to the
   // observers that aren't allocated their max capacity.
-  for (; i < priority_rate_observers.size(); ++i) {
-    const auto& priority_rate_observer = priority_rate_observers[i];
+  for (; k < order.size(); ++k) {
+    const size_t i = order[k];
     double fraction_allocated =
-        priority_rate_observer.bitrate_priority / bitrate_priority_sum;
-    allocation->at(priority_rate_observer.allocation_key) +=
-        fraction_allocated * remaining_bitrate;
+        allocatable_tracks[i].config.bitrate_priority / bitrate_priority_sum;
+    (*allocation)[i] += fraction_allocated * remaining_bitrate;
   }
 }
 
 // Allocates bitrate to observers when there isn't enough to allocate the
 // minimum to all observers.
-std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
-    const std::vector<AllocatableTrack>& allocatable_tracks,
-    uint32_t bitrate) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
+void LowRateAllocation(const std::vector<AllocatableTrack>& allocatable_tracks,
+                       uint32_t bitrate,
+                       AllocationScratch* scratch,
+                       std::vector<int>* allocation) {
   // Start by allocating bitrate to observers enforcing a min bitrate, hence
   // remaining_bitrate might turn negative.
   int64_t remaining_bitrate = bitrate;
-  for (const auto& observer_config : allocatable_tracks) {
+  for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+    const auto& observer_config = allocatable_tracks[i];
     int32_t allocated_bitrate = 0;
     if (observer_config.config.enforce_min_bitrate)
       allocated_bitrate = observer_config.config.min_bitrate_bps;
 
-    allocation[observer_config.observer] = allocated_bitrate;
+    (*allocation)[i] = allocated_bitrate;
     remaining_bitrate -= allocated_bitrate;
   }
 
   // Allocate bitrate to all previously active streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : allocatable_tracks) {
+    for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+      const auto& observer_config = allocatable_tracks[i];
       if (observer_config.config.enforce_min_bitrate ||
           observer_config.LastAllocatedBitrate() == 0)
         continue;
 
       uint32_t required_bitrate = observer_config.MinBitrateWithHysteresis();
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        (*allocation)[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -219,14 +224,15 @@ std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
 
   // Allocate bitrate to previously paused streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : allocatable_tracks) {
+    for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+      const auto& observer_config = allocatable_tracks[i];
       if (observer_config.LastAllocatedBitrate() != 0)
         continue;
 
       // Add a hysteresis to avoid toggling.
       uint32_t required_bitrate = observer_config.MinBitrateWithHysteresis();
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        (*allocation)[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -235,10 +241,7 @@ std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
   // Split a possible remainder evenly on all streams with an allocation.
   if (remaining_bitrate > 0)
     DistributeBitrateEvenly(allocatable_tracks, remaining_bitrate, false, 1,
-                            &allocation);
-
-  RTC_DCHECK_EQ(allocation.size(), allocatable_tracks.size());
-  return allocation;
+                            scratch, allocation);
 }
 
 // Allocates bitrate to all observers when the available bandwidth is enough
@@ -252,32 +255,32 @@ std::map<BitrateAllocatorObserver*, int> LowRateAllocation(
 // bitrate_priority = 2.0, the expected behavior is that observer 2 will be
 // allocated twice the bitrate as observer 1 above the each observer's
 // min_bitrate_bps values, until one of the observers hits its max_bitrate_bps.
-std::map<BitrateAllocatorObserver*, int> NormalRateAllocation(
+void NormalRateAllocation(
     const std::vector<AllocatableTrack>& allocatable_tracks,
     uint32_t bitrate,
-    uint32_t sum_min_bitrates) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
-  std::map<BitrateAllocatorObserver*, int> observers_capacities;
-  for (const auto& observer_config : allocatable_tracks) {
-    allocation[observer_config.observer] =
-        observer_config.config.min_bitrate_bps;
-    observers_capacities[observer_config.observer] =
-        observer_config.config.max_bitrate_bps -
-        observer_config.config.min_bitrate_bps;
+    uint32_t sum_min_bitrates,
+    AllocationScratch* scratch,
+    std::vector<int>* allocation) {
+  std::vector<int>& capacities = scratch->capacities;
+  capacities.resize(allocatable_tracks.size());
+  for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+    const auto& observer_config = allocatable_tracks[i];
+    (*allocation)[i] = observer_config.config.min_bitrate_bps;
+    capacities[i] = observer_config.config.max_bitrate_bps -
+                    observer_config.config.min_bitrate_bps;
   }
 
   bitrate -= sum_min_bitrates;
 
   // TODO(srte): Implement fair sharing between prioritized streams, currently
   // they are treated on a first come first serve basis.
-  for (const auto& observer_config : allocatable_tracks) {
-    int64_t priority_margin = observer_config.config.priority_bitrate_bps -
-                              allocation[observer_config.observer];
+  for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+    int64_t priority_margin =
+        allocatable_tracks[i].config.priority_bitrate_bps - (*allocation)[i];
     if (priority_margin > 0 && bitrate > 0) {
       int64_t extra_bitrate = std::min<int64_t>(priority_margin, bitrate);
-      allocation[observer_config.observer] +=
-          rtc::dchecked_cast<int>(extra_bitrate);
-      observers_capacities[observer_config.observer] -= extra_bitrate;
+      (*allocation)[i] += rtc::dchecked_cast<int>(extra_bitrate);
+      capacities[i] -= extra_bitrate;
       bitrate -= extra_bitrate;
     }
   }
@@ -285,47 +288,34 @@ std::map<BitrateAllocatorObserver*, int> NormalRateAllocation(
   // From the remaining bitrate, allocate a proportional amount to each observer
   // above the min bitrate already allocated.
   if (bitrate > 0)
-    DistributeBitrateRelatively(allocatable_tracks, bitrate,
-                                observers_capacities, &allocation);
-
-  return allocation;
+    DistributeBitrateRelatively(allocatable_tracks, bitrate, scratch,
+                                allocation);
 }
 
 // Allocates bitrate to observers when there is enough available bandwidth
 // for all observers to be allocated their max bitrate.
-std::map<BitrateAllocatorObserver*, int> MaxRateAllocation(
-    const std::vector<AllocatableTrack>& allocatable_tracks,
-    uint32_t bitrate,
-    uint32_t sum_max_bitrates) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
-
-  for (const auto& observer_config : allocatable_tracks) {
-    allocation[observer_config.observer] =
-        observer_config.config.max_bitrate_bps;
-    bitrate -= observer_config.config.max_bitrate_bps;
+void MaxRateAllocation(const std::vector<AllocatableTrack>& allocatable_tracks,
+                       uint32_t bitrate,
+                       uint32_t sum_max_bitrates,
+                       AllocationScratch* scratch,
+                       std::vector<int>* allocation) {
+  for (size_t i = 0; i < allocatable_tracks.size(); ++i) {
+    (*allocation)[i] = allocatable_tracks[i].config.max_bitrate_bps;
   }
-  DistributeBitrateEvenly(allocatable_tracks, bitrate, true,
-                          kTransmissionMaxBitrateMultiplier, &allocation);
-  return allocation;
-}
-
-// Allocates zero bitrate to all observers.
-std::map<BitrateAllocatorObserver*, int> ZeroRateAllocation(
-    const std::vector<AllocatableTrack>& allocatable_tracks) {
-  std::map<BitrateAllocatorObserver*, int> allocation;
-  for (const auto& observer_config : allocatable_tracks)
-    allocation[observer_config.observer] = 0;
-  return allocation;
+  DistributeBitrateEvenly(allocatable_tracks, bitrate - sum_max_bitrates, true,
+                          kTransmissionMaxBitrateMultiplier, scratch,
+                          allocation);
 }
 
-std::map<BitrateAllocatorObserver*, int> AllocateBitrates(
-    const std::vector<AllocatableTrack>& allocatable_tracks,
-    uint32_t bitrate) {
-  if (allocatable_tracks.empty())
-    return std::map<BitrateAllocatorObserver*, int>();
-
-  if (bitrate == 0)
-    return ZeroRateAllocation(allocatable_tracks);
+// Allocates |bitrate| to |allocatable_tracks|, into |allocation| by index in
+// |allocatable_tracks|. Reuses the memory of |scratch| and |allocation|.
+void AllocateBitrates(const std::vector<AllocatableTrack>& allocatable_tracks,
+                      uint32_t bitrate,
+                      AllocationScratch* scratch,
+                      std::vector<int>* allocation) {
+  allocation->assign(allocatable_tracks.size(), 0);
+  if (allocatable_tracks.empty() || bitrate == 0)
+    return;
 
   uint32_t sum_min_bitrates = 0;
   uint32_t sum_max_bitrates = 0;
@@ -338,16 +328,52 @@ std::map<BitrateAllocatorObserver*, int> AllocateBitrates(
   // enforced min bitrate -> allocated bitrate previous round -> restart paused
   // streams.
   if (!EnoughBitrateForAllObservers(allocatable_tracks, bitrate,
-                                    sum_min_bitrates))
-    return LowRateAllocation(allocatable_tracks, bitrate);
+                                    sum_min_bitrates)) {
+    LowRateAllocation(allocatable_tracks, bitrate, scratch, allocation);
+    return;
+  }
 
   // All observers will get their min bitrate plus a share of the rest. This
   // share is allocated to each observer based on its bitrate_priority.
-  if (bitrate <= sum_max_bitrates)
-    return NormalRateAllocation(allocatable_tracks, bitrate, sum_min_bitrates);
+  if (bitrate <= sum_max_bitrates) {
+    NormalRateAllocation(allocatable_tracks, bitrate, sum_min_bitrates,
+                         scratch, allocation);
+    return;
+  }
 
   // All observers will get up to transmission_max_bitrate_multiplier_ x max.
-  return MaxRateAllocation(allocatable_tracks, bitrate, sum_max_bitrates);
+  MaxRateAllocation(allocatable_tracks, bitrate, sum_max_bitrates, scratch,
+                    allocation);
+}
+
+// Whether an observer that was last notified of |last_update| needs to be
+// notified of |update|, given the update threshold |threshold|.
+bool NeedsUpdate(const absl::optional<BitrateAllocationUpdate>& last_update,
+                 const BitrateAllocationUpdate& update,
+                 absl::optional<double> threshold) {
+  if (!threshold || !last_update)
+    return true;
+  auto rate_changed = [&threshold](DataRate last, DataRate rate) {
+    if (last.IsZero() || rate.IsZero())
+      return last != rate;
+    return std::abs(last.bps() - rate.bps()) > last.bps() * *threshold;
+  };
+  return rate_changed(last_update->target_bitrate, update.target_bitrate) ||
+         rate_changed(last_update->stable_target_bitrate,
+                      update.stable_target_bitrate) ||
+         last_update->packet_loss_ratio != update.packet_loss_ratio ||
+         last_update->round_trip_time != update.round_trip_time ||
+         last_update->bwe_period != update.bwe_period ||
+         last_update->cwnd_reduce_ratio != update.cwnd_reduce_ratio;
+}
+
+absl::optional<double> ParseUpdateThreshold() {
+  FieldTrialOptional<double> threshold("threshold");
+  ParseFieldTrial({&threshold},
+                  field_trial::FindFullName(kAllocationUpdateThreshold));
+  if (!threshold)
+    return absl::nullopt;
+  return std::max(threshold.Value(), 0.0);
 }
 
 }  // namespace
@@ -361,7 +387,8 @@ BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
       last_rtt_(0),
       last_bwe_period_ms_(1000),
       num_pause_events_(0),
-      last_bwe_log_time_(0) {
+      last_bwe_log_time_(0),
+      update_threshold_(ParseUpdateThreshold()) {
   sequenced_checker_.Detach();
 }
 
@@ -395,22 +422,26 @@ void BitrateAllocator::OnNetworkEstimateChanged(TargetTransferRate msg) {
     last_bwe_log_time_ = now;
   }
 
-  auto allocation = AllocateBitrates(allocatable_tracks_, last_target_bps_);
-  auto stable_bitrate_allocation =
-      AllocateBitrates(allocatable_tracks_, last_stable_target_bps_);
+  UpdateAllocations();
 
-  for (auto& config : allocatable_tracks_) {
-    uint32_t allocated_bitrate = allocation[config.observer];
-    uint32_t allocated_stable_target_rate =
-        stable_bitrate_allocation[config.observer];
+  for (size_t i = 0; i < allocatable_tracks_.size(); ++i) {
+    AllocatableTrack& config = allocatable_tracks_[i];
+    uint32_t allocated_bitrate = allocation_[i];
     BitrateAllocationUpdate update;
     update.target_bitrate = DataRate::BitsPerSec(allocated_bitrate);
-    update.stable_target_bitrate =
-        DataRate::BitsPerSec(allocated_stable_target_rate);
+    update.stable_target_bitrate = DataRate::BitsPerSec(stable_allocation_[i]);
     update.packet_loss_ratio = last_fraction_loss_ / 256.0;
     update.round_trip_time = TimeDelta::Millis(last_rtt_);
     update.bwe_period = TimeDelta::Millis(last_bwe_period_ms_);
     update.cwnd_reduce_ratio = msg.cwnd_reduce_ratio;
+    // With an update threshold, observers whose allocation hasn't changed
+    // noticeably keep the one they were last notified of, and don't report
+    // their protection bitrate. Pausing and resuming always notifies.
+    if (!NeedsUpdate(config.last_update, update, update_threshold_)) {
+      config.allocated_bitrate_bps = allocated_bitrate;
+      continue;
+    }
+    config.last_update = update;
     uint32_t protection_bitrate = config.observer->OnBitrateUpdated(update);
 
     if (allocated_bitrate == 0 && config.allocated_bitrate_bps > 0) {
@@ -461,22 +492,19 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
 
   if (last_target_bps_ > 0) {
     // Calculate a new allocation and update all observers.
-
-    auto allocation = AllocateBitrates(allocatable_tracks_, last_target_bps_);
-    auto stable_bitrate_allocation =
-        AllocateBitrates(allocatable_tracks_, last_stable_target_bps_);
-    for (auto& config : allocatable_tracks_) {
-      uint32_t allocated_bitrate = allocation[config.observer];
-      uint32_t allocated_stable_bitrate =
-          stable_bitrate_allocation[config.observer];
+    UpdateAllocations();
+    for (size_t i = 0; i < allocatable_tracks_.size(); ++i) {
+      AllocatableTrack& config = allocatable_tracks_[i];
+      uint32_t allocated_bitrate = allocation_[i];
       BitrateAllocationUpdate update;
       update.target_bitrate = DataRate::BitsPerSec(allocated_bitrate);
       update.stable_target_bitrate =
-          DataRate::BitsPerSec(allocated_stable_bitrate);
+          DataRate::BitsPerSec(stable_allocation_[i]);
       update.packet_loss_ratio = last_fraction_loss_ / 256.0;
       update.round_trip_time = TimeDelta::Millis(last_rtt_);
       update.bwe_period = TimeDelta::Millis(last_bwe_period_ms_);
       uint32_t protection_bitrate = config.observer->OnBitrateUpdated(update);
+      config.last_update = update;
       config.allocated_bitrate_bps = allocated_bitrate;
       if (allocated_bitrate > 0)
         config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
@@ -497,6 +525,18 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
   UpdateAllocationLimits();
 }
 
+void BitrateAllocator::UpdateAllocations() {
+  AllocateBitrates(allocatable_tracks_, last_target_bps_, &scratch_,
+                   &allocation_);
+  // The stable target is often the target itself, which allocates the same.
+  if (last_stable_target_bps_ == last_target_bps_) {
+    stable_allocation_ = allocation_;
+  } else {
+    AllocateBitrates(allocatable_tracks_, last_stable_target_bps_, &scratch_,
+                     &stable_allocation_);
+  }
+}
+
 void BitrateAllocator::UpdateAllocationLimits() {
   BitrateAllocationLimits limits;
   for (const auto& config : allocatable_tracks_) {
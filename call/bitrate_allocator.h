@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "api/call/bitrate_allocation.h"
 #include "api/transport/network_types.h"
 #include "rtc_base/synchronization/sequence_checker.h"
@@ -86,12 +87,23 @@ struct AllocatableTrack {
   MediaStreamAllocationConfig config;
   int64_t allocated_bitrate_bps;
   double media_ratio;  // Part of the total bitrate used for media [0.0, 1.0].
+  // The update the observer was last notified of.
+  absl::optional<BitrateAllocationUpdate> last_update;
 
   uint32_t LastAllocatedBitrate() const;
   // The minimum bitrate required by this observer, including
   // enable-hysteresis if the observer is in a paused state.
   uint32_t MinBitrateWithHysteresis() const;
 };
+
+// Working memory of an allocation, kept between allocations so that they
+// don't need to allocate memory.
+struct AllocationScratch {
+  // Indices into the tracks, in the order they are allocated.
+  std::vector<size_t> order;
+  // The bitrate that can still be allocated to each track.
+  std::vector<int> capacities;
+};
 }  // namespace bitrate_allocator_impl
 
 // Usage: this class will register multiple RtcpBitrateObserver's one at each
@@ -138,6 +150,10 @@ class BitrateAllocator : public BitrateAllocatorInterface {
  private:
   using AllocatableTrack = bitrate_allocator_impl::AllocatableTrack;
 
+  // Allocates |last_target_bps_| and |last_stable_target_bps_| to the tracks,
+  // into |allocation_| and |stable_allocation_|.
+  void UpdateAllocations() RTC_RUN_ON(&sequenced_checker_);
+
   // Calculates the minimum requested send bitrate and max padding bitrate and
   // calls LimitObserver::OnAllocationLimitsChanged.
   void UpdateAllocationLimits() RTC_RUN_ON(&sequenced_checker_);
@@ -163,6 +179,16 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   int num_pause_events_ RTC_GUARDED_BY(&sequenced_checker_);
   int64_t last_bwe_log_time_ RTC_GUARDED_BY(&sequenced_checker_);
   BitrateAllocationLimits current_limits_ RTC_GUARDED_BY(&sequenced_checker_);
+  // If set, observers are not notified of an update whose rates differ from
+  // the last ones they got by at most this fraction of them, and whose other
+  // fields are the same.
+  const absl::optional<double> update_threshold_;
+  // The last allocation of the target and stable target rates, by index in
+  // |allocatable_tracks_|.
+  std::vector<int> allocation_ RTC_GUARDED_BY(&sequenced_checker_);
+  std::vector<int> stable_allocation_ RTC_GUARDED_BY(&sequenced_checker_);
+  bitrate_allocator_impl::AllocationScratch scratch_
+      RTC_GUARDED_BY(&sequenced_checker_);
 };
 
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "system_wrappers/include/clock.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -60,7 +61,8 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
         last_fraction_loss_(0),
         last_rtt_ms_(0),
         last_probing_interval_ms_(0),
-        protection_ratio_(0.0) {}
+        protection_ratio_(0.0),
+        num_updates_(0) {}
 
   void SetBitrateProtectionRatio(double protection_ratio) {
     protection_ratio_ = protection_ratio;
@@ -72,6 +74,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
         rtc::dchecked_cast<uint8_t>(update.packet_loss_ratio * 256);
     last_rtt_ms_ = update.round_trip_time.ms();
     last_probing_interval_ms_ = update.bwe_period.ms();
+    ++num_updates_;
     return update.target_bitrate.bps() * protection_ratio_;
   }
   uint32_t last_bitrate_bps_;
@@ -79,6 +82,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
   int64_t last_rtt_ms_;
   int last_probing_interval_ms_;
   double protection_ratio_;
+  int num_updates_;
 };
 
 constexpr int64_t kDefaultProbingIntervalMs = 3000;
@@ -1033,4 +1037,72 @@ TEST_F(BitrateAllocatorTest, PriorityRateThreeObserversTwoAllocatedToMax) {
   allocator_->RemoveObserver(&observer_high);
 }
 
+TEST(BitrateAllocatorUpdateThresholdTest, DoesNotNotifyUnchangedAllocation) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-Bwe-AllocationUpdateThreshold/threshold:0/");
+  NiceMock<MockLimitObserver> limit_observer;
+  BitrateAllocator allocator(&limit_observer);
+  TestBitrateObserver observer_low;
+  TestBitrateObserver observer_high;
+  allocator.AddObserver(&observer_low, {100000, 200000, 0, 0, false,
+                                        kDefaultBitratePriority});
+  allocator.AddObserver(&observer_high, {100000, 1000000, 0, 0, false,
+                                         kDefaultBitratePriority});
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(600000, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(200000u, observer_low.last_bitrate_bps_);
+  EXPECT_EQ(400000u, observer_high.last_bitrate_bps_);
+  const int low_updates = observer_low.num_updates_;
+  const int high_updates = observer_high.num_updates_;
+
+  // Only the allocation of |observer_high| changes.
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(700000, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(low_updates, observer_low.num_updates_);
+  EXPECT_EQ(high_updates + 1, observer_high.num_updates_);
+  EXPECT_EQ(500000u, observer_high.last_bitrate_bps_);
+
+  // A change of round trip time is passed to all observers.
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(700000, 0, 100, kDefaultProbingIntervalMs));
+  EXPECT_EQ(low_updates + 1, observer_low.num_updates_);
+  EXPECT_EQ(100, observer_low.last_rtt_ms_);
+
+  allocator.RemoveObserver(&observer_low);
+  allocator.RemoveObserver(&observer_high);
+}
+
+TEST(BitrateAllocatorUpdateThresholdTest, NotifiesChangesAboveThreshold) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-Bwe-AllocationUpdateThreshold/threshold:0.1/");
+  NiceMock<MockLimitObserver> limit_observer;
+  BitrateAllocator allocator(&limit_observer);
+  TestBitrateObserver observer;
+  allocator.AddObserver(&observer, {100000, 1000000, 0, 0, false,
+                                    kDefaultBitratePriority});
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(500000, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(500000u, observer.last_bitrate_bps_);
+
+  // Within 10% of the last notified allocation.
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(540000, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(500000u, observer.last_bitrate_bps_);
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(460000, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(500000u, observer.last_bitrate_bps_);
+  EXPECT_EQ(460000, allocator.GetStartBitrate(&observer));
+
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(560000, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(560000u, observer.last_bitrate_bps_);
+
+  // Pausing is always notified.
+  allocator.OnNetworkEstimateChanged(
+      CreateTargetRateMessage(0, 0, 50, kDefaultProbingIntervalMs));
+  EXPECT_EQ(0u, observer.last_bitrate_bps_);
+
+  allocator.RemoveObserver(&observer);
+}
+
 }  // namespace webrtc
@@ -30,6 +30,7 @@
 #include "call/receive_time_calculator.h"
 #include "call/rtp_stream_receiver_controller.h"
 #include "call/rtp_transport_controller_send.h"
+#include "call/selective_forwarding_stream_impl.h"
 #include "logging/rtc_event_log/events/rtc_event_audio_receive_stream_config.h"
 #include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
 #include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
@@ -100,6 +101,10 @@ bool UseSendSideBwe(const FlexfecReceiveStream::Config& config) {
   return UseSendSideBwe(config.rtp_header_extensions, config.transport_cc);
 }
 
+bool UseSendSideBwe(const SelectiveForwardingStream::Config& config) {
+  return UseSendSideBwe(config.rtp_header_extensions, config.transport_cc);
+}
+
 const int* FindKeyByValue(const std::map<int, int>& m, int v) {
   for (const auto& kv : m) {
     if (kv.second == v)
@@ -212,6 +217,11 @@ class Call final : public webrtc::Call,
   void DestroyFlexfecReceiveStream(
       FlexfecReceiveStream* receive_stream) override;
 
+  SelectiveForwardingStream* CreateSelectiveForwardingStream(
+      const SelectiveForwardingStream::Config& config) override;
+  void DestroySelectiveForwardingStream(
+      SelectiveForwardingStream* forwarding_stream) override;
+
   RtpTransportControllerSendInterface* GetTransportControllerSend() override;
 
   Stats GetStats() const override;
@@ -313,6 +323,9 @@ class Call final : public webrtc::Call,
     explicit ReceiveRtpConfig(const FlexfecReceiveStream::Config& config)
         : extensions(config.rtp_header_extensions),
           use_send_side_bwe(UseSendSideBwe(config)) {}
+    explicit ReceiveRtpConfig(const SelectiveForwardingStream::Config& config)
+        : extensions(config.rtp_header_extensions),
+          use_send_side_bwe(UseSendSideBwe(config)) {}
 
     // Registered RTP header extensions for each stream. Note that RTP header
     // extensions are negotiated per track ("m= line") in the SDP, but we have
@@ -427,7 +440,9 @@ Call* Call::Create(const Call::Config& config,
       std::make_unique<RtpTransportControllerSend>(
           clock, config.event_log, config.network_state_predictor_factory,
           config.network_controller_factory, config.bitrate_config,
-          std::move(pacer_thread), config.task_queue_factory, config.trials),
+          std::move(pacer_thread), config.task_queue_factory,
+          config.shared_pacer, config.trials,
+          config.bandwidth_estimate_cache),
       std::move(call_thread), config.task_queue_factory);
 }
 
@@ -853,7 +868,8 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
       task_queue_factory_, call_stats_->AsRtcpRttStats(), transport_send_ptr_,
       bitrate_allocator_.get(), video_send_delay_stats_.get(), event_log_,
       std::move(config), std::move(encoder_config), suspended_video_send_ssrcs_,
-      suspended_video_payload_states_, std::move(fec_controller));
+      suspended_video_payload_states_, std::move(fec_controller),
+      config_.encode_task_queue_factory);
 
   for (uint32_t ssrc : ssrcs) {
     RTC_DCHECK(video_send_ssrcs_.find(ssrc) == video_send_ssrcs_.end());
@@ -933,7 +949,8 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
       task_queue_factory_, current, &video_receiver_controller_, num_cpu_cores_,
       transport_send_ptr_->packet_router(), std::move(configuration),
       module_process_thread_->process_thread(), call_stats_.get(), clock_,
-      new VCMTiming(clock_));
+      new VCMTiming(clock_), config_.decode_task_queue_factory,
+      config_.receive_task_queue_factory, config_.render_task_queue_factory);
 
   const webrtc::VideoReceiveStream::Config& config = receive_stream->config();
   if (config.rtp.rtx_ssrc) {
@@ -1024,6 +1041,41 @@ void Call::DestroyFlexfecReceiveStream(FlexfecReceiveStream* receive_stream) {
   delete receive_stream;
 }
 
+SelectiveForwardingStream* Call::CreateSelectiveForwardingStream(
+    const SelectiveForwardingStream::Config& config) {
+  TRACE_EVENT0("webrtc", "Call::CreateSelectiveForwardingStream");
+  RTC_DCHECK_RUN_ON(worker_thread_);
+
+  // As for FlexfecReceiveStream, the constructor registers the stream with
+  // video_receiver_controller_, so it has to run on the worker thread.
+  SelectiveForwardingStreamImpl* forwarding_stream =
+      new SelectiveForwardingStreamImpl(&video_receiver_controller_,
+                                        transport_send_ptr_->packet_sender(),
+                                        config);
+
+  RTC_DCHECK(receive_rtp_config_.find(config.remote_ssrc) ==
+             receive_rtp_config_.end());
+  receive_rtp_config_.emplace(config.remote_ssrc, ReceiveRtpConfig(config));
+
+  return forwarding_stream;
+}
+
+void Call::DestroySelectiveForwardingStream(
+    SelectiveForwardingStream* forwarding_stream) {
+  TRACE_EVENT0("webrtc", "Call::DestroySelectiveForwardingStream");
+  RTC_DCHECK_RUN_ON(worker_thread_);
+
+  RTC_DCHECK(forwarding_stream != nullptr);
+  const SelectiveForwardingStream::Config& config =
+      forwarding_stream->GetConfig();
+  uint32_t ssrc = config.remote_ssrc;
+  receive_rtp_config_.erase(ssrc);
+  receive_side_cc_.GetRemoteBitrateEstimator(UseSendSideBwe(config))
+      ->RemoveStream(ssrc);
+
+  delete static_cast<SelectiveForwardingStreamImpl*>(forwarding_stream);
+}
+
 RtpTransportControllerSendInterface* Call::GetTransportControllerSend() {
   return transport_send_ptr_;
 }
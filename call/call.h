@@ -22,6 +22,7 @@
 #include "call/flexfec_receive_stream.h"
 #include "call/packet_receiver.h"
 #include "call/rtp_transport_controller_send_interface.h"
+#include "call/selective_forwarding_stream.h"
 #include "call/video_receive_stream.h"
 #include "call/video_send_stream.h"
 #include "modules/utility/include/process_thread.h"
@@ -125,6 +126,13 @@ class Call {
   virtual void DestroyFlexfecReceiveStream(
       FlexfecReceiveStream* receive_stream) = 0;
 
+  // Forwards a received video stream to the send side without decoding it.
+  // |config.remote_ssrc| must not be received by any other receive stream.
+  virtual SelectiveForwardingStream* CreateSelectiveForwardingStream(
+      const SelectiveForwardingStream::Config& config) = 0;
+  virtual void DestroySelectiveForwardingStream(
+      SelectiveForwardingStream* forwarding_stream) = 0;
+
   // All received RTP and RTCP packets for the call should be inserted to this
   // PacketReceiver. The PacketReceiver pointer is valid as long as the
   // Call instance exists.
@@ -15,6 +15,7 @@
 #include "api/network_state_predictor.h"
 #include "api/rtc_error.h"
 #include "api/task_queue/task_queue_factory.h"
+#include "api/transport/bandwidth_estimate_cache.h"
 #include "api/transport/bitrate_settings.h"
 #include "api/transport/network_control.h"
 #include "api/transport/webrtc_key_value_config.h"
@@ -24,6 +25,7 @@ namespace webrtc {
 
 class AudioProcessing;
 class RtcEventLog;
+class SharedPacer;
 
 struct CallConfig {
   explicit CallConfig(RtcEventLog* event_log);
@@ -50,6 +52,32 @@ struct CallConfig {
   // Task Queue Factory to be used in this call. Required.
   TaskQueueFactory* task_queue_factory = nullptr;
 
+  // Task Queue Factory for the decode queues of video receive streams. If set,
+  // e.g. to a CreateTaskQueuePoolFactory() factory shared by all calls,
+  // decoding for all streams is multiplexed onto its threads instead of every
+  // stream getting a thread of its own. Optional, must outlive the call.
+  TaskQueueFactory* decode_task_queue_factory = nullptr;
+
+  // Like |decode_task_queue_factory|, but for the encoder queues of video send
+  // streams.
+  TaskQueueFactory* encode_task_queue_factory = nullptr;
+
+  // Like |decode_task_queue_factory|, but for the RTP packet processing of
+  // video receive streams. If set, each stream depacketizes and assembles its
+  // frames on a queue of its own instead of on the worker thread, which then
+  // only dispatches the packets. Optional, must outlive the call.
+  TaskQueueFactory* receive_task_queue_factory = nullptr;
+
+  // Like |decode_task_queue_factory|, but for the queues that smooth the
+  // delivery of decoded frames to the renderers of video receive streams, see
+  // VideoReceiveStream::Config::enable_prerenderer_smoothing.
+  TaskQueueFactory* render_task_queue_factory = nullptr;
+
+  // Pacer shared by all calls, which runs the pacing of this call on its task
+  // queues instead of on a pacer thread of its own. Optional, must outlive the
+  // call.
+  SharedPacer* shared_pacer = nullptr;
+
   // NetworkStatePredictor to use for this call.
   NetworkStatePredictorFactoryInterface* network_state_predictor_factory =
       nullptr;
@@ -57,6 +85,11 @@ struct CallConfig {
   // Network controller factory to use for this call.
   NetworkControllerFactoryInterface* network_controller_factory = nullptr;
 
+  // Bandwidth estimates of earlier calls, which this call starts from when
+  // one is cached for its network route, and to which it stores its last
+  // estimate. Optional, must outlive the call.
+  BandwidthEstimateCache* bandwidth_estimate_cache = nullptr;
+
   // NetEq factory to use for this call.
   NetEqFactory* neteq_factory = nullptr;
 
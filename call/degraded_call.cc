@@ -245,6 +245,16 @@ void DegradedCall::DestroyFlexfecReceiveStream(
   call_->DestroyFlexfecReceiveStream(receive_stream);
 }
 
+SelectiveForwardingStream* DegradedCall::CreateSelectiveForwardingStream(
+    const SelectiveForwardingStream::Config& config) {
+  return call_->CreateSelectiveForwardingStream(config);
+}
+
+void DegradedCall::DestroySelectiveForwardingStream(
+    SelectiveForwardingStream* forwarding_stream) {
+  call_->DestroySelectiveForwardingStream(forwarding_stream);
+}
+
 PacketReceiver* DegradedCall::Receiver() {
   if (receive_config_) {
     return this;
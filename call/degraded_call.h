@@ -31,6 +31,7 @@
 #include "call/flexfec_receive_stream.h"
 #include "call/packet_receiver.h"
 #include "call/rtp_transport_controller_send_interface.h"
+#include "call/selective_forwarding_stream.h"
 #include "call/simulated_network.h"
 #include "call/video_receive_stream.h"
 #include "call/video_send_stream.h"
@@ -77,6 +78,11 @@ class DegradedCall : public Call, private PacketReceiver {
   void DestroyFlexfecReceiveStream(
       FlexfecReceiveStream* receive_stream) override;
 
+  SelectiveForwardingStream* CreateSelectiveForwardingStream(
+      const SelectiveForwardingStream::Config& config) override;
+  void DestroySelectiveForwardingStream(
+      SelectiveForwardingStream* forwarding_stream) override;
+
   PacketReceiver* Receiver() override;
 
   RtpTransportControllerSendInterface* GetTransportControllerSend() override;
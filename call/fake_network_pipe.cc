@@ -13,7 +13,6 @@
 #include <string.h>
 
 #include <algorithm>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -262,7 +261,7 @@ size_t FakeNetworkPipe::SentPackets() {
 
 void FakeNetworkPipe::Process() {
   int64_t time_now_us;
-  std::queue<NetworkPacket> packets_to_deliver;
+  std::vector<NetworkPacket> packets_to_deliver;
   {
     rtc::CritScope crit(&process_lock_);
     time_now_us = clock_->TimeInMicroseconds();
@@ -279,22 +278,25 @@ void FakeNetworkPipe::Process() {
 
     std::vector<PacketDeliveryInfo> delivery_infos =
         network_behavior_->DequeueDeliverablePackets(time_now_us);
+    packets_to_deliver.reserve(delivery_infos.size());
     for (auto& delivery_info : delivery_infos) {
-      // In the common case where no reordering happens, find will return early
-      // as the first packet will be a match.
-      auto packet_it =
-          std::find_if(packets_in_flight_.begin(), packets_in_flight_.end(),
-                       [&delivery_info](StoredPacket& packet_ref) {
-                         return reinterpret_cast<uint64_t>(&packet_ref) ==
-                                delivery_info.packet_id;
-                       });
+      // The id is the address of the packet in |packets_in_flight_|, which
+      // only grows and shrinks at its ends and so never moves the packets.
+      // Using it directly avoids searching the deque for every packet when
+      // packets are reordered or dropped.
+      StoredPacket* stored_packet =
+          reinterpret_cast<StoredPacket*>(delivery_info.packet_id);
       // Check that the packet is in the deque of packets in flight.
-      RTC_CHECK(packet_it != packets_in_flight_.end());
+      RTC_DCHECK(std::any_of(packets_in_flight_.begin(),
+                             packets_in_flight_.end(),
+                             [stored_packet](const StoredPacket& packet_ref) {
+                               return &packet_ref == stored_packet;
+                             }));
       // Check that the packet is not already removed.
-      RTC_DCHECK(!packet_it->removed);
+      RTC_DCHECK(!stored_packet->removed);
 
-      NetworkPacket packet = std::move(packet_it->packet);
-      packet_it->removed = true;
+      NetworkPacket packet = std::move(stored_packet->packet);
+      stored_packet->removed = true;
 
       // Cleanup of removed packets at the beginning of the deque.
       while (!packets_in_flight_.empty() &&
@@ -306,7 +308,7 @@ void FakeNetworkPipe::Process() {
         int64_t added_delay_us =
             delivery_info.receive_time_us - packet.send_time();
         packet.IncrementArrivalTime(added_delay_us);
-        packets_to_deliver.emplace(std::move(packet));
+        packets_to_deliver.push_back(std::move(packet));
         // |time_now_us| might be later than when the packet should have
         // arrived, due to NetworkProcess being called too late. For stats, use
         // the time it should have been on the link.
@@ -319,11 +321,8 @@ void FakeNetworkPipe::Process() {
   }
 
   rtc::CritScope crit(&config_lock_);
-  while (!packets_to_deliver.empty()) {
-    NetworkPacket packet = std::move(packets_to_deliver.front());
-    packets_to_deliver.pop();
+  for (NetworkPacket& packet : packets_to_deliver)
     DeliverNetworkPacket(&packet);
-  }
 }
 
 void FakeNetworkPipe::DeliverNetworkPacket(NetworkPacket* packet) {
@@ -114,6 +114,13 @@ struct RtpConfig {
   // frame descriptor RTP header extension).
   bool raw_payload = false;
 
+  // Keep the packets of the latest key frame and the frames following it, and
+  // answer the first key frame request for them by resending the packets
+  // instead of encoding a new key frame. This is meant for broadcast-style
+  // streams, where the request comes from a receiver that joins late, and
+  // saves the bitrate spike of a new key frame.
+  bool cache_key_frames = false;
+
   // See LntfConfig for description.
   LntfConfig lntf;
 
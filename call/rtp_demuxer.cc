@@ -112,6 +112,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   RefreshKnownMids();
+  ClearSinkCache();
 
   RTC_LOG(LS_INFO) << "Added sink = " << sink << " for criteria "
                    << criteria.ToString();
@@ -186,6 +187,11 @@ void RtpDemuxer::RefreshKnownMids() {
   }
 }
 
+void RtpDemuxer::ClearSinkCache() {
+  cached_sink_by_ssrc_.clear();
+  last_cached_sink_ = nullptr;
+}
+
 bool RtpDemuxer::AddSink(uint32_t ssrc, RtpPacketSinkInterface* sink) {
   RtpDemuxerCriteria criteria;
   criteria.ssrcs.insert(ssrc);
@@ -207,6 +213,7 @@ bool RtpDemuxer::RemoveSink(const RtpPacketSinkInterface* sink) {
                        RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
                        RemoveFromMapByValue(&sink_by_rsid_, sink);
   RefreshKnownMids();
+  ClearSinkCache();
   bool removed = num_removed > 0;
   if (removed) {
     RTC_LOG(LS_INFO) << "Removed sink = " << sink << " bindings";
@@ -225,6 +232,43 @@ bool RtpDemuxer::OnRtpPacket(const RtpPacketReceived& packet) {
 
 RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
     const RtpPacketReceived& packet) {
+  const uint32_t ssrc = packet.Ssrc();
+  const bool has_mid_or_rsid = (use_mid_ && packet.HasExtension<RtpMid>()) ||
+                               packet.HasExtension<RtpStreamId>() ||
+                               packet.HasExtension<RepairedRtpStreamId>();
+  if (has_mid_or_rsid) {
+    cached_sink_by_ssrc_.erase(ssrc);
+    if (ssrc == last_cached_ssrc_) {
+      last_cached_sink_ = nullptr;
+    }
+    return ResolveSinkUncached(packet);
+  }
+
+  if (last_cached_sink_ != nullptr && ssrc == last_cached_ssrc_) {
+    return last_cached_sink_;
+  }
+  const auto cached_it = cached_sink_by_ssrc_.find(ssrc);
+  if (cached_it != cached_sink_by_ssrc_.end()) {
+    last_cached_ssrc_ = ssrc;
+    last_cached_sink_ = cached_it->second;
+    return last_cached_sink_;
+  }
+
+  RtpPacketSinkInterface* sink = ResolveSinkUncached(packet);
+  // Once the sink is bound to the SSRC, later packets without MID or RSID
+  // resolve to it whatever their payload type, until the sinks change.
+  const auto ssrc_sink_it = sink_by_ssrc_.find(ssrc);
+  if (sink != nullptr && ssrc_sink_it != sink_by_ssrc_.end() &&
+      ssrc_sink_it->second == sink) {
+    cached_sink_by_ssrc_[ssrc] = sink;
+    last_cached_ssrc_ = ssrc;
+    last_cached_sink_ = sink;
+  }
+  return sink;
+}
+
+RtpPacketSinkInterface* RtpDemuxer::ResolveSinkUncached(
+    const RtpPacketReceived& packet) {
   // See the BUNDLE spec for high level reference to this algorithm:
   // https://tools.ietf.org/html/draft-ietf-mmusic-sdp-bundle-negotiation-38#section-10.2
 
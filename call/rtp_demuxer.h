@@ -17,6 +17,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+
 namespace webrtc {
 
 class RtpPacketReceived;
@@ -146,7 +148,10 @@ class RtpDemuxer {
 
   // Configure whether to look at the MID header extension when demuxing
   // incoming RTP packets. By default this is enabled.
-  void set_use_mid(bool use_mid) { use_mid_ = use_mid; }
+  void set_use_mid(bool use_mid) {
+    use_mid_ = use_mid;
+    ClearSinkCache();
+  }
 
  private:
   // Returns true if adding a sink with the given criteria would cause conflicts
@@ -157,7 +162,10 @@ class RtpDemuxer {
   // should receive the packet.
   // Will record any SSRC<->ID associations along the way.
   // If the packet should be dropped, this method returns null.
+  // Resolves the sink through the SSRC sink cache if possible, and otherwise
+  // through ResolveSinkUncached().
   RtpPacketSinkInterface* ResolveSink(const RtpPacketReceived& packet);
+  RtpPacketSinkInterface* ResolveSinkUncached(const RtpPacketReceived& packet);
 
   // Used by the ResolveSink algorithm.
   RtpPacketSinkInterface* ResolveSinkByMid(const std::string& mid,
@@ -174,6 +182,9 @@ class RtpDemuxer {
   // sink_by_mid_and_rsid_ maps.
   void RefreshKnownMids();
 
+  // Must be called whenever the sinks or their criteria change.
+  void ClearSinkCache();
+
   // Map each sink by its component attributes to facilitate quick lookups.
   // Payload Type mapping is a multimap because if two sinks register for the
   // same payload type, both AddSinks succeed but we must know not to demux on
@@ -210,6 +221,18 @@ class RtpDemuxer {
   std::vector<SsrcBindingObserver*> ssrc_binding_observers_;
 
   bool use_mid_ = true;
+
+  // Sinks of SSRCs whose last packet carried neither MID nor RSID and was
+  // demuxed by the state bound to its SSRC, i.e. a latched MID or RSID or an
+  // SSRC binding. The next such packet of the SSRC goes to the same sink, so
+  // established streams skip the lookups by string. Entries only exist for
+  // SSRCs in |sink_by_ssrc_|, which bounds the size. A packet carrying a MID
+  // or RSID may change what is latched for its SSRC, so it removes the entry.
+  absl::flat_hash_map<uint32_t, RtpPacketSinkInterface*> cached_sink_by_ssrc_;
+  // The entry of |cached_sink_by_ssrc_| used last, since packets tend to come
+  // in bursts per stream. Null if there is none.
+  uint32_t last_cached_ssrc_ = 0;
+  RtpPacketSinkInterface* last_cached_sink_ = nullptr;
 };
 
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "call/ssrc_binding_observer.h"
 #include "call/test/mock_rtp_packet_sink_interface.h"
@@ -21,7 +22,9 @@
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/time_utils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -1486,6 +1489,91 @@ TEST_F(RtpDemuxerTest, MaliciousPeerCannotCauseMemoryOveruse) {
   }
 }
 
+TEST_F(RtpDemuxerTest, PacketWithNewMidRebindsSsrcRoutedByLatchedMid) {
+  const std::string mid1 = "v";
+  const std::string mid2 = "a";
+  constexpr uint32_t ssrc = 10;
+  MockRtpPacketSink sink1;
+  MockRtpPacketSink sink2;
+  AddSinkOnlyMid(mid1, &sink1);
+  AddSinkOnlyMid(mid2, &sink2);
+
+  InSequence seq;
+  EXPECT_CALL(sink1, OnRtpPacket(_)).Times(3);
+  EXPECT_CALL(sink2, OnRtpPacket(_)).Times(3);
+
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrcMid(ssrc, mid1)));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc)));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc)));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrcMid(ssrc, mid2)));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc)));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc)));
+}
+
+TEST_F(RtpDemuxerTest, PacketsWithOnlySsrcFollowAddedAndRemovedSinks) {
+  constexpr uint32_t ssrc1 = 10;
+  constexpr uint32_t ssrc2 = 11;
+  MockRtpPacketSink sink1;
+  MockRtpPacketSink sink2;
+  AddSinkOnlySsrc(ssrc1, &sink1);
+
+  EXPECT_CALL(sink1, OnRtpPacket(_)).Times(2);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc1)));
+  EXPECT_FALSE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc2)));
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc1)));
+
+  AddSinkOnlySsrc(ssrc2, &sink2);
+  EXPECT_CALL(sink2, OnRtpPacket(_)).Times(1);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc2)));
+
+  RemoveSink(&sink1);
+  EXPECT_FALSE(demuxer_.OnRtpPacket(*CreatePacketWithSsrc(ssrc1)));
+}
+
+class CountingRtpPacketSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override { ++num_packets; }
+
+  int num_packets = 0;
+};
+
+// Measures the time to demux packets of established streams, with a single sink
+// per SSRC.
+TEST_F(RtpDemuxerTest, DISABLED_DemuxPerformance) {
+  constexpr int kNumStreams = 300;
+  constexpr int kNumRounds = 10000;
+  constexpr int kPacketsPerBurst = 4;
+  std::vector<std::unique_ptr<CountingRtpPacketSink>> sinks;
+  std::vector<std::unique_ptr<RtpPacketReceived>> packets;
+  for (int i = 0; i < kNumStreams; ++i) {
+    sinks.push_back(std::make_unique<CountingRtpPacketSink>());
+    const uint32_t ssrc = 1000 + 2 * i;
+    const std::string mid = std::to_string(i);
+    AddSinkOnlyMid(mid, sinks.back().get());
+    // Latch the MID, then demux by SSRC as when senders stop sending it.
+    demuxer_.OnRtpPacket(*CreatePacketWithSsrcMid(ssrc, mid));
+    packets.push_back(CreatePacketWithSsrc(ssrc));
+  }
+
+  const int64_t start_us = rtc::TimeMicros();
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (const auto& packet : packets) {
+      for (int i = 0; i < kPacketsPerBurst; ++i)
+        demuxer_.OnRtpPacket(*packet);
+    }
+  }
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  RTC_LOG(LS_INFO) << "Demuxed "
+                   << kNumRounds * kNumStreams * kPacketsPerBurst
+                   << " packets of " << kNumStreams << " streams in "
+                   << elapsed_us << " us, "
+                   << 1000.0 * elapsed_us /
+                          (kNumRounds * kNumStreams * kPacketsPerBurst)
+                   << " ns per packet.";
+  for (const auto& sink : sinks)
+    EXPECT_EQ(sink->num_packets, 1 + kNumRounds * kPacketsPerBurst);
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 
 TEST_F(RtpDemuxerDeathTest, CriteriaMustBeNonEmpty) {
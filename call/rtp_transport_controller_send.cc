@@ -9,6 +9,7 @@
  */
 #include "call/rtp_transport_controller_send.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "logging/rtc_event_log/events/rtc_event_route_change.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/rate_limiter.h"
 
@@ -78,12 +80,15 @@ RtpTransportControllerSend::RtpTransportControllerSend(
     const BitrateConstraints& bitrate_config,
     std::unique_ptr<ProcessThread> process_thread,
     TaskQueueFactory* task_queue_factory,
-    const WebRtcKeyValueConfig* trials)
+    SharedPacer* shared_pacer,
+    const WebRtcKeyValueConfig* trials,
+    BandwidthEstimateCache* estimate_cache)
     : clock_(clock),
       event_log_(event_log),
       bitrate_configurator_(bitrate_config),
       process_thread_(std::move(process_thread)),
-      use_task_queue_pacer_(IsEnabled(trials, "WebRTC-TaskQueuePacer")),
+      use_task_queue_pacer_(shared_pacer ||
+                            IsEnabled(trials, "WebRTC-TaskQueuePacer")),
       process_thread_pacer_(use_task_queue_pacer_
                                 ? nullptr
                                 : new PacedSender(clock,
@@ -92,7 +97,7 @@ RtpTransportControllerSend::RtpTransportControllerSend(
                                                   trials,
                                                   process_thread_.get())),
       task_queue_pacer_(
-          use_task_queue_pacer_
+          use_task_queue_pacer_ && !shared_pacer
               ? new TaskQueuePacedSender(
                     clock,
                     &packet_router_,
@@ -101,12 +106,17 @@ RtpTransportControllerSend::RtpTransportControllerSend(
                     task_queue_factory,
                     /*hold_back_window = */ PacingController::kMinSleepTime)
               : nullptr),
+      shared_pacer_sender_(
+          shared_pacer
+              ? shared_pacer->CreateSender(&packet_router_, event_log, trials)
+              : nullptr),
       observer_(nullptr),
       controller_factory_override_(controller_factory),
       controller_factory_fallback_(
           std::make_unique<GoogCcNetworkControllerFactory>(predictor_factory)),
       process_interval_(controller_factory_fallback_->GetProcessInterval()),
       last_report_block_time_(Timestamp::Millis(clock_->TimeInMilliseconds())),
+      estimate_cache_(estimate_cache),
       reset_feedback_on_route_change_(
           !IsEnabled(trials, "WebRTC-Bwe-NoFeedbackReset")),
       send_side_bwe_with_overhead_(
@@ -136,6 +146,15 @@ RtpTransportControllerSend::RtpTransportControllerSend(
 }
 
 RtpTransportControllerSend::~RtpTransportControllerSend() {
+  if (estimate_cache_) {
+    rtc::Event done;
+    task_queue_.PostTask([this, &done] {
+      RTC_DCHECK_RUN_ON(&task_queue_);
+      MaybeStoreEstimate();
+      done.Set();
+    });
+    done.Wait(rtc::Event::kForever);
+  }
   if (!use_task_queue_pacer_) {
     process_thread_->Stop();
   }
@@ -181,12 +200,16 @@ void RtpTransportControllerSend::UpdateControlState() {
   if (!update)
     return;
   retransmission_rate_limiter_.SetMaxRate(update->target_rate.bps());
+  last_target_rate_ = update->target_rate;
   // We won't create control_handler_ until we have an observers.
   RTC_DCHECK(observer_ != nullptr);
   observer_->OnTargetTransferRate(*update);
 }
 
 RtpPacketPacer* RtpTransportControllerSend::pacer() {
+  if (shared_pacer_sender_) {
+    return shared_pacer_sender_.get();
+  }
   if (use_task_queue_pacer_) {
     return task_queue_pacer_.get();
   }
@@ -194,6 +217,9 @@ RtpPacketPacer* RtpTransportControllerSend::pacer() {
 }
 
 const RtpPacketPacer* RtpTransportControllerSend::pacer() const {
+  if (shared_pacer_sender_) {
+    return shared_pacer_sender_.get();
+  }
   if (use_task_queue_pacer_) {
     return task_queue_pacer_.get();
   }
@@ -219,6 +245,9 @@ RtpTransportControllerSend::transport_feedback_observer() {
 }
 
 RtpPacketSender* RtpTransportControllerSend::packet_sender() {
+  if (shared_pacer_sender_) {
+    return shared_pacer_sender_.get();
+  }
   if (use_task_queue_pacer_) {
     return task_queue_pacer_.get();
   }
@@ -305,11 +334,28 @@ void RtpTransportControllerSend::OnNetworkRouteChanged(
     if (relay_constraint_update.has_value()) {
       UpdateBitrateConstraints(*relay_constraint_update);
     }
-    task_queue_.PostTask([this, network_route] {
+    NetworkRouteChange msg;
+    msg.at_time = Timestamp::Millis(clock_->TimeInMilliseconds());
+    msg.constraints =
+        ConvertConstraints(bitrate_configurator_.GetConfig(), clock_);
+    task_queue_.PostTask([this, msg, network_route]() mutable {
       RTC_DCHECK_RUN_ON(&task_queue_);
       transport_overhead_bytes_per_packet_ = network_route.packet_overhead;
+      // No need to reset BWE if this is the first time the network connects,
+      // unless there is a cached estimate to start from.
+      if (!estimate_cache_ || estimate_route_)
+        return;
+      estimate_route_ = network_route;
+      if (!ApplyCachedEstimate(network_route, &msg.constraints))
+        return;
+      if (controller_) {
+        PostUpdates(controller_->OnNetworkRouteChange(msg));
+      } else {
+        UpdateInitialConstraints(msg.constraints);
+        if (observer_)
+          observer_->OnStartRateUpdate(*msg.constraints.starting_rate);
+      }
     });
-    // No need to reset BWE if this is the first time the network connects.
     return;
   }
 
@@ -334,9 +380,14 @@ void RtpTransportControllerSend::OnNetworkRouteChanged(
     NetworkRouteChange msg;
     msg.at_time = Timestamp::Millis(clock_->TimeInMilliseconds());
     msg.constraints = ConvertConstraints(bitrate_config, clock_);
-    task_queue_.PostTask([this, msg, network_route] {
+    task_queue_.PostTask([this, msg, network_route]() mutable {
       RTC_DCHECK_RUN_ON(&task_queue_);
       transport_overhead_bytes_per_packet_ = network_route.packet_overhead;
+      if (estimate_cache_) {
+        MaybeStoreEstimate();
+        estimate_route_ = network_route;
+        ApplyCachedEstimate(network_route, &msg.constraints);
+      }
       if (reset_feedback_on_route_change_) {
         transport_feedback_adapter_.SetNetworkRoute(network_route);
       }
@@ -601,6 +652,30 @@ void RtpTransportControllerSend::UpdateInitialConstraints(
   initial_config_.constraints = new_contraints;
 }
 
+bool RtpTransportControllerSend::ApplyCachedEstimate(
+    const rtc::NetworkRoute& route,
+    TargetRateConstraints* constraints) {
+  absl::optional<DataRate> estimate = estimate_cache_->GetEstimate(route);
+  if (!estimate || estimate->IsZero() || !estimate->IsFinite())
+    return false;
+  DataRate starting_rate = *estimate;
+  if (constraints->max_data_rate)
+    starting_rate = std::min(starting_rate, *constraints->max_data_rate);
+  if (constraints->min_data_rate)
+    starting_rate = std::max(starting_rate, *constraints->min_data_rate);
+  RTC_LOG(LS_INFO) << "Starting from cached bandwidth estimate "
+                   << ToString(starting_rate) << " on "
+                   << route.DebugString();
+  constraints->starting_rate = starting_rate;
+  return true;
+}
+
+void RtpTransportControllerSend::MaybeStoreEstimate() {
+  if (estimate_route_ && last_target_rate_)
+    estimate_cache_->StoreEstimate(*estimate_route_, *last_target_rate_);
+  last_target_rate_.reset();
+}
+
 void RtpTransportControllerSend::StartProcessPeriodicTasks() {
   if (!pacer_queue_update_task_.Running()) {
     pacer_queue_update_task_ = RepeatingTaskHandle::DelayedStart(
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "api/network_state_predictor.h"
+#include "api/transport/bandwidth_estimate_cache.h"
 #include "api/transport/network_control.h"
 #include "api/units/data_rate.h"
 #include "call/rtp_bitrate_configurator.h"
@@ -29,6 +30,7 @@
 #include "modules/pacing/paced_sender.h"
 #include "modules/pacing/packet_router.h"
 #include "modules/pacing/rtp_packet_pacer.h"
+#include "modules/pacing/shared_pacer.h"
 #include "modules/pacing/task_queue_paced_sender.h"
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/constructor_magic.h"
@@ -59,7 +61,9 @@ class RtpTransportControllerSend final
       const BitrateConstraints& bitrate_config,
       std::unique_ptr<ProcessThread> process_thread,
       TaskQueueFactory* task_queue_factory,
-      const WebRtcKeyValueConfig* trials);
+      SharedPacer* shared_pacer,
+      const WebRtcKeyValueConfig* trials,
+      BandwidthEstimateCache* estimate_cache = nullptr);
   ~RtpTransportControllerSend() override;
 
   RtpVideoSenderInterface* CreateRtpVideoSender(
@@ -142,6 +146,13 @@ class RtpTransportControllerSend final
       RTC_RUN_ON(task_queue_);
   void PostUpdates(NetworkControlUpdate update) RTC_RUN_ON(task_queue_);
   void UpdateControlState() RTC_RUN_ON(task_queue_);
+  // Sets the starting rate of |constraints| to the cached estimate for
+  // |route|, if there is one. Returns true if it did.
+  bool ApplyCachedEstimate(const rtc::NetworkRoute& route,
+                           TargetRateConstraints* constraints)
+      RTC_RUN_ON(task_queue_);
+  // Stores the last estimate on |estimate_route_| in |estimate_cache_|.
+  void MaybeStoreEstimate() RTC_RUN_ON(task_queue_);
   RtpPacketPacer* pacer();
   const RtpPacketPacer* pacer() const;
 
@@ -155,6 +166,7 @@ class RtpTransportControllerSend final
   const bool use_task_queue_pacer_;
   std::unique_ptr<PacedSender> process_thread_pacer_;
   std::unique_ptr<TaskQueuePacedSender> task_queue_pacer_;
+  std::unique_ptr<SharedPacedSender> shared_pacer_sender_;
 
   TargetTransferRateObserver* observer_ RTC_GUARDED_BY(task_queue_);
   TransportFeedbackDemuxer feedback_demuxer_;
@@ -182,6 +194,12 @@ class RtpTransportControllerSend final
   NetworkControllerConfig initial_config_ RTC_GUARDED_BY(task_queue_);
   StreamsConfig streams_config_ RTC_GUARDED_BY(task_queue_);
 
+  BandwidthEstimateCache* const estimate_cache_;
+  // The route that the current estimate is for, and the last target rate.
+  absl::optional<rtc::NetworkRoute> estimate_route_
+      RTC_GUARDED_BY(task_queue_);
+  absl::optional<DataRate> last_target_rate_ RTC_GUARDED_BY(task_queue_);
+
   const bool reset_feedback_on_route_change_;
   const bool send_side_bwe_with_overhead_;
   const bool add_pacing_to_cwin_;
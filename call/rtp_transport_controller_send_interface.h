@@ -52,6 +52,7 @@ class RtcpBandwidthObserver;
 class RtpPacketSender;
 class SendDelayStats;
 class SendStatisticsProxy;
+class VideoBitrateAllocationObserver;
 
 struct RtpSenderObservers {
   RtcpRttStats* rtcp_rtt_stats;
@@ -65,6 +66,7 @@ struct RtpSenderObservers {
   RtcpPacketTypeCounterObserver* rtcp_type_observer;
   SendSideDelayObserver* send_delay_observer;
   SendPacketObserver* send_packet_observer;
+  VideoBitrateAllocationObserver* requested_bitrate_allocation_observer;
 };
 
 struct RtpSenderFrameEncryptionConfig {
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_transport_controller_send.h"
+
+#include <memory>
+#include <vector>
+
+#include "api/rtc_event_log/rtc_event_log.h"
+#include "api/transport/bandwidth_estimate_cache.h"
+#include "api/transport/field_trial_based_config.h"
+#include "test/gtest.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace webrtc {
+namespace {
+
+class FakeBandwidthEstimateCache : public BandwidthEstimateCache {
+ public:
+  absl::optional<DataRate> GetEstimate(
+      const rtc::NetworkRoute& route) override {
+    return estimate;
+  }
+  void StoreEstimate(const rtc::NetworkRoute& route,
+                     DataRate estimate) override {
+    stored_estimates.push_back(estimate);
+  }
+
+  absl::optional<DataRate> estimate;
+  std::vector<DataRate> stored_estimates;
+};
+
+class RateObserver : public TargetTransferRateObserver {
+ public:
+  void OnTargetTransferRate(TargetTransferRate msg) override {
+    target_rate = msg.target_rate;
+  }
+  void OnStartRateUpdate(DataRate start_rate) override {
+    this->start_rate = start_rate;
+  }
+
+  absl::optional<DataRate> target_rate;
+  absl::optional<DataRate> start_rate;
+};
+
+class RtpTransportControllerSendTest : public ::testing::Test {
+ protected:
+  RtpTransportControllerSendTest()
+      : time_controller_(Timestamp::Millis(1000000)) {
+    bitrate_config_.min_bitrate_bps = 30000;
+    bitrate_config_.start_bitrate_bps = 300000;
+    bitrate_config_.max_bitrate_bps = 5000000;
+  }
+
+  std::unique_ptr<RtpTransportControllerSend> CreateController() {
+    return std::make_unique<RtpTransportControllerSend>(
+        time_controller_.GetClock(), &event_log_, nullptr, nullptr,
+        bitrate_config_, time_controller_.CreateProcessThread("PacerThread"),
+        time_controller_.GetTaskQueueFactory(), /*shared_pacer=*/nullptr,
+        &field_trials_, &cache_);
+  }
+
+  void Connect(RtpTransportControllerSend* controller) {
+    controller->RegisterTargetTransferRateObserver(&observer_);
+    rtc::NetworkRoute route;
+    route.connected = true;
+    controller->OnNetworkRouteChanged("transport", route);
+    controller->OnNetworkAvailability(true);
+    time_controller_.AdvanceTime(TimeDelta::Millis(100));
+  }
+
+  GlobalSimulatedTimeController time_controller_;
+  RtcEventLogNull event_log_;
+  FieldTrialBasedConfig field_trials_;
+  BitrateConstraints bitrate_config_;
+  FakeBandwidthEstimateCache cache_;
+  RateObserver observer_;
+};
+
+TEST_F(RtpTransportControllerSendTest, StartsFromCachedEstimate) {
+  cache_.estimate = DataRate::KilobitsPerSec(2000);
+  std::unique_ptr<RtpTransportControllerSend> controller = CreateController();
+  Connect(controller.get());
+
+  EXPECT_EQ(observer_.start_rate, DataRate::KilobitsPerSec(2000));
+  ASSERT_TRUE(observer_.target_rate);
+  EXPECT_GT(*observer_.target_rate, DataRate::KilobitsPerSec(1000));
+
+  // The estimate is stored when the call ends.
+  controller.reset();
+  ASSERT_EQ(cache_.stored_estimates.size(), 1u);
+  EXPECT_EQ(cache_.stored_estimates[0], *observer_.target_rate);
+}
+
+TEST_F(RtpTransportControllerSendTest, ClampsCachedEstimateToMaxBitrate) {
+  cache_.estimate = DataRate::KilobitsPerSec(20000);
+  std::unique_ptr<RtpTransportControllerSend> controller = CreateController();
+  Connect(controller.get());
+  EXPECT_EQ(observer_.start_rate, DataRate::KilobitsPerSec(5000));
+}
+
+TEST_F(RtpTransportControllerSendTest,
+       StartsFromConfiguredRateWithoutCachedEstimate) {
+  std::unique_ptr<RtpTransportControllerSend> controller = CreateController();
+  Connect(controller.get());
+
+  EXPECT_EQ(observer_.start_rate, DataRate::KilobitsPerSec(300));
+  ASSERT_TRUE(observer_.target_rate);
+  EXPECT_LT(*observer_.target_rate, DataRate::KilobitsPerSec(1000));
+  controller.reset();
+  EXPECT_EQ(cache_.stored_estimates.size(), 1u);
+}
+
+}  // namespace
+}  // namespace webrtc
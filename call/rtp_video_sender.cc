@@ -44,12 +44,18 @@ RtpStreamSender::RtpStreamSender(
       sender_video(std::move(sender_video)),
       fec_generator(std::move(fec_generator)) {}
 
-RtpStreamSender::~RtpStreamSender() = default;
+RtpStreamSender::~RtpStreamSender() {
+  // |sender_video| may still be generating FEC with |fec_generator|.
+  sender_video.reset();
+}
 
 }  // namespace webrtc_internal_rtp_video_sender
 
 namespace {
 static const int kMinSendSidePacketHistorySize = 600;
+// Packets of the latest key frame and the frames following it to keep, when
+// key frames are cached.
+static const size_t kKeyFrameCacheSize = 1000;
 // We don't do MTU discovery, so assume that we have the standard ethernet MTU.
 static const size_t kPathMTU = 1500;
 
@@ -240,6 +246,10 @@ std::vector<RtpStreamSender> CreateRtpStreamSenders(
   for (size_t i = 0; i < rtp_config.ssrcs.size(); ++i) {
     RTPSenderVideo::Config video_config;
     configuration.local_media_ssrc = rtp_config.ssrcs[i];
+    // The receiver's requested allocation covers all the layers and reaches
+    // every module, so only the first module reports it.
+    configuration.requested_bitrate_allocation_observer =
+        i == 0 ? observers.requested_bitrate_allocation_observer : nullptr;
 
     std::unique_ptr<VideoFecGenerator> fec_generator =
         MaybeCreateFecGenerator(clock, rtp_config, suspended_ssrcs, i, trials);
@@ -283,6 +293,9 @@ std::vector<RtpStreamSender> CreateRtpStreamSenders(
     }
     video_config.frame_transformer = frame_transformer;
     video_config.send_transport_queue = transport->GetWorkerQueue()->Get();
+    if (rtp_config.cache_key_frames) {
+      video_config.key_frame_cache_size = kKeyFrameCacheSize;
+    }
     auto sender_video = std::make_unique<RTPSenderVideo>(video_config);
     rtp_streams.emplace_back(std::move(rtp_rtcp), std::move(sender_video),
                              std::move(fec_generator));
@@ -838,6 +851,15 @@ std::vector<RtpSequenceNumberMap::Info> RtpVideoSender::GetSentRtpPacketInfos(
   return std::vector<RtpSequenceNumberMap::Info>();
 }
 
+bool RtpVideoSender::SendCachedKeyFrame(uint32_t ssrc) {
+  for (const auto& rtp_stream : rtp_streams_) {
+    if (ssrc == rtp_stream.rtp_rtcp->SSRC()) {
+      return rtp_stream.sender_video->RequestCachedKeyFrame();
+    }
+  }
+  return false;
+}
+
 int RtpVideoSender::ProtectionRequest(const FecProtectionParams* delta_params,
                                       const FecProtectionParams* key_params,
                                       uint32_t* sent_video_rate_bps,
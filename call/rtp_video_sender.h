@@ -154,6 +154,7 @@ class RtpVideoSender : public RtpVideoSenderInterface,
       uint32_t ssrc,
       rtc::ArrayView<const uint16_t> sequence_numbers) const
       RTC_LOCKS_EXCLUDED(crit_) override;
+  bool SendCachedKeyFrame(uint32_t ssrc) RTC_LOCKS_EXCLUDED(crit_) override;
 
   // From StreamFeedbackObserver.
   void OnPacketFeedbackVector(
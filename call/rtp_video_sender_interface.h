@@ -62,6 +62,9 @@ class RtpVideoSenderInterface : public EncodedImageCallback,
   virtual std::vector<RtpSequenceNumberMap::Info> GetSentRtpPacketInfos(
       uint32_t ssrc,
       rtc::ArrayView<const uint16_t> sequence_numbers) const = 0;
+  // Resends the cached key frame of |ssrc|, if RtpConfig::cache_key_frames is
+  // set. Returns false if a new key frame has to be encoded instead.
+  virtual bool SendCachedKeyFrame(uint32_t ssrc) = 0;
 
   // Implements FecControllerOverride.
   void SetFecAllowed(bool fec_allowed) override = 0;
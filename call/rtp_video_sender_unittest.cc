@@ -82,6 +82,7 @@ RtpSenderObservers CreateObservers(
   observers.rtcp_type_observer = rtcp_type_observer;
   observers.send_delay_observer = send_delay_observer;
   observers.send_packet_observer = send_packet_observer;
+  observers.requested_bitrate_allocation_observer = nullptr;
   return observers;
 }
 
@@ -135,6 +136,7 @@ class RtpVideoSenderTestFixture {
             bitrate_config_,
             time_controller_.CreateProcessThread("PacerThread"),
             time_controller_.GetTaskQueueFactory(),
+            /*shared_pacer=*/nullptr,
             &field_trials_),
         process_thread_(time_controller_.CreateProcessThread("test_thread")),
         call_stats_(time_controller_.GetClock(), process_thread_.get()),
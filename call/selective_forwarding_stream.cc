@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/selective_forwarding_stream.h"
+
+#include "rtc_base/strings/string_builder.h"
+
+namespace webrtc {
+
+std::string SelectiveForwardingStream::Stats::ToString() const {
+  char buf[256];
+  rtc::SimpleStringBuilder ss(buf);
+  ss << "{forwarded_packets: " << forwarded_packets;
+  ss << ", dropped_packets: " << dropped_packets << "}";
+  return ss.str();
+}
+
+SelectiveForwardingStream::Config::Config() = default;
+SelectiveForwardingStream::Config::Config(const Config&) = default;
+SelectiveForwardingStream::Config::~Config() = default;
+
+std::string SelectiveForwardingStream::Config::ToString() const {
+  char buf[1024];
+  rtc::SimpleStringBuilder ss(buf);
+  ss << "{remote_ssrc: " << remote_ssrc;
+  ss << ", output_ssrc: " << output_ssrc;
+  ss << ", transport_cc: " << (transport_cc ? "on" : "off");
+  ss << ", rtp_header_extensions: [";
+  size_t i = 0;
+  for (; i + 1 < rtp_header_extensions.size(); ++i)
+    ss << rtp_header_extensions[i].ToString() << ", ";
+  if (!rtp_header_extensions.empty())
+    ss << rtp_header_extensions[i].ToString();
+  ss << "]}";
+  return ss.str();
+}
+
+}  // namespace webrtc
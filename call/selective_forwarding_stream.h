@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_SELECTIVE_FORWARDING_STREAM_H_
+#define CALL_SELECTIVE_FORWARDING_STREAM_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "api/rtp_parameters.h"
+
+namespace webrtc {
+
+// Forwards the RTP packets of a received video stream to the send side of the
+// call without assembling or decoding frames, as a selective forwarding unit
+// does. Spatial and temporal layers are selected with the dependency
+// descriptor header extension, and the forwarded packets get a new SSRC and
+// gapless sequence numbers.
+class SelectiveForwardingStream {
+ public:
+  struct Stats {
+    std::string ToString() const;
+
+    uint64_t forwarded_packets = 0;
+    // Packets of layers above the target layers, padding, and packets that
+    // arrived before the first frame dependency structure.
+    uint64_t dropped_packets = 0;
+  };
+
+  struct Config {
+    Config();
+    Config(const Config&);
+    ~Config();
+
+    std::string ToString() const;
+
+    // SSRC of the video stream to be received.
+    uint32_t remote_ssrc = 0;
+
+    // SSRC of the forwarded stream. The RTP module sending this SSRC, e.g. the
+    // one of a VideoSendStream, must be registered with the packet router of
+    // the call, or the pacer drops the forwarded packets.
+    uint32_t output_ssrc = 0;
+
+    // |transport_cc| is true whenever the send-side BWE RTCP feedback message
+    // has been negotiated. This is a prerequisite for enabling send-side BWE.
+    bool transport_cc = false;
+
+    // RTP header extensions that have been negotiated for the received stream.
+    // Forwarded packets keep the received extension ids, so they have to match
+    // the ones negotiated for the send side.
+    std::vector<RtpExtension> rtp_header_extensions;
+  };
+
+  // Limits the forwarded layers to spatial layers up to |spatial_id| and
+  // temporal layers up to |temporal_id|. It takes effect at the start of the
+  // next frame. Before switching up, the caller should make sure that the
+  // next frame is a key frame or a switch point, e.g. by requesting a key
+  // frame. By default all layers are forwarded.
+  virtual void SetTargetLayers(int spatial_id, int temporal_id) = 0;
+
+  virtual Stats GetStats() const = 0;
+
+  virtual const Config& GetConfig() const = 0;
+
+ protected:
+  virtual ~SelectiveForwardingStream() = default;
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_SELECTIVE_FORWARDING_STREAM_H_
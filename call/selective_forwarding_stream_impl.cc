@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/selective_forwarding_stream_impl.h"
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "call/rtp_stream_receiver_controller_interface.h"
+#include "modules/rtp_rtcp/include/rtp_packet_sender.h"
+#include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+SelectiveForwardingStreamImpl::SelectiveForwardingStreamImpl(
+    RtpStreamReceiverControllerInterface* receiver_controller,
+    RtpPacketSender* packet_sender,
+    const Config& config)
+    : config_(config),
+      extensions_(config.rtp_header_extensions),
+      packet_sender_(packet_sender),
+      target_spatial_id_(std::numeric_limits<int>::max()),
+      target_temporal_id_(std::numeric_limits<int>::max()),
+      frame_spatial_id_(target_spatial_id_),
+      frame_temporal_id_(target_temporal_id_) {
+  RTC_LOG(LS_INFO) << "SelectiveForwardingStreamImpl: " << config_.ToString();
+  RTC_DCHECK(packet_sender_);
+  // Register last, so that packets are not delivered to a partially
+  // constructed object.
+  rtp_stream_receiver_ =
+      receiver_controller->CreateReceiver(config_.remote_ssrc, this);
+}
+
+SelectiveForwardingStreamImpl::~SelectiveForwardingStreamImpl() {
+  RTC_LOG(LS_INFO) << "~SelectiveForwardingStreamImpl: "
+                   << config_.ToString();
+}
+
+void SelectiveForwardingStreamImpl::SetTargetLayers(int spatial_id,
+                                                     int temporal_id) {
+  RTC_DCHECK_GE(spatial_id, 0);
+  RTC_DCHECK_GE(temporal_id, 0);
+  rtc::CritScope lock(&crit_);
+  target_spatial_id_ = spatial_id;
+  target_temporal_id_ = temporal_id;
+}
+
+SelectiveForwardingStream::Stats SelectiveForwardingStreamImpl::GetStats()
+    const {
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+const SelectiveForwardingStream::Config&
+SelectiveForwardingStreamImpl::GetConfig() const {
+  return config_;
+}
+
+void SelectiveForwardingStreamImpl::OnRtpPacket(
+    const RtpPacketReceived& packet) {
+  auto forwarded_packet = std::make_unique<RtpPacketToSend>(&extensions_);
+  {
+    rtc::CritScope lock(&crit_);
+    // Unwrap all packets, so that the forwarded sequence numbers are the
+    // received ones less the packets dropped so far.
+    const int64_t sequence_number =
+        sequence_number_unwrapper_.Unwrap(packet.SequenceNumber());
+    bool end_of_picture = packet.Marker();
+    if (!ShouldForward(packet, &end_of_picture)) {
+      ++stats_.dropped_packets;
+      return;
+    }
+    ++stats_.forwarded_packets;
+
+    // The payload is shared with |packet| until the header is rewritten.
+    forwarded_packet->Parse(packet.Buffer());
+    forwarded_packet->SetSsrc(config_.output_ssrc);
+    forwarded_packet->SetSequenceNumber(
+        static_cast<uint16_t>(sequence_number - stats_.dropped_packets));
+    forwarded_packet->SetMarker(end_of_picture);
+  }
+  forwarded_packet->set_packet_type(RtpPacketMediaType::kVideo);
+  forwarded_packet->set_capture_time_ms(packet.arrival_time_ms());
+
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  packets.push_back(std::move(forwarded_packet));
+  packet_sender_->EnqueuePackets(std::move(packets));
+}
+
+bool SelectiveForwardingStreamImpl::ShouldForward(
+    const RtpPacketReceived& packet,
+    bool* end_of_picture) {
+  // Padding is only used for probing the link of the sender.
+  if (packet.payload_size() == 0) {
+    return false;
+  }
+  if (!packet.HasExtension<RtpDependencyDescriptorExtension>()) {
+    // Without layer information the whole stream is forwarded.
+    return true;
+  }
+
+  DependencyDescriptor descriptor;
+  if (!packet.GetExtension<RtpDependencyDescriptorExtension>(structure_.get(),
+                                                             &descriptor)) {
+    // The structure this packet refers to hasn't arrived yet, or the packet
+    // is older than the current structure.
+    return false;
+  }
+  if (descriptor.attached_structure) {
+    structure_ = std::move(descriptor.attached_structure);
+  }
+  if (descriptor.first_packet_in_frame) {
+    frame_spatial_id_ = target_spatial_id_;
+    frame_temporal_id_ = target_temporal_id_;
+  }
+
+  const int spatial_id = descriptor.frame_dependencies.spatial_id;
+  if (spatial_id > frame_spatial_id_ ||
+      descriptor.frame_dependencies.temporal_id > frame_temporal_id_) {
+    return false;
+  }
+  // The marker bit is on the top spatial layer, which may be dropped.
+  if (descriptor.last_packet_in_frame && spatial_id == frame_spatial_id_) {
+    *end_of_picture = true;
+  }
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_SELECTIVE_FORWARDING_STREAM_IMPL_H_
+#define CALL_SELECTIVE_FORWARDING_STREAM_IMPL_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "api/transport/rtp/dependency_descriptor.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "call/selective_forwarding_stream.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/numerics/sequence_number_util.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class RtpPacketReceived;
+class RtpPacketSender;
+class RtpStreamReceiverControllerInterface;
+class RtpStreamReceiverInterface;
+
+class SelectiveForwardingStreamImpl : public SelectiveForwardingStream,
+                                      public RtpPacketSinkInterface {
+ public:
+  // Forwarded packets are enqueued to |packet_sender|, normally the pacer of
+  // the send transport controller.
+  SelectiveForwardingStreamImpl(
+      RtpStreamReceiverControllerInterface* receiver_controller,
+      RtpPacketSender* packet_sender,
+      const Config& config);
+  ~SelectiveForwardingStreamImpl() override;
+
+  // SelectiveForwardingStream.
+  void SetTargetLayers(int spatial_id, int temporal_id) override;
+  Stats GetStats() const override;
+  const Config& GetConfig() const override;
+
+  // RtpPacketSinkInterface.
+  void OnRtpPacket(const RtpPacketReceived& packet) override;
+
+ private:
+  // Returns true if |packet| belongs to a forwarded layer, and sets
+  // |end_of_picture| if it is the last forwarded packet of the picture.
+  bool ShouldForward(const RtpPacketReceived& packet, bool* end_of_picture)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const Config config_;
+  const RtpHeaderExtensionMap extensions_;
+  RtpPacketSender* const packet_sender_;
+
+  rtc::CriticalSection crit_;
+  int target_spatial_id_ RTC_GUARDED_BY(crit_);
+  int target_temporal_id_ RTC_GUARDED_BY(crit_);
+  // The target layers of the frame being forwarded.
+  int frame_spatial_id_ RTC_GUARDED_BY(crit_);
+  int frame_temporal_id_ RTC_GUARDED_BY(crit_);
+  std::unique_ptr<FrameDependencyStructure> structure_ RTC_GUARDED_BY(crit_);
+  SeqNumUnwrapper<uint16_t> sequence_number_unwrapper_ RTC_GUARDED_BY(crit_);
+  Stats stats_ RTC_GUARDED_BY(crit_);
+
+  std::unique_ptr<RtpStreamReceiverInterface> rtp_stream_receiver_;
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_SELECTIVE_FORWARDING_STREAM_IMPL_H_
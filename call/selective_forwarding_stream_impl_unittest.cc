@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/selective_forwarding_stream_impl.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/transport/rtp/dependency_descriptor.h"
+#include "call/rtp_stream_receiver_controller.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/include/rtp_packet_sender.h"
+#include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+
+constexpr uint32_t kRemoteSsrc = 1111;
+constexpr uint32_t kOutputSsrc = 2222;
+constexpr int kDependencyDescriptorId = 7;
+
+class MockRtpPacketSender : public RtpPacketSender {
+ public:
+  MOCK_METHOD(void,
+              EnqueuePackets,
+              (std::vector<std::unique_ptr<RtpPacketToSend>>),
+              (override));
+};
+
+// Two spatial layers with a single temporal layer each.
+FrameDependencyStructure CreateL2T1Structure() {
+  FrameDependencyStructure structure;
+  structure.num_decode_targets = 2;
+  FrameDependencyTemplate base_layer;
+  base_layer.spatial_id = 0;
+  base_layer.decode_target_indications = {DecodeTargetIndication::kSwitch,
+                                          DecodeTargetIndication::kSwitch};
+  FrameDependencyTemplate enhancement_layer;
+  enhancement_layer.spatial_id = 1;
+  enhancement_layer.decode_target_indications = {
+      DecodeTargetIndication::kNotPresent, DecodeTargetIndication::kSwitch};
+  enhancement_layer.frame_diffs = {1};
+  structure.templates = {base_layer, enhancement_layer};
+  return structure;
+}
+
+class SelectiveForwardingStreamTest : public ::testing::Test {
+ protected:
+  SelectiveForwardingStreamTest() {
+    config_.remote_ssrc = kRemoteSsrc;
+    config_.output_ssrc = kOutputSsrc;
+    config_.rtp_header_extensions.emplace_back(
+        RtpDependencyDescriptorExtension::kUri, kDependencyDescriptorId);
+    extensions_.Register<RtpDependencyDescriptorExtension>(
+        kDependencyDescriptorId);
+    forwarding_stream_ = std::make_unique<SelectiveForwardingStreamImpl>(
+        &receiver_controller_, &packet_sender_, config_);
+    ON_CALL(packet_sender_, EnqueuePackets)
+        .WillByDefault(Invoke(
+            [this](std::vector<std::unique_ptr<RtpPacketToSend>> packets) {
+              for (auto& packet : packets)
+                sent_packets_.push_back(std::move(packet));
+            }));
+  }
+
+  void ReceivePacket(const DependencyDescriptor* descriptor, bool marker) {
+    RtpPacketReceived packet(&extensions_);
+    packet.SetSsrc(kRemoteSsrc);
+    packet.SetSequenceNumber(sequence_number_++);
+    packet.SetMarker(marker);
+    if (descriptor) {
+      ASSERT_TRUE(packet.SetExtension<RtpDependencyDescriptorExtension>(
+          structure_, *descriptor));
+    }
+    uint8_t* payload = packet.SetPayloadSize(10);
+    ASSERT_TRUE(payload);
+    payload[0] = 0x42;
+    EXPECT_TRUE(receiver_controller_.OnRtpPacket(packet));
+  }
+
+  // Receives a picture with one packet per spatial layer.
+  void ReceivePicture(int frame_number, bool key_frame) {
+    for (int spatial_id = 0; spatial_id < 2; ++spatial_id) {
+      DependencyDescriptor descriptor;
+      descriptor.frame_number = frame_number * 2 + spatial_id;
+      descriptor.frame_dependencies = structure_.templates[spatial_id];
+      if (key_frame && spatial_id == 0) {
+        descriptor.attached_structure =
+            std::make_unique<FrameDependencyStructure>(structure_);
+      }
+      ReceivePacket(&descriptor, /*marker=*/spatial_id == 1);
+    }
+  }
+
+  const FrameDependencyStructure structure_ = CreateL2T1Structure();
+  SelectiveForwardingStream::Config config_;
+  RtpHeaderExtensionMap extensions_;
+  RtpStreamReceiverController receiver_controller_;
+  ::testing::NiceMock<MockRtpPacketSender> packet_sender_;
+  std::unique_ptr<SelectiveForwardingStreamImpl> forwarding_stream_;
+  std::vector<std::unique_ptr<RtpPacketToSend>> sent_packets_;
+  uint16_t sequence_number_ = 0xfffe;
+};
+
+TEST_F(SelectiveForwardingStreamTest, ForwardsPacketsWithOutputSsrc) {
+  ReceivePacket(/*descriptor=*/nullptr, /*marker=*/true);
+
+  ASSERT_EQ(sent_packets_.size(), 1u);
+  EXPECT_EQ(sent_packets_[0]->Ssrc(), kOutputSsrc);
+  EXPECT_EQ(sent_packets_[0]->SequenceNumber(), 0xfffe);
+  EXPECT_TRUE(sent_packets_[0]->Marker());
+  EXPECT_EQ(sent_packets_[0]->payload_size(), 10u);
+  EXPECT_EQ(sent_packets_[0]->payload()[0], 0x42);
+  EXPECT_EQ(forwarding_stream_->GetStats().forwarded_packets, 1u);
+}
+
+TEST_F(SelectiveForwardingStreamTest, ForwardsAllLayersByDefault) {
+  ReceivePicture(/*frame_number=*/0, /*key_frame=*/true);
+  ReceivePicture(/*frame_number=*/1, /*key_frame=*/false);
+
+  ASSERT_EQ(sent_packets_.size(), 4u);
+  EXPECT_FALSE(sent_packets_[0]->Marker());
+  EXPECT_TRUE(sent_packets_[1]->Marker());
+  EXPECT_EQ(forwarding_stream_->GetStats().dropped_packets, 0u);
+}
+
+TEST_F(SelectiveForwardingStreamTest, DropsLayersAboveTarget) {
+  forwarding_stream_->SetTargetLayers(/*spatial_id=*/0, /*temporal_id=*/0);
+  ReceivePicture(/*frame_number=*/0, /*key_frame=*/true);
+  ReceivePicture(/*frame_number=*/1, /*key_frame=*/false);
+
+  // Only the base layer is forwarded, with gapless sequence numbers and the
+  // marker bit moved to the base layer.
+  ASSERT_EQ(sent_packets_.size(), 2u);
+  EXPECT_EQ(sent_packets_[0]->SequenceNumber(), 0xfffe);
+  EXPECT_EQ(sent_packets_[1]->SequenceNumber(), 0xffff);
+  EXPECT_TRUE(sent_packets_[0]->Marker());
+  EXPECT_TRUE(sent_packets_[1]->Marker());
+  EXPECT_EQ(forwarding_stream_->GetStats().dropped_packets, 2u);
+}
+
+TEST_F(SelectiveForwardingStreamTest, DropsPacketsBeforeStructure) {
+  ReceivePicture(/*frame_number=*/0, /*key_frame=*/false);
+  EXPECT_TRUE(sent_packets_.empty());
+
+  ReceivePicture(/*frame_number=*/1, /*key_frame=*/true);
+  ASSERT_EQ(sent_packets_.size(), 2u);
+  EXPECT_EQ(sent_packets_[0]->SequenceNumber(), 0xfffe);
+  EXPECT_EQ(forwarding_stream_->GetStats().dropped_packets, 2u);
+}
+
+}  // namespace
+}  // namespace webrtc
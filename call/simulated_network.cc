@@ -109,22 +109,25 @@ void SimulatedNetwork::SetConfig(const Config& config) {
     config_state_.prob_start_bursting =
         prob_loss / (1 - prob_loss) / avg_burst_loss_length;
   }
+  config_changed_.store(true, std::memory_order_release);
 }
 
 void SimulatedNetwork::UpdateConfig(
     std::function<void(BuiltInNetworkBehaviorConfig*)> config_modifier) {
   rtc::CritScope crit(&config_lock_);
   config_modifier(&config_state_.config);
+  config_changed_.store(true, std::memory_order_release);
 }
 
 void SimulatedNetwork::PauseTransmissionUntil(int64_t until_us) {
   rtc::CritScope crit(&config_lock_);
   config_state_.pause_transmission_until_us = until_us;
+  config_changed_.store(true, std::memory_order_release);
 }
 
 bool SimulatedNetwork::EnqueuePacket(PacketInFlightInfo packet) {
   RTC_DCHECK_RUNS_SERIALIZED(&process_checker_);
-  ConfigState state = GetConfigState();
+  const ConfigState& state = GetConfigState();
 
   UpdateCapacityQueue(state, packet.send_time_us);
 
@@ -152,9 +155,10 @@ absl::optional<int64_t> SimulatedNetwork::NextDeliveryTimeUs() const {
   return next_process_time_us_;
 }
 
-void SimulatedNetwork::UpdateCapacityQueue(ConfigState state,
+void SimulatedNetwork::UpdateCapacityQueue(const ConfigState& state,
                                            int64_t time_now_us) {
   bool needs_sort = false;
+  const size_t first_new = delay_link_.size();
 
   // Catch for thread races.
   if (time_now_us < last_capacity_link_visit_us_.value_or(time_now_us))
@@ -252,16 +256,32 @@ void SimulatedNetwork::UpdateCapacityQueue(ConfigState state,
 
   if (needs_sort) {
     // Packet(s) arrived out of order, make sure list is sorted.
-    std::sort(delay_link_.begin(), delay_link_.end(),
-              [](const PacketInfo& p1, const PacketInfo& p2) {
-                return p1.arrival_time_us < p2.arrival_time_us;
-              });
+    SortDelayLink(first_new);
   }
 }
 
-SimulatedNetwork::ConfigState SimulatedNetwork::GetConfigState() const {
-  rtc::CritScope crit(&config_lock_);
-  return config_state_;
+void SimulatedNetwork::SortDelayLink(size_t first_new) {
+  auto earlier = [](const PacketInfo& p1, const PacketInfo& p2) {
+    return p1.arrival_time_us < p2.arrival_time_us;
+  };
+  auto middle = delay_link_.begin() + first_new;
+  // The packets that were queued before are usually still sorted. Then only
+  // the new ones are sorted and merged in, in linear time for a link that
+  // holds many packets.
+  if (!std::is_sorted(delay_link_.begin(), middle, earlier)) {
+    std::sort(delay_link_.begin(), delay_link_.end(), earlier);
+    return;
+  }
+  std::sort(middle, delay_link_.end(), earlier);
+  std::inplace_merge(delay_link_.begin(), middle, delay_link_.end(), earlier);
+}
+
+const SimulatedNetwork::ConfigState& SimulatedNetwork::GetConfigState() {
+  if (config_changed_.exchange(false, std::memory_order_acquire)) {
+    rtc::CritScope crit(&config_lock_);
+    process_config_state_ = config_state_;
+  }
+  return process_config_state_;
 }
 
 std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <deque>
 #include <queue>
 #include <vector>
@@ -92,9 +93,15 @@ class SimulatedNetwork : public SimulatedNetworkInterface {
   };
 
   // Moves packets from capacity- to delay link.
-  void UpdateCapacityQueue(ConfigState state, int64_t time_now_us)
+  void UpdateCapacityQueue(const ConfigState& state, int64_t time_now_us)
       RTC_RUN_ON(&process_checker_);
-  ConfigState GetConfigState() const;
+  // Returns the current configuration, which is only copied from
+  // |config_state_| after it changed, so that processing packets doesn't
+  // take |config_lock_|.
+  const ConfigState& GetConfigState() RTC_RUN_ON(&process_checker_);
+  // Sorts the packets appended to |delay_link_| at and after |first_new| by
+  // arrival time, and merges them into the preceding packets.
+  void SortDelayLink(size_t first_new) RTC_RUN_ON(&process_checker_);
 
   rtc::CriticalSection config_lock_;
 
@@ -108,6 +115,9 @@ class SimulatedNetwork : public SimulatedNetworkInterface {
   std::deque<PacketInfo> delay_link_ RTC_GUARDED_BY(process_checker_);
 
   ConfigState config_state_ RTC_GUARDED_BY(config_lock_);
+  // Set when |config_state_| changes.
+  std::atomic<bool> config_changed_{true};
+  ConfigState process_config_state_ RTC_GUARDED_BY(process_checker_);
 
   // Are we currently dropping a burst of packets?
   bool bursting_;
@@ -57,8 +57,11 @@ std::string VideoReceiveStream::Stats::ToString(int64_t time_ms) const {
   ss << "max_decode_ms: " << max_decode_ms << ", ";
   ss << "first_frame_received_to_decoded_ms: "
      << first_frame_received_to_decoded_ms << ", ";
+  ss << "start_to_first_frame_decoded_ms: " << start_to_first_frame_decoded_ms
+     << ", ";
   ss << "cur_delay_ms: " << current_delay_ms << ", ";
   ss << "targ_delay_ms: " << target_delay_ms << ", ";
+  ss << "e2e_delay_ms: " << e2e_delay_ms << ", ";
   ss << "jb_delay_ms: " << jitter_buffer_ms << ", ";
   ss << "jb_cumulative_delay_seconds: " << jitter_buffer_delay_seconds << ", ";
   ss << "jb_emitted_count: " << jitter_buffer_emitted_count << ", ";
@@ -94,6 +97,8 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", rtp: " << rtp.ToString();
   ss << ", renderer: " << (renderer ? "(renderer)" : "nullptr");
   ss << ", render_delay_ms: " << render_delay_ms;
+  if (!decode_frames)
+    ss << ", decode_frames: false";
   if (!sync_group.empty())
     ss << ", sync_group: " << sync_group;
   ss << ", target_delay_ms: " << target_delay_ms;
@@ -119,6 +119,12 @@ class VideoReceiveStream {
     // https://w3c.github.io/webrtc-stats/#dom-rtcinboundrtpstreamstats-totalsqauredinterframedelay
     double total_squared_inter_frame_delay = 0;
     int64_t first_frame_received_to_decoded_ms = -1;
+    // Time from Start() until the first frame was decoded, or -1 until then.
+    int64_t start_to_first_frame_decoded_ms = -1;
+    // Delay from capture to render of the last rendered frame, or -1 while
+    // the capture time of the frames is unknown. With |target_delay_ms|, the
+    // part of it spent in the receiver, this shows the glass-to-glass budget.
+    int64_t e2e_delay_ms = -1;
     absl::optional<uint64_t> qp_sum;
 
     int current_payload_type = -1;
@@ -232,9 +238,16 @@ class VideoReceiveStream {
     // Transport for outgoing packets (RTCP).
     Transport* rtcp_send_transport = nullptr;
 
-    // Must always be set.
+    // Must be set unless |decode_frames| is false.
     rtc::VideoSinkInterface<VideoFrame>* renderer = nullptr;
 
+    // If false, the received frames are assembled and ordered as usual and
+    // passed to the encoded frame callback set with SetAndGetRecordingState,
+    // but never decoded. No decoders are created, so the decoders'
+    // |decoder_factory| and |renderer| may be null. Used for recording
+    // streams, e.g. with EncodedFrameRecorder.
+    bool decode_frames = true;
+
     // Expected delay needed by the renderer, i.e. the frame will be delivered
     // this many milliseconds, if possible, earlier than the ideal render time.
     int render_delay_ms = 10;
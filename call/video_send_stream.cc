@@ -69,6 +69,7 @@ std::string VideoSendStream::Stats::ToString(int64_t time_ms) const {
   ss << "encode_fps: " << encode_frame_rate << ", ";
   ss << "encode_ms: " << avg_encode_time_ms << ", ";
   ss << "encode_usage_perc: " << encode_usage_percent << ", ";
+  ss << "encoder_queue_delay_us: " << avg_encoder_queue_delay_us << ", ";
   ss << "target_bps: " << target_media_bitrate_bps << ", ";
   ss << "media_bps: " << media_bitrate_bps << ", ";
   ss << "suspended: " << (suspended ? "true" : "false") << ", ";
@@ -22,6 +22,8 @@
 #include "api/crypto/crypto_options.h"
 #include "api/frame_transformer_interface.h"
 #include "api/rtp_parameters.h"
+#include "api/units/data_rate.h"
+#include "api/video/recordable_encoded_frame.h"
 #include "api/video/video_content_type.h"
 #include "api/video/video_frame.h"
 #include "api/video/video_sink_interface.h"
@@ -100,6 +102,9 @@ class VideoSendStream {
     int encode_frame_rate = 0;
     int avg_encode_time_ms = 0;
     int encode_usage_percent = 0;
+    // Smoothed time incoming frames wait for the encoder queue, which grows
+    // when a shared encoder thread pool is too small.
+    int avg_encoder_queue_delay_us = 0;
     uint32_t frames_encoded = 0;
     // https://w3c.github.io/webrtc-stats/#dom-rtcoutboundrtpstreamstats-totalencodetime
     uint64_t total_encode_time_ms = 0;
@@ -198,6 +203,21 @@ class VideoSendStream {
     Config(const Config&);
   };
 
+  // The source of the frames of a stream that sends frames which are already
+  // encoded, such as relayed or recorded media. It gets the feedback that
+  // would otherwise go to the encoder. Called on an arbitrary thread.
+  class EncodedFrameSource {
+   public:
+    // Called with the bitrate that the frames should be sent at, which is zero
+    // while the stream is paused.
+    virtual void OnTargetBitrateChanged(DataRate target_bitrate) = 0;
+    // Called when the next frame should be a key frame.
+    virtual void OnKeyFrameRequested() = 0;
+
+   protected:
+    virtual ~EncodedFrameSource() = default;
+  };
+
   // Updates the sending state for all simulcast layers that the video send
   // stream owns. This can mean updating the activity one or for multiple
   // layers. The ordering of active layers is the order in which the
@@ -219,6 +239,18 @@ class VideoSendStream {
       rtc::VideoSourceInterface<webrtc::VideoFrame>* source,
       const DegradationPreference& degradation_preference) = 0;
 
+  // Makes the stream send the frames passed to SendEncodedFrame instead of
+  // encoding the frames of the source set with SetSource, which should be
+  // unset meanwhile, and routes the rate and key frame feedback to |source|.
+  // Null returns to encoding. |source| must outlive its use here.
+  virtual void SetEncodedFrameSource(EncodedFrameSource* source) = 0;
+
+  // Sends |frame| without encoding it, while an encoded frame source is set.
+  // The frame is packetized, protected and paced like an encoded frame, on
+  // the first SSRC, so it must be of the configured codec and have a single
+  // spatial and temporal layer. May be called on any thread.
+  virtual void SendEncodedFrame(const RecordableEncodedFrame& frame) = 0;
+
   // Set which streams to send. Must have at least as many SSRCs as configured
   // in the config. Encoder settings are passed on to the encoder instance along
   // with the VideoStream settings.
@@ -10,28 +10,151 @@
 
 #include "common_audio/include/audio_util.h"
 
+#include "common_audio/audio_util_simd.h"
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
 namespace webrtc {
 
-void FloatToS16(const float* src, size_t size, int16_t* dest) {
+namespace {
+
+void FloatToS16_C(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToS16(src[i]);
 }
 
-void S16ToFloat(const int16_t* src, size_t size, float* dest) {
+void S16ToFloat_C(const int16_t* src, size_t size, float* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = S16ToFloat(src[i]);
 }
 
-void S16ToFloatS16(const int16_t* src, size_t size, float* dest) {
+void S16ToFloatS16_C(const int16_t* src, size_t size, float* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = src[i];
 }
 
-void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
+void FloatS16ToS16_C(const float* src, size_t size, int16_t* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatS16ToS16(src[i]);
 }
 
+template <typename T>
+void DeinterleaveStereo_C(const T* interleaved,
+                          size_t samples_per_channel,
+                          T* left,
+                          T* right) {
+  T* const deinterleaved[] = {left, right};
+  DeinterleaveImpl(interleaved, samples_per_channel, 2, deinterleaved);
+}
+
+template <typename T>
+void InterleaveStereo_C(const T* left,
+                        const T* right,
+                        size_t samples_per_channel,
+                        T* interleaved) {
+  const T* const deinterleaved[] = {left, right};
+  InterleaveImpl(deinterleaved, samples_per_channel, 2, interleaved);
+}
+
+void DownmixInterleavedStereoToMono_C(const int16_t* interleaved,
+                                      size_t num_frames,
+                                      int16_t* mono) {
+  DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved, num_frames, 2,
+                                                 mono);
+}
+
+// The implementations used on this CPU, picked once on first use.
+struct AudioUtilFunctions {
+  decltype(&FloatToS16_C) float_to_s16 = FloatToS16_C;
+  decltype(&S16ToFloat_C) s16_to_float = S16ToFloat_C;
+  decltype(&S16ToFloatS16_C) s16_to_float_s16 = S16ToFloatS16_C;
+  decltype(&FloatS16ToS16_C) float_s16_to_s16 = FloatS16ToS16_C;
+  void (*deinterleave_stereo_s16)(const int16_t*, size_t, int16_t*, int16_t*) =
+      DeinterleaveStereo_C<int16_t>;
+  void (*deinterleave_stereo_float)(const float*, size_t, float*, float*) =
+      DeinterleaveStereo_C<float>;
+  void (*interleave_stereo_s16)(const int16_t*,
+                                const int16_t*,
+                                size_t,
+                                int16_t*) = InterleaveStereo_C<int16_t>;
+  void (*interleave_stereo_float)(const float*,
+                                  const float*,
+                                  size_t,
+                                  float*) = InterleaveStereo_C<float>;
+  void (*downmix_to_mono_float)(const float* const*, size_t, int, float*) =
+      DownmixToMonoImpl<float, float>;
+  decltype(&DownmixInterleavedStereoToMono_C)
+      downmix_interleaved_stereo_to_mono_s16 = DownmixInterleavedStereoToMono_C;
+};
+
+AudioUtilFunctions SelectFunctions() {
+  AudioUtilFunctions functions;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if !defined(__SSE2__)
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return functions;
+#endif
+  functions.float_to_s16 = FloatToS16_SSE2;
+  functions.s16_to_float = S16ToFloat_SSE2;
+  functions.s16_to_float_s16 = S16ToFloatS16_SSE2;
+  functions.float_s16_to_s16 = FloatS16ToS16_SSE2;
+  functions.deinterleave_stereo_s16 = DeinterleaveStereo_SSE2;
+  functions.deinterleave_stereo_float = DeinterleaveStereo_SSE2;
+  functions.interleave_stereo_s16 = InterleaveStereo_SSE2;
+  functions.interleave_stereo_float = InterleaveStereo_SSE2;
+  functions.downmix_to_mono_float = DownmixToMono_SSE2;
+  functions.downmix_interleaved_stereo_to_mono_s16 =
+      DownmixInterleavedStereoToMono_SSE2;
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    functions.float_to_s16 = FloatToS16_AVX2;
+    functions.s16_to_float = S16ToFloat_AVX2;
+    functions.s16_to_float_s16 = S16ToFloatS16_AVX2;
+    functions.float_s16_to_s16 = FloatS16ToS16_AVX2;
+    functions.downmix_to_mono_float = DownmixToMono_AVX2;
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  functions.float_to_s16 = FloatToS16_NEON;
+  functions.s16_to_float = S16ToFloat_NEON;
+  functions.s16_to_float_s16 = S16ToFloatS16_NEON;
+  functions.float_s16_to_s16 = FloatS16ToS16_NEON;
+  functions.deinterleave_stereo_s16 = DeinterleaveStereo_NEON;
+  functions.deinterleave_stereo_float = DeinterleaveStereo_NEON;
+  functions.interleave_stereo_s16 = InterleaveStereo_NEON;
+  functions.interleave_stereo_float = InterleaveStereo_NEON;
+  functions.downmix_to_mono_float = DownmixToMono_NEON;
+  functions.downmix_interleaved_stereo_to_mono_s16 =
+      DownmixInterleavedStereoToMono_NEON;
+#endif
+  return functions;
+}
+
+const AudioUtilFunctions& Functions() {
+  static const AudioUtilFunctions functions = SelectFunctions();
+  return functions;
+}
+
+}  // namespace
+
+void FloatToS16(const float* src, size_t size, int16_t* dest) {
+  Functions().float_to_s16(src, size, dest);
+}
+
+void S16ToFloat(const int16_t* src, size_t size, float* dest) {
+  Functions().s16_to_float(src, size, dest);
+}
+
+void S16ToFloatS16(const int16_t* src, size_t size, float* dest) {
+  Functions().s16_to_float_s16(src, size, dest);
+}
+
+void FloatS16ToS16(const float* src, size_t size, int16_t* dest) {
+  Functions().float_s16_to_s16(src, size, dest);
+}
+
 void FloatToFloatS16(const float* src, size_t size, float* dest) {
   for (size_t i = 0; i < size; ++i)
     dest[i] = FloatToFloatS16(src[i]);
@@ -42,11 +165,81 @@ void FloatS16ToFloat(const float* src, size_t size, float* dest) {
     dest[i] = FloatS16ToFloat(src[i]);
 }
 
+template <>
+void Deinterleave<int16_t>(const int16_t* interleaved,
+                           size_t samples_per_channel,
+                           size_t num_channels,
+                           int16_t* const* deinterleaved) {
+  if (num_channels == 2) {
+    Functions().deinterleave_stereo_s16(interleaved, samples_per_channel,
+                                        deinterleaved[0], deinterleaved[1]);
+    return;
+  }
+  DeinterleaveImpl(interleaved, samples_per_channel, num_channels,
+                   deinterleaved);
+}
+
+template <>
+void Deinterleave<float>(const float* interleaved,
+                         size_t samples_per_channel,
+                         size_t num_channels,
+                         float* const* deinterleaved) {
+  if (num_channels == 2) {
+    Functions().deinterleave_stereo_float(interleaved, samples_per_channel,
+                                          deinterleaved[0], deinterleaved[1]);
+    return;
+  }
+  DeinterleaveImpl(interleaved, samples_per_channel, num_channels,
+                   deinterleaved);
+}
+
+template <>
+void Interleave<int16_t>(const int16_t* const* deinterleaved,
+                         size_t samples_per_channel,
+                         size_t num_channels,
+                         int16_t* interleaved) {
+  if (num_channels == 2) {
+    Functions().interleave_stereo_s16(deinterleaved[0], deinterleaved[1],
+                                      samples_per_channel, interleaved);
+    return;
+  }
+  InterleaveImpl(deinterleaved, samples_per_channel, num_channels,
+                 interleaved);
+}
+
+template <>
+void Interleave<float>(const float* const* deinterleaved,
+                       size_t samples_per_channel,
+                       size_t num_channels,
+                       float* interleaved) {
+  if (num_channels == 2) {
+    Functions().interleave_stereo_float(deinterleaved[0], deinterleaved[1],
+                                        samples_per_channel, interleaved);
+    return;
+  }
+  InterleaveImpl(deinterleaved, samples_per_channel, num_channels,
+                 interleaved);
+}
+
+template <>
+void DownmixToMono<float, float>(const float* const* input_channels,
+                                 size_t num_frames,
+                                 int num_channels,
+                                 float* out) {
+  Functions().downmix_to_mono_float(input_channels, num_frames, num_channels,
+                                    out);
+}
+
 template <>
 void DownmixInterleavedToMono<int16_t>(const int16_t* interleaved,
                                        size_t num_frames,
                                        int num_channels,
                                        int16_t* deinterleaved) {
+  if (num_channels == 2) {
+    Functions().downmix_interleaved_stereo_to_mono_s16(interleaved, num_frames,
+                                                       deinterleaved);
+    return;
+  }
   DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved, num_frames,
                                                  num_channels, deinterleaved);
 }
@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "common_audio/audio_util_simd.h"
+
+namespace webrtc {
+
+namespace {
+
+// Rounds |v|, already scaled to the int16_t range, half away from zero and
+// converts it with saturation, like the scalar FloatS16ToS16().
+inline __m256i RoundToS32(__m256 v) {
+  const __m256 kSignMask = _mm256_set1_ps(-0.f);
+  const __m256 kHalf = _mm256_set1_ps(0.5f);
+  v = _mm256_min_ps(v, _mm256_set1_ps(32767.f));
+  v = _mm256_max_ps(v, _mm256_set1_ps(-32768.f));
+  v = _mm256_add_ps(v, _mm256_or_ps(_mm256_and_ps(v, kSignMask), kHalf));
+  return _mm256_cvttps_epi32(v);
+}
+
+inline void StoreFloatS16(__m256 lo, __m256 hi, int16_t* dest) {
+  // _mm256_packs_epi32 packs within 128-bit lanes, so the 64-bit blocks come
+  // out as lo[0:3], hi[0:3], lo[4:7], hi[4:7] and need to be reordered.
+  const __m256i packed = _mm256_packs_epi32(RoundToS32(lo), RoundToS32(hi));
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),
+                      _mm256_permute4x64_epi64(packed, 0xD8));
+}
+
+// Loads sixteen samples from |src| and converts them to floats.
+inline void LoadS16(const int16_t* src, __m256* lo, __m256* hi) {
+  const __m128i v_lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const __m128i v_hi =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+  *lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v_lo));
+  *hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v_hi));
+}
+
+// Runs |convert_block| on each |kBlockSize| samples of |src|. The remainder is
+// converted through a zero-padded block, so the results are the same as for
+// full blocks.
+template <size_t kBlockSize, typename In, typename Out, typename F>
+void ConvertBlocks(const In* src, size_t size, Out* dest, F convert_block) {
+  size_t i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize)
+    convert_block(src + i, dest + i);
+  if (i < size) {
+    In padded_src[kBlockSize] = {};
+    Out padded_dest[kBlockSize];
+    std::copy(src + i, src + size, padded_src);
+    convert_block(padded_src, padded_dest);
+    std::copy(padded_dest, padded_dest + (size - i), dest + i);
+  }
+}
+
+}  // namespace
+
+void FloatToS16_AVX2(const float* src, size_t size, int16_t* dest) {
+  ConvertBlocks<16>(src, size, dest, [](const float* src, int16_t* dest) {
+    const __m256 kScaling = _mm256_set1_ps(32768.f);
+    StoreFloatS16(_mm256_mul_ps(_mm256_loadu_ps(src), kScaling),
+                  _mm256_mul_ps(_mm256_loadu_ps(src + 8), kScaling), dest);
+  });
+}
+
+void FloatS16ToS16_AVX2(const float* src, size_t size, int16_t* dest) {
+  ConvertBlocks<16>(src, size, dest, [](const float* src, int16_t* dest) {
+    StoreFloatS16(_mm256_loadu_ps(src), _mm256_loadu_ps(src + 8), dest);
+  });
+}
+
+void S16ToFloat_AVX2(const int16_t* src, size_t size, float* dest) {
+  ConvertBlocks<16>(src, size, dest, [](const int16_t* src, float* dest) {
+    const __m256 kScaling = _mm256_set1_ps(1.f / 32768.f);
+    __m256 lo, hi;
+    LoadS16(src, &lo, &hi);
+    _mm256_storeu_ps(dest, _mm256_mul_ps(lo, kScaling));
+    _mm256_storeu_ps(dest + 8, _mm256_mul_ps(hi, kScaling));
+  });
+}
+
+void S16ToFloatS16_AVX2(const int16_t* src, size_t size, float* dest) {
+  ConvertBlocks<16>(src, size, dest, [](const int16_t* src, float* dest) {
+    __m256 lo, hi;
+    LoadS16(src, &lo, &hi);
+    _mm256_storeu_ps(dest, lo);
+    _mm256_storeu_ps(dest + 8, hi);
+  });
+}
+
+void DownmixToMono_AVX2(const float* const* input_channels,
+                        size_t num_frames,
+                        int num_channels,
+                        float* out) {
+  // Same summation order and division as the scalar version.
+  const __m256 divisor = _mm256_set1_ps(static_cast<float>(num_channels));
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    __m256 sum = _mm256_loadu_ps(input_channels[0] + i);
+    for (int j = 1; j < num_channels; ++j)
+      sum = _mm256_add_ps(sum, _mm256_loadu_ps(input_channels[j] + i));
+    _mm256_storeu_ps(out + i, _mm256_div_ps(sum, divisor));
+  }
+  for (; i < num_frames; ++i) {
+    float value = input_channels[0][i];
+    for (int j = 1; j < num_channels; ++j)
+      value += input_channels[j][i];
+    out[i] = value / num_channels;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <arm_neon.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "common_audio/audio_util_simd.h"
+
+namespace webrtc {
+
+namespace {
+
+// Rounds |v|, already scaled to the int16_t range, half away from zero and
+// converts it with saturation, like the scalar FloatS16ToS16().
+inline int16x4_t RoundToS16(float32x4_t v) {
+  v = vminq_f32(v, vdupq_n_f32(32767.f));
+  v = vmaxq_f32(v, vdupq_n_f32(-32768.f));
+  const uint32x4_t sign =
+      vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000u));
+  const float32x4_t half = vreinterpretq_f32_u32(
+      vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+  return vqmovn_s32(vcvtq_s32_f32(vaddq_f32(v, half)));
+}
+
+// Runs |convert_block| on each |kBlockSize| samples of |src|. The remainder is
+// converted through a zero-padded block, so the results are the same as for
+// full blocks.
+template <size_t kBlockSize, typename In, typename Out, typename F>
+void ConvertBlocks(const In* src, size_t size, Out* dest, F convert_block) {
+  size_t i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize)
+    convert_block(src + i, dest + i);
+  if (i < size) {
+    In padded_src[kBlockSize] = {};
+    Out padded_dest[kBlockSize];
+    std::copy(src + i, src + size, padded_src);
+    convert_block(padded_src, padded_dest);
+    std::copy(padded_dest, padded_dest + (size - i), dest + i);
+  }
+}
+
+}  // namespace
+
+void FloatToS16_NEON(const float* src, size_t size, int16_t* dest) {
+  ConvertBlocks<4>(src, size, dest, [](const float* src, int16_t* dest) {
+    vst1_s16(dest, RoundToS16(vmulq_f32(vld1q_f32(src), vdupq_n_f32(32768.f))));
+  });
+}
+
+void FloatS16ToS16_NEON(const float* src, size_t size, int16_t* dest) {
+  ConvertBlocks<4>(src, size, dest, [](const float* src, int16_t* dest) {
+    vst1_s16(dest, RoundToS16(vld1q_f32(src)));
+  });
+}
+
+void S16ToFloat_NEON(const int16_t* src, size_t size, float* dest) {
+  ConvertBlocks<4>(src, size, dest, [](const int16_t* src, float* dest) {
+    const float32x4_t v = vcvtq_f32_s32(vmovl_s16(vld1_s16(src)));
+    vst1q_f32(dest, vmulq_f32(v, vdupq_n_f32(1.f / 32768.f)));
+  });
+}
+
+void S16ToFloatS16_NEON(const int16_t* src, size_t size, float* dest) {
+  ConvertBlocks<4>(src, size, dest, [](const int16_t* src, float* dest) {
+    vst1q_f32(dest, vcvtq_f32_s32(vmovl_s16(vld1_s16(src))));
+  });
+}
+
+void DeinterleaveStereo_NEON(const int16_t* interleaved,
+                             size_t samples_per_channel,
+                             int16_t* left,
+                             int16_t* right) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const int16x8x2_t v = vld2q_s16(interleaved + 2 * i);
+    vst1q_s16(left + i, v.val[0]);
+    vst1q_s16(right + i, v.val[1]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void DeinterleaveStereo_NEON(const float* interleaved,
+                             size_t samples_per_channel,
+                             float* left,
+                             float* right) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const float32x4x2_t v = vld2q_f32(interleaved + 2 * i);
+    vst1q_f32(left + i, v.val[0]);
+    vst1q_f32(right + i, v.val[1]);
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void InterleaveStereo_NEON(const int16_t* left,
+                           const int16_t* right,
+                           size_t samples_per_channel,
+                           int16_t* interleaved) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    int16x8x2_t v;
+    v.val[0] = vld1q_s16(left + i);
+    v.val[1] = vld1q_s16(right + i);
+    vst2q_s16(interleaved + 2 * i, v);
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void InterleaveStereo_NEON(const float* left,
+                           const float* right,
+                           size_t samples_per_channel,
+                           float* interleaved) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    float32x4x2_t v;
+    v.val[0] = vld1q_f32(left + i);
+    v.val[1] = vld1q_f32(right + i);
+    vst2q_f32(interleaved + 2 * i, v);
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void DownmixToMono_NEON(const float* const* input_channels,
+                        size_t num_frames,
+                        int num_channels,
+                        float* out) {
+  // ARMv7 NEON has no vector division, so only the sums are vectorized; the
+  // division stays scalar to match the rounding of the scalar version.
+  size_t i = 0;
+  float sums[4];
+  for (; i + 4 <= num_frames; i += 4) {
+    float32x4_t sum = vld1q_f32(input_channels[0] + i);
+    for (int j = 1; j < num_channels; ++j)
+      sum = vaddq_f32(sum, vld1q_f32(input_channels[j] + i));
+    vst1q_f32(sums, sum);
+    for (int k = 0; k < 4; ++k)
+      out[i + k] = sums[k] / num_channels;
+  }
+  for (; i < num_frames; ++i) {
+    float value = input_channels[0][i];
+    for (int j = 1; j < num_channels; ++j)
+      value += input_channels[j][i];
+    out[i] = value / num_channels;
+  }
+}
+
+void DownmixInterleavedStereoToMono_NEON(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  size_t i = 0;
+  for (; i + 4 <= num_frames; i += 4) {
+    const int16x4x2_t v = vld2_s16(interleaved + 2 * i);
+    int32x4_t sum = vaddl_s16(v.val[0], v.val[1]);
+    // Division by two truncates towards zero, like the scalar version.
+    sum = vshrq_n_s32(
+        vaddq_s32(sum, vreinterpretq_s32_u32(vshrq_n_u32(
+                           vreinterpretq_u32_s32(sum), 31))),
+        1);
+    vst1_s16(mono + i, vmovn_s32(sum));
+  }
+  for (; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) /
+              2;
+  }
+}
+
+}  // namespace webrtc
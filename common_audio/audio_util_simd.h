@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_AUDIO_UTIL_SIMD_H_
+#define COMMON_AUDIO_AUDIO_UTIL_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/system/arch.h"
+
+namespace webrtc {
+
+// SIMD versions of the conversion, interleaving and downmixing functions in
+// common_audio/include/audio_util.h. They produce bit-exact results with the
+// scalar versions. audio_util.cc picks the best set available on the CPU at
+// runtime, so these are only called directly by tests and benchmarks.
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void FloatToS16_SSE2(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_SSE2(const int16_t* src, size_t size, float* dest);
+void S16ToFloatS16_SSE2(const int16_t* src, size_t size, float* dest);
+void FloatS16ToS16_SSE2(const float* src, size_t size, int16_t* dest);
+void DeinterleaveStereo_SSE2(const int16_t* interleaved,
+                             size_t samples_per_channel,
+                             int16_t* left,
+                             int16_t* right);
+void DeinterleaveStereo_SSE2(const float* interleaved,
+                             size_t samples_per_channel,
+                             float* left,
+                             float* right);
+void InterleaveStereo_SSE2(const int16_t* left,
+                           const int16_t* right,
+                           size_t samples_per_channel,
+                           int16_t* interleaved);
+void InterleaveStereo_SSE2(const float* left,
+                           const float* right,
+                           size_t samples_per_channel,
+                           float* interleaved);
+void DownmixToMono_SSE2(const float* const* input_channels,
+                        size_t num_frames,
+                        int num_channels,
+                        float* out);
+void DownmixInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+
+void FloatToS16_AVX2(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_AVX2(const int16_t* src, size_t size, float* dest);
+void S16ToFloatS16_AVX2(const int16_t* src, size_t size, float* dest);
+void FloatS16ToS16_AVX2(const float* src, size_t size, int16_t* dest);
+void DownmixToMono_AVX2(const float* const* input_channels,
+                        size_t num_frames,
+                        int num_channels,
+                        float* out);
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void FloatToS16_NEON(const float* src, size_t size, int16_t* dest);
+void S16ToFloat_NEON(const int16_t* src, size_t size, float* dest);
+void S16ToFloatS16_NEON(const int16_t* src, size_t size, float* dest);
+void FloatS16ToS16_NEON(const float* src, size_t size, int16_t* dest);
+void DeinterleaveStereo_NEON(const int16_t* interleaved,
+                             size_t samples_per_channel,
+                             int16_t* left,
+                             int16_t* right);
+void DeinterleaveStereo_NEON(const float* interleaved,
+                             size_t samples_per_channel,
+                             float* left,
+                             float* right);
+void InterleaveStereo_NEON(const int16_t* left,
+                           const int16_t* right,
+                           size_t samples_per_channel,
+                           int16_t* interleaved);
+void InterleaveStereo_NEON(const float* left,
+                           const float* right,
+                           size_t samples_per_channel,
+                           float* interleaved);
+void DownmixToMono_NEON(const float* const* input_channels,
+                        size_t num_frames,
+                        int num_channels,
+                        float* out);
+void DownmixInterleavedStereoToMono_NEON(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono);
+#endif
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_AUDIO_UTIL_SIMD_H_
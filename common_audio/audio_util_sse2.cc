@@ -0,0 +1,229 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "common_audio/audio_util_simd.h"
+
+namespace webrtc {
+
+namespace {
+
+// Rounds |v|, already scaled to the int16_t range, half away from zero and
+// converts it with saturation, like the scalar FloatS16ToS16().
+inline __m128i RoundToS32(__m128 v) {
+  const __m128 kSignMask = _mm_set1_ps(-0.f);
+  const __m128 kHalf = _mm_set1_ps(0.5f);
+  v = _mm_min_ps(v, _mm_set1_ps(32767.f));
+  v = _mm_max_ps(v, _mm_set1_ps(-32768.f));
+  v = _mm_add_ps(v, _mm_or_ps(_mm_and_ps(v, kSignMask), kHalf));
+  return _mm_cvttps_epi32(v);
+}
+
+inline void StoreFloatS16(__m128 lo, __m128 hi, int16_t* dest) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_packs_epi32(RoundToS32(lo), RoundToS32(hi)));
+}
+
+// Loads eight samples from |src| and converts them to floats.
+inline void LoadS16(const int16_t* src, __m128* lo, __m128* hi) {
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  *lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+  *hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+}
+
+// Runs |convert_block| on each |kBlockSize| samples of |src|. The remainder is
+// converted through a zero-padded block, so the results are the same as for
+// full blocks.
+template <size_t kBlockSize, typename In, typename Out, typename F>
+void ConvertBlocks(const In* src, size_t size, Out* dest, F convert_block) {
+  size_t i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize)
+    convert_block(src + i, dest + i);
+  if (i < size) {
+    In padded_src[kBlockSize] = {};
+    Out padded_dest[kBlockSize];
+    std::copy(src + i, src + size, padded_src);
+    convert_block(padded_src, padded_dest);
+    std::copy(padded_dest, padded_dest + (size - i), dest + i);
+  }
+}
+
+}  // namespace
+
+void FloatToS16_SSE2(const float* src, size_t size, int16_t* dest) {
+  ConvertBlocks<8>(src, size, dest, [](const float* src, int16_t* dest) {
+    const __m128 kScaling = _mm_set1_ps(32768.f);
+    StoreFloatS16(_mm_mul_ps(_mm_loadu_ps(src), kScaling),
+                  _mm_mul_ps(_mm_loadu_ps(src + 4), kScaling), dest);
+  });
+}
+
+void FloatS16ToS16_SSE2(const float* src, size_t size, int16_t* dest) {
+  ConvertBlocks<8>(src, size, dest, [](const float* src, int16_t* dest) {
+    StoreFloatS16(_mm_loadu_ps(src), _mm_loadu_ps(src + 4), dest);
+  });
+}
+
+void S16ToFloat_SSE2(const int16_t* src, size_t size, float* dest) {
+  ConvertBlocks<8>(src, size, dest, [](const int16_t* src, float* dest) {
+    const __m128 kScaling = _mm_set1_ps(1.f / 32768.f);
+    __m128 lo, hi;
+    LoadS16(src, &lo, &hi);
+    _mm_storeu_ps(dest, _mm_mul_ps(lo, kScaling));
+    _mm_storeu_ps(dest + 4, _mm_mul_ps(hi, kScaling));
+  });
+}
+
+void S16ToFloatS16_SSE2(const int16_t* src, size_t size, float* dest) {
+  ConvertBlocks<8>(src, size, dest, [](const int16_t* src, float* dest) {
+    __m128 lo, hi;
+    LoadS16(src, &lo, &hi);
+    _mm_storeu_ps(dest, lo);
+    _mm_storeu_ps(dest + 4, hi);
+  });
+}
+
+void DeinterleaveStereo_SSE2(const int16_t* interleaved,
+                             size_t samples_per_channel,
+                             int16_t* left,
+                             int16_t* right) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(interleaved + 2 * i));
+    const __m128i b = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(interleaved + 2 * i + 8));
+    // Even samples sign-extended from the low halves of each 32-bit lane, odd
+    // samples from the high halves.
+    const __m128i left_v =
+        _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                        _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+    const __m128i right_v =
+        _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(left + i), left_v);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(right + i), right_v);
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void DeinterleaveStereo_SSE2(const float* interleaved,
+                             size_t samples_per_channel,
+                             float* left,
+                             float* right) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const __m128 a = _mm_loadu_ps(interleaved + 2 * i);
+    const __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+void InterleaveStereo_SSE2(const int16_t* left,
+                           const int16_t* right,
+                           size_t samples_per_channel,
+                           int16_t* interleaved) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const __m128i l =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(left + i));
+    const __m128i r =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(right + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(interleaved + 2 * i),
+                     _mm_unpacklo_epi16(l, r));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(interleaved + 2 * i + 8),
+                     _mm_unpackhi_epi16(l, r));
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void InterleaveStereo_SSE2(const float* left,
+                           const float* right,
+                           size_t samples_per_channel,
+                           float* interleaved) {
+  size_t i = 0;
+  for (; i + 4 <= samples_per_channel; i += 4) {
+    const __m128 l = _mm_loadu_ps(left + i);
+    const __m128 r = _mm_loadu_ps(right + i);
+    _mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(l, r));
+    _mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(l, r));
+  }
+  for (; i < samples_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+void DownmixToMono_SSE2(const float* const* input_channels,
+                        size_t num_frames,
+                        int num_channels,
+                        float* out) {
+  // Sum the channels in the same order as the scalar version, and divide
+  // rather than multiply by the reciprocal, to get the same rounding.
+  const __m128 divisor = _mm_set1_ps(static_cast<float>(num_channels));
+  size_t i = 0;
+  for (; i + 4 <= num_frames; i += 4) {
+    __m128 sum = _mm_loadu_ps(input_channels[0] + i);
+    for (int j = 1; j < num_channels; ++j)
+      sum = _mm_add_ps(sum, _mm_loadu_ps(input_channels[j] + i));
+    _mm_storeu_ps(out + i, _mm_div_ps(sum, divisor));
+  }
+  for (; i < num_frames; ++i) {
+    float value = input_channels[0][i];
+    for (int j = 1; j < num_channels; ++j)
+      value += input_channels[j][i];
+    out[i] = value / num_channels;
+  }
+}
+
+void DownmixInterleavedStereoToMono_SSE2(const int16_t* interleaved,
+                                         size_t num_frames,
+                                         int16_t* mono) {
+  size_t i = 0;
+  for (; i + 8 <= num_frames; i += 8) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(interleaved + 2 * i));
+    const __m128i b = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(interleaved + 2 * i + 8));
+    // Adding the sign-extended left and right halves of each lane gives the
+    // 32-bit sum of one frame. Division by two truncates towards zero, like
+    // the scalar version, so negative sums are rounded up before the shift.
+    __m128i sum_a = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                  _mm_srai_epi32(a, 16));
+    __m128i sum_b = _mm_add_epi32(_mm_srai_epi32(_mm_slli_epi32(b, 16), 16),
+                                  _mm_srai_epi32(b, 16));
+    sum_a = _mm_srai_epi32(_mm_add_epi32(sum_a, _mm_srli_epi32(sum_a, 31)), 1);
+    sum_b = _mm_srai_epi32(_mm_add_epi32(sum_b, _mm_srli_epi32(sum_b, 31)), 1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mono + i),
+                     _mm_packs_epi32(sum_a, sum_b));
+  }
+  for (; i < num_frames; ++i) {
+    mono[i] = (static_cast<int32_t>(interleaved[2 * i]) +
+               interleaved[2 * i + 1]) /
+              2;
+  }
+}
+
+}  // namespace webrtc
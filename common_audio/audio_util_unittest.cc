@@ -10,10 +10,22 @@
 
 #include "common_audio/include/audio_util.h"
 
+#include <stdio.h>
+
+#include <vector>
+
+#include "common_audio/audio_util_simd.h"
 #include "rtc_base/arraysize.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/time_utils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
 namespace webrtc {
 namespace {
 
@@ -246,5 +258,262 @@ TEST(AudioUtilTest, DownmixToMonoTest) {
   }
 }
 
+// The optimized versions of the conversion, interleaving and downmixing
+// functions on this CPU, as well as the scalar reference.
+struct Kernels {
+  const char* name;
+  void (*float_to_s16)(const float*, size_t, int16_t*);
+  void (*s16_to_float)(const int16_t*, size_t, float*);
+  void (*s16_to_float_s16)(const int16_t*, size_t, float*);
+  void (*float_s16_to_s16)(const float*, size_t, int16_t*);
+  void (*downmix_to_mono)(const float* const*, size_t, int, float*);
+};
+
+void FloatToS16Scalar(const float* src, size_t size, int16_t* dest) {
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = FloatToS16(src[i]);
+}
+
+void S16ToFloatScalar(const int16_t* src, size_t size, float* dest) {
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = S16ToFloat(src[i]);
+}
+
+void S16ToFloatS16Scalar(const int16_t* src, size_t size, float* dest) {
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = src[i];
+}
+
+void FloatS16ToS16Scalar(const float* src, size_t size, int16_t* dest) {
+  for (size_t i = 0; i < size; ++i)
+    dest[i] = FloatS16ToS16(src[i]);
+}
+
+std::vector<Kernels> AvailableSimdKernels() {
+  std::vector<Kernels> kernels;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    kernels.push_back({"SSE2", FloatToS16_SSE2, S16ToFloat_SSE2,
+                       S16ToFloatS16_SSE2, FloatS16ToS16_SSE2,
+                       DownmixToMono_SSE2});
+  }
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    kernels.push_back({"AVX2", FloatToS16_AVX2, S16ToFloat_AVX2,
+                       S16ToFloatS16_AVX2, FloatS16ToS16_AVX2,
+                       DownmixToMono_AVX2});
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  kernels.push_back({"NEON", FloatToS16_NEON, S16ToFloat_NEON,
+                     S16ToFloatS16_NEON, FloatS16ToS16_NEON,
+                     DownmixToMono_NEON});
+#endif
+  return kernels;
+}
+
+// Sizes that cover empty input, remainders shorter than a vector and whole
+// 10 ms frames.
+constexpr size_t kTestSizes[] = {0, 1, 7, 15, 17, 160, 479, 960};
+
+TEST(AudioUtilTest, SimdConversionsAreBitExact) {
+  Random random(42);
+  for (const Kernels& kernels : AvailableSimdKernels()) {
+    SCOPED_TRACE(kernels.name);
+    for (size_t size : kTestSizes) {
+      SCOPED_TRACE(size);
+      std::vector<float> float_input(size);
+      std::vector<float> float_s16_input(size);
+      std::vector<int16_t> s16_input(size);
+      for (size_t i = 0; i < size; ++i) {
+        // Include values outside the valid range to exercise the clamping,
+        // and exact halves to exercise the rounding.
+        float_input[i] = 1.2f * (2.f * random.Rand<float>() - 1.f);
+        float_s16_input[i] =
+            i % 4 == 0 ? static_cast<int>(40000.f * float_input[i]) + 0.5f
+                       : 40000.f * float_input[i];
+        s16_input[i] = random.Rand<int16_t>();
+      }
+
+      std::vector<int16_t> s16_ref(size), s16_out(size);
+      FloatToS16Scalar(float_input.data(), size, s16_ref.data());
+      kernels.float_to_s16(float_input.data(), size, s16_out.data());
+      EXPECT_EQ(s16_ref, s16_out);
+
+      FloatS16ToS16Scalar(float_s16_input.data(), size, s16_ref.data());
+      kernels.float_s16_to_s16(float_s16_input.data(), size, s16_out.data());
+      EXPECT_EQ(s16_ref, s16_out);
+
+      std::vector<float> float_ref(size), float_out(size);
+      S16ToFloatScalar(s16_input.data(), size, float_ref.data());
+      kernels.s16_to_float(s16_input.data(), size, float_out.data());
+      EXPECT_EQ(float_ref, float_out);
+
+      S16ToFloatS16Scalar(s16_input.data(), size, float_ref.data());
+      kernels.s16_to_float_s16(s16_input.data(), size, float_out.data());
+      EXPECT_EQ(float_ref, float_out);
+    }
+  }
+}
+
+TEST(AudioUtilTest, SimdDownmixToMonoIsBitExact) {
+  Random random(42);
+  for (const Kernels& kernels : AvailableSimdKernels()) {
+    SCOPED_TRACE(kernels.name);
+    for (int num_channels = 1; num_channels <= 8; ++num_channels) {
+      for (size_t size : kTestSizes) {
+        std::vector<std::vector<float>> channels(num_channels,
+                                                 std::vector<float>(size));
+        std::vector<const float*> channel_ptrs;
+        for (auto& channel : channels) {
+          for (float& sample : channel)
+            sample = 32768.f * (2.f * random.Rand<float>() - 1.f);
+          channel_ptrs.push_back(channel.data());
+        }
+        std::vector<float> ref(size), out(size);
+        DownmixToMonoImpl<float, float>(channel_ptrs.data(), size,
+                                        num_channels, ref.data());
+        kernels.downmix_to_mono(channel_ptrs.data(), size, num_channels,
+                                out.data());
+        EXPECT_EQ(ref, out);
+      }
+    }
+  }
+}
+
+TEST(AudioUtilTest, StereoInterleavingMatchesGenericVersion) {
+  Random random(42);
+  for (size_t size : kTestSizes) {
+    SCOPED_TRACE(size);
+    std::vector<int16_t> interleaved(2 * size);
+    for (int16_t& sample : interleaved)
+      sample = random.Rand<int16_t>();
+
+    std::vector<int16_t> left_ref(size), right_ref(size);
+    int16_t* deinterleaved_ref[] = {left_ref.data(), right_ref.data()};
+    DeinterleaveImpl(interleaved.data(), size, 2, deinterleaved_ref);
+    std::vector<int16_t> left(size), right(size);
+    int16_t* deinterleaved[] = {left.data(), right.data()};
+    Deinterleave(interleaved.data(), size, 2, deinterleaved);
+    EXPECT_EQ(left_ref, left);
+    EXPECT_EQ(right_ref, right);
+
+    std::vector<int16_t> reinterleaved(2 * size);
+    Interleave(deinterleaved, size, 2, reinterleaved.data());
+    EXPECT_EQ(interleaved, reinterleaved);
+
+    if (size > 0) {
+      std::vector<int16_t> mono_ref(size), mono(size);
+      DownmixInterleavedToMonoImpl<int16_t, int32_t>(interleaved.data(), size,
+                                                     2, mono_ref.data());
+      DownmixInterleavedToMono(interleaved.data(), size, 2, mono.data());
+      EXPECT_EQ(mono_ref, mono);
+    }
+
+    std::vector<float> float_interleaved(2 * size);
+    S16ToFloat(interleaved.data(), 2 * size, float_interleaved.data());
+    std::vector<float> float_left(size), float_right(size);
+    float* float_deinterleaved[] = {float_left.data(), float_right.data()};
+    Deinterleave(float_interleaved.data(), size, 2, float_deinterleaved);
+    std::vector<float> float_reinterleaved(2 * size);
+    Interleave(float_deinterleaved, size, 2, float_reinterleaved.data());
+    EXPECT_EQ(float_interleaved, float_reinterleaved);
+  }
+}
+
+// Benchmark for the per-frame conversions, comparing the scalar versions with
+// the ones picked at runtime. Make sure to build with RTC_DCHECKs compiled out
+// when benchmarking.
+TEST(AudioUtilTest, DISABLED_Benchmark) {
+  constexpr int kIterations = 100000;
+  constexpr int kSampleRatesHz[] = {16000, 48000};
+  constexpr size_t kNumChannels[] = {1, 2, 4, 8};
+  Random random(42);
+  for (int sample_rate_hz : kSampleRatesHz) {
+    for (size_t num_channels : kNumChannels) {
+      const size_t samples_per_channel = sample_rate_hz / 100;
+      const size_t size = samples_per_channel * num_channels;
+      std::vector<float> float_interleaved(size);
+      std::vector<int16_t> s16_interleaved(size);
+      for (size_t i = 0; i < size; ++i) {
+        float_interleaved[i] = 32768.f * (2.f * random.Rand<float>() - 1.f);
+        s16_interleaved[i] = random.Rand<int16_t>();
+      }
+      std::vector<std::vector<float>> channels(
+          num_channels, std::vector<float>(samples_per_channel));
+      std::vector<float*> channel_ptrs;
+      for (auto& channel : channels)
+        channel_ptrs.push_back(channel.data());
+      std::vector<float> mono(samples_per_channel);
+
+      auto measure = [](const char* name, int sample_rate_hz,
+                        size_t num_channels, auto scalar, auto optimized) {
+        int64_t start = rtc::TimeNanos();
+        for (int i = 0; i < kIterations; ++i)
+          scalar();
+        const int64_t scalar_ns = rtc::TimeNanos() - start;
+        start = rtc::TimeNanos();
+        for (int i = 0; i < kIterations; ++i)
+          optimized();
+        const int64_t optimized_ns = rtc::TimeNanos() - start;
+        printf("%-14s %5d Hz %zu ch: scalar %7.1f ns, optimized %7.1f ns\n",
+               name, sample_rate_hz, num_channels,
+               static_cast<double>(scalar_ns) / kIterations,
+               static_cast<double>(optimized_ns) / kIterations);
+      };
+
+      measure(
+          "FloatS16ToS16", sample_rate_hz, num_channels,
+          [&] {
+            FloatS16ToS16Scalar(float_interleaved.data(), size,
+                                s16_interleaved.data());
+          },
+          [&] {
+            FloatS16ToS16(float_interleaved.data(), size,
+                          s16_interleaved.data());
+          });
+      measure(
+          "S16ToFloat", sample_rate_hz, num_channels,
+          [&] {
+            S16ToFloatScalar(s16_interleaved.data(), size,
+                             float_interleaved.data());
+          },
+          [&] {
+            S16ToFloat(s16_interleaved.data(), size, float_interleaved.data());
+          });
+      measure(
+          "Deinterleave", sample_rate_hz, num_channels,
+          [&] {
+            DeinterleaveImpl(float_interleaved.data(), samples_per_channel,
+                             num_channels, channel_ptrs.data());
+          },
+          [&] {
+            Deinterleave(float_interleaved.data(), samples_per_channel,
+                         num_channels, channel_ptrs.data());
+          });
+      measure(
+          "Interleave", sample_rate_hz, num_channels,
+          [&] {
+            InterleaveImpl(channel_ptrs.data(), samples_per_channel,
+                           num_channels, float_interleaved.data());
+          },
+          [&] {
+            Interleave(channel_ptrs.data(), samples_per_channel, num_channels,
+                       float_interleaved.data());
+          });
+      measure(
+          "DownmixToMono", sample_rate_hz, num_channels,
+          [&] {
+            DownmixToMonoImpl<float, float>(channel_ptrs.data(),
+                                            samples_per_channel, num_channels,
+                                            mono.data());
+          },
+          [&] {
+            DownmixToMono<float, float>(channel_ptrs.data(),
+                                        samples_per_channel, num_channels,
+                                        mono.data());
+          });
+    }
+  }
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -106,20 +106,56 @@ void CopyAudioIfNeeded(const T* const* src,
   }
 }
 
+template <typename T>
+void DeinterleaveImpl(const T* interleaved,
+                      size_t samples_per_channel,
+                      size_t num_channels,
+                      T* const* deinterleaved) {
+  for (size_t i = 0; i < num_channels; ++i) {
+    T* channel = deinterleaved[i];
+    size_t interleaved_idx = i;
+    for (size_t j = 0; j < samples_per_channel; ++j) {
+      channel[j] = interleaved[interleaved_idx];
+      interleaved_idx += num_channels;
+    }
+  }
+}
+
 // Deinterleave audio from |interleaved| to the channel buffers pointed to
 // by |deinterleaved|. There must be sufficient space allocated in the
 // |deinterleaved| buffers (|num_channel| buffers with |samples_per_channel|
-// per buffer).
+// per buffer). The int16_t and float versions use SIMD for stereo.
 template <typename T>
 void Deinterleave(const T* interleaved,
                   size_t samples_per_channel,
                   size_t num_channels,
                   T* const* deinterleaved) {
+  DeinterleaveImpl(interleaved, samples_per_channel, num_channels,
+                   deinterleaved);
+}
+
+template <>
+void Deinterleave<int16_t>(const int16_t* interleaved,
+                           size_t samples_per_channel,
+                           size_t num_channels,
+                           int16_t* const* deinterleaved);
+
+template <>
+void Deinterleave<float>(const float* interleaved,
+                         size_t samples_per_channel,
+                         size_t num_channels,
+                         float* const* deinterleaved);
+
+template <typename T>
+void InterleaveImpl(const T* const* deinterleaved,
+                    size_t samples_per_channel,
+                    size_t num_channels,
+                    T* interleaved) {
   for (size_t i = 0; i < num_channels; ++i) {
-    T* channel = deinterleaved[i];
+    const T* channel = deinterleaved[i];
     size_t interleaved_idx = i;
     for (size_t j = 0; j < samples_per_channel; ++j) {
-      channel[j] = interleaved[interleaved_idx];
+      interleaved[interleaved_idx] = channel[j];
       interleaved_idx += num_channels;
     }
   }
@@ -127,22 +163,29 @@ void Deinterleave(const T* interleaved,
 
 // Interleave audio from the channel buffers pointed to by |deinterleaved| to
 // |interleaved|. There must be sufficient space allocated in |interleaved|
-// (|samples_per_channel| * |num_channels|).
+// (|samples_per_channel| * |num_channels|). The int16_t and float versions use
+// SIMD for stereo.
 template <typename T>
 void Interleave(const T* const* deinterleaved,
                 size_t samples_per_channel,
                 size_t num_channels,
                 T* interleaved) {
-  for (size_t i = 0; i < num_channels; ++i) {
-    const T* channel = deinterleaved[i];
-    size_t interleaved_idx = i;
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      interleaved[interleaved_idx] = channel[j];
-      interleaved_idx += num_channels;
-    }
-  }
+  InterleaveImpl(deinterleaved, samples_per_channel, num_channels,
+                 interleaved);
 }
 
+template <>
+void Interleave<int16_t>(const int16_t* const* deinterleaved,
+                         size_t samples_per_channel,
+                         size_t num_channels,
+                         int16_t* interleaved);
+
+template <>
+void Interleave<float>(const float* const* deinterleaved,
+                       size_t samples_per_channel,
+                       size_t num_channels,
+                       float* interleaved);
+
 // Copies audio from a single channel buffer pointed to by |mono| to each
 // channel of |interleaved|. There must be sufficient space allocated in
 // |interleaved| (|samples_per_channel| * |num_channels|).
@@ -160,10 +203,10 @@ void UpmixMonoToInterleaved(const T* mono,
 }
 
 template <typename T, typename Intermediate>
-void DownmixToMono(const T* const* input_channels,
-                   size_t num_frames,
-                   int num_channels,
-                   T* out) {
+void DownmixToMonoImpl(const T* const* input_channels,
+                       size_t num_frames,
+                       int num_channels,
+                       T* out) {
   for (size_t i = 0; i < num_frames; ++i) {
     Intermediate value = input_channels[0][i];
     for (int j = 1; j < num_channels; ++j) {
@@ -173,6 +216,23 @@ void DownmixToMono(const T* const* input_channels,
   }
 }
 
+// Downmixes a multichannel signal to a single channel by averaging all
+// channels. The float version uses SIMD.
+template <typename T, typename Intermediate>
+void DownmixToMono(const T* const* input_channels,
+                   size_t num_frames,
+                   int num_channels,
+                   T* out) {
+  DownmixToMonoImpl<T, Intermediate>(input_channels, num_frames, num_channels,
+                                     out);
+}
+
+template <>
+void DownmixToMono<float, float>(const float* const* input_channels,
+                                 size_t num_frames,
+                                 int num_channels,
+                                 float* out);
+
 // Downmixes an interleaved multichannel signal to a single channel by averaging
 // all channels.
 template <typename T, typename Intermediate>
@@ -11,6 +11,7 @@
 #include "common_audio/real_fourier.h"
 
 #include "common_audio/real_fourier_ooura.h"
+#include "common_audio/real_fourier_pffft.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "rtc_base/checks.h"
 
@@ -21,7 +22,17 @@ using std::complex;
 const size_t RealFourier::kFftBufferAlignment = 32;
 
 std::unique_ptr<RealFourier> RealFourier::Create(int fft_order) {
-  return std::unique_ptr<RealFourier>(new RealFourierOoura(fft_order));
+  return Create(fft_order, Implementation::kOoura);
+}
+
+std::unique_ptr<RealFourier> RealFourier::Create(
+    int fft_order,
+    Implementation implementation) {
+  if (implementation == Implementation::kPffft &&
+      fft_order >= RealFourierPffft::kMinFftOrder) {
+    return std::make_unique<RealFourierPffft>(fft_order);
+  }
+  return std::make_unique<RealFourierOoura>(fft_order);
 }
 
 int RealFourier::FftOrder(size_t length) {
@@ -34,9 +34,21 @@ class RealFourier {
   // The alignment required for all input and output buffers, in bytes.
   static const size_t kFftBufferAlignment;
 
+  // The FFT libraries a RealFourier can be backed by.
+  enum class Implementation {
+    // The portable Ooura FFT.
+    kOoura,
+    // PFFFT, which is vectorized where SSE or NEON is available.
+    kPffft,
+  };
+
   // Construct a wrapper instance for the given input order, which must be
   // between 1 and kMaxFftOrder, inclusively.
   static std::unique_ptr<RealFourier> Create(int fft_order);
+  // Same as above, backed by |implementation| when it supports |fft_order|,
+  // and by the Ooura FFT otherwise.
+  static std::unique_ptr<RealFourier> Create(int fft_order,
+                                             Implementation implementation);
   virtual ~RealFourier() {}
 
   // Helper to compute the smallest FFT order (a power of 2) which will contain
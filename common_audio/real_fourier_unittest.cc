@@ -12,7 +12,13 @@
 
 #include <stdlib.h>
 
+#include <memory>
+
 #include "common_audio/real_fourier_ooura.h"
+#include "common_audio/real_fourier_pffft.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -99,4 +105,86 @@ TYPED_TEST(RealFourierTest, SimpleBackwardTransform) {
   EXPECT_NEAR(this->real_buffer_[3], 4.0f, 1e-8f);
 }
 
+TEST(RealFourierPffftTest, MatchesOoura) {
+  Random random(42);
+  for (int order = RealFourierPffft::kMinFftOrder; order <= 10; ++order) {
+    SCOPED_TRACE(order);
+    const size_t length = RealFourier::FftLength(order);
+    const size_t complex_length = RealFourier::ComplexLength(order);
+    RealFourierOoura ooura(order);
+    RealFourierPffft pffft(order);
+    RealFourier::fft_real_scoper input = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_real_scoper output = RealFourier::AllocRealBuffer(length);
+    RealFourier::fft_cplx_scoper ooura_spectrum =
+        RealFourier::AllocCplxBuffer(complex_length);
+    RealFourier::fft_cplx_scoper pffft_spectrum =
+        RealFourier::AllocCplxBuffer(complex_length);
+    for (size_t i = 0; i < length; ++i) {
+      input[i] = 2.f * random.Rand<float>() - 1.f;
+    }
+
+    ooura.Forward(input.get(), ooura_spectrum.get());
+    pffft.Forward(input.get(), pffft_spectrum.get());
+    for (size_t i = 0; i < complex_length; ++i) {
+      EXPECT_NEAR(ooura_spectrum[i].real(), pffft_spectrum[i].real(), 1e-3f);
+      EXPECT_NEAR(ooura_spectrum[i].imag(), pffft_spectrum[i].imag(), 1e-3f);
+    }
+
+    pffft.Inverse(pffft_spectrum.get(), output.get());
+    for (size_t i = 0; i < length; ++i) {
+      EXPECT_NEAR(input[i], output[i], 1e-5f);
+    }
+  }
+}
+
+TEST(RealFourierTest, CreateFallsBackToOouraForSmallOrders) {
+  std::unique_ptr<RealFourier> fft =
+      RealFourier::Create(2, RealFourier::Implementation::kPffft);
+  RealFourier::fft_real_scoper real_buffer = RealFourier::AllocRealBuffer(4);
+  RealFourier::fft_cplx_scoper cplx_buffer = RealFourier::AllocCplxBuffer(3);
+  for (int i = 0; i < 4; ++i) {
+    real_buffer[i] = i + 1.0f;
+  }
+
+  fft->Forward(real_buffer.get(), cplx_buffer.get());
+
+  EXPECT_NEAR(cplx_buffer[0].real(), 10.0f, 1e-8f);
+  EXPECT_NEAR(cplx_buffer[1].real(), -2.0f, 1e-8f);
+  EXPECT_NEAR(cplx_buffer[1].imag(), 2.0f, 1e-8f);
+  EXPECT_NEAR(cplx_buffer[2].real(), -2.0f, 1e-8f);
+}
+
+// Logs how long the forward and inverse 256 point transforms that the noise
+// suppressor runs on every 10 ms frame take with each implementation.
+TEST(RealFourierTest, DISABLED_Benchmark) {
+  constexpr int kOrder = 8;
+  constexpr int kIterations = 100000;
+  const size_t length = RealFourier::FftLength(kOrder);
+  Random random(42);
+  RealFourier::fft_real_scoper real_buffer =
+      RealFourier::AllocRealBuffer(length);
+  RealFourier::fft_cplx_scoper cplx_buffer =
+      RealFourier::AllocCplxBuffer(RealFourier::ComplexLength(kOrder));
+  for (size_t i = 0; i < length; ++i) {
+    real_buffer[i] = 2.f * random.Rand<float>() - 1.f;
+  }
+
+  for (auto implementation : {RealFourier::Implementation::kOoura,
+                              RealFourier::Implementation::kPffft}) {
+    std::unique_ptr<RealFourier> fft =
+        RealFourier::Create(kOrder, implementation);
+    const int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kIterations; ++i) {
+      fft->Forward(real_buffer.get(), cplx_buffer.get());
+      fft->Inverse(cplx_buffer.get(), real_buffer.get());
+    }
+    const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+    RTC_LOG(LS_INFO) << (implementation == RealFourier::Implementation::kOoura
+                             ? "Ooura"
+                             : "PFFFT")
+                     << ": " << elapsed_us * 1000 / kIterations
+                     << " ns per 10 ms frame";
+  }
+}
+
 }  // namespace webrtc
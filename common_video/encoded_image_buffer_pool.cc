@@ -0,0 +1,201 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/encoded_image_buffer_pool.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/ref_counter.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace {
+
+// Index of the smallest capacity class that fits |size|.
+size_t CapacityClass(size_t size) {
+  size_t capacity_class = 0;
+  while ((EncodedImageBufferPool::kMinCapacity << capacity_class) < size)
+    ++capacity_class;
+  return capacity_class;
+}
+
+size_t NumCapacityClasses() {
+  return CapacityClass(EncodedImageBufferPool::kMaxPooledCapacity) + 1;
+}
+
+}  // namespace
+
+// State shared between the pool and the buffers it created, so that buffers
+// can outlive the pool.
+class EncodedImageBufferPool::Core : public rtc::RefCountInterface {
+ public:
+  Core(size_t max_free_buffers_per_capacity, BufferAllocator* allocator)
+      : max_free_buffers_per_capacity_(max_free_buffers_per_capacity),
+        allocator_(allocator),
+        free_buffers_(NumCapacityClasses()) {}
+
+  rtc::scoped_refptr<EncodedImageBufferInterface> Allocate(size_t size);
+  // Takes ownership of |buffer|, which has no references left.
+  void Recycle(PooledBuffer* buffer);
+  // Frees all unused storage. Storage returned afterwards is freed directly.
+  void Close();
+
+  Stats GetStats() const {
+    rtc::CritScope lock(&lock_);
+    return stats_;
+  }
+
+ protected:
+  ~Core() override { RTC_DCHECK(closed_); }
+
+ private:
+  const size_t max_free_buffers_per_capacity_;
+  BufferAllocator* const allocator_;
+  rtc::CriticalSection lock_;
+  bool closed_ RTC_GUARDED_BY(lock_) = false;
+  // Unused buffers, by capacity class.
+  std::vector<std::vector<PooledBuffer*>> free_buffers_ RTC_GUARDED_BY(lock_);
+  Stats stats_ RTC_GUARDED_BY(lock_);
+};
+
+// Buffer that returns itself to the pool when the last reference is dropped.
+class EncodedImageBufferPool::PooledBuffer final
+    : public EncodedImageBufferInterface {
+ public:
+  PooledBuffer(size_t capacity_class,
+               BufferAllocator* allocator,
+               rtc::scoped_refptr<Core> core)
+      : capacity_class_(capacity_class),
+        storage_(static_cast<uint8_t*>(
+                     allocator->Allocate(kMinCapacity << capacity_class)),
+                 BufferAllocatorDeleter{allocator,
+                                        kMinCapacity << capacity_class}),
+        core_(std::move(core)) {}
+  ~PooledBuffer() override = default;
+
+  void AddRef() const override { ref_count_.IncRef(); }
+  rtc::RefCountReleaseStatus Release() const override {
+    const auto status = ref_count_.DecRef();
+    if (status == rtc::RefCountReleaseStatus::kDroppedLastRef) {
+      core_->Recycle(const_cast<PooledBuffer*>(this));
+    }
+    return status;
+  }
+
+  const uint8_t* data() const override { return storage_.get(); }
+  uint8_t* data() override { return storage_.get(); }
+  size_t size() const override { return size_; }
+
+  size_t capacity_class() const { return capacity_class_; }
+  void set_size(size_t size) {
+    RTC_DCHECK_LE(size, kMinCapacity << capacity_class_);
+    size_ = size;
+  }
+
+ private:
+  const size_t capacity_class_;
+  const std::unique_ptr<uint8_t, BufferAllocatorDeleter> storage_;
+  const rtc::scoped_refptr<Core> core_;
+  size_t size_ = 0;
+  mutable webrtc_impl::RefCounter ref_count_{0};
+};
+
+rtc::scoped_refptr<EncodedImageBufferInterface>
+EncodedImageBufferPool::Core::Allocate(size_t size) {
+  if (size > kMaxPooledCapacity) {
+    {
+      rtc::CritScope lock(&lock_);
+      ++stats_.misses;
+    }
+    return EncodedImageBuffer::Create(size);
+  }
+
+  const size_t capacity_class = CapacityClass(size);
+  PooledBuffer* buffer = nullptr;
+  {
+    rtc::CritScope lock(&lock_);
+    RTC_DCHECK(!closed_);
+    std::vector<PooledBuffer*>& free_buffers = free_buffers_[capacity_class];
+    if (!free_buffers.empty()) {
+      buffer = free_buffers.back();
+      free_buffers.pop_back();
+      ++stats_.hits;
+    } else {
+      ++stats_.misses;
+    }
+  }
+  if (!buffer)
+    buffer = new PooledBuffer(capacity_class, allocator_, this);
+  buffer->set_size(size);
+  return buffer;
+}
+
+void EncodedImageBufferPool::Core::Recycle(PooledBuffer* buffer) {
+  {
+    rtc::CritScope lock(&lock_);
+    std::vector<PooledBuffer*>& free_buffers =
+        free_buffers_[buffer->capacity_class()];
+    if (!closed_ && free_buffers.size() < max_free_buffers_per_capacity_) {
+      free_buffers.push_back(buffer);
+      return;
+    }
+  }
+  // Deleting the buffer may drop the last reference to |this|, so it must
+  // happen outside the lock.
+  delete buffer;
+}
+
+void EncodedImageBufferPool::Core::Close() {
+  std::vector<std::vector<PooledBuffer*>> free_buffers;
+  {
+    rtc::CritScope lock(&lock_);
+    closed_ = true;
+    free_buffers.swap(free_buffers_);
+  }
+  for (const std::vector<PooledBuffer*>& buffers : free_buffers) {
+    for (PooledBuffer* buffer : buffers)
+      delete buffer;
+  }
+}
+
+EncodedImageBufferPool::EncodedImageBufferPool()
+    : EncodedImageBufferPool(kDefaultMaxFreeBuffersPerCapacity) {}
+
+EncodedImageBufferPool::EncodedImageBufferPool(
+    size_t max_free_buffers_per_capacity)
+    : EncodedImageBufferPool(max_free_buffers_per_capacity,
+                             GetDefaultBufferAllocator()) {}
+
+EncodedImageBufferPool::EncodedImageBufferPool(
+    size_t max_free_buffers_per_capacity,
+    BufferAllocator* allocator)
+    : core_(new rtc::RefCountedObject<Core>(max_free_buffers_per_capacity,
+                                            allocator)) {}
+
+EncodedImageBufferPool::~EncodedImageBufferPool() {
+  core_->Close();
+}
+
+rtc::scoped_refptr<EncodedImageBufferInterface> EncodedImageBufferPool::Create(
+    size_t size) {
+  return core_->Allocate(size);
+}
+
+EncodedImageBufferPool::Stats EncodedImageBufferPool::GetStats() const {
+  return core_->GetStats();
+}
+
+}  // namespace webrtc
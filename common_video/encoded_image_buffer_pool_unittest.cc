@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/encoded_image_buffer_pool.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "api/video/encoded_image.h"
+#include "rtc_base/memory/buffer_allocator.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+class CountingAllocator : public BufferAllocator {
+ public:
+  void* Allocate(size_t size) override {
+    ++num_allocations;
+    allocated_bytes += size;
+    return GetDefaultBufferAllocator()->Allocate(size);
+  }
+  void Free(void* data, size_t size) override {
+    --num_allocations;
+    allocated_bytes -= size;
+    GetDefaultBufferAllocator()->Free(data, size);
+  }
+
+  int num_allocations = 0;
+  size_t allocated_bytes = 0;
+};
+
+}  // namespace
+
+TEST(EncodedImageBufferPoolTest, ReusesReleasedBuffer) {
+  EncodedImageBufferPool pool;
+  auto buffer = pool.Create(1000);
+  EXPECT_EQ(1000u, buffer->size());
+  const uint8_t* data = buffer->data();
+  buffer = nullptr;
+
+  buffer = pool.Create(1000);
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_EQ(1, pool.GetStats().hits);
+  EXPECT_EQ(1, pool.GetStats().misses);
+}
+
+TEST(EncodedImageBufferPoolTest, ReusesBufferForSmallerSizeOfSameCapacity) {
+  EncodedImageBufferPool pool;
+  auto buffer = pool.Create(EncodedImageBufferPool::kMinCapacity * 3 / 2);
+  const uint8_t* data = buffer->data();
+  buffer = nullptr;
+
+  buffer = pool.Create(EncodedImageBufferPool::kMinCapacity + 1);
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_EQ(EncodedImageBufferPool::kMinCapacity + 1, buffer->size());
+  // The whole size is writable.
+  memset(buffer->data(), 0xab, buffer->size());
+}
+
+TEST(EncodedImageBufferPoolTest, DoesNotReuseBufferInUse) {
+  EncodedImageBufferPool pool;
+  auto buffer1 = pool.Create(100);
+  auto buffer2 = pool.Create(100);
+  EXPECT_NE(buffer1->data(), buffer2->data());
+  EXPECT_EQ(0, pool.GetStats().hits);
+  EXPECT_EQ(2, pool.GetStats().misses);
+}
+
+TEST(EncodedImageBufferPoolTest, DoesNotReuseBufferOfSmallerCapacity) {
+  EncodedImageBufferPool pool;
+  auto buffer = pool.Create(100);
+  buffer = nullptr;
+
+  buffer = pool.Create(EncodedImageBufferPool::kMinCapacity * 2);
+  EXPECT_EQ(EncodedImageBufferPool::kMinCapacity * 2, buffer->size());
+  EXPECT_EQ(0, pool.GetStats().hits);
+}
+
+TEST(EncodedImageBufferPoolTest, AllocatesFramesLargerThanPooledCapacity) {
+  EncodedImageBufferPool pool;
+  auto buffer = pool.Create(EncodedImageBufferPool::kMaxPooledCapacity + 1);
+  EXPECT_EQ(EncodedImageBufferPool::kMaxPooledCapacity + 1, buffer->size());
+  buffer = nullptr;
+
+  buffer = pool.Create(EncodedImageBufferPool::kMaxPooledCapacity + 1);
+  EXPECT_EQ(0, pool.GetStats().hits);
+  EXPECT_EQ(2, pool.GetStats().misses);
+}
+
+TEST(EncodedImageBufferPoolTest, KeepsAtMostMaxFreeBuffers) {
+  EncodedImageBufferPool pool(/*max_free_buffers_per_capacity=*/1);
+  std::vector<rtc::scoped_refptr<EncodedImageBufferInterface>> buffers;
+  buffers.push_back(pool.Create(100));
+  buffers.push_back(pool.Create(100));
+  buffers.clear();
+
+  buffers.push_back(pool.Create(100));
+  buffers.push_back(pool.Create(100));
+  EXPECT_EQ(1, pool.GetStats().hits);
+  EXPECT_EQ(3, pool.GetStats().misses);
+}
+
+TEST(EncodedImageBufferPoolTest, BufferOutlivesPool) {
+  rtc::scoped_refptr<EncodedImageBufferInterface> buffer;
+  {
+    EncodedImageBufferPool pool;
+    buffer = pool.Create(100);
+  }
+  memset(buffer->data(), 0xab, buffer->size());
+  buffer = nullptr;
+}
+
+TEST(EncodedImageBufferPoolTest, AllocatesWithAllocator) {
+  CountingAllocator allocator;
+  {
+    EncodedImageBufferPool pool(
+        EncodedImageBufferPool::kDefaultMaxFreeBuffersPerCapacity, &allocator);
+    auto buffer = pool.Create(100);
+    EXPECT_EQ(1, allocator.num_allocations);
+    EXPECT_EQ(size_t{EncodedImageBufferPool::kMinCapacity},
+              allocator.allocated_bytes);
+    buffer = nullptr;
+    // The storage is kept for reuse.
+    EXPECT_EQ(1, allocator.num_allocations);
+  }
+  EXPECT_EQ(0, allocator.num_allocations);
+  EXPECT_EQ(0u, allocator.allocated_bytes);
+}
+
+}  // namespace webrtc
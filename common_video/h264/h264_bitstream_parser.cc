@@ -10,7 +10,9 @@
 #include "common_video/h264/h264_bitstream_parser.h"
 
 #include <stdlib.h>
+#include <string.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -24,6 +26,24 @@ const int kMaxAbsQpDeltaValue = 51;
 const int kMinQpValue = 0;
 const int kMaxQpValue = 51;
 
+// Bytes at the start of a slice that are unescaped to parse the slice header.
+// Headers are normally much shorter; longer ones are parsed from the whole
+// slice.
+const size_t kMaxSliceHeaderSize = 128;
+
+// Returns true if |nalu| is the same as |last_nalu|, and otherwise stores it
+// in |last_nalu|.
+bool IsRepeatedNalu(const uint8_t* nalu,
+                    size_t length,
+                    std::vector<uint8_t>* last_nalu) {
+  if (last_nalu->size() == length &&
+      memcmp(last_nalu->data(), nalu, length) == 0) {
+    return true;
+  }
+  last_nalu->assign(nalu, nalu + length);
+  return false;
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -47,6 +67,19 @@ H264BitstreamParser::Result H264BitstreamParser::ParseNonParameterSetNalu(
     return kInvalidStream;
 
   last_slice_qp_delta_ = absl::nullopt;
+  // Only the start of the slice is unescaped, unless the header doesn't fit.
+  Result result = ParseSliceHeader(
+      source, std::min(source_length, kMaxSliceHeaderSize), nalu_type);
+  if (result == kInvalidStream && source_length > kMaxSliceHeaderSize) {
+    result = ParseSliceHeader(source, source_length, nalu_type);
+  }
+  return result;
+}
+
+H264BitstreamParser::Result H264BitstreamParser::ParseSliceHeader(
+    const uint8_t* source,
+    size_t source_length,
+    uint8_t nalu_type) {
   const std::vector<uint8_t> slice_rbsp =
       H264::ParseRbsp(source, source_length);
   if (slice_rbsp.size() < H264::kNaluTypeSize)
@@ -272,6 +305,9 @@ void H264BitstreamParser::ParseSlice(const uint8_t* slice, size_t length) {
   H264::NaluType nalu_type = H264::ParseNaluType(slice[0]);
   switch (nalu_type) {
     case H264::NaluType::kSps: {
+      // Encoders repeat the same SPS and PPS with each key frame.
+      if (IsRepeatedNalu(slice, length, &last_sps_nalu_))
+        break;
       sps_ = SpsParser::ParseSps(slice + H264::kNaluTypeSize,
                                  length - H264::kNaluTypeSize);
       if (!sps_)
@@ -279,6 +315,8 @@ void H264BitstreamParser::ParseSlice(const uint8_t* slice, size_t length) {
       break;
     }
     case H264::NaluType::kPps: {
+      if (IsRepeatedNalu(slice, length, &last_pps_nalu_))
+        break;
       pps_ = PpsParser::ParsePps(slice + H264::kNaluTypeSize,
                                  length - H264::kNaluTypeSize);
       if (!pps_)
@@ -300,8 +338,30 @@ void H264BitstreamParser::ParseBitstream(const uint8_t* bitstream,
                                          size_t length) {
   std::vector<H264::NaluIndex> nalu_indices =
       H264::FindNaluIndices(bitstream, length);
-  for (const H264::NaluIndex& index : nalu_indices)
+  // Only the QP of the last slice is kept, so a slice is parsed only when it is
+  // the last one before a parameter set or the end of the bitstream.
+  const H264::NaluIndex* pending_slice = nullptr;
+  for (const H264::NaluIndex& index : nalu_indices) {
+    H264::NaluType nalu_type =
+        H264::ParseNaluType(bitstream[index.payload_start_offset]);
+    if (nalu_type == H264::NaluType::kSps ||
+        nalu_type == H264::NaluType::kPps) {
+      if (pending_slice) {
+        ParseSlice(&bitstream[pending_slice->payload_start_offset],
+                   pending_slice->payload_size);
+        pending_slice = nullptr;
+      }
+    } else if (nalu_type != H264::NaluType::kAud &&
+               nalu_type != H264::NaluType::kSei) {
+      pending_slice = &index;
+      continue;
+    }
     ParseSlice(&bitstream[index.payload_start_offset], index.payload_size);
+  }
+  if (pending_slice) {
+    ParseSlice(&bitstream[pending_slice->payload_start_offset],
+               pending_slice->payload_size);
+  }
 }
 
 bool H264BitstreamParser::GetLastSliceQp(int* qp) const {
@@ -13,6 +13,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <vector>
+
 #include "absl/types/optional.h"
 #include "api/video_codecs/bitstream_parser.h"
 #include "common_video/h264/pps_parser.h"
@@ -49,10 +51,17 @@ class H264BitstreamParser : public BitstreamParser {
   Result ParseNonParameterSetNalu(const uint8_t* source,
                                   size_t source_length,
                                   uint8_t nalu_type);
+  // Parses the slice header in the first |source_length| bytes of a slice.
+  Result ParseSliceHeader(const uint8_t* source,
+                          size_t source_length,
+                          uint8_t nalu_type);
 
   // SPS/PPS state, updated when parsing new SPS/PPS, used to parse slices.
   absl::optional<SpsParser::SpsState> sps_;
   absl::optional<PpsParser::PpsState> pps_;
+  // The latest SPS and PPS NAL units, to skip parsing repeated ones.
+  std::vector<uint8_t> last_sps_nalu_;
+  std::vector<uint8_t> last_pps_nalu_;
 
   // Last parsed slice QP.
   absl::optional<int32_t> last_slice_qp_delta_;
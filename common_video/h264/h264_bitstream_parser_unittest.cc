@@ -10,6 +10,8 @@
 
 #include "common_video/h264/h264_bitstream_parser.h"
 
+#include <vector>
+
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -85,4 +87,46 @@ TEST(H264BitstreamParserTest, ReportsLastSliceQpForCABACImageSlices) {
   EXPECT_EQ(24, qp);
 }
 
+TEST(H264BitstreamParserTest, ReportsQpOfLastSliceInBitstream) {
+  std::vector<uint8_t> bitstream(
+      kH264BitstreamChunk, kH264BitstreamChunk + sizeof(kH264BitstreamChunk));
+  bitstream.insert(bitstream.end(), kH264BitstreamNextImageSliceChunk,
+                   kH264BitstreamNextImageSliceChunk +
+                       sizeof(kH264BitstreamNextImageSliceChunk));
+  H264BitstreamParser h264_parser;
+  h264_parser.ParseBitstream(bitstream.data(), bitstream.size());
+  int qp;
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(37, qp);
+}
+
+TEST(H264BitstreamParserTest, ReportsQpWithRepeatedParameterSets) {
+  H264BitstreamParser h264_parser;
+  h264_parser.ParseBitstream(kH264BitstreamChunk, sizeof(kH264BitstreamChunk));
+  h264_parser.ParseBitstream(kH264BitstreamChunk, sizeof(kH264BitstreamChunk));
+  int qp;
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(35, qp);
+
+  // Switching to other parameter sets takes effect.
+  h264_parser.ParseBitstream(kH264BitstreamChunkCabac,
+                             sizeof(kH264BitstreamChunkCabac));
+  h264_parser.ParseBitstream(kH264BitstreamNextImageSliceChunkCabac,
+                             sizeof(kH264BitstreamNextImageSliceChunkCabac));
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(24, qp);
+}
+
+TEST(H264BitstreamParserTest, ReportsQpForLongSlices) {
+  // Only the start of a long slice has to be unescaped for the slice header.
+  std::vector<uint8_t> bitstream(
+      kH264BitstreamChunk, kH264BitstreamChunk + sizeof(kH264BitstreamChunk));
+  bitstream.resize(bitstream.size() + 1000, 0x2a);
+  H264BitstreamParser h264_parser;
+  h264_parser.ParseBitstream(bitstream.data(), bitstream.size());
+  int qp;
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(35, qp);
+}
+
 }  // namespace webrtc
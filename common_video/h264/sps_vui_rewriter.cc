@@ -210,7 +210,7 @@ SpsVuiRewriter::ParseResult SpsVuiRewriter::ParseAndRewriteSps(
   return result;
 }
 
-void SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
+bool SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
     rtc::ArrayView<const uint8_t> buffer,
     size_t num_nalus,
     const size_t* nalu_offsets,
@@ -219,8 +219,8 @@ void SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
     rtc::Buffer* output_buffer,
     size_t* output_nalu_offsets,
     size_t* output_nalu_lengths) {
-  // Allocate some extra space for potentially adding a missing VUI.
-  output_buffer->EnsureCapacity(buffer.size() + num_nalus * kMaxVuiSpsIncrease);
+  // Nothing is copied to |output_buffer| until the first SPS is rewritten.
+  bool rewritten = false;
 
   const uint8_t* prev_nalu_ptr = buffer.data();
   size_t prev_nalu_length = 0;
@@ -229,11 +229,13 @@ void SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
     const uint8_t* nalu_ptr = buffer.data() + nalu_offsets[i];
     const size_t nalu_length = nalu_lengths[i];
 
-    // Copy NAL unit start code.
-    const uint8_t* start_code_ptr = prev_nalu_ptr + prev_nalu_length;
-    const size_t start_code_length =
-        (nalu_ptr - prev_nalu_ptr) - prev_nalu_length;
-    output_buffer->AppendData(start_code_ptr, start_code_length);
+    if (rewritten) {
+      // Copy NAL unit start code.
+      const uint8_t* start_code_ptr = prev_nalu_ptr + prev_nalu_length;
+      const size_t start_code_length =
+          (nalu_ptr - prev_nalu_ptr) - prev_nalu_length;
+      output_buffer->AppendData(start_code_ptr, start_code_length);
+    }
 
     bool updated_sps = false;
 
@@ -260,6 +262,14 @@ void SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
           nalu_ptr + H264::kNaluTypeSize, nalu_length - H264::kNaluTypeSize,
           &sps, color_space, &output_nalu, Direction::kOutgoing);
       if (result == ParseResult::kVuiRewritten) {
+        if (!rewritten) {
+          // Allocate some extra space for potentially adding a missing VUI,
+          // and copy everything up to this NAL unit, including its start code.
+          output_buffer->EnsureCapacity(buffer.size() +
+                                        num_nalus * kMaxVuiSpsIncrease);
+          output_buffer->AppendData(buffer.data(), nalu_offsets[i]);
+          rewritten = true;
+        }
         updated_sps = true;
         output_nalu_offsets[i] = output_buffer->size();
         output_nalu_lengths[i] = output_nalu.size();
@@ -268,14 +278,20 @@ void SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
     }
 
     if (!updated_sps) {
-      output_nalu_offsets[i] = output_buffer->size();
       output_nalu_lengths[i] = nalu_length;
-      output_buffer->AppendData(nalu_ptr, nalu_length);
+      if (rewritten) {
+        output_nalu_offsets[i] = output_buffer->size();
+        output_buffer->AppendData(nalu_ptr, nalu_length);
+      } else {
+        output_nalu_offsets[i] = nalu_offsets[i];
+      }
     }
 
     prev_nalu_ptr = nalu_ptr;
     prev_nalu_length = nalu_length;
   }
+
+  return rewritten;
 }
 
 namespace {
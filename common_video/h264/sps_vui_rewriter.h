@@ -55,7 +55,10 @@ class SpsVuiRewriter : private SpsParser {
   // The result is written to |output_buffer| and modified NAL unit offsets
   // and lenghts are written to |output_nalu_offsets| and |output_nalu_lenghts|
   // to account for any added data.
-  static void ParseOutgoingBitstreamAndRewriteSps(
+  // Returns false if no SPS had to be rewritten. In that case nothing is
+  // copied: |output_buffer| is left untouched, and the output offsets and
+  // lengths are those of |buffer|.
+  static bool ParseOutgoingBitstreamAndRewriteSps(
       rtc::ArrayView<const uint8_t> buffer,
       size_t num_nalus,
       const size_t* nalu_offsets,
@@ -412,14 +412,12 @@ TEST(SpsVuiRewriterOutgoingVuiTest, ParseOutgoingBitstreamOptimalVui) {
   size_t modified_nalu_offsets[kNumNalus];
   size_t modified_nalu_lengths[kNumNalus];
 
-  SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
+  // Nothing is copied when no SPS is rewritten.
+  EXPECT_FALSE(SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
       buffer, kNumNalus, nalu_offsets, nalu_lengths, nullptr, &modified_buffer,
-      modified_nalu_offsets, modified_nalu_lengths);
+      modified_nalu_offsets, modified_nalu_lengths));
 
-  EXPECT_THAT(
-      std::vector<uint8_t>(modified_buffer.data(),
-                           modified_buffer.data() + modified_buffer.size()),
-      ::testing::ElementsAreArray(buffer.data(), buffer.size()));
+  EXPECT_EQ(modified_buffer.size(), 0u);
   EXPECT_THAT(std::vector<size_t>(modified_nalu_offsets,
                                   modified_nalu_offsets + kNumNalus),
               ::testing::ElementsAreArray(nalu_offsets, kNumNalus));
@@ -476,9 +474,9 @@ TEST(SpsVuiRewriterOutgoingVuiTest, ParseOutgoingBitstreamNoVui) {
   size_t modified_nalu_offsets[kNumNalus];
   size_t modified_nalu_lengths[kNumNalus];
 
-  SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
+  EXPECT_TRUE(SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
       buffer, kNumNalus, nalu_offsets, nalu_lengths, nullptr, &modified_buffer,
-      modified_nalu_offsets, modified_nalu_lengths);
+      modified_nalu_offsets, modified_nalu_lengths));
 
   EXPECT_THAT(
       std::vector<uint8_t>(modified_buffer.data(),
@@ -10,52 +10,248 @@
 
 #include "common_video/include/i420_buffer_pool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/ref_counter.h"
 
 namespace webrtc {
 
+namespace {
+
+// Resolutions kept at the same time, enough for simulcast while adapting.
+constexpr size_t kMaxNumberOfSubPools = 4;
+// A sub-pool not asked for a buffer in this many CreateBuffer calls is purged,
+// so that the buffers of a previous resolution are freed soon after switching.
+constexpr uint64_t kMaxIdleRequests = 30;
+
+}  // namespace
+
+// A buffer that returns itself to its sub-pool, instead of being deleted, when
+// the last reference is dropped.
+template <typename BufferT>
+class I420BufferPool::PooledBuffer : public BufferT {
+ public:
+  template <typename... Args>
+  PooledBuffer(SubPool<BufferT>* sub_pool, Args... args)
+      : BufferT(args...), sub_pool_(sub_pool) {}
+
+  void AddRef() const override { ref_count_.IncRef(); }
+  rtc::RefCountReleaseStatus Release() const override;
+
+ private:
+  friend class SubPool<BufferT>;
+
+  ~PooledBuffer() override = default;
+
+  mutable webrtc_impl::RefCounter ref_count_{0};
+  const rtc::scoped_refptr<SubPool<BufferT>> sub_pool_;
+  // Links the buffers in the free lists of |sub_pool_|.
+  PooledBuffer<BufferT>* next_ = nullptr;
+};
+
+// The buffers of one resolution and stride. Buffers hold a reference, so that
+// they can be returned after the pool has dropped the sub-pool or been
+// destroyed; a detached sub-pool deletes returned buffers. Unless noted, the
+// methods run on the pool's sequence.
+template <typename BufferT>
+class I420BufferPool::SubPool : public rtc::RefCountInterface {
+ public:
+  SubPool(int width, int height, int stride_y, int stride_u, int stride_v)
+      : width_(width),
+        height_(height),
+        stride_y_(stride_y),
+        stride_u_(stride_u),
+        stride_v_(stride_v) {}
+
+  bool Matches(int width,
+               int height,
+               int stride_y,
+               int stride_u,
+               int stride_v) const {
+    return width_ == width && height_ == height && stride_y_ == stride_y &&
+           stride_u_ == stride_u && stride_v_ == stride_v;
+  }
+
+  rtc::scoped_refptr<BufferT> GetBuffer(size_t max_number_of_buffers,
+                                        bool zero_initialize,
+                                        BufferAllocator* allocator) {
+    if (!free_)
+      TakeReturnedBuffers();
+    if (free_) {
+      PooledBuffer<BufferT>* buffer = free_;
+      free_ = buffer->next_;
+      buffer->next_ = nullptr;
+      --num_free_;
+      return buffer;
+    }
+    if (num_buffers_ >= max_number_of_buffers)
+      return nullptr;
+    PooledBuffer<BufferT>* buffer = NewBuffer(allocator);
+    ++num_buffers_;
+    if (zero_initialize)
+      buffer->InitializeData();
+    return buffer;
+  }
+
+  size_t NumBuffersInUse() {
+    TakeReturnedBuffers();
+    return num_buffers_ - num_free_;
+  }
+
+  // Deletes free buffers until at most |max_number_of_buffers| remain.
+  void Shrink(size_t max_number_of_buffers) {
+    TakeReturnedBuffers();
+    while (free_ && num_buffers_ > max_number_of_buffers) {
+      PooledBuffer<BufferT>* buffer = free_;
+      free_ = buffer->next_;
+      --num_free_;
+      --num_buffers_;
+      delete buffer;
+    }
+  }
+
+  // Deletes the free buffers, and makes the buffers still in use delete
+  // themselves when released.
+  void Detach() {
+    detached_.store(true);
+    Shrink(0);
+    DeleteReturnedBuffers();
+  }
+
+  // Called on any thread, by a buffer whose last reference was dropped. The
+  // caller keeps a reference to the sub-pool.
+  void Return(PooledBuffer<BufferT>* buffer) {
+    PooledBuffer<BufferT>* head = returned_.load(std::memory_order_relaxed);
+    do {
+      buffer->next_ = head;
+    } while (!returned_.compare_exchange_weak(head, buffer));
+    // Either Detach() sees the buffer, or this sees that the sub-pool was
+    // detached, since both sides use sequentially consistent operations.
+    if (detached_.load())
+      DeleteReturnedBuffers();
+  }
+
+  uint64_t last_request() const { return last_request_; }
+  void set_last_request(uint64_t request) { last_request_ = request; }
+
+ private:
+  PooledBuffer<BufferT>* NewBuffer(BufferAllocator* allocator);
+
+  // Moves the buffers returned since the last call to the free list. Only the
+  // pool takes from |returned_|, and it takes the whole list, so the lock-free
+  // stack is not subject to ABA.
+  void TakeReturnedBuffers() {
+    PooledBuffer<BufferT>* buffer = returned_.exchange(nullptr);
+    while (buffer) {
+      PooledBuffer<BufferT>* next = buffer->next_;
+      buffer->next_ = free_;
+      free_ = buffer;
+      ++num_free_;
+      buffer = next;
+    }
+  }
+
+  // Called on any thread once detached.
+  void DeleteReturnedBuffers() {
+    PooledBuffer<BufferT>* buffer = returned_.exchange(nullptr);
+    while (buffer) {
+      PooledBuffer<BufferT>* next = buffer->next_;
+      delete buffer;
+      buffer = next;
+    }
+  }
+
+  const int width_;
+  const int height_;
+  const int stride_y_;
+  const int stride_u_;
+  const int stride_v_;
+  // Buffers released since the pool last looked, pushed on any thread.
+  std::atomic<PooledBuffer<BufferT>*> returned_{nullptr};
+  std::atomic<bool> detached_{false};
+  // Accessed on the pool's sequence only.
+  PooledBuffer<BufferT>* free_ = nullptr;
+  size_t num_free_ = 0;
+  size_t num_buffers_ = 0;
+  uint64_t last_request_ = 0;
+};
+
+template <>
+I420BufferPool::PooledBuffer<I420Buffer>*
+I420BufferPool::SubPool<I420Buffer>::NewBuffer(BufferAllocator* allocator) {
+  return new PooledBuffer<I420Buffer>(this, width_, height_, stride_y_,
+                                      stride_u_, stride_v_, allocator);
+}
+
+template <>
+I420BufferPool::PooledBuffer<NV12Buffer>*
+I420BufferPool::SubPool<NV12Buffer>::NewBuffer(BufferAllocator* allocator) {
+  return new PooledBuffer<NV12Buffer>(this, width_, height_, stride_y_,
+                                      stride_u_, allocator);
+}
+
+template <typename BufferT>
+rtc::RefCountReleaseStatus I420BufferPool::PooledBuffer<BufferT>::Release()
+    const {
+  const rtc::RefCountReleaseStatus status = ref_count_.DecRef();
+  if (status == rtc::RefCountReleaseStatus::kDroppedLastRef) {
+    // Once returned, the buffer may be deleted on another thread, dropping its
+    // reference to the sub-pool.
+    rtc::scoped_refptr<SubPool<BufferT>> sub_pool = sub_pool_;
+    sub_pool->Return(const_cast<PooledBuffer<BufferT>*>(this));
+  }
+  return status;
+}
+
 I420BufferPool::I420BufferPool() : I420BufferPool(false) {}
 I420BufferPool::I420BufferPool(bool zero_initialize)
     : I420BufferPool(zero_initialize, std::numeric_limits<size_t>::max()) {}
 I420BufferPool::I420BufferPool(bool zero_initialize,
                                size_t max_number_of_buffers)
+    : I420BufferPool(zero_initialize,
+                     max_number_of_buffers,
+                     GetDefaultBufferAllocator()) {}
+I420BufferPool::I420BufferPool(bool zero_initialize,
+                               size_t max_number_of_buffers,
+                               BufferAllocator* allocator)
     : zero_initialize_(zero_initialize),
+      allocator_(allocator),
       max_number_of_buffers_(max_number_of_buffers) {}
-I420BufferPool::~I420BufferPool() = default;
+I420BufferPool::~I420BufferPool() {
+  Release();
+}
 
 void I420BufferPool::Release() {
-  buffers_.clear();
+  for (const auto& sub_pool : sub_pools_)
+    sub_pool->Detach();
+  sub_pools_.clear();
+  for (const auto& sub_pool : nv12_sub_pools_)
+    sub_pool->Detach();
+  nv12_sub_pools_.clear();
 }
 
 bool I420BufferPool::Resize(size_t max_number_of_buffers) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
-  size_t used_buffers_count = 0;
-  for (const rtc::scoped_refptr<PooledI420Buffer>& buffer : buffers_) {
-    // If the buffer is in use, the ref count will be >= 2, one from the list we
-    // are looping over and one from the application. If the ref count is 1,
-    // then the list we are looping over holds the only reference and it's safe
-    // to reuse.
-    if (!buffer->HasOneRef()) {
-      used_buffers_count++;
+  for (const auto& sub_pool : sub_pools_) {
+    if (sub_pool->NumBuffersInUse() > max_number_of_buffers) {
+      return false;
     }
   }
-  if (used_buffers_count > max_number_of_buffers) {
-    return false;
-  }
-  max_number_of_buffers_ = max_number_of_buffers;
-
-  size_t buffers_to_purge = buffers_.size() - max_number_of_buffers_;
-  auto iter = buffers_.begin();
-  while (iter != buffers_.end() && buffers_to_purge > 0) {
-    if ((*iter)->HasOneRef()) {
-      iter = buffers_.erase(iter);
-      buffers_to_purge--;
-    } else {
-      ++iter;
+  for (const auto& sub_pool : nv12_sub_pools_) {
+    if (sub_pool->NumBuffersInUse() > max_number_of_buffers) {
+      return false;
     }
   }
+  max_number_of_buffers_ = max_number_of_buffers;
+  for (const auto& sub_pool : sub_pools_)
+    sub_pool->Shrink(max_number_of_buffers_);
+  for (const auto& sub_pool : nv12_sub_pools_)
+    sub_pool->Shrink(max_number_of_buffers_);
   return true;
 }
 
@@ -70,37 +266,60 @@ rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
                                                             int stride_y,
                                                             int stride_u,
                                                             int stride_v) {
+  return GetBuffer(&sub_pools_, width, height, stride_y, stride_u, stride_v);
+}
+
+rtc::scoped_refptr<NV12Buffer> I420BufferPool::CreateNV12Buffer(int width,
+                                                                int height) {
+  // Default stride_y is width, default uv stride is width rounded up to even.
+  return CreateNV12Buffer(width, height, width, width + width % 2);
+}
+
+rtc::scoped_refptr<NV12Buffer> I420BufferPool::CreateNV12Buffer(
+    int width,
+    int height,
+    int stride_y,
+    int stride_uv) {
+  return GetBuffer(&nv12_sub_pools_, width, height, stride_y, stride_uv, 0);
+}
+
+template <typename BufferT>
+rtc::scoped_refptr<BufferT> I420BufferPool::GetBuffer(
+    SubPools<BufferT>* sub_pools,
+    int width,
+    int height,
+    int stride_y,
+    int stride_u,
+    int stride_v) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
-  // Release buffers with wrong resolution.
-  for (auto it = buffers_.begin(); it != buffers_.end();) {
-    const auto& buffer = *it;
-    if (buffer->width() != width || buffer->height() != height ||
-        buffer->StrideY() != stride_y || buffer->StrideU() != stride_u ||
-        buffer->StrideV() != stride_v) {
-      it = buffers_.erase(it);
-    } else {
-      ++it;
+  ++num_requests_;
+  auto it = std::find_if(sub_pools->begin(), sub_pools->end(),
+                         [&](const rtc::scoped_refptr<SubPool<BufferT>>& pool) {
+                           return pool->Matches(width, height, stride_y,
+                                                stride_u, stride_v);
+                         });
+  if (it != sub_pools->end()) {
+    std::rotate(sub_pools->begin(), it, it + 1);
+  } else {
+    if (sub_pools->size() >= kMaxNumberOfSubPools) {
+      sub_pools->back()->Detach();
+      sub_pools->pop_back();
     }
+    sub_pools->insert(sub_pools->begin(),
+                      new rtc::RefCountedObject<SubPool<BufferT>>(
+                          width, height, stride_y, stride_u, stride_v));
   }
-  // Look for a free buffer.
-  for (const rtc::scoped_refptr<PooledI420Buffer>& buffer : buffers_) {
-    // If the buffer is in use, the ref count will be >= 2, one from the list we
-    // are looping over and one from the application. If the ref count is 1,
-    // then the list we are looping over holds the only reference and it's safe
-    // to reuse.
-    if (buffer->HasOneRef())
-      return buffer;
+  sub_pools->front()->set_last_request(num_requests_);
+
+  // Release sub-pools with resolutions no longer asked for.
+  while (sub_pools->size() > 1 &&
+         num_requests_ - sub_pools->back()->last_request() > kMaxIdleRequests) {
+    sub_pools->back()->Detach();
+    sub_pools->pop_back();
   }
 
-  if (buffers_.size() >= max_number_of_buffers_)
-    return nullptr;
-  // Allocate new buffer.
-  rtc::scoped_refptr<PooledI420Buffer> buffer =
-      new PooledI420Buffer(width, height, stride_y, stride_u, stride_v);
-  if (zero_initialize_)
-    buffer->InitializeData();
-  buffers_.push_back(buffer);
-  return buffer;
+  return sub_pools->front()->GetBuffer(max_number_of_buffers_,
+                                       zero_initialize_, allocator_);
 }
 
 }  // namespace webrtc
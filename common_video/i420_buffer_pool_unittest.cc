@@ -13,9 +13,14 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "api/scoped_refptr.h"
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video/video_frame_buffer.h"
+#include "rtc_base/platform_thread.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -114,4 +119,116 @@ TEST(TestI420BufferPool, MaxNumberOfBuffers) {
   EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
 }
 
+TEST(TestI420BufferPool, KeepsBuffersOfSeveralResolutions) {
+  I420BufferPool pool;
+  auto buffer = pool.CreateBuffer(16, 16);
+  const uint8_t* y_ptr = buffer->DataY();
+  buffer = nullptr;
+  // Buffers of another resolution don't purge the 16x16 buffer.
+  auto other_buffer = pool.CreateBuffer(32, 32);
+  other_buffer = nullptr;
+  buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+}
+
+TEST(TestI420BufferPool, PurgesIdleResolutions) {
+  I420BufferPool pool(/*zero_initialize=*/false, 1);
+  auto buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
+  for (int i = 0; i < 100; ++i)
+    pool.CreateBuffer(32, 32);
+  // |buffer| is still in use, but belongs to a purged sub-pool and no longer
+  // counts towards the limit.
+  EXPECT_NE(nullptr, pool.CreateBuffer(16, 16).get());
+  EXPECT_EQ(16, buffer->width());
+}
+
+TEST(TestI420BufferPool, MaxNumberOfBuffersIsPerResolution) {
+  I420BufferPool pool(false, 1);
+  auto buffer1 = pool.CreateBuffer(16, 16);
+  auto buffer2 = pool.CreateBuffer(32, 32);
+  EXPECT_NE(nullptr, buffer1.get());
+  EXPECT_NE(nullptr, buffer2.get());
+  EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
+  EXPECT_EQ(nullptr, pool.CreateBuffer(32, 32).get());
+}
+
+TEST(TestI420BufferPool, ResizeFailsIfBuffersInUse) {
+  I420BufferPool pool;
+  auto buffer1 = pool.CreateBuffer(16, 16);
+  auto buffer2 = pool.CreateBuffer(16, 16);
+  EXPECT_FALSE(pool.Resize(1));
+  buffer2 = nullptr;
+  EXPECT_TRUE(pool.Resize(1));
+  EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
+}
+
+TEST(TestI420BufferPool, ReusesBuffersReleasedOnOtherThreads) {
+  constexpr int kNumBuffers = 4;
+  I420BufferPool pool(/*zero_initialize=*/false, kNumBuffers);
+  std::vector<rtc::scoped_refptr<I420Buffer>> buffers;
+  for (int i = 0; i < kNumBuffers; ++i)
+    buffers.push_back(pool.CreateBuffer(16, 16));
+  std::vector<const uint8_t*> y_ptrs;
+  for (const auto& buffer : buffers)
+    y_ptrs.push_back(buffer->DataY());
+
+  rtc::PlatformThread thread(
+      [](void* obj) {
+        static_cast<std::vector<rtc::scoped_refptr<I420Buffer>>*>(obj)
+            ->clear();
+      },
+      &buffers, "ReleaseThread");
+  thread.Start();
+  thread.Stop();
+
+  for (int i = 0; i < kNumBuffers; ++i) {
+    auto buffer = pool.CreateBuffer(16, 16);
+    ASSERT_TRUE(buffer);
+    EXPECT_NE(std::find(y_ptrs.begin(), y_ptrs.end(), buffer->DataY()),
+              y_ptrs.end());
+    buffers.push_back(buffer);
+  }
+}
+
+TEST(TestI420BufferPool, BuffersOutliveRelease) {
+  I420BufferPool pool;
+  auto buffer = pool.CreateBuffer(16, 16);
+  pool.Release();
+  EXPECT_EQ(16, buffer->width());
+  memset(buffer->MutableDataY(), 0xA5, 16 * buffer->StrideY());
+  buffer = nullptr;
+  EXPECT_TRUE(pool.CreateBuffer(16, 16));
+}
+
+TEST(TestI420BufferPool, SimpleNV12FrameReuse) {
+  I420BufferPool pool;
+  auto buffer = pool.CreateNV12Buffer(15, 16);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12, buffer->type());
+  EXPECT_EQ(15, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+  // The default UV stride is width rounded up to even.
+  EXPECT_EQ(15, buffer->StrideY());
+  EXPECT_EQ(16, buffer->StrideUV());
+  const uint8_t* y_ptr = buffer->DataY();
+  const uint8_t* uv_ptr = buffer->DataUV();
+  buffer = nullptr;
+  buffer = pool.CreateNV12Buffer(15, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(uv_ptr, buffer->DataUV());
+}
+
+TEST(TestI420BufferPool, NV12AndI420BuffersAreCountedSeparately) {
+  I420BufferPool pool(/*zero_initialize=*/false, 1);
+  auto i420_buffer = pool.CreateBuffer(16, 16);
+  auto nv12_buffer = pool.CreateNV12Buffer(16, 16);
+  EXPECT_NE(nullptr, i420_buffer.get());
+  EXPECT_NE(nullptr, nv12_buffer.get());
+  EXPECT_EQ(nullptr, pool.CreateNV12Buffer(16, 16).get());
+  EXPECT_FALSE(pool.Resize(0));
+  nv12_buffer = nullptr;
+  i420_buffer = nullptr;
+  EXPECT_TRUE(pool.Resize(1));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/i420_pyramid_scaler.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "api/video/i420_buffer.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+int64_t Area(int width, int height) {
+  return static_cast<int64_t>(width) * height;
+}
+
+}  // namespace
+
+I420PyramidScaler::I420PyramidScaler() = default;
+I420PyramidScaler::~I420PyramidScaler() = default;
+
+void I420PyramidScaler::SetResolutions(
+    const std::vector<Resolution>& resolutions) {
+  bool changed = resolutions.size() != resolutions_.size();
+  for (size_t i = 0; !changed && i < resolutions.size(); ++i) {
+    changed = resolutions[i].width != resolutions_[i].width ||
+              resolutions[i].height != resolutions_[i].height;
+  }
+  if (!changed)
+    return;
+
+  resolutions_ = resolutions;
+  order_.resize(resolutions_.size());
+  pools_.clear();
+  for (size_t i = 0; i < resolutions_.size(); ++i) {
+    RTC_DCHECK_GT(resolutions_[i].width, 0);
+    RTC_DCHECK_GT(resolutions_[i].height, 0);
+    order_[i] = i;
+    pools_.push_back(std::make_unique<I420BufferPool>());
+  }
+  std::stable_sort(order_.begin(), order_.end(), [this](size_t a, size_t b) {
+    return Area(resolutions_[a].width, resolutions_[a].height) >
+           Area(resolutions_[b].width, resolutions_[b].height);
+  });
+}
+
+std::vector<rtc::scoped_refptr<I420BufferInterface>> I420PyramidScaler::Scale(
+    const rtc::scoped_refptr<I420BufferInterface>& source,
+    const std::vector<bool>& wanted) {
+  RTC_DCHECK(source);
+  RTC_DCHECK_EQ(wanted.size(), resolutions_.size());
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> levels(
+      resolutions_.size());
+  for (size_t level : order_) {
+    if (!wanted[level])
+      continue;
+    const Resolution& resolution = resolutions_[level];
+
+    // Scale from the smallest buffer that is at least as large in both
+    // dimensions, or from the source if there is none.
+    const rtc::scoped_refptr<I420BufferInterface>* input = &source;
+    for (size_t larger : order_) {
+      if (larger == level)
+        break;
+      const rtc::scoped_refptr<I420BufferInterface>& candidate =
+          levels[larger];
+      if (candidate && candidate->width() >= resolution.width &&
+          candidate->height() >= resolution.height) {
+        input = &candidate;
+      }
+    }
+
+    if ((*input)->width() == resolution.width &&
+        (*input)->height() == resolution.height) {
+      levels[level] = *input;
+      continue;
+    }
+    rtc::scoped_refptr<I420Buffer> buffer =
+        pools_[level]->CreateBuffer(resolution.width, resolution.height);
+    buffer->ScaleFrom(**input);
+    levels[level] = buffer;
+  }
+  return levels;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/i420_pyramid_scaler.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame_buffer.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+rtc::scoped_refptr<I420BufferInterface> CreateUniformBuffer(int width,
+                                                            int height,
+                                                            uint8_t y,
+                                                            uint8_t u,
+                                                            uint8_t v) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  memset(buffer->MutableDataY(), y, buffer->StrideY() * height);
+  memset(buffer->MutableDataU(), u, buffer->StrideU() * buffer->ChromaHeight());
+  memset(buffer->MutableDataV(), v, buffer->StrideV() * buffer->ChromaHeight());
+  return buffer;
+}
+
+bool PlaneIs(const uint8_t* data, int stride, int width, int height,
+             uint8_t value) {
+  for (int row = 0; row < height; ++row) {
+    for (int col = 0; col < width; ++col) {
+      if (data[row * stride + col] != value)
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(TestI420PyramidScaler, ReturnsLevelsInConfiguredOrder) {
+  I420PyramidScaler scaler;
+  scaler.SetResolutions({{320, 180}, {1280, 720}, {640, 360}});
+  auto source = CreateUniformBuffer(1280, 720, 0, 128, 128);
+
+  auto levels = scaler.Scale(source, {true, true, true});
+  ASSERT_EQ(3u, levels.size());
+  EXPECT_EQ(320, levels[0]->width());
+  EXPECT_EQ(180, levels[0]->height());
+  EXPECT_EQ(1280, levels[1]->width());
+  EXPECT_EQ(720, levels[1]->height());
+  EXPECT_EQ(640, levels[2]->width());
+  EXPECT_EQ(360, levels[2]->height());
+}
+
+TEST(TestI420PyramidScaler, PassesSourceThroughAtSourceResolution) {
+  I420PyramidScaler scaler;
+  scaler.SetResolutions({{640, 360}, {320, 180}});
+  auto source = CreateUniformBuffer(640, 360, 0, 128, 128);
+
+  auto levels = scaler.Scale(source, {true, true});
+  EXPECT_EQ(source.get(), levels[0].get());
+  EXPECT_NE(source.get(), levels[1].get());
+}
+
+TEST(TestI420PyramidScaler, SkipsUnwantedLevels) {
+  I420PyramidScaler scaler;
+  scaler.SetResolutions({{640, 360}, {320, 180}, {160, 90}});
+  auto source = CreateUniformBuffer(1280, 720, 0, 128, 128);
+
+  auto levels = scaler.Scale(source, {false, true, false});
+  EXPECT_FALSE(levels[0]);
+  ASSERT_TRUE(levels[1]);
+  EXPECT_EQ(320, levels[1]->width());
+  EXPECT_FALSE(levels[2]);
+}
+
+TEST(TestI420PyramidScaler, ReusesReleasedBuffers) {
+  I420PyramidScaler scaler;
+  scaler.SetResolutions({{640, 360}, {320, 180}});
+  auto source = CreateUniformBuffer(1280, 720, 0, 128, 128);
+
+  auto levels = scaler.Scale(source, {true, true});
+  const uint8_t* y_ptr_0 = levels[0]->DataY();
+  const uint8_t* y_ptr_1 = levels[1]->DataY();
+  levels.clear();
+
+  levels = scaler.Scale(source, {true, true});
+  EXPECT_EQ(y_ptr_0, levels[0]->DataY());
+  EXPECT_EQ(y_ptr_1, levels[1]->DataY());
+}
+
+TEST(TestI420PyramidScaler, DoesNotReuseBuffersStillInUse) {
+  I420PyramidScaler scaler;
+  scaler.SetResolutions({{320, 180}});
+  auto source = CreateUniformBuffer(1280, 720, 0, 128, 128);
+
+  auto first = scaler.Scale(source, {true});
+  auto second = scaler.Scale(source, {true});
+  EXPECT_NE(first[0]->DataY(), second[0]->DataY());
+}
+
+TEST(TestI420PyramidScaler, ScalesEveryLevelFromSourceContent) {
+  I420PyramidScaler scaler;
+  scaler.SetResolutions({{640, 360}, {320, 180}, {160, 90}});
+  auto source = CreateUniformBuffer(1280, 720, 16, 64, 192);
+
+  auto levels = scaler.Scale(source, {true, true, true});
+  for (const auto& level : levels) {
+    EXPECT_TRUE(PlaneIs(level->DataY(), level->StrideY(), level->width(),
+                        level->height(), 16));
+    EXPECT_TRUE(PlaneIs(level->DataU(), level->StrideU(), level->ChromaWidth(),
+                        level->ChromaHeight(), 64));
+    EXPECT_TRUE(PlaneIs(level->DataV(), level->StrideV(), level->ChromaWidth(),
+                        level->ChromaHeight(), 192));
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_VIDEO_INCLUDE_ENCODED_IMAGE_BUFFER_POOL_H_
+#define COMMON_VIDEO_INCLUDE_ENCODED_IMAGE_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api/scoped_refptr.h"
+#include "api/video/encoded_image.h"
+#include "rtc_base/memory/buffer_allocator.h"
+
+namespace webrtc {
+
+// Recycles the buffers that received frames are assembled into. Buffers are
+// pooled by capacity, in powers of two from kMinCapacity to
+// kMaxPooledCapacity, and a buffer serves any frame that fits, so that the
+// frames of a stream, whose sizes vary from frame to frame, keep reusing a
+// handful of buffers. Larger frames are allocated as usual. When the last
+// reference to a buffer goes away, on whichever thread that happens (e.g. the
+// decoder's), its storage goes back to the pool instead of being freed.
+//
+// The pool may be destroyed while buffers created by it are still in use.
+// Thread safe.
+class EncodedImageBufferPool {
+ public:
+  struct Stats {
+    // Number of buffers that reused pooled storage.
+    int64_t hits = 0;
+    // Number of buffers that needed a new allocation.
+    int64_t misses = 0;
+  };
+
+  static constexpr size_t kMinCapacity = 4 * 1024;
+  static constexpr size_t kMaxPooledCapacity = 4 * 1024 * 1024;
+  static constexpr size_t kDefaultMaxFreeBuffersPerCapacity = 16;
+
+  EncodedImageBufferPool();
+  // At most |max_free_buffers_per_capacity| unused buffers are kept per
+  // capacity; storage returned beyond that is freed.
+  explicit EncodedImageBufferPool(size_t max_free_buffers_per_capacity);
+  // Allocates the pooled buffers with |allocator|, e.g. to place them on the
+  // NUMA node of the threads that process them. |allocator| must outlive the
+  // buffers.
+  EncodedImageBufferPool(size_t max_free_buffers_per_capacity,
+                         BufferAllocator* allocator);
+  ~EncodedImageBufferPool();
+
+  EncodedImageBufferPool(const EncodedImageBufferPool&) = delete;
+  EncodedImageBufferPool& operator=(const EncodedImageBufferPool&) = delete;
+
+  // Returns a buffer of |size| uninitialized bytes.
+  rtc::scoped_refptr<EncodedImageBufferInterface> Create(size_t size);
+
+  Stats GetStats() const;
+
+ private:
+  class Core;
+  class PooledBuffer;
+
+  const rtc::scoped_refptr<Core> core_;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_VIDEO_INCLUDE_ENCODED_IMAGE_BUFFER_POOL_H_
@@ -12,33 +12,48 @@
 #define COMMON_VIDEO_INCLUDE_I420_BUFFER_POOL_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
-#include <list>
+#include <vector>
 
 #include "api/scoped_refptr.h"
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
+#include "rtc_base/memory/buffer_allocator.h"
 #include "rtc_base/race_checker.h"
-#include "rtc_base/ref_counted_object.h"
 
 namespace webrtc {
 
-// Simple buffer pool to avoid unnecessary allocations of I420Buffer objects.
-// The pool manages the memory of the I420Buffer returned from CreateBuffer.
-// When the I420Buffer is destructed, the memory is returned to the pool for use
-// by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
-// Note that CreateBuffer will crash if more than kMaxNumberOfFramesBeforeCrash
-// are created. This is to prevent memory leaks where frames are not returned.
+// Simple buffer pool to avoid unnecessary allocations of I420Buffer and
+// NV12Buffer objects. The pool manages the memory of the buffers returned from
+// CreateBuffer and CreateNV12Buffer. When a buffer is destructed, the memory is
+// returned to the pool for use by subsequent calls. Buffers are kept in a
+// sub-pool per format, resolution and stride, so that a few resolutions in use
+// at the same time, e.g. with simulcast or while adapting, don't purge each
+// other's buffers. Sub-pools that haven't been asked for a buffer in a while
+// are purged. Note that CreateBuffer will crash if more than
+// kMaxNumberOfFramesBeforeCrash are created. This is to prevent memory leaks
+// where frames are not returned.
+//
+// CreateBuffer, Resize and Release must be called sequentially, but buffers may
+// be released on any thread. Released buffers are returned to their sub-pool
+// through a lock-free list.
 class I420BufferPool {
  public:
   I420BufferPool();
   explicit I420BufferPool(bool zero_initialize);
   I420BufferPool(bool zero_initialze, size_t max_number_of_buffers);
+  // Allocates the buffers with |allocator|, e.g. to place them on the NUMA
+  // node of the threads that process them. |allocator| must outlive the
+  // buffers.
+  I420BufferPool(bool zero_initialize,
+                 size_t max_number_of_buffers,
+                 BufferAllocator* allocator);
   ~I420BufferPool();
 
   // Returns a buffer from the pool. If no suitable buffer exist in the pool
-  // and there are less than |max_number_of_buffers| pending, a buffer is
-  // created. Returns null otherwise.
+  // and there are less than |max_number_of_buffers| pending with the same
+  // resolution, a buffer is created. Returns null otherwise.
   rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height);
 
   // Returns a buffer from the pool with the explicitly specified stride.
@@ -48,29 +63,55 @@ class I420BufferPool {
                                               int stride_u,
                                               int stride_v);
 
-  // Changes the max amount of buffers in the pool to the new value.
+  // Returns an NV12 buffer from the pool, with the same limits as
+  // CreateBuffer. NV12 buffers are kept in sub-pools of their own.
+  rtc::scoped_refptr<NV12Buffer> CreateNV12Buffer(int width, int height);
+  rtc::scoped_refptr<NV12Buffer> CreateNV12Buffer(int width,
+                                                  int height,
+                                                  int stride_y,
+                                                  int stride_uv);
+
+  // Changes the max amount of buffers per resolution to the new value.
   // Returns true if change was successful and false if the amount of already
-  // allocated buffers is bigger than new value.
+  // allocated buffers of some resolution is bigger than new value.
   bool Resize(size_t max_number_of_buffers);
 
-  // Clears buffers_ and detaches the thread checker so that it can be reused
-  // later from another thread.
+  // Clears the sub-pools so that the pool can be reused later from another
+  // thread.
   void Release();
 
  private:
-  // Explicitly use a RefCountedObject to get access to HasOneRef,
-  // needed by the pool to check exclusive access.
-  using PooledI420Buffer = rtc::RefCountedObject<I420Buffer>;
+  template <typename BufferT>
+  class PooledBuffer;
+  template <typename BufferT>
+  class SubPool;
+  template <typename BufferT>
+  using SubPools = std::vector<rtc::scoped_refptr<SubPool<BufferT>>>;
+
+  // Finds or adds the sub-pool for the resolution and strides, and returns a
+  // buffer from it. Unused strides are 0.
+  template <typename BufferT>
+  rtc::scoped_refptr<BufferT> GetBuffer(SubPools<BufferT>* sub_pools,
+                                        int width,
+                                        int height,
+                                        int stride_y,
+                                        int stride_u,
+                                        int stride_v);
 
   rtc::RaceChecker race_checker_;
-  std::list<rtc::scoped_refptr<PooledI420Buffer>> buffers_;
+  // Most recently used first.
+  SubPools<I420Buffer> sub_pools_;
+  SubPools<NV12Buffer> nv12_sub_pools_;
+  // Number of buffer requests, used to find idle sub-pools.
+  uint64_t num_requests_ = 0;
   // If true, newly allocated buffers are zero-initialized. Note that recycled
   // buffers are not zero'd before reuse. This is required of buffers used by
   // FFmpeg according to http://crbug.com/390941, which only requires it for the
   // initial allocation (as shown by FFmpeg's own buffer allocation code). It
   // has to do with "Use-of-uninitialized-value" on "Linux_msan_chrome".
   const bool zero_initialize_;
-  // Max number of buffers this pool can have pending.
+  BufferAllocator* const allocator_;
+  // Max number of buffers of one resolution this pool can have pending.
   size_t max_number_of_buffers_;
 };
 
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_VIDEO_INCLUDE_I420_PYRAMID_SCALER_H_
+#define COMMON_VIDEO_INCLUDE_I420_PYRAMID_SCALER_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "api/video/video_frame_buffer.h"
+#include "common_video/include/i420_buffer_pool.h"
+
+namespace webrtc {
+
+// Scales one source buffer to a set of levels, such as the layers of a
+// simulcast encoding, reading the full resolution source only once. Larger
+// levels are produced first, and each level is scaled from the smallest buffer
+// produced so far that is at least as large in both dimensions, so with the
+// usual 2:1 layer ratios each level is derived from the one above it.
+//
+// Each level has its own I420BufferPool, so output buffers are reused once
+// released. Not thread safe.
+class I420PyramidScaler {
+ public:
+  struct Resolution {
+    int width;
+    int height;
+  };
+
+  I420PyramidScaler();
+  ~I420PyramidScaler();
+
+  // Sets the level resolutions, in any order. Drops the pooled buffers if they
+  // changed.
+  void SetResolutions(const std::vector<Resolution>& resolutions);
+  size_t num_levels() const { return resolutions_.size(); }
+
+  // Returns one buffer per level, scaled from |source|. Levels for which
+  // |wanted| is false are null, and are not used as a source for smaller
+  // levels. Levels with the resolution of |source| get |source| itself.
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> Scale(
+      const rtc::scoped_refptr<I420BufferInterface>& source,
+      const std::vector<bool>& wanted);
+
+ private:
+  std::vector<Resolution> resolutions_;
+  // Level indices, largest resolution first.
+  std::vector<size_t> order_;
+  std::vector<std::unique_ptr<I420BufferPool>> pools_;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_VIDEO_INCLUDE_I420_PYRAMID_SCALER_H_
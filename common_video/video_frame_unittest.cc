@@ -453,6 +453,19 @@ TEST_P(TestPlanarYuvBuffer, CropAndScale16x9) {
   CheckCrop(*scaled_buffer->ToI420(), 0.0, 0.125, 1.0, 0.75);
 }
 
+TEST_P(TestPlanarYuvBuffer, CropAndScaleWithDefaultImplementation) {
+  rtc::scoped_refptr<PlanarYuvBuffer> buf =
+      CreateGradient(GetParam(), 200, 100);
+
+  // Center cropping, then scaling by half.
+  rtc::scoped_refptr<VideoFrameBuffer> scaled_buffer =
+      buf->CropAndScale(50, 0, 100, 100, 50, 50);
+  ASSERT_TRUE(scaled_buffer);
+  EXPECT_EQ(50, scaled_buffer->width());
+  EXPECT_EQ(50, scaled_buffer->height());
+  CheckCrop(*scaled_buffer->ToI420(), 0.25, 0.0, 0.5, 1.0);
+}
+
 TEST_P(TestPlanarYuvBuffer, PastesIntoBuffer) {
   const int kOffsetx = 20;
   const int kOffsety = 30;
@@ -29,6 +29,7 @@ const uint32_t kEventMaxWaitTimeMs = 200;
 const uint32_t kMinRenderDelayMs = 10;
 const uint32_t kMaxRenderDelayMs = 500;
 const size_t kMaxIncomingFramesBeforeLogged = 100;
+const size_t kInitialRingSize = 8;
 
 uint32_t EnsureValidRenderDelay(uint32_t render_delay) {
   return (render_delay < kMinRenderDelayMs || render_delay > kMaxRenderDelayMs)
@@ -38,10 +39,11 @@ uint32_t EnsureValidRenderDelay(uint32_t render_delay) {
 }  // namespace
 
 VideoRenderFrames::VideoRenderFrames(uint32_t render_delay_ms)
-    : render_delay_ms_(EnsureValidRenderDelay(render_delay_ms)) {}
+    : incoming_frames_(kInitialRingSize),
+      render_delay_ms_(EnsureValidRenderDelay(render_delay_ms)) {}
 
 VideoRenderFrames::~VideoRenderFrames() {
-  frames_dropped_ += incoming_frames_.size();
+  frames_dropped_ += num_frames_;
   RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.DroppedFrames.RenderQueue",
                             frames_dropped_);
   RTC_LOG(LS_INFO) << "WebRTC.Video.DroppedFrames.RenderQueue "
@@ -53,7 +55,7 @@ int32_t VideoRenderFrames::AddFrame(VideoFrame&& new_frame) {
 
   // Drop old frames only when there are other frames in the queue, otherwise, a
   // really slow system never renders any frames.
-  if (!incoming_frames_.empty() &&
+  if (num_frames_ > 0 &&
       new_frame.render_time_ms() + kOldRenderTimestampMS < time_now) {
     RTC_LOG(LS_WARNING) << "Too old frame, timestamp=" << new_frame.timestamp();
     ++frames_dropped_;
@@ -78,39 +80,63 @@ int32_t VideoRenderFrames::AddFrame(VideoFrame&& new_frame) {
   }
 
   last_render_time_ms_ = new_frame.render_time_ms();
-  incoming_frames_.emplace_back(std::move(new_frame));
+  if (num_frames_ == incoming_frames_.size()) {
+    // Full, move the frames in order to a ring twice the size.
+    const size_t num_frames = num_frames_;
+    std::vector<absl::optional<VideoFrame>> frames(2 * num_frames);
+    for (size_t i = 0; i < num_frames; ++i)
+      frames[i] = PopOldestFrame();
+    incoming_frames_ = std::move(frames);
+    oldest_frame_ = 0;
+    num_frames_ = num_frames;
+  }
+  incoming_frames_[(oldest_frame_ + num_frames_) % incoming_frames_.size()]
+      .emplace(std::move(new_frame));
+  ++num_frames_;
 
-  if (incoming_frames_.size() > kMaxIncomingFramesBeforeLogged) {
-    RTC_LOG(LS_WARNING) << "Stored incoming frames: "
-                        << incoming_frames_.size();
+  if (num_frames_ > kMaxIncomingFramesBeforeLogged) {
+    RTC_LOG(LS_WARNING) << "Stored incoming frames: " << num_frames_;
   }
-  return static_cast<int32_t>(incoming_frames_.size());
+  return static_cast<int32_t>(num_frames_);
 }
 
 absl::optional<VideoFrame> VideoRenderFrames::FrameToRender() {
   absl::optional<VideoFrame> render_frame;
   // Get the newest frame that can be released for rendering.
-  while (!incoming_frames_.empty() && TimeToNextFrameRelease() <= 0) {
+  while (num_frames_ > 0 && TimeToNextFrameRelease() <= 0) {
     if (render_frame) {
       ++frames_dropped_;
     }
-    render_frame = std::move(incoming_frames_.front());
-    incoming_frames_.pop_front();
+    render_frame = PopOldestFrame();
   }
   return render_frame;
 }
 
 uint32_t VideoRenderFrames::TimeToNextFrameRelease() {
-  if (incoming_frames_.empty()) {
+  if (num_frames_ == 0) {
     return kEventMaxWaitTimeMs;
   }
-  const int64_t time_to_release = incoming_frames_.front().render_time_ms() -
-                                  render_delay_ms_ - rtc::TimeMillis();
+  const int64_t time_to_release =
+      OldestFrame().render_time_ms() - render_delay_ms_ - rtc::TimeMillis();
   return time_to_release < 0 ? 0u : static_cast<uint32_t>(time_to_release);
 }
 
 bool VideoRenderFrames::HasPendingFrames() const {
-  return !incoming_frames_.empty();
+  return num_frames_ > 0;
+}
+
+VideoFrame& VideoRenderFrames::OldestFrame() {
+  RTC_DCHECK_GT(num_frames_, 0);
+  return *incoming_frames_[oldest_frame_];
+}
+
+VideoFrame VideoRenderFrames::PopOldestFrame() {
+  VideoFrame frame = std::move(OldestFrame());
+  // Reset the slot so that it doesn't hold on to the frame buffer.
+  incoming_frames_[oldest_frame_].reset();
+  oldest_frame_ = (oldest_frame_ + 1) % incoming_frames_.size();
+  --num_frames_;
+  return frame;
 }
 
 }  // namespace webrtc
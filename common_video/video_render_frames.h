@@ -14,7 +14,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <list>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "api/video/video_frame.h"
@@ -40,8 +40,15 @@ class VideoRenderFrames {
   bool HasPendingFrames() const;
 
  private:
-  // Sorted list with framed to be rendered, oldest first.
-  std::list<VideoFrame> incoming_frames_;
+  VideoFrame& OldestFrame();
+  VideoFrame PopOldestFrame();
+
+  // Ring of frames to be rendered, sorted oldest first. The |num_frames_|
+  // frames from |oldest_frame_| on are set; the ring only grows when full, so
+  // queueing frames doesn't allocate once it has reached its working size.
+  std::vector<absl::optional<VideoFrame>> incoming_frames_;
+  size_t oldest_frame_ = 0;
+  size_t num_frames_ = 0;
 
   // Estimated delay from a frame is released until it's rendered.
   const uint32_t render_delay_ms_;
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/video_render_frames.h"
+
+#include "api/units/time_delta.h"
+#include "api/video/i420_buffer.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kRenderDelayMs = 10;
+
+VideoFrame CreateFrame(uint32_t timestamp, int64_t render_time_ms) {
+  return VideoFrame::Builder()
+      .set_video_frame_buffer(I420Buffer::Create(2, 2))
+      .set_timestamp_rtp(timestamp)
+      .set_timestamp_ms(render_time_ms)
+      .build();
+}
+
+TEST(VideoRenderFramesTest, ReleasesFramesInOrderWhenDue) {
+  rtc::ScopedFakeClock clock;
+  clock.SetTime(Timestamp::Millis(1000));
+  VideoRenderFrames frames(kRenderDelayMs);
+  EXPECT_FALSE(frames.HasPendingFrames());
+
+  // More frames than the ring initially holds.
+  const int64_t start_ms = rtc::TimeMillis();
+  for (uint32_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(static_cast<int32_t>(i + 1),
+              frames.AddFrame(CreateFrame(i, start_ms + 100 + 10 * i)));
+  }
+  EXPECT_EQ(100u - kRenderDelayMs, frames.TimeToNextFrameRelease());
+  EXPECT_FALSE(frames.FrameToRender());
+
+  for (uint32_t i = 0; i < 20; ++i) {
+    clock.AdvanceTime(TimeDelta::Millis(i == 0 ? 100 - kRenderDelayMs : 10));
+    absl::optional<VideoFrame> frame = frames.FrameToRender();
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(i, frame->timestamp());
+  }
+  EXPECT_FALSE(frames.HasPendingFrames());
+}
+
+TEST(VideoRenderFramesTest, ReleasesNewestDueFrame) {
+  rtc::ScopedFakeClock clock;
+  clock.SetTime(Timestamp::Millis(1000));
+  VideoRenderFrames frames(kRenderDelayMs);
+  const int64_t start_ms = rtc::TimeMillis();
+  for (uint32_t i = 0; i < 6; ++i)
+    frames.AddFrame(CreateFrame(i, start_ms + 10 * i));
+
+  // The first five frames are due, only the last of them is rendered.
+  clock.AdvanceTime(TimeDelta::Millis(40 - kRenderDelayMs));
+  absl::optional<VideoFrame> frame = frames.FrameToRender();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(4u, frame->timestamp());
+
+  // Queue enough frames for the ring to wrap around and then grow.
+  for (uint32_t i = 6; i < 14; ++i)
+    EXPECT_GT(frames.AddFrame(CreateFrame(i, start_ms + 10 * i)), 0);
+  for (uint32_t i = 5; i < 14; ++i) {
+    clock.AdvanceTime(TimeDelta::Millis(10));
+    frame = frames.FrameToRender();
+    ASSERT_TRUE(frame);
+    EXPECT_EQ(i, frame->timestamp());
+  }
+  EXPECT_FALSE(frames.HasPendingFrames());
+}
+
+TEST(VideoRenderFramesTest, DropsFramesOutOfOrder) {
+  rtc::ScopedFakeClock clock;
+  clock.SetTime(Timestamp::Millis(1000));
+  VideoRenderFrames frames(kRenderDelayMs);
+  const int64_t start_ms = rtc::TimeMillis();
+  EXPECT_EQ(1, frames.AddFrame(CreateFrame(0, start_ms + 20)));
+  EXPECT_EQ(-1, frames.AddFrame(CreateFrame(1, start_ms + 10)));
+  EXPECT_EQ(2, frames.AddFrame(CreateFrame(2, start_ms + 30)));
+}
+
+}  // namespace
+}  // namespace webrtc
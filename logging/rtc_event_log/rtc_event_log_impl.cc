@@ -10,6 +10,7 @@
 
 #include "logging/rtc_event_log/rtc_event_log_impl.h"
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -35,6 +36,9 @@ constexpr size_t kMaxEventsInHistory = 10000;
 // The config-history is supposed to be unbounded, but needs to have some bound
 // to prevent an attack via unreasonable memory use.
 constexpr size_t kMaxEventsInConfigHistory = 1000;
+// The history is encoded and written this many events at a time, which bounds
+// the size of the encoded string that has to be kept in memory.
+constexpr size_t kMaxEventsPerEncodedBatch = 1000;
 
 std::unique_ptr<RtcEventLogEncoder> CreateEncoder(
     RtcEventLog::EncodingType type) {
@@ -142,13 +146,33 @@ void RtcEventLogImpl::StopLogging(std::function<void()> callback) {
 void RtcEventLogImpl::Log(std::unique_ptr<RtcEvent> event) {
   RTC_CHECK(event);
 
+  {
+    rtc::CritScope lock(&queue_crit_);
+    queued_events_.push_back(std::move(event));
+    if (queue_processing_scheduled_)
+      return;
+    queue_processing_scheduled_ = true;
+  }
+
   // Binding to |this| is safe because |this| outlives the |task_queue_|.
-  task_queue_->PostTask([this, event = std::move(event)]() mutable {
+  task_queue_->PostTask([this]() {
     RTC_DCHECK_RUN_ON(task_queue_.get());
+    ProcessQueuedEvents();
+  });
+}
+
+void RtcEventLogImpl::ProcessQueuedEvents() {
+  std::vector<std::unique_ptr<RtcEvent>> events;
+  {
+    rtc::CritScope lock(&queue_crit_);
+    events.swap(queued_events_);
+    queue_processing_scheduled_ = false;
+  }
+  for (std::unique_ptr<RtcEvent>& event : events) {
     LogToMemory(std::move(event));
     if (event_output_)
       ScheduleOutput();
-  });
+  }
 }
 
 void RtcEventLogImpl::ScheduleOutput() {
@@ -224,11 +248,21 @@ void RtcEventLogImpl::LogEventsFromMemoryToOutput() {
   // log is started immediately after the first one becomes full, then one
   // cannot rely on the second log to contain everything that isn't in the first
   // log; one batch of events might be missing.
-  std::string encoded_history =
-      event_encoder_->EncodeBatch(history_.begin(), history_.end());
+  auto batch_begin = history_.begin();
+  do {
+    const size_t batch_size = std::min<size_t>(
+        kMaxEventsPerEncodedBatch, history_.end() - batch_begin);
+    const auto batch_end = batch_begin + batch_size;
+    std::string encoded_history =
+        event_encoder_->EncodeBatch(batch_begin, batch_end);
+    WriteConfigsAndHistoryToOutput(encoded_configs, encoded_history);
+    // The configs are only written together with the first batch.
+    encoded_configs.clear();
+    batch_begin = batch_end;
+    // Writing fails if e.g. the maximum file size is reached, which closes the
+    // output.
+  } while (batch_begin != history_.end() && event_output_);
   history_.clear();
-
-  WriteConfigsAndHistoryToOutput(encoded_configs, encoded_history);
 }
 
 void RtcEventLogImpl::WriteConfigsAndHistoryToOutput(
@@ -16,6 +16,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "api/rtc_event_log/rtc_event.h"
@@ -23,6 +24,7 @@
 #include "api/rtc_event_log_output.h"
 #include "api/task_queue/task_queue_factory.h"
 #include "logging/rtc_event_log/encoder/rtc_event_log_encoder.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/synchronization/sequence_checker.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
@@ -48,6 +50,8 @@ class RtcEventLogImpl final : public RtcEventLog {
   void Log(std::unique_ptr<RtcEvent> event) override;
 
  private:
+  // Moves the events queued by Log() into memory, and schedules output.
+  void ProcessQueuedEvents() RTC_RUN_ON(task_queue_);
   void LogToMemory(std::unique_ptr<RtcEvent> event) RTC_RUN_ON(task_queue_);
   void LogEventsFromMemoryToOutput() RTC_RUN_ON(task_queue_);
 
@@ -78,6 +82,15 @@ class RtcEventLogImpl final : public RtcEventLog {
   int64_t last_output_ms_ RTC_GUARDED_BY(*task_queue_);
   bool output_scheduled_ RTC_GUARDED_BY(*task_queue_);
 
+  // Events logged since the last ProcessQueuedEvents(). Log() is called for
+  // every packet on the network and worker threads, so rather than posting a
+  // task per event, events are batched here and only the first event of a
+  // batch posts a task.
+  rtc::CriticalSection queue_crit_;
+  std::vector<std::unique_ptr<RtcEvent>> queued_events_
+      RTC_GUARDED_BY(queue_crit_);
+  bool queue_processing_scheduled_ RTC_GUARDED_BY(queue_crit_) = false;
+
   SequenceChecker logging_state_checker_;
   bool logging_state_started_ RTC_GUARDED_BY(logging_state_checker_);
 
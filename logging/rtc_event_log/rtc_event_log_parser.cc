@@ -1126,13 +1126,17 @@ ParsedRtcEventLog::ParseStatus ParsedRtcEventLog::ParseStream(
 
   // ParseStreamInternal stores the RTP packets in a map indexed by SSRC.
   // Since we dont need rapid lookup based on SSRC after parsing, we move the
-  // packets_streams from map to vector.
+  // packets_streams from map to vector. The packets are by far the largest
+  // part of a long log, and the vectors were grown one packet at a time, so
+  // release their unused capacity, which may be almost as large as the
+  // packets themselves.
   incoming_rtp_packets_by_ssrc_.reserve(incoming_rtp_packets_map_.size());
   for (auto& kv : incoming_rtp_packets_map_) {
     incoming_rtp_packets_by_ssrc_.emplace_back(LoggedRtpStreamIncoming());
     incoming_rtp_packets_by_ssrc_.back().ssrc = kv.first;
     incoming_rtp_packets_by_ssrc_.back().incoming_packets =
         std::move(kv.second);
+    incoming_rtp_packets_by_ssrc_.back().incoming_packets.shrink_to_fit();
   }
   incoming_rtp_packets_map_.clear();
   outgoing_rtp_packets_by_ssrc_.reserve(outgoing_rtp_packets_map_.size());
@@ -1141,8 +1145,11 @@ ParsedRtcEventLog::ParseStatus ParsedRtcEventLog::ParseStream(
     outgoing_rtp_packets_by_ssrc_.back().ssrc = kv.first;
     outgoing_rtp_packets_by_ssrc_.back().outgoing_packets =
         std::move(kv.second);
+    outgoing_rtp_packets_by_ssrc_.back().outgoing_packets.shrink_to_fit();
   }
   outgoing_rtp_packets_map_.clear();
+  incoming_rtcp_packets_.shrink_to_fit();
+  outgoing_rtcp_packets_.shrink_to_fit();
 
   // Build PacketViews for easier iteration over RTP packets.
   for (const auto& stream : incoming_rtp_packets_by_ssrc_) {
@@ -51,9 +51,14 @@ void AdaptedVideoTrackSource::OnFrame(const webrtc::VideoFrame& frame) {
   if (apply_rotation() && frame.rotation() != webrtc::kVideoRotation_0 &&
       buffer->type() == webrtc::VideoFrameBuffer::Type::kI420) {
     /* Apply pending rotation. */
+    const bool transposed = frame.rotation() == webrtc::kVideoRotation_90 ||
+                            frame.rotation() == webrtc::kVideoRotation_270;
+    rtc::scoped_refptr<webrtc::I420Buffer> rotated_buffer =
+        CreateI420Buffer(transposed ? buffer->height() : buffer->width(),
+                         transposed ? buffer->width() : buffer->height());
+    rotated_buffer->RotateFrom(*buffer->GetI420(), frame.rotation());
     webrtc::VideoFrame rotated_frame(frame);
-    rotated_frame.set_video_frame_buffer(
-        webrtc::I420Buffer::Rotate(*buffer->GetI420(), frame.rotation()));
+    rotated_frame.set_video_frame_buffer(rotated_buffer);
     rotated_frame.set_rotation(webrtc::kVideoRotation_0);
     broadcaster_.OnFrame(rotated_frame);
   } else {
@@ -61,6 +66,41 @@ void AdaptedVideoTrackSource::OnFrame(const webrtc::VideoFrame& frame) {
   }
 }
 
+rtc::scoped_refptr<webrtc::VideoFrameBuffer>
+AdaptedVideoTrackSource::CropAndScaleBuffer(
+    const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+    int crop_x,
+    int crop_y,
+    int crop_width,
+    int crop_height,
+    int out_width,
+    int out_height) {
+  if (crop_x == 0 && crop_y == 0 && crop_width == buffer->width() &&
+      crop_height == buffer->height() && out_width == buffer->width() &&
+      out_height == buffer->height()) {
+    return buffer;
+  }
+  if (buffer->type() != webrtc::VideoFrameBuffer::Type::kI420) {
+    return buffer->CropAndScale(crop_x, crop_y, crop_width, crop_height,
+                                out_width, out_height);
+  }
+  rtc::scoped_refptr<webrtc::I420Buffer> scaled_buffer =
+      CreateI420Buffer(out_width, out_height);
+  scaled_buffer->CropAndScaleFrom(*buffer->GetI420(), crop_x, crop_y,
+                                  crop_width, crop_height);
+  return scaled_buffer;
+}
+
+rtc::scoped_refptr<webrtc::I420Buffer>
+AdaptedVideoTrackSource::CreateI420Buffer(int width, int height) {
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer;
+  {
+    rtc::CritScope lock(&buffer_pool_crit_);
+    buffer = buffer_pool_.CreateBuffer(width, height);
+  }
+  return buffer ? buffer : webrtc::I420Buffer::Create(width, height);
+}
+
 void AdaptedVideoTrackSource::AddOrUpdateSink(
     rtc::VideoSinkInterface<webrtc::VideoFrame>* sink,
     const rtc::VideoSinkWants& wants) {
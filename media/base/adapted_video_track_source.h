@@ -19,6 +19,7 @@
 #include "api/video/video_frame.h"
 #include "api/video/video_sink_interface.h"
 #include "api/video/video_source_interface.h"
+#include "common_video/include/i420_buffer_pool.h"
 #include "media/base/video_adapter.h"
 #include "media/base/video_broadcaster.h"
 #include "rtc_base/critical_section.h"
@@ -68,6 +69,21 @@ class RTC_EXPORT AdaptedVideoTrackSource
 
   cricket::VideoAdapter* video_adapter() { return &video_adapter_; }
 
+  // Returns the area of |crop_width| x |crop_height| pixels at |crop_x|,
+  // |crop_y| of |buffer|, scaled to |out_width| x |out_height|. I420 buffers
+  // are scaled into buffers from a pool owned by the source, so that adapting
+  // frames of a steady resolution doesn't allocate. Other buffers are adapted
+  // by VideoFrameBuffer::CropAndScale(), which native buffers may implement
+  // without conversion.
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScaleBuffer(
+      const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+      int crop_x,
+      int crop_y,
+      int crop_width,
+      int crop_height,
+      int out_width,
+      int out_height);
+
  private:
   // Implements rtc::VideoSourceInterface.
   void AddOrUpdateSink(rtc::VideoSinkInterface<webrtc::VideoFrame>* sink,
@@ -79,6 +95,11 @@ class RTC_EXPORT AdaptedVideoTrackSource
 
   void OnSinkWantsChanged(const rtc::VideoSinkWants& wants);
 
+  // Returns a buffer from |buffer_pool_|, or a new one if the pool is out of
+  // buffers.
+  rtc::scoped_refptr<webrtc::I420Buffer> CreateI420Buffer(int width,
+                                                          int height);
+
   // Encoded sinks not implemented for AdaptedVideoTrackSource.
   bool SupportsEncodedOutput() const override { return false; }
   void GenerateKeyFrame() override {}
@@ -92,6 +113,11 @@ class RTC_EXPORT AdaptedVideoTrackSource
   rtc::CriticalSection stats_crit_;
   absl::optional<Stats> stats_ RTC_GUARDED_BY(stats_crit_);
 
+  // Frames may be adapted on any thread, but the pool requires sequential
+  // calls.
+  rtc::CriticalSection buffer_pool_crit_;
+  webrtc::I420BufferPool buffer_pool_ RTC_GUARDED_BY(buffer_pool_crit_);
+
   VideoBroadcaster broadcaster_;
 };
 
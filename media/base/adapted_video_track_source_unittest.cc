@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/base/adapted_video_track_source.h"
+
+#include <set>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "api/video/video_rotation.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+class TestVideoTrackSource : public AdaptedVideoTrackSource {
+ public:
+  using AdaptedVideoTrackSource::CropAndScaleBuffer;
+  using AdaptedVideoTrackSource::OnFrame;
+
+  SourceState state() const override { return kLive; }
+  bool remote() const override { return false; }
+  bool is_screencast() const override { return false; }
+  absl::optional<bool> needs_denoising() const override { return false; }
+};
+
+class FrameSink : public VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  void OnFrame(const webrtc::VideoFrame& frame) override {
+    frames_.push_back(frame);
+  }
+
+  const std::vector<webrtc::VideoFrame>& frames() const { return frames_; }
+
+ private:
+  std::vector<webrtc::VideoFrame> frames_;
+};
+
+rtc::scoped_refptr<webrtc::I420Buffer> CreateBuffer(int width, int height) {
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer =
+      webrtc::I420Buffer::Create(width, height);
+  webrtc::I420Buffer::SetBlack(buffer);
+  return buffer;
+}
+
+class AdaptedVideoTrackSourceTest : public ::testing::Test {
+ protected:
+  AdaptedVideoTrackSourceTest()
+      : source_(new rtc::RefCountedObject<TestVideoTrackSource>()),
+        input_(CreateBuffer(1280, 720)) {}
+
+  rtc::scoped_refptr<TestVideoTrackSource> source_;
+  rtc::scoped_refptr<webrtc::I420Buffer> input_;
+};
+
+TEST_F(AdaptedVideoTrackSourceTest, CropsAndScalesI420Buffers) {
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> output =
+      source_->CropAndScaleBuffer(input_, /*crop_x=*/160, /*crop_y=*/0,
+                                  /*crop_width=*/960, /*crop_height=*/720,
+                                  /*out_width=*/640, /*out_height=*/480);
+  ASSERT_TRUE(output);
+  EXPECT_EQ(output->type(), webrtc::VideoFrameBuffer::Type::kI420);
+  EXPECT_EQ(output->width(), 640);
+  EXPECT_EQ(output->height(), 480);
+}
+
+TEST_F(AdaptedVideoTrackSourceTest, ReturnsBufferThatNeedsNoAdaptation) {
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> output =
+      source_->CropAndScaleBuffer(input_, 0, 0, 1280, 720, 1280, 720);
+  EXPECT_EQ(output.get(), input_.get());
+}
+
+TEST_F(AdaptedVideoTrackSourceTest, ReusesReleasedBuffers) {
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> output =
+      source_->CropAndScaleBuffer(input_, 0, 0, 1280, 720, 640, 360);
+  const uint8_t* data = output->GetI420()->DataY();
+  output = nullptr;
+
+  output = source_->CropAndScaleBuffer(input_, 0, 0, 1280, 720, 640, 360);
+  EXPECT_EQ(output->GetI420()->DataY(), data);
+}
+
+TEST_F(AdaptedVideoTrackSourceTest, AppliesRotationForSinksThatWantIt) {
+  FrameSink sink;
+  VideoSinkWants wants;
+  wants.rotation_applied = true;
+  static_cast<VideoSourceInterface<webrtc::VideoFrame>*>(source_.get())
+      ->AddOrUpdateSink(&sink, wants);
+
+  for (int i = 0; i < 2; ++i) {
+    source_->OnFrame(webrtc::VideoFrame::Builder()
+                         .set_video_frame_buffer(input_)
+                         .set_rotation(webrtc::kVideoRotation_90)
+                         .set_timestamp_us(i)
+                         .build());
+  }
+
+  ASSERT_EQ(sink.frames().size(), 2u);
+  for (const webrtc::VideoFrame& frame : sink.frames()) {
+    EXPECT_EQ(frame.rotation(), webrtc::kVideoRotation_0);
+    EXPECT_EQ(frame.width(), 720);
+    EXPECT_EQ(frame.height(), 1280);
+  }
+  static_cast<VideoSourceInterface<webrtc::VideoFrame>*>(source_.get())
+      ->RemoveSink(&sink);
+}
+
+// Reports the time per adapted frame and the number of distinct buffers used,
+// when a few adapted frames are in flight at a time and the resolution changes
+// now and then.
+TEST_F(AdaptedVideoTrackSourceTest, DISABLED_AdaptFrameThroughput) {
+  constexpr int kNumFrames = 6000;
+  constexpr size_t kFramesInFlight = 3;
+  std::vector<rtc::scoped_refptr<webrtc::VideoFrameBuffer>> in_flight;
+  std::set<const uint8_t*> buffers;
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumFrames; ++i) {
+    const int out_width = (i / 200) % 2 == 0 ? 640 : 320;
+    const int out_height = out_width * 9 / 16;
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> output =
+        source_->CropAndScaleBuffer(input_, 0, 0, 1280, 720, out_width,
+                                    out_height);
+    buffers.insert(output->GetI420()->DataY());
+    in_flight.push_back(output);
+    if (in_flight.size() > kFramesInFlight)
+      in_flight.erase(in_flight.begin());
+  }
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  RTC_LOG(LS_INFO) << "Adapted " << kNumFrames << " frames in " << elapsed_us
+                   << " us into " << buffers.size() << " buffers.";
+}
+
+}  // namespace
+}  // namespace rtc
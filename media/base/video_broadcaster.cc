@@ -10,6 +10,7 @@
 
 #include "media/base/video_broadcaster.h"
 
+#include <utility>
 #include <vector>
 
 #include "absl/types/optional.h"
@@ -22,6 +23,13 @@
 namespace rtc {
 
 VideoBroadcaster::VideoBroadcaster() = default;
+
+VideoBroadcaster::VideoBroadcaster(webrtc::TaskQueueFactory* task_queue_factory)
+    : delivery_queue_(std::make_unique<rtc::TaskQueue>(
+          task_queue_factory->CreateTaskQueue(
+              "VideoBroadcaster",
+              webrtc::TaskQueueFactory::Priority::NORMAL))) {}
+
 VideoBroadcaster::~VideoBroadcaster() = default;
 
 void VideoBroadcaster::AddOrUpdateSink(
@@ -40,8 +48,16 @@ void VideoBroadcaster::AddOrUpdateSink(
 void VideoBroadcaster::RemoveSink(
     VideoSinkInterface<webrtc::VideoFrame>* sink) {
   RTC_DCHECK(sink != nullptr);
+  // Wait for a delivery in progress on the delivery queue, which may be to
+  // |sink|. Synchronous deliveries are made while holding
+  // |sinks_and_wants_lock_| instead.
+  absl::optional<rtc::CritScope> delivery;
+  if (delivery_queue_) {
+    delivery.emplace(&delivery_lock_);
+  }
   rtc::CritScope cs(&sinks_and_wants_lock_);
   VideoSourceBase::RemoveSink(sink);
+  pending_frames_.erase(sink);
   UpdateWants();
 }
 
@@ -58,6 +74,9 @@ VideoSinkWants VideoBroadcaster::wants() const {
 void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
   rtc::CritScope cs(&sinks_and_wants_lock_);
   bool current_frame_was_discarded = false;
+  // Created for the first sink that needs them, and shared with the rest.
+  absl::optional<webrtc::VideoFrame> black_frame;
+  absl::optional<webrtc::VideoFrame> frame_without_update_rect;
   for (auto& sink_pair : sink_pairs()) {
     if (sink_pair.wants.rotation_applied &&
         frame.rotation() != webrtc::kVideoRotation_0) {
@@ -66,36 +85,105 @@ void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
       // with rotation still pending. Protect sinks that don't expect any
       // pending rotation.
       RTC_LOG(LS_VERBOSE) << "Discarding frame with unexpected rotation.";
-      sink_pair.sink->OnDiscardedFrame();
+      DeliverFrame(sink_pair.sink, absl::nullopt);
       current_frame_was_discarded = true;
       continue;
     }
     if (sink_pair.wants.black_frames) {
-      webrtc::VideoFrame black_frame =
-          webrtc::VideoFrame::Builder()
-              .set_video_frame_buffer(
-                  GetBlackFrameBuffer(frame.width(), frame.height()))
-              .set_rotation(frame.rotation())
-              .set_timestamp_us(frame.timestamp_us())
-              .set_id(frame.id())
-              .build();
-      sink_pair.sink->OnFrame(black_frame);
+      if (!black_frame) {
+        black_frame = webrtc::VideoFrame::Builder()
+                          .set_video_frame_buffer(GetBlackFrameBuffer(
+                              frame.width(), frame.height()))
+                          .set_rotation(frame.rotation())
+                          .set_timestamp_us(frame.timestamp_us())
+                          .set_id(frame.id())
+                          .build();
+      }
+      DeliverFrame(sink_pair.sink, black_frame);
     } else if (!previous_frame_sent_to_all_sinks_ && frame.has_update_rect()) {
       // Since last frame was not sent to some sinks, no reliable update
       // information is available, so we need to clear the update rect.
-      webrtc::VideoFrame copy = frame;
-      copy.clear_update_rect();
-      sink_pair.sink->OnFrame(copy);
+      if (!frame_without_update_rect) {
+        frame_without_update_rect = frame;
+        frame_without_update_rect->clear_update_rect();
+      }
+      DeliverFrame(sink_pair.sink, frame_without_update_rect);
     } else {
-      sink_pair.sink->OnFrame(frame);
+      DeliverFrame(sink_pair.sink, frame);
     }
   }
   previous_frame_sent_to_all_sinks_ = !current_frame_was_discarded;
 }
 
 void VideoBroadcaster::OnDiscardedFrame() {
+  rtc::CritScope cs(&sinks_and_wants_lock_);
   for (auto& sink_pair : sink_pairs()) {
-    sink_pair.sink->OnDiscardedFrame();
+    DeliverFrame(sink_pair.sink, absl::nullopt);
+  }
+}
+
+void VideoBroadcaster::DeliverFrame(
+    VideoSinkInterface<webrtc::VideoFrame>* sink,
+    const absl::optional<webrtc::VideoFrame>& frame) {
+  if (!delivery_queue_) {
+    if (frame) {
+      sink->OnFrame(*frame);
+    } else {
+      sink->OnDiscardedFrame();
+    }
+    return;
+  }
+
+  auto it = pending_frames_.find(sink);
+  if (it == pending_frames_.end()) {
+    pending_frames_.emplace(sink, frame);
+  } else if (frame) {
+    // The sink hasn't got the pending frame yet, so the update rect of the
+    // replacing frame has to cover the changes of both.
+    absl::optional<webrtc::VideoFrame>& pending_frame = it->second;
+    if (pending_frame && frame->has_update_rect() &&
+        pending_frame->width() == frame->width() &&
+        pending_frame->height() == frame->height()) {
+      webrtc::VideoFrame::UpdateRect update_rect =
+          pending_frame->update_rect();
+      update_rect.Union(frame->update_rect());
+      pending_frame = frame;
+      pending_frame->set_update_rect(update_rect);
+    } else {
+      pending_frame = frame;
+      pending_frame->clear_update_rect();
+    }
+  }
+
+  if (!delivery_scheduled_) {
+    delivery_scheduled_ = true;
+    delivery_queue_->PostTask([this] { DeliverPendingFrames(); });
+  }
+}
+
+void VideoBroadcaster::DeliverPendingFrames() {
+  rtc::CritScope delivery(&delivery_lock_);
+  while (true) {
+    VideoSinkInterface<webrtc::VideoFrame>* sink;
+    absl::optional<webrtc::VideoFrame> frame;
+    {
+      // Take one frame at a time, since sinks may be removed by the sinks
+      // called before them.
+      rtc::CritScope cs(&sinks_and_wants_lock_);
+      if (pending_frames_.empty()) {
+        delivery_scheduled_ = false;
+        return;
+      }
+      auto it = pending_frames_.begin();
+      sink = it->first;
+      frame = std::move(it->second);
+      pending_frames_.erase(it);
+    }
+    if (frame) {
+      sink->OnFrame(*frame);
+    } else {
+      sink->OnDiscardedFrame();
+    }
   }
 }
 
@@ -11,11 +11,17 @@
 #ifndef MEDIA_BASE_VIDEO_BROADCASTER_H_
 #define MEDIA_BASE_VIDEO_BROADCASTER_H_
 
+#include <map>
+#include <memory>
+
+#include "absl/types/optional.h"
 #include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "api/video/video_frame_buffer.h"
 #include "api/video/video_source_interface.h"
 #include "media/base/video_source_base.h"
 #include "rtc_base/critical_section.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
 
@@ -26,10 +32,19 @@ namespace rtc {
 // rtc::VideoSinkInterface. The class is threadsafe; methods may be called on
 // any thread. This is needed because VideoStreamEncoder calls AddOrUpdateSink
 // both on the worker thread and on the encoder task queue.
+//
+// Frames for sinks with the same wants are created once per broadcast frame
+// and shared by those sinks.
 class VideoBroadcaster : public VideoSourceBase,
                          public VideoSinkInterface<webrtc::VideoFrame> {
  public:
   VideoBroadcaster();
+  // Delivers frames to the sinks on a task queue created with
+  // |task_queue_factory| rather than on the thread calling OnFrame(), so that
+  // a slow sink can't stall the source. A sink that hasn't returned from its
+  // previous OnFrame() call when new frames arrive only gets the latest one.
+  // Must not be destroyed from within a sink callback.
+  explicit VideoBroadcaster(webrtc::TaskQueueFactory* task_queue_factory);
   ~VideoBroadcaster() override;
   void AddOrUpdateSink(VideoSinkInterface<webrtc::VideoFrame>* sink,
                        const VideoSinkWants& wants) override;
@@ -51,17 +66,34 @@ class VideoBroadcaster : public VideoSourceBase,
   void OnDiscardedFrame() override;
 
  protected:
+  // Passes |frame| to |sink|, or a discarded frame if |frame| is nullopt.
+  void DeliverFrame(VideoSinkInterface<webrtc::VideoFrame>* sink,
+                    const absl::optional<webrtc::VideoFrame>& frame)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
+  void DeliverPendingFrames();
   void UpdateWants() RTC_EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
   const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& GetBlackFrameBuffer(
       int width,
       int height) RTC_EXCLUSIVE_LOCKS_REQUIRED(sinks_and_wants_lock_);
 
+  // Held while frames are delivered on |delivery_queue_|, so that a sink
+  // isn't called after RemoveSink() returns. Acquired before
+  // |sinks_and_wants_lock_|, and only if there is a |delivery_queue_|.
+  rtc::CriticalSection delivery_lock_;
   rtc::CriticalSection sinks_and_wants_lock_;
 
   VideoSinkWants current_wants_ RTC_GUARDED_BY(sinks_and_wants_lock_);
   rtc::scoped_refptr<webrtc::VideoFrameBuffer> black_frame_buffer_;
   bool previous_frame_sent_to_all_sinks_ RTC_GUARDED_BY(sinks_and_wants_lock_) =
       true;
+  // The latest frame not yet delivered on |delivery_queue_|, per sink.
+  std::map<VideoSinkInterface<webrtc::VideoFrame>*,
+           absl::optional<webrtc::VideoFrame>>
+      pending_frames_ RTC_GUARDED_BY(sinks_and_wants_lock_);
+  bool delivery_scheduled_ RTC_GUARDED_BY(sinks_and_wants_lock_) = false;
+  // Declared last, so that it's destroyed, and stops running deliveries,
+  // before the members they use.
+  std::unique_ptr<rtc::TaskQueue> delivery_queue_;
 };
 
 }  // namespace rtc
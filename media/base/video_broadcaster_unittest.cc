@@ -11,18 +11,81 @@
 #include "media/base/video_broadcaster.h"
 
 #include <limits>
+#include <memory>
+#include <vector>
 
 #include "absl/types/optional.h"
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame.h"
 #include "api/video/video_rotation.h"
 #include "media/base/fake_video_renderer.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
 #include "test/gtest.h"
 
 using cricket::FakeVideoRenderer;
 using rtc::VideoBroadcaster;
 using rtc::VideoSinkWants;
 
+namespace {
+
+class FrameBufferSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  void OnFrame(const webrtc::VideoFrame& frame) override {
+    buffer_ = frame.video_frame_buffer();
+  }
+
+  webrtc::VideoFrameBuffer* buffer() const { return buffer_.get(); }
+
+ private:
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer_;
+};
+
+// Blocks in OnFrame() until Release() is called.
+class BlockingSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+ public:
+  BlockingSink()
+      : release_(/*manual_reset=*/true, /*initially_signaled=*/false) {}
+
+  void OnFrame(const webrtc::VideoFrame& frame) override {
+    {
+      rtc::CritScope cs(&crit_);
+      timestamps_us_.push_back(frame.timestamp_us());
+    }
+    frame_received_.Set();
+    release_.Wait(rtc::Event::kForever);
+  }
+
+  bool WaitForFrame() { return frame_received_.Wait(5000); }
+  void Release() { release_.Set(); }
+
+  std::vector<int64_t> timestamps_us() const {
+    rtc::CritScope cs(&crit_);
+    return timestamps_us_;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  std::vector<int64_t> timestamps_us_ RTC_GUARDED_BY(crit_);
+  rtc::Event frame_received_;
+  rtc::Event release_;
+};
+
+webrtc::VideoFrame CreateFrame(int64_t timestamp_us) {
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer(
+      webrtc::I420Buffer::Create(100, 50));
+  webrtc::I420Buffer::SetBlack(buffer);
+  return webrtc::VideoFrame::Builder()
+      .set_video_frame_buffer(buffer)
+      .set_rotation(webrtc::kVideoRotation_0)
+      .set_timestamp_us(timestamp_us)
+      .build();
+}
+
+}  // namespace
+
 TEST(VideoBroadcasterTest, frame_wanted) {
   VideoBroadcaster broadcaster;
   EXPECT_FALSE(broadcaster.frame_wanted());
@@ -232,3 +295,36 @@ TEST(VideoBroadcasterTest, SinkWantsBlackFrames) {
   EXPECT_TRUE(sink2.black_frame());
   EXPECT_EQ(30, sink2.timestamp_us());
 }
+
+TEST(VideoBroadcasterTest, SinksWantingBlackFramesShareBuffer) {
+  VideoBroadcaster broadcaster;
+  FrameBufferSink sink1;
+  FrameBufferSink sink2;
+  VideoSinkWants wants;
+  wants.black_frames = true;
+  broadcaster.AddOrUpdateSink(&sink1, wants);
+  broadcaster.AddOrUpdateSink(&sink2, wants);
+
+  broadcaster.OnFrame(CreateFrame(/*timestamp_us=*/0));
+  ASSERT_TRUE(sink1.buffer());
+  EXPECT_EQ(sink1.buffer(), sink2.buffer());
+}
+
+TEST(VideoBroadcasterTest, SlowSinkGetsLatestFrameWithDeliveryQueue) {
+  std::unique_ptr<webrtc::TaskQueueFactory> task_queue_factory =
+      webrtc::CreateDefaultTaskQueueFactory();
+  VideoBroadcaster broadcaster(task_queue_factory.get());
+  BlockingSink sink;
+  broadcaster.AddOrUpdateSink(&sink, rtc::VideoSinkWants());
+
+  broadcaster.OnFrame(CreateFrame(/*timestamp_us=*/1));
+  ASSERT_TRUE(sink.WaitForFrame());
+  // The sink is blocked, which doesn't block the broadcaster.
+  broadcaster.OnFrame(CreateFrame(/*timestamp_us=*/2));
+  broadcaster.OnFrame(CreateFrame(/*timestamp_us=*/3));
+
+  sink.Release();
+  ASSERT_TRUE(sink.WaitForFrame());
+  broadcaster.RemoveSink(&sink);
+  EXPECT_EQ(sink.timestamps_us(), (std::vector<int64_t>{1, 3}));
+}
@@ -570,6 +570,18 @@ void FakeCall::DestroyFlexfecReceiveStream(
   }
 }
 
+webrtc::SelectiveForwardingStream* FakeCall::CreateSelectiveForwardingStream(
+    const webrtc::SelectiveForwardingStream::Config& config) {
+  // Selective forwarding is not used by the media engine.
+  ADD_FAILURE() << "CreateSelectiveForwardingStream is not supported.";
+  return nullptr;
+}
+
+void FakeCall::DestroySelectiveForwardingStream(
+    webrtc::SelectiveForwardingStream* forwarding_stream) {
+  ADD_FAILURE() << "DestroySelectiveForwardingStream is not supported.";
+}
+
 webrtc::PacketReceiver* FakeCall::Receiver() {
   return this;
 }
@@ -163,6 +163,10 @@ class FakeVideoSendStream final
   rtc::VideoSourceInterface<webrtc::VideoFrame>* source() const {
     return source_;
   }
+  webrtc::VideoSendStream::EncodedFrameSource* encoded_frame_source() const {
+    return encoded_frame_source_;
+  }
+  int num_encoded_frames() const { return num_encoded_frames_; }
 
  private:
   // rtc::VideoSinkInterface<VideoFrame> implementation.
@@ -176,6 +180,13 @@ class FakeVideoSendStream final
   void SetSource(
       rtc::VideoSourceInterface<webrtc::VideoFrame>* source,
       const webrtc::DegradationPreference& degradation_preference) override;
+  void SetEncodedFrameSource(
+      webrtc::VideoSendStream::EncodedFrameSource* source) override {
+    encoded_frame_source_ = source;
+  }
+  void SendEncodedFrame(const webrtc::RecordableEncodedFrame& frame) override {
+    ++num_encoded_frames_;
+  }
   webrtc::VideoSendStream::Stats GetStats() override;
   void ReconfigureVideoEncoder(webrtc::VideoEncoderConfig config) override;
 
@@ -198,6 +209,8 @@ class FakeVideoSendStream final
   absl::optional<webrtc::VideoFrame> last_frame_;
   webrtc::VideoSendStream::Stats stats_;
   int num_encoder_reconfigurations_ = 0;
+  webrtc::VideoSendStream::EncodedFrameSource* encoded_frame_source_ = nullptr;
+  int num_encoded_frames_ = 0;
 };
 
 class FakeVideoReceiveStream final : public webrtc::VideoReceiveStream {
@@ -341,6 +354,11 @@ class FakeCall final : public webrtc::Call, public webrtc::PacketReceiver {
   void DestroyFlexfecReceiveStream(
       webrtc::FlexfecReceiveStream* receive_stream) override;
 
+  webrtc::SelectiveForwardingStream* CreateSelectiveForwardingStream(
+      const webrtc::SelectiveForwardingStream::Config& config) override;
+  void DestroySelectiveForwardingStream(
+      webrtc::SelectiveForwardingStream* forwarding_stream) override;
+
   webrtc::PacketReceiver* Receiver() override;
 
   DeliveryStatus DeliverPacket(webrtc::MediaType media_type,
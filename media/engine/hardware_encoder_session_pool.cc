@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ */
+
+#include "media/engine/hardware_encoder_session_pool.h"
+
+#include <utility>
+
+#include "api/video_codecs/video_encoder_software_fallback_wrapper.h"
+#include "media/base/codec.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+bool IsFormatSupported(const std::vector<SdpVideoFormat>& supported_formats,
+                       const SdpVideoFormat& format) {
+  for (const SdpVideoFormat& supported_format : supported_formats) {
+    if (cricket::IsSameCodec(format.name, format.parameters,
+                             supported_format.name,
+                             supported_format.parameters)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Holds a session of |session_pool| while |encoder| is initialized.
+class SessionPooledEncoder : public VideoEncoder {
+ public:
+  SessionPooledEncoder(std::unique_ptr<VideoEncoder> encoder,
+                       HardwareEncoderSessionPool* session_pool)
+      : encoder_(std::move(encoder)), session_pool_(session_pool) {}
+  ~SessionPooledEncoder() override { Release(); }
+
+  void SetFecControllerOverride(
+      FecControllerOverride* fec_controller_override) override {
+    encoder_->SetFecControllerOverride(fec_controller_override);
+  }
+
+  int InitEncode(const VideoCodec* codec_settings,
+                 const VideoEncoder::Settings& settings) override {
+    if (!has_session_) {
+      if (!session_pool_->TryAcquireSession()) {
+        RTC_LOG(LS_INFO) << "All " << session_pool_->max_sessions()
+                         << " hardware encoder sessions are in use.";
+        return WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE;
+      }
+      has_session_ = true;
+    }
+    int ret = encoder_->InitEncode(codec_settings, settings);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      ReleaseSession();
+    }
+    return ret;
+  }
+
+  int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) override {
+    return encoder_->RegisterEncodeCompleteCallback(callback);
+  }
+
+  int32_t Release() override {
+    if (!has_session_) {
+      return WEBRTC_VIDEO_CODEC_OK;
+    }
+    int32_t ret = encoder_->Release();
+    ReleaseSession();
+    return ret;
+  }
+
+  int32_t Encode(const VideoFrame& frame,
+                 const std::vector<VideoFrameType>* frame_types) override {
+    if (!has_session_) {
+      return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+    }
+    return encoder_->Encode(frame, frame_types);
+  }
+
+  void SetRates(const RateControlParameters& parameters) override {
+    encoder_->SetRates(parameters);
+  }
+
+  void OnPacketLossRateUpdate(float packet_loss_rate) override {
+    encoder_->OnPacketLossRateUpdate(packet_loss_rate);
+  }
+
+  void OnRttUpdate(int64_t rtt_ms) override { encoder_->OnRttUpdate(rtt_ms); }
+
+  void OnLossNotification(const LossNotification& loss_notification) override {
+    encoder_->OnLossNotification(loss_notification);
+  }
+
+  EncoderInfo GetEncoderInfo() const override {
+    return encoder_->GetEncoderInfo();
+  }
+
+ private:
+  void ReleaseSession() {
+    if (has_session_) {
+      session_pool_->ReleaseSession();
+      has_session_ = false;
+    }
+  }
+
+  const std::unique_ptr<VideoEncoder> encoder_;
+  HardwareEncoderSessionPool* const session_pool_;
+  bool has_session_ = false;
+};
+
+}  // namespace
+
+HardwareEncoderSessionPool::HardwareEncoderSessionPool(int max_sessions)
+    : max_sessions_(max_sessions) {
+  RTC_DCHECK_GE(max_sessions_, 0);
+}
+
+HardwareEncoderSessionPool::~HardwareEncoderSessionPool() {
+  RTC_DCHECK_EQ(sessions_in_use_, 0);
+}
+
+bool HardwareEncoderSessionPool::TryAcquireSession() {
+  rtc::CritScope lock(&crit_);
+  if (sessions_in_use_ >= max_sessions_) {
+    return false;
+  }
+  ++sessions_in_use_;
+  return true;
+}
+
+void HardwareEncoderSessionPool::ReleaseSession() {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK_GT(sessions_in_use_, 0);
+  --sessions_in_use_;
+}
+
+int HardwareEncoderSessionPool::sessions_in_use() const {
+  rtc::CritScope lock(&crit_);
+  return sessions_in_use_;
+}
+
+SessionPooledVideoEncoderFactory::SessionPooledVideoEncoderFactory(
+    std::unique_ptr<VideoEncoderFactory> hardware_factory,
+    std::unique_ptr<VideoEncoderFactory> software_factory,
+    int max_sessions)
+    : hardware_factory_(std::move(hardware_factory)),
+      software_factory_(std::move(software_factory)),
+      session_pool_(max_sessions) {
+  RTC_DCHECK(hardware_factory_);
+}
+
+SessionPooledVideoEncoderFactory::~SessionPooledVideoEncoderFactory() =
+    default;
+
+std::vector<SdpVideoFormat>
+SessionPooledVideoEncoderFactory::GetSupportedFormats() const {
+  std::vector<SdpVideoFormat> formats =
+      hardware_factory_->GetSupportedFormats();
+  if (software_factory_) {
+    for (const SdpVideoFormat& format :
+         software_factory_->GetSupportedFormats()) {
+      if (!IsFormatSupported(formats, format))
+        formats.push_back(format);
+    }
+  }
+  return formats;
+}
+
+VideoEncoderFactory::CodecInfo
+SessionPooledVideoEncoderFactory::QueryVideoEncoder(
+    const SdpVideoFormat& format) const {
+  if (IsSupportedByHardware(format)) {
+    return hardware_factory_->QueryVideoEncoder(format);
+  }
+  RTC_DCHECK(software_factory_);
+  return software_factory_->QueryVideoEncoder(format);
+}
+
+std::unique_ptr<VideoEncoder>
+SessionPooledVideoEncoderFactory::CreateVideoEncoder(
+    const SdpVideoFormat& format) {
+  const bool supported_by_software =
+      software_factory_ &&
+      IsFormatSupported(software_factory_->GetSupportedFormats(), format);
+  if (!IsSupportedByHardware(format)) {
+    return supported_by_software ? software_factory_->CreateVideoEncoder(format)
+                                 : nullptr;
+  }
+
+  auto hardware_encoder = std::make_unique<SessionPooledEncoder>(
+      hardware_factory_->CreateVideoEncoder(format), &session_pool_);
+  if (!supported_by_software) {
+    return hardware_encoder;
+  }
+  return CreateVideoEncoderSoftwareFallbackWrapper(
+      software_factory_->CreateVideoEncoder(format),
+      std::move(hardware_encoder));
+}
+
+bool SessionPooledVideoEncoderFactory::IsSupportedByHardware(
+    const SdpVideoFormat& format) const {
+  return IsFormatSupported(hardware_factory_->GetSupportedFormats(), format);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ */
+
+#ifndef MEDIA_ENGINE_HARDWARE_ENCODER_SESSION_POOL_H_
+#define MEDIA_ENGINE_HARDWARE_ENCODER_SESSION_POOL_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_encoder.h"
+#include "api/video_codecs/video_encoder_factory.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/system/rtc_export.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Counts the encode sessions in use of a device that supports a limited
+// number of concurrent sessions, e.g. a VA-API GPU. Thread safe.
+class RTC_EXPORT HardwareEncoderSessionPool {
+ public:
+  explicit HardwareEncoderSessionPool(int max_sessions);
+  ~HardwareEncoderSessionPool();
+
+  // Returns false if all sessions are in use.
+  bool TryAcquireSession();
+  void ReleaseSession();
+
+  int max_sessions() const { return max_sessions_; }
+  int sessions_in_use() const;
+
+ private:
+  const int max_sessions_;
+  rtc::CriticalSection crit_;
+  int sessions_in_use_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+// Creates encoders of |hardware_factory| that hold one of |max_sessions|
+// sessions while initialized. When all sessions are in use, or the hardware
+// encoder fails, they fall back to an encoder of |software_factory|, which
+// may be null. A hardware encoder is tried again on the next InitEncode, so
+// sessions released by other streams are picked up on reconfiguration. The
+// encoders share the session pool of the factory and must not outlive it.
+class RTC_EXPORT SessionPooledVideoEncoderFactory : public VideoEncoderFactory {
+ public:
+  SessionPooledVideoEncoderFactory(
+      std::unique_ptr<VideoEncoderFactory> hardware_factory,
+      std::unique_ptr<VideoEncoderFactory> software_factory,
+      int max_sessions);
+  ~SessionPooledVideoEncoderFactory() override;
+
+  // Implements VideoEncoderFactory.
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override;
+  CodecInfo QueryVideoEncoder(const SdpVideoFormat& format) const override;
+  std::unique_ptr<VideoEncoder> CreateVideoEncoder(
+      const SdpVideoFormat& format) override;
+
+  const HardwareEncoderSessionPool& session_pool() const {
+    return session_pool_;
+  }
+
+ private:
+  bool IsSupportedByHardware(const SdpVideoFormat& format) const;
+
+  const std::unique_ptr<VideoEncoderFactory> hardware_factory_;
+  const std::unique_ptr<VideoEncoderFactory> software_factory_;
+  HardwareEncoderSessionPool session_pool_;
+};
+
+}  // namespace webrtc
+
+#endif  // MEDIA_ENGINE_HARDWARE_ENCODER_SESSION_POOL_H_
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ */
+
+#include "media/engine/hardware_encoder_session_pool.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "api/test/mock_video_encoder.h"
+#include "api/test/mock_video_encoder_factory.h"
+#include "modules/video_coding/include/video_codec_interface.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/video_codec_settings.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+const VideoEncoder::Capabilities kCapabilities(false);
+const VideoEncoder::Settings kSettings(kCapabilities, 1, 1200);
+const char kHardwareName[] = "hardware";
+const char kSoftwareName[] = "software";
+
+std::unique_ptr<MockVideoEncoderFactory> CreateFactory(
+    const std::string& implementation_name) {
+  auto factory = std::make_unique<NiceMock<MockVideoEncoderFactory>>();
+  ON_CALL(*factory, GetSupportedFormats())
+      .WillByDefault(
+          Return(std::vector<SdpVideoFormat>{SdpVideoFormat("VP8")}));
+  ON_CALL(*factory, CreateVideoEncoder(_))
+      .WillByDefault([implementation_name](const SdpVideoFormat&) {
+        auto encoder = std::make_unique<NiceMock<MockVideoEncoder>>();
+        ON_CALL(*encoder, InitEncode(_, _))
+            .WillByDefault(Return(WEBRTC_VIDEO_CODEC_OK));
+        VideoEncoder::EncoderInfo info;
+        info.implementation_name = implementation_name;
+        ON_CALL(*encoder, GetEncoderInfo()).WillByDefault(Return(info));
+        return std::unique_ptr<VideoEncoder>(std::move(encoder));
+      });
+  return factory;
+}
+
+class SessionPooledVideoEncoderFactoryTest : public ::testing::Test {
+ protected:
+  SessionPooledVideoEncoderFactoryTest()
+      : factory_(CreateFactory(kHardwareName),
+                 CreateFactory(kSoftwareName),
+                 /*max_sessions=*/1) {
+    test::CodecSettings(kVideoCodecVP8, &codec_settings_);
+  }
+
+  SessionPooledVideoEncoderFactory factory_;
+  VideoCodec codec_settings_;
+};
+
+TEST(HardwareEncoderSessionPoolTest, LimitsSessions) {
+  HardwareEncoderSessionPool pool(2);
+  EXPECT_TRUE(pool.TryAcquireSession());
+  EXPECT_TRUE(pool.TryAcquireSession());
+  EXPECT_FALSE(pool.TryAcquireSession());
+  EXPECT_EQ(2, pool.sessions_in_use());
+  pool.ReleaseSession();
+  EXPECT_TRUE(pool.TryAcquireSession());
+  pool.ReleaseSession();
+  pool.ReleaseSession();
+}
+
+TEST_F(SessionPooledVideoEncoderFactoryTest,
+       FallsBackToSoftwareWhenSessionsAreInUse) {
+  std::unique_ptr<VideoEncoder> first =
+      factory_.CreateVideoEncoder(SdpVideoFormat("VP8"));
+  std::unique_ptr<VideoEncoder> second =
+      factory_.CreateVideoEncoder(SdpVideoFormat("VP8"));
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            first->InitEncode(&codec_settings_, kSettings));
+  EXPECT_EQ(kHardwareName, first->GetEncoderInfo().implementation_name);
+  EXPECT_EQ(1, factory_.session_pool().sessions_in_use());
+
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            second->InitEncode(&codec_settings_, kSettings));
+  EXPECT_EQ(kSoftwareName, second->GetEncoderInfo().implementation_name);
+
+  // The session of |first| is picked up when |second| is reconfigured.
+  first->Release();
+  EXPECT_EQ(0, factory_.session_pool().sessions_in_use());
+  second->Release();
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            second->InitEncode(&codec_settings_, kSettings));
+  EXPECT_EQ(kHardwareName, second->GetEncoderInfo().implementation_name);
+  EXPECT_EQ(1, factory_.session_pool().sessions_in_use());
+
+  second.reset();
+  EXPECT_EQ(0, factory_.session_pool().sessions_in_use());
+}
+
+TEST_F(SessionPooledVideoEncoderFactoryTest, ReleasesSessionOnInitFailure) {
+  auto hardware_factory = CreateFactory(kHardwareName);
+  ON_CALL(*hardware_factory, CreateVideoEncoder(_))
+      .WillByDefault([](const SdpVideoFormat&) {
+        auto encoder = std::make_unique<NiceMock<MockVideoEncoder>>();
+        ON_CALL(*encoder, InitEncode(_, _))
+            .WillByDefault(Return(WEBRTC_VIDEO_CODEC_ERROR));
+        return std::unique_ptr<VideoEncoder>(std::move(encoder));
+      });
+  SessionPooledVideoEncoderFactory factory(std::move(hardware_factory),
+                                           CreateFactory(kSoftwareName),
+                                           /*max_sessions=*/1);
+
+  std::unique_ptr<VideoEncoder> encoder =
+      factory.CreateVideoEncoder(SdpVideoFormat("VP8"));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder->InitEncode(&codec_settings_, kSettings));
+  EXPECT_EQ(kSoftwareName, encoder->GetEncoderInfo().implementation_name);
+  EXPECT_EQ(0, factory.session_pool().sessions_in_use());
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -14,12 +14,14 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <utility>
 
+#include "absl/algorithm/container.h"
 #include "api/scoped_refptr.h"
-#include "api/video/i420_buffer.h"
+#include "api/task_queue/default_task_queue_factory.h"
 #include "api/video/video_codec_constants.h"
 #include "api/video/video_frame_buffer.h"
 #include "api/video/video_rotation.h"
@@ -31,6 +33,7 @@
 #include "modules/video_coding/utility/simulcast_rate_allocator.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/experiments/rate_control_settings.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/field_trial.h"
@@ -151,7 +154,10 @@ SimulcastEncoderAdapter::SimulcastEncoderAdapter(
       boost_base_layer_quality_(RateControlSettings::ParseFromFieldTrials()
                                     .Vp8BoostBaseLayerQuality()),
       prefer_temporal_support_on_base_layer_(field_trial::IsEnabled(
-          "WebRTC-Video-PreferTemporalSupportOnBaseLayer")) {
+          "WebRTC-Video-PreferTemporalSupportOnBaseLayer")),
+      parallel_encoding_enabled_(field_trial::IsEnabled(
+          "WebRTC-SimulcastEncoderAdapter-ParallelEncoding")),
+      encode_in_parallel_(false) {
   RTC_DCHECK(primary_factory);
 
   // The adapter is typically created on the worker thread, but operated on
@@ -341,6 +347,34 @@ int SimulcastEncoderAdapter::InitEncode(
   // To save memory, don't store encoders that we don't use.
   DestroyStoredEncoders();
 
+  std::vector<I420PyramidScaler::Resolution> resolutions;
+  for (const StreamInfo& stream_info : streaminfos_)
+    resolutions.push_back({stream_info.width, stream_info.height});
+  pyramid_scaler_.SetResolutions(resolutions);
+
+  encode_in_parallel_ = parallel_encoding_enabled_ &&
+                        doing_simulcast_using_adapter && number_of_streams > 1;
+  for (const StreamInfo& stream_info : streaminfos_) {
+    EncoderInfo encoder_info = stream_info.encoder->GetEncoderInfo();
+    if (encoder_info.is_hardware_accelerated ||
+        encoder_info.has_internal_source) {
+      encode_in_parallel_ = false;
+    }
+  }
+  if (encode_in_parallel_) {
+    if (!task_queue_factory_)
+      task_queue_factory_ = CreateDefaultTaskQueueFactory();
+    encode_queues_.resize(std::max<size_t>(encode_queues_.size(),
+                                           number_of_streams));
+    for (int i = 1; i < number_of_streams; ++i) {
+      if (!encode_queues_[i]) {
+        encode_queues_[i] = std::make_unique<rtc::TaskQueue>(
+            task_queue_factory_->CreateTaskQueue(
+                "SimulcastEncoder", TaskQueueFactory::Priority::NORMAL));
+      }
+    }
+  }
+
   rtc::AtomicOps::ReleaseStore(&inited_, 1);
 
   return WEBRTC_VIDEO_CODEC_OK;
@@ -377,86 +411,197 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  // Temporary thay may hold the result of texture to i420 buffer conversion.
-  rtc::scoped_refptr<I420BufferInterface> src_buffer;
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  const uint32_t frame_timestamp_ms =
+      1000 * input_image.timestamp() / 90000;  // kVideoPayloadTypeFrequency;
+
+  std::vector<std::pair<size_t, std::vector<VideoFrameType>>> streams;
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
-    // Don't encode frames in resolutions that we don't intend to send.
-    if (!streaminfos_[stream_idx].send_stream) {
-      continue;
+    std::vector<VideoFrameType> stream_frame_types;
+    if (PrepareStreamFrameTypes(stream_idx, send_key_frame, frame_timestamp_ms,
+                                &stream_frame_types)) {
+      streams.emplace_back(stream_idx, std::move(stream_frame_types));
     }
+  }
+  const std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaled_buffers =
+      ScaleStreams(input_image, streams);
 
-    const uint32_t frame_timestamp_ms =
-        1000 * input_image.timestamp() / 90000;  // kVideoPayloadTypeFrequency;
-
-    // If adapter is passed through and only one sw encoder does simulcast,
-    // frame types for all streams should be passed to the encoder unchanged.
-    // Otherwise a single per-encoder frame type is passed.
-    std::vector<VideoFrameType> stream_frame_types(
-        streaminfos_.size() == 1 ? NumberOfStreams(codec_) : 1);
-    if (send_key_frame) {
-      std::fill(stream_frame_types.begin(), stream_frame_types.end(),
-                VideoFrameType::kVideoFrameKey);
-      streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      if (streaminfos_[stream_idx].framerate_controller->DropFrame(
-              frame_timestamp_ms)) {
-        continue;
-      }
-      std::fill(stream_frame_types.begin(), stream_frame_types.end(),
-                VideoFrameType::kVideoFrameDelta);
+  if (encode_in_parallel_) {
+    return EncodeStreamsInParallel(input_image, streams, scaled_buffers);
+  }
+
+  for (const auto& stream : streams) {
+    int ret = EncodeStream(stream.first, input_image, stream.second,
+                           scaled_buffers[stream.first]);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
     }
-    streaminfos_[stream_idx].framerate_controller->AddFrame(frame_timestamp_ms);
-
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources) or the source image has a native handle, pass the image on
-    // directly. Otherwise, we'll scale it to match what the encoder expects
-    // (below).
-    // For texture frames, the underlying encoder is expected to be able to
-    // correctly sample/scale the source texture.
-    // TODO(perkj): ensure that works going forward, and figure out how this
-    // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
-        (input_image.video_frame_buffer()->type() ==
-             VideoFrameBuffer::Type::kNative &&
-         streaminfos_[stream_idx]
-             .encoder->GetEncoderInfo()
-             .supports_native_handle)) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(input_image,
-                                                         &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
-    } else {
-      if (src_buffer == nullptr) {
-        src_buffer = input_image.video_frame_buffer()->ToI420();
-      }
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-
-      dst_buffer->ScaleFrom(*src_buffer);
-
-      // UpdateRect is not propagated to lower simulcast layers currently.
-      // TODO(ilnik): Consider scaling UpdateRect together with the buffer.
-      VideoFrame frame(input_image);
-      frame.set_video_frame_buffer(dst_buffer);
-      frame.set_rotation(webrtc::kVideoRotation_0);
-      frame.set_update_rect(
-          VideoFrame::UpdateRect{0, 0, frame.width(), frame.height()});
-      int ret =
-          streaminfos_[stream_idx].encoder->Encode(frame, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
+  }
+
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+bool SimulcastEncoderAdapter::PrepareStreamFrameTypes(
+    size_t stream_idx,
+    bool send_key_frame,
+    uint32_t frame_timestamp_ms,
+    std::vector<VideoFrameType>* frame_types) {
+  // Don't encode frames in resolutions that we don't intend to send.
+  if (!streaminfos_[stream_idx].send_stream) {
+    return false;
+  }
+
+  // If adapter is passed through and only one sw encoder does simulcast,
+  // frame types for all streams should be passed to the encoder unchanged.
+  // Otherwise a single per-encoder frame type is passed.
+  frame_types->resize(streaminfos_.size() == 1 ? NumberOfStreams(codec_) : 1);
+  if (send_key_frame) {
+    std::fill(frame_types->begin(), frame_types->end(),
+              VideoFrameType::kVideoFrameKey);
+    streaminfos_[stream_idx].key_frame_request = false;
+  } else {
+    if (streaminfos_[stream_idx].framerate_controller->DropFrame(
+            frame_timestamp_ms)) {
+      return false;
+    }
+    std::fill(frame_types->begin(), frame_types->end(),
+              VideoFrameType::kVideoFrameDelta);
+  }
+  streaminfos_[stream_idx].framerate_controller->AddFrame(frame_timestamp_ms);
+  return true;
+}
+
+bool SimulcastEncoderAdapter::CanPassThrough(
+    size_t stream_idx,
+    const VideoFrame& input_image) const {
+  // If scaling isn't required, because the input resolution
+  // matches the destination or the input image is empty (e.g.
+  // a keyframe request for encoders with internal camera
+  // sources) or the source image has a native handle, pass the image on
+  // directly. Otherwise, we'll scale it to match what the encoder expects
+  // (below).
+  // For texture frames, the underlying encoder is expected to be able to
+  // correctly sample/scale the source texture.
+  // TODO(perkj): ensure that works going forward, and figure out how this
+  // affects webrtc:5683.
+  return (streaminfos_[stream_idx].width == input_image.width() &&
+          streaminfos_[stream_idx].height == input_image.height()) ||
+         (input_image.video_frame_buffer()->type() ==
+              VideoFrameBuffer::Type::kNative &&
+          streaminfos_[stream_idx]
+              .encoder->GetEncoderInfo()
+              .supports_native_handle);
+}
+
+std::vector<rtc::scoped_refptr<VideoFrameBuffer>>
+SimulcastEncoderAdapter::ScaleStreams(
+    const VideoFrame& input_image,
+    const std::vector<std::pair<size_t, std::vector<VideoFrameType>>>&
+        streams) {
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> scaled_buffers(
+      streaminfos_.size());
+  std::vector<bool> needs_scaling(streaminfos_.size(), false);
+  bool any_needs_scaling = false;
+  for (const auto& stream : streams) {
+    if (!CanPassThrough(stream.first, input_image)) {
+      needs_scaling[stream.first] = true;
+      any_needs_scaling = true;
+    }
+  }
+  if (!any_needs_scaling)
+    return scaled_buffers;
+
+  rtc::scoped_refptr<VideoFrameBuffer> buffer =
+      input_image.video_frame_buffer();
+  if (buffer->type() == VideoFrameBuffer::Type::kNative ||
+      buffer->type() == VideoFrameBuffer::Type::kNV12) {
+    // Let the native or NV12 buffer scale each stream, so that it is only
+    // converted to I420, at the stream resolution, if the stream's encoder
+    // needs it.
+    for (size_t stream_idx = 0; stream_idx < streaminfos_.size();
+         ++stream_idx) {
+      if (needs_scaling[stream_idx]) {
+        scaled_buffers[stream_idx] =
+            buffer->Scale(streaminfos_[stream_idx].width,
+                          streaminfos_[stream_idx].height);
       }
     }
+    return scaled_buffers;
   }
 
-  return WEBRTC_VIDEO_CODEC_OK;
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> i420_buffers =
+      pyramid_scaler_.Scale(buffer->ToI420(), needs_scaling);
+  for (size_t stream_idx = 0; stream_idx < i420_buffers.size(); ++stream_idx)
+    scaled_buffers[stream_idx] = i420_buffers[stream_idx];
+  return scaled_buffers;
+}
+
+int SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const VideoFrame& input_image,
+    const std::vector<VideoFrameType>& frame_types,
+    const rtc::scoped_refptr<VideoFrameBuffer>& scaled_buffer) {
+  if (!scaled_buffer) {
+    return streaminfos_[stream_idx].encoder->Encode(input_image, &frame_types);
+  }
+
+  // UpdateRect is not propagated to lower simulcast layers currently.
+  // TODO(ilnik): Consider scaling UpdateRect together with the buffer.
+  VideoFrame frame(input_image);
+  frame.set_video_frame_buffer(scaled_buffer);
+  frame.set_rotation(webrtc::kVideoRotation_0);
+  frame.set_update_rect(
+      VideoFrame::UpdateRect{0, 0, frame.width(), frame.height()});
+  return streaminfos_[stream_idx].encoder->Encode(frame, &frame_types);
+}
+
+int SimulcastEncoderAdapter::EncodeStreamsInParallel(
+    const VideoFrame& input_image,
+    const std::vector<std::pair<size_t, std::vector<VideoFrameType>>>& streams,
+    const std::vector<rtc::scoped_refptr<VideoFrameBuffer>>& scaled_buffers) {
+  if (streams.empty()) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  rtc::Event done;
+  std::atomic<int> num_pending(static_cast<int>(streams.size()) - 1);
+  for (size_t i = 1; i < streams.size(); ++i) {
+    const size_t stream_idx = streams[i].first;
+    const std::vector<VideoFrameType>* frame_types = &streams[i].second;
+    streaminfos_[stream_idx].defer_encoded_images = true;
+    encode_queues_[stream_idx]->PostTask(
+        [this, stream_idx, frame_types, &input_image, &scaled_buffers, &done,
+         &num_pending] {
+          streaminfos_[stream_idx].encode_result =
+              EncodeStream(stream_idx, input_image, *frame_types,
+                           scaled_buffers[stream_idx]);
+          if (num_pending.fetch_sub(1) == 1) {
+            done.Set();
+          }
+        });
+  }
+
+  int ret = EncodeStream(streams[0].first, input_image, streams[0].second,
+                         scaled_buffers[streams[0].first]);
+  if (streams.size() > 1) {
+    done.Wait(rtc::Event::kForever);
+  }
+
+  // Deliver the held back encoded images in stream order, as if the streams
+  // had been encoded one after the other.
+  for (size_t i = 1; i < streams.size(); ++i) {
+    StreamInfo& stream_info = streaminfos_[streams[i].first];
+    stream_info.defer_encoded_images = false;
+    for (DeferredEncodedImage& deferred : stream_info.deferred_images) {
+      encoded_complete_callback_->OnEncodedImage(
+          deferred.encoded_image, &deferred.codec_specific_info,
+          deferred.fragmentation.get());
+    }
+    stream_info.deferred_images.clear();
+    if (ret == WEBRTC_VIDEO_CODEC_OK) {
+      ret = stream_info.encode_result;
+    }
+  }
+  return ret;
 }
 
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
@@ -566,6 +711,18 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
 
   stream_image.SetSpatialIndex(stream_idx);
 
+  StreamInfo& stream_info = streaminfos_[stream_idx];
+  if (stream_info.defer_encoded_images) {
+    DeferredEncodedImage deferred{stream_image, stream_codec_specific, nullptr};
+    if (fragmentation) {
+      deferred.fragmentation = std::make_unique<RTPFragmentationHeader>();
+      deferred.fragmentation->CopyFrom(*fragmentation);
+    }
+    stream_info.deferred_images.push_back(std::move(deferred));
+    return EncodedImageCallback::Result(EncodedImageCallback::Result::OK,
+                                        stream_image.Timestamp());
+  }
+
   return encoded_complete_callback_->OnEncodedImage(
       stream_image, &stream_codec_specific, fragmentation);
 }
@@ -665,6 +822,8 @@ VideoEncoder::EncoderInfo SimulcastEncoderAdapter::GetEncoderInfo() const {
       encoder_info.is_hardware_accelerated =
           encoder_impl_info.is_hardware_accelerated;
       encoder_info.has_internal_source = encoder_impl_info.has_internal_source;
+      encoder_info.preferred_pixel_formats =
+          encoder_impl_info.preferred_pixel_formats;
     } else {
       encoder_info.implementation_name += ", ";
       encoder_info.implementation_name += encoder_impl_info.implementation_name;
@@ -686,6 +845,17 @@ VideoEncoder::EncoderInfo SimulcastEncoderAdapter::GetEncoderInfo() const {
 
       // Has internal source only if all encoders have it.
       encoder_info.has_internal_source &= encoder_impl_info.has_internal_source;
+
+      // Pixel formats only if all encoders take them.
+      encoder_info.preferred_pixel_formats.erase(
+          std::remove_if(encoder_info.preferred_pixel_formats.begin(),
+                         encoder_info.preferred_pixel_formats.end(),
+                         [&](VideoFrameBuffer::Type type) {
+                           return !absl::c_linear_search(
+                               encoder_impl_info.preferred_pixel_formats,
+                               type);
+                         }),
+          encoder_info.preferred_pixel_formats.end());
     }
     encoder_info.fps_allocation[i] = encoder_impl_info.fps_allocation[0];
     encoder_info.requested_resolution_alignment = cricket::LeastCommonMultiple(
@@ -20,13 +20,19 @@
 
 #include "absl/types/optional.h"
 #include "api/fec_controller_override.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/video/video_frame_buffer.h"
 #include "api/video_codecs/sdp_video_format.h"
 #include "api/video_codecs/video_encoder.h"
+#include "common_video/include/i420_pyramid_scaler.h"
+#include "modules/include/module_common_types.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "modules/video_coding/utility/framerate_controller.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/synchronization/sequence_checker.h"
 #include "rtc_base/system/rtc_export.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -37,6 +43,16 @@ class VideoEncoderFactory;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+//
+// With the field trial WebRTC-SimulcastEncoderAdapter-ParallelEncoding
+// enabled, the layers of a frame are scaled and encoded concurrently, each
+// layer but the first on a thread of its own, and Encode() returns once all of
+// them are done. Encoded images of the other layers are held back and
+// delivered from Encode() after those of the first layer, so the callback sees
+// them from the encoder task queue and in the same order as without the
+// trial. Layers are still encoded serially if an encoder is hardware
+// accelerated or has an internal source, since such encoders may deliver
+// encoded images after Encode() has returned.
 class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
  public:
   // TODO(bugs.webrtc.org/11000): Remove when downstream usage is gone.
@@ -76,6 +92,12 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
   EncoderInfo GetEncoderInfo() const override;
 
  private:
+  struct DeferredEncodedImage {
+    EncodedImage encoded_image;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   struct StreamInfo {
     StreamInfo(std::unique_ptr<VideoEncoder> encoder,
                std::unique_ptr<EncodedImageCallback> callback,
@@ -97,6 +119,11 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
     uint16_t height;
     bool key_frame_request;
     bool send_stream;
+    // Set while the stream is encoded on its encode queue, during which its
+    // encoded images are collected in |deferred_images|.
+    bool defer_encoded_images = false;
+    std::vector<DeferredEncodedImage> deferred_images;
+    int encode_result = 0;
   };
 
   enum class StreamResolution {
@@ -114,6 +141,35 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
 
   bool Initialized() const;
 
+  // Decides whether the stream encodes |input_image|, and with which frame
+  // types. Updates the stream's key frame request and frame rate state.
+  bool PrepareStreamFrameTypes(size_t stream_idx,
+                               bool send_key_frame,
+                               uint32_t frame_timestamp_ms,
+                               std::vector<VideoFrameType>* frame_types);
+  // Whether |input_image| can be passed to the stream's encoder as is, without
+  // scaling.
+  bool CanPassThrough(size_t stream_idx, const VideoFrame& input_image) const;
+  // Returns the scaled buffers of |streams|, indexed by stream. I420 input is
+  // scaled in a single pyramid pass, native input by the buffer itself.
+  // Streams that need no scaling get null.
+  std::vector<rtc::scoped_refptr<VideoFrameBuffer>> ScaleStreams(
+      const VideoFrame& input_image,
+      const std::vector<std::pair<size_t, std::vector<VideoFrameType>>>&
+          streams);
+  // Encodes |input_image| with the stream's encoder, replacing its buffer with
+  // |scaled_buffer| unless null.
+  int EncodeStream(
+      size_t stream_idx,
+      const VideoFrame& input_image,
+      const std::vector<VideoFrameType>& frame_types,
+      const rtc::scoped_refptr<VideoFrameBuffer>& scaled_buffer);
+  int EncodeStreamsInParallel(
+      const VideoFrame& input_image,
+      const std::vector<std::pair<size_t, std::vector<VideoFrameType>>>&
+          streams,
+      const std::vector<rtc::scoped_refptr<VideoFrameBuffer>>& scaled_buffers);
+
   void DestroyStoredEncoders();
 
   volatile int inited_;  // Accessed atomically.
@@ -131,9 +187,21 @@ class RTC_EXPORT SimulcastEncoderAdapter : public VideoEncoder {
   // have to be recreated. Remaining encoders are destroyed by the destructor.
   std::stack<std::unique_ptr<VideoEncoder>> stored_encoders_;
 
+  // Produces the input of the streams that encode a scaled down frame.
+  I420PyramidScaler pyramid_scaler_;
+
   const absl::optional<unsigned int> experimental_boosted_screenshare_qp_;
   const bool boost_base_layer_quality_;
   const bool prefer_temporal_support_on_base_layer_;
+
+  const bool parallel_encoding_enabled_;
+  // Whether the current configuration encodes streams in parallel.
+  bool encode_in_parallel_;
+  std::unique_ptr<TaskQueueFactory> task_queue_factory_;
+  // Indexed by stream, kept across InitEncode() calls. The first stream
+  // encoded for a frame is encoded on the encoder task queue, so the queue of
+  // stream 0 is never created.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encode_queues_;
 };
 
 }  // namespace webrtc
@@ -28,10 +28,17 @@
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "modules/video_coding/utility/simulcast_test_fixture_impl.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
 using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Invoke;
 using ::testing::Return;
 using EncoderInfo = webrtc::VideoEncoder::EncoderInfo;
 using FramerateFractions =
@@ -1048,6 +1055,61 @@ TEST_F(TestSimulcastEncoderAdapterFake, NativeHandleForwardingOnlyIfSupported) {
   EXPECT_EQ(0, adapter_->Encode(input_frame, &frame_types));
 }
 
+class FakeScalableNativeBuffer : public FakeNativeBufferI420 {
+ public:
+  FakeScalableNativeBuffer(int width, int height)
+      : FakeNativeBufferI420(width, height, /*allow_to_i420=*/false) {}
+
+  rtc::scoped_refptr<VideoFrameBuffer> CropAndScale(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override {
+    return new rtc::RefCountedObject<FakeScalableNativeBuffer>(scaled_width,
+                                                               scaled_height);
+  }
+};
+
+TEST_F(TestSimulcastEncoderAdapterFake, ScalesNativeBufferWithoutConversion) {
+  SimulcastTestFixtureImpl::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
+      kVideoCodecVP8);
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, kSettings));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  ASSERT_EQ(3u, helper_->factory()->encoders().size());
+  auto& encoders = helper_->factory()->encoders();
+
+  rtc::scoped_refptr<VideoFrameBuffer> buffer(
+      new rtc::RefCountedObject<FakeScalableNativeBuffer>(1280, 720));
+  VideoFrame input_frame = VideoFrame::Builder()
+                               .set_video_frame_buffer(buffer)
+                               .set_timestamp_rtp(100)
+                               .set_timestamp_ms(1000)
+                               .set_rotation(kVideoRotation_0)
+                               .build();
+  // The lower streams get native buffers scaled by the input buffer, the top
+  // stream gets the input frame as is.
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_CALL(*encoders[i], Encode)
+        .WillOnce([&, i](const VideoFrame& frame,
+                         const std::vector<VideoFrameType>* frame_types) {
+          EXPECT_EQ(frame.video_frame_buffer()->type(),
+                    VideoFrameBuffer::Type::kNative);
+          EXPECT_EQ(frame.width(), codec_.simulcastStream[i].width);
+          EXPECT_EQ(frame.height(), codec_.simulcastStream[i].height);
+          return 0;
+        });
+  }
+  EXPECT_CALL(*encoders[2], Encode(::testing::Ref(input_frame), _)).Times(1);
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, &frame_types));
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, TestFailureReturnCodesFromEncodeCalls) {
   SimulcastTestFixtureImpl::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile),
@@ -1527,5 +1589,222 @@ TEST_F(TestSimulcastEncoderAdapterFake, SupportsPerSimulcastLayerMaxFramerate) {
   EXPECT_EQ(10u, helper_->factory()->encoders()[2]->codec().maxFramerate);
 }
 
+constexpr char kParallelEncodingFieldTrial[] =
+    "WebRTC-SimulcastEncoderAdapter-ParallelEncoding/Enabled/";
+// Enough for all streams of SimulcastTestFixtureImpl::DefaultSettings().
+constexpr uint32_t kAllStreamsBitrateBps = 5000000;
+
+VideoFrame CreateInputFrame(uint32_t rtp_timestamp) {
+  rtc::scoped_refptr<I420Buffer> input_buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  input_buffer->InitializeData();
+  return VideoFrame::Builder()
+      .set_video_frame_buffer(input_buffer)
+      .set_timestamp_rtp(rtp_timestamp)
+      .set_timestamp_us(0)
+      .set_rotation(kVideoRotation_0)
+      .build();
+}
+
+TEST_F(TestSimulcastEncoderAdapterFake, ReusesScaledBuffersBetweenFrames) {
+  SetupCodec();
+  adapter_->SetRates(VideoEncoder::RateControlParameters(
+      rate_allocator_->Allocate(
+          VideoBitrateAllocationParameters(kAllStreamsBitrateBps, 30)),
+      30.0));
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+
+  // The lower streams get pooled buffers, which are recycled once the
+  // encoders have released them.
+  std::array<std::vector<const uint8_t*>, 2> data_y;
+  for (size_t i = 0; i < data_y.size(); ++i) {
+    EXPECT_CALL(*encoders[i], Encode)
+        .Times(2)
+        .WillRepeatedly([&data_y, i](const VideoFrame& frame,
+                                     const std::vector<VideoFrameType>*) {
+          data_y[i].push_back(frame.video_frame_buffer()->GetI420()->DataY());
+          return 0;
+        });
+  }
+  EXPECT_CALL(*encoders[2], Encode).Times(2).WillRepeatedly(Return(0));
+  EXPECT_EQ(0, adapter_->Encode(CreateInputFrame(0), nullptr));
+  EXPECT_EQ(0, adapter_->Encode(CreateInputFrame(3000), nullptr));
+
+  for (const std::vector<const uint8_t*>& stream_data_y : data_y) {
+    ASSERT_EQ(2u, stream_data_y.size());
+    EXPECT_EQ(stream_data_y[0], stream_data_y[1]);
+  }
+}
+
+class TestSimulcastEncoderAdapterParallelEncoding
+    : public TestSimulcastEncoderAdapterFake {
+ public:
+  TestSimulcastEncoderAdapterParallelEncoding()
+      : field_trials_(kParallelEncodingFieldTrial),
+        test_thread_(rtc::CurrentThreadRef()) {}
+
+  Result OnEncodedImage(const EncodedImage& encoded_image,
+                        const CodecSpecificInfo* codec_specific_info,
+                        const RTPFragmentationHeader* fragmentation) override {
+    EXPECT_TRUE(rtc::IsThreadRefEqual(rtc::CurrentThreadRef(), test_thread_));
+    encoded_simulcast_indices_.push_back(
+        encoded_image.SpatialIndex().value_or(-1));
+    return TestSimulcastEncoderAdapterFake::OnEncodedImage(
+        encoded_image, codec_specific_info, fragmentation);
+  }
+
+ protected:
+  void SetRatesForAllStreams() {
+    adapter_->SetRates(VideoEncoder::RateControlParameters(
+        rate_allocator_->Allocate(
+            VideoBitrateAllocationParameters(kAllStreamsBitrateBps, 30)),
+        30.0));
+  }
+
+  // Makes the encoder of each stream record the thread it encodes on and send
+  // an encoded image, returning |return_values[i]|.
+  void ExpectEncode(std::array<rtc::PlatformThreadRef, 3>* encode_threads,
+                    std::array<int32_t, 3> return_values = {0, 0, 0}) {
+    std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+    ASSERT_EQ(3u, encoders.size());
+    for (size_t i = 0; i < encoders.size(); ++i) {
+      MockVideoEncoder* encoder = encoders[i];
+      int32_t return_value = return_values[i];
+      EXPECT_CALL(*encoder, Encode(_, _))
+          .WillOnce(Invoke([encoder, encode_threads, i, return_value](
+                               const VideoFrame& frame,
+                               const std::vector<VideoFrameType>*) {
+            (*encode_threads)[i] = rtc::CurrentThreadRef();
+            // Without reordering, the lowest stream would be delivered
+            // last.
+            if (i == 0)
+              SleepMs(20);
+            encoder->SendEncodedImage(frame.width(), frame.height());
+            return return_value;
+          }));
+    }
+  }
+
+  ScopedFieldTrials field_trials_;
+  const rtc::PlatformThreadRef test_thread_;
+  std::vector<int> encoded_simulcast_indices_;
+};
+
+TEST_F(TestSimulcastEncoderAdapterParallelEncoding,
+       EncodesStreamsConcurrentlyAndDeliversInStreamOrder) {
+  SetupCodec();
+  SetRatesForAllStreams();
+  std::array<rtc::PlatformThreadRef, 3> encode_threads;
+  ExpectEncode(&encode_threads);
+
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            adapter_->Encode(CreateInputFrame(0), &frame_types));
+
+  EXPECT_THAT(encoded_simulcast_indices_, ElementsAre(0, 1, 2));
+  EXPECT_TRUE(rtc::IsThreadRefEqual(encode_threads[0], test_thread_));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(encode_threads[1], test_thread_));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(encode_threads[2], test_thread_));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(encode_threads[1], encode_threads[2]));
+
+  // Encoded images sent outside of Encode() are passed on right away.
+  helper_->factory()->encoders()[2]->SendEncodedImage(1280, 720);
+  EXPECT_THAT(encoded_simulcast_indices_, ElementsAre(0, 1, 2, 2));
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallelEncoding,
+       ReturnsFailureOfConcurrentlyEncodedStream) {
+  SetupCodec();
+  SetRatesForAllStreams();
+  std::array<rtc::PlatformThreadRef, 3> encode_threads;
+  ExpectEncode(&encode_threads,
+               {WEBRTC_VIDEO_CODEC_OK, WEBRTC_VIDEO_CODEC_OK,
+                WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE});
+
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_FALLBACK_SOFTWARE,
+            adapter_->Encode(CreateInputFrame(0), &frame_types));
+  EXPECT_THAT(encoded_simulcast_indices_, ElementsAre(0, 1, 2));
+}
+
+TEST_F(TestSimulcastEncoderAdapterParallelEncoding,
+       EncodesSeriallyWithHardwareEncoders) {
+  SetupCodec();
+  for (MockVideoEncoder* encoder : helper_->factory()->encoders())
+    encoder->set_is_hardware_accelerated(true);
+  // Reinitializing reuses the encoders.
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, kSettings));
+  SetRatesForAllStreams();
+  std::array<rtc::PlatformThreadRef, 3> encode_threads;
+  ExpectEncode(&encode_threads);
+
+  std::vector<VideoFrameType> frame_types(3, VideoFrameType::kVideoFrameKey);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            adapter_->Encode(CreateInputFrame(0), &frame_types));
+
+  EXPECT_THAT(encoded_simulcast_indices_, ElementsAre(0, 1, 2));
+  for (const rtc::PlatformThreadRef& thread : encode_threads)
+    EXPECT_TRUE(rtc::IsThreadRefEqual(thread, test_thread_));
+}
+
+// Compares the latency of Encode() for three layers with and without parallel
+// encoding, with fake encoders that take time in proportion to the number of
+// pixels they encode, 9 ms for the 720p stream.
+TEST(SimulcastEncoderAdapterParallelEncodingTest, DISABLED_EncodeLatency) {
+  class NullCallback : public EncodedImageCallback {
+   public:
+    Result OnEncodedImage(
+        const EncodedImage& encoded_image,
+        const CodecSpecificInfo* codec_specific_info,
+        const RTPFragmentationHeader* fragmentation) override {
+      return Result(Result::OK);
+    }
+  };
+  constexpr int kNumFrames = 200;
+  constexpr int kPixelsPerMs = 100000;
+
+  for (bool parallel : {false, true}) {
+    ScopedFieldTrials field_trials(parallel ? kParallelEncodingFieldTrial : "");
+    TestSimulcastEncoderAdapterFakeHelper helper(
+        /*use_fallback_factory=*/false, SdpVideoFormat("VP8"));
+    std::unique_ptr<VideoEncoder> adapter(helper.CreateMockEncoderAdapter());
+    VideoCodec codec;
+    SimulcastTestFixtureImpl::DefaultSettings(
+        &codec, static_cast<const int*>(kTestTemporalLayerProfile),
+        kVideoCodecVP8);
+    ASSERT_EQ(0, adapter->InitEncode(&codec, kSettings));
+    NullCallback callback;
+    adapter->RegisterEncodeCompleteCallback(&callback);
+    SimulcastRateAllocator rate_allocator(codec);
+    adapter->SetRates(VideoEncoder::RateControlParameters(
+        rate_allocator.Allocate(
+            VideoBitrateAllocationParameters(kAllStreamsBitrateBps, 30)),
+        30.0));
+    for (MockVideoEncoder* encoder : helper.factory()->encoders()) {
+      ON_CALL(*encoder, Encode(_, _))
+          .WillByDefault(Invoke([](const VideoFrame& frame,
+                                   const std::vector<VideoFrameType>*) {
+            SleepMs(frame.width() * frame.height() / kPixelsPerMs);
+            return WEBRTC_VIDEO_CODEC_OK;
+          }));
+    }
+
+    int64_t total_us = 0;
+    std::vector<VideoFrameType> frame_types(3,
+                                            VideoFrameType::kVideoFrameDelta);
+    for (int i = 0; i < kNumFrames; ++i) {
+      VideoFrame frame = CreateInputFrame(i * 3000);
+      int64_t start_us = rtc::TimeMicros();
+      EXPECT_EQ(0, adapter->Encode(frame, &frame_types));
+      total_us += rtc::TimeMicros() - start_us;
+    }
+    RTC_LOG(LS_INFO) << (parallel ? "Parallel" : "Serial")
+                     << " encoding of 3 layers took " << total_us / kNumFrames
+                     << " us per frame.";
+    adapter->Release();
+  }
+}
+
 }  // namespace test
 }  // namespace webrtc
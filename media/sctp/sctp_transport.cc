@@ -22,6 +22,8 @@ enum PreservedErrno {
 #include <stdio.h>
 
 #include <memory>
+#include <unordered_map>
+#include <utility>
 
 #include "absl/algorithm/container.h"
 #include "absl/base/attributes.h"
@@ -35,12 +37,16 @@ enum PreservedErrno {
 #include "rtc_base/arraysize.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/critical_section.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/numerics/safe_minmax.h"
 #include "rtc_base/string_utils.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
 #include "rtc_base/trace_event.h"
+#include "system_wrappers/include/field_trial.h"
 #include "usrsctplib/usrsctp.h"
 
 namespace {
@@ -48,6 +54,9 @@ namespace {
 // The biggest SCTP packet. Starting from a 'safe' wire MTU value of 1280,
 // take off 80 bytes for DTLS/TURN/TCP/IP overhead.
 static constexpr size_t kSctpMtu = 1200;
+// The biggest SCTP packet that may be configured, for paths known to carry
+// 1500 byte packets. The same 80 bytes are taken off.
+static constexpr size_t kMaxSctpMtu = 1420;
 
 // Set the initial value of the static SCTP Data Engines reference count.
 ABSL_CONST_INIT int g_usrsctp_usage_count = 0;
@@ -197,6 +206,34 @@ sctp_sendv_spa CreateSctpSendParams(const cricket::SendDataParams& params) {
 
 namespace cricket {
 
+// Maps the usrsctp sockets to the transports that own them, for the usrsctp
+// callbacks that are only given the socket. This lock is only held for the
+// lookup, while usrsctp_getladdrs() takes a usrsctp global lock and allocates
+// the address list.
+class SctpTransportMap {
+ public:
+  void Add(struct socket* sock, SctpTransport* transport) {
+    rtc::CritScope cs(&crit_);
+    transports_[sock] = transport;
+  }
+
+  void Remove(struct socket* sock) {
+    rtc::CritScope cs(&crit_);
+    transports_.erase(sock);
+  }
+
+  SctpTransport* Find(struct socket* sock) const {
+    rtc::CritScope cs(&crit_);
+    auto it = transports_.find(sock);
+    return it != transports_.end() ? it->second : nullptr;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  std::unordered_map<struct socket*, SctpTransport*> transports_
+      RTC_GUARDED_BY(crit_);
+};
+
 // Handles global init/deinit, and mapping from usrsctp callbacks to
 // SctpTransport calls.
 class SctpTransport::UsrSctpWrapper {
@@ -339,13 +376,8 @@ class SctpTransport::UsrSctpWrapper {
         // A message with a new sid, but haven't seen the EOR for the
         // previous message. Deliver the previous partial message to avoid
         // merging messages from different sid's.
-        transport->invoker_.AsyncInvoke<void>(
-            RTC_FROM_HERE, transport->network_thread_,
-            rtc::Bind(&SctpTransport::OnInboundPacketFromSctpToTransport,
-                      transport, transport->partial_incoming_message_,
-                      transport->partial_params_, transport->partial_flags_));
-
-        transport->partial_incoming_message_.Clear();
+        transport->DeliverPartialIncomingMessage(transport->partial_params_,
+                                                 transport->partial_flags_);
       }
 
       transport->partial_incoming_message_.AppendData(
@@ -372,44 +404,23 @@ class SctpTransport::UsrSctpWrapper {
         RTC_LOG(LS_WARNING) << "Chunking SCTP message without the EOR bit set.";
       }
 
-      // The ownership of the packet transfers to |invoker_|. Using
-      // CopyOnWriteBuffer is the most convenient way to do this.
-      transport->invoker_.AsyncInvoke<void>(
-          RTC_FROM_HERE, transport->network_thread_,
-          rtc::Bind(&SctpTransport::OnInboundPacketFromSctpToTransport,
-                    transport, transport->partial_incoming_message_, params,
-                    flags));
-
-      transport->partial_incoming_message_.Clear();
+      transport->DeliverPartialIncomingMessage(params, flags);
     }
     return 1;
   }
 
-  static SctpTransport* GetTransportFromSocket(struct socket* sock) {
-    struct sockaddr* addrs = nullptr;
-    int naddrs = usrsctp_getladdrs(sock, 0, &addrs);
-    if (naddrs <= 0 || addrs[0].sa_family != AF_CONN) {
-      return nullptr;
-    }
-    // usrsctp_getladdrs() returns the addresses bound to this socket, which
-    // contains the SctpTransport* as sconn_addr.  Read the pointer,
-    // then free the list of addresses once we have the pointer.  We only open
-    // AF_CONN sockets, and they should all have the sconn_addr set to the
-    // pointer that created them, so [0] is as good as any other.
-    struct sockaddr_conn* sconn =
-        reinterpret_cast<struct sockaddr_conn*>(&addrs[0]);
-    SctpTransport* transport =
-        reinterpret_cast<SctpTransport*>(sconn->sconn_addr);
-    usrsctp_freeladdrs(addrs);
-
-    return transport;
+  static SctpTransportMap* transport_map() {
+    // Never destroyed, since usrsctp callbacks may use it until the usrsctp
+    // threads have stopped.
+    static SctpTransportMap* const map = new SctpTransportMap();
+    return map;
   }
 
   static int SendThresholdCallback(struct socket* sock, uint32_t sb_free) {
     // Fired on our I/O thread. SctpTransport::OnPacketReceived() gets
     // a packet containing acknowledgments, which goes into usrsctp_conninput,
     // and then back here.
-    SctpTransport* transport = GetTransportFromSocket(sock);
+    SctpTransport* transport = transport_map()->Find(sock);
     if (!transport) {
       RTC_LOG(LS_ERROR)
           << "SendThresholdCallback: Failed to get transport for socket "
@@ -428,6 +439,7 @@ SctpTransport::SctpTransport(rtc::Thread* network_thread,
       was_ever_writable_(transport ? transport->writable() : false) {
   RTC_DCHECK(network_thread_);
   RTC_DCHECK_RUN_ON(network_thread_);
+  ParseSocketConfig();
   ConnectTransportSignals();
 }
 
@@ -465,6 +477,26 @@ void SctpTransport::SetDtlsTransport(rtc::PacketTransportInternal* transport) {
   }
 }
 
+void SctpTransport::ParseSocketConfig() {
+  webrtc::FieldTrialParameter<int> mtu("mtu", kSctpMtu);
+  webrtc::FieldTrialOptional<int> send_buffer("send_buffer");
+  webrtc::FieldTrialOptional<int> receive_buffer("receive_buffer");
+  webrtc::FieldTrialParameter<bool> nodelay("nodelay", true);
+  webrtc::ParseFieldTrial(
+      {&mtu, &send_buffer, &receive_buffer, &nodelay},
+      webrtc::field_trial::FindFullName("WebRTC-SctpTransportConfig"));
+
+  sctp_mtu_ = rtc::SafeClamp<size_t>(mtu.Get(), kSctpMtu, kMaxSctpMtu);
+  // Smaller buffers than the default would not fit the largest messages.
+  if (send_buffer && *send_buffer >= kSctpSendBufferSize) {
+    send_buffer_size_ = *send_buffer;
+  }
+  if (receive_buffer && *receive_buffer >= kSctpSendBufferSize) {
+    receive_buffer_size_ = *receive_buffer;
+  }
+  nodelay_ = nodelay.Get();
+}
+
 bool SctpTransport::Start(int local_sctp_port,
                           int remote_sctp_port,
                           int max_message_size) {
@@ -733,7 +765,7 @@ bool SctpTransport::Connect() {
   params.spp_flags = SPP_PMTUD_DISABLE;
   // The MTU value provided specifies the space available for chunks in the
   // packet, so we subtract the SCTP header size.
-  params.spp_pathmtu = kSctpMtu - sizeof(struct sctp_common_header);
+  params.spp_pathmtu = sctp_mtu_ - sizeof(struct sctp_common_header);
   if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_PEER_ADDR_PARAMS, &params,
                          sizeof(params))) {
     RTC_LOG_ERRNO(LS_ERROR) << debug_name_
@@ -761,10 +793,12 @@ bool SctpTransport::OpenSctpSocket() {
   // still have to do something reasonable here.  Look up what the buffer's real
   // size is and set our threshold to something reasonable.
   static const int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  const int send_threshold =
+      send_buffer_size_ ? *send_buffer_size_ / 2 : kSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, &UsrSctpWrapper::OnSctpInboundPacket,
-      &UsrSctpWrapper::SendThresholdCallback, kSendThreshold, this);
+      &UsrSctpWrapper::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     RTC_LOG_ERRNO(LS_ERROR) << debug_name_
                             << "->OpenSctpSocket(): "
@@ -779,6 +813,7 @@ bool SctpTransport::OpenSctpSocket() {
     UsrSctpWrapper::DecrementUsrSctpUsageCount();
     return false;
   }
+  UsrSctpWrapper::transport_map()->Add(sock_, this);
   // Register this class as an address for usrsctp. This is used by SCTP to
   // direct the packets received (by the created socket) to this class.
   usrsctp_register_address(this);
@@ -823,8 +858,8 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
-  // Nagle.
-  uint32_t nodelay = 1;
+  // Nagle. Leaving it enabled bundles small messages into shared packets.
+  uint32_t nodelay = nodelay_ ? 1 : 0;
   if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_NODELAY, &nodelay,
                          sizeof(nodelay))) {
     RTC_LOG_ERRNO(LS_ERROR) << debug_name_
@@ -833,6 +868,26 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
+  // Larger buffers keep more data in flight on links with a high
+  // bandwidth-delay product. The receive buffer is advertised in the INIT, so
+  // it has to be set before connecting.
+  if (send_buffer_size_ &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, &*send_buffer_size_,
+                         sizeof(*send_buffer_size_))) {
+    RTC_LOG_ERRNO(LS_ERROR) << debug_name_
+                            << "->ConfigureSctpSocket(): "
+                               "Failed to set SO_SNDBUF.";
+    return false;
+  }
+  if (receive_buffer_size_ &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &*receive_buffer_size_,
+                         sizeof(*receive_buffer_size_))) {
+    RTC_LOG_ERRNO(LS_ERROR) << debug_name_
+                            << "->ConfigureSctpSocket(): "
+                               "Failed to set SO_RCVBUF.";
+    return false;
+  }
+
   // Explicit EOR.
   uint32_t eor = 1;
   if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_EXPLICIT_EOR, &eor,
@@ -870,6 +925,7 @@ void SctpTransport::CloseSctpSocket() {
     // We assume that SO_LINGER option is set to close the association when
     // close is called. This means that any pending packets in usrsctp will be
     // discarded instead of being sent.
+    UsrSctpWrapper::transport_map()->Remove(sock_);
     usrsctp_close(sock_);
     sock_ = nullptr;
     usrsctp_deregister_address(this);
@@ -1037,15 +1093,28 @@ sockaddr_conn SctpTransport::GetSctpSockAddr(int port) {
   return sconn;
 }
 
+void SctpTransport::DeliverPartialIncomingMessage(
+    const ReceiveDataParams& params,
+    int flags) {
+  // The ownership of the message transfers to |invoker_|, and from there all
+  // the way to the receivers, without copying. The next message is assembled
+  // in a new buffer of its own size, rather than one as large as this one.
+  rtc::CopyOnWriteBuffer message = std::move(partial_incoming_message_);
+  invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, network_thread_,
+      rtc::Bind(&SctpTransport::OnInboundPacketFromSctpToTransport, this,
+                message, params, flags));
+}
+
 void SctpTransport::OnPacketFromSctpToNetwork(
     const rtc::CopyOnWriteBuffer& buffer) {
   RTC_DCHECK_RUN_ON(network_thread_);
-  if (buffer.size() > (kSctpMtu)) {
+  if (buffer.size() > sctp_mtu_) {
     RTC_LOG(LS_ERROR) << debug_name_
                       << "->OnPacketFromSctpToNetwork(...): "
                          "SCTP seems to have made a packet that is bigger "
                          "than its official MTU: "
-                      << buffer.size() << " vs max of " << kSctpMtu;
+                      << buffer.size() << " vs max of " << sctp_mtu_;
   }
   TRACE_EVENT0("webrtc", "SctpTransport::OnPacketFromSctpToNetwork");
 
@@ -132,6 +132,10 @@ class SctpTransport : public SctpTransportInternal,
   void ConnectTransportSignals();
   void DisconnectTransportSignals();
 
+  // Reads the socket options from the WebRTC-SctpTransportConfig field
+  // trial, e.g. "mtu:1400,send_buffer:1048576,receive_buffer:1048576".
+  void ParseSocketConfig();
+
   // Creates the socket and connects.
   bool Connect();
 
@@ -170,6 +174,10 @@ class SctpTransport : public SctpTransportInternal,
   void OnSendThresholdCallback();
   sockaddr_conn GetSctpSockAddr(int port);
 
+  // Posts |partial_incoming_message_| to the network thread, leaving it
+  // empty. Called on the usrsctp thread.
+  void DeliverPartialIncomingMessage(const ReceiveDataParams& params,
+                                     int flags);
   // Called using |invoker_| to send packet on the network.
   void OnPacketFromSctpToNetwork(const rtc::CopyOnWriteBuffer& buffer);
   // Called using |invoker_| to decide what to do with the packet.
@@ -210,6 +218,14 @@ class SctpTransport : public SctpTransportInternal,
   int max_message_size_ = kSctpSendBufferSize;
   struct socket* sock_ = nullptr;  // The socket created by usrsctp_socket(...).
 
+  // The biggest SCTP packet to send.
+  size_t sctp_mtu_;
+  // Socket buffer sizes, if not the usrsctp defaults.
+  absl::optional<int> send_buffer_size_;
+  absl::optional<int> receive_buffer_size_;
+  // Disables Nagle's algorithm, so that each message is sent right away.
+  bool nodelay_ = true;
+
   // Has Start been called? Don't create SCTP socket until it has.
   bool started_ = false;
   // Are we ready to queue data (SCTP socket created, and not blocked due to
@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -24,6 +25,8 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 
 namespace {
@@ -100,6 +103,28 @@ class SctpTransportObserver : public sigslot::has_slots<> {
   bool ready_to_send_ = false;
 };
 
+// Records the size of the biggest packet received by a transport.
+class PacketSizeRecorder : public sigslot::has_slots<> {
+ public:
+  explicit PacketSizeRecorder(rtc::PacketTransportInternal* transport) {
+    transport->SignalReadPacket.connect(this,
+                                        &PacketSizeRecorder::OnPacketRead);
+  }
+
+  size_t max_packet_size() const { return max_packet_size_; }
+
+ private:
+  void OnPacketRead(rtc::PacketTransportInternal* transport,
+                    const char* data,
+                    size_t len,
+                    const int64_t& packet_time_us,
+                    int flags) {
+    max_packet_size_ = std::max(max_packet_size_, len);
+  }
+
+  size_t max_packet_size_ = 0;
+};
+
 // Helper class used to immediately attempt to reopen a stream as soon as it's
 // been closed.
 class SignalTransportClosedReopener : public sigslot::has_slots<> {
@@ -713,6 +738,51 @@ TEST_F(SctpTransportTest, RejectsTooSmallMessageSize) {
   EXPECT_FALSE(transport->Start(kSctpDefaultPort, kSctpDefaultPort, 0));
 }
 
+TEST_F(SctpTransportTest, SendsPacketsUpToConfiguredMtu) {
+  webrtc::test::ScopedFieldTrials trials(
+      "WebRTC-SctpTransportConfig/mtu:1400/");
+  SetupConnectedTransportsWithTwoStreams();
+  PacketSizeRecorder recorder(fake_dtls2());
+  EXPECT_EQ_WAIT(1, transport1_ready_to_send_count(), kDefaultTimeout);
+
+  SendDataResult result;
+  std::string message(10000, 'a');
+  ASSERT_TRUE(SendData(transport1(), 1, message, &result));
+  EXPECT_TRUE_WAIT(ReceivedData(receiver2(), 1, message), kDefaultTimeout);
+  EXPECT_GT(recorder.max_packet_size(), 1200u);
+  EXPECT_LE(recorder.max_packet_size(), 1400u);
+}
+
+// Reports the throughput of a bulk transfer, for comparing socket
+// configurations.
+TEST_F(SctpTransportTest, DISABLED_BulkTransferThroughput) {
+  constexpr size_t kMessageSize = 64 * 1024;
+  constexpr size_t kNumMessages = 1000;
+  SetupConnectedTransportsWithTwoStreams();
+  EXPECT_EQ_WAIT(1, transport1_ready_to_send_count(), kDefaultTimeout);
+
+  const std::string message(kMessageSize, 'a');
+  const int64_t start_ms = rtc::TimeMillis();
+  size_t num_sent = 0;
+  while (num_sent < kNumMessages) {
+    SendDataResult result;
+    const int ready_to_send_count = transport1_ready_to_send_count();
+    if (SendData(transport1(), 1, message, &result, /*ordered=*/true)) {
+      ++num_sent;
+      continue;
+    }
+    ASSERT_EQ(SDR_BLOCK, result);
+    ASSERT_TRUE_WAIT(transport1_ready_to_send_count() > ready_to_send_count,
+                     kDefaultTimeout);
+  }
+  EXPECT_EQ_WAIT(kNumMessages, receiver2()->num_messages_received(),
+                 kDefaultTimeout);
+  const int64_t elapsed_ms = std::max<int64_t>(rtc::TimeMillis() - start_ms, 1);
+  RTC_LOG(LS_INFO) << "Transferred " << kNumMessages * kMessageSize
+                   << " bytes in " << elapsed_ms << " ms, "
+                   << kNumMessages * kMessageSize * 8 / elapsed_ms << " kbps.";
+}
+
 TEST_F(SctpTransportTest, RejectsSendTooLargeMessages) {
   SetupConnectedTransportsWithTwoStreams();
   // Use "Start" to reduce the max message size
@@ -13,6 +13,7 @@
 #include <assert.h>
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 
 #include "absl/strings/match.h"
 #include "api/array_view.h"
@@ -134,6 +135,10 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
 
   int InitializeReceiverSafe() RTC_EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
+  // Returns the receiver, creating it on first use. Modules that only send
+  // never create it, and so don't carry a NetEq.
+  acm2::AcmReceiver* receiver();
+
   bool HaveValidEncoder(const char* caller_name) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
@@ -161,7 +166,11 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
   uint32_t expected_codec_ts_ RTC_GUARDED_BY(acm_crit_sect_);
   uint32_t expected_in_ts_ RTC_GUARDED_BY(acm_crit_sect_);
   acm2::ACMResampler resampler_ RTC_GUARDED_BY(acm_crit_sect_);
-  acm2::AcmReceiver receiver_;  // AcmReceiver has it's own internal lock.
+  const AudioCodingModule::Config config_;
+  rtc::CriticalSection receiver_crit_sect_;
+  // AcmReceiver has it's own internal lock. Never reset once created.
+  std::unique_ptr<acm2::AcmReceiver> receiver_
+      RTC_GUARDED_BY(receiver_crit_sect_);
   ChangeLogger bitrate_logger_ RTC_GUARDED_BY(acm_crit_sect_);
 
   // Current encoder stack, provided by a call to RegisterEncoder.
@@ -208,7 +217,7 @@ AudioCodingModuleImpl::AudioCodingModuleImpl(
     const AudioCodingModule::Config& config)
     : expected_codec_ts_(0xD87F3F9F),
       expected_in_ts_(0xD87F3F9F),
-      receiver_(config),
+      config_(config),
       bitrate_logger_("WebRTC.Audio.TargetBitrateInKbps"),
       encoder_stack_(nullptr),
       previous_pltype_(255),
@@ -539,19 +548,29 @@ int AudioCodingModuleImpl::InitializeReceiver() {
 int AudioCodingModuleImpl::InitializeReceiverSafe() {
   // If the receiver is already initialized then we want to destroy any
   // existing decoders. After a call to this function, we should have a clean
-  // start-up.
-  if (receiver_initialized_)
-    receiver_.RemoveAllCodecs();
-  receiver_.FlushBuffers();
+  // start-up. A receiver that is created later starts up clean.
+  rtc::CritScope lock(&receiver_crit_sect_);
+  if (receiver_) {
+    if (receiver_initialized_)
+      receiver_->RemoveAllCodecs();
+    receiver_->FlushBuffers();
+  }
 
   receiver_initialized_ = true;
   return 0;
 }
 
+acm2::AcmReceiver* AudioCodingModuleImpl::receiver() {
+  rtc::CritScope lock(&receiver_crit_sect_);
+  if (!receiver_)
+    receiver_ = std::make_unique<acm2::AcmReceiver>(config_);
+  return receiver_.get();
+}
+
 void AudioCodingModuleImpl::SetReceiveCodecs(
     const std::map<int, SdpAudioFormat>& codecs) {
   rtc::CritScope lock(&acm_crit_sect_);
-  receiver_.SetCodecs(codecs);
+  receiver()->SetCodecs(codecs);
 }
 
 // Incoming packet from network parsed and ready for decode.
@@ -559,7 +578,7 @@ int AudioCodingModuleImpl::IncomingPacket(const uint8_t* incoming_payload,
                                           const size_t payload_length,
                                           const RTPHeader& rtp_header) {
   RTC_DCHECK_EQ(payload_length == 0, incoming_payload == nullptr);
-  return receiver_.InsertPacket(
+  return receiver()->InsertPacket(
       rtp_header,
       rtc::ArrayView<const uint8_t>(incoming_payload, payload_length));
 }
@@ -570,7 +589,7 @@ int AudioCodingModuleImpl::PlayoutData10Ms(int desired_freq_hz,
                                            AudioFrame* audio_frame,
                                            bool* muted) {
   // GetAudio always returns 10 ms, at the requested sample rate.
-  if (receiver_.GetAudio(desired_freq_hz, audio_frame, muted) != 0) {
+  if (receiver()->GetAudio(desired_freq_hz, audio_frame, muted) != 0) {
     RTC_LOG(LS_ERROR) << "PlayoutData failed, RecOut Failed";
     return -1;
   }
@@ -584,7 +603,7 @@ int AudioCodingModuleImpl::PlayoutData10Ms(int desired_freq_hz,
 // TODO(turajs) change the return value to void. Also change the corresponding
 // NetEq function.
 int AudioCodingModuleImpl::GetNetworkStatistics(NetworkStatistics* statistics) {
-  receiver_.GetNetworkStatistics(statistics);
+  receiver()->GetNetworkStatistics(statistics);
   return 0;
 }
 
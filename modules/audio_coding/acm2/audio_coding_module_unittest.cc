@@ -31,6 +31,7 @@
 #include "modules/audio_coding/codecs/g711/audio_encoder_pcm.h"
 #include "modules/audio_coding/codecs/isac/main/include/audio_encoder_isac.h"
 #include "modules/audio_coding/include/audio_coding_module_typedefs.h"
+#include "modules/audio_coding/neteq/default_neteq_factory.h"
 #include "modules/audio_coding/neteq/tools/audio_checksum.h"
 #include "modules/audio_coding/neteq/tools/audio_loop.h"
 #include "modules/audio_coding/neteq/tools/constant_pcm_packet_source.h"
@@ -301,6 +302,39 @@ TEST_F(AudioCodingModuleTestOldApi, TransportCallbackIsInvokedForEachPacket) {
   EXPECT_EQ(AudioFrameType::kAudioFrameSpeech, packet_cb_.last_frame_type());
 }
 
+// Checks that the NetEq is only created when the receiver side is first used,
+// so that modules that only send don't carry one.
+TEST(AudioCodingModuleTest, CreatesNetEqOnFirstUseOfReceiver) {
+  class CountingNetEqFactory : public NetEqFactory {
+   public:
+    std::unique_ptr<NetEq> CreateNetEq(
+        const NetEq::Config& config,
+        const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory,
+        Clock* clock) const override {
+      ++num_created;
+      return factory_.CreateNetEq(config, decoder_factory, clock);
+    }
+
+    mutable int num_created = 0;
+
+   private:
+    const DefaultNetEqFactory factory_;
+  };
+
+  CountingNetEqFactory neteq_factory;
+  AudioCodingModule::Config config(CreateBuiltinAudioDecoderFactory());
+  config.neteq_factory = &neteq_factory;
+  std::unique_ptr<AudioCodingModule> acm(AudioCodingModule::Create(config));
+  EXPECT_EQ(0, acm->InitializeReceiver());
+  EXPECT_EQ(0, neteq_factory.num_created);
+
+  AudioFrame audio_frame;
+  bool muted;
+  EXPECT_EQ(0, acm->PlayoutData10Ms(16000, &audio_frame, &muted));
+  EXPECT_EQ(0, acm->PlayoutData10Ms(16000, &audio_frame, &muted));
+  EXPECT_EQ(1, neteq_factory.num_created);
+}
+
 #if defined(WEBRTC_CODEC_ISAC) || defined(WEBRTC_CODEC_ISACFX)
 // Verifies that the RTP timestamp series is not reset when the codec is
 // changed.
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/audio_network_adaptor/complexity_controller.h"
+
+#include "rtc_base/checks.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+// Opus encodes all bandwidths up to 48 kHz, i.e. fullband.
+constexpr int kUnlimitedMaxPlaybackRateHz = 48000;
+}  // namespace
+
+ComplexityController::Config::Config(int cpu_budget_percent,
+                                     float complexity_decreasing_load,
+                                     float complexity_increasing_load,
+                                     int min_complexity,
+                                     int max_complexity,
+                                     int limited_max_playback_rate_hz,
+                                     int adaptation_interval_ms)
+    : cpu_budget_percent(cpu_budget_percent),
+      complexity_decreasing_load(complexity_decreasing_load),
+      complexity_increasing_load(complexity_increasing_load),
+      min_complexity(min_complexity),
+      max_complexity(max_complexity),
+      limited_max_playback_rate_hz(limited_max_playback_rate_hz),
+      adaptation_interval_ms(adaptation_interval_ms) {}
+
+ComplexityController::ComplexityController(
+    const Config& config,
+    EncodeTimeTracker* encode_time_tracker)
+    : config_(config),
+      encode_time_tracker_(encode_time_tracker),
+      max_complexity_(config_.max_complexity),
+      bandwidth_limited_(false) {
+  RTC_DCHECK(encode_time_tracker_);
+  RTC_DCHECK_GT(config_.cpu_budget_percent, 0);
+  RTC_DCHECK_LT(config_.complexity_increasing_load,
+                config_.complexity_decreasing_load);
+  RTC_DCHECK_LE(config_.min_complexity, config_.max_complexity);
+}
+
+ComplexityController::~ComplexityController() = default;
+
+void ComplexityController::UpdateNetworkMetrics(
+    const NetworkMetrics& network_metrics) {}
+
+void ComplexityController::MakeDecision(AudioEncoderRuntimeConfig* config) {
+  // Decision on |max_complexity| should not have been made.
+  RTC_DCHECK(!config->max_complexity);
+
+  const int64_t now_ms = rtc::TimeMillis();
+  const float load = encode_time_tracker_->GetCpuUsage(now_ms) * 100 /
+                     config_.cpu_budget_percent;
+  if (!last_adaptation_time_ms_) {
+    last_adaptation_time_ms_ = now_ms;
+  } else if (now_ms - *last_adaptation_time_ms_ >=
+             config_.adaptation_interval_ms) {
+    if (load > config_.complexity_decreasing_load) {
+      if (max_complexity_ > config_.min_complexity) {
+        --max_complexity_;
+      } else {
+        bandwidth_limited_ = true;
+      }
+      last_adaptation_time_ms_ = now_ms;
+    } else if (load < config_.complexity_increasing_load) {
+      if (bandwidth_limited_) {
+        bandwidth_limited_ = false;
+      } else if (max_complexity_ < config_.max_complexity) {
+        ++max_complexity_;
+      }
+      last_adaptation_time_ms_ = now_ms;
+    }
+  }
+
+  config->max_complexity = max_complexity_;
+  config->max_playback_rate_hz = bandwidth_limited_
+                                     ? config_.limited_max_playback_rate_hz
+                                     : kUnlimitedMaxPlaybackRateHz;
+}
+
+}  // namespace webrtc
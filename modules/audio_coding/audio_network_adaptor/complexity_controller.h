@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
+#define MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "modules/audio_coding/audio_network_adaptor/controller.h"
+#include "modules/audio_coding/audio_network_adaptor/encode_time_tracker.h"
+#include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor_config.h"
+#include "rtc_base/constructor_magic.h"
+
+namespace webrtc {
+
+// Trades encoding quality for CPU when the encoders of the process together
+// exceed a CPU budget, e.g. on a server that encodes audio for many
+// participants. While the encode time reported to the EncodeTimeTracker is
+// above the budget, the encoder complexity is lowered one step per
+// adaptation interval down to |min_complexity|, and then the encoded
+// bandwidth is limited. When the load falls well below the budget, the steps
+// are undone in reverse order.
+class ComplexityController final : public Controller {
+ public:
+  struct Config {
+    Config(int cpu_budget_percent,
+           float complexity_decreasing_load,
+           float complexity_increasing_load,
+           int min_complexity,
+           int max_complexity,
+           int limited_max_playback_rate_hz,
+           int adaptation_interval_ms);
+    // CPU time the encoders of the process may use, in percent of one core.
+    int cpu_budget_percent;
+    // Fractions of the budget above which the complexity is lowered, and
+    // below which it is raised.
+    float complexity_decreasing_load;
+    float complexity_increasing_load;
+    int min_complexity;
+    int max_complexity;
+    // Max playback rate to encode for when the complexity can't be lowered
+    // further.
+    int limited_max_playback_rate_hz;
+    // Least time between two adaptation steps, long enough for the effect of
+    // the previous step to show up in the measured load.
+    int adaptation_interval_ms;
+  };
+
+  ComplexityController(const Config& config,
+                       EncodeTimeTracker* encode_time_tracker);
+  ~ComplexityController() override;
+
+  void UpdateNetworkMetrics(const NetworkMetrics& network_metrics) override;
+
+  void MakeDecision(AudioEncoderRuntimeConfig* config) override;
+
+ private:
+  const Config config_;
+  EncodeTimeTracker* const encode_time_tracker_;
+  int max_complexity_;
+  bool bandwidth_limited_;
+  absl::optional<int64_t> last_adaptation_time_ms_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(ComplexityController);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_COMPLEXITY_CONTROLLER_H_
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/audio_network_adaptor/complexity_controller.h"
+
+#include <memory>
+
+#include "rtc_base/fake_clock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr float kComplexityDecreasingLoad = 0.9f;
+constexpr float kComplexityIncreasingLoad = 0.7f;
+constexpr int kMinComplexity = 8;
+constexpr int kMaxComplexity = 10;
+constexpr int kLimitedMaxPlaybackRateHz = 16000;
+constexpr int kAdaptationIntervalMs = 2000;
+constexpr int kTrackerWindowMs = 1000;
+
+class ComplexityControllerTest : public ::testing::Test {
+ protected:
+  ComplexityControllerTest() : encode_time_tracker_(kTrackerWindowMs) {
+    clock_.SetTime(Timestamp::Seconds(1000));
+  }
+
+  std::unique_ptr<ComplexityController> CreateController(
+      int cpu_budget_percent) {
+    return std::make_unique<ComplexityController>(
+        ComplexityController::Config(
+            cpu_budget_percent, kComplexityDecreasingLoad,
+            kComplexityIncreasingLoad, kMinComplexity, kMaxComplexity,
+            kLimitedMaxPlaybackRateHz, kAdaptationIntervalMs),
+        &encode_time_tracker_);
+  }
+
+  // Encodes with |cpu_usage| cores for |seconds|, asking for a decision every
+  // second, and returns the last decision.
+  AudioEncoderRuntimeConfig EncodeFor(ComplexityController* controller,
+                                      int seconds,
+                                      float cpu_usage) {
+    AudioEncoderRuntimeConfig config;
+    for (int i = 0; i < seconds; ++i) {
+      encode_time_tracker_.AddEncodeTime(
+          static_cast<int64_t>(cpu_usage * kTrackerWindowMs * 1000));
+      clock_.AdvanceTime(TimeDelta::Millis(kTrackerWindowMs));
+      config = AudioEncoderRuntimeConfig();
+      controller->MakeDecision(&config);
+    }
+    return config;
+  }
+
+  void CheckDecision(const AudioEncoderRuntimeConfig& config,
+                     int expected_max_complexity,
+                     bool expected_bandwidth_limited) {
+    EXPECT_EQ(expected_max_complexity, config.max_complexity);
+    EXPECT_EQ(expected_bandwidth_limited ? kLimitedMaxPlaybackRateHz : 48000,
+              config.max_playback_rate_hz);
+  }
+
+  rtc::ScopedFakeClock clock_;
+  EncodeTimeTracker encode_time_tracker_;
+};
+
+}  // namespace
+
+TEST_F(ComplexityControllerTest, OutputMaxComplexityInitially) {
+  auto controller = CreateController(100);
+  AudioEncoderRuntimeConfig config;
+  controller->MakeDecision(&config);
+  CheckDecision(config, kMaxComplexity, false);
+}
+
+TEST_F(ComplexityControllerTest, LowerComplexityThenBandwidthWhenOverBudget) {
+  auto controller = CreateController(100);
+  AudioEncoderRuntimeConfig config;
+  controller->MakeDecision(&config);
+
+  CheckDecision(EncodeFor(controller.get(), 1, 0.95f), 10, false);
+  CheckDecision(EncodeFor(controller.get(), 1, 0.95f), 9, false);
+  CheckDecision(EncodeFor(controller.get(), 2, 0.95f), 8, false);
+  CheckDecision(EncodeFor(controller.get(), 2, 0.95f), 8, true);
+  CheckDecision(EncodeFor(controller.get(), 4, 0.95f), 8, true);
+
+  // Within the hysteresis window, nothing changes.
+  CheckDecision(EncodeFor(controller.get(), 4, 0.8f), 8, true);
+
+  // The steps are undone in reverse order.
+  CheckDecision(EncodeFor(controller.get(), 2, 0.5f), 8, false);
+  CheckDecision(EncodeFor(controller.get(), 2, 0.5f), 9, false);
+  CheckDecision(EncodeFor(controller.get(), 2, 0.5f), 10, false);
+  CheckDecision(EncodeFor(controller.get(), 4, 0.5f), 10, false);
+}
+
+TEST_F(ComplexityControllerTest, LoadIsRelativeToBudget) {
+  auto controller = CreateController(200);
+  AudioEncoderRuntimeConfig config;
+  controller->MakeDecision(&config);
+
+  CheckDecision(EncodeFor(controller.get(), 4, 1.5f), 10, false);
+  CheckDecision(EncodeFor(controller.get(), 2, 1.9f), 9, false);
+}
+
+}  // namespace webrtc
@@ -16,8 +16,10 @@
 
 #include "modules/audio_coding/audio_network_adaptor/bitrate_controller.h"
 #include "modules/audio_coding/audio_network_adaptor/channel_controller.h"
+#include "modules/audio_coding/audio_network_adaptor/complexity_controller.h"
 #include "modules/audio_coding/audio_network_adaptor/debug_dump_writer.h"
 #include "modules/audio_coding/audio_network_adaptor/dtx_controller.h"
+#include "modules/audio_coding/audio_network_adaptor/encode_time_tracker.h"
 #include "modules/audio_coding/audio_network_adaptor/fec_controller_plr_based.h"
 #include "modules/audio_coding/audio_network_adaptor/frame_length_controller.h"
 #include "modules/audio_coding/audio_network_adaptor/util/threshold_curve.h"
@@ -197,6 +199,37 @@ std::unique_ptr<BitrateController> CreateBitrateController(
           initial_bitrate_bps, initial_frame_length_ms,
           fl_increase_overhead_offset, fl_decrease_overhead_offset)));
 }
+
+std::unique_ptr<ComplexityController> CreateComplexityController(
+    const audio_network_adaptor::config::ComplexityController& config) {
+  RTC_CHECK(config.has_cpu_budget_percent());
+  constexpr float kDefaultComplexityDecreasingLoad = 0.9f;
+  constexpr float kDefaultComplexityIncreasingLoad = 0.7f;
+  constexpr int kDefaultMinComplexity = 1;
+  constexpr int kDefaultMaxComplexity = 10;
+  constexpr int kDefaultLimitedMaxPlaybackRateHz = 16000;
+  constexpr int kDefaultAdaptationIntervalMs = 2000;
+
+  return std::unique_ptr<ComplexityController>(new ComplexityController(
+      ComplexityController::Config(
+          config.cpu_budget_percent(),
+          config.has_complexity_decreasing_load()
+              ? config.complexity_decreasing_load()
+              : kDefaultComplexityDecreasingLoad,
+          config.has_complexity_increasing_load()
+              ? config.complexity_increasing_load()
+              : kDefaultComplexityIncreasingLoad,
+          config.has_min_complexity() ? config.min_complexity()
+                                      : kDefaultMinComplexity,
+          config.has_max_complexity() ? config.max_complexity()
+                                      : kDefaultMaxComplexity,
+          config.has_limited_max_playback_rate_hz()
+              ? config.limited_max_playback_rate_hz()
+              : kDefaultLimitedMaxPlaybackRateHz,
+          config.has_adaptation_interval_ms() ? config.adaptation_interval_ms()
+                                              : kDefaultAdaptationIntervalMs),
+      EncodeTimeTracker::GetInstance()));
+}
 #endif  // WEBRTC_ENABLE_PROTOBUF
 
 }  // namespace
@@ -277,6 +310,10 @@ std::unique_ptr<ControllerManager> ControllerManagerImpl::Create(
             controller_config.bitrate_controller(), initial_bitrate_bps,
             initial_frame_length_ms);
         break;
+      case audio_network_adaptor::config::Controller::kComplexityController:
+        controller = CreateComplexityController(
+            controller_config.complexity_controller());
+        break;
       default:
         RTC_NOTREACHED();
     }
@@ -138,6 +138,12 @@ void DebugDumpWriterImpl::DumpEncoderRuntimeConfig(
   if (config.num_channels)
     dump_config->set_num_channels(*config.num_channels);
 
+  if (config.max_complexity)
+    dump_config->set_max_complexity(*config.max_complexity);
+
+  if (config.max_playback_rate_hz)
+    dump_config->set_max_playback_rate_hz(*config.max_playback_rate_hz);
+
   DumpEventToFile(event, &dump_file_);
 #endif  // WEBRTC_ENABLE_PROTOBUF
 }
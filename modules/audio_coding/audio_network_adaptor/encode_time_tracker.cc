@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/audio_network_adaptor/encode_time_tracker.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+constexpr int64_t kDefaultWindowMs = 1000;
+}  // namespace
+
+EncodeTimeTracker* EncodeTimeTracker::GetInstance() {
+  static EncodeTimeTracker* const instance =
+      new EncodeTimeTracker(kDefaultWindowMs);
+  return instance;
+}
+
+EncodeTimeTracker::EncodeTimeTracker(int64_t window_ms)
+    : window_ms_(window_ms) {
+  RTC_DCHECK_GT(window_ms_, 0);
+}
+
+EncodeTimeTracker::~EncodeTimeTracker() = default;
+
+void EncodeTimeTracker::AddEncodeTime(int64_t encode_time_us) {
+  encode_time_us_.fetch_add(encode_time_us, std::memory_order_relaxed);
+}
+
+float EncodeTimeTracker::GetCpuUsage(int64_t now_ms) {
+  rtc::CritScope lock(&lock_);
+  if (window_start_ms_ < 0) {
+    // Encode times added before the first call aren't within a known window.
+    encode_time_us_.store(0, std::memory_order_relaxed);
+    window_start_ms_ = now_ms;
+  } else if (now_ms - window_start_ms_ >= window_ms_) {
+    int64_t encode_time_us =
+        encode_time_us_.exchange(0, std::memory_order_relaxed);
+    cpu_usage_ = static_cast<float>(encode_time_us) /
+                 ((now_ms - window_start_ms_) * 1000);
+    window_start_ms_ = now_ms;
+  }
+  return cpu_usage_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_ENCODE_TIME_TRACKER_H_
+#define MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_ENCODE_TIME_TRACKER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Sums up the time that audio encoders spend encoding, across all encoders
+// in the process, so that ComplexityController can keep the total within a
+// CPU budget. Thread safe; encoders on any thread add their encode times
+// without taking a lock.
+class EncodeTimeTracker {
+ public:
+  // The tracker shared by all encoders in the process.
+  static EncodeTimeTracker* GetInstance();
+
+  explicit EncodeTimeTracker(int64_t window_ms);
+  ~EncodeTimeTracker();
+
+  void AddEncodeTime(int64_t encode_time_us);
+
+  // Returns the encode time per wall clock time, i.e. the number of CPU
+  // cores kept busy by encoding, over the last complete window. Returns zero
+  // until the first window has passed.
+  float GetCpuUsage(int64_t now_ms);
+
+ private:
+  const int64_t window_ms_;
+  std::atomic<int64_t> encode_time_us_{0};
+  rtc::CriticalSection lock_;
+  int64_t window_start_ms_ RTC_GUARDED_BY(lock_) = -1;
+  float cpu_usage_ RTC_GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_AUDIO_NETWORK_ADAPTOR_ENCODE_TIME_TRACKER_H_
@@ -36,6 +36,11 @@ struct AudioEncoderRuntimeConfig {
   // to encode.
   absl::optional<size_t> num_channels;
 
+  // Upper limits for the encoder complexity and the max playback rate, to
+  // save CPU. The encoder uses the lower of these and its own settings.
+  absl::optional<int> max_complexity;
+  absl::optional<int> max_playback_rate_hz;
+
   // This is true if the last frame length change was an increase, and otherwise
   // false.
   // The value of this boolean is used to apply a different offset to the
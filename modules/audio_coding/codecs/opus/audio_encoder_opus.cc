@@ -54,6 +54,11 @@ constexpr int kOpusBitrateFbBps = 32000;
 constexpr int kRtpTimestampRateHz = 48000;
 constexpr int kDefaultMaxPlaybackRate = 48000;
 
+// How often the audio network adaptor is asked for a new config while it caps
+// the complexity, so that it can follow the CPU load without waiting for new
+// network metrics.
+constexpr int64_t kCpuAdaptationUpdateIntervalMs = 500;
+
 // These two lists must be sorted from low to high
 #if WEBRTC_OPUS_SUPPORT_120MS_PTIME
 constexpr int kANASupportedFrameLengths[] = {20, 40, 60, 120};
@@ -434,6 +439,7 @@ AudioEncoderOpusImpl::AudioEncoderOpusImpl(
       packet_loss_rate_(0.0),
       min_packet_loss_rate_(GetMinPacketLossRate()),
       inst_(nullptr),
+      encode_time_tracker_(EncodeTimeTracker::GetInstance()),
       packet_loss_fraction_smoother_(new PacketLossFractionSmoother()),
       audio_network_adaptor_creator_(audio_network_adaptor_creator),
       bitrate_smoother_(std::move(bitrate_smoother)),
@@ -537,6 +543,9 @@ bool AudioEncoderOpusImpl::EnableAudioNetworkAdaptor(
 
 void AudioEncoderOpusImpl::DisableAudioNetworkAdaptor() {
   audio_network_adaptor_.reset(nullptr);
+  max_complexity_ = absl::nullopt;
+  UpdateComplexity();
+  SetMaxPlaybackRateLimit(absl::nullopt);
 }
 
 void AudioEncoderOpusImpl::OnReceivedUplinkPacketLossFraction(
@@ -646,6 +655,7 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
     rtc::ArrayView<const int16_t> audio,
     rtc::Buffer* encoded) {
   MaybeUpdateUplinkBandwidth();
+  MaybeUpdateCpuAdaptation();
 
   if (input_buffer_.empty())
     first_timestamp_in_buffer_ = rtp_timestamp;
@@ -659,6 +669,12 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
                Num10msFramesPerPacket() * SamplesPer10msFrame());
 
   const size_t max_encoded_bytes = SufficientOutputBufferSize();
+  // The complexity is adapted to the total encode time of the process while
+  // it is capped. Wall clock time is measured, which also grows when the
+  // encoding thread doesn't get to run because the CPU is overloaded.
+  const bool track_encode_time = max_complexity_.has_value();
+  const int64_t encode_start_time_us =
+      track_encode_time ? rtc::TimeMicros() : 0;
   EncodedInfo info;
   info.encoded_bytes = encoded->AppendData(
       max_encoded_bytes, [&](rtc::ArrayView<uint8_t> encoded) {
@@ -672,6 +688,10 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
         return static_cast<size_t>(status);
       });
   input_buffer_.clear();
+  if (track_encode_time) {
+    encode_time_tracker_->AddEncodeTime(rtc::TimeMicros() -
+                                        encode_start_time_us);
+  }
 
   bool dtx_frame = (info.encoded_bytes <= 2);
 
@@ -747,12 +767,16 @@ bool AudioEncoderOpusImpl::RecreateEncoderInstance(
   } else {
     RTC_CHECK_EQ(0, WebRtcOpus_DisableFec(inst_));
   }
-  RTC_CHECK_EQ(
-      0, WebRtcOpus_SetMaxPlaybackRate(inst_, config.max_playback_rate_hz));
+  RTC_CHECK_EQ(0, WebRtcOpus_SetMaxPlaybackRate(
+                      inst_, std::min(config.max_playback_rate_hz,
+                                      max_playback_rate_limit_hz_.value_or(
+                                          config.max_playback_rate_hz))));
   // Use the default complexity if the start bitrate is within the hysteresis
   // window.
   complexity_ = GetNewComplexity(config).value_or(config.complexity);
-  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity_));
+  applied_complexity_ = std::min(complexity_,
+                                 max_complexity_.value_or(complexity_));
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, applied_complexity_));
   bitrate_changed_ = true;
   if (config.dtx_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableDtx(inst_));
@@ -815,12 +839,31 @@ void AudioEncoderOpusImpl::SetTargetBitrate(int bits_per_second) {
   }
 
   const auto new_complexity = GetNewComplexity(config_);
-  if (new_complexity && complexity_ != *new_complexity) {
+  if (new_complexity)
     complexity_ = *new_complexity;
-    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity_));
+  UpdateComplexity();
+}
+
+void AudioEncoderOpusImpl::UpdateComplexity() {
+  const int complexity =
+      std::min(complexity_, max_complexity_.value_or(complexity_));
+  if (applied_complexity_ != complexity) {
+    applied_complexity_ = complexity;
+    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, applied_complexity_));
   }
 }
 
+void AudioEncoderOpusImpl::SetMaxPlaybackRateLimit(
+    absl::optional<int> max_playback_rate_hz) {
+  if (max_playback_rate_limit_hz_ == max_playback_rate_hz)
+    return;
+  max_playback_rate_limit_hz_ = max_playback_rate_hz;
+  RTC_CHECK_EQ(0, WebRtcOpus_SetMaxPlaybackRate(
+                      inst_, std::min(config_.max_playback_rate_hz,
+                                      max_playback_rate_hz.value_or(
+                                          config_.max_playback_rate_hz))));
+}
+
 void AudioEncoderOpusImpl::ApplyAudioNetworkAdaptor() {
   auto config = audio_network_adaptor_->GetEncoderRuntimeConfig();
 
@@ -836,6 +879,12 @@ void AudioEncoderOpusImpl::ApplyAudioNetworkAdaptor() {
     SetDtx(*config.enable_dtx);
   if (config.num_channels)
     SetNumChannelsToEncode(*config.num_channels);
+  if (config.max_complexity) {
+    max_complexity_ = config.max_complexity;
+    UpdateComplexity();
+  }
+  if (config.max_playback_rate_hz)
+    SetMaxPlaybackRateLimit(config.max_playback_rate_hz);
 }
 
 std::unique_ptr<AudioNetworkAdaptor>
@@ -866,6 +915,19 @@ void AudioEncoderOpusImpl::MaybeUpdateUplinkBandwidth() {
   }
 }
 
+void AudioEncoderOpusImpl::MaybeUpdateCpuAdaptation() {
+  if (!audio_network_adaptor_ || !max_complexity_)
+    return;
+  const int64_t now_ms = rtc::TimeMillis();
+  if (cpu_adaptation_last_update_time_ms_ &&
+      now_ms - *cpu_adaptation_last_update_time_ms_ <
+          kCpuAdaptationUpdateIntervalMs) {
+    return;
+  }
+  cpu_adaptation_last_update_time_ms_ = now_ms;
+  ApplyAudioNetworkAdaptor();
+}
+
 ANAStats AudioEncoderOpusImpl::GetANAStats() const {
   if (audio_network_adaptor_) {
     return audio_network_adaptor_->GetStats();
@@ -21,6 +21,7 @@
 #include "api/audio_codecs/audio_format.h"
 #include "api/audio_codecs/opus/audio_encoder_opus_config.h"
 #include "common_audio/smoothing_filter.h"
+#include "modules/audio_coding/audio_network_adaptor/encode_time_tracker.h"
 #include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
 #include "rtc_base/constructor_magic.h"
@@ -108,6 +109,7 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   bool fec_enabled() const { return config_.fec_enabled; }
   size_t num_channels_to_encode() const { return num_channels_to_encode_; }
   int next_frame_length_ms() const { return next_frame_length_ms_; }
+  int complexity() const { return applied_complexity_; }
 
  protected:
   EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
@@ -132,6 +134,9 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   void SetFrameLength(int frame_length_ms);
   void SetNumChannelsToEncode(size_t num_channels_to_encode);
   void SetProjectedPacketLossRate(float fraction);
+  // Applies |complexity_|, capped by |max_complexity_|, to the encoder.
+  void UpdateComplexity();
+  void SetMaxPlaybackRateLimit(absl::optional<int> max_playback_rate_hz);
 
   void OnReceivedUplinkBandwidth(
       int target_audio_bitrate_bps,
@@ -148,6 +153,7 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
       RtcEventLog* event_log) const;
 
   void MaybeUpdateUplinkBandwidth();
+  void MaybeUpdateCpuAdaptation();
 
   AudioEncoderOpusConfig config_;
   const int payload_type_;
@@ -166,7 +172,14 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   uint32_t first_timestamp_in_buffer_;
   size_t num_channels_to_encode_;
   int next_frame_length_ms_;
+  // Complexity for the current bitrate, and the one applied to the encoder
+  // after the audio network adaptor's cap.
   int complexity_;
+  int applied_complexity_;
+  absl::optional<int> max_complexity_;
+  absl::optional<int> max_playback_rate_limit_hz_;
+  EncodeTimeTracker* const encode_time_tracker_;
+  absl::optional<int64_t> cpu_adaptation_last_update_time_ms_;
   std::unique_ptr<PacketLossFractionSmoother> packet_loss_fraction_smoother_;
   const AudioNetworkAdaptorCreator audio_network_adaptor_creator_;
   std::unique_ptr<AudioNetworkAdaptor> audio_network_adaptor_;
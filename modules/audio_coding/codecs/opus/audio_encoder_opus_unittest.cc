@@ -631,6 +631,47 @@ TEST_P(AudioEncoderOpusTest, UpdateUplinkBandwidthInAudioNetworkAdaptor) {
   }
 }
 
+TEST_P(AudioEncoderOpusTest, AudioNetworkAdaptorCapsComplexity) {
+  auto states = CreateCodec(sample_rate_hz_, 2);
+  const int initial_complexity = states->encoder->complexity();
+  states->encoder->EnableAudioNetworkAdaptor("", nullptr);
+  AudioEncoderRuntimeConfig config;
+  config.max_complexity = 3;
+  config.max_playback_rate_hz = 16000;
+  EXPECT_CALL(*states->mock_audio_network_adaptor, GetEncoderRuntimeConfig())
+      .WillOnce(Return(config));
+  states->encoder->OnReceivedRtt(30);
+  EXPECT_EQ(3, states->encoder->complexity());
+
+  // While the complexity is capped, a new config is requested periodically
+  // when encoding, to follow the CPU load.
+  const size_t opus_rate_khz = rtc::CheckedDivExact(sample_rate_hz_, 1000);
+  const std::vector<int16_t> audio(opus_rate_khz * 10 * 2, 0);
+  rtc::Buffer encoded;
+  EXPECT_CALL(*states->mock_bitrate_smoother, GetAverage())
+      .WillRepeatedly(Return(absl::nullopt));
+  config.max_complexity = 5;
+  EXPECT_CALL(*states->mock_audio_network_adaptor, GetEncoderRuntimeConfig())
+      .WillOnce(Return(config));
+  states->encoder->Encode(
+      0, rtc::ArrayView<const int16_t>(audio.data(), audio.size()), &encoded);
+  EXPECT_EQ(5, states->encoder->complexity());
+
+  states->fake_clock->AdvanceTime(TimeDelta::Millis(499));
+  states->encoder->Encode(
+      0, rtc::ArrayView<const int16_t>(audio.data(), audio.size()), &encoded);
+  config.max_complexity = 1;
+  EXPECT_CALL(*states->mock_audio_network_adaptor, GetEncoderRuntimeConfig())
+      .WillOnce(Return(config));
+  states->fake_clock->AdvanceTime(TimeDelta::Millis(1));
+  states->encoder->Encode(
+      0, rtc::ArrayView<const int16_t>(audio.data(), audio.size()), &encoded);
+  EXPECT_EQ(1, states->encoder->complexity());
+
+  states->encoder->DisableAudioNetworkAdaptor();
+  EXPECT_EQ(initial_complexity, states->encoder->complexity());
+}
+
 TEST_P(AudioEncoderOpusTest, EncodeAtMinBitrate) {
   auto states = CreateCodec(sample_rate_hz_, 1);
   constexpr int kNumPacketsToEncode = 2;
@@ -13,6 +13,8 @@
 #include <cstdlib>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/field_trial.h"
 
 enum {
@@ -54,6 +56,73 @@ static int DefaultFrameSizePerChannel(int sample_rate_hz) {
   return FrameSizePerChannel(20, sample_rate_hz);
 }
 
+// Released mono and stereo libopus states, kept for reuse once a capacity has
+// been set with WebRtcOpus_SetStatePoolCapacity(). opus_encoder_init() and
+// opus_decoder_init() put a state in the same condition as a freshly created
+// one, without the allocation. The pools are indexed by channel count - 1.
+static const size_t kMaxStatePoolCapacity = 256;
+static rtc::GlobalLock g_state_pool_lock;
+static size_t g_state_pool_capacity RTC_GUARDED_BY(g_state_pool_lock) = 0;
+static OpusEncoder* g_encoder_pool[2][kMaxStatePoolCapacity] RTC_GUARDED_BY(
+    g_state_pool_lock);
+static size_t g_encoder_pool_size[2] RTC_GUARDED_BY(g_state_pool_lock);
+static OpusDecoder* g_decoder_pool[2][kMaxStatePoolCapacity] RTC_GUARDED_BY(
+    g_state_pool_lock);
+static size_t g_decoder_pool_size[2] RTC_GUARDED_BY(g_state_pool_lock);
+
+static OpusEncoder* TakePooledEncoder(size_t channels) {
+  if (channels < 1 || channels > 2)
+    return NULL;
+  rtc::GlobalLockScope lock(&g_state_pool_lock);
+  size_t& size = g_encoder_pool_size[channels - 1];
+  return size > 0 ? g_encoder_pool[channels - 1][--size] : NULL;
+}
+
+// Returns false if the pool is full and |encoder| must be destroyed.
+static bool ReturnPooledEncoder(OpusEncoder* encoder, size_t channels) {
+  if (channels < 1 || channels > 2)
+    return false;
+  rtc::GlobalLockScope lock(&g_state_pool_lock);
+  size_t& size = g_encoder_pool_size[channels - 1];
+  if (size >= g_state_pool_capacity)
+    return false;
+  g_encoder_pool[channels - 1][size++] = encoder;
+  return true;
+}
+
+static OpusDecoder* TakePooledDecoder(size_t channels) {
+  if (channels < 1 || channels > 2)
+    return NULL;
+  rtc::GlobalLockScope lock(&g_state_pool_lock);
+  size_t& size = g_decoder_pool_size[channels - 1];
+  return size > 0 ? g_decoder_pool[channels - 1][--size] : NULL;
+}
+
+// Returns false if the pool is full and |decoder| must be destroyed.
+static bool ReturnPooledDecoder(OpusDecoder* decoder, size_t channels) {
+  if (channels < 1 || channels > 2)
+    return false;
+  rtc::GlobalLockScope lock(&g_state_pool_lock);
+  size_t& size = g_decoder_pool_size[channels - 1];
+  if (size >= g_state_pool_capacity)
+    return false;
+  g_decoder_pool[channels - 1][size++] = decoder;
+  return true;
+}
+
+void WebRtcOpus_SetStatePoolCapacity(size_t capacity) {
+  if (capacity > kMaxStatePoolCapacity)
+    capacity = kMaxStatePoolCapacity;
+  rtc::GlobalLockScope lock(&g_state_pool_lock);
+  g_state_pool_capacity = capacity;
+  for (size_t i = 0; i < 2; ++i) {
+    while (g_encoder_pool_size[i] > capacity)
+      opus_encoder_destroy(g_encoder_pool[i][--g_encoder_pool_size[i]]);
+    while (g_decoder_pool_size[i] > capacity)
+      opus_decoder_destroy(g_decoder_pool[i][--g_decoder_pool_size[i]]);
+  }
+}
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  size_t channels,
                                  int32_t application,
@@ -78,8 +147,14 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   RTC_DCHECK(state);
 
   int error;
-  state->encoder = opus_encoder_create(
-      sample_rate_hz, static_cast<int>(channels), opus_app, &error);
+  state->encoder = TakePooledEncoder(channels);
+  if (state->encoder) {
+    error = opus_encoder_init(state->encoder, sample_rate_hz,
+                              static_cast<int>(channels), opus_app);
+  } else {
+    state->encoder = opus_encoder_create(
+        sample_rate_hz, static_cast<int>(channels), opus_app, &error);
+  }
 
   if (error != OPUS_OK || (!state->encoder && !state->multistream_encoder)) {
     WebRtcOpus_EncoderFree(state);
@@ -139,7 +214,8 @@ int16_t WebRtcOpus_MultistreamEncoderCreate(
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
     if (inst->encoder) {
-      opus_encoder_destroy(inst->encoder);
+      if (!ReturnPooledEncoder(inst->encoder, inst->channels))
+        opus_encoder_destroy(inst->encoder);
     } else {
       opus_multistream_encoder_destroy(inst->multistream_encoder);
     }
@@ -398,8 +474,14 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst,
       return -1;
     }
 
-    state->decoder =
-        opus_decoder_create(sample_rate_hz, static_cast<int>(channels), &error);
+    state->decoder = TakePooledDecoder(channels);
+    if (state->decoder) {
+      error = opus_decoder_init(state->decoder, sample_rate_hz,
+                                static_cast<int>(channels));
+    } else {
+      state->decoder = opus_decoder_create(sample_rate_hz,
+                                           static_cast<int>(channels), &error);
+    }
     if (error == OPUS_OK && state->decoder) {
       // Creation of memory all ok.
       state->channels = channels;
@@ -469,7 +551,8 @@ int16_t WebRtcOpus_MultistreamDecoderCreate(
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   if (inst) {
     if (inst->decoder) {
-      opus_decoder_destroy(inst->decoder);
+      if (!ReturnPooledDecoder(inst->decoder, inst->channels))
+        opus_decoder_destroy(inst->decoder);
     } else if (inst->multistream_decoder) {
       opus_multistream_decoder_destroy(inst->multistream_decoder);
     }
@@ -24,6 +24,22 @@ extern "C" {
 typedef struct WebRtcOpusEncInst OpusEncInst;
 typedef struct WebRtcOpusDecInst OpusDecInst;
 
+/****************************************************************************
+ * WebRtcOpus_SetStatePoolCapacity(...)
+ *
+ * Sets how many released mono and how many released stereo encoder and
+ * decoder states are kept for reuse, instead of being destroyed. Creating a
+ * mono or stereo encoder or decoder takes a pooled state when there is one
+ * and re-initializes it. Multistream states are never pooled. The default
+ * capacity is 0, which disables pooling; lowering it destroys the excess
+ * states. The capacity is capped at 256.
+ *
+ * Input:
+ *      - capacity           : number of states to keep per kind and
+ *                             channel count.
+ */
+void WebRtcOpus_SetStatePoolCapacity(size_t capacity);
+
 /****************************************************************************
  * WebRtcOpus_EncoderCreate(...)
  *
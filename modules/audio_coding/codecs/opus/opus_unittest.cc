@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -490,6 +491,58 @@ TEST(OpusTest, OpusFreeFail) {
   EXPECT_EQ(-1, WebRtcOpus_DecoderFree(NULL));
 }
 
+// Test that a pooled state is reset to the state of a freshly created one.
+TEST(OpusTest, OpusPooledStatesMatchNewStates) {
+  constexpr size_t kSamples = 960;
+  constexpr size_t kMaxBytes = 1500;
+  int16_t audio[kSamples * 2];
+  for (size_t i = 0; i < kSamples * 2; ++i)
+    audio[i] = static_cast<int16_t>((i * 7919) % 20000 - 10000);
+
+  WebRtcOpus_SetStatePoolCapacity(1);
+  for (size_t channels = 1; channels <= 2; ++channels) {
+    uint8_t fresh[kMaxBytes];
+    uint8_t pooled[kMaxBytes];
+
+    WebRtcOpusEncInst* encoder;
+    ASSERT_EQ(0, WebRtcOpus_EncoderCreate(&encoder, channels, 0, 48000));
+    const int fresh_bytes =
+        WebRtcOpus_Encode(encoder, audio, kSamples, kMaxBytes, fresh);
+    ASSERT_GT(fresh_bytes, 0);
+    // Leave the state with non-default settings before it is pooled.
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(encoder, 6000));
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+
+    ASSERT_EQ(0, WebRtcOpus_EncoderCreate(&encoder, channels, 0, 48000));
+    const int pooled_bytes =
+        WebRtcOpus_Encode(encoder, audio, kSamples, kMaxBytes, pooled);
+    ASSERT_EQ(fresh_bytes, pooled_bytes);
+    EXPECT_EQ(0, memcmp(fresh, pooled, fresh_bytes));
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+
+    int16_t fresh_decoded[kSamples * 2];
+    int16_t pooled_decoded[kSamples * 2];
+    int16_t audio_type;
+    WebRtcOpusDecInst* decoder;
+    ASSERT_EQ(0, WebRtcOpus_DecoderCreate(&decoder, channels, 48000));
+    WebRtcOpus_DecoderInit(decoder);
+    ASSERT_EQ(static_cast<int>(kSamples),
+              WebRtcOpus_Decode(decoder, fresh, fresh_bytes, fresh_decoded,
+                                &audio_type));
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+
+    ASSERT_EQ(0, WebRtcOpus_DecoderCreate(&decoder, channels, 48000));
+    WebRtcOpus_DecoderInit(decoder);
+    ASSERT_EQ(static_cast<int>(kSamples),
+              WebRtcOpus_Decode(decoder, fresh, fresh_bytes, pooled_decoded,
+                                &audio_type));
+    EXPECT_EQ(0, memcmp(fresh_decoded, pooled_decoded,
+                        kSamples * channels * sizeof(int16_t)));
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+  }
+  WebRtcOpus_SetStatePoolCapacity(0);
+}
+
 // Test normal Create and Free.
 TEST_P(OpusTest, OpusCreateFree) {
   CreateSingleOrMultiStreamEncoder(&opus_encoder_, channels_, application_,
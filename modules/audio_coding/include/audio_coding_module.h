@@ -73,6 +73,8 @@ class AudioCodingModule {
     NetEq::Config neteq_config;
     Clock* clock;
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory;
+    // The receiver side, and its NetEq, is only created on first use, so the
+    // factory must outlive the module.
     NetEqFactory* neteq_factory = nullptr;
   };
 
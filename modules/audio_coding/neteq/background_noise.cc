@@ -18,6 +18,7 @@
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_coding/neteq/audio_multi_vector.h"
 #include "modules/audio_coding/neteq/cross_correlation.h"
+#include "modules/audio_coding/neteq/dsp_kernels.h"
 #include "modules/audio_coding/neteq/post_decode_vad.h"
 
 namespace webrtc {
@@ -98,7 +99,7 @@ bool BackgroundNoise::Update(const AudioMultiVector& input,
       WebRtcSpl_FilterMAFastQ12(temp_signal + kVecLen - kResidualLength,
                                 fiter_output, lpc_coefficients,
                                 kMaxLpcOrder + 1, kResidualLength);
-      int32_t residual_energy = WebRtcSpl_DotProductWithScale(
+      int32_t residual_energy = GetDspKernels().dot_product_with_scale(
           fiter_output, fiter_output, kResidualLength, 0);
 
       // Check spectral flatness.
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/batched_neteq_factory.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "api/units/time_delta.h"
+#include "modules/audio_coding/neteq/neteq_impl.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/task_utils/repeating_task.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr TimeDelta kOutputInterval = TimeDelta::Millis(10);
+
+}  // namespace
+
+// Pulls audio from its share of the NetEq instances on a task queue of its
+// own.
+class BatchedNetEqFactory::Worker {
+ public:
+  Worker(TaskQueueFactory* task_queue_factory, NetEqOutputSink* sink)
+      : sink_(sink),
+        task_queue_(task_queue_factory->CreateTaskQueue(
+            "BatchedNetEq",
+            TaskQueueFactory::Priority::HIGH)) {
+    RepeatingTaskHandle::Start(task_queue_.Get(), [this]() {
+      Process();
+      return kOutputInterval;
+    });
+  }
+
+  void Add(NetEq* neteq) {
+    rtc::CritScope cs(&lock_);
+    neteqs_.push_back(neteq);
+  }
+
+  // Returns once |neteq| is not being processed and will not be again.
+  void Remove(NetEq* neteq) {
+    rtc::CritScope cs(&lock_);
+    auto it = std::find(neteqs_.begin(), neteqs_.end(), neteq);
+    RTC_DCHECK(it != neteqs_.end());
+    neteqs_.erase(it);
+  }
+
+  size_t num_neteqs() const {
+    rtc::CritScope cs(&lock_);
+    return neteqs_.size();
+  }
+
+ private:
+  void Process() {
+    rtc::CritScope cs(&lock_);
+    for (NetEq* neteq : neteqs_) {
+      bool muted = false;
+      if (neteq->GetAudio(&frame_, &muted) == NetEq::kOK)
+        sink_->OnNetEqOutput(neteq, frame_, muted);
+    }
+  }
+
+  NetEqOutputSink* const sink_;
+  rtc::CriticalSection lock_;
+  std::vector<NetEq*> neteqs_ RTC_GUARDED_BY(lock_);
+  // Only used on |task_queue_|.
+  AudioFrame frame_;
+  // Declared last, so that it stops processing before the rest is destroyed.
+  rtc::TaskQueue task_queue_;
+};
+
+// A NetEqImpl that is processed by a worker for as long as it exists.
+class BatchedNetEqFactory::BatchedNetEq : public NetEqImpl {
+ public:
+  BatchedNetEq(const NetEq::Config& config,
+               NetEqImpl::Dependencies&& deps,
+               Worker* worker)
+      : NetEqImpl(config, std::move(deps)), worker_(worker) {
+    worker_->Add(this);
+  }
+
+  ~BatchedNetEq() override { worker_->Remove(this); }
+
+ private:
+  Worker* const worker_;
+};
+
+BatchedNetEqFactory::BatchedNetEqFactory(TaskQueueFactory* task_queue_factory,
+                                         size_t num_workers,
+                                         NetEqOutputSink* sink) {
+  RTC_DCHECK(task_queue_factory);
+  RTC_DCHECK_GT(num_workers, 0);
+  RTC_DCHECK(sink);
+  for (size_t i = 0; i < num_workers; ++i)
+    workers_.push_back(std::make_unique<Worker>(task_queue_factory, sink));
+}
+
+BatchedNetEqFactory::~BatchedNetEqFactory() {
+  for (const auto& worker : workers_)
+    RTC_DCHECK_EQ(worker->num_neteqs(), 0);
+}
+
+std::unique_ptr<NetEq> BatchedNetEqFactory::CreateNetEq(
+    const NetEq::Config& config,
+    const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory,
+    Clock* clock) const {
+  // Give the new instance to the least loaded worker.
+  Worker* worker = workers_[0].get();
+  for (const auto& candidate : workers_) {
+    if (candidate->num_neteqs() < worker->num_neteqs())
+      worker = candidate.get();
+  }
+  return std::make_unique<BatchedNetEq>(
+      config,
+      NetEqImpl::Dependencies(config, clock, decoder_factory,
+                              controller_factory_),
+      worker);
+}
+
+}  // namespace webrtc
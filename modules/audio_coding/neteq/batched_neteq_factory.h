@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_BATCHED_NETEQ_FACTORY_H_
+#define MODULES_AUDIO_CODING_NETEQ_BATCHED_NETEQ_FACTORY_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_frame.h"
+#include "api/audio_codecs/audio_decoder_factory.h"
+#include "api/neteq/default_neteq_controller_factory.h"
+#include "api/neteq/neteq.h"
+#include "api/neteq/neteq_factory.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+// Receives the audio of the NetEq instances created by a
+// BatchedNetEqFactory.
+class NetEqOutputSink {
+ public:
+  virtual ~NetEqOutputSink() = default;
+
+  // Called every 10 ms for every NetEq instance, on one of the factory's
+  // worker threads, with the 10 ms of audio |neteq| delivered. |frame| is only
+  // valid during the call; if |muted| is true its data should be interpreted
+  // as all zeros. The packet infos of |frame| tell which RTP stream the audio
+  // was decoded from. Must not destroy any of the NetEq instances.
+  virtual void OnNetEqOutput(const NetEq* neteq,
+                             const AudioFrame& frame,
+                             bool muted) = 0;
+};
+
+// Creates NetEq instances that are pulled for audio by a small pool of worker
+// task queues, for servers that receive many audio streams but have no audio
+// device to drive the playout of each of them. Every 10 ms, each worker runs
+// GetAudio() on all the instances it was given, one after the other, and hands
+// the audio to |sink|. Packets are inserted into the instances as usual, from
+// any thread, but nothing else may call GetAudio() on them. The instances
+// must be destroyed before the factory.
+class BatchedNetEqFactory : public NetEqFactory {
+ public:
+  BatchedNetEqFactory(TaskQueueFactory* task_queue_factory,
+                      size_t num_workers,
+                      NetEqOutputSink* sink);
+  ~BatchedNetEqFactory() override;
+  BatchedNetEqFactory(const BatchedNetEqFactory&) = delete;
+  BatchedNetEqFactory& operator=(const BatchedNetEqFactory&) = delete;
+
+  std::unique_ptr<NetEq> CreateNetEq(
+      const NetEq::Config& config,
+      const rtc::scoped_refptr<AudioDecoderFactory>& decoder_factory,
+      Clock* clock) const override;
+
+ private:
+  class Worker;
+  class BatchedNetEq;
+
+  const DefaultNetEqControllerFactory controller_factory_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}  // namespace webrtc
+#endif  // MODULES_AUDIO_CODING_NETEQ_BATCHED_NETEQ_FACTORY_H_
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/batched_neteq_factory.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/task_queue/default_task_queue_factory.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kNumFramesToWaitFor = 5;
+
+// Counts the frames of each NetEq, and signals once every one of them has
+// delivered kNumFramesToWaitFor.
+class CountingSink : public NetEqOutputSink {
+ public:
+  explicit CountingSink(size_t num_neteqs) : num_neteqs_(num_neteqs) {}
+
+  void OnNetEqOutput(const NetEq* neteq,
+                     const AudioFrame& frame,
+                     bool muted) override {
+    rtc::CritScope cs(&lock_);
+    EXPECT_EQ(frame.sample_rate_hz_ / 100,
+              static_cast<int>(frame.samples_per_channel_));
+    const int num_frames = ++num_frames_[neteq];
+    if (num_frames == kNumFramesToWaitFor &&
+        ++num_neteqs_done_ == num_neteqs_) {
+      done_.Set();
+    }
+  }
+
+  bool WaitForAll() { return done_.Wait(5000); }
+
+  int NumFrames(const NetEq* neteq) const {
+    rtc::CritScope cs(&lock_);
+    auto it = num_frames_.find(neteq);
+    return it == num_frames_.end() ? 0 : it->second;
+  }
+
+ private:
+  const size_t num_neteqs_;
+  rtc::CriticalSection lock_;
+  std::map<const NetEq*, int> num_frames_;
+  size_t num_neteqs_done_ = 0;
+  rtc::Event done_;
+};
+
+}  // namespace
+
+TEST(BatchedNetEqFactory, PullsAudioFromAllInstances) {
+  constexpr size_t kNumNetEqs = 5;
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  CountingSink sink(kNumNetEqs);
+  BatchedNetEqFactory factory(task_queue_factory.get(), 2, &sink);
+
+  std::vector<std::unique_ptr<NetEq>> neteqs;
+  for (size_t i = 0; i < kNumNetEqs; ++i) {
+    neteqs.push_back(factory.CreateNetEq(NetEq::Config(),
+                                         CreateBuiltinAudioDecoderFactory(),
+                                         Clock::GetRealTimeClock()));
+  }
+  ASSERT_TRUE(sink.WaitForAll());
+
+  // No audio is pulled from an instance once it is destroyed.
+  const NetEq* const destroyed = neteqs[0].get();
+  neteqs[0].reset();
+  const int num_frames = sink.NumFrames(destroyed);
+  rtc::Event().Wait(50);
+  EXPECT_EQ(num_frames, sink.NumFrames(destroyed));
+  EXPECT_GT(sink.NumFrames(neteqs[1].get()), kNumFramesToWaitFor);
+}
+
+}  // namespace webrtc
@@ -14,11 +14,12 @@
 #include <limits>
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_coding/neteq/dsp_kernels.h"
 
 namespace webrtc {
 
-// This function decides the overflow-protecting scaling and calls
-// WebRtcSpl_CrossCorrelation.
+// This function decides the overflow-protecting scaling and calls the
+// cross-correlation kernel.
 int CrossCorrelationWithAutoShift(const int16_t* sequence_1,
                                   const int16_t* sequence_2,
                                   size_t sequence_1_length,
@@ -53,9 +54,9 @@ int CrossCorrelationWithAutoShift(const int16_t* sequence_1,
                          static_cast<int32_t>(sequence_1_length));
   const int scaling = factor == 0 ? 0 : 31 - WebRtcSpl_NormW32(factor);
 
-  WebRtcSpl_CrossCorrelation(cross_correlation, sequence_1, sequence_2,
-                             sequence_1_length, cross_correlation_length,
-                             scaling, cross_correlation_step);
+  GetDspKernels().cross_correlation(cross_correlation, sequence_1, sequence_2,
+                                    sequence_1_length, cross_correlation_length,
+                                    scaling, cross_correlation_step);
 
   return scaling;
 }
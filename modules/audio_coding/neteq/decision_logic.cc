@@ -36,7 +36,8 @@ DecisionLogic::DecisionLogic(NetEqController::Config config)
     : delay_manager_(DelayManager::Create(config.max_packets_in_buffer,
                                           config.base_min_delay_ms,
                                           config.enable_rtx_handling,
-                                          config.tick_timer)),
+                                          config.tick_timer,
+                                          config.low_latency_delay)),
       tick_timer_(config.tick_timer),
       disallow_time_stretching_(!config.allow_time_stretching),
       timescale_countdown_(
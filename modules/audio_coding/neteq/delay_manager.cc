@@ -38,6 +38,10 @@ constexpr int kMaxHistoryMs = 2000;  // Oldest packet to include in history to
 constexpr int kDelayBuckets = 100;
 constexpr int kBucketSizeMs = 20;
 constexpr int kDecelerationTargetLevelOffsetMs = 85 << 8;  // In Q8.
+// The low-latency policy uses finer buckets, covering 500 ms, and forgets
+// old arrival delays with a time constant of about 50 packets.
+constexpr int kLowLatencyBucketSizeMs = 5;
+constexpr int kLowLatencyForgetFactor = 32113;  // 0.98 in Q15.
 
 int PercentileToQuantile(double percentile) {
   return static_cast<int>((1 << 30) * percentile / 100.0 + 0.5);
@@ -88,7 +92,9 @@ DelayManager::DelayManager(size_t max_packets_in_buffer,
                            int histogram_quantile,
                            bool enable_rtx_handling,
                            const TickTimer* tick_timer,
-                           std::unique_ptr<Histogram> histogram)
+                           std::unique_ptr<Histogram> histogram,
+                           const absl::optional<NetEq::Config::LowLatencyDelay>&
+                               low_latency_delay)
     : first_packet_received_(false),
       max_packets_in_buffer_(max_packets_in_buffer),
       histogram_(std::move(histogram)),
@@ -104,7 +110,10 @@ DelayManager::DelayManager(size_t max_packets_in_buffer,
       minimum_delay_ms_(0),
       maximum_delay_ms_(0),
       last_pack_cng_or_dtmf_(1),
-      enable_rtx_handling_(enable_rtx_handling) {
+      enable_rtx_handling_(enable_rtx_handling),
+      low_latency_delay_(low_latency_delay),
+      bucket_size_ms_(low_latency_delay ? kLowLatencyBucketSizeMs
+                                        : kBucketSizeMs) {
   RTC_CHECK(histogram_);
   RTC_DCHECK_GE(base_minimum_delay_ms_, 0);
 
@@ -115,14 +124,27 @@ std::unique_ptr<DelayManager> DelayManager::Create(
     size_t max_packets_in_buffer,
     int base_minimum_delay_ms,
     bool enable_rtx_handling,
-    const TickTimer* tick_timer) {
-  DelayHistogramConfig config = GetDelayHistogramConfig();
+    const TickTimer* tick_timer,
+    const absl::optional<NetEq::Config::LowLatencyDelay>& low_latency_delay) {
+  DelayHistogramConfig config;
+  if (low_latency_delay) {
+    const double late_packet_rate =
+        rtc::SafeClamp(low_latency_delay->late_packet_rate, 0.0, 1.0);
+    config.quantile = PercentileToQuantile(100.0 * (1.0 - late_packet_rate));
+    config.forget_factor = kLowLatencyForgetFactor;
+    RTC_LOG(LS_INFO) << "Low-latency delay policy: late_packet_rate="
+                     << late_packet_rate
+                     << " max_delay_ms=" << low_latency_delay->max_delay_ms;
+  } else {
+    config = GetDelayHistogramConfig();
+  }
   const int quantile = config.quantile;
   std::unique_ptr<Histogram> histogram = std::make_unique<Histogram>(
       kDelayBuckets, config.forget_factor, config.start_forget_weight);
   return std::make_unique<DelayManager>(
       max_packets_in_buffer, base_minimum_delay_ms, quantile,
-      enable_rtx_handling, tick_timer, std::move(histogram));
+      enable_rtx_handling, tick_timer, std::move(histogram),
+      low_latency_delay);
 }
 
 DelayManager::~DelayManager() {}
@@ -188,7 +210,12 @@ absl::optional<int> DelayManager::Update(uint16_t sequence_number,
       relative_delay = CalculateRelativePacketArrivalDelay();
     }
 
-    const int index = relative_delay.value() / kBucketSizeMs;
+    int index = relative_delay.value() / bucket_size_ms_;
+    if (low_latency_delay_) {
+      // The buckets only cover 500 ms, so count longer delays in the last one
+      // instead of ignoring them.
+      index = std::min(index, histogram_->NumBuckets() - 1);
+    }
     if (index < histogram_->NumBuckets()) {
       // Maximum delay to register is 2000 ms.
       histogram_->Add(index);
@@ -272,9 +299,25 @@ int DelayManager::CalculateTargetLevel() {
   int limit_probability = histogram_quantile_;
 
   int bucket_index = histogram_->Quantile(limit_probability);
+  if (low_latency_delay_ && packet_len_ms_ > 0) {
+    // Target the quantile delay on top of the packet being played out, with
+    // sub-packet resolution rather than rounded to whole packets.
+    int target_level =
+        ((packet_len_ms_ + bucket_index * bucket_size_ms_) << 8) /
+        packet_len_ms_;
+    if (low_latency_delay_->max_delay_ms > 0) {
+      target_level =
+          std::min(target_level,
+                   (low_latency_delay_->max_delay_ms << 8) / packet_len_ms_);
+    }
+    target_level_ = std::max(target_level, 1 << 8);
+    base_target_level_ = target_level_ >> 8;
+    return target_level_;
+  }
+
   int target_level = 1;
   if (packet_len_ms_ > 0) {
-    target_level += bucket_index * kBucketSizeMs / packet_len_ms_;
+    target_level += bucket_index * bucket_size_ms_ / packet_len_ms_;
   }
   base_target_level_ = target_level;
 
@@ -17,6 +17,7 @@
 #include <memory>
 
 #include "absl/types/optional.h"
+#include "api/neteq/neteq.h"
 #include "api/neteq/tick_timer.h"
 #include "modules/audio_coding/neteq/histogram.h"
 #include "rtc_base/constructor_magic.h"
@@ -30,17 +31,23 @@ class DelayManager {
                int histogram_quantile,
                bool enable_rtx_handling,
                const TickTimer* tick_timer,
-               std::unique_ptr<Histogram> histogram);
+               std::unique_ptr<Histogram> histogram,
+               const absl::optional<NetEq::Config::LowLatencyDelay>&
+                   low_latency_delay = absl::nullopt);
 
   // Create a DelayManager object. Notify the delay manager that the packet
   // buffer can hold no more than |max_packets_in_buffer| packets (i.e., this
   // is the number of packet slots in the buffer) and that the target delay
   // should be greater than or equal to |base_minimum_delay_ms|. Supply a
-  // PeakDetector object to the DelayManager.
-  static std::unique_ptr<DelayManager> Create(size_t max_packets_in_buffer,
-                                              int base_minimum_delay_ms,
-                                              bool enable_rtx_handling,
-                                              const TickTimer* tick_timer);
+  // PeakDetector object to the DelayManager. The low-latency delay policy is
+  // used if |low_latency_delay| is set.
+  static std::unique_ptr<DelayManager> Create(
+      size_t max_packets_in_buffer,
+      int base_minimum_delay_ms,
+      bool enable_rtx_handling,
+      const TickTimer* tick_timer,
+      const absl::optional<NetEq::Config::LowLatencyDelay>& low_latency_delay =
+          absl::nullopt);
 
   virtual ~DelayManager();
 
@@ -166,6 +173,10 @@ class DelayManager {
   int maximum_delay_ms_;     // Externally set maximum allowed delay.
   int last_pack_cng_or_dtmf_;
   const bool enable_rtx_handling_;
+  // Settings of the low-latency delay policy, if used.
+  const absl::optional<NetEq::Config::LowLatencyDelay> low_latency_delay_;
+  // Width of the delay histogram buckets.
+  const int bucket_size_ms_;
   int num_reordered_packets_ = 0;  // Number of consecutive reordered packets.
 
   struct PacketDelay {
@@ -14,7 +14,9 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "modules/audio_coding/neteq/histogram.h"
 #include "modules/audio_coding/neteq/mock/mock_histogram.h"
@@ -594,4 +596,73 @@ TEST_F(DelayManagerTest, DecelerationTargetLevelOffset) {
   }
 }
 
+namespace {
+
+// Feeds 20 ms packets to |dms|, the first |num_spiky_packets| of them with
+// every fifth packet held back by 60 ms, followed by |num_smooth_packets| on
+// time packets. Held back packets delay the ones behind them.
+void InsertSpikyThenSmoothPackets(
+    const std::vector<DelayManager*>& dms,
+    TickTimer* tick_timer,
+    int num_spiky_packets,
+    int num_smooth_packets) {
+  uint16_t seq_no = 0;
+  uint32_t ts = 0;
+  int64_t arrival_ms = 0;
+  for (int i = 0; i < num_spiky_packets + num_smooth_packets; ++i) {
+    const int extra_delay_ms = (i < num_spiky_packets && i % 5 == 0) ? 60 : 0;
+    arrival_ms =
+        std::max(arrival_ms, int64_t{i} * kFrameSizeMs + extra_delay_ms);
+    while (static_cast<int64_t>(tick_timer->ticks()) * kTimeStepMs <
+           arrival_ms) {
+      tick_timer->Increment();
+    }
+    for (DelayManager* dm : dms) {
+      dm->Update(seq_no, ts, kFs);
+    }
+    ++seq_no;
+    ts += kTsIncrement;
+  }
+}
+
+}  // namespace
+
+TEST(DelayManagerLowLatencyTest, RecoversQuicklyAfterDelaySpikes) {
+  TickTimer tick_timer;
+  std::unique_ptr<DelayManager> default_dm = DelayManager::Create(
+      kMaxNumberOfPackets, kMinDelayMs, false, &tick_timer);
+  std::unique_ptr<DelayManager> low_latency_dm =
+      DelayManager::Create(kMaxNumberOfPackets, kMinDelayMs, false,
+                           &tick_timer, NetEq::Config::LowLatencyDelay());
+  default_dm->SetPacketAudioLength(kFrameSizeMs);
+  low_latency_dm->SetPacketAudioLength(kFrameSizeMs);
+
+  // Two seconds of delay spikes raise both targets.
+  InsertSpikyThenSmoothPackets({default_dm.get(), low_latency_dm.get()},
+                               &tick_timer, 100, 0);
+  EXPECT_GE(default_dm->TargetLevel(), 3 << 8);
+  EXPECT_GE(low_latency_dm->TargetLevel(), 3 << 8);
+
+  // After five seconds without jitter, only the low-latency target is back to
+  // a single packet.
+  InsertSpikyThenSmoothPackets({default_dm.get(), low_latency_dm.get()},
+                               &tick_timer, 0, 250);
+  EXPECT_GE(default_dm->TargetLevel(), 3 << 8);
+  EXPECT_EQ(1 << 8, low_latency_dm->TargetLevel());
+}
+
+TEST(DelayManagerLowLatencyTest, TargetLevelIsLimitedByMaxDelay) {
+  TickTimer tick_timer;
+  NetEq::Config::LowLatencyDelay low_latency_delay;
+  low_latency_delay.max_delay_ms = 50;
+  std::unique_ptr<DelayManager> dm =
+      DelayManager::Create(kMaxNumberOfPackets, kMinDelayMs, false,
+                           &tick_timer, low_latency_delay);
+  dm->SetPacketAudioLength(kFrameSizeMs);
+
+  InsertSpikyThenSmoothPackets({dm.get()}, &tick_timer, 100, 0);
+  // 50 ms is two and a half packets.
+  EXPECT_EQ((5 << 8) / 2, dm->TargetLevel());
+}
+
 }  // namespace webrtc
@@ -16,6 +16,7 @@
 #include <algorithm>  // Access to min, max.
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_coding/neteq/dsp_kernels.h"
 
 namespace webrtc {
 
@@ -277,15 +278,8 @@ void DspHelper::CrossFade(const int16_t* input1,
                           int16_t* mix_factor,
                           int16_t factor_decrement,
                           int16_t* output) {
-  int16_t factor = *mix_factor;
-  int16_t complement_factor = 16384 - factor;
-  for (size_t i = 0; i < length; i++) {
-    output[i] =
-        (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14;
-    factor -= factor_decrement;
-    complement_factor += factor_decrement;
-  }
-  *mix_factor = factor;
+  GetDspKernels().cross_fade(input1, input2, length, mix_factor,
+                             factor_decrement, output);
 }
 
 void DspHelper::UnmuteSignal(const int16_t* input,
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/dsp_kernels.h"
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/audio_coding/neteq/dsp_kernels_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/audio_coding/neteq/dsp_kernels_avx2.h"
+#include "modules/audio_coding/neteq/dsp_kernels_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
+namespace webrtc {
+
+namespace {
+
+void CrossFade_C(const int16_t* input1,
+                 const int16_t* input2,
+                 size_t length,
+                 int16_t* mix_factor,
+                 int16_t factor_decrement,
+                 int16_t* output) {
+  int16_t factor = *mix_factor;
+  int16_t complement_factor = 16384 - factor;
+  for (size_t i = 0; i < length; i++) {
+    output[i] =
+        (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14;
+    factor -= factor_decrement;
+    complement_factor += factor_decrement;
+  }
+  *mix_factor = factor;
+}
+
+#if defined(WEBRTC_HAS_NEON)
+// The cross-correlation is the existing NEON version from the signal
+// processing library.
+const DspKernels kDspKernels_NEON = {&DotProductWithScale_NEON,
+                                     &WebRtcSpl_CrossCorrelationNeon,
+                                     &CrossFade_NEON};
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+const DspKernels kDspKernels_SSE2 = {&DotProductWithScale_SSE2,
+                                     &CrossCorrelation_SSE2, &CrossFade_SSE2};
+const DspKernels kDspKernels_AVX2 = {&DotProductWithScale_AVX2,
+                                     &CrossCorrelation_AVX2, &CrossFade_AVX2};
+#endif
+
+const DspKernels kDspKernels_C = {&WebRtcSpl_DotProductWithScale,
+                                  &WebRtcSpl_CrossCorrelationC, &CrossFade_C};
+
+const DspKernels& SelectDspKernels() {
+#if defined(WEBRTC_HAS_NEON)
+  return kDspKernels_NEON;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    return kDspKernels_AVX2;
+  }
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(__SSE2__)
+  return kDspKernels_SSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? kDspKernels_SSE2 : kDspKernels_C;
+#endif
+#else
+  return kDspKernels_C;
+#endif
+}
+
+}  // namespace
+
+const DspKernels& GetDspKernels() {
+  static const DspKernels& kernels = SelectDspKernels();
+  return kernels;
+}
+
+const DspKernels& GetDspKernels_C() {
+  return kDspKernels_C;
+}
+
+}  // namespace webrtc
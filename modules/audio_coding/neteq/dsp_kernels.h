@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_H_
+#define MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+// The inner loops of the signal processing in NetEq (Expand, Merge,
+// Accelerate, PreemptiveExpand and Normal). Every implementation gives the
+// same output, bit for bit, as the portable one, except for the NEON
+// cross-correlation, which is the signal processing library's and shifts the
+// sum rather than each product.
+struct DspKernels {
+  // Same as WebRtcSpl_DotProductWithScale(): sums the products of |vector1|
+  // and |vector2|, each right shifted by |scaling|, and saturates the sum to
+  // 32 bits.
+  int32_t (*dot_product_with_scale)(const int16_t* vector1,
+                                    const int16_t* vector2,
+                                    size_t length,
+                                    int scaling);
+
+  // Same as WebRtcSpl_CrossCorrelation(): computes |dim_cross_correlation|
+  // dot products, as above but summed in 32 bits, moving |seq2| by
+  // |step_seq2| between them.
+  void (*cross_correlation)(int32_t* cross_correlation,
+                            const int16_t* seq1,
+                            const int16_t* seq2,
+                            size_t dim_seq,
+                            size_t dim_cross_correlation,
+                            int right_shifts,
+                            int step_seq2);
+
+  // Same as DspHelper::CrossFade(): mixes |input1| and |input2| with the
+  // factors |*mix_factor| and 16384 - |*mix_factor| in Q14, decreasing
+  // |*mix_factor| by |factor_decrement| for every sample.
+  void (*cross_fade)(const int16_t* input1,
+                     const int16_t* input2,
+                     size_t length,
+                     int16_t* mix_factor,
+                     int16_t factor_decrement,
+                     int16_t* output);
+};
+
+// Returns the kernels using the widest vector instructions the CPU supports.
+const DspKernels& GetDspKernels();
+
+// The portable kernels, exposed for testing.
+const DspKernels& GetDspKernels_C();
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_H_
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/dsp_kernels_avx2.h"
+
+#include <immintrin.h>
+
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+
+namespace {
+
+// Returns the products of the 16-bit lanes of |a| and |b|, each arithmetically
+// right shifted by |shift|, in 32-bit lanes. The order of the products is not
+// kept, which does not matter when summing them.
+inline void ShiftedProducts(__m256i a,
+                            __m256i b,
+                            __m128i shift,
+                            __m256i* products_0,
+                            __m256i* products_1) {
+  const __m256i low = _mm256_mullo_epi16(a, b);
+  const __m256i high = _mm256_mulhi_epi16(a, b);
+  *products_0 = _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), shift);
+  *products_1 = _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), shift);
+}
+
+// Adds the sign extended 32-bit lanes of |values| to the 64-bit lanes of
+// |sum|.
+inline __m256i AddToSum64(__m256i sum, __m256i values) {
+  const __m256i sign = _mm256_srai_epi32(values, 31);
+  sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(values, sign));
+  return _mm256_add_epi64(sum, _mm256_unpackhi_epi32(values, sign));
+}
+
+}  // namespace
+
+int32_t DotProductWithScale_AVX2(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 size_t length,
+                                 int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m256i sum = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m256i products_0;
+    __m256i products_1;
+    ShiftedProducts(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vector1 + i)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vector2 + i)),
+        shift, &products_0, &products_1);
+    sum = AddToSum64(sum, products_0);
+    sum = AddToSum64(sum, products_1);
+  }
+  int64_t sums[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), sum);
+  int64_t total = sums[0] + sums[1] + sums[2] + sums[3];
+  for (; i < length; ++i) {
+    total += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return rtc::saturated_cast<int32_t>(total);
+}
+
+void CrossCorrelation_AVX2(int32_t* cross_correlation,
+                           const int16_t* seq1,
+                           const int16_t* seq2,
+                           size_t dim_seq,
+                           size_t dim_cross_correlation,
+                           int right_shifts,
+                           int step_seq2) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  for (size_t lag = 0; lag < dim_cross_correlation; ++lag) {
+    // Like the portable version, sum in 32 bits; the caller picks
+    // |right_shifts| so that this does not overflow.
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= dim_seq; i += 16) {
+      __m256i products_0;
+      __m256i products_1;
+      ShiftedProducts(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq1 + i)),
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seq2 + i)),
+          shift, &products_0, &products_1);
+      sum = _mm256_add_epi32(sum, _mm256_add_epi32(products_0, products_1));
+    }
+    __m128i sum_128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                    _mm256_extracti128_si256(sum, 1));
+    sum_128 = _mm_add_epi32(sum_128,
+                            _mm_shuffle_epi32(sum_128, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum_128 = _mm_add_epi32(sum_128,
+                            _mm_shuffle_epi32(sum_128, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t total = static_cast<uint32_t>(_mm_cvtsi128_si32(sum_128));
+    for (; i < dim_seq; ++i) {
+      total += static_cast<uint32_t>((seq1[i] * seq2[i]) >> right_shifts);
+    }
+    cross_correlation[lag] = static_cast<int32_t>(total);
+    seq2 += step_seq2;
+  }
+}
+
+void CrossFade_AVX2(const int16_t* input1,
+                    const int16_t* input2,
+                    size_t length,
+                    int16_t* mix_factor,
+                    int16_t factor_decrement,
+                    int16_t* output) {
+  int16_t factor = *mix_factor;
+  const __m256i rounding = _mm256_set1_epi32(8192);
+  const __m256i q14_one = _mm256_set1_epi16(16384);
+  // The factors of 16 consecutive samples, and how much they change from one
+  // group of 16 to the next.
+  __m256i factors = _mm256_sub_epi16(
+      _mm256_set1_epi16(factor),
+      _mm256_mullo_epi16(_mm256_set1_epi16(factor_decrement),
+                         _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
+                                           11, 12, 13, 14, 15)));
+  const __m256i factors_step =
+      _mm256_set1_epi16(static_cast<int16_t>(16 * factor_decrement));
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m256i in1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input1 + i));
+    const __m256i in2 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input2 + i));
+    const __m256i complement_factors = _mm256_sub_epi16(q14_one, factors);
+    // factor * input1 + complement_factor * input2, in 32 bits. Unpacking and
+    // packing both work within 128-bit lanes, so the output is in order.
+    __m256i mixed_low =
+        _mm256_madd_epi16(_mm256_unpacklo_epi16(factors, complement_factors),
+                          _mm256_unpacklo_epi16(in1, in2));
+    __m256i mixed_high =
+        _mm256_madd_epi16(_mm256_unpackhi_epi16(factors, complement_factors),
+                          _mm256_unpackhi_epi16(in1, in2));
+    mixed_low = _mm256_srai_epi32(_mm256_add_epi32(mixed_low, rounding), 14);
+    mixed_high = _mm256_srai_epi32(_mm256_add_epi32(mixed_high, rounding), 14);
+    // Truncate to 16 bits, as the assignment in the portable version does,
+    // rather than saturate.
+    mixed_low = _mm256_srai_epi32(_mm256_slli_epi32(mixed_low, 16), 16);
+    mixed_high = _mm256_srai_epi32(_mm256_slli_epi32(mixed_high, 16), 16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                        _mm256_packs_epi32(mixed_low, mixed_high));
+    factors = _mm256_sub_epi16(factors, factors_step);
+  }
+  factor = static_cast<int16_t>(
+      _mm_extract_epi16(_mm256_castsi256_si128(factors), 0));
+  int16_t complement_factor = 16384 - factor;
+  for (; i < length; ++i) {
+    output[i] =
+        (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14;
+    factor -= factor_decrement;
+    complement_factor += factor_decrement;
+  }
+  *mix_factor = factor;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,40 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_AVX2_H_
+#define MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_AVX2_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+// The DspKernels implemented with AVX2 instructions.
+int32_t DotProductWithScale_AVX2(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 size_t length,
+                                 int scaling);
+void CrossCorrelation_AVX2(int32_t* cross_correlation,
+                           const int16_t* seq1,
+                           const int16_t* seq2,
+                           size_t dim_seq,
+                           size_t dim_cross_correlation,
+                           int right_shifts,
+                           int step_seq2);
+void CrossFade_AVX2(const int16_t* input1,
+                    const int16_t* input2,
+                    size_t length,
+                    int16_t* mix_factor,
+                    int16_t factor_decrement,
+                    int16_t* output);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_AVX2_H_
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/dsp_kernels_neon.h"
+
+#include <arm_neon.h>
+
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+
+int32_t DotProductWithScale_NEON(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 size_t length,
+                                 int scaling) {
+  // Shifting left by a negative amount shifts right arithmetically.
+  const int32x4_t shift = vdupq_n_s32(-scaling);
+  int64x2_t sum = vdupq_n_s64(0);
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const int16x8_t a = vld1q_s16(vector1 + i);
+    const int16x8_t b = vld1q_s16(vector2 + i);
+    const int32x4_t products_low =
+        vshlq_s32(vmull_s16(vget_low_s16(a), vget_low_s16(b)), shift);
+    const int32x4_t products_high =
+        vshlq_s32(vmull_s16(vget_high_s16(a), vget_high_s16(b)), shift);
+    sum = vpadalq_s32(sum, products_low);
+    sum = vpadalq_s32(sum, products_high);
+  }
+  int64_t total = vgetq_lane_s64(sum, 0) + vgetq_lane_s64(sum, 1);
+  for (; i < length; ++i) {
+    total += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return rtc::saturated_cast<int32_t>(total);
+}
+
+void CrossFade_NEON(const int16_t* input1,
+                    const int16_t* input2,
+                    size_t length,
+                    int16_t* mix_factor,
+                    int16_t factor_decrement,
+                    int16_t* output) {
+  int16_t factor = *mix_factor;
+  static const int16_t kSteps[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  const int16x8_t q14_one = vdupq_n_s16(16384);
+  // The factors of eight consecutive samples, and how much they change from
+  // one group of eight to the next.
+  int16x8_t factors = vmlsq_s16(vdupq_n_s16(factor), vld1q_s16(kSteps),
+                                vdupq_n_s16(factor_decrement));
+  const int16x8_t factors_step =
+      vdupq_n_s16(static_cast<int16_t>(8 * factor_decrement));
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const int16x8_t in1 = vld1q_s16(input1 + i);
+    const int16x8_t in2 = vld1q_s16(input2 + i);
+    const int16x8_t complement_factors = vsubq_s16(q14_one, factors);
+    int32x4_t mixed_low =
+        vmull_s16(vget_low_s16(factors), vget_low_s16(in1));
+    mixed_low = vmlal_s16(mixed_low, vget_low_s16(complement_factors),
+                          vget_low_s16(in2));
+    int32x4_t mixed_high =
+        vmull_s16(vget_high_s16(factors), vget_high_s16(in1));
+    mixed_high = vmlal_s16(mixed_high, vget_high_s16(complement_factors),
+                           vget_high_s16(in2));
+    // Round, shift and truncate to 16 bits, as the portable version does.
+    mixed_low = vshrq_n_s32(vaddq_s32(mixed_low, vdupq_n_s32(8192)), 14);
+    mixed_high = vshrq_n_s32(vaddq_s32(mixed_high, vdupq_n_s32(8192)), 14);
+    vst1q_s16(output + i,
+              vcombine_s16(vmovn_s32(mixed_low), vmovn_s32(mixed_high)));
+    factors = vsubq_s16(factors, factors_step);
+  }
+  factor = vgetq_lane_s16(factors, 0);
+  int16_t complement_factor = 16384 - factor;
+  for (; i < length; ++i) {
+    output[i] =
+        (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14;
+    factor -= factor_decrement;
+    complement_factor += factor_decrement;
+  }
+  *mix_factor = factor;
+}
+
+}  // namespace webrtc
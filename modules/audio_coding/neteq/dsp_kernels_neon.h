@@ -0,0 +1,33 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_NEON_H_
+#define MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_NEON_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+// The DspKernels implemented with NEON instructions.
+int32_t DotProductWithScale_NEON(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 size_t length,
+                                 int scaling);
+void CrossFade_NEON(const int16_t* input1,
+                    const int16_t* input2,
+                    size_t length,
+                    int16_t* mix_factor,
+                    int16_t factor_decrement,
+                    int16_t* output);
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_NETEQ_DSP_KERNELS_NEON_H_
@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/dsp_kernels_sse2.h"
+
+#include <emmintrin.h>
+
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+
+namespace {
+
+// Returns the products of the 16-bit lanes of |a| and |b|, each arithmetically
+// right shifted by |shift|, in four 32-bit lanes per output.
+inline void ShiftedProducts(__m128i a,
+                            __m128i b,
+                            __m128i shift,
+                            __m128i* products_low,
+                            __m128i* products_high) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  const __m128i high = _mm_mulhi_epi16(a, b);
+  *products_low = _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift);
+  *products_high = _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift);
+}
+
+// Adds the sign extended 32-bit lanes of |values| to the 64-bit lanes of
+// |sum|.
+inline __m128i AddToSum64(__m128i sum, __m128i values) {
+  const __m128i sign = _mm_srai_epi32(values, 31);
+  sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(values, sign));
+  return _mm_add_epi64(sum, _mm_unpackhi_epi32(values, sign));
+}
+
+}  // namespace
+
+int32_t DotProductWithScale_SSE2(const int16_t* vector1,
+                                 const int16_t* vector2,
+                                 size_t length,
+                                 int scaling) {
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m128i sum = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    __m128i products_low;
+    __m128i products_high;
+    ShiftedProducts(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(vector1 + i)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(vector2 + i)), shift,
+        &products_low, &products_high);
+    sum = AddToSum64(sum, products_low);
+    sum = AddToSum64(sum, products_high);
+  }
+  int64_t sums[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum);
+  int64_t total = sums[0] + sums[1];
+  for (; i < length; ++i) {
+    total += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return rtc::saturated_cast<int32_t>(total);
+}
+
+void CrossCorrelation_SSE2(int32_t* cross_correlation,
+                           const int16_t* seq1,
+                           const int16_t* seq2,
+                           size_t dim_seq,
+                           size_t dim_cross_correlation,
+                           int right_shifts,
+                           int step_seq2) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  for (size_t lag = 0; lag < dim_cross_correlation; ++lag) {
+    // Like the portable version, sum in 32 bits; the caller picks
+    // |right_shifts| so that this does not overflow.
+    __m128i sum = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= dim_seq; i += 8) {
+      __m128i products_low;
+      __m128i products_high;
+      ShiftedProducts(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(seq1 + i)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(seq2 + i)), shift,
+          &products_low, &products_high);
+      sum = _mm_add_epi32(sum, _mm_add_epi32(products_low, products_high));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    uint32_t total = static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+    for (; i < dim_seq; ++i) {
+      total += static_cast<uint32_t>((seq1[i] * seq2[i]) >> right_shifts);
+    }
+    cross_correlation[lag] = static_cast<int32_t>(total);
+    seq2 += step_seq2;
+  }
+}
+
+void CrossFade_SSE2(const int16_t* input1,
+                    const int16_t* input2,
+                    size_t length,
+                    int16_t* mix_factor,
+                    int16_t factor_decrement,
+                    int16_t* output) {
+  int16_t factor = *mix_factor;
+  const __m128i rounding = _mm_set1_epi32(8192);
+  const __m128i q14_one = _mm_set1_epi16(16384);
+  // The factors of eight consecutive samples, and how much they change from
+  // one group of eight to the next.
+  __m128i factors = _mm_sub_epi16(
+      _mm_set1_epi16(factor),
+      _mm_mullo_epi16(_mm_set1_epi16(factor_decrement),
+                      _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7)));
+  const __m128i factors_step =
+      _mm_set1_epi16(static_cast<int16_t>(8 * factor_decrement));
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const __m128i in1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input1 + i));
+    const __m128i in2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input2 + i));
+    const __m128i complement_factors = _mm_sub_epi16(q14_one, factors);
+    // factor * input1 + complement_factor * input2, in 32 bits.
+    __m128i mixed_low =
+        _mm_madd_epi16(_mm_unpacklo_epi16(factors, complement_factors),
+                       _mm_unpacklo_epi16(in1, in2));
+    __m128i mixed_high =
+        _mm_madd_epi16(_mm_unpackhi_epi16(factors, complement_factors),
+                       _mm_unpackhi_epi16(in1, in2));
+    mixed_low = _mm_srai_epi32(_mm_add_epi32(mixed_low, rounding), 14);
+    mixed_high = _mm_srai_epi32(_mm_add_epi32(mixed_high, rounding), 14);
+    // Truncate to 16 bits, as the assignment in the portable version does,
+    // rather than saturate.
+    mixed_low = _mm_srai_epi32(_mm_slli_epi32(mixed_low, 16), 16);
+    mixed_high = _mm_srai_epi32(_mm_slli_epi32(mixed_high, 16), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm_packs_epi32(mixed_low, mixed_high));
+    factors = _mm_sub_epi16(factors, factors_step);
+  }
+  factor = static_cast<int16_t>(_mm_extract_epi16(factors, 0));
+  int16_t complement_factor = 16384 - factor;
+  for (; i < length; ++i) {
+    output[i] =
+        (factor * input1[i] + complement_factor * input2[i] + 8192) >> 14;
+    factor -= factor_decrement;
+    complement_factor += factor_decrement;
+  }
+  *mix_factor = factor;
+}
+
+}  // namespace webrtc
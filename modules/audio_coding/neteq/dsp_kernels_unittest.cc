@@ -0,0 +1,237 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/dsp_kernels.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/audio_coding/neteq/dsp_kernels_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/audio_coding/neteq/dsp_kernels_avx2.h"
+#include "modules/audio_coding/neteq/dsp_kernels_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
+namespace webrtc {
+
+namespace {
+
+using DotProductWithScaleFunction = int32_t (*)(const int16_t*,
+                                                const int16_t*,
+                                                size_t,
+                                                int);
+using CrossCorrelationFunction =
+    void (*)(int32_t*, const int16_t*, const int16_t*, size_t, size_t, int, int);
+using CrossFadeFunction = void (*)(const int16_t*,
+                                   const int16_t*,
+                                   size_t,
+                                   int16_t*,
+                                   int16_t,
+                                   int16_t*);
+
+constexpr size_t kMaxLength = 300;
+
+std::vector<int16_t> RandomSamples(Random* random,
+                                   size_t length,
+                                   int16_t max_abs) {
+  std::vector<int16_t> samples(length);
+  for (int16_t& sample : samples)
+    sample = static_cast<int16_t>(random->Rand(-max_abs, max_abs));
+  return samples;
+}
+
+// Full scale samples, with many at the extremes.
+std::vector<int16_t> ExtremeSamples(Random* random, size_t length) {
+  std::vector<int16_t> samples(length);
+  for (int16_t& sample : samples) {
+    const int choice = random->Rand(0, 3);
+    sample = choice == 0 ? -32768
+                         : choice == 1 ? 32767 : random->Rand<int16_t>();
+  }
+  return samples;
+}
+
+void VerifyDotProductWithScale(DotProductWithScaleFunction dot_product) {
+  Random random(0x5eed);
+  const DotProductWithScaleFunction reference =
+      GetDspKernels_C().dot_product_with_scale;
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    // Covers sums that saturate.
+    const std::vector<int16_t> a = ExtremeSamples(&random, length);
+    const std::vector<int16_t> b = ExtremeSamples(&random, length);
+    for (int scaling : {0, 1, 5, 16}) {
+      ASSERT_EQ(reference(a.data(), b.data(), length, scaling),
+                dot_product(a.data(), b.data(), length, scaling))
+          << "length " << length << ", scaling " << scaling;
+      ASSERT_EQ(reference(a.data(), a.data(), length, scaling),
+                dot_product(a.data(), a.data(), length, scaling))
+          << "length " << length << ", scaling " << scaling;
+    }
+  }
+}
+
+void VerifyCrossCorrelation(CrossCorrelationFunction cross_correlation) {
+  Random random(0xc0);
+  const CrossCorrelationFunction reference =
+      GetDspKernels_C().cross_correlation;
+  constexpr size_t kMaxLags = 40;
+  for (size_t length = 1; length <= kMaxLength; length += 7) {
+    for (int step : {1, -1, 2}) {
+      const size_t num_lags = 1 + length % kMaxLags;
+      const size_t slide = (num_lags - 1) * 2;
+      // The shifts keep the 32-bit sums from overflowing, as the callers do.
+      for (int right_shifts : {0, 3, 9}) {
+        const std::vector<int16_t> seq1 =
+            right_shifts < 9 ? RandomSamples(&random, length, 2000)
+                             : ExtremeSamples(&random, length);
+        const std::vector<int16_t> seq2 =
+            right_shifts < 9 ? RandomSamples(&random, length + 2 * slide, 2000)
+                             : ExtremeSamples(&random, length + 2 * slide);
+        const int16_t* seq2_start = &seq2[slide];
+        std::vector<int32_t> expected(num_lags);
+        std::vector<int32_t> actual(num_lags);
+        reference(expected.data(), seq1.data(), seq2_start, length, num_lags,
+                  right_shifts, step);
+        cross_correlation(actual.data(), seq1.data(), seq2_start, length,
+                          num_lags, right_shifts, step);
+        ASSERT_EQ(expected, actual) << "length " << length << ", step "
+                                    << step << ", shifts " << right_shifts;
+      }
+    }
+  }
+}
+
+void VerifyCrossFade(CrossFadeFunction cross_fade) {
+  Random random(0xfade);
+  const CrossFadeFunction reference = GetDspKernels_C().cross_fade;
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    const std::vector<int16_t> input1 = ExtremeSamples(&random, length);
+    const std::vector<int16_t> input2 = ExtremeSamples(&random, length);
+    // A fade as NetEq does it, and arbitrary factors that wrap around.
+    const int16_t fades[][2] = {
+        {16384, static_cast<int16_t>(16384 / (length + 1))},
+        {random.Rand<int16_t>(), random.Rand<int16_t>()}};
+    for (const auto& fade : fades) {
+      int16_t expected_factor = fade[0];
+      int16_t actual_factor = fade[0];
+      std::vector<int16_t> expected(length);
+      std::vector<int16_t> actual(length);
+      reference(input1.data(), input2.data(), length, &expected_factor,
+                fade[1], expected.data());
+      cross_fade(input1.data(), input2.data(), length, &actual_factor, fade[1],
+                 actual.data());
+      ASSERT_EQ(expected, actual) << "length " << length;
+      ASSERT_EQ(expected_factor, actual_factor) << "length " << length;
+    }
+  }
+}
+
+// Logs how long each operation takes with |kernels|, at the sizes NetEq uses
+// at 48 kHz.
+void Benchmark(const std::string& name, const DspKernels& kernels) {
+  constexpr int kIterations = 100000;
+  constexpr size_t kLength = 480;
+  constexpr size_t kLags = 60;
+  Random random(0xbe);
+  const std::vector<int16_t> a = RandomSamples(&random, kLength + kLags, 8000);
+  const std::vector<int16_t> b = RandomSamples(&random, kLength + kLags, 8000);
+  std::vector<int16_t> faded(kLength);
+  std::vector<int32_t> correlation(kLags);
+  int32_t sink = 0;
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i)
+    sink += kernels.dot_product_with_scale(a.data(), b.data(), kLength, 2);
+  const int64_t dot_product_us = rtc::TimeMicros() - start_us;
+
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations / 10; ++i) {
+    kernels.cross_correlation(correlation.data(), a.data(), b.data(), kLength,
+                              kLags, 6, 1);
+    sink += correlation[0];
+  }
+  const int64_t cross_correlation_us = rtc::TimeMicros() - start_us;
+
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i) {
+    int16_t factor = 16384;
+    kernels.cross_fade(a.data(), b.data(), kLength, &factor, 34, faded.data());
+    sink += faded[i % kLength];
+  }
+  const int64_t cross_fade_us = rtc::TimeMicros() - start_us;
+
+  RTC_LOG(LS_INFO) << name << ": dot product "
+                   << dot_product_us * 1000 / kIterations
+                   << " ns, cross-correlation of " << kLags << " lags "
+                   << cross_correlation_us * 10000 / kIterations
+                   << " ns, cross-fade " << cross_fade_us * 1000 / kIterations
+                   << " ns (" << sink << ")";
+}
+
+}  // namespace
+
+TEST(DspKernelsTest, Portable) {
+  VerifyDotProductWithScale(GetDspKernels_C().dot_product_with_scale);
+  VerifyCrossCorrelation(GetDspKernels_C().cross_correlation);
+  VerifyCrossFade(GetDspKernels_C().cross_fade);
+}
+
+TEST(DspKernelsTest, Dispatched) {
+  VerifyDotProductWithScale(GetDspKernels().dot_product_with_scale);
+#if !defined(WEBRTC_HAS_NEON)
+  VerifyCrossCorrelation(GetDspKernels().cross_correlation);
+#endif
+  VerifyCrossFade(GetDspKernels().cross_fade);
+}
+
+#if defined(WEBRTC_HAS_NEON)
+
+TEST(DspKernelsTest, Neon) {
+  VerifyDotProductWithScale(&DotProductWithScale_NEON);
+  VerifyCrossFade(&CrossFade_NEON);
+}
+
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+
+TEST(DspKernelsTest, Sse2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    VerifyDotProductWithScale(&DotProductWithScale_SSE2);
+    VerifyCrossCorrelation(&CrossCorrelation_SSE2);
+    VerifyCrossFade(&CrossFade_SSE2);
+  }
+}
+
+TEST(DspKernelsTest, Avx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    VerifyDotProductWithScale(&DotProductWithScale_AVX2);
+    VerifyCrossCorrelation(&CrossCorrelation_AVX2);
+    VerifyCrossFade(&CrossFade_AVX2);
+  }
+}
+
+#endif
+
+TEST(DspKernelsTest, DISABLED_Benchmark) {
+  Benchmark("Portable", GetDspKernels_C());
+  Benchmark("Dispatched", GetDspKernels());
+}
+
+}  // namespace webrtc
@@ -21,6 +21,7 @@
 #include "modules/audio_coding/neteq/background_noise.h"
 #include "modules/audio_coding/neteq/cross_correlation.h"
 #include "modules/audio_coding/neteq/dsp_helper.h"
+#include "modules/audio_coding/neteq/dsp_kernels.h"
 #include "modules/audio_coding/neteq/random_vector.h"
 #include "modules/audio_coding/neteq/statistics_calculator.h"
 #include "modules/audio_coding/neteq/sync_buffer.h"
@@ -488,7 +489,7 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     correlation_scale = std::max(0, correlation_scale);
 
     // Calculate the correlation, store in |correlation_vector2|.
-    WebRtcSpl_CrossCorrelation(
+    GetDspKernels().cross_correlation(
         correlation_vector2,
         &(audio_history[signal_length - correlation_length]),
         &(audio_history[signal_length - correlation_length - start_index]),
@@ -501,11 +502,11 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     best_index = best_index + start_index;
 
     // Calculate energies.
-    int32_t energy1 = WebRtcSpl_DotProductWithScale(
+    int32_t energy1 = GetDspKernels().dot_product_with_scale(
         &(audio_history[signal_length - correlation_length]),
         &(audio_history[signal_length - correlation_length]),
         correlation_length, correlation_scale);
-    int32_t energy2 = WebRtcSpl_DotProductWithScale(
+    int32_t energy2 = GetDspKernels().dot_product_with_scale(
         &(audio_history[signal_length - correlation_length - best_index]),
         &(audio_history[signal_length - correlation_length - best_index]),
         correlation_length, correlation_scale);
@@ -542,10 +543,10 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     const int16_t* vector1 = &(audio_history[signal_length - expansion_length]);
     const int16_t* vector2 = vector1 - distortion_lag;
     // Normalize the second vector to the same energy as the first.
-    energy1 = WebRtcSpl_DotProductWithScale(vector1, vector1, expansion_length,
-                                            correlation_scale);
-    energy2 = WebRtcSpl_DotProductWithScale(vector2, vector2, expansion_length,
-                                            correlation_scale);
+    energy1 = GetDspKernels().dot_product_with_scale(
+        vector1, vector1, expansion_length, correlation_scale);
+    energy2 = GetDspKernels().dot_product_with_scale(
+        vector2, vector2, expansion_length, correlation_scale);
     // Confirm that amplitude ratio sqrt(energy1 / energy2) is within 0.5 - 2.0,
     // i.e., energy1 / energy2 is within 0.25 - 4.
     int16_t amplitude_ratio;
@@ -691,7 +692,7 @@ void Expand::AnalyzeSignal(int16_t* random_vector) {
     int unvoiced_prescale =
         std::max(0, 2 * WebRtcSpl_GetSizeInBits(unvoiced_max_abs) - 24);
 
-    int32_t unvoiced_energy = WebRtcSpl_DotProductWithScale(
+    int32_t unvoiced_energy = GetDspKernels().dot_product_with_scale(
         unvoiced_vector, unvoiced_vector, 128, unvoiced_prescale);
 
     // Normalize |unvoiced_energy| to 28 or 29 bits to preserve sqrt() accuracy.
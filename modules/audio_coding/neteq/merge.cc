@@ -20,6 +20,7 @@
 #include "modules/audio_coding/neteq/audio_multi_vector.h"
 #include "modules/audio_coding/neteq/cross_correlation.h"
 #include "modules/audio_coding/neteq/dsp_helper.h"
+#include "modules/audio_coding/neteq/dsp_kernels.h"
 #include "modules/audio_coding/neteq/expand.h"
 #include "modules/audio_coding/neteq/sync_buffer.h"
 #include "rtc_base/numerics/safe_conversions.h"
@@ -217,7 +218,7 @@ int16_t Merge::SignalScaling(const int16_t* input,
       (expanded_max * expanded_max) / (std::numeric_limits<int32_t>::max() /
                                        static_cast<int32_t>(mod_input_length));
   const int expanded_shift = factor == 0 ? 0 : 31 - WebRtcSpl_NormW32(factor);
-  int32_t energy_expanded = WebRtcSpl_DotProductWithScale(
+  int32_t energy_expanded = GetDspKernels().dot_product_with_scale(
       expanded_signal, expanded_signal, mod_input_length, expanded_shift);
 
   // Calculate energy of input signal.
@@ -225,7 +226,7 @@ int16_t Merge::SignalScaling(const int16_t* input,
   factor = (input_max * input_max) / (std::numeric_limits<int32_t>::max() /
                                       static_cast<int32_t>(mod_input_length));
   const int input_shift = factor == 0 ? 0 : 31 - WebRtcSpl_NormW32(factor);
-  int32_t energy_input = WebRtcSpl_DotProductWithScale(
+  int32_t energy_input = GetDspKernels().dot_product_with_scale(
       input, input, mod_input_length, input_shift);
 
   // Align to the same Q-domain.
@@ -61,6 +61,7 @@ std::unique_ptr<NetEqController> CreateNetEqController(
     int max_packets_in_buffer,
     bool enable_rtx_handling,
     bool allow_time_stretching,
+    const absl::optional<NetEq::Config::LowLatencyDelay>& low_latency_delay,
     TickTimer* tick_timer,
     webrtc::Clock* clock) {
   NetEqController::Config config;
@@ -68,6 +69,7 @@ std::unique_ptr<NetEqController> CreateNetEqController(
   config.max_packets_in_buffer = max_packets_in_buffer;
   config.enable_rtx_handling = enable_rtx_handling;
   config.allow_time_stretching = allow_time_stretching;
+  config.low_latency_delay = low_latency_delay;
   config.tick_timer = tick_timer;
   config.clock = clock;
   return controller_factory.CreateNetEqController(config);
@@ -95,6 +97,7 @@ NetEqImpl::Dependencies::Dependencies(
                                 config.max_packets_in_buffer,
                                 config.enable_rtx_handling,
                                 !config.for_test_no_time_stretching,
+                                config.low_latency_delay,
                                 tick_timer.get(),
                                 clock)),
       red_payload_splitter(new RedPayloadSplitter),
@@ -124,7 +127,6 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       controller_(std::move(deps.neteq_controller)),
       last_mode_(Mode::kNormal),
       decoded_buffer_length_(kMaxFrameSize),
-      decoded_buffer_(new int16_t[decoded_buffer_length_]),
       playout_timestamp_(0),
       new_codec_(false),
       timestamp_(0),
@@ -133,6 +135,7 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       enable_fast_accelerate_(config.enable_fast_accelerate),
       nack_enabled_(false),
       enable_muted_state_(config.enable_muted_state),
+      skip_decoding_audio_level_(config.skip_decoding_audio_level),
       expand_uma_logger_("WebRTC.Audio.ExpandRatePercent",
                          10,  // Report once every 10 s.
                          tick_timer_.get()),
@@ -532,6 +535,12 @@ int NetEqImpl::InsertPacketInternal(const RTPHeader& rtp_header,
   int64_t receive_time_ms = clock_->TimeInMilliseconds();
   stats_->ReceivedPacket();
 
+  if (skip_decoding_audio_level_ &&
+      (!active_packet_stopwatch_ || !rtp_header.extension.hasAudioLevel ||
+       rtp_header.extension.audioLevel < *skip_decoding_audio_level_)) {
+    active_packet_stopwatch_ = tick_timer_->GetNewStopwatch();
+  }
+
   PacketList packet_list;
   // Insert packet in a packet list.
   packet_list.push_back([&rtp_header, &payload, &receive_time_ms] {
@@ -824,6 +833,22 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame,
     *muted = true;
     return 0;
   }
+  if (ShouldSkipDecoding()) {
+    SkipDecoding(audio_frame);
+    *muted = true;
+    return 0;
+  }
+  if (skipping_decoding_) {
+    // Resume with the next packet, as if it followed what was last played, so
+    // that it is decoded right away instead of being concealed towards. The
+    // decoder state is stale.
+    skipping_decoding_ = false;
+    const Packet* next_packet = packet_buffer_->PeekNextPacket();
+    if (next_packet) {
+      sync_buffer_->set_end_timestamp(next_packet->timestamp);
+    }
+    reset_decoder_ = true;
+  }
   int return_value = GetDecision(&operation, &packet_list, &dtmf_event,
                                  &play_dtmf, action_override);
   if (return_value != 0) {
@@ -1035,6 +1060,40 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame,
   return return_value;
 }
 
+bool NetEqImpl::ShouldSkipDecoding() const {
+  // Long enough for the pauses within speech to still be decoded.
+  constexpr int64_t kQuietTimeBeforeSkippingMs = 200;
+  return skip_decoding_audio_level_ && active_packet_stopwatch_ &&
+         active_packet_stopwatch_->ElapsedMs() >= kQuietTimeBeforeSkippingMs &&
+         !first_packet_ && dtmf_buffer_->Empty();
+}
+
+void NetEqImpl::SkipDecoding(AudioFrame* audio_frame) {
+  if (!skipping_decoding_) {
+    // Decoding later resumes from silence, not from what was last decoded.
+    skipping_decoding_ = true;
+    sync_buffer_->Flush();
+    sync_buffer_->set_next_index(sync_buffer_->next_index() -
+                                 expand_->overlap_length());
+    expand_->Reset();
+    last_mode_ = Mode::kNormal;
+  }
+  playout_timestamp_ += static_cast<uint32_t>(output_size_samples_);
+  sync_buffer_->set_end_timestamp(
+      playout_timestamp_ + static_cast<uint32_t>(sync_buffer_->FutureLength()));
+  // The packets still to be played stay in the buffer, so the delay is kept.
+  packet_buffer_->DiscardAllOldPackets(playout_timestamp_, stats_.get());
+
+  audio_frame->Reset();
+  RTC_DCHECK(audio_frame->muted());  // Reset() should mute the frame.
+  audio_frame->sample_rate_hz_ = fs_hz_;
+  audio_frame->samples_per_channel_ = output_size_samples_;
+  audio_frame->timestamp_ =
+      timestamp_scaler_->ToExternal(playout_timestamp_) -
+      static_cast<uint32_t>(audio_frame->samples_per_channel_);
+  audio_frame->num_channels_ = sync_buffer_->Channels();
+}
+
 int NetEqImpl::GetDecision(Operation* operation,
                            PacketList* packet_list,
                            DtmfEvent* dtmf_event,
@@ -1392,6 +1451,11 @@ int NetEqImpl::Decode(PacketList* packet_list,
     reset_decoder_ = false;
   }
 
+  // The decode buffer is allocated once there is a decoder to use it, so that
+  // a stream which never receives audio doesn't hold it.
+  if (decoder && !decoded_buffer_)
+    decoded_buffer_.reset(new int16_t[decoded_buffer_length_]);
+
   *decoded_length = 0;
   // Update codec-internal PLC state.
   if ((*operation == Operation::kMerge) && decoder && decoder->HasDecodePlc()) {
@@ -2126,9 +2190,9 @@ void NetEqImpl::SetSampleRateAndChannels(int fs_hz, size_t channels) {
 
   // Verify that |decoded_buffer_| is long enough.
   if (decoded_buffer_length_ < kMaxFrameSize * channels) {
-    // Reallocate to larger size.
+    // Reallocate to larger size on the next decode.
     decoded_buffer_length_ = kMaxFrameSize * channels;
-    decoded_buffer_.reset(new int16_t[decoded_buffer_length_]);
+    decoded_buffer_.reset();
   }
   RTC_CHECK(controller_) << "Unexpectedly found no NetEqController";
   controller_->SetSampleRate(fs_hz_, output_size_samples_);
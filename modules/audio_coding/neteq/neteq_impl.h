@@ -219,6 +219,15 @@ class NetEqImpl : public webrtc::NetEq {
                        absl::optional<Operation> action_override)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
+  // Returns true if the received packets have been quiet for long enough to
+  // stop decoding. See NetEq::Config::skip_decoding_audio_level.
+  bool ShouldSkipDecoding() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Writes a muted frame to |audio_frame| instead of decoding, and discards
+  // the packets whose playout time has passed.
+  void SkipDecoding(AudioFrame* audio_frame)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
   // Provides a decision to the GetAudioInternal method. The decision what to
   // do is written to |operation|. Packets to decode are written to
   // |packet_list|, and a DTMF event to play is written to |dtmf_event|. When
@@ -390,6 +399,13 @@ class NetEqImpl : public webrtc::NetEq {
   std::unique_ptr<NackTracker> nack_ RTC_GUARDED_BY(crit_sect_);
   bool nack_enabled_ RTC_GUARDED_BY(crit_sect_);
   const bool enable_muted_state_ RTC_GUARDED_BY(crit_sect_);
+  const absl::optional<int> skip_decoding_audio_level_
+      RTC_GUARDED_BY(crit_sect_);
+  // Time since a packet louder than |skip_decoding_audio_level_|, or without
+  // an audio level, was received.
+  std::unique_ptr<TickTimer::Stopwatch> active_packet_stopwatch_
+      RTC_GUARDED_BY(crit_sect_);
+  bool skipping_decoding_ RTC_GUARDED_BY(crit_sect_) = false;
   AudioFrame::VADActivity last_vad_activity_ RTC_GUARDED_BY(crit_sect_) =
       AudioFrame::kVadPassive;
   std::unique_ptr<TickTimer::Stopwatch> generated_noise_stopwatch_
@@ -1512,6 +1512,68 @@ TEST_F(NetEqImplTest, InsertEmptyPacket) {
   neteq_->InsertEmptyPacket(rtp_header);
 }
 
+TEST_F(NetEqImplTest, SkipsDecodingWhileAudioLevelIsQuiet) {
+  constexpr int kSkipDecodingAudioLevel = 100;
+  config_.skip_decoding_audio_level = kSkipDecodingAudioLevel;
+  UseNoMocks();
+  CreateInstance();
+
+  const size_t kPayloadLengthSamples = 80;
+  const size_t kPayloadLengthBytes = 2 * kPayloadLengthSamples;  // PCM 16-bit.
+  const uint8_t kPayloadType = 17;  // Just an arbitrary number.
+  uint8_t payload[kPayloadLengthBytes];
+  // Constant, non-zero samples.
+  for (size_t i = 0; i < kPayloadLengthBytes; i += 2) {
+    payload[i] = 0x10;
+    payload[i + 1] = 0x00;
+  }
+  RTPHeader rtp_header;
+  rtp_header.payloadType = kPayloadType;
+  rtp_header.sequenceNumber = 0x1234;
+  rtp_header.timestamp = 0x12345678;
+  rtp_header.ssrc = 0x87654321;
+  rtp_header.extension.hasAudioLevel = true;
+
+  EXPECT_TRUE(neteq_->RegisterPayloadType(kPayloadType,
+                                          SdpAudioFormat("l16", 8000, 1)));
+
+  // Inserts a 10 ms packet with |audio_level| and pulls 10 ms of audio.
+  AudioFrame output;
+  bool muted;
+  auto insert_and_get_audio = [&](int audio_level) {
+    rtp_header.extension.audioLevel = audio_level;
+    ASSERT_EQ(NetEq::kOK, neteq_->InsertPacket(rtp_header, payload));
+    rtp_header.timestamp += rtc::checked_cast<uint32_t>(kPayloadLengthSamples);
+    ++rtp_header.sequenceNumber;
+    ASSERT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
+  };
+
+  for (int i = 0; i < 10; ++i) {
+    insert_and_get_audio(/*audio_level=*/10);
+    EXPECT_FALSE(muted);
+  }
+  const uint64_t concealed_samples =
+      neteq_->GetLifetimeStatistics().concealed_samples;
+
+  // Quiet packets keep being decoded for a while, then are only discarded.
+  for (int i = 0; i < 18; ++i) {
+    insert_and_get_audio(kSkipDecodingAudioLevel);
+    EXPECT_FALSE(muted);
+  }
+  for (int i = 0; i < 20; ++i) {
+    insert_and_get_audio(kSkipDecodingAudioLevel);
+    EXPECT_TRUE(muted);
+    EXPECT_LE(packet_buffer_->NumPacketsInBuffer(), 1u);
+  }
+
+  // Decoding resumes with the first loud packet, without concealment.
+  insert_and_get_audio(/*audio_level=*/10);
+  EXPECT_FALSE(muted);
+  EXPECT_EQ(0x1000, output.data()[kPayloadLengthSamples - 1]);
+  EXPECT_EQ(concealed_samples,
+            neteq_->GetLifetimeStatistics().concealed_samples);
+}
+
 TEST_F(NetEqImplTest, EnableRtxHandling) {
   UseNoMocks();
   use_mock_neteq_controller_ = true;
@@ -8,14 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-// This is the implementation of the PacketBuffer class. It is mostly based on
-// an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// This is the implementation of the PacketBuffer class. It is based on a ring
+// of packets, which is kept sorted at all times so that the next packet to
+// decode is at the beginning of the ring.
 
 #include "modules/audio_coding/neteq/packet_buffer.h"
 
 #include <algorithm>
-#include <list>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -30,17 +29,9 @@
 
 namespace webrtc {
 namespace {
-// Predicate used when inserting packets in the buffer list.
-// Operator() returns true when |packet| goes before |new_packet|.
-class NewTimestampIsLarger {
- public:
-  explicit NewTimestampIsLarger(const Packet& new_packet)
-      : new_packet_(new_packet) {}
-  bool operator()(const Packet& packet) { return (new_packet_ >= packet); }
-
- private:
-  const Packet& new_packet_;
-};
+
+// The number of slots allocated for the first packets.
+constexpr size_t kMinNumberOfSlots = 8;
 
 // Returns true if both payload types are known to the decoder database, and
 // have the same sample rate.
@@ -74,11 +65,15 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  buffer_.clear();
+  for (size_t i = 0; i < num_packets_; ++i) {
+    PacketAt(i) = Packet();
+  }
+  first_slot_ = 0;
+  num_packets_ = 0;
 }
 
 bool PacketBuffer::Empty() const {
-  return buffer_.empty();
+  return num_packets_ == 0;
 }
 
 int PacketBuffer::InsertPacket(Packet&& packet, StatisticsCalculator* stats) {
@@ -94,7 +89,7 @@ int PacketBuffer::InsertPacket(Packet&& packet, StatisticsCalculator* stats) {
 
   packet.waiting_time = tick_timer_->GetNewStopwatch();
 
-  if (buffer_.size() >= max_number_of_packets_) {
+  if (num_packets_ >= max_number_of_packets_) {
     // Buffer is full. Flush it.
     Flush();
     stats->FlushedPacketBuffer();
@@ -102,29 +97,47 @@ int PacketBuffer::InsertPacket(Packet&& packet, StatisticsCalculator* stats) {
     return_val = kFlushed;
   }
 
-  // Get an iterator pointing to the place in the buffer where the new packet
-  // should be inserted. The list is searched from the back, since the most
-  // likely case is that the new packet should be near the end of the list.
-  PacketList::reverse_iterator rit = std::find_if(
-      buffer_.rbegin(), buffer_.rend(), NewTimestampIsLarger(packet));
+  // Find the position of the first packet that goes after the new one. The
+  // most likely case is that the new packet goes at the end, otherwise the
+  // position is found by binary search.
+  size_t position = num_packets_;
+  if (num_packets_ > 0 && packet < PacketAt(num_packets_ - 1)) {
+    size_t begin = 0;
+    position = num_packets_ - 1;
+    while (begin < position) {
+      const size_t middle = begin + (position - begin) / 2;
+      if (packet < PacketAt(middle)) {
+        position = middle;
+      } else {
+        begin = middle + 1;
+      }
+    }
+  }
 
-  // The new packet is to be inserted to the right of |rit|. If it has the same
-  // timestamp as |rit|, which has a higher priority, do not insert the new
-  // packet to list.
-  if (rit != buffer_.rend() && packet.timestamp == rit->timestamp) {
+  // The new packet is to be inserted after the packet at |position| - 1. If it
+  // has the same timestamp as that one, which has a higher priority, do not
+  // insert the new packet.
+  if (position > 0 && packet.timestamp == PacketAt(position - 1).timestamp) {
     LogPacketDiscarded(packet.priority.codec_level, stats);
     return return_val;
   }
 
-  // The new packet is to be inserted to the left of |it|. If it has the same
-  // timestamp as |it|, which has a lower priority, replace |it| with the new
-  // packet.
-  PacketList::iterator it = rit.base();
-  if (it != buffer_.end() && packet.timestamp == it->timestamp) {
-    LogPacketDiscarded(it->priority.codec_level, stats);
-    it = buffer_.erase(it);
+  // The new packet is to be inserted before the packet at |position|. If it
+  // has the same timestamp as that one, which has a lower priority, replace it
+  // with the new packet.
+  if (position < num_packets_ &&
+      packet.timestamp == PacketAt(position).timestamp) {
+    LogPacketDiscarded(PacketAt(position).priority.codec_level, stats);
+    PacketAt(position) = std::move(packet);
+    return return_val;
   }
-  buffer_.insert(it, std::move(packet));  // Insert the packet at that position.
+
+  Grow();
+  for (size_t i = num_packets_; i > position; --i) {
+    PacketAt(i) = std::move(PacketAt(i - 1));
+  }
+  PacketAt(position) = std::move(packet);
+  ++num_packets_;
 
   return return_val;
 }
@@ -182,7 +195,7 @@ int PacketBuffer::NextTimestamp(uint32_t* next_timestamp) const {
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  *next_timestamp = buffer_.front().timestamp;
+  *next_timestamp = PacketAt(0).timestamp;
   return kOK;
 }
 
@@ -194,11 +207,11 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  PacketList::const_iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    if (it->timestamp >= timestamp) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
+    if (packet.timestamp >= timestamp) {
       // Found a packet matching the search.
-      *next_timestamp = it->timestamp;
+      *next_timestamp = packet.timestamp;
       return kOK;
     }
   }
@@ -206,7 +219,7 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
 }
 
 const Packet* PacketBuffer::PeekNextPacket() const {
-  return buffer_.empty() ? nullptr : &buffer_.front();
+  return Empty() ? nullptr : &PacketAt(0);
 }
 
 absl::optional<Packet> PacketBuffer::GetNextPacket() {
@@ -215,10 +228,11 @@ absl::optional<Packet> PacketBuffer::GetNextPacket() {
     return absl::nullopt;
   }
 
-  absl::optional<Packet> packet(std::move(buffer_.front()));
+  absl::optional<Packet> packet(std::move(PacketAt(0)));
   // Assert that the packet sanity checks in InsertPacket method works.
   RTC_DCHECK(!packet->empty());
-  buffer_.pop_front();
+  first_slot_ = (first_slot_ + 1) % slots_.size();
+  --num_packets_;
 
   return packet;
 }
@@ -228,17 +242,19 @@ int PacketBuffer::DiscardNextPacket(StatisticsCalculator* stats) {
     return kBufferEmpty;
   }
   // Assert that the packet sanity checks in InsertPacket method works.
-  const Packet& packet = buffer_.front();
+  Packet& packet = PacketAt(0);
   RTC_DCHECK(!packet.empty());
   LogPacketDiscarded(packet.priority.codec_level, stats);
-  buffer_.pop_front();
+  packet = Packet();
+  first_slot_ = (first_slot_ + 1) % slots_.size();
+  --num_packets_;
   return kOK;
 }
 
 void PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit,
                                      uint32_t horizon_samples,
                                      StatisticsCalculator* stats) {
-  buffer_.remove_if([timestamp_limit, horizon_samples, stats](const Packet& p) {
+  RemoveIf([timestamp_limit, horizon_samples, stats](const Packet& p) {
     if (timestamp_limit == p.timestamp ||
         !IsObsoleteTimestamp(p.timestamp, timestamp_limit, horizon_samples)) {
       return false;
@@ -255,7 +271,7 @@ void PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit,
 
 void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type,
                                                  StatisticsCalculator* stats) {
-  buffer_.remove_if([payload_type, stats](const Packet& p) {
+  RemoveIf([payload_type, stats](const Packet& p) {
     if (p.payload_type != payload_type) {
       return false;
     }
@@ -265,13 +281,14 @@ void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type,
 }
 
 size_t PacketBuffer::NumPacketsInBuffer() const {
-  return buffer_.size();
+  return num_packets_;
 }
 
 size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
   size_t num_samples = 0;
   size_t last_duration = last_decoded_length;
-  for (const Packet& packet : buffer_) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
     if (packet.frame) {
       // TODO(hlundin): Verify that it's fine to count all packets and remove
       // this check.
@@ -291,16 +308,17 @@ size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
 size_t PacketBuffer::GetSpanSamples(size_t last_decoded_length,
                                     size_t sample_rate,
                                     bool count_dtx_waiting_time) const {
-  if (buffer_.size() == 0) {
+  if (num_packets_ == 0) {
     return 0;
   }
 
-  size_t span = buffer_.back().timestamp - buffer_.front().timestamp;
-  if (buffer_.back().frame && buffer_.back().frame->Duration() > 0) {
-    size_t duration = buffer_.back().frame->Duration();
-    if (count_dtx_waiting_time && buffer_.back().frame->IsDtxPacket()) {
+  const Packet& last_packet = PacketAt(num_packets_ - 1);
+  size_t span = last_packet.timestamp - PacketAt(0).timestamp;
+  if (last_packet.frame && last_packet.frame->Duration() > 0) {
+    size_t duration = last_packet.frame->Duration();
+    if (count_dtx_waiting_time && last_packet.frame->IsDtxPacket()) {
       size_t waiting_time_samples = rtc::dchecked_cast<size_t>(
-          buffer_.back().waiting_time->ElapsedMs() * (sample_rate / 1000));
+          last_packet.waiting_time->ElapsedMs() * (sample_rate / 1000));
       duration = std::max(duration, waiting_time_samples);
     }
     span += duration;
@@ -313,7 +331,8 @@ size_t PacketBuffer::GetSpanSamples(size_t last_decoded_length,
 bool PacketBuffer::ContainsDtxOrCngPacket(
     const DecoderDatabase* decoder_database) const {
   RTC_DCHECK(decoder_database);
-  for (const Packet& packet : buffer_) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
     if ((packet.frame && packet.frame->IsDtxPacket()) ||
         decoder_database->IsComfortNoise(packet.payload_type)) {
       return true;
@@ -322,4 +341,53 @@ bool PacketBuffer::ContainsDtxOrCngPacket(
   return false;
 }
 
+Packet& PacketBuffer::PacketAt(size_t index) {
+  RTC_DCHECK_LT(index, slots_.size());
+  const size_t slot = first_slot_ + index;
+  return slots_[slot < slots_.size() ? slot : slot - slots_.size()];
+}
+
+const Packet& PacketBuffer::PacketAt(size_t index) const {
+  RTC_DCHECK_LT(index, slots_.size());
+  const size_t slot = first_slot_ + index;
+  return slots_[slot < slots_.size() ? slot : slot - slots_.size()];
+}
+
+void PacketBuffer::Grow() {
+  if (num_packets_ < slots_.size()) {
+    return;
+  }
+  // InsertPacket() flushes the buffer rather than going over the maximum
+  // number of packets, but always makes room for the new packet.
+  const size_t max_number_of_slots =
+      std::max<size_t>(max_number_of_packets_, 1);
+  RTC_DCHECK_LT(slots_.size(), max_number_of_slots);
+  std::vector<Packet> slots(std::min(
+      max_number_of_slots, std::max(kMinNumberOfSlots, 2 * slots_.size())));
+  for (size_t i = 0; i < num_packets_; ++i) {
+    slots[i] = std::move(PacketAt(i));
+  }
+  slots_ = std::move(slots);
+  first_slot_ = 0;
+}
+
+template <typename Predicate>
+void PacketBuffer::RemoveIf(Predicate predicate) {
+  size_t num_kept = 0;
+  for (size_t i = 0; i < num_packets_; ++i) {
+    Packet& packet = PacketAt(i);
+    if (predicate(packet)) {
+      continue;
+    }
+    if (num_kept != i) {
+      PacketAt(num_kept) = std::move(packet);
+    }
+    ++num_kept;
+  }
+  for (size_t i = num_kept; i < num_packets_; ++i) {
+    PacketAt(i) = Packet();
+  }
+  num_packets_ = num_kept;
+}
+
 }  // namespace webrtc
@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 #define MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 
+#include <vector>
+
 #include "absl/types/optional.h"
 #include "modules/audio_coding/neteq/decoder_database.h"
 #include "modules/audio_coding/neteq/packet.h"
@@ -146,8 +148,26 @@ class PacketBuffer {
   }
 
  private:
+  // Returns the |index|th oldest packet in the buffer.
+  Packet& PacketAt(size_t index);
+  const Packet& PacketAt(size_t index) const;
+
+  // Makes room for one more packet, if all slots are in use.
+  void Grow();
+
+  // Removes the packets for which |predicate| returns true, keeping the
+  // order of the others.
+  template <typename Predicate>
+  void RemoveIf(Predicate predicate);
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  // The packets, sorted by timestamp, are kept in a ring of |slots_| starting
+  // at |first_slot_|. Slots are reused rather than the packets being allocated
+  // one by one, and are only added, up to |max_number_of_packets_|, when all
+  // are in use.
+  std::vector<Packet> slots_;
+  size_t first_slot_ = 0;
+  size_t num_packets_ = 0;
   const TickTimer* tick_timer_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
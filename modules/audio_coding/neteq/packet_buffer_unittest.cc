@@ -456,6 +456,45 @@ TEST(PacketBuffer, Reordering) {
 // wide-band speech. The expected behavior of the packet buffer is to detect a
 // change in sample rate, even though no speech packet has been inserted before,
 // and flush out the CNG packet.
+// Inserts packets out of order while extracting them, so that the packets
+// wrap around the end of the buffer's storage, and checks that they come out
+// in order.
+TEST(PacketBuffer, ReorderingWhileExtracting) {
+  TickTimer tick_timer;
+  PacketBuffer buffer(100, &tick_timer);  // 100 packets.
+  const uint32_t start_ts = 4711;
+  const uint32_t ts_increment = 10;
+  PacketGenerator gen(17, start_ts, 0, ts_increment);
+  const int payload_len = 10;
+  StrictMock<MockStatisticsCalculator> mock_stats;
+
+  // Fill the buffer with a varying number of packets, every pair of packets
+  // inserted in reverse order.
+  uint32_t expected_ts = start_ts;
+  for (int i = 0; i < 500; ++i) {
+    Packet first = gen.NextPacket(payload_len, nullptr);
+    Packet second = gen.NextPacket(payload_len, nullptr);
+    EXPECT_EQ(PacketBuffer::kOK,
+              buffer.InsertPacket(std::move(second), &mock_stats));
+    EXPECT_EQ(PacketBuffer::kOK,
+              buffer.InsertPacket(std::move(first), &mock_stats));
+    const size_t target_size = 1 + i % 37;
+    while (buffer.NumPacketsInBuffer() > target_size) {
+      const absl::optional<Packet> packet = buffer.GetNextPacket();
+      ASSERT_TRUE(packet);
+      EXPECT_EQ(expected_ts, packet->timestamp);
+      expected_ts += ts_increment;
+    }
+  }
+  while (!buffer.Empty()) {
+    const absl::optional<Packet> packet = buffer.GetNextPacket();
+    ASSERT_TRUE(packet);
+    EXPECT_EQ(expected_ts, packet->timestamp);
+    expected_ts += ts_increment;
+  }
+  EXPECT_EQ(start_ts + 1000 * ts_increment, expected_ts);
+}
+
 TEST(PacketBuffer, CngFirstThenSpeechWithNewSampleRate) {
   TickTimer tick_timer;
   PacketBuffer buffer(10, &tick_timer);  // 10 packets.
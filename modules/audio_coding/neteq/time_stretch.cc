@@ -17,6 +17,7 @@
 #include "modules/audio_coding/neteq/background_noise.h"
 #include "modules/audio_coding/neteq/cross_correlation.h"
 #include "modules/audio_coding/neteq/dsp_helper.h"
+#include "modules/audio_coding/neteq/dsp_kernels.h"
 #include "rtc_base/numerics/safe_conversions.h"
 
 namespace webrtc {
@@ -90,13 +91,13 @@ TimeStretch::ReturnCodes TimeStretch::Process(const int16_t* input,
   // Calculate energies for |vec1| and |vec2|, assuming they both contain
   // |peak_index| samples.
   int32_t vec1_energy =
-      WebRtcSpl_DotProductWithScale(vec1, vec1, peak_index, scaling);
+      GetDspKernels().dot_product_with_scale(vec1, vec1, peak_index, scaling);
   int32_t vec2_energy =
-      WebRtcSpl_DotProductWithScale(vec2, vec2, peak_index, scaling);
+      GetDspKernels().dot_product_with_scale(vec2, vec2, peak_index, scaling);
 
   // Calculate cross-correlation between |vec1| and |vec2|.
   int32_t cross_corr =
-      WebRtcSpl_DotProductWithScale(vec1, vec2, peak_index, scaling);
+      GetDspKernels().dot_product_with_scale(vec1, vec2, peak_index, scaling);
 
   // Check if the signal seems to be active speech or not (simple VAD).
   bool active_speech =
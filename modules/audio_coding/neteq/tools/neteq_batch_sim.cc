@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "modules/audio_coding/neteq/tools/neteq_batch_simulator.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
+#include "rtc_base/string_encode.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "system_wrappers/include/field_trial.h"
+
+ABSL_FLAG(std::string,
+          input_list,
+          "",
+          "File listing the input RTP dumps, pcap files or RTC event logs, one "
+          "per line. Empty lines and lines starting with # are ignored");
+ABSL_FLAG(std::string,
+          configs,
+          "default",
+          "Semicolon separated NetEq configurations to compare, each written "
+          "as name or name=options. The options are a comma separated list "
+          "of fast_accelerate, max_packets:<n>, low_latency, "
+          "late_packet_rate:<fraction> and max_delay_ms:<ms>");
+ABSL_FLAG(int,
+          num_threads,
+          0,
+          "Number of simulations to run in parallel; 0 means one per core");
+ABSL_FLAG(std::string,
+          force_fieldtrials,
+          "",
+          "Field trials used by all simulations. E.g. running with "
+          "--force_fieldtrials=WebRTC-FooFeature/Enable/ will assign the "
+          "group Enable to field trial WebRTC-FooFeature.");
+
+namespace {
+
+using webrtc::test::NetEqBatchSimulator;
+
+NetEqBatchSimulator::NamedConfig ParseConfig(const std::string& spec) {
+  NetEqBatchSimulator::NamedConfig config;
+  const size_t separator = spec.find('=');
+  config.name = spec.substr(0, separator);
+  config.config.quiet = true;
+  if (separator == std::string::npos) {
+    return config;
+  }
+
+  webrtc::FieldTrialFlag fast_accelerate("fast_accelerate");
+  webrtc::FieldTrialParameter<int> max_packets(
+      "max_packets", config.config.max_nr_packets_in_buffer);
+  webrtc::FieldTrialFlag low_latency("low_latency");
+  webrtc::NetEq::Config::LowLatencyDelay low_latency_delay;
+  webrtc::FieldTrialParameter<double> late_packet_rate(
+      "late_packet_rate", low_latency_delay.late_packet_rate);
+  webrtc::FieldTrialParameter<int> max_delay_ms(
+      "max_delay_ms", low_latency_delay.max_delay_ms);
+  webrtc::ParseFieldTrial({&fast_accelerate, &max_packets, &low_latency,
+                           &late_packet_rate, &max_delay_ms},
+                          spec.substr(separator + 1));
+
+  config.config.enable_fast_accelerate = fast_accelerate;
+  config.config.max_nr_packets_in_buffer = max_packets;
+  if (low_latency) {
+    low_latency_delay.late_packet_rate = late_packet_rate;
+    low_latency_delay.max_delay_ms = max_delay_ms;
+    config.config.low_latency_delay = low_latency_delay;
+  }
+  return config;
+}
+
+std::vector<std::string> ReadInputList(const std::string& filename) {
+  std::vector<std::string> input_files;
+  std::ifstream list(filename);
+  RTC_CHECK(list.is_open()) << "Cannot open " << filename;
+  std::string line;
+  while (std::getline(list, line)) {
+    if (!line.empty() && line[0] != '#') {
+      input_files.push_back(line);
+    }
+  }
+  return input_files;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<char*> args = absl::ParseCommandLine(argc, argv);
+  const std::string usage =
+      "Tool for comparing NetEq configurations on many inputs at once.\n"
+      "Example usage:\n"
+      "./neteq_batch_sim --configs=\"default;ll=low_latency\" "
+      "[--input_list=inputs.txt] [input.rtp ...]\n";
+
+  std::vector<std::string> input_files;
+  if (!absl::GetFlag(FLAGS_input_list).empty()) {
+    input_files = ReadInputList(absl::GetFlag(FLAGS_input_list));
+  }
+  for (size_t i = 1; i < args.size(); ++i) {
+    input_files.push_back(args[i]);
+  }
+  if (input_files.empty()) {
+    std::cout << usage;
+    exit(0);
+  }
+
+  std::vector<std::string> config_specs;
+  rtc::split(absl::GetFlag(FLAGS_configs), ';', &config_specs);
+  std::vector<NetEqBatchSimulator::NamedConfig> configs;
+  for (const std::string& spec : config_specs) {
+    if (!spec.empty()) {
+      configs.push_back(ParseConfig(spec));
+    }
+  }
+  RTC_CHECK(!configs.empty()) << "No configurations given";
+
+  // Make force_fieldtrials persistent string during entire program live as
+  // absl::GetFlag creates temporary string and c_str() will point to
+  // deallocated string.
+  const std::string force_fieldtrials = absl::GetFlag(FLAGS_force_fieldtrials);
+  webrtc::field_trial::InitFieldTrialsFromString(force_fieldtrials.c_str());
+
+  int num_threads = absl::GetFlag(FLAGS_num_threads);
+  if (num_threads <= 0) {
+    num_threads = webrtc::CpuInfo::DetectNumberOfCores();
+  }
+
+  NetEqBatchSimulator simulator(std::move(configs), std::move(input_files),
+                                num_threads);
+  const std::vector<NetEqBatchSimulator::Stats> all_stats = simulator.Run();
+
+  for (const NetEqBatchSimulator::Stats& stats : all_stats) {
+    printf("%s:\n", stats.config_name.c_str());
+    printf("  simulations: %d (%d failed)\n", stats.num_simulations,
+           stats.num_failed_simulations);
+    printf("  output duration: %" PRId64 " ms\n", stats.output_duration_ms);
+    printf("  mean_jitter_buffer_delay_ms: %f ms\n",
+           stats.MeanJitterBufferDelayMs());
+    printf("  expand_rate: %f %%\n", 100.0 * stats.ExpandRate());
+    printf("  preemptive_rate: %f %%\n", 100.0 * stats.PreemptiveRate());
+    printf("  accelerate_rate: %f %%\n", 100.0 * stats.AccelerateRate());
+    printf("  cpu_time: %" PRId64 " ms\n", stats.cpu_time_ns / 1000000);
+    printf("  cpu_usage: %f %%\n", 100.0 * stats.CpuUsage());
+  }
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/tools/neteq_batch_simulator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+double Ratio(uint64_t numerator, uint64_t denominator) {
+  return denominator > 0 ? static_cast<double>(numerator) / denominator : 0.0;
+}
+
+}  // namespace
+
+double NetEqBatchSimulator::Stats::MeanJitterBufferDelayMs() const {
+  return Ratio(jitter_buffer_delay_ms, jitter_buffer_emitted_count);
+}
+
+double NetEqBatchSimulator::Stats::ExpandRate() const {
+  return Ratio(concealed_samples, total_samples_received);
+}
+
+double NetEqBatchSimulator::Stats::PreemptiveRate() const {
+  return Ratio(inserted_samples_for_deceleration, total_samples_received);
+}
+
+double NetEqBatchSimulator::Stats::AccelerateRate() const {
+  return Ratio(removed_samples_for_acceleration, total_samples_received);
+}
+
+double NetEqBatchSimulator::Stats::CpuUsage() const {
+  return output_duration_ms > 0
+             ? cpu_time_ns / (1e6 * static_cast<double>(output_duration_ms))
+             : 0.0;
+}
+
+NetEqBatchSimulator::NetEqBatchSimulator(std::vector<NamedConfig> configs,
+                                         std::vector<std::string> input_files,
+                                         int num_threads)
+    : configs_(std::move(configs)),
+      input_files_(std::move(input_files)),
+      num_threads_(std::max(num_threads, 1)) {
+  for (const NamedConfig& config : configs_) {
+    RTC_CHECK(config.config.field_trial_string.empty())
+        << "Field trials cannot be set per configuration: " << config.name;
+  }
+}
+
+NetEqBatchSimulator::~NetEqBatchSimulator() = default;
+
+std::vector<NetEqBatchSimulator::Stats> NetEqBatchSimulator::Run() {
+  {
+    rtc::CritScope lock(&crit_);
+    next_job_ = 0;
+    stats_.clear();
+    stats_.resize(configs_.size());
+    for (size_t i = 0; i < configs_.size(); ++i) {
+      stats_[i].config_name = configs_[i].name;
+    }
+  }
+
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads_; ++i) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        &NetEqBatchSimulator::WorkerThread, this, "NetEqBatchSimulator"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+void NetEqBatchSimulator::WorkerThread(void* obj) {
+  static_cast<NetEqBatchSimulator*>(obj)->ProcessJobs();
+}
+
+void NetEqBatchSimulator::ProcessJobs() {
+  const size_t num_jobs = configs_.size() * input_files_.size();
+  while (true) {
+    size_t job;
+    {
+      rtc::CritScope lock(&crit_);
+      if (next_job_ >= num_jobs) {
+        return;
+      }
+      job = next_job_++;
+    }
+    // All configurations of one file run next to each other, so that the
+    // file is likely still cached.
+    RunJob(job % configs_.size(), input_files_[job / configs_.size()]);
+  }
+}
+
+void NetEqBatchSimulator::RunJob(size_t config_index,
+                                 const std::string& input_file) {
+  NetEqTestFactory factory;
+  std::unique_ptr<NetEqTest> test = factory.InitializeTestFromFile(
+      input_file, nullptr, configs_[config_index].config);
+  if (!test) {
+    std::cerr << "Failed to simulate " << input_file << " with configuration "
+              << configs_[config_index].name << std::endl;
+    rtc::CritScope lock(&crit_);
+    ++stats_[config_index].num_failed_simulations;
+    return;
+  }
+
+  const int64_t start_cpu_time_ns = rtc::GetThreadCpuTimeNanos();
+  const int64_t output_duration_ms = test->Run();
+  const int64_t cpu_time_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_time_ns;
+  const NetEqLifetimeStatistics lifetime_stats = test->LifetimeStats();
+
+  rtc::CritScope lock(&crit_);
+  Stats& stats = stats_[config_index];
+  ++stats.num_simulations;
+  stats.output_duration_ms += output_duration_ms;
+  stats.cpu_time_ns += cpu_time_ns;
+  stats.total_samples_received += lifetime_stats.total_samples_received;
+  stats.concealed_samples += lifetime_stats.concealed_samples;
+  stats.jitter_buffer_delay_ms += lifetime_stats.jitter_buffer_delay_ms;
+  stats.jitter_buffer_emitted_count +=
+      lifetime_stats.jitter_buffer_emitted_count;
+  stats.inserted_samples_for_deceleration +=
+      lifetime_stats.inserted_samples_for_deceleration;
+  stats.removed_samples_for_acceleration +=
+      lifetime_stats.removed_samples_for_acceleration;
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_BATCH_SIMULATOR_H_
+#define MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_BATCH_SIMULATOR_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/audio_coding/neteq/tools/neteq_test_factory.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace test {
+
+// Replays every input file (RTP dump, pcap or RTC event log) through every
+// NetEq configuration, running the simulations in parallel on a number of
+// threads, and aggregates the NetEq lifetime statistics and the CPU time spent
+// per configuration. Field trials are process wide, so they cannot differ
+// between the configurations, and the field_trial_string of each
+// configuration must be empty.
+class NetEqBatchSimulator {
+ public:
+  struct NamedConfig {
+    std::string name;
+    NetEqTestFactory::Config config;
+  };
+
+  // Sums over all successful simulations of one configuration.
+  struct Stats {
+    std::string config_name;
+    int num_simulations = 0;
+    int num_failed_simulations = 0;
+    int64_t output_duration_ms = 0;
+    int64_t cpu_time_ns = 0;
+    uint64_t total_samples_received = 0;
+    uint64_t concealed_samples = 0;
+    uint64_t jitter_buffer_delay_ms = 0;
+    uint64_t jitter_buffer_emitted_count = 0;
+    uint64_t inserted_samples_for_deceleration = 0;
+    uint64_t removed_samples_for_acceleration = 0;
+
+    // Mean delay of the samples played out, in ms.
+    double MeanJitterBufferDelayMs() const;
+    // Fractions of the samples received that were concealed, inserted by
+    // deceleration and removed by acceleration, respectively.
+    double ExpandRate() const;
+    double PreemptiveRate() const;
+    double AccelerateRate() const;
+    // CPU time spent per second of audio played out, as a fraction.
+    double CpuUsage() const;
+  };
+
+  NetEqBatchSimulator(std::vector<NamedConfig> configs,
+                      std::vector<std::string> input_files,
+                      int num_threads);
+  ~NetEqBatchSimulator();
+
+  // Runs all simulations, and returns the statistics in the order of the
+  // configurations.
+  std::vector<Stats> Run();
+
+ private:
+  static void WorkerThread(void* obj);
+  void ProcessJobs();
+  void RunJob(size_t config_index, const std::string& input_file);
+
+  const std::vector<NamedConfig> configs_;
+  const std::vector<std::string> input_files_;
+  const int num_threads_;
+
+  rtc::CriticalSection crit_;
+  size_t next_job_ RTC_GUARDED_BY(crit_) = 0;
+  std::vector<Stats> stats_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_BATCH_SIMULATOR_H_
@@ -153,6 +153,19 @@ ABSL_FLAG(bool,
           enable_fast_accelerate,
           false,
           "Enables jitter buffer fast accelerate");
+ABSL_FLAG(bool,
+          low_latency_delay,
+          false,
+          "Uses the low-latency jitter buffer delay policy");
+ABSL_FLAG(double,
+          low_latency_late_packet_rate,
+          0.05,
+          "Fraction of packets allowed to arrive too late for playout with "
+          "the low-latency delay policy");
+ABSL_FLAG(int,
+          low_latency_max_delay_ms,
+          0,
+          "Upper limit of the low-latency target delay; 0 means no limit");
 
 namespace {
 
@@ -377,6 +390,14 @@ int main(int argc, char* argv[]) {
   config.max_nr_packets_in_buffer =
       absl::GetFlag(FLAGS_max_nr_packets_in_buffer);
   config.enable_fast_accelerate = absl::GetFlag(FLAGS_enable_fast_accelerate);
+  if (absl::GetFlag(FLAGS_low_latency_delay)) {
+    webrtc::NetEq::Config::LowLatencyDelay low_latency_delay;
+    low_latency_delay.late_packet_rate =
+        absl::GetFlag(FLAGS_low_latency_late_packet_rate);
+    low_latency_delay.max_delay_ms =
+        absl::GetFlag(FLAGS_low_latency_max_delay_ms);
+    config.low_latency_delay = low_latency_delay;
+  }
   if (!output_audio_filename.empty()) {
     config.output_audio_filename = output_audio_filename;
   }
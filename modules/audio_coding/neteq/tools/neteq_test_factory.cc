@@ -143,7 +143,9 @@ std::unique_ptr<NetEqTest> NetEqTestFactory::InitializeTestFromFile(
                                                    config.ssrc_filter));
   }
 
-  std::cout << "Input file: " << input_file_name << std::endl;
+  if (!config.quiet) {
+    std::cout << "Input file: " << input_file_name << std::endl;
+  }
   if (!input) {
     std::cerr << "Error: Cannot open input file" << std::endl;
     return nullptr;
@@ -167,8 +169,10 @@ std::unique_ptr<NetEqTest> NetEqTestFactory::InitializeTest(
 
   // Skip some initial events/packets if requested.
   if (config.skip_get_audio_events > 0) {
-    std::cout << "Skipping " << config.skip_get_audio_events
-              << " get_audio events" << std::endl;
+    if (!config.quiet) {
+      std::cout << "Skipping " << config.skip_get_audio_events
+                << " get_audio events" << std::endl;
+    }
     if (!input->NextPacketTime() || !input->NextOutputEventTime()) {
       std::cerr << "No events found" << std::endl;
       return nullptr;
@@ -196,13 +200,17 @@ std::unique_ptr<NetEqTest> NetEqTestFactory::InitializeTest(
     RTC_DCHECK(first_rtp_header);
     sample_rate_hz = CodecSampleRate(first_rtp_header->payloadType, config);
     if (sample_rate_hz) {
-      std::cout << "Found valid packet with payload type "
-                << static_cast<int>(first_rtp_header->payloadType)
-                << " and SSRC 0x" << std::hex << first_rtp_header->ssrc
-                << std::dec << std::endl;
+      if (!config.quiet) {
+        std::cout << "Found valid packet with payload type "
+                  << static_cast<int>(first_rtp_header->payloadType)
+                  << " and SSRC 0x" << std::hex << first_rtp_header->ssrc
+                  << std::dec << std::endl;
+      }
       if (config.initial_dummy_packets > 0) {
-        std::cout << "Nr of initial dummy packets: "
-                  << config.initial_dummy_packets << std::endl;
+        if (!config.quiet) {
+          std::cout << "Nr of initial dummy packets: "
+                    << config.initial_dummy_packets << std::endl;
+        }
         input = std::make_unique<InitialPacketInserterNetEqInput>(
             std::move(input), config.initial_dummy_packets, *sample_rate_hz);
       }
@@ -214,7 +222,7 @@ std::unique_ptr<NetEqTest> NetEqTestFactory::InitializeTest(
                                   first_rtp_header->ssrc);
     input->PopPacket();
   }
-  if (!discarded_pt_and_ssrc.empty()) {
+  if (!discarded_pt_and_ssrc.empty() && !config.quiet) {
     std::cout << "Discarded initial packets with the following payload types "
                  "and SSRCs:"
               << std::endl;
@@ -233,7 +241,9 @@ std::unique_ptr<NetEqTest> NetEqTestFactory::InitializeTest(
   std::unique_ptr<AudioSink> output;
   if (!config.output_audio_filename.has_value()) {
     output = std::make_unique<VoidAudioSink>();
-    std::cout << "No output audio file" << std::endl;
+    if (!config.quiet) {
+      std::cout << "No output audio file" << std::endl;
+    }
   } else if (config.output_audio_filename->size() >= 4 &&
              config.output_audio_filename->substr(
                  config.output_audio_filename->size() - 4) == ".wav") {
@@ -328,11 +338,14 @@ std::unique_ptr<NetEqTest> NetEqTestFactory::InitializeTest(
       new SsrcSwitchDetector(stats_plotter_->stats_getter()->delay_analyzer()));
   callbacks.post_insert_packet = ssrc_switch_detector_.get();
   callbacks.get_audio_callback = stats_plotter_->stats_getter();
-  callbacks.simulation_ended_callback = stats_plotter_.get();
+  if (!config.quiet) {
+    callbacks.simulation_ended_callback = stats_plotter_.get();
+  }
   NetEq::Config neteq_config;
   neteq_config.sample_rate_hz = *sample_rate_hz;
   neteq_config.max_packets_in_buffer = config.max_nr_packets_in_buffer;
   neteq_config.enable_fast_accelerate = config.enable_fast_accelerate;
+  neteq_config.low_latency_delay = config.low_latency_delay;
   return std::make_unique<NetEqTest>(
       neteq_config, decoder_factory, codecs, std::move(text_log), factory,
       std::move(input), std::move(output), callbacks);
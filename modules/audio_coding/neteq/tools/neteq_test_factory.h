@@ -132,6 +132,8 @@ class NetEqTestFactory {
     int skip_get_audio_events = default_skip_get_audio_events();
     // Enables jitter buffer fast accelerate.
     bool enable_fast_accelerate = false;
+    // Uses the low-latency jitter buffer delay policy with these settings.
+    absl::optional<NetEq::Config::LowLatencyDelay> low_latency_delay;
     // Dumps events that describes the simulation on a step-by-step basis.
     bool textlog = false;
     // If specified and |textlog| is true, the output of |textlog| is written to
@@ -143,6 +145,9 @@ class NetEqTestFactory {
     absl::optional<std::string> output_audio_filename;
     // Field trials to use during the simulation.
     std::string field_trial_string;
+    // Suppresses the progress printouts and the statistics summary, for batch
+    // runs. Errors are still printed.
+    bool quiet = false;
   };
 
   std::unique_ptr<NetEqTest> InitializeTestFromFile(
@@ -0,0 +1,253 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "modules/audio_device/include/headless_audio_device.h"
+
+#if defined(WEBRTC_LINUX)
+#include <errno.h>
+#include <time.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "modules/audio_device/include/audio_device_default.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int64_t kFrameLengthUs = 10000;
+// A tick starting later than this is counted as late.
+constexpr int64_t kLateThresholdUs = 1000;
+// When the thread is this far behind, e.g. after the process was suspended,
+// the missed ticks are dropped instead of being run back to back.
+constexpr int64_t kMaxCatchUpUs = 10 * kFrameLengthUs;
+
+class HeadlessAudioDeviceModuleImpl
+    : public webrtc_impl::AudioDeviceModuleDefault<HeadlessAudioDeviceModule> {
+ public:
+  HeadlessAudioDeviceModuleImpl(const Config& config, PlayoutSink* sink)
+      : config_(config),
+        sink_(sink),
+        samples_per_channel_(rtc::CheckedDivExact(config.sample_rate_hz, 100)),
+        playout_buffer_(samples_per_channel_ * config.playout_channels, 0),
+        recording_buffer_(samples_per_channel_ * config.recording_channels,
+                          0) {
+    RTC_CHECK_GT(config.playout_channels, 0);
+    RTC_CHECK_GT(config.recording_channels, 0);
+  }
+
+  ~HeadlessAudioDeviceModuleImpl() override { Terminate(); }
+
+  int32_t Init() override {
+    if (thread_)
+      return 0;
+    stop_ = false;
+    thread_ = std::make_unique<rtc::PlatformThread>(
+        &HeadlessAudioDeviceModuleImpl::ThreadFunc, this,
+        "HeadlessAudioDevice", rtc::kRealtimePriority);
+    thread_->Start();
+    return 0;
+  }
+
+  int32_t Terminate() override {
+    if (!thread_)
+      return 0;
+    stop_ = true;
+    wake_up_.Set();
+    thread_->Stop();
+    thread_.reset();
+    return 0;
+  }
+
+  bool Initialized() const override { return thread_ != nullptr; }
+
+  int32_t RegisterAudioCallback(AudioTransport* callback) override {
+    rtc::CritScope cs(&lock_);
+    RTC_DCHECK(callback || audio_callback_);
+    audio_callback_ = callback;
+    return 0;
+  }
+
+  int32_t StartPlayout() override {
+    rtc::CritScope cs(&lock_);
+    playing_ = true;
+    return 0;
+  }
+
+  int32_t StopPlayout() override {
+    rtc::CritScope cs(&lock_);
+    playing_ = false;
+    return 0;
+  }
+
+  int32_t StartRecording() override {
+    rtc::CritScope cs(&lock_);
+    recording_ = true;
+    return 0;
+  }
+
+  int32_t StopRecording() override {
+    rtc::CritScope cs(&lock_);
+    recording_ = false;
+    return 0;
+  }
+
+  bool Playing() const override {
+    rtc::CritScope cs(&lock_);
+    return playing_;
+  }
+
+  bool Recording() const override {
+    rtc::CritScope cs(&lock_);
+    return recording_;
+  }
+
+  int32_t StereoPlayoutIsAvailable(bool* available) const override {
+    *available = config_.playout_channels == 2;
+    return 0;
+  }
+
+  int32_t StereoPlayout(bool* enabled) const override {
+    *enabled = config_.playout_channels == 2;
+    return 0;
+  }
+
+  int32_t StereoRecordingIsAvailable(bool* available) const override {
+    *available = config_.recording_channels == 2;
+    return 0;
+  }
+
+  int32_t StereoRecording(bool* enabled) const override {
+    *enabled = config_.recording_channels == 2;
+    return 0;
+  }
+
+  Stats GetStats() const override {
+    rtc::CritScope cs(&lock_);
+    return stats_;
+  }
+
+ private:
+  static void ThreadFunc(void* obj) {
+    static_cast<HeadlessAudioDeviceModuleImpl*>(obj)->Run();
+  }
+
+  void Run() {
+    int64_t deadline_us = rtc::TimeMicros() + kFrameLengthUs;
+    while (!stop_) {
+      WaitUntil(deadline_us);
+      if (stop_)
+        break;
+      const int64_t lateness_us = rtc::TimeMicros() - deadline_us;
+      int64_t skipped_ticks = 0;
+      if (lateness_us > kMaxCatchUpUs) {
+        skipped_ticks = lateness_us / kFrameLengthUs;
+        deadline_us += skipped_ticks * kFrameLengthUs;
+      }
+      ProcessAudio(std::max<int64_t>(lateness_us, 0), skipped_ticks);
+      deadline_us += kFrameLengthUs;
+    }
+  }
+
+  // Sleeps until |deadline_us| in the rtc::TimeMicros() time base, or until
+  // Terminate() is called.
+  void WaitUntil(int64_t deadline_us) {
+    const int64_t wait_us = deadline_us - rtc::TimeMicros();
+    if (wait_us <= 0)
+      return;
+#if defined(WEBRTC_LINUX)
+    // Sleep against an absolute CLOCK_MONOTONIC deadline with sub-millisecond
+    // precision. Terminate() is noticed after at most one frame.
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    const int64_t deadline_ns =
+        deadline.tv_nsec + wait_us * rtc::kNumNanosecsPerMicrosec;
+    deadline.tv_sec += deadline_ns / rtc::kNumNanosecsPerSec;
+    deadline.tv_nsec = deadline_ns % rtc::kNumNanosecsPerSec;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline,
+                           nullptr) == EINTR) {
+    }
+#else
+    wake_up_.Wait(static_cast<int>(wait_us / rtc::kNumMicrosecsPerMillisec));
+#endif
+  }
+
+  void ProcessAudio(int64_t lateness_us, int64_t skipped_ticks) {
+    rtc::CritScope cs(&lock_);
+    ++stats_.ticks;
+    if (lateness_us > kLateThresholdUs)
+      ++stats_.late_ticks;
+    stats_.max_lateness_us = std::max(stats_.max_lateness_us, lateness_us);
+    stats_.skipped_ticks += skipped_ticks;
+
+    if (!audio_callback_)
+      return;
+    if (recording_) {
+      uint32_t new_mic_level = 0;
+      audio_callback_->RecordedDataIsAvailable(
+          recording_buffer_.data(), samples_per_channel_,
+          sizeof(int16_t) * config_.recording_channels,
+          config_.recording_channels, config_.sample_rate_hz, 0, 0, 0, false,
+          new_mic_level);
+    }
+    if (playing_) {
+      size_t samples_out = 0;
+      int64_t elapsed_time_ms = -1;
+      int64_t ntp_time_ms = -1;
+      audio_callback_->NeedMorePlayData(
+          samples_per_channel_, sizeof(int16_t) * config_.playout_channels,
+          config_.playout_channels, config_.sample_rate_hz,
+          playout_buffer_.data(), samples_out, &elapsed_time_ms, &ntp_time_ms);
+      if (sink_) {
+        sink_->OnPlayoutData(
+            rtc::ArrayView<const int16_t>(
+                playout_buffer_.data(),
+                std::min(samples_out, playout_buffer_.size())),
+            config_.sample_rate_hz, config_.playout_channels);
+      }
+    }
+  }
+
+  const Config config_;
+  PlayoutSink* const sink_;
+  const size_t samples_per_channel_;
+
+  std::unique_ptr<rtc::PlatformThread> thread_;
+  std::atomic<bool> stop_{false};
+  rtc::Event wake_up_;
+
+  rtc::CriticalSection lock_;
+  AudioTransport* audio_callback_ RTC_GUARDED_BY(lock_) = nullptr;
+  bool playing_ RTC_GUARDED_BY(lock_) = false;
+  bool recording_ RTC_GUARDED_BY(lock_) = false;
+  Stats stats_ RTC_GUARDED_BY(lock_);
+  std::vector<int16_t> playout_buffer_ RTC_GUARDED_BY(lock_);
+  const std::vector<int16_t> recording_buffer_;
+};
+
+}  // namespace
+
+rtc::scoped_refptr<HeadlessAudioDeviceModule>
+HeadlessAudioDeviceModule::Create(const Config& config, PlayoutSink* sink) {
+  return new rtc::RefCountedObject<HeadlessAudioDeviceModuleImpl>(config,
+                                                                  sink);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef MODULES_AUDIO_DEVICE_INCLUDE_HEADLESS_AUDIO_DEVICE_H_
+#define MODULES_AUDIO_DEVICE_INCLUDE_HEADLESS_AUDIO_DEVICE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api/array_view.h"
+#include "api/scoped_refptr.h"
+#include "modules/audio_device/include/audio_device.h"
+
+namespace webrtc {
+
+// HeadlessAudioDeviceModule is an AudioDeviceModule for machines without a
+// sound card, e.g. servers that mix or record the received audio. A dedicated
+// real-time priority thread pulls 10 ms of playout audio from the
+// AudioTransport on every tick, which mixes all AudioReceiveStreams in one
+// call, and hands it to a PlayoutSink. Ticks are scheduled against absolute
+// deadlines, so a late tick does not shift the ones after it.
+class HeadlessAudioDeviceModule : public AudioDeviceModule {
+ public:
+  // Receives the mixed playout audio. Called on the device thread, so it must
+  // not block.
+  class PlayoutSink {
+   public:
+    virtual ~PlayoutSink() {}
+    // |data| holds 10 ms of interleaved audio at the configured sample rate
+    // and number of channels.
+    virtual void OnPlayoutData(rtc::ArrayView<const int16_t> data,
+                               int sample_rate_hz,
+                               size_t num_channels) = 0;
+  };
+
+  struct Config {
+    int sample_rate_hz = 48000;
+    size_t playout_channels = 1;
+    size_t recording_channels = 1;
+  };
+
+  struct Stats {
+    // Number of 10 ms ticks run since the thread started.
+    int64_t ticks = 0;
+    // Number of ticks that started more than 1 ms after their deadline.
+    int64_t late_ticks = 0;
+    // Largest delay of a tick start relative to its deadline.
+    int64_t max_lateness_us = 0;
+    // Number of ticks dropped because the thread fell too far behind.
+    int64_t skipped_ticks = 0;
+  };
+
+  ~HeadlessAudioDeviceModule() override {}
+
+  // |sink| may be null, in which case the playout audio is discarded. It must
+  // outlive the module. When recording, silence is delivered to the
+  // AudioTransport so that the send side is paced like with a real device.
+  static rtc::scoped_refptr<HeadlessAudioDeviceModule> Create(
+      const Config& config,
+      PlayoutSink* sink);
+
+  virtual Stats GetStats() const = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_DEVICE_INCLUDE_HEADLESS_AUDIO_DEVICE_H_
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_device/include/headless_audio_device.h"
+
+#include <algorithm>
+
+#include "modules/audio_device/include/mock_audio_transport.h"
+#include "rtc_base/event.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::AtLeast;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgReferee;
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+constexpr int kNumFrames = 10;
+
+class CountingSink : public HeadlessAudioDeviceModule::PlayoutSink {
+ public:
+  void OnPlayoutData(rtc::ArrayView<const int16_t> data,
+                     int sample_rate_hz,
+                     size_t num_channels) override {
+    EXPECT_EQ(sample_rate_hz, kSampleRateHz);
+    EXPECT_EQ(data.size(), kSamplesPerChannel * num_channels);
+    EXPECT_TRUE(std::all_of(data.begin(), data.end(),
+                            [](int16_t sample) { return sample == 0; }));
+    if (++frames_ == kNumFrames)
+      done_.Set();
+  }
+
+  bool WaitForFrames() { return done_.Wait(5000); }
+
+ private:
+  int frames_ = 0;
+  rtc::Event done_;
+};
+
+TEST(HeadlessAudioDeviceModuleTest, PullsPlayoutDataEveryTick) {
+  CountingSink sink;
+  HeadlessAudioDeviceModule::Config config;
+  config.sample_rate_hz = kSampleRateHz;
+  config.playout_channels = 2;
+  rtc::scoped_refptr<HeadlessAudioDeviceModule> adm =
+      HeadlessAudioDeviceModule::Create(config, &sink);
+
+  test::MockAudioTransport transport;
+  EXPECT_CALL(transport, NeedMorePlayData(kSamplesPerChannel, 4, 2,
+                                          kSampleRateHz, _, _, _, _))
+      .Times(AtLeast(kNumFrames))
+      .WillRepeatedly(
+          DoAll(SetArgReferee<5>(2 * kSamplesPerChannel), Return(0)));
+  EXPECT_CALL(transport, RecordedDataIsAvailable).Times(0);
+
+  EXPECT_EQ(0, adm->RegisterAudioCallback(&transport));
+  EXPECT_EQ(0, adm->Init());
+  EXPECT_EQ(0, adm->StartPlayout());
+  EXPECT_TRUE(sink.WaitForFrames());
+  EXPECT_EQ(0, adm->StopPlayout());
+  EXPECT_EQ(0, adm->Terminate());
+
+  EXPECT_GE(adm->GetStats().ticks, kNumFrames);
+}
+
+TEST(HeadlessAudioDeviceModuleTest, DeliversSilenceWhenRecording) {
+  HeadlessAudioDeviceModule::Config config;
+  config.sample_rate_hz = kSampleRateHz;
+  rtc::scoped_refptr<HeadlessAudioDeviceModule> adm =
+      HeadlessAudioDeviceModule::Create(config, nullptr);
+
+  rtc::Event recorded;
+  test::MockAudioTransport transport;
+  EXPECT_CALL(transport, RecordedDataIsAvailable(_, kSamplesPerChannel, 2, 1,
+                                                 kSampleRateHz, _, _, _, _, _))
+      .WillRepeatedly([&recorded](const void*, const size_t, const size_t,
+                                  const size_t, const uint32_t, const uint32_t,
+                                  const int32_t, const uint32_t, const bool,
+                                  uint32_t&) {
+        recorded.Set();
+        return 0;
+      });
+  EXPECT_CALL(transport, NeedMorePlayData).Times(0);
+
+  EXPECT_EQ(0, adm->RegisterAudioCallback(&transport));
+  EXPECT_EQ(0, adm->Init());
+  EXPECT_EQ(0, adm->StartRecording());
+  EXPECT_TRUE(recorded.Wait(5000));
+  EXPECT_EQ(0, adm->StopRecording());
+  EXPECT_EQ(0, adm->Terminate());
+}
+
+}  // namespace
+}  // namespace webrtc
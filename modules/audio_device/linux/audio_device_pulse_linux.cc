@@ -12,9 +12,13 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "modules/audio_device/linux/latebindingsymboltable_linux.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
 
 WebRTCPulseSymbolTable* GetPulseSymbolTable() {
   static WebRTCPulseSymbolTable* pulse_symbol_table =
@@ -69,6 +73,10 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse()
       _tempSampleDataSize(0),
       _configuredLatencyPlay(0),
       _configuredLatencyRec(0),
+      _adaptivePlayLatency(
+          webrtc::field_trial::IsEnabled("WebRTC-Audio-PulseAdaptiveLatency")),
+      _minStablePlayLatency(0),
+      _lastPlayLatencyChangeMs(0),
       _paDeviceIndex(-1),
       _paStateChanged(false),
       _paMainloop(NULL),
@@ -917,8 +925,10 @@ int32_t AudioDeviceLinuxPulse::InitPlayout() {
     }
 
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-    uint32_t latency = bytesPerSec * WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS /
-                       WEBRTC_PA_MSECS_PER_SEC;
+    const uint32_t minimumMsecs =
+        _adaptivePlayLatency ? WEBRTC_PA_ADAPTIVE_PLAYBACK_LATENCY_MINIMUM_MSECS
+                             : WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS;
+    uint32_t latency = bytesPerSec * minimumMsecs / WEBRTC_PA_MSECS_PER_SEC;
 
     // Set the play buffer attributes
     _playBufferAttr.maxlength = latency;  // num bytes stored in the buffer
@@ -929,6 +939,8 @@ int32_t AudioDeviceLinuxPulse::InitPlayout() {
     _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
 
     _configuredLatencyPlay = latency;
+    _minStablePlayLatency = latency;
+    _lastPlayLatencyChangeMs = rtc::TimeMillis();
   }
 
   // num samples in bytes * num channels
@@ -1787,10 +1799,20 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler() {
                                    WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS /
                                    WEBRTC_PA_MSECS_PER_SEC;
 
+  // The adaptive mode never steps back down to a latency that underflowed.
+  _minStablePlayLatency = std::max<uint32_t>(
+      _minStablePlayLatency,
+      _configuredLatencyPlay + bytesPerSec *
+                                   WEBRTC_PA_PLAYBACK_LATENCY_DECREMENT_MSECS /
+                                   WEBRTC_PA_MSECS_PER_SEC);
+  SetPlayLatency(newLatency);
+}
+
+void AudioDeviceLinuxPulse::SetPlayLatency(uint32_t latency) {
   // Set the play buffer attributes
-  _playBufferAttr.maxlength = newLatency;
-  _playBufferAttr.tlength = newLatency;
-  _playBufferAttr.minreq = newLatency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
+  _playBufferAttr.maxlength = latency;
+  _playBufferAttr.tlength = latency;
+  _playBufferAttr.minreq = latency / WEBRTC_PA_PLAYBACK_REQUEST_FACTOR;
   _playBufferAttr.prebuf = _playBufferAttr.tlength - _playBufferAttr.minreq;
 
   pa_operation* op = LATE(pa_stream_set_buffer_attr)(
@@ -1804,7 +1826,37 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler() {
   LATE(pa_operation_unref)(op);
 
   // Save the new latency in case we underflow again.
-  _configuredLatencyPlay = newLatency;
+  _configuredLatencyPlay = latency;
+  _lastPlayLatencyChangeMs = rtc::TimeMillis();
+}
+
+void AudioDeviceLinuxPulse::MaybeDecreasePlayLatency() {
+  if (!_adaptivePlayLatency ||
+      _configuredLatencyPlay == WEBRTC_PA_NO_LATENCY_REQUIREMENTS ||
+      static_cast<uint32_t>(_configuredLatencyPlay) <= _minStablePlayLatency) {
+    return;
+  }
+  if (rtc::TimeMillis() - _lastPlayLatencyChangeMs <
+      WEBRTC_PA_PLAYBACK_STABLE_PERIOD_MSECS) {
+    return;
+  }
+
+  const pa_sample_spec* spec = LATE(pa_stream_get_sample_spec)(_playStream);
+  if (!spec) {
+    RTC_LOG(LS_ERROR) << "pa_stream_get_sample_spec()";
+    return;
+  }
+
+  size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
+  const uint32_t decrement = bytesPerSec *
+                             WEBRTC_PA_PLAYBACK_LATENCY_DECREMENT_MSECS /
+                             WEBRTC_PA_MSECS_PER_SEC;
+  const uint32_t newLatency = std::max<uint32_t>(
+      _minStablePlayLatency, _configuredLatencyPlay - decrement);
+  RTC_LOG(LS_INFO) << "Lowering playout latency to "
+                   << newLatency * WEBRTC_PA_MSECS_PER_SEC / bytesPerSec
+                   << " ms";
+  SetPlayLatency(newLatency);
 }
 
 void AudioDeviceLinuxPulse::EnableReadCallback() {
@@ -2128,21 +2180,36 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess() {
         return true;
       }
 
-      nSamples = _ptrAudioBuffer->GetPlayoutData(_playBuffer);
-      if (nSamples != numPlaySamples) {
-        RTC_LOG(LS_ERROR) << "invalid number of output samples(" << nSamples
-                          << ")";
-      }
-
       size_t write = _playbackBufferSize;
       if (_tempBufferSpace < write) {
         write = _tempBufferSpace;
       }
 
-      RTC_LOG(LS_VERBOSE) << "will write";
       PaLock();
-      if (LATE(pa_stream_write)(_playStream, (void*)&_playBuffer[0], write,
-                                NULL, (int64_t)0, PA_SEEK_RELATIVE) != PA_OK) {
+      // When the whole frame fits, let the AudioDeviceBuffer copy it straight
+      // into a PulseAudio memblock instead of staging it in |_playBuffer|.
+      void* paBuffer = NULL;
+      size_t paBufferSize = _playbackBufferSize;
+      const bool writeInPlace =
+          write == _playbackBufferSize &&
+          LATE(pa_stream_begin_write)(_playStream, &paBuffer, &paBufferSize) ==
+              PA_OK &&
+          paBufferSize >= _playbackBufferSize;
+      if (!writeInPlace && paBuffer) {
+        LATE(pa_stream_cancel_write)(_playStream);
+      }
+      int8_t* playData =
+          writeInPlace ? static_cast<int8_t*>(paBuffer) : _playBuffer;
+
+      nSamples = _ptrAudioBuffer->GetPlayoutData(playData);
+      if (nSamples != numPlaySamples) {
+        RTC_LOG(LS_ERROR) << "invalid number of output samples(" << nSamples
+                          << ")";
+      }
+
+      RTC_LOG(LS_VERBOSE) << "will write";
+      if (LATE(pa_stream_write)(_playStream, playData, write, NULL, (int64_t)0,
+                                PA_SEEK_RELATIVE) != PA_OK) {
         _writeErrors++;
         if (_writeErrors > 10) {
           RTC_LOG(LS_ERROR) << "Playout error: _writeErrors=" << _writeErrors
@@ -2157,6 +2224,7 @@ bool AudioDeviceLinuxPulse::PlayThreadProcess() {
 
     _tempBufferSpace = 0;
     PaLock();
+    MaybeDecreasePlayLatency();
     EnableWriteCallback();
     PaUnLock();
 
@@ -69,6 +69,16 @@ const uint32_t WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS = 20;
 // latency that is greater by this amount.
 const uint32_t WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS = 20;
 
+// With the "WebRTC-Audio-PulseAdaptiveLatency" field trial, playback starts
+// from this lower target instead, and an underflow raises the target by
+// WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS as usual. After playing for
+// WEBRTC_PA_PLAYBACK_STABLE_PERIOD_MSECS without an underflow the target is
+// lowered by WEBRTC_PA_PLAYBACK_LATENCY_DECREMENT_MSECS, but never back to a
+// target that has underflowed.
+const uint32_t WEBRTC_PA_ADAPTIVE_PLAYBACK_LATENCY_MINIMUM_MSECS = 10;
+const uint32_t WEBRTC_PA_PLAYBACK_LATENCY_DECREMENT_MSECS = 5;
+const uint32_t WEBRTC_PA_PLAYBACK_STABLE_PERIOD_MSECS = 10000;
+
 // We also need to configure a suitable request size. Too small and we'd burn
 // CPU from the overhead of transfering small amounts of data at once. Too large
 // and the amount of data remaining in the buffer right before refilling it
@@ -231,6 +241,12 @@ class AudioDeviceLinuxPulse : public AudioDeviceGeneric {
   void PaStreamWriteCallbackHandler(size_t buffer_space);
   static void PaStreamUnderflowCallback(pa_stream* unused, void* pThis);
   void PaStreamUnderflowCallbackHandler();
+  // Reconfigures the play stream with a target latency of |latency| bytes.
+  // Must be called with the PulseAudio lock held.
+  void SetPlayLatency(uint32_t latency);
+  // Lowers the play latency in the adaptive mode once playout has been stable
+  // for long enough. Must be called with the PulseAudio lock held.
+  void MaybeDecreasePlayLatency();
   void EnableReadCallback();
   void DisableReadCallback();
   static void PaStreamReadCallback(pa_stream* unused1,
@@ -322,6 +338,10 @@ class AudioDeviceLinuxPulse : public AudioDeviceGeneric {
   size_t _tempSampleDataSize;
   int32_t _configuredLatencyPlay;
   int32_t _configuredLatencyRec;
+  // Playback latency adaptation, see WEBRTC_PA_PLAYBACK_STABLE_PERIOD_MSECS.
+  const bool _adaptivePlayLatency;
+  uint32_t _minStablePlayLatency;
+  int64_t _lastPlayLatencyChangeMs;
 
   // PulseAudio
   uint16_t _paDeviceIndex;
@@ -61,6 +61,8 @@ namespace adm_linux_pulse {
   X(pa_cvolume_set)                        \
   X(pa_operation_get_state)                \
   X(pa_operation_unref)                    \
+  X(pa_stream_begin_write)                 \
+  X(pa_stream_cancel_write)                \
   X(pa_stream_connect_playback)            \
   X(pa_stream_connect_record)              \
   X(pa_stream_disconnect)                  \
@@ -13,13 +13,18 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <map>
 #include <type_traits>
 #include <utility>
 
+#include "api/task_queue/default_task_queue_factory.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "modules/audio_mixer/default_output_rate_calculator.h"
+#include "modules/audio_processing/agc2/speech_activity_ranker.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ref_counted_object.h"
 
@@ -91,16 +96,51 @@ AudioMixerImpl::SourceStatusList::const_iterator FindSourceInList(
         return p->audio_source == audio_source;
       });
 }
+
+AudioMixerImpl::Config MakeConfig(
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator,
+    bool use_limiter) {
+  AudioMixerImpl::Config config;
+  config.output_rate_calculator = std::move(output_rate_calculator);
+  config.use_limiter = use_limiter;
+  return config;
+}
 }  // namespace
 
+AudioMixerImpl::Config::Config() = default;
+AudioMixerImpl::Config::Config(Config&&) = default;
+AudioMixerImpl::Config& AudioMixerImpl::Config::operator=(Config&&) = default;
+AudioMixerImpl::Config::~Config() = default;
+
 AudioMixerImpl::AudioMixerImpl(
     std::unique_ptr<OutputRateCalculator> output_rate_calculator,
     bool use_limiter)
-    : output_rate_calculator_(std::move(output_rate_calculator)),
+    : AudioMixerImpl(
+          MakeConfig(std::move(output_rate_calculator), use_limiter)) {}
+
+AudioMixerImpl::AudioMixerImpl(Config config)
+    : output_rate_calculator_(std::move(config.output_rate_calculator)),
+      max_mixed_sources_(config.max_mixed_sources),
+      max_polled_sources_(config.max_polled_sources),
+      speech_activity_ranker_(config.speech_activity_ranker),
       output_frequency_(0),
       sample_size_(0),
       audio_source_list_(),
-      frame_combiner_(use_limiter) {}
+      frame_combiner_(config.use_limiter) {
+  RTC_DCHECK(max_polled_sources_ == 0 ||
+             max_polled_sources_ >= max_mixed_sources_);
+  if (!output_rate_calculator_)
+    output_rate_calculator_ = std::make_unique<DefaultOutputRateCalculator>();
+  if (config.num_fetch_threads > 0) {
+    std::unique_ptr<TaskQueueFactory> task_queue_factory =
+        CreateDefaultTaskQueueFactory();
+    for (size_t i = 0; i < config.num_fetch_threads; ++i) {
+      fetch_queues_.push_back(std::make_unique<rtc::TaskQueue>(
+          task_queue_factory->CreateTaskQueue(
+              "AudioMixerFetch", TaskQueueFactory::Priority::HIGH)));
+    }
+  }
+}
 
 AudioMixerImpl::~AudioMixerImpl() {}
 
@@ -118,6 +158,11 @@ rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(
           std::move(output_rate_calculator), use_limiter));
 }
 
+rtc::scoped_refptr<AudioMixerImpl> AudioMixerImpl::Create(Config config) {
+  return rtc::scoped_refptr<AudioMixerImpl>(
+      new rtc::RefCountedObject<AudioMixerImpl>(std::move(config)));
+}
+
 void AudioMixerImpl::Mix(size_t number_of_channels,
                          AudioFrame* audio_frame_for_mixing) {
   RTC_DCHECK(number_of_channels >= 1);
@@ -175,6 +220,92 @@ void AudioMixerImpl::RemoveSource(Source* audio_source) {
   audio_source_list_.erase(iter);
 }
 
+std::vector<AudioMixerImpl::SourceStatus*>
+AudioMixerImpl::SelectSourcesToPoll() {
+  std::vector<SourceStatus*> polled;
+  polled.reserve(audio_source_list_.size());
+  if (max_polled_sources_ == 0) {
+    for (auto& source_and_status : audio_source_list_)
+      polled.push_back(source_and_status.get());
+    return polled;
+  }
+
+  // The position of each stream in the ranking, if there is a ranker.
+  std::map<int, int> ranks;
+  if (speech_activity_ranker_) {
+    const std::vector<uint32_t> ranking =
+        speech_activity_ranker_->GetRanking();
+    for (size_t i = 0; i < ranking.size(); ++i)
+      ranks[static_cast<int>(ranking[i])] = static_cast<int>(i);
+  }
+
+  // Sources mixed last round are always polled, so that a lagging hint does
+  // not drop them from the mix, and so are sources without a hint. The rest
+  // compete on their hints, or on their ranks if there is a ranker.
+  std::vector<std::pair<int, SourceStatus*>> candidates;
+  for (auto& source_and_status : audio_source_list_) {
+    absl::optional<int> level;
+    if (!source_and_status->is_mixed && speech_activity_ranker_) {
+      auto it = ranks.find(source_and_status->audio_source->Ssrc());
+      if (it != ranks.end())
+        level = it->second;
+    } else if (!source_and_status->is_mixed) {
+      level = source_and_status->audio_source->AudioLevelHint();
+    }
+    if (level) {
+      candidates.emplace_back(*level, source_and_status.get());
+    } else {
+      polled.push_back(source_and_status.get());
+    }
+  }
+  // Lower levels are louder, and lower ranks more active.
+  const size_t num_candidates =
+      std::min(candidates.size(), max_polled_sources_);
+  std::nth_element(
+      candidates.begin(), candidates.begin() + num_candidates,
+      candidates.end(),
+      [](const std::pair<int, SourceStatus*>& a,
+         const std::pair<int, SourceStatus*>& b) { return a.first < b.first; });
+  for (size_t i = 0; i < num_candidates; ++i)
+    polled.push_back(candidates[i].second);
+  return polled;
+}
+
+void AudioMixerImpl::FetchAudio(const std::vector<SourceStatus*>& sources) {
+  const int sample_rate_hz = OutputFrequency();
+  auto fetch = [sample_rate_hz, &sources](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      SourceStatus* status = sources[i];
+      status->audio_frame_info =
+          status->audio_source->GetAudioFrameWithInfo(sample_rate_hz,
+                                                      &status->audio_frame);
+    }
+  };
+
+  // Split the sources in contiguous ranges, one per thread. The mixing thread
+  // takes the first.
+  const size_t num_ranges =
+      std::min(fetch_queues_.size() + 1, std::max<size_t>(sources.size(), 1));
+  if (num_ranges == 1) {
+    fetch(0, sources.size());
+    return;
+  }
+  rtc::Event done;
+  std::atomic<int> num_pending(static_cast<int>(num_ranges) - 1);
+  for (size_t i = 1; i < num_ranges; ++i) {
+    const size_t begin = sources.size() * i / num_ranges;
+    const size_t end = sources.size() * (i + 1) / num_ranges;
+    fetch_queues_[i - 1]->PostTask([&fetch, &done, &num_pending, begin, end] {
+      fetch(begin, end);
+      if (num_pending.fetch_sub(1) == 1) {
+        done.Set();
+      }
+    });
+  }
+  fetch(0, sources.size() / num_ranges);
+  done.Wait(rtc::Event::kForever);
+}
+
 AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
   AudioFrameList result;
@@ -182,25 +313,29 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   std::vector<SourceFrame> ramp_list;
 
   // Get audio from the audio sources and put it in the SourceFrame vector.
-  for (auto& source_and_status : audio_source_list_) {
-    const auto audio_frame_info =
-        source_and_status->audio_source->GetAudioFrameWithInfo(
-            OutputFrequency(), &source_and_status->audio_frame);
-
+  const std::vector<SourceStatus*> polled_sources = SelectSourcesToPoll();
+  FetchAudio(polled_sources);
+  audio_source_mixing_data_list.reserve(polled_sources.size());
+  for (SourceStatus* source_status : polled_sources) {
+    const auto audio_frame_info = source_status->audio_frame_info;
     if (audio_frame_info == Source::AudioFrameInfo::kError) {
       RTC_LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
       continue;
     }
     audio_source_mixing_data_list.emplace_back(
-        source_and_status.get(), &source_and_status->audio_frame,
+        source_status, &source_status->audio_frame,
         audio_frame_info == Source::AudioFrameInfo::kMuted);
   }
 
-  // Sort frames by sorting function.
-  std::sort(audio_source_mixing_data_list.begin(),
-            audio_source_mixing_data_list.end(), ShouldMixBefore);
+  // Only the sources that may be mixed need to be in order. Muted sources go
+  // last, so they are among those only when fewer sources are unmuted.
+  const size_t num_sorted =
+      std::min(audio_source_mixing_data_list.size(), max_mixed_sources_);
+  std::partial_sort(audio_source_mixing_data_list.begin(),
+                    audio_source_mixing_data_list.begin() + num_sorted,
+                    audio_source_mixing_data_list.end(), ShouldMixBefore);
 
-  int max_audio_frame_counter = kMaximumAmountOfMixedAudioSources;
+  size_t max_audio_frame_counter = max_mixed_sources_;
 
   // Go through list in order and put unmuted frames in result list.
   for (const auto& p : audio_source_mixing_data_list) {
@@ -24,10 +24,13 @@
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/race_checker.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
+class SpeechActivityRanker;
+
 typedef std::vector<AudioFrame*> AudioFrameList;
 
 class AudioMixerImpl : public AudioMixer {
@@ -41,6 +44,34 @@ class AudioMixerImpl : public AudioMixer {
 
     // A frame that will be passed to audio_source->GetAudioFrameWithInfo.
     AudioFrame audio_frame;
+    // The result of the last GetAudioFrameWithInfo call.
+    Source::AudioFrameInfo audio_frame_info = Source::AudioFrameInfo::kError;
+  };
+
+  struct Config {
+    Config();
+    Config(Config&&);
+    Config& operator=(Config&&);
+    ~Config();
+
+    // Defaults to a DefaultOutputRateCalculator if null.
+    std::unique_ptr<OutputRateCalculator> output_rate_calculator;
+    bool use_limiter = true;
+    // The most sources mixed at once.
+    size_t max_mixed_sources = kMaximumAmountOfMixedAudioSources;
+    // If nonzero, of the sources that give an AudioLevelHint(), only the
+    // |max_polled_sources| loudest are asked for audio each round, along with
+    // those mixed in the last round so that they can ramp out. Sources without
+    // a hint are always asked. Must be at least |max_mixed_sources|.
+    size_t max_polled_sources = 0;
+    // If set, the sources compete for polling on the rank of their Ssrc() in
+    // this ranker rather than on their AudioLevelHint(), and those it does not
+    // know are always asked. It is fed by its owner and must outlive the
+    // mixer.
+    SpeechActivityRanker* speech_activity_ranker = nullptr;
+    // Number of extra threads asking sources for audio, in parallel with the
+    // mixing thread. Each source is still asked by one thread at a time.
+    size_t num_fetch_threads = 0;
   };
 
   using SourceStatusList = std::vector<std::unique_ptr<SourceStatus>>;
@@ -55,6 +86,8 @@ class AudioMixerImpl : public AudioMixer {
       std::unique_ptr<OutputRateCalculator> output_rate_calculator,
       bool use_limiter);
 
+  static rtc::scoped_refptr<AudioMixerImpl> Create(Config config);
+
   ~AudioMixerImpl() override;
 
   // AudioMixer functions
@@ -73,6 +106,7 @@ class AudioMixerImpl : public AudioMixer {
  protected:
   AudioMixerImpl(std::unique_ptr<OutputRateCalculator> output_rate_calculator,
                  bool use_limiter);
+  explicit AudioMixerImpl(Config config);
 
  private:
   // Set mixing frequency through OutputFrequencyCalculator.
@@ -81,10 +115,17 @@ class AudioMixerImpl : public AudioMixer {
   int OutputFrequency() const;
 
   // Compute what audio sources to mix from audio_source_list_. Ramp
-  // in and out. Update mixed status. Mixes up to
-  // kMaximumAmountOfMixedAudioSources audio sources.
+  // in and out. Update mixed status. Mixes up to |max_mixed_sources_| audio
+  // sources.
   AudioFrameList GetAudioFromSources() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Returns the sources to ask for audio this round.
+  std::vector<SourceStatus*> SelectSourcesToPoll()
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Asks |sources| for audio, on the fetch threads if there are any.
+  void FetchAudio(const std::vector<SourceStatus*>& sources)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // The critical section lock guards audio source insertion and
   // removal, which can be done from any thread. The race checker
   // checks that mixing is done sequentially.
@@ -92,6 +133,9 @@ class AudioMixerImpl : public AudioMixer {
   rtc::RaceChecker race_checker_;
 
   std::unique_ptr<OutputRateCalculator> output_rate_calculator_;
+  const size_t max_mixed_sources_;
+  const size_t max_polled_sources_;
+  SpeechActivityRanker* const speech_activity_ranker_;
   // The current sample frequency and sample size when mixing.
   int output_frequency_ RTC_GUARDED_BY(race_checker_);
   size_t sample_size_ RTC_GUARDED_BY(race_checker_);
@@ -102,6 +146,9 @@ class AudioMixerImpl : public AudioMixer {
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_ RTC_GUARDED_BY(race_checker_);
 
+  // Ask sources for audio in parallel with the mixing thread.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> fetch_queues_;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
 }  // namespace webrtc
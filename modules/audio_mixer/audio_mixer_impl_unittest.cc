@@ -19,6 +19,7 @@
 
 #include "api/audio/audio_mixer.h"
 #include "modules/audio_mixer/default_output_rate_calculator.h"
+#include "modules/audio_processing/agc2/speech_activity_ranker.h"
 #include "rtc_base/bind.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/strings/string_builder.h"
@@ -81,6 +82,7 @@ class MockMixerAudioSource : public ::testing::NiceMock<AudioMixer::Source> {
 
   MOCK_METHOD(int, PreferredSampleRate, (), (const, override));
   MOCK_METHOD(int, Ssrc, (), (const, override));
+  MOCK_METHOD(absl::optional<int>, AudioLevelHint, (), (const, override));
 
   AudioFrame* fake_frame() { return &fake_frame_; }
   AudioFrameInfo fake_info() { return fake_audio_frame_info_; }
@@ -643,4 +645,177 @@ TEST(AudioMixerDeathTest, MultipleChannelsAndHighRate) {
 #endif
 }
 
+TEST(AudioMixer, MixesConfiguredNumberOfSources) {
+  constexpr size_t kMaxMixedSources = 5;
+  constexpr int kAudioSources = kMaxMixedSources + 3;
+  AudioMixerImpl::Config config;
+  config.max_mixed_sources = kMaxMixedSources;
+  const auto mixer = AudioMixerImpl::Create(std::move(config));
+
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    participants[i].fake_frame()->mutable_data()[80] = i;
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+
+  for (int i = 0; i < kAudioSources; ++i) {
+    EXPECT_EQ(i >= kAudioSources - static_cast<int>(kMaxMixedSources),
+              mixer->GetAudioSourceMixabilityStatusForTest(&participants[i]))
+        << "Mixing status of AudioSource #" << i << " wrong.";
+  }
+}
+
+TEST(AudioMixer, PollsOnlyLoudestHintedSources) {
+  AudioMixerImpl::Config config;
+  config.max_mixed_sources = 1;
+  config.max_polled_sources = 2;
+  const auto mixer = AudioMixerImpl::Create(std::move(config));
+
+  constexpr int kLevels[] = {10, 100, 20, 127};
+  constexpr bool kPolled[] = {true, false, true, false};
+  MockMixerAudioSource participants[4];
+  for (int i = 0; i < 4; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    ON_CALL(participants[i], AudioLevelHint())
+        .WillByDefault(Return(kLevels[i]));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(_, _))
+        .Times(kPolled[i] ? 1 : 0);
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+}
+
+TEST(AudioMixer, AlwaysPollsSourcesWithoutHint) {
+  AudioMixerImpl::Config config;
+  config.max_mixed_sources = 1;
+  config.max_polled_sources = 1;
+  const auto mixer = AudioMixerImpl::Create(std::move(config));
+
+  MockMixerAudioSource without_hint[2];
+  for (auto& participant : without_hint) {
+    ResetFrame(participant.fake_frame());
+    EXPECT_CALL(participant, GetAudioFrameWithInfo(_, _)).Times(1);
+    EXPECT_TRUE(mixer->AddSource(&participant));
+  }
+  MockMixerAudioSource loud;
+  MockMixerAudioSource quiet;
+  ResetFrame(loud.fake_frame());
+  ResetFrame(quiet.fake_frame());
+  ON_CALL(loud, AudioLevelHint()).WillByDefault(Return(0));
+  ON_CALL(quiet, AudioLevelHint()).WillByDefault(Return(90));
+  EXPECT_CALL(loud, GetAudioFrameWithInfo(_, _)).Times(1);
+  EXPECT_CALL(quiet, GetAudioFrameWithInfo(_, _)).Times(0);
+  EXPECT_TRUE(mixer->AddSource(&loud));
+  EXPECT_TRUE(mixer->AddSource(&quiet));
+
+  mixer->Mix(1, &frame_for_mixing);
+}
+
+TEST(AudioMixer, PollsMixedSourceAfterItsHintTurnsQuiet) {
+  AudioMixerImpl::Config config;
+  config.max_mixed_sources = 1;
+  config.max_polled_sources = 1;
+  const auto mixer = AudioMixerImpl::Create(std::move(config));
+
+  MockMixerAudioSource speaker;
+  MockMixerAudioSource listener;
+  ResetFrame(speaker.fake_frame());
+  ResetFrame(listener.fake_frame());
+  speaker.fake_frame()->mutable_data()[80] = 100;
+  ON_CALL(speaker, AudioLevelHint()).WillByDefault(Return(0));
+  ON_CALL(listener, AudioLevelHint()).WillByDefault(Return(127));
+  EXPECT_TRUE(mixer->AddSource(&speaker));
+  EXPECT_TRUE(mixer->AddSource(&listener));
+
+  EXPECT_CALL(speaker, GetAudioFrameWithInfo(_, _)).Times(1);
+  EXPECT_CALL(listener, GetAudioFrameWithInfo(_, _)).Times(0);
+  mixer->Mix(1, &frame_for_mixing);
+  EXPECT_TRUE(mixer->GetAudioSourceMixabilityStatusForTest(&speaker));
+
+  // The speaker was mixed, so it is still asked for audio, while the listener
+  // now wins on its hint.
+  ON_CALL(speaker, AudioLevelHint()).WillByDefault(Return(127));
+  ON_CALL(listener, AudioLevelHint()).WillByDefault(Return(0));
+  EXPECT_CALL(speaker, GetAudioFrameWithInfo(_, _)).Times(1);
+  EXPECT_CALL(listener, GetAudioFrameWithInfo(_, _)).Times(1);
+  mixer->Mix(1, &frame_for_mixing);
+}
+
+TEST(AudioMixer, PollsMostActiveRankedSources) {
+  SpeechActivityRanker ranker;
+  AudioMixerImpl::Config config;
+  config.max_mixed_sources = 1;
+  config.max_polled_sources = 2;
+  config.speech_activity_ranker = &ranker;
+  const auto mixer = AudioMixerImpl::Create(std::move(config));
+
+  // The ranks decide rather than the hints. The loudest ranked source is not
+  // speaking, and the last source is unknown to the ranker.
+  constexpr int kNumRankedSources = 4;
+  constexpr int kRtpLevels[kNumRankedSources] = {10, 100, 20, 5};
+  constexpr bool kPolled[] = {true, false, true, false, true};
+  MockMixerAudioSource participants[kNumRankedSources + 1];
+  for (int i = 0; i <= kNumRankedSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    ON_CALL(participants[i], Ssrc()).WillByDefault(Return(i + 1));
+    ON_CALL(participants[i], AudioLevelHint()).WillByDefault(Return(0));
+    EXPECT_CALL(participants[i], GetAudioFrameWithInfo(_, _))
+        .Times(kPolled[i] ? 1 : 0);
+    EXPECT_TRUE(mixer->AddSource(&participants[i]));
+  }
+  for (int i = 0; i < kNumRankedSources; ++i)
+    ranker.AddStream(i + 1);
+  for (int round = 0; round < 50; ++round) {
+    for (int i = 0; i < kNumRankedSources; ++i) {
+      ranker.OnAudioLevel(i + 1, kRtpLevels[i],
+                          /*voice_activity=*/i != kNumRankedSources - 1);
+    }
+    ranker.Process();
+  }
+
+  mixer->Mix(1, &frame_for_mixing);
+}
+
+TEST(AudioMixer, FetchThreadsGiveSameMixAsMixingThread) {
+  constexpr int kAudioSources = 10;
+  MockMixerAudioSource participants[kAudioSources];
+  for (int i = 0; i < kAudioSources; ++i) {
+    ResetFrame(participants[i].fake_frame());
+    int16_t* data = participants[i].fake_frame()->mutable_data();
+    for (size_t j = 0; j < kDefaultSampleRateHz / 100; ++j)
+      data[j] = static_cast<int16_t>((i + 1) * 100 + j);
+  }
+
+  AudioMixerImpl::Config config;
+  config.num_fetch_threads = 3;
+  const auto parallel_mixer = AudioMixerImpl::Create(std::move(config));
+  const auto serial_mixer = AudioMixerImpl::Create();
+  for (auto& participant : participants) {
+    EXPECT_CALL(participant, GetAudioFrameWithInfo(_, _)).Times(4);
+    EXPECT_TRUE(parallel_mixer->AddSource(&participant));
+    EXPECT_TRUE(serial_mixer->AddSource(&participant));
+  }
+
+  AudioFrame parallel_frame;
+  AudioFrame serial_frame;
+  for (int i = 0; i < 2; ++i) {
+    parallel_mixer->Mix(1, &parallel_frame);
+    serial_mixer->Mix(1, &serial_frame);
+  }
+
+  ASSERT_EQ(serial_frame.samples_per_channel_,
+            parallel_frame.samples_per_channel_);
+  EXPECT_EQ(0, memcmp(serial_frame.data(), parallel_frame.data(),
+                      serial_frame.samples_per_channel_ * sizeof(int16_t)));
+  for (auto& participant : participants) {
+    EXPECT_EQ(serial_mixer->GetAudioSourceMixabilityStatusForTest(&participant),
+              parallel_mixer->GetAudioSourceMixabilityStatusForTest(
+                  &participant));
+  }
+}
+
 }  // namespace webrtc
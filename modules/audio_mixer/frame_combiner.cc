@@ -68,34 +68,42 @@ void MixFewFramesWithNoLimiter(const std::vector<AudioFrame*>& mix_list,
     return;
   }
   RTC_DCHECK_LE(mix_list.size(), 1);
-  std::copy(mix_list[0]->data(),
-            mix_list[0]->data() +
-                mix_list[0]->num_channels_ * mix_list[0]->samples_per_channel_,
-            audio_frame_for_mixing->mutable_data());
+  // The samples are passed through unchanged, so share them instead of
+  // copying.
+  audio_frame_for_mixing->ShareDataFrom(*mix_list[0]);
 }
 
 void MixToFloatFrame(const std::vector<AudioFrame*>& mix_list,
                      size_t samples_per_channel,
                      size_t number_of_channels,
+                     FrameCombiner::InterleavedMixingBuffer* interleaved_buffer,
                      MixingBuffer* mixing_buffer) {
   RTC_DCHECK_LE(samples_per_channel, FrameCombiner::kMaximumChannelSize);
   RTC_DCHECK_LE(number_of_channels, FrameCombiner::kMaximumNumberOfChannels);
-  // Clear the mixing buffer.
+  const size_t num_samples = std::min(number_of_channels * samples_per_channel,
+                                      interleaved_buffer->size());
+  float* const sum = interleaved_buffer->data();
+
+  // Convert to FloatS16 and mix, keeping the interleaved layout.
+  std::fill(sum, sum + num_samples, 0.f);
+  for (const AudioFrame* frame : mix_list) {
+    const int16_t* const data = frame->data();
+    for (size_t i = 0; i < num_samples; ++i) {
+      sum[i] += data[i];
+    }
+  }
+
+  // Deinterleave into the mixing buffer, clearing what is not covered.
   for (auto& one_channel_buffer : *mixing_buffer) {
     std::fill(one_channel_buffer.begin(), one_channel_buffer.end(), 0.f);
   }
-
-  // Convert to FloatS16 and mix.
-  for (size_t i = 0; i < mix_list.size(); ++i) {
-    const AudioFrame* const frame = mix_list[i];
-    for (size_t j = 0; j < std::min(number_of_channels,
-                                    FrameCombiner::kMaximumNumberOfChannels);
-         ++j) {
-      for (size_t k = 0; k < std::min(samples_per_channel,
-                                      FrameCombiner::kMaximumChannelSize);
-           ++k) {
-        (*mixing_buffer)[j][k] += frame->data()[number_of_channels * k + j];
-      }
+  const size_t output_number_of_channels =
+      std::min(number_of_channels, FrameCombiner::kMaximumNumberOfChannels);
+  const size_t output_samples_per_channel =
+      std::min(samples_per_channel, FrameCombiner::kMaximumChannelSize);
+  for (size_t j = 0; j < output_number_of_channels; ++j) {
+    for (size_t k = 0; k < output_samples_per_channel; ++k) {
+      (*mixing_buffer)[j][k] = sum[number_of_channels * k + j];
     }
   }
 }
@@ -131,6 +139,7 @@ FrameCombiner::FrameCombiner(bool use_limiter)
       mixing_buffer_(
           std::make_unique<std::array<std::array<float, kMaximumChannelSize>,
                                       kMaximumNumberOfChannels>>()),
+      interleaved_mixing_buffer_(std::make_unique<InterleavedMixingBuffer>()),
       limiter_(static_cast<size_t>(48000), data_dumper_.get(), "AudioMixer"),
       use_limiter_(use_limiter) {
   static_assert(kMaximumChannelSize * kMaximumNumberOfChannels <=
@@ -172,7 +181,7 @@ void FrameCombiner::Combine(const std::vector<AudioFrame*>& mix_list,
   }
 
   MixToFloatFrame(mix_list, samples_per_channel, number_of_channels,
-                  mixing_buffer_.get());
+                  interleaved_mixing_buffer_.get(), mixing_buffer_.get());
 
   const size_t output_number_of_channels =
       std::min(number_of_channels, kMaximumNumberOfChannels);
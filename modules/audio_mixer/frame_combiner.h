@@ -44,6 +44,10 @@ class FrameCombiner {
 
   using MixingBuffer = std::array<std::array<float, kMaximumChannelSize>,
                                   kMaximumNumberOfChannels>;
+  // Holds the sum of the frames in their interleaved layout, so that frames
+  // are added with contiguous, vectorizable loops.
+  using InterleavedMixingBuffer =
+      std::array<float, AudioFrame::kMaxDataSizeSamples>;
 
  private:
   void LogMixingStats(const std::vector<AudioFrame*>& mix_list,
@@ -52,6 +56,7 @@ class FrameCombiner {
 
   std::unique_ptr<ApmDataDumper> data_dumper_;
   std::unique_ptr<MixingBuffer> mixing_buffer_;
+  std::unique_ptr<InterleavedMixingBuffer> interleaved_mixing_buffer_;
   Limiter limiter_;
   const bool use_limiter_;
   mutable int uma_logging_counter_ = 0;
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/channel_worker_pool.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+ChannelWorkerPool::ChannelWorkerPool(size_t num_threads) {
+  RTC_DCHECK_GE(num_threads, 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->pool = this;
+    worker->thread = std::make_unique<rtc::PlatformThread>(
+        &ChannelWorkerPool::WorkerThread, worker.get(), "Aec3ChannelWorker",
+        rtc::kRealtimePriority);
+    worker->thread->Start();
+    workers_.push_back(std::move(worker));
+  }
+}
+
+ChannelWorkerPool::~ChannelWorkerPool() {
+  {
+    rtc::CritScope lock(&crit_);
+    stopping_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker->wake_up.Set();
+    worker->thread->Stop();
+  }
+}
+
+void ChannelWorkerPool::ParallelFor(size_t num_channels,
+                                    rtc::FunctionView<void(size_t)> function) {
+  if (workers_.empty() || num_channels <= 1) {
+    for (size_t ch = 0; ch < num_channels; ++ch) {
+      function(ch);
+    }
+    return;
+  }
+
+  // The calling thread takes part, so only wake up as many workers as there
+  // are channels left for them.
+  const size_t num_woken_workers = std::min(workers_.size(), num_channels - 1);
+  {
+    rtc::CritScope lock(&crit_);
+    function_ = &function;
+    num_channels_ = num_channels;
+    next_channel_ = 0;
+    active_workers_ = num_woken_workers;
+  }
+  for (size_t i = 0; i < num_woken_workers; ++i) {
+    workers_[i]->wake_up.Set();
+  }
+  ProcessChannels();
+  done_.Wait(rtc::Event::kForever, rtc::Event::kForever);
+}
+
+void ChannelWorkerPool::WorkerThread(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  worker->pool->RunWorker(worker);
+}
+
+void ChannelWorkerPool::RunWorker(Worker* worker) {
+  while (true) {
+    // Workers are idle whenever no capture audio is processed, so don't warn
+    // about long waits.
+    worker->wake_up.Wait(rtc::Event::kForever, rtc::Event::kForever);
+    {
+      rtc::CritScope lock(&crit_);
+      if (stopping_) {
+        return;
+      }
+    }
+    ProcessChannels();
+    rtc::CritScope lock(&crit_);
+    if (--active_workers_ == 0) {
+      done_.Set();
+    }
+  }
+}
+
+void ChannelWorkerPool::ProcessChannels() {
+  while (true) {
+    rtc::FunctionView<void(size_t)>* function;
+    size_t ch;
+    {
+      rtc::CritScope lock(&crit_);
+      if (next_channel_ >= num_channels_) {
+        return;
+      }
+      function = function_;
+      ch = next_channel_++;
+    }
+    (*function)(ch);
+  }
+}
+
+}  // namespace webrtc
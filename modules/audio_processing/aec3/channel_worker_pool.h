@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_CHANNEL_WORKER_POOL_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_CHANNEL_WORKER_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/function_view.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Spreads independent per-channel work of a capture block over a few threads.
+// The threads are kept alive, with real-time priority like the audio capture
+// thread, so that handing over the channels of a block is cheap. As every
+// channel is processed by exactly one thread, the results don't depend on the
+// number of threads as long as the work for different channels is independent.
+class ChannelWorkerPool {
+ public:
+  // |num_threads| includes the thread calling ParallelFor(). With one thread,
+  // all channels are processed on the calling thread.
+  explicit ChannelWorkerPool(size_t num_threads);
+  ChannelWorkerPool(const ChannelWorkerPool&) = delete;
+  ChannelWorkerPool& operator=(const ChannelWorkerPool&) = delete;
+  ~ChannelWorkerPool();
+
+  size_t num_threads() const { return workers_.size() + 1; }
+
+  // Calls |function| once for every channel in [0, num_channels) and returns
+  // when all calls are done. Must not be called from |function|, nor from
+  // several threads at once.
+  void ParallelFor(size_t num_channels,
+                   rtc::FunctionView<void(size_t)> function);
+
+ private:
+  struct Worker {
+    ChannelWorkerPool* pool;
+    rtc::Event wake_up;
+    std::unique_ptr<rtc::PlatformThread> thread;
+  };
+
+  static void WorkerThread(void* obj);
+  void RunWorker(Worker* worker);
+  void ProcessChannels();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  rtc::Event done_;
+
+  rtc::CriticalSection crit_;
+  bool stopping_ RTC_GUARDED_BY(crit_) = false;
+  rtc::FunctionView<void(size_t)>* function_ RTC_GUARDED_BY(crit_) = nullptr;
+  size_t num_channels_ RTC_GUARDED_BY(crit_) = 0;
+  size_t next_channel_ RTC_GUARDED_BY(crit_) = 0;
+  size_t active_workers_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_CHANNEL_WORKER_POOL_H_
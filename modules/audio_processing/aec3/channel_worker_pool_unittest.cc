@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/channel_worker_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(ChannelWorkerPool, ProcessesEveryChannelOnce) {
+  for (size_t num_threads : {1, 2, 4}) {
+    ChannelWorkerPool pool(num_threads);
+    EXPECT_EQ(num_threads, pool.num_threads());
+    for (size_t num_channels : {0, 1, 3, 8}) {
+      // Run several blocks, as the workers are reused between calls.
+      for (int block = 0; block < 10; ++block) {
+        std::vector<std::atomic<int>> calls(num_channels);
+        for (auto& c : calls) {
+          c = 0;
+        }
+        pool.ParallelFor(num_channels, [&](size_t ch) { ++calls[ch]; });
+        for (size_t ch = 0; ch < num_channels; ++ch) {
+          EXPECT_EQ(1, calls[ch]) << "threads: " << num_threads
+                                  << ", channel: " << ch;
+        }
+      }
+    }
+  }
+}
+
+TEST(ChannelWorkerPool, ReturnsWhenAllChannelsAreDone) {
+  ChannelWorkerPool pool(4);
+  std::vector<float> results(6, 0.f);
+  pool.ParallelFor(results.size(), [&](size_t ch) {
+    float sum = 0.f;
+    for (int k = 0; k < 10000; ++k) {
+      sum += static_cast<float>(ch);
+    }
+    results[ch] = sum;
+  });
+  for (size_t ch = 0; ch < results.size(); ++ch) {
+    EXPECT_EQ(10000.f * ch, results[ch]);
+  }
+}
+
+}  // namespace webrtc
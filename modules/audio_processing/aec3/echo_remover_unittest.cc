@@ -22,7 +22,9 @@
 #include "modules/audio_processing/test/echo_canceller_test_tools.h"
 #include "rtc_base/random.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/time_utils.h"
 #include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
 
 namespace webrtc {
 namespace {
@@ -38,6 +40,61 @@ std::string ProduceDebugText(int sample_rate_hz, int delay) {
   return ss.Release();
 }
 
+// Runs an echo remover at 48 kHz with two render channels, where every capture
+// channel gets its own mix of echo and noise. Returns the lowest band of all
+// processed capture blocks and adds the time spent in ProcessCapture() to
+// |processing_time_us|.
+std::vector<float> RemoveEcho(const EchoCanceller3Config& config,
+                              size_t num_capture_channels,
+                              int num_blocks,
+                              int64_t* processing_time_us) {
+  constexpr int kRate = 48000;
+  constexpr size_t kNumRenderChannels = 2;
+  std::unique_ptr<EchoRemover> remover(EchoRemover::Create(
+      config, kRate, kNumRenderChannels, num_capture_channels));
+  std::unique_ptr<RenderDelayBuffer> render_buffer(
+      RenderDelayBuffer::Create(config, kRate, kNumRenderChannels));
+  std::vector<std::vector<std::vector<float>>> x(
+      NumBandsForRate(kRate),
+      std::vector<std::vector<float>>(kNumRenderChannels,
+                                      std::vector<float>(kBlockSize, 0.f)));
+  std::vector<std::vector<std::vector<float>>> y(
+      NumBandsForRate(kRate),
+      std::vector<std::vector<float>>(num_capture_channels,
+                                      std::vector<float>(kBlockSize, 0.f)));
+  Random random_generator(42U);
+  const EchoPathVariability echo_path_variability(
+      false, EchoPathVariability::DelayAdjustment::kNone, false);
+  absl::optional<DelayEstimate> delay_estimate;
+  std::vector<float> output;
+  for (int k = 0; k < num_blocks; ++k) {
+    for (size_t band = 0; band < x.size(); ++band) {
+      for (size_t ch = 0; ch < kNumRenderChannels; ++ch) {
+        RandomizeSampleVector(&random_generator, x[band][ch]);
+      }
+      for (size_t ch = 0; ch < num_capture_channels; ++ch) {
+        RandomizeSampleVector(&random_generator, y[band][ch], 100.f);
+        const float echo_gain = 1.f / (ch + 1);
+        for (size_t i = 0; i < kBlockSize; ++i) {
+          y[band][ch][i] += echo_gain * x[band][ch % kNumRenderChannels][i];
+        }
+      }
+    }
+    render_buffer->Insert(x);
+    render_buffer->PrepareCaptureProcessing();
+
+    const int64_t start_time_us = rtc::TimeMicros();
+    remover->ProcessCapture(echo_path_variability, false, delay_estimate,
+                            render_buffer->GetRenderBuffer(), nullptr, &y);
+    *processing_time_us += rtc::TimeMicros() - start_time_us;
+
+    for (size_t ch = 0; ch < num_capture_channels; ++ch) {
+      output.insert(output.end(), y[0][ch].begin(), y[0][ch].end());
+    }
+  }
+  return output;
+}
+
 }  // namespace
 
 class EchoRemoverMultiChannel
@@ -240,4 +297,45 @@ TEST(EchoRemover, BasicEchoRemoval) {
   }
 }
 
+// Verifies that processing the capture channels on several threads gives
+// exactly the same output as processing them on the capture thread.
+TEST(EchoRemover, SameOutputWithSeveralCaptureThreads) {
+  constexpr size_t kNumCaptureChannels = 6;
+  constexpr int kNumBlocks = 200;
+  int64_t processing_time_us = 0;
+  EchoCanceller3Config config;
+  const std::vector<float> reference = RemoveEcho(
+      config, kNumCaptureChannels, kNumBlocks, &processing_time_us);
+  for (size_t num_threads : {2, 4, 8}) {
+    SCOPED_TRACE(num_threads);
+    config.multi_channel.num_capture_threads = num_threads;
+    EXPECT_EQ(reference, RemoveEcho(config, kNumCaptureChannels, kNumBlocks,
+                                    &processing_time_us));
+  }
+}
+
+// Reports the average time for removing the echo from a capture block, for
+// different numbers of capture channels and threads.
+TEST(EchoRemover, DISABLED_ProcessingTimePerCaptureChannelCount) {
+  constexpr int kNumBlocks = 2000;
+  for (size_t num_channels : {1, 2, 4, 8}) {
+    for (size_t num_threads : {1, 2, 4}) {
+      if (num_threads > num_channels) {
+        continue;
+      }
+      EchoCanceller3Config config;
+      config.multi_channel.num_capture_threads = num_threads;
+      int64_t processing_time_us = 0;
+      RemoveEcho(config, num_channels, kNumBlocks, &processing_time_us);
+      rtc::StringBuilder modifier;
+      modifier << "_" << num_channels << "_channels";
+      rtc::StringBuilder story;
+      story << num_threads << "_threads";
+      webrtc::test::PrintResult(
+          "aec3_echo_remover_block_time", modifier.str(), story.str(),
+          static_cast<double>(processing_time_us) / kNumBlocks, "us", false);
+    }
+  }
+}
+
 }  // namespace webrtc
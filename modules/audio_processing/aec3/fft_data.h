@@ -60,6 +60,9 @@ struct FftData {
         power_spectrum[kFftLengthBy2] = re[kFftLengthBy2] * re[kFftLengthBy2] +
                                         im[kFftLengthBy2] * im[kFftLengthBy2];
       } break;
+      case Aec3Optimization::kAvx2:
+        SpectrumAVX2(power_spectrum);
+        break;
 #endif
       default:
         std::transform(re.begin(), re.end(), im.begin(), power_spectrum.begin(),
@@ -91,6 +94,12 @@ struct FftData {
 
   std::array<float, kFftLengthBy2Plus1> re;
   std::array<float, kFftLengthBy2Plus1> im;
+
+ private:
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  // Computes the power spectrum of the data, using AVX2.
+  void SpectrumAVX2(rtc::ArrayView<float> power_spectrum) const;
+#endif
 };
 
 }  // namespace webrtc
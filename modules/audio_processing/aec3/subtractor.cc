@@ -83,7 +83,11 @@ Subtractor::Subtractor(const EchoCanceller3Config& config,
           std::vector<float>(GetTimeDomainLength(std::max(
                                  config_.filter.refined_initial.length_blocks,
                                  config_.filter.refined.length_blocks)),
-                             0.f)) {
+                             0.f)),
+      worker_pool_(std::max<size_t>(
+          1,
+          std::min(config_.multi_channel.num_capture_threads,
+                   num_capture_channels_))) {
   for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
     refined_filters_[ch] = std::make_unique<AdaptiveFirFilter>(
         config_.filter.refined.length_blocks,
@@ -181,8 +185,9 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
                                &X2_coarse);
   }
 
-  // Process all capture channels
-  for (size_t ch = 0; ch < num_capture_channels_; ++ch) {
+  // Process all capture channels. The filters of the channels are adapted
+  // independently, so the channels may be processed in parallel.
+  worker_pool_.ParallelFor(num_capture_channels_, [&](size_t ch) {
     RTC_DCHECK_EQ(kBlockSize, capture[ch].size());
     SubtractorOutput& output = outputs[ch];
     rtc::ArrayView<const float> y = capture[ch];
@@ -282,7 +287,7 @@ void Subtractor::Process(const RenderBuffer& render_buffer,
       data_dumper_->DumpWav("aec3_coarse_filter_output", kBlockSize,
                             &e_coarse[0], 16000, 1);
     }
-  }
+  });
 }
 
 void Subtractor::FilterMisadjustmentEstimator::Update(
@@ -58,6 +58,9 @@ class VectorMath {
           x[j] = sqrtf(x[j]);
         }
       } break;
+      case Aec3Optimization::kAvx2:
+        SqrtAVX2(x);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -133,6 +136,9 @@ class VectorMath {
           z[j] = x[j] * y[j];
         }
       } break;
+      case Aec3Optimization::kAvx2:
+        MultiplyAVX2(x, y, z);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -179,6 +185,9 @@ class VectorMath {
           z[j] += x[j];
         }
       } break;
+      case Aec3Optimization::kAvx2:
+        AccumulateAVX2(x, z);
+        break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
       case Aec3Optimization::kNeon: {
@@ -205,6 +214,14 @@ class VectorMath {
   }
 
  private:
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  void SqrtAVX2(rtc::ArrayView<float> x);
+  void MultiplyAVX2(rtc::ArrayView<const float> x,
+                    rtc::ArrayView<const float> y,
+                    rtc::ArrayView<float> z);
+  void AccumulateAVX2(rtc::ArrayView<const float> x, rtc::ArrayView<float> z);
+#endif
+
   Aec3Optimization optimization_;
 };
 
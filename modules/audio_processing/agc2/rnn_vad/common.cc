@@ -18,7 +18,9 @@ namespace rnn_vad {
 
 Optimization DetectOptimization() {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    return Optimization::kAvx2;
+  } else if (WebRtc_GetCPUInfo(kSSE2) != 0) {
     return Optimization::kSse2;
   }
 #endif
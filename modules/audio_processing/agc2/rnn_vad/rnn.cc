@@ -29,6 +29,10 @@
 #include "third_party/rnnoise/src/rnn_activations.h"
 #include "third_party/rnnoise/src/rnn_vad_weights.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/audio_processing/agc2/rnn_vad/rnn_avx2.h"
+#endif
+
 namespace webrtc {
 namespace rnn_vad {
 namespace {
@@ -261,8 +265,119 @@ void ComputeFullyConnectedLayerOutputSse2(
                            bias[o] + v[0] + v[1] + v[2] + v[3]));
   }
 }
+
+// Dot product SSE2 implementation.
+float DotProductSse2(const float* x, const float* y, size_t size) {
+  __m128 sum = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+  }
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  float result = _mm_cvtss_f32(sum);
+  for (; i < size; ++i) {
+    result += x[i] * y[i];
+  }
+  return result;
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// Dot product NEON implementation.
+float DotProductNeon(const float* x, const float* y, size_t size) {
+  float32x4_t sum = vdupq_n_f32(0.f);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    sum = vmlaq_f32(sum, vld1q_f32(x + i), vld1q_f32(y + i));
+  }
+  const float32x2_t sum_2 = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  float result = vget_lane_f32(vpadd_f32(sum_2, sum_2), 0);
+  for (; i < size; ++i) {
+    result += x[i] * y[i];
+  }
+  return result;
+}
 #endif
 
+using DotProductFunction = float (*)(const float*, const float*, size_t);
+
+// Fully connected layer implementation that computes each output with one call
+// to the vectorized |dot_product|.
+void ComputeFullyConnectedLayerOutputVectorized(
+    DotProductFunction dot_product,
+    size_t input_size,
+    size_t output_size,
+    rtc::ArrayView<const float> input,
+    rtc::ArrayView<const float> bias,
+    rtc::ArrayView<const float> weights,
+    rtc::FunctionView<float(float)> activation_function,
+    rtc::ArrayView<float> output) {
+  RTC_DCHECK_EQ(input.size(), input_size);
+  RTC_DCHECK_EQ(bias.size(), output_size);
+  RTC_DCHECK_EQ(weights.size(), input_size * output_size);
+  for (size_t o = 0; o < output_size; ++o) {
+    output[o] = activation_function(
+        bias[o] +
+        dot_product(input.data(), weights.data() + o * input_size, input_size));
+  }
+}
+
+// Gated recurrent unit (GRU) layer implementation that computes the gates
+// with the vectorized |dot_product|. Unlike ComputeGruLayerOutput(), the
+// reset gate is applied to the state before it is multiplied by the recurrent
+// weights of the output gate.
+void ComputeGruLayerOutputVectorized(
+    DotProductFunction dot_product,
+    size_t input_size,
+    size_t output_size,
+    rtc::ArrayView<const float> input,
+    rtc::ArrayView<const float> weights,
+    rtc::ArrayView<const float> recurrent_weights,
+    rtc::ArrayView<const float> bias,
+    rtc::ArrayView<float> state) {
+  RTC_DCHECK_EQ(input_size, input.size());
+  // Stride and offset used to read parameter arrays.
+  const size_t stride_in = input_size * output_size;
+  const size_t stride_out = output_size * output_size;
+  const float* const w = weights.data();
+  const float* const rw = recurrent_weights.data();
+
+  // Update and reset gates.
+  std::array<float, kRecurrentLayersMaxUnits> update;
+  std::array<float, kRecurrentLayersMaxUnits> reset;
+  for (size_t o = 0; o < output_size; ++o) {
+    update[o] = SigmoidApproximated(
+        bias[o] + dot_product(input.data(), w + o * input_size, input_size) +
+        dot_product(state.data(), rw + o * output_size, output_size));
+    reset[o] = SigmoidApproximated(
+        bias[output_size + o] +
+        dot_product(input.data(), w + stride_in + o * input_size, input_size) +
+        dot_product(state.data(), rw + stride_out + o * output_size,
+                    output_size));
+  }
+
+  // Output gate.
+  std::array<float, kRecurrentLayersMaxUnits> reset_state;
+  for (size_t s = 0; s < output_size; ++s) {
+    reset_state[s] = state[s] * reset[s];
+  }
+  std::array<float, kRecurrentLayersMaxUnits> output;
+  for (size_t o = 0; o < output_size; ++o) {
+    output[o] = RectifiedLinearUnit(
+        bias[2 * output_size + o] +
+        dot_product(input.data(), w + 2 * stride_in + o * input_size,
+                    input_size) +
+        dot_product(reset_state.data(), rw + 2 * stride_out + o * output_size,
+                    output_size));
+  }
+
+  // Update output through the update gates and update the state.
+  for (size_t o = 0; o < output_size; ++o) {
+    state[o] = update[o] * state[o] + (1.f - update[o]) * output[o];
+  }
+}
+
 }  // namespace
 
 FullyConnectedLayer::FullyConnectedLayer(
@@ -301,12 +416,17 @@ void FullyConnectedLayer::ComputeOutput(rtc::ArrayView<const float> input) {
                                            bias_, weights_,
                                            activation_function_, output_);
       break;
+    case Optimization::kAvx2:
+      ComputeFullyConnectedLayerOutputVectorized(
+          &DotProductAvx2, input_size_, output_size_, input, bias_, weights_,
+          activation_function_, output_);
+      break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Optimization::kNeon:
-      // TODO(bugs.chromium.org/10480): Handle Optimization::kNeon.
-      ComputeFullyConnectedLayerOutput(input_size_, output_size_, input, bias_,
-                                       weights_, activation_function_, output_);
+      ComputeFullyConnectedLayerOutputVectorized(
+          &DotProductNeon, input_size_, output_size_, input, bias_, weights_,
+          activation_function_, output_);
       break;
 #endif
     default:
@@ -354,24 +474,35 @@ void GatedRecurrentLayer::Reset() {
 }
 
 void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
+  ComputeOutput(input, state_);
+}
+
+void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input,
+                                        rtc::ArrayView<float> state) const {
+  RTC_DCHECK_GE(state.size(), output_size_);
   switch (optimization_) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
     case Optimization::kSse2:
-      // TODO(bugs.chromium.org/10480): Handle Optimization::kSse2.
-      ComputeGruLayerOutput(input_size_, output_size_, input, weights_,
-                            recurrent_weights_, bias_, state_);
+      ComputeGruLayerOutputVectorized(&DotProductSse2, input_size_,
+                                      output_size_, input, weights_,
+                                      recurrent_weights_, bias_, state);
+      break;
+    case Optimization::kAvx2:
+      ComputeGruLayerOutputVectorized(&DotProductAvx2, input_size_,
+                                      output_size_, input, weights_,
+                                      recurrent_weights_, bias_, state);
       break;
 #endif
 #if defined(WEBRTC_HAS_NEON)
     case Optimization::kNeon:
-      // TODO(bugs.chromium.org/10480): Handle Optimization::kNeon.
-      ComputeGruLayerOutput(input_size_, output_size_, input, weights_,
-                            recurrent_weights_, bias_, state_);
+      ComputeGruLayerOutputVectorized(&DotProductNeon, input_size_,
+                                      output_size_, input, weights_,
+                                      recurrent_weights_, bias_, state);
       break;
 #endif
     default:
       ComputeGruLayerOutput(input_size_, output_size_, input, weights_,
-                            recurrent_weights_, bias_, state_);
+                            recurrent_weights_, bias_, state);
   }
 }
 
@@ -421,5 +552,68 @@ float RnnBasedVad::ComputeVadProbability(
   return vad_output[0];
 }
 
+BatchedRnnBasedVad::BatchedRnnBasedVad(size_t num_vads)
+    : input_layer_(kInputLayerInputSize,
+                   kInputLayerOutputSize,
+                   kInputDenseBias,
+                   kInputDenseWeights,
+                   TansigApproximated,
+                   DetectOptimization()),
+      hidden_layer_(kInputLayerOutputSize,
+                    kHiddenLayerOutputSize,
+                    kHiddenGruBias,
+                    kHiddenGruWeights,
+                    kHiddenGruRecurrentWeights,
+                    DetectOptimization()),
+      output_layer_(kHiddenLayerOutputSize,
+                    kOutputLayerOutputSize,
+                    kOutputDenseBias,
+                    kOutputDenseWeights,
+                    SigmoidApproximated,
+                    DetectOptimization()),
+      hidden_states_(num_vads) {
+  for (size_t i = 0; i < num_vads; ++i) {
+    Reset(i);
+  }
+}
+
+BatchedRnnBasedVad::~BatchedRnnBasedVad() = default;
+
+void BatchedRnnBasedVad::AddVad() {
+  hidden_states_.emplace_back();
+  hidden_states_.back().fill(0.f);
+}
+
+void BatchedRnnBasedVad::RemoveVad(size_t vad_index) {
+  RTC_DCHECK_LT(vad_index, hidden_states_.size());
+  hidden_states_[vad_index] = hidden_states_.back();
+  hidden_states_.pop_back();
+}
+
+void BatchedRnnBasedVad::Reset(size_t vad_index) {
+  RTC_DCHECK_LT(vad_index, hidden_states_.size());
+  hidden_states_[vad_index].fill(0.f);
+}
+
+void BatchedRnnBasedVad::ComputeVadProbabilities(
+    rtc::ArrayView<const Input> inputs,
+    rtc::ArrayView<float> vad_probabilities) {
+  RTC_DCHECK_EQ(inputs.size(), hidden_states_.size());
+  RTC_DCHECK_EQ(vad_probabilities.size(), hidden_states_.size());
+  for (size_t i = 0; i < hidden_states_.size(); ++i) {
+    if (inputs[i].is_silence) {
+      Reset(i);
+      vad_probabilities[i] = 0.f;
+      continue;
+    }
+    rtc::ArrayView<const float> hidden_output(hidden_states_[i].data(),
+                                              hidden_layer_.output_size());
+    input_layer_.ComputeOutput(inputs[i].feature_vector);
+    hidden_layer_.ComputeOutput(input_layer_.GetOutput(), hidden_states_[i]);
+    output_layer_.ComputeOutput(hidden_output);
+    vad_probabilities[i] = output_layer_.GetOutput()[0];
+  }
+}
+
 }  // namespace rnn_vad
 }  // namespace webrtc
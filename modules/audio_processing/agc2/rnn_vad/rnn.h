@@ -88,6 +88,11 @@ class GatedRecurrentLayer {
   void Reset();
   // Computes the recurrent layer output and updates the status.
   void ComputeOutput(rtc::ArrayView<const float> input);
+  // Like ComputeOutput(input), but reads and updates |state| instead of the
+  // state of the layer, so that one layer can serve several networks. |state|
+  // must have at least output_size() elements and is also the output.
+  void ComputeOutput(rtc::ArrayView<const float> input,
+                     rtc::ArrayView<float> state) const;
 
  private:
   const size_t input_size_;
@@ -120,6 +125,42 @@ class RnnBasedVad {
   FullyConnectedLayer output_layer_;
 };
 
+// Runs the network of RnnBasedVad for many independent VADs, e.g. one per
+// received stream. The layer parameters are shared, so that only one copy of
+// them has to be kept in cache however many VADs there are. Each VAD gives the
+// same output as an RnnBasedVad fed with the same features.
+class BatchedRnnBasedVad {
+ public:
+  // Input of one VAD.
+  struct Input {
+    std::array<float, kFeatureVectorSize> feature_vector;
+    // If true, |feature_vector| is not read and the VAD is reset.
+    bool is_silence = true;
+  };
+
+  explicit BatchedRnnBasedVad(size_t num_vads);
+  BatchedRnnBasedVad(const BatchedRnnBasedVad&) = delete;
+  BatchedRnnBasedVad& operator=(const BatchedRnnBasedVad&) = delete;
+  ~BatchedRnnBasedVad();
+  size_t num_vads() const { return hidden_states_.size(); }
+  // Adds a VAD in its initial state, with index num_vads() - 1.
+  void AddVad();
+  // Removes the VAD |vad_index|. The last VAD takes its index.
+  void RemoveVad(size_t vad_index);
+  void Reset(size_t vad_index);
+  // Computes the probability of voice (range: [0.0, 1.0]) of every VAD. The
+  // i-th VAD reads |inputs[i]| and writes |vad_probabilities[i]|. Both must
+  // have num_vads() elements.
+  void ComputeVadProbabilities(rtc::ArrayView<const Input> inputs,
+                               rtc::ArrayView<float> vad_probabilities);
+
+ private:
+  FullyConnectedLayer input_layer_;
+  const GatedRecurrentLayer hidden_layer_;
+  FullyConnectedLayer output_layer_;
+  std::vector<std::array<float, kRecurrentLayersMaxUnits>> hidden_states_;
+};
+
 }  // namespace rnn_vad
 }  // namespace webrtc
 
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/rnn_avx2.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+namespace rnn_vad {
+
+float DotProductAvx2(const float* x, const float* y, size_t size) {
+  __m256 sum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    sum = _mm256_add_ps(
+        sum, _mm256_mul_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  }
+  __m128 sum_128 =
+      _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  if (i + 4 <= size) {
+    sum_128 = _mm_add_ps(sum_128,
+                         _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    i += 4;
+  }
+  sum_128 = _mm_add_ps(sum_128, _mm_movehl_ps(sum_128, sum_128));
+  sum_128 = _mm_add_ss(sum_128, _mm_shuffle_ps(sum_128, sum_128, 1));
+  float result = _mm_cvtss_f32(sum_128);
+  for (; i < size; ++i) {
+    result += x[i] * y[i];
+  }
+  return result;
+}
+
+}  // namespace rnn_vad
+}  // namespace webrtc
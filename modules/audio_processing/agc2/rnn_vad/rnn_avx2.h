@@ -0,0 +1,26 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_RNN_AVX2_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_RNN_AVX2_H_
+
+#include <stddef.h>
+
+namespace webrtc {
+namespace rnn_vad {
+
+// Returns the dot product of the |size| elements of |x| and |y|. Must only be
+// called on CPUs that support AVX2.
+float DotProductAvx2(const float* x, const float* y, size_t size);
+
+}  // namespace rnn_vad
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_RNN_AVX2_H_
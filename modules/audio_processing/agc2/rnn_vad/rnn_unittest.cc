@@ -136,6 +136,8 @@ std::string GetOptimizationName(Optimization optimization) {
   switch (optimization) {
     case Optimization::kSse2:
       return "SSE2";
+    case Optimization::kAvx2:
+      return "AVX2";
     case Optimization::kNeon:
       return "NEON";
     case Optimization::kNone:
@@ -197,8 +199,88 @@ TEST(RnnVadTest, CheckGatedRecurrentLayerSse2) {
   TestGatedRecurrentLayer(&gru, kGruInputSequence, kGruExpectedOutputSequence);
 }
 
+// Like CheckFullyConnectedLayerOutput, but testing the AVX2 implementation.
+TEST(RnnVadTest, CheckFullyConnectedLayerOutputAvx2) {
+  if (!IsOptimizationAvailable(Optimization::kAvx2)) {
+    return;
+  }
+
+  FullyConnectedLayer fc(rnnoise::kInputLayerInputSize,
+                         rnnoise::kInputLayerOutputSize,
+                         rnnoise::kInputDenseBias, rnnoise::kInputDenseWeights,
+                         rnnoise::TansigApproximated, Optimization::kAvx2);
+  TestFullyConnectedLayer(&fc, kFullyConnectedInputVector,
+                          kFullyConnectedExpectedOutput);
+}
+
+// Like CheckGatedRecurrentLayer, but testing the AVX2 implementation.
+TEST(RnnVadTest, CheckGatedRecurrentLayerAvx2) {
+  if (!IsOptimizationAvailable(Optimization::kAvx2)) {
+    return;
+  }
+
+  GatedRecurrentLayer gru(kGruInputSize, kGruOutputSize, kGruBias, kGruWeights,
+                          kGruRecurrentWeights, Optimization::kAvx2);
+  TestGatedRecurrentLayer(&gru, kGruInputSequence, kGruExpectedOutputSequence);
+}
+
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
+#if defined(WEBRTC_HAS_NEON)
+
+// Like CheckFullyConnectedLayerOutput, but testing the NEON implementation.
+TEST(RnnVadTest, CheckFullyConnectedLayerOutputNeon) {
+  FullyConnectedLayer fc(rnnoise::kInputLayerInputSize,
+                         rnnoise::kInputLayerOutputSize,
+                         rnnoise::kInputDenseBias, rnnoise::kInputDenseWeights,
+                         rnnoise::TansigApproximated, Optimization::kNeon);
+  TestFullyConnectedLayer(&fc, kFullyConnectedInputVector,
+                          kFullyConnectedExpectedOutput);
+}
+
+// Like CheckGatedRecurrentLayer, but testing the NEON implementation.
+TEST(RnnVadTest, CheckGatedRecurrentLayerNeon) {
+  GatedRecurrentLayer gru(kGruInputSize, kGruOutputSize, kGruBias, kGruWeights,
+                          kGruRecurrentWeights, Optimization::kNeon);
+  TestGatedRecurrentLayer(&gru, kGruInputSequence, kGruExpectedOutputSequence);
+}
+
+#endif  // WEBRTC_HAS_NEON
+
+// Checks that each VAD of a batch gives the same output as a VAD of its own,
+// including when some of them are reset by silence.
+TEST(RnnVadTest, BatchedVadMatchesSingleVads) {
+  constexpr size_t kNumVads = 3;
+  constexpr size_t kNumFrames = 20;
+  BatchedRnnBasedVad batched_vad(kNumVads);
+  ASSERT_EQ(kNumVads, batched_vad.num_vads());
+  std::vector<std::unique_ptr<RnnBasedVad>> vads;
+  for (size_t i = 0; i < kNumVads; ++i) {
+    vads.push_back(std::make_unique<RnnBasedVad>());
+  }
+
+  std::array<BatchedRnnBasedVad::Input, kNumVads> inputs;
+  std::array<float, kNumVads> vad_probabilities;
+  for (size_t frame = 0; frame < kNumFrames; ++frame) {
+    SCOPED_TRACE(frame);
+    for (size_t i = 0; i < kNumVads; ++i) {
+      // Different features for every VAD and frame.
+      for (size_t j = 0; j < kFeatureVectorSize; ++j) {
+        inputs[i].feature_vector[j] = kFullyConnectedInputVector[j] *
+                                      (1.f - 0.1f * i) *
+                                      (frame % 2 ? .5f : 1.f);
+      }
+      inputs[i].is_silence = (frame + i) % 7 == 0;
+    }
+    batched_vad.ComputeVadProbabilities(inputs, vad_probabilities);
+    for (size_t i = 0; i < kNumVads; ++i) {
+      EXPECT_EQ(vads[i]->ComputeVadProbability(inputs[i].feature_vector,
+                                               inputs[i].is_silence),
+                vad_probabilities[i]);
+    }
+  }
+}
+
 TEST(RnnVadTest, DISABLED_BenchmarkFullyConnectedLayer) {
   std::vector<std::unique_ptr<FullyConnectedLayer>> implementations;
   implementations.emplace_back(std::make_unique<FullyConnectedLayer>(
@@ -211,6 +293,18 @@ TEST(RnnVadTest, DISABLED_BenchmarkFullyConnectedLayer) {
         rnnoise::kInputDenseBias, rnnoise::kInputDenseWeights,
         rnnoise::TansigApproximated, Optimization::kSse2));
   }
+  if (IsOptimizationAvailable(Optimization::kAvx2)) {
+    implementations.emplace_back(std::make_unique<FullyConnectedLayer>(
+        rnnoise::kInputLayerInputSize, rnnoise::kInputLayerOutputSize,
+        rnnoise::kInputDenseBias, rnnoise::kInputDenseWeights,
+        rnnoise::TansigApproximated, Optimization::kAvx2));
+  }
+  if (IsOptimizationAvailable(Optimization::kNeon)) {
+    implementations.emplace_back(std::make_unique<FullyConnectedLayer>(
+        rnnoise::kInputLayerInputSize, rnnoise::kInputLayerOutputSize,
+        rnnoise::kInputDenseBias, rnnoise::kInputDenseWeights,
+        rnnoise::TansigApproximated, Optimization::kNeon));
+  }
 
   std::vector<Result> results;
   constexpr size_t number_of_tests = 10000;
@@ -237,6 +331,14 @@ TEST(RnnVadTest, DISABLED_BenchmarkGatedRecurrentLayer) {
   implementations.emplace_back(std::make_unique<GatedRecurrentLayer>(
       kGruInputSize, kGruOutputSize, kGruBias, kGruWeights,
       kGruRecurrentWeights, Optimization::kNone));
+  for (Optimization optimization :
+       {Optimization::kSse2, Optimization::kAvx2, Optimization::kNeon}) {
+    if (IsOptimizationAvailable(optimization)) {
+      implementations.emplace_back(std::make_unique<GatedRecurrentLayer>(
+          kGruInputSize, kGruOutputSize, kGruBias, kGruWeights,
+          kGruRecurrentWeights, optimization));
+    }
+  }
 
   rtc::ArrayView<const float> input_sequence(kGruInputSequence);
   static_assert(kGruInputSequence.size() % kGruInputSize == 0, "");
@@ -267,6 +369,72 @@ TEST(RnnVadTest, DISABLED_BenchmarkGatedRecurrentLayer) {
   }
 }
 
+// Checks that the last VAD of a batch keeps its state when it takes the index
+// of a removed VAD, and that added VADs start from the initial state.
+TEST(RnnVadTest, BatchedVadKeepsStateWhenAddingAndRemovingVads) {
+  BatchedRnnBasedVad batched_vad(2);
+  RnnBasedVad last_vad;
+  RnnBasedVad added_vad;
+  std::array<BatchedRnnBasedVad::Input, 2> inputs;
+  for (auto& input : inputs) {
+    input.feature_vector = kFullyConnectedInputVector;
+    input.is_silence = false;
+  }
+  std::array<float, 2> vad_probabilities;
+  for (int frame = 0; frame < 5; ++frame) {
+    batched_vad.ComputeVadProbabilities(inputs, vad_probabilities);
+    last_vad.ComputeVadProbability(kFullyConnectedInputVector, false);
+  }
+
+  batched_vad.RemoveVad(0);
+  batched_vad.AddVad();
+  ASSERT_EQ(2u, batched_vad.num_vads());
+  batched_vad.ComputeVadProbabilities(inputs, vad_probabilities);
+  EXPECT_EQ(last_vad.ComputeVadProbability(kFullyConnectedInputVector, false),
+            vad_probabilities[0]);
+  EXPECT_EQ(added_vad.ComputeVadProbability(kFullyConnectedInputVector, false),
+            vad_probabilities[1]);
+}
+
+// Compares running many VADs one after the other with running them as a batch.
+TEST(RnnVadTest, DISABLED_BenchmarkBatchedVad) {
+  constexpr size_t kNumVads = 500;
+  constexpr size_t number_of_tests = 1000;
+  std::vector<std::unique_ptr<RnnBasedVad>> vads;
+  for (size_t i = 0; i < kNumVads; ++i) {
+    vads.push_back(std::make_unique<RnnBasedVad>());
+  }
+  BatchedRnnBasedVad batched_vad(kNumVads);
+  std::vector<BatchedRnnBasedVad::Input> inputs(
+      kNumVads, {kFullyConnectedInputVector, false});
+  std::vector<float> vad_probabilities(kNumVads);
+
+  ::webrtc::test::PerformanceTimer single_timer(number_of_tests);
+  for (size_t k = 0; k < number_of_tests; ++k) {
+    single_timer.StartTimer();
+    for (size_t i = 0; i < kNumVads; ++i) {
+      vad_probabilities[i] =
+          vads[i]->ComputeVadProbability(inputs[i].feature_vector, false);
+    }
+    single_timer.StopTimer();
+  }
+
+  ::webrtc::test::PerformanceTimer batched_timer(number_of_tests);
+  for (size_t k = 0; k < number_of_tests; ++k) {
+    batched_timer.StartTimer();
+    batched_vad.ComputeVadProbabilities(inputs, vad_probabilities);
+    batched_timer.StopTimer();
+  }
+
+  RTC_LOG(LS_INFO) << kNumVads << " single VADs: "
+                   << (single_timer.GetDurationAverage() / 1e3) << " +/- "
+                   << (single_timer.GetDurationStandardDeviation() / 1e3)
+                   << " ms, batched: "
+                   << (batched_timer.GetDurationAverage() / 1e3) << " +/- "
+                   << (batched_timer.GetDurationStandardDeviation() / 1e3)
+                   << " ms";
+}
+
 }  // namespace test
 }  // namespace rnn_vad
 }  // namespace webrtc
@@ -0,0 +1,234 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/speech_activity_ranker.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/include/push_resampler.h"
+#include "common_audio/vad/include/vad.h"
+#include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "modules/audio_processing/agc2/rnn_vad/features_extraction.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// Frames in a row that WebRtcVad must find passive before the analysis of a
+// stream stops.
+constexpr int kHangoverFrames = 30;
+// Weight of the past in the smoothed activity, per 10 ms.
+constexpr float kProbabilitySmoothing = 0.95f;
+constexpr float kLevelSmoothing = 0.9f;
+// Smoothed probability above which a stream is considered to be speaking, and
+// probability of a frame above which the frame updates the speech level.
+constexpr float kSpeechProbabilityThreshold = 0.5f;
+
+bool IsWebRtcVadRate(int sample_rate_hz) {
+  return sample_rate_hz == 8000 || sample_rate_hz == 16000 ||
+         sample_rate_hz == 32000 || sample_rate_hz == 48000;
+}
+
+}  // namespace
+
+struct SpeechActivityRanker::Stream {
+  explicit Stream(uint32_t ssrc)
+      : ssrc(ssrc), vad(CreateVad(Vad::kVadNormal)) {}
+
+  const uint32_t ssrc;
+  const std::unique_ptr<Vad> vad;
+  PushResampler<float> resampler;
+  rnn_vad::FeaturesExtractor features_extractor;
+  int num_passive_frames = kHangoverFrames;
+  // What the stream got since the last Process().
+  bool got_frame = false;
+  float frame_level_dbfs = kMinLevelDbfs;
+  absl::optional<float> rtp_level_dbfs;
+  bool rtp_voice_activity = false;
+  StreamActivity activity;
+};
+
+SpeechActivityRanker::SpeechActivityRanker() : rnn_vad_(0) {}
+
+SpeechActivityRanker::~SpeechActivityRanker() = default;
+
+void SpeechActivityRanker::AddStream(uint32_t ssrc) {
+  rtc::CritScope cs(&lock_);
+  RTC_DCHECK(stream_indices_.find(ssrc) == stream_indices_.end());
+  stream_indices_[ssrc] = streams_.size();
+  streams_.push_back(std::make_unique<Stream>(ssrc));
+  rnn_vad_.AddVad();
+  rnn_vad_inputs_.emplace_back();
+  speech_probabilities_.push_back(0.f);
+}
+
+void SpeechActivityRanker::RemoveStream(uint32_t ssrc) {
+  rtc::CritScope cs(&lock_);
+  auto it = stream_indices_.find(ssrc);
+  RTC_DCHECK(it != stream_indices_.end());
+  if (it == stream_indices_.end())
+    return;
+  // The last stream takes the index of the removed one, as in |rnn_vad_|.
+  const size_t index = it->second;
+  stream_indices_.erase(it);
+  if (index != streams_.size() - 1) {
+    streams_[index] = std::move(streams_.back());
+    rnn_vad_inputs_[index] = rnn_vad_inputs_.back();
+    stream_indices_[streams_[index]->ssrc] = index;
+  }
+  streams_.pop_back();
+  rnn_vad_inputs_.pop_back();
+  speech_probabilities_.pop_back();
+  rnn_vad_.RemoveVad(index);
+}
+
+void SpeechActivityRanker::OnAudioFrame(uint32_t ssrc,
+                                        const AudioFrame& frame,
+                                        bool muted) {
+  rtc::CritScope cs(&lock_);
+  auto it = stream_indices_.find(ssrc);
+  if (it == stream_indices_.end())
+    return;
+  Stream& stream = *streams_[it->second];
+  rnn_vad::BatchedRnnBasedVad::Input& rnn_vad_input =
+      rnn_vad_inputs_[it->second];
+  stream.got_frame = true;
+  stream.frame_level_dbfs = kMinLevelDbfs;
+  rnn_vad_input.is_silence = true;
+
+  const size_t num_samples = frame.samples_per_channel_;
+  const int sample_rate_hz = frame.sample_rate_hz_;
+  if (muted || num_samples == 0 ||
+      static_cast<size_t>(sample_rate_hz / 100) != num_samples) {
+    stream.num_passive_frames =
+        std::min(stream.num_passive_frames + 1, kHangoverFrames);
+    return;
+  }
+
+  // The first channel, and its level.
+  std::array<int16_t, AudioFrame::kMaxDataSizeSamples> mono;
+  const int16_t* const data = frame.data();
+  float energy = 0.f;
+  for (size_t i = 0; i < num_samples; ++i) {
+    mono[i] = data[i * frame.num_channels_];
+    energy += static_cast<float>(mono[i]) * mono[i];
+  }
+  stream.frame_level_dbfs =
+      FloatS16ToDbfs(std::sqrt(energy / static_cast<float>(num_samples)));
+
+  // WebRtcVad decides whether the frame is worth analyzing. Sample rates it
+  // does not support leave every frame to the RNN VAD.
+  const bool is_passive =
+      IsWebRtcVadRate(sample_rate_hz) &&
+      stream.vad->VoiceActivity(mono.data(), num_samples, sample_rate_hz) ==
+          Vad::kPassive;
+  if (!is_passive) {
+    stream.num_passive_frames = 0;
+  } else if (stream.num_passive_frames < kHangoverFrames &&
+             ++stream.num_passive_frames == kHangoverFrames) {
+    // The analysis stops; it restarts from scratch on the next active frame.
+    stream.features_extractor.Reset();
+  }
+  if (stream.num_passive_frames >= kHangoverFrames)
+    return;
+
+  std::array<float, AudioFrame::kMaxDataSizeSamples> mono_float;
+  std::copy(mono.begin(), mono.begin() + num_samples, mono_float.begin());
+  std::array<float, rnn_vad::kFrameSize10ms24kHz> frame_24khz;
+  stream.resampler.InitializeIfNeeded(sample_rate_hz,
+                                      rnn_vad::kSampleRate24kHz, 1);
+  stream.resampler.Resample(mono_float.data(), num_samples, frame_24khz.data(),
+                            frame_24khz.size());
+  rnn_vad_input.is_silence =
+      stream.features_extractor.CheckSilenceComputeFeatures(
+          frame_24khz, rnn_vad_input.feature_vector);
+}
+
+void SpeechActivityRanker::OnAudioLevel(uint32_t ssrc,
+                                        int level_dbov,
+                                        bool voice_activity) {
+  rtc::CritScope cs(&lock_);
+  auto it = stream_indices_.find(ssrc);
+  if (it == stream_indices_.end())
+    return;
+  Stream& stream = *streams_[it->second];
+  stream.rtp_level_dbfs = -static_cast<float>(std::min(
+      std::max(level_dbov, 0), static_cast<int>(-kMinLevelDbfs)));
+  stream.rtp_voice_activity = voice_activity;
+}
+
+void SpeechActivityRanker::Process() {
+  rtc::CritScope cs(&lock_);
+  rnn_vad_.ComputeVadProbabilities(rnn_vad_inputs_, speech_probabilities_);
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    Stream& stream = *streams_[i];
+    float speech_probability = 0.f;
+    absl::optional<float> level_dbfs;
+    if (stream.got_frame) {
+      speech_probability = speech_probabilities_[i];
+      level_dbfs = stream.frame_level_dbfs;
+    } else if (stream.rtp_level_dbfs) {
+      speech_probability = stream.rtp_voice_activity ? 1.f : 0.f;
+      level_dbfs = stream.rtp_level_dbfs;
+    }
+
+    StreamActivity& activity = stream.activity;
+    activity.speech_probability =
+        kProbabilitySmoothing * activity.speech_probability +
+        (1.f - kProbabilitySmoothing) * speech_probability;
+    if (level_dbfs && speech_probability > kSpeechProbabilityThreshold) {
+      activity.speech_level_dbfs =
+          kLevelSmoothing * activity.speech_level_dbfs +
+          (1.f - kLevelSmoothing) * *level_dbfs;
+    }
+
+    stream.got_frame = false;
+    stream.rtp_level_dbfs = absl::nullopt;
+    rnn_vad_inputs_[i].is_silence = true;
+  }
+}
+
+absl::optional<SpeechActivityRanker::StreamActivity>
+SpeechActivityRanker::GetActivity(uint32_t ssrc) const {
+  rtc::CritScope cs(&lock_);
+  auto it = stream_indices_.find(ssrc);
+  if (it == stream_indices_.end())
+    return absl::nullopt;
+  return streams_[it->second]->activity;
+}
+
+std::vector<uint32_t> SpeechActivityRanker::GetRanking() const {
+  rtc::CritScope cs(&lock_);
+  std::vector<const Stream*> ranked;
+  ranked.reserve(streams_.size());
+  for (const auto& stream : streams_)
+    ranked.push_back(stream.get());
+  std::sort(ranked.begin(), ranked.end(), [](const Stream* a, const Stream* b) {
+    const bool a_speaking =
+        a->activity.speech_probability > kSpeechProbabilityThreshold;
+    const bool b_speaking =
+        b->activity.speech_probability > kSpeechProbabilityThreshold;
+    if (a_speaking != b_speaking)
+      return a_speaking;
+    return a->activity.speech_level_dbfs > b->activity.speech_level_dbfs;
+  });
+  std::vector<uint32_t> ssrcs;
+  ssrcs.reserve(ranked.size());
+  for (const Stream* stream : ranked)
+    ssrcs.push_back(stream->ssrc);
+  return ssrcs;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AGC2_SPEECH_ACTIVITY_RANKER_H_
+#define MODULES_AUDIO_PROCESSING_AGC2_SPEECH_ACTIVITY_RANKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/audio/audio_frame.h"
+#include "modules/audio_processing/agc2/rnn_vad/rnn.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Tracks how actively each of many received audio streams is speaking, for
+// servers that rank active speakers without otherwise processing the received
+// audio. A stream is fed either its decoded audio, e.g. from a NetEqOutputSink,
+// or just the audio levels of its RTP packets. Decoded audio first goes through
+// WebRtcVad; only while that finds a stream active is the stream's audio
+// analyzed for the RNN VAD of AGC2, which Process() runs on all the streams as
+// one batch. Thread-safe.
+class SpeechActivityRanker {
+ public:
+  static constexpr float kMinLevelDbfs = -127.f;
+
+  struct StreamActivity {
+    // Smoothed probability of speech, in [0, 1].
+    float speech_probability = 0.f;
+    // Smoothed level of the speech.
+    float speech_level_dbfs = kMinLevelDbfs;
+  };
+
+  SpeechActivityRanker();
+  SpeechActivityRanker(const SpeechActivityRanker&) = delete;
+  SpeechActivityRanker& operator=(const SpeechActivityRanker&) = delete;
+  ~SpeechActivityRanker();
+
+  void AddStream(uint32_t ssrc);
+  void RemoveStream(uint32_t ssrc);
+
+  // Analyzes 10 ms of decoded audio of the stream |ssrc|. Only the first
+  // channel is used. If |muted|, the frame counts as silence.
+  void OnAudioFrame(uint32_t ssrc, const AudioFrame& frame, bool muted);
+  // Takes the audio level, in -dBov, and the voice activity flag of an RTP
+  // packet of the stream |ssrc|, as carried by the RFC 6464 header extension.
+  // Meant for streams that are not decoded: rounds in which the stream also
+  // got OnAudioFrame() use the decoded audio only.
+  void OnAudioLevel(uint32_t ssrc, int level_dbov, bool voice_activity);
+
+  // Updates the activity of all the streams with what they got since the last
+  // call, and should be called every 10 ms. Streams that got nothing count as
+  // silent.
+  void Process();
+
+  absl::optional<StreamActivity> GetActivity(uint32_t ssrc) const;
+  // Returns the SSRCs of all the streams, most active first: the streams
+  // likely to be speaking come before the others, and louder streams before
+  // quieter ones among each.
+  std::vector<uint32_t> GetRanking() const;
+
+ private:
+  struct Stream;
+
+  rtc::CriticalSection lock_;
+  // The streams, each at the index of its VAD in |rnn_vad_|.
+  std::vector<std::unique_ptr<Stream>> streams_ RTC_GUARDED_BY(lock_);
+  std::map<uint32_t, size_t> stream_indices_ RTC_GUARDED_BY(lock_);
+  rnn_vad::BatchedRnnBasedVad rnn_vad_ RTC_GUARDED_BY(lock_);
+  std::vector<rnn_vad::BatchedRnnBasedVad::Input> rnn_vad_inputs_
+      RTC_GUARDED_BY(lock_);
+  std::vector<float> speech_probabilities_ RTC_GUARDED_BY(lock_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AGC2_SPEECH_ACTIVITY_RANKER_H_
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/speech_activity_ranker.h"
+
+#include <cmath>
+#include <vector>
+
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr int kSampleRateHz = 48000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+
+void SetSineWave(float amplitude, int frame_index, AudioFrame* frame) {
+  frame->UpdateFrame(0, nullptr, kSamplesPerChannel, kSampleRateHz,
+                     AudioFrame::kNormalSpeech, AudioFrame::kVadUnknown, 1);
+  int16_t* data = frame->mutable_data();
+  for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+    const size_t t = frame_index * kSamplesPerChannel + i;
+    data[i] = static_cast<int16_t>(
+        amplitude * std::sin(2 * M_PI * 440.f * t / kSampleRateHz));
+  }
+}
+
+}  // namespace
+
+TEST(SpeechActivityRankerTest, TracksAddedStreamsOnly) {
+  SpeechActivityRanker ranker;
+  EXPECT_FALSE(ranker.GetActivity(1));
+  ranker.AddStream(1);
+  ASSERT_TRUE(ranker.GetActivity(1));
+  EXPECT_EQ(0.f, ranker.GetActivity(1)->speech_probability);
+  EXPECT_EQ(SpeechActivityRanker::kMinLevelDbfs,
+            ranker.GetActivity(1)->speech_level_dbfs);
+
+  // Input for unknown streams is ignored.
+  ranker.OnAudioLevel(2, 10, true);
+  ranker.Process();
+  EXPECT_FALSE(ranker.GetActivity(2));
+  EXPECT_THAT(ranker.GetRanking(), ElementsAre(1));
+
+  ranker.RemoveStream(1);
+  EXPECT_FALSE(ranker.GetActivity(1));
+  EXPECT_TRUE(ranker.GetRanking().empty());
+}
+
+TEST(SpeechActivityRankerTest, RanksSpeakingStreamsByLevel) {
+  SpeechActivityRanker ranker;
+  ranker.AddStream(1);
+  ranker.AddStream(2);
+  ranker.AddStream(3);
+  for (int i = 0; i < 100; ++i) {
+    ranker.OnAudioLevel(1, 30, true);
+    ranker.OnAudioLevel(2, 10, true);
+    // Loudest, but not speaking.
+    ranker.OnAudioLevel(3, 5, false);
+    ranker.Process();
+  }
+
+  EXPECT_THAT(ranker.GetRanking(), ElementsAre(2, 1, 3));
+  EXPECT_GT(ranker.GetActivity(1)->speech_probability, 0.9f);
+  EXPECT_NEAR(-30.f, ranker.GetActivity(1)->speech_level_dbfs, 0.1f);
+  EXPECT_NEAR(-10.f, ranker.GetActivity(2)->speech_level_dbfs, 0.1f);
+  EXPECT_LT(ranker.GetActivity(3)->speech_probability, 0.1f);
+}
+
+TEST(SpeechActivityRankerTest, ActivityDecaysWithoutInput) {
+  SpeechActivityRanker ranker;
+  ranker.AddStream(1);
+  for (int i = 0; i < 100; ++i) {
+    ranker.OnAudioLevel(1, 20, true);
+    ranker.Process();
+  }
+  const float speech_probability = ranker.GetActivity(1)->speech_probability;
+  for (int i = 0; i < 10; ++i)
+    ranker.Process();
+  EXPECT_LT(ranker.GetActivity(1)->speech_probability, speech_probability);
+}
+
+TEST(SpeechActivityRankerTest, RemovingStreamKeepsActivityOfOthers) {
+  SpeechActivityRanker ranker;
+  ranker.AddStream(1);
+  ranker.AddStream(2);
+  ranker.AddStream(3);
+  for (int i = 0; i < 100; ++i) {
+    ranker.OnAudioLevel(2, 20, true);
+    ranker.OnAudioLevel(3, 10, true);
+    ranker.Process();
+  }
+  const SpeechActivityRanker::StreamActivity activity =
+      *ranker.GetActivity(3);
+
+  ranker.RemoveStream(1);
+  EXPECT_EQ(activity.speech_probability,
+            ranker.GetActivity(3)->speech_probability);
+  EXPECT_EQ(activity.speech_level_dbfs,
+            ranker.GetActivity(3)->speech_level_dbfs);
+  EXPECT_THAT(ranker.GetRanking(), ElementsAre(3, 2));
+}
+
+TEST(SpeechActivityRankerTest, DecodedSilenceIsNotSpeech) {
+  SpeechActivityRanker ranker;
+  ranker.AddStream(1);
+  ranker.AddStream(2);
+  AudioFrame frame;
+  for (int i = 0; i < 100; ++i) {
+    SetSineWave(0.f, i, &frame);
+    ranker.OnAudioFrame(1, frame, /*muted=*/false);
+    ranker.OnAudioFrame(2, frame, /*muted=*/true);
+    ranker.Process();
+  }
+  EXPECT_EQ(0.f, ranker.GetActivity(1)->speech_probability);
+  EXPECT_EQ(0.f, ranker.GetActivity(2)->speech_probability);
+}
+
+TEST(SpeechActivityRankerTest, AnalyzesDecodedAudio) {
+  SpeechActivityRanker ranker;
+  ranker.AddStream(1);
+  AudioFrame frame;
+  for (int i = 0; i < 100; ++i) {
+    SetSineWave(10000.f, i, &frame);
+    ranker.OnAudioFrame(1, frame, /*muted=*/false);
+    ranker.Process();
+  }
+  const SpeechActivityRanker::StreamActivity activity = *ranker.GetActivity(1);
+  EXPECT_GE(activity.speech_probability, 0.f);
+  EXPECT_LE(activity.speech_probability, 1.f);
+}
+
+}  // namespace webrtc
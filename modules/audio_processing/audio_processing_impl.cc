@@ -11,6 +11,7 @@
 #include "modules/audio_processing/audio_processing_impl.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -20,6 +21,7 @@
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/audio/audio_frame.h"
+#include "api/task_queue/default_task_queue_factory.h"
 #include "common_audio/audio_converter.h"
 #include "common_audio/include/audio_util.h"
 #include "modules/audio_processing/aec_dump/aec_dump_factory.h"
@@ -32,6 +34,8 @@
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructor_magic.h"
+#include "rtc_base/cpu_accounting.h"
+#include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ref_counted_object.h"
 #include "rtc_base/time_utils.h"
@@ -125,6 +129,54 @@ static const size_t kMaxAllowedValuesOfSamplesPerFrame = 480;
 // TODO(peah): Decrease this once we properly handle hugely unbalanced
 // reverse and forward call numbers.
 static const size_t kMaxNumFramesToBuffer = 100;
+
+// Sample rate of the linear AEC output.
+constexpr int kLinearOutputRateHz = 16000;
+
+// With |Config::Pipeline::skip_processing_in_silence|, the number of silent
+// frames before the capture processing is skipped, and how often it still runs
+// after that.
+constexpr int kSilentFramesBeforeSkipping = 50;
+constexpr int kSilentFrameProcessingInterval = 10;
+// Samples of at most this magnitude, about -90 dBFS, count as silence.
+constexpr float kSilenceThreshold = 1.f;
+
+bool IsSilent(const AudioBuffer& audio) {
+  for (size_t ch = 0; ch < audio.num_channels(); ++ch) {
+    const float* samples = audio.channels_const()[ch];
+    for (size_t i = 0; i < audio.num_frames(); ++i) {
+      if (std::fabs(samples[i]) > kSilenceThreshold) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void SetToZero(AudioBuffer* audio) {
+  for (size_t ch = 0; ch < audio->num_channels(); ++ch) {
+    std::fill_n(audio->channels()[ch], audio->num_frames(), 0.f);
+  }
+}
+
+// Copies the audio of |from|, both in full band and split into bands, to |to|,
+// which must have the same format. Unlike swapping the buffers, this keeps the
+// filter and resampler states of each buffer continuous.
+void CopyAudio(const AudioBuffer& from, AudioBuffer* to) {
+  RTC_DCHECK_EQ(from.num_frames(), to->num_frames());
+  RTC_DCHECK_EQ(from.num_bands(), to->num_bands());
+  to->set_num_channels(from.num_channels());
+  for (size_t ch = 0; ch < from.num_channels(); ++ch) {
+    std::copy_n(from.channels_const()[ch], from.num_frames(),
+                to->channels()[ch]);
+    if (from.num_bands() > 1) {
+      for (size_t band = 0; band < from.num_bands(); ++band) {
+        std::copy_n(from.split_bands_const(ch)[band],
+                    from.num_frames_per_band(), to->split_bands(ch)[band]);
+      }
+    }
+  }
+}
 }  // namespace
 
 // Throughout webrtc, it's assumed that success is represented by zero.
@@ -386,27 +438,18 @@ int AudioProcessingImpl::InitializeLocked() {
     render_.render_converter.reset(nullptr);
   }
 
-  capture_.capture_audio.reset(new AudioBuffer(
-      formats_.api_format.input_stream().sample_rate_hz(),
-      formats_.api_format.input_stream().num_channels(),
-      capture_nonlocked_.capture_processing_format.sample_rate_hz(),
-      formats_.api_format.output_stream().num_channels(),
-      formats_.api_format.output_stream().sample_rate_hz(),
-      formats_.api_format.output_stream().num_channels()));
+  capture_.capture_audio = CreateCaptureBuffer(
+      capture_nonlocked_.capture_processing_format.sample_rate_hz());
 
   if (capture_nonlocked_.capture_processing_format.sample_rate_hz() <
           formats_.api_format.output_stream().sample_rate_hz() &&
       formats_.api_format.output_stream().sample_rate_hz() == 48000) {
-    capture_.capture_fullband_audio.reset(
-        new AudioBuffer(formats_.api_format.input_stream().sample_rate_hz(),
-                        formats_.api_format.input_stream().num_channels(),
-                        formats_.api_format.output_stream().sample_rate_hz(),
-                        formats_.api_format.output_stream().num_channels(),
-                        formats_.api_format.output_stream().sample_rate_hz(),
-                        formats_.api_format.output_stream().num_channels()));
+    capture_.capture_fullband_audio = CreateCaptureBuffer(
+        formats_.api_format.output_stream().sample_rate_hz());
   } else {
     capture_.capture_fullband_audio.reset();
   }
+  capture_.pipelined_frame = ApmCaptureState::PipelinedFrame();
 
   AllocateRenderQueue();
 
@@ -535,7 +578,9 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
       config_.pipeline.multi_channel_capture !=
           config.pipeline.multi_channel_capture ||
       config_.pipeline.maximum_internal_processing_rate !=
-          config.pipeline.maximum_internal_processing_rate;
+          config.pipeline.maximum_internal_processing_rate ||
+      config_.pipeline.pipelined_capture_processing !=
+          config.pipeline.pipelined_capture_processing;
 
   const bool aec_config_changed =
       config_.echo_canceller.enabled != config.echo_canceller.enabled ||
@@ -631,6 +676,14 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
     InitializeVoiceDetector();
   }
 
+  if (!config_.pipeline.pipelined_capture_processing) {
+    capture_pipeline_queue_.reset();
+  } else if (!capture_pipeline_queue_) {
+    capture_pipeline_queue_ = std::make_unique<rtc::TaskQueue>(
+        CreateDefaultTaskQueueFactory()->CreateTaskQueue(
+            "ApmCapturePipeline", TaskQueueFactory::Priority::HIGH));
+  }
+
   // Reinitialization must happen after all submodule configuration to avoid
   // additional reinitializations on the next capture / render processing call.
   if (pipeline_config_changed) {
@@ -779,6 +832,7 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
                                        const StreamConfig& output_config,
                                        float* const* dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessStream_StreamConfig");
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kAudioProcessing);
   if (!src || !dest) {
     return kNullPointerError;
   }
@@ -1021,6 +1075,7 @@ int AudioProcessingImpl::ProcessStream(const int16_t* const src,
                                        const StreamConfig& output_config,
                                        int16_t* const dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessStream_AudioFrame");
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kAudioProcessing);
   RETURN_ON_ERR(MaybeInitializeCapture(input_config, output_config));
 
   rtc::CritScope cs_capture(&crit_capture_);
@@ -1060,9 +1115,188 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   RTC_DCHECK_LE(
       !!submodules_.echo_controller + !!submodules_.echo_control_mobile, 1);
 
-  AudioBuffer* capture_buffer = capture_.capture_audio.get();  // For brevity.
-  AudioBuffer* linear_aec_buffer = capture_.linear_aec_output.get();
+  if (SkipCaptureProcessingInSilence()) {
+    SetToZero(capture_.capture_audio.get());
+    if (capture_.capture_fullband_audio) {
+      SetToZero(capture_.capture_fullband_audio.get());
+    }
+    // The pending frame, if any, is silence too.
+    capture_.pipelined_frame.pending = false;
+    if (capture_.stats.voice_detected) {
+      capture_.stats.voice_detected = false;
+    }
+    stats_reporter_.UpdateStatistics(capture_.stats);
+    capture_.was_stream_delay_set = false;
+    return kNoError;
+  }
+
+  const bool log_rms = ++capture_rms_interval_counter_ >= 1000;
+  if (log_rms) {
+    capture_rms_interval_counter_ = 0;
+  }
 
+  if (CapturePipeliningActive()) {
+    RETURN_ON_ERR(ProcessCaptureStreamPipelinedLocked(log_rms));
+  } else {
+    capture_.pipelined_frame.pending = false;
+    AudioBuffer* capture_buffer = capture_.capture_audio.get();
+    AudioBuffer* linear_aec_buffer = capture_.linear_aec_output.get();
+    const int64_t start_time_us = rtc::TimeMicros();
+    RETURN_ON_ERR(ProcessCaptureEchoStageLocked(
+        capture_buffer, linear_aec_buffer, /*pipelined=*/false, log_rms));
+    const bool ec_active = submodules_.echo_controller
+                               ? submodules_.echo_controller->ActiveProcessing()
+                               : false;
+    const int64_t echo_stage_end_time_us = rtc::TimeMicros();
+    RETURN_ON_ERR(ProcessCapturePostEchoStageLocked(
+        capture_buffer, capture_.capture_fullband_audio.get(),
+        linear_aec_buffer, ec_active, /*pipelined=*/false, log_rms));
+    capture_.stats.echo_stage_processing_time_us =
+        static_cast<int>(echo_stage_end_time_us - start_time_us);
+    capture_.stats.post_echo_stage_processing_time_us =
+        static_cast<int>(rtc::TimeMicros() - echo_stage_end_time_us);
+  }
+
+  // Compute echo-related stats.
+  if (submodules_.echo_controller) {
+    auto ec_metrics = submodules_.echo_controller->GetMetrics();
+    capture_.stats.echo_return_loss = ec_metrics.echo_return_loss;
+    capture_.stats.echo_return_loss_enhancement =
+        ec_metrics.echo_return_loss_enhancement;
+    capture_.stats.delay_ms = ec_metrics.delay_ms;
+  }
+  if (config_.residual_echo_detector.enabled) {
+    RTC_DCHECK(submodules_.echo_detector);
+    auto ed_metrics = submodules_.echo_detector->GetMetrics();
+    capture_.stats.residual_echo_likelihood = ed_metrics.echo_likelihood;
+    capture_.stats.residual_echo_likelihood_recent_max =
+        ed_metrics.echo_likelihood_recent_max;
+  }
+
+  // Pass stats for reporting.
+  stats_reporter_.UpdateStatistics(capture_.stats);
+
+  capture_.was_stream_delay_set = false;
+  return kNoError;
+}
+
+bool AudioProcessingImpl::SkipCaptureProcessingInSilence() {
+  if (!config_.pipeline.skip_processing_in_silence ||
+      submodules_.gain_control || submodules_.agc_manager ||
+      !render_silent_.load(std::memory_order_relaxed) ||
+      !IsSilent(*capture_.capture_audio)) {
+    capture_silent_frames_ = 0;
+    return false;
+  }
+  if (++capture_silent_frames_ <= kSilentFramesBeforeSkipping) {
+    return false;
+  }
+  if (capture_silent_frames_ ==
+      kSilentFramesBeforeSkipping + kSilentFrameProcessingInterval) {
+    capture_silent_frames_ = kSilentFramesBeforeSkipping;
+    return false;
+  }
+  return true;
+}
+
+bool AudioProcessingImpl::CapturePipeliningActive() const {
+  return capture_pipeline_queue_ && submodules_.echo_controller &&
+         !submodules_.echo_control_mobile && !submodules_.gain_control &&
+         !submodules_.agc_manager && !submodules_.transient_suppressor;
+}
+
+int AudioProcessingImpl::ProcessCaptureStreamPipelinedLocked(bool log_rms) {
+  ApmCaptureState::PipelinedFrame& frame = capture_.pipelined_frame;
+  if (!frame.capture_audio) {
+    const int capture_rate_hz =
+        capture_nonlocked_.capture_processing_format.sample_rate_hz();
+    frame.echo_stage_audio = CreateCaptureBuffer(capture_rate_hz);
+    frame.capture_audio = CreateCaptureBuffer(capture_rate_hz);
+    if (capture_.capture_fullband_audio) {
+      const int fullband_rate_hz =
+          formats_.api_format.output_stream().sample_rate_hz();
+      frame.echo_stage_fullband_audio = CreateCaptureBuffer(fullband_rate_hz);
+      frame.capture_fullband_audio = CreateCaptureBuffer(fullband_rate_hz);
+    }
+    if (capture_.linear_aec_output) {
+      frame.linear_aec_output = CreateLinearAecOutputBuffer();
+    }
+  }
+
+  // The buffers of |capture_| always take the input and do the echo stage,
+  // and those of |frame| always do the post-echo stage, so that each of them
+  // sees consecutive frames.
+  rtc::Event post_echo_stage_done;
+  int post_echo_stage_result = kNoError;
+  if (frame.pending) {
+    CopyAudio(*frame.echo_stage_audio, frame.capture_audio.get());
+    if (frame.capture_fullband_audio) {
+      CopyAudio(*frame.echo_stage_fullband_audio,
+                frame.capture_fullband_audio.get());
+    }
+    capture_pipeline_queue_->PostTask([&] {
+      post_echo_stage_result = ProcessPipelinedFramePostEchoStage(log_rms);
+      post_echo_stage_done.Set();
+    });
+  }
+
+  const int64_t start_time_us = rtc::TimeMicros();
+  const int echo_stage_result = ProcessCaptureEchoStageLocked(
+      capture_.capture_audio.get(), capture_.linear_aec_output.get(),
+      /*pipelined=*/true, log_rms);
+  const bool ec_active = submodules_.echo_controller->ActiveProcessing();
+  capture_.stats.echo_stage_processing_time_us =
+      static_cast<int>(rtc::TimeMicros() - start_time_us);
+
+  if (frame.pending) {
+    post_echo_stage_done.Wait(rtc::Event::kForever);
+  }
+
+  // Keep the current frame for the next call, and output the previous one,
+  // or silence if there is none yet.
+  CopyAudio(*capture_.capture_audio, frame.echo_stage_audio.get());
+  if (capture_.capture_fullband_audio) {
+    CopyAudio(*capture_.capture_fullband_audio,
+              frame.echo_stage_fullband_audio.get());
+  }
+  if (frame.pending) {
+    CopyAudio(*frame.capture_audio, capture_.capture_audio.get());
+    if (capture_.capture_fullband_audio) {
+      CopyAudio(*frame.capture_fullband_audio,
+                capture_.capture_fullband_audio.get());
+    }
+  } else {
+    SetToZero(capture_.capture_audio.get());
+    if (capture_.capture_fullband_audio) {
+      SetToZero(capture_.capture_fullband_audio.get());
+    }
+  }
+  // The linear AEC output buffer has no state of its own.
+  std::swap(capture_.linear_aec_output, frame.linear_aec_output);
+  frame.echo_controller_active = ec_active;
+  frame.pending = echo_stage_result == kNoError;
+
+  RETURN_ON_ERR(echo_stage_result);
+  return post_echo_stage_result;
+}
+
+int AudioProcessingImpl::ProcessPipelinedFramePostEchoStage(bool log_rms) {
+  const int64_t start_time_us = rtc::TimeMicros();
+  const ApmCaptureState::PipelinedFrame& frame = capture_.pipelined_frame;
+  const int result = ProcessCapturePostEchoStageLocked(
+      frame.capture_audio.get(), frame.capture_fullband_audio.get(),
+      frame.linear_aec_output.get(), frame.echo_controller_active,
+      /*pipelined=*/true, log_rms);
+  capture_.stats.post_echo_stage_processing_time_us =
+      static_cast<int>(rtc::TimeMicros() - start_time_us);
+  return result;
+}
+
+int AudioProcessingImpl::ProcessCaptureEchoStageLocked(
+    AudioBuffer* capture_buffer,
+    AudioBuffer* linear_aec_buffer,
+    bool pipelined,
+    bool log_rms) {
   if (submodules_.high_pass_filter &&
       config_.high_pass_filter.apply_in_full_band &&
       !constants_.enforce_split_band_hpf) {
@@ -1079,9 +1313,7 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
   capture_input_rms_.Analyze(rtc::ArrayView<const float>(
       capture_buffer->channels_const()[0],
       capture_nonlocked_.capture_processing_format.num_frames()));
-  const bool log_rms = ++capture_rms_interval_counter_ >= 1000;
   if (log_rms) {
-    capture_rms_interval_counter_ = 0;
     RmsLevel::Levels levels = capture_input_rms_.AverageAndPeak();
     RTC_HISTOGRAM_COUNTS_LINEAR("WebRTC.Audio.ApmCaptureInputLevelAverageRms",
                                 levels.average, 1, RmsLevel::kMinLevelDb, 64);
@@ -1149,7 +1381,8 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
         submodules_.gain_control->AnalyzeCaptureAudio(*capture_buffer));
   }
 
-  if ((!config_.noise_suppression.analyze_linear_aec_output_when_available ||
+  if (!pipelined &&
+      (!config_.noise_suppression.analyze_linear_aec_output_when_available ||
        !linear_aec_buffer || submodules_.echo_control_mobile) &&
       submodules_.noise_suppressor) {
     submodules_.noise_suppressor->Analyze(*capture_buffer);
@@ -1168,26 +1401,35 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
 
     RETURN_ON_ERR(submodules_.echo_control_mobile->ProcessCaptureAudio(
         capture_buffer, stream_delay_ms()));
-  } else {
-    if (submodules_.echo_controller) {
-      data_dumper_->DumpRaw("stream_delay", stream_delay_ms());
-
-      if (capture_.was_stream_delay_set) {
-        submodules_.echo_controller->SetAudioBufferDelay(stream_delay_ms());
-      }
+  } else if (submodules_.echo_controller) {
+    data_dumper_->DumpRaw("stream_delay", stream_delay_ms());
 
-      submodules_.echo_controller->ProcessCapture(
-          capture_buffer, linear_aec_buffer, capture_.echo_path_gain_change);
+    if (capture_.was_stream_delay_set) {
+      submodules_.echo_controller->SetAudioBufferDelay(stream_delay_ms());
     }
 
+    submodules_.echo_controller->ProcessCapture(
+        capture_buffer, linear_aec_buffer, capture_.echo_path_gain_change);
+  }
+  return kNoError;
+}
+
+int AudioProcessingImpl::ProcessCapturePostEchoStageLocked(
+    AudioBuffer* capture_buffer,
+    AudioBuffer* capture_fullband_buffer,
+    AudioBuffer* linear_aec_buffer,
+    bool echo_controller_active,
+    bool pipelined,
+    bool log_rms) {
+  if (!submodules_.echo_control_mobile && submodules_.noise_suppressor) {
     if (config_.noise_suppression.analyze_linear_aec_output_when_available &&
-        linear_aec_buffer && submodules_.noise_suppressor) {
+        linear_aec_buffer) {
       submodules_.noise_suppressor->Analyze(*linear_aec_buffer);
+    } else if (pipelined) {
+      // The signal before the echo canceller is gone by now.
+      submodules_.noise_suppressor->Analyze(*capture_buffer);
     }
-
-    if (submodules_.noise_suppressor) {
-      submodules_.noise_suppressor->Process(capture_buffer);
-    }
+    submodules_.noise_suppressor->Process(capture_buffer);
   }
 
   if (config_.voice_detection.enabled) {
@@ -1219,15 +1461,14 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     capture_buffer->MergeFrequencyBands();
   }
 
-  if (capture_.capture_fullband_audio) {
-    const auto& ec = submodules_.echo_controller;
-    bool ec_active = ec ? ec->ActiveProcessing() : false;
+  if (capture_fullband_buffer) {
     // Only update the fullband buffer if the multiband processing has changed
     // the signal. Keep the original signal otherwise.
-    if (submodule_states_.CaptureMultiBandProcessingActive(ec_active)) {
-      capture_buffer->CopyTo(capture_.capture_fullband_audio.get());
+    if (submodule_states_.CaptureMultiBandProcessingActive(
+            echo_controller_active)) {
+      capture_buffer->CopyTo(capture_fullband_buffer);
     }
-    capture_buffer = capture_.capture_fullband_audio.get();
+    capture_buffer = capture_fullband_buffer;
   }
 
   if (config_.residual_echo_detector.enabled) {
@@ -1292,27 +1533,6 @@ int AudioProcessingImpl::ProcessCaptureStreamLocked() {
     data_dumper_->DumpRaw("experimental_gain_control_stream_analog_level", 1,
                           &level);
   }
-
-  // Compute echo-related stats.
-  if (submodules_.echo_controller) {
-    auto ec_metrics = submodules_.echo_controller->GetMetrics();
-    capture_.stats.echo_return_loss = ec_metrics.echo_return_loss;
-    capture_.stats.echo_return_loss_enhancement =
-        ec_metrics.echo_return_loss_enhancement;
-    capture_.stats.delay_ms = ec_metrics.delay_ms;
-  }
-  if (config_.residual_echo_detector.enabled) {
-    RTC_DCHECK(submodules_.echo_detector);
-    auto ed_metrics = submodules_.echo_detector->GetMetrics();
-    capture_.stats.residual_echo_likelihood = ed_metrics.echo_likelihood;
-    capture_.stats.residual_echo_likelihood_recent_max =
-        ed_metrics.echo_likelihood_recent_max;
-  }
-
-  // Pass stats for reporting.
-  stats_reporter_.UpdateStatistics(capture_.stats);
-
-  capture_.was_stream_delay_set = false;
   return kNoError;
 }
 
@@ -1329,6 +1549,7 @@ int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
                                               const StreamConfig& output_config,
                                               float* const* dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_StreamConfig");
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kAudioProcessing);
   rtc::CritScope cs(&crit_render_);
   RETURN_ON_ERR(AnalyzeReverseStreamLocked(src, input_config, output_config));
   if (submodule_states_.RenderMultiBandProcessingActive() ||
@@ -1385,6 +1606,7 @@ int AudioProcessingImpl::ProcessReverseStream(const int16_t* const src,
                                               const StreamConfig& output_config,
                                               int16_t* const dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_AudioFrame");
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kAudioProcessing);
 
   if (input_config.num_channels() <= 0) {
     return AudioProcessing::Error::kBadNumberChannelsError;
@@ -1426,6 +1648,10 @@ int AudioProcessingImpl::ProcessRenderStreamLocked() {
 
   HandleRenderRuntimeSettings();
 
+  if (config_.pipeline.skip_processing_in_silence) {
+    render_silent_.store(IsSilent(*render_buffer), std::memory_order_relaxed);
+  }
+
   if (submodules_.render_pre_processor) {
     submodules_.render_pre_processor->Process(render_buffer);
   }
@@ -1668,6 +1894,24 @@ void AudioProcessingImpl::InitializeVoiceDetector() {
     submodules_.voice_detector.reset();
   }
 }
+std::unique_ptr<AudioBuffer> AudioProcessingImpl::CreateCaptureBuffer(
+    int processing_sample_rate_hz) const {
+  return std::make_unique<AudioBuffer>(
+      formats_.api_format.input_stream().sample_rate_hz(),
+      formats_.api_format.input_stream().num_channels(),
+      processing_sample_rate_hz,
+      formats_.api_format.output_stream().num_channels(),
+      formats_.api_format.output_stream().sample_rate_hz(),
+      formats_.api_format.output_stream().num_channels());
+}
+
+std::unique_ptr<AudioBuffer> AudioProcessingImpl::CreateLinearAecOutputBuffer()
+    const {
+  return std::make_unique<AudioBuffer>(
+      kLinearOutputRateHz, num_proc_channels(), kLinearOutputRateHz,
+      num_proc_channels(), kLinearOutputRateHz, num_proc_channels());
+}
+
 void AudioProcessingImpl::InitializeEchoController() {
   bool use_echo_controller =
       echo_control_factory_ ||
@@ -1692,13 +1936,11 @@ void AudioProcessingImpl::InitializeEchoController() {
 
     // Setup the storage for returning the linear AEC output.
     if (config_.echo_canceller.export_linear_aec_output) {
-      constexpr int kLinearOutputRateHz = 16000;
-      capture_.linear_aec_output = std::make_unique<AudioBuffer>(
-          kLinearOutputRateHz, num_proc_channels(), kLinearOutputRateHz,
-          num_proc_channels(), kLinearOutputRateHz, num_proc_channels());
+      capture_.linear_aec_output = CreateLinearAecOutputBuffer();
     } else {
       capture_.linear_aec_output.reset();
     }
+    capture_.pipelined_frame = ApmCaptureState::PipelinedFrame();
 
     capture_nonlocked_.echo_controller_enabled = true;
 
@@ -1710,6 +1952,7 @@ void AudioProcessingImpl::InitializeEchoController() {
   submodules_.echo_controller.reset();
   capture_nonlocked_.echo_controller_enabled = false;
   capture_.linear_aec_output.reset();
+  capture_.pipelined_frame = ApmCaptureState::PipelinedFrame();
 
   if (!config_.echo_canceller.enabled) {
     submodules_.echo_control_mobile.reset();
@@ -2033,6 +2276,16 @@ AudioProcessingImpl::ApmCaptureState::ApmCaptureState()
 
 AudioProcessingImpl::ApmCaptureState::~ApmCaptureState() = default;
 
+AudioProcessingImpl::ApmCaptureState::PipelinedFrame::PipelinedFrame() =
+    default;
+
+AudioProcessingImpl::ApmCaptureState::PipelinedFrame::~PipelinedFrame() =
+    default;
+
+AudioProcessingImpl::ApmCaptureState::PipelinedFrame&
+AudioProcessingImpl::ApmCaptureState::PipelinedFrame::operator=(
+    PipelinedFrame&&) = default;
+
 void AudioProcessingImpl::ApmCaptureState::KeyboardInfo::Extract(
     const float* const* data,
     const StreamConfig& stream_config) {
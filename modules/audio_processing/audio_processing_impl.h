@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -43,6 +44,7 @@
 #include "rtc_base/gtest_prod_util.h"
 #include "rtc_base/ignore_wundef.h"
 #include "rtc_base/swap_queue.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -276,6 +278,15 @@ class AudioProcessingImpl : public AudioProcessing {
   // already acquired.
   void InitializePreProcessor() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_render_);
 
+  // Returns a capture buffer for processing at |processing_sample_rate_hz|, in
+  // the current API formats.
+  std::unique_ptr<AudioBuffer> CreateCaptureBuffer(
+      int processing_sample_rate_hz) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+  // Returns a buffer for the linear AEC output.
+  std::unique_ptr<AudioBuffer> CreateLinearAecOutputBuffer() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+
   // Sample rate used for the fullband processing.
   int proc_fullband_sample_rate_hz() const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
@@ -299,6 +310,44 @@ class AudioProcessingImpl : public AudioProcessing {
   // manner that are called with the render lock already acquired.
   int ProcessCaptureStreamLocked() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
 
+  // The capture processing is done in two stages: the echo stage, up to and
+  // including the echo canceller, and the post-echo stage with the rest of the
+  // processing. With |pipelined| true, the stages run at the same time on
+  // consecutive frames, and must not touch the same submodules; the echo stage
+  // then leaves the noise suppressor analysis to the post-echo stage.
+  int ProcessCaptureEchoStageLocked(AudioBuffer* capture_buffer,
+                                    AudioBuffer* linear_aec_buffer,
+                                    bool pipelined,
+                                    bool log_rms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+  int ProcessCapturePostEchoStageLocked(AudioBuffer* capture_buffer,
+                                        AudioBuffer* capture_fullband_buffer,
+                                        AudioBuffer* linear_aec_buffer,
+                                        bool echo_controller_active,
+                                        bool pipelined,
+                                        bool log_rms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+
+  // Returns true if the capture processing can be pipelined, i.e. it is
+  // enabled and none of the submodules that the two stages would both use is
+  // active.
+  bool CapturePipeliningActive() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+  // Runs the echo stage of the current frame while the post-echo stage of the
+  // previous one runs on |capture_pipeline_queue_|, and leaves the previous
+  // frame as the output.
+  int ProcessCaptureStreamPipelinedLocked(bool log_rms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+  // Runs on |capture_pipeline_queue_| while the capture thread, holding
+  // |crit_capture_|, waits for it.
+  int ProcessPipelinedFramePostEchoStage(bool log_rms)
+      RTC_NO_THREAD_SAFETY_ANALYSIS;
+
+  // Returns true if the capture processing of the current frame is to be
+  // skipped, as the capture and render audio have been silent for a while.
+  bool SkipCaptureProcessingInSilence()
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_capture_);
+
   // Render-side exclusive methods possibly running APM in a multi-threaded
   // manner that are called with the render lock already acquired.
   // TODO(ekm): Remove once all clients updated to new interface.
@@ -444,6 +493,22 @@ class AudioProcessingImpl : public AudioProcessing {
       const float* keyboard_data = nullptr;
     } keyboard_info;
     int cached_stream_analog_level_ = 0;
+    // With pipelined capture processing, the frame that has been through the
+    // echo stage and awaits the post-echo stage, with its buffers.
+    struct PipelinedFrame {
+      PipelinedFrame();
+      ~PipelinedFrame();
+      PipelinedFrame& operator=(PipelinedFrame&&);
+      // The audio as the echo stage left it.
+      std::unique_ptr<AudioBuffer> echo_stage_audio;
+      std::unique_ptr<AudioBuffer> echo_stage_fullband_audio;
+      // The buffers that the post-echo stage runs on.
+      std::unique_ptr<AudioBuffer> capture_audio;
+      std::unique_ptr<AudioBuffer> capture_fullband_audio;
+      std::unique_ptr<AudioBuffer> linear_aec_output;
+      bool echo_controller_active = false;
+      bool pending = false;
+    } pipelined_frame;
   } capture_ RTC_GUARDED_BY(crit_capture_);
 
   struct ApmCaptureNonLockedState {
@@ -503,6 +568,16 @@ class AudioProcessingImpl : public AudioProcessing {
   RmsLevel capture_output_rms_ RTC_GUARDED_BY(crit_capture_);
   int capture_rms_interval_counter_ RTC_GUARDED_BY(crit_capture_) = 0;
 
+  // Number of consecutive silent capture frames, with silent render audio.
+  int capture_silent_frames_ RTC_GUARDED_BY(crit_capture_) = 0;
+  // Whether the last render frame was silent. Written on the render thread and
+  // read on the capture thread.
+  std::atomic<bool> render_silent_{true};
+
+  // Runs the post-echo stage of the capture processing when it is pipelined.
+  std::unique_ptr<rtc::TaskQueue> capture_pipeline_queue_
+      RTC_GUARDED_BY(crit_capture_);
+
   // Lock protection not needed.
   std::unique_ptr<
       SwapQueue<std::vector<int16_t>, RenderQueueItemVerifier<int16_t>>>
@@ -13,6 +13,7 @@
 #include <array>
 #include <memory>
 
+#include "api/audio/echo_canceller3_factory.h"
 #include "api/scoped_refptr.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "modules/audio_processing/optionally_built_submodule_creators.h"
@@ -349,6 +350,138 @@ TEST(AudioProcessingImplTest, EchoControllerObservesPlayoutVolumeChange) {
   apm->ProcessStream(frame.data(), stream_config, stream_config, frame.data());
 }
 
+TEST(AudioProcessingImplTest, PipelinedCaptureProcessingDelaysOutput) {
+  // Tests that pipelining the capture processing gives the same output as
+  // processing it serially, one frame later.
+  for (int max_processing_rate : {32000, 48000}) {
+    SCOPED_TRACE(max_processing_rate);
+    AudioProcessing::Config apm_config;
+    apm_config.pipeline.maximum_internal_processing_rate = max_processing_rate;
+    apm_config.echo_canceller.enabled = true;
+    apm_config.echo_canceller.export_linear_aec_output = true;
+    apm_config.noise_suppression.enabled = true;
+    apm_config.noise_suppression.analyze_linear_aec_output_when_available =
+        true;
+    apm_config.gain_controller1.enabled = false;
+    apm_config.gain_controller2.enabled = true;
+    apm_config.high_pass_filter.enabled = true;
+    EchoCanceller3Config aec3_config;
+    aec3_config.filter.export_linear_aec_output = true;
+    std::unique_ptr<AudioProcessing> apm_reference(
+        AudioProcessingBuilderForTesting()
+            .SetEchoControlFactory(
+                std::make_unique<EchoCanceller3Factory>(aec3_config))
+            .Create());
+    apm_reference->ApplyConfig(apm_config);
+    apm_config.pipeline.pipelined_capture_processing = true;
+    std::unique_ptr<AudioProcessing> apm(
+        AudioProcessingBuilderForTesting()
+            .SetEchoControlFactory(
+                std::make_unique<EchoCanceller3Factory>(aec3_config))
+            .Create());
+    apm->ApplyConfig(apm_config);
+
+    constexpr int kSampleRateHz = 48000;
+    constexpr size_t kNumFrames = kSampleRateHz / 100;
+    StreamConfig stream_config(kSampleRateHz, /*num_channels=*/1,
+                               /*has_keyboard=*/false);
+    Random random_generator(4711U);
+    std::array<float, kNumFrames> render;
+    std::array<float, kNumFrames> capture;
+    std::array<float, kNumFrames> output;
+    std::array<float, kNumFrames> previous_reference_output;
+    std::array<float, kNumFrames> reference_output;
+    previous_reference_output.fill(0.f);
+    AudioProcessingStats stats;
+    for (int i = 0; i < 100; ++i) {
+      RandomizeSampleVector(&random_generator, render);
+      RandomizeSampleVector(&random_generator, capture);
+      for (AudioProcessing* processor : {apm.get(), apm_reference.get()}) {
+        std::array<float, kNumFrames> render_copy = render;
+        float* render_channels[] = {render_copy.data()};
+        ASSERT_EQ(processor->ProcessReverseStream(
+                      render_channels, stream_config, stream_config,
+                      render_channels),
+                  AudioProcessing::kNoError);
+      }
+      const float* capture_channels[] = {capture.data()};
+      float* output_channels[] = {output.data()};
+      float* reference_output_channels[] = {reference_output.data()};
+      ASSERT_EQ(apm->ProcessStream(capture_channels, stream_config,
+                                   stream_config, output_channels),
+                AudioProcessing::kNoError);
+      ASSERT_EQ(apm_reference->ProcessStream(capture_channels, stream_config,
+                                             stream_config,
+                                             reference_output_channels),
+                AudioProcessing::kNoError);
+      ASSERT_EQ(previous_reference_output, output) << "frame " << i;
+      previous_reference_output = reference_output;
+      stats = apm->GetStatistics();
+    }
+
+    EXPECT_TRUE(stats.echo_stage_processing_time_us);
+    EXPECT_TRUE(stats.post_echo_stage_processing_time_us);
+  }
+}
+
+TEST(AudioProcessingImplTest, SkipsCaptureProcessingInSustainedSilence) {
+  auto echo_control_factory = std::make_unique<MockEchoControlFactory>();
+  const auto* echo_control_factory_ptr = echo_control_factory.get();
+  std::unique_ptr<AudioProcessing> apm(
+      AudioProcessingBuilderForTesting()
+          .SetEchoControlFactory(std::move(echo_control_factory))
+          .Create());
+  webrtc::AudioProcessing::Config apm_config;
+  apm_config.pipeline.skip_processing_in_silence = true;
+  apm_config.gain_controller1.enabled = false;
+  apm_config.gain_controller2.enabled = true;
+  apm_config.noise_suppression.enabled = true;
+  apm->ApplyConfig(apm_config);
+
+  constexpr int16_t kSilentLevel = 1;
+  constexpr int16_t kAudioLevel = 10000;
+  constexpr size_t kSampleRateHz = 48000;
+  std::array<int16_t, kSampleRateHz / 100> render;
+  std::array<int16_t, kSampleRateHz / 100> frame;
+  StreamConfig stream_config(kSampleRateHz, /*num_channels=*/1,
+                             /*has_keyboard=*/false);
+  auto process_frames = [&](int num_frames, int16_t render_level,
+                            int16_t capture_level) {
+    for (int i = 0; i < num_frames; ++i) {
+      render.fill(render_level);
+      ASSERT_EQ(apm->ProcessReverseStream(render.data(), stream_config,
+                                          stream_config, render.data()),
+                AudioProcessing::kNoError);
+      frame.fill(capture_level);
+      ASSERT_EQ(apm->ProcessStream(frame.data(), stream_config,
+                                   stream_config, frame.data()),
+                AudioProcessing::kNoError);
+    }
+  };
+
+  MockEchoControl* echo_control_mock = echo_control_factory_ptr->GetNext();
+  // Initialize with the stream formats, so that the echo controller isn't
+  // recreated when processing starts.
+  ASSERT_EQ(apm->Initialize({{stream_config, stream_config, stream_config,
+                              stream_config}}),
+            AudioProcessing::kNoError);
+
+  // After half a second of silence, only every tenth frame is processed, and
+  // the output of the others is zeroed.
+  EXPECT_CALL(*echo_control_mock, ProcessCapture(NotNull(), testing::_, false))
+      .Times(50 + 1);
+  process_frames(50 + 19, kSilentLevel, kSilentLevel);
+  testing::Mock::VerifyAndClearExpectations(echo_control_mock);
+  EXPECT_THAT(frame, ::testing::Each(0));
+
+  // Any audio, on either side, ends the skipping at once.
+  EXPECT_CALL(*echo_control_mock, ProcessCapture(NotNull(), testing::_, false))
+      .Times(2);
+  process_frames(1, kSilentLevel, kAudioLevel);
+  process_frames(1, kAudioLevel, kSilentLevel);
+  testing::Mock::VerifyAndClearExpectations(echo_control_mock);
+}
+
 TEST(AudioProcessingImplTest, RenderPreProcessorBeforeEchoDetector) {
   // Make sure that signal changes caused by a render pre-processing sub-module
   // take place before any echo detector analysis.
@@ -81,6 +81,10 @@ std::string AudioProcessing::Config::ToString() const {
           << ", "
              ", multi_channel_capture: "
           << pipeline.multi_channel_capture
+          << ", pipelined_capture_processing: "
+          << pipeline.pipelined_capture_processing
+          << ", skip_processing_in_silence: "
+          << pipeline.skip_processing_in_silence
           << "}, "
              "pre_amplifier: { enabled: "
           << pre_amplifier.enabled
@@ -225,6 +225,22 @@ class RTC_EXPORT AudioProcessing : public rtc::RefCountInterface {
       // Allow multi-channel processing of capture audio when AEC3 is active
       // or a custom AEC is injected..
       bool multi_channel_capture = false;
+      // Run the capture processing after the echo canceller (noise
+      // suppression, AGC2 and the rest) on a thread of its own, on the
+      // previous frame, while the capture thread echo cancels the current
+      // one. This delays the capture output by one frame. Only takes effect
+      // when an echo canceller other than AECM is active, and AGC1 and the
+      // transient suppressor are not. The noise suppressor then analyzes the
+      // linear AEC output when |analyze_linear_aec_output_when_available| is
+      // set, and the echo canceller output otherwise.
+      bool pipelined_capture_processing = false;
+      // Skip the capture processing while both the capture and the render
+      // audio have been digital silence for half a second, only running it
+      // on every tenth frame so that the submodules keep consuming the render
+      // audio and adapting. The capture output is silence while skipping.
+      // Does not take effect when AGC1 is active, as it may need to raise the
+      // analog mic level out of silence.
+      bool skip_processing_in_silence = false;
     } pipeline;
 
     // Enabled the pre-amplifier. It amplifies the capture signal
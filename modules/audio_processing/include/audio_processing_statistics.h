@@ -66,6 +66,13 @@ struct RTC_EXPORT AudioProcessingStats {
   // milliseconds and the value is the instantaneous value at the time of the
   // call to |GetStatistics()|.
   absl::optional<int32_t> delay_ms;
+
+  // The time in microseconds spent on the last capture frame by the two stages
+  // of the capture processing: up to and including the echo canceller, and
+  // after it. With Config::Pipeline::pipelined_capture_processing the stages
+  // run in parallel, so the longer of the two bounds the processing time.
+  absl::optional<int> echo_stage_processing_time_us;
+  absl::optional<int> post_echo_stage_processing_time_us;
 };
 
 }  // namespace webrtc
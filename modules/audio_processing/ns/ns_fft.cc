@@ -10,55 +10,51 @@
 
 #include "modules/audio_processing/ns/ns_fft.h"
 
-#include "common_audio/third_party/ooura/fft_size_256/fft4g.h"
+#include <algorithm>
+
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
-NrFft::NrFft() : bit_reversal_state_(kFftSize / 2), tables_(kFftSize / 2) {
-  // Initialize WebRtc_rdt (setting (bit_reversal_state_[0] to 0 triggers
-  // initialization)
-  bit_reversal_state_[0] = 0.f;
-  std::array<float, kFftSize> tmp_buffer;
-  tmp_buffer.fill(0.f);
-  WebRtc_rdft(kFftSize, 1, tmp_buffer.data(), bit_reversal_state_.data(),
-              tables_.data());
+namespace {
+
+RealFourier::Implementation GetImplementation() {
+  return field_trial::IsEnabled("WebRTC-NoiseSuppressionPffft")
+             ? RealFourier::Implementation::kPffft
+             : RealFourier::Implementation::kOoura;
 }
 
+}  // namespace
+
+NrFft::NrFft() : NrFft(GetImplementation()) {}
+
+NrFft::NrFft(RealFourier::Implementation implementation)
+    : fft_(RealFourier::Create(RealFourier::FftOrder(kFftSize),
+                               implementation)),
+      time_buffer_(RealFourier::AllocRealBuffer(kFftSize)),
+      frequency_buffer_(RealFourier::AllocCplxBuffer(kFftSizeBy2Plus1)) {}
+
 void NrFft::Fft(rtc::ArrayView<float, kFftSize> time_data,
                 rtc::ArrayView<float, kFftSize> real,
                 rtc::ArrayView<float, kFftSize> imag) {
-  WebRtc_rdft(kFftSize, 1, time_data.data(), bit_reversal_state_.data(),
-              tables_.data());
+  std::copy(time_data.begin(), time_data.end(), time_buffer_.get());
+  fft_->Forward(time_buffer_.get(), frequency_buffer_.get());
 
-  imag[0] = 0;
-  real[0] = time_data[0];
-
-  imag[kFftSizeBy2Plus1 - 1] = 0;
-  real[kFftSizeBy2Plus1 - 1] = time_data[1];
-
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    real[i] = time_data[2 * i];
-    imag[i] = time_data[2 * i + 1];
+  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+    real[i] = frequency_buffer_[i].real();
+    imag[i] = -frequency_buffer_[i].imag();
   }
 }
 
 void NrFft::Ifft(rtc::ArrayView<const float> real,
                  rtc::ArrayView<const float> imag,
                  rtc::ArrayView<float> time_data) {
-  time_data[0] = real[0];
-  time_data[1] = real[kFftSizeBy2Plus1 - 1];
-  for (size_t i = 1; i < kFftSizeBy2Plus1 - 1; ++i) {
-    time_data[2 * i] = real[i];
-    time_data[2 * i + 1] = imag[i];
-  }
-  WebRtc_rdft(kFftSize, -1, time_data.data(), bit_reversal_state_.data(),
-              tables_.data());
-
-  // Scale the output
-  constexpr float kScaling = 2.f / kFftSize;
-  for (float& d : time_data) {
-    d *= kScaling;
+  for (size_t i = 0; i < kFftSizeBy2Plus1; ++i) {
+    frequency_buffer_[i] = std::complex<float>(real[i], -imag[i]);
   }
+  fft_->Inverse(frequency_buffer_.get(), time_buffer_.get());
+  std::copy(time_buffer_.get(), time_buffer_.get() + kFftSize,
+            time_data.begin());
 }
 
 }  // namespace webrtc
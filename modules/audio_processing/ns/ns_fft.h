@@ -11,17 +11,23 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_NS_FFT_H_
 #define MODULES_AUDIO_PROCESSING_NS_NS_FFT_H_
 
-#include <vector>
+#include <memory>
 
 #include "api/array_view.h"
+#include "common_audio/real_fourier.h"
 #include "modules/audio_processing/ns/ns_common.h"
 
 namespace webrtc {
 
-// Wrapper class providing 256 point FFT functionality.
+// Wrapper class providing 256 point FFT functionality. The frequency domain
+// data follows the Ooura FFT convention, i.e., the imaginary parts have the
+// opposite sign of the usual Fourier definition. The FFT is done by PFFFT if
+// the "WebRTC-NoiseSuppressionPffft" field trial is enabled, and by the Ooura
+// FFT otherwise.
 class NrFft {
  public:
   NrFft();
+  explicit NrFft(RealFourier::Implementation implementation);
   NrFft(const NrFft&) = delete;
   NrFft& operator=(const NrFft&) = delete;
 
@@ -36,8 +42,9 @@ class NrFft {
             rtc::ArrayView<float> time_data);
 
  private:
-  std::vector<size_t> bit_reversal_state_;
-  std::vector<float> tables_;
+  const std::unique_ptr<RealFourier> fft_;
+  const RealFourier::fft_real_scoper time_buffer_;
+  const RealFourier::fft_cplx_scoper frequency_buffer_;
 };
 
 }  // namespace webrtc
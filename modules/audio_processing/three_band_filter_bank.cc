@@ -32,6 +32,7 @@
 
 #include "modules/audio_processing/three_band_filter_bank.h"
 
+#include <algorithm>
 #include <array>
 
 #include "rtc_base/checks.h"
@@ -111,31 +112,23 @@ void FilterCore(
   constexpr int kMaxInShift = (kStride - 1);
   RTC_DCHECK_GE(in_shift, 0);
   RTC_DCHECK_LE(in_shift, kMaxInShift);
-  std::fill(out.begin(), out.end(), 0.f);
-
-  for (int k = 0; k < in_shift; ++k) {
-    for (int i = 0, j = kMemorySize + k - in_shift; i < kFilterSize;
-         ++i, j -= kStride) {
-      out[k] += state[j] * filter[i];
-    }
-  }
 
-  for (int k = in_shift, shift = 0; k < kFilterSize * kStride; ++k, ++shift) {
-    RTC_DCHECK_GE(shift, 0);
-    const int loop_limit = std::min(kFilterSize, 1 + (shift >> kStrideLog2));
-    for (int i = 0, j = shift; i < loop_limit; ++i, j -= kStride) {
-      out[k] += in[j] * filter[i];
-    }
-    for (int i = loop_limit, j = kMemorySize + shift - loop_limit * kStride;
-         i < kFilterSize; ++i, j -= kStride) {
-      out[k] += state[j] * filter[i];
-    }
-  }
+  // With the state placed right before the input, every output sample is
+  // computed by the same expression. Accumulating one filter tap at a time
+  // over the whole output then gives contiguous loops that the compiler
+  // vectorizes, while keeping the summation order of a per-sample FIR.
+  std::array<float, kMemorySize + ThreeBandFilterBank::kSplitBandSize>
+      extended_in;
+  std::copy(state.begin(), state.end(), extended_in.begin());
+  std::copy(in.begin(), in.end(), extended_in.begin() + kMemorySize);
 
-  for (int k = kFilterSize * kStride, shift = kFilterSize * kStride - in_shift;
-       k < ThreeBandFilterBank::kSplitBandSize; ++k, ++shift) {
-    for (int i = 0, j = shift; i < kFilterSize; ++i, j -= kStride) {
-      out[k] += in[j] * filter[i];
+  std::fill(out.begin(), out.end(), 0.f);
+  for (int i = 0; i < kFilterSize; ++i) {
+    const float coefficient = filter[i];
+    const float* const delayed_in =
+        &extended_in[kMemorySize - in_shift - i * kStride];
+    for (int k = 0; k < ThreeBandFilterBank::kSplitBandSize; ++k) {
+      out[k] += delayed_in[k] * coefficient;
     }
   }
 
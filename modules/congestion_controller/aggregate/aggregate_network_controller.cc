@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/aggregate/aggregate_network_controller.h"
+
+#include <cmath>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ref_counted_object.h"
+
+namespace webrtc {
+
+namespace {
+
+// Pacing is only updated for changes of the scale larger than this, so that
+// small changes of other transports do not cause updates on every call.
+constexpr double kPacingScaleThreshold = 0.02;
+
+DataRate PacingRate(const PacerConfig& config) {
+  if (config.data_window.IsInfinite() || config.time_window.IsInfinite())
+    return DataRate::PlusInfinity();
+  return config.data_rate();
+}
+
+PacerConfig ScalePacerConfig(const PacerConfig& config,
+                             double scale,
+                             Timestamp at_time) {
+  PacerConfig scaled = config;
+  scaled.at_time = at_time;
+  if (scaled.data_window.IsFinite())
+    scaled.data_window = scaled.data_window * scale;
+  scaled.pad_window = scaled.pad_window * scale;
+  return scaled;
+}
+
+}  // namespace
+
+AggregateNetworkController::AggregateNetworkController(
+    std::unique_ptr<NetworkControllerInterface> controller,
+    rtc::scoped_refptr<EgressCoordinator> coordinator)
+    : controller_(std::move(controller)),
+      coordinator_(std::move(coordinator)),
+      transport_id_(coordinator_->AddTransport()) {
+  RTC_DCHECK(controller_);
+}
+
+AggregateNetworkController::~AggregateNetworkController() {
+  coordinator_->RemoveTransport(transport_id_);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnNetworkAvailability(
+    NetworkAvailability msg) {
+  return Coordinate(controller_->OnNetworkAvailability(msg), msg.at_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnNetworkRouteChange(
+    NetworkRouteChange msg) {
+  return Coordinate(controller_->OnNetworkRouteChange(msg), msg.at_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnProcessInterval(
+    ProcessInterval msg) {
+  return Coordinate(controller_->OnProcessInterval(msg), msg.at_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnRemoteBitrateReport(
+    RemoteBitrateReport msg) {
+  return Coordinate(controller_->OnRemoteBitrateReport(msg), msg.receive_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnRoundTripTimeUpdate(
+    RoundTripTimeUpdate msg) {
+  return Coordinate(controller_->OnRoundTripTimeUpdate(msg), msg.receive_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnSentPacket(SentPacket msg) {
+  return Coordinate(controller_->OnSentPacket(msg), msg.send_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnReceivedPacket(
+    ReceivedPacket msg) {
+  return Coordinate(controller_->OnReceivedPacket(msg), msg.receive_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnStreamsConfig(
+    StreamsConfig msg) {
+  return Coordinate(controller_->OnStreamsConfig(msg), msg.at_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnTargetRateConstraints(
+    TargetRateConstraints msg) {
+  return Coordinate(controller_->OnTargetRateConstraints(msg), msg.at_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnTransportLossReport(
+    TransportLossReport msg) {
+  return Coordinate(controller_->OnTransportLossReport(msg), msg.receive_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnTransportPacketsFeedback(
+    TransportPacketsFeedback msg) {
+  return Coordinate(controller_->OnTransportPacketsFeedback(msg),
+                    msg.feedback_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::OnNetworkStateEstimate(
+    NetworkStateEstimate msg) {
+  return Coordinate(controller_->OnNetworkStateEstimate(msg), msg.update_time);
+}
+
+NetworkControlUpdate AggregateNetworkController::Coordinate(
+    NetworkControlUpdate update,
+    Timestamp at_time) {
+  // Some messages, mostly in tests, come without a time.
+  if (at_time.IsFinite() && at_time > now_)
+    now_ = at_time;
+
+  if (update.pacer_config) {
+    pacer_config_ = update.pacer_config;
+    coordinator_->SetPacingRate(transport_id_, PacingRate(*pacer_config_));
+  }
+  const double pacing_scale = coordinator_->GetPacingScale();
+  if (pacer_config_ &&
+      (update.pacer_config ||
+       std::abs(pacing_scale - pacing_scale_) > kPacingScaleThreshold)) {
+    pacing_scale_ = pacing_scale;
+    update.pacer_config = ScalePacerConfig(
+        *pacer_config_, pacing_scale_,
+        update.pacer_config ? update.pacer_config->at_time : now_);
+  }
+
+  if (!now_.IsFinite())
+    return update;
+  for (ProbeClusterConfig& probe : update.probe_cluster_configs) {
+    probe.at_time = now_;
+    pending_probes_.push_back(probe);
+  }
+  update.probe_cluster_configs.clear();
+  const TimeDelta max_probe_delay = coordinator_->config().max_probe_delay;
+  while (!pending_probes_.empty() &&
+         now_ - pending_probes_.front().at_time > max_probe_delay) {
+    RTC_LOG(LS_INFO) << "Dropping probe cluster " << pending_probes_.front().id
+                     << ", other transports were probing.";
+    pending_probes_.pop_front();
+  }
+  if (!pending_probes_.empty() &&
+      coordinator_->TryStartProbe(transport_id_, now_)) {
+    for (ProbeClusterConfig& probe : pending_probes_) {
+      probe.at_time = now_;
+      update.probe_cluster_configs.push_back(probe);
+    }
+    pending_probes_.clear();
+  }
+  return update;
+}
+
+AggregateNetworkControllerFactory::AggregateNetworkControllerFactory(
+    std::unique_ptr<NetworkControllerFactoryInterface> factory,
+    const EgressCoordinator::Config& config)
+    : factory_(std::move(factory)),
+      coordinator_(new rtc::RefCountedObject<EgressCoordinator>(config)) {
+  RTC_DCHECK(factory_);
+}
+
+AggregateNetworkControllerFactory::~AggregateNetworkControllerFactory() =
+    default;
+
+std::unique_ptr<NetworkControllerInterface>
+AggregateNetworkControllerFactory::Create(NetworkControllerConfig config) {
+  return std::make_unique<AggregateNetworkController>(factory_->Create(config),
+                                                      coordinator_);
+}
+
+TimeDelta AggregateNetworkControllerFactory::GetProcessInterval() const {
+  return factory_->GetProcessInterval();
+}
+
+}  // namespace webrtc
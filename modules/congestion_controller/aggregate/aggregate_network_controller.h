@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_AGGREGATE_AGGREGATE_NETWORK_CONTROLLER_H_
+#define MODULES_CONGESTION_CONTROLLER_AGGREGATE_AGGREGATE_NETWORK_CONTROLLER_H_
+
+#include <deque>
+#include <memory>
+
+#include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
+#include "api/transport/network_control.h"
+#include "api/transport/network_types.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "modules/congestion_controller/aggregate/egress_coordinator.h"
+
+namespace webrtc {
+
+// Wraps the network controller of one transport, so that it shares probing
+// and pacing with the other transports of an EgressCoordinator:
+// - Probes are only sent while the transport holds one of the probe slots of
+//   the egress. Otherwise they are held back, and dropped if they wait too
+//   long.
+// - The pacing rate is scaled down when the pacing rates of all transports add
+//   up to more than the capacity of the egress.
+// Everything else is passed through unchanged.
+class AggregateNetworkController : public NetworkControllerInterface {
+ public:
+  AggregateNetworkController(
+      std::unique_ptr<NetworkControllerInterface> controller,
+      rtc::scoped_refptr<EgressCoordinator> coordinator);
+  ~AggregateNetworkController() override;
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability msg) override;
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange msg) override;
+  NetworkControlUpdate OnProcessInterval(ProcessInterval msg) override;
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport msg) override;
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate msg) override;
+  NetworkControlUpdate OnSentPacket(SentPacket msg) override;
+  NetworkControlUpdate OnReceivedPacket(ReceivedPacket msg) override;
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig msg) override;
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints msg) override;
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override;
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override;
+  NetworkControlUpdate OnNetworkStateEstimate(
+      NetworkStateEstimate msg) override;
+
+ private:
+  // Applies the decisions of the coordinator to |update|, made by
+  // |controller_| at |at_time|.
+  NetworkControlUpdate Coordinate(NetworkControlUpdate update,
+                                  Timestamp at_time);
+
+  const std::unique_ptr<NetworkControllerInterface> controller_;
+  const rtc::scoped_refptr<EgressCoordinator> coordinator_;
+  const int transport_id_;
+  Timestamp now_ = Timestamp::MinusInfinity();
+  // The pacer config from |controller_|, before scaling.
+  absl::optional<PacerConfig> pacer_config_;
+  double pacing_scale_ = 1.0;
+  // Probes waiting for a slot, with the time they were asked for.
+  std::deque<ProbeClusterConfig> pending_probes_;
+};
+
+// Creates controllers with another factory, and wraps them all in
+// AggregateNetworkControllers that share one EgressCoordinator. Give the same
+// factory to all transports that send through the same bottleneck.
+class AggregateNetworkControllerFactory
+    : public NetworkControllerFactoryInterface {
+ public:
+  AggregateNetworkControllerFactory(
+      std::unique_ptr<NetworkControllerFactoryInterface> factory,
+      const EgressCoordinator::Config& config);
+  ~AggregateNetworkControllerFactory() override;
+
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override;
+  TimeDelta GetProcessInterval() const override;
+
+  EgressCoordinator* coordinator() const { return coordinator_.get(); }
+
+ private:
+  const std::unique_ptr<NetworkControllerFactoryInterface> factory_;
+  const rtc::scoped_refptr<EgressCoordinator> coordinator_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_AGGREGATE_AGGREGATE_NETWORK_CONTROLLER_H_
@@ -0,0 +1,200 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/aggregate/aggregate_network_controller.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Returns the update it was given from OnProcessInterval() and nothing from
+// the other calls.
+class FakeNetworkController : public NetworkControllerInterface {
+ public:
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability) override {
+    return {};
+  }
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange) override {
+    return {};
+  }
+  NetworkControlUpdate OnProcessInterval(ProcessInterval) override {
+    NetworkControlUpdate update = std::move(next_update_);
+    next_update_ = NetworkControlUpdate();
+    return update;
+  }
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport) override {
+    return {};
+  }
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate) override {
+    return {};
+  }
+  NetworkControlUpdate OnSentPacket(SentPacket) override { return {}; }
+  NetworkControlUpdate OnReceivedPacket(ReceivedPacket) override { return {}; }
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig) override { return {}; }
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints) override {
+    return {};
+  }
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport) override {
+    return {};
+  }
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback) override {
+    return {};
+  }
+  NetworkControlUpdate OnNetworkStateEstimate(NetworkStateEstimate) override {
+    return {};
+  }
+
+  NetworkControlUpdate next_update_;
+};
+
+// Creates FakeNetworkControllers, and keeps pointers to them.
+class FakeNetworkControllerFactory : public NetworkControllerFactoryInterface {
+ public:
+  explicit FakeNetworkControllerFactory(
+      std::vector<FakeNetworkController*>* controllers)
+      : controllers_(controllers) {}
+
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig) override {
+    auto controller = std::make_unique<FakeNetworkController>();
+    controllers_->push_back(controller.get());
+    return controller;
+  }
+  TimeDelta GetProcessInterval() const override {
+    return TimeDelta::Millis(25);
+  }
+
+ private:
+  std::vector<FakeNetworkController*>* const controllers_;
+};
+
+ProbeClusterConfig MakeProbe(int id) {
+  ProbeClusterConfig probe;
+  probe.target_data_rate = DataRate::KilobitsPerSec(1000);
+  probe.target_duration = TimeDelta::Millis(15);
+  probe.target_probe_count = 5;
+  probe.id = id;
+  return probe;
+}
+
+PacerConfig MakePacerConfig(DataRate rate, Timestamp at_time) {
+  PacerConfig config;
+  config.at_time = at_time;
+  config.time_window = TimeDelta::Seconds(1);
+  config.data_window = rate * config.time_window;
+  return config;
+}
+
+class AggregateNetworkControllerTest : public ::testing::Test {
+ protected:
+  AggregateNetworkControllerTest() {
+    config_.max_concurrent_probes = 1;
+    config_.probe_slot_duration = TimeDelta::Millis(500);
+    config_.max_probe_delay = TimeDelta::Seconds(2);
+    config_.capacity = DataRate::KilobitsPerSec(1000);
+    factory_ = std::make_unique<AggregateNetworkControllerFactory>(
+        std::make_unique<FakeNetworkControllerFactory>(&fakes_), config_);
+    for (int i = 0; i < 2; ++i) {
+      NetworkControllerConfig controller_config;
+      controllers_.push_back(factory_->Create(controller_config));
+    }
+  }
+
+  NetworkControlUpdate Process(int index) {
+    ProcessInterval msg;
+    msg.at_time = now_;
+    return controllers_[index]->OnProcessInterval(msg);
+  }
+
+  EgressCoordinator::Config config_;
+  Timestamp now_ = Timestamp::Seconds(100);
+  std::vector<FakeNetworkController*> fakes_;
+  std::unique_ptr<AggregateNetworkControllerFactory> factory_;
+  std::vector<std::unique_ptr<NetworkControllerInterface>> controllers_;
+};
+
+}  // namespace
+
+TEST_F(AggregateNetworkControllerTest, DefersProbesWhileOthersProbe) {
+  fakes_[0]->next_update_.probe_cluster_configs.push_back(MakeProbe(1));
+  NetworkControlUpdate update = Process(0);
+  ASSERT_EQ(1u, update.probe_cluster_configs.size());
+  EXPECT_EQ(1, update.probe_cluster_configs[0].id);
+  EXPECT_EQ(now_, update.probe_cluster_configs[0].at_time);
+
+  fakes_[1]->next_update_.probe_cluster_configs.push_back(MakeProbe(2));
+  EXPECT_TRUE(Process(1).probe_cluster_configs.empty());
+
+  // Sent once the first transport's slot runs out.
+  now_ += TimeDelta::Millis(300);
+  EXPECT_TRUE(Process(1).probe_cluster_configs.empty());
+  now_ += TimeDelta::Millis(200);
+  update = Process(1);
+  ASSERT_EQ(1u, update.probe_cluster_configs.size());
+  EXPECT_EQ(2, update.probe_cluster_configs[0].id);
+  EXPECT_EQ(now_, update.probe_cluster_configs[0].at_time);
+}
+
+TEST_F(AggregateNetworkControllerTest, DropsProbesThatWaitTooLong) {
+  fakes_[0]->next_update_.probe_cluster_configs.push_back(MakeProbe(1));
+  EXPECT_EQ(1u, Process(0).probe_cluster_configs.size());
+  fakes_[1]->next_update_.probe_cluster_configs.push_back(MakeProbe(2));
+  EXPECT_TRUE(Process(1).probe_cluster_configs.empty());
+
+  // The first transport keeps probing for longer than the probe may wait.
+  for (int i = 0; i < 6; ++i) {
+    now_ += TimeDelta::Millis(400);
+    fakes_[0]->next_update_.probe_cluster_configs.push_back(MakeProbe(3 + i));
+    EXPECT_EQ(1u, Process(0).probe_cluster_configs.size());
+    EXPECT_TRUE(Process(1).probe_cluster_configs.empty());
+  }
+  now_ += TimeDelta::Millis(500);
+  EXPECT_TRUE(Process(1).probe_cluster_configs.empty());
+}
+
+TEST_F(AggregateNetworkControllerTest, ScalesPacingToCapacity) {
+  fakes_[0]->next_update_.pacer_config =
+      MakePacerConfig(DataRate::KilobitsPerSec(600), now_);
+  NetworkControlUpdate update = Process(0);
+  ASSERT_TRUE(update.pacer_config);
+  EXPECT_EQ(DataRate::KilobitsPerSec(600), update.pacer_config->data_rate());
+
+  // The second transport takes the total to twice the capacity.
+  fakes_[1]->next_update_.pacer_config =
+      MakePacerConfig(DataRate::KilobitsPerSec(1400), now_);
+  update = Process(1);
+  ASSERT_TRUE(update.pacer_config);
+  EXPECT_EQ(DataRate::KilobitsPerSec(700), update.pacer_config->data_rate());
+
+  // The first transport is rescaled on its next update, and only then.
+  now_ += TimeDelta::Millis(25);
+  update = Process(0);
+  ASSERT_TRUE(update.pacer_config);
+  EXPECT_EQ(DataRate::KilobitsPerSec(300), update.pacer_config->data_rate());
+  EXPECT_EQ(now_, update.pacer_config->at_time);
+  EXPECT_FALSE(Process(0).pacer_config);
+
+  // Removing the second transport gives the first its full rate back.
+  controllers_.pop_back();
+  update = Process(0);
+  ASSERT_TRUE(update.pacer_config);
+  EXPECT_EQ(DataRate::KilobitsPerSec(600), update.pacer_config->data_rate());
+}
+
+}  // namespace webrtc
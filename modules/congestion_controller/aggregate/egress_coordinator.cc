@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/aggregate/egress_coordinator.h"
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+EgressCoordinator::EgressCoordinator(const Config& config) : config_(config) {
+  RTC_DCHECK_GT(config_.max_concurrent_probes, 0);
+}
+
+EgressCoordinator::~EgressCoordinator() = default;
+
+int EgressCoordinator::AddTransport() {
+  rtc::CritScope cs(&crit_);
+  int transport_id = next_transport_id_++;
+  transports_[transport_id] = Transport();
+  return transport_id;
+}
+
+void EgressCoordinator::RemoveTransport(int transport_id) {
+  rtc::CritScope cs(&crit_);
+  auto it = transports_.find(transport_id);
+  RTC_DCHECK(it != transports_.end());
+  total_pacing_rate_ -= it->second.pacing_rate;
+  transports_.erase(it);
+}
+
+bool EgressCoordinator::TryStartProbe(int transport_id, Timestamp now) {
+  rtc::CritScope cs(&crit_);
+  auto it = transports_.find(transport_id);
+  RTC_DCHECK(it != transports_.end());
+  // A transport that is already probing may go on, for instance with the
+  // next cluster of a series.
+  if (it->second.probe_slot_end <= now) {
+    int num_probing = 0;
+    for (const auto& transport : transports_) {
+      if (transport.second.probe_slot_end > now)
+        ++num_probing;
+    }
+    if (num_probing >= config_.max_concurrent_probes)
+      return false;
+  }
+  it->second.probe_slot_end = now + config_.probe_slot_duration;
+  return true;
+}
+
+void EgressCoordinator::SetPacingRate(int transport_id, DataRate rate) {
+  // Rates without a limit cannot be shared, and are left as they are.
+  if (!rate.IsFinite())
+    rate = DataRate::Zero();
+  rtc::CritScope cs(&crit_);
+  auto it = transports_.find(transport_id);
+  RTC_DCHECK(it != transports_.end());
+  total_pacing_rate_ = total_pacing_rate_ - it->second.pacing_rate + rate;
+  it->second.pacing_rate = rate;
+}
+
+double EgressCoordinator::GetPacingScale() const {
+  rtc::CritScope cs(&crit_);
+  if (total_pacing_rate_ <= config_.capacity)
+    return 1.0;
+  return config_.capacity / total_pacing_rate_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_AGGREGATE_EGRESS_COORDINATOR_H_
+#define MODULES_CONGESTION_CONTROLLER_AGGREGATE_EGRESS_COORDINATOR_H_
+
+#include <map>
+
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Shares probing and pacing between the network controllers of transports
+// that send through the same bottleneck, such as the uplink of a server with
+// many peers. Without it, each controller probes and paces as if it had the
+// link to itself.
+//
+// Thread safe, since each transport runs its controller on its own task
+// queue. All transports must report times from the same clock.
+class EgressCoordinator : public rtc::RefCountInterface {
+ public:
+  struct Config {
+    // Number of transports that may probe at the same time.
+    int max_concurrent_probes = 1;
+    // How long a transport keeps its probe slot after starting a probe, for
+    // the probe to be sent and its feedback to arrive.
+    TimeDelta probe_slot_duration = TimeDelta::Millis(500);
+    // Probes that do not get a slot within this time are dropped.
+    TimeDelta max_probe_delay = TimeDelta::Seconds(2);
+    // Capacity of the shared egress. When the pacing rates of all transports
+    // add up to more, they are all scaled down to fit.
+    DataRate capacity = DataRate::PlusInfinity();
+  };
+
+  explicit EgressCoordinator(const Config& config);
+  ~EgressCoordinator() override;
+
+  // Returns the id of a new transport.
+  int AddTransport();
+  void RemoveTransport(int transport_id);
+
+  // Returns true if |transport_id| may start probing at |now|, in which case
+  // it holds a probe slot until |now| + probe_slot_duration.
+  bool TryStartProbe(int transport_id, Timestamp now);
+
+  // Sets the pacing rate that the controller of |transport_id| asks for.
+  void SetPacingRate(int transport_id, DataRate rate);
+  // Returns the factor, at most 1, that all pacing rates are scaled with.
+  double GetPacingScale() const;
+
+  const Config& config() const { return config_; }
+
+ private:
+  struct Transport {
+    DataRate pacing_rate = DataRate::Zero();
+    Timestamp probe_slot_end = Timestamp::MinusInfinity();
+  };
+
+  const Config config_;
+  rtc::CriticalSection crit_;
+  int next_transport_id_ RTC_GUARDED_BY(crit_) = 0;
+  std::map<int, Transport> transports_ RTC_GUARDED_BY(crit_);
+  // Sum of the pacing rates of |transports_|.
+  DataRate total_pacing_rate_ RTC_GUARDED_BY(crit_) = DataRate::Zero();
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_AGGREGATE_EGRESS_COORDINATOR_H_
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/aggregate/egress_coordinator.h"
+
+#include "api/scoped_refptr.h"
+#include "rtc_base/ref_counted_object.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(EgressCoordinatorTest, GrantsLimitedNumberOfProbeSlots) {
+  EgressCoordinator::Config config;
+  config.max_concurrent_probes = 2;
+  config.probe_slot_duration = TimeDelta::Millis(500);
+  rtc::scoped_refptr<EgressCoordinator> coordinator(
+      new rtc::RefCountedObject<EgressCoordinator>(config));
+  const int first = coordinator->AddTransport();
+  const int second = coordinator->AddTransport();
+  const int third = coordinator->AddTransport();
+  Timestamp now = Timestamp::Seconds(10);
+
+  EXPECT_TRUE(coordinator->TryStartProbe(first, now));
+  EXPECT_TRUE(coordinator->TryStartProbe(second, now));
+  EXPECT_FALSE(coordinator->TryStartProbe(third, now));
+  // A transport that holds a slot may keep probing.
+  EXPECT_TRUE(coordinator->TryStartProbe(first, now + TimeDelta::Millis(100)));
+
+  // The second slot is free once it expires, or its transport is removed.
+  now += TimeDelta::Millis(500);
+  EXPECT_TRUE(coordinator->TryStartProbe(third, now));
+  EXPECT_FALSE(coordinator->TryStartProbe(second, now));
+  coordinator->RemoveTransport(first);
+  EXPECT_TRUE(coordinator->TryStartProbe(second, now));
+}
+
+TEST(EgressCoordinatorTest, ScalesPacingRatesToCapacity) {
+  EgressCoordinator::Config config;
+  config.capacity = DataRate::KilobitsPerSec(1000);
+  rtc::scoped_refptr<EgressCoordinator> coordinator(
+      new rtc::RefCountedObject<EgressCoordinator>(config));
+  const int first = coordinator->AddTransport();
+  const int second = coordinator->AddTransport();
+  EXPECT_EQ(1.0, coordinator->GetPacingScale());
+
+  coordinator->SetPacingRate(first, DataRate::KilobitsPerSec(600));
+  coordinator->SetPacingRate(second, DataRate::KilobitsPerSec(400));
+  EXPECT_EQ(1.0, coordinator->GetPacingScale());
+  coordinator->SetPacingRate(second, DataRate::KilobitsPerSec(1400));
+  EXPECT_DOUBLE_EQ(0.5, coordinator->GetPacingScale());
+
+  // Unlimited rates do not count.
+  coordinator->SetPacingRate(first, DataRate::PlusInfinity());
+  EXPECT_DOUBLE_EQ(1000.0 / 1400.0, coordinator->GetPacingScale());
+  coordinator->RemoveTransport(second);
+  EXPECT_EQ(1.0, coordinator->GetPacingScale());
+}
+
+}  // namespace webrtc
@@ -84,8 +84,88 @@ bool InFlightBytesTracker::NetworkRouteComparator::operator()(
   return a.connected < b.connected;
 }
 
-TransportFeedbackAdapter::TransportFeedbackAdapter() = default;
+TransportFeedbackAdapter::PacketFeedbackRing::PacketFeedbackRing() = default;
+TransportFeedbackAdapter::PacketFeedbackRing::~PacketFeedbackRing() = default;
+
+PacketFeedback* TransportFeedbackAdapter::PacketFeedbackRing::Find(
+    int64_t seq_num) {
+  if (seq_num < first_seq_num_ ||
+      seq_num >= first_seq_num_ + static_cast<int64_t>(span_)) {
+    return nullptr;
+  }
+  absl::optional<PacketFeedback>& slot = Slot(seq_num - first_seq_num_);
+  return slot ? &*slot : nullptr;
+}
 
+void TransportFeedbackAdapter::PacketFeedbackRing::Insert(
+    const PacketFeedback& packet) {
+  const int64_t seq_num = packet.sent.sequence_number;
+  if (empty()) {
+    first_seq_num_ = seq_num;
+    span_ = 0;
+  }
+  if (seq_num < first_seq_num_) {
+    const size_t shift = static_cast<size_t>(first_seq_num_ - seq_num);
+    Reserve(span_ + shift);
+    head_ = (head_ - shift) & (slots_.size() - 1);
+    first_seq_num_ = seq_num;
+    span_ += shift;
+  } else if (seq_num >= first_seq_num_ + static_cast<int64_t>(span_)) {
+    const size_t span = static_cast<size_t>(seq_num - first_seq_num_ + 1);
+    Reserve(span);
+    span_ = span;
+  }
+  absl::optional<PacketFeedback>& slot = Slot(seq_num - first_seq_num_);
+  if (!slot) {
+    slot = packet;
+    ++num_packets_;
+  }
+}
+
+void TransportFeedbackAdapter::PacketFeedbackRing::Erase(int64_t seq_num) {
+  if (seq_num < first_seq_num_ ||
+      seq_num >= first_seq_num_ + static_cast<int64_t>(span_)) {
+    return;
+  }
+  absl::optional<PacketFeedback>& slot = Slot(seq_num - first_seq_num_);
+  if (!slot) {
+    return;
+  }
+  slot.reset();
+  if (--num_packets_ == 0) {
+    span_ = 0;
+    return;
+  }
+  // Keep both ends of the span on stored packets.
+  while (!Slot(0)) {
+    head_ = (head_ + 1) & (slots_.size() - 1);
+    ++first_seq_num_;
+    --span_;
+  }
+  while (!Slot(span_ - 1)) {
+    --span_;
+  }
+}
+
+void TransportFeedbackAdapter::PacketFeedbackRing::Reserve(size_t span) {
+  static constexpr size_t kMinCapacity = 64;
+  if (span <= slots_.size()) {
+    return;
+  }
+  size_t capacity = std::max(kMinCapacity, slots_.size());
+  while (capacity < span) {
+    capacity *= 2;
+  }
+  // Slots outside the span are always empty, so only the span is moved.
+  std::vector<absl::optional<PacketFeedback>> slots(capacity);
+  for (size_t i = 0; i < span_; ++i) {
+    slots[i] = std::move(Slot(i));
+  }
+  slots_.swap(slots);
+  head_ = 0;
+}
+
+TransportFeedbackAdapter::TransportFeedbackAdapter() = default;
 
 void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
                                          size_t overhead_bytes,
@@ -100,14 +180,14 @@ void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
   packet.sent.pacing_info = packet_info.pacing_info;
 
   while (!history_.empty() &&
-         creation_time - history_.begin()->second.creation_time >
+         creation_time - history_.front().creation_time >
              kSendTimeHistoryWindow) {
     // TODO(sprang): Warn if erasing (too many) old items?
-    if (history_.begin()->second.sent.sequence_number > last_ack_seq_num_)
-      in_flight_.RemoveInFlightPacketBytes(history_.begin()->second);
-    history_.erase(history_.begin());
+    if (history_.front().sent.sequence_number > last_ack_seq_num_)
+      in_flight_.RemoveInFlightPacketBytes(history_.front());
+    history_.pop_front();
   }
-  history_.insert(std::make_pair(packet.sent.sequence_number, packet));
+  history_.Insert(packet);
 }
 
 absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
@@ -117,10 +197,10 @@ absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
   if (sent_packet.info.included_in_feedback || sent_packet.packet_id != -1) {
     int64_t unwrapped_seq_num =
         seq_num_unwrapper_.Unwrap(sent_packet.packet_id);
-    auto it = history_.find(unwrapped_seq_num);
-    if (it != history_.end()) {
-      bool packet_retransmit = it->second.sent.send_time.IsFinite();
-      it->second.sent.send_time = send_time;
+    PacketFeedback* packet = history_.Find(unwrapped_seq_num);
+    if (packet) {
+      bool packet_retransmit = packet->sent.send_time.IsFinite();
+      packet->sent.send_time = send_time;
       last_send_time_ = std::max(last_send_time_, send_time);
       // TODO(srte): Don't do this on retransmit.
       if (!pending_untracked_size_.IsZero()) {
@@ -128,14 +208,14 @@ absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
           RTC_LOG(LS_WARNING)
               << "appending acknowledged data for out of order packet. (Diff: "
               << ToString(last_untracked_send_time_ - send_time) << " ms.)";
-        it->second.sent.prior_unacked_data += pending_untracked_size_;
+        packet->sent.prior_unacked_data += pending_untracked_size_;
         pending_untracked_size_ = DataSize::Zero();
       }
       if (!packet_retransmit) {
-        if (it->second.sent.sequence_number > last_ack_seq_num_)
-          in_flight_.AddInFlightPacketBytes(it->second);
-        it->second.sent.data_in_flight = GetOutstandingData();
-        return it->second.sent;
+        if (packet->sent.sequence_number > last_ack_seq_num_)
+          in_flight_.AddInFlightPacketBytes(*packet);
+        packet->sent.data_in_flight = GetOutstandingData();
+        return packet->sent;
       }
     }
   } else if (sent_packet.info.included_in_allocation) {
@@ -167,9 +247,8 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
   if (msg.packet_feedbacks.empty())
     return absl::nullopt;
 
-  auto it = history_.find(last_ack_seq_num_);
-  if (it != history_.end()) {
-    msg.first_unacked_send_time = it->second.sent.send_time;
+  if (const PacketFeedback* packet = history_.Find(last_ack_seq_num_)) {
+    msg.first_unacked_send_time = packet->sent.send_time;
   }
   msg.data_in_flight = in_flight_.GetOutstandingData(network_route_);
 
@@ -218,22 +297,22 @@ TransportFeedbackAdapter::ProcessTransportFeedbackInner(
     int64_t seq_num = seq_num_unwrapper_.Unwrap(packet.sequence_number());
 
     if (seq_num > last_ack_seq_num_) {
-      // Starts at history_.begin() if last_ack_seq_num_ < 0, since any valid
-      // sequence number is >= 0.
-      for (auto it = history_.upper_bound(last_ack_seq_num_);
-           it != history_.upper_bound(seq_num); ++it) {
-        in_flight_.RemoveInFlightPacketBytes(it->second);
-      }
+      // Starts at the front of the history if last_ack_seq_num_ < 0, since
+      // any valid sequence number is >= 0.
+      history_.ForEachInRange(last_ack_seq_num_, seq_num,
+                              [this](const PacketFeedback& packet) {
+                                in_flight_.RemoveInFlightPacketBytes(packet);
+                              });
       last_ack_seq_num_ = seq_num;
     }
 
-    auto it = history_.find(seq_num);
-    if (it == history_.end()) {
+    const PacketFeedback* sent_packet = history_.Find(seq_num);
+    if (!sent_packet) {
       ++failed_lookups;
       continue;
     }
 
-    if (it->second.sent.send_time.IsInfinite()) {
+    if (sent_packet->sent.send_time.IsInfinite()) {
       // TODO(srte): Fix the tests that makes this happen and make this a
       // DCHECK.
       RTC_DLOG(LS_ERROR)
@@ -241,14 +320,14 @@ TransportFeedbackAdapter::ProcessTransportFeedbackInner(
       continue;
     }
 
-    PacketFeedback packet_feedback = it->second;
+    PacketFeedback packet_feedback = *sent_packet;
     if (packet.received()) {
       packet_offset += packet.delta();
       packet_feedback.receive_time =
           current_offset_ + packet_offset.RoundDownTo(TimeDelta::Millis(1));
       // Note: Lost packets are not removed from history because they might be
       // reported as received by a later feedback.
-      history_.erase(it);
+      history_.Erase(seq_num);
     }
     if (packet_feedback.network_route == network_route_) {
       PacketResult result;
@@ -11,11 +11,13 @@
 #ifndef MODULES_CONGESTION_CONTROLLER_RTP_TRANSPORT_FEEDBACK_ADAPTER_H_
 #define MODULES_CONGESTION_CONTROLLER_RTP_TRANSPORT_FEEDBACK_ADAPTER_H_
 
+#include <algorithm>
 #include <deque>
 #include <map>
 #include <utility>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "api/transport/network_types.h"
 #include "modules/include/module_common_types_public.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -76,6 +78,61 @@ class TransportFeedbackAdapter {
  private:
   enum class SendTimeHistoryStatus { kNotAdded, kOk, kDuplicate };
 
+  // Ring buffer of packets indexed by unwrapped transport sequence number,
+  // with constant time insertion, lookup and removal. It spans the sequence
+  // numbers from the lowest to the highest stored one. Storage is contiguous
+  // and only grows, so a history that has reached its steady state size
+  // stores packets without allocating.
+  class PacketFeedbackRing {
+   public:
+    PacketFeedbackRing();
+    ~PacketFeedbackRing();
+
+    bool empty() const { return num_packets_ == 0; }
+    // The packet with the lowest sequence number. Must not be empty.
+    PacketFeedback& front() { return *Slot(0); }
+
+    // Returns the packet with |seq_num|, or null if there is none.
+    PacketFeedback* Find(int64_t seq_num);
+    // Adds |packet|, unless a packet with its sequence number is stored.
+    void Insert(const PacketFeedback& packet);
+    // Removes the packet with |seq_num|, if any.
+    void Erase(int64_t seq_num);
+    void pop_front() { Erase(first_seq_num_); }
+
+    // Calls |f| with the stored packets with sequence numbers in
+    // (|after_seq_num|, |up_to_seq_num|], in order.
+    template <typename F>
+    void ForEachInRange(int64_t after_seq_num, int64_t up_to_seq_num, F f) {
+      const int64_t begin = std::max(after_seq_num + 1, first_seq_num_);
+      const int64_t end =
+          std::min(up_to_seq_num + 1,
+                   first_seq_num_ + static_cast<int64_t>(span_));
+      for (int64_t seq_num = begin; seq_num < end; ++seq_num) {
+        absl::optional<PacketFeedback>& slot = Slot(seq_num - first_seq_num_);
+        if (slot) {
+          f(*slot);
+        }
+      }
+    }
+
+   private:
+    absl::optional<PacketFeedback>& Slot(int64_t index) {
+      return slots_[(head_ + index) & (slots_.size() - 1)];
+    }
+    // Makes room for a span of |span| sequence numbers.
+    void Reserve(size_t span);
+
+    // Size is zero or a power of two.
+    std::vector<absl::optional<PacketFeedback>> slots_;
+    size_t head_ = 0;
+    // The sequence number of the slot at |head_|, and the number of sequence
+    // numbers from it to the highest stored one.
+    int64_t first_seq_num_ = 0;
+    size_t span_ = 0;
+    size_t num_packets_ = 0;
+  };
+
   std::vector<PacketResult> ProcessTransportFeedbackInner(
       const rtcp::TransportFeedback& feedback,
       Timestamp feedback_receive_time);
@@ -84,7 +141,7 @@ class TransportFeedbackAdapter {
   Timestamp last_send_time_ = Timestamp::MinusInfinity();
   Timestamp last_untracked_send_time_ = Timestamp::MinusInfinity();
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+  PacketFeedbackRing history_;
 
   // Sequence numbers are never negative, using -1 as it always < a real
   // sequence number.
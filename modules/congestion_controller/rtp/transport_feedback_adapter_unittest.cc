@@ -17,7 +17,9 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
@@ -412,6 +414,87 @@ TEST_F(TransportFeedbackAdapterTest, IgnoreDuplicatePacketSentCalls) {
   EXPECT_FALSE(duplicate_packet.has_value());
 }
 
+TEST_F(TransportFeedbackAdapterTest, ReportsLostPacketsReceivedLater) {
+  // Enough packets for the history to grow a few times.
+  const int kNumPackets = 200;
+  std::vector<PacketResult> packets;
+  for (int i = 0; i < kNumPackets; ++i) {
+    packets.push_back(CreatePacket(1000 + i, 100 + i, i, 1500, kPacingInfo0));
+    OnSentPacket(packets.back());
+  }
+
+  // The first feedback reports every odd packet as lost. They are kept in the
+  // history, and found when a later feedback reports them as received.
+  rtcp::TransportFeedback even_feedback;
+  even_feedback.SetBase(0, packets[0].receive_time.us());
+  for (int i = 0; i < kNumPackets; i += 2) {
+    EXPECT_TRUE(
+        even_feedback.AddReceivedPacket(i, packets[i].receive_time.us()));
+  }
+  even_feedback.Build();
+  auto res =
+      adapter_->ProcessTransportFeedback(even_feedback, clock_.CurrentTime());
+  ASSERT_TRUE(res.has_value());
+  EXPECT_EQ(static_cast<size_t>(kNumPackets / 2),
+            res->ReceivedWithSendInfo().size());
+
+  rtcp::TransportFeedback odd_feedback;
+  odd_feedback.SetBase(1, packets[1].receive_time.us());
+  std::vector<PacketResult> odd_packets;
+  for (int i = 1; i < kNumPackets; i += 2) {
+    EXPECT_TRUE(
+        odd_feedback.AddReceivedPacket(i, packets[i].receive_time.us()));
+    odd_packets.push_back(packets[i]);
+  }
+  odd_feedback.Build();
+  res = adapter_->ProcessTransportFeedback(odd_feedback, clock_.CurrentTime());
+  ASSERT_TRUE(res.has_value());
+  // The even packets were removed when they were reported as received.
+  ComparePacketFeedbackVectors(odd_packets, res->packet_feedbacks);
+}
+
+TEST_F(TransportFeedbackAdapterTest,
+       DISABLED_BenchmarkProcessTransportFeedback) {
+  constexpr int kNumFeedbacks = 1000;
+  // Large feedback, as sent for high rate video with a long RTCP interval.
+  constexpr int kPacketsPerFeedback = 2000;
+
+  int64_t process_us = 0;
+  int64_t seq_num = 0;
+  for (int i = 0; i < kNumFeedbacks; ++i) {
+    rtcp::TransportFeedback feedback;
+    const int64_t base_seq_num = seq_num;
+    for (int j = 0; j < kPacketsPerFeedback; ++j, ++seq_num) {
+      PacketResult packet =
+          CreatePacket(seq_num + 1000, seq_num, seq_num, 1200, kPacingInfo0);
+      OnSentPacket(packet);
+      if (j == 0) {
+        feedback.SetBase(static_cast<uint16_t>(seq_num),
+                         packet.receive_time.us());
+      }
+      // Every tenth packet is lost.
+      if (j % 10 != 9) {
+        ASSERT_TRUE(feedback.AddReceivedPacket(
+            static_cast<uint16_t>(seq_num), packet.receive_time.us()));
+      }
+    }
+    feedback.Build();
+    clock_.AdvanceTimeMilliseconds(kPacketsPerFeedback);
+
+    const int64_t start_us = rtc::TimeMicros();
+    auto res =
+        adapter_->ProcessTransportFeedback(feedback, clock_.CurrentTime());
+    process_us += rtc::TimeMicros() - start_us;
+    ASSERT_TRUE(res.has_value());
+    ASSERT_EQ(base_seq_num,
+              res->packet_feedbacks.front().sent_packet.sequence_number);
+  }
+
+  RTC_LOG(LS_INFO) << "Feedback packets per second: "
+                   << kNumFeedbacks * rtc::kNumMicrosecsPerSec / process_us
+                   << ", with " << kPacketsPerFeedback << " packets each";
+}
+
 }  // namespace test
 }  // namespace webrtc_cc
 }  // namespace webrtc
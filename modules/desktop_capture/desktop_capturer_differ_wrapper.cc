@@ -13,18 +13,25 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "modules/desktop_capture/desktop_geometry.h"
 #include "modules/desktop_capture/desktop_region.h"
 #include "modules/desktop_capture/differ_block.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/time_utils.h"
 
 namespace webrtc {
 
 namespace {
 
+// Bands are diffed on separate threads only if each of them has at least this
+// many block-rows, so that small updated areas aren't slowed down.
+constexpr int kMinBlockRowsPerBand = 4;
+
 // Returns true if (0, 0) - (|width|, |height|) vector in |old_buffer| and
 // |new_buffer| are equal. |width| should be less than 32
 // (defined by kBlockSize), otherwise BlockDifference() should be used.
@@ -150,6 +157,20 @@ DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
   RTC_DCHECK(base_capturer_);
 }
 
+DesktopCapturerDifferWrapper::DesktopCapturerDifferWrapper(
+    std::unique_ptr<DesktopCapturer> base_capturer,
+    TaskQueueFactory* task_queue_factory,
+    int num_bands)
+    : DesktopCapturerDifferWrapper(std::move(base_capturer)) {
+  RTC_DCHECK(task_queue_factory);
+  RTC_DCHECK_GE(num_bands, 1);
+  for (int i = 1; i < num_bands; ++i) {
+    band_queues_.push_back(
+        std::make_unique<rtc::TaskQueue>(task_queue_factory->CreateTaskQueue(
+            "DesktopCapturerDiffer", TaskQueueFactory::Priority::NORMAL)));
+  }
+}
+
 DesktopCapturerDifferWrapper::~DesktopCapturerDifferWrapper() {}
 
 void DesktopCapturerDifferWrapper::Start(DesktopCapturer::Callback* callback) {
@@ -208,8 +229,8 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
     DesktopRegion hints;
     hints.Swap(frame->mutable_updated_region());
     for (DesktopRegion::Iterator it(hints); !it.IsAtEnd(); it.Advance()) {
-      CompareFrames(*last_frame_, *frame, it.rect(),
-                    frame->mutable_updated_region());
+      CompareFramesInBands(*last_frame_, *frame, it.rect(),
+                           frame->mutable_updated_region());
     }
   } else {
     frame->mutable_updated_region()->SetRect(
@@ -223,4 +244,50 @@ void DesktopCapturerDifferWrapper::OnCaptureResult(
   callback_->OnCaptureResult(result, std::move(frame));
 }
 
+void DesktopCapturerDifferWrapper::CompareFramesInBands(
+    const DesktopFrame& old_frame,
+    const DesktopFrame& new_frame,
+    DesktopRect rect,
+    DesktopRegion* output) {
+  rect.IntersectWith(DesktopRect::MakeSize(old_frame.size()));
+  const int y_block_count = (rect.height() + kBlockSize - 1) / kBlockSize;
+  const int num_bands =
+      std::min(static_cast<int>(band_queues_.size()) + 1,
+               y_block_count / kMinBlockRowsPerBand);
+  if (num_bands <= 1) {
+    CompareFrames(old_frame, new_frame, rect, output);
+    return;
+  }
+
+  // Bands start at block-row boundaries of |rect|, so that the blocks are the
+  // same as when diffing |rect| at once. DesktopRegion merges the adjacent
+  // rects of the bands.
+  auto band_rect = [&rect, y_block_count, num_bands](int band) {
+    const int top = rect.top() + y_block_count * band / num_bands * kBlockSize;
+    const int bottom =
+        band == num_bands - 1
+            ? rect.bottom()
+            : rect.top() + y_block_count * (band + 1) / num_bands * kBlockSize;
+    return DesktopRect::MakeLTRB(rect.left(), top, rect.right(), bottom);
+  };
+  std::vector<DesktopRegion> band_regions(num_bands);
+  std::atomic<int> pending_bands(num_bands - 1);
+  rtc::Event done;
+  for (int band = 1; band < num_bands; ++band) {
+    band_queues_[band - 1]->PostTask([&, band] {
+      CompareFrames(old_frame, new_frame, band_rect(band),
+                    &band_regions[band]);
+      if (--pending_bands == 0) {
+        done.Set();
+      }
+    });
+  }
+  CompareFrames(old_frame, new_frame, band_rect(0), &band_regions[0]);
+  done.Wait(rtc::Event::kForever);
+
+  for (const DesktopRegion& band_region : band_regions) {
+    output->AddRegion(band_region);
+  }
+}
+
 }  // namespace webrtc
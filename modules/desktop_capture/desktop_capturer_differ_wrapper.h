@@ -12,7 +12,9 @@
 #define MODULES_DESKTOP_CAPTURE_DESKTOP_CAPTURER_DIFFER_WRAPPER_H_
 
 #include <memory>
+#include <vector>
 
+#include "api/task_queue/task_queue_factory.h"
 #include "modules/desktop_capture/desktop_capture_types.h"
 #include "modules/desktop_capture/desktop_capturer.h"
 #include "modules/desktop_capture/desktop_frame.h"
@@ -20,6 +22,7 @@
 #include "modules/desktop_capture/shared_desktop_frame.h"
 #include "modules/desktop_capture/shared_memory.h"
 #include "rtc_base/system/rtc_export.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -40,6 +43,14 @@ class RTC_EXPORT DesktopCapturerDifferWrapper
   explicit DesktopCapturerDifferWrapper(
       std::unique_ptr<DesktopCapturer> base_capturer);
 
+  // Same as above, but splits large updated areas into up to |num_bands|
+  // horizontal bands, which are diffed in parallel on task queues created
+  // with |task_queue_factory|. The updated_region() is the same as the one
+  // diffed on a single thread.
+  DesktopCapturerDifferWrapper(std::unique_ptr<DesktopCapturer> base_capturer,
+                               TaskQueueFactory* task_queue_factory,
+                               int num_bands);
+
   ~DesktopCapturerDifferWrapper() override;
 
   // DesktopCapturer interface.
@@ -58,9 +69,18 @@ class RTC_EXPORT DesktopCapturerDifferWrapper
   void OnCaptureResult(Result result,
                        std::unique_ptr<DesktopFrame> frame) override;
 
+  // Compares |rect| area in |old_frame| and |new_frame|, and outputs dirty
+  // regions into |output|, using |band_queues_| for large areas.
+  void CompareFramesInBands(const DesktopFrame& old_frame,
+                            const DesktopFrame& new_frame,
+                            DesktopRect rect,
+                            DesktopRegion* output);
+
   const std::unique_ptr<DesktopCapturer> base_capturer_;
   DesktopCapturer::Callback* callback_;
   std::unique_ptr<SharedDesktopFrame> last_frame_;
+  // Diff all bands but the first, which is diffed on the capture thread.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> band_queues_;
 };
 
 }  // namespace webrtc
@@ -15,6 +15,8 @@
 #include <utility>
 #include <vector>
 
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "modules/desktop_capture/desktop_geometry.h"
 #include "modules/desktop_capture/desktop_region.h"
 #include "modules/desktop_capture/differ_block.h"
@@ -150,10 +152,13 @@ void ExecuteCapturer(DesktopCapturerDifferWrapper* capturer,
   capturer->CaptureFrame();
 }
 
+// Diffs in |num_bands| bands in parallel if |task_queue_factory| is set.
 void ExecuteDifferWrapperTest(bool with_hints,
                               bool enlarge_updated_region,
                               bool random_updated_region,
-                              bool check_result) {
+                              bool check_result,
+                              TaskQueueFactory* task_queue_factory = nullptr,
+                              int num_bands = 1) {
   const bool updated_region_should_exactly_match =
       with_hints && !enlarge_updated_region && !random_updated_region;
   BlackWhiteDesktopFramePainter frame_painter;
@@ -161,7 +166,12 @@ void ExecuteDifferWrapperTest(bool with_hints,
   frame_generator.set_desktop_frame_painter(&frame_painter);
   std::unique_ptr<FakeDesktopCapturer> fake(new FakeDesktopCapturer());
   fake->set_frame_generator(&frame_generator);
-  DesktopCapturerDifferWrapper capturer(std::move(fake));
+  std::unique_ptr<DesktopCapturerDifferWrapper> differ_wrapper =
+      task_queue_factory
+          ? std::make_unique<DesktopCapturerDifferWrapper>(
+                std::move(fake), task_queue_factory, num_bands)
+          : std::make_unique<DesktopCapturerDifferWrapper>(std::move(fake));
+  DesktopCapturerDifferWrapper& capturer = *differ_wrapper;
   MockDesktopCapturerCallback callback;
   frame_generator.set_provide_updated_region_hints(with_hints);
   frame_generator.set_enlarge_updated_region(enlarge_updated_region);
@@ -244,6 +254,20 @@ TEST(DesktopCapturerDifferWrapperTest, CaptureWithEnlargedAndRandomHints) {
   ExecuteDifferWrapperTest(true, true, true, true);
 }
 
+TEST(DesktopCapturerDifferWrapperTest, CaptureInBandsWithoutHints) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  ExecuteDifferWrapperTest(false, false, false, true, task_queue_factory.get(),
+                           /*num_bands=*/4);
+}
+
+TEST(DesktopCapturerDifferWrapperTest, CaptureInBandsWithHints) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  ExecuteDifferWrapperTest(true, false, false, true, task_queue_factory.get(),
+                           /*num_bands=*/4);
+}
+
 // When hints are provided, DesktopCapturerDifferWrapper has a slightly better
 // performance in current configuration, but not so significant. Following is
 // one run result.
@@ -288,4 +312,14 @@ TEST(DesktopCapturerDifferWrapperTest,
   ASSERT_LE(rtc::TimeMillis() - started, 15000);
 }
 
+TEST(DesktopCapturerDifferWrapperTest,
+     DISABLED_CaptureInBandsWithoutHintsPerf) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  int64_t started = rtc::TimeMillis();
+  ExecuteDifferWrapperTest(false, false, false, false,
+                           task_queue_factory.get(), /*num_bands=*/4);
+  ASSERT_LE(rtc::TimeMillis() - started, 15000);
+}
+
 }  // namespace webrtc
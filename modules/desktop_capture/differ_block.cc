@@ -12,50 +12,67 @@
 
 #include <string.h>
 
-#include "modules/desktop_capture/differ_vector_sse2.h"
 #include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/desktop_capture/differ_vector_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/desktop_capture/differ_vector_avx2.h"
+#include "modules/desktop_capture/differ_vector_sse2.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
 
 namespace webrtc {
 
 namespace {
 
+using VectorDifferenceFunction = bool (*)(const uint8_t*, const uint8_t*);
+
 bool VectorDifference_C(const uint8_t* image1, const uint8_t* image2) {
   return memcmp(image1, image2, kBlockSize * kBytesPerPixel) != 0;
 }
 
-}  // namespace
-
-bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
-  static bool (*diff_proc)(const uint8_t*, const uint8_t*) = nullptr;
-
-  if (!diff_proc) {
-#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
-    // For ARM and MIPS processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
-    diff_proc = &VectorDifference_C;
+VectorDifferenceFunction SelectVectorDifference() {
+  static_assert(kBlockSize == 16 || kBlockSize == 32,
+                "The SIMD versions only handle blocks of 16 or 32 pixels.");
+#if defined(WEBRTC_HAS_NEON)
+  return kBlockSize == 32 ? &VectorDifference_NEON_W32
+                          : &VectorDifference_NEON_W16;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    return kBlockSize == 32 ? &VectorDifference_AVX2_W32
+                            : &VectorDifference_AVX2_W16;
+  }
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    return kBlockSize == 32 ? &VectorDifference_SSE2_W32
+                            : &VectorDifference_SSE2_W16;
+  }
+  return &VectorDifference_C;
 #else
-    bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
-      diff_proc = &VectorDifference_SSE2_W32;
-    } else if (have_sse2 && kBlockSize == 16) {
-      diff_proc = &VectorDifference_SSE2_W16;
-    } else {
-      diff_proc = &VectorDifference_C;
-    }
+  // For MIPS processors, always use C version.
+  return &VectorDifference_C;
 #endif
-  }
+}
 
-  return diff_proc(image1, image2);
+// Initialized once, so that frames can be diffed on several threads.
+VectorDifferenceFunction GetVectorDifference() {
+  static const VectorDifferenceFunction diff_proc = SelectVectorDifference();
+  return diff_proc;
+}
+
+}  // namespace
+
+bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
+  return GetVectorDifference()(image1, image2);
 }
 
 bool BlockDifference(const uint8_t* image1,
                      const uint8_t* image2,
                      int height,
                      int stride) {
+  const VectorDifferenceFunction diff_proc = GetVectorDifference();
   for (int i = 0; i < height; i++) {
-    if (VectorDifference(image1, image2)) {
+    if (diff_proc(image1, image2)) {
       return true;
     }
     image1 += stride;
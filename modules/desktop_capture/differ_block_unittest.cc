@@ -12,8 +12,17 @@
 
 #include <string.h>
 
+#include "rtc_base/system/arch.h"
 #include "test/gtest.h"
 
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/desktop_capture/differ_vector_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/desktop_capture/differ_vector_avx2.h"
+#include "modules/desktop_capture/differ_vector_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
 namespace webrtc {
 
 // Run 900 times to mimic 1280x720.
@@ -86,4 +95,40 @@ TEST(BlockDifferenceTestFirst, BlockDifference) {
   }
 }
 
+// Checks that |diff_proc| finds a difference in every byte of a vector of
+// kBlockSize pixels, and no difference in equal vectors.
+void TestVectorDifference(bool (*diff_proc)(const uint8_t*, const uint8_t*)) {
+  uint8_t* block1;
+  uint8_t* block2;
+  PrepareBuffers(block1, block2);
+  // Start at an odd address, to check unaligned loads.
+  block1 += 1;
+  block2 += 1;
+  EXPECT_FALSE(diff_proc(block1, block2));
+  for (int i = 0; i < kBlockSize * kBytesPerPixel; ++i) {
+    block2[i] += 1;
+    EXPECT_TRUE(diff_proc(block1, block2)) << "Byte " << i;
+    block2[i] -= 1;
+  }
+  EXPECT_FALSE(diff_proc(block1, block2));
+}
+
+#if defined(WEBRTC_HAS_NEON)
+TEST(VectorDifferenceTest, Neon) {
+  TestVectorDifference(&VectorDifference_NEON_W32);
+}
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(VectorDifferenceTest, Sse2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    TestVectorDifference(&VectorDifference_SSE2_W32);
+  }
+}
+
+TEST(VectorDifferenceTest, Avx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    TestVectorDifference(&VectorDifference_AVX2_W32);
+  }
+}
+#endif
+
 }  // namespace webrtc
@@ -0,0 +1,44 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/differ_vector_avx2.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns whether the |num_vectors| 256-bit vectors starting at |image1| and
+// |image2| differ.
+bool VectorDifference_AVX2(const uint8_t* image1,
+                           const uint8_t* image2,
+                           int num_vectors) {
+  const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+  const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+  __m256i acc = _mm256_setzero_si256();
+  for (int i = 0; i < num_vectors; ++i) {
+    acc = _mm256_or_si256(acc, _mm256_xor_si256(_mm256_loadu_si256(i1 + i),
+                                                _mm256_loadu_si256(i2 + i)));
+  }
+  return _mm256_testz_si256(acc, acc) == 0;
+}
+
+}  // namespace
+
+bool VectorDifference_AVX2_W16(const uint8_t* image1, const uint8_t* image2) {
+  return VectorDifference_AVX2(image1, image2, 2);
+}
+
+bool VectorDifference_AVX2_W32(const uint8_t* image1, const uint8_t* image2) {
+  return VectorDifference_AVX2(image1, image2, 4);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/differ_vector_neon.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns whether the |num_vectors| 128-bit vectors starting at |image1| and
+// |image2| differ.
+bool VectorDifference_NEON(const uint8_t* image1,
+                           const uint8_t* image2,
+                           int num_vectors) {
+  uint8x16_t acc = vdupq_n_u8(0);
+  for (int i = 0; i < num_vectors; ++i) {
+    acc = vorrq_u8(acc, veorq_u8(vld1q_u8(image1 + i * 16),
+                                 vld1q_u8(image2 + i * 16)));
+  }
+  const uint64x2_t acc64 = vreinterpretq_u64_u8(acc);
+  return (vgetq_lane_u64(acc64, 0) | vgetq_lane_u64(acc64, 1)) != 0;
+}
+
+}  // namespace
+
+bool VectorDifference_NEON_W16(const uint8_t* image1, const uint8_t* image2) {
+  return VectorDifference_NEON(image1, image2, 4);
+}
+
+bool VectorDifference_NEON_W32(const uint8_t* image1, const uint8_t* image2) {
+  return VectorDifference_NEON(image1, image2, 8);
+}
+
+}  // namespace webrtc
@@ -12,19 +12,27 @@
 
 #include <gio/gunixfdlist.h>
 #include <glib-object.h>
+#include <errno.h>
+#include <linux/dma-buf.h>
 #include <spa/param/format-utils.h>
 #include <spa/param/props.h>
 #include <spa/param/video/raw-utils.h>
 #include <spa/support/type-map.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "modules/desktop_capture/desktop_capture_options.h"
 #include "modules/desktop_capture/desktop_capturer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/ref_counted_object.h"
 
 #if defined(WEBRTC_DLOPEN_PIPEWIRE)
 #include "modules/desktop_capture/linux/pipewire_stubs.h"
@@ -50,6 +58,153 @@ const int kBytesPerPixel = 4;
 const char kPipeWireLib[] = "libpipewire-0.2.so.1";
 #endif
 
+// A buffer of the stream backed by a memfd or a DMA-BUF, mapped by the
+// capturer. The mapping is independent of the stream, so frames wrapping the
+// buffer stay valid when the stream removes it, e.g. on a format change.
+class PipeWireMappedBuffer : public rtc::RefCountInterface {
+ public:
+  static rtc::scoped_refptr<PipeWireMappedBuffer> Create(pw_buffer* buffer,
+                                                         bool is_dma_buf) {
+    const spa_data& data = buffer->buffer->datas[0];
+    size_t size = data.mapoffset + data.maxsize;
+    // Consumers of desktop frames may draw into them, e.g. the mouse cursor,
+    // which needs a writable mapping. Producers that seal their buffers
+    // against writes get a read-only one, and their frames are copied.
+    bool writable = true;
+    void* map = mmap(/*addr=*/nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, data.fd, 0);
+    if (map == MAP_FAILED) {
+      writable = false;
+      map = mmap(/*addr=*/nullptr, size, PROT_READ, MAP_SHARED, data.fd, 0);
+    }
+    if (map == MAP_FAILED) {
+      RTC_LOG(LS_ERROR) << "Failed to mmap the PipeWire buffer: " << errno;
+      return nullptr;
+    }
+    int dma_buf_fd = is_dma_buf ? dup(data.fd) : -1;
+    return new rtc::RefCountedObject<PipeWireMappedBuffer>(
+        buffer, static_cast<uint8_t*>(map), size, writable, dma_buf_fd);
+  }
+
+  pw_buffer* buffer() const { return buffer_; }
+  uint8_t* data() const { return map_ + buffer_->buffer->datas[0].mapoffset; }
+  bool writable() const { return writable_; }
+
+  // Accesses to a DMA-BUF by the CPU have to be bracketed by these calls, so
+  // that the driver keeps the caches coherent with the GPU.
+  void BeginCpuAccess() { SyncDmaBuf(DMA_BUF_SYNC_START); }
+  void EndCpuAccess() { SyncDmaBuf(DMA_BUF_SYNC_END); }
+
+ protected:
+  PipeWireMappedBuffer(pw_buffer* buffer,
+                       uint8_t* map,
+                       size_t map_size,
+                       bool writable,
+                       int dma_buf_fd)
+      : buffer_(buffer),
+        map_(map),
+        map_size_(map_size),
+        writable_(writable),
+        dma_buf_fd_(dma_buf_fd) {}
+  ~PipeWireMappedBuffer() override {
+    munmap(map_, map_size_);
+    if (dma_buf_fd_ >= 0) {
+      close(dma_buf_fd_);
+    }
+  }
+
+ private:
+  void SyncDmaBuf(uint64_t flags) {
+    if (dma_buf_fd_ < 0) {
+      return;
+    }
+    dma_buf_sync sync = {
+        flags | (writable_ ? DMA_BUF_SYNC_RW : DMA_BUF_SYNC_READ)};
+    while (ioctl(dma_buf_fd_, DMA_BUF_IOCTL_SYNC, &sync) == -1 &&
+           (errno == EINTR || errno == EAGAIN)) {
+    }
+  }
+
+  // Only compared and handed back to the stream on the PipeWire thread, while
+  // the buffer is part of the stream.
+  pw_buffer* const buffer_;
+  uint8_t* const map_;
+  const size_t map_size_;
+  const bool writable_;
+  // A duplicate of the descriptor of the buffer, or -1 if it is not a
+  // DMA-BUF.
+  const int dma_buf_fd_;
+};
+
+// Collects the buffers released by frames on any thread, and wakes up the
+// PipeWire thread to queue them back to the stream.
+class PipeWireBufferReturner : public rtc::RefCountInterface {
+ public:
+  PipeWireBufferReturner(pw_loop* loop, spa_source* event)
+      : loop_(loop), event_(event) {}
+
+  void Return(rtc::scoped_refptr<PipeWireMappedBuffer> buffer) {
+    rtc::CritScope lock(&crit_);
+    if (!event_) {
+      return;
+    }
+    returned_buffers_.push_back(std::move(buffer));
+    pw_loop_signal_event(loop_, event_);
+  }
+
+  std::vector<rtc::scoped_refptr<PipeWireMappedBuffer>> TakeReturned() {
+    std::vector<rtc::scoped_refptr<PipeWireMappedBuffer>> returned;
+    rtc::CritScope lock(&crit_);
+    returned.swap(returned_buffers_);
+    return returned;
+  }
+
+  // Called before the loop is destroyed. Buffers released afterwards are
+  // dropped.
+  void Detach() {
+    rtc::CritScope lock(&crit_);
+    event_ = nullptr;
+    returned_buffers_.clear();
+  }
+
+ private:
+  pw_loop* const loop_;
+  rtc::CriticalSection crit_;
+  spa_source* event_ RTC_GUARDED_BY(crit_);
+  std::vector<rtc::scoped_refptr<PipeWireMappedBuffer>> returned_buffers_
+      RTC_GUARDED_BY(crit_);
+};
+
+namespace {
+
+// Wraps a mapped buffer of the stream without copying its pixels. The buffer is
+// held, i.e. not written by the producer, until the frame is released.
+class PipeWireBufferFrame : public DesktopFrame {
+ public:
+  PipeWireBufferFrame(DesktopSize size,
+                      int stride,
+                      uint8_t* data,
+                      rtc::scoped_refptr<PipeWireMappedBuffer> buffer,
+                      rtc::scoped_refptr<PipeWireBufferReturner> returner)
+      : DesktopFrame(size, stride, data, nullptr),
+        buffer_(std::move(buffer)),
+        returner_(std::move(returner)) {
+    buffer_->BeginCpuAccess();
+  }
+  ~PipeWireBufferFrame() override {
+    buffer_->EndCpuAccess();
+    returner_->Return(std::move(buffer_));
+  }
+
+ private:
+  rtc::scoped_refptr<PipeWireMappedBuffer> buffer_;
+  const rtc::scoped_refptr<PipeWireBufferReturner> returner_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PipeWireBufferFrame);
+};
+
+}  // namespace
+
 // static
 void BaseCapturerPipeWire::OnStateChanged(void* data,
                                           pw_remote_state old_state,
@@ -170,19 +325,66 @@ void BaseCapturerPipeWire::OnStreamProcess(void* data) {
     return;
   }
 
-  that->HandleBuffer(buf);
+  if (!that->HandleBuffer(buf)) {
+    pw_stream_queue_buffer(that->pw_stream_, buf);
+  }
+}
+
+// static
+void BaseCapturerPipeWire::OnStreamAddBuffer(void* data, pw_buffer* buffer) {
+  BaseCapturerPipeWire* that = static_cast<BaseCapturerPipeWire*>(data);
+  RTC_DCHECK(that);
 
-  pw_stream_queue_buffer(that->pw_stream_, buf);
+  const spa_data& spaData = buffer->buffer->datas[0];
+  const bool is_dma_buf = spaData.type == that->pw_core_type_->data.DmaBuf;
+  if (!is_dma_buf && spaData.type != that->pw_core_type_->data.MemFd) {
+    // Plain memory is read through |spaData.data|.
+    return;
+  }
+  rtc::scoped_refptr<PipeWireMappedBuffer> mapped =
+      PipeWireMappedBuffer::Create(buffer, is_dma_buf);
+  if (mapped) {
+    that->mapped_buffers_[buffer] = mapped;
+  }
+}
+
+// static
+void BaseCapturerPipeWire::OnStreamRemoveBuffer(void* data,
+                                                pw_buffer* buffer) {
+  BaseCapturerPipeWire* that = static_cast<BaseCapturerPipeWire*>(data);
+  RTC_DCHECK(that);
+
+  // Frames still wrapping the buffer keep their mapping, but the buffer is not
+  // queued back once they are released.
+  that->mapped_buffers_.erase(buffer);
+}
+
+// static
+void BaseCapturerPipeWire::OnBuffersReturned(void* data, uint64_t count) {
+  BaseCapturerPipeWire* that = static_cast<BaseCapturerPipeWire*>(data);
+  RTC_DCHECK(that);
+
+  that->QueueReturnedBuffers();
 }
 
 BaseCapturerPipeWire::BaseCapturerPipeWire(CaptureSourceType source_type)
     : capture_source_type_(source_type) {}
 
 BaseCapturerPipeWire::~BaseCapturerPipeWire() {
+  if (buffer_returner_) {
+    buffer_returner_->Detach();
+  }
+
   if (pw_main_loop_) {
     pw_thread_loop_stop(pw_main_loop_);
   }
 
+  {
+    rtc::CritScope lock(&latest_frame_lock_);
+    latest_frame_.reset();
+  }
+  mapped_buffers_.clear();
+
   if (pw_type_) {
     delete pw_type_;
   }
@@ -211,10 +413,6 @@ BaseCapturerPipeWire::~BaseCapturerPipeWire() {
     pw_loop_destroy(pw_loop_);
   }
 
-  if (current_frame_) {
-    free(current_frame_);
-  }
-
   if (start_request_signal_id_) {
     g_dbus_connection_signal_unsubscribe(connection_, start_request_signal_id_);
   }
@@ -300,8 +498,13 @@ void BaseCapturerPipeWire::InitPipeWire() {
   pw_stream_events_.version = PW_VERSION_STREAM_EVENTS;
   pw_stream_events_.state_changed = &OnStreamStateChanged;
   pw_stream_events_.format_changed = &OnStreamFormatChanged;
+  pw_stream_events_.add_buffer = &OnStreamAddBuffer;
+  pw_stream_events_.remove_buffer = &OnStreamRemoveBuffer;
   pw_stream_events_.process = &OnStreamProcess;
 
+  buffer_returner_ = new rtc::RefCountedObject<PipeWireBufferReturner>(
+      pw_loop_, pw_loop_add_event(pw_loop_, &OnBuffersReturned, this));
+
   pw_remote_add_listener(pw_remote_, &spa_remote_listener_, &pw_remote_events_,
                          this);
   pw_remote_connect_fd(pw_remote_, pw_fd_);
@@ -367,9 +570,9 @@ void BaseCapturerPipeWire::CreateReceivingStream() {
 
   pw_stream_add_listener(pw_stream_, &spa_stream_listener_, &pw_stream_events_,
                          this);
+  // Buffers backed by a file descriptor are mapped in OnStreamAddBuffer().
   pw_stream_flags flags = static_cast<pw_stream_flags>(
-      PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_INACTIVE |
-      PW_STREAM_FLAG_MAP_BUFFERS);
+      PW_STREAM_FLAG_AUTOCONNECT | PW_STREAM_FLAG_INACTIVE);
   if (pw_stream_connect(pw_stream_, PW_DIRECTION_INPUT, /*port_path=*/nullptr,
                         flags, params,
                         /*n_params=*/1) != 0) {
@@ -379,39 +582,75 @@ void BaseCapturerPipeWire::CreateReceivingStream() {
   }
 }
 
-void BaseCapturerPipeWire::HandleBuffer(pw_buffer* buffer) {
+bool BaseCapturerPipeWire::HandleBuffer(pw_buffer* buffer) {
   spa_buffer* spaBuffer = buffer->buffer;
-  void* src = nullptr;
+  rtc::scoped_refptr<PipeWireMappedBuffer> mapped;
+  uint8_t* src = nullptr;
 
-  if (!(src = spaBuffer->datas[0].data)) {
-    return;
+  auto it = mapped_buffers_.find(buffer);
+  if (it != mapped_buffers_.end()) {
+    mapped = it->second;
+    src = mapped->data();
+  } else {
+    src = static_cast<uint8_t*>(spaBuffer->datas[0].data);
+  }
+  if (!src) {
+    return false;
   }
+  src += spaBuffer->datas[0].chunk->offset;
 
-  uint32_t maxSize = spaBuffer->datas[0].maxsize;
   int32_t srcStride = spaBuffer->datas[0].chunk->stride;
   if (srcStride != (desktop_size_.width() * kBytesPerPixel)) {
     RTC_LOG(LS_ERROR) << "Got buffer with stride different from screen stride: "
                       << srcStride
                       << " != " << (desktop_size_.width() * kBytesPerPixel);
     portal_init_failed_ = true;
-    return;
-  }
-
-  if (!current_frame_) {
-    current_frame_ = static_cast<uint8_t*>(malloc(maxSize));
+    return false;
   }
-  RTC_DCHECK(current_frame_ != nullptr);
 
   // If both sides decided to go with the RGBx format we need to convert it to
-  // BGRx to match color format expected by WebRTC.
-  if (spa_video_format_->format == pw_type_->video_format.RGBx) {
-    uint8_t* tempFrame = static_cast<uint8_t*>(malloc(maxSize));
-    std::memcpy(tempFrame, src, maxSize);
-    ConvertRGBxToBGRx(tempFrame, maxSize);
-    std::memcpy(current_frame_, tempFrame, maxSize);
-    free(tempFrame);
+  // BGRx to match color format expected by WebRTC, which takes a copy.
+  const bool convert = spa_video_format_->format == pw_type_->video_format.RGBx;
+  const bool held = mapped && mapped->writable() && !convert;
+  std::unique_ptr<DesktopFrame> frame;
+  if (held) {
+    frame = absl::make_unique<PipeWireBufferFrame>(
+        desktop_size_, srcStride, src, mapped, buffer_returner_);
   } else {
-    std::memcpy(current_frame_, src, maxSize);
+    if (mapped) {
+      mapped->BeginCpuAccess();
+    }
+    frame = absl::make_unique<BasicDesktopFrame>(desktop_size_);
+    frame->CopyPixelsFrom(src, srcStride,
+                          DesktopRect::MakeSize(desktop_size_));
+    if (mapped) {
+      mapped->EndCpuAccess();
+    }
+    if (convert) {
+      ConvertRGBxToBGRx(frame->data(),
+                        frame->stride() * desktop_size_.height());
+    }
+  }
+
+  std::unique_ptr<SharedDesktopFrame> shared_frame =
+      SharedDesktopFrame::Wrap(std::move(frame));
+  {
+    rtc::CritScope lock(&latest_frame_lock_);
+    latest_frame_.swap(shared_frame);
+  }
+  // The previous frame, if it wrapped a buffer, is released here or once the
+  // callback drops its last reference to it.
+  return held;
+}
+
+void BaseCapturerPipeWire::QueueReturnedBuffers() {
+  for (const rtc::scoped_refptr<PipeWireMappedBuffer>& returned :
+       buffer_returner_->TakeReturned()) {
+    auto it = mapped_buffers_.find(returned->buffer());
+    // Skip buffers that have been removed from the stream since.
+    if (it != mapped_buffers_.end() && it->second == returned) {
+      pw_stream_queue_buffer(pw_stream_, returned->buffer());
+    }
   }
 }
 
@@ -854,15 +1093,15 @@ void BaseCapturerPipeWire::CaptureFrame() {
     return;
   }
 
-  if (!current_frame_) {
-    callback_->OnCaptureResult(Result::ERROR_TEMPORARY, nullptr);
-    return;
+  std::unique_ptr<DesktopFrame> result;
+  {
+    rtc::CritScope lock(&latest_frame_lock_);
+    if (latest_frame_) {
+      // The frame is shared instead of copied; the capturer never writes to
+      // it once it is the latest one.
+      result = latest_frame_->Share();
+    }
   }
-
-  std::unique_ptr<DesktopFrame> result(new BasicDesktopFrame(desktop_size_));
-  result->CopyPixelsFrom(
-      current_frame_, (desktop_size_.width() * kBytesPerPixel),
-      DesktopRect::MakeWH(desktop_size_.width(), desktop_size_.height()));
   if (!result) {
     callback_->OnCaptureResult(Result::ERROR_TEMPORARY, nullptr);
     return;
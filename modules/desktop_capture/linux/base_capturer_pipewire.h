@@ -16,12 +16,22 @@
 #include <pipewire/pipewire.h>
 #include <spa/param/video/format-utils.h>
 
+#include <map>
+#include <memory>
+
+#include "api/scoped_refptr.h"
 #include "modules/desktop_capture/desktop_capture_options.h"
 #include "modules/desktop_capture/desktop_capturer.h"
+#include "modules/desktop_capture/shared_desktop_frame.h"
 #include "rtc_base/constructor_magic.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
+class PipeWireMappedBuffer;
+class PipeWireBufferReturner;
+
 class PipeWireType {
  public:
   spa_type_media_type media_type;
@@ -61,6 +71,13 @@ class BaseCapturerPipeWire : public DesktopCapturer {
 
   spa_video_info_raw* spa_video_format_ = nullptr;
 
+  // Buffers of the stream backed by a file descriptor, mapped by the capturer
+  // so that frames can wrap them without copying. Only used on the PipeWire
+  // thread.
+  std::map<pw_buffer*, rtc::scoped_refptr<PipeWireMappedBuffer>>
+      mapped_buffers_;
+  rtc::scoped_refptr<PipeWireBufferReturner> buffer_returner_;
+
   gint32 pw_fd_ = -1;
 
   CaptureSourceType capture_source_type_ =
@@ -82,7 +99,9 @@ class BaseCapturerPipeWire : public DesktopCapturer {
   DesktopSize desktop_size_ = {};
   DesktopCaptureOptions options_ = {};
 
-  uint8_t* current_frame_ = nullptr;
+  rtc::CriticalSection latest_frame_lock_;
+  std::unique_ptr<SharedDesktopFrame> latest_frame_
+      RTC_GUARDED_BY(latest_frame_lock_);
   Callback* callback_ = nullptr;
 
   bool portal_init_failed_ = false;
@@ -92,7 +111,10 @@ class BaseCapturerPipeWire : public DesktopCapturer {
   void InitPipeWireTypes();
 
   void CreateReceivingStream();
-  void HandleBuffer(pw_buffer* buffer);
+  // Returns true if |buffer| is held by the latest frame, in which case it is
+  // queued back to the stream once the frame is released.
+  bool HandleBuffer(pw_buffer* buffer);
+  void QueueReturnedBuffers();
 
   void ConvertRGBxToBGRx(uint8_t* frame, uint32_t size);
 
@@ -107,7 +129,9 @@ class BaseCapturerPipeWire : public DesktopCapturer {
 
   static void OnStreamFormatChanged(void* data, const struct spa_pod* format);
   static void OnStreamProcess(void* data);
-  static void OnNewBuffer(void* data, uint32_t id);
+  static void OnStreamAddBuffer(void* data, pw_buffer* buffer);
+  static void OnStreamRemoveBuffer(void* data, pw_buffer* buffer);
+  static void OnBuffersReturned(void* data, uint64_t count);
 
   guint SetupRequestResponseSignal(const gchar* object_path,
                                    GDBusSignalCallback callback);
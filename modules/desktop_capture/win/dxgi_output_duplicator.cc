@@ -179,7 +179,18 @@ bool DxgiOutputDuplicator::Duplicate(Context* context,
   if (error.Error() == S_OK && frame_info.AccumulatedFrames > 0 && resource) {
     DetectUpdatedRegion(frame_info, &context->updated_region);
     SpreadContextChange(context);
-    if (!texture_->CopyFrom(frame_info, resource.Get())) {
+    // The texture is not rotated, unlike the updated region.
+    DesktopRegion texture_region;
+    if (rotation_ != Rotation::CLOCK_WISE_0) {
+      for (DesktopRegion::Iterator it(context->updated_region); !it.IsAtEnd();
+           it.Advance()) {
+        texture_region.AddRect(
+            RotateRect(it.rect(), desktop_size(), ReverseRotation(rotation_)));
+      }
+    } else {
+      texture_region = context->updated_region;
+    }
+    if (!texture_->CopyFrom(frame_info, resource.Get(), texture_region)) {
       return false;
     }
     updated_region.AddRegion(context->updated_region);
@@ -33,9 +33,13 @@ class DxgiTexture {
   virtual ~DxgiTexture();
 
   // Copies selected regions of a frame represented by frame_info and resource.
-  // Returns false if anything wrong.
+  // |updated_region| is the area changed since the previous frame, in the
+  // coordinates of the unrotated texture. Implementations may copy only this
+  // area, and keep the rest of the previous frame. Returns false if anything
+  // wrong.
   bool CopyFrom(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-                IDXGIResource* resource);
+                IDXGIResource* resource,
+                const DesktopRegion& updated_region);
 
   const DesktopSize& desktop_size() const { return desktop_size_; }
 
@@ -58,7 +62,8 @@ class DxgiTexture {
   DXGI_MAPPED_RECT* rect();
 
   virtual bool CopyFromTexture(const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-                               ID3D11Texture2D* texture) = 0;
+                               ID3D11Texture2D* texture,
+                               const DesktopRegion& updated_region) = 0;
 
   virtual bool DoRelease() = 0;
 
@@ -60,6 +60,7 @@ bool DxgiTextureStaging::InitializeStage(ID3D11Texture2D* texture) {
   } else {
     RTC_DCHECK(!surface_);
   }
+  stage_holds_frame_ = false;
 
   _com_error error = device_.d3d_device()->CreateTexture2D(
       &desc, nullptr, stage_.GetAddressOf());
@@ -93,7 +94,8 @@ void DxgiTextureStaging::AssertStageAndSurfaceAreSameObject() {
 
 bool DxgiTextureStaging::CopyFromTexture(
     const DXGI_OUTDUPL_FRAME_INFO& frame_info,
-    ID3D11Texture2D* texture) {
+    ID3D11Texture2D* texture,
+    const DesktopRegion& updated_region) {
   RTC_DCHECK_GT(frame_info.AccumulatedFrames, 0);
   RTC_DCHECK(texture);
 
@@ -103,8 +105,27 @@ bool DxgiTextureStaging::CopyFromTexture(
     return false;
   }
 
-  device_.context()->CopyResource(static_cast<ID3D11Resource*>(stage_.Get()),
-                                  static_cast<ID3D11Resource*>(texture));
+  if (stage_holds_frame_) {
+    // The rest of the stage is unchanged since the previous frame, so only the
+    // updated region needs to cross the bus.
+    for (DesktopRegion::Iterator it(updated_region); !it.IsAtEnd();
+         it.Advance()) {
+      const DesktopRect& rect = it.rect();
+      const D3D11_BOX box = {static_cast<UINT>(rect.left()),
+                             static_cast<UINT>(rect.top()),
+                             /*front=*/0,
+                             static_cast<UINT>(rect.right()),
+                             static_cast<UINT>(rect.bottom()),
+                             /*back=*/1};
+      device_.context()->CopySubresourceRegion(
+          static_cast<ID3D11Resource*>(stage_.Get()), /*DstSubresource=*/0,
+          box.left, box.top, /*DstZ=*/0, static_cast<ID3D11Resource*>(texture),
+          /*SrcSubresource=*/0, &box);
+    }
+  } else {
+    device_.context()->CopyResource(static_cast<ID3D11Resource*>(stage_.Get()),
+                                    static_cast<ID3D11Resource*>(texture));
+  }
 
   *rect() = {0};
   _com_error error = surface_->Map(rect(), DXGI_MAP_READ);
@@ -112,9 +133,11 @@ bool DxgiTextureStaging::CopyFromTexture(
     *rect() = {0};
     RTC_LOG(LS_ERROR) << "Failed to map the IDXGISurface to a bitmap, error "
                       << error.ErrorMessage() << ", code " << error.Error();
+    stage_holds_frame_ = false;
     return false;
   }
 
+  stage_holds_frame_ = true;
   return true;
 }
 
@@ -123,6 +146,7 @@ bool DxgiTextureStaging::DoRelease() {
   if (error.Error() != S_OK) {
     stage_.Reset();
     surface_.Reset();
+    stage_holds_frame_ = false;
   }
   // If using staging mode, we only need to recreate ID3D11Texture2D instance.
   // This will happen during next CopyFrom call. So this function always returns
@@ -157,7 +157,7 @@ class PacedSender : public Module,
     PacedSender* const delegate_;
   } module_proxy_{this};
 
-  rtc::CriticalSection critsect_;
+  rtc::CriticalSection critsect_{"PacedSender"};
   const PacingController::ProcessMode process_mode_;
   PacingController pacing_controller_ RTC_GUARDED_BY(critsect_);
 
@@ -15,15 +15,16 @@
 #include <utility>
 #include <vector>
 
-#include "absl/strings/match.h"
 #include "modules/pacing/bitrate_prober.h"
 #include "modules/pacing/interval_budget.h"
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/metrics.h"
 
 namespace webrtc {
 namespace {
@@ -41,16 +42,6 @@ constexpr TimeDelta kMaxProcessingInterval = TimeDelta::Millis(30);
 
 constexpr int kFirstPriority = 0;
 
-bool IsDisabled(const WebRtcKeyValueConfig& field_trials,
-                absl::string_view key) {
-  return absl::StartsWith(field_trials.Lookup(key), "Disabled");
-}
-
-bool IsEnabled(const WebRtcKeyValueConfig& field_trials,
-               absl::string_view key) {
-  return absl::StartsWith(field_trials.Lookup(key), "Enabled");
-}
-
 TimeDelta GetDynamicPaddingTarget(const WebRtcKeyValueConfig& field_trials) {
   FieldTrialParameter<TimeDelta> padding_target("timedelta",
                                                 TimeDelta::Millis(5));
@@ -59,6 +50,28 @@ TimeDelta GetDynamicPaddingTarget(const WebRtcKeyValueConfig& field_trials) {
   return padding_target.Get();
 }
 
+TimeDelta GetBurstInterval(const WebRtcKeyValueConfig& field_trials) {
+  FieldTrialParameter<TimeDelta> burst_interval("timedelta",
+                                                TimeDelta::Zero());
+  ParseFieldTrial({&burst_interval},
+                  field_trials.Lookup("WebRTC-Pacer-BurstInterval"));
+  return std::max(burst_interval.Get(), TimeDelta::Zero());
+}
+
+// Returns the expected queue time above which discardable video packets are
+// dropped, or nullopt if they are never dropped.
+absl::optional<TimeDelta> GetDropDiscardableQueueTime(
+    const WebRtcKeyValueConfig& field_trials) {
+  FieldTrialFlag enabled("Enabled");
+  FieldTrialParameter<TimeDelta> max_queue_time("max_queue_time",
+                                                TimeDelta::Millis(100));
+  ParseFieldTrial({&enabled, &max_queue_time},
+                  field_trials.Lookup("WebRTC-Pacer-DropDiscardableLayers"));
+  if (!enabled)
+    return absl::nullopt;
+  return std::max(max_queue_time.Get(), TimeDelta::Zero());
+}
+
 int GetPriorityForType(RtpPacketMediaType type) {
   // Lower number takes priority over higher.
   switch (type) {
@@ -102,15 +115,17 @@ PacingController::PacingController(Clock* clock,
           !field_trials ? std::make_unique<FieldTrialBasedConfig>() : nullptr),
       field_trials_(field_trials ? field_trials : fallback_field_trials_.get()),
       drain_large_queues_(
-          !IsDisabled(*field_trials_, "WebRTC-Pacer-DrainQueue")),
+          !field_trials_->IsDisabled("WebRTC-Pacer-DrainQueue")),
       send_padding_if_silent_(
-          IsEnabled(*field_trials_, "WebRTC-Pacer-PadInSilence")),
-      pace_audio_(IsEnabled(*field_trials_, "WebRTC-Pacer-BlockAudio")),
+          field_trials_->IsEnabled("WebRTC-Pacer-PadInSilence")),
+      pace_audio_(field_trials_->IsEnabled("WebRTC-Pacer-BlockAudio")),
       small_first_probe_packet_(
-          IsEnabled(*field_trials_, "WebRTC-Pacer-SmallFirstProbePacket")),
+          field_trials_->IsEnabled("WebRTC-Pacer-SmallFirstProbePacket")),
       ignore_transport_overhead_(
-          IsEnabled(*field_trials_, "WebRTC-Pacer-IgnoreTransportOverhead")),
+          field_trials_->IsEnabled("WebRTC-Pacer-IgnoreTransportOverhead")),
       padding_target_duration_(GetDynamicPaddingTarget(*field_trials_)),
+      burst_interval_(GetBurstInterval(*field_trials_)),
+      drop_discardable_queue_time_(GetDropDiscardableQueueTime(*field_trials_)),
       min_packet_limit_(kDefaultMinPacketLimit),
       transport_overhead_per_packet_(DataSize::Zero()),
       last_timestamp_(clock_->CurrentTime()),
@@ -132,7 +147,9 @@ PacingController::PacingController(Clock* clock,
       outstanding_data_(DataSize::Zero()),
       queue_time_limit(kMaxExpectedQueueLength),
       account_for_audio_(false),
-      include_overhead_(false) {
+      include_overhead_(false),
+      first_process_time_(Timestamp::MinusInfinity()),
+      num_process_calls_(0) {
   if (!drain_large_queues_) {
     RTC_LOG(LS_WARNING) << "Pacer queues will not be drained,"
                            "pushback experiment must be enabled.";
@@ -144,7 +161,15 @@ PacingController::PacingController(Clock* clock,
   UpdateBudgetWithElapsedTime(min_packet_limit_);
 }
 
-PacingController::~PacingController() = default;
+PacingController::~PacingController() {
+  if (first_process_time_.IsFinite()) {
+    const TimeDelta run_time = last_timestamp_ - first_process_time_;
+    if (run_time.seconds() >= metrics::kMinRunTimeInSeconds) {
+      RTC_HISTOGRAM_COUNTS_1000("WebRTC.Pacer.ProcessCallsPerSecond",
+                                num_process_calls_ * 1000 / run_time.ms());
+    }
+  }
+}
 
 void PacingController::CreateProbeCluster(DataRate bitrate, int cluster_id) {
   prober_.CreateProbeCluster(bitrate, CurrentTime(), cluster_id);
@@ -218,6 +243,7 @@ void PacingController::SetProbingEnabled(bool enabled) {
 void PacingController::SetPacingRates(DataRate pacing_rate,
                                       DataRate padding_rate) {
   RTC_DCHECK_GT(pacing_rate, DataRate::Zero());
+  const bool rate_dropped = pacing_rate < pacing_bitrate_;
   media_rate_ = pacing_rate;
   padding_rate_ = padding_rate;
   pacing_bitrate_ = pacing_rate;
@@ -226,6 +252,20 @@ void PacingController::SetPacingRates(DataRate pacing_rate,
   RTC_LOG(LS_VERBOSE) << "bwe:pacer_updated pacing_kbps="
                       << pacing_bitrate_.kbps()
                       << " padding_budget_kbps=" << padding_rate.kbps();
+
+  // Packets already queued were produced for the previous rate, and the
+  // encoder needs a few frames to adapt. Frames that no other frame depends on
+  // can be dropped right away instead of delaying everything behind them.
+  if (rate_dropped && drop_discardable_queue_time_ &&
+      ExpectedQueueTime() > *drop_discardable_queue_time_) {
+    size_t dropped = packet_queue_.RemoveDiscardablePackets(CurrentTime());
+    if (dropped > 0) {
+      RTC_LOG(LS_INFO) << "Dropped " << dropped
+                       << " discardable packets after the pacing rate "
+                          "dropped to "
+                       << pacing_bitrate_.kbps() << " kbps.";
+    }
+  }
 }
 
 void PacingController::EnqueuePacket(std::unique_ptr<RtpPacketToSend> packet) {
@@ -235,6 +275,16 @@ void PacingController::EnqueuePacket(std::unique_ptr<RtpPacketToSend> packet) {
   // Get priority first and store in temporary, to avoid chance of object being
   // moved before GetPriorityForType() being called.
   const int priority = GetPriorityForType(*packet->packet_type());
+  // Until the encoder has adapted to a lower rate, don't let discardable
+  // frames add to a queue that is already too long.
+  if (drop_discardable_queue_time_ && packet->is_discardable() &&
+      packet->packet_type() == RtpPacketMediaType::kVideo &&
+      ExpectedQueueTime() > *drop_discardable_queue_time_) {
+    RTC_LOG(LS_VERBOSE) << "Dropping discardable packet "
+                        << packet->SequenceNumber() << " of ssrc "
+                        << packet->Ssrc();
+    return;
+  }
   EnqueuePacketInternal(std::move(packet), priority);
 }
 
@@ -396,7 +446,11 @@ Timestamp PacingController::NextSendTime() const {
 }
 
 void PacingController::ProcessPackets() {
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kPacing);
   Timestamp now = CurrentTime();
+  if (first_process_time_.IsMinusInfinity())
+    first_process_time_ = now;
+  ++num_process_calls_;
   Timestamp target_send_time = now;
   if (mode_ == ProcessMode::kDynamic) {
     target_send_time = NextSendTime();
@@ -656,15 +710,21 @@ std::unique_ptr<RtpPacketToSend> PacingController::GetPendingPacket(
         // We allow sending slightly early if we think that we would actually
         // had been able to, had we been right on time - i.e. the current debt
         // is not more than would be reduced to zero at the target sent time.
+        // Packets within the burst interval are sent right away as well.
         TimeDelta flush_time = media_debt_ / media_rate_;
-        if (now + flush_time > target_send_time) {
+        if (now + flush_time > target_send_time + burst_interval_) {
           return nullptr;
         }
       }
     }
   }
 
-  return packet_queue_.Pop();
+  TimeDelta queue_time = TimeDelta::Zero();
+  std::unique_ptr<RtpPacketToSend> packet = packet_queue_.Pop(&queue_time);
+  if (packet->packet_type() != RtpPacketMediaType::kPadding) {
+    RTC_HISTOGRAM_COUNTS_10000("WebRTC.Pacer.QueueTimeMs", queue_time.ms());
+  }
+  return packet;
 }
 
 void PacingController::OnPacketSent(RtpPacketMediaType packet_type,
@@ -186,6 +186,13 @@ class PacingController {
   // In dynamic mode, indicates the target size when requesting padding,
   // expressed as a duration in order to adjust for varying padding rate.
   const TimeDelta padding_target_duration_;
+  // In dynamic mode, media packets whose send time is at most this far ahead
+  // are sent together with the current one, so that the pacer wakes up less
+  // often and timer slack matters less.
+  const TimeDelta burst_interval_;
+  // If set, discardable video packets are dropped when the expected queue time
+  // exceeds this value, rather than waiting for the encoder to adapt.
+  const absl::optional<TimeDelta> drop_discardable_queue_time_;
 
   TimeDelta min_packet_limit_;
 
@@ -231,6 +238,10 @@ class PacingController {
   TimeDelta queue_time_limit;
   bool account_for_audio_;
   bool include_overhead_;
+
+  // For the process calls per second histogram.
+  Timestamp first_process_time_;
+  int64_t num_process_calls_;
 };
 }  // namespace webrtc
 
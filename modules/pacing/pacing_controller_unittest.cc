@@ -20,6 +20,7 @@
 #include "api/units/data_rate.h"
 #include "modules/pacing/packet_router.h"
 #include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/metrics.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -462,6 +463,48 @@ TEST_P(PacingControllerFieldTrialTest, DefaultBudgetDoesNotAffectAudio) {
   ProcessNext(&pacer);
 }
 
+TEST_P(PacingControllerFieldTrialTest, DropsDiscardablePacketsWhenRateDrops) {
+  ScopedFieldTrials trial(
+      "WebRTC-Pacer-DropDiscardableLayers/Enabled,max_queue_time:100ms/");
+  PacingController pacer(&clock_, &callback_, nullptr, nullptr, GetParam());
+  pacer.SetPacingRates(DataRate::KilobitsPerSec(800), DataRate::Zero());
+  auto enqueue_video = [&](bool discardable) {
+    auto packet = BuildPacket(video.type, video.ssrc, video.seq_num++,
+                              clock_.TimeInMilliseconds(), video.packet_size);
+    packet->set_is_discardable(discardable);
+    pacer.EnqueuePacket(std::move(packet));
+  };
+
+  // 100 ms worth of video at 800 kbps, every other packet discardable.
+  for (int i = 0; i < 10; ++i)
+    enqueue_video(/*discardable=*/i % 2 == 1);
+  EXPECT_EQ(pacer.QueueSizePackets(), 10u);
+
+  // At 200 kbps the queue would take 400 ms to send.
+  pacer.SetPacingRates(DataRate::KilobitsPerSec(200), DataRate::Zero());
+  EXPECT_EQ(pacer.QueueSizePackets(), 5u);
+  EXPECT_EQ(pacer.ExpectedQueueTime(), TimeDelta::Millis(200));
+
+  // While the queue is too long, new discardable packets are dropped too.
+  enqueue_video(/*discardable=*/true);
+  EXPECT_EQ(pacer.QueueSizePackets(), 5u);
+  enqueue_video(/*discardable=*/false);
+  EXPECT_EQ(pacer.QueueSizePackets(), 6u);
+}
+
+TEST_P(PacingControllerFieldTrialTest, DefaultKeepsDiscardablePackets) {
+  PacingController pacer(&clock_, &callback_, nullptr, nullptr, GetParam());
+  pacer.SetPacingRates(DataRate::KilobitsPerSec(800), DataRate::Zero());
+  for (int i = 0; i < 10; ++i) {
+    auto packet = BuildPacket(video.type, video.ssrc, video.seq_num++,
+                              clock_.TimeInMilliseconds(), video.packet_size);
+    packet->set_is_discardable(true);
+    pacer.EnqueuePacket(std::move(packet));
+  }
+  pacer.SetPacingRates(DataRate::KilobitsPerSec(200), DataRate::Zero());
+  EXPECT_EQ(pacer.QueueSizePackets(), 10u);
+}
+
 INSTANTIATE_TEST_SUITE_P(WithAndWithoutIntervalBudget,
                          PacingControllerFieldTrialTest,
                          ::testing::Values(false, true));
@@ -2029,6 +2072,60 @@ TEST_P(PacingControllerTest, PaddingTargetAccountsForPaddingRate) {
   AdvanceTimeAndProcess();
 }
 
+TEST_P(PacingControllerTest, SendsPacketsWithinBurstIntervalTogether) {
+  if (PeriodicProcess()) {
+    // This test applies only when NOT using interval budget.
+    return;
+  }
+
+  ScopedFieldTrials field_trials("WebRTC-Pacer-BurstInterval/timedelta:10ms/");
+  SetUp();
+
+  // One packet every 2ms.
+  const uint32_t kSsrc = 12345;
+  const size_t kPacketSize = 1000;
+  const size_t kNumPackets = 50;
+  pacer_->SetPacingRates(DataRate::KilobitsPerSec(4000), DataRate::Zero());
+  uint16_t sequence_number = 1;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    SendAndExpectPacket(RtpPacketMediaType::kVideo, kSsrc, sequence_number++,
+                        clock_.TimeInMilliseconds(), kPacketSize);
+  }
+
+  const Timestamp start_time = clock_.CurrentTime();
+  int num_process_calls = 0;
+  while (pacer_->QueueSizePackets() > 0) {
+    AdvanceTimeAndProcess();
+    ++num_process_calls;
+  }
+  // Bursts of six packets, at the same average rate. Without the burst
+  // interval every packet would need a call of its own.
+  EXPECT_LE(num_process_calls, 10);
+  const TimeDelta send_time = clock_.CurrentTime() - start_time;
+  EXPECT_GE(send_time, TimeDelta::Millis(2 * (kNumPackets - 1) - 10));
+  EXPECT_LE(send_time, TimeDelta::Millis(2 * (kNumPackets - 1)));
+}
+
+TEST_P(PacingControllerTest, ReportsHistograms) {
+  metrics::Reset();
+  const uint32_t kSsrc = 12345;
+  uint16_t sequence_number = 1;
+  const Timestamp start_time = clock_.CurrentTime();
+  while ((clock_.CurrentTime() - start_time).seconds() <=
+         metrics::kMinRunTimeInSeconds) {
+    SendAndExpectPacket(RtpPacketMediaType::kVideo, kSsrc, sequence_number++,
+                        clock_.TimeInMilliseconds(), 250);
+    clock_.AdvanceTime(TimeDelta::Millis(5));
+    pacer_->ProcessPackets();
+  }
+  EXPECT_GT(metrics::NumSamples("WebRTC.Pacer.QueueTimeMs"), 0);
+  EXPECT_EQ(0, metrics::NumSamples("WebRTC.Pacer.ProcessCallsPerSecond"));
+
+  pacer_.reset();
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Pacer.ProcessCallsPerSecond"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Pacer.ProcessCallsPerSecond", 200));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     WithAndWithoutIntervalBudget,
     PacingControllerTest,
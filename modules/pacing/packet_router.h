@@ -94,7 +94,7 @@ class PacketRouter : public RemoteBitrateObserver,
   void RemoveSendRtpModuleFromMap(uint32_t ssrc)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(modules_crit_);
 
-  rtc::CriticalSection modules_crit_;
+  rtc::CriticalSection modules_crit_{"PacketRouter::modules"};
   // Ssrc to RtpRtcp module;
   std::unordered_map<uint32_t, RtpRtcp*> send_modules_map_
       RTC_GUARDED_BY(modules_crit_);
@@ -107,7 +107,7 @@ class PacketRouter : public RemoteBitrateObserver,
 
   // TODO(eladalon): remb_crit_ only ever held from one function, and it's not
   // clear if that function can actually be called from more than one thread.
-  rtc::CriticalSection remb_crit_;
+  rtc::CriticalSection remb_crit_{"PacketRouter::remb"};
   // The last time a REMB was sent.
   int64_t last_remb_time_ms_ RTC_GUARDED_BY(remb_crit_);
   int64_t last_send_bitrate_bps_ RTC_GUARDED_BY(remb_crit_);
@@ -22,33 +22,30 @@ namespace {
 static constexpr DataSize kMaxLeadingSize = DataSize::Bytes(1400);
 }
 
-RoundRobinPacketQueue::QueuedPacket::QueuedPacket(const QueuedPacket& rhs) =
+RoundRobinPacketQueue::QueuedPacket::QueuedPacket()
+    : priority_(0),
+      enqueue_time_(Timestamp::MinusInfinity()),
+      enqueue_order_(0),
+      is_retransmission_(false),
+      enqueue_time_index_(0) {}
+RoundRobinPacketQueue::QueuedPacket::QueuedPacket(QueuedPacket&& rhs) =
     default;
+RoundRobinPacketQueue::QueuedPacket&
+RoundRobinPacketQueue::QueuedPacket::operator=(QueuedPacket&& rhs) = default;
 RoundRobinPacketQueue::QueuedPacket::~QueuedPacket() = default;
 
 RoundRobinPacketQueue::QueuedPacket::QueuedPacket(
     int priority,
     Timestamp enqueue_time,
     uint64_t enqueue_order,
-    std::multiset<Timestamp>::iterator enqueue_time_it,
     std::unique_ptr<RtpPacketToSend> packet)
     : priority_(priority),
       enqueue_time_(enqueue_time),
       enqueue_order_(enqueue_order),
       is_retransmission_(packet->packet_type() ==
                          RtpPacketMediaType::kRetransmission),
-      enqueue_time_it_(enqueue_time_it),
-      owned_packet_(packet.release()) {}
-
-bool RoundRobinPacketQueue::QueuedPacket::operator<(
-    const RoundRobinPacketQueue::QueuedPacket& other) const {
-  if (priority_ != other.priority_)
-    return priority_ > other.priority_;
-  if (is_retransmission_ != other.is_retransmission_)
-    return other.is_retransmission_;
-
-  return enqueue_order_ > other.enqueue_order_;
-}
+      enqueue_time_index_(0),
+      owned_packet_(std::move(packet)) {}
 
 int RoundRobinPacketQueue::QueuedPacket::Priority() const {
   return priority_;
@@ -67,7 +64,7 @@ Timestamp RoundRobinPacketQueue::QueuedPacket::EnqueueTime() const {
 }
 
 bool RoundRobinPacketQueue::QueuedPacket::IsRetransmission() const {
-  return Type() == RtpPacketMediaType::kRetransmission;
+  return is_retransmission_;
 }
 
 uint64_t RoundRobinPacketQueue::QueuedPacket::EnqueueOrder() const {
@@ -75,17 +72,21 @@ uint64_t RoundRobinPacketQueue::QueuedPacket::EnqueueOrder() const {
 }
 
 RtpPacketToSend* RoundRobinPacketQueue::QueuedPacket::RtpPacket() const {
-  return owned_packet_;
+  return owned_packet_.get();
+}
+
+std::unique_ptr<RtpPacketToSend>
+RoundRobinPacketQueue::QueuedPacket::ReleaseRtpPacket() {
+  return std::move(owned_packet_);
 }
 
-void RoundRobinPacketQueue::QueuedPacket::UpdateEnqueueTimeIterator(
-    std::multiset<Timestamp>::iterator it) {
-  enqueue_time_it_ = it;
+uint64_t RoundRobinPacketQueue::QueuedPacket::EnqueueTimeIndex() const {
+  return enqueue_time_index_;
 }
 
-std::multiset<Timestamp>::iterator
-RoundRobinPacketQueue::QueuedPacket::EnqueueTimeIterator() const {
-  return enqueue_time_it_;
+void RoundRobinPacketQueue::QueuedPacket::UpdateEnqueueTimeIndex(
+    uint64_t index) {
+  enqueue_time_index_ = index;
 }
 
 void RoundRobinPacketQueue::QueuedPacket::SubtractPauseTime(
@@ -93,20 +94,25 @@ void RoundRobinPacketQueue::QueuedPacket::SubtractPauseTime(
   enqueue_time_ -= pause_time_sum;
 }
 
-RoundRobinPacketQueue::PriorityPacketQueue::const_iterator
-RoundRobinPacketQueue::PriorityPacketQueue::begin() const {
-  return c.begin();
-}
+RoundRobinPacketQueue::Stream::Stream(uint32_t ssrc)
+    : size(DataSize::Zero()),
+      ssrc(ssrc),
+      scheduled(false),
+      scheduled_priority(0) {}
+RoundRobinPacketQueue::Stream::Stream(Stream&& stream) = default;
+RoundRobinPacketQueue::Stream& RoundRobinPacketQueue::Stream::operator=(
+    Stream&& stream) = default;
+RoundRobinPacketQueue::Stream::~Stream() = default;
 
-RoundRobinPacketQueue::PriorityPacketQueue::const_iterator
-RoundRobinPacketQueue::PriorityPacketQueue::end() const {
-  return c.end();
+RoundRobinPacketQueue::Ring<RoundRobinPacketQueue::QueuedPacket>*
+RoundRobinPacketQueue::Stream::NextPacketQueue() {
+  for (Ring<QueuedPacket>& packet_queue : packet_queues) {
+    if (!packet_queue.empty())
+      return &packet_queue;
+  }
+  return nullptr;
 }
 
-RoundRobinPacketQueue::Stream::Stream() : size(DataSize::Zero()), ssrc(0) {}
-RoundRobinPacketQueue::Stream::Stream(const Stream& stream) = default;
-RoundRobinPacketQueue::Stream::~Stream() = default;
-
 bool IsEnabled(const WebRtcKeyValueConfig* field_trials, const char* name) {
   if (!field_trials) {
     return false;
@@ -125,41 +131,58 @@ RoundRobinPacketQueue::RoundRobinPacketQueue(
       max_size_(kMaxLeadingSize),
       queue_time_sum_(TimeDelta::Zero()),
       pause_time_sum_(TimeDelta::Zero()),
+      enqueue_times_begin_(0),
       include_overhead_(false) {}
 
-RoundRobinPacketQueue::~RoundRobinPacketQueue() {
-  // Make sure to release any packets owned by raw pointer in QueuedPacket.
-  while (!Empty()) {
-    Pop();
-  }
-}
+RoundRobinPacketQueue::~RoundRobinPacketQueue() = default;
 
 void RoundRobinPacketQueue::Push(int priority,
                                  Timestamp enqueue_time,
                                  uint64_t enqueue_order,
                                  std::unique_ptr<RtpPacketToSend> packet) {
   RTC_DCHECK(packet->packet_type().has_value());
+  RTC_DCHECK_GE(priority, 0);
+  RTC_DCHECK_LT(priority, kNumPriorityLevels);
   if (size_packets_ == 0) {
     // Single packet fast-path.
-    single_packet_queue_.emplace(
-        QueuedPacket(priority, enqueue_time, enqueue_order,
-                     enqueue_times_.end(), std::move(packet)));
+    single_packet_queue_.emplace(priority, enqueue_time, enqueue_order,
+                                 std::move(packet));
     UpdateQueueTime(enqueue_time);
     single_packet_queue_->SubtractPauseTime(pause_time_sum_);
     size_packets_ = 1;
     size_ += PacketSize(*single_packet_queue_);
   } else {
     MaybePromoteSinglePacketToNormalQueue();
-    Push(QueuedPacket(priority, enqueue_time, enqueue_order,
-                      enqueue_times_.insert(enqueue_time), std::move(packet)));
+    QueuedPacket queued_packet(priority, enqueue_time, enqueue_order,
+                               std::move(packet));
+    queued_packet.UpdateEnqueueTimeIndex(InsertEnqueueTime(enqueue_time));
+
+    // In order to figure out how much time a packet has spent in the queue
+    // while not in a paused state, we subtract the total amount of time the
+    // queue has been paused so far, and when the packet is popped we subtract
+    // the total amount of time the queue has been paused at that moment. This
+    // way we subtract the total amount of time the packet has spent in the
+    // queue while in a paused state.
+    UpdateQueueTime(queued_packet.EnqueueTime());
+    queued_packet.SubtractPauseTime(pause_time_sum_);
+
+    size_packets_ += 1;
+    size_ += PacketSize(queued_packet);
+
+    Push(std::move(queued_packet));
   }
 }
 
-std::unique_ptr<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
+std::unique_ptr<RtpPacketToSend> RoundRobinPacketQueue::Pop(
+    TimeDelta* queue_time) {
   if (single_packet_queue_.has_value()) {
-    RTC_DCHECK(stream_priorities_.empty());
-    std::unique_ptr<RtpPacketToSend> rtp_packet(
-        single_packet_queue_->RtpPacket());
+    RTC_DCHECK(stream_schedule_.empty());
+    if (queue_time) {
+      *queue_time = time_last_updated_ - single_packet_queue_->EnqueueTime() -
+                    pause_time_sum_;
+    }
+    std::unique_ptr<RtpPacketToSend> rtp_packet =
+        single_packet_queue_->ReleaseRtpPacket();
     single_packet_queue_.reset();
     queue_time_sum_ = TimeDelta::Zero();
     size_packets_ = 0;
@@ -169,9 +192,11 @@ std::unique_ptr<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
 
   RTC_DCHECK(!Empty());
   Stream* stream = GetHighestPriorityStream();
-  const QueuedPacket& queued_packet = stream->packet_queue.top();
+  stream_schedule_.pop_back();
+  stream->scheduled = false;
 
-  stream_priorities_.erase(stream->priority_it);
+  Ring<QueuedPacket>* packet_queue = stream->NextPacketQueue();
+  QueuedPacket& queued_packet = packet_queue->front();
 
   // Calculate the total amount of time spent by this packet in the queue
   // while in a non-paused state. Note that the |pause_time_sum_ms_| was
@@ -181,9 +206,10 @@ std::unique_ptr<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
   TimeDelta time_in_non_paused_state =
       time_last_updated_ - queued_packet.EnqueueTime() - pause_time_sum_;
   queue_time_sum_ -= time_in_non_paused_state;
+  if (queue_time)
+    *queue_time = time_in_non_paused_state;
 
-  RTC_CHECK(queued_packet.EnqueueTimeIterator() != enqueue_times_.end());
-  enqueue_times_.erase(queued_packet.EnqueueTimeIterator());
+  EraseEnqueueTime(queued_packet.EnqueueTimeIndex());
 
   // Update |bytes| of this stream. The general idea is that the stream that
   // has sent the least amount of bytes should have the highest priority.
@@ -200,17 +226,14 @@ std::unique_ptr<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
   size_packets_ -= 1;
   RTC_CHECK(size_packets_ > 0 || queue_time_sum_ == TimeDelta::Zero());
 
-  std::unique_ptr<RtpPacketToSend> rtp_packet(queued_packet.RtpPacket());
-  stream->packet_queue.pop();
+  std::unique_ptr<RtpPacketToSend> rtp_packet =
+      queued_packet.ReleaseRtpPacket();
+  packet_queue->pop_front();
 
   // If there are packets left to be sent, schedule the stream again.
-  RTC_CHECK(!IsSsrcScheduled(stream->ssrc));
-  if (stream->packet_queue.empty()) {
-    stream->priority_it = stream_priorities_.end();
-  } else {
-    int priority = stream->packet_queue.top().Priority();
-    stream->priority_it = stream_priorities_.emplace(
-        StreamPrioKey(priority, stream->size), stream->ssrc);
+  packet_queue = stream->NextPacketQueue();
+  if (packet_queue) {
+    Schedule(stream - streams_.data(), packet_queue->front().Priority());
   }
 
   return rtp_packet;
@@ -218,10 +241,10 @@ std::unique_ptr<RtpPacketToSend> RoundRobinPacketQueue::Pop() {
 
 bool RoundRobinPacketQueue::Empty() const {
   if (size_packets_ == 0) {
-    RTC_DCHECK(!single_packet_queue_.has_value() && stream_priorities_.empty());
+    RTC_DCHECK(!single_packet_queue_.has_value() && stream_schedule_.empty());
     return true;
   }
-  RTC_DCHECK(single_packet_queue_.has_value() || !stream_priorities_.empty());
+  RTC_DCHECK(single_packet_queue_.has_value() || !stream_schedule_.empty());
   return false;
 }
 
@@ -242,14 +265,18 @@ absl::optional<Timestamp> RoundRobinPacketQueue::LeadingAudioPacketEnqueueTime()
     return absl::nullopt;
   }
 
-  if (stream_priorities_.empty()) {
+  if (stream_schedule_.empty()) {
     return absl::nullopt;
   }
-  uint32_t ssrc = stream_priorities_.begin()->second;
-
-  const auto& top_packet = streams_.find(ssrc)->second.packet_queue.top();
-  if (top_packet.Type() == RtpPacketMediaType::kAudio) {
-    return top_packet.EnqueueTime();
+  const Stream& stream = streams_[stream_schedule_.back().stream_index];
+  for (const Ring<QueuedPacket>& packet_queue : stream.packet_queues) {
+    if (packet_queue.empty())
+      continue;
+    const QueuedPacket& top_packet = packet_queue.front();
+    if (top_packet.Type() == RtpPacketMediaType::kAudio) {
+      return top_packet.EnqueueTime();
+    }
+    break;
   }
   return absl::nullopt;
 }
@@ -262,7 +289,7 @@ Timestamp RoundRobinPacketQueue::OldestEnqueueTime() const {
   if (Empty())
     return Timestamp::MinusInfinity();
   RTC_CHECK(!enqueue_times_.empty());
-  return *enqueue_times_.begin();
+  return *enqueue_times_.front();
 }
 
 void RoundRobinPacketQueue::UpdateQueueTime(Timestamp now) {
@@ -292,10 +319,12 @@ void RoundRobinPacketQueue::SetIncludeOverhead() {
   MaybePromoteSinglePacketToNormalQueue();
   include_overhead_ = true;
   // We need to update the size to reflect overhead for existing packets.
-  for (const auto& stream : streams_) {
-    for (const QueuedPacket& packet : stream.second.packet_queue) {
-      size_ += DataSize::Bytes(packet.RtpPacket()->headers_size()) +
-               transport_overhead_per_packet_;
+  for (const Stream& stream : streams_) {
+    for (const Ring<QueuedPacket>& packet_queue : stream.packet_queues) {
+      for (size_t i = 0; i < packet_queue.size(); ++i) {
+        size_ += DataSize::Bytes(packet_queue[i].RtpPacket()->headers_size()) +
+                 transport_overhead_per_packet_;
+      }
     }
   }
 }
@@ -305,65 +334,88 @@ void RoundRobinPacketQueue::SetTransportOverhead(DataSize overhead_per_packet) {
   if (include_overhead_) {
     DataSize previous_overhead = transport_overhead_per_packet_;
     // We need to update the size to reflect overhead for existing packets.
-    for (const auto& stream : streams_) {
-      int packets = stream.second.packet_queue.size();
-      size_ -= packets * previous_overhead;
-      size_ += packets * overhead_per_packet;
+    for (const Stream& stream : streams_) {
+      for (const Ring<QueuedPacket>& packet_queue : stream.packet_queues) {
+        int packets = packet_queue.size();
+        size_ -= packets * previous_overhead;
+        size_ += packets * overhead_per_packet;
+      }
     }
   }
   transport_overhead_per_packet_ = overhead_per_packet;
 }
 
+size_t RoundRobinPacketQueue::RemoveDiscardablePackets(Timestamp now) {
+  UpdateQueueTime(now);
+  if (single_packet_queue_.has_value()) {
+    if (!IsDiscardable(*single_packet_queue_))
+      return 0;
+    single_packet_queue_.reset();
+    queue_time_sum_ = TimeDelta::Zero();
+    size_packets_ = 0;
+    size_ = DataSize::Zero();
+    return 1;
+  }
+
+  size_t removed = 0;
+  for (size_t stream_index = 0; stream_index < streams_.size();
+       ++stream_index) {
+    Stream& stream = streams_[stream_index];
+    size_t removed_from_stream = 0;
+    for (Ring<QueuedPacket>& packet_queue : stream.packet_queues) {
+      removed_from_stream +=
+          packet_queue.RemoveIf([this](const QueuedPacket& packet) {
+            if (!IsDiscardable(packet))
+              return false;
+            RemoveFromQueueStats(packet);
+            return true;
+          });
+    }
+    if (removed_from_stream == 0)
+      continue;
+    removed += removed_from_stream;
+    // The stream may have run out of packets, or its next packet may have a
+    // lower priority than the one it was scheduled with.
+    RTC_DCHECK(stream.scheduled);
+    Unschedule(stream_index);
+    Ring<QueuedPacket>* packet_queue = stream.NextPacketQueue();
+    if (packet_queue)
+      Schedule(stream_index, packet_queue->front().Priority());
+  }
+  if (size_packets_ == 0)
+    queue_time_sum_ = TimeDelta::Zero();
+  return removed;
+}
+
 TimeDelta RoundRobinPacketQueue::AverageQueueTime() const {
   if (Empty())
     return TimeDelta::Zero();
   return queue_time_sum_ / size_packets_;
 }
 
-void RoundRobinPacketQueue::Push(QueuedPacket packet) {
-  auto stream_info_it = streams_.find(packet.Ssrc());
-  if (stream_info_it == streams_.end()) {
-    stream_info_it = streams_.emplace(packet.Ssrc(), Stream()).first;
-    stream_info_it->second.priority_it = stream_priorities_.end();
-    stream_info_it->second.ssrc = packet.Ssrc();
-  }
-
-  Stream* stream = &stream_info_it->second;
-
-  if (stream->priority_it == stream_priorities_.end()) {
-    // If the SSRC is not currently scheduled, add it to |stream_priorities_|.
-    RTC_CHECK(!IsSsrcScheduled(stream->ssrc));
-    stream->priority_it = stream_priorities_.emplace(
-        StreamPrioKey(packet.Priority(), stream->size), packet.Ssrc());
-  } else if (packet.Priority() < stream->priority_it->first.priority) {
-    // If the priority of this SSRC increased, remove the outdated StreamPrioKey
-    // and insert a new one with the new priority. Note that |priority_| uses
-    // lower ordinal for higher priority.
-    stream_priorities_.erase(stream->priority_it);
-    stream->priority_it = stream_priorities_.emplace(
-        StreamPrioKey(packet.Priority(), stream->size), packet.Ssrc());
-  }
-  RTC_CHECK(stream->priority_it != stream_priorities_.end());
-
-  if (packet.EnqueueTimeIterator() == enqueue_times_.end()) {
-    // Promotion from single-packet queue. Just add to enqueue times.
-    packet.UpdateEnqueueTimeIterator(
-        enqueue_times_.insert(packet.EnqueueTime()));
-  } else {
-    // In order to figure out how much time a packet has spent in the queue
-    // while not in a paused state, we subtract the total amount of time the
-    // queue has been paused so far, and when the packet is popped we subtract
-    // the total amount of time the queue has been paused at that moment. This
-    // way we subtract the total amount of time the packet has spent in the
-    // queue while in a paused state.
-    UpdateQueueTime(packet.EnqueueTime());
-    packet.SubtractPauseTime(pause_time_sum_);
+int RoundRobinPacketQueue::PacketClass(const QueuedPacket& packet) {
+  return 2 * packet.Priority() + (packet.IsRetransmission() ? 0 : 1);
+}
 
-    size_packets_ += 1;
-    size_ += PacketSize(packet);
+void RoundRobinPacketQueue::Push(QueuedPacket packet) {
+  size_t stream_index = GetOrCreateStreamIndex(packet.Ssrc());
+  Stream* stream = &streams_[stream_index];
+
+  if (!stream->scheduled) {
+    // If the SSRC is not currently scheduled, add it to |stream_schedule_|.
+    Schedule(stream_index, packet.Priority());
+  } else if (packet.Priority() < stream->scheduled_priority) {
+    // If the priority of this SSRC increased, reschedule it with the new
+    // priority. Note that |priority_| uses lower ordinal for higher priority.
+    Unschedule(stream_index);
+    Schedule(stream_index, packet.Priority());
   }
 
-  stream->packet_queue.push(packet);
+  Ring<QueuedPacket>& packet_queue = stream->packet_queues[PacketClass(packet)];
+  RTC_DCHECK(packet_queue.empty() ||
+             packet_queue[packet_queue.size() - 1].EnqueueOrder() <
+                 packet.EnqueueOrder());
+  packet_queue.push_back(std::move(packet));
 }
 
 DataSize RoundRobinPacketQueue::PacketSize(const QueuedPacket& packet) const {
@@ -376,31 +428,92 @@ DataSize RoundRobinPacketQueue::PacketSize(const QueuedPacket& packet) const {
   return packet_size;
 }
 
+bool RoundRobinPacketQueue::IsDiscardable(const QueuedPacket& packet) {
+  return packet.Type() == RtpPacketMediaType::kVideo &&
+         packet.RtpPacket()->is_discardable();
+}
+
+void RoundRobinPacketQueue::RemoveFromQueueStats(const QueuedPacket& packet) {
+  queue_time_sum_ -=
+      time_last_updated_ - packet.EnqueueTime() - pause_time_sum_;
+  EraseEnqueueTime(packet.EnqueueTimeIndex());
+  size_ -= PacketSize(packet);
+  size_packets_ -= 1;
+}
+
 void RoundRobinPacketQueue::MaybePromoteSinglePacketToNormalQueue() {
   if (single_packet_queue_.has_value()) {
-    Push(*single_packet_queue_);
+    QueuedPacket packet = std::move(*single_packet_queue_);
     single_packet_queue_.reset();
+    packet.UpdateEnqueueTimeIndex(InsertEnqueueTime(packet.EnqueueTime()));
+    Push(std::move(packet));
   }
 }
 
+size_t RoundRobinPacketQueue::GetOrCreateStreamIndex(uint32_t ssrc) {
+  auto it = std::lower_bound(
+      stream_indices_.begin(), stream_indices_.end(), ssrc,
+      [](const std::pair<uint32_t, size_t>& entry, uint32_t ssrc) {
+        return entry.first < ssrc;
+      });
+  if (it != stream_indices_.end() && it->first == ssrc)
+    return it->second;
+  streams_.emplace_back(ssrc);
+  stream_indices_.emplace(it, ssrc, streams_.size() - 1);
+  return streams_.size() - 1;
+}
+
+void RoundRobinPacketQueue::Schedule(size_t stream_index, int priority) {
+  Stream& stream = streams_[stream_index];
+  RTC_DCHECK(!stream.scheduled);
+  stream.scheduled = true;
+  stream.scheduled_priority = priority;
+  // Insert before all streams that are not sent from later than this one, so
+  // that it is sent from after streams of the same priority and size that
+  // were scheduled before it.
+  ScheduledStream entry = {priority, stream.size, stream_index};
+  auto it = std::lower_bound(
+      stream_schedule_.begin(), stream_schedule_.end(), entry,
+      [](const ScheduledStream& a, const ScheduledStream& b) {
+        if (a.priority != b.priority)
+          return a.priority > b.priority;
+        return a.size > b.size;
+      });
+  stream_schedule_.insert(it, entry);
+}
+
+void RoundRobinPacketQueue::Unschedule(size_t stream_index) {
+  auto it = std::find_if(stream_schedule_.begin(), stream_schedule_.end(),
+                         [stream_index](const ScheduledStream& entry) {
+                           return entry.stream_index == stream_index;
+                         });
+  RTC_CHECK(it != stream_schedule_.end());
+  stream_schedule_.erase(it);
+  streams_[stream_index].scheduled = false;
+}
+
 RoundRobinPacketQueue::Stream*
 RoundRobinPacketQueue::GetHighestPriorityStream() {
-  RTC_CHECK(!stream_priorities_.empty());
-  uint32_t ssrc = stream_priorities_.begin()->second;
+  RTC_CHECK(!stream_schedule_.empty());
+  Stream* stream = &streams_[stream_schedule_.back().stream_index];
+  RTC_CHECK(stream->scheduled);
+  RTC_CHECK(stream->NextPacketQueue() != nullptr);
+  return stream;
+}
 
-  auto stream_info_it = streams_.find(ssrc);
-  RTC_CHECK(stream_info_it != streams_.end());
-  RTC_CHECK(stream_info_it->second.priority_it == stream_priorities_.begin());
-  RTC_CHECK(!stream_info_it->second.packet_queue.empty());
-  return &stream_info_it->second;
+uint64_t RoundRobinPacketQueue::InsertEnqueueTime(Timestamp enqueue_time) {
+  enqueue_times_.push_back(enqueue_time);
+  return enqueue_times_begin_ + enqueue_times_.size() - 1;
 }
 
-bool RoundRobinPacketQueue::IsSsrcScheduled(uint32_t ssrc) const {
-  for (const auto& scheduled_stream : stream_priorities_) {
-    if (scheduled_stream.second == ssrc)
-      return true;
+void RoundRobinPacketQueue::EraseEnqueueTime(uint64_t index) {
+  RTC_CHECK_GE(index, enqueue_times_begin_);
+  RTC_CHECK_LT(index - enqueue_times_begin_, enqueue_times_.size());
+  enqueue_times_[index - enqueue_times_begin_].reset();
+  while (!enqueue_times_.empty() && !enqueue_times_.front().has_value()) {
+    enqueue_times_.pop_front();
+    ++enqueue_times_begin_;
   }
-  return false;
 }
 
 }  // namespace webrtc
@@ -14,11 +14,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <list>
-#include <map>
+#include <array>
 #include <memory>
-#include <queue>
-#include <set>
+#include <utility>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "api/transport/webrtc_key_value_config.h"
@@ -41,7 +40,9 @@ class RoundRobinPacketQueue {
             Timestamp enqueue_time,
             uint64_t enqueue_order,
             std::unique_ptr<RtpPacketToSend> packet);
-  std::unique_ptr<RtpPacketToSend> Pop();
+  // If |queue_time| is not null, it is set to the time the packet spent in the
+  // queue while not paused.
+  std::unique_ptr<RtpPacketToSend> Pop(TimeDelta* queue_time = nullptr);
 
   bool Empty() const;
   size_t SizeInPackets() const;
@@ -59,19 +60,87 @@ class RoundRobinPacketQueue {
   void SetIncludeOverhead();
   void SetTransportOverhead(DataSize overhead_per_packet);
 
+  // Removes the queued video packets that are marked as discardable, i.e. that
+  // no other frame depends on. Returns the number of removed packets.
+  size_t RemoveDiscardablePackets(Timestamp now);
+
+ // Push() accepts priorities in the range [0, kNumPriorityLevels), where a
+  // lower value means a higher priority.
+  static constexpr int kNumPriorityLevels = 8;
+
  private:
-  struct QueuedPacket {
+  // A FIFO queue backed by a power-of-two sized ring. The storage only grows,
+  // so a queue that has reached its steady-state size pushes and pops without
+  // allocating.
+  template <typename T>
+  class Ring {
+   public:
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    T& front() { return slots_[head_]; }
+    const T& front() const { return slots_[head_]; }
+    T& operator[](size_t index) { return slots_[Slot(index)]; }
+    const T& operator[](size_t index) const { return slots_[Slot(index)]; }
+
+    void push_back(T value) {
+      if (size_ == slots_.size())
+        Grow();
+      slots_[Slot(size_)] = std::move(value);
+      ++size_;
+    }
+    void pop_front() {
+      slots_[head_] = T();
+      head_ = Slot(1);
+      --size_;
+    }
+    // Removes the elements for which |predicate| returns true, keeping the
+    // order of the others. Returns the number of removed elements.
+    template <typename Predicate>
+    size_t RemoveIf(Predicate predicate) {
+      size_t kept = 0;
+      for (size_t i = 0; i < size_; ++i) {
+        if (predicate((*this)[i]))
+          continue;
+        if (kept != i)
+          (*this)[kept] = std::move((*this)[i]);
+        ++kept;
+      }
+      for (size_t i = kept; i < size_; ++i)
+        (*this)[i] = T();
+      const size_t removed = size_ - kept;
+      size_ = kept;
+      return removed;
+    }
+
+   private:
+    size_t Slot(size_t index) const {
+      return (head_ + index) & (slots_.size() - 1);
+    }
+    void Grow() {
+      std::vector<T> slots(slots_.empty() ? 8 : 2 * slots_.size());
+      for (size_t i = 0; i < size_; ++i)
+        slots[i] = std::move((*this)[i]);
+      slots_.swap(slots);
+      head_ = 0;
+    }
+
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+  };
+
+  class QueuedPacket {
    public:
+    QueuedPacket();
     QueuedPacket(int priority,
                  Timestamp enqueue_time,
                  uint64_t enqueue_order,
-                 std::multiset<Timestamp>::iterator enqueue_time_it,
                  std::unique_ptr<RtpPacketToSend> packet);
-    QueuedPacket(const QueuedPacket& rhs);
+    QueuedPacket(QueuedPacket&& rhs);
+    QueuedPacket& operator=(QueuedPacket&& rhs);
     ~QueuedPacket();
 
-    bool operator<(const QueuedPacket& other) const;
-
     int Priority() const;
     RtpPacketMediaType Type() const;
     uint32_t Ssrc() const;
@@ -79,9 +148,10 @@ class RoundRobinPacketQueue {
     bool IsRetransmission() const;
     uint64_t EnqueueOrder() const;
     RtpPacketToSend* RtpPacket() const;
+    std::unique_ptr<RtpPacketToSend> ReleaseRtpPacket();
 
-    std::multiset<Timestamp>::iterator EnqueueTimeIterator() const;
-    void UpdateEnqueueTimeIterator(std::multiset<Timestamp>::iterator it);
+    uint64_t EnqueueTimeIndex() const;
+    void UpdateEnqueueTimeIndex(uint64_t index);
     void SubtractPauseTime(TimeDelta pause_time_sum);
 
    private:
@@ -89,61 +159,66 @@ class RoundRobinPacketQueue {
     Timestamp enqueue_time_;  // Absolute time of pacer queue entry.
     uint64_t enqueue_order_;
     bool is_retransmission_;  // Cached for performance.
-    std::multiset<Timestamp>::iterator enqueue_time_it_;
-    // Raw pointer since priority_queue doesn't allow for moving
-    // out of the container.
-    RtpPacketToSend* owned_packet_;
+    // Position of the packet's entry in |enqueue_times_|.
+    uint64_t enqueue_time_index_;
+    std::unique_ptr<RtpPacketToSend> owned_packet_;
   };
 
-  class PriorityPacketQueue : public std::priority_queue<QueuedPacket> {
-   public:
-    using const_iterator = container_type::const_iterator;
-    const_iterator begin() const;
-    const_iterator end() const;
-  };
-
-  struct StreamPrioKey {
-    StreamPrioKey(int priority, DataSize size)
-        : priority(priority), size(size) {}
-
-    bool operator<(const StreamPrioKey& other) const {
-      if (priority != other.priority)
-        return priority < other.priority;
-      return size < other.size;
-    }
-
-    const int priority;
-    const DataSize size;
-  };
+  // Packets of a stream are sent in order of priority, retransmissions before
+  // other packets of the same priority, and otherwise in enqueue order. Since
+  // the enqueue order only increases, each combination of priority and
+  // retransmission gets a FIFO queue, and the queues are visited in the order
+  // they are sent from.
+  static constexpr int kNumPacketClasses = 2 * kNumPriorityLevels;
 
   struct Stream {
-    Stream();
-    Stream(const Stream&);
+    explicit Stream(uint32_t ssrc);
+    Stream(Stream&&);
+    Stream& operator=(Stream&&);
+    ~Stream();
 
-    virtual ~Stream();
+    // The queue the next packet of this stream is sent from, or nullptr if the
+    // stream has no packets.
+    Ring<QueuedPacket>* NextPacketQueue();
 
     DataSize size;
     uint32_t ssrc;
 
-    PriorityPacketQueue packet_queue;
+    // Indexed by PacketClass().
+    std::array<Ring<QueuedPacket>, kNumPacketClasses> packet_queues;
 
-    // Whenever a packet is inserted for this stream we check if |priority_it|
-    // points to an element in |stream_priorities_|, and if it does it means
-    // this stream has already been scheduled, and if the scheduled priority is
-    // lower than the priority of the incoming packet we reschedule this stream
-    // with the higher priority.
-    std::multimap<StreamPrioKey, uint32_t>::iterator priority_it;
+    // Whether this stream has an entry in |stream_schedule_|, and with which
+    // priority. Whenever a packet is inserted for this stream and it is
+    // scheduled with a lower priority than the incoming packet, the stream is
+    // rescheduled with the higher priority.
+    bool scheduled;
+    int scheduled_priority;
   };
 
+  struct ScheduledStream {
+    int priority;
+    DataSize size;
+    size_t stream_index;
+  };
+
+  static int PacketClass(const QueuedPacket& packet);
+
   void Push(QueuedPacket packet);
 
   DataSize PacketSize(const QueuedPacket& packet) const;
+  static bool IsDiscardable(const QueuedPacket& packet);
+  // Updates the size and queue time of the queue for a packet that is removed
+  // without being sent.
+  void RemoveFromQueueStats(const QueuedPacket& packet);
   void MaybePromoteSinglePacketToNormalQueue();
 
+  size_t GetOrCreateStreamIndex(uint32_t ssrc);
+  void Schedule(size_t stream_index, int priority);
+  void Unschedule(size_t stream_index);
   Stream* GetHighestPriorityStream();
 
-  // Just used to verify correctness.
-  bool IsSsrcScheduled(uint32_t ssrc) const;
+  uint64_t InsertEnqueueTime(Timestamp enqueue_time);
+  void EraseEnqueueTime(uint64_t index);
 
   DataSize transport_overhead_per_packet_;
 
@@ -156,18 +231,25 @@ class RoundRobinPacketQueue {
   TimeDelta queue_time_sum_;
   TimeDelta pause_time_sum_;
 
-  // A map of streams used to prioritize from which stream to send next. We use
-  // a multimap instead of a priority_queue since the priority of a stream can
-  // change as a new packet is inserted, and a multimap allows us to remove and
-  // then reinsert a StreamPrioKey if the priority has increased.
-  std::multimap<StreamPrioKey, uint32_t> stream_priorities_;
-
-  // A map of SSRCs to Streams.
-  std::map<uint32_t, Stream> streams_;
-
-  // The enqueue time of every packet currently in the queue. Used to figure out
-  // the age of the oldest packet in the queue.
-  std::multiset<Timestamp> enqueue_times_;
+  // Streams waiting to send, used to prioritize from which stream to send
+  // next. Sorted so that the stream to send from next is at the back; among
+  // streams with the same priority and size, the one scheduled first is sent
+  // from first. The number of streams is small, so keeping a sorted array is
+  // cheaper than maintaining a tree.
+  std::vector<ScheduledStream> stream_schedule_;
+
+  // Streams are never removed, so indices into |streams_| are stable.
+  std::vector<Stream> streams_;
+  // Pairs of SSRC and index into |streams_|, sorted by SSRC.
+  std::vector<std::pair<uint32_t, size_t>> stream_indices_;
+
+  // The enqueue times of the packets in the queue, in push order. Entries of
+  // popped packets are cleared, and cleared entries are dropped once they
+  // reach the front. Enqueue times never decrease, so the front entry holds
+  // the enqueue time of the oldest packet in the queue.
+  Ring<absl::optional<Timestamp>> enqueue_times_;
+  // The index of the front entry of |enqueue_times_|.
+  uint64_t enqueue_times_begin_;
 
   absl::optional<QueuedPacket> single_packet_queue_;
 
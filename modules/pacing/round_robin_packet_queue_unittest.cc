@@ -0,0 +1,232 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/round_robin_packet_queue.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kAudioSsrc = 1234;
+constexpr uint32_t kVideoSsrc = 5678;
+constexpr int kAudioPriority = 0;
+constexpr int kRetransmissionPriority = 1;
+constexpr int kVideoPriority = 2;
+
+std::unique_ptr<RtpPacketToSend> CreatePacket(RtpPacketMediaType type,
+                                              uint32_t ssrc,
+                                              uint16_t sequence_number,
+                                              size_t payload_size) {
+  auto packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+  packet->set_packet_type(type);
+  packet->SetSsrc(ssrc);
+  packet->SetSequenceNumber(sequence_number);
+  packet->SetPayloadSize(payload_size);
+  return packet;
+}
+
+class RoundRobinPacketQueueTest : public ::testing::Test {
+ protected:
+  RoundRobinPacketQueueTest()
+      : now_(Timestamp::Millis(1000)), queue_(now_, nullptr) {}
+
+  void Push(int priority, std::unique_ptr<RtpPacketToSend> packet) {
+    queue_.Push(priority, now_, enqueue_order_++, std::move(packet));
+  }
+
+  uint16_t PopSequenceNumber() {
+    std::unique_ptr<RtpPacketToSend> packet = queue_.Pop();
+    EXPECT_TRUE(packet);
+    return packet ? packet->SequenceNumber() : 0;
+  }
+
+  Timestamp now_;
+  uint64_t enqueue_order_ = 0;
+  RoundRobinPacketQueue queue_;
+};
+
+TEST_F(RoundRobinPacketQueueTest, EmptyQueue) {
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(queue_.SizeInPackets(), 0u);
+  EXPECT_EQ(queue_.Size(), DataSize::Zero());
+  EXPECT_FALSE(queue_.LeadingAudioPacketEnqueueTime().has_value());
+  EXPECT_EQ(queue_.OldestEnqueueTime(), Timestamp::MinusInfinity());
+}
+
+TEST_F(RoundRobinPacketQueueTest, SendsByPriorityThenRetransmissionsFirst) {
+  Push(kVideoPriority, CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc,
+                                    /*sequence_number=*/1, 100));
+  Push(kVideoPriority,
+       CreatePacket(RtpPacketMediaType::kRetransmission, kVideoSsrc,
+                    /*sequence_number=*/2, 100));
+  Push(kVideoPriority, CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc,
+                                    /*sequence_number=*/3, 100));
+  Push(kRetransmissionPriority,
+       CreatePacket(RtpPacketMediaType::kRetransmission, kVideoSsrc,
+                    /*sequence_number=*/4, 100));
+
+  EXPECT_EQ(queue_.SizeInPackets(), 4u);
+  EXPECT_EQ(PopSequenceNumber(), 4);
+  EXPECT_EQ(PopSequenceNumber(), 2);
+  EXPECT_EQ(PopSequenceNumber(), 1);
+  EXPECT_EQ(PopSequenceNumber(), 3);
+  EXPECT_TRUE(queue_.Empty());
+}
+
+TEST_F(RoundRobinPacketQueueTest, HigherPriorityStreamIsSentFirst) {
+  Push(kVideoPriority, CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc,
+                                    /*sequence_number=*/1, 100));
+  Push(kAudioPriority, CreatePacket(RtpPacketMediaType::kAudio, kAudioSsrc,
+                                    /*sequence_number=*/2, 100));
+
+  EXPECT_EQ(queue_.LeadingAudioPacketEnqueueTime(), now_);
+  EXPECT_EQ(PopSequenceNumber(), 2);
+  EXPECT_FALSE(queue_.LeadingAudioPacketEnqueueTime().has_value());
+  EXPECT_EQ(PopSequenceNumber(), 1);
+}
+
+TEST_F(RoundRobinPacketQueueTest, AlternatesBetweenStreamsOfSamePriority) {
+  const uint32_t kOtherVideoSsrc = kVideoSsrc + 1;
+  for (uint16_t i = 0; i < 3; ++i) {
+    Push(kVideoPriority,
+         CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc, i, 100));
+  }
+  for (uint16_t i = 0; i < 3; ++i) {
+    Push(kVideoPriority, CreatePacket(RtpPacketMediaType::kVideo,
+                                      kOtherVideoSsrc, 100 + i, 100));
+  }
+
+  EXPECT_EQ(PopSequenceNumber(), 0);
+  EXPECT_EQ(PopSequenceNumber(), 100);
+  EXPECT_EQ(PopSequenceNumber(), 1);
+  EXPECT_EQ(PopSequenceNumber(), 101);
+  EXPECT_EQ(PopSequenceNumber(), 2);
+  EXPECT_EQ(PopSequenceNumber(), 102);
+}
+
+TEST_F(RoundRobinPacketQueueTest, TracksSizeAndOldestEnqueueTime) {
+  const Timestamp kFirstEnqueueTime = now_;
+  Push(kVideoPriority, CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc,
+                                    /*sequence_number=*/1, 100));
+  now_ += TimeDelta::Millis(10);
+  queue_.UpdateQueueTime(now_);
+  Push(kAudioPriority, CreatePacket(RtpPacketMediaType::kAudio, kAudioSsrc,
+                                    /*sequence_number=*/2, 50));
+  EXPECT_EQ(queue_.Size(), DataSize::Bytes(150));
+  EXPECT_EQ(queue_.OldestEnqueueTime(), kFirstEnqueueTime);
+  EXPECT_EQ(queue_.AverageQueueTime(), TimeDelta::Millis(5));
+
+  // Popping the newer audio packet leaves the oldest packet in place.
+  EXPECT_EQ(PopSequenceNumber(), 2);
+  EXPECT_EQ(queue_.Size(), DataSize::Bytes(100));
+  EXPECT_EQ(queue_.OldestEnqueueTime(), kFirstEnqueueTime);
+  EXPECT_EQ(queue_.AverageQueueTime(), TimeDelta::Millis(10));
+
+  now_ += TimeDelta::Millis(10);
+  queue_.UpdateQueueTime(now_);
+  Push(kVideoPriority, CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc,
+                                    /*sequence_number=*/3, 100));
+  EXPECT_EQ(PopSequenceNumber(), 1);
+  EXPECT_EQ(queue_.OldestEnqueueTime(), now_);
+  EXPECT_EQ(PopSequenceNumber(), 3);
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(queue_.Size(), DataSize::Zero());
+}
+
+TEST_F(RoundRobinPacketQueueTest, IncludesOverheadOfQueuedPackets) {
+  for (uint16_t i = 0; i < 2; ++i) {
+    Push(kVideoPriority,
+         CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc, i, 100));
+  }
+  const DataSize kHeaderSize = DataSize::Bytes(
+      CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc, 0, 0)->size());
+  queue_.SetIncludeOverhead();
+  EXPECT_EQ(queue_.Size(), 2 * (DataSize::Bytes(100) + kHeaderSize));
+  queue_.SetTransportOverhead(DataSize::Bytes(28));
+  EXPECT_EQ(queue_.Size(), 2 * (DataSize::Bytes(128) + kHeaderSize));
+}
+
+TEST_F(RoundRobinPacketQueueTest, RemovesDiscardablePackets) {
+  const uint32_t kOtherVideoSsrc = kVideoSsrc + 1;
+  for (uint16_t i = 0; i < 4; ++i) {
+    auto packet = CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc, i, 100);
+    packet->set_is_discardable(i % 2 == 1);
+    Push(kVideoPriority, std::move(packet));
+  }
+  auto packet = CreatePacket(RtpPacketMediaType::kVideo, kOtherVideoSsrc,
+                             /*sequence_number=*/100, 100);
+  packet->set_is_discardable(true);
+  Push(kVideoPriority, std::move(packet));
+  // Retransmissions are never dropped.
+  packet = CreatePacket(RtpPacketMediaType::kRetransmission, kVideoSsrc,
+                        /*sequence_number=*/5, 100);
+  packet->set_is_discardable(true);
+  Push(kRetransmissionPriority, std::move(packet));
+
+  now_ += TimeDelta::Millis(10);
+  EXPECT_EQ(queue_.RemoveDiscardablePackets(now_), 3u);
+  EXPECT_EQ(queue_.SizeInPackets(), 3u);
+  EXPECT_EQ(queue_.Size(), DataSize::Bytes(300));
+  EXPECT_EQ(queue_.AverageQueueTime(), TimeDelta::Millis(10));
+
+  EXPECT_EQ(PopSequenceNumber(), 5);
+  EXPECT_EQ(PopSequenceNumber(), 0);
+  EXPECT_EQ(PopSequenceNumber(), 2);
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(queue_.OldestEnqueueTime(), Timestamp::MinusInfinity());
+}
+
+TEST_F(RoundRobinPacketQueueTest, RemovesSingleDiscardablePacket) {
+  auto packet = CreatePacket(RtpPacketMediaType::kVideo, kVideoSsrc,
+                             /*sequence_number=*/1, 100);
+  packet->set_is_discardable(true);
+  Push(kVideoPriority, std::move(packet));
+
+  EXPECT_EQ(queue_.RemoveDiscardablePackets(now_), 1u);
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(queue_.Size(), DataSize::Zero());
+}
+
+TEST_F(RoundRobinPacketQueueTest, DISABLED_PushAndPopThroughput) {
+  constexpr int kNumStreams = 8;
+  constexpr int kPacketsInQueue = 300;
+  constexpr int kNumPackets = 1000000;
+  // Packets are created up front, so that only the queue is measured.
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  packets.reserve(kNumPackets);
+  for (int i = 0; i < kNumPackets; ++i) {
+    packets.push_back(CreatePacket(RtpPacketMediaType::kVideo,
+                                   kVideoSsrc + i % kNumStreams, i, 1000));
+  }
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    Push(kVideoPriority + i % 2, std::move(packets[i]));
+    if (i >= kPacketsInQueue)
+      packets[i - kPacketsInQueue] = queue_.Pop();
+  }
+  while (!queue_.Empty())
+    queue_.Pop();
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  RTC_LOG(LS_INFO) << "Pushed and popped " << kNumPackets << " packets in "
+                   << elapsed_us << " us, "
+                   << kNumPackets * int64_t{1000000} / elapsed_us
+                   << " packets/s.";
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,356 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/shared_pacer.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+SharedPacer::SharedPacer(Clock* clock,
+                         TaskQueueFactory* task_queue_factory,
+                         int num_task_queues,
+                         TimeDelta hold_back_window)
+    : clock_(clock), num_senders_(num_task_queues, 0) {
+  RTC_DCHECK_GT(num_task_queues, 0);
+  for (int i = 0; i < num_task_queues; ++i) {
+    shards_.push_back(std::make_unique<Shard>(clock, task_queue_factory,
+                                              hold_back_window));
+  }
+}
+
+SharedPacer::~SharedPacer() {
+  rtc::CritScope cs(&crit_);
+  for (int num_senders : num_senders_) {
+    RTC_DCHECK_EQ(num_senders, 0);
+  }
+}
+
+std::unique_ptr<SharedPacedSender> SharedPacer::CreateSender(
+    PacketRouter* packet_router,
+    RtcEventLog* event_log,
+    const WebRtcKeyValueConfig* field_trials) {
+  size_t index;
+  {
+    rtc::CritScope cs(&crit_);
+    index = std::min_element(num_senders_.begin(), num_senders_.end()) -
+            num_senders_.begin();
+    ++num_senders_[index];
+  }
+  return std::unique_ptr<SharedPacedSender>(
+      new SharedPacedSender(this, shards_[index].get(), clock_, packet_router,
+                            event_log, field_trials));
+}
+
+int SharedPacer::GetNumSenders(int index) const {
+  rtc::CritScope cs(&crit_);
+  return num_senders_[index];
+}
+
+void SharedPacer::OnSenderDestroyed(Shard* shard) {
+  rtc::CritScope cs(&crit_);
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (shards_[i].get() == shard) {
+      --num_senders_[i];
+      return;
+    }
+  }
+  RTC_NOTREACHED();
+}
+
+SharedPacer::Shard::Shard(Clock* clock,
+                          TaskQueueFactory* task_queue_factory,
+                          TimeDelta hold_back_window)
+    : clock_(clock),
+      hold_back_window_(
+          std::max(hold_back_window, PacingController::kMinSleepTime)),
+      task_queue_(task_queue_factory->CreateTaskQueue(
+          "SharedPacer",
+          TaskQueueFactory::Priority::NORMAL)) {}
+
+SharedPacer::Shard::~Shard() {
+  // The rtc::TaskQueue destructor waits for pending tasks to complete, but
+  // delayed tasks must not post new ones meanwhile.
+  task_queue_.PostTask([this]() {
+    RTC_DCHECK_RUN_ON(&task_queue_);
+    RTC_DCHECK(schedule_.empty());
+    is_shutdown_ = true;
+  });
+}
+
+void SharedPacer::Shard::Reschedule(SharedPacedSender* sender) {
+  if (sender->scheduled_time_.IsFinite()) {
+    schedule_.erase({sender->scheduled_time_, sender});
+    sender->scheduled_time_ = Timestamp::MinusInfinity();
+  }
+  // Like TaskQueuePacedSender, send right away if the change made the sender
+  // due, rather than after a wakeup.
+  const Timestamp now = clock_->CurrentTime();
+  if (sender->pacing_controller_.NextSendTime() <= now) {
+    sender->ProcessPackets();
+  } else {
+    sender->UpdateStats();
+  }
+  Schedule(sender, now);
+  MaybePostWakeup(now);
+}
+
+void SharedPacer::Shard::Remove(SharedPacedSender* sender) {
+  if (sender->scheduled_time_.IsFinite()) {
+    schedule_.erase({sender->scheduled_time_, sender});
+    sender->scheduled_time_ = Timestamp::MinusInfinity();
+  }
+}
+
+void SharedPacer::Shard::OnWakeup(Timestamp scheduled_time) {
+  if (scheduled_time == next_wakeup_)
+    next_wakeup_ = Timestamp::MinusInfinity();
+  if (is_shutdown_)
+    return;
+
+  const Timestamp now = clock_->CurrentTime();
+  while (!schedule_.empty() && schedule_.begin()->first <= now) {
+    SharedPacedSender* sender = schedule_.begin()->second;
+    schedule_.erase(schedule_.begin());
+    sender->scheduled_time_ = Timestamp::MinusInfinity();
+    sender->ProcessPackets();
+    // Always lands after |now|, so every sender runs at most once per wakeup.
+    Schedule(sender, now);
+  }
+  MaybePostWakeup(now);
+}
+
+void SharedPacer::Shard::Schedule(SharedPacedSender* sender, Timestamp now) {
+  RTC_DCHECK(sender->scheduled_time_.IsMinusInfinity());
+  const TimeDelta min_sleep = sender->pacing_controller_.IsProbing()
+                                  ? PacingController::kMinSleepTime
+                                  : hold_back_window_;
+  sender->scheduled_time_ =
+      std::max(now + min_sleep, sender->pacing_controller_.NextSendTime());
+  schedule_.insert({sender->scheduled_time_, sender});
+}
+
+void SharedPacer::Shard::MaybePostWakeup(Timestamp now) {
+  if (is_shutdown_ || schedule_.empty())
+    return;
+  // Only post a new task if it is needed noticeably before the one in flight.
+  const Timestamp wakeup = schedule_.begin()->first;
+  if (next_wakeup_.IsFinite() &&
+      wakeup > next_wakeup_ - PacingController::kMinSleepTime) {
+    return;
+  }
+  next_wakeup_ = wakeup;
+  // Rounded up, since a wakeup before |wakeup| would find nothing to do.
+  const int64_t delay_us = std::max<int64_t>((wakeup - now).us(), 0);
+  task_queue_.PostDelayedTask(
+      [this, wakeup]() {
+        RTC_DCHECK_RUN_ON(&task_queue_);
+        OnWakeup(wakeup);
+      },
+      static_cast<uint32_t>((delay_us + 999) / 1000));
+}
+
+SharedPacedSender::SharedPacedSender(SharedPacer* owner,
+                                     SharedPacer::Shard* shard,
+                                     Clock* clock,
+                                     PacketRouter* packet_router,
+                                     RtcEventLog* event_log,
+                                     const WebRtcKeyValueConfig* field_trials)
+    : owner_(owner),
+      shard_(shard),
+      task_queue_(shard->task_queue()),
+      pacing_controller_(clock,
+                         packet_router,
+                         event_log,
+                         field_trials,
+                         PacingController::ProcessMode::kDynamic) {}
+
+SharedPacedSender::~SharedPacedSender() {
+  // Tasks posted by this sender run before this one, and no delayed task
+  // refers to a sender once it is out of the schedule.
+  if (task_queue_->IsCurrent()) {
+    RTC_DCHECK_RUN_ON(task_queue_);
+    shard_->Remove(this);
+  } else {
+    rtc::Event done;
+    task_queue_->PostTask([this, &done]() {
+      RTC_DCHECK_RUN_ON(task_queue_);
+      shard_->Remove(this);
+      done.Set();
+    });
+    done.Wait(rtc::Event::kForever);
+  }
+  owner_->OnSenderDestroyed(shard_);
+}
+
+template <typename Closure>
+void SharedPacedSender::PostTask(Closure&& task, bool reschedule) {
+  task_queue_->PostTask(
+      [this, task = std::forward<Closure>(task), reschedule]() mutable {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        task();
+        if (reschedule)
+          shard_->Reschedule(this);
+      });
+}
+
+void SharedPacedSender::EnqueuePackets(
+    std::vector<std::unique_ptr<RtpPacketToSend>> packets) {
+  PostTask(
+      [this, packets = std::move(packets)]() mutable {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        for (auto& packet : packets) {
+          pacing_controller_.EnqueuePacket(std::move(packet));
+        }
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::CreateProbeCluster(DataRate bitrate, int cluster_id) {
+  PostTask(
+      [this, bitrate, cluster_id]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.CreateProbeCluster(bitrate, cluster_id);
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::Pause() {
+  PostTask(
+      [this]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.Pause();
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::Resume() {
+  PostTask(
+      [this]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.Resume();
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::SetCongestionWindow(DataSize congestion_window_size) {
+  PostTask(
+      [this, congestion_window_size]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.SetCongestionWindow(congestion_window_size);
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::UpdateOutstandingData(DataSize outstanding_data) {
+  if (task_queue_->IsCurrent()) {
+    RTC_DCHECK_RUN_ON(task_queue_);
+    // Fast path since this can be called once per sent packet while on the
+    // task queue. The sender is rescheduled after the packets are sent.
+    pacing_controller_.UpdateOutstandingData(outstanding_data);
+    return;
+  }
+  PostTask(
+      [this, outstanding_data]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.UpdateOutstandingData(outstanding_data);
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::SetPacingRates(DataRate pacing_rate,
+                                       DataRate padding_rate) {
+  PostTask(
+      [this, pacing_rate, padding_rate]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.SetPacingRates(pacing_rate, padding_rate);
+      },
+      /*reschedule=*/true);
+}
+
+void SharedPacedSender::SetAccountForAudioPackets(bool account_for_audio) {
+  PostTask(
+      [this, account_for_audio]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.SetAccountForAudioPackets(account_for_audio);
+      },
+      /*reschedule=*/false);
+}
+
+void SharedPacedSender::SetIncludeOverhead() {
+  PostTask(
+      [this]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.SetIncludeOverhead();
+      },
+      /*reschedule=*/false);
+}
+
+void SharedPacedSender::SetTransportOverhead(DataSize overhead_per_packet) {
+  PostTask(
+      [this, overhead_per_packet]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.SetTransportOverhead(overhead_per_packet);
+      },
+      /*reschedule=*/false);
+}
+
+void SharedPacedSender::SetQueueTimeLimit(TimeDelta limit) {
+  PostTask(
+      [this, limit]() {
+        RTC_DCHECK_RUN_ON(task_queue_);
+        pacing_controller_.SetQueueTimeLimit(limit);
+      },
+      /*reschedule=*/true);
+}
+
+TimeDelta SharedPacedSender::ExpectedQueueTime() const {
+  return GetStats().expected_queue_time;
+}
+
+DataSize SharedPacedSender::QueueSizeData() const {
+  return GetStats().queue_size;
+}
+
+absl::optional<Timestamp> SharedPacedSender::FirstSentPacketTime() const {
+  return GetStats().first_sent_packet_time;
+}
+
+TimeDelta SharedPacedSender::OldestPacketWaitTime() const {
+  return GetStats().oldest_packet_wait_time;
+}
+
+void SharedPacedSender::ProcessPackets() {
+  pacing_controller_.ProcessPackets();
+  UpdateStats();
+}
+
+void SharedPacedSender::UpdateStats() {
+  // Senders with queued packets run at least every kPausedProcessInterval,
+  // which keeps the stats fresh without a stats task of their own.
+  Stats stats;
+  stats.expected_queue_time = pacing_controller_.ExpectedQueueTime();
+  stats.first_sent_packet_time = pacing_controller_.FirstSentPacketTime();
+  stats.oldest_packet_wait_time = pacing_controller_.OldestPacketWaitTime();
+  stats.queue_size = pacing_controller_.QueueSizeData();
+  rtc::CritScope cs(&stats_crit_);
+  current_stats_ = stats;
+}
+
+SharedPacedSender::Stats SharedPacedSender::GetStats() const {
+  rtc::CritScope cs(&stats_crit_);
+  return current_stats_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,184 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_SHARED_PACER_H_
+#define MODULES_PACING_SHARED_PACER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/transport/webrtc_key_value_config.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "modules/pacing/pacing_controller.h"
+#include "modules/pacing/packet_router.h"
+#include "modules/pacing/rtp_packet_pacer.h"
+#include "modules/rtp_rtcp/include/rtp_packet_sender.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+class Clock;
+class RtcEventLog;
+class SharedPacedSender;
+
+// Runs the pacing of many transports on a few task queues, instead of one
+// task queue and timer per transport as TaskQueuePacedSender does. Each task
+// queue keeps its pacers ordered by the time they next need to run, and wakes
+// up once for all pacers that are due, so transports that have nothing to send
+// cost no wakeups of their own.
+//
+// Thread safe. Must outlive the senders it creates.
+class SharedPacer {
+ public:
+  // The |hold_back_window| is the least time to sleep while not probing, as
+  // for TaskQueuePacedSender. Raising it coalesces more wakeups, at the
+  // expense of latency.
+  SharedPacer(Clock* clock,
+              TaskQueueFactory* task_queue_factory,
+              int num_task_queues,
+              TimeDelta hold_back_window = PacingController::kMinSleepTime);
+  ~SharedPacer();
+
+  // Creates the pacer of one transport, on the least loaded task queue.
+  std::unique_ptr<SharedPacedSender> CreateSender(
+      PacketRouter* packet_router,
+      RtcEventLog* event_log,
+      const WebRtcKeyValueConfig* field_trials);
+
+  int num_task_queues() const { return static_cast<int>(shards_.size()); }
+  // Returns the number of senders that run on task queue |index|.
+  int GetNumSenders(int index) const;
+
+ private:
+  friend class SharedPacedSender;
+
+  // One task queue, and the senders that run on it.
+  class Shard {
+   public:
+    Shard(Clock* clock,
+          TaskQueueFactory* task_queue_factory,
+          TimeDelta hold_back_window);
+    ~Shard();
+
+    rtc::TaskQueue* task_queue() { return &task_queue_; }
+
+    // Processes |sender| if it is due, and schedules it for when it next
+    // needs to run. Called whenever the state of its pacer has changed.
+    void Reschedule(SharedPacedSender* sender) RTC_RUN_ON(task_queue_);
+    void Remove(SharedPacedSender* sender) RTC_RUN_ON(task_queue_);
+
+   private:
+    // Processes all senders that are due. |scheduled_time| identifies the
+    // delayed task that made the call, see |next_wakeup_|.
+    void OnWakeup(Timestamp scheduled_time) RTC_RUN_ON(task_queue_);
+    void Schedule(SharedPacedSender* sender, Timestamp now)
+        RTC_RUN_ON(task_queue_);
+    void MaybePostWakeup(Timestamp now) RTC_RUN_ON(task_queue_);
+
+    Clock* const clock_;
+    const TimeDelta hold_back_window_;
+    // Senders ordered by the time they next need to run.
+    std::set<std::pair<Timestamp, SharedPacedSender*>> schedule_
+        RTC_GUARDED_BY(task_queue_);
+    // The time of the one valid delayed task in flight, or MinusInfinity() if
+    // there is none. Superseded tasks still run, but do not post new ones.
+    Timestamp next_wakeup_ RTC_GUARDED_BY(task_queue_) =
+        Timestamp::MinusInfinity();
+    bool is_shutdown_ RTC_GUARDED_BY(task_queue_) = false;
+    rtc::TaskQueue task_queue_;
+  };
+
+  void OnSenderDestroyed(Shard* shard);
+
+  Clock* const clock_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  rtc::CriticalSection crit_;
+  std::vector<int> num_senders_ RTC_GUARDED_BY(crit_);
+};
+
+// The pacer of one transport, run by a SharedPacer. Works like
+// TaskQueuePacedSender, and may be used in its place.
+class SharedPacedSender : public RtpPacketPacer, public RtpPacketSender {
+ public:
+  ~SharedPacedSender() override;
+
+  // Methods implementing RtpPacketSender.
+  void EnqueuePackets(
+      std::vector<std::unique_ptr<RtpPacketToSend>> packets) override;
+
+  // Methods implementing RtpPacketPacer.
+  void CreateProbeCluster(DataRate bitrate, int cluster_id) override;
+  void Pause() override;
+  void Resume() override;
+  void SetCongestionWindow(DataSize congestion_window_size) override;
+  void UpdateOutstandingData(DataSize outstanding_data) override;
+  void SetPacingRates(DataRate pacing_rate, DataRate padding_rate) override;
+  void SetAccountForAudioPackets(bool account_for_audio) override;
+  void SetIncludeOverhead() override;
+  void SetTransportOverhead(DataSize overhead_per_packet) override;
+  TimeDelta OldestPacketWaitTime() const override;
+  DataSize QueueSizeData() const override;
+  absl::optional<Timestamp> FirstSentPacketTime() const override;
+  TimeDelta ExpectedQueueTime() const override;
+  void SetQueueTimeLimit(TimeDelta limit) override;
+
+ private:
+  friend class SharedPacer;
+  friend class SharedPacer::Shard;
+
+  struct Stats {
+    TimeDelta oldest_packet_wait_time = TimeDelta::Zero();
+    DataSize queue_size = DataSize::Zero();
+    TimeDelta expected_queue_time = TimeDelta::Zero();
+    absl::optional<Timestamp> first_sent_packet_time;
+  };
+
+  SharedPacedSender(SharedPacer* owner,
+                    SharedPacer::Shard* shard,
+                    Clock* clock,
+                    PacketRouter* packet_router,
+                    RtcEventLog* event_log,
+                    const WebRtcKeyValueConfig* field_trials);
+
+  // Posts |task| to the task queue, followed by a reschedule if
+  // |reschedule| is set.
+  template <typename Closure>
+  void PostTask(Closure&& task, bool reschedule);
+  void ProcessPackets() RTC_RUN_ON(task_queue_);
+  void UpdateStats() RTC_RUN_ON(task_queue_);
+  Stats GetStats() const;
+
+  SharedPacer* const owner_;
+  SharedPacer::Shard* const shard_;
+  rtc::TaskQueue* const task_queue_;
+  PacingController pacing_controller_ RTC_GUARDED_BY(task_queue_);
+  // The key of this sender in the schedule of |shard_|, or MinusInfinity() if
+  // it is not scheduled.
+  Timestamp scheduled_time_ RTC_GUARDED_BY(task_queue_) =
+      Timestamp::MinusInfinity();
+
+  rtc::CriticalSection stats_crit_;
+  Stats current_stats_ RTC_GUARDED_BY(stats_crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_SHARED_PACER_H_
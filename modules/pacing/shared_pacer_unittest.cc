@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/shared_pacer.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "modules/pacing/packet_router.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kDefaultPacketSize = 1234;
+
+class MockPacketRouter : public PacketRouter {
+ public:
+  MOCK_METHOD(void,
+              SendPacket,
+              (std::unique_ptr<RtpPacketToSend> packet,
+               const PacedPacketInfo& cluster_info),
+              (override));
+  MOCK_METHOD(std::vector<std::unique_ptr<RtpPacketToSend>>,
+              GeneratePadding,
+              (DataSize target_size),
+              (override));
+};
+
+std::vector<std::unique_ptr<RtpPacketToSend>> GenerateVideoPackets(
+    size_t num_packets) {
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  for (size_t i = 0; i < num_packets; ++i) {
+    auto packet = std::make_unique<RtpPacketToSend>(nullptr);
+    packet->set_packet_type(RtpPacketMediaType::kVideo);
+    packet->SetSsrc(1234);
+    packet->SetPayloadSize(kDefaultPacketSize);
+    packets.push_back(std::move(packet));
+  }
+  return packets;
+}
+
+}  // namespace
+
+TEST(SharedPacerTest, PacesPacketsOfEachSender) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
+  SharedPacer shared_pacer(time_controller.GetClock(),
+                           time_controller.GetTaskQueueFactory(),
+                           /*num_task_queues=*/2);
+  constexpr int kNumSenders = 5;
+  constexpr size_t kPacketsToSend = 42;
+  std::vector<std::unique_ptr<MockPacketRouter>> routers;
+  std::vector<std::unique_ptr<SharedPacedSender>> senders;
+  std::vector<size_t> packets_sent(kNumSenders, 0);
+  std::vector<Timestamp> start_times;
+  std::vector<Timestamp> end_times(kNumSenders, Timestamp::PlusInfinity());
+  // Each sender gets packets covering one second, from a different start
+  // time.
+  for (int i = 0; i < kNumSenders; ++i) {
+    routers.push_back(std::make_unique<MockPacketRouter>());
+    EXPECT_CALL(*routers.back(), SendPacket)
+        .WillRepeatedly([&, i](std::unique_ptr<RtpPacketToSend> packet,
+                               const PacedPacketInfo& cluster_info) {
+          if (++packets_sent[i] == kPacketsToSend) {
+            end_times[i] = time_controller.GetClock()->CurrentTime();
+          }
+        });
+    senders.push_back(shared_pacer.CreateSender(routers.back().get(),
+                                                /*event_log=*/nullptr,
+                                                /*field_trials=*/nullptr));
+    start_times.push_back(time_controller.GetClock()->CurrentTime());
+    senders.back()->SetPacingRates(
+        DataRate::BitsPerSec(kDefaultPacketSize * 8 * kPacketsToSend),
+        DataRate::Zero());
+    senders.back()->EnqueuePackets(GenerateVideoPackets(kPacketsToSend));
+    time_controller.AdvanceTime(TimeDelta::Millis(7));
+  }
+  EXPECT_EQ(3, shared_pacer.GetNumSenders(0));
+  EXPECT_EQ(2, shared_pacer.GetNumSenders(1));
+  time_controller.AdvanceTime(TimeDelta::Seconds(1));
+
+  for (int i = 0; i < kNumSenders; ++i) {
+    EXPECT_EQ(kPacketsToSend, packets_sent[i]);
+    ASSERT_TRUE(end_times[i].IsFinite());
+    // A little less than a second, since initial probing is a bit quicker.
+    EXPECT_NEAR((end_times[i] - start_times[i]).ms<double>(), 1000.0, 50.0);
+  }
+}
+
+TEST(SharedPacerTest, UpdatesStatsOfQueuedPackets) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
+  SharedPacer shared_pacer(time_controller.GetClock(),
+                           time_controller.GetTaskQueueFactory(),
+                           /*num_task_queues=*/1);
+  ::testing::NiceMock<MockPacketRouter> packet_router;
+  std::unique_ptr<SharedPacedSender> sender =
+      shared_pacer.CreateSender(&packet_router, /*event_log=*/nullptr,
+                                /*field_trials=*/nullptr);
+
+  // At one packet per second, the last of three stays queued for a while.
+  sender->SetPacingRates(DataRate::BitsPerSec(kDefaultPacketSize * 8),
+                         DataRate::Zero());
+  sender->EnqueuePackets(GenerateVideoPackets(3));
+  time_controller.AdvanceTime(TimeDelta::Millis(500));
+  EXPECT_GT(sender->QueueSizeData(), DataSize::Zero());
+  EXPECT_GT(sender->ExpectedQueueTime(), TimeDelta::Zero());
+  EXPECT_TRUE(sender->FirstSentPacketTime());
+
+  time_controller.AdvanceTime(TimeDelta::Seconds(5));
+  EXPECT_EQ(DataSize::Zero(), sender->QueueSizeData());
+}
+
+TEST(SharedPacerTest, BalancesSendersOverTaskQueues) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
+  SharedPacer shared_pacer(time_controller.GetClock(),
+                           time_controller.GetTaskQueueFactory(),
+                           /*num_task_queues=*/2);
+  EXPECT_EQ(2, shared_pacer.num_task_queues());
+  PacketRouter packet_router;
+  auto first = shared_pacer.CreateSender(&packet_router, nullptr, nullptr);
+  auto second = shared_pacer.CreateSender(&packet_router, nullptr, nullptr);
+  EXPECT_EQ(1, shared_pacer.GetNumSenders(0));
+  EXPECT_EQ(1, shared_pacer.GetNumSenders(1));
+
+  first.reset();
+  EXPECT_EQ(0, shared_pacer.GetNumSenders(0));
+  auto third = shared_pacer.CreateSender(&packet_router, nullptr, nullptr);
+  EXPECT_EQ(1, shared_pacer.GetNumSenders(0));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/packet_arrival_map.h"
+
+#include <algorithm>
+
+namespace webrtc {
+
+constexpr int64_t PacketArrivalTimeMap::kNotReceived;
+
+PacketArrivalTimeMap::PacketArrivalTimeMap() = default;
+PacketArrivalTimeMap::~PacketArrivalTimeMap() = default;
+
+int64_t PacketArrivalTimeMap::LowerBound(int64_t sequence_number) const {
+  if (sequence_number <= begin_sequence_number_) {
+    return begin_sequence_number_;
+  }
+  for (; sequence_number < end_sequence_number_; ++sequence_number) {
+    if (Slot(sequence_number) != kNotReceived) {
+      return sequence_number;
+    }
+  }
+  return end_sequence_number_;
+}
+
+void PacketArrivalTimeMap::AddPacket(int64_t sequence_number,
+                                     int64_t arrival_time_ms) {
+  RTC_DCHECK_GE(arrival_time_ms, 0);
+  if (empty()) {
+    Reserve(sequence_number, sequence_number + 1);
+    begin_sequence_number_ = sequence_number;
+    end_sequence_number_ = sequence_number + 1;
+  } else if (sequence_number < begin_sequence_number_) {
+    Reserve(sequence_number, end_sequence_number_);
+    begin_sequence_number_ = sequence_number;
+  } else if (sequence_number >= end_sequence_number_) {
+    Reserve(begin_sequence_number_, sequence_number + 1);
+    end_sequence_number_ = sequence_number + 1;
+  } else if (Slot(sequence_number) != kNotReceived) {
+    // Only the first arrival is of interest.
+    return;
+  }
+  Slot(sequence_number) = arrival_time_ms;
+}
+
+void PacketArrivalTimeMap::EraseTo(int64_t sequence_number) {
+  if (sequence_number >= end_sequence_number_) {
+    sequence_number = end_sequence_number_;
+  }
+  for (; begin_sequence_number_ < sequence_number; ++begin_sequence_number_) {
+    Slot(begin_sequence_number_) = kNotReceived;
+  }
+  TrimBeginning();
+}
+
+void PacketArrivalTimeMap::RemoveOldPackets(int64_t sequence_number,
+                                            int64_t arrival_time_limit_ms) {
+  while (!empty() && begin_sequence_number_ < sequence_number &&
+         Slot(begin_sequence_number_) <= arrival_time_limit_ms) {
+    Slot(begin_sequence_number_) = kNotReceived;
+    ++begin_sequence_number_;
+    TrimBeginning();
+  }
+}
+
+void PacketArrivalTimeMap::Reserve(int64_t begin, int64_t end) {
+  static constexpr size_t kMinCapacity = 64;
+  const size_t span = static_cast<size_t>(end - begin);
+  if (span <= arrival_times_.size()) {
+    return;
+  }
+  size_t capacity = std::max(kMinCapacity, arrival_times_.size());
+  while (capacity < span) {
+    capacity *= 2;
+  }
+  std::vector<int64_t> arrival_times(capacity, kNotReceived);
+  for (int64_t sequence_number = begin_sequence_number_;
+       sequence_number < end_sequence_number_; ++sequence_number) {
+    arrival_times[sequence_number & (capacity - 1)] = Slot(sequence_number);
+  }
+  arrival_times_.swap(arrival_times);
+}
+
+void PacketArrivalTimeMap::TrimBeginning() {
+  while (begin_sequence_number_ < end_sequence_number_ &&
+         Slot(begin_sequence_number_) == kNotReceived) {
+    ++begin_sequence_number_;
+  }
+}
+
+}  // namespace webrtc
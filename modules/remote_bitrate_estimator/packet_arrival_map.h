@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_PACKET_ARRIVAL_MAP_H_
+#define MODULES_REMOTE_BITRATE_ESTIMATOR_PACKET_ARRIVAL_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Arrival times of received packets, indexed by unwrapped transport sequence
+// number. The times are kept in a ring buffer that spans the sequence numbers
+// from the lowest to the highest received one, so adding, looking up and
+// removing packets is constant time, and no memory is allocated once the
+// buffer has grown to the size of the span.
+//
+// Both ends of the span are always received packets.
+class PacketArrivalTimeMap {
+ public:
+  PacketArrivalTimeMap();
+  ~PacketArrivalTimeMap();
+
+  bool empty() const { return end_sequence_number_ == begin_sequence_number_; }
+
+  // The lowest received sequence number, and one past the highest one. Only
+  // valid if not empty.
+  int64_t begin_sequence_number() const { return begin_sequence_number_; }
+  int64_t end_sequence_number() const { return end_sequence_number_; }
+
+  bool has_received(int64_t sequence_number) const {
+    return sequence_number >= begin_sequence_number_ &&
+           sequence_number < end_sequence_number_ &&
+           Slot(sequence_number) != kNotReceived;
+  }
+
+  // Returns the arrival time of |sequence_number|, which must have been
+  // received.
+  int64_t get(int64_t sequence_number) const {
+    RTC_DCHECK(has_received(sequence_number));
+    return Slot(sequence_number);
+  }
+
+  // Returns the lowest received sequence number that is not lower than
+  // |sequence_number|, or end_sequence_number() if there is none.
+  int64_t LowerBound(int64_t sequence_number) const;
+
+  // Records that |sequence_number| arrived at |arrival_time_ms|, which must be
+  // non-negative. Does nothing if it has already been received.
+  void AddPacket(int64_t sequence_number, int64_t arrival_time_ms);
+
+  // Removes all packets with sequence numbers lower than |sequence_number|.
+  void EraseTo(int64_t sequence_number);
+
+  // Removes packets from the beginning, as long as their sequence number is
+  // lower than |sequence_number| and they arrived no later than
+  // |arrival_time_limit_ms|.
+  void RemoveOldPackets(int64_t sequence_number,
+                        int64_t arrival_time_limit_ms);
+
+ private:
+  static constexpr int64_t kNotReceived = -1;
+
+  int64_t& Slot(int64_t sequence_number) {
+    return arrival_times_[sequence_number & (arrival_times_.size() - 1)];
+  }
+  int64_t Slot(int64_t sequence_number) const {
+    return arrival_times_[sequence_number & (arrival_times_.size() - 1)];
+  }
+  // Makes room for the sequence numbers [|begin|, |end|).
+  void Reserve(int64_t begin, int64_t end);
+  // Moves the beginning forward to the first received packet.
+  void TrimBeginning();
+
+  // Indexed by sequence number modulo the size, which is zero or a power of
+  // two. Slots outside of the span are kNotReceived.
+  std::vector<int64_t> arrival_times_;
+  int64_t begin_sequence_number_ = 0;
+  int64_t end_sequence_number_ = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_REMOTE_BITRATE_ESTIMATOR_PACKET_ARRIVAL_MAP_H_
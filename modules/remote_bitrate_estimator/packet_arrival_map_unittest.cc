@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/packet_arrival_map.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+TEST(PacketArrivalMapTest, IsConsistentWhenEmpty) {
+  PacketArrivalTimeMap map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.has_received(0));
+  EXPECT_EQ(map.end_sequence_number(), map.LowerBound(0));
+}
+
+TEST(PacketArrivalMapTest, KeepsFirstArrivalOfPackets) {
+  PacketArrivalTimeMap map;
+  map.AddPacket(42, 10);
+  map.AddPacket(45, 11);
+  map.AddPacket(42, 12);
+  EXPECT_EQ(42, map.begin_sequence_number());
+  EXPECT_EQ(46, map.end_sequence_number());
+  EXPECT_EQ(10, map.get(42));
+  EXPECT_EQ(11, map.get(45));
+  EXPECT_FALSE(map.has_received(43));
+  EXPECT_EQ(45, map.LowerBound(43));
+  EXPECT_EQ(46, map.LowerBound(46));
+}
+
+TEST(PacketArrivalMapTest, GrowsInBothDirections) {
+  PacketArrivalTimeMap map;
+  map.AddPacket(1000, 1);
+  map.AddPacket(1100, 2);
+  map.AddPacket(900, 3);
+  map.AddPacket(2000, 4);
+  EXPECT_EQ(900, map.begin_sequence_number());
+  EXPECT_EQ(2001, map.end_sequence_number());
+  EXPECT_EQ(1, map.get(1000));
+  EXPECT_EQ(2, map.get(1100));
+  EXPECT_EQ(3, map.get(900));
+  EXPECT_EQ(4, map.get(2000));
+  EXPECT_FALSE(map.has_received(1500));
+}
+
+TEST(PacketArrivalMapTest, EraseToSkipsToNextReceivedPacket) {
+  PacketArrivalTimeMap map;
+  map.AddPacket(10, 1);
+  map.AddPacket(11, 2);
+  map.AddPacket(15, 3);
+  map.EraseTo(12);
+  EXPECT_EQ(15, map.begin_sequence_number());
+  EXPECT_FALSE(map.has_received(11));
+  EXPECT_TRUE(map.has_received(15));
+
+  map.EraseTo(100);
+  EXPECT_TRUE(map.empty());
+  map.AddPacket(5, 4);
+  EXPECT_EQ(5, map.begin_sequence_number());
+  EXPECT_EQ(6, map.end_sequence_number());
+}
+
+TEST(PacketArrivalMapTest, RemovesOldPacketsUpToSequenceNumber) {
+  PacketArrivalTimeMap map;
+  map.AddPacket(10, 100);
+  map.AddPacket(11, 200);
+  map.AddPacket(13, 150);
+  map.AddPacket(14, 300);
+
+  // Stops at the first packet that is too recent.
+  map.RemoveOldPackets(20, 150);
+  EXPECT_EQ(11, map.begin_sequence_number());
+
+  map.RemoveOldPackets(14, 1000);
+  EXPECT_EQ(14, map.begin_sequence_number());
+  EXPECT_EQ(300, map.get(14));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -42,23 +42,16 @@ enum {
   kInitialProbingIntervalMs = 2000,
   kMinClusterSize = 4,
   kMaxProbePackets = 15,
-  kExpectedNumberOfProbes = 3
+  kExpectedNumberOfProbes = 3,
+  // Probes are only kept for recomputing the clusters after the oldest probe
+  // is removed, which only happens while there are fewer than
+  // kMaxProbePackets probes without clusters.
+  kMaxStoredProbes = 64
 };
 
 static const double kTimestampToMs =
     1000.0 / static_cast<double>(1 << kInterArrivalShift);
 
-template <typename K, typename V>
-std::vector<K> Keys(const std::map<K, V>& map) {
-  std::vector<K> keys;
-  keys.reserve(map.size());
-  for (typename std::map<K, V>::const_iterator it = map.begin();
-       it != map.end(); ++it) {
-    keys.push_back(it->first);
-  }
-  return keys;
-}
-
 uint32_t ConvertMsTo24Bits(int64_t time_ms) {
   uint32_t time_24_bits =
       static_cast<uint32_t>(((static_cast<uint64_t>(time_ms)
@@ -82,12 +75,19 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
   return fabs(static_cast<float>(send_delta_ms) - cluster_mean) < 2.5f;
 }
 
-void RemoteBitrateEstimatorAbsSendTime::AddCluster(std::list<Cluster>* clusters,
-                                                   Cluster* cluster) {
-  cluster->send_mean_ms /= static_cast<float>(cluster->count);
-  cluster->recv_mean_ms /= static_cast<float>(cluster->count);
-  cluster->mean_size /= cluster->count;
-  clusters->push_back(*cluster);
+bool RemoteBitrateEstimatorAbsSendTime::IsClusterComplete(
+    const Cluster& cluster) {
+  return cluster.count >= kMinClusterSize && cluster.send_mean_ms > 0.0f &&
+         cluster.recv_mean_ms > 0.0f;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::AddCluster(
+    std::vector<Cluster>* clusters,
+    Cluster cluster) {
+  cluster.send_mean_ms /= static_cast<float>(cluster.count);
+  cluster.recv_mean_ms /= static_cast<float>(cluster.count);
+  cluster.mean_size /= cluster.count;
+  clusters->push_back(cluster);
 }
 
 RemoteBitrateEstimatorAbsSendTime::RemoteBitrateEstimatorAbsSendTime(
@@ -100,118 +100,152 @@ RemoteBitrateEstimatorAbsSendTime::RemoteBitrateEstimatorAbsSendTime(
       detector_(&field_trials_),
       incoming_bitrate_(kBitrateWindowMs, 8000),
       incoming_bitrate_initialized_(false),
+      probes_(kMaxStoredProbes, Probe(0, 0, 0)),
+      first_probe_(0),
+      num_probes_(0),
       total_probes_received_(0),
       first_packet_time_ms_(-1),
       last_update_ms_(-1),
       uma_recorded_(false),
+      pending_changes_(false),
       remote_rate_(&field_trials_) {
   RTC_DCHECK(clock_);
   RTC_DCHECK(observer_);
   RTC_LOG(LS_INFO) << "RemoteBitrateEstimatorAbsSendTime: Instantiating.";
+  valid_estimate_ = remote_rate_.ValidEstimate();
+  feedback_interval_ms_ = remote_rate_.GetFeedbackInterval().ms();
 }
 
-void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
-    std::list<Cluster>* clusters) const {
-  Cluster current;
-  int64_t prev_send_time = -1;
-  int64_t prev_recv_time = -1;
-  for (std::list<Probe>::const_iterator it = probes_.begin();
-       it != probes_.end(); ++it) {
-    if (prev_send_time >= 0) {
-      int send_delta_ms = it->send_time_ms - prev_send_time;
-      int recv_delta_ms = it->recv_time_ms - prev_recv_time;
-      if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
-        ++current.num_above_min_delta;
-      }
-      if (!IsWithinClusterBounds(send_delta_ms, current)) {
-        if (current.count >= kMinClusterSize && current.send_mean_ms > 0.0f &&
-            current.recv_mean_ms > 0.0f) {
-          AddCluster(clusters, &current);
-        }
-        current = Cluster();
-      }
-      current.send_mean_ms += send_delta_ms;
-      current.recv_mean_ms += recv_delta_ms;
-      current.mean_size += it->payload_size;
-      ++current.count;
-    }
-    prev_send_time = it->send_time_ms;
-    prev_recv_time = it->recv_time_ms;
+const Probe& RemoteBitrateEstimatorAbsSendTime::ProbeAt(size_t index) const {
+  RTC_DCHECK_LT(index, num_probes_);
+  return probes_[(first_probe_ + index) % probes_.size()];
+}
+
+void RemoteBitrateEstimatorAbsSendTime::AddProbe(const Probe& probe) {
+  if (num_probes_ > 0)
+    UpdateClusters(ProbeAt(num_probes_ - 1), probe);
+  if (num_probes_ == probes_.size()) {
+    first_probe_ = (first_probe_ + 1) % probes_.size();
+    --num_probes_;
   }
-  if (current.count >= kMinClusterSize && current.send_mean_ms > 0.0f &&
-      current.recv_mean_ms > 0.0f) {
-    AddCluster(clusters, &current);
+  probes_[(first_probe_ + num_probes_) % probes_.size()] = probe;
+  ++num_probes_;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::RemoveOldestProbe() {
+  RTC_DCHECK_GT(num_probes_, 0);
+  first_probe_ = (first_probe_ + 1) % probes_.size();
+  --num_probes_;
+  clusters_.clear();
+  open_cluster_ = Cluster();
+  for (size_t i = 1; i < num_probes_; ++i)
+    UpdateClusters(ProbeAt(i - 1), ProbeAt(i));
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ClearProbes() {
+  first_probe_ = 0;
+  num_probes_ = 0;
+  clusters_.clear();
+  open_cluster_ = Cluster();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::UpdateClusters(const Probe& previous,
+                                                       const Probe& probe) {
+  int send_delta_ms = probe.send_time_ms - previous.send_time_ms;
+  int recv_delta_ms = probe.recv_time_ms - previous.recv_time_ms;
+  if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
+    ++open_cluster_.num_above_min_delta;
   }
+  if (!IsWithinClusterBounds(send_delta_ms, open_cluster_)) {
+    if (IsClusterComplete(open_cluster_))
+      AddCluster(&clusters_, open_cluster_);
+    open_cluster_ = Cluster();
+  }
+  open_cluster_.send_mean_ms += send_delta_ms;
+  open_cluster_.recv_mean_ms += recv_delta_ms;
+  open_cluster_.mean_size += probe.payload_size;
+  ++open_cluster_.count;
 }
 
-std::list<Cluster>::const_iterator
-RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
-    const std::list<Cluster>& clusters) const {
+const Cluster* RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
+    const std::vector<Cluster>& clusters) const {
   int highest_probe_bitrate_bps = 0;
-  std::list<Cluster>::const_iterator best_it = clusters.end();
-  for (std::list<Cluster>::const_iterator it = clusters.begin();
-       it != clusters.end(); ++it) {
-    if (it->send_mean_ms == 0 || it->recv_mean_ms == 0)
+  const Cluster* best = nullptr;
+  for (const Cluster& cluster : clusters) {
+    if (cluster.send_mean_ms == 0 || cluster.recv_mean_ms == 0)
       continue;
-    if (it->num_above_min_delta > it->count / 2 &&
-        (it->recv_mean_ms - it->send_mean_ms <= 2.0f &&
-         it->send_mean_ms - it->recv_mean_ms <= 5.0f)) {
+    if (cluster.num_above_min_delta > cluster.count / 2 &&
+        (cluster.recv_mean_ms - cluster.send_mean_ms <= 2.0f &&
+         cluster.send_mean_ms - cluster.recv_mean_ms <= 5.0f)) {
       int probe_bitrate_bps =
-          std::min(it->GetSendBitrateBps(), it->GetRecvBitrateBps());
+          std::min(cluster.GetSendBitrateBps(), cluster.GetRecvBitrateBps());
       if (probe_bitrate_bps > highest_probe_bitrate_bps) {
         highest_probe_bitrate_bps = probe_bitrate_bps;
-        best_it = it;
+        best = &cluster;
       }
     } else {
-      int send_bitrate_bps = it->mean_size * 8 * 1000 / it->send_mean_ms;
-      int recv_bitrate_bps = it->mean_size * 8 * 1000 / it->recv_mean_ms;
+      int send_bitrate_bps =
+          cluster.mean_size * 8 * 1000 / cluster.send_mean_ms;
+      int recv_bitrate_bps =
+          cluster.mean_size * 8 * 1000 / cluster.recv_mean_ms;
       RTC_LOG(LS_INFO) << "Probe failed, sent at " << send_bitrate_bps
                        << " bps, received at " << recv_bitrate_bps
-                       << " bps. Mean send delta: " << it->send_mean_ms
-                       << " ms, mean recv delta: " << it->recv_mean_ms
-                       << " ms, num probes: " << it->count;
+                       << " bps. Mean send delta: " << cluster.send_mean_ms
+                       << " ms, mean recv delta: " << cluster.recv_mean_ms
+                       << " ms, num probes: " << cluster.count;
       break;
     }
   }
-  return best_it;
+  return best;
 }
 
 RemoteBitrateEstimatorAbsSendTime::ProbeResult
 RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
-  std::list<Cluster> clusters;
-  ComputeClusters(&clusters);
-  if (clusters.empty()) {
+  // The open cluster is evaluated too if it is large enough, but it stays open
+  // for the next probe.
+  const bool open_cluster_complete = IsClusterComplete(open_cluster_);
+  if (open_cluster_complete)
+    AddCluster(&clusters_, open_cluster_);
+  if (clusters_.empty()) {
     // If we reach the max number of probe packets and still have no clusters,
     // we will remove the oldest one.
-    if (probes_.size() >= kMaxProbePackets)
-      probes_.pop_front();
+    if (num_probes_ >= kMaxProbePackets)
+      RemoveOldestProbe();
     return ProbeResult::kNoUpdate;
   }
 
-  std::list<Cluster>::const_iterator best_it = FindBestProbe(clusters);
-  if (best_it != clusters.end()) {
+  ProbeResult result = ProbeResult::kNoUpdate;
+  const Cluster* best = FindBestProbe(clusters_);
+  if (best) {
     int probe_bitrate_bps =
-        std::min(best_it->GetSendBitrateBps(), best_it->GetRecvBitrateBps());
+        std::min(best->GetSendBitrateBps(), best->GetRecvBitrateBps());
+    rtc::CritScope lock(&crit_);
     // Make sure that a probe sent on a lower bitrate than our estimate can't
     // reduce the estimate.
     if (IsBitrateImproving(probe_bitrate_bps)) {
       RTC_LOG(LS_INFO) << "Probe successful, sent at "
-                       << best_it->GetSendBitrateBps() << " bps, received at "
-                       << best_it->GetRecvBitrateBps()
-                       << " bps. Mean send delta: " << best_it->send_mean_ms
-                       << " ms, mean recv delta: " << best_it->recv_mean_ms
-                       << " ms, num probes: " << best_it->count;
+                       << best->GetSendBitrateBps() << " bps, received at "
+                       << best->GetRecvBitrateBps()
+                       << " bps. Mean send delta: " << best->send_mean_ms
+                       << " ms, mean recv delta: " << best->recv_mean_ms
+                       << " ms, num probes: " << best->count;
       remote_rate_.SetEstimate(DataRate::BitsPerSec(probe_bitrate_bps),
                                Timestamp::Millis(now_ms));
-      return ProbeResult::kBitrateUpdated;
+      ApplyPendingChanges();
+      result = ProbeResult::kBitrateUpdated;
     }
   }
 
+  const size_t num_clusters = clusters_.size();
+  if (open_cluster_complete)
+    clusters_.pop_back();
   // Not probing and received non-probe packet, or finished with current set
   // of probes.
-  if (clusters.size() >= kExpectedNumberOfProbes)
-    probes_.clear();
-  return ProbeResult::kNoUpdate;
+  if (result == ProbeResult::kNoUpdate &&
+      num_clusters >= kExpectedNumberOfProbes) {
+    ClearProbes();
+  }
+  return result;
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::IsBitrateImproving(
@@ -275,87 +309,101 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
   if (first_packet_time_ms_ == -1)
     first_packet_time_ms_ = now_ms;
 
-  uint32_t ts_delta = 0;
-  int64_t t_delta = 0;
-  int size_delta = 0;
-  bool update_estimate = false;
-  uint32_t target_bitrate_bps = 0;
-  std::vector<uint32_t> ssrcs;
-  {
+  if (pending_changes_.load(std::memory_order_acquire)) {
+    rtc::CritScope lock(&crit_);
+    ApplyPendingChanges();
+  }
+
+  TimeoutStreams(now_ms);
+  RTC_DCHECK(inter_arrival_.get());
+  RTC_DCHECK(estimator_.get());
+  auto stream = std::find_if(
+      streams_.begin(), streams_.end(),
+      [ssrc](const Stream& stream) { return stream.ssrc == ssrc; });
+  if (stream != streams_.end()) {
+    stream->last_packet_time_ms = now_ms;
+  } else {
+    streams_.push_back({ssrc, now_ms});
     rtc::CritScope lock(&crit_);
+    PublishSsrcs();
+  }
 
-    TimeoutStreams(now_ms);
-    RTC_DCHECK(inter_arrival_.get());
-    RTC_DCHECK(estimator_.get());
-    ssrcs_[ssrc] = now_ms;
-
-    // For now only try to detect probes while we don't have a valid estimate.
-    // We currently assume that only packets larger than 200 bytes are paced by
-    // the sender.
-    const size_t kMinProbePacketSize = 200;
-    if (payload_size > kMinProbePacketSize &&
-        (!remote_rate_.ValidEstimate() ||
-         now_ms - first_packet_time_ms_ < kInitialProbingIntervalMs)) {
-      // TODO(holmer): Use a map instead to get correct order?
-      if (total_probes_received_ < kMaxProbePackets) {
-        int send_delta_ms = -1;
-        int recv_delta_ms = -1;
-        if (!probes_.empty()) {
-          send_delta_ms = send_time_ms - probes_.back().send_time_ms;
-          recv_delta_ms = arrival_time_ms - probes_.back().recv_time_ms;
-        }
-        RTC_LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
-                         << " ms, recv time=" << arrival_time_ms
-                         << " ms, send delta=" << send_delta_ms
-                         << " ms, recv delta=" << recv_delta_ms << " ms.";
+  bool update_estimate = false;
+  // For now only try to detect probes while we don't have a valid estimate.
+  // We currently assume that only packets larger than 200 bytes are paced by
+  // the sender.
+  const size_t kMinProbePacketSize = 200;
+  if (payload_size > kMinProbePacketSize &&
+      (!valid_estimate_ ||
+       now_ms - first_packet_time_ms_ < kInitialProbingIntervalMs)) {
+    // TODO(holmer): Use a map instead to get correct order?
+    if (total_probes_received_ < kMaxProbePackets) {
+      int send_delta_ms = -1;
+      int recv_delta_ms = -1;
+      if (num_probes_ > 0) {
+        const Probe& last_probe = ProbeAt(num_probes_ - 1);
+        send_delta_ms = send_time_ms - last_probe.send_time_ms;
+        recv_delta_ms = arrival_time_ms - last_probe.recv_time_ms;
       }
-      probes_.push_back(Probe(send_time_ms, arrival_time_ms, payload_size));
-      ++total_probes_received_;
-      // Make sure that a probe which updated the bitrate immediately has an
-      // effect by calling the OnReceiveBitrateChanged callback.
-      if (ProcessClusters(now_ms) == ProbeResult::kBitrateUpdated)
-        update_estimate = true;
-    }
-    if (inter_arrival_->ComputeDeltas(timestamp, arrival_time_ms, now_ms,
-                                      payload_size, &ts_delta, &t_delta,
-                                      &size_delta)) {
-      double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
-      estimator_->Update(t_delta, ts_delta_ms, size_delta, detector_.State(),
-                         arrival_time_ms);
-      detector_.Detect(estimator_->offset(), ts_delta_ms,
-                       estimator_->num_of_deltas(), arrival_time_ms);
+      RTC_LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
+                       << " ms, recv time=" << arrival_time_ms
+                       << " ms, send delta=" << send_delta_ms
+                       << " ms, recv delta=" << recv_delta_ms << " ms.";
     }
+    AddProbe(Probe(send_time_ms, arrival_time_ms, payload_size));
+    ++total_probes_received_;
+    // Make sure that a probe which updated the bitrate immediately has an
+    // effect by calling the OnReceiveBitrateChanged callback.
+    if (ProcessClusters(now_ms) == ProbeResult::kBitrateUpdated)
+      update_estimate = true;
+  }
+  uint32_t ts_delta = 0;
+  int64_t t_delta = 0;
+  int size_delta = 0;
+  if (inter_arrival_->ComputeDeltas(timestamp, arrival_time_ms, now_ms,
+                                    payload_size, &ts_delta, &t_delta,
+                                    &size_delta)) {
+    double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
+    estimator_->Update(t_delta, ts_delta_ms, size_delta, detector_.State(),
+                       arrival_time_ms);
+    detector_.Detect(estimator_->offset(), ts_delta_ms,
+                     estimator_->num_of_deltas(), arrival_time_ms);
+  }
 
-    if (!update_estimate) {
-      // Check if it's time for a periodic update or if we should update because
-      // of an over-use.
-      if (last_update_ms_ == -1 ||
-          now_ms - last_update_ms_ > remote_rate_.GetFeedbackInterval().ms()) {
-        update_estimate = true;
-      } else if (detector_.State() == BandwidthUsage::kBwOverusing) {
-        absl::optional<uint32_t> incoming_rate =
-            incoming_bitrate_.Rate(arrival_time_ms);
-        if (incoming_rate && remote_rate_.TimeToReduceFurther(
-                                 Timestamp::Millis(now_ms),
-                                 DataRate::BitsPerSec(*incoming_rate))) {
-          update_estimate = true;
-        }
+  if (!update_estimate) {
+    // Check if it's time for a periodic update or if we should update because
+    // of an over-use.
+    if (last_update_ms_ == -1 ||
+        now_ms - last_update_ms_ > feedback_interval_ms_) {
+      update_estimate = true;
+    } else if (detector_.State() == BandwidthUsage::kBwOverusing) {
+      absl::optional<uint32_t> incoming_rate =
+          incoming_bitrate_.Rate(arrival_time_ms);
+      if (incoming_rate) {
+        rtc::CritScope lock(&crit_);
+        update_estimate = remote_rate_.TimeToReduceFurther(
+            Timestamp::Millis(now_ms), DataRate::BitsPerSec(*incoming_rate));
       }
     }
+  }
+  if (!update_estimate)
+    return;
 
-    if (update_estimate) {
-      // The first overuse should immediately trigger a new estimate.
-      // We also have to update the estimate immediately if we are overusing
-      // and the target bitrate is too high compared to what we are receiving.
-      const RateControlInput input(
-          detector_.State(),
-          OptionalRateFromOptionalBps(incoming_bitrate_.Rate(arrival_time_ms)));
-      target_bitrate_bps =
-          remote_rate_.Update(&input, Timestamp::Millis(now_ms))
-              .bps<uint32_t>();
-      update_estimate = remote_rate_.ValidEstimate();
-      ssrcs = Keys(ssrcs_);
-    }
+  uint32_t target_bitrate_bps = 0;
+  std::vector<uint32_t> ssrcs;
+  {
+    rtc::CritScope lock(&crit_);
+    // The first overuse should immediately trigger a new estimate.
+    // We also have to update the estimate immediately if we are overusing
+    // and the target bitrate is too high compared to what we are receiving.
+    const RateControlInput input(
+        detector_.State(),
+        OptionalRateFromOptionalBps(incoming_bitrate_.Rate(arrival_time_ms)));
+    target_bitrate_bps =
+        remote_rate_.Update(&input, Timestamp::Millis(now_ms)).bps<uint32_t>();
+    ApplyPendingChanges();
+    update_estimate = valid_estimate_;
+    ssrcs = active_ssrcs_;
   }
   if (update_estimate) {
     last_update_ms_ = now_ms;
@@ -370,15 +418,41 @@ int64_t RemoteBitrateEstimatorAbsSendTime::TimeUntilNextProcess() {
   return kDisabledModuleTime;
 }
 
-void RemoteBitrateEstimatorAbsSendTime::TimeoutStreams(int64_t now_ms) {
-  for (Ssrcs::iterator it = ssrcs_.begin(); it != ssrcs_.end();) {
-    if ((now_ms - it->second) > kStreamTimeOutMs) {
-      ssrcs_.erase(it++);
-    } else {
-      ++it;
+void RemoteBitrateEstimatorAbsSendTime::ApplyPendingChanges() {
+  pending_changes_.store(false, std::memory_order_relaxed);
+  if (!removed_ssrcs_.empty()) {
+    for (uint32_t ssrc : removed_ssrcs_) {
+      streams_.erase(
+          std::remove_if(
+              streams_.begin(), streams_.end(),
+              [ssrc](const Stream& stream) { return stream.ssrc == ssrc; }),
+          streams_.end());
     }
+    removed_ssrcs_.clear();
+    PublishSsrcs();
+  }
+  valid_estimate_ = remote_rate_.ValidEstimate();
+  feedback_interval_ms_ = remote_rate_.GetFeedbackInterval().ms();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::PublishSsrcs() {
+  active_ssrcs_.clear();
+  for (const Stream& stream : streams_)
+    active_ssrcs_.push_back(stream.ssrc);
+  std::sort(active_ssrcs_.begin(), active_ssrcs_.end());
+}
+
+void RemoteBitrateEstimatorAbsSendTime::TimeoutStreams(int64_t now_ms) {
+  auto timed_out = std::remove_if(
+      streams_.begin(), streams_.end(), [now_ms](const Stream& stream) {
+        return now_ms - stream.last_packet_time_ms > kStreamTimeOutMs;
+      });
+  if (timed_out != streams_.end()) {
+    streams_.erase(timed_out, streams_.end());
+    rtc::CritScope lock(&crit_);
+    PublishSsrcs();
   }
-  if (ssrcs_.empty()) {
+  if (streams_.empty()) {
     // We can't update the estimate if we don't have any active streams.
     inter_arrival_.reset(
         new InterArrival((kTimestampGroupLengthMs << kInterArrivalShift) / 1000,
@@ -397,7 +471,12 @@ void RemoteBitrateEstimatorAbsSendTime::OnRttUpdate(int64_t avg_rtt_ms,
 
 void RemoteBitrateEstimatorAbsSendTime::RemoveStream(uint32_t ssrc) {
   rtc::CritScope lock(&crit_);
-  ssrcs_.erase(ssrc);
+  active_ssrcs_.erase(
+      std::remove(active_ssrcs_.begin(), active_ssrcs_.end(), ssrc),
+      active_ssrcs_.end());
+  // The stream itself is forgotten by the next IncomingPacket().
+  removed_ssrcs_.push_back(ssrc);
+  pending_changes_.store(true, std::memory_order_release);
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
@@ -413,8 +492,8 @@ bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
   if (!remote_rate_.ValidEstimate()) {
     return false;
   }
-  *ssrcs = Keys(ssrcs_);
-  if (ssrcs_.empty()) {
+  *ssrcs = active_ssrcs_;
+  if (active_ssrcs_.empty()) {
     *bitrate_bps = 0;
   } else {
     *bitrate_bps = remote_rate_.LatestEstimate().bps<uint32_t>();
@@ -427,5 +506,7 @@ void RemoteBitrateEstimatorAbsSendTime::SetMinBitrate(int min_bitrate_bps) {
   // be called from the network thread in the future.
   rtc::CritScope lock(&crit_);
   remote_rate_.SetMinBitrate(DataRate::BitsPerSec(min_bitrate_bps));
+  // May change the feedback interval.
+  pending_changes_.store(true, std::memory_order_release);
 }
 }  // namespace webrtc
@@ -14,8 +14,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <list>
-#include <map>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -72,6 +71,9 @@ struct Cluster {
   int num_above_min_delta;
 };
 
+// IncomingPacket() must not be called concurrently with itself. It only takes
+// the lock when the set of streams changes, for probes and over-use that may
+// change the estimate, and when the estimate is updated.
 class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
  public:
   RemoteBitrateEstimatorAbsSendTime(RemoteBitrateObserver* observer,
@@ -94,32 +96,49 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   void SetMinBitrate(int min_bitrate_bps) override;
 
  private:
-  typedef std::map<uint32_t, int64_t> Ssrcs;
+  struct Stream {
+    uint32_t ssrc;
+    int64_t last_packet_time_ms;
+  };
   enum class ProbeResult { kBitrateUpdated, kNoUpdate };
 
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
 
-  static void AddCluster(std::list<Cluster>* clusters, Cluster* cluster);
+  static bool IsClusterComplete(const Cluster& cluster);
+
+  static void AddCluster(std::vector<Cluster>* clusters, Cluster cluster);
 
   void IncomingPacketInfo(int64_t arrival_time_ms,
                           uint32_t send_time_24bits,
                           size_t payload_size,
                           uint32_t ssrc);
 
-  void ComputeClusters(std::list<Cluster>* clusters) const;
+  const Probe& ProbeAt(size_t index) const;
+  // Stores |probe| and adds it to the clusters. When the ring is full, the
+  // oldest probe is forgotten, but the clusters it belongs to are kept.
+  void AddProbe(const Probe& probe);
+  // Removes the oldest probe and computes the clusters of the remaining ones.
+  void RemoveOldestProbe();
+  void ClearProbes();
+  // Extends the clusters with |probe|, which was received after |previous|.
+  void UpdateClusters(const Probe& previous, const Probe& probe);
 
-  std::list<Cluster>::const_iterator FindBestProbe(
-      const std::list<Cluster>& clusters) const;
+  const Cluster* FindBestProbe(const std::vector<Cluster>& clusters) const;
 
   // Returns true if a probe which changed the estimate was detected.
-  ProbeResult ProcessClusters(int64_t now_ms)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+  ProbeResult ProcessClusters(int64_t now_ms);
 
   bool IsBitrateImproving(int probe_bitrate_bps) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
 
-  void TimeoutStreams(int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+  // Brings the state of the network thread up to date with RemoveStream()
+  // and SetMinBitrate() calls, and with |remote_rate_|.
+  void ApplyPendingChanges() RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+  // Updates |active_ssrcs_| after |streams_| changed.
+  void PublishSsrcs() RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+
+  void TimeoutStreams(int64_t now_ms);
 
   rtc::RaceChecker network_race_;
   Clock* const clock_;
@@ -132,14 +151,34 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   bool incoming_bitrate_initialized_;
   std::vector<int> recent_propagation_delta_ms_;
   std::vector<int64_t> recent_update_time_ms_;
-  std::list<Probe> probes_;
+  // Ring of the most recent probes, starting at |first_probe_|.
+  std::vector<Probe> probes_;
+  size_t first_probe_;
+  size_t num_probes_;
+  // The closed clusters of the probes, and the last cluster, which may still
+  // grow with the next probe. The open cluster holds sums rather than means.
+  std::vector<Cluster> clusters_;
+  Cluster open_cluster_;
   size_t total_probes_received_;
   int64_t first_packet_time_ms_;
   int64_t last_update_ms_;
   bool uma_recorded_;
 
+  // Streams seen by IncomingPacket(), which mostly runs without taking
+  // |crit_|. Changes to the set of streams are published to |active_ssrcs_|.
+  std::vector<Stream> streams_;
+  // Copies of |remote_rate_| state that IncomingPacket() needs for every
+  // packet.
+  bool valid_estimate_;
+  int64_t feedback_interval_ms_;
+  // Set when RemoveStream() or SetMinBitrate() left changes for
+  // ApplyPendingChanges().
+  std::atomic<bool> pending_changes_;
+
   rtc::CriticalSection crit_;
-  Ssrcs ssrcs_ RTC_GUARDED_BY(&crit_);
+  // Sorted SSRCs of |streams_|, for LatestEstimate().
+  std::vector<uint32_t> active_ssrcs_ RTC_GUARDED_BY(&crit_);
+  std::vector<uint32_t> removed_ssrcs_ RTC_GUARDED_BY(&crit_);
   AimdRateControl remote_rate_ RTC_GUARDED_BY(&crit_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RemoteBitrateEstimatorAbsSendTime);
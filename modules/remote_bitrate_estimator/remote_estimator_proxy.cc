@@ -26,6 +26,10 @@ namespace webrtc {
 // Impossible to request feedback older than what can be represented by 15 bits.
 const int RemoteEstimatorProxy::kMaxNumberOfPackets = (1 << 15);
 
+// Enough for the packets received between two feedbacks at a few thousand
+// packets per second. IncomingPacket() takes the lock when it is full.
+const size_t RemoteEstimatorProxy::kMaxPendingArrivals = 4096;
+
 // The maximum allowed value for a timestamp in milliseconds. This is lower
 // than the numerical limit since we often convert to microseconds.
 static constexpr int64_t kMaxTimeMs =
@@ -40,6 +44,7 @@ RemoteEstimatorProxy::RemoteEstimatorProxy(
       feedback_sender_(feedback_sender),
       send_config_(key_value_config),
       last_process_time_ms_(-1),
+      pending_arrivals_(kMaxPendingArrivals),
       network_state_estimator_(network_state_estimator),
       media_ssrc_(0),
       feedback_packet_count_(0),
@@ -61,48 +66,30 @@ void RemoteEstimatorProxy::IncomingPacket(int64_t arrival_time_ms,
     RTC_LOG(LS_WARNING) << "Arrival time out of bounds: " << arrival_time_ms;
     return;
   }
+  const bool report_to_estimator =
+      network_state_estimator_ && header.extension.hasAbsoluteSendTime;
+  if (header.extension.hasTransportSequenceNumber &&
+      !header.extension.feedback_request && !report_to_estimator &&
+      pending_arrivals_.Push(PendingArrival{
+          arrival_time_ms, header.ssrc,
+          header.extension.transportSequenceNumber})) {
+    return;
+  }
+
   rtc::CritScope cs(&lock_);
+  // Keep the arrival order of the queued packets and this one.
+  ProcessPendingArrivals();
   media_ssrc_ = header.ssrc;
   int64_t seq = 0;
 
   if (header.extension.hasTransportSequenceNumber) {
-    seq = unwrapper_.Unwrap(header.extension.transportSequenceNumber);
-
-    if (send_periodic_feedback_) {
-      if (periodic_window_start_seq_ &&
-          packet_arrival_times_.lower_bound(*periodic_window_start_seq_) ==
-              packet_arrival_times_.end()) {
-        // Start new feedback packet, cull old packets.
-        for (auto it = packet_arrival_times_.begin();
-             it != packet_arrival_times_.end() && it->first < seq &&
-             arrival_time_ms - it->second >= send_config_.back_window->ms();) {
-          it = packet_arrival_times_.erase(it);
-        }
-      }
-      if (!periodic_window_start_seq_ || seq < *periodic_window_start_seq_) {
-        periodic_window_start_seq_ = seq;
-      }
-    }
-
+    absl::optional<int64_t> unwrapped_seq =
+        OnPacketArrival(header.extension.transportSequenceNumber,
+                        arrival_time_ms, header.ssrc);
     // We are only interested in the first time a packet is received.
-    if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
+    if (!unwrapped_seq)
       return;
-
-    packet_arrival_times_[seq] = arrival_time_ms;
-
-    // Limit the range of sequence numbers to send feedback for.
-    auto first_arrival_time_to_keep = packet_arrival_times_.lower_bound(
-        packet_arrival_times_.rbegin()->first - kMaxNumberOfPackets);
-    if (first_arrival_time_to_keep != packet_arrival_times_.begin()) {
-      packet_arrival_times_.erase(packet_arrival_times_.begin(),
-                                  first_arrival_time_to_keep);
-      if (send_periodic_feedback_) {
-        // |packet_arrival_times_| cannot be empty since we just added one
-        // element and the last element is not deleted.
-        RTC_DCHECK(!packet_arrival_times_.empty());
-        periodic_window_start_seq_ = packet_arrival_times_.begin()->first;
-      }
-    }
+    seq = *unwrapped_seq;
 
     if (header.extension.feedback_request) {
       // Send feedback packet immediately.
@@ -128,6 +115,56 @@ void RemoteEstimatorProxy::IncomingPacket(int64_t arrival_time_ms,
   }
 }
 
+void RemoteEstimatorProxy::ProcessPendingArrivals() {
+  PendingArrival arrival;
+  while (pending_arrivals_.Pop(&arrival)) {
+    OnPacketArrival(arrival.sequence_number, arrival.arrival_time_ms,
+                    arrival.ssrc);
+  }
+}
+
+absl::optional<int64_t> RemoteEstimatorProxy::OnPacketArrival(
+    uint16_t sequence_number,
+    int64_t arrival_time_ms,
+    uint32_t ssrc) {
+  media_ssrc_ = ssrc;
+  int64_t seq = unwrapper_.Unwrap(sequence_number);
+
+  if (send_periodic_feedback_) {
+    if (periodic_window_start_seq_ &&
+        packet_arrival_times_.LowerBound(*periodic_window_start_seq_) ==
+            packet_arrival_times_.end_sequence_number()) {
+      // Start new feedback packet, cull old packets.
+      packet_arrival_times_.RemoveOldPackets(
+          seq, arrival_time_ms - send_config_.back_window->ms());
+    }
+    if (!periodic_window_start_seq_ || seq < *periodic_window_start_seq_) {
+      periodic_window_start_seq_ = seq;
+    }
+  }
+
+  if (packet_arrival_times_.has_received(seq))
+    return absl::nullopt;
+
+  packet_arrival_times_.AddPacket(seq, arrival_time_ms);
+
+  // Limit the range of sequence numbers to send feedback for.
+  const int64_t first_sequence_number_to_keep =
+      packet_arrival_times_.end_sequence_number() - 1 - kMaxNumberOfPackets;
+  if (first_sequence_number_to_keep >
+      packet_arrival_times_.begin_sequence_number()) {
+    packet_arrival_times_.EraseTo(first_sequence_number_to_keep);
+    if (send_periodic_feedback_) {
+      // |packet_arrival_times_| cannot be empty since we just added one
+      // element and the last element is not deleted.
+      RTC_DCHECK(!packet_arrival_times_.empty());
+      periodic_window_start_seq_ =
+          packet_arrival_times_.begin_sequence_number();
+    }
+  }
+  return seq;
+}
+
 bool RemoteEstimatorProxy::LatestEstimate(std::vector<unsigned int>* ssrcs,
                                           unsigned int* bitrate_bps) const {
   return false;
@@ -153,6 +190,7 @@ void RemoteEstimatorProxy::Process() {
   }
   last_process_time_ms_ = clock_->TimeInMilliseconds();
 
+  ProcessPendingArrivals();
   SendPeriodicFeedbacks();
 }
 
@@ -179,6 +217,8 @@ void RemoteEstimatorProxy::OnBitrateChanged(int bitrate_bps) {
 void RemoteEstimatorProxy::SetSendPeriodicFeedback(
     bool send_periodic_feedback) {
   rtc::CritScope cs(&lock_);
+  // Record the queued packets with the mode they arrived in.
+  ProcessPendingArrivals();
   send_periodic_feedback_ = send_periodic_feedback;
 }
 
@@ -199,15 +239,16 @@ void RemoteEstimatorProxy::SendPeriodicFeedbacks() {
     }
   }
 
-  for (auto begin_iterator =
-           packet_arrival_times_.lower_bound(*periodic_window_start_seq_);
-       begin_iterator != packet_arrival_times_.cend();
-       begin_iterator =
-           packet_arrival_times_.lower_bound(*periodic_window_start_seq_)) {
+  for (int64_t begin_sequence_number =
+           packet_arrival_times_.LowerBound(*periodic_window_start_seq_);
+       begin_sequence_number < packet_arrival_times_.end_sequence_number();
+       begin_sequence_number =
+           packet_arrival_times_.LowerBound(*periodic_window_start_seq_)) {
     auto feedback_packet = std::make_unique<rtcp::TransportFeedback>();
     periodic_window_start_seq_ = BuildFeedbackPacket(
         feedback_packet_count_++, media_ssrc_, *periodic_window_start_seq_,
-        begin_iterator, packet_arrival_times_.cend(), feedback_packet.get());
+        begin_sequence_number, packet_arrival_times_.end_sequence_number(),
+        feedback_packet.get());
 
     RTC_DCHECK(feedback_sender_ != nullptr);
 
@@ -236,16 +277,17 @@ void RemoteEstimatorProxy::SendFeedbackOnRequest(
 
   int64_t first_sequence_number =
       sequence_number - feedback_request.sequence_count + 1;
-  auto begin_iterator =
-      packet_arrival_times_.lower_bound(first_sequence_number);
-  auto end_iterator = packet_arrival_times_.upper_bound(sequence_number);
+  int64_t begin_sequence_number =
+      packet_arrival_times_.LowerBound(first_sequence_number);
+  int64_t end_sequence_number = std::min(
+      sequence_number + 1, packet_arrival_times_.end_sequence_number());
 
   BuildFeedbackPacket(feedback_packet_count_++, media_ssrc_,
-                      first_sequence_number, begin_iterator, end_iterator,
-                      feedback_packet.get());
+                      first_sequence_number, begin_sequence_number,
+                      end_sequence_number, feedback_packet.get());
 
   // Clear up to the first packet that is included in this feedback packet.
-  packet_arrival_times_.erase(packet_arrival_times_.begin(), begin_iterator);
+  packet_arrival_times_.EraseTo(begin_sequence_number);
 
   RTC_DCHECK(feedback_sender_ != nullptr);
   std::vector<std::unique_ptr<rtcp::RtcpPacket>> packets;
@@ -257,10 +299,11 @@ int64_t RemoteEstimatorProxy::BuildFeedbackPacket(
     uint8_t feedback_packet_count,
     uint32_t media_ssrc,
     int64_t base_sequence_number,
-    std::map<int64_t, int64_t>::const_iterator begin_iterator,
-    std::map<int64_t, int64_t>::const_iterator end_iterator,
-    rtcp::TransportFeedback* feedback_packet) {
-  RTC_DCHECK(begin_iterator != end_iterator);
+    int64_t begin_sequence_number,
+    int64_t end_sequence_number,
+    rtcp::TransportFeedback* feedback_packet) const {
+  RTC_DCHECK_LT(begin_sequence_number, end_sequence_number);
+  RTC_DCHECK(packet_arrival_times_.has_received(begin_sequence_number));
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
@@ -268,22 +311,31 @@ int64_t RemoteEstimatorProxy::BuildFeedbackPacket(
   // Base sequence number is the expected first sequence number. This is known,
   // but we might not have actually received it, so the base time shall be the
   // time of the first received packet in the feedback.
-  feedback_packet->SetBase(static_cast<uint16_t>(base_sequence_number & 0xFFFF),
-                           begin_iterator->second * 1000);
+  feedback_packet->SetBase(
+      static_cast<uint16_t>(base_sequence_number & 0xFFFF),
+      packet_arrival_times_.get(begin_sequence_number) * 1000);
   feedback_packet->SetFeedbackSequenceNumber(feedback_packet_count);
+  // Allocate room for all packets up front, rather than for each one.
+  feedback_packet->Reserve(static_cast<size_t>(std::min<int64_t>(
+      end_sequence_number - base_sequence_number,
+      rtcp::TransportFeedback::kMaxReportedPackets)));
   int64_t next_sequence_number = base_sequence_number;
-  for (auto it = begin_iterator; it != end_iterator; ++it) {
+  for (int64_t seq = begin_sequence_number; seq < end_sequence_number; ++seq) {
+    if (!packet_arrival_times_.has_received(seq)) {
+      continue;
+    }
     if (!feedback_packet->AddReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+            static_cast<uint16_t>(seq & 0xFFFF),
+            packet_arrival_times_.get(seq) * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK(begin_iterator != it);
+      RTC_CHECK_NE(begin_sequence_number, seq);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
       break;
     }
-    next_sequence_number = it->first + 1;
+    next_sequence_number = seq + 1;
   }
   return next_sequence_number;
 }
@@ -11,15 +11,17 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "api/transport/network_control.h"
 #include "api/transport/webrtc_key_value_config.h"
 #include "modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "modules/remote_bitrate_estimator/packet_arrival_map.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/numerics/sequence_number_util.h"
+#include "rtc_base/spsc_queue.h"
 
 namespace webrtc {
 
@@ -32,7 +34,10 @@ class TransportFeedback;
 // Class used when send-side BWE is enabled: This proxy is instantiated on the
 // receive side. It buffers a number of receive timestamps and then sends
 // transport feedback messages back too the send side.
-
+//
+// IncomingPacket() must not be called concurrently with itself. Packets that
+// neither request feedback nor are reported to the network state estimator
+// are queued without taking the lock, and recorded when feedback is built.
 class RemoteEstimatorProxy : public RemoteBitrateEstimator {
  public:
   RemoteEstimatorProxy(Clock* clock,
@@ -71,27 +76,47 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
     }
   };
 
-  static const int kMaxNumberOfPackets;
+  // A packet queued by IncomingPacket() without taking the lock.
+  struct PendingArrival {
+    int64_t arrival_time_ms;
+    uint32_t ssrc;
+    uint16_t sequence_number;
+  };
 
+  static const int kMaxNumberOfPackets;
+  static const size_t kMaxPendingArrivals;
+
+  // Records the packets queued by IncomingPacket().
+  void ProcessPendingArrivals() RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+  // Records the arrival of |sequence_number|, and returns its unwrapped value,
+  // or nullopt if it has already been received.
+  absl::optional<int64_t> OnPacketArrival(uint16_t sequence_number,
+                                          int64_t arrival_time_ms,
+                                          uint32_t ssrc)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
   void SendPeriodicFeedbacks() RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
   void SendFeedbackOnRequest(int64_t sequence_number,
                              const FeedbackRequest& feedback_request)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
-  static int64_t BuildFeedbackPacket(
-      uint8_t feedback_packet_count,
-      uint32_t media_ssrc,
-      int64_t base_sequence_number,
-      std::map<int64_t, int64_t>::const_iterator
-          begin_iterator,  // |begin_iterator| is inclusive.
-      std::map<int64_t, int64_t>::const_iterator
-          end_iterator,  // |end_iterator| is exclusive.
-      rtcp::TransportFeedback* feedback_packet);
+  // Adds the received packets in [|begin_sequence_number|,
+  // |end_sequence_number|) to |feedback_packet|, until it is full. Returns
+  // the first sequence number that was not added.
+  int64_t BuildFeedbackPacket(uint8_t feedback_packet_count,
+                              uint32_t media_ssrc,
+                              int64_t base_sequence_number,
+                              int64_t begin_sequence_number,
+                              int64_t end_sequence_number,
+                              rtcp::TransportFeedback* feedback_packet) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
 
   Clock* const clock_;
   TransportFeedbackSenderInterface* const feedback_sender_;
   const TransportWideFeedbackConfig send_config_;
   int64_t last_process_time_ms_;
 
+  // Written by IncomingPacket(), read with |lock_| held.
+  rtc::SpscQueue<PendingArrival> pending_arrivals_;
+
   rtc::CriticalSection lock_;
   //  |network_state_estimator_| may be null.
   NetworkStateEstimator* const network_state_estimator_
@@ -100,8 +125,7 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_packet_count_ RTC_GUARDED_BY(&lock_);
   SeqNumUnwrapper<uint16_t> unwrapper_ RTC_GUARDED_BY(&lock_);
   absl::optional<int64_t> periodic_window_start_seq_ RTC_GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ RTC_GUARDED_BY(&lock_);
+  PacketArrivalTimeMap packet_arrival_times_ RTC_GUARDED_BY(&lock_);
   int64_t send_interval_ms_ RTC_GUARDED_BY(&lock_);
   bool send_periodic_feedback_ RTC_GUARDED_BY(&lock_);
 
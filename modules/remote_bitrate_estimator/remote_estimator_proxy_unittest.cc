@@ -257,6 +257,30 @@ TEST_F(RemoteEstimatorProxyTest, SendsFragmentedFeedback) {
   Process();
 }
 
+TEST_F(RemoteEstimatorProxyTest, SendsFeedbackForManyPacketsBetweenProcess) {
+  // More packets than can be queued without taking the lock.
+  const int kNumPackets = 10000;
+  for (int i = 0; i < kNumPackets; ++i) {
+    IncomingPacket(kBaseSeq + i, kBaseTimeMs + i);
+  }
+
+  size_t num_received = 0;
+  EXPECT_CALL(router_, SendCombinedRtcpPacket)
+      .WillRepeatedly(Invoke(
+          [&](std::vector<std::unique_ptr<rtcp::RtcpPacket>> feedback_packets) {
+            rtcp::TransportFeedback* feedback_packet =
+                static_cast<rtcp::TransportFeedback*>(
+                    feedback_packets[0].get());
+            EXPECT_EQ(static_cast<uint16_t>(kBaseSeq + num_received),
+                      feedback_packet->GetBaseSequence());
+            num_received += feedback_packet->GetReceivedPackets().size();
+            return true;
+          }));
+
+  Process();
+  EXPECT_EQ(static_cast<size_t>(kNumPackets), num_received);
+}
+
 TEST_F(RemoteEstimatorProxyTest, HandlesReorderingAndWrap) {
   const int64_t kDeltaMs = 1000;
   const uint16_t kLargeSeq = 62762;
@@ -83,6 +83,10 @@ class RtpRtcp : public Module, public RtcpFeedbackSenderInterface {
     NetworkStateEstimateObserver* network_state_estimate_observer = nullptr;
     TransportFeedbackObserver* transport_feedback_callback = nullptr;
     VideoBitrateAllocationObserver* bitrate_allocation_observer = nullptr;
+    // Called when the receiver of our stream requests a bitrate allocation
+    // across its layers with an RTCP XR target bitrate report.
+    VideoBitrateAllocationObserver* requested_bitrate_allocation_observer =
+        nullptr;
     RtcpRttStats* rtt_stats = nullptr;
     RtcpPacketTypeCounterObserver* rtcp_packet_type_counter_observer = nullptr;
     // Called on receipt of RTCP report block from remote side.
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/fec_xor.h"
+
+#include <string.h>
+
+#include "rtc_base/system/arch.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/rtp_rtcp/source/fec_xor_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/rtp_rtcp/source/fec_xor_avx2.h"
+#include "modules/rtp_rtcp/source/fec_xor_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
+namespace webrtc {
+
+namespace {
+
+using FecXorFunction = void (*)(const uint8_t*, size_t, uint8_t*);
+
+FecXorFunction SelectFecXor() {
+#if defined(WEBRTC_HAS_NEON)
+  return &FecXor_NEON;
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    return &FecXor_AVX2;
+  }
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(__SSE2__)
+  return &FecXor_SSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? &FecXor_SSE2 : &FecXor_C;
+#endif
+#else
+  return &FecXor_C;
+#endif
+}
+
+}  // namespace
+
+void FecXor(const uint8_t* src, size_t length, uint8_t* dst) {
+  static const FecXorFunction fec_xor = SelectFecXor();
+  fec_xor(src, length, dst);
+}
+
+void FecXor_C(const uint8_t* src, size_t length, uint8_t* dst) {
+  // XOR a word at a time; memcpy keeps the unaligned accesses well defined.
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t s;
+    uint64_t d;
+    memcpy(&s, src + i, sizeof(s));
+    memcpy(&d, dst + i, sizeof(d));
+    d ^= s;
+    memcpy(dst + i, &d, sizeof(d));
+  }
+  for (; i < length; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+}  // namespace webrtc
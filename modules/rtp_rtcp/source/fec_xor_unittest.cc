@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/fec_xor.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "test/gtest.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/rtp_rtcp/source/fec_xor_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/rtp_rtcp/source/fec_xor_avx2.h"
+#include "modules/rtp_rtcp/source/fec_xor_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
+namespace webrtc {
+
+namespace {
+
+using FecXorFunction = void (*)(const uint8_t*, size_t, uint8_t*);
+
+constexpr size_t kMaxLength = 300;
+constexpr size_t kMaxOffset = 31;
+
+// Checks |fec_xor| against a byte by byte XOR, for every length up to
+// |kMaxLength| and for buffers starting at any alignment. Also checks that no
+// byte past the end of |dst| is touched.
+void VerifyFecXor(FecXorFunction fec_xor) {
+  Random random(0x5eed);
+  std::vector<uint8_t> src(kMaxLength + kMaxOffset);
+  std::vector<uint8_t> dst(kMaxLength + kMaxOffset + 1);
+  for (uint8_t& byte : src)
+    byte = random.Rand<uint8_t>();
+
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t offset = 0; offset <= kMaxOffset; offset += 7) {
+      for (uint8_t& byte : dst)
+        byte = random.Rand<uint8_t>();
+      std::vector<uint8_t> expected = dst;
+      for (size_t i = 0; i < length; ++i)
+        expected[offset + i] ^= src[kMaxOffset - offset + i];
+
+      fec_xor(&src[kMaxOffset - offset], length, &dst[offset]);
+      ASSERT_EQ(expected, dst) << "length " << length << ", offset " << offset;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(FecXorTest, Portable) {
+  VerifyFecXor(&FecXor_C);
+}
+
+TEST(FecXorTest, Dispatched) {
+  VerifyFecXor(&FecXor);
+}
+
+TEST(FecXorTest, XorTwiceRestoresData) {
+  Random random(0xfec);
+  std::vector<uint8_t> src(kMaxLength);
+  std::vector<uint8_t> dst(kMaxLength);
+  for (size_t i = 0; i < kMaxLength; ++i) {
+    src[i] = random.Rand<uint8_t>();
+    dst[i] = random.Rand<uint8_t>();
+  }
+  const std::vector<uint8_t> original = dst;
+
+  FecXor(src.data(), src.size(), dst.data());
+  EXPECT_NE(original, dst);
+  FecXor(src.data(), src.size(), dst.data());
+  EXPECT_EQ(original, dst);
+}
+
+#if defined(WEBRTC_HAS_NEON)
+
+TEST(FecXorTest, Neon) {
+  VerifyFecXor(&FecXor_NEON);
+}
+
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+
+TEST(FecXorTest, Sse2) {
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    VerifyFecXor(&FecXor_SSE2);
+  }
+}
+
+TEST(FecXorTest, Avx2) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    VerifyFecXor(&FecXor_AVX2);
+  }
+}
+
+#endif
+
+}  // namespace webrtc
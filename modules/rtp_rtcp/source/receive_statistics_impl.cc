@@ -20,6 +20,7 @@
 #include "modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "modules/rtp_rtcp/source/time_util.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/rate_statistics.h"
 #include "system_wrappers/include/clock.h"
 
 namespace webrtc {
@@ -262,7 +263,6 @@ StreamDataCounters StreamStatisticianImpl::GetReceiveStreamDataCounters()
 }
 
 uint32_t StreamStatisticianImpl::BitrateReceived() const {
-  rtc::CritScope cs(&stream_lock_);
   return incoming_bitrate_.Rate(clock_->TimeInMilliseconds()).value_or(0);
 }
 
@@ -18,8 +18,8 @@
 #include "absl/types/optional.h"
 #include "modules/include/module_common_types_public.h"
 #include "modules/rtp_rtcp/include/receive_statistics.h"
+#include "rtc_base/concurrent_rate_statistics.h"
 #include "rtc_base/critical_section.h"
-#include "rtc_base/rate_statistics.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -66,7 +66,8 @@ class StreamStatisticianImpl : public StreamStatistician {
   const uint32_t ssrc_;
   Clock* const clock_;
   rtc::CriticalSection stream_lock_;
-  RateStatistics incoming_bitrate_ RTC_GUARDED_BY(&stream_lock_);
+  // Updated under |stream_lock_|, but can be read without it.
+  ConcurrentRateStatistics incoming_bitrate_;
   // In number of packets or sequence numbers.
   int max_reordering_threshold_ RTC_GUARDED_BY(&stream_lock_);
   bool enable_retransmit_detection_ RTC_GUARDED_BY(&stream_lock_);
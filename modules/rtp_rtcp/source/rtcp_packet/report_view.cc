@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/report_view.h"
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace rtcp {
+namespace {
+// Bytes before the first report block: the sender SSRC, and for a sender
+// report also the sender info.
+constexpr size_t kRrBaseLength = 4;
+constexpr size_t kSrBaseLength = 24;
+}  // namespace
+
+ReportView::Iterator::Iterator(const uint8_t* pos, const uint8_t* end)
+    : pos_(pos), end_(end) {
+  if (pos_ != end_)
+    block_.Parse(pos_, ReportBlock::kLength);
+}
+
+ReportView::Iterator& ReportView::Iterator::operator++() {
+  RTC_DCHECK(pos_ != end_);
+  pos_ += ReportBlock::kLength;
+  if (pos_ != end_)
+    block_.Parse(pos_, ReportBlock::kLength);
+  return *this;
+}
+
+ReportView::ReportView() = default;
+
+ReportView::~ReportView() = default;
+
+bool ReportView::Parse(const CommonHeader& packet) {
+  RTC_DCHECK(packet.type() == SenderReport::kPacketType ||
+             packet.type() == ReceiverReport::kPacketType);
+  is_sender_report_ = packet.type() == SenderReport::kPacketType;
+  const size_t base_length = is_sender_report_ ? kSrBaseLength : kRrBaseLength;
+  const uint8_t report_block_count = packet.count();
+  if (packet.payload_size_bytes() <
+      base_length + report_block_count * ReportBlock::kLength) {
+    RTC_LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+
+  const uint8_t* const payload = packet.payload();
+  sender_ssrc_ = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  if (is_sender_report_) {
+    uint32_t secs = ByteReader<uint32_t>::ReadBigEndian(&payload[4]);
+    uint32_t frac = ByteReader<uint32_t>::ReadBigEndian(&payload[8]);
+    ntp_.Set(secs, frac);
+    rtp_timestamp_ = ByteReader<uint32_t>::ReadBigEndian(&payload[12]);
+    sender_packet_count_ = ByteReader<uint32_t>::ReadBigEndian(&payload[16]);
+    sender_octet_count_ = ByteReader<uint32_t>::ReadBigEndian(&payload[20]);
+  } else {
+    ntp_.Reset();
+    rtp_timestamp_ = 0;
+    sender_packet_count_ = 0;
+    sender_octet_count_ = 0;
+  }
+  num_report_blocks_ = report_block_count;
+  report_blocks_begin_ = payload + base_length;
+  report_blocks_end_ =
+      report_blocks_begin_ + report_block_count * ReportBlock::kLength;
+  return true;
+}
+
+ReportView::Iterator ReportView::begin() const {
+  return Iterator(report_blocks_begin_, report_blocks_end_);
+}
+
+ReportView::Iterator ReportView::end() const {
+  return Iterator(report_blocks_end_, report_blocks_end_);
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
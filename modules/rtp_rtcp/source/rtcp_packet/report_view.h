@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_REPORT_VIEW_H_
+#define MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_REPORT_VIEW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "system_wrappers/include/ntp_time.h"
+
+namespace webrtc {
+namespace rtcp {
+class CommonHeader;
+
+// Read-only view of a sender report or a receiver report. Unlike SenderReport
+// and ReceiverReport it doesn't copy the report blocks, but parses them one at
+// a time while they are iterated over, so it must not outlive the buffer the
+// CommonHeader points into.
+class ReportView {
+ public:
+  class Iterator {
+   public:
+    const ReportBlock& operator*() const { return block_; }
+    const ReportBlock* operator->() const { return &block_; }
+    Iterator& operator++();
+    bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+    bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+   private:
+    friend class ReportView;
+    Iterator(const uint8_t* pos, const uint8_t* end);
+
+    const uint8_t* pos_;
+    const uint8_t* const end_;
+    ReportBlock block_;
+  };
+
+  ReportView();
+  ~ReportView();
+
+  // Parse assumes header is already parsed and validated, and of type
+  // SenderReport::kPacketType or ReceiverReport::kPacketType.
+  bool Parse(const CommonHeader& packet);
+
+  bool is_sender_report() const { return is_sender_report_; }
+  uint32_t sender_ssrc() const { return sender_ssrc_; }
+  // Sender info, only set for sender reports.
+  NtpTime ntp() const { return ntp_; }
+  uint32_t rtp_timestamp() const { return rtp_timestamp_; }
+  uint32_t sender_packet_count() const { return sender_packet_count_; }
+  uint32_t sender_octet_count() const { return sender_octet_count_; }
+
+  size_t num_report_blocks() const { return num_report_blocks_; }
+  Iterator begin() const;
+  Iterator end() const;
+
+ private:
+  bool is_sender_report_ = false;
+  uint32_t sender_ssrc_ = 0;
+  NtpTime ntp_;
+  uint32_t rtp_timestamp_ = 0;
+  uint32_t sender_packet_count_ = 0;
+  uint32_t sender_octet_count_ = 0;
+  size_t num_report_blocks_ = 0;
+  const uint8_t* report_blocks_begin_ = nullptr;
+  const uint8_t* report_blocks_end_ = nullptr;
+};
+
+}  // namespace rtcp
+}  // namespace webrtc
+#endif  // MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_REPORT_VIEW_H_
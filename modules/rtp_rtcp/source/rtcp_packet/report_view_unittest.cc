@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/report_view.h"
+
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "rtc_base/buffer.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using webrtc::rtcp::CommonHeader;
+using webrtc::rtcp::ReceiverReport;
+using webrtc::rtcp::ReportBlock;
+using webrtc::rtcp::ReportView;
+using webrtc::rtcp::SenderReport;
+
+namespace webrtc {
+namespace {
+const uint32_t kSenderSsrc = 0x12345678;
+const NtpTime kNtp(0x11121418, 0x22242628);
+const uint32_t kRtpTimestamp = 0x33343536;
+const uint32_t kPacketCount = 0x44454647;
+const uint32_t kOctetCount = 0x55565758;
+
+ReportBlock MakeReportBlock(uint32_t ssrc, int32_t cumulative_lost) {
+  ReportBlock block;
+  block.SetMediaSsrc(ssrc);
+  block.SetFractionLost(55);
+  block.SetCumulativeLost(cumulative_lost);
+  block.SetJitter(ssrc + 1);
+  return block;
+}
+
+std::vector<uint32_t> SourceSsrcs(const ReportView& view) {
+  std::vector<uint32_t> ssrcs;
+  for (const ReportBlock& block : view)
+    ssrcs.push_back(block.source_ssrc());
+  return ssrcs;
+}
+}  // namespace
+
+TEST(RtcpPacketReportViewTest, ParsesSenderReport) {
+  SenderReport sr;
+  sr.SetSenderSsrc(kSenderSsrc);
+  sr.SetNtp(kNtp);
+  sr.SetRtpTimestamp(kRtpTimestamp);
+  sr.SetPacketCount(kPacketCount);
+  sr.SetOctetCount(kOctetCount);
+  sr.AddReportBlock(MakeReportBlock(0x1000, -5));
+  sr.AddReportBlock(MakeReportBlock(0x2000, 7));
+  rtc::Buffer packet = sr.Build();
+
+  CommonHeader header;
+  ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+  ReportView view;
+  ASSERT_TRUE(view.Parse(header));
+
+  EXPECT_TRUE(view.is_sender_report());
+  EXPECT_EQ(kSenderSsrc, view.sender_ssrc());
+  EXPECT_EQ(kNtp, view.ntp());
+  EXPECT_EQ(kRtpTimestamp, view.rtp_timestamp());
+  EXPECT_EQ(kPacketCount, view.sender_packet_count());
+  EXPECT_EQ(kOctetCount, view.sender_octet_count());
+  EXPECT_EQ(2u, view.num_report_blocks());
+  EXPECT_THAT(SourceSsrcs(view), ElementsAre(0x1000, 0x2000));
+  ReportView::Iterator it = view.begin();
+  EXPECT_EQ(55, it->fraction_lost());
+  EXPECT_EQ(-5, it->cumulative_lost_signed());
+  EXPECT_EQ(0x1001u, it->jitter());
+  ++it;
+  EXPECT_EQ(7, it->cumulative_lost_signed());
+  ++it;
+  EXPECT_TRUE(it == view.end());
+}
+
+TEST(RtcpPacketReportViewTest, ParsesReceiverReport) {
+  ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rr.AddReportBlock(MakeReportBlock(0x1000, 0));
+  rr.AddReportBlock(MakeReportBlock(0x2000, 0));
+  rr.AddReportBlock(MakeReportBlock(0x3000, 0));
+  rtc::Buffer packet = rr.Build();
+
+  CommonHeader header;
+  ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+  ReportView view;
+  ASSERT_TRUE(view.Parse(header));
+
+  EXPECT_FALSE(view.is_sender_report());
+  EXPECT_EQ(kSenderSsrc, view.sender_ssrc());
+  EXPECT_EQ(0u, view.rtp_timestamp());
+  EXPECT_EQ(3u, view.num_report_blocks());
+  EXPECT_THAT(SourceSsrcs(view), ElementsAre(0x1000, 0x2000, 0x3000));
+}
+
+TEST(RtcpPacketReportViewTest, ParsesReportWithoutReportBlocks) {
+  ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rtc::Buffer packet = rr.Build();
+
+  CommonHeader header;
+  ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+  ReportView view;
+  ASSERT_TRUE(view.Parse(header));
+
+  EXPECT_EQ(kSenderSsrc, view.sender_ssrc());
+  EXPECT_EQ(0u, view.num_report_blocks());
+  EXPECT_THAT(SourceSsrcs(view), IsEmpty());
+}
+
+TEST(RtcpPacketReportViewTest, ParseFailsOnIncorrectSize) {
+  ReceiverReport rr;
+  rr.SetSenderSsrc(kSenderSsrc);
+  rr.AddReportBlock(MakeReportBlock(0x1000, 0));
+  rtc::Buffer packet = rr.Build();
+  packet[0]++;  // Damage the packet: increase count field.
+
+  CommonHeader header;
+  ASSERT_TRUE(header.Parse(packet.data(), packet.size()));
+  ReportView view;
+  EXPECT_FALSE(view.Parse(header));
+}
+
+}  // namespace webrtc
@@ -30,6 +30,8 @@ namespace {
 // * 8 bytes FeedbackPacket header
 constexpr size_t kTransportFeedbackHeaderSizeBytes = 4 + 8 + 8;
 constexpr size_t kChunkSizeBytes = 2;
+// A two bit status vector chunk, the least dense kind, holds 7 statuses.
+constexpr size_t kMinStatusesPerChunk = 7;
 // TODO(sprang): Add support for dynamic max size for easier fragmentation,
 // eg. set it to what's left in the buffer or IP_PACKET_SIZE.
 // Size constraint imposed by RTCP common header: 16bit size field interpreted
@@ -71,6 +73,50 @@ constexpr int64_t kTimeWrapPeriodUs = (1ll << 24) * kBaseScaleFactor;
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 //    |           recv delta          |  recv delta   | zero padding  |
 //    +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+// Number of set bits in |bits|.
+int PopCount(uint16_t bits) {
+  bits = bits - ((bits >> 1) & 0x5555);
+  bits = (bits & 0x3333) + ((bits >> 2) & 0x3333);
+  bits = (bits + (bits >> 4)) & 0x0f0f;
+  return (bits + (bits >> 8)) & 0x1f;
+}
+
+// What a packet status chunk reports, found without decoding each status.
+struct ChunkSummary {
+  size_t num_statuses;
+  size_t num_received;
+  // Sum of the delta sizes, which is the size of the receive deltas.
+  size_t delta_size_sum;
+  // Whether any delta size is 3, which is reserved.
+  bool has_invalid_delta_size;
+};
+
+// Summarizes |chunk|, of which at most |max_size| statuses are used.
+ChunkSummary SummarizeChunk(uint16_t chunk, size_t max_size) {
+  if ((chunk & 0x8000) == 0) {
+    // Run length chunk.
+    size_t count = std::min<size_t>(chunk & 0x1fff, max_size);
+    size_t delta_size = (chunk >> 13) & 0x03;
+    return {count, delta_size > 0 ? count : 0, delta_size * count,
+            delta_size == 3 && count > 0};
+  }
+  if ((chunk & 0x4000) == 0) {
+    // One bit status vector chunk, with 14 statuses, first in the high bits.
+    size_t count = std::min<size_t>(14, max_size);
+    size_t num_received = PopCount((chunk & 0x3fff) >> (14 - count));
+    return {count, num_received, num_received, false};
+  }
+  // Two bit status vector chunk, with 7 statuses, first in the high bits.
+  size_t count = std::min<size_t>(7, max_size);
+  uint16_t symbols = (chunk & 0x3fff) >> 2 * (7 - count);
+  uint16_t low_bits = symbols & 0x1555;
+  uint16_t high_bits = (symbols >> 1) & 0x1555;
+  return {count, static_cast<size_t>(PopCount(low_bits | high_bits)),
+          static_cast<size_t>(PopCount(low_bits) + 2 * PopCount(high_bits)),
+          (low_bits & high_bits) != 0};
+}
+
 }  // namespace
 constexpr uint8_t TransportFeedback::kFeedbackMessageType;
 constexpr size_t TransportFeedback::kMaxReportedPackets;
@@ -307,6 +353,13 @@ void TransportFeedback::SetFeedbackSequenceNumber(uint8_t feedback_sequence) {
   feedback_seq_ = feedback_sequence;
 }
 
+void TransportFeedback::Reserve(size_t num_packets) {
+  received_packets_.reserve(num_packets);
+  if (include_lost_)
+    all_packets_.reserve(num_packets);
+  encoded_chunks_.reserve(num_packets / kMinStatusesPerChunk + 1);
+}
+
 bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number,
                                           int64_t timestamp_us) {
   // Set delta to zero if timestamps are not included, this will simplify the
@@ -426,92 +479,108 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     return false;
   }
 
-  std::vector<uint8_t> delta_sizes;
-  delta_sizes.reserve(status_count);
-  while (delta_sizes.size() < status_count) {
+  // Find the chunks, and how many packets and delta bytes they report, before
+  // decoding any of them.
+  size_t num_statuses = 0;
+  size_t num_received = 0;
+  size_t recv_delta_size = 0;
+  bool has_invalid_delta_size = false;
+  size_t last_chunk_max_size = 0;
+  while (num_statuses < status_count) {
     if (index + kChunkSizeBytes > end_index) {
       RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
       Clear();
       return false;
     }
-
     uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
     index += kChunkSizeBytes;
-    encoded_chunks_.push_back(chunk);
-    last_chunk_.Decode(chunk, status_count - delta_sizes.size());
-    last_chunk_.AppendTo(&delta_sizes);
+    last_chunk_max_size = status_count - num_statuses;
+    ChunkSummary summary = SummarizeChunk(chunk, last_chunk_max_size);
+    num_statuses += summary.num_statuses;
+    num_received += summary.num_received;
+    recv_delta_size += summary.delta_size_sum;
+    has_invalid_delta_size |= summary.has_invalid_delta_size;
   }
-  // Last chunk is stored in the |last_chunk_|.
-  encoded_chunks_.pop_back();
-  RTC_DCHECK_EQ(delta_sizes.size(), status_count);
+  RTC_DCHECK_EQ(num_statuses, status_count);
   num_seq_no_ = status_count;
-
-  uint16_t seq_no = base_seq_no_;
-  size_t recv_delta_size = 0;
-  for (size_t delta_size : delta_sizes) {
-    recv_delta_size += delta_size;
-  }
+  const size_t chunks_begin = 16;
+  const size_t chunks_end = index;
 
   // Determine if timestamps, that is, recv_delta are included in the packet.
-  if (end_index >= index + recv_delta_size) {
-    for (size_t delta_size : delta_sizes) {
-      if (index + delta_size > end_index) {
-        RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
-        Clear();
-        return false;
-      }
-      switch (delta_size) {
-        case 0:
-          if (include_lost_)
-            all_packets_.emplace_back(seq_no);
-          break;
-        case 1: {
-          int16_t delta = payload[index];
-          received_packets_.emplace_back(seq_no, delta);
-          if (include_lost_)
-            all_packets_.emplace_back(seq_no, delta);
-          last_timestamp_us_ += delta * kDeltaScaleFactor;
-          index += delta_size;
-          break;
-        }
-        case 2: {
-          int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
-          received_packets_.emplace_back(seq_no, delta);
-          if (include_lost_)
-            all_packets_.emplace_back(seq_no, delta);
-          last_timestamp_us_ += delta * kDeltaScaleFactor;
-          index += delta_size;
-          break;
-        }
-        case 3:
-          Clear();
-          RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
-
-          return false;
-        default:
-          RTC_NOTREACHED();
-          break;
-      }
-      ++seq_no;
-    }
-  } else {
+  const bool has_deltas = end_index >= index + recv_delta_size;
+  if (has_deltas && has_invalid_delta_size) {
+    Clear();
+    RTC_LOG(LS_WARNING) << "Invalid delta_size in packet.";
+    return false;
+  }
+  if (!has_deltas) {
     // The packet does not contain receive deltas.
     include_timestamps_ = false;
-    for (size_t delta_size : delta_sizes) {
-      // Use delta sizes to detect if packet was received.
-      if (delta_size > 0) {
-        received_packets_.emplace_back(seq_no, 0);
+  }
+
+  encoded_chunks_.reserve((chunks_end - chunks_begin) / kChunkSizeBytes - 1);
+  received_packets_.reserve(num_received);
+  if (include_lost_)
+    all_packets_.reserve(status_count);
+
+  uint16_t seq_no = base_seq_no_;
+  auto add_packet = [&](DeltaSize delta_size) {
+    if (delta_size == 0) {
+      if (include_lost_)
+        all_packets_.emplace_back(seq_no);
+    } else {
+      int16_t delta = 0;
+      if (has_deltas) {
+        delta = delta_size == 1
+                    ? payload[index]
+                    : ByteReader<int16_t>::ReadBigEndian(&payload[index]);
+        index += delta_size;
+        last_timestamp_us_ += delta * kDeltaScaleFactor;
       }
-      if (include_lost_) {
-        if (delta_size > 0) {
-          all_packets_.emplace_back(seq_no, 0);
-        } else {
-          all_packets_.emplace_back(seq_no);
-        }
+      // Without deltas, packets with any delta size are received.
+      received_packets_.emplace_back(seq_no, delta);
+      if (include_lost_)
+        all_packets_.emplace_back(seq_no, delta);
+    }
+    ++seq_no;
+  };
+
+  size_t remaining = status_count;
+  for (size_t i = chunks_begin; i < chunks_end; i += kChunkSizeBytes) {
+    uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[i]);
+    if (i + kChunkSizeBytes < chunks_end) {
+      encoded_chunks_.push_back(chunk);
+    } else {
+      // Last chunk is stored in the |last_chunk_|.
+      last_chunk_.Decode(chunk, last_chunk_max_size);
+    }
+    if ((chunk & 0x8000) == 0) {
+      // Run length chunk.
+      size_t count = std::min<size_t>(chunk & 0x1fff, remaining);
+      DeltaSize delta_size = (chunk >> 13) & 0x03;
+      remaining -= count;
+      if (delta_size == 0 && !include_lost_) {
+        seq_no += static_cast<uint16_t>(count);
+        continue;
       }
-      ++seq_no;
+      for (size_t j = 0; j < count; ++j)
+        add_packet(delta_size);
+    } else if ((chunk & 0x4000) == 0) {
+      // One bit status vector chunk.
+      size_t count = std::min<size_t>(14, remaining);
+      remaining -= count;
+      for (size_t j = 0; j < count; ++j)
+        add_packet((chunk >> (13 - j)) & 0x01);
+    } else {
+      // Two bit status vector chunk.
+      size_t count = std::min<size_t>(7, remaining);
+      remaining -= count;
+      for (size_t j = 0; j < count; ++j)
+        add_packet((chunk >> 2 * (6 - j)) & 0x03);
     }
   }
+  RTC_DCHECK_EQ(remaining, 0);
+  RTC_DCHECK_EQ(received_packets_.size(), num_received);
   size_bytes_ = RtcpPacket::kHeaderLength + index;
   RTC_DCHECK_LE(index, end_index);
   return true;
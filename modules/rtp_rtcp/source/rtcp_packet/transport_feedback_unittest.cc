@@ -16,6 +16,8 @@
 
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -602,5 +604,67 @@ TEST(TransportFeedbackTest, ReportsMissingPacketsWithoutTimestamps) {
   EXPECT_FALSE(packets[2].received());
   EXPECT_TRUE(packets[3].received());
 }
+
+TEST(TransportFeedbackTest, RejectsReservedDeltaSize) {
+  TransportFeedback feedback_builder;
+  feedback_builder.SetBase(0, 0);
+  for (uint16_t seq_no = 0; seq_no < 7; ++seq_no) {
+    EXPECT_TRUE(feedback_builder.AddReceivedPacket(
+        seq_no, seq_no * TransportFeedback::kDeltaScaleFactor * 1000));
+  }
+  rtc::Buffer coded = feedback_builder.Build();
+  ASSERT_TRUE(TransportFeedback::ParseFrom(coded.data(), coded.size()));
+
+  // Replace the run length chunk of large deltas with a two bit vector chunk
+  // that ends with the reserved delta size 3. The 14 bytes of receive deltas
+  // are enough for the 9 it needs.
+  ByteWriter<uint16_t>::WriteBigEndian(&coded[kHeaderSize], 0xd557);
+  EXPECT_FALSE(TransportFeedback::ParseFrom(coded.data(), coded.size()));
+}
+
+TEST(TransportFeedbackTest, DISABLED_BenchmarkBuildAndParse) {
+  constexpr int kNumIterations = 20000;
+  constexpr int kNumPackets = 1000;
+  const int64_t kBaseTimestampUs = 123456789;
+
+  // Mostly small deltas, with every 16th packet lost and every 10th delayed
+  // enough to need a large delta.
+  TransportFeedback feedback;
+  feedback.SetBase(0, kBaseTimestampUs);
+  int64_t timestamp_us = kBaseTimestampUs;
+  for (int i = 0; i < kNumPackets; ++i) {
+    timestamp_us += i % 10 == 9 ? 100000 : 1000;
+    if (i % 16 != 15)
+      ASSERT_TRUE(feedback.AddReceivedPacket(i, timestamp_us));
+  }
+  const rtc::Buffer coded = feedback.Build();
+
+  int64_t start_us = rtc::TimeMicros();
+  size_t total_size = 0;
+  for (int i = 0; i < kNumIterations; ++i) {
+    total_size += feedback.Build().size();
+  }
+  const int64_t build_us = rtc::TimeMicros() - start_us;
+  EXPECT_EQ(kNumIterations * coded.size(), total_size);
+
+  start_us = rtc::TimeMicros();
+  size_t num_received = 0;
+  for (int i = 0; i < kNumIterations; ++i) {
+    std::unique_ptr<TransportFeedback> parsed =
+        TransportFeedback::ParseFrom(coded.data(), coded.size());
+    ASSERT_TRUE(parsed);
+    num_received += parsed->GetReceivedPackets().size();
+  }
+  const int64_t parse_us = rtc::TimeMicros() - start_us;
+  EXPECT_EQ(kNumIterations * feedback.GetReceivedPackets().size(),
+            num_received);
+
+  RTC_LOG(LS_INFO) << "Feedback packets of " << kNumPackets
+                   << " packets per second, built: "
+                   << kNumIterations * rtc::kNumMicrosecsPerSec / build_us
+                   << ", parsed: "
+                   << kNumIterations * rtc::kNumMicrosecsPerSec / parse_us;
+}
+
 }  // namespace
 }  // namespace webrtc
@@ -32,6 +32,7 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remote_estimate.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_view.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/tmmbn.h"
@@ -94,6 +95,7 @@ struct RTCPReceiver::PacketInformation {
   uint32_t receiver_estimated_max_bitrate_bps = 0;
   std::unique_ptr<rtcp::TransportFeedback> transport_feedback;
   absl::optional<VideoBitrateAllocation> target_bitrate_allocation;
+  absl::optional<VideoBitrateAllocation> requested_bitrate_allocation;
   absl::optional<NetworkStateEstimate> network_state_estimate;
   std::unique_ptr<rtcp::LossNotification> loss_notification;
 };
@@ -149,6 +151,8 @@ RTCPReceiver::RTCPReceiver(const RtpRtcp::Configuration& config,
       network_state_estimate_observer_(config.network_state_estimate_observer),
       transport_feedback_observer_(config.transport_feedback_callback),
       bitrate_allocation_observer_(config.bitrate_allocation_observer),
+      requested_bitrate_allocation_observer_(
+          config.requested_bitrate_allocation_observer),
       report_interval_ms_(config.rtcp_report_interval_ms > 0
                               ? config.rtcp_report_interval_ms
                               : (config.audio ? kDefaultAudioReportInterval
@@ -432,7 +436,7 @@ bool RTCPReceiver::ParseCompoundPacket(rtc::ArrayView<const uint8_t> packet,
 
 void RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
                                       PacketInformation* packet_information) {
-  rtcp::SenderReport sender_report;
+  rtcp::ReportView sender_report;
   if (!sender_report.Parse(rtcp_block)) {
     ++num_skipped_packets_;
     return;
@@ -458,13 +462,13 @@ void RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
     packet_information->packet_type_flags |= kRtcpRr;
   }
 
-  for (const rtcp::ReportBlock& report_block : sender_report.report_blocks())
+  for (const rtcp::ReportBlock& report_block : sender_report)
     HandleReportBlock(report_block, packet_information, remote_ssrc);
 }
 
 void RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
                                         PacketInformation* packet_information) {
-  rtcp::ReceiverReport receiver_report;
+  rtcp::ReportView receiver_report;
   if (!receiver_report.Parse(rtcp_block)) {
     ++num_skipped_packets_;
     return;
@@ -478,7 +482,7 @@ void RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
 
   packet_information->packet_type_flags |= kRtcpRr;
 
-  for (const ReportBlock& report_block : receiver_report.report_blocks())
+  for (const ReportBlock& report_block : receiver_report)
     HandleReportBlock(report_block, packet_information, remote_ssrc);
 }
 
@@ -803,7 +807,12 @@ void RTCPReceiver::HandleXrTargetBitrate(
     uint32_t ssrc,
     const rtcp::TargetBitrate& target_bitrate,
     PacketInformation* packet_information) {
-  if (ssrc != remote_ssrc_) {
+  // From the sender of the stream we receive, the report is the allocation of
+  // that stream. On a sending module, it is instead the receiver of our stream
+  // asking for an allocation, e.g. an SFU signalling which layers it forwards.
+  const bool from_remote_sender = ssrc == remote_ssrc_;
+  if (!from_remote_sender &&
+      (receiver_only_ || !requested_bitrate_allocation_observer_)) {
     return;  // Not for us.
   }
 
@@ -820,7 +829,12 @@ void RTCPReceiver::HandleXrTargetBitrate(
                                     item.target_bitrate_kbps * 1000);
     }
   }
-  packet_information->target_bitrate_allocation.emplace(bitrate_allocation);
+  if (from_remote_sender) {
+    packet_information->target_bitrate_allocation.emplace(bitrate_allocation);
+  } else {
+    packet_information->requested_bitrate_allocation.emplace(
+        bitrate_allocation);
+  }
 }
 
 void RTCPReceiver::HandlePli(const CommonHeader& rtcp_block,
@@ -1094,6 +1108,12 @@ void RTCPReceiver::TriggerCallbacksFromRtcpPacket(
         *packet_information.target_bitrate_allocation);
   }
 
+  if (requested_bitrate_allocation_observer_ &&
+      packet_information.requested_bitrate_allocation) {
+    requested_bitrate_allocation_observer_->OnBitrateAllocationUpdated(
+        *packet_information.requested_bitrate_allocation);
+  }
+
   if (!receiver_only_) {
     if (stats_callback_) {
       for (const auto& report_block : packet_information.report_blocks) {
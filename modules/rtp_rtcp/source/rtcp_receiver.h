@@ -221,6 +221,7 @@ class RTCPReceiver final {
   NetworkStateEstimateObserver* const network_state_estimate_observer_;
   TransportFeedbackObserver* const transport_feedback_observer_;
   VideoBitrateAllocationObserver* const bitrate_allocation_observer_;
+  VideoBitrateAllocationObserver* const requested_bitrate_allocation_observer_;
   const int report_interval_ms_;
 
   rtc::CriticalSection rtcp_receiver_lock_;
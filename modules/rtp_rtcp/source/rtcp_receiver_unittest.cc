@@ -1747,6 +1747,38 @@ TEST(RtcpReceiverTest, ReceivesTargetBitrate) {
   receiver.IncomingPacket(xr.Build());
 }
 
+TEST(RtcpReceiverTest, ReceivesRequestedBitrateAllocation) {
+  ReceiverMocks mocks;
+  StrictMock<MockVideoBitrateAllocationObserver> requested_observer;
+  RtpRtcp::Configuration config = DefaultConfiguration(&mocks);
+  config.requested_bitrate_allocation_observer = &requested_observer;
+  RTCPReceiver receiver(config, &mocks.rtp_rtcp_impl);
+  receiver.SetRemoteSSRC(kSenderSsrc);
+
+  VideoBitrateAllocation expected_allocation;
+  expected_allocation.SetBitrate(0, 0, 10000);
+  expected_allocation.SetBitrate(1, 0, 0);
+
+  rtcp::TargetBitrate bitrate;
+  bitrate.AddTargetBitrate(0, 0, expected_allocation.GetBitrate(0, 0) / 1000);
+  bitrate.AddTargetBitrate(1, 0, 0);
+
+  rtcp::ExtendedReports xr;
+  xr.SetTargetBitrate(bitrate);
+
+  // From the receiver of our stream, the report is a requested allocation.
+  xr.SetSenderSsrc(kSenderSsrc + 1);
+  EXPECT_CALL(requested_observer,
+              OnBitrateAllocationUpdated(expected_allocation));
+  receiver.IncomingPacket(xr.Build());
+
+  // From the sender of the stream we receive, it is that stream's allocation.
+  xr.SetSenderSsrc(kSenderSsrc);
+  EXPECT_CALL(mocks.bitrate_allocation_observer,
+              OnBitrateAllocationUpdated(expected_allocation));
+  receiver.IncomingPacket(xr.Build());
+}
+
 TEST(RtcpReceiverTest, HandlesIncorrectTargetBitrate) {
   ReceiverMocks mocks;
   RTCPReceiver receiver(DefaultConfiguration(&mocks), &mocks.rtp_rtcp_impl);
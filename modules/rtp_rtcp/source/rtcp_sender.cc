@@ -20,7 +20,6 @@
 #include "logging/rtc_event_log/events/rtc_event_rtcp_packet_outgoing.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/app.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
-#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/loss_notification.h"
@@ -51,38 +50,11 @@ const uint32_t kRtcpAnyExtendedReports = kRtcpXrReceiverReferenceTime |
 constexpr int32_t kDefaultVideoReportInterval = 1000;
 constexpr int32_t kDefaultAudioReportInterval = 5000;
 
-class PacketContainer : public rtcp::CompoundPacket {
- public:
-  PacketContainer(Transport* transport, RtcEventLog* event_log)
-      : transport_(transport), event_log_(event_log) {}
-  ~PacketContainer() override {
-    for (RtcpPacket* packet : appended_packets_)
-      delete packet;
-  }
-
-  size_t SendPackets(size_t max_payload_length) {
-    size_t bytes_sent = 0;
-    Build(max_payload_length, [&](rtc::ArrayView<const uint8_t> packet) {
-      if (transport_->SendRtcp(packet.data(), packet.size())) {
-        bytes_sent += packet.size();
-        if (event_log_) {
-          event_log_->Log(std::make_unique<RtcEventRtcpPacketOutgoing>(packet));
-        }
-      }
-    });
-    return bytes_sent;
-  }
-
- private:
-  Transport* transport_;
-  RtcEventLog* const event_log_;
-
-  RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(PacketContainer);
-};
+}  // namespace
 
-// Helper to put several RTCP packets into lower layer datagram RTCP packet.
-// Prefer to use this class instead of PacketContainer.
-class PacketSender {
+// Serializes RTCP packets straight into a datagram sized buffer, so that a
+// compound packet is built without keeping the individual packets around.
+class RTCPSender::PacketSender {
  public:
   PacketSender(rtcp::RtcpPacket::PacketReadyCallback callback,
                size_t max_packet_size)
@@ -114,8 +86,6 @@ class PacketSender {
   uint8_t buffer_[IP_PACKET_SIZE];
 };
 
-}  // namespace
-
 RTCPSender::FeedbackState::FeedbackState()
     : packets_sent(0),
       media_bytes_sent(0),
@@ -453,7 +423,7 @@ bool RTCPSender::TimeToSendRTCPReport(bool sendKeyframeBeforeRTP) const {
   return false;
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSR(const RtcpContext& ctx) {
+void RTCPSender::BuildSR(const RtcpContext& ctx, PacketSender* sender) {
   // Timestamp shouldn't be estimated before first media frame.
   RTC_DCHECK_GE(last_frame_capture_time_ms_, 0);
   // The timestamp of this RTCP packet should be estimated as the timestamp of
@@ -472,69 +442,62 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSR(const RtcpContext& ctx) {
       timestamp_offset_ + last_rtp_timestamp_ +
       ((ctx.now_us_ + 500) / 1000 - last_frame_capture_time_ms_) * rtp_rate;
 
-  rtcp::SenderReport* report = new rtcp::SenderReport();
-  report->SetSenderSsrc(ssrc_);
-  report->SetNtp(TimeMicrosToNtp(ctx.now_us_));
-  report->SetRtpTimestamp(rtp_timestamp);
-  report->SetPacketCount(ctx.feedback_state_.packets_sent);
-  report->SetOctetCount(ctx.feedback_state_.media_bytes_sent);
-  report->SetReportBlocks(CreateReportBlocks(ctx.feedback_state_));
-
-  return std::unique_ptr<rtcp::RtcpPacket>(report);
+  rtcp::SenderReport report;
+  report.SetSenderSsrc(ssrc_);
+  report.SetNtp(TimeMicrosToNtp(ctx.now_us_));
+  report.SetRtpTimestamp(rtp_timestamp);
+  report.SetPacketCount(ctx.feedback_state_.packets_sent);
+  report.SetOctetCount(ctx.feedback_state_.media_bytes_sent);
+  report.SetReportBlocks(CreateReportBlocks(ctx.feedback_state_));
+  sender->AppendPacket(report);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildSDES(
-    const RtcpContext& ctx) {
+void RTCPSender::BuildSDES(const RtcpContext& ctx, PacketSender* sender) {
   size_t length_cname = cname_.length();
   RTC_CHECK_LT(length_cname, RTCP_CNAME_SIZE);
 
-  rtcp::Sdes* sdes = new rtcp::Sdes();
-  sdes->AddCName(ssrc_, cname_);
+  rtcp::Sdes sdes;
+  sdes.AddCName(ssrc_, cname_);
 
   for (const auto& it : csrc_cnames_)
-    RTC_CHECK(sdes->AddCName(it.first, it.second));
+    RTC_CHECK(sdes.AddCName(it.first, it.second));
 
-  return std::unique_ptr<rtcp::RtcpPacket>(sdes);
+  sender->AppendPacket(sdes);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildRR(const RtcpContext& ctx) {
-  rtcp::ReceiverReport* report = new rtcp::ReceiverReport();
-  report->SetSenderSsrc(ssrc_);
-  report->SetReportBlocks(CreateReportBlocks(ctx.feedback_state_));
-
-  return std::unique_ptr<rtcp::RtcpPacket>(report);
+void RTCPSender::BuildRR(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::ReceiverReport report;
+  report.SetSenderSsrc(ssrc_);
+  report.SetReportBlocks(CreateReportBlocks(ctx.feedback_state_));
+  sender->AppendPacket(report);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildPLI(const RtcpContext& ctx) {
-  rtcp::Pli* pli = new rtcp::Pli();
-  pli->SetSenderSsrc(ssrc_);
-  pli->SetMediaSsrc(remote_ssrc_);
+void RTCPSender::BuildPLI(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::Pli pli;
+  pli.SetSenderSsrc(ssrc_);
+  pli.SetMediaSsrc(remote_ssrc_);
 
   ++packet_type_counter_.pli_packets;
-
-  return std::unique_ptr<rtcp::RtcpPacket>(pli);
+  sender->AppendPacket(pli);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildFIR(const RtcpContext& ctx) {
+void RTCPSender::BuildFIR(const RtcpContext& ctx, PacketSender* sender) {
   ++sequence_number_fir_;
 
-  rtcp::Fir* fir = new rtcp::Fir();
-  fir->SetSenderSsrc(ssrc_);
-  fir->AddRequestTo(remote_ssrc_, sequence_number_fir_);
+  rtcp::Fir fir;
+  fir.SetSenderSsrc(ssrc_);
+  fir.AddRequestTo(remote_ssrc_, sequence_number_fir_);
 
   ++packet_type_counter_.fir_packets;
-
-  return std::unique_ptr<rtcp::RtcpPacket>(fir);
+  sender->AppendPacket(fir);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildREMB(
-    const RtcpContext& ctx) {
-  rtcp::Remb* remb = new rtcp::Remb();
-  remb->SetSenderSsrc(ssrc_);
-  remb->SetBitrateBps(remb_bitrate_);
-  remb->SetSsrcs(remb_ssrcs_);
-
-  return std::unique_ptr<rtcp::RtcpPacket>(remb);
+void RTCPSender::BuildREMB(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::Remb remb;
+  remb.SetSenderSsrc(ssrc_);
+  remb.SetBitrateBps(remb_bitrate_);
+  remb.SetSsrcs(remb_ssrcs_);
+  sender->AppendPacket(remb);
 }
 
 void RTCPSender::SetTargetBitrate(unsigned int target_bitrate) {
@@ -542,10 +505,9 @@ void RTCPSender::SetTargetBitrate(unsigned int target_bitrate) {
   tmmbr_send_bps_ = target_bitrate;
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildTMMBR(
-    const RtcpContext& ctx) {
+void RTCPSender::BuildTMMBR(const RtcpContext& ctx, PacketSender* sender) {
   if (ctx.feedback_state_.receiver == nullptr)
-    return nullptr;
+    return;
   // Before sending the TMMBR check the received TMMBN, only an owner is
   // allowed to raise the bitrate:
   // * If the sender is an owner of the TMMBN -> send TMMBR
@@ -565,7 +527,7 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildTMMBR(
       if (candidate.bitrate_bps() == tmmbr_send_bps_ &&
           candidate.packet_overhead() == packet_oh_send_) {
         // Do not send the same tuple.
-        return nullptr;
+        return;
       }
     }
     if (!tmmbr_owner) {
@@ -579,65 +541,60 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildTMMBR(
       tmmbr_owner = TMMBRHelp::IsOwner(bounding, ssrc_);
       if (!tmmbr_owner) {
         // Did not enter bounding set, no meaning to send this request.
-        return nullptr;
+        return;
       }
     }
   }
 
   if (!tmmbr_send_bps_)
-    return nullptr;
+    return;
 
-  rtcp::Tmmbr* tmmbr = new rtcp::Tmmbr();
-  tmmbr->SetSenderSsrc(ssrc_);
+  rtcp::Tmmbr tmmbr;
+  tmmbr.SetSenderSsrc(ssrc_);
   rtcp::TmmbItem request;
   request.set_ssrc(remote_ssrc_);
   request.set_bitrate_bps(tmmbr_send_bps_);
   request.set_packet_overhead(packet_oh_send_);
-  tmmbr->AddTmmbr(request);
-
-  return std::unique_ptr<rtcp::RtcpPacket>(tmmbr);
+  tmmbr.AddTmmbr(request);
+  sender->AppendPacket(tmmbr);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildTMMBN(
-    const RtcpContext& ctx) {
-  rtcp::Tmmbn* tmmbn = new rtcp::Tmmbn();
-  tmmbn->SetSenderSsrc(ssrc_);
+void RTCPSender::BuildTMMBN(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::Tmmbn tmmbn;
+  tmmbn.SetSenderSsrc(ssrc_);
   for (const rtcp::TmmbItem& tmmbr : tmmbn_to_send_) {
     if (tmmbr.bitrate_bps() > 0) {
-      tmmbn->AddTmmbr(tmmbr);
+      tmmbn.AddTmmbr(tmmbr);
     }
   }
-
-  return std::unique_ptr<rtcp::RtcpPacket>(tmmbn);
+  sender->AppendPacket(tmmbn);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildAPP(const RtcpContext& ctx) {
-  rtcp::App* app = new rtcp::App();
-  app->SetSenderSsrc(ssrc_);
-  app->SetSubType(app_sub_type_);
-  app->SetName(app_name_);
-  app->SetData(app_data_.get(), app_length_);
-
-  return std::unique_ptr<rtcp::RtcpPacket>(app);
+void RTCPSender::BuildAPP(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::App app;
+  app.SetSenderSsrc(ssrc_);
+  app.SetSubType(app_sub_type_);
+  app.SetName(app_name_);
+  app.SetData(app_data_.get(), app_length_);
+  sender->AppendPacket(app);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildLossNotification(
-    const RtcpContext& ctx) {
-  auto loss_notification = std::make_unique<rtcp::LossNotification>(
+void RTCPSender::BuildLossNotification(const RtcpContext& ctx,
+                                       PacketSender* sender) {
+  rtcp::LossNotification loss_notification(
       loss_notification_state_.last_decoded_seq_num,
       loss_notification_state_.last_received_seq_num,
       loss_notification_state_.decodability_flag);
-  loss_notification->SetSenderSsrc(ssrc_);
-  loss_notification->SetMediaSsrc(remote_ssrc_);
-  return std::move(loss_notification);
+  loss_notification.SetSenderSsrc(ssrc_);
+  loss_notification.SetMediaSsrc(remote_ssrc_);
+  sender->AppendPacket(loss_notification);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildNACK(
-    const RtcpContext& ctx) {
-  rtcp::Nack* nack = new rtcp::Nack();
-  nack->SetSenderSsrc(ssrc_);
-  nack->SetMediaSsrc(remote_ssrc_);
-  nack->SetPacketIds(ctx.nack_list_, ctx.nack_size_);
+void RTCPSender::BuildNACK(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::Nack nack;
+  nack.SetSenderSsrc(ssrc_);
+  nack.SetMediaSsrc(remote_ssrc_);
+  nack.SetPacketIds(ctx.nack_list_, ctx.nack_size_);
 
   // Report stats.
   for (int idx = 0; idx < ctx.nack_size_; ++idx) {
@@ -647,31 +604,29 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildNACK(
   packet_type_counter_.unique_nack_requests = nack_stats_.unique_requests();
 
   ++packet_type_counter_.nack_packets;
-
-  return std::unique_ptr<rtcp::RtcpPacket>(nack);
+  sender->AppendPacket(nack);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildBYE(const RtcpContext& ctx) {
-  rtcp::Bye* bye = new rtcp::Bye();
-  bye->SetSenderSsrc(ssrc_);
-  bye->SetCsrcs(csrcs_);
-
-  return std::unique_ptr<rtcp::RtcpPacket>(bye);
+void RTCPSender::BuildBYE(const RtcpContext& ctx, PacketSender* sender) {
+  rtcp::Bye bye;
+  bye.SetSenderSsrc(ssrc_);
+  bye.SetCsrcs(csrcs_);
+  sender->AppendPacket(bye);
 }
 
-std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildExtendedReports(
-    const RtcpContext& ctx) {
-  std::unique_ptr<rtcp::ExtendedReports> xr(new rtcp::ExtendedReports());
-  xr->SetSenderSsrc(ssrc_);
+void RTCPSender::BuildExtendedReports(const RtcpContext& ctx,
+                                      PacketSender* sender) {
+  rtcp::ExtendedReports xr;
+  xr.SetSenderSsrc(ssrc_);
 
   if (!sending_ && xr_send_receiver_reference_time_enabled_) {
     rtcp::Rrtr rrtr;
     rrtr.SetNtp(TimeMicrosToNtp(ctx.now_us_));
-    xr->SetRrtr(rrtr);
+    xr.SetRrtr(rrtr);
   }
 
   for (const rtcp::ReceiveTimeInfo& rti : ctx.feedback_state_.last_xr_rtis) {
-    xr->AddDlrrItem(rti);
+    xr.AddDlrrItem(rti);
   }
 
   if (send_video_bitrate_allocation_) {
@@ -686,11 +641,10 @@ std::unique_ptr<rtcp::RtcpPacket> RTCPSender::BuildExtendedReports(
       }
     }
 
-    xr->SetTargetBitrate(target_bitrate);
+    xr.SetTargetBitrate(target_bitrate);
     send_video_bitrate_allocation_ = false;
   }
-
-  return std::move(xr);
+  sender->AppendPacket(xr);
 }
 
 int32_t RTCPSender::SendRTCP(const FeedbackState& feedback_state,
@@ -707,20 +661,27 @@ int32_t RTCPSender::SendCompoundRTCP(
     const std::set<RTCPPacketType>& packet_types,
     int32_t nack_size,
     const uint16_t* nack_list) {
-  PacketContainer container(transport_, event_log_);
-  size_t max_packet_size;
-
+  size_t bytes_sent = 0;
+  auto callback = [&](rtc::ArrayView<const uint8_t> packet) {
+    if (transport_->SendRtcp(packet.data(), packet.size())) {
+      bytes_sent += packet.size();
+      if (event_log_)
+        event_log_->Log(std::make_unique<RtcEventRtcpPacketOutgoing>(packet));
+    }
+  };
+  absl::optional<PacketSender> sender;
   {
     rtc::CritScope lock(&critical_section_rtcp_sender_);
+    sender.emplace(callback, max_packet_size_);
     auto result = ComputeCompoundRTCPPacket(feedback_state, packet_types,
-                                            nack_size, nack_list, &container);
+                                            nack_size, nack_list, &*sender);
     if (result) {
       return *result;
     }
-    max_packet_size = max_packet_size_;
   }
-
-  size_t bytes_sent = container.SendPackets(max_packet_size);
+  // Only the last datagram of the compound packet is sent here; any earlier
+  // ones were sent as the buffer filled up.
+  sender->Send();
   return bytes_sent == 0 ? -1 : 0;
 }
 
@@ -729,13 +690,24 @@ int32_t RTCPSender::SendCompoundRTCPLocked(
     const std::set<RTCPPacketType>& packet_types,
     int32_t nack_size,
     const uint16_t* nack_list) {
-  PacketContainer container(transport_, event_log_);
+  size_t bytes_sent = 0;
+  PacketSender sender(
+      [&](rtc::ArrayView<const uint8_t> packet) {
+        if (transport_->SendRtcp(packet.data(), packet.size())) {
+          bytes_sent += packet.size();
+          if (event_log_) {
+            event_log_->Log(
+                std::make_unique<RtcEventRtcpPacketOutgoing>(packet));
+          }
+        }
+      },
+      max_packet_size_);
   auto result = ComputeCompoundRTCPPacket(feedback_state, packet_types,
-                                          nack_size, nack_list, &container);
+                                          nack_size, nack_list, &sender);
   if (result) {
     return *result;
   }
-  size_t bytes_sent = container.SendPackets(max_packet_size_);
+  sender.Send();
   return bytes_sent == 0 ? -1 : 0;
 }
 
@@ -744,7 +716,7 @@ absl::optional<int32_t> RTCPSender::ComputeCompoundRTCPPacket(
     const std::set<RTCPPacketType>& packet_types,
     int32_t nack_size,
     const uint16_t* nack_list,
-    rtcp::CompoundPacket* out_packet) {
+    PacketSender* sender) {
   if (method_ == RtcpMode::kOff) {
     RTC_LOG(LS_WARNING) << "Can't send rtcp if it is disabled.";
     return -1;
@@ -778,35 +750,34 @@ absl::optional<int32_t> RTCPSender::ComputeCompoundRTCPPacket(
 
   PrepareReport(feedback_state);
 
-  std::unique_ptr<rtcp::RtcpPacket> packet_bye;
+  bool create_bye = false;
 
   auto it = report_flags_.begin();
   while (it != report_flags_.end()) {
-    auto builder_it = builders_.find(it->type);
-    RTC_DCHECK(builder_it != builders_.end())
-        << "Could not find builder for packet type " << it->type;
+    uint32_t rtcp_packet_type = it->type;
+
     if (it->is_volatile) {
       report_flags_.erase(it++);
     } else {
       ++it;
     }
 
-    BuilderFunc func = builder_it->second;
-    std::unique_ptr<rtcp::RtcpPacket> packet = (this->*func)(context);
-    if (packet == nullptr)
-      return -1;
     // If there is a BYE, don't append now - save it and append it
     // at the end later.
-    if (builder_it->first == kRtcpBye) {
-      packet_bye = std::move(packet);
-    } else {
-      out_packet->Append(packet.release());
+    if (rtcp_packet_type == kRtcpBye) {
+      create_bye = true;
+      continue;
     }
+    auto builder_it = builders_.find(rtcp_packet_type);
+    RTC_DCHECK(builder_it != builders_.end())
+        << "Could not find builder for packet type " << rtcp_packet_type;
+    BuilderFunc func = builder_it->second;
+    (this->*func)(context, sender);
   }
 
   // Append the BYE now at the end
-  if (packet_bye) {
-    out_packet->Append(packet_bye.release());
+  if (create_bye) {
+    BuildBYE(context, sender);
   }
 
   if (packet_type_counter_observer_ != nullptr) {
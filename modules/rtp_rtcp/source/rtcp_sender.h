@@ -27,7 +27,6 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_nack_stats.h"
 #include "modules/rtp_rtcp/source/rtcp_packet.h"
-#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/tmmb_item.h"
@@ -170,6 +169,7 @@ class RTCPSender final {
 
  private:
   class RtcpContext;
+  class PacketSender;
 
   int32_t SendCompoundRTCPLocked(const FeedbackState& feedback_state,
                                  const std::set<RTCPPacketType>& packet_types,
@@ -182,7 +182,7 @@ class RTCPSender final {
       const std::set<RTCPPacketType>& packet_types,
       int32_t nack_size,
       const uint16_t* nack_list,
-      rtcp::CompoundPacket* out_packet)
+      PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
 
   // Determine which RTCP messages should be sent and setup flags.
@@ -193,33 +193,33 @@ class RTCPSender final {
       const FeedbackState& feedback_state)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
 
-  std::unique_ptr<rtcp::RtcpPacket> BuildSR(const RtcpContext& context)
+  void BuildSR(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildRR(const RtcpContext& context)
+  void BuildRR(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildSDES(const RtcpContext& context)
+  void BuildSDES(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildPLI(const RtcpContext& context)
+  void BuildPLI(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildREMB(const RtcpContext& context)
+  void BuildREMB(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildTMMBR(const RtcpContext& context)
+  void BuildTMMBR(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildTMMBN(const RtcpContext& context)
+  void BuildTMMBN(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildAPP(const RtcpContext& context)
+  void BuildAPP(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildLossNotification(
-      const RtcpContext& context)
+  void BuildLossNotification(const RtcpContext& context,
+                             PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildExtendedReports(
-      const RtcpContext& context)
+  void BuildExtendedReports(const RtcpContext& context,
+                            PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildBYE(const RtcpContext& context)
+  void BuildBYE(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildFIR(const RtcpContext& context)
+  void BuildFIR(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
-  std::unique_ptr<rtcp::RtcpPacket> BuildNACK(const RtcpContext& context)
+  void BuildNACK(const RtcpContext& context, PacketSender* sender)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critical_section_rtcp_sender_);
 
  private:
@@ -330,8 +330,7 @@ class RTCPSender final {
   std::set<ReportFlag> report_flags_
       RTC_GUARDED_BY(critical_section_rtcp_sender_);
 
-  typedef std::unique_ptr<rtcp::RtcpPacket> (RTCPSender::*BuilderFunc)(
-      const RtcpContext&);
+  typedef void (RTCPSender::*BuilderFunc)(const RtcpContext&, PacketSender*);
   // Map from RTCPPacketType to builder.
   std::map<uint32_t, BuilderFunc> builders_;
 
@@ -57,9 +57,11 @@ class TestTransport : public Transport {
     return false;
   }
   bool SendRtcp(const uint8_t* data, size_t len) override {
+    ++num_rtcp_sent_;
     parser_.Parse(data, len);
     return true;
   }
+  int num_rtcp_sent_ = 0;
   test::RtcpPacketParser parser_;
 };
 
@@ -611,6 +613,14 @@ TEST_F(RtcpSenderTest, TmmbrIncludedInCompoundPacketIfEnabled) {
   EXPECT_FALSE(rtcp_sender_->TMMBR());
 }
 
+TEST_F(RtcpSenderTest, TmmbrWithoutTargetBitrateDoesNotBlockReport) {
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
+  rtcp_sender_->SetTMMBRStatus(true);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpReport));
+  EXPECT_EQ(1, parser()->receiver_report()->num_packets());
+  EXPECT_EQ(0, parser()->tmmbr()->num_packets());
+}
+
 TEST_F(RtcpSenderTest, SendTmmbn) {
   rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
   rtcp_sender_->SetSendingStatus(feedback_state(), true);
@@ -825,6 +835,22 @@ TEST_F(RtcpSenderTest, DoesntSchedulesInitialReportWhenSsrcSetOnConstruction) {
   EXPECT_FALSE(rtcp_sender_->TimeToSendRTCPReport(false));
 }
 
+TEST_F(RtcpSenderTest, SplitsCompoundPacketAtMaxPacketSize) {
+  const uint16_t kList[] = {0, 1, 16};
+  rtcp_sender_->SetRTCPStatus(RtcpMode::kCompound);
+  rtcp_sender_->SetSendingStatus(feedback_state(), true);
+  rtcp_sender_->SetCNAME("cname");
+  // The SR and the SDES take 44 bytes, so the NACK goes in a second datagram.
+  rtcp_sender_->SetMaxRtpPacketSize(56);
+  EXPECT_EQ(0, rtcp_sender_->SendRTCP(feedback_state(), kRtcpNack,
+                                      ABSL_ARRAYSIZE(kList), kList));
+  EXPECT_EQ(2, test_transport_.num_rtcp_sent_);
+  EXPECT_EQ(1, parser()->sender_report()->num_packets());
+  EXPECT_EQ(1, parser()->sdes()->num_packets());
+  EXPECT_EQ(1, parser()->nack()->num_packets());
+  EXPECT_THAT(parser()->nack()->packet_ids(), ElementsAre(0, 1, 16));
+}
+
 TEST_F(RtcpSenderTest, SendsCombinedRtcpPacket) {
   rtcp_sender_->SetRTCPStatus(RtcpMode::kReducedSize);
 
@@ -72,6 +72,24 @@ void RtcpTransceiver::RemoveMediaReceiverRtcpObserver(
   task_queue_->PostTask(ToQueuedTask(std::move(remove), std::move(on_removed)));
 }
 
+void RtcpTransceiver::AddMediaSender(uint32_t local_ssrc,
+                                     RtpStreamRtcpHandler* handler) {
+  RTC_CHECK(rtcp_transceiver_);
+  RtcpTransceiverImpl* ptr = rtcp_transceiver_.get();
+  task_queue_->PostTask(ToQueuedTask([ptr, local_ssrc, handler] {
+    bool added = ptr->AddMediaSender(local_ssrc, handler);
+    RTC_DCHECK(added) << "Media sender " << local_ssrc << " already added.";
+  }));
+}
+
+void RtcpTransceiver::RemoveMediaSender(uint32_t local_ssrc,
+                                        std::function<void()> on_removed) {
+  RTC_CHECK(rtcp_transceiver_);
+  RtcpTransceiverImpl* ptr = rtcp_transceiver_.get();
+  auto remove = [ptr, local_ssrc] { ptr->RemoveMediaSender(local_ssrc); };
+  task_queue_->PostTask(ToQueuedTask(std::move(remove), std::move(on_removed)));
+}
+
 void RtcpTransceiver::SetReadyToSend(bool ready) {
   RTC_CHECK(rtcp_transceiver_);
   RtcpTransceiverImpl* ptr = rtcp_transceiver_.get();
@@ -55,6 +55,14 @@ class RtcpTransceiver : public RtcpFeedbackSenderInterface {
                                        MediaReceiverRtcpObserver* observer,
                                        std::function<void()> on_removed);
 
+  // Registers local media sender to include in the sender reports, and to be
+  // notified about incoming feedback for |local_ssrc|. Calls to the handler
+  // will be done on the |config.task_queue|.
+  void AddMediaSender(uint32_t local_ssrc, RtpStreamRtcpHandler* handler);
+  // Deregisters the media sender. Might return before it is deregistered.
+  // Runs |on_removed| when the handler is no longer used.
+  void RemoveMediaSender(uint32_t local_ssrc, std::function<void()> on_removed);
+
   // Enables/disables sending rtcp packets eventually.
   // Packets may be sent after the SetReadyToSend(false) returns, but no new
   // packets will be scheduled.
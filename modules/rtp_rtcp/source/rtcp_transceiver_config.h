@@ -13,10 +13,12 @@
 
 #include <string>
 
+#include "api/array_view.h"
 #include "api/rtp_headers.h"
 #include "api/task_queue/task_queue_base.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "system_wrappers/include/ntp_time.h"
 
 namespace webrtc {
@@ -38,6 +40,37 @@ class MediaReceiverRtcpObserver {
                                    const VideoBitrateAllocation& allocation) {}
 };
 
+// Interface of a local media (rtp) sender to the RtcpTransceiver. Provides the
+// stats for its sender reports, and is notified about incoming rtcp packets
+// about the stream it sends.
+class RtpStreamRtcpHandler {
+ public:
+  struct RtpStats {
+    uint32_t num_sent_packets = 0;
+    // Payload octets, as defined for the sender info in rfc3550 section 6.4.1.
+    uint32_t num_sent_bytes = 0;
+    // Rtp timestamp and capture time, in the rtc::TimeMicros() clock, of the
+    // last sent frame. The rtp timestamp of a sender report is extrapolated
+    // from them.
+    uint32_t last_rtp_timestamp = 0;
+    int64_t last_capture_time_us = 0;
+    int last_clock_rate_hz = 90000;
+  };
+
+  virtual ~RtpStreamRtcpHandler() = default;
+
+  // No sender report is sent for the stream before it sends its first packet.
+  virtual RtpStats SentStats() = 0;
+
+  // Message handlers have default empty implementations too.
+  virtual void OnNack(uint32_t sender_ssrc,
+                      rtc::ArrayView<const uint16_t> sequence_numbers) {}
+  virtual void OnFir(uint32_t sender_ssrc) {}
+  virtual void OnPli(uint32_t sender_ssrc) {}
+  virtual void OnReportBlock(uint32_t sender_ssrc,
+                             const rtcp::ReportBlock& report_block) {}
+};
+
 struct RtcpTransceiverConfig {
   RtcpTransceiverConfig();
   RtcpTransceiverConfig(const RtcpTransceiverConfig&);
@@ -25,8 +25,11 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_view.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "modules/rtp_rtcp/source/time_util.h"
@@ -121,6 +124,16 @@ void RtcpTransceiverImpl::RemoveMediaReceiverRtcpObserver(
   stored.erase(it);
 }
 
+bool RtcpTransceiverImpl::AddMediaSender(uint32_t local_ssrc,
+                                         RtpStreamRtcpHandler* handler) {
+  RTC_DCHECK(handler);
+  return local_senders_.emplace(local_ssrc, handler).second;
+}
+
+bool RtcpTransceiverImpl::RemoveMediaSender(uint32_t local_ssrc) {
+  return local_senders_.erase(local_ssrc) > 0;
+}
+
 void RtcpTransceiverImpl::SetReadyToSend(bool ready) {
   if (config_.schedule_periodic_compound_packets) {
     if (ready_to_send_ && !ready)
@@ -236,6 +249,15 @@ void RtcpTransceiverImpl::HandleReceivedPacket(
     case rtcp::SenderReport::kPacketType:
       HandleSenderReport(rtcp_packet_header, now_us);
       break;
+    case rtcp::ReceiverReport::kPacketType:
+      HandleReceiverReport(rtcp_packet_header);
+      break;
+    case rtcp::Rtpfb::kPacketType:
+      HandleRtpFeedback(rtcp_packet_header);
+      break;
+    case rtcp::Psfb::kPacketType:
+      HandlePayloadSpecificFeedback(rtcp_packet_header);
+      break;
     case rtcp::ExtendedReports::kPacketType:
       HandleExtendedReports(rtcp_packet_header, now_us);
       break;
@@ -257,7 +279,7 @@ void RtcpTransceiverImpl::HandleBye(
 void RtcpTransceiverImpl::HandleSenderReport(
     const rtcp::CommonHeader& rtcp_packet_header,
     int64_t now_us) {
-  rtcp::SenderReport sender_report;
+  rtcp::ReportView sender_report;
   if (!sender_report.Parse(rtcp_packet_header))
     return;
   RemoteSenderState& remote_sender =
@@ -271,6 +293,66 @@ void RtcpTransceiverImpl::HandleSenderReport(
   for (MediaReceiverRtcpObserver* observer : remote_sender.observers)
     observer->OnSenderReport(sender_report.sender_ssrc(), sender_report.ntp(),
                              sender_report.rtp_timestamp());
+  HandleReportBlocks(sender_report);
+}
+
+void RtcpTransceiverImpl::HandleReceiverReport(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  rtcp::ReportView receiver_report;
+  if (!receiver_report.Parse(rtcp_packet_header))
+    return;
+  HandleReportBlocks(receiver_report);
+}
+
+void RtcpTransceiverImpl::HandleReportBlocks(const rtcp::ReportView& report) {
+  if (local_senders_.empty())
+    return;
+  for (const rtcp::ReportBlock& report_block : report) {
+    auto it = local_senders_.find(report_block.source_ssrc());
+    if (it != local_senders_.end())
+      it->second->OnReportBlock(report.sender_ssrc(), report_block);
+  }
+}
+
+void RtcpTransceiverImpl::HandleRtpFeedback(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  if (rtcp_packet_header.fmt() != rtcp::Nack::kFeedbackMessageType ||
+      local_senders_.empty())
+    return;
+  rtcp::Nack nack;
+  if (!nack.Parse(rtcp_packet_header))
+    return;
+  auto it = local_senders_.find(nack.media_ssrc());
+  if (it != local_senders_.end())
+    it->second->OnNack(nack.sender_ssrc(), nack.packet_ids());
+}
+
+void RtcpTransceiverImpl::HandlePayloadSpecificFeedback(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  if (local_senders_.empty())
+    return;
+  switch (rtcp_packet_header.fmt()) {
+    case rtcp::Pli::kFeedbackMessageType: {
+      rtcp::Pli pli;
+      if (!pli.Parse(rtcp_packet_header))
+        return;
+      auto it = local_senders_.find(pli.media_ssrc());
+      if (it != local_senders_.end())
+        it->second->OnPli(pli.sender_ssrc());
+      break;
+    }
+    case rtcp::Fir::kFeedbackMessageType: {
+      rtcp::Fir fir;
+      if (!fir.Parse(rtcp_packet_header))
+        return;
+      for (const rtcp::Fir::Request& request : fir.requests()) {
+        auto it = local_senders_.find(request.ssrc);
+        if (it != local_senders_.end())
+          it->second->OnFir(fir.sender_ssrc());
+      }
+      break;
+    }
+  }
 }
 
 void RtcpTransceiverImpl::HandleExtendedReports(
@@ -354,26 +436,38 @@ void RtcpTransceiverImpl::CreateCompoundPacket(PacketSender* sender) {
   RTC_DCHECK(sender->IsEmpty());
   const uint32_t sender_ssrc = config_.feedback_ssrc;
   int64_t now_us = rtc::TimeMicros();
-  rtcp::ReceiverReport receiver_report;
-  receiver_report.SetSenderSsrc(sender_ssrc);
-  receiver_report.SetReportBlocks(CreateReportBlocks(now_us));
-  sender->AppendPacket(receiver_report);
+  std::vector<rtcp::ReportBlock> report_blocks = CreateReportBlocks(now_us);
+  const bool sent_sender_reports =
+      AppendSenderReports(now_us, &report_blocks, sender);
+  if (!sent_sender_reports) {
+    rtcp::ReceiverReport receiver_report;
+    receiver_report.SetSenderSsrc(sender_ssrc);
+    receiver_report.SetReportBlocks(std::move(report_blocks));
+    sender->AppendPacket(receiver_report);
+  }
 
   if (!config_.cname.empty()) {
     rtcp::Sdes sdes;
     bool added = sdes.AddCName(config_.feedback_ssrc, config_.cname);
     RTC_DCHECK(added) << "Failed to add cname " << config_.cname
                       << " to rtcp sdes packet.";
+    for (const auto& local_sender : local_senders_) {
+      if (local_sender.first == config_.feedback_ssrc)
+        continue;
+      if (!sdes.AddCName(local_sender.first, config_.cname)) {
+        RTC_LOG(LS_WARNING) << config_.debug_id
+                            << "Too many local senders for a single sdes.";
+        break;
+      }
+    }
     sender->AppendPacket(sdes);
   }
   if (remb_) {
     remb_->SetSenderSsrc(sender_ssrc);
     sender->AppendPacket(*remb_);
   }
-  // TODO(bugs.webrtc.org/8239): Do not send rrtr if this packet starts with
-  // SenderReport instead of ReceiverReport
-  // when RtcpTransceiver supports rtp senders.
-  if (config_.non_sender_rtt_measurement) {
+  // Rrtr is only meaningful when this packet starts with a ReceiverReport.
+  if (config_.non_sender_rtt_measurement && !sent_sender_reports) {
     rtcp::ExtendedReports xr;
 
     rtcp::Rrtr rrtr;
@@ -455,4 +549,31 @@ std::vector<rtcp::ReportBlock> RtcpTransceiverImpl::CreateReportBlocks(
   return report_blocks;
 }
 
+bool RtcpTransceiverImpl::AppendSenderReports(
+    int64_t now_us,
+    std::vector<rtcp::ReportBlock>* report_blocks,
+    PacketSender* sender) {
+  bool appended = false;
+  for (const auto& local_sender : local_senders_) {
+    RtpStreamRtcpHandler::RtpStats stats = local_sender.second->SentStats();
+    if (stats.num_sent_packets == 0)
+      continue;
+    rtcp::SenderReport sender_report;
+    sender_report.SetSenderSsrc(local_sender.first);
+    sender_report.SetNtp(TimeMicrosToNtp(now_us));
+    // Extrapolate the rtp timestamp of a frame captured now.
+    int64_t elapsed_ticks = (now_us - stats.last_capture_time_us) *
+                            stats.last_clock_rate_hz / rtc::kNumMicrosecsPerSec;
+    sender_report.SetRtpTimestamp(stats.last_rtp_timestamp +
+                                  static_cast<uint32_t>(elapsed_ticks));
+    sender_report.SetPacketCount(stats.num_sent_packets);
+    sender_report.SetOctetCount(stats.num_sent_bytes);
+    if (!appended)
+      sender_report.SetReportBlocks(std::move(*report_blocks));
+    sender->AppendPacket(sender_report);
+    appended = true;
+  }
+  return appended;
+}
+
 }  // namespace webrtc
@@ -22,6 +22,7 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_view.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/target_bitrate.h"
 #include "modules/rtp_rtcp/source/rtcp_transceiver_config.h"
 #include "rtc_base/task_utils/repeating_task.h"
@@ -46,6 +47,13 @@ class RtcpTransceiverImpl {
   void RemoveMediaReceiverRtcpObserver(uint32_t remote_ssrc,
                                        MediaReceiverRtcpObserver* observer);
 
+  // Registers the local media sender |local_ssrc|. Every compound packet then
+  // starts with sender reports for the registered senders that have sent rtp
+  // packets, and incoming report blocks and feedback for |local_ssrc| are
+  // passed to |handler|. Returns false if |local_ssrc| is already registered.
+  bool AddMediaSender(uint32_t local_ssrc, RtpStreamRtcpHandler* handler);
+  bool RemoveMediaSender(uint32_t local_ssrc);
+
   void SetReadyToSend(bool ready);
 
   void ReceivePacket(rtc::ArrayView<const uint8_t> packet, int64_t now_us);
@@ -81,6 +89,11 @@ class RtcpTransceiverImpl {
   void HandleBye(const rtcp::CommonHeader& rtcp_packet_header);
   void HandleSenderReport(const rtcp::CommonHeader& rtcp_packet_header,
                           int64_t now_us);
+  void HandleReceiverReport(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandleReportBlocks(const rtcp::ReportView& report);
+  void HandleRtpFeedback(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandlePayloadSpecificFeedback(
+      const rtcp::CommonHeader& rtcp_packet_header);
   void HandleExtendedReports(const rtcp::CommonHeader& rtcp_packet_header,
                              int64_t now_us);
   // Extended Reports blocks handlers.
@@ -98,6 +111,12 @@ class RtcpTransceiverImpl {
   void SendImmediateFeedback(const rtcp::RtcpPacket& rtcp_packet);
   // Generate Report Blocks to be send in Sender or Receiver Report.
   std::vector<rtcp::ReportBlock> CreateReportBlocks(int64_t now_us);
+  // Appends sender reports for the local senders that have sent rtp packets,
+  // moving |report_blocks| into the first one. Returns false, leaving
+  // |report_blocks| as is, if there are none.
+  bool AppendSenderReports(int64_t now_us,
+                           std::vector<rtcp::ReportBlock>* report_blocks,
+                           PacketSender* sender);
 
   const RtcpTransceiverConfig config_;
 
@@ -106,6 +125,7 @@ class RtcpTransceiverImpl {
   // TODO(danilchap): Remove entries from remote_senders_ that are no longer
   // needed.
   std::map<uint32_t, RemoteSenderState> remote_senders_;
+  std::map<uint32_t, RtpStreamRtcpHandler*> local_senders_;
   RepeatingTaskHandle periodic_task_handle_;
 };
 
@@ -20,6 +20,10 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/app.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/time_util.h"
 #include "rtc_base/event.h"
 #include "rtc_base/fake_clock.h"
@@ -33,6 +37,7 @@ namespace {
 
 using ::testing::_;
 using ::testing::ElementsAre;
+using ::testing::Property;
 using ::testing::Return;
 using ::testing::SizeIs;
 using ::testing::StrictMock;
@@ -43,12 +48,17 @@ using ::webrtc::MockTransport;
 using ::webrtc::NtpTime;
 using ::webrtc::RtcpTransceiverConfig;
 using ::webrtc::RtcpTransceiverImpl;
+using ::webrtc::RtpStreamRtcpHandler;
 using ::webrtc::SaturatedUsToCompactNtp;
 using ::webrtc::TaskQueueForTest;
 using ::webrtc::TimeMicrosToNtp;
 using ::webrtc::VideoBitrateAllocation;
 using ::webrtc::rtcp::Bye;
 using ::webrtc::rtcp::CompoundPacket;
+using ::webrtc::rtcp::Fir;
+using ::webrtc::rtcp::Nack;
+using ::webrtc::rtcp::Pli;
+using ::webrtc::rtcp::ReceiverReport;
 using ::webrtc::rtcp::ReportBlock;
 using ::webrtc::rtcp::SenderReport;
 using ::webrtc::test::RtcpPacketParser;
@@ -68,6 +78,21 @@ class MockMediaReceiverRtcpObserver : public webrtc::MediaReceiverRtcpObserver {
               (override));
 };
 
+class MockRtpStreamRtcpHandler : public RtpStreamRtcpHandler {
+ public:
+  MOCK_METHOD(RtpStats, SentStats, (), (override));
+  MOCK_METHOD(void,
+              OnNack,
+              (uint32_t, rtc::ArrayView<const uint16_t>),
+              (override));
+  MOCK_METHOD(void, OnFir, (uint32_t), (override));
+  MOCK_METHOD(void, OnPli, (uint32_t), (override));
+  MOCK_METHOD(void,
+              OnReportBlock,
+              (uint32_t, const ReportBlock&),
+              (override));
+};
+
 // Since some tests will need to wait for this period, make it small to avoid
 // slowing tests too much. As long as there are test bots with high scheduler
 // granularity, small period should be ok.
@@ -1041,4 +1066,113 @@ TEST(RtcpTransceiverImplTest, IgnoresUnknownSsrcInDlrr) {
   rtcp_transceiver.ReceivePacket(raw_packet, time_us + 100000);
 }
 
+TEST(RtcpTransceiverImplTest, SendsSenderReportsForLocalSenders) {
+  const uint32_t kFeedbackSsrc = 1234;
+  const uint32_t kSenderSsrc1 = 2345;
+  const uint32_t kSenderSsrc2 = 3456;
+  const uint32_t kIdleSenderSsrc = 4567;
+  const uint32_t kMediaSsrc = 5678;
+  rtc::ScopedFakeClock clock;
+  clock.AdvanceTime(webrtc::TimeDelta::Seconds(1));
+  MockReceiveStatisticsProvider receive_statistics;
+  std::vector<ReportBlock> report_blocks(1);
+  report_blocks[0].SetMediaSsrc(kMediaSsrc);
+  EXPECT_CALL(receive_statistics, RtcpReportBlocks(_))
+      .WillRepeatedly(Return(report_blocks));
+  RtpStreamRtcpHandler::RtpStats stats;
+  stats.num_sent_packets = 10;
+  stats.num_sent_bytes = 1000;
+  stats.last_rtp_timestamp = 1000;
+  stats.last_capture_time_us = rtc::TimeMicros() - 10000;
+  stats.last_clock_rate_hz = 90000;
+  MockRtpStreamRtcpHandler sender1;
+  MockRtpStreamRtcpHandler sender2;
+  MockRtpStreamRtcpHandler idle_sender;
+  EXPECT_CALL(sender1, SentStats()).WillRepeatedly(Return(stats));
+  EXPECT_CALL(sender2, SentStats()).WillRepeatedly(Return(stats));
+  EXPECT_CALL(idle_sender, SentStats())
+      .WillRepeatedly(Return(RtpStreamRtcpHandler::RtpStats()));
+
+  RtcpTransceiverConfig config;
+  config.feedback_ssrc = kFeedbackSsrc;
+  config.cname = "cname";
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  config.receive_statistics = &receive_statistics;
+  config.schedule_periodic_compound_packets = false;
+  config.non_sender_rtt_measurement = true;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  EXPECT_TRUE(rtcp_transceiver.AddMediaSender(kSenderSsrc2, &sender2));
+  EXPECT_TRUE(rtcp_transceiver.AddMediaSender(kSenderSsrc1, &sender1));
+  EXPECT_TRUE(rtcp_transceiver.AddMediaSender(kIdleSenderSsrc, &idle_sender));
+  EXPECT_FALSE(rtcp_transceiver.AddMediaSender(kSenderSsrc1, &sender2));
+
+  rtcp_transceiver.SendCompoundPacket();
+
+  // Both reports go into one compound packet, which starts with the report
+  // of the lowest ssrc. Only that one carries the report blocks.
+  EXPECT_EQ(transport.num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 0);
+  EXPECT_EQ(rtcp_parser.sender_report()->num_packets(), 2);
+  EXPECT_EQ(rtcp_parser.sender_report()->sender_ssrc(), kSenderSsrc2);
+  EXPECT_THAT(rtcp_parser.sender_report()->report_blocks(), SizeIs(0));
+  EXPECT_EQ(rtcp_parser.sender_report()->rtp_timestamp(), 1000u + 900u);
+  EXPECT_EQ(rtcp_parser.sender_report()->sender_packet_count(), 10u);
+  EXPECT_EQ(rtcp_parser.sender_report()->sender_octet_count(), 1000u);
+  EXPECT_EQ(rtcp_parser.sdes()->chunks().size(), 4u);
+  // Rrtr is only sent by non-senders.
+  EXPECT_EQ(rtcp_parser.xr()->num_packets(), 0);
+
+  EXPECT_TRUE(rtcp_transceiver.RemoveMediaSender(kSenderSsrc2));
+  EXPECT_FALSE(rtcp_transceiver.RemoveMediaSender(kSenderSsrc2));
+  rtcp_transceiver.SendCompoundPacket();
+  EXPECT_EQ(rtcp_parser.sender_report()->num_packets(), 3);
+  EXPECT_EQ(rtcp_parser.sender_report()->sender_ssrc(), kSenderSsrc1);
+  ASSERT_THAT(rtcp_parser.sender_report()->report_blocks(), SizeIs(1));
+  EXPECT_EQ(rtcp_parser.sender_report()->report_blocks()[0].source_ssrc(),
+            kMediaSsrc);
+}
+
+TEST(RtcpTransceiverImplTest, CallsMediaSenderOnFeedbackForItsSsrc) {
+  const uint32_t kRemoteSsrc = 1234;
+  const uint32_t kSenderSsrc1 = 2345;
+  const uint32_t kSenderSsrc2 = 3456;
+  StrictMock<MockRtpStreamRtcpHandler> sender1;
+  StrictMock<MockRtpStreamRtcpHandler> sender2;
+  RtcpTransceiverImpl rtcp_transceiver(DefaultTestConfig());
+  rtcp_transceiver.AddMediaSender(kSenderSsrc1, &sender1);
+  rtcp_transceiver.AddMediaSender(kSenderSsrc2, &sender2);
+
+  CompoundPacket compound;
+  auto rr = std::make_unique<ReceiverReport>();
+  rr->SetSenderSsrc(kRemoteSsrc);
+  ReportBlock report_block;
+  report_block.SetMediaSsrc(kSenderSsrc1);
+  rr->AddReportBlock(report_block);
+  compound.Append(rr.release());
+  auto nack = std::make_unique<Nack>();
+  nack->SetSenderSsrc(kRemoteSsrc);
+  nack->SetMediaSsrc(kSenderSsrc2);
+  nack->SetPacketIds({1, 2, 5});
+  compound.Append(nack.release());
+  auto pli = std::make_unique<Pli>();
+  pli->SetSenderSsrc(kRemoteSsrc);
+  pli->SetMediaSsrc(kSenderSsrc1);
+  compound.Append(pli.release());
+  auto fir = std::make_unique<Fir>();
+  fir->SetSenderSsrc(kRemoteSsrc);
+  fir->AddRequestTo(kSenderSsrc2, /*seq_num=*/1);
+  compound.Append(fir.release());
+  auto raw_packet = compound.Build();
+
+  EXPECT_CALL(sender1, OnReportBlock(kRemoteSsrc,
+                                     Property(&ReportBlock::source_ssrc,
+                                              kSenderSsrc1)));
+  EXPECT_CALL(sender2, OnNack(kRemoteSsrc, ElementsAre(1, 2, 5)));
+  EXPECT_CALL(sender1, OnPli(kRemoteSsrc));
+  EXPECT_CALL(sender2, OnFir(kRemoteSsrc));
+  rtcp_transceiver.ReceivePacket(raw_packet, /*now_us=*/0);
+}
+
 }  // namespace
@@ -14,7 +14,7 @@
 #include <vector>
 
 #include "api/transport/rtp/dependency_descriptor.h"
-#include "rtc_base/bit_buffer.h"
+#include "rtc_base/bitstream_reader.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -30,7 +30,7 @@ RtpDependencyDescriptorReader::RtpDependencyDescriptorReader(
     rtc::ArrayView<const uint8_t> raw_data,
     const FrameDependencyStructure* structure,
     DependencyDescriptor* descriptor)
-    : descriptor_(descriptor), buffer_(raw_data.data(), raw_data.size()) {
+    : descriptor_(descriptor), buffer_(raw_data) {
   RTC_DCHECK(descriptor);
 
   ReadMandatoryFields();
@@ -40,10 +40,12 @@ RtpDependencyDescriptorReader::RtpDependencyDescriptorReader(
   structure_ = descriptor->attached_structure
                    ? descriptor->attached_structure.get()
                    : structure;
-  if (structure_ == nullptr || parsing_failed_) {
-    parsing_failed_ = true;
+  if (structure_ == nullptr) {
+    buffer_.Invalidate();
     return;
   }
+  if (!buffer_.Ok())
+    return;
   if (active_decode_targets_present_flag_) {
     descriptor->active_decode_targets_bitmask =
         ReadBits(structure_->num_decode_targets);
@@ -52,20 +54,6 @@ RtpDependencyDescriptorReader::RtpDependencyDescriptorReader(
   ReadFrameDependencyDefinition();
 }
 
-uint32_t RtpDependencyDescriptorReader::ReadBits(size_t bit_count) {
-  uint32_t value = 0;
-  if (!buffer_.ReadBits(&value, bit_count))
-    parsing_failed_ = true;
-  return value;
-}
-
-uint32_t RtpDependencyDescriptorReader::ReadNonSymmetric(size_t num_values) {
-  uint32_t value = 0;
-  if (!buffer_.ReadNonSymmetric(&value, num_values))
-    parsing_failed_ = true;
-  return value;
-}
-
 void RtpDependencyDescriptorReader::ReadTemplateDependencyStructure() {
   descriptor_->attached_structure =
       std::make_unique<FrameDependencyStructure>();
@@ -96,7 +84,7 @@ void RtpDependencyDescriptorReader::ReadTemplateLayers() {
   NextLayerIdc next_layer_idc;
   do {
     if (templates.size() == kMaxTemplates) {
-      parsing_failed_ = true;
+      buffer_.Invalidate();
       break;
     }
     templates.emplace_back();
@@ -108,18 +96,18 @@ void RtpDependencyDescriptorReader::ReadTemplateLayers() {
     if (next_layer_idc == kNextTemporalLayer) {
       temporal_id++;
       if (temporal_id > kMaxTemporalId) {
-        parsing_failed_ = true;
+        buffer_.Invalidate();
         break;
       }
     } else if (next_layer_idc == kNextSpatialLayer) {
       temporal_id = 0;
       spatial_id++;
       if (spatial_id > kMaxSpatialId) {
-        parsing_failed_ = true;
+        buffer_.Invalidate();
         break;
       }
     }
-  } while (next_layer_idc != kNoMoreTemplates && !parsing_failed_);
+  } while (next_layer_idc != kNoMoreTemplates && buffer_.Ok());
 
   descriptor_->attached_structure->templates = std::move(templates);
 }
@@ -203,7 +191,7 @@ void RtpDependencyDescriptorReader::ReadFrameDependencyDefinition() {
                           kMaxTemplates;
 
   if (template_index >= structure_->templates.size()) {
-    parsing_failed_ = true;
+    buffer_.Invalidate();
     return;
   }
 
@@ -16,7 +16,7 @@
 
 #include "api/array_view.h"
 #include "api/transport/rtp/dependency_descriptor.h"
-#include "rtc_base/bit_buffer.h"
+#include "rtc_base/bitstream_reader.h"
 
 namespace webrtc {
 // Deserializes DependencyDescriptor rtp header extension.
@@ -31,13 +31,17 @@ class RtpDependencyDescriptorReader {
       const RtpDependencyDescriptorReader&) = delete;
 
   // Returns true if parse was successful.
-  bool ParseSuccessful() { return !parsing_failed_; }
+  bool ParseSuccessful() { return buffer_.Ok(); }
 
  private:
   // Reads bits from |buffer_|. If it fails, returns 0 and marks parsing as
   // failed, but doesn't stop the parsing.
-  uint32_t ReadBits(size_t bit_count);
-  uint32_t ReadNonSymmetric(size_t num_values);
+  uint32_t ReadBits(int bit_count) {
+    return static_cast<uint32_t>(buffer_.ReadBits(bit_count));
+  }
+  uint32_t ReadNonSymmetric(uint32_t num_values) {
+    return buffer_.ReadNonSymmetric(num_values);
+  }
 
   // Functions to read template dependency structure.
   void ReadTemplateDependencyStructure();
@@ -57,11 +61,10 @@ class RtpDependencyDescriptorReader {
   void ReadFrameChains();
 
   // Output.
-  bool parsing_failed_ = false;
   DependencyDescriptor* const descriptor_;
   // Values that are needed while reading the descriptor, but can be discarded
-  // when reading is complete.
-  rtc::BitBuffer buffer_;
+  // when reading is complete. Parsing failed if |buffer_| is no longer ok.
+  rtc::BitstreamReader buffer_;
   int frame_dependency_template_id_ = 0;
   bool active_decode_targets_present_flag_ = false;
   bool custom_dtis_flag_ = false;
@@ -17,7 +17,9 @@
 #include "modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "modules/rtp_rtcp/source/forward_error_correction.h"
 #include "modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -1125,4 +1127,63 @@ TYPED_TEST(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(this->IsRecoveryComplete());
 }
 
+// Measures the throughput of FEC encoding and of recovering one lost media
+// packet, for a range of mask sizes. Both are dominated by XORing payloads.
+TYPED_TEST(RtpFecTest, DISABLED_XorThroughput) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr uint8_t kProtectionFactor = 255;
+  constexpr int kNumIterations = 2000;
+
+  for (int num_media_packets : {4, 12, 24, 48}) {
+    this->media_packets_ =
+        this->media_packet_generator_.ConstructMediaPackets(num_media_packets);
+    size_t media_bytes = 0;
+    for (const auto& packet : this->media_packets_)
+      media_bytes += packet->data.size();
+
+    int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumIterations; ++i) {
+      this->generated_fec_packets_.clear();
+      ASSERT_EQ(0, this->fec_.EncodeFec(
+                       this->media_packets_, kProtectionFactor,
+                       kNumImportantPackets, kUseUnequalProtection,
+                       kFecMaskBursty, &this->generated_fec_packets_));
+    }
+    const int64_t encode_us = rtc::TimeMicros() - start_us;
+
+    // Decoding modifies the received packets, so each iteration gets its own.
+    memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+    memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+    this->media_loss_mask_[0] = 1;
+    std::vector<std::vector<
+        std::unique_ptr<ForwardErrorCorrection::ReceivedPacket>>>
+        received_packets(kNumIterations);
+    for (auto& packets : received_packets) {
+      this->NetworkReceivedPackets(this->media_loss_mask_,
+                                   this->fec_loss_mask_);
+      packets = std::move(this->received_packets_);
+    }
+
+    start_us = rtc::TimeMicros();
+    for (const auto& packets : received_packets) {
+      this->fec_.ResetState(&this->recovered_packets_);
+      for (const auto& received_packet : packets)
+        this->fec_.DecodeFec(*received_packet, &this->recovered_packets_);
+    }
+    const int64_t decode_us = rtc::TimeMicros() - start_us;
+    EXPECT_TRUE(this->IsRecoveryComplete());
+
+    const double media_mbytes =
+        static_cast<double>(media_bytes) * kNumIterations / 1e6;
+    RTC_LOG(LS_INFO) << num_media_packets << " media packets, "
+                     << this->generated_fec_packets_.size()
+                     << " FEC packets: encode "
+                     << media_mbytes / (encode_us / 1e6) << " MB/s, recover "
+                     << media_mbytes / (decode_us / 1e6) << " MB/s";
+    this->fec_.ResetState(&this->recovered_packets_);
+    this->generated_fec_packets_.clear();
+  }
+}
+
 }  // namespace webrtc
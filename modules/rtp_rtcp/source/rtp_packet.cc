@@ -68,10 +68,19 @@ RtpPacket::RtpPacket(const ExtensionManager* extensions, size_t capacity)
   Clear();
 }
 
+RtpPacket::RtpPacket(const ExtensionManager* extensions,
+                     rtc::CopyOnWriteBuffer buffer)
+    : extensions_(extensions ? *extensions : ExtensionManager()),
+      buffer_(std::move(buffer)) {
+  RTC_DCHECK_GE(capacity(), kFixedHeaderSize);
+  Clear();
+}
+
 RtpPacket::~RtpPacket() {}
 
 void RtpPacket::IdentifyExtensions(const ExtensionManager& extensions) {
   extensions_ = extensions;
+  ReindexExtensionEntries();
 }
 
 bool RtpPacket::Parse(const uint8_t* buffer, size_t buffer_size) {
@@ -99,6 +108,12 @@ bool RtpPacket::Parse(rtc::CopyOnWriteBuffer buffer) {
   return true;
 }
 
+void RtpPacket::MoveToBuffer(rtc::CopyOnWriteBuffer buffer) {
+  RTC_DCHECK_EQ(buffer.capacity(), capacity());
+  buffer.SetData(data(), size());
+  buffer_ = std::move(buffer);
+}
+
 std::vector<uint32_t> RtpPacket::Csrcs() const {
   size_t num_csrc = data()[0] & 0x0F;
   RTC_DCHECK_GE(capacity(), kFixedHeaderSize + num_csrc * 4);
@@ -121,6 +136,8 @@ void RtpPacket::CopyHeaderFrom(const RtpPacket& packet) {
   payload_offset_ = packet.payload_offset_;
   extensions_ = packet.extensions_;
   extension_entries_ = packet.extension_entries_;
+  memcpy(entry_index_by_type_, packet.entry_index_by_type_,
+         sizeof(entry_index_by_type_));
   extensions_size_ = packet.extensions_size_;
   buffer_ = packet.buffer_.Slice(0, packet.headers_size());
   // Reset payload and padding.
@@ -325,6 +342,7 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
   const uint8_t extension_info_length = rtc::dchecked_cast<uint8_t>(length);
   extension_entries_.emplace_back(id, extension_info_length,
                                   extension_info_offset);
+  IndexLastExtensionEntry();
 
   extensions_size_ = new_extensions_size;
 
@@ -437,6 +455,7 @@ void RtpPacket::Clear() {
   padding_size_ = 0;
   extensions_size_ = 0;
   extension_entries_.clear();
+  memset(entry_index_by_type_, 0, sizeof(entry_index_by_type_));
 
   memset(WriteAt(0), 0, kFixedHeaderSize);
   buffer_.SetSize(kFixedHeaderSize);
@@ -477,6 +496,7 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
 
   extensions_size_ = 0;
   extension_entries_.clear();
+  memset(entry_index_by_type_, 0, sizeof(entry_index_by_type_));
   if (has_extension) {
     /* RTP header extension, RFC 3550.
      0                   1                   2                   3
@@ -577,22 +597,41 @@ RtpPacket::ExtensionInfo& RtpPacket::FindOrCreateExtensionInfo(int id) {
     }
   }
   extension_entries_.emplace_back(id);
+  IndexLastExtensionEntry();
   return extension_entries_.back();
 }
 
+void RtpPacket::IndexLastExtensionEntry() {
+  RTC_DCHECK(!extension_entries_.empty());
+  RTPExtensionType type = extensions_.GetType(extension_entries_.back().id);
+  if (type == ExtensionManager::kInvalidType) {
+    return;
+  }
+  // Each id appears at most once, and there are at most 255 distinct ids.
+  entry_index_by_type_[type] =
+      rtc::dchecked_cast<uint8_t>(extension_entries_.size());
+}
+
+void RtpPacket::ReindexExtensionEntries() {
+  memset(entry_index_by_type_, 0, sizeof(entry_index_by_type_));
+  for (size_t i = 0; i < extension_entries_.size(); ++i) {
+    RTPExtensionType type = extensions_.GetType(extension_entries_[i].id);
+    if (type != ExtensionManager::kInvalidType) {
+      entry_index_by_type_[type] = rtc::dchecked_cast<uint8_t>(i + 1);
+    }
+  }
+}
+
 rtc::ArrayView<const uint8_t> RtpPacket::FindExtension(
     ExtensionType type) const {
-  uint8_t id = extensions_.GetId(type);
-  if (id == ExtensionManager::kInvalidId) {
-    // Extension not registered.
-    return nullptr;
-  }
-  ExtensionInfo const* extension_info = FindExtensionInfo(id);
-  if (extension_info == nullptr) {
+  uint8_t index = entry_index_by_type_[type];
+  if (index == 0) {
+    // Extension not registered or not present.
     return nullptr;
   }
-  return rtc::MakeArrayView(data() + extension_info->offset,
-                            extension_info->length);
+  const ExtensionInfo& extension_info = extension_entries_[index - 1];
+  return rtc::MakeArrayView(data() + extension_info.offset,
+                            extension_info.length);
 }
 
 rtc::ArrayView<uint8_t> RtpPacket::AllocateExtension(ExtensionType type,
@@ -617,12 +656,7 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateExtension(ExtensionType type,
 }
 
 bool RtpPacket::HasExtension(ExtensionType type) const {
-  uint8_t id = extensions_.GetId(type);
-  if (id == ExtensionManager::kInvalidId) {
-    // Extension not registered.
-    return false;
-  }
-  return FindExtensionInfo(id) != nullptr;
+  return entry_index_by_type_[type] != 0;
 }
 
 bool RtpPacket::RemoveExtension(ExtensionType type) {
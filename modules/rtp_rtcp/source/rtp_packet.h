@@ -34,6 +34,9 @@ class RtpPacket {
   explicit RtpPacket(const ExtensionManager* extensions);
   RtpPacket(const RtpPacket&);
   RtpPacket(const ExtensionManager* extensions, size_t capacity);
+  // Uses |buffer| as storage, e.g. to draw packets from a buffer pool. The
+  // capacity of |buffer| becomes the capacity of the packet.
+  RtpPacket(const ExtensionManager* extensions, rtc::CopyOnWriteBuffer buffer);
   ~RtpPacket();
 
   RtpPacket& operator=(const RtpPacket&) = default;
@@ -48,6 +51,11 @@ class RtpPacket {
   // Parse and move given buffer into Packet.
   bool Parse(rtc::CopyOnWriteBuffer packet);
 
+  // Copies the packet into |buffer| and uses it as storage from now on, e.g.
+  // to move a copied packet into pooled storage instead of having the first
+  // write allocate. |buffer| must have the same capacity as the packet.
+  void MoveToBuffer(rtc::CopyOnWriteBuffer buffer);
+
   // Maps extensions id to their types.
   void IdentifyExtensions(const ExtensionManager& extensions);
 
@@ -168,6 +176,13 @@ class RtpPacket {
   // with the specified id if not found.
   ExtensionInfo& FindOrCreateExtensionInfo(int id);
 
+  // Records the type the last entry in |extension_entries_| is registered as,
+  // so that typed lookups don't have to scan the entries.
+  void IndexLastExtensionEntry();
+  // Rebuilds |entry_index_by_type_| from scratch, e.g. after the extension
+  // map changed.
+  void ReindexExtensionEntries();
+
   // Allocates and returns place to store rtp header extension.
   // Returns empty arrayview on failure.
   rtc::ArrayView<uint8_t> AllocateRawExtension(int id, size_t length);
@@ -194,6 +209,10 @@ class RtpPacket {
 
   ExtensionManager extensions_;
   std::vector<ExtensionInfo> extension_entries_;
+  // One plus the index into |extension_entries_| of the extension of each
+  // type, or 0 if the packet doesn't have it. Filled while parsing, so reading
+  // an extension by type is a single table lookup.
+  uint8_t entry_index_by_type_[kRtpExtensionNumberOfExtensions];
   size_t extensions_size_ = 0;  // Unaligned.
   rtc::CopyOnWriteBuffer buffer_;
 };
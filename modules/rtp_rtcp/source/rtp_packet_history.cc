@@ -22,6 +22,10 @@
 #include "system_wrappers/include/clock.h"
 
 namespace webrtc {
+namespace {
+// The ring never shrinks below this many slots once it has been allocated.
+constexpr size_t kMinRingCapacity = 64;
+}  // namespace
 
 constexpr size_t RtpPacketHistory::kMaxCapacity;
 constexpr size_t RtpPacketHistory::kMaxPaddingtHistory;
@@ -52,32 +56,110 @@ RtpPacketHistory::StoredPacket& RtpPacketHistory::StoredPacket::operator=(
 RtpPacketHistory::StoredPacket::~StoredPacket() = default;
 
 void RtpPacketHistory::StoredPacket::IncrementTimesRetransmitted(
-    PacketPrioritySet* priority_set) {
-  // Check if this StoredPacket is in the priority set. If so, we need to remove
-  // it before updating |times_retransmitted_| since that is used in sorting,
-  // and then add it back.
-  const bool in_priority_set = priority_set && priority_set->erase(this) > 0;
+    PaddingPriorityIndex* priority_index) {
+  // Check if this StoredPacket is in the priority index. If so, we need to
+  // remove it before updating |times_retransmitted_| since that is used in
+  // sorting, and then add it back.
+  const bool in_priority_index =
+      priority_index && priority_index->Remove(*this);
   ++times_retransmitted_;
-  if (in_priority_set) {
-    auto it = priority_set->insert(this);
-    RTC_DCHECK(it.second)
-        << "ERROR: Priority set already contains matching packet! In set: "
-           "insert order = "
-        << (*it.first)->insert_order_
-        << ", times retransmitted = " << (*it.first)->times_retransmitted_
-        << ". Trying to add: insert order = " << insert_order_
-        << ", times retransmitted = " << times_retransmitted_;
+  if (in_priority_index) {
+    priority_index->Insert(*this);
   }
 }
 
-bool RtpPacketHistory::MoreUseful::operator()(StoredPacket* lhs,
-                                              StoredPacket* rhs) const {
+RtpPacketHistory::StoredPacketRing::StoredPacketRing() = default;
+RtpPacketHistory::StoredPacketRing::~StoredPacketRing() = default;
+
+void RtpPacketHistory::StoredPacketRing::push_front(StoredPacket packet) {
+  if (size_ == slots_.size()) {
+    Resize(std::max(kMinRingCapacity, 2 * slots_.size()));
+  }
+  head_ = (head_ - 1) & (slots_.size() - 1);
+  ++size_;
+  front() = std::move(packet);
+}
+
+void RtpPacketHistory::StoredPacketRing::push_back(StoredPacket packet) {
+  if (size_ == slots_.size()) {
+    Resize(std::max(kMinRingCapacity, 2 * slots_.size()));
+  }
+  ++size_;
+  (*this)[size_ - 1] = std::move(packet);
+}
+
+void RtpPacketHistory::StoredPacketRing::pop_front() {
+  RTC_DCHECK(!empty());
+  // Release the packet now rather than when the slot is reused.
+  front().packet_.reset();
+  head_ = (head_ + 1) & (slots_.size() - 1);
+  --size_;
+  // Give back memory once a burst has been culled, e.g. when a stream goes
+  // idle. Shrinking to half at a quarter full leaves room to grow again
+  // without resizing back and forth.
+  if (slots_.size() > kMinRingCapacity && size_ <= slots_.size() / 4) {
+    Resize(slots_.size() / 2);
+  }
+}
+
+void RtpPacketHistory::StoredPacketRing::clear() {
+  slots_.clear();
+  slots_.shrink_to_fit();
+  head_ = 0;
+  size_ = 0;
+}
+
+void RtpPacketHistory::StoredPacketRing::Resize(size_t new_capacity) {
+  RTC_DCHECK_GE(new_capacity, size_);
+  std::vector<StoredPacket> slots;
+  slots.reserve(new_capacity);
+  for (size_t i = 0; i < size_; ++i) {
+    slots.push_back(std::move((*this)[i]));
+  }
+  while (slots.size() < new_capacity) {
+    slots.emplace_back(nullptr, absl::nullopt, 0);
+  }
+  slots_.swap(slots);
+  head_ = 0;
+}
+
+RtpPacketHistory::PaddingPriorityIndex::PaddingPriorityIndex() = default;
+RtpPacketHistory::PaddingPriorityIndex::~PaddingPriorityIndex() = default;
+
+bool RtpPacketHistory::PaddingPriorityIndex::MoreUseful(const Entry& lhs,
+                                                        const Entry& rhs) {
   // Prefer to send packets we haven't already sent as padding.
-  if (lhs->times_retransmitted() != rhs->times_retransmitted()) {
-    return lhs->times_retransmitted() < rhs->times_retransmitted();
+  if (lhs.times_retransmitted != rhs.times_retransmitted) {
+    return lhs.times_retransmitted < rhs.times_retransmitted;
   }
   // All else being equal, prefer newer packets.
-  return lhs->insert_order() > rhs->insert_order();
+  return lhs.insert_order > rhs.insert_order;
+}
+
+void RtpPacketHistory::PaddingPriorityIndex::Insert(
+    const StoredPacket& packet) {
+  RTC_DCHECK(packet.packet_);
+  if (entries_.size() >= kMaxPaddingtHistory - 1) {
+    entries_.pop_back();
+  }
+  const Entry entry{packet.times_retransmitted(), packet.insert_order(),
+                    packet.packet_->SequenceNumber()};
+  entries_.insert(
+      std::upper_bound(entries_.begin(), entries_.end(), entry, &MoreUseful),
+      entry);
+}
+
+bool RtpPacketHistory::PaddingPriorityIndex::Remove(
+    const StoredPacket& packet) {
+  auto it = std::find_if(entries_.begin(), entries_.end(),
+                         [&packet](const Entry& entry) {
+                           return entry.insert_order == packet.insert_order();
+                         });
+  if (it == entries_.end()) {
+    return false;
+  }
+  entries_.erase(it);
+  return true;
 }
 
 RtpPacketHistory::RtpPacketHistory(Clock* clock, bool enable_padding_prio)
@@ -145,11 +227,11 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
 
   // Packet to be inserted ahead of first packet, expand front.
   for (; packet_index < 0; ++packet_index) {
-    packet_history_.emplace_front(nullptr, absl::nullopt, 0);
+    packet_history_.push_front(StoredPacket(nullptr, absl::nullopt, 0));
   }
   // Packet to be inserted behind last packet, expand back.
   while (static_cast<int>(packet_history_.size()) <= packet_index) {
-    packet_history_.emplace_back(nullptr, absl::nullopt, 0);
+    packet_history_.push_back(StoredPacket(nullptr, absl::nullopt, 0));
   }
 
   RTC_DCHECK_GE(packet_index, 0);
@@ -160,11 +242,7 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
       StoredPacket(std::move(packet), send_time_ms, packets_inserted_++);
 
   if (enable_padding_prio_) {
-    if (padding_priority_.size() >= kMaxPaddingtHistory - 1) {
-      padding_priority_.erase(std::prev(padding_priority_.end()));
-    }
-    auto prio_it = padding_priority_.insert(&packet_history_[packet_index]);
-    RTC_DCHECK(prio_it.second) << "Failed to insert packet into prio set.";
+    padding_priority_.Insert(packet_history_[packet_index]);
   }
 }
 
@@ -318,14 +396,13 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPayloadPaddingPacket(
 
   StoredPacket* best_packet = nullptr;
   if (enable_padding_prio_ && !padding_priority_.empty()) {
-    auto best_packet_it = padding_priority_.begin();
-    best_packet = *best_packet_it;
+    best_packet = GetStoredPacket(padding_priority_.best());
+    RTC_DCHECK(best_packet);
   } else if (!enable_padding_prio_ && !packet_history_.empty()) {
     // Prioritization not available, pick the last packet.
-    for (auto it = packet_history_.rbegin(); it != packet_history_.rend();
-         ++it) {
-      if (it->packet_ != nullptr) {
-        best_packet = &(*it);
+    for (size_t i = packet_history_.size(); i > 0; --i) {
+      if (packet_history_[i - 1].packet_ != nullptr) {
+        best_packet = &packet_history_[i - 1];
         break;
       }
     }
@@ -431,15 +508,15 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
 
 std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
     int packet_index) {
+  // Erase from padding priority index, if eligible.
+  if (enable_padding_prio_ && packet_history_[packet_index].packet_) {
+    padding_priority_.Remove(packet_history_[packet_index]);
+  }
+
   // Move the packet out from the StoredPacket container.
   std::unique_ptr<RtpPacketToSend> rtp_packet =
       std::move(packet_history_[packet_index].packet_);
 
-  // Erase from padding priority set, if eligible.
-  if (enable_padding_prio_) {
-    padding_priority_.erase(&packet_history_[packet_index]);
-  }
-
   if (packet_index == 0) {
     while (!packet_history_.empty() &&
            packet_history_.front().packet_ == nullptr) {
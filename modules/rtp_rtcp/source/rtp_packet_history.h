@@ -11,10 +11,8 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 #define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 
-#include <deque>
 #include <map>
 #include <memory>
-#include <set>
 #include <vector>
 
 #include "api/function_view.h"
@@ -136,9 +134,7 @@ class RtpPacketHistory {
   void Clear();
 
  private:
-  struct MoreUseful;
-  class StoredPacket;
-  using PacketPrioritySet = std::set<StoredPacket*, MoreUseful>;
+  class PaddingPriorityIndex;
 
   class StoredPacket {
    public:
@@ -151,7 +147,7 @@ class RtpPacketHistory {
 
     uint64_t insert_order() const { return insert_order_; }
     size_t times_retransmitted() const { return times_retransmitted_; }
-    void IncrementTimesRetransmitted(PacketPrioritySet* priority_set);
+    void IncrementTimesRetransmitted(PaddingPriorityIndex* priority_index);
 
     // The time of last transmission, including retransmissions.
     absl::optional<int64_t> send_time_ms_;
@@ -170,8 +166,69 @@ class RtpPacketHistory {
     // Number of times RE-transmitted, ie excluding the first transmission.
     size_t times_retransmitted_;
   };
-  struct MoreUseful {
-    bool operator()(StoredPacket* lhs, StoredPacket* rhs) const;
+
+  // Ring buffer with the subset of the std::deque interface used by the
+  // history. Storage is contiguous and only grows, so a history that has
+  // reached its steady state size stores packets without allocating.
+  class StoredPacketRing {
+   public:
+    StoredPacketRing();
+    ~StoredPacketRing();
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    StoredPacket& operator[](size_t index) {
+      return slots_[(head_ + index) & (slots_.size() - 1)];
+    }
+    const StoredPacket& operator[](size_t index) const {
+      return slots_[(head_ + index) & (slots_.size() - 1)];
+    }
+    StoredPacket& front() { return (*this)[0]; }
+    const StoredPacket& front() const { return (*this)[0]; }
+
+    void push_front(StoredPacket packet);
+    void push_back(StoredPacket packet);
+    void pop_front();
+    void clear();
+
+   private:
+    // Moves the stored packets to a ring of |new_capacity| slots.
+    void Resize(size_t new_capacity);
+
+    // Size is zero or a power of two.
+    std::vector<StoredPacket> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+  };
+
+  // The packets most likely to be useful as padding, best first: fewest
+  // retransmissions, then newest. Holds at most kMaxPaddingtHistory - 1
+  // entries in a flat sorted array; at that size shifting a few entries is
+  // cheaper than allocating tree nodes.
+  class PaddingPriorityIndex {
+   public:
+    PaddingPriorityIndex();
+    ~PaddingPriorityIndex();
+
+    bool empty() const { return entries_.empty(); }
+    // Sequence number of the most useful packet. Must not be empty.
+    uint16_t best() const { return entries_.front().sequence_number; }
+
+    // Adds |packet|, dropping the least useful entry if the index is full.
+    void Insert(const StoredPacket& packet);
+    // Returns true if |packet| was in the index.
+    bool Remove(const StoredPacket& packet);
+    void clear() { entries_.clear(); }
+
+   private:
+    struct Entry {
+      size_t times_retransmitted;
+      uint64_t insert_order;
+      uint16_t sequence_number;
+    };
+    static bool MoreUseful(const Entry& lhs, const Entry& rhs);
+
+    std::vector<Entry> entries_;
   };
 
   // Helper method used by GetPacketAndSetSendTime() and GetPacketState() to
@@ -193,7 +250,7 @@ class RtpPacketHistory {
 
   Clock* const clock_;
   const bool enable_padding_prio_;
-  rtc::CriticalSection lock_;
+  rtc::CriticalSection lock_{"RtpPacketHistory"};
   size_t number_to_store_ RTC_GUARDED_BY(lock_);
   StorageMode mode_ RTC_GUARDED_BY(lock_);
   int64_t rtt_ms_ RTC_GUARDED_BY(lock_);
@@ -204,13 +261,13 @@ class RtpPacketHistory {
   // Packets may also be removed out-of-order, in which case there will be
   // instances of StoredPacket with |packet_| set to nullptr. The first and last
   // entry in the queue will however always be populated.
-  std::deque<StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
+  StoredPacketRing packet_history_ RTC_GUARDED_BY(lock_);
 
   // Total number of packets with inserted.
   uint64_t packets_inserted_ RTC_GUARDED_BY(lock_);
-  // Objects from |packet_history_| ordered by "most likely to be useful", used
+  // Packets from |packet_history_| ordered by "most likely to be useful", used
   // in GetPayloadPaddingPacket().
-  PacketPrioritySet padding_priority_ RTC_GUARDED_BY(lock_);
+  PaddingPriorityIndex padding_priority_ RTC_GUARDED_BY(lock_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtpPacketHistory);
 };
@@ -15,6 +15,8 @@
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -835,6 +837,35 @@ TEST_P(RtpPacketHistoryTest, UsesLastPacketAsPaddingWithPrioOff) {
   EXPECT_EQ(hist_.GetPayloadPaddingPacket(), nullptr);
 }
 
+// Measures PutRtpPacket() and GetPacketAndMarkAsPending() throughput with a
+// history sized for high RTT NACK. Disabled since it only logs the result.
+TEST_P(RtpPacketHistoryTest, DISABLED_PutAndRetransmitThroughput) {
+  constexpr size_t kHistorySize = RtpPacketHistory::kMaxCapacity / 2;
+  constexpr int kNumPackets = 1000000;
+  constexpr int kRetransmitDistance = 500;
+  hist_.SetStorePacketsStatus(StorageMode::kStoreAndCull, kHistorySize);
+  hist_.SetRtt(1);
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + i)),
+                       fake_clock_.TimeInMilliseconds());
+    if (i >= kRetransmitDistance) {
+      uint16_t nacked = To16u(kStartSeqNum + i - kRetransmitDistance);
+      if (hist_.GetPacketAndMarkAsPending(nacked)) {
+        hist_.MarkPacketAsSent(nacked);
+      }
+    }
+    if (i % 10 == 0) {
+      hist_.GetPayloadPaddingPacket();
+    }
+    fake_clock_.AdvanceTimeMilliseconds(1);
+  }
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  RTC_LOG(LS_INFO) << (GetParam() ? "With" : "Without") << " padding prio: "
+                   << kNumPackets * 1000000LL / elapsed_us << " packets/s";
+}
+
 INSTANTIATE_TEST_SUITE_P(WithAndWithoutPaddingPrio,
                          RtpPacketHistoryTest,
                          ::testing::Bool());
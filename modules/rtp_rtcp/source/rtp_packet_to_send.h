@@ -21,6 +21,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "modules/rtp_rtcp/source/rtp_packet.h"
+#include "rtc_base/copy_on_write_buffer.h"
 
 namespace webrtc {
 // Class to hold rtp packet with metadata for sender side.
@@ -31,6 +32,8 @@ class RtpPacketToSend : public RtpPacket {
 
   explicit RtpPacketToSend(const ExtensionManager* extensions);
   RtpPacketToSend(const ExtensionManager* extensions, size_t capacity);
+  RtpPacketToSend(const ExtensionManager* extensions,
+                  rtc::CopyOnWriteBuffer buffer);
   RtpPacketToSend(const RtpPacketToSend& packet);
   RtpPacketToSend(RtpPacketToSend&& packet);
 
@@ -108,6 +111,14 @@ class RtpPacketToSend : public RtpPacket {
   void set_is_key_frame(bool is_key_frame) { is_key_frame_ = is_key_frame; }
   bool is_key_frame() const { return is_key_frame_; }
 
+  // Indicates that no other frame depends on the video frame of this packet,
+  // i.e. the decode target indications of its dependency descriptor are all
+  // discardable or not present. Such packets may be dropped by the pacer.
+  void set_is_discardable(bool is_discardable) {
+    is_discardable_ = is_discardable;
+  }
+  bool is_discardable() const { return is_discardable_; }
+
  private:
   int64_t capture_time_ms_ = 0;
   absl::optional<RtpPacketMediaType> packet_type_;
@@ -116,6 +127,7 @@ class RtpPacketToSend : public RtpPacket {
   std::vector<uint8_t> application_data_;
   bool is_first_packet_of_frame_ = false;
   bool is_key_frame_ = false;
+  bool is_discardable_ = false;
 };
 
 }  // namespace webrtc
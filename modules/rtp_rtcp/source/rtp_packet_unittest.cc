@@ -7,6 +7,8 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <utility>
+
 #include "common_video/test/utilities.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
@@ -211,6 +213,42 @@ TEST(RtpPacketTest, CreateMinimum) {
   EXPECT_THAT(kMinimumPacket, ElementsAreArray(packet.data(), packet.size()));
 }
 
+TEST(RtpPacketTest, CreateInProvidedBuffer) {
+  rtc::CopyOnWriteBuffer buffer(0, 200);
+  const uint8_t* storage = buffer.cdata();
+  RtpPacketToSend packet(nullptr, std::move(buffer));
+  packet.SetPayloadType(kPayloadType);
+  packet.SetSequenceNumber(kSeqNum);
+  packet.SetTimestamp(kTimestamp);
+  packet.SetSsrc(kSsrc);
+  EXPECT_EQ(packet.capacity(), 200u);
+  EXPECT_EQ(packet.data(), storage);
+  EXPECT_THAT(kMinimumPacket, ElementsAreArray(packet.data(), packet.size()));
+}
+
+TEST(RtpPacketTest, MoveToBufferKeepsContent) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
+  RtpPacketToSend original(&extensions);
+  original.SetPayloadType(kPayloadType);
+  original.SetSequenceNumber(kSeqNum);
+  original.SetTimestamp(kTimestamp);
+  original.SetSsrc(kSsrc);
+  original.SetExtension<TransmissionOffset>(kTimeOffset);
+
+  RtpPacketToSend copy(original);
+  rtc::CopyOnWriteBuffer buffer(0, original.capacity());
+  const uint8_t* storage = buffer.cdata();
+  copy.MoveToBuffer(std::move(buffer));
+
+  EXPECT_EQ(copy.data(), storage);
+  EXPECT_NE(copy.data(), original.data());
+  EXPECT_THAT(kPacketWithTO, ElementsAreArray(copy.data(), copy.size()));
+  int32_t time_offset;
+  EXPECT_TRUE(copy.GetExtension<TransmissionOffset>(&time_offset));
+  EXPECT_EQ(time_offset, kTimeOffset);
+}
+
 TEST(RtpPacketTest, CreateWithExtension) {
   RtpPacketToSend::ExtensionManager extensions;
   extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
@@ -700,6 +738,40 @@ TEST(RtpPacketTest, ParseWithExtensionDelayed) {
   EXPECT_EQ(0u, packet.padding_size());
 }
 
+TEST(RtpPacketTest, IdentifyExtensionsOfParsedPacketRemapsExtensionIds) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
+  extensions.Register<AudioLevel>(kAudioLevelExtensionId);
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)));
+  EXPECT_TRUE(packet.HasExtension<TransmissionOffset>());
+  EXPECT_TRUE(packet.HasExtension<AudioLevel>());
+
+  // Register only the audio level, and under the transmission offset's id.
+  RtpPacketToSend::ExtensionManager remapped_extensions;
+  remapped_extensions.Register<AudioLevel>(kTransmissionOffsetExtensionId);
+  packet.IdentifyExtensions(remapped_extensions);
+  EXPECT_FALSE(packet.HasExtension<TransmissionOffset>());
+  EXPECT_THAT(packet.GetRawExtension<AudioLevel>(),
+              ElementsAre(0x00, 0x56, 0xce));
+}
+
+TEST(RtpPacketTest, CopyHeaderFromKeepsExtensions) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
+  extensions.Register<AudioLevel>(kAudioLevelExtensionId);
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)));
+
+  RtpPacketToSend copy(nullptr);
+  copy.CopyHeaderFrom(packet);
+  EXPECT_EQ(copy.GetExtension<TransmissionOffset>(), kTimeOffset);
+  bool voice_active;
+  uint8_t audio_level;
+  EXPECT_TRUE(copy.GetExtension<AudioLevel>(&voice_active, &audio_level));
+  EXPECT_EQ(kAudioLevel, audio_level);
+}
+
 TEST(RtpPacketTest, ParseDynamicSizeExtension) {
   // clang-format off
   const uint8_t kPacket1[] = {
@@ -73,7 +73,7 @@ class Av1Frame {
   using value_type = uint8_t;
   using const_iterator = const uint8_t*;
 
-  explicit Av1Frame(rtc::scoped_refptr<EncodedImageBuffer> frame)
+  explicit Av1Frame(rtc::scoped_refptr<EncodedImageBufferInterface> frame)
       : frame_(std::move(frame)) {}
 
   const_iterator begin() const { return frame_ ? frame_->data() : nullptr; }
@@ -82,7 +82,7 @@ class Av1Frame {
   }
 
  private:
-  rtc::scoped_refptr<EncodedImageBuffer> frame_;
+  rtc::scoped_refptr<EncodedImageBufferInterface> frame_;
 };
 
 std::vector<RtpPayload> Packetize(
@@ -0,0 +1,323 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Microbenchmarks for the per-packet RTP/RTCP code paths. Each result is the
+// time in ms to run the operation 1000 times, so that the numbers don't
+// depend on whether WebRTC-QuickPerfTest is enabled.
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/function_view.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "api/video/video_frame_type.h"
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "modules/include/module_common_types.h"
+#include "modules/pacing/round_robin_packet_queue.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/fec_test_helper.h"
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "modules/rtp_rtcp/source/rtp_format.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_video_header.h"
+#include "modules/video_coding/codecs/h264/include/h264_globals.h"
+#include "modules/video_coding/codecs/vp8/include/vp8_globals.h"
+#include "modules/video_coding/codecs/vp9/include/vp9_globals.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+using test::ImproveDirection;
+
+constexpr uint32_t kSsrc = 0x12345678;
+constexpr int kPayloadType = 96;
+constexpr size_t kPacketPayloadSize = 1100;
+constexpr size_t kFrameSize = 10000;
+constexpr int kTransmissionOffsetId = 1;
+constexpr int kAbsoluteSendTimeId = 2;
+constexpr int kTransportSequenceNumberId = 3;
+constexpr int kMidId = 4;
+
+int Iterations(int full_iterations) {
+  return field_trial::IsEnabled("WebRTC-QuickPerfTest") ? full_iterations / 100
+                                                        : full_iterations;
+}
+
+// Runs |operation| |iterations| times and reports the time per 1000 runs.
+void MeasureAndReport(const std::string& measurement,
+                      const std::string& user_story,
+                      int iterations,
+                      rtc::FunctionView<void()> operation) {
+  const int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < iterations; ++i)
+    operation();
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  test::PrintResult(measurement, "", user_story,
+                    static_cast<double>(elapsed_us) / iterations, "ms",
+                    /*important=*/false, ImproveDirection::kSmallerIsBetter);
+}
+
+RtpHeaderExtensionMap MakeExtensionMap() {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransmissionOffset>(kTransmissionOffsetId);
+  extensions.Register<AbsoluteSendTime>(kAbsoluteSendTimeId);
+  extensions.Register<TransportSequenceNumber>(kTransportSequenceNumberId);
+  extensions.Register<RtpMid>(kMidId);
+  return extensions;
+}
+
+std::unique_ptr<RtpPacketToSend> CreatePacket(uint32_t ssrc,
+                                              uint16_t sequence_number) {
+  auto packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+  packet->set_packet_type(RtpPacketMediaType::kVideo);
+  packet->SetPayloadType(kPayloadType);
+  packet->SetSsrc(ssrc);
+  packet->SetSequenceNumber(sequence_number);
+  packet->SetTimestamp(sequence_number * 3000);
+  packet->SetPayloadSize(kPacketPayloadSize);
+  packet->set_allow_retransmission(true);
+  return packet;
+}
+
+// Creates a frame that each of the video packetizers accepts: a single H264
+// NAL unit, or a single AV1 OBU with a size field.
+std::vector<uint8_t> CreateFrame(VideoCodecType codec_type) {
+  std::vector<uint8_t> frame(kFrameSize, 0x55);
+  if (codec_type == kVideoCodecH264) {
+    frame[0] = 0x65;  // IDR slice.
+  } else if (codec_type == kVideoCodecAV1) {
+    const size_t obu_payload_size = kFrameSize - 3;
+    frame[0] = 0b0'0110'010;  // OBU_FRAME, has_size_field.
+    frame[1] = 0x80 | (obu_payload_size & 0x7f);
+    frame[2] = obu_payload_size >> 7;
+  }
+  return frame;
+}
+
+void PacketizeFrame(VideoCodecType codec_type, const std::string& user_story) {
+  const std::vector<uint8_t> frame = CreateFrame(codec_type);
+  RTPVideoHeader video_header;
+  video_header.frame_type = VideoFrameType::kVideoFrameDelta;
+  RTPFragmentationHeader fragmentation;
+  switch (codec_type) {
+    case kVideoCodecVP8: {
+      auto& vp8 = video_header.video_type_header.emplace<RTPVideoHeaderVP8>();
+      vp8.InitRTPVideoHeaderVP8();
+      vp8.pictureId = 17;
+      break;
+    }
+    case kVideoCodecVP9: {
+      auto& vp9 = video_header.video_type_header.emplace<RTPVideoHeaderVP9>();
+      vp9.InitRTPVideoHeaderVP9();
+      vp9.picture_id = 17;
+      break;
+    }
+    case kVideoCodecH264: {
+      auto& h264 = video_header.video_type_header.emplace<RTPVideoHeaderH264>();
+      h264.packetization_mode = H264PacketizationMode::NonInterleaved;
+      fragmentation.VerifyAndAllocateFragmentationHeader(1);
+      fragmentation.fragmentationOffset[0] = 0;
+      fragmentation.fragmentationLength[0] = frame.size();
+      break;
+    }
+    default:
+      break;
+  }
+
+  RtpPacketToSend packet(/*extensions=*/nullptr);
+  MeasureAndReport("rtp_packetizer", user_story, Iterations(20000), [&] {
+    std::unique_ptr<RtpPacketizer> packetizer =
+        RtpPacketizer::Create(codec_type, frame, {}, video_header,
+                              &fragmentation);
+    while (packetizer->NextPacket(&packet)) {
+    }
+  });
+}
+
+class CountingSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override { ++packets_; }
+  int packets() const { return packets_; }
+
+ private:
+  int packets_ = 0;
+};
+
+}  // namespace
+
+TEST(RtpRtcpPerformanceTest, ParseRtpPacket) {
+  const RtpHeaderExtensionMap extensions = MakeExtensionMap();
+  RtpPacketToSend packet(&extensions);
+  packet.SetPayloadType(kPayloadType);
+  packet.SetSsrc(kSsrc);
+  packet.SetSequenceNumber(1);
+  packet.SetExtension<TransmissionOffset>(90);
+  packet.SetExtension<AbsoluteSendTime>(0x123456);
+  packet.SetExtension<TransportSequenceNumber>(12);
+  packet.SetExtension<RtpMid>("video");
+  packet.SetPayloadSize(kPacketPayloadSize);
+  const rtc::CopyOnWriteBuffer buffer = packet.Buffer();
+
+  RtpPacketReceived received(&extensions);
+  MeasureAndReport("rtp_packet_parse", "with_extensions", Iterations(1000000),
+                   [&] {
+                     EXPECT_TRUE(received.Parse(buffer));
+                     uint16_t transport_sequence_number;
+                     received.GetExtension<TransportSequenceNumber>(
+                         &transport_sequence_number);
+                   });
+}
+
+TEST(RtpRtcpPerformanceTest, PacketizeVp8) {
+  PacketizeFrame(kVideoCodecVP8, "vp8");
+}
+
+TEST(RtpRtcpPerformanceTest, PacketizeVp9) {
+  PacketizeFrame(kVideoCodecVP9, "vp9");
+}
+
+TEST(RtpRtcpPerformanceTest, PacketizeH264) {
+  PacketizeFrame(kVideoCodecH264, "h264");
+}
+
+TEST(RtpRtcpPerformanceTest, PacketizeAv1) {
+  PacketizeFrame(kVideoCodecAV1, "av1");
+}
+
+TEST(RtpRtcpPerformanceTest, EncodeUlpfec) {
+  constexpr int kNumMediaPackets = 10;
+  constexpr uint8_t kProtectionFactor = 85;  // One third overhead.
+  Random random(0x7654321);
+  test::fec::MediaPacketGenerator generator(200, kPacketPayloadSize, kSsrc,
+                                            &random);
+  const ForwardErrorCorrection::PacketList media_packets =
+      generator.ConstructMediaPackets(kNumMediaPackets);
+  std::unique_ptr<ForwardErrorCorrection> fec =
+      ForwardErrorCorrection::CreateUlpfec(kSsrc);
+
+  MeasureAndReport("fec_encode", "ulpfec_10_packets", Iterations(100000), [&] {
+    std::list<ForwardErrorCorrection::Packet*> fec_packets;
+    EXPECT_EQ(0, fec->EncodeFec(media_packets, kProtectionFactor,
+                                /*num_important_packets=*/0,
+                                /*use_unequal_protection=*/false,
+                                kFecMaskBursty, &fec_packets));
+  });
+}
+
+TEST(RtpRtcpPerformanceTest, StoreAndRetransmitFromPacketHistory) {
+  constexpr size_t kHistorySize = 600;
+  constexpr uint16_t kRetransmissionDistance = 50;
+  SimulatedClock clock(1000000);
+  RtpPacketHistory history(&clock, /*enable_padding_prio=*/true);
+  history.SetStorePacketsStatus(RtpPacketHistory::StorageMode::kStoreAndCull,
+                                kHistorySize);
+  uint16_t sequence_number = 0;
+  for (; sequence_number < kRetransmissionDistance; ++sequence_number) {
+    history.PutRtpPacket(CreatePacket(kSsrc, sequence_number),
+                         clock.TimeInMilliseconds());
+  }
+
+  MeasureAndReport(
+      "rtp_packet_history", "put_and_retransmit", Iterations(200000), [&] {
+        clock.AdvanceTimeMicroseconds(500);
+        history.PutRtpPacket(CreatePacket(kSsrc, sequence_number),
+                             clock.TimeInMilliseconds());
+        const uint16_t lost_sequence_number =
+            sequence_number - kRetransmissionDistance;
+        EXPECT_TRUE(history.GetPacketAndMarkAsPending(lost_sequence_number));
+        history.MarkPacketAsSent(lost_sequence_number);
+        ++sequence_number;
+      });
+}
+
+TEST(RtpRtcpPerformanceTest, PushAndPopRoundRobinPacketQueue) {
+  constexpr int kNumStreams = 4;
+  constexpr int kPacketsPerStream = 50;
+  Timestamp now = Timestamp::Millis(1000);
+  RoundRobinPacketQueue queue(now, /*field_trials=*/nullptr);
+  uint64_t enqueue_order = 0;
+  for (int i = 0; i < kNumStreams * kPacketsPerStream; ++i) {
+    queue.Push(/*priority=*/2, now, enqueue_order++,
+               CreatePacket(kSsrc + i % kNumStreams, i));
+  }
+
+  MeasureAndReport("round_robin_packet_queue", "push_and_pop",
+                   Iterations(1000000), [&] {
+                     now += TimeDelta::Micros(100);
+                     std::unique_ptr<RtpPacketToSend> packet = queue.Pop();
+                     queue.Push(/*priority=*/2, now, enqueue_order++,
+                                std::move(packet));
+                   });
+}
+
+TEST(RtpRtcpPerformanceTest, BuildAndParseTransportFeedback) {
+  constexpr int kNumPackets = 100;
+  constexpr int64_t kBaseTimeUs = 1000000;
+  rtcp::TransportFeedback feedback;
+  feedback.SetBase(/*base_sequence=*/1000, kBaseTimeUs);
+  for (int i = 0; i < kNumPackets; ++i) {
+    // Every 10th packet is lost.
+    if (i % 10 != 9) {
+      feedback.AddReceivedPacket(1000 + i, kBaseTimeUs + i * 1200);
+    }
+  }
+  const rtc::Buffer serialized = feedback.Build();
+
+  MeasureAndReport("transport_feedback", "build_100_packets",
+                   Iterations(200000), [&] { feedback.Build(); });
+  MeasureAndReport("transport_feedback", "parse_100_packets",
+                   Iterations(200000), [&] {
+                     EXPECT_TRUE(rtcp::TransportFeedback::ParseFrom(
+                         serialized.data(), serialized.size()));
+                   });
+}
+
+TEST(RtpRtcpPerformanceTest, DemuxRtpPackets) {
+  constexpr int kNumStreams = 8;
+  RtpDemuxer demuxer;
+  CountingSink sinks[kNumStreams];
+  std::vector<RtpPacketReceived> packets;
+  for (int i = 0; i < kNumStreams; ++i) {
+    EXPECT_TRUE(demuxer.AddSink(kSsrc + i, &sinks[i]));
+    RtpPacketReceived packet;
+    packet.SetPayloadType(kPayloadType);
+    packet.SetSsrc(kSsrc + i);
+    packet.SetSequenceNumber(i);
+    packets.push_back(packet);
+  }
+
+  int index = 0;
+  MeasureAndReport("rtp_demuxer", "8_ssrcs", Iterations(1000000), [&] {
+    EXPECT_TRUE(demuxer.OnRtpPacket(packets[index]));
+    index = (index + 1) % kNumStreams;
+  });
+  EXPECT_GT(sinks[0].packets(), 0);
+  for (const CountingSink& sink : sinks)
+    demuxer.RemoveSink(&sink);
+}
+
+}  // namespace webrtc
@@ -446,8 +446,9 @@ std::vector<std::unique_ptr<RtpPacketToSend>> RTPSender::GeneratePadding(
   }
 
   while (bytes_left > 0) {
-    auto padding_packet =
-        std::make_unique<RtpPacketToSend>(&rtp_header_extension_map_);
+    auto padding_packet = std::make_unique<RtpPacketToSend>(
+        &rtp_header_extension_map_,
+        packet_buffer_pool_.Create(0, IP_PACKET_SIZE));
     padding_packet->set_packet_type(RtpPacketMediaType::kPadding);
     padding_packet->SetMarker(false);
     padding_packet->SetTimestamp(last_rtp_timestamp_);
@@ -573,7 +574,8 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   // it is better than crash on drop packet without trying to send it.
   static constexpr int kExtraCapacity = 16;
   auto packet = std::make_unique<RtpPacketToSend>(
-      &rtp_header_extension_map_, max_packet_size_ + kExtraCapacity);
+      &rtp_header_extension_map_,
+      packet_buffer_pool_.Create(0, max_packet_size_ + kExtraCapacity));
   packet->SetSsrc(ssrc_);
   packet->SetCsrcs(csrcs_);
   // Reserve extensions, if registered, RtpSender set in SendToNetwork.
@@ -605,6 +607,13 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   return packet;
 }
 
+std::unique_ptr<RtpPacketToSend> RTPSender::CopyPacket(
+    const RtpPacketToSend& packet) const {
+  auto copy = std::make_unique<RtpPacketToSend>(packet);
+  copy->MoveToBuffer(packet_buffer_pool_.Create(0, packet.capacity()));
+  return copy;
+}
+
 bool RTPSender::AssignSequenceNumber(RtpPacketToSend* packet) {
   rtc::CritScope lock(&send_critsect_);
   if (!sending_media_)
@@ -759,8 +768,9 @@ std::unique_ptr<RtpPacketToSend> RTPSender::BuildRtxPacket(
     if (kv == rtx_payload_type_map_.end())
       return nullptr;
 
-    rtx_packet = std::make_unique<RtpPacketToSend>(&rtp_header_extension_map_,
-                                                   max_packet_size_);
+    rtx_packet = std::make_unique<RtpPacketToSend>(
+        &rtp_header_extension_map_,
+        packet_buffer_pool_.Create(0, max_packet_size_));
 
     rtx_packet->SetPayloadType(kv->second);
 
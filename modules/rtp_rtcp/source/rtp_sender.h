@@ -30,6 +30,7 @@
 #include "modules/rtp_rtcp/source/rtp_packet_history.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "rtc_base/constructor_magic.h"
+#include "rtc_base/copy_on_write_buffer_pool.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/deprecation.h"
 #include "rtc_base/random.h"
@@ -132,6 +133,9 @@ class RTPSender {
   // extensions RtpSender updates before sending.
   std::unique_ptr<RtpPacketToSend> AllocatePacket() const
       RTC_LOCKS_EXCLUDED(send_critsect_);
+  // Returns a copy of |packet| backed by a buffer from the packet pool.
+  std::unique_ptr<RtpPacketToSend> CopyPacket(
+      const RtpPacketToSend& packet) const;
   // Allocate sequence number for provided packet.
   // Save packet's fields to generate padding that doesn't break media stream.
   // Return false if sending was turned off.
@@ -173,6 +177,11 @@ class RTPSender {
 
   int64_t LastTimestampTimeMs() const RTC_LOCKS_EXCLUDED(send_critsect_);
 
+  // Hit rate of the pool backing the packets created by this sender.
+  rtc::CopyOnWriteBufferPool::Stats GetPacketBufferPoolStats() const {
+    return packet_buffer_pool_.GetStats();
+  }
+
  private:
   std::unique_ptr<RtpPacketToSend> BuildRtxPacket(
       const RtpPacketToSend& packet);
@@ -196,7 +205,11 @@ class RTPSender {
   RtpPacketHistory* const packet_history_;
   RtpPacketSender* const paced_sender_;
 
-  rtc::CriticalSection send_critsect_;
+  rtc::CriticalSection send_critsect_{"RTPSender"};
+
+  // Recycles packet buffers once the packets have been sent and dropped from
+  // the packet history, wherever that happens. Thread safe.
+  mutable rtc::CopyOnWriteBufferPool packet_buffer_pool_;
 
   bool sending_media_ RTC_GUARDED_BY(send_critsect_);
   size_t max_packet_size_;
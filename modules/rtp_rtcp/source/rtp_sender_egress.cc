@@ -19,6 +19,7 @@
 #include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/rate_statistics.h"
 
 namespace webrtc {
 namespace {
@@ -27,6 +28,15 @@ constexpr int kSendSideDelayWindowMs = 1000;
 constexpr int kBitrateStatisticsWindowMs = 1000;
 constexpr size_t kRtpSequenceNumberMapMaxEntries = 1 << 13;
 
+std::vector<std::unique_ptr<ConcurrentRateStatistics>> CreateSendRates() {
+  std::vector<std::unique_ptr<ConcurrentRateStatistics>> send_rates;
+  for (size_t i = 0; i < kNumMediaTypes; ++i) {
+    send_rates.push_back(std::make_unique<ConcurrentRateStatistics>(
+        kBitrateStatisticsWindowMs, RateStatistics::kBpsScale));
+  }
+  return send_rates;
+}
+
 bool IsEnabled(absl::string_view name,
                const WebRtcKeyValueConfig* field_trials) {
   FieldTrialBasedConfig default_trials;
@@ -79,8 +89,7 @@ RtpSenderEgress::RtpSenderEgress(const RtpRtcp::Configuration& config,
       max_delay_it_(send_delays_.end()),
       sum_delays_ms_(0),
       total_packet_send_delay_ms_(0),
-      send_rates_(kNumMediaTypes,
-                  {kBitrateStatisticsWindowMs, RateStatistics::kBpsScale}),
+      send_rates_(CreateSendRates()),
       rtp_sequence_number_map_(need_rtp_packet_infos_
                                    ? std::make_unique<RtpSequenceNumberMap>(
                                          kRtpSequenceNumberMapMaxEntries)
@@ -205,25 +214,19 @@ void RtpSenderEgress::ProcessBitrateAndNotifyObservers() {
   if (!bitrate_callback_)
     return;
 
-  rtc::CritScope lock(&lock_);
-  RtpSendRates send_rates = GetSendRatesLocked();
+  RtpSendRates send_rates = GetSendRates();
   bitrate_callback_->Notify(
       send_rates.Sum().bps(),
       send_rates[RtpPacketMediaType::kRetransmission].bps(), ssrc_);
 }
 
 RtpSendRates RtpSenderEgress::GetSendRates() const {
-  rtc::CritScope lock(&lock_);
-  return GetSendRatesLocked();
-}
-
-RtpSendRates RtpSenderEgress::GetSendRatesLocked() const {
   const int64_t now_ms = clock_->TimeInMilliseconds();
   RtpSendRates current_rates;
   for (size_t i = 0; i < kNumMediaTypes; ++i) {
     RtpPacketMediaType type = static_cast<RtpPacketMediaType>(i);
     current_rates[type] =
-        DataRate::BitsPerSec(send_rates_[i].Rate(now_ms).value_or(0));
+        DataRate::BitsPerSec(send_rates_[i]->Rate(now_ms).value_or(0));
   }
   return current_rates;
 }
@@ -454,8 +457,8 @@ void RtpSenderEgress::UpdateRtpStats(const RtpPacketToSend& packet) {
   counters->transmitted.AddPacket(packet);
 
   RTC_DCHECK(packet.packet_type().has_value());
-  send_rates_[static_cast<size_t>(*packet.packet_type())].Update(packet.size(),
-                                                                 now_ms);
+  send_rates_[static_cast<size_t>(*packet.packet_type())]->Update(packet.size(),
+                                                                  now_ms);
 
   if (rtp_stats_callback_) {
     rtp_stats_callback_->DataCountersUpdated(*counters, packet.Ssrc());
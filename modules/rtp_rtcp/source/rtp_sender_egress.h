@@ -24,8 +24,8 @@
 #include "modules/rtp_rtcp/source/rtp_packet_history.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "modules/rtp_rtcp/source/rtp_sequence_number_map.h"
+#include "rtc_base/concurrent_rate_statistics.h"
 #include "rtc_base/critical_section.h"
-#include "rtc_base/rate_statistics.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -58,7 +58,7 @@ class RtpSenderEgress {
   absl::optional<uint32_t> FlexFecSsrc() const { return flexfec_ssrc_; }
 
   void ProcessBitrateAndNotifyObservers() RTC_LOCKS_EXCLUDED(lock_);
-  RtpSendRates GetSendRates() const RTC_LOCKS_EXCLUDED(lock_);
+  RtpSendRates GetSendRates() const;
   void GetDataCounters(StreamDataCounters* rtp_stats,
                        StreamDataCounters* rtx_stats) const
       RTC_LOCKS_EXCLUDED(lock_);
@@ -84,7 +84,6 @@ class RtpSenderEgress {
   // time.
   typedef std::map<int64_t, int> SendDelayMap;
 
-  RtpSendRates GetSendRatesLocked() const RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   bool HasCorrectSsrc(const RtpPacketToSend& packet) const;
   void AddPacketToTransportFeedback(uint16_t packet_id,
                                     const RtpPacketToSend& packet,
@@ -134,7 +133,8 @@ class RtpSenderEgress {
   StreamDataCounters rtp_stats_ RTC_GUARDED_BY(lock_);
   StreamDataCounters rtx_rtp_stats_ RTC_GUARDED_BY(lock_);
   // One element per value in RtpPacketMediaType, with index matching value.
-  std::vector<RateStatistics> send_rates_ RTC_GUARDED_BY(lock_);
+  // Updated under |lock_|, but can be read without it.
+  const std::vector<std::unique_ptr<ConcurrentRateStatistics>> send_rates_;
 
   // Maps sent packets' sequence numbers to a tuple consisting of:
   // 1. The timestamp, without the randomizing offset mandated by the RFC.
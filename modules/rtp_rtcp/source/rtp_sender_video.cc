@@ -23,6 +23,8 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/match.h"
 #include "api/crypto/frame_encryptor_interface.h"
+#include "api/task_queue/default_task_queue_factory.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "api/transport/rtp/dependency_descriptor.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -45,16 +47,19 @@ namespace {
 constexpr size_t kRedForFecHeaderLength = 1;
 constexpr int64_t kMaxUnretransmittableFrameIntervalMs = 33 * 4;
 
-void BuildRedPayload(const RtpPacketToSend& media_packet,
-                     RtpPacketToSend* red_packet) {
-  uint8_t* red_payload = red_packet->AllocatePayload(
-      kRedForFecHeaderLength + media_packet.payload_size());
+// Encapsulates the payload of |packet| in RED, without copying the packet. If
+// the buffer is shared, e.g. with the FEC generator, it is copied once on
+// write.
+void ConvertToRedPacket(int red_payload_type, RtpPacketToSend* packet) {
+  const uint8_t media_payload_type = packet->PayloadType();
+  const size_t media_payload_size = packet->payload_size();
+  uint8_t* red_payload =
+      packet->SetPayloadSize(kRedForFecHeaderLength + media_payload_size);
   RTC_DCHECK(red_payload);
-  red_payload[0] = media_packet.PayloadType();
-
-  auto media_payload = media_packet.payload();
-  memcpy(&red_payload[kRedForFecHeaderLength], media_payload.data(),
-         media_payload.size());
+  memmove(&red_payload[kRedForFecHeaderLength], red_payload,
+          media_payload_size);
+  red_payload[0] = media_payload_type;
+  packet->SetPayloadType(red_payload_type);
 }
 
 bool MinimizeDescriptor(RTPVideoHeader* video_header) {
@@ -71,6 +76,15 @@ bool MinimizeDescriptor(RTPVideoHeader* video_header) {
   return false;
 }
 
+// Returns true if no decode target depends on the frame.
+bool IsDiscardable(rtc::ArrayView<const DecodeTargetIndication> indications) {
+  return !indications.empty() &&
+         absl::c_all_of(indications, [](DecodeTargetIndication indication) {
+           return indication == DecodeTargetIndication::kDiscardable ||
+                  indication == DecodeTargetIndication::kNotPresent;
+         });
+}
+
 bool IsBaseLayer(const RTPVideoHeader& video_header) {
   switch (video_header.codec) {
     case kVideoCodecVP8: {
@@ -130,6 +144,7 @@ RTPSenderVideo::RTPSenderVideo(const Config& config)
       fec_generator_(config.fec_generator),
       fec_type_(config.fec_type),
       fec_overhead_bytes_(config.fec_overhead_bytes),
+      key_frame_cache_size_(config.key_frame_cache_size),
       video_bitrate_(1000, RateStatistics::kBpsScale),
       packetization_overhead_bitrate_(1000, RateStatistics::kBpsScale),
       frame_encryptor_(config.frame_encryptor),
@@ -149,6 +164,14 @@ RTPSenderVideo::RTPSenderVideo(const Config& config)
               : nullptr) {
   if (frame_transformer_delegate_)
     frame_transformer_delegate_->Init();
+  if (fec_generator_ &&
+      absl::StartsWith(
+          config.field_trials->Lookup("WebRTC-AsyncFecGeneration"),
+          "Enabled")) {
+    fec_queue_ = std::make_unique<rtc::TaskQueue>(
+        CreateDefaultTaskQueueFactory()->CreateTaskQueue(
+            "RtpSenderVideoFec", TaskQueueFactory::Priority::NORMAL));
+  }
 }
 
 RTPSenderVideo::~RTPSenderVideo() {
@@ -194,6 +217,25 @@ void RTPSenderVideo::LogAndSendToNetwork(
   rtp_sender_->EnqueuePackets(std::move(packets));
 }
 
+void RTPSenderVideo::GenerateAndSendFec(
+    std::vector<std::unique_ptr<RtpPacketToSend>> media_packets) {
+  RTC_DCHECK_RUN_ON(fec_queue_.get());
+  for (const auto& packet : media_packets) {
+    fec_generator_->AddPacketAndGenerateFec(*packet);
+  }
+  std::vector<std::unique_ptr<RtpPacketToSend>> fec_packets =
+      fec_generator_->GetFecPackets();
+  if (fec_packets.empty()) {
+    return;
+  }
+  if (!fec_generator_->FecSsrc()) {
+    for (auto& fec_packet : fec_packets) {
+      rtp_sender_->AssignSequenceNumber(fec_packet.get());
+    }
+  }
+  rtp_sender_->EnqueuePackets(std::move(fec_packets));
+}
+
 size_t RTPSenderVideo::FecPacketOverhead() const {
   size_t overhead = fec_overhead_bytes_;
   if (red_enabled()) {
@@ -352,6 +394,10 @@ void RTPSenderVideo::AddRtpHeaderExtensions(
       }
       extension_is_set = packet->SetExtension<RtpDependencyDescriptorExtension>(
           *video_structure_, descriptor);
+      if (extension_is_set) {
+        packet->set_is_discardable(IsDiscardable(
+            descriptor.frame_dependencies.decode_target_indications));
+      }
 
       // Remove the temporary shared ownership.
       descriptor.attached_structure.release();
@@ -410,6 +456,12 @@ bool RTPSenderVideo::SendVideo(
   if (payload.empty())
     return false;
 
+  const bool key_frame =
+      video_header.frame_type == VideoFrameType::kVideoFrameKey;
+  if (key_frame_cache_size_ > 0 && !key_frame) {
+    MaybeResendCachedKeyFrame();
+  }
+
   int32_t retransmission_settings = retransmission_settings_;
   if (codec_type == VideoCodecType::kVideoCodecH264) {
     // Backward compatibility for older receivers without temporal layer logic.
@@ -443,9 +495,9 @@ bool RTPSenderVideo::SendVideo(
           Int64MsToUQ32x32(single_packet->capture_time_ms() + NtpOffsetMs()),
           /*estimated_capture_clock_offset=*/absl::nullopt);
 
-  auto first_packet = std::make_unique<RtpPacketToSend>(*single_packet);
-  auto middle_packet = std::make_unique<RtpPacketToSend>(*single_packet);
-  auto last_packet = std::make_unique<RtpPacketToSend>(*single_packet);
+  auto first_packet = rtp_sender_->CopyPacket(*single_packet);
+  auto middle_packet = rtp_sender_->CopyPacket(*single_packet);
+  auto last_packet = rtp_sender_->CopyPacket(*single_packet);
   // Simplest way to estimate how much extensions would occupy is to set them.
   AddRtpHeaderExtensions(video_header, absolute_capture_time,
                          /*first_packet=*/true, /*last_packet=*/true,
@@ -489,8 +541,6 @@ bool RTPSenderVideo::SendVideo(
     MinimizeDescriptor(&video_header);
   }
 
-  // TODO(benwright@webrtc.org) - Allocate enough to always encrypt inline.
-  rtc::Buffer encrypted_video_payload;
   if (frame_encryptor_ != nullptr) {
     if (!has_generic_descriptor) {
       return false;
@@ -499,7 +549,9 @@ bool RTPSenderVideo::SendVideo(
     const size_t max_ciphertext_size =
         frame_encryptor_->GetMaxCiphertextByteSize(cricket::MEDIA_TYPE_VIDEO,
                                                    payload.size());
-    encrypted_video_payload.SetSize(max_ciphertext_size);
+    // The buffer is reused from frame to frame, so that its storage only has
+    // to grow when a frame is larger than all the ones before it.
+    encrypted_video_payload_.SetSize(max_ciphertext_size);
 
     size_t bytes_written = 0;
 
@@ -511,12 +563,12 @@ bool RTPSenderVideo::SendVideo(
 
     if (frame_encryptor_->Encrypt(
             cricket::MEDIA_TYPE_VIDEO, first_packet->Ssrc(), additional_data,
-            payload, encrypted_video_payload, &bytes_written) != 0) {
+            payload, encrypted_video_payload_, &bytes_written) != 0) {
       return false;
     }
 
-    encrypted_video_payload.SetSize(bytes_written);
-    payload = encrypted_video_payload;
+    encrypted_video_payload_.SetSize(bytes_written);
+    payload = encrypted_video_payload_;
   } else if (require_frame_encryption_) {
     RTC_LOG(LS_WARNING)
         << "No FrameEncryptor is attached to this video sending stream but "
@@ -551,6 +603,7 @@ bool RTPSenderVideo::SendVideo(
 
   bool first_frame = first_frame_sent_();
   std::vector<std::unique_ptr<RtpPacketToSend>> rtp_packets;
+  std::vector<std::unique_ptr<RtpPacketToSend>> fec_media_packets;
   for (size_t i = 0; i < num_packets; ++i) {
     std::unique_ptr<RtpPacketToSend> packet;
     int expected_payload_capacity;
@@ -568,7 +621,7 @@ bool RTPSenderVideo::SendVideo(
       expected_payload_capacity =
           limits.max_payload_len - limits.last_packet_reduction_len;
     } else {
-      packet = std::make_unique<RtpPacketToSend>(*middle_packet);
+      packet = rtp_sender_->CopyPacket(*middle_packet);
       expected_payload_capacity = limits.max_payload_len;
     }
 
@@ -590,7 +643,11 @@ bool RTPSenderVideo::SendVideo(
     // No FEC protection for upper temporal layers, if used.
     if (fec_type_.has_value() &&
         (temporal_id == 0 || temporal_id == kNoTemporalIdx)) {
-      if (fec_generator_) {
+      if (fec_queue_) {
+        // The copy shares the payload buffer with |packet|.
+        fec_media_packets.push_back(
+            std::make_unique<RtpPacketToSend>(*packet));
+      } else if (fec_generator_) {
         fec_generator_->AddPacketAndGenerateFec(*packet);
       } else {
         // TODO(sprang): When deferred FEC generation is enabled, just mark the
@@ -599,18 +656,11 @@ bool RTPSenderVideo::SendVideo(
     }
 
     if (red_enabled()) {
-      std::unique_ptr<RtpPacketToSend> red_packet(new RtpPacketToSend(*packet));
-      BuildRedPayload(*packet, red_packet.get());
-      red_packet->SetPayloadType(*red_payload_type_);
-
-      // Send |red_packet| instead of |packet| for allocated sequence number.
-      red_packet->set_packet_type(RtpPacketMediaType::kVideo);
-      red_packet->set_allow_retransmission(packet->allow_retransmission());
-      rtp_packets.emplace_back(std::move(red_packet));
-    } else {
-      packet->set_packet_type(RtpPacketMediaType::kVideo);
-      rtp_packets.emplace_back(std::move(packet));
+      // The RED packet keeps the sequence number allocated for |packet|.
+      ConvertToRedPacket(*red_payload_type_, packet.get());
     }
+    packet->set_packet_type(RtpPacketMediaType::kVideo);
+    rtp_packets.emplace_back(std::move(packet));
 
     if (first_frame) {
       if (i == 0) {
@@ -624,7 +674,11 @@ bool RTPSenderVideo::SendVideo(
     }
   }
 
-  if (fec_generator_) {
+  if (key_frame_cache_size_ > 0) {
+    UpdateKeyFrameCache(key_frame, rtp_packets);
+  }
+
+  if (fec_generator_ && !fec_queue_) {
     // Fetch any FEC packets generated from the media frame and add them to
     // the list of packets to send.
     auto fec_packets = fec_generator_->GetFecPackets();
@@ -639,6 +693,15 @@ bool RTPSenderVideo::SendVideo(
 
   LogAndSendToNetwork(std::move(rtp_packets), unpacketized_payload_size);
 
+  if (!fec_media_packets.empty()) {
+    // Protect the frame as a whole once its media packets are in the pacer,
+    // so that they are not delayed by the FEC encoding.
+    fec_queue_->PostTask(
+        [this, media_packets = std::move(fec_media_packets)]() mutable {
+          GenerateAndSendFec(std::move(media_packets));
+        });
+  }
+
   // Update details about the last sent frame.
   last_rotation_ = video_header.rotation;
 
@@ -790,6 +853,67 @@ bool RTPSenderVideo::UpdateConditionalRetransmit(
   return false;
 }
 
+bool RTPSenderVideo::RequestCachedKeyFrame() {
+  rtc::CritScope cs(&crit_);
+  if (key_frame_cache_state_ != KeyFrameCacheState::kCached) {
+    return key_frame_cache_state_ == KeyFrameCacheState::kResendPending;
+  }
+  key_frame_cache_state_ = KeyFrameCacheState::kResendPending;
+  return true;
+}
+
+void RTPSenderVideo::MaybeResendCachedKeyFrame() {
+  {
+    rtc::CritScope cs(&crit_);
+    if (key_frame_cache_state_ != KeyFrameCacheState::kResendPending) {
+      return;
+    }
+    key_frame_cache_state_ = KeyFrameCacheState::kResent;
+  }
+  RTC_LOG(LS_INFO) << "Resending " << key_frame_cache_.size()
+                   << " cached packets of the latest key frame.";
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  packets.reserve(key_frame_cache_.size());
+  for (const auto& cached_packet : key_frame_cache_) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        rtp_sender_->CopyPacket(*cached_packet);
+    if (!rtp_sender_->AssignSequenceNumber(packet.get())) {
+      return;
+    }
+    packets.push_back(std::move(packet));
+  }
+  rtp_sender_->EnqueuePackets(std::move(packets));
+}
+
+void RTPSenderVideo::UpdateKeyFrameCache(
+    bool key_frame,
+    const std::vector<std::unique_ptr<RtpPacketToSend>>& packets) {
+  if (key_frame) {
+    key_frame_cache_.clear();
+  } else if (key_frame_cache_.empty()) {
+    return;
+  }
+  const bool fits =
+      key_frame_cache_.size() + packets.size() <= key_frame_cache_size_;
+  {
+    rtc::CritScope cs(&crit_);
+    if (key_frame) {
+      key_frame_cache_state_ = KeyFrameCacheState::kCached;
+    }
+    if (!fits) {
+      // The frames since the key frame can't all be resent any more.
+      key_frame_cache_state_ = KeyFrameCacheState::kEmpty;
+    }
+  }
+  if (!fits) {
+    key_frame_cache_.clear();
+    return;
+  }
+  for (const auto& packet : packets) {
+    key_frame_cache_.push_back(rtp_sender_->CopyPacket(*packet));
+  }
+}
+
 void RTPSenderVideo::MaybeUpdateCurrentPlayoutDelay(
     const RTPVideoHeader& header) {
   if (IsNoopDelay(header.playout_delay)) {
@@ -32,11 +32,13 @@
 #include "modules/rtp_rtcp/source/rtp_sender_video_frame_transformer_delegate.h"
 #include "modules/rtp_rtcp/source/rtp_video_header.h"
 #include "modules/rtp_rtcp/source/video_fec_generator.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/one_time_event.h"
 #include "rtc_base/race_checker.h"
 #include "rtc_base/rate_statistics.h"
 #include "rtc_base/synchronization/sequence_checker.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -83,6 +85,10 @@ class RTPSenderVideo {
     const WebRtcKeyValueConfig* field_trials = nullptr;
     rtc::scoped_refptr<FrameTransformerInterface> frame_transformer;
     TaskQueueBase* send_transport_queue = nullptr;
+    // If non-zero, the media packets of the latest key frame and the frames
+    // following it are kept, up to this many packets, for
+    // RequestCachedKeyFrame().
+    size_t key_frame_cache_size = 0;
   };
 
   explicit RTPSenderVideo(const Config& config);
@@ -120,6 +126,13 @@ class RTPSenderVideo {
 
   uint32_t VideoBitrateSent() const;
 
+  // Requests that the cached key frame and the frames following it are sent
+  // again, with new sequence numbers, before the next frame. Returns false if
+  // there is nothing to resend, e.g. because caching is disabled, too many
+  // packets have been sent since the latest key frame, or the cached key frame
+  // has been resent already. May be called on any thread.
+  bool RequestCachedKeyFrame();
+
   // Returns the current packetization overhead rate, in bps. Note that this is
   // the payload overhead, eg the VP8 payload headers, not the RTP headers
   // or extension/
@@ -157,6 +170,11 @@ class RTPSenderVideo {
       std::vector<std::unique_ptr<RtpPacketToSend>> packets,
       size_t unpacketized_payload_size);
 
+  // Protects the media packets of a frame and sends the resulting FEC
+  // packets. Runs on |fec_queue_|.
+  void GenerateAndSendFec(
+      std::vector<std::unique_ptr<RtpPacketToSend>> media_packets);
+
   bool red_enabled() const { return red_payload_type_.has_value(); }
 
   bool UpdateConditionalRetransmit(uint8_t temporal_id,
@@ -166,6 +184,14 @@ class RTPSenderVideo {
   void MaybeUpdateCurrentPlayoutDelay(const RTPVideoHeader& header)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(send_checker_);
 
+  // Sends the cached packets again if RequestCachedKeyFrame() has been called.
+  void MaybeResendCachedKeyFrame() RTC_EXCLUSIVE_LOCKS_REQUIRED(send_checker_);
+  // Adds copies of the media packets of a frame to |key_frame_cache_|.
+  void UpdateKeyFrameCache(
+      bool key_frame,
+      const std::vector<std::unique_ptr<RtpPacketToSend>>& packets)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(send_checker_);
+
   RTPSender* const rtp_sender_;
   Clock* const clock_;
 
@@ -179,6 +205,8 @@ class RTPSenderVideo {
   bool transmit_color_space_next_frame_ RTC_GUARDED_BY(send_checker_);
   std::unique_ptr<FrameDependencyStructure> video_structure_
       RTC_GUARDED_BY(send_checker_);
+  // Holds the payload of the frame being sent when it is encrypted.
+  rtc::Buffer encrypted_video_payload_ RTC_GUARDED_BY(send_checker_);
 
   // Current target playout delay.
   PlayoutDelay current_playout_delay_ RTC_GUARDED_BY(send_checker_);
@@ -186,8 +214,16 @@ class RTPSenderVideo {
   // to guarantee it gets delivered.
   bool playout_delay_pending_;
 
+  enum class KeyFrameCacheState { kEmpty, kCached, kResendPending, kResent };
+
   // Should never be held when calling out of this class.
   rtc::CriticalSection crit_;
+  KeyFrameCacheState key_frame_cache_state_ RTC_GUARDED_BY(crit_) =
+      KeyFrameCacheState::kEmpty;
+
+  const size_t key_frame_cache_size_;
+  std::vector<std::unique_ptr<RtpPacketToSend>> key_frame_cache_
+      RTC_GUARDED_BY(send_checker_);
 
   const absl::optional<int> red_payload_type_;
   VideoFecGenerator* const fec_generator_;
@@ -217,6 +253,11 @@ class RTPSenderVideo {
 
   const rtc::scoped_refptr<RTPSenderVideoFrameTransformerDelegate>
       frame_transformer_delegate_;
+
+  // If set, FEC is generated on this queue after the media packets of a frame
+  // have been sent. Declared last, so pending tasks are stopped before the
+  // members they use are destroyed.
+  std::unique_ptr<rtc::TaskQueue> fec_queue_;
 };
 
 }  // namespace webrtc
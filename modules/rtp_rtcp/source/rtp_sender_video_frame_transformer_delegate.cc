@@ -10,6 +10,9 @@
 
 #include "modules/rtp_rtcp/source/rtp_sender_video_frame_transformer_delegate.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -62,7 +65,22 @@ class TransformableVideoSenderFrame : public TransformableVideoFrameInterface {
   }
 
   void SetData(rtc::ArrayView<const uint8_t> data) override {
-    encoded_data_ = EncodedImageBuffer::Create(data.data(), data.size());
+    owned_data_ = EncodedImageBuffer::Create(data.data(), data.size());
+    encoded_data_ = owned_data_;
+  }
+
+  rtc::ArrayView<uint8_t> GetMutableData(size_t size) override {
+    if (!owned_data_ || size == 0) {
+      // The encoded data may be shared with the encoder, so it's copied the
+      // first time it's modified.
+      owned_data_ = EncodedImageBuffer::Create(size);
+      memcpy(owned_data_->data(), encoded_data_->data(),
+             std::min(size, encoded_data_->size()));
+      encoded_data_ = owned_data_;
+    } else if (size != owned_data_->size()) {
+      owned_data_->Realloc(size);
+    }
+    return rtc::ArrayView<uint8_t>(owned_data_->data(), size);
   }
 
   uint32_t GetTimestamp() const override { return timestamp_; }
@@ -93,6 +111,8 @@ class TransformableVideoSenderFrame : public TransformableVideoFrameInterface {
 
  private:
   rtc::scoped_refptr<EncodedImageBufferInterface> encoded_data_;
+  // Set once the frame has a copy of the encoded data of its own.
+  rtc::scoped_refptr<EncodedImageBuffer> owned_data_;
   const RTPVideoHeader header_;
   const VideoFrameMetadata metadata_;
   const VideoFrameType frame_type_;
@@ -34,9 +34,12 @@
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "modules/rtp_rtcp/source/time_util.h"
+#include "modules/rtp_rtcp/source/ulpfec_generator.h"
 #include "rtc_base/arraysize.h"
+#include "rtc_base/event.h"
 #include "rtc_base/rate_limiter.h"
 #include "rtc_base/task_queue_for_test.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 #include "test/mock_frame_transformer.h"
@@ -911,10 +914,183 @@ TEST_P(RtpSenderVideoTest, PopulatesPlayoutDelay) {
   EXPECT_EQ(received_delay, kExpectedDelay);
 }
 
+TEST_P(RtpSenderVideoTest, EncapsulatesPayloadInRed) {
+  constexpr int kRedPayloadType = 98;
+  constexpr size_t kPacketSize = 123;
+  uint8_t kFrame[kPacketSize];
+  for (size_t i = 0; i < kPacketSize; ++i) {
+    kFrame[i] = static_cast<uint8_t>(i);
+  }
+  RTPVideoHeader hdr;
+  hdr.frame_type = VideoFrameType::kVideoFrameKey;
+  rtp_sender_video_.SendVideo(kPayload, kType, kTimestamp, 0, kFrame, nullptr,
+                              hdr, kDefaultExpectedRetransmissionTimeMs);
+  const RtpPacketReceived media_packet = transport_.last_sent_packet();
+
+  RTPSenderVideo::Config config;
+  config.clock = &fake_clock_;
+  config.rtp_sender = rtp_module_->RtpSender();
+  config.field_trials = &field_trials_;
+  config.red_payload_type = kRedPayloadType;
+  RTPSenderVideo rtp_sender_video(config);
+  rtp_sender_video.SendVideo(kPayload, kType, kTimestamp, 0, kFrame, nullptr,
+                             hdr, kDefaultExpectedRetransmissionTimeMs);
+  const RtpPacketReceived& red_packet = transport_.last_sent_packet();
+
+  EXPECT_EQ(red_packet.PayloadType(), kRedPayloadType);
+  ASSERT_EQ(red_packet.payload_size(), media_packet.payload_size() + 1);
+  EXPECT_EQ(red_packet.payload()[0], kPayload);
+  EXPECT_THAT(red_packet.payload().subview(1),
+              ElementsAreArray(media_packet.payload()));
+}
+
+TEST_P(RtpSenderVideoTest, ResendsCachedKeyFrameOnce) {
+  constexpr size_t kPacketSize = 123;
+  uint8_t kFrame[kPacketSize] = {};
+  RTPSenderVideo::Config config;
+  config.clock = &fake_clock_;
+  config.rtp_sender = rtp_module_->RtpSender();
+  config.field_trials = &field_trials_;
+  config.key_frame_cache_size = 10;
+  RTPSenderVideo rtp_sender_video(config);
+  EXPECT_FALSE(rtp_sender_video.RequestCachedKeyFrame());
+
+  RTPVideoHeader hdr;
+  hdr.frame_type = VideoFrameType::kVideoFrameKey;
+  rtp_sender_video.SendVideo(kPayload, kType, kTimestamp, 0, kFrame, nullptr,
+                             hdr, kDefaultExpectedRetransmissionTimeMs);
+  hdr.frame_type = VideoFrameType::kVideoFrameDelta;
+  rtp_sender_video.SendVideo(kPayload, kType, kTimestamp + 3000, 0, kFrame,
+                             nullptr, hdr,
+                             kDefaultExpectedRetransmissionTimeMs);
+  ASSERT_EQ(transport_.packets_sent(), 2);
+
+  // The key frame and the delta frame are resent before the next frame, with
+  // new sequence numbers.
+  EXPECT_TRUE(rtp_sender_video.RequestCachedKeyFrame());
+  rtp_sender_video.SendVideo(kPayload, kType, kTimestamp + 6000, 0, kFrame,
+                             nullptr, hdr,
+                             kDefaultExpectedRetransmissionTimeMs);
+  ASSERT_EQ(transport_.packets_sent(), 5);
+  const std::vector<RtpPacketReceived>& sent = transport_.sent_packets();
+  EXPECT_EQ(sent[2].Timestamp(), sent[0].Timestamp());
+  EXPECT_EQ(sent[3].Timestamp(), sent[1].Timestamp());
+  EXPECT_EQ(sent[4].Timestamp(), kTimestamp + 6000);
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_EQ(sent[i].SequenceNumber(),
+              static_cast<uint16_t>(sent[0].SequenceNumber() + i));
+  }
+
+  // Later requests need a new key frame.
+  EXPECT_FALSE(rtp_sender_video.RequestCachedKeyFrame());
+  hdr.frame_type = VideoFrameType::kVideoFrameKey;
+  rtp_sender_video.SendVideo(kPayload, kType, kTimestamp + 9000, 0, kFrame,
+                             nullptr, hdr,
+                             kDefaultExpectedRetransmissionTimeMs);
+  EXPECT_TRUE(rtp_sender_video.RequestCachedKeyFrame());
+}
+
+TEST_P(RtpSenderVideoTest, DropsKeyFrameCacheWhenFull) {
+  constexpr size_t kPacketSize = 123;
+  uint8_t kFrame[kPacketSize] = {};
+  RTPSenderVideo::Config config;
+  config.clock = &fake_clock_;
+  config.rtp_sender = rtp_module_->RtpSender();
+  config.field_trials = &field_trials_;
+  config.key_frame_cache_size = 2;
+  RTPSenderVideo rtp_sender_video(config);
+
+  RTPVideoHeader hdr;
+  hdr.frame_type = VideoFrameType::kVideoFrameKey;
+  rtp_sender_video.SendVideo(kPayload, kType, kTimestamp, 0, kFrame, nullptr,
+                             hdr, kDefaultExpectedRetransmissionTimeMs);
+  hdr.frame_type = VideoFrameType::kVideoFrameDelta;
+  for (int i = 0; i < 2; ++i) {
+    rtp_sender_video.SendVideo(kPayload, kType, kTimestamp, 0, kFrame, nullptr,
+                               hdr, kDefaultExpectedRetransmissionTimeMs);
+  }
+  EXPECT_FALSE(rtp_sender_video.RequestCachedKeyFrame());
+}
+
 INSTANTIATE_TEST_SUITE_P(WithAndWithoutOverhead,
                          RtpSenderVideoTest,
                          ::testing::Bool());
 
+class SignalingTransport : public LoopbackTransportTest {
+ public:
+  explicit SignalingTransport(int num_packets) : num_packets_(num_packets) {}
+
+  bool SendRtp(const uint8_t* data,
+               size_t len,
+               const PacketOptions& options) override {
+    LoopbackTransportTest::SendRtp(data, len, options);
+    if (packets_sent() == num_packets_) {
+      packets_sent_.Set();
+    }
+    return true;
+  }
+
+  bool WaitForPackets() { return packets_sent_.Wait(kTimeoutMs); }
+
+ private:
+  static constexpr int kTimeoutMs = 5000;
+  const int num_packets_;
+  rtc::Event packets_sent_;
+};
+
+TEST(RtpSenderVideoAsyncFecTest, SendsFecAfterMediaPackets) {
+  constexpr int kRedPayloadType = 96;
+  constexpr int kUlpfecPayloadType = 97;
+  test::ScopedFieldTrials trials("WebRTC-AsyncFecGeneration/Enabled/");
+  FieldTrialBasedConfig field_trials;
+  SimulatedClock fake_clock(kStartTime);
+  SignalingTransport transport(/*num_packets=*/2);
+  RateLimiter retransmission_rate_limiter(&fake_clock, 1000);
+  RtpRtcp::Configuration rtp_config;
+  rtp_config.clock = &fake_clock;
+  rtp_config.outgoing_transport = &transport;
+  rtp_config.retransmission_rate_limiter = &retransmission_rate_limiter;
+  rtp_config.field_trials = &field_trials;
+  rtp_config.local_media_ssrc = kSsrc;
+  std::unique_ptr<RtpRtcp> rtp_module = RtpRtcp::Create(rtp_config);
+  rtp_module->SetSequenceNumber(kSeqNum);
+
+  UlpfecGenerator ulpfec_generator(kRedPayloadType, kUlpfecPayloadType,
+                                   &fake_clock);
+  FecProtectionParams fec_params;
+  fec_params.fec_mask_type = kFecMaskRandom;
+  fec_params.fec_rate = 1;
+  fec_params.max_fec_frames = 1;
+  ulpfec_generator.SetProtectionParameters(fec_params, fec_params);
+
+  RTPSenderVideo::Config config;
+  config.clock = &fake_clock;
+  config.rtp_sender = rtp_module->RtpSender();
+  config.field_trials = &field_trials;
+  config.red_payload_type = kRedPayloadType;
+  config.fec_generator = &ulpfec_generator;
+  config.fec_type = ulpfec_generator.GetFecType();
+  config.fec_overhead_bytes = ulpfec_generator.MaxPacketOverhead();
+  RTPSenderVideo rtp_sender_video(config);
+
+  const uint8_t kFrame[] = {47, 11, 32, 93, 89};
+  RTPVideoHeader hdr;
+  hdr.frame_type = VideoFrameType::kVideoFrameKey;
+  ASSERT_TRUE(rtp_sender_video.SendVideo(kPayload, kType, kTimestamp, 0,
+                                         kFrame, nullptr, hdr,
+                                         kDefaultExpectedRetransmissionTimeMs));
+  ASSERT_TRUE(transport.WaitForPackets());
+
+  const RtpPacketReceived& media_packet = transport.sent_packets()[0];
+  EXPECT_EQ(media_packet.PayloadType(), kRedPayloadType);
+  EXPECT_EQ(media_packet.payload()[0], kPayload);
+  EXPECT_EQ(media_packet.SequenceNumber(), kSeqNum);
+  const RtpPacketReceived& fec_packet = transport.sent_packets()[1];
+  EXPECT_EQ(fec_packet.PayloadType(), kRedPayloadType);
+  EXPECT_EQ(fec_packet.payload()[0], kUlpfecPayloadType);
+  EXPECT_EQ(fec_packet.SequenceNumber(), kSeqNum + 1);
+}
+
 class RtpSenderVideoWithFrameTransformerTest : public ::testing::Test {
  public:
   RtpSenderVideoWithFrameTransformerTest()
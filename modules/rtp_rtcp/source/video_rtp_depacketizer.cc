@@ -16,19 +16,21 @@
 #include "api/array_view.h"
 #include "api/scoped_refptr.h"
 #include "api/video/encoded_image.h"
+#include "common_video/include/encoded_image_buffer_pool.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
 
-rtc::scoped_refptr<EncodedImageBuffer> VideoRtpDepacketizer::AssembleFrame(
+rtc::scoped_refptr<EncodedImageBufferInterface>
+VideoRtpDepacketizer::AssembleFrame(
     rtc::ArrayView<const rtc::ArrayView<const uint8_t>> rtp_payloads) {
   size_t frame_size = 0;
   for (rtc::ArrayView<const uint8_t> payload : rtp_payloads) {
     frame_size += payload.size();
   }
 
-  rtc::scoped_refptr<EncodedImageBuffer> bitstream =
-      EncodedImageBuffer::Create(frame_size);
+  rtc::scoped_refptr<EncodedImageBufferInterface> bitstream =
+      CreateFrameBuffer(frame_size);
 
   uint8_t* write_at = bitstream->data();
   for (rtc::ArrayView<const uint8_t> payload : rtp_payloads) {
@@ -39,4 +41,11 @@ rtc::scoped_refptr<EncodedImageBuffer> VideoRtpDepacketizer::AssembleFrame(
   return bitstream;
 }
 
+rtc::scoped_refptr<EncodedImageBufferInterface>
+VideoRtpDepacketizer::CreateFrameBuffer(size_t size) {
+  if (frame_buffer_pool_)
+    return frame_buffer_pool_->Create(size);
+  return EncodedImageBuffer::Create(size);
+}
+
 }  // namespace webrtc
@@ -17,6 +17,7 @@
 #include "api/array_view.h"
 #include "api/scoped_refptr.h"
 #include "api/video/encoded_image.h"
+#include "common_video/include/encoded_image_buffer_pool.h"
 #include "modules/rtp_rtcp/source/rtp_video_header.h"
 #include "rtc_base/copy_on_write_buffer.h"
 
@@ -32,8 +33,22 @@ class VideoRtpDepacketizer {
   virtual ~VideoRtpDepacketizer() = default;
   virtual absl::optional<ParsedRtpPayload> Parse(
       rtc::CopyOnWriteBuffer rtp_payload) = 0;
-  virtual rtc::scoped_refptr<EncodedImageBuffer> AssembleFrame(
+  virtual rtc::scoped_refptr<EncodedImageBufferInterface> AssembleFrame(
       rtc::ArrayView<const rtc::ArrayView<const uint8_t>> rtp_payloads);
+
+  // Makes AssembleFrame take the frame buffers from |pool|, which must
+  // outlive the depacketizer. By default, each frame buffer is allocated.
+  void SetFrameBufferPool(EncodedImageBufferPool* pool) {
+    frame_buffer_pool_ = pool;
+  }
+
+ protected:
+  // Returns a buffer of |size| uninitialized bytes to assemble a frame into.
+  rtc::scoped_refptr<EncodedImageBufferInterface> CreateFrameBuffer(
+      size_t size);
+
+ private:
+  EncodedImageBufferPool* frame_buffer_pool_ = nullptr;
 };
 
 }  // namespace webrtc
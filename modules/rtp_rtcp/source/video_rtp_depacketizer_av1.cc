@@ -335,7 +335,8 @@ bool CalculateObuSizes(ObuInfo* obu_info) {
 
 }  // namespace
 
-rtc::scoped_refptr<EncodedImageBuffer> VideoRtpDepacketizerAv1::AssembleFrame(
+rtc::scoped_refptr<EncodedImageBufferInterface>
+VideoRtpDepacketizerAv1::AssembleFrame(
     rtc::ArrayView<const rtc::ArrayView<const uint8_t>> rtp_payloads) {
   VectorObuInfo obu_infos = ParseObus(rtp_payloads);
   if (obu_infos.empty()) {
@@ -350,8 +351,8 @@ rtc::scoped_refptr<EncodedImageBuffer> VideoRtpDepacketizerAv1::AssembleFrame(
     frame_size += (obu_info.prefix_size + obu_info.payload_size);
   }
 
-  rtc::scoped_refptr<EncodedImageBuffer> bitstream =
-      EncodedImageBuffer::Create(frame_size);
+  rtc::scoped_refptr<EncodedImageBufferInterface> bitstream =
+      CreateFrameBuffer(frame_size);
   uint8_t* write_at = bitstream->data();
   for (const ObuInfo& obu_info : obu_infos) {
     // Copy the obu_header and obu_size fields.
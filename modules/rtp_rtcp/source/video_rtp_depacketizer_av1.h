@@ -30,7 +30,7 @@ class VideoRtpDepacketizerAv1 : public VideoRtpDepacketizer {
   VideoRtpDepacketizerAv1& operator=(const VideoRtpDepacketizerAv1&) = delete;
   ~VideoRtpDepacketizerAv1() override = default;
 
-  rtc::scoped_refptr<EncodedImageBuffer> AssembleFrame(
+  rtc::scoped_refptr<EncodedImageBufferInterface> AssembleFrame(
       rtc::ArrayView<const rtc::ArrayView<const uint8_t>> rtp_payloads)
       override;
 
@@ -15,15 +15,10 @@
 #include "api/video/video_codec_constants.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "modules/video_coding/codecs/interface/common_constants.h"
-#include "rtc_base/bit_buffer.h"
+#include "rtc_base/bitstream_reader.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
-#define RETURN_FALSE_ON_ERROR(x) \
-  if (!(x)) {                    \
-    return false;                \
-  }
-
 namespace webrtc {
 namespace {
 
@@ -37,19 +32,15 @@ constexpr int kFailedToParse = 0;
 // M:   | EXTENDED PID  |
 //      +-+-+-+-+-+-+-+-+
 //
-bool ParsePictureId(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
-  uint32_t picture_id;
-  uint32_t m_bit;
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&m_bit, 1));
-  if (m_bit) {
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&picture_id, 15));
+bool ParsePictureId(rtc::BitstreamReader* parser, RTPVideoHeaderVP9* vp9) {
+  if (parser->ReadBit()) {
+    vp9->picture_id = parser->ReadBits(15);
     vp9->max_picture_id = kMaxTwoBytePictureId;
   } else {
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&picture_id, 7));
+    vp9->picture_id = parser->ReadBits(7);
     vp9->max_picture_id = kMaxOneBytePictureId;
   }
-  vp9->picture_id = picture_id;
-  return true;
+  return parser->Ok();
 }
 
 // Layer indices (flexible mode):
@@ -58,18 +49,15 @@ bool ParsePictureId(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
 // L:   |  T  |U|  S  |D|
 //      +-+-+-+-+-+-+-+-+
 //
-bool ParseLayerInfoCommon(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
-  uint32_t t, u_bit, s, d_bit;
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&t, 3));
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&u_bit, 1));
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&s, 3));
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&d_bit, 1));
-  vp9->temporal_idx = t;
-  vp9->temporal_up_switch = u_bit ? true : false;
-  if (s >= kMaxSpatialLayers)
+bool ParseLayerInfoCommon(rtc::BitstreamReader* parser,
+                          RTPVideoHeaderVP9* vp9) {
+  vp9->temporal_idx = parser->ReadBits(3);
+  vp9->temporal_up_switch = parser->ReadBit();
+  uint64_t s = parser->ReadBits(3);
+  vp9->inter_layer_predicted = parser->ReadBit();
+  if (!parser->Ok() || s >= kMaxSpatialLayers)
     return false;
   vp9->spatial_idx = s;
-  vp9->inter_layer_predicted = d_bit ? true : false;
   return true;
 }
 
@@ -81,15 +69,13 @@ bool ParseLayerInfoCommon(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
 //      |   TL0PICIDX   |
 //      +-+-+-+-+-+-+-+-+
 //
-bool ParseLayerInfoNonFlexibleMode(rtc::BitBuffer* parser,
+bool ParseLayerInfoNonFlexibleMode(rtc::BitstreamReader* parser,
                                    RTPVideoHeaderVP9* vp9) {
-  uint8_t tl0picidx;
-  RETURN_FALSE_ON_ERROR(parser->ReadUInt8(&tl0picidx));
-  vp9->tl0_pic_idx = tl0picidx;
-  return true;
+  vp9->tl0_pic_idx = parser->Read<uint8_t>();
+  return parser->Ok();
 }
 
-bool ParseLayerInfo(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
+bool ParseLayerInfo(rtc::BitstreamReader* parser, RTPVideoHeaderVP9* vp9) {
   if (!ParseLayerInfoCommon(parser, vp9))
     return false;
 
@@ -106,19 +92,18 @@ bool ParseLayerInfo(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
 //      +-+-+-+-+-+-+-+-+                    N=1: An additional P_DIFF follows
 //                                                current P_DIFF.
 //
-bool ParseRefIndices(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
+bool ParseRefIndices(rtc::BitstreamReader* parser, RTPVideoHeaderVP9* vp9) {
   if (vp9->picture_id == kNoPictureId)
     return false;
 
   vp9->num_ref_pics = 0;
-  uint32_t n_bit;
+  bool n_bit;
   do {
     if (vp9->num_ref_pics == kMaxVp9RefPics)
       return false;
 
-    uint32_t p_diff;
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&p_diff, 7));
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&n_bit, 1));
+    uint32_t p_diff = parser->ReadBits(7);
+    n_bit = parser->ReadBit();
 
     vp9->pid_diff[vp9->num_ref_pics] = p_diff;
     uint32_t scaled_pid = vp9->picture_id;
@@ -129,7 +114,7 @@ bool ParseRefIndices(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
     vp9->ref_picture_id[vp9->num_ref_pics++] = scaled_pid - p_diff;
   } while (n_bit);
 
-  return true;
+  return parser->Ok();
 }
 
 // Scalability structure (SS).
@@ -152,44 +137,33 @@ bool ParseRefIndices(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
 //      |    P_DIFF     | (OPTIONAL)    . R times    .
 //      +-+-+-+-+-+-+-+-+              -|           -|
 //
-bool ParseSsData(rtc::BitBuffer* parser, RTPVideoHeaderVP9* vp9) {
-  uint32_t n_s, y_bit, g_bit;
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&n_s, 3));
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&y_bit, 1));
-  RETURN_FALSE_ON_ERROR(parser->ReadBits(&g_bit, 1));
-  RETURN_FALSE_ON_ERROR(parser->ConsumeBits(3));
-  vp9->num_spatial_layers = n_s + 1;
-  vp9->spatial_layer_resolution_present = y_bit ? true : false;
+bool ParseSsData(rtc::BitstreamReader* parser, RTPVideoHeaderVP9* vp9) {
+  vp9->num_spatial_layers = parser->ReadBits(3) + 1;
+  vp9->spatial_layer_resolution_present = parser->ReadBit();
+  bool g_bit = parser->ReadBit();
+  parser->ConsumeBits(3);
   vp9->gof.num_frames_in_gof = 0;
 
-  if (y_bit) {
+  if (vp9->spatial_layer_resolution_present) {
     for (size_t i = 0; i < vp9->num_spatial_layers; ++i) {
-      RETURN_FALSE_ON_ERROR(parser->ReadUInt16(&vp9->width[i]));
-      RETURN_FALSE_ON_ERROR(parser->ReadUInt16(&vp9->height[i]));
+      vp9->width[i] = parser->Read<uint16_t>();
+      vp9->height[i] = parser->Read<uint16_t>();
     }
   }
   if (g_bit) {
-    uint8_t n_g;
-    RETURN_FALSE_ON_ERROR(parser->ReadUInt8(&n_g));
-    vp9->gof.num_frames_in_gof = n_g;
+    vp9->gof.num_frames_in_gof = parser->Read<uint8_t>();
   }
   for (size_t i = 0; i < vp9->gof.num_frames_in_gof; ++i) {
-    uint32_t t, u_bit, r;
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&t, 3));
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&u_bit, 1));
-    RETURN_FALSE_ON_ERROR(parser->ReadBits(&r, 2));
-    RETURN_FALSE_ON_ERROR(parser->ConsumeBits(2));
-    vp9->gof.temporal_idx[i] = t;
-    vp9->gof.temporal_up_switch[i] = u_bit ? true : false;
-    vp9->gof.num_ref_pics[i] = r;
+    vp9->gof.temporal_idx[i] = parser->ReadBits(3);
+    vp9->gof.temporal_up_switch[i] = parser->ReadBit();
+    vp9->gof.num_ref_pics[i] = parser->ReadBits(2);
+    parser->ConsumeBits(2);
 
     for (uint8_t p = 0; p < vp9->gof.num_ref_pics[i]; ++p) {
-      uint8_t p_diff;
-      RETURN_FALSE_ON_ERROR(parser->ReadUInt8(&p_diff));
-      vp9->gof.pid_diff[i][p] = p_diff;
+      vp9->gof.pid_diff[i][p] = parser->Read<uint8_t>();
     }
   }
-  return true;
+  return parser->Ok();
 }
 }  // namespace
 
@@ -212,9 +186,9 @@ int VideoRtpDepacketizerVp9::ParseRtpPayload(
     RTPVideoHeader* video_header) {
   RTC_DCHECK(video_header);
   // Parse mandatory first byte of payload descriptor.
-  rtc::BitBuffer parser(rtp_payload.data(), rtp_payload.size());
-  uint8_t first_byte;
-  if (!parser.ReadUInt8(&first_byte)) {
+  rtc::BitstreamReader parser(rtp_payload);
+  uint8_t first_byte = parser.Read<uint8_t>();
+  if (!parser.Ok()) {
     RTC_LOG(LS_ERROR) << "Payload length is zero.";
     return kFailedToParse;
   }
@@ -273,10 +247,8 @@ int VideoRtpDepacketizerVp9::ParseRtpPayload(
   video_header->is_first_packet_in_frame =
       b_bit && (!l_bit || !vp9_header.inter_layer_predicted);
 
-  size_t byte_offset;
-  size_t bit_offset;
-  parser.GetCurrentOffset(&byte_offset, &bit_offset);
-  RTC_DCHECK_EQ(bit_offset, 0);
+  RTC_DCHECK_EQ(parser.RemainingBitCount() % 8, 0);
+  size_t byte_offset = rtp_payload.size() - parser.RemainingBitCount() / 8;
   if (byte_offset == rtp_payload.size()) {
     // Empty vp9 payload data.
     return kFailedToParse;
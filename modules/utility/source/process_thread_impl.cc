@@ -10,7 +10,11 @@
 
 #include "modules/utility/source/process_thread_impl.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "modules/include/module.h"
 #include "rtc_base/checks.h"
@@ -110,8 +114,13 @@ void ProcessThreadImpl::WakeUp(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     for (ModuleCallback& m : modules_) {
-      if (m.module == module)
-        m.next_callback = kCallProcessImmediately;
+      if (m.module != module)
+        continue;
+      // A module that is not in |schedule_| is being processed right now and
+      // gets rescheduled when its Process() returns.
+      if (schedule_.erase(std::make_pair(m.next_callback, &m)) > 0)
+        schedule_.emplace(kCallProcessImmediately, &m);
+      m.next_callback = kCallProcessImmediately;
     }
   }
   wake_up_.Set();
@@ -169,6 +178,9 @@ void ProcessThreadImpl::RegisterModule(Module* module,
   {
     rtc::CritScope lock(&lock_);
     modules_.push_back(ModuleCallback(module, from));
+    // A |next_callback| of 0 sorts before every real timestamp, so the
+    // module's first TimeUntilNextProcess() is queried on the next Process().
+    schedule_.emplace(modules_.back().next_callback, &modules_.back());
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -183,6 +195,10 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
+    for (ModuleCallback& m : modules_) {
+      if (m.module == module)
+        schedule_.erase(std::make_pair(m.next_callback, &m));
+    }
     modules_.remove_if(
         [&module](const ModuleCallback& m) { return m.module == module; });
   }
@@ -191,6 +207,44 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
   module->ProcessThreadAttached(nullptr);
 }
 
+int64_t ProcessThreadImpl::ProcessDueModules(int64_t now) {
+  // Modules are rescheduled once all due modules have run, so that a module
+  // which is due again right away is still processed once per Process().
+  std::vector<ModuleCallback*> processed;
+  while (!schedule_.empty() && schedule_.begin()->first <= now) {
+    ModuleCallback* m = schedule_.begin()->second;
+    schedule_.erase(schedule_.begin());
+    // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
+    // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
+    // operation should not require taking a lock, so querying all modules
+    // should run in a matter of nanoseconds.
+    if (m->next_callback == 0) {
+      m->next_callback = GetNextCallbackTime(m->module, now);
+      if (m->next_callback > now) {
+        schedule_.emplace(m->next_callback, m);
+        continue;
+      }
+    }
+    {
+      TRACE_EVENT2("webrtc", "ModuleProcess", "function",
+                   m->location.function_name(), "file",
+                   m->location.file_name());
+      m->module->Process();
+    }
+    // Use a new 'now' reference to calculate when the next callback
+    // should occur.  We'll continue to use 'now' above for the baseline
+    // of calculating how long we should wait, to reduce variance.
+    int64_t new_now = rtc::TimeMillis();
+    m->next_callback = GetNextCallbackTime(m->module, new_now);
+    processed.push_back(m);
+  }
+  for (ModuleCallback* m : processed)
+    schedule_.emplace(m->next_callback, m);
+
+  return schedule_.empty() ? std::numeric_limits<int64_t>::max()
+                           : schedule_.begin()->first;
+}
+
 // static
 void ProcessThreadImpl::Run(void* obj) {
   ProcessThreadImpl* impl = static_cast<ProcessThreadImpl*>(obj);
@@ -208,32 +262,7 @@ bool ProcessThreadImpl::Process() {
     rtc::CritScope lock(&lock_);
     if (stop_)
       return false;
-    for (ModuleCallback& m : modules_) {
-      // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
-      // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
-      // operation should not require taking a lock, so querying all modules
-      // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
-        m.next_callback = GetNextCallbackTime(m.module, now);
-
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
-        {
-          TRACE_EVENT2("webrtc", "ModuleProcess", "function",
-                       m.location.function_name(), "file",
-                       m.location.file_name());
-          m.module->Process();
-        }
-        // Use a new 'now' reference to calculate when the next callback
-        // should occur.  We'll continue to use 'now' above for the baseline
-        // of calculating how long we should wait, to reduce variance.
-        int64_t new_now = rtc::TimeMillis();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
-      }
-
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
-    }
+    next_checkpoint = std::min(next_checkpoint, ProcessDueModules(now));
 
     while (!delayed_tasks_.empty() && delayed_tasks_.top().run_at_ms <= now) {
       queue_.push(delayed_tasks_.top().task);
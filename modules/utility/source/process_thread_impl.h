@@ -16,6 +16,8 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <set>
+#include <utility>
 
 #include "api/task_queue/queued_task.h"
 #include "modules/include/module.h"
@@ -83,9 +85,16 @@ class ProcessThreadImpl : public ProcessThread {
     QueuedTask* task;
   };
   typedef std::list<ModuleCallback> ModuleList;
+  // Registered modules ordered by |next_callback|, so that Process() only
+  // visits the modules that are due instead of every registered module.
+  typedef std::set<std::pair<int64_t, ModuleCallback*>> ModuleSchedule;
 
   void Delete() override;
 
+  // Processes the modules in |schedule_| that are due at |now| and returns
+  // the time of the earliest callback that is still pending.
+  int64_t ProcessDueModules(int64_t now) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
   // on Mac 10.9 debug.  I (Tommi) suspect we're hitting some obscure alignemnt
@@ -100,6 +109,7 @@ class ProcessThreadImpl : public ProcessThread {
   std::unique_ptr<rtc::PlatformThread> thread_;
 
   ModuleList modules_;
+  ModuleSchedule schedule_ RTC_GUARDED_BY(lock_);
   std::queue<QueuedTask*> queue_;
   std::priority_queue<DelayedTask> delayed_tasks_ RTC_GUARDED_BY(lock_);
   bool stop_;
@@ -299,6 +299,40 @@ TEST(ProcessThreadImpl, WakeUp) {
   EXPECT_LE(diff, 100u);
 }
 
+// Tests that waking up one module neither processes nor queries the modules
+// that aren't due yet.
+TEST(ProcessThreadImpl, WakeUpOnlyProcessesDueModules) {
+  ProcessThreadImpl thread("ProcessThread");
+  rtc::Event called;
+  int process_count = 0;
+
+  MockModule idle_module;
+  EXPECT_CALL(idle_module, TimeUntilNextProcess())
+      .Times(1)
+      .WillOnce(Return(10000));
+  EXPECT_CALL(idle_module, Process()).Times(0);
+  EXPECT_CALL(idle_module, ProcessThreadAttached(_)).Times(2);
+
+  MockModule woken_module;
+  EXPECT_CALL(woken_module, TimeUntilNextProcess())
+      .WillRepeatedly(Return(10000));
+  EXPECT_CALL(woken_module, Process())
+      .WillRepeatedly(
+          DoAll(Increment(&process_count), SetEvent(&called), Return()));
+  EXPECT_CALL(woken_module, ProcessThreadAttached(_)).Times(2);
+
+  thread.RegisterModule(&idle_module, RTC_FROM_HERE);
+  thread.RegisterModule(&woken_module, RTC_FROM_HERE);
+  thread.Start();
+  for (int i = 0; i < 10; ++i) {
+    thread.WakeUp(&woken_module);
+    EXPECT_TRUE(called.Wait(kEventWaitTimeout));
+  }
+  thread.Stop();
+
+  EXPECT_EQ(process_count, 10);
+}
+
 // Tests that we can post a task that gets run straight away on the worker
 // thread.
 TEST(ProcessThreadImpl, PostTask) {
@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 
 #include "absl/types/optional.h"
@@ -31,6 +32,22 @@ namespace {
 
 constexpr int kConfigLowBitDepth = 1;  // 8-bits per luma/chroma sample.
 constexpr int kDecFlags = 0;           // 0 signals no post processing.
+constexpr int kMaxDecoderThreads = 8;
+
+// Returns the number of decoder threads for frames of the given size. libaom
+// decodes tiles and superblock rows in parallel, but for lower resolutions
+// the synchronization between the threads outweighs the gain.
+int NumberOfDecoderThreads(int width, int height, int number_of_cores) {
+  int max_threads = 1;
+  if (width * height >= 3840 * 2160) {
+    max_threads = kMaxDecoderThreads;
+  } else if (width * height >= 1280 * 720) {
+    max_threads = 4;
+  } else if (width * height >= 640 * 360) {
+    max_threads = 2;
+  }
+  return std::max(1, std::min(number_of_cores, max_threads));
+}
 
 class LibaomAv1Decoder final : public VideoDecoder {
  public:
@@ -54,8 +71,16 @@ class LibaomAv1Decoder final : public VideoDecoder {
   int32_t Release() override;
 
  private:
+  // Initializes |context_| to decode with |num_threads| threads.
+  bool InitContext(int num_threads);
+  // Recreates |context_| if the resolution of |key_frame| calls for another
+  // number of decoder threads.
+  int32_t MaybeUpdateDecoderThreads(const EncodedImage& key_frame);
+
   aom_codec_ctx_t context_;
   bool inited_;
+  int num_cores_;
+  int num_threads_;
   // Pool of memory buffers to store decoded image data for application access.
   I420BufferPool buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
@@ -64,6 +89,8 @@ class LibaomAv1Decoder final : public VideoDecoder {
 LibaomAv1Decoder::LibaomAv1Decoder()
     : context_(),  // Force value initialization instead of default one.
       inited_(false),
+      num_cores_(1),
+      num_threads_(0),
       buffer_pool_(false, /*max_number_of_buffers=*/150),
       decode_complete_callback_(nullptr) {}
 
@@ -73,8 +100,19 @@ LibaomAv1Decoder::~LibaomAv1Decoder() {
 
 int32_t LibaomAv1Decoder::InitDecode(const VideoCodec* codec_settings,
                                      int number_of_cores) {
+  // The resolution of the stream isn't known yet, so start with the maximum
+  // number of threads and adjust to the resolution of key frames.
+  num_cores_ = number_of_cores;
+  if (!InitContext(std::min(number_of_cores, kMaxDecoderThreads))) {
+    return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+  inited_ = true;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+bool LibaomAv1Decoder::InitContext(int num_threads) {
   aom_codec_dec_cfg_t config = {
-      static_cast<unsigned int>(number_of_cores),  // Max # of threads.
+      static_cast<unsigned int>(num_threads),  // Max # of threads.
       0,                    // Frame width set after decode.
       0,                    // Frame height set after decode.
       kConfigLowBitDepth};  // Enable low-bit-depth code path.
@@ -84,6 +122,32 @@ int32_t LibaomAv1Decoder::InitDecode(const VideoCodec* codec_settings,
   if (ret != AOM_CODEC_OK) {
     RTC_LOG(LS_WARNING) << "LibaomAv1Decoder::InitDecode returned " << ret
                         << " on aom_codec_dec_init.";
+    return false;
+  }
+  num_threads_ = num_threads;
+  return true;
+}
+
+int32_t LibaomAv1Decoder::MaybeUpdateDecoderThreads(
+    const EncodedImage& key_frame) {
+  aom_codec_stream_info_t info = {};
+  if (aom_codec_peek_stream_info(aom_codec_av1_dx(), key_frame.data(),
+                                 key_frame.size(), &info) != AOM_CODEC_OK) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  const int num_threads = NumberOfDecoderThreads(info.w, info.h, num_cores_);
+  if (num_threads == num_threads_) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  // A key frame doesn't depend on previous frames, so the context can be
+  // recreated. Decoded frames are copied to |buffer_pool_|, so no buffers
+  // referenced by the application are owned by the context.
+  RTC_LOG(LS_INFO) << "Reconfiguring AV1 decoder from " << num_threads_
+                   << " to " << num_threads << " threads for " << info.w
+                   << "x" << info.h;
+  inited_ = false;
+  if (aom_codec_destroy(&context_) != AOM_CODEC_OK ||
+      !InitContext(num_threads)) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   inited_ = true;
@@ -100,6 +164,13 @@ int32_t LibaomAv1Decoder::Decode(const EncodedImage& encoded_image,
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
   }
 
+  if (encoded_image._frameType == VideoFrameType::kVideoFrameKey) {
+    int32_t ret = MaybeUpdateDecoderThreads(encoded_image);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
+    }
+  }
+
   // Decode one video frame.
   aom_codec_err_t ret =
       aom_codec_decode(&context_, encoded_image.data(), encoded_image.size(),
@@ -61,6 +61,29 @@ int GetCpuSpeed(int width, int height) {
     return 7;
 }
 
+// Threads beyond what the frame can keep busy only add synchronization
+// overhead, so the thread count grows with the resolution.
+int NumberOfThreads(int width, int height, int number_of_cores) {
+  if (width * height >= 1280 * 720 && number_of_cores > 4)
+    return 4;
+  else if (width * height >= 640 * 360 && number_of_cores > 2)
+    return 2;
+  else
+    return 1;
+}
+
+// Returns log2 of the number of tile columns: one column per thread, as long
+// as each column stays at least kMinTileWidth pixels wide. Rows within a tile
+// are spread over the threads by row based multithreading, so a single tile
+// row is used.
+int TileColumnsLog2(int width, int num_threads) {
+  constexpr int kMinTileWidth = 320;
+  int log2 = 0;
+  while ((2 << log2) <= num_threads && (width >> (log2 + 1)) >= kMinTileWidth)
+    ++log2;
+  return log2;
+}
+
 class LibaomAv1Encoder final : public VideoEncoder {
  public:
   explicit LibaomAv1Encoder(
@@ -85,6 +108,9 @@ class LibaomAv1Encoder final : public VideoEncoder {
  private:
   // Configures the encoder with scalability for the next coded video sequence.
   bool SetSvcParams(ScalableVideoController::StreamLayersConfig svc_config);
+  // Configures the speed and tools for real-time encoding with
+  // |cfg_.g_threads| threads.
+  bool SetRealtimePerformanceParams();
   // Configures the encoder with layer for the next frame.
   void SetSvcLayerId(
       const ScalableVideoController::LayerFrameConfig& layer_frame);
@@ -177,7 +203,8 @@ int LibaomAv1Encoder::InitEncode(const VideoCodec* codec_settings,
   // Overwrite default config with input encoder settings & RTC-relevant values.
   cfg_.g_w = encoder_settings_.width;
   cfg_.g_h = encoder_settings_.height;
-  cfg_.g_threads = settings.number_of_cores;
+  cfg_.g_threads =
+      NumberOfThreads(cfg_.g_w, cfg_.g_h, settings.number_of_cores);
   cfg_.g_timebase.num = 1;
   cfg_.g_timebase.den = kRtpTicksPerSecond;
   cfg_.rc_target_bitrate = encoder_settings_.maxBitrate;  // kilobits/sec.
@@ -214,11 +241,7 @@ int LibaomAv1Encoder::InitEncode(const VideoCodec* codec_settings,
   inited_ = true;
 
   // Set control parameters
-  ret = aom_codec_control(&ctx_, AOME_SET_CPUUSED,
-                          GetCpuSpeed(cfg_.g_w, cfg_.g_h));
-  if (ret != AOM_CODEC_OK) {
-    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
-                        << " on control AV1E_SET_CPUUSED.";
+  if (!SetRealtimePerformanceParams()) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   ret = aom_codec_control(&ctx_, AV1E_SET_ENABLE_TPL_MODEL, 0);
@@ -258,6 +281,61 @@ int LibaomAv1Encoder::InitEncode(const VideoCodec* codec_settings,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+bool LibaomAv1Encoder::SetRealtimePerformanceParams() {
+  aom_codec_err_t ret = aom_codec_control(&ctx_, AOME_SET_CPUUSED,
+                                          GetCpuSpeed(cfg_.g_w, cfg_.g_h));
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_CPUUSED.";
+    return false;
+  }
+  ret = aom_codec_control(&ctx_, AV1E_SET_ROW_MT, cfg_.g_threads > 1 ? 1 : 0);
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_ROW_MT.";
+    return false;
+  }
+  ret = aom_codec_control(&ctx_, AV1E_SET_TILE_COLUMNS,
+                          TileColumnsLog2(cfg_.g_w, cfg_.g_threads));
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_TILE_COLUMNS.";
+    return false;
+  }
+  ret = aom_codec_control(&ctx_, AV1E_SET_TILE_ROWS, 0);
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_TILE_ROWS.";
+    return false;
+  }
+  // Tools whose search cost is too high for real-time encoding.
+  ret = aom_codec_control(&ctx_, AV1E_SET_ENABLE_GLOBAL_MOTION, 0);
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_ENABLE_GLOBAL_MOTION.";
+    return false;
+  }
+  ret = aom_codec_control(&ctx_, AV1E_SET_ENABLE_WARPED_MOTION, 0);
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_ENABLE_WARPED_MOTION.";
+    return false;
+  }
+  ret = aom_codec_control(&ctx_, AV1E_SET_ENABLE_OBMC, 0);
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_ENABLE_OBMC.";
+    return false;
+  }
+  ret = aom_codec_control(&ctx_, AV1E_SET_NOISE_SENSITIVITY, 0);
+  if (ret != AOM_CODEC_OK) {
+    RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::EncodeInit returned " << ret
+                        << " on control AV1E_SET_NOISE_SENSITIVITY.";
+    return false;
+  }
+  return true;
+}
+
 bool LibaomAv1Encoder::SetSvcParams(
     ScalableVideoController::StreamLayersConfig svc_config) {
   svc_enabled_ =
@@ -321,6 +399,19 @@ void LibaomAv1Encoder::SetSvcLayerId(
     RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::Encode returned " << ret
                         << " on control AV1E_SET_SVC_LAYER_ID.";
   }
+
+  // Lower spatial layers are smaller and cheaper to encode, so use the speed
+  // matching their resolution rather than the one of the full frame.
+  int num_spatial_layers = svc_controller_->StreamConfig().num_spatial_layers;
+  if (num_spatial_layers > 1) {
+    int shift = num_spatial_layers - layer_frame.spatial_id - 1;
+    ret = aom_codec_control(&ctx_, AOME_SET_CPUUSED,
+                            GetCpuSpeed(cfg_.g_w >> shift, cfg_.g_h >> shift));
+    if (ret != AOM_CODEC_OK) {
+      RTC_LOG(LS_WARNING) << "LibaomAv1Encoder::Encode returned " << ret
+                          << " on control AV1E_SET_CPUUSED.";
+    }
+  }
 }
 
 void LibaomAv1Encoder::SetSvcRefFrameConfig(
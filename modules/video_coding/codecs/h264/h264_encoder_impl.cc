@@ -16,6 +16,7 @@
 
 #include "modules/video_coding/codecs/h264/h264_encoder_impl.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 
@@ -40,6 +41,15 @@ namespace {
 
 const bool kOpenH264EncoderDetailedLogging = false;
 
+std::unique_ptr<EncoderComplexityController> CreateComplexityController() {
+  absl::optional<EncoderComplexityController::Config> config =
+      EncoderComplexityController::ParseFieldTrial();
+  if (!config) {
+    return nullptr;
+  }
+  return std::make_unique<EncoderComplexityController>(*config);
+}
+
 // QP scaling thresholds.
 static const int kLowH264QpThreshold = 24;
 static const int kHighH264QpThreshold = 37;
@@ -153,7 +163,8 @@ H264EncoderImpl::H264EncoderImpl(const cricket::VideoCodec& codec)
       number_of_cores_(0),
       encoded_image_callback_(nullptr),
       has_reported_init_(false),
-      has_reported_error_(false) {
+      has_reported_error_(false),
+      complexity_controller_(CreateComplexityController()) {
   RTC_CHECK(absl::EqualsIgnoreCase(codec.name, cricket::kH264CodecName));
   std::string packetization_mode_string;
   if (codec.GetParam(cricket::kH264FmtpPacketizationMode,
@@ -266,6 +277,7 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* inst,
 
     // Create encoder parameters based on the layer configuration.
     SEncParamExt encoder_params = CreateEncoderParams(i);
+    base_complexity_mode_ = encoder_params.iComplexityMode;
 
     // Initialize.
     if (openh264_encoder->InitializeExt(&encoder_params) != 0) {
@@ -292,6 +304,11 @@ int32_t H264EncoderImpl::InitEncode(const VideoCodec* inst,
     tl0sync_limit_[i] = configurations_[i].num_temporal_layers;
   }
 
+  if (complexity_controller_) {
+    complexity_controller_->Reset();
+    complexity_controller_->SetFramerate(codec_.maxFramerate);
+  }
+
   SimulcastRateAllocator init_allocator(codec_);
   VideoBitrateAllocation allocation =
       init_allocator.Allocate(VideoBitrateAllocationParameters(
@@ -343,6 +360,9 @@ void H264EncoderImpl::SetRates(const RateControlParameters& parameters) {
   }
 
   codec_.maxFramerate = static_cast<uint32_t>(parameters.framerate_fps);
+  if (complexity_controller_) {
+    complexity_controller_->SetFramerate(parameters.framerate_fps);
+  }
 
   size_t stream_idx = encoders_.size() - 1;
   for (size_t i = 0; i < encoders_.size(); ++i, --stream_idx) {
@@ -409,6 +429,7 @@ int32_t H264EncoderImpl::Encode(
   RTC_DCHECK_EQ(configurations_[0].width, frame_buffer->width());
   RTC_DCHECK_EQ(configurations_[0].height, frame_buffer->height());
 
+  const int64_t encode_start_us = rtc::TimeMicros();
   // Encode image for each layer.
   for (size_t i = 0; i < encoders_.size(); ++i) {
     // EncodeFrame input.
@@ -521,9 +542,25 @@ int32_t H264EncoderImpl::Encode(
                                               &codec_specific, &frag_header);
     }
   }
+  if (complexity_controller_ &&
+      complexity_controller_->OnFrameEncoded(rtc::TimeMicros() -
+                                             encode_start_us)) {
+    SetComplexity();
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void H264EncoderImpl::SetComplexity() {
+  // Each step of the speed offset is one complexity mode less than the
+  // configured one, down to LOW_COMPLEXITY.
+  int complexity_mode = std::max<int>(
+      LOW_COMPLEXITY,
+      base_complexity_mode_ - complexity_controller_->speed_offset());
+  for (ISVCEncoder* encoder : encoders_) {
+    encoder->SetOption(ENCODER_OPTION_COMPLEXITY, &complexity_mode);
+  }
+}
+
 // Initialization parameters.
 // There are two ways to initialize. There is SEncParamBase (cleared with
 // memset(&p, 0, sizeof(SEncParamBase)) used in Initialize, and SEncParamExt
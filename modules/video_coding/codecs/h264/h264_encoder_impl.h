@@ -28,6 +28,7 @@
 #include "api/video_codecs/video_encoder.h"
 #include "common_video/h264/h264_bitstream_parser.h"
 #include "modules/video_coding/codecs/h264/include/h264.h"
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
 #include "modules/video_coding/utility/quality_scaler.h"
 #include "third_party/openh264/src/codec/api/svc/codec_app_def.h"
 
@@ -86,6 +87,9 @@ class H264EncoderImpl : public H264Encoder {
 
  private:
   SEncParamExt CreateEncoderParams(size_t i) const;
+  // Sets the complexity mode of the encoders, from |base_complexity_mode_| and
+  // the speed offset of |complexity_controller_|.
+  void SetComplexity();
 
   webrtc::H264BitstreamParser h264_bitstream_parser_;
   // Reports statistics with histograms.
@@ -108,6 +112,11 @@ class H264EncoderImpl : public H264Encoder {
   bool has_reported_error_;
 
   std::vector<uint8_t> tl0sync_limit_;
+
+  // Lowers the complexity mode of the encoders when encoding takes too long,
+  // if the field trial is enabled.
+  const std::unique_ptr<EncoderComplexityController> complexity_controller_;
+  int base_complexity_mode_ = LOW_COMPLEXITY;
 };
 
 }  // namespace webrtc
@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/test/videocodec_test_batch_runner.h"
+
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+#include "modules/video_coding/codecs/test/videocodec_test_fixture_impl.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+void PrintDistribution(const std::string& measurement,
+                       const std::string& user_story,
+                       SamplesStatsCounter* counter,
+                       const std::string& units) {
+  if (counter->IsEmpty()) {
+    return;
+  }
+  PrintResult(measurement, "", user_story, *counter, units,
+              /*important=*/false, ImproveDirection::kSmallerIsBetter);
+  PrintResult(measurement, "_p50", user_story, counter->GetPercentile(0.5),
+              units, /*important=*/false, ImproveDirection::kSmallerIsBetter);
+  PrintResult(measurement, "_p90", user_story, counter->GetPercentile(0.9),
+              units, /*important=*/false, ImproveDirection::kSmallerIsBetter);
+  PrintResult(measurement, "_p99", user_story, counter->GetPercentile(0.99),
+              units, /*important=*/false, ImproveDirection::kSmallerIsBetter);
+}
+
+}  // namespace
+
+double VideoCodecTestBatchRunner::Result::MaxBitrateMismatchPercent() const {
+  double max_mismatch = 0.0;
+  for (double mismatch : bitrate_mismatch_percent) {
+    max_mismatch = std::max(max_mismatch, mismatch);
+  }
+  return max_mismatch;
+}
+
+VideoCodecTestBatchRunner::VideoCodecTestBatchRunner(std::vector<Job> jobs,
+                                                     int num_threads,
+                                                     bool pin_threads)
+    : jobs_(std::move(jobs)),
+      num_threads_(std::max(
+          std::min(num_threads, static_cast<int>(jobs_.size())), 1)),
+      pin_threads_(pin_threads) {
+  for (const Job& job : jobs_) {
+    RTC_CHECK(!job.rate_profiles.empty()) << "No rate profiles: " << job.name;
+  }
+}
+
+VideoCodecTestBatchRunner::~VideoCodecTestBatchRunner() = default;
+
+std::vector<VideoCodecTestBatchRunner::Result>
+VideoCodecTestBatchRunner::Run() {
+  {
+    rtc::CritScope lock(&crit_);
+    next_job_ = 0;
+    next_worker_index_ = 0;
+    results_.clear();
+    results_.resize(jobs_.size());
+  }
+
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < num_threads_; ++i) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        &VideoCodecTestBatchRunner::WorkerThread, this,
+        "VideoCodecTestBatchRunner"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+
+  rtc::CritScope lock(&crit_);
+  return results_;
+}
+
+void VideoCodecTestBatchRunner::PrintResults(std::vector<Result>* results) {
+  for (Result& result : *results) {
+    PrintDistribution("encode_time", result.name, &result.encode_time_us, "us");
+    PrintDistribution("decode_time", result.name, &result.decode_time_us, "us");
+    for (size_t i = 0; i < result.bitrate_kbps.size(); ++i) {
+      const std::string modifier = "_r" + std::to_string(i);
+      PrintResult("bitrate", modifier, result.name, result.bitrate_kbps[i],
+                  "kbps", /*important=*/false);
+      PrintResult("bitrate_mismatch", modifier, result.name,
+                  result.bitrate_mismatch_percent[i], "%",
+                  /*important=*/false, ImproveDirection::kSmallerIsBetter);
+    }
+    PrintResult("max_bitrate_mismatch", "", result.name,
+                result.MaxBitrateMismatchPercent(), "%", /*important=*/false,
+                ImproveDirection::kSmallerIsBetter);
+    PrintResult("wall_time", "", result.name, result.wall_time_ms, "ms",
+                /*important=*/false, ImproveDirection::kSmallerIsBetter);
+  }
+}
+
+void VideoCodecTestBatchRunner::WorkerThread(void* obj) {
+  static_cast<VideoCodecTestBatchRunner*>(obj)->ProcessJobs();
+}
+
+void VideoCodecTestBatchRunner::ProcessJobs() {
+  if (pin_threads_) {
+    int worker_index;
+    {
+      rtc::CritScope lock(&crit_);
+      worker_index = next_worker_index_++;
+    }
+    PinCurrentThread(worker_index);
+  }
+
+  while (true) {
+    size_t job;
+    {
+      rtc::CritScope lock(&crit_);
+      if (next_job_ >= jobs_.size()) {
+        return;
+      }
+      job = next_job_++;
+    }
+    Result result = RunJob(jobs_[job]);
+    rtc::CritScope lock(&crit_);
+    results_[job] = std::move(result);
+  }
+}
+
+VideoCodecTestBatchRunner::Result VideoCodecTestBatchRunner::RunJob(
+    const Job& job) {
+  Result result;
+  result.name = job.name;
+
+  VideoCodecTestFixture::Config config = job.config;
+  config.test_name = job.name;
+  VideoCodecTestFixtureImpl fixture(config);
+  const int64_t start_ms = rtc::TimeMillis();
+  fixture.RunTest(job.rate_profiles, nullptr, nullptr, nullptr);
+  result.wall_time_ms = rtc::TimeMillis() - start_ms;
+
+  const std::vector<VideoCodecTestStats::FrameStatistics> frame_stats =
+      fixture.GetStats().GetFrameStatistics();
+  std::vector<size_t> length_bytes(job.rate_profiles.size(), 0);
+  for (const VideoCodecTestStats::FrameStatistics& frame_stat : frame_stats) {
+    if (frame_stat.encoding_successful) {
+      ++result.num_encoded_frames;
+      result.encode_time_us.AddSample(frame_stat.encode_time_us);
+      // Index of the last rate profile that starts at or before this frame.
+      size_t rate_profile_idx = 0;
+      while (rate_profile_idx + 1 < job.rate_profiles.size() &&
+             job.rate_profiles[rate_profile_idx + 1].frame_num <=
+                 frame_stat.frame_number) {
+        ++rate_profile_idx;
+      }
+      length_bytes[rate_profile_idx] += frame_stat.length_bytes;
+    }
+    if (frame_stat.decoding_successful) {
+      ++result.num_decoded_frames;
+      result.decode_time_us.AddSample(frame_stat.decode_time_us);
+    }
+  }
+
+  for (size_t i = 0; i < job.rate_profiles.size(); ++i) {
+    const RateProfile& rate_profile = job.rate_profiles[i];
+    const size_t end_frame_num = i + 1 < job.rate_profiles.size()
+                                     ? job.rate_profiles[i + 1].frame_num
+                                     : config.num_frames;
+    RTC_CHECK_GT(end_frame_num, rate_profile.frame_num);
+    const double duration_sec =
+        (end_frame_num - rate_profile.frame_num) / rate_profile.input_fps;
+    const double bitrate_kbps = length_bytes[i] * 8 / duration_sec / 1000;
+    result.bitrate_kbps.push_back(bitrate_kbps);
+    result.bitrate_mismatch_percent.push_back(
+        100 * std::fabs(bitrate_kbps - rate_profile.target_kbps) /
+        rate_profile.target_kbps);
+  }
+  return result;
+}
+
+void VideoCodecTestBatchRunner::PinCurrentThread(int worker_index) {
+#if defined(WEBRTC_LINUX)
+  // Threads inherit the affinity of the thread that creates them, so this
+  // also pins the task queue and the codec threads of the jobs.
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  const int cores_per_worker = std::max(num_cores / num_threads_, 1);
+  const int first_core = (worker_index * cores_per_worker) % num_cores;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int i = 0; i < cores_per_worker; ++i) {
+    CPU_SET((first_core + i) % num_cores, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    RTC_LOG(LS_WARNING) << "Failed to pin worker " << worker_index
+                        << " to cores " << first_core << "-"
+                        << first_core + cores_per_worker - 1;
+  }
+#endif
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_TEST_BATCH_RUNNER_H_
+#define MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_TEST_BATCH_RUNNER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "api/test/videocodec_test_fixture.h"
+#include "api/test/videocodec_test_stats.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/numerics/samples_stats_counter.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs a batch of independent codec test configurations, e.g. different
+// codecs, resolutions and bitrates, through VideoCodecTestFixtureImpl in
+// parallel on a number of threads. For each configuration it collects the
+// distributions of the per frame encode and decode times and how well the
+// encoder hit the target bitrate of each rate profile.
+//
+// With |pin_threads|, each worker thread, and thereby the codec threads it
+// creates, is restricted to its own share of the CPU cores, so that
+// concurrent configurations do not compete for the same cores. Configurations
+// should then use a single core, or the codecs will oversubscribe the share.
+// Pinning is only supported on Linux and is ignored elsewhere.
+class VideoCodecTestBatchRunner {
+ public:
+  struct Job {
+    // Used as the user story of the perf results; should be unique.
+    std::string name;
+    VideoCodecTestFixture::Config config;
+    std::vector<RateProfile> rate_profiles;
+  };
+
+  struct Result {
+    std::string name;
+    size_t num_encoded_frames = 0;
+    size_t num_decoded_frames = 0;
+    // Over all successfully encoded or decoded frames of all layers.
+    SamplesStatsCounter encode_time_us;
+    SamplesStatsCounter decode_time_us;
+    // Bitrate produced by the encoder over all layers, and its deviation from
+    // the target, per rate profile.
+    std::vector<double> bitrate_kbps;
+    std::vector<double> bitrate_mismatch_percent;
+    int64_t wall_time_ms = 0;
+
+    // Largest bitrate mismatch over all rate profiles.
+    double MaxBitrateMismatchPercent() const;
+  };
+
+  VideoCodecTestBatchRunner(std::vector<Job> jobs,
+                            int num_threads,
+                            bool pin_threads);
+  ~VideoCodecTestBatchRunner();
+
+  // Runs all jobs and returns the results in the order of the jobs.
+  std::vector<Result> Run();
+
+  // Reports |results| through test::PrintResult(), so that they end up in
+  // the perf results written by test::WritePerfResults().
+  static void PrintResults(std::vector<Result>* results);
+
+ private:
+  static void WorkerThread(void* obj);
+  void ProcessJobs();
+  Result RunJob(const Job& job);
+  void PinCurrentThread(int worker_index);
+
+  const std::vector<Job> jobs_;
+  const int num_threads_;
+  const bool pin_threads_;
+
+  rtc::CriticalSection crit_;
+  size_t next_job_ RTC_GUARDED_BY(crit_) = 0;
+  int next_worker_index_ RTC_GUARDED_BY(crit_) = 0;
+  std::vector<Result> results_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_TEST_BATCH_RUNNER_H_
@@ -9,6 +9,7 @@
  */
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "api/test/create_videocodec_test_fixture.h"
@@ -18,8 +19,10 @@
 #include "media/engine/internal_decoder_factory.h"
 #include "media/engine/internal_encoder_factory.h"
 #include "media/engine/simulcast_encoder_adapter.h"
+#include "modules/video_coding/codecs/test/videocodec_test_batch_runner.h"
 #include "modules/video_coding/utility/vp8_header_parser.h"
 #include "modules/video_coding/utility/vp9_uncompressed_header_parser.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 #include "test/testsupport/file_utils.h"
 
@@ -430,6 +433,39 @@ TEST(VideoCodecTestLibvpx, MAYBE_SvcVP9) {
   fixture->RunTest(rate_profiles, &rc_thresholds, &quality_thresholds, nullptr);
 }
 
+TEST(VideoCodecTestLibvpx, BatchOfConfigurationsInParallel) {
+  std::vector<const char*> codec_names = {cricket::kVp8CodecName};
+#if defined(RTC_ENABLE_VP9)
+  codec_names.push_back(cricket::kVp9CodecName);
+#endif
+  std::vector<VideoCodecTestBatchRunner::Job> jobs;
+  for (const char* codec_name : codec_names) {
+    for (size_t bitrate_kbps : {300, 800}) {
+      VideoCodecTestBatchRunner::Job job;
+      job.name = std::string(codec_name) + "_" + std::to_string(bitrate_kbps);
+      job.config = CreateConfig();
+      job.config.num_frames = kNumFramesShort;
+      job.config.SetCodecSettings(codec_name, 1, 1, 1, false, true, false,
+                                  kCifWidth, kCifHeight);
+      job.rate_profiles = {{bitrate_kbps, 30, 0}};
+      jobs.push_back(std::move(job));
+    }
+  }
+
+  const int num_threads = static_cast<int>(jobs.size());
+  VideoCodecTestBatchRunner runner(jobs, num_threads, /*pin_threads=*/true);
+  std::vector<VideoCodecTestBatchRunner::Result> results = runner.Run();
+  ASSERT_EQ(jobs.size(), results.size());
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    EXPECT_EQ(jobs[i].name, results[i].name);
+    EXPECT_EQ(static_cast<size_t>(kNumFramesShort),
+              results[i].num_encoded_frames);
+    EXPECT_EQ(results[i].num_encoded_frames, results[i].num_decoded_frames);
+    EXPECT_LE(results[i].MaxBitrateMismatchPercent(), 20);
+  }
+  VideoCodecTestBatchRunner::PrintResults(&results);
+}
+
 TEST(VideoCodecTestLibvpx, DISABLED_MultiresVP8RdPerf) {
   auto config = CreateConfig();
   config.filename = "FourPeople_1280x720_30";
@@ -482,5 +518,31 @@ TEST(VideoCodecTestLibvpx, DISABLED_SvcVP9RdPerf) {
   PrintRdPerf(rd_stats);
 }
 
+TEST(VideoCodecTestLibvpx, DISABLED_MultithreadedSvcVP9Perf) {
+  // Compares encode speed of multithreaded SVC with and without row based
+  // multithreading and per spatial layer speed settings.
+  for (const char* field_trials :
+       {"WebRTC-VP9-PerformanceFlags/row_mt:false,per_layer_speed:false/",
+        "WebRTC-VP9-PerformanceFlags/row_mt:true,per_layer_speed:true/"}) {
+    ScopedFieldTrials override_field_trials(field_trials);
+    auto config = CreateConfig();
+    config.filename = "ConferenceMotion_1280_720_50";
+    config.filepath = ResourcePath(config.filename, "yuv");
+    config.num_frames = kNumFramesLong;
+    config.use_single_core = false;
+    config.measure_cpu = true;
+    config.SetCodecSettings(cricket::kVp9CodecName, 1, 3, 3, true, true, false,
+                            1280, 720);
+    auto fixture = CreateVideoCodecTestFixture(config);
+
+    std::vector<RateProfile> rate_profiles = {{1500, 30, 0}};
+    fixture->RunTest(rate_profiles, nullptr, nullptr, nullptr);
+
+    printf("%s\n", field_trials);
+    PrintRdPerf({{1500, fixture->GetStats().SliceAndCalcLayerVideoStatistic(
+                            0, config.num_frames - 1)}});
+  }
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -20,6 +20,7 @@
 #include "absl/types/optional.h"
 #include "api/scoped_refptr.h"
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video/video_frame.h"
 #include "api/video/video_frame_buffer.h"
 #include "api/video/video_rotation.h"
@@ -31,6 +32,7 @@
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
 #include "third_party/libyuv/include/libyuv/convert.h"
+#include "third_party/libyuv/include/libyuv/convert_from.h"
 #include "vpx/vp8.h"
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_decoder.h"
@@ -44,6 +46,7 @@ constexpr int kVp8ErrorPropagationTh = 30;
 constexpr long kDecodeDeadlineRealtime = 1;  // NOLINT
 
 const char kVp8PostProcArmFieldTrial[] = "WebRTC-VP8-Postproc-Config-Arm";
+const char kVp8Nv12OutputFieldTrial[] = "WebRTC-NV12Decode";
 
 void GetPostProcParamsFromFieldTrialGroup(
     LibvpxVp8Decoder::DeblockParams* deblock_params) {
@@ -99,6 +102,7 @@ class LibvpxVp8Decoder::QpSmoother {
 LibvpxVp8Decoder::LibvpxVp8Decoder()
     : use_postproc_arm_(
           webrtc::field_trial::IsEnabled(kVp8PostProcArmFieldTrial)),
+      output_nv12_(webrtc::field_trial::IsEnabled(kVp8Nv12OutputFieldTrial)),
       buffer_pool_(false, 300 /* max_number_of_buffers*/),
       decode_complete_callback_(NULL),
       inited_(false),
@@ -306,24 +310,42 @@ int LibvpxVp8Decoder::ReturnFrame(
   }
   last_frame_width_ = img->d_w;
   last_frame_height_ = img->d_h;
-  // Allocate memory for decoded image.
-  rtc::scoped_refptr<I420Buffer> buffer =
-      buffer_pool_.CreateBuffer(img->d_w, img->d_h);
-  if (!buffer.get()) {
+  // Allocate memory for decoded image, and copy the image, which libvpx owns,
+  // into it. The NV12 output is converted while copying, at no extra cost.
+  rtc::scoped_refptr<VideoFrameBuffer> buffer;
+  if (output_nv12_) {
+    rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+        buffer_pool_.CreateNV12Buffer(img->d_w, img->d_h);
+    if (nv12_buffer) {
+      libyuv::I420ToNV12(img->planes[VPX_PLANE_Y], img->stride[VPX_PLANE_Y],
+                         img->planes[VPX_PLANE_U], img->stride[VPX_PLANE_U],
+                         img->planes[VPX_PLANE_V], img->stride[VPX_PLANE_V],
+                         nv12_buffer->MutableDataY(), nv12_buffer->StrideY(),
+                         nv12_buffer->MutableDataUV(), nv12_buffer->StrideUV(),
+                         img->d_w, img->d_h);
+      buffer = nv12_buffer;
+    }
+  } else {
+    rtc::scoped_refptr<I420Buffer> i420_buffer =
+        buffer_pool_.CreateBuffer(img->d_w, img->d_h);
+    if (i420_buffer) {
+      libyuv::I420Copy(img->planes[VPX_PLANE_Y], img->stride[VPX_PLANE_Y],
+                       img->planes[VPX_PLANE_U], img->stride[VPX_PLANE_U],
+                       img->planes[VPX_PLANE_V], img->stride[VPX_PLANE_V],
+                       i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+                       i420_buffer->MutableDataU(), i420_buffer->StrideU(),
+                       i420_buffer->MutableDataV(), i420_buffer->StrideV(),
+                       img->d_w, img->d_h);
+      buffer = i420_buffer;
+    }
+  }
+  if (!buffer) {
     // Pool has too many pending frames.
     RTC_HISTOGRAM_BOOLEAN("WebRTC.Video.LibvpxVp8Decoder.TooManyPendingFrames",
                           1);
     return WEBRTC_VIDEO_CODEC_NO_OUTPUT;
   }
 
-  libyuv::I420Copy(img->planes[VPX_PLANE_Y], img->stride[VPX_PLANE_Y],
-                   img->planes[VPX_PLANE_U], img->stride[VPX_PLANE_U],
-                   img->planes[VPX_PLANE_V], img->stride[VPX_PLANE_V],
-                   buffer->MutableDataY(), buffer->StrideY(),
-                   buffer->MutableDataU(), buffer->StrideU(),
-                   buffer->MutableDataV(), buffer->StrideV(), img->d_w,
-                   img->d_h);
-
   VideoFrame decoded_image = VideoFrame::Builder()
                                  .set_video_frame_buffer(buffer)
                                  .set_timestamp_rtp(timestamp)
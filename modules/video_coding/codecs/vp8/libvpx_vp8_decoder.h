@@ -52,6 +52,9 @@ class LibvpxVp8Decoder : public VideoDecoder {
                   int qp,
                   const webrtc::ColorSpace* explicit_color_space);
   const bool use_postproc_arm_;
+  // Output NV12 instead of I420, for renderers and hardware encoders that take
+  // NV12 natively.
+  const bool output_nv12_;
 
   I420BufferPool buffer_pool_;
   DecodedImageCallback* decode_complete_callback_;
@@ -36,6 +36,7 @@
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/experiments/field_trial_units.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/field_trial.h"
 #include "third_party/libyuv/include/libyuv/scale.h"
@@ -52,6 +53,15 @@ const char kVP8IosMaxNumberOfThreadFieldTrialParameter[] = "max_thread";
 const char kVp8ForcePartitionResilience[] =
     "WebRTC-VP8-ForcePartitionResilience";
 
+const char kVp8ScreenshareActiveMap[] = "WebRTC-VP8-ScreenshareActiveMap";
+
+// Size of the macroblocks of the active map, in pixels.
+constexpr int kMacroblockSize = 16;
+
+// Number of frames below the steady state qp and size after which the
+// quality is considered to have converged.
+constexpr int kMinSteadyStateFrames = 3;
+
 // QP is obtained from VP8-bitstream for HW, so the QP corresponds to the
 // bitstream range of [0, 127] and not the user-level range of [0,63].
 constexpr int kLowVp8QpThreshold = 29;
@@ -66,6 +76,15 @@ constexpr int kRtpTicksPerMs = kRtpTicksPerSecond / 1000;
 constexpr double kLowRateFactor = 1.0;
 constexpr double kHighRateFactor = 2.0;
 
+std::unique_ptr<EncoderComplexityController> CreateComplexityController() {
+  absl::optional<EncoderComplexityController::Config> config =
+      EncoderComplexityController::ParseFieldTrial();
+  if (!config) {
+    return nullptr;
+  }
+  return std::make_unique<EncoderComplexityController>(*config);
+}
+
 // VP8 denoiser states.
 enum denoiserState : uint32_t {
   kDenoiserOff,
@@ -285,7 +304,9 @@ LibvpxVp8Encoder::LibvpxVp8Encoder(std::unique_ptr<LibvpxInterface> interface,
       key_frame_request_(kMaxSimulcastStreams, false),
       variable_framerate_experiment_(ParseVariableFramerateConfig(
           "WebRTC-VP8VariableFramerateScreenshare")),
-      framerate_controller_(variable_framerate_experiment_.framerate_limit) {
+      framerate_controller_(variable_framerate_experiment_.framerate_limit),
+      use_active_map_(field_trial::IsEnabled(kVp8ScreenshareActiveMap)),
+      complexity_controller_(CreateComplexityController()) {
   // TODO(eladalon/ilnik): These reservations might be wasting memory.
   // InitEncode() is resizing to the actual size, which might be smaller.
   raw_images_.reserve(kMaxSimulcastStreams);
@@ -357,6 +378,9 @@ void LibvpxVp8Encoder::SetRates(const RateControlParameters& parameters) {
   }
 
   codec_.maxFramerate = static_cast<uint32_t>(parameters.framerate_fps + 0.5);
+  if (complexity_controller_) {
+    complexity_controller_->SetFramerate(parameters.framerate_fps);
+  }
 
   if (encoders_.size() > 1) {
     // If we have more than 1 stream, reduce the qp_max for the low resolution
@@ -523,6 +547,8 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   send_stream_[0] = true;  // For non-simulcast case.
   cpu_speed_.resize(number_of_streams);
   std::fill(key_frame_request_.begin(), key_frame_request_.end(), false);
+  changed_rects_.assign(number_of_streams, VideoFrame::UpdateRect{0, 0, 0, 0});
+  active_map_set_.assign(number_of_streams, false);
 
   int idx = number_of_streams - 1;
   for (int i = 0; i < (number_of_streams - 1); ++i, --idx) {
@@ -706,6 +732,16 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   return InitAndSetControlSettings();
 }
 
+void LibvpxVp8Encoder::SetCpuSpeed() {
+  const int speed_offset =
+      complexity_controller_ ? complexity_controller_->speed_offset() : 0;
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    // VP8 speeds up with the magnitude of cpu_speed, down to -16.
+    libvpx_->codec_control(&(encoders_[i]), VP8E_SET_CPUUSED,
+                           std::max(-16, cpu_speed_[i] - speed_offset));
+  }
+}
+
 int LibvpxVp8Encoder::GetCpuSpeed(int width, int height) {
 #if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || \
     defined(WEBRTC_ANDROID)
@@ -825,12 +861,16 @@ int LibvpxVp8Encoder::InitAndSetControlSettings() {
         &encoders_[1], VP8E_SET_NOISE_SENSITIVITY,
         codec_.VP8()->denoisingOn ? denoiser_state : kDenoiserOff);
   }
+  if (complexity_controller_) {
+    complexity_controller_->Reset();
+    complexity_controller_->SetFramerate(codec_.maxFramerate);
+  }
+  SetCpuSpeed();
   for (size_t i = 0; i < encoders_.size(); ++i) {
     // Allow more screen content to be detected as static.
     libvpx_->codec_control(
         &(encoders_[i]), VP8E_SET_STATIC_THRESHOLD,
         codec_.mode == VideoCodecMode::kScreensharing ? 100u : 1u);
-    libvpx_->codec_control(&(encoders_[i]), VP8E_SET_CPUUSED, cpu_speed_[i]);
     libvpx_->codec_control(
         &(encoders_[i]), VP8E_SET_TOKEN_PARTITIONS,
         static_cast<vp8e_token_partitions>(kTokenPartitions));
@@ -962,7 +1002,17 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     }
   }
 
-  if (frame.update_rect().IsEmpty() && num_steady_state_frames_ >= 3 &&
+  // Accumulated before the frame may be dropped, so that the changes of
+  // dropped frames are encoded with the next one.
+  const bool use_active_maps = use_active_map_ &&
+                               codec_.mode == VideoCodecMode::kScreensharing &&
+                               codec_.VP8()->numberOfTemporalLayers <= 1;
+  if (use_active_maps) {
+    AccumulateChangedRects(frame);
+  }
+
+  if (frame.update_rect().IsEmpty() &&
+      num_steady_state_frames_ >= kMinSteadyStateFrames &&
       !key_frame_requested) {
     if (variable_framerate_experiment_.enabled &&
         framerate_controller_.DropFrame(frame.timestamp() / kRtpTicksPerMs)) {
@@ -994,25 +1044,12 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     flags[i] = send_key_frame ? VPX_EFLAG_FORCE_KF : EncodeFlags(tl_configs[i]);
   }
 
-  rtc::scoped_refptr<I420BufferInterface> input_image =
-      frame.video_frame_buffer()->ToI420();
-  // Since we are extracting raw pointers from |input_image| to
-  // |raw_images_[0]|, the resolution of these frames must match.
-  RTC_DCHECK_EQ(input_image->width(), raw_images_[0].d_w);
-  RTC_DCHECK_EQ(input_image->height(), raw_images_[0].d_h);
-
-  // Image in vpx_image_t format.
-  // Input image is const. VP8's raw image is not defined as const.
-  raw_images_[0].planes[VPX_PLANE_Y] =
-      const_cast<uint8_t*>(input_image->DataY());
-  raw_images_[0].planes[VPX_PLANE_U] =
-      const_cast<uint8_t*>(input_image->DataU());
-  raw_images_[0].planes[VPX_PLANE_V] =
-      const_cast<uint8_t*>(input_image->DataV());
-
-  raw_images_[0].stride[VPX_PLANE_Y] = input_image->StrideY();
-  raw_images_[0].stride[VPX_PLANE_U] = input_image->StrideU();
-  raw_images_[0].stride[VPX_PLANE_V] = input_image->StrideV();
+  rtc::scoped_refptr<VideoFrameBuffer> input_image =
+      PrepareBuffers(frame.video_frame_buffer());
+  if (!input_image) {
+    RTC_LOG(LS_ERROR) << "Failed to convert input frame to I420.";
+    return WEBRTC_VIDEO_CODEC_ENCODER_FAILURE;
+  }
 
   struct CleanUpOnExit {
     explicit CleanUpOnExit(vpx_image_t& raw_image) : raw_image_(raw_image) {}
@@ -1024,22 +1061,6 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     vpx_image_t& raw_image_;
   } clean_up_on_exit(raw_images_[0]);
 
-  for (size_t i = 1; i < encoders_.size(); ++i) {
-    // Scale the image down a number of times by downsampling factor
-    libyuv::I420Scale(
-        raw_images_[i - 1].planes[VPX_PLANE_Y],
-        raw_images_[i - 1].stride[VPX_PLANE_Y],
-        raw_images_[i - 1].planes[VPX_PLANE_U],
-        raw_images_[i - 1].stride[VPX_PLANE_U],
-        raw_images_[i - 1].planes[VPX_PLANE_V],
-        raw_images_[i - 1].stride[VPX_PLANE_V], raw_images_[i - 1].d_w,
-        raw_images_[i - 1].d_h, raw_images_[i].planes[VPX_PLANE_Y],
-        raw_images_[i].stride[VPX_PLANE_Y], raw_images_[i].planes[VPX_PLANE_U],
-        raw_images_[i].stride[VPX_PLANE_U], raw_images_[i].planes[VPX_PLANE_V],
-        raw_images_[i].stride[VPX_PLANE_V], raw_images_[i].d_w,
-        raw_images_[i].d_h, libyuv::kFilterBilinear);
-  }
-
   if (send_key_frame) {
     // Adapt the size of the key frame when in screenshare with 1 temporal
     // layer.
@@ -1054,6 +1075,10 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     std::fill(key_frame_request_.begin(), key_frame_request_.end(), false);
   }
 
+  if (use_active_maps) {
+    SetActiveMaps(send_key_frame);
+  }
+
   // Set the encoder frame flags and temporal layer_id for each spatial stream.
   // Note that streams are defined starting from lowest resolution at
   // position 0 to highest resolution at position |encoders_.size() - 1|,
@@ -1079,6 +1104,7 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
   assert(codec_.maxFramerate > 0);
   uint32_t duration = kRtpTicksPerSecond / codec_.maxFramerate;
 
+  const int64_t encode_start_us = rtc::TimeMicros();
   int error = WEBRTC_VIDEO_CODEC_OK;
   int num_tries = 0;
   // If the first try returns WEBRTC_VIDEO_CODEC_TARGET_BITRATE_OVERSHOOT
@@ -1103,6 +1129,11 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     // Examines frame timestamps only.
     error = GetEncodedPartitions(frame, retransmission_allowed);
   }
+  if (complexity_controller_ &&
+      complexity_controller_->OnFrameEncoded(rtc::TimeMicros() -
+                                             encode_start_us)) {
+    SetCpuSpeed();
+  }
   // TODO(sprang): Shouldn't we use the frame timestamp instead?
   timestamp_ += duration;
   return error;
@@ -1199,6 +1230,7 @@ int LibvpxVp8Encoder::GetEncodedPartitions(const VideoFrame& input_image,
         encoded_images_[encoder_idx].qp_ = qp_128;
         encoded_complete_callback_->OnEncodedImage(encoded_images_[encoder_idx],
                                                    &codec_specific, nullptr);
+        changed_rects_[encoder_idx].MakeEmptyUpdate();
         const size_t steady_state_size = SteadyStateSize(
             stream_idx, codec_specific.codecSpecific.VP8.temporalIdx);
         if (qp_128 > variable_framerate_experiment_.steady_state_qp ||
@@ -1221,6 +1253,164 @@ int LibvpxVp8Encoder::GetEncodedPartitions(const VideoFrame& input_image,
   return result;
 }
 
+void LibvpxVp8Encoder::AccumulateChangedRects(const VideoFrame& frame) {
+  const VideoFrame::UpdateRect update_rect =
+      frame.has_update_rect()
+          ? frame.update_rect()
+          : VideoFrame::UpdateRect{0, 0, frame.width(), frame.height()};
+  if (update_rect.IsEmpty()) {
+    return;
+  }
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    const int width = raw_images_[i].d_w;
+    const int height = raw_images_[i].d_h;
+    if (width == frame.width() && height == frame.height()) {
+      changed_rects_[i].Union(update_rect);
+    } else {
+      VideoFrame::UpdateRect scaled_rect = update_rect.ScaleWithFrame(
+          frame.width(), frame.height(), 0, 0, frame.width(), frame.height(),
+          width, height);
+      scaled_rect.Intersect(VideoFrame::UpdateRect{0, 0, width, height});
+      changed_rects_[i].Union(scaled_rect);
+    }
+  }
+}
+
+void LibvpxVp8Encoder::SetActiveMaps(bool key_frame) {
+  for (size_t i = 0; i < encoders_.size(); ++i) {
+    const int width = raw_images_[i].d_w;
+    const int height = raw_images_[i].d_h;
+    const VideoFrame::UpdateRect& rect = changed_rects_[i];
+    const bool full_frame = rect.offset_x == 0 && rect.offset_y == 0 &&
+                            rect.width >= width && rect.height >= height;
+    // Until the quality has converged, unchanged frames still refine the
+    // whole picture. Afterwards they leave all macroblocks inactive.
+    const bool restrict_to_rect =
+        !key_frame && !full_frame &&
+        (!rect.IsEmpty() || num_steady_state_frames_ >= kMinSteadyStateFrames);
+    if (!restrict_to_rect && !active_map_set_[i]) {
+      continue;
+    }
+
+    vpx_active_map_t active_map;
+    active_map.cols = (width + kMacroblockSize - 1) / kMacroblockSize;
+    active_map.rows = (height + kMacroblockSize - 1) / kMacroblockSize;
+    active_map.active_map = nullptr;
+    if (restrict_to_rect) {
+      active_map_.assign(active_map.rows * active_map.cols, 0);
+      if (!rect.IsEmpty()) {
+        const int first_col = rect.offset_x / kMacroblockSize;
+        const int end_col =
+            (rect.offset_x + rect.width + kMacroblockSize - 1) /
+            kMacroblockSize;
+        const int end_row =
+            (rect.offset_y + rect.height + kMacroblockSize - 1) /
+            kMacroblockSize;
+        for (int row = rect.offset_y / kMacroblockSize; row < end_row; ++row) {
+          std::fill_n(active_map_.begin() + row * active_map.cols + first_col,
+                      end_col - first_col, 1);
+        }
+      }
+      active_map.active_map = active_map_.data();
+    }
+    if (libvpx_->codec_control(&encoders_[i], VP8E_SET_ACTIVEMAP,
+                               &active_map) != VPX_CODEC_OK) {
+      RTC_LOG(LS_WARNING) << "Failed to set the active map.";
+      continue;
+    }
+    active_map_set_[i] = restrict_to_rect;
+  }
+}
+
+void LibvpxVp8Encoder::MaybeUpdatePixelFormat(vpx_img_fmt fmt) {
+  RTC_DCHECK(!raw_images_.empty());
+  if (raw_images_[0].fmt == fmt)
+    return;
+  RTC_LOG(LS_INFO) << "Updating vp8 encoder pixel format to "
+                   << (fmt == VPX_IMG_FMT_NV12 ? "NV12" : "I420");
+  for (size_t i = 0; i < raw_images_.size(); ++i) {
+    vpx_image_t& img = raw_images_[i];
+    unsigned int width = img.d_w;
+    unsigned int height = img.d_h;
+    libvpx_->img_free(&img);
+    // The first image wraps the input frame, the others are allocated.
+    if (i == 0) {
+      libvpx_->img_wrap(&img, fmt, width, height, 1, nullptr);
+    } else {
+      libvpx_->img_alloc(&img, fmt, width, height, kVp832ByteAlign);
+    }
+  }
+}
+
+rtc::scoped_refptr<VideoFrameBuffer> LibvpxVp8Encoder::PrepareBuffers(
+    rtc::scoped_refptr<VideoFrameBuffer> buffer) {
+  // Since we are extracting raw pointers from |buffer| to |raw_images_[0]|,
+  // the resolution of these frames must match.
+  RTC_DCHECK_EQ(buffer->width(), raw_images_[0].d_w);
+  RTC_DCHECK_EQ(buffer->height(), raw_images_[0].d_h);
+
+  // Image in vpx_image_t format.
+  // Input image is const. VP8's raw image is not defined as const.
+  if (buffer->type() == VideoFrameBuffer::Type::kNV12) {
+    const NV12BufferInterface* nv12_buffer = buffer->GetNV12();
+    MaybeUpdatePixelFormat(VPX_IMG_FMT_NV12);
+    raw_images_[0].planes[VPX_PLANE_Y] =
+        const_cast<uint8_t*>(nv12_buffer->DataY());
+    raw_images_[0].planes[VPX_PLANE_U] =
+        const_cast<uint8_t*>(nv12_buffer->DataUV());
+    raw_images_[0].planes[VPX_PLANE_V] = raw_images_[0].planes[VPX_PLANE_U] + 1;
+    raw_images_[0].stride[VPX_PLANE_Y] = nv12_buffer->StrideY();
+    raw_images_[0].stride[VPX_PLANE_U] = nv12_buffer->StrideUV();
+    raw_images_[0].stride[VPX_PLANE_V] = nv12_buffer->StrideUV();
+
+    for (size_t i = 1; i < encoders_.size(); ++i) {
+      // Scale the image down a number of times by downsampling factor.
+      libyuv::NV12Scale(
+          raw_images_[i - 1].planes[VPX_PLANE_Y],
+          raw_images_[i - 1].stride[VPX_PLANE_Y],
+          raw_images_[i - 1].planes[VPX_PLANE_U],
+          raw_images_[i - 1].stride[VPX_PLANE_U], raw_images_[i - 1].d_w,
+          raw_images_[i - 1].d_h, raw_images_[i].planes[VPX_PLANE_Y],
+          raw_images_[i].stride[VPX_PLANE_Y],
+          raw_images_[i].planes[VPX_PLANE_U],
+          raw_images_[i].stride[VPX_PLANE_U], raw_images_[i].d_w,
+          raw_images_[i].d_h, libyuv::kFilterBilinear);
+    }
+    return buffer;
+  }
+
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer = buffer->ToI420();
+  if (!i420_buffer)
+    return nullptr;
+  MaybeUpdatePixelFormat(VPX_IMG_FMT_I420);
+  raw_images_[0].planes[VPX_PLANE_Y] =
+      const_cast<uint8_t*>(i420_buffer->DataY());
+  raw_images_[0].planes[VPX_PLANE_U] =
+      const_cast<uint8_t*>(i420_buffer->DataU());
+  raw_images_[0].planes[VPX_PLANE_V] =
+      const_cast<uint8_t*>(i420_buffer->DataV());
+  raw_images_[0].stride[VPX_PLANE_Y] = i420_buffer->StrideY();
+  raw_images_[0].stride[VPX_PLANE_U] = i420_buffer->StrideU();
+  raw_images_[0].stride[VPX_PLANE_V] = i420_buffer->StrideV();
+
+  for (size_t i = 1; i < encoders_.size(); ++i) {
+    // Scale the image down a number of times by downsampling factor.
+    libyuv::I420Scale(
+        raw_images_[i - 1].planes[VPX_PLANE_Y],
+        raw_images_[i - 1].stride[VPX_PLANE_Y],
+        raw_images_[i - 1].planes[VPX_PLANE_U],
+        raw_images_[i - 1].stride[VPX_PLANE_U],
+        raw_images_[i - 1].planes[VPX_PLANE_V],
+        raw_images_[i - 1].stride[VPX_PLANE_V], raw_images_[i - 1].d_w,
+        raw_images_[i - 1].d_h, raw_images_[i].planes[VPX_PLANE_Y],
+        raw_images_[i].stride[VPX_PLANE_Y], raw_images_[i].planes[VPX_PLANE_U],
+        raw_images_[i].stride[VPX_PLANE_U], raw_images_[i].planes[VPX_PLANE_V],
+        raw_images_[i].stride[VPX_PLANE_V], raw_images_[i].d_w,
+        raw_images_[i].d_h, libyuv::kFilterBilinear);
+  }
+  return i420_buffer;
+}
+
 VideoEncoder::EncoderInfo LibvpxVp8Encoder::GetEncoderInfo() const {
   EncoderInfo info;
   info.supports_native_handle = false;
@@ -1230,6 +1420,8 @@ VideoEncoder::EncoderInfo LibvpxVp8Encoder::GetEncoderInfo() const {
   info.is_hardware_accelerated = false;
   info.has_internal_source = false;
   info.supports_simulcast = true;
+  info.preferred_pixel_formats = {VideoFrameBuffer::Type::kI420,
+                                  VideoFrameBuffer::Type::kNV12};
   if (!resolution_bitrate_limits_.empty()) {
     info.resolution_bitrate_limits = resolution_bitrate_limits_;
   }
@@ -24,6 +24,7 @@
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/codecs/vp8/libvpx_interface.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
 #include "modules/video_coding/utility/framerate_controller.h"
 #include "rtc_base/experiments/cpu_speed_experiment.h"
 #include "rtc_base/experiments/rate_control_settings.h"
@@ -64,6 +65,10 @@ class LibvpxVp8Encoder : public VideoEncoder {
   static vpx_enc_frame_flags_t EncodeFlags(const Vp8FrameConfig& references);
 
  private:
+  // Sets the cpu_speed of the encoders, from |cpu_speed_| and the speed offset
+  // of |complexity_controller_|.
+  void SetCpuSpeed();
+
   // Get the cpu_speed setting for encoder based on resolution and/or platform.
   int GetCpuSpeed(int width, int height);
 
@@ -93,6 +98,21 @@ class LibvpxVp8Encoder : public VideoEncoder {
 
   bool UpdateVpxConfiguration(size_t stream_index);
 
+  // Adds the update rect of |frame|, scaled to the resolution of each
+  // encoder, to |changed_rects_|.
+  void AccumulateChangedRects(const VideoFrame& frame);
+  // Limits the macroblocks encoded by each encoder to its |changed_rects_|.
+  void SetActiveMaps(bool key_frame);
+
+  // Switches |raw_images_| to |fmt| if the input pixel format changed.
+  void MaybeUpdatePixelFormat(vpx_img_fmt fmt);
+  // Points |raw_images_[0]| at the pixels of |buffer|, converting to I420 if
+  // libvpx can't take its format, and downscales into the other raw images.
+  // Returns the buffer that has to be kept alive while encoding, or nullptr
+  // if the conversion failed.
+  rtc::scoped_refptr<VideoFrameBuffer> PrepareBuffers(
+      rtc::scoped_refptr<VideoFrameBuffer> buffer);
+
   const std::unique_ptr<LibvpxInterface> libvpx_;
 
   const absl::optional<std::vector<CpuSpeedExperiment::Config>>
@@ -139,6 +159,20 @@ class LibvpxVp8Encoder : public VideoEncoder {
   FramerateController framerate_controller_;
   int num_steady_state_frames_ = 0;
 
+  // Delta frames of screenshares with a single temporal layer are only
+  // encoded where the input changed since the last encoded frame. Skipped
+  // macroblocks are copied from that frame.
+  const bool use_active_map_;
+  // Per encoder, the area changed since its last encoded frame, and whether an
+  // active map is set.
+  std::vector<VideoFrame::UpdateRect> changed_rects_;
+  std::vector<bool> active_map_set_;
+  std::vector<uint8_t> active_map_;
+
+  // Speeds up the encoders from |cpu_speed_| when encoding takes too long,
+  // if the field trial is enabled.
+  const std::unique_ptr<EncoderComplexityController> complexity_controller_;
+
   FecControllerOverride* fec_controller_override_ = nullptr;
 };
 
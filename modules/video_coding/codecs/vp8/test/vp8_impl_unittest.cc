@@ -16,6 +16,7 @@
 #include "api/test/frame_generator_interface.h"
 #include "api/test/mock_video_decoder.h"
 #include "api/test/mock_video_encoder.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video_codecs/video_encoder.h"
 #include "api/video_codecs/vp8_temporal_layers.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
@@ -33,6 +34,7 @@ namespace webrtc {
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::Contains;
 using ::testing::ElementsAreArray;
 using ::testing::Field;
 using ::testing::Invoke;
@@ -400,6 +402,63 @@ TEST_F(TestVp8Impl, MAYBE_AlignedStrideEncodeDecode) {
   EXPECT_EQ(kInitialTimestampRtp, decoded_frame->timestamp());
 }
 
+#if defined(WEBRTC_ANDROID)
+#define MAYBE_EncodeNV12FrameThenI420Frame DISABLED_EncodeNV12FrameThenI420Frame
+#else
+#define MAYBE_EncodeNV12FrameThenI420Frame EncodeNV12FrameThenI420Frame
+#endif
+TEST_F(TestVp8Impl, MAYBE_EncodeNV12FrameThenI420Frame) {
+  EXPECT_THAT(encoder_->GetEncoderInfo().preferred_pixel_formats,
+              Contains(VideoFrameBuffer::Type::kNV12));
+  VideoFrame input_frame = NextInputFrame();
+  VideoFrame nv12_frame = VideoFrame::Builder()
+                              .set_video_frame_buffer(NV12Buffer::Copy(
+                                  *input_frame.video_frame_buffer()->ToI420()))
+                              .set_timestamp_rtp(input_frame.timestamp())
+                              .build();
+  EncodedImage encoded_frame;
+  CodecSpecificInfo codec_specific_info;
+  EncodeAndWaitForFrame(nv12_frame, &encoded_frame, &codec_specific_info);
+
+  encoded_frame._frameType = VideoFrameType::kVideoFrameKey;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder_->Decode(encoded_frame, false, -1));
+  std::unique_ptr<VideoFrame> decoded_frame;
+  absl::optional<uint8_t> decoded_qp;
+  ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+  ASSERT_TRUE(decoded_frame);
+  EXPECT_GT(I420PSNR(&input_frame, decoded_frame.get()), 36);
+
+  // Switching back to I420 input re-wraps the raw images.
+  EncodeAndWaitForFrame(NextInputFrame(), &encoded_frame, &codec_specific_info);
+}
+
+class TestVp8ImplWithNV12Output : public TestVp8Impl {
+ private:
+  test::ScopedFieldTrials field_trials_{"WebRTC-NV12Decode/Enabled/"};
+};
+
+#if defined(WEBRTC_ANDROID)
+#define MAYBE_DecodesToNV12 DISABLED_DecodesToNV12
+#else
+#define MAYBE_DecodesToNV12 DecodesToNV12
+#endif
+TEST_F(TestVp8ImplWithNV12Output, MAYBE_DecodesToNV12) {
+  VideoFrame input_frame = NextInputFrame();
+  EncodedImage encoded_frame;
+  CodecSpecificInfo codec_specific_info;
+  EncodeAndWaitForFrame(input_frame, &encoded_frame, &codec_specific_info);
+
+  encoded_frame._frameType = VideoFrameType::kVideoFrameKey;
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, decoder_->Decode(encoded_frame, false, -1));
+  std::unique_ptr<VideoFrame> decoded_frame;
+  absl::optional<uint8_t> decoded_qp;
+  ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+  ASSERT_TRUE(decoded_frame);
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12,
+            decoded_frame->video_frame_buffer()->type());
+  EXPECT_GT(I420PSNR(&input_frame, decoded_frame.get()), 36);
+}
+
 #if defined(WEBRTC_ANDROID)
 #define MAYBE_DecodeWithACompleteKeyFrame DISABLED_DecodeWithACompleteKeyFrame
 #else
@@ -552,6 +611,93 @@ TEST_F(TestVp8Impl, KeepsTimestampOnReencode) {
   encoder.Encode(NextInputFrame(), &delta_frame);
 }
 
+TEST_F(TestVp8Impl, SetsActiveMapFromUpdateRectInScreenshare) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-VP8-ScreenshareActiveMap/Enabled/");
+  auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
+  LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)),
+                           VP8Encoder::Settings());
+  codec_settings_.mode = VideoCodecMode::kScreensharing;
+  codec_settings_.VP8()->numberOfTemporalLayers = 1;
+
+  ON_CALL(*vpx, img_wrap(_, _, _, _, _, _))
+      .WillByDefault(Invoke([](vpx_image_t* img, vpx_img_fmt_t fmt,
+                               unsigned int d_w, unsigned int d_h,
+                               unsigned int stride_align,
+                               unsigned char* img_data) {
+        img->fmt = fmt;
+        img->d_w = d_w;
+        img->d_h = d_h;
+        img->img_data = img_data;
+        return img;
+      }));
+  // Every encode call outputs a small frame.
+  uint8_t payload[10] = {0};
+  vpx_codec_cx_pkt_t packet = {};
+  packet.kind = VPX_CODEC_CX_FRAME_PKT;
+  packet.data.frame.buf = payload;
+  packet.data.frame.sz = sizeof(payload);
+  ON_CALL(*vpx, codec_get_cx_data(_, _))
+      .WillByDefault(Invoke(
+          [&packet](vpx_codec_ctx_t*,
+                    vpx_codec_iter_t* iter) -> const vpx_codec_cx_pkt_t* {
+            if (*iter) {
+              return nullptr;
+            }
+            *iter = &packet;
+            return &packet;
+          }));
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder.InitEncode(&codec_settings_,
+                               VideoEncoder::Settings(kCapabilities, 1, 1000)));
+  NiceMock<MockEncodedImageCallback> callback;
+  ON_CALL(callback, OnEncodedImage)
+      .WillByDefault(Return(
+          EncodedImageCallback::Result(EncodedImageCallback::Result::OK)));
+  encoder.RegisterEncodeCompleteCallback(&callback);
+
+  // A 172x144 frame has 11x9 macroblocks.
+  std::vector<uint8_t> active_map;
+  EXPECT_CALL(*vpx, codec_control(_, VP8E_SET_ACTIVEMAP,
+                                  ::testing::An<vpx_active_map*>()))
+      .WillOnce(Invoke([&active_map](vpx_codec_ctx_t*, vp8e_enc_control_id,
+                                     vpx_active_map* map) {
+        EXPECT_EQ(map->cols, 11u);
+        EXPECT_EQ(map->rows, 9u);
+        EXPECT_TRUE(map->active_map);
+        if (map->active_map) {
+          active_map.assign(map->active_map,
+                            map->active_map + map->rows * map->cols);
+        }
+        return VPX_CODEC_OK;
+      }))
+      .WillOnce(Invoke(
+          [](vpx_codec_ctx_t*, vp8e_enc_control_id, vpx_active_map* map) {
+            // Unchanged areas are encoded again after a frame without an
+            // update rect.
+            EXPECT_FALSE(map->active_map);
+            return VPX_CODEC_OK;
+          }));
+
+  auto key_frame = std::vector<VideoFrameType>{VideoFrameType::kVideoFrameKey};
+  auto delta_frame =
+      std::vector<VideoFrameType>{VideoFrameType::kVideoFrameDelta};
+  encoder.Encode(NextInputFrame(), &key_frame);
+
+  VideoFrame frame = NextInputFrame();
+  frame.set_update_rect(VideoFrame::UpdateRect{40, 20, 10, 4});
+  encoder.Encode(frame, &delta_frame);
+  // Columns 2 and 3 of row 1.
+  std::vector<uint8_t> expected_active_map(11 * 9, 0);
+  expected_active_map[1 * 11 + 2] = 1;
+  expected_active_map[1 * 11 + 3] = 1;
+  EXPECT_EQ(active_map, expected_active_map);
+
+  frame = NextInputFrame();
+  frame.clear_update_rect();
+  encoder.Encode(frame, &delta_frame);
+}
+
 TEST(LibvpxVp8EncoderTest, GetEncoderInfoReturnsStaticInformation) {
   auto* const vpx = new NiceMock<MockLibvpxVp8Interface>();
   LibvpxVp8Encoder encoder((std::unique_ptr<LibvpxInterface>(vpx)),
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
+
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using Vp9FrameBuffer = Vp9FrameBufferPool::Vp9FrameBuffer;
+
+constexpr size_t kSmallSize = 1000;
+constexpr size_t kLargeSize = 4000;
+
+class Vp9FrameBufferPoolTest : public ::testing::Test {
+ protected:
+  Vp9FrameBufferPoolTest() {
+    clock_.SetTime(Timestamp::Seconds(1000));
+    Vp9FrameBufferPool::SetMemoryBudget(0);
+  }
+  ~Vp9FrameBufferPoolTest() override { Vp9FrameBufferPool::SetMemoryBudget(0); }
+
+  rtc::ScopedFakeClock clock_;
+  Vp9FrameBufferPool pool_;
+};
+
+TEST_F(Vp9FrameBufferPoolTest, RecyclesSmallestBufferThatFits) {
+  rtc::scoped_refptr<Vp9FrameBuffer> large = pool_.GetFrameBuffer(kLargeSize);
+  rtc::scoped_refptr<Vp9FrameBuffer> small = pool_.GetFrameBuffer(kSmallSize);
+  Vp9FrameBuffer* const large_ptr = large.get();
+  Vp9FrameBuffer* const small_ptr = small.get();
+  large = nullptr;
+  small = nullptr;
+
+  EXPECT_EQ(small_ptr, pool_.GetFrameBuffer(kSmallSize).get());
+  EXPECT_EQ(large_ptr, pool_.GetFrameBuffer(kLargeSize).get());
+  EXPECT_EQ(0, pool_.GetNumBuffersInUse());
+}
+
+TEST_F(Vp9FrameBufferPoolTest, CountsAllocatedBytes) {
+  const size_t total_bytes = Vp9FrameBufferPool::GetTotalAllocatedBytes();
+  rtc::scoped_refptr<Vp9FrameBuffer> buffer = pool_.GetFrameBuffer(kSmallSize);
+  EXPECT_EQ(buffer->GetCapacity(), pool_.GetAllocatedBytes());
+  EXPECT_EQ(total_bytes + buffer->GetCapacity(),
+            Vp9FrameBufferPool::GetTotalAllocatedBytes());
+
+  buffer = nullptr;
+  pool_.ReleaseUnusedBuffers();
+  EXPECT_EQ(0u, pool_.GetAllocatedBytes());
+  EXPECT_EQ(total_bytes, Vp9FrameBufferPool::GetTotalAllocatedBytes());
+}
+
+TEST_F(Vp9FrameBufferPoolTest, DeletesIdleBuffers) {
+  rtc::scoped_refptr<Vp9FrameBuffer> in_use = pool_.GetFrameBuffer(kSmallSize);
+  pool_.GetFrameBuffer(kLargeSize);
+
+  // The large buffer would fit, but has been idle for too long.
+  clock_.AdvanceTime(TimeDelta::Millis(kIdleBufferTimeoutMs));
+  rtc::scoped_refptr<Vp9FrameBuffer> buffer = pool_.GetFrameBuffer(kSmallSize);
+  EXPECT_EQ(in_use->GetCapacity() + buffer->GetCapacity(),
+            pool_.GetAllocatedBytes());
+  EXPECT_LT(buffer->GetCapacity(), kLargeSize);
+}
+
+TEST_F(Vp9FrameBufferPoolTest, MemoryBudgetIsSharedByPools) {
+  Vp9FrameBufferPool other_pool;
+  other_pool.GetFrameBuffer(kSmallSize);
+  Vp9FrameBufferPool::SetMemoryBudget(
+      Vp9FrameBufferPool::GetTotalAllocatedBytes() + kSmallSize - 1);
+
+  // The available buffer of |other_pool| is deleted to stay within budget.
+  rtc::scoped_refptr<Vp9FrameBuffer> buffer = pool_.GetFrameBuffer(kSmallSize);
+  EXPECT_TRUE(buffer);
+  EXPECT_EQ(0u, other_pool.GetAllocatedBytes());
+
+  // No available buffers are left to delete.
+  EXPECT_FALSE(pool_.GetFrameBuffer(kLargeSize));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -153,6 +153,30 @@ TEST_F(TestVp9Impl, EncodeDecode) {
             color_space.chroma_siting_vertical());
 }
 
+TEST_F(TestVp9Impl, DecodesAfterAdjustingThreadsToKeyFrameResolution) {
+  // More decoder threads than 720p has tile columns, so the decoder is
+  // recreated with fewer threads on the key frame.
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            decoder_->InitDecode(&codec_settings_, /*number_of_cores=*/8));
+
+  for (int frame_num = 0; frame_num < 3; ++frame_num) {
+    VideoFrame input_frame = NextInputFrame();
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->Encode(input_frame, nullptr));
+    EncodedImage encoded_frame;
+    CodecSpecificInfo codec_specific_info;
+    ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
+    EXPECT_EQ(frame_num == 0,
+              encoded_frame._frameType == VideoFrameType::kVideoFrameKey);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              decoder_->Decode(encoded_frame, false, 0));
+    std::unique_ptr<VideoFrame> decoded_frame;
+    absl::optional<uint8_t> decoded_qp;
+    ASSERT_TRUE(WaitForDecodedFrame(&decoded_frame, &decoded_qp));
+    ASSERT_TRUE(decoded_frame);
+    EXPECT_GT(I420PSNR(&input_frame, decoded_frame.get()), 36);
+  }
+}
+
 TEST_F(TestVp9Impl, DecodedColorSpaceFromBitstream) {
   EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK, encoder_->Encode(NextInputFrame(), nullptr));
   EncodedImage encoded_frame;
@@ -1701,6 +1725,40 @@ TEST_F(TestVp9Impl, EncodeWithDynamicRate) {
   ASSERT_TRUE(WaitForEncodedFrame(&encoded_frame, &codec_specific_info));
 }
 
+TEST_F(TestVp9Impl, EncodesSvcMultithreadedWithPerformanceFlags) {
+  // Configure performance flags field trial and re-create the encoder.
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-VP9-PerformanceFlags/"
+      "row_mt:false,max_threads:2,per_layer_speed:true/");
+  SetUp();
+
+  const size_t num_spatial_layers = 3;
+  ConfigureSvc(num_spatial_layers);
+  const VideoEncoder::Settings multicore_settings(kCapabilities,
+                                                  /*number_of_cores=*/4,
+                                                  /*max_payload_size=*/0);
+  EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+            encoder_->InitEncode(&codec_settings_, multicore_settings));
+
+  VideoBitrateAllocation bitrate_allocation;
+  for (size_t sl_idx = 0; sl_idx < num_spatial_layers; ++sl_idx) {
+    bitrate_allocation.SetBitrate(
+        sl_idx, 0, codec_settings_.spatialLayers[sl_idx].targetBitrate * 1000);
+  }
+  encoder_->SetRates(VideoEncoder::RateControlParameters(
+      bitrate_allocation, codec_settings_.maxFramerate));
+
+  for (int frame_num = 0; frame_num < 3; ++frame_num) {
+    SetWaitForEncodedFramesThreshold(num_spatial_layers);
+    EXPECT_EQ(WEBRTC_VIDEO_CODEC_OK,
+              encoder_->Encode(NextInputFrame(), nullptr));
+    std::vector<EncodedImage> frames;
+    std::vector<CodecSpecificInfo> codec_specific;
+    ASSERT_TRUE(WaitForEncodedFrames(&frames, &codec_specific));
+    EXPECT_EQ(num_spatial_layers, frames.size());
+  }
+}
+
 TEST_F(TestVp9Impl, ReenablingUpperLayerAfterKFWithInterlayerPredIsEnabled) {
   const size_t num_spatial_layers = 2;
   const int num_frames_to_encode = 10;
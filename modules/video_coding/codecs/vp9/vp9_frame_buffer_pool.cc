@@ -13,14 +13,35 @@
 
 #include "modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
 
+#include <atomic>
+#include <set>
+
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/time_utils.h"
 #include "vpx/vpx_codec.h"
 #include "vpx/vpx_decoder.h"
 #include "vpx/vpx_frame_buffer.h"
 
 namespace webrtc {
+namespace {
+
+// How often a pool looks for idle buffers.
+constexpr int64_t kIdleCheckIntervalMs = 1000;
+
+rtc::GlobalLock g_pools_lock;
+std::atomic<size_t> g_total_allocated_bytes(0);
+std::atomic<size_t> g_memory_budget_bytes(0);
+
+std::set<Vp9FrameBufferPool*>& GetPools()
+    RTC_EXCLUSIVE_LOCKS_REQUIRED(g_pools_lock) {
+  // google.github.io/styleguide/cppguide.html#Static_and_Global_Variables
+  static auto& pools = *new std::set<Vp9FrameBufferPool*>();
+  return pools;
+}
+
+}  // namespace
 
 uint8_t* Vp9FrameBufferPool::Vp9FrameBuffer::GetData() {
   return data_.data<uint8_t>();
@@ -30,10 +51,27 @@ size_t Vp9FrameBufferPool::Vp9FrameBuffer::GetDataSize() const {
   return data_.size();
 }
 
+size_t Vp9FrameBufferPool::Vp9FrameBuffer::GetCapacity() const {
+  return data_.capacity();
+}
+
 void Vp9FrameBufferPool::Vp9FrameBuffer::SetSize(size_t size) {
   data_.SetSize(size);
 }
 
+Vp9FrameBufferPool::Vp9FrameBufferPool() {
+  rtc::GlobalLockScope lock(&g_pools_lock);
+  GetPools().insert(this);
+}
+
+Vp9FrameBufferPool::~Vp9FrameBufferPool() {
+  {
+    rtc::GlobalLockScope lock(&g_pools_lock);
+    GetPools().erase(this);
+  }
+  ClearPool();
+}
+
 bool Vp9FrameBufferPool::InitializeVpxUsePool(
     vpx_codec_ctx* vpx_codec_context) {
   RTC_DCHECK(vpx_codec_context);
@@ -56,44 +94,93 @@ bool Vp9FrameBufferPool::InitializeVpxUsePool(
 rtc::scoped_refptr<Vp9FrameBufferPool::Vp9FrameBuffer>
 Vp9FrameBufferPool::GetFrameBuffer(size_t min_size) {
   RTC_DCHECK_GT(min_size, 0);
-  rtc::scoped_refptr<Vp9FrameBuffer> available_buffer = nullptr;
-  {
-    rtc::CritScope cs(&buffers_lock_);
-    // Do we have a buffer we can recycle?
-    for (const auto& buffer : allocated_buffers_) {
-      if (buffer->HasOneRef()) {
-        available_buffer = buffer;
-        break;
-      }
+  rtc::scoped_refptr<Vp9FrameBuffer> buffer =
+      GetFrameBufferWithinBudget(min_size);
+  if (buffer == nullptr) {
+    // Delete the available buffers of all pools and try again. This is done
+    // without holding |buffers_lock_|, since it takes the locks of all pools.
+    OnMemoryPressure();
+    buffer = GetFrameBufferWithinBudget(min_size);
+    if (buffer == nullptr) {
+      RTC_LOG(LS_WARNING) << "A Vp9FrameBuffer of " << min_size
+                          << " bytes would exceed the memory budget of "
+                          << g_memory_budget_bytes.load() << " bytes.";
     }
-    // Otherwise create one.
-    if (available_buffer == nullptr) {
-      available_buffer = new rtc::RefCountedObject<Vp9FrameBuffer>();
-      allocated_buffers_.push_back(available_buffer);
-      if (allocated_buffers_.size() > max_num_buffers_) {
-        RTC_LOG(LS_WARNING)
-            << allocated_buffers_.size()
-            << " Vp9FrameBuffers have been "
-               "allocated by a Vp9FrameBufferPool (exceeding what is "
-               "considered reasonable, "
-            << max_num_buffers_ << ").";
-
-        // TODO(phoglund): this limit is being hit in tests since Oct 5 2016.
-        // See https://bugs.chromium.org/p/webrtc/issues/detail?id=6484.
-        // RTC_NOTREACHED();
-      }
+  }
+  return buffer;
+}
+
+rtc::scoped_refptr<Vp9FrameBufferPool::Vp9FrameBuffer>
+Vp9FrameBufferPool::GetFrameBufferWithinBudget(size_t min_size) {
+  const int64_t now_ms = rtc::TimeMillis();
+  rtc::CritScope cs(&buffers_lock_);
+  if (now_ms - last_idle_check_ms_ >= kIdleCheckIntervalMs) {
+    last_idle_check_ms_ = now_ms;
+    RemoveUnusedBuffers([now_ms](const PooledBuffer& pooled) {
+      return now_ms - pooled.last_used_ms >= kIdleBufferTimeoutMs;
+    });
+  }
+
+  // Do we have a buffer we can recycle? Prefer the smallest one that fits,
+  // otherwise grow the largest one.
+  auto is_better_fit = [min_size](size_t capacity, size_t best_capacity) {
+    const bool fits = capacity >= min_size;
+    if (fits != (best_capacity >= min_size))
+      return fits;
+    return fits ? capacity < best_capacity : capacity > best_capacity;
+  };
+  PooledBuffer* available = nullptr;
+  for (PooledBuffer& pooled : allocated_buffers_) {
+    if (pooled.buffer->HasOneRef() &&
+        (available == nullptr ||
+         is_better_fit(pooled.buffer->GetCapacity(),
+                       available->buffer->GetCapacity()))) {
+      available = &pooled;
+    }
+  }
+
+  const size_t available_capacity =
+      available ? available->buffer->GetCapacity() : 0;
+  const size_t budget = g_memory_budget_bytes.load();
+  if (budget > 0 && available_capacity < min_size &&
+      g_total_allocated_bytes.load() + min_size - available_capacity >
+          budget) {
+    return nullptr;
+  }
+
+  // Otherwise create one.
+  if (available == nullptr) {
+    allocated_buffers_.push_back(
+        {new rtc::RefCountedObject<Vp9FrameBuffer>(), now_ms});
+    available = &allocated_buffers_.back();
+    if (allocated_buffers_.size() > max_num_buffers_) {
+      RTC_LOG(LS_WARNING)
+          << allocated_buffers_.size()
+          << " Vp9FrameBuffers have been "
+             "allocated by a Vp9FrameBufferPool (exceeding what is "
+             "considered reasonable, "
+          << max_num_buffers_ << ").";
+
+      // TODO(phoglund): this limit is being hit in tests since Oct 5 2016.
+      // See https://bugs.chromium.org/p/webrtc/issues/detail?id=6484.
+      // RTC_NOTREACHED();
     }
   }
 
-  available_buffer->SetSize(min_size);
-  return available_buffer;
+  available->buffer->SetSize(min_size);
+  const size_t grown_bytes =
+      available->buffer->GetCapacity() - available_capacity;
+  allocated_bytes_ += grown_bytes;
+  g_total_allocated_bytes += grown_bytes;
+  available->last_used_ms = now_ms;
+  return available->buffer;
 }
 
 int Vp9FrameBufferPool::GetNumBuffersInUse() const {
   int num_buffers_in_use = 0;
   rtc::CritScope cs(&buffers_lock_);
-  for (const auto& buffer : allocated_buffers_) {
-    if (!buffer->HasOneRef())
+  for (const auto& pooled : allocated_buffers_) {
+    if (!pooled.buffer->HasOneRef())
       ++num_buffers_in_use;
   }
   return num_buffers_in_use;
@@ -102,12 +189,12 @@ int Vp9FrameBufferPool::GetNumBuffersInUse() const {
 bool Vp9FrameBufferPool::Resize(size_t max_number_of_buffers) {
   rtc::CritScope cs(&buffers_lock_);
   size_t used_buffers_count = 0;
-  for (const auto& buffer : allocated_buffers_) {
+  for (const auto& pooled : allocated_buffers_) {
     // If the buffer is in use, the ref count will be >= 2, one from the list we
     // are looping over and one from the application. If the ref count is 1,
     // then the list we are looping over holds the only reference and it's safe
     // to reuse.
-    if (!buffer->HasOneRef()) {
+    if (!pooled.buffer->HasOneRef()) {
       used_buffers_count++;
     }
   }
@@ -116,22 +203,66 @@ bool Vp9FrameBufferPool::Resize(size_t max_number_of_buffers) {
   }
   max_num_buffers_ = max_number_of_buffers;
 
-  size_t buffers_to_purge = allocated_buffers_.size() - max_num_buffers_;
+  size_t buffers_to_purge = allocated_buffers_.size() > max_num_buffers_
+                                ? allocated_buffers_.size() - max_num_buffers_
+                                : 0;
+  RemoveUnusedBuffers([&buffers_to_purge](const PooledBuffer&) {
+    if (buffers_to_purge == 0)
+      return false;
+    --buffers_to_purge;
+    return true;
+  });
+  return true;
+}
+
+void Vp9FrameBufferPool::ClearPool() {
+  rtc::CritScope cs(&buffers_lock_);
+  // Buffers still in use are no longer accounted for.
+  g_total_allocated_bytes -= allocated_bytes_;
+  allocated_bytes_ = 0;
+  allocated_buffers_.clear();
+}
+
+void Vp9FrameBufferPool::ReleaseUnusedBuffers() {
+  rtc::CritScope cs(&buffers_lock_);
+  RemoveUnusedBuffers([](const PooledBuffer&) { return true; });
+}
+
+size_t Vp9FrameBufferPool::GetAllocatedBytes() const {
+  rtc::CritScope cs(&buffers_lock_);
+  return allocated_bytes_;
+}
+
+template <typename Predicate>
+void Vp9FrameBufferPool::RemoveUnusedBuffers(Predicate predicate) {
   auto iter = allocated_buffers_.begin();
-  while (iter != allocated_buffers_.end() && buffers_to_purge > 0) {
-    if ((*iter)->HasOneRef()) {
+  while (iter != allocated_buffers_.end()) {
+    if (iter->buffer->HasOneRef() && predicate(*iter)) {
+      const size_t capacity = iter->buffer->GetCapacity();
+      allocated_bytes_ -= capacity;
+      g_total_allocated_bytes -= capacity;
       iter = allocated_buffers_.erase(iter);
-      buffers_to_purge--;
     } else {
       ++iter;
     }
   }
-  return true;
 }
 
-void Vp9FrameBufferPool::ClearPool() {
-  rtc::CritScope cs(&buffers_lock_);
-  allocated_buffers_.clear();
+// static
+void Vp9FrameBufferPool::SetMemoryBudget(size_t max_bytes) {
+  g_memory_budget_bytes = max_bytes;
+}
+
+// static
+size_t Vp9FrameBufferPool::GetTotalAllocatedBytes() {
+  return g_total_allocated_bytes.load();
+}
+
+// static
+void Vp9FrameBufferPool::OnMemoryPressure() {
+  rtc::GlobalLockScope lock(&g_pools_lock);
+  for (Vp9FrameBufferPool* pool : GetPools())
+    pool->ReleaseUnusedBuffers();
 }
 
 // static
@@ -151,6 +282,8 @@ int32_t Vp9FrameBufferPool::VpxGetFrameBuffer(void* user_priv,
   Vp9FrameBufferPool* pool = static_cast<Vp9FrameBufferPool*>(user_priv);
 
   rtc::scoped_refptr<Vp9FrameBuffer> buffer = pool->GetFrameBuffer(min_size);
+  if (buffer == nullptr)
+    return -1;
   fb->data = buffer->GetData();
   fb->size = buffer->GetDataSize();
   // Store Vp9FrameBuffer* in |priv| for use in VpxReleaseFrameBuffer.
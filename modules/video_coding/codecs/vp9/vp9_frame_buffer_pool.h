@@ -14,6 +14,9 @@
 
 #ifdef RTC_ENABLE_VP9
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <vector>
 
 #include "api/scoped_refptr.h"
@@ -37,6 +40,9 @@ namespace webrtc {
 // video.
 constexpr size_t kDefaultMaxNumBuffers = 68;
 
+// Buffers that have not been handed out for this long are deleted.
+constexpr int64_t kIdleBufferTimeoutMs = 10000;
+
 // This memory pool is used to serve buffers to libvpx for decoding purposes in
 // VP9, which is set up in InitializeVPXUsePool. After the initialization any
 // time libvpx wants to decode a frame it will use buffers provided and released
@@ -63,12 +69,16 @@ constexpr size_t kDefaultMaxNumBuffers = 68;
 //
 //    // Destroying the codec will make libvpx release any buffers it was using.
 //    vpx_codec_destroy(decoder_ctx);
+//
+// All pools of the process share an optional memory budget, see
+// SetMemoryBudget().
 class Vp9FrameBufferPool {
  public:
   class Vp9FrameBuffer : public rtc::RefCountInterface {
    public:
     uint8_t* GetData();
     size_t GetDataSize() const;
+    size_t GetCapacity() const;
     void SetSize(size_t size);
 
     virtual bool HasOneRef() const = 0;
@@ -78,13 +88,17 @@ class Vp9FrameBufferPool {
     rtc::Buffer data_;
   };
 
+  Vp9FrameBufferPool();
+  ~Vp9FrameBufferPool();
+
   // Configures libvpx to, in the specified context, use this memory pool for
   // buffers used to decompress frames. This is only supported for VP9.
   bool InitializeVpxUsePool(vpx_codec_ctx* vpx_codec_context);
 
-  // Gets a frame buffer of at least |min_size|, recycling an available one or
-  // creating a new one. When no longer referenced from the outside the buffer
-  // becomes recyclable.
+  // Gets a frame buffer of at least |min_size|, recycling the smallest
+  // available one that fits or creating a new one. When no longer referenced
+  // from the outside the buffer becomes recyclable. Returns null if a new
+  // buffer would exceed the memory budget.
   rtc::scoped_refptr<Vp9FrameBuffer> GetFrameBuffer(size_t min_size);
   // Gets the number of buffers currently in use (not ready to be recycled).
   int GetNumBuffersInUse() const;
@@ -95,6 +109,20 @@ class Vp9FrameBufferPool {
   // Releases allocated buffers, deleting available buffers. Buffers in use are
   // not deleted until they are no longer referenced.
   void ClearPool();
+  // Deletes the available buffers, keeping the ones in use.
+  void ReleaseUnusedBuffers();
+  // Gets the number of bytes allocated by buffers of the pool.
+  size_t GetAllocatedBytes() const;
+
+  // Limits the bytes allocated by all pools of the process to |max_bytes|, 0
+  // means no limit. Buffers allocated before are not affected.
+  static void SetMemoryBudget(size_t max_bytes);
+  // Gets the number of bytes allocated by all pools of the process.
+  static size_t GetTotalAllocatedBytes();
+  // Deletes the available buffers of all pools of the process. Called when
+  // the memory budget is exceeded, and may be called by the application on
+  // memory pressure.
+  static void OnMemoryPressure();
 
   // InitializeVpxUsePool configures libvpx to call this function when it needs
   // a new frame buffer. Parameters:
@@ -118,11 +146,25 @@ class Vp9FrameBufferPool {
                                        vpx_codec_frame_buffer* fb);
 
  private:
+  struct PooledBuffer {
+    rtc::scoped_refptr<Vp9FrameBuffer> buffer;
+    // When the buffer was last handed out.
+    int64_t last_used_ms;
+  };
+
+  rtc::scoped_refptr<Vp9FrameBuffer> GetFrameBufferWithinBudget(
+      size_t min_size);
+  // Deletes available buffers for which |predicate| returns true.
+  template <typename Predicate>
+  void RemoveUnusedBuffers(Predicate predicate)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(buffers_lock_);
+
   // Protects |allocated_buffers_|.
   rtc::CriticalSection buffers_lock_;
   // All buffers, in use or ready to be recycled.
-  std::vector<rtc::scoped_refptr<Vp9FrameBuffer>> allocated_buffers_
-      RTC_GUARDED_BY(buffers_lock_);
+  std::vector<PooledBuffer> allocated_buffers_ RTC_GUARDED_BY(buffers_lock_);
+  size_t allocated_bytes_ RTC_GUARDED_BY(buffers_lock_) = 0;
+  int64_t last_idle_check_ms_ RTC_GUARDED_BY(buffers_lock_) = 0;
   size_t max_num_buffers_ = kDefaultMaxNumBuffers;
 };
 
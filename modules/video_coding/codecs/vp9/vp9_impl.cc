@@ -76,6 +76,19 @@ int GetCpuSpeed(int width, int height) {
     return 7;
 #endif
 }
+
+// Returns the number of decoder threads for frames |width| pixels wide. libvpx
+// decodes tile columns in parallel, and a tile column is at least 256 pixels
+// wide, so more threads than possible tile columns are left idle.
+int NumberOfDecoderThreads(int width, int number_of_cores) {
+  int max_tile_columns = 1;
+  while (max_tile_columns < kMaxNumTiles4kVideo &&
+         width / (2 * max_tile_columns) >= 256) {
+    max_tile_columns *= 2;
+  }
+  return std::max(1, std::min(number_of_cores, max_tile_columns));
+}
+
 // Helper class for extracting VP9 colorspace.
 ColorSpace ExtractVP9ColorSpace(vpx_color_space_t space_t,
                                 vpx_color_range_t range_t,
@@ -250,7 +263,8 @@ VP9EncoderImpl::VP9EncoderImpl(const cricket::VideoCodec& codec)
       variable_framerate_controller_(
           variable_framerate_experiment_.framerate_limit),
       num_steady_state_frames_(0),
-      config_changed_(true) {
+      config_changed_(true),
+      performance_flags_(ParsePerformanceFlagsFromTrials()) {
   codec_ = {};
   memset(&svc_params_, 0, sizeof(vpx_svc_extra_cfg_t));
 }
@@ -646,21 +660,24 @@ int VP9EncoderImpl::NumberOfThreads(int width,
                                     int number_of_cores) {
   // Keep the number of encoder threads equal to the possible number of column
   // tiles, which is (1, 2, 4, 8). See comments below for VP9E_SET_TILE_COLUMNS.
-  if (width * height >= 1280 * 720 && number_of_cores > 4) {
-    return 4;
+  int num_threads = 1;
+  if (width * height >= 1920 * 1080 && number_of_cores > 8) {
+    num_threads = 8;
+  } else if (width * height >= 1280 * 720 && number_of_cores > 4) {
+    num_threads = 4;
   } else if (width * height >= 640 * 360 && number_of_cores > 2) {
-    return 2;
+    num_threads = 2;
   } else {
 // Use 2 threads for low res on ARM.
 #if defined(WEBRTC_ARCH_ARM) || defined(WEBRTC_ARCH_ARM64) || \
     defined(WEBRTC_ANDROID)
     if (width * height >= 320 * 180 && number_of_cores > 2) {
-      return 2;
+      num_threads = 2;
     }
 #endif
     // 1 thread less than VGA.
-    return 1;
   }
+  return std::max(1, std::min(num_threads, performance_flags_.max_num_threads));
 }
 
 int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
@@ -740,6 +757,19 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   vpx_codec_control(encoder_, VP9E_SET_SVC_GF_TEMPORAL_REF, 0);
 
   if (is_svc_) {
+    // A speed of 0 leaves the layer at |cpu_speed_|.
+    const bool use_per_layer_speed = performance_flags_.use_per_layer_speed &&
+                                     num_spatial_layers_ > 1 &&
+                                     config_->g_threads > 1;
+    for (size_t si = 0; si < num_spatial_layers_; ++si) {
+      svc_params_.speed_per_layer[si] =
+          use_per_layer_speed
+              ? GetCpuSpeed(codec_.width * svc_params_.scaling_factor_num[si] /
+                                svc_params_.scaling_factor_den[si],
+                            codec_.height * svc_params_.scaling_factor_num[si] /
+                                svc_params_.scaling_factor_den[si])
+              : 0;
+    }
     vpx_codec_control(encoder_, VP9E_SET_SVC, 1);
     vpx_codec_control(encoder_, VP9E_SET_SVC_PARAMETERS, &svc_params_);
   }
@@ -804,11 +834,17 @@ int VP9EncoderImpl::InitAndSetControlSettings(const VideoCodec* inst) {
   // Control function to set the number of column tiles in encoding a frame, in
   // log2 unit: e.g., 0 = 1 tile column, 1 = 2 tile columns, 2 = 4 tile columns.
   // The number tile columns will be capped by the encoder based on image size
-  // (minimum width of tile column is 256 pixels, maximum is 4096).
-  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, (config_->g_threads >> 1));
-
-  // Turn on row-based multithreading.
-  vpx_codec_control(encoder_, VP9E_SET_ROW_MT, 1);
+  // (minimum width of tile column is 256 pixels, maximum is 4096), so the low
+  // spatial layers get fewer tiles.
+  int log2_tile_columns = 0;
+  while ((2 << log2_tile_columns) <= static_cast<int>(config_->g_threads))
+    ++log2_tile_columns;
+  vpx_codec_control(encoder_, VP9E_SET_TILE_COLUMNS, log2_tile_columns);
+
+  // Row-based multithreading, on by default, lets several threads work within
+  // a tile.
+  vpx_codec_control(encoder_, VP9E_SET_ROW_MT,
+                    performance_flags_.use_row_mt ? 1 : 0);
 
 #if !defined(WEBRTC_ARCH_ARM) && !defined(WEBRTC_ARCH_ARM64) && \
     !defined(ANDROID)
@@ -970,7 +1006,23 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
   rtc::scoped_refptr<const I010BufferInterface> i010_copy;
   switch (profile_) {
     case VP9Profile::kProfile0: {
+      // libvpx takes NV12 directly. |input_image| keeps the buffer alive.
+      if (input_image.video_frame_buffer()->type() ==
+          VideoFrameBuffer::Type::kNV12) {
+        const NV12BufferInterface* nv12_buffer =
+            input_image.video_frame_buffer()->GetNV12();
+        MaybeRewrapRawWithFormat(VPX_IMG_FMT_NV12);
+        raw_->planes[VPX_PLANE_Y] = const_cast<uint8_t*>(nv12_buffer->DataY());
+        raw_->planes[VPX_PLANE_U] =
+            const_cast<uint8_t*>(nv12_buffer->DataUV());
+        raw_->planes[VPX_PLANE_V] = raw_->planes[VPX_PLANE_U] + 1;
+        raw_->stride[VPX_PLANE_Y] = nv12_buffer->StrideY();
+        raw_->stride[VPX_PLANE_U] = nv12_buffer->StrideUV();
+        raw_->stride[VPX_PLANE_V] = nv12_buffer->StrideUV();
+        break;
+      }
       i420_buffer = input_image.video_frame_buffer()->ToI420();
+      MaybeRewrapRawWithFormat(VPX_IMG_FMT_I420);
       // Image in vpx_image_t format.
       // Input image is const. VPX's raw image is not defined as const.
       raw_->planes[VPX_PLANE_Y] = const_cast<uint8_t*>(i420_buffer->DataY());
@@ -1550,6 +1602,16 @@ int VP9EncoderImpl::RegisterEncodeCompleteCallback(
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void VP9EncoderImpl::MaybeRewrapRawWithFormat(vpx_img_fmt fmt) {
+  RTC_DCHECK(raw_);
+  if (raw_->fmt == fmt)
+    return;
+  RTC_LOG(LS_INFO) << "Switching VP9 encoder pixel format to "
+                   << (fmt == VPX_IMG_FMT_NV12 ? "NV12" : "I420");
+  vpx_img_free(raw_);
+  raw_ = vpx_img_wrap(nullptr, fmt, codec_.width, codec_.height, 1, nullptr);
+}
+
 VideoEncoder::EncoderInfo VP9EncoderImpl::GetEncoderInfo() const {
   EncoderInfo info;
   info.supports_native_handle = false;
@@ -1558,6 +1620,10 @@ VideoEncoder::EncoderInfo VP9EncoderImpl::GetEncoderInfo() const {
   info.has_trusted_rate_controller = trusted_rate_controller_;
   info.is_hardware_accelerated = false;
   info.has_internal_source = false;
+  if (profile_ == VP9Profile::kProfile0) {
+    info.preferred_pixel_formats = {VideoFrameBuffer::Type::kI420,
+                                    VideoFrameBuffer::Type::kNV12};
+  }
   if (inited_) {
     // Find the max configured fps of any active spatial layer.
     float max_fps = 0.0;
@@ -1627,11 +1693,29 @@ VP9EncoderImpl::ParseVariableFramerateConfig(std::string group_name) {
   return config;
 }
 
+// static
+VP9EncoderImpl::PerformanceFlags
+VP9EncoderImpl::ParsePerformanceFlagsFromTrials() {
+  FieldTrialParameter<bool> use_row_mt("row_mt", true);
+  FieldTrialParameter<int> max_num_threads("max_threads", 8);
+  FieldTrialParameter<bool> use_per_layer_speed("per_layer_speed", true);
+  ParseFieldTrial({&use_row_mt, &max_num_threads, &use_per_layer_speed},
+                  field_trial::FindFullName("WebRTC-VP9-PerformanceFlags"));
+  PerformanceFlags flags;
+  flags.use_row_mt = use_row_mt.Get();
+  flags.max_num_threads = max_num_threads.Get();
+  flags.use_per_layer_speed = use_per_layer_speed.Get();
+  return flags;
+}
+
 VP9DecoderImpl::VP9DecoderImpl()
     : decode_complete_callback_(nullptr),
       inited_(false),
       decoder_(nullptr),
-      key_frame_required_(true) {}
+      key_frame_required_(true),
+      num_cores_(1),
+      num_threads_(0),
+      last_decoded_width_(0) {}
 
 VP9DecoderImpl::~VP9DecoderImpl() {
   inited_ = true;  // in order to do the actual release
@@ -1656,8 +1740,6 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   if (decoder_ == nullptr) {
     decoder_ = new vpx_codec_ctx_t;
   }
-  vpx_codec_dec_cfg_t cfg;
-  memset(&cfg, 0, sizeof(cfg));
 
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
   // We focus on webrtc fuzzing here, not libvpx itself. Use single thread for
@@ -1665,21 +1747,18 @@ int VP9DecoderImpl::InitDecode(const VideoCodec* inst, int number_of_cores) {
   //  - libvpx's VP9 single thread decoder is more fuzzer friendly. It detects
   //    errors earlier than the multi-threads version.
   //  - Make peak CPU usage under control (not depending on input)
-  cfg.threads = 1;
-  (void)kMaxNumTiles4kVideo;  // unused
+  num_cores_ = 1;
+  int num_threads = 1;
 #else
   // We want to use multithreading when decoding high resolution videos. But,
-  // since we don't know resolution of input stream at this stage, we always
-  // enable it.
-  cfg.threads = std::min(number_of_cores, kMaxNumTiles4kVideo);
+  // since we don't know resolution of input stream at this stage, we start
+  // with the maximum and adjust the threads to the resolution of key frames.
+  num_cores_ = number_of_cores;
+  int num_threads = std::min(number_of_cores, kMaxNumTiles4kVideo);
 #endif
+  last_decoded_width_ = 0;
 
-  vpx_codec_flags_t flags = 0;
-  if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
-    return WEBRTC_VIDEO_CODEC_MEMORY;
-  }
-
-  if (!frame_buffer_pool_.InitializeVpxUsePool(decoder_)) {
+  if (!InitDecoderContext(num_threads)) {
     return WEBRTC_VIDEO_CODEC_MEMORY;
   }
 
@@ -1720,6 +1799,12 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
   if (input_image.size() == 0) {
     buffer = nullptr;  // Triggers full frame concealment.
   }
+  if (buffer && input_image._frameType == VideoFrameType::kVideoFrameKey) {
+    int ret = MaybeUpdateDecoderThreads(input_image);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
+    }
+  }
   // During decode libvpx may get and release buffers from |frame_buffer_pool_|.
   // In practice libvpx keeps a few (~3-4) buffers alive at a time.
   if (vpx_codec_decode(decoder_, buffer,
@@ -1731,6 +1816,9 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
   // It may be released by libvpx during future vpx_codec_decode or
   // vpx_codec_destroy calls.
   img = vpx_codec_get_frame(decoder_, &iter);
+  if (img) {
+    last_decoded_width_ = img->d_w;
+  }
   int qp;
   vpx_codec_err_t vpx_ret =
       vpx_codec_control(decoder_, VPXD_GET_LAST_QUANTIZER, &qp);
@@ -1743,6 +1831,57 @@ int VP9DecoderImpl::Decode(const EncodedImage& input_image,
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+bool VP9DecoderImpl::InitDecoderContext(int num_threads) {
+  vpx_codec_dec_cfg_t cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.threads = num_threads;
+  vpx_codec_flags_t flags = 0;
+  if (vpx_codec_dec_init(decoder_, vpx_codec_vp9_dx(), &cfg, flags)) {
+    return false;
+  }
+  // Row based multithreading also decodes the rows within a tile column and
+  // the loop filter in parallel, which balances uneven tiles.
+  if (num_threads > 1) {
+    vpx_codec_control(decoder_, VP9D_SET_ROW_MT, 1);
+  }
+  num_threads_ = num_threads;
+  return frame_buffer_pool_.InitializeVpxUsePool(decoder_);
+}
+
+int VP9DecoderImpl::MaybeUpdateDecoderThreads(const EncodedImage& key_frame) {
+  // The peeked size is the one of the first frame in a superframe, i.e. the
+  // lowest spatial layer, so the size of the previous output frame is taken
+  // into account as well.
+  vpx_codec_stream_info_t info;
+  memset(&info, 0, sizeof(info));
+  info.sz = sizeof(info);
+  int width = last_decoded_width_;
+  if (vpx_codec_peek_stream_info(vpx_codec_vp9_dx(), key_frame.data(),
+                                 static_cast<unsigned int>(key_frame.size()),
+                                 &info) == VPX_CODEC_OK) {
+    width = std::max(width, static_cast<int>(info.w));
+  }
+  const int num_threads = NumberOfDecoderThreads(width, num_cores_);
+  if (num_threads == num_threads_) {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  // A key frame doesn't depend on previous frames, so the decoder can be
+  // recreated. Destroying it releases the buffers it references, but buffers
+  // of frames still held by the application stay alive until those frames
+  // are released, and then go back to |frame_buffer_pool_| for reuse. The
+  // threads decode in parallel within one frame, so they don't need more
+  // buffers from the pool.
+  RTC_LOG(LS_INFO) << "Reconfiguring VP9 decoder from " << num_threads_
+                   << " to " << num_threads << " threads for width " << width;
+  inited_ = false;
+  if (vpx_codec_destroy(decoder_) || !InitDecoderContext(num_threads)) {
+    return WEBRTC_VIDEO_CODEC_MEMORY;
+  }
+  inited_ = true;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
 int VP9DecoderImpl::ReturnFrame(
     const vpx_image_t* img,
     uint32_t timestamp,
@@ -98,6 +98,9 @@ class VP9EncoderImpl : public VP9Encoder {
 
   size_t SteadyStateSize(int sid, int tid);
 
+  // Re-wraps |raw_| if the input pixel format of profile 0 changed.
+  void MaybeRewrapRawWithFormat(vpx_img_fmt fmt);
+
   EncodedImage encoded_image_;
   CodecSpecificInfo codec_specific_;
   EncodedImageCallback* encoded_complete_callback_;
@@ -178,6 +181,19 @@ class VP9EncoderImpl : public VP9Encoder {
   int num_steady_state_frames_;
   // Only set config when this flag is set.
   bool config_changed_;
+
+  // Multithreading and speed settings, see WebRTC-VP9-PerformanceFlags.
+  const struct PerformanceFlags {
+    // Use libvpx row-based multithreading within each tile.
+    bool use_row_mt;
+    // Upper bound of the encoder threads picked by NumberOfThreads().
+    int max_num_threads;
+    // Give each spatial layer the speed of its own resolution, so that the
+    // cheap low layers are encoded with a slower, more efficient setting than
+    // the top layer. Only used with spare cores, i.e. more than one thread.
+    bool use_per_layer_speed;
+  } performance_flags_;
+  static PerformanceFlags ParsePerformanceFlagsFromTrials();
 };
 
 class VP9DecoderImpl : public VP9Decoder {
@@ -199,6 +215,11 @@ class VP9DecoderImpl : public VP9Decoder {
   const char* ImplementationName() const override;
 
  private:
+  // Initializes |decoder_| to decode with |num_threads| threads.
+  bool InitDecoderContext(int num_threads);
+  // Recreates |decoder_| if the resolution of |key_frame| calls for another
+  // number of decoder threads.
+  int MaybeUpdateDecoderThreads(const EncodedImage& key_frame);
   int ReturnFrame(const vpx_image_t* img,
                   uint32_t timestamp,
                   int qp,
@@ -210,6 +231,9 @@ class VP9DecoderImpl : public VP9Decoder {
   bool inited_;
   vpx_codec_ctx_t* decoder_;
   bool key_frame_required_;
+  int num_cores_;
+  int num_threads_;
+  int last_decoded_width_;
 };
 }  // namespace webrtc
 
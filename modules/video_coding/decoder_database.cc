@@ -110,12 +110,34 @@ VCMGenericDecoder* VCMDecoderDataBase::GetDecoder(
   if (payload_type == receive_codec_.plType || payload_type == 0) {
     return ptr_decoder_.get();
   }
+  return SwitchDecoder(payload_type, frame.EncodedImage()._encodedWidth,
+                       frame.EncodedImage()._encodedHeight,
+                       decoded_frame_callback);
+}
+
+bool VCMDecoderDataBase::PrepareDecoder(
+    uint8_t payload_type,
+    VCMDecodedFrameCallback* decoded_frame_callback) {
+  RTC_DCHECK(decoded_frame_callback->UserReceiveCallback());
+  if (payload_type == receive_codec_.plType) {
+    return ptr_decoder_ != nullptr;
+  }
+  return SwitchDecoder(payload_type, /*width=*/0, /*height=*/0,
+                       decoded_frame_callback) != nullptr;
+}
+
+VCMGenericDecoder* VCMDecoderDataBase::SwitchDecoder(
+    uint8_t payload_type,
+    int width,
+    int height,
+    VCMDecodedFrameCallback* decoded_frame_callback) {
   // If decoder exists - delete.
   if (ptr_decoder_) {
     ptr_decoder_.reset();
     memset(&receive_codec_, 0, sizeof(VideoCodec));
   }
-  ptr_decoder_ = CreateAndInitDecoder(frame, &receive_codec_);
+  ptr_decoder_ =
+      CreateAndInitDecoder(payload_type, width, height, &receive_codec_);
   if (!ptr_decoder_) {
     return nullptr;
   }
@@ -135,9 +157,10 @@ bool VCMDecoderDataBase::PrefersLateDecoding() const {
 }
 
 std::unique_ptr<VCMGenericDecoder> VCMDecoderDataBase::CreateAndInitDecoder(
-    const VCMEncodedFrame& frame,
+    uint8_t payload_type,
+    int width,
+    int height,
     VideoCodec* new_codec) const {
-  uint8_t payload_type = frame.PayloadType();
   RTC_LOG(LS_INFO) << "Initializing decoder with payload type '"
                    << static_cast<int>(payload_type) << "'.";
   RTC_DCHECK(new_codec);
@@ -164,10 +187,9 @@ std::unique_ptr<VCMGenericDecoder> VCMDecoderDataBase::CreateAndInitDecoder(
   // the first frame being of a different resolution than the database values.
   // This is best effort, since there's no guarantee that width/height have been
   // parsed yet (and may be zero).
-  if (frame.EncodedImage()._encodedWidth > 0 &&
-      frame.EncodedImage()._encodedHeight > 0) {
-    decoder_item->settings->width = frame.EncodedImage()._encodedWidth;
-    decoder_item->settings->height = frame.EncodedImage()._encodedHeight;
+  if (width > 0 && height > 0) {
+    decoder_item->settings->width = width;
+    decoder_item->settings->height = height;
   }
   int err = ptr_decoder->InitDecode(decoder_item->settings.get(),
                                     decoder_item->number_of_cores);
@@ -62,6 +62,12 @@ class VCMDecoderDataBase {
       const VCMEncodedFrame& frame,
       VCMDecodedFrameCallback* decoded_frame_callback);
 
+  // Creates and initializes the decoder for |payload_type| ahead of its first
+  // frame, so that GetDecoder() can return it right away. Returns false if no
+  // decoder could be created.
+  bool PrepareDecoder(uint8_t payload_type,
+                      VCMDecodedFrameCallback* decoded_frame_callback);
+
   // Returns true if the currently active decoder prefer to decode frames late.
   // That means that frames must be decoded near the render times stamp.
   bool PrefersLateDecoding() const;
@@ -70,8 +76,18 @@ class VCMDecoderDataBase {
   typedef std::map<uint8_t, VCMDecoderMapItem*> DecoderMap;
   typedef std::map<uint8_t, VCMExtDecoderMapItem*> ExternalDecoderMap;
 
+  // Replaces the current decoder with one for |payload_type|. |width| and
+  // |height| are the resolution of the first frame, or zero if unknown.
+  VCMGenericDecoder* SwitchDecoder(
+      uint8_t payload_type,
+      int width,
+      int height,
+      VCMDecodedFrameCallback* decoded_frame_callback);
+
   std::unique_ptr<VCMGenericDecoder> CreateAndInitDecoder(
-      const VCMEncodedFrame& frame,
+      uint8_t payload_type,
+      int width,
+      int height,
       VideoCodec* new_codec) const;
 
   const VCMDecoderMapItem* FindDecoderItem(uint8_t payload_type) const;
@@ -13,7 +13,6 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iterator>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -46,6 +45,10 @@ constexpr int kMaxFramesHistory = 1 << 13;
 constexpr int kMaxAllowedFrameDelayMs = 5;
 
 constexpr int64_t kLogNonDecodedIntervalMs = 5000;
+
+// With low-latency rendering, the number of complete superframes that may be
+// waiting to be decoded before the older ones are dropped to catch up.
+constexpr size_t kMaxLowLatencyQueuedSuperframes = 2;
 }  // namespace
 
 FrameBuffer::FrameBuffer(Clock* clock,
@@ -126,18 +129,18 @@ void FrameBuffer::StartWaitForNextFrameOnQueue() {
 int64_t FrameBuffer::FindNextFrame(int64_t now_ms) {
   int64_t wait_ms = latest_return_time_ms_ - now_ms;
   frames_to_decode_.clear();
+  const bool low_latency = timing_->UseLowLatencyRendering();
+  std::vector<VideoLayerFrameId> oldest_superframe;
+  size_t num_superframes = 0;
 
-  // |last_continuous_frame_| may be empty below, but nullopt is smaller
-  // than everything else and loop will immediately terminate as expected.
-  for (auto frame_it = frames_.begin();
-       frame_it != frames_.end() && frame_it->first <= last_continuous_frame_;
-       ++frame_it) {
-    if (!frame_it->second.continuous ||
-        frame_it->second.num_missing_decodable > 0) {
-      continue;
-    }
+  for (const VideoLayerFrameId& id : decodable_frames_) {
+    size_t index = frames_.find(id);
+    RTC_DCHECK_LT(index, frames_.size());
+    const FrameInfo& info = frames_[index].second;
+    RTC_DCHECK(info.continuous);
+    RTC_DCHECK_EQ(info.num_missing_decodable, 0u);
 
-    EncodedFrame* frame = frame_it->second.frame.get();
+    EncodedFrame* frame = info.frame.get();
 
     if (keyframe_required_ && !frame->is_keyframe())
       continue;
@@ -160,33 +163,31 @@ int64_t FrameBuffer::FindNextFrame(int64_t now_ms) {
     }
 
     // Gather all remaining frames for the same superframe.
-    std::vector<FrameMap::iterator> current_superframe;
-    current_superframe.push_back(frame_it);
-    bool last_layer_completed = frame_it->second.frame->is_last_spatial_layer;
-    FrameMap::iterator next_frame_it = frame_it;
-    while (true) {
-      ++next_frame_it;
-      if (next_frame_it == frames_.end() ||
-          next_frame_it->first.picture_id != frame->id.picture_id ||
-          !next_frame_it->second.continuous) {
+    std::vector<VideoLayerFrameId> current_superframe;
+    current_superframe.push_back(id);
+    bool last_layer_completed = frame->is_last_spatial_layer;
+    for (size_t next = index + 1; next < frames_.size(); ++next) {
+      const FrameMap::value_type& next_frame = frames_[next];
+      if (next_frame.first.picture_id != frame->id.picture_id ||
+          !next_frame.second.continuous) {
         break;
       }
       // Check if the next frame has some undecoded references other than
       // the previous frame in the same superframe.
       size_t num_allowed_undecoded_refs =
-          (next_frame_it->second.frame->inter_layer_predicted) ? 1 : 0;
-      if (next_frame_it->second.num_missing_decodable >
+          (next_frame.second.frame->inter_layer_predicted) ? 1 : 0;
+      if (next_frame.second.num_missing_decodable >
           num_allowed_undecoded_refs) {
         break;
       }
       // All frames in the superframe should have the same timestamp.
-      if (frame->Timestamp() != next_frame_it->second.frame->Timestamp()) {
+      if (frame->Timestamp() != next_frame.second.frame->Timestamp()) {
         RTC_LOG(LS_WARNING) << "Frames in a single superframe have different"
                                " timestamps. Skipping undecodable superframe.";
         break;
       }
-      current_superframe.push_back(next_frame_it);
-      last_layer_completed = next_frame_it->second.frame->is_last_spatial_layer;
+      current_superframe.push_back(next_frame.first);
+      last_layer_completed = next_frame.second.frame->is_last_spatial_layer;
     }
     // Check if the current superframe is complete.
     // TODO(bugs.webrtc.org/10064): consider returning all available to
@@ -200,6 +201,16 @@ int64_t FrameBuffer::FindNextFrame(int64_t now_ms) {
     if (frame->RenderTime() == -1) {
       frame->SetRenderTime(timing_->RenderTimeMs(frame->Timestamp(), now_ms));
     }
+
+    if (low_latency) {
+      // Frames are decoded as soon as they are complete, so the oldest one is
+      // next, unless the decoder has fallen behind; see below.
+      if (++num_superframes == 1) {
+        oldest_superframe = frames_to_decode_;
+      }
+      continue;
+    }
+
     wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
 
     // This will cause the frame buffer to prefer high framerate rather
@@ -212,6 +223,15 @@ int64_t FrameBuffer::FindNextFrame(int64_t now_ms) {
 
     break;
   }
+  if (num_superframes > 0) {
+    // When more superframes are queued than the decoder keeps up with, skip
+    // to the newest one, and drop the others, rather than letting the delay
+    // build up.
+    if (num_superframes <= kMaxLowLatencyQueuedSuperframes) {
+      frames_to_decode_ = std::move(oldest_superframe);
+    }
+    wait_ms = 0;
+  }
   wait_ms = std::min<int64_t>(wait_ms, latest_return_time_ms_ - now_ms);
   wait_ms = std::max<int64_t>(wait_ms, 0);
   return wait_ms;
@@ -226,7 +246,8 @@ EncodedFrame* FrameBuffer::GetNextFrame() {
   RTC_DCHECK(!frames_to_decode_.empty());
   bool superframe_delayed_by_retransmission = false;
   size_t superframe_size = 0;
-  EncodedFrame* first_frame = frames_to_decode_[0]->second.frame.get();
+  EncodedFrame* first_frame =
+      frames_[frames_.find(frames_to_decode_[0])].second.frame.get();
   int64_t render_time_ms = first_frame->RenderTime();
   int64_t receive_time_ms = first_frame->ReceivedTime();
   // Gracefully handle bad RTP timestamps and render time issues.
@@ -236,9 +257,11 @@ EncodedFrame* FrameBuffer::GetNextFrame() {
     render_time_ms = timing_->RenderTimeMs(first_frame->Timestamp(), now_ms);
   }
 
-  for (FrameMap::iterator& frame_it : frames_to_decode_) {
-    RTC_DCHECK(frame_it != frames_.end());
-    EncodedFrame* frame = frame_it->second.frame.release();
+  for (const VideoLayerFrameId& id : frames_to_decode_) {
+    size_t index = frames_.find(id);
+    RTC_DCHECK_LT(index, frames_.size());
+    FrameInfo& info = frames_[index].second;
+    EncodedFrame* frame = info.frame.release();
 
     frame->SetRenderTime(render_time_ms);
 
@@ -246,22 +269,26 @@ EncodedFrame* FrameBuffer::GetNextFrame() {
     receive_time_ms = std::max(receive_time_ms, frame->ReceivedTime());
     superframe_size += frame->size();
 
-    PropagateDecodability(frame_it->second);
-    decoded_frames_history_.InsertDecoded(frame_it->first, frame->Timestamp());
+    PropagateDecodability(info);
+    decoded_frames_history_.InsertDecoded(id, frame->Timestamp());
 
     // Remove decoded frame and all undecoded frames before it.
     if (stats_callback_) {
-      unsigned int dropped_frames = std::count_if(
-          frames_.begin(), frame_it,
-          [](const std::pair<const VideoLayerFrameId, FrameInfo>& frame) {
-            return frame.second.frame != nullptr;
-          });
+      unsigned int dropped_frames = 0;
+      for (size_t i = 0; i < index; ++i) {
+        if (frames_[i].second.frame)
+          ++dropped_frames;
+      }
       if (dropped_frames > 0) {
         stats_callback_->OnDroppedFrames(dropped_frames);
       }
     }
 
-    frames_.erase(frames_.begin(), ++frame_it);
+    frames_.erase_front(index + 1);
+    decodable_frames_.erase(
+        decodable_frames_.begin(),
+        std::upper_bound(decodable_frames_.begin(), decodable_frames_.end(),
+                         id));
 
     frames_out.push_back(frame);
   }
@@ -390,17 +417,17 @@ bool FrameBuffer::IsCompleteSuperFrame(const EncodedFrame& frame) {
     VideoLayerFrameId id = frame.id;
     RTC_DCHECK_GT(id.spatial_layer, 0);
     --id.spatial_layer;
-    FrameMap::iterator prev_frame = frames_.find(id);
-    if (prev_frame == frames_.end() || !prev_frame->second.frame)
+    size_t prev_frame = frames_.find(id);
+    if (prev_frame == frames_.size() || !frames_[prev_frame].second.frame)
       return false;
-    while (prev_frame->second.frame->inter_layer_predicted) {
-      if (prev_frame == frames_.begin())
+    while (frames_[prev_frame].second.frame->inter_layer_predicted) {
+      if (prev_frame == 0)
         return false;
       --prev_frame;
       --id.spatial_layer;
-      if (!prev_frame->second.frame ||
-          prev_frame->first.picture_id != id.picture_id ||
-          prev_frame->first.spatial_layer != id.spatial_layer) {
+      if (!frames_[prev_frame].second.frame ||
+          frames_[prev_frame].first.picture_id != id.picture_id ||
+          frames_[prev_frame].first.spatial_layer != id.spatial_layer) {
         return false;
       }
     }
@@ -410,15 +437,15 @@ bool FrameBuffer::IsCompleteSuperFrame(const EncodedFrame& frame) {
     // Check that all following spatial layers are already inserted.
     VideoLayerFrameId id = frame.id;
     ++id.spatial_layer;
-    FrameMap::iterator next_frame = frames_.find(id);
-    if (next_frame == frames_.end() || !next_frame->second.frame)
+    size_t next_frame = frames_.find(id);
+    if (next_frame == frames_.size() || !frames_[next_frame].second.frame)
       return false;
-    while (!next_frame->second.frame->is_last_spatial_layer) {
+    while (!frames_[next_frame].second.frame->is_last_spatial_layer) {
       ++next_frame;
       ++id.spatial_layer;
-      if (next_frame == frames_.end() || !next_frame->second.frame ||
-          next_frame->first.picture_id != id.picture_id ||
-          next_frame->first.spatial_layer != id.spatial_layer) {
+      if (next_frame == frames_.size() || !frames_[next_frame].second.frame ||
+          frames_[next_frame].first.picture_id != id.picture_id ||
+          frames_[next_frame].first.spatial_layer != id.spatial_layer) {
         return false;
       }
     }
@@ -493,23 +520,26 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
   // Test if inserting this frame would cause the order of the frames to become
   // ambiguous (covering more than half the interval of 2^16). This can happen
   // when the picture id make large jumps mid stream.
-  if (!frames_.empty() && id < frames_.begin()->first &&
-      frames_.rbegin()->first < id) {
+  if (!frames_.empty() && id < frames_.front().first &&
+      frames_.back().first < id) {
     RTC_LOG(LS_WARNING)
         << "A jump in picture id was detected, clearing buffer.";
     ClearFramesAndHistory();
     last_continuous_picture_id = -1;
   }
 
-  auto info = frames_.emplace(id, FrameInfo()).first;
+  size_t info = frames_.emplace(id);
 
-  if (info->second.frame) {
+  if (frames_[info].second.frame) {
     return last_continuous_picture_id;
   }
 
   if (!UpdateFrameInfoWithIncomingFrame(*frame, info))
     return last_continuous_picture_id;
 
+  // Inserting the frames referenced by |frame| may have moved it.
+  info = frames_.find(id);
+
   if (!frame->delayed_by_retransmission())
     timing_->IncomingTimestamp(frame->Timestamp(), frame->ReceivedTime());
 
@@ -518,10 +548,10 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
                                      frame->contentType());
   }
 
-  info->second.frame = std::move(frame);
+  frames_[info].second.frame = std::move(frame);
 
-  if (info->second.num_missing_continuous == 0) {
-    info->second.continuous = true;
+  if (frames_[info].second.num_missing_continuous == 0) {
+    frames_[info].second.continuous = true;
     PropagateContinuity(info);
     last_continuous_picture_id = last_continuous_frame_->picture_id;
 
@@ -542,34 +572,37 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
   return last_continuous_picture_id;
 }
 
-void FrameBuffer::PropagateContinuity(FrameMap::iterator start) {
+void FrameBuffer::PropagateContinuity(size_t start) {
   TRACE_EVENT0("webrtc", "FrameBuffer::PropagateContinuity");
-  RTC_DCHECK(start->second.continuous);
+  RTC_DCHECK(frames_[start].second.continuous);
 
-  std::queue<FrameMap::iterator> continuous_frames;
-  continuous_frames.push(start);
+  absl::InlinedVector<size_t, 8> continuous_frames;
+  continuous_frames.push_back(start);
 
-  // A simple BFS to traverse continuous frames.
+  // A simple DFS to traverse continuous frames.
   while (!continuous_frames.empty()) {
-    auto frame = continuous_frames.front();
-    continuous_frames.pop();
+    const FrameMap::value_type& frame = frames_[continuous_frames.back()];
+    continuous_frames.pop_back();
 
-    if (!last_continuous_frame_ || *last_continuous_frame_ < frame->first) {
-      last_continuous_frame_ = frame->first;
+    if (!last_continuous_frame_ || *last_continuous_frame_ < frame.first) {
+      last_continuous_frame_ = frame.first;
     }
+    if (frame.second.num_missing_decodable == 0)
+      AddDecodableFrame(frame.first);
 
     // Loop through all dependent frames, and if that frame no longer has
     // any unfulfilled dependencies then that frame is continuous as well.
-    for (size_t d = 0; d < frame->second.dependent_frames.size(); ++d) {
-      auto frame_ref = frames_.find(frame->second.dependent_frames[d]);
-      RTC_DCHECK(frame_ref != frames_.end());
+    for (size_t d = 0; d < frame.second.dependent_frames.size(); ++d) {
+      size_t frame_ref = frames_.find(frame.second.dependent_frames[d]);
+      RTC_DCHECK_LT(frame_ref, frames_.size());
 
       // TODO(philipel): Look into why we've seen this happen.
-      if (frame_ref != frames_.end()) {
-        --frame_ref->second.num_missing_continuous;
-        if (frame_ref->second.num_missing_continuous == 0) {
-          frame_ref->second.continuous = true;
-          continuous_frames.push(frame_ref);
+      if (frame_ref < frames_.size()) {
+        FrameInfo& ref_info = frames_[frame_ref].second;
+        --ref_info.num_missing_continuous;
+        if (ref_info.num_missing_continuous == 0) {
+          ref_info.continuous = true;
+          continuous_frames.push_back(frame_ref);
         }
       }
     }
@@ -579,23 +612,37 @@ void FrameBuffer::PropagateContinuity(FrameMap::iterator start) {
 void FrameBuffer::PropagateDecodability(const FrameInfo& info) {
   TRACE_EVENT0("webrtc", "FrameBuffer::PropagateDecodability");
   for (size_t d = 0; d < info.dependent_frames.size(); ++d) {
-    auto ref_info = frames_.find(info.dependent_frames[d]);
-    RTC_DCHECK(ref_info != frames_.end());
+    size_t ref_index = frames_.find(info.dependent_frames[d]);
+    RTC_DCHECK_LT(ref_index, frames_.size());
     // TODO(philipel): Look into why we've seen this happen.
-    if (ref_info != frames_.end()) {
-      RTC_DCHECK_GT(ref_info->second.num_missing_decodable, 0U);
-      --ref_info->second.num_missing_decodable;
+    if (ref_index < frames_.size()) {
+      FrameInfo& ref_info = frames_[ref_index].second;
+      RTC_DCHECK_GT(ref_info.num_missing_decodable, 0U);
+      --ref_info.num_missing_decodable;
+      if (ref_info.num_missing_decodable == 0 && ref_info.continuous)
+        AddDecodableFrame(frames_[ref_index].first);
     }
   }
 }
 
+void FrameBuffer::AddDecodableFrame(const VideoLayerFrameId& id) {
+  if (decodable_frames_.empty() || decodable_frames_.back() < id) {
+    decodable_frames_.push_back(id);
+    return;
+  }
+  auto it =
+      std::lower_bound(decodable_frames_.begin(), decodable_frames_.end(), id);
+  RTC_DCHECK(*it != id);
+  decodable_frames_.insert(it, id);
+}
+
 bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
-                                                   FrameMap::iterator info) {
+                                                   size_t info) {
   TRACE_EVENT0("webrtc", "FrameBuffer::UpdateFrameInfoWithIncomingFrame");
   const VideoLayerFrameId& id = frame.id;
 
   auto last_decoded_frame = decoded_frames_history_.GetLastDecodedFrameId();
-  RTC_DCHECK(!last_decoded_frame || *last_decoded_frame < info->first);
+  RTC_DCHECK(!last_decoded_frame || *last_decoded_frame < frames_[info].first);
 
   // In this function we determine how many missing dependencies this |frame|
   // has to become continuous/decodable. If a frame that this |frame| depend
@@ -631,9 +678,9 @@ bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
         return false;
       }
     } else {
-      auto ref_info = frames_.find(ref_key);
-      bool ref_continuous =
-          ref_info != frames_.end() && ref_info->second.continuous;
+      size_t ref_index = frames_.find(ref_key);
+      bool ref_continuous = ref_index < frames_.size() &&
+                            frames_[ref_index].second.continuous;
       not_yet_fulfilled_dependencies.push_back({ref_key, ref_continuous});
     }
   }
@@ -641,13 +688,13 @@ bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
   // Does |frame| depend on the lower spatial layer?
   if (frame.inter_layer_predicted) {
     VideoLayerFrameId ref_key(frame.id.picture_id, frame.id.spatial_layer - 1);
-    auto ref_info = frames_.find(ref_key);
+    size_t ref_index = frames_.find(ref_key);
 
     bool lower_layer_decoded =
         last_decoded_frame && *last_decoded_frame == ref_key;
     bool lower_layer_continuous =
-        lower_layer_decoded ||
-        (ref_info != frames_.end() && ref_info->second.continuous);
+        lower_layer_decoded || (ref_index < frames_.size() &&
+                                frames_[ref_index].second.continuous);
 
     if (!lower_layer_continuous || !lower_layer_decoded) {
       not_yet_fulfilled_dependencies.push_back(
@@ -655,16 +702,19 @@ bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
     }
   }
 
-  info->second.num_missing_continuous = not_yet_fulfilled_dependencies.size();
-  info->second.num_missing_decodable = not_yet_fulfilled_dependencies.size();
+  FrameInfo& frame_info = frames_[info].second;
+  frame_info.num_missing_continuous = not_yet_fulfilled_dependencies.size();
+  frame_info.num_missing_decodable = not_yet_fulfilled_dependencies.size();
 
   for (const Dependency& dep : not_yet_fulfilled_dependencies) {
     if (dep.continuous)
-      --info->second.num_missing_continuous;
-
-    frames_[dep.id].dependent_frames.push_back(id);
+      --frame_info.num_missing_continuous;
   }
 
+  // Inserting the dependencies may move |frame_info|, so it is done last.
+  for (const Dependency& dep : not_yet_fulfilled_dependencies)
+    frames_[frames_.emplace(dep.id)].second.dependent_frames.push_back(id);
+
   return true;
 }
 
@@ -698,16 +748,17 @@ void FrameBuffer::UpdateTimingFrameInfo() {
 void FrameBuffer::ClearFramesAndHistory() {
   TRACE_EVENT0("webrtc", "FrameBuffer::ClearFramesAndHistory");
   if (stats_callback_) {
-    unsigned int dropped_frames = std::count_if(
-        frames_.begin(), frames_.end(),
-        [](const std::pair<const VideoLayerFrameId, FrameInfo>& frame) {
-          return frame.second.frame != nullptr;
-        });
+    unsigned int dropped_frames = 0;
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      if (frames_[i].second.frame)
+        ++dropped_frames;
+    }
     if (dropped_frames > 0) {
       stats_callback_->OnDroppedFrames(dropped_frames);
     }
   }
   frames_.clear();
+  decodable_frames_.clear();
   last_continuous_frame_.reset();
   frames_to_decode_.clear();
   decoded_frames_history_.Clear();
@@ -756,7 +807,72 @@ EncodedFrame* FrameBuffer::CombineAndDeleteFrames(
 
 FrameBuffer::FrameInfo::FrameInfo() = default;
 FrameBuffer::FrameInfo::FrameInfo(FrameInfo&&) = default;
+FrameBuffer::FrameInfo& FrameBuffer::FrameInfo::operator=(FrameInfo&&) =
+    default;
 FrameBuffer::FrameInfo::~FrameInfo() = default;
 
+FrameBuffer::FrameMap::FrameMap() = default;
+FrameBuffer::FrameMap::~FrameMap() = default;
+
+size_t FrameBuffer::FrameMap::find(const VideoLayerFrameId& id) const {
+  size_t index = LowerBound(id);
+  if (index < size_ && (*this)[index].first == id)
+    return index;
+  return size_;
+}
+
+size_t FrameBuffer::FrameMap::emplace(const VideoLayerFrameId& id) {
+  size_t index = LowerBound(id);
+  if (index < size_ && (*this)[index].first == id)
+    return index;
+  if (size_ == slots_.size())
+    Grow();
+  // Frames are rarely inserted far from the newest frame, so only a few newer
+  // frames have to be moved to make room.
+  for (size_t i = size_; i > index; --i)
+    (*this)[i] = std::move((*this)[i - 1]);
+  (*this)[index] = value_type(id, FrameInfo());
+  ++size_;
+  return index;
+}
+
+void FrameBuffer::FrameMap::erase_front(size_t count) {
+  RTC_DCHECK_LE(count, size_);
+  for (size_t i = 0; i < count; ++i)
+    (*this)[i] = value_type();
+  head_ = Slot(count);
+  size_ -= count;
+}
+
+void FrameBuffer::FrameMap::clear() {
+  erase_front(size_);
+  head_ = 0;
+}
+
+size_t FrameBuffer::FrameMap::LowerBound(const VideoLayerFrameId& id) const {
+  // Fast path for frames arriving in order.
+  if (size_ == 0 || (*this)[size_ - 1].first < id)
+    return size_;
+  size_t begin = 0;
+  size_t end = size_;
+  while (begin < end) {
+    size_t middle = begin + (end - begin) / 2;
+    if ((*this)[middle].first < id) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin;
+}
+
+void FrameBuffer::FrameMap::Grow() {
+  std::vector<value_type> slots(slots_.empty() ? 16 : 2 * slots_.size());
+  for (size_t i = 0; i < size_; ++i)
+    slots[i] = std::move((*this)[i]);
+  slots_.swap(slots);
+  head_ = 0;
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
@@ -12,7 +12,6 @@
 #define MODULES_VIDEO_CODING_FRAME_BUFFER2_H_
 
 #include <array>
-#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -89,6 +88,7 @@ class FrameBuffer {
   struct FrameInfo {
     FrameInfo();
     FrameInfo(FrameInfo&&);
+    FrameInfo& operator=(FrameInfo&&);
     ~FrameInfo();
 
     // Which other frames that have direct unfulfilled dependencies
@@ -113,7 +113,48 @@ class FrameBuffer {
     std::unique_ptr<EncodedFrame> frame;
   };
 
-  using FrameMap = std::map<VideoLayerFrameId, FrameInfo>;
+  // Frames ordered by id. Frames are almost always inserted close to the
+  // newest frame and removed from the oldest one, so they are kept sorted in a
+  // ring whose storage only grows. Frames are referred to by their position,
+  // counted from the oldest frame; positions are only stable until the next
+  // insertion or removal.
+  class FrameMap {
+   public:
+    using value_type = std::pair<VideoLayerFrameId, FrameInfo>;
+
+    FrameMap();
+    ~FrameMap();
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    value_type& operator[](size_t index) { return slots_[Slot(index)]; }
+    const value_type& operator[](size_t index) const {
+      return slots_[Slot(index)];
+    }
+    value_type& front() { return (*this)[0]; }
+    value_type& back() { return (*this)[size_ - 1]; }
+
+    // Returns the position of |id|, or size() if there is no such frame.
+    size_t find(const VideoLayerFrameId& id) const;
+    // Returns the position of |id|, inserting an empty FrameInfo for it first
+    // if there is no such frame.
+    size_t emplace(const VideoLayerFrameId& id);
+    // Removes the |count| oldest frames.
+    void erase_front(size_t count);
+    void clear();
+
+   private:
+    size_t LowerBound(const VideoLayerFrameId& id) const;
+    size_t Slot(size_t index) const {
+      return (head_ + index) & (slots_.size() - 1);
+    }
+    void Grow();
+
+    std::vector<value_type> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+  };
 
   // Check that the references of |frame| are valid.
   bool ValidReferences(const EncodedFrame& frame) const;
@@ -126,18 +167,20 @@ class FrameBuffer {
 
   // Update all directly dependent and indirectly dependent frames and mark
   // them as continuous if all their references has been fulfilled.
-  void PropagateContinuity(FrameMap::iterator start)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void PropagateContinuity(size_t start) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Marks the frame as decoded and updates all directly dependent frames.
   void PropagateDecodability(const FrameInfo& info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Adds |id| to |decodable_frames_|.
+  void AddDecodableFrame(const VideoLayerFrameId& id)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Update the corresponding FrameInfo of |frame| and all FrameInfos that
   // |frame| references.
   // Return false if |frame| will never be decodable, true otherwise.
-  bool UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
-                                        FrameMap::iterator info)
+  bool UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame, size_t info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   void UpdateJitterDelay() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
@@ -182,7 +225,11 @@ class FrameBuffer {
   VCMInterFrameDelay inter_frame_delay_ RTC_GUARDED_BY(crit_);
   absl::optional<VideoLayerFrameId> last_continuous_frame_
       RTC_GUARDED_BY(crit_);
-  std::vector<FrameMap::iterator> frames_to_decode_ RTC_GUARDED_BY(crit_);
+  // Ids of the continuous frames that have all their references decoded, in
+  // order. Only these frames can start the next superframe to decode, so
+  // FindNextFrame() does not have to look at any other frames.
+  std::vector<VideoLayerFrameId> decodable_frames_ RTC_GUARDED_BY(crit_);
+  std::vector<VideoLayerFrameId> frames_to_decode_ RTC_GUARDED_BY(crit_);
   bool stopped_ RTC_GUARDED_BY(crit_);
   VCMVideoProtection protection_mode_ RTC_GUARDED_BY(crit_);
   VCMReceiveStatisticsCallback* const stats_callback_;
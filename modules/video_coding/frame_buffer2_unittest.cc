@@ -19,9 +19,11 @@
 #include "modules/video_coding/frame_object.h"
 #include "modules/video_coding/jitter_estimator.h"
 #include "modules/video_coding/timing.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
@@ -290,6 +292,34 @@ TEST_F(TestFrameBuffer2, ZeroPlayoutDelay) {
   EXPECT_EQ(0, frames_[0]->RenderTimeMs());
 }
 
+TEST_F(TestFrameBuffer2, LowLatencyDropsFramesOnlyWhenFallingBehind) {
+  VCMTiming timing(time_controller_.GetClock());
+  timing.set_min_playout_delay(0);
+  timing.set_max_playout_delay(0);
+  buffer_.reset(
+      new FrameBuffer(time_controller_.GetClock(), &timing, &stats_callback_));
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+
+  InsertFrame(pid, 0, ts, false, true, kFrameSize);
+  ExtractFrame();
+  CheckFrame(0, pid, 0);
+
+  // Two queued frames are decoded in order.
+  InsertFrame(pid + 1, 0, ts + kFps20, false, true, kFrameSize, pid);
+  InsertFrame(pid + 2, 0, ts + 2 * kFps20, false, true, kFrameSize, pid);
+  ExtractFrame();
+  CheckFrame(1, pid + 1, 0);
+
+  // With three, the decoder skips to the newest.
+  InsertFrame(pid + 3, 0, ts + 3 * kFps20, false, true, kFrameSize, pid);
+  InsertFrame(pid + 4, 0, ts + 4 * kFps20, false, true, kFrameSize, pid);
+  EXPECT_CALL(stats_callback_, OnDroppedFrames(2));
+  ExtractFrame();
+  CheckFrame(2, pid + 4, 0);
+  EXPECT_EQ(0, frames_[2]->RenderTimeMs());
+}
+
 // Flaky test, see bugs.webrtc.org/7068.
 TEST_F(TestFrameBuffer2, DISABLED_OneUnorderedSuperFrame) {
   uint16_t pid = Rand();
@@ -699,5 +729,59 @@ TEST_F(TestFrameBuffer2, HigherSpatialLayerNonDecodable) {
   CheckFrame(2, pid + 2, 1);
 }
 
+TEST_F(TestFrameBuffer2, FramesInsertedInReverseOrder) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  constexpr int kNumFrames = 40;
+
+  for (int i = kNumFrames - 1; i > 0; --i) {
+    EXPECT_EQ(-1, InsertFrame(pid + i, 0, ts + i * kFps10, false, true,
+                              kFrameSize, pid + i - 1));
+  }
+  EXPECT_EQ(pid + kNumFrames - 1,
+            InsertFrame(pid, 0, ts, false, true, kFrameSize));
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    ExtractFrame();
+    time_controller_.AdvanceTime(TimeDelta::Millis(kFps10));
+    CheckFrame(i, pid + i, 0);
+  }
+}
+
+TEST_F(TestFrameBuffer2, DISABLED_WaitForKeyframeThroughput) {
+  constexpr int kNumPictures = 60000;
+  constexpr int kKeyframeInterval = 300;
+  constexpr int kFrameIntervalMs = 10;
+
+  // Only keyframes are extracted, so the delta frames following each keyframe
+  // pile up in the buffer until the next keyframe is decoded. The clock is
+  // simulated, so the time spent is measured with the system clock.
+  int64_t start_us = rtc::SystemTimeNanos() / rtc::kNumNanosecsPerMicrosec;
+  for (int i = 0; i < kNumPictures; ++i) {
+    uint16_t pid = i;
+    int64_t ts_ms = i * kFrameIntervalMs;
+    if (i % kKeyframeInterval == 0) {
+      InsertFrame(pid, 0, ts_ms, false, false, kFrameSize);
+      InsertFrame(pid, 1, ts_ms, true, true, kFrameSize);
+    } else {
+      InsertFrame(pid, 0, ts_ms, false, false, kFrameSize, pid - 1);
+      InsertFrame(pid, 1, ts_ms, true, true, kFrameSize, pid - 1);
+    }
+    ExtractFrame(0, /*keyframe_required=*/true);
+    time_controller_.AdvanceTime(TimeDelta::Millis(kFrameIntervalMs));
+  }
+  int64_t elapsed_us =
+      rtc::SystemTimeNanos() / rtc::kNumNanosecsPerMicrosec - start_us;
+  EXPECT_EQ(std::count_if(frames_.begin(), frames_.end(),
+                          [](const std::unique_ptr<EncodedFrame>& frame) {
+                            return frame != nullptr;
+                          }),
+            kNumPictures / kKeyframeInterval);
+  RTC_LOG(LS_INFO) << "Inserted and extracted " << kNumPictures
+                   << " pictures in " << elapsed_us << " us, "
+                   << kNumPictures * int64_t{1000000} / elapsed_us
+                   << " pictures/s.";
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
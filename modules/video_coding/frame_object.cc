@@ -38,7 +38,7 @@ RtpFrameObject::RtpFrameObject(
     const RTPVideoHeader& video_header,
     const absl::optional<webrtc::ColorSpace>& color_space,
     RtpPacketInfos packet_infos,
-    rtc::scoped_refptr<EncodedImageBuffer> image_buffer)
+    rtc::scoped_refptr<EncodedImageBufferInterface> image_buffer)
     : first_seq_num_(first_seq_num),
       last_seq_num_(last_seq_num),
       last_packet_received_time_(last_packet_received_time),
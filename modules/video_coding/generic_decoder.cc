@@ -17,6 +17,7 @@
 #include "api/video/video_timing.h"
 #include "modules/video_coding/include/video_error_codes.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/time_utils.h"
@@ -240,8 +241,12 @@ int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame, Timestamp now) {
   _callback->Map(frame.Timestamp(), &_frameInfos[_nextFrameInfoIdx]);
 
   _nextFrameInfoIdx = (_nextFrameInfoIdx + 1) % kDecoderFrameMemoryLength;
-  int32_t ret = decoder_->Decode(frame.EncodedImage(), frame.MissingFrame(),
-                                 frame.RenderTimeMs());
+  int32_t ret;
+  {
+    rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kDecoder);
+    ret = decoder_->Decode(frame.EncodedImage(), frame.MissingFrame(),
+                           frame.RenderTimeMs());
+  }
   const char* new_implementation_name = decoder_->ImplementationName();
   if (new_implementation_name != implementation_name_) {
     implementation_name_ = new_implementation_name;
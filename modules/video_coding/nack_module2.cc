@@ -11,7 +11,10 @@
 #include "modules/video_coding/nack_module2.h"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <limits>
+#include <utility>
 
 #include "api/units/timestamp.h"
 #include "rtc_base/checks.h"
@@ -30,6 +33,7 @@ const int kMaxNackRetries = 10;
 const int kMaxReorderedPackets = 128;
 const int kNumReorderingBuckets = 10;
 const int kDefaultSendNackDelayMs = 0;
+const int kMinNackRingSize = 64;
 
 int64_t GetSendNackDelay() {
   int64_t delay_ms = strtol(
@@ -41,6 +45,26 @@ int64_t GetSendNackDelay() {
   }
   return kDefaultSendNackDelayMs;
 }
+
+// Orders sequence numbers oldest first.
+bool OlderThan(uint16_t a, uint16_t b) {
+  return AheadOf(b, a);
+}
+
+// Inserts |seq_num| into |list|, sorted oldest first, unless it is there.
+void InsertSorted(std::deque<uint16_t>* list, uint16_t seq_num) {
+  auto it = std::upper_bound(list->begin(), list->end(), seq_num, OlderThan);
+  if (it != list->begin() && *std::prev(it) == seq_num)
+    return;
+  list->insert(it, seq_num);
+}
+
+// Removes the sequence numbers older than |seq_num| from |list|, sorted
+// oldest first.
+void EraseOlderThan(std::deque<uint16_t>* list, uint16_t seq_num) {
+  while (!list->empty() && AheadOf(seq_num, list->front()))
+    list->pop_front();
+}
 }  // namespace
 
 constexpr TimeDelta NackModule2::kUpdateInterval;
@@ -102,6 +126,10 @@ NackModule2::NackModule2(TaskQueueBase* current_queue,
       initialized_(false),
       rtt_ms_(kDefaultRttMs),
       newest_seq_num_(0),
+      nack_window_start_(0),
+      nack_window_size_(0),
+      nack_list_size_(0),
+      resend_queues_(kMaxNackRetries),
       send_nack_delay_ms_(GetSendNackDelay()),
       backoff_settings_(BackoffSettings::ParseFromFieldTrials()) {
   RTC_DCHECK(clock_);
@@ -109,10 +137,9 @@ NackModule2::NackModule2(TaskQueueBase* current_queue,
   RTC_DCHECK(keyframe_request_sender_);
   RTC_DCHECK_GT(update_interval.ms(), 0);
   RTC_DCHECK(worker_thread_);
-  RTC_DCHECK(worker_thread_->IsCurrent());
 
   repeating_task_ = RepeatingTaskHandle::DelayedStart(
-      TaskQueueBase::Current(), update_interval_,
+      worker_thread_, update_interval_,
       [this]() {
         RTC_DCHECK_RUN_ON(worker_thread_);
         std::vector<uint16_t> nack_batch = GetNackBatch(kTimeOnly);
@@ -149,7 +176,7 @@ int NackModule2::OnReceivedPacket(uint16_t seq_num,
   if (!initialized_) {
     newest_seq_num_ = seq_num;
     if (is_keyframe)
-      keyframe_list_.insert(seq_num);
+      keyframe_list_.push_back(seq_num);
     initialized_ = true;
     return 0;
   }
@@ -161,11 +188,11 @@ int NackModule2::OnReceivedPacket(uint16_t seq_num,
 
   if (AheadOf(newest_seq_num_, seq_num)) {
     // An out of order packet has been received.
-    auto nack_list_it = nack_list_.find(seq_num);
+    NackInfo* nack_info = FindNack(seq_num);
     int nacks_sent_for_packet = 0;
-    if (nack_list_it != nack_list_.end()) {
-      nacks_sent_for_packet = nack_list_it->second.retries;
-      nack_list_.erase(nack_list_it);
+    if (nack_info) {
+      nacks_sent_for_packet = nack_info->retries;
+      EraseNack(seq_num);
     }
     if (!is_retransmitted)
       UpdateReorderingStatistics(seq_num);
@@ -174,20 +201,16 @@ int NackModule2::OnReceivedPacket(uint16_t seq_num,
 
   // Keep track of new keyframes.
   if (is_keyframe)
-    keyframe_list_.insert(seq_num);
+    InsertSorted(&keyframe_list_, seq_num);
 
   // And remove old ones so we don't accumulate keyframes.
-  auto it = keyframe_list_.lower_bound(seq_num - kMaxPacketAge);
-  if (it != keyframe_list_.begin())
-    keyframe_list_.erase(keyframe_list_.begin(), it);
+  EraseOlderThan(&keyframe_list_, seq_num - kMaxPacketAge);
 
   if (is_recovered) {
-    recovered_list_.insert(seq_num);
+    InsertSorted(&recovered_list_, seq_num);
 
     // Remove old ones so we don't accumulate recovered packets.
-    auto it = recovered_list_.lower_bound(seq_num - kMaxPacketAge);
-    if (it != recovered_list_.begin())
-      recovered_list_.erase(recovered_list_.begin(), it);
+    EraseOlderThan(&recovered_list_, seq_num - kMaxPacketAge);
 
     // Do not send nack for packets recovered by FEC or RTX.
     return 0;
@@ -211,11 +234,9 @@ void NackModule2::ClearUpTo(uint16_t seq_num) {
   // Called via RtpVideoStreamReceiver2::FrameContinuous on the network thread.
   worker_thread_->PostTask(ToQueuedTask(task_safety_, [seq_num, this]() {
     RTC_DCHECK_RUN_ON(worker_thread_);
-    nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
-    keyframe_list_.erase(keyframe_list_.begin(),
-                         keyframe_list_.lower_bound(seq_num));
-    recovered_list_.erase(recovered_list_.begin(),
-                          recovered_list_.lower_bound(seq_num));
+    EraseNacksOlderThan(seq_num);
+    EraseOlderThan(&keyframe_list_, seq_num);
+    EraseOlderThan(&recovered_list_, seq_num);
   }));
 }
 
@@ -227,18 +248,17 @@ void NackModule2::UpdateRtt(int64_t rtt_ms) {
 bool NackModule2::RemovePacketsUntilKeyFrame() {
   // Called on worker_thread_.
   while (!keyframe_list_.empty()) {
-    auto it = nack_list_.lower_bound(*keyframe_list_.begin());
-
-    if (it != nack_list_.begin()) {
+    if (nack_list_size_ > 0 &&
+        AheadOf(keyframe_list_.front(), nack_window_start_)) {
       // We have found a keyframe that actually is newer than at least one
       // packet in the nack list.
-      nack_list_.erase(nack_list_.begin(), it);
+      EraseNacksOlderThan(keyframe_list_.front());
       return true;
     }
 
     // If this keyframe is so old it does not remove any packets from the list,
     // remove it from the list of keyframes and try the next keyframe.
-    keyframe_list_.erase(keyframe_list_.begin());
+    keyframe_list_.pop_front();
   }
   return false;
 }
@@ -247,20 +267,19 @@ void NackModule2::AddPacketsToNack(uint16_t seq_num_start,
                                    uint16_t seq_num_end) {
   // Called on worker_thread_.
   // Remove old packets.
-  auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-  nack_list_.erase(nack_list_.begin(), it);
+  EraseNacksOlderThan(seq_num_end - kMaxPacketAge);
 
   // If the nack list is too large, remove packets from the nack list until
   // the latest first packet of a keyframe. If the list is still too large,
   // clear it and request a keyframe.
   uint16_t num_new_nacks = ForwardDiff(seq_num_start, seq_num_end);
-  if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+  if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     while (RemovePacketsUntilKeyFrame() &&
-           nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+           nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     }
 
-    if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
-      nack_list_.clear();
+    if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
+      ClearNacks();
       RTC_LOG(LS_WARNING) << "NACK list full, clearing NACK"
                              " list and requesting keyframe.";
       keyframe_request_sender_->RequestKeyFrame();
@@ -269,13 +288,15 @@ void NackModule2::AddPacketsToNack(uint16_t seq_num_start,
   }
 
   for (uint16_t seq_num = seq_num_start; seq_num != seq_num_end; ++seq_num) {
+    // Recovered packets older than |seq_num| will not be looked up again.
+    EraseOlderThan(&recovered_list_, seq_num);
     // Do not send nack for packets that are already recovered by FEC or RTX
-    if (recovered_list_.find(seq_num) != recovered_list_.end())
+    if (!recovered_list_.empty() && recovered_list_.front() == seq_num)
       continue;
     NackInfo nack_info(seq_num, seq_num + WaitNumberOfPackets(0.5),
                        clock_->TimeInMilliseconds());
-    RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
-    nack_list_[seq_num] = nack_info;
+    InsertNack(nack_info);
+    unsent_nacks_.push_back(seq_num);
   }
 }
 
@@ -286,46 +307,175 @@ std::vector<uint16_t> NackModule2::GetNackBatch(NackFilterOptions options) {
   bool consider_timestamp = options != kSeqNumOnly;
   Timestamp now = clock_->CurrentTime();
   std::vector<uint16_t> nack_batch;
-  auto it = nack_list_.begin();
-  while (it != nack_list_.end()) {
-    TimeDelta resend_delay = TimeDelta::Millis(rtt_ms_);
-    if (backoff_settings_) {
-      resend_delay =
-          std::max(resend_delay, backoff_settings_->min_retry_interval);
-      if (it->second.retries > 1) {
-        TimeDelta exponential_backoff =
-            std::min(TimeDelta::Millis(rtt_ms_), backoff_settings_->max_rtt) *
-            std::pow(backoff_settings_->base, it->second.retries - 1);
-        resend_delay = std::max(resend_delay, exponential_backoff);
-      }
-    }
-
-    bool delay_timed_out =
-        now.ms() - it->second.created_at_time >= send_nack_delay_ms_;
+  auto add_to_batch = [&](NackInfo* nack_info) {
+    nack_batch.emplace_back(nack_info->seq_num);
+    ++nack_info->retries;
+    nack_info->sent_at_time = now.ms();
+  };
+
+  // Entries that have never been sent. They were created in sequence number
+  // order, so the first one still within |send_nack_delay_ms_| ends the scan.
+  const int64_t first_resend_delay_ms = ResendDelay(0).ms();
+  for (uint16_t seq_num : unsent_nacks_) {
+    NackInfo* nack_info = FindNack(seq_num);
+    if (!nack_info || nack_info->sent_at_time != -1)
+      continue;
+    if (now.ms() - nack_info->created_at_time < send_nack_delay_ms_)
+      break;
     bool nack_on_rtt_passed =
-        now.ms() - it->second.sent_at_time >= resend_delay.ms();
+        now.ms() - nack_info->sent_at_time >= first_resend_delay_ms;
     bool nack_on_seq_num_passed =
-        it->second.sent_at_time == -1 &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num);
-    if (delay_timed_out && ((consider_seq_num && nack_on_seq_num_passed) ||
-                            (consider_timestamp && nack_on_rtt_passed))) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now.ms();
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                            << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
+        AheadOrAt(newest_seq_num_, nack_info->send_at_seq_num);
+    if ((consider_seq_num && nack_on_seq_num_passed) ||
+        (consider_timestamp && nack_on_rtt_passed)) {
+      add_to_batch(nack_info);
+    }
+  }
+  while (!unsent_nacks_.empty()) {
+    NackInfo* nack_info = FindNack(unsent_nacks_.front());
+    if (nack_info && nack_info->sent_at_time == -1)
+      break;
+    unsent_nacks_.pop_front();
+  }
+
+  // Entries that have been sent, which are only resent on time.
+  for (int retries = 1; consider_timestamp && retries < kMaxNackRetries;
+       ++retries) {
+    std::deque<SentNack>& resend_queue = resend_queues_[retries];
+    const int64_t resend_delay_ms = ResendDelay(retries).ms();
+    while (!resend_queue.empty()) {
+      const SentNack& sent_nack = resend_queue.front();
+      NackInfo* nack_info = FindNack(sent_nack.seq_num);
+      if (nack_info && nack_info->retries == retries &&
+          nack_info->sent_at_time == sent_nack.sent_at_time) {
+        if (now.ms() - sent_nack.sent_at_time < resend_delay_ms)
+          break;
+        add_to_batch(nack_info);
       }
-      continue;
+      resend_queue.pop_front();
+    }
+  }
+
+  const uint16_t window_start = nack_window_start_;
+  std::sort(nack_batch.begin(), nack_batch.end(),
+            [window_start](uint16_t a, uint16_t b) {
+              return ForwardDiff(window_start, a) <
+                     ForwardDiff(window_start, b);
+            });
+  for (uint16_t seq_num : nack_batch) {
+    int retries = FindNack(seq_num)->retries;
+    if (retries >= kMaxNackRetries) {
+      RTC_LOG(LS_WARNING) << "Sequence number " << seq_num
+                          << " removed from NACK list due to max retries.";
+      EraseNack(seq_num);
+    } else {
+      resend_queues_[retries].push_back({seq_num, now.ms()});
     }
-    ++it;
   }
   return nack_batch;
 }
 
+NackModule2::NackInfo* NackModule2::FindNack(uint16_t seq_num) {
+  // Called on worker_thread_.
+  if (ForwardDiff(nack_window_start_, seq_num) >= nack_window_size_)
+    return nullptr;
+  size_t index = seq_num & (nack_slots_.size() - 1);
+  return nack_present_[index] ? &nack_slots_[index] : nullptr;
+}
+
+void NackModule2::InsertNack(const NackInfo& nack_info) {
+  // Called on worker_thread_.
+  if (nack_window_size_ == 0)
+    nack_window_start_ = nack_info.seq_num;
+  int offset = ForwardDiff(nack_window_start_, nack_info.seq_num);
+  RTC_DCHECK_GE(offset, nack_window_size_);
+  if (offset >= static_cast<int>(nack_slots_.size()))
+    GrowNackRing(offset + 1);
+  size_t index = nack_info.seq_num & (nack_slots_.size() - 1);
+  nack_slots_[index] = nack_info;
+  nack_present_[index] = true;
+  nack_window_size_ = offset + 1;
+  ++nack_list_size_;
+}
+
+void NackModule2::EraseNack(uint16_t seq_num) {
+  // Called on worker_thread_.
+  RTC_DCHECK(FindNack(seq_num));
+  nack_present_[seq_num & (nack_slots_.size() - 1)] = false;
+  --nack_list_size_;
+  if (seq_num == nack_window_start_)
+    TrimNackWindow();
+}
+
+void NackModule2::EraseNacksOlderThan(uint16_t seq_num) {
+  // Called on worker_thread_.
+  while (nack_window_size_ > 0 && AheadOf(seq_num, nack_window_start_)) {
+    size_t index = nack_window_start_ & (nack_slots_.size() - 1);
+    if (nack_present_[index]) {
+      nack_present_[index] = false;
+      --nack_list_size_;
+    }
+    ++nack_window_start_;
+    --nack_window_size_;
+  }
+  TrimNackWindow();
+}
+
+void NackModule2::ClearNacks() {
+  // Called on worker_thread_.
+  std::fill(nack_present_.begin(), nack_present_.end(), false);
+  nack_window_size_ = 0;
+  nack_list_size_ = 0;
+  unsent_nacks_.clear();
+  for (std::deque<SentNack>& resend_queue : resend_queues_)
+    resend_queue.clear();
+}
+
+void NackModule2::TrimNackWindow() {
+  // Called on worker_thread_.
+  while (nack_window_size_ > 0 &&
+         !nack_present_[nack_window_start_ & (nack_slots_.size() - 1)]) {
+    ++nack_window_start_;
+    --nack_window_size_;
+  }
+}
+
+void NackModule2::GrowNackRing(int window_size) {
+  // Called on worker_thread_.
+  size_t size = std::max<size_t>(nack_slots_.size(), kMinNackRingSize);
+  while (size < static_cast<size_t>(window_size))
+    size *= 2;
+  RTC_DCHECK_LE(size, 1 << 16);
+  std::vector<NackInfo> slots(size);
+  std::vector<bool> present(size, false);
+  for (int offset = 0; offset < nack_window_size_; ++offset) {
+    uint16_t seq_num = nack_window_start_ + offset;
+    size_t index = seq_num & (nack_slots_.size() - 1);
+    if (nack_present_[index]) {
+      slots[seq_num & (size - 1)] = nack_slots_[index];
+      present[seq_num & (size - 1)] = true;
+    }
+  }
+  nack_slots_ = std::move(slots);
+  nack_present_ = std::move(present);
+}
+
+TimeDelta NackModule2::ResendDelay(int retries) const {
+  // Called on worker_thread_.
+  TimeDelta resend_delay = TimeDelta::Millis(rtt_ms_);
+  if (backoff_settings_) {
+    resend_delay =
+        std::max(resend_delay, backoff_settings_->min_retry_interval);
+    if (retries > 1) {
+      TimeDelta exponential_backoff =
+          std::min(TimeDelta::Millis(rtt_ms_), backoff_settings_->max_rtt) *
+          std::pow(backoff_settings_->base, retries - 1);
+      resend_delay = std::max(resend_delay, exponential_backoff);
+    }
+  }
+  return resend_delay;
+}
+
 void NackModule2::UpdateReorderingStatistics(uint16_t seq_num) {
   // Running on worker_thread_.
   RTC_DCHECK(AheadOf(newest_seq_num_, seq_num));
@@ -13,8 +13,7 @@
 
 #include <stdint.h>
 
-#include <map>
-#include <set>
+#include <deque>
 #include <vector>
 
 #include "api/units/time_delta.h"
@@ -37,6 +36,8 @@ class NackModule2 final {
  public:
   static constexpr TimeDelta kUpdateInterval = TimeDelta::Millis(20);
 
+  // May be constructed on any thread, but must be used and destroyed on
+  // |current_queue|.
   NackModule2(TaskQueueBase* current_queue,
               Clock* clock,
               NackSender* nack_sender,
@@ -71,6 +72,12 @@ class NackModule2 final {
     int retries;
   };
 
+  // A nack list entry that has been sent, as queued for resending.
+  struct SentNack {
+    uint16_t seq_num;
+    int64_t sent_at_time;
+  };
+
   struct BackoffSettings {
     BackoffSettings(TimeDelta min_retry, TimeDelta max_rtt, double base);
     static absl::optional<BackoffSettings> ParseFromFieldTrials();
@@ -93,6 +100,28 @@ class NackModule2 final {
   std::vector<uint16_t> GetNackBatch(NackFilterOptions options)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
 
+  // Returns the nack list entry of |seq_num|, or null if there is none.
+  NackInfo* FindNack(uint16_t seq_num)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  // Adds |nack_info| to the nack list. Its sequence number must be newer than
+  // those of all entries.
+  void InsertNack(const NackInfo& nack_info)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void EraseNack(uint16_t seq_num) RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  // Removes the entries older than |seq_num| from the nack list.
+  void EraseNacksOlderThan(uint16_t seq_num)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  void ClearNacks() RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  // Moves the start of the nack window to its oldest entry.
+  void TrimNackWindow() RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+  // Makes room in the ring for a window of |window_size| sequence numbers.
+  void GrowNackRing(int window_size)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+
+  // Time to wait before resending a nack that has been sent |retries| times.
+  TimeDelta ResendDelay(int retries) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
+
   // Update the reordering distribution.
   void UpdateReorderingStatistics(uint16_t seq_num)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_thread_);
@@ -115,12 +144,28 @@ class NackModule2 final {
   // TODO(philipel): Some of the variables below are consistently used on a
   // known thread (e.g. see |initialized_|). Those probably do not need
   // synchronized access.
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
-      RTC_GUARDED_BY(worker_thread_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> keyframe_list_
-      RTC_GUARDED_BY(worker_thread_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> recovered_list_
+  // The nack list, a ring indexed by sequence number. It spans the
+  // |nack_window_size_| sequence numbers from |nack_window_start_| on, and
+  // |nack_present_| tells which of them have an entry. The window starts at
+  // the oldest entry, and the ring grows with it up to |kMaxPacketAge|.
+  std::vector<NackInfo> nack_slots_ RTC_GUARDED_BY(worker_thread_);
+  std::vector<bool> nack_present_ RTC_GUARDED_BY(worker_thread_);
+  uint16_t nack_window_start_ RTC_GUARDED_BY(worker_thread_);
+  int nack_window_size_ RTC_GUARDED_BY(worker_thread_);
+  size_t nack_list_size_ RTC_GUARDED_BY(worker_thread_);
+  // The entries that have never been sent, in sequence number order. Entries
+  // that were sent or removed since are dropped once at the front.
+  std::deque<uint16_t> unsent_nacks_ RTC_GUARDED_BY(worker_thread_);
+  // The entries that have been sent, by number of retries, in the order they
+  // were last sent. All entries of a queue are due for resending after the
+  // same delay, so the due ones are at its front. Entries that were resent or
+  // removed since are dropped once at the front.
+  std::vector<std::deque<SentNack>> resend_queues_
       RTC_GUARDED_BY(worker_thread_);
+  // Oldest first.
+  std::deque<uint16_t> keyframe_list_ RTC_GUARDED_BY(worker_thread_);
+  // Recovered packets newer than |newest_seq_num_|, oldest first.
+  std::deque<uint16_t> recovered_list_ RTC_GUARDED_BY(worker_thread_);
   video_coding::Histogram reordering_histogram_ RTC_GUARDED_BY(worker_thread_);
   bool initialized_ RTC_GUARDED_BY(worker_thread_);
   int64_t rtt_ms_ RTC_GUARDED_BY(worker_thread_);
@@ -256,6 +256,22 @@ TEST_P(TestNackModule2, ResendPacketMaxRetries) {
   EXPECT_EQ(10u, sent_nacks_.size());
 }
 
+TEST_P(TestNackModule2, ResendsDueNacksInSequenceNumberOrder) {
+  NackModule2& nack_module = CreateNackModule(TimeDelta::Millis(1));
+  nack_module.OnReceivedPacket(1, false, false);
+  nack_module.OnReceivedPacket(3, false, false);
+  clock_->AdvanceTimeMilliseconds(kDefaultRttMs);
+  ASSERT_TRUE(WaitForSendNack());
+  // 2 has been nacked twice, 4 and 5 once.
+  nack_module.OnReceivedPacket(6, false, false);
+  EXPECT_EQ((std::vector<uint16_t>{2, 2, 4, 5}), sent_nacks_);
+
+  sent_nacks_.clear();
+  clock_->AdvanceTimeMilliseconds(2 * kDefaultRttMs);
+  ASSERT_TRUE(WaitForSendNack());
+  EXPECT_EQ((std::vector<uint16_t>{2, 4, 5}), sent_nacks_);
+}
+
 TEST_P(TestNackModule2, TooLargeNackList) {
   NackModule2& nack_module = CreateNackModule();
   nack_module.OnReceivedPacket(0, false, false);
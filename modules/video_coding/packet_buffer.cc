@@ -129,7 +129,7 @@ PacketBuffer::InsertResult PacketBuffer::InsertPacket(
   packet->continuous = false;
   buffer_[index] = std::move(packet);
 
-  UpdateMissingPackets(seq_num);
+  missing_packets_.Insert(seq_num);
 
   result.packets = FindFrames(seq_num);
   return result;
@@ -165,11 +165,7 @@ void PacketBuffer::ClearTo(uint16_t seq_num) {
   first_seq_num_ = seq_num;
 
   is_cleared_to_first_seq_num_ = true;
-  auto clear_to_it = missing_packets_.upper_bound(seq_num);
-  if (clear_to_it != missing_packets_.begin()) {
-    --clear_to_it;
-    missing_packets_.erase(missing_packets_.begin(), clear_to_it);
-  }
+  missing_packets_.EraseBeforeNewestUpTo(seq_num);
 }
 
 void PacketBuffer::Clear() {
@@ -180,7 +176,7 @@ void PacketBuffer::Clear() {
 PacketBuffer::InsertResult PacketBuffer::InsertPadding(uint16_t seq_num) {
   PacketBuffer::InsertResult result;
   rtc::CritScope lock(&crit_);
-  UpdateMissingPackets(seq_num);
+  missing_packets_.Insert(seq_num);
   result.packets = FindFrames(static_cast<uint16_t>(seq_num + 1));
   return result;
 }
@@ -204,8 +200,7 @@ void PacketBuffer::ClearInternal() {
   is_cleared_to_first_seq_num_ = false;
   last_received_packet_ms_.reset();
   last_received_keyframe_packet_ms_.reset();
-  newest_inserted_seq_num_.reset();
-  missing_packets_.clear();
+  missing_packets_.Clear();
 }
 
 bool PacketBuffer::ExpandBufferSize() {
@@ -256,15 +251,21 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
   std::vector<std::unique_ptr<PacketBuffer::Packet>> found_frames;
   for (size_t i = 0; i < buffer_.size() && PotentialNewFrame(seq_num); ++i) {
     size_t index = seq_num % buffer_.size();
-    buffer_[index]->continuous = true;
+    size_t prev_index = index > 0 ? index - 1 : buffer_.size() - 1;
+    Packet& packet = *buffer_[index];
+    packet.continuous = true;
+    // PotentialNewFrame() made sure that the previous packet belongs to the
+    // same frame unless this is the first one.
+    packet.frame_start_seq_num = packet.is_first_packet_in_frame()
+                                     ? seq_num
+                                     : buffer_[prev_index]->frame_start_seq_num;
 
     // If all packets of the frame is continuous, find the first packet of the
     // frame and add all packets of the frame to the returned packets.
     if (buffer_[index]->is_last_packet_in_frame()) {
       uint16_t start_seq_num = seq_num;
 
-      // Find the start index by searching backward until the packet with
-      // the |frame_begin| flag is set.
+      // For H.264 the start index is found by searching backward, see below.
       int start_index = index;
       size_t tested_packets = 0;
       int64_t frame_timestamp = buffer_[start_index]->timestamp;
@@ -277,40 +278,39 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
       bool is_h264_keyframe = false;
       int idr_width = -1;
       int idr_height = -1;
-      while (true) {
+      // The continuity chain of a frame starts at the packet with the
+      // |frame_begin| flag set, so that is where the frame starts.
+      if (!is_h264)
+        start_seq_num = packet.frame_start_seq_num;
+      while (is_h264) {
         ++tested_packets;
 
-        if (!is_h264 && buffer_[start_index]->is_first_packet_in_frame())
-          break;
+        const auto* h264_header = absl::get_if<RTPVideoHeaderH264>(
+            &buffer_[start_index]->video_header.video_type_header);
+        if (!h264_header || h264_header->nalus_length >= kMaxNalusPerPacket)
+          return found_frames;
 
-        if (is_h264) {
-          const auto* h264_header = absl::get_if<RTPVideoHeaderH264>(
-              &buffer_[start_index]->video_header.video_type_header);
-          if (!h264_header || h264_header->nalus_length >= kMaxNalusPerPacket)
-            return found_frames;
-
-          for (size_t j = 0; j < h264_header->nalus_length; ++j) {
-            if (h264_header->nalus[j].type == H264::NaluType::kSps) {
-              has_h264_sps = true;
-            } else if (h264_header->nalus[j].type == H264::NaluType::kPps) {
-              has_h264_pps = true;
-            } else if (h264_header->nalus[j].type == H264::NaluType::kIdr) {
-              has_h264_idr = true;
-            }
+        for (size_t j = 0; j < h264_header->nalus_length; ++j) {
+          if (h264_header->nalus[j].type == H264::NaluType::kSps) {
+            has_h264_sps = true;
+          } else if (h264_header->nalus[j].type == H264::NaluType::kPps) {
+            has_h264_pps = true;
+          } else if (h264_header->nalus[j].type == H264::NaluType::kIdr) {
+            has_h264_idr = true;
           }
-          if ((sps_pps_idr_is_h264_keyframe_ && has_h264_idr && has_h264_sps &&
-               has_h264_pps) ||
-              (!sps_pps_idr_is_h264_keyframe_ && has_h264_idr)) {
-            is_h264_keyframe = true;
-            // Store the resolution of key frame which is the packet with
-            // smallest index and valid resolution; typically its IDR or SPS
-            // packet; there may be packet preceeding this packet, IDR's
-            // resolution will be applied to them.
-            if (buffer_[start_index]->width() > 0 &&
-                buffer_[start_index]->height() > 0) {
-              idr_width = buffer_[start_index]->width();
-              idr_height = buffer_[start_index]->height();
-            }
+        }
+        if ((sps_pps_idr_is_h264_keyframe_ && has_h264_idr && has_h264_sps &&
+             has_h264_pps) ||
+            (!sps_pps_idr_is_h264_keyframe_ && has_h264_idr)) {
+          is_h264_keyframe = true;
+          // Store the resolution of key frame which is the packet with
+          // smallest index and valid resolution; typically its IDR or SPS
+          // packet; there may be packet preceeding this packet, IDR's
+          // resolution will be applied to them.
+          if (buffer_[start_index]->width() > 0 &&
+              buffer_[start_index]->height() > 0) {
+            idr_width = buffer_[start_index]->width();
+            idr_height = buffer_[start_index]->height();
           }
         }
 
@@ -325,8 +325,8 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
         // the timestamp of that packet is the same as this one. This may cause
         // the PacketBuffer to hand out incomplete frames.
         // See: https://bugs.chromium.org/p/webrtc/issues/detail?id=7106
-        if (is_h264 && (buffer_[start_index] == nullptr ||
-                        buffer_[start_index]->timestamp != frame_timestamp)) {
+        if (buffer_[start_index] == nullptr ||
+            buffer_[start_index]->timestamp != frame_timestamp) {
           break;
         }
 
@@ -370,8 +370,7 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
                 ? buffer_[start_index]->video_header.frame_marking.temporal_id
                 : kNoTemporalIdx;
         if (h264tid == kNoTemporalIdx && !is_h264_keyframe &&
-            missing_packets_.upper_bound(start_seq_num) !=
-                missing_packets_.begin()) {
+            missing_packets_.AnyUpTo(start_seq_num)) {
           return found_frames;
         }
       }
@@ -381,47 +380,110 @@ std::vector<std::unique_ptr<PacketBuffer::Packet>> PacketBuffer::FindFrames(
       uint16_t num_packets = end_seq_num - start_seq_num;
       found_frames.reserve(found_frames.size() + num_packets);
       for (uint16_t i = start_seq_num; i != end_seq_num; ++i) {
-        std::unique_ptr<Packet>& packet = buffer_[i % buffer_.size()];
-        RTC_DCHECK(packet);
-        RTC_DCHECK_EQ(i, packet->seq_num);
+        std::unique_ptr<Packet>& frame_packet = buffer_[i % buffer_.size()];
+        RTC_DCHECK(frame_packet);
+        RTC_DCHECK_EQ(i, frame_packet->seq_num);
         // Ensure frame boundary flags are properly set.
-        packet->video_header.is_first_packet_in_frame = (i == start_seq_num);
-        packet->video_header.is_last_packet_in_frame = (i == seq_num);
-        found_frames.push_back(std::move(packet));
+        frame_packet->video_header.is_first_packet_in_frame =
+            (i == start_seq_num);
+        frame_packet->video_header.is_last_packet_in_frame = (i == seq_num);
+        found_frames.push_back(std::move(frame_packet));
       }
 
-      missing_packets_.erase(missing_packets_.begin(),
-                             missing_packets_.upper_bound(seq_num));
+      missing_packets_.EraseUpTo(seq_num);
     }
     ++seq_num;
   }
   return found_frames;
 }
 
-void PacketBuffer::UpdateMissingPackets(uint16_t seq_num) {
-  if (!newest_inserted_seq_num_)
-    newest_inserted_seq_num_ = seq_num;
-
-  const int kMaxPaddingAge = 1000;
-  if (AheadOf(seq_num, *newest_inserted_seq_num_)) {
-    uint16_t old_seq_num = seq_num - kMaxPaddingAge;
-    auto erase_to = missing_packets_.lower_bound(old_seq_num);
-    missing_packets_.erase(missing_packets_.begin(), erase_to);
-
-    // Guard against inserting a large amount of missing packets if there is a
-    // jump in the sequence number.
-    if (AheadOf(old_seq_num, *newest_inserted_seq_num_))
-      *newest_inserted_seq_num_ = old_seq_num;
-
-    ++*newest_inserted_seq_num_;
-    while (AheadOf(seq_num, *newest_inserted_seq_num_)) {
-      missing_packets_.insert(*newest_inserted_seq_num_);
-      ++*newest_inserted_seq_num_;
-    }
+PacketBuffer::MissingPackets::MissingPackets() : oldest_(0), bits_{} {}
+
+void PacketBuffer::MissingPackets::Insert(uint16_t seq_num) {
+  if (!newest_) {
+    newest_ = seq_num;
+    oldest_ = seq_num;
+    SetMissing(seq_num, false);
+    return;
+  }
+
+  if (!AheadOf(seq_num, *newest_)) {
+    if (WindowOffset(seq_num) >= 0)
+      SetMissing(seq_num, false);
+    return;
+  }
+
+  // Mark the sequence numbers after the previous newest one as missing,
+  // guarding against marking a large amount of them if there is a jump in the
+  // sequence number. Every slot the window moves onto is written, since it
+  // may hold the state of an older sequence number.
+  const uint16_t gap = ForwardDiff(*newest_, seq_num);
+  const size_t num_missing = std::min(gap, kMaxPaddingAge) - 1;
+  const size_t num_written = std::min<size_t>(gap, kWindowSize);
+  for (size_t i = 0; i < num_written; ++i) {
+    SetMissing(seq_num - i, i >= 1 && i <= num_missing);
+  }
+  if (ForwardDiff(oldest_, *newest_) + gap > kMaxPaddingAge)
+    oldest_ = seq_num - kMaxPaddingAge;
+  newest_ = seq_num;
+}
+
+bool PacketBuffer::MissingPackets::AnyUpTo(uint16_t seq_num) {
+  if (!newest_)
+    return false;
+  // Sequence numbers before the oldest missing one are skipped only once,
+  // which keeps repeated queries cheap.
+  while (oldest_ != *newest_ && !IsMissing(oldest_))
+    ++oldest_;
+  if (!IsMissing(oldest_))
+    return false;
+  return WindowOffset(seq_num) >= 0 || AheadOf(seq_num, *newest_);
+}
+
+void PacketBuffer::MissingPackets::EraseUpTo(uint16_t seq_num) {
+  if (!newest_)
+    return;
+  if (seq_num == *newest_ || AheadOf(seq_num, *newest_)) {
+    oldest_ = *newest_;
+  } else if (WindowOffset(seq_num) >= 0) {
+    oldest_ = seq_num + 1;
+  }
+}
+
+void PacketBuffer::MissingPackets::EraseBeforeNewestUpTo(uint16_t seq_num) {
+  if (!AnyUpTo(seq_num))
+    return;
+  uint16_t newest_missing =
+      AheadOf(seq_num, *newest_) ? *newest_ : seq_num;
+  while (!IsMissing(newest_missing))
+    --newest_missing;
+  oldest_ = newest_missing;
+}
+
+void PacketBuffer::MissingPackets::Clear() {
+  newest_.reset();
+}
+
+bool PacketBuffer::MissingPackets::IsMissing(uint16_t seq_num) const {
+  size_t slot = seq_num % kWindowSize;
+  return (bits_[slot / kBitsPerWord] >> (slot % kBitsPerWord)) & 1;
+}
+
+void PacketBuffer::MissingPackets::SetMissing(uint16_t seq_num, bool missing) {
+  size_t slot = seq_num % kWindowSize;
+  uint64_t mask = uint64_t{1} << (slot % kBitsPerWord);
+  if (missing) {
+    bits_[slot / kBitsPerWord] |= mask;
   } else {
-    missing_packets_.erase(seq_num);
+    bits_[slot / kBitsPerWord] &= ~mask;
   }
 }
 
+int PacketBuffer::MissingPackets::WindowOffset(uint16_t seq_num) const {
+  RTC_DCHECK(newest_);
+  uint16_t offset = ForwardDiff(oldest_, seq_num);
+  return offset <= ForwardDiff(oldest_, *newest_) ? offset : -1;
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
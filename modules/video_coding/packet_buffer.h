@@ -11,9 +11,10 @@
 #ifndef MODULES_VIDEO_CODING_PACKET_BUFFER_H_
 #define MODULES_VIDEO_CODING_PACKET_BUFFER_H_
 
+#include <stdint.h>
+
+#include <array>
 #include <memory>
-#include <queue>
-#include <set>
 #include <vector>
 
 #include "absl/base/attributes.h"
@@ -58,6 +59,9 @@ class PacketBuffer {
     // If all its previous packets have been inserted into the packet buffer.
     // Set and used internally by the PacketBuffer.
     bool continuous = false;
+    // Sequence number of the first packet of the frame, valid if |continuous|
+    // is set. Set and used internally by the PacketBuffer.
+    uint16_t frame_start_seq_num = 0;
     bool marker_bit = false;
     uint8_t payload_type = 0;
     uint16_t seq_num = 0;
@@ -96,6 +100,45 @@ class PacketBuffer {
       RTC_LOCKS_EXCLUDED(crit_);
 
  private:
+  // Tracks which of the most recent sequence numbers, up to the newest one
+  // inserted or padded, have not been received yet. Sequence numbers more than
+  // kMaxPaddingAge older than the newest one are forgotten. Backed by a bitmap
+  // indexed by sequence number, so that bursts of loss and clearing are cheap.
+  class MissingPackets {
+   public:
+    MissingPackets();
+
+    // Marks |seq_num| as received. If |seq_num| is the newest sequence number
+    // so far, the sequence numbers between it and the previous newest one are
+    // marked as missing.
+    void Insert(uint16_t seq_num);
+    // Whether any sequence number up to and including |seq_num| is missing.
+    bool AnyUpTo(uint16_t seq_num);
+    // Forgets the missing sequence numbers up to and including |seq_num|.
+    void EraseUpTo(uint16_t seq_num);
+    // Forgets the missing sequence numbers that are older than the newest
+    // missing one that is not newer than |seq_num|.
+    void EraseBeforeNewestUpTo(uint16_t seq_num);
+    void Clear();
+
+   private:
+    static constexpr uint16_t kMaxPaddingAge = 1000;
+    static constexpr size_t kWindowSize = 1024;
+    static constexpr size_t kBitsPerWord = 64;
+
+    bool IsMissing(uint16_t seq_num) const;
+    void SetMissing(uint16_t seq_num, bool missing);
+    // Position of |seq_num| in the window [oldest_, newest_], or -1 if it is
+    // outside of it.
+    int WindowOffset(uint16_t seq_num) const;
+
+    absl::optional<uint16_t> newest_;
+    // The oldest sequence number that may be missing. Sequence numbers in
+    // [oldest_, newest_] are missing if their bit is set; newest_ never is.
+    uint16_t oldest_;
+    std::array<uint64_t, kWindowSize / kBitsPerWord> bits_;
+  };
+
   Clock* const clock_;
 
   // Clears with |crit_| taken.
@@ -113,9 +156,6 @@ class PacketBuffer {
   std::vector<std::unique_ptr<Packet>> FindFrames(uint16_t seq_num)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  void UpdateMissingPackets(uint16_t seq_num)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
-
   rtc::CriticalSection crit_;
 
   // buffer_.size() and max_size_ must always be a power of two.
@@ -141,9 +181,7 @@ class PacketBuffer {
   absl::optional<uint32_t> last_received_keyframe_rtp_timestamp_
       RTC_GUARDED_BY(crit_);
 
-  absl::optional<uint16_t> newest_inserted_seq_num_ RTC_GUARDED_BY(crit_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> missing_packets_
-      RTC_GUARDED_BY(crit_);
+  MissingPackets missing_packets_ RTC_GUARDED_BY(crit_);
 
   // Indicates if we should require SPS, PPS, and IDR for a particular
   // RTP timestamp to treat the corresponding frame as a keyframe.
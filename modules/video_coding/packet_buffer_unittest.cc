@@ -10,15 +10,19 @@
 #include "modules/video_coding/packet_buffer.h"
 
 #include <cstring>
+#include <deque>
 #include <limits>
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "api/array_view.h"
 #include "common_video/h264/h264_common.h"
 #include "modules/video_coding/frame_object.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/random.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
@@ -730,6 +734,61 @@ TEST_F(PacketBufferTest, TooManyNalusInPacket) {
               IsEmpty());
 }
 
+TEST_F(PacketBufferTest, DISABLED_InsertWithBurstLossThroughput) {
+  constexpr int kNumPackets = 1000000;
+  constexpr int kPacketsPerFrame = 10;
+  constexpr int kRetransmissionDelayPackets = 300;
+  constexpr uint16_t kClearToDelayPackets = 1000;
+  PacketBuffer packet_buffer(&clock_, 512, 2048);
+
+  // Packet indices in arrival order. Losses come in bursts, following a
+  // two-state (Gilbert-Elliott) model. A lost packet arrives as a
+  // retransmission |kRetransmissionDelayPackets| later, unless that is lost
+  // too.
+  std::vector<int> arrivals;
+  std::deque<std::pair<int, int>> retransmissions;
+  bool in_burst = false;
+  for (int i = 0; i < kNumPackets; ++i) {
+    while (!retransmissions.empty() && retransmissions.front().first <= i) {
+      if (rand_.Rand<double>() > 0.1)
+        arrivals.push_back(retransmissions.front().second);
+      retransmissions.pop_front();
+    }
+    in_burst = in_burst ? rand_.Rand<double>() > 0.3
+                        : rand_.Rand<double>() < 0.01;
+    if (in_burst && rand_.Rand<double>() < 0.5) {
+      retransmissions.emplace_back(i + kRetransmissionDelayPackets, i);
+    } else {
+      arrivals.push_back(i);
+    }
+  }
+
+  int64_t start_us = rtc::TimeMicros();
+  int num_frames = 0;
+  for (int i : arrivals) {
+    auto packet = std::make_unique<PacketBuffer::Packet>();
+    packet->video_header.codec = kVideoCodecGeneric;
+    packet->seq_num = static_cast<uint16_t>(i);
+    packet->timestamp = i / kPacketsPerFrame;
+    packet->video_header.is_first_packet_in_frame = i % kPacketsPerFrame == 0;
+    packet->video_header.is_last_packet_in_frame =
+        i % kPacketsPerFrame == kPacketsPerFrame - 1;
+    PacketBuffer::InsertResult result =
+        packet_buffer.InsertPacket(std::move(packet));
+    if (!result.packets.empty()) {
+      num_frames += result.packets.size() / kPacketsPerFrame;
+      // Give up on frames that are too old to be completed.
+      packet_buffer.ClearTo(result.packets.back()->seq_num -
+                            kClearToDelayPackets);
+    }
+  }
+  int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  RTC_LOG(LS_INFO) << "Inserted " << arrivals.size() << " packets in "
+                   << elapsed_us << " us, "
+                   << arrivals.size() * int64_t{1000000} / elapsed_us
+                   << " packets/s, " << num_frames << " frames.";
+}
+
 TEST_P(PacketBufferH264ParameterizedTest, OneFrameFillBuffer) {
   InsertH264(0, kKeyFrame, kFirst, kNotLast, 1000);
   for (int i = 1; i < kStartSize - 1; ++i)
@@ -779,6 +838,18 @@ TEST_P(PacketBufferH264ParameterizedTest, FindFramesOnPadding) {
   EXPECT_THAT(packet_buffer_.InsertPadding(1), StartSeqNumsAre(2));
 }
 
+TEST_P(PacketBufferH264ParameterizedTest, OnlyRecentPacketsMissingAfterJump) {
+  EXPECT_THAT(InsertH264(0, kKeyFrame, kFirst, kLast, 1000),
+              StartSeqNumsAre(0));
+  EXPECT_THAT(InsertH264(2000, kDeltaFrame, kFirst, kLast, 2000).packets,
+              IsEmpty());
+
+  // Only the sequence numbers up to 1000 before the jump are missing.
+  for (uint16_t seq_num = 1001; seq_num < 1999; ++seq_num)
+    EXPECT_THAT(packet_buffer_.InsertPadding(seq_num).packets, IsEmpty());
+  EXPECT_THAT(packet_buffer_.InsertPadding(1999), StartSeqNumsAre(2000));
+}
+
 class PacketBufferH264XIsKeyframeTest : public PacketBufferH264Test {
  protected:
   const uint16_t kSeqNum = 5;
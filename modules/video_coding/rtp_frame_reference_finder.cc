@@ -122,9 +122,8 @@ RtpFrameReferenceFinder::ManageFrameInternal(RtpFrameObject* frame) {
 }
 
 void RtpFrameReferenceFinder::PaddingReceived(uint16_t seq_num) {
-  auto clean_padding_to =
-      stashed_padding_.lower_bound(seq_num - kMaxPaddingAge);
-  stashed_padding_.erase(stashed_padding_.begin(), clean_padding_to);
+  stashed_padding_.erase(
+      0, stashed_padding_.lower_bound(seq_num - kMaxPaddingAge));
   stashed_padding_.insert(seq_num);
   UpdateLastPictureIdWithPadding(seq_num);
   RetryStashedFrames();
@@ -144,38 +143,38 @@ void RtpFrameReferenceFinder::ClearTo(uint16_t seq_num) {
 }
 
 void RtpFrameReferenceFinder::UpdateLastPictureIdWithPadding(uint16_t seq_num) {
-  auto gop_seq_num_it = last_seq_num_gop_.upper_bound(seq_num);
+  size_t gop_index = last_seq_num_gop_.upper_bound(seq_num);
 
   // If this padding packet "belongs" to a group of pictures that we don't track
   // anymore, do nothing.
-  if (gop_seq_num_it == last_seq_num_gop_.begin())
+  if (gop_index == 0)
     return;
-  --gop_seq_num_it;
+  auto& gop_seq_num = last_seq_num_gop_[gop_index - 1];
 
   // Calculate the next contiuous sequence number and search for it in
   // the padding packets we have stashed.
-  uint16_t next_seq_num_with_padding = gop_seq_num_it->second.second + 1;
-  auto padding_seq_num_it =
+  uint16_t next_seq_num_with_padding = gop_seq_num.second.second + 1;
+  size_t padding_index =
       stashed_padding_.lower_bound(next_seq_num_with_padding);
 
   // While there still are padding packets and those padding packets are
   // continuous, then advance the "last-picture-id-with-padding" and remove
   // the stashed padding packet.
-  while (padding_seq_num_it != stashed_padding_.end() &&
-         *padding_seq_num_it == next_seq_num_with_padding) {
-    gop_seq_num_it->second.second = next_seq_num_with_padding;
+  while (padding_index < stashed_padding_.size() &&
+         stashed_padding_[padding_index] == next_seq_num_with_padding) {
+    gop_seq_num.second.second = next_seq_num_with_padding;
     ++next_seq_num_with_padding;
-    padding_seq_num_it = stashed_padding_.erase(padding_seq_num_it);
+    stashed_padding_.erase_at(padding_index);
   }
 
   // In the case where the stream has been continuous without any new keyframes
   // for a while there is a risk that new frames will appear to be older than
   // the keyframe they belong to due to wrapping sequence number. In order
   // to prevent this we advance the picture id of the keyframe every so often.
-  if (ForwardDiff(gop_seq_num_it->first, seq_num) > 10000) {
-    auto save = gop_seq_num_it->second;
+  if (ForwardDiff(gop_seq_num.first, seq_num) > 10000) {
+    auto save = gop_seq_num.second;
     last_seq_num_gop_.clear();
-    last_seq_num_gop_[seq_num] = save;
+    last_seq_num_gop_.insert(std::make_pair(seq_num, save));
   }
 }
 
@@ -223,28 +222,26 @@ RtpFrameReferenceFinder::ManageFramePidOrSeqNum(RtpFrameObject* frame,
 
   // Clean up info for old keyframes but make sure to keep info
   // for the last keyframe.
-  auto clean_to = last_seq_num_gop_.lower_bound(frame->last_seq_num() - 100);
-  for (auto it = last_seq_num_gop_.begin();
-       it != clean_to && last_seq_num_gop_.size() > 1;) {
-    it = last_seq_num_gop_.erase(it);
-  }
+  size_t clean_to = last_seq_num_gop_.lower_bound(frame->last_seq_num() - 100);
+  last_seq_num_gop_.erase(0,
+                          std::min(clean_to, last_seq_num_gop_.size() - 1));
 
   // Find the last sequence number of the last frame for the keyframe
   // that this frame indirectly references.
-  auto seq_num_it = last_seq_num_gop_.upper_bound(frame->last_seq_num());
-  if (seq_num_it == last_seq_num_gop_.begin()) {
+  size_t gop_index = last_seq_num_gop_.upper_bound(frame->last_seq_num());
+  if (gop_index == 0) {
     RTC_LOG(LS_WARNING) << "Generic frame with packet range ["
                         << frame->first_seq_num() << ", "
                         << frame->last_seq_num()
                         << "] has no GoP, dropping frame.";
     return kDrop;
   }
-  seq_num_it--;
+  auto& gop_seq_num = last_seq_num_gop_[gop_index - 1];
 
   // Make sure the packet sequence numbers are continuous, otherwise stash
   // this frame.
-  uint16_t last_picture_id_gop = seq_num_it->second.first;
-  uint16_t last_picture_id_with_padding_gop = seq_num_it->second.second;
+  uint16_t last_picture_id_gop = gop_seq_num.second.first;
+  uint16_t last_picture_id_with_padding_gop = gop_seq_num.second.second;
   if (frame->frame_type() == VideoFrameType::kVideoFrameDelta) {
     uint16_t prev_seq_num = frame->first_seq_num() - 1;
 
@@ -252,7 +249,7 @@ RtpFrameReferenceFinder::ManageFramePidOrSeqNum(RtpFrameObject* frame,
       return kStash;
   }
 
-  RTC_DCHECK(AheadOrAt(frame->last_seq_num(), seq_num_it->first));
+  RTC_DCHECK(AheadOrAt(frame->last_seq_num(), gop_seq_num.first));
 
   // Since keyframes can cause reordering we can't simply assign the
   // picture id according to some incrementing counter.
@@ -261,8 +258,8 @@ RtpFrameReferenceFinder::ManageFramePidOrSeqNum(RtpFrameObject* frame,
       frame->frame_type() == VideoFrameType::kVideoFrameDelta;
   frame->references[0] = rtp_seq_num_unwrapper_.Unwrap(last_picture_id_gop);
   if (AheadOf<uint16_t>(frame->id.picture_id, last_picture_id_gop)) {
-    seq_num_it->second.first = frame->id.picture_id;
-    seq_num_it->second.second = frame->id.picture_id;
+    gop_seq_num.second.first = frame->id.picture_id;
+    gop_seq_num.second.second = frame->id.picture_id;
   }
 
   UpdateLastPictureIdWithPadding(frame->id.picture_id);
@@ -294,9 +291,8 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   // Clean up info about not yet received frames that are too old.
   uint16_t old_picture_id =
       Subtract<kPicIdLength>(frame->id.picture_id, kMaxNotYetReceivedFrames);
-  auto clean_frames_to = not_yet_received_frames_.lower_bound(old_picture_id);
-  not_yet_received_frames_.erase(not_yet_received_frames_.begin(),
-                                 clean_frames_to);
+  not_yet_received_frames_.erase(
+      0, not_yet_received_frames_.lower_bound(old_picture_id));
   // Avoid re-adding picture ids that were just erased.
   if (AheadOf<uint16_t, kPicIdLength>(old_picture_id, last_picture_id_)) {
     last_picture_id_ = old_picture_id;
@@ -314,34 +310,33 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
 
   // Clean up info for base layers that are too old.
   int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxLayerInfo;
-  auto clean_layer_info_to = layer_info_.lower_bound(old_tl0_pic_idx);
-  layer_info_.erase(layer_info_.begin(), clean_layer_info_to);
+  layer_info_.erase(0, layer_info_.lower_bound(old_tl0_pic_idx));
 
   if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
     if (codec_header.temporalIdx != 0) {
       return kDrop;
     }
     frame->num_references = 0;
-    layer_info_[unwrapped_tl0].fill(-1);
+    layer_info_[layer_info_.insert({unwrapped_tl0, {}})].second.fill(-1);
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
   }
 
-  auto layer_info_it = layer_info_.find(
+  size_t layer_info_index = layer_info_.find(
       codec_header.temporalIdx == 0 ? unwrapped_tl0 - 1 : unwrapped_tl0);
 
   // If we don't have the base layer frame yet, stash this frame.
-  if (layer_info_it == layer_info_.end())
+  if (layer_info_index == layer_info_.size())
     return kStash;
 
   // A non keyframe base layer frame has been received, copy the layer info
   // from the previous base layer frame and set a reference to the previous
   // base layer frame.
   if (codec_header.temporalIdx == 0) {
-    layer_info_it =
-        layer_info_.emplace(unwrapped_tl0, layer_info_it->second).first;
+    layer_info_index = layer_info_.insert(
+        {unwrapped_tl0, layer_info_[layer_info_index].second});
     frame->num_references = 1;
-    int64_t last_pid_on_layer = layer_info_it->second[0];
+    int64_t last_pid_on_layer = layer_info_[layer_info_index].second[0];
 
     // Is this an old frame that has already been used to update the state? If
     // so, drop it.
@@ -358,7 +353,8 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
   // Layer sync frame, this frame only references its base layer frame.
   if (codec_header.layerSync) {
     frame->num_references = 1;
-    int64_t last_pid_on_layer = layer_info_it->second[codec_header.temporalIdx];
+    int64_t last_pid_on_layer =
+        layer_info_[layer_info_index].second[codec_header.temporalIdx];
 
     // Is this an old frame that has already been used to update the state? If
     // so, drop it.
@@ -368,39 +364,42 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
       return kDrop;
     }
 
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = layer_info_[layer_info_index].second[0];
     UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
     return kHandOff;
   }
 
   // Find all references for this frame.
+  const std::array<int64_t, kMaxTemporalLayers>& layer_info =
+      layer_info_[layer_info_index].second;
   frame->num_references = 0;
   for (uint8_t layer = 0; layer <= codec_header.temporalIdx; ++layer) {
     // If we have not yet received a previous frame on this temporal layer,
     // stash this frame.
-    if (layer_info_it->second[layer] == -1)
+    if (layer_info[layer] == -1)
       return kStash;
 
     // If the last frame on this layer is ahead of this frame it means that
     // a layer sync frame has been received after this frame for the same
     // base layer frame, drop this frame.
-    if (AheadOf<uint16_t, kPicIdLength>(layer_info_it->second[layer],
+    if (AheadOf<uint16_t, kPicIdLength>(layer_info[layer],
                                         frame->id.picture_id)) {
       return kDrop;
     }
 
     // If we have not yet received a frame between this frame and the referenced
     // frame then we have to wait for that frame to be completed first.
-    auto not_received_frame_it =
-        not_yet_received_frames_.upper_bound(layer_info_it->second[layer]);
-    if (not_received_frame_it != not_yet_received_frames_.end() &&
-        AheadOf<uint16_t, kPicIdLength>(frame->id.picture_id,
-                                        *not_received_frame_it)) {
+    size_t not_received_frame =
+        not_yet_received_frames_.upper_bound(layer_info[layer]);
+    if (not_received_frame < not_yet_received_frames_.size() &&
+        AheadOf<uint16_t, kPicIdLength>(
+            frame->id.picture_id,
+            not_yet_received_frames_[not_received_frame])) {
       return kStash;
     }
 
     if (!(AheadOf<uint16_t, kPicIdLength>(frame->id.picture_id,
-                                          layer_info_it->second[layer]))) {
+                                          layer_info[layer]))) {
       RTC_LOG(LS_WARNING) << "Frame with picture id " << frame->id.picture_id
                           << " and packet range [" << frame->first_seq_num()
                           << ", " << frame->last_seq_num()
@@ -410,7 +409,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
     }
 
     ++frame->num_references;
-    frame->references[layer] = layer_info_it->second[layer];
+    frame->references[layer] = layer_info[layer];
   }
 
   UpdateLayerInfoVp8(frame, unwrapped_tl0, codec_header.temporalIdx);
@@ -420,23 +419,22 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp8(
 void RtpFrameReferenceFinder::UpdateLayerInfoVp8(RtpFrameObject* frame,
                                                  int64_t unwrapped_tl0,
                                                  uint8_t temporal_idx) {
-  auto layer_info_it = layer_info_.find(unwrapped_tl0);
-
   // Update this layer info and newer.
-  while (layer_info_it != layer_info_.end()) {
-    if (layer_info_it->second[temporal_idx] != -1 &&
-        AheadOf<uint16_t, kPicIdLength>(layer_info_it->second[temporal_idx],
+  for (size_t index = layer_info_.find(unwrapped_tl0);
+       index < layer_info_.size() && layer_info_[index].first == unwrapped_tl0;
+       ++index, ++unwrapped_tl0) {
+    int64_t& last_pid_on_layer = layer_info_[index].second[temporal_idx];
+    if (last_pid_on_layer != -1 &&
+        AheadOf<uint16_t, kPicIdLength>(last_pid_on_layer,
                                         frame->id.picture_id)) {
       // The frame was not newer, then no subsequent layer info have to be
       // update.
       break;
     }
 
-    layer_info_it->second[temporal_idx] = frame->id.picture_id;
-    ++unwrapped_tl0;
-    layer_info_it = layer_info_.find(unwrapped_tl0);
+    last_pid_on_layer = frame->id.picture_id;
   }
-  not_yet_received_frames_.erase(frame->id.picture_id);
+  not_yet_received_frames_.erase_key(frame->id.picture_id);
 
   UnwrapPictureIds(frame);
 }
@@ -512,16 +510,16 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
       current_ss_idx_ = Add<kMaxGofSaved>(current_ss_idx_, 1);
       scalability_structures_[current_ss_idx_] = gof;
       scalability_structures_[current_ss_idx_].pid_start = frame->id.picture_id;
-      gof_info_.emplace(unwrapped_tl0,
-                        GofInfo(&scalability_structures_[current_ss_idx_],
-                                frame->id.picture_id));
+      gof_info_.insert(std::make_pair(
+          unwrapped_tl0, GofInfo(&scalability_structures_[current_ss_idx_],
+                                 frame->id.picture_id)));
     }
 
-    const auto gof_info_it = gof_info_.find(unwrapped_tl0);
-    if (gof_info_it == gof_info_.end())
+    size_t gof_info_index = gof_info_.find(unwrapped_tl0);
+    if (gof_info_index == gof_info_.size())
       return kStash;
 
-    info = &gof_info_it->second;
+    info = &gof_info_[gof_info_index].second;
 
     if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
       frame->num_references = 0;
@@ -534,11 +532,11 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
       RTC_LOG(LS_WARNING) << "Received keyframe without scalability structure";
       return kDrop;
     }
-    const auto gof_info_it = gof_info_.find(unwrapped_tl0);
-    if (gof_info_it == gof_info_.end())
+    size_t gof_info_index = gof_info_.find(unwrapped_tl0);
+    if (gof_info_index == gof_info_.size())
       return kStash;
 
-    info = &gof_info_it->second;
+    info = &gof_info_[gof_info_index].second;
 
     if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
       frame->num_references = 0;
@@ -547,27 +545,26 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
       return kHandOff;
     }
   } else {
-    auto gof_info_it = gof_info_.find(
+    size_t gof_info_index = gof_info_.find(
         (codec_header.temporal_idx == 0) ? unwrapped_tl0 - 1 : unwrapped_tl0);
 
     // Gof info for this frame is not available yet, stash this frame.
-    if (gof_info_it == gof_info_.end())
+    if (gof_info_index == gof_info_.size())
       return kStash;
 
     if (codec_header.temporal_idx == 0) {
-      gof_info_it = gof_info_
-                        .emplace(unwrapped_tl0, GofInfo(gof_info_it->second.gof,
-                                                        frame->id.picture_id))
-                        .first;
+      gof_info_index = gof_info_.insert(std::make_pair(
+          unwrapped_tl0, GofInfo(gof_info_[gof_info_index].second.gof,
+                                 frame->id.picture_id)));
     }
 
-    info = &gof_info_it->second;
+    info = &gof_info_[gof_info_index].second;
   }
 
-  // Clean up info for base layers that are too old.
+  // Clean up info for base layers that are too old. Erasing from the front
+  // leaves the remaining elements, and so |info|, in place.
   int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxGofSaved;
-  auto clean_gof_info_to = gof_info_.lower_bound(old_tl0_pic_idx);
-  gof_info_.erase(gof_info_.begin(), clean_gof_info_to);
+  gof_info_.erase(0, gof_info_.lower_bound(old_tl0_pic_idx));
 
   FrameReceivedVp9(frame->id.picture_id, info);
 
@@ -577,12 +574,12 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameVp9(
     return kStash;
 
   if (codec_header.temporal_up_switch)
-    up_switch_.emplace(frame->id.picture_id, codec_header.temporal_idx);
+    up_switch_.insert(
+        std::make_pair(frame->id.picture_id, codec_header.temporal_idx));
 
   // Clean out old info about up switch frames.
   uint16_t old_picture_id = Subtract<kPicIdLength>(frame->id.picture_id, 50);
-  auto up_switch_erase_to = up_switch_.lower_bound(old_picture_id);
-  up_switch_.erase(up_switch_.begin(), up_switch_erase_to);
+  up_switch_.erase(0, up_switch_.lower_bound(old_picture_id));
 
   size_t diff = ForwardDiff<uint16_t, kPicIdLength>(info->gof->pid_start,
                                                     frame->id.picture_id);
@@ -636,9 +633,11 @@ bool RtpFrameReferenceFinder::MissingRequiredFrameVp9(uint16_t picture_id,
     uint16_t ref_pid =
         Subtract<kPicIdLength>(picture_id, info.gof->pid_diff[gof_idx][i]);
     for (size_t l = 0; l < temporal_idx; ++l) {
-      auto missing_frame_it = missing_frames_for_layer_[l].lower_bound(ref_pid);
-      if (missing_frame_it != missing_frames_for_layer_[l].end() &&
-          AheadOf<uint16_t, kPicIdLength>(picture_id, *missing_frame_it)) {
+      const auto& missing_frames = missing_frames_for_layer_[l];
+      size_t missing_frame = missing_frames.lower_bound(ref_pid);
+      if (missing_frame < missing_frames.size() &&
+          AheadOf<uint16_t, kPicIdLength>(picture_id,
+                                          missing_frames[missing_frame])) {
         return true;
       }
     }
@@ -648,6 +647,13 @@ bool RtpFrameReferenceFinder::MissingRequiredFrameVp9(uint16_t picture_id,
 
 void RtpFrameReferenceFinder::FrameReceivedVp9(uint16_t picture_id,
                                                GofInfo* info) {
+  // Clean up info about missing frames that are too old, so that the missing
+  // frames of a layer never span more than a fraction of the picture id space.
+  uint16_t old_picture_id =
+      Subtract<kPicIdLength>(picture_id, kMaxNotYetReceivedFrames);
+  for (auto& missing_frames : missing_frames_for_layer_)
+    missing_frames.erase(0, missing_frames.lower_bound(old_picture_id));
+
   int last_picture_id = info->last_picture_id;
   size_t gof_size = std::min(info->gof->num_frames_in_gof, kMaxVp9FramesInGof);
 
@@ -672,7 +678,8 @@ void RtpFrameReferenceFinder::FrameReceivedVp9(uint16_t picture_id,
         return;
       }
 
-      missing_frames_for_layer_[temporal_idx].insert(last_picture_id);
+      if (AheadOrAt<uint16_t, kPicIdLength>(last_picture_id, old_picture_id))
+        missing_frames_for_layer_[temporal_idx].insert(last_picture_id);
       last_picture_id = Add<kPicIdLength>(last_picture_id, 1);
     }
 
@@ -691,18 +698,18 @@ void RtpFrameReferenceFinder::FrameReceivedVp9(uint16_t picture_id,
       return;
     }
 
-    missing_frames_for_layer_[temporal_idx].erase(picture_id);
+    missing_frames_for_layer_[temporal_idx].erase_key(picture_id);
   }
 }
 
 bool RtpFrameReferenceFinder::UpSwitchInIntervalVp9(uint16_t picture_id,
                                                     uint8_t temporal_idx,
                                                     uint16_t pid_ref) {
-  for (auto up_switch_it = up_switch_.upper_bound(pid_ref);
-       up_switch_it != up_switch_.end() &&
-       AheadOf<uint16_t, kPicIdLength>(picture_id, up_switch_it->first);
-       ++up_switch_it) {
-    if (up_switch_it->second < temporal_idx)
+  for (size_t index = up_switch_.upper_bound(pid_ref);
+       index < up_switch_.size() &&
+       AheadOf<uint16_t, kPicIdLength>(picture_id, up_switch_[index].first);
+       ++index) {
+    if (up_switch_[index].second < temporal_idx)
       return true;
   }
 
@@ -746,7 +753,7 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameH264(
 
   // Check for gap in sequence numbers. Store in |not_yet_received_seq_num_|.
   if (frame->frame_type() == VideoFrameType::kVideoFrameDelta) {
-    uint16_t last_pic_id_padded = last_seq_num_gop_.begin()->second.second;
+    uint16_t last_pic_id_padded = last_seq_num_gop_.front().second.second;
     if (AheadOf<uint16_t>(frame->id.picture_id, last_pic_id_padded)) {
       do {
         last_pic_id_padded = last_pic_id_padded + 1;
@@ -759,36 +766,33 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameH264(
 
   // Clean up info for base layers that are too old.
   int64_t old_tl0_pic_idx = unwrapped_tl0 - kMaxLayerInfo;
-  auto clean_layer_info_to = layer_info_.lower_bound(old_tl0_pic_idx);
-  layer_info_.erase(layer_info_.begin(), clean_layer_info_to);
+  layer_info_.erase(0, layer_info_.lower_bound(old_tl0_pic_idx));
 
   // Clean up info about not yet received frames that are too old.
   uint16_t old_picture_id = frame->id.picture_id - kMaxNotYetReceivedFrames * 2;
-  auto clean_frames_to = not_yet_received_seq_num_.lower_bound(old_picture_id);
-  not_yet_received_seq_num_.erase(not_yet_received_seq_num_.begin(),
-                                  clean_frames_to);
+  not_yet_received_seq_num_.erase(
+      0, not_yet_received_seq_num_.lower_bound(old_picture_id));
 
   if (frame->frame_type() == VideoFrameType::kVideoFrameKey) {
     frame->num_references = 0;
-    layer_info_[unwrapped_tl0].fill(-1);
+    layer_info_[layer_info_.insert({unwrapped_tl0, {}})].second.fill(-1);
     UpdateDataH264(frame, unwrapped_tl0, tid);
     return kHandOff;
   }
 
-  auto layer_info_it =
+  size_t layer_info_index =
       layer_info_.find(tid == 0 ? unwrapped_tl0 - 1 : unwrapped_tl0);
 
   // Stash if we have no base layer frame yet.
-  if (layer_info_it == layer_info_.end())
+  if (layer_info_index == layer_info_.size())
     return kStash;
 
   // Base layer frame. Copy layer info from previous base layer frame.
   if (tid == 0) {
-    layer_info_it =
-        layer_info_.insert(std::make_pair(unwrapped_tl0, layer_info_it->second))
-            .first;
+    layer_info_index = layer_info_.insert(
+        std::make_pair(unwrapped_tl0, layer_info_[layer_info_index].second));
     frame->num_references = 1;
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = layer_info_[layer_info_index].second[0];
     UpdateDataH264(frame, unwrapped_tl0, tid);
     return kHandOff;
   }
@@ -796,29 +800,32 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameH264(
   // This frame only references its base layer frame.
   if (blSync) {
     frame->num_references = 1;
-    frame->references[0] = layer_info_it->second[0];
+    frame->references[0] = layer_info_[layer_info_index].second[0];
     UpdateDataH264(frame, unwrapped_tl0, tid);
     return kHandOff;
   }
 
   // Find all references for general frame.
+  const std::array<int64_t, kMaxTemporalLayers>& layer_info =
+      layer_info_[layer_info_index].second;
   frame->num_references = 0;
   for (uint8_t layer = 0; layer <= tid; ++layer) {
     // Stash if we have not yet received frames on this temporal layer.
-    if (layer_info_it->second[layer] == -1)
+    if (layer_info[layer] == -1)
       return kStash;
 
     // Drop if the last frame on this layer is ahead of this frame. A layer sync
     // frame was received after this frame for the same base layer frame.
-    uint16_t last_frame_in_layer = layer_info_it->second[layer];
+    uint16_t last_frame_in_layer = layer_info[layer];
     if (AheadOf<uint16_t>(last_frame_in_layer, frame->id.picture_id))
       return kDrop;
 
     // Stash and wait for missing frame between this frame and the reference
-    auto not_received_seq_num_it =
+    size_t not_received_seq_num =
         not_yet_received_seq_num_.upper_bound(last_frame_in_layer);
-    if (not_received_seq_num_it != not_yet_received_seq_num_.end() &&
-        AheadOf<uint16_t>(frame->id.picture_id, *not_received_seq_num_it)) {
+    if (not_received_seq_num < not_yet_received_seq_num_.size() &&
+        AheadOf<uint16_t>(frame->id.picture_id,
+                          not_yet_received_seq_num_[not_received_seq_num])) {
       return kStash;
     }
 
@@ -840,39 +847,37 @@ RtpFrameReferenceFinder::FrameDecision RtpFrameReferenceFinder::ManageFrameH264(
 }
 
 void RtpFrameReferenceFinder::UpdateLastPictureIdWithPaddingH264() {
-  auto seq_num_it = last_seq_num_gop_.begin();
+  auto& gop_seq_num = last_seq_num_gop_.front();
 
   // Check if next sequence number is in a stashed padding packet.
-  uint16_t next_padded_seq_num = seq_num_it->second.second + 1;
-  auto padding_seq_num_it = stashed_padding_.lower_bound(next_padded_seq_num);
+  uint16_t next_padded_seq_num = gop_seq_num.second.second + 1;
+  size_t padding_index = stashed_padding_.lower_bound(next_padded_seq_num);
 
   // Check for more consecutive padding packets to increment
   // the "last-picture-id-with-padding" and remove the stashed packets.
-  while (padding_seq_num_it != stashed_padding_.end() &&
-         *padding_seq_num_it == next_padded_seq_num) {
-    seq_num_it->second.second = next_padded_seq_num;
+  while (padding_index < stashed_padding_.size() &&
+         stashed_padding_[padding_index] == next_padded_seq_num) {
+    gop_seq_num.second.second = next_padded_seq_num;
     ++next_padded_seq_num;
-    padding_seq_num_it = stashed_padding_.erase(padding_seq_num_it);
+    stashed_padding_.erase_at(padding_index);
   }
 }
 
 void RtpFrameReferenceFinder::UpdateLayerInfoH264(RtpFrameObject* frame,
                                                   int64_t unwrapped_tl0,
                                                   uint8_t temporal_idx) {
-  auto layer_info_it = layer_info_.find(unwrapped_tl0);
-
   // Update this layer info and newer.
-  while (layer_info_it != layer_info_.end()) {
-    if (layer_info_it->second[temporal_idx] != -1 &&
-        AheadOf<uint16_t>(layer_info_it->second[temporal_idx],
-                          frame->id.picture_id)) {
+  for (size_t index = layer_info_.find(unwrapped_tl0);
+       index < layer_info_.size() && layer_info_[index].first == unwrapped_tl0;
+       ++index, ++unwrapped_tl0) {
+    int64_t& last_pid_on_layer = layer_info_[index].second[temporal_idx];
+    if (last_pid_on_layer != -1 &&
+        AheadOf<uint16_t>(last_pid_on_layer, frame->id.picture_id)) {
       // Not a newer frame. No subsequent layer info needs update.
       break;
     }
 
-    layer_info_it->second[temporal_idx] = frame->id.picture_id;
-    ++unwrapped_tl0;
-    layer_info_it = layer_info_.find(unwrapped_tl0);
+    last_pid_on_layer = frame->id.picture_id;
   }
 
   for (size_t i = 0; i < frame->num_references; ++i)
@@ -884,21 +889,24 @@ void RtpFrameReferenceFinder::UpdateDataH264(RtpFrameObject* frame,
                                              int64_t unwrapped_tl0,
                                              uint8_t temporal_idx) {
   // Update last_seq_num_gop_ entry for last picture id.
-  auto seq_num_it = last_seq_num_gop_.begin();
-  uint16_t last_pic_id = seq_num_it->second.first;
+  auto& gop_seq_num = last_seq_num_gop_.front();
+  uint16_t last_pic_id = gop_seq_num.second.first;
   if (AheadOf<uint16_t>(frame->id.picture_id, last_pic_id)) {
-    seq_num_it->second.first = frame->id.picture_id;
-    seq_num_it->second.second = frame->id.picture_id;
+    gop_seq_num.second.first = frame->id.picture_id;
+    gop_seq_num.second.second = frame->id.picture_id;
   }
   UpdateLastPictureIdWithPaddingH264();
 
   UpdateLayerInfoH264(frame, unwrapped_tl0, temporal_idx);
 
   // Remove any current packets from |not_yet_received_seq_num_|.
-  uint16_t last_seq_num_padded = seq_num_it->second.second;
-  for (uint16_t n = frame->first_seq_num(); AheadOrAt(last_seq_num_padded, n);
-       ++n) {
-    not_yet_received_seq_num_.erase(n);
+  uint16_t first_seq_num = frame->first_seq_num();
+  uint16_t last_seq_num_padded = gop_seq_num.second.second;
+  if (AheadOrAt(last_seq_num_padded, first_seq_num)) {
+    size_t begin = not_yet_received_seq_num_.lower_bound(first_seq_num);
+    size_t end = not_yet_received_seq_num_.upper_bound(last_seq_num_padded);
+    if (begin < end)
+      not_yet_received_seq_num_.erase(begin, end);
   }
 }
 
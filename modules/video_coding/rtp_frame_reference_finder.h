@@ -13,14 +13,15 @@
 
 #include <array>
 #include <deque>
-#include <map>
+#include <functional>
 #include <memory>
-#include <set>
 #include <utility>
+#include <vector>
 
 #include "modules/include/module_common_types_public.h"
 #include "modules/rtp_rtcp/source/rtp_video_header.h"
 #include "modules/video_coding/codecs/vp9/include/vp9_globals.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/thread_annotations.h"
@@ -73,10 +74,134 @@ class RtpFrameReferenceFinder {
   enum FrameDecision { kStash, kHandOff, kDrop };
 
   struct GofInfo {
+    GofInfo() = default;
     GofInfo(GofInfoVP9* gof, uint16_t last_picture_id)
         : gof(gof), last_picture_id(last_picture_id) {}
-    GofInfoVP9* gof;
-    uint16_t last_picture_id;
+    GofInfoVP9* gof = nullptr;
+    uint16_t last_picture_id = 0;
+  };
+
+  // A sorted set of |Key|s, or map when |T| is a pair of |Key| and a value,
+  // stored in a ring whose storage only grows. All the state kept by the
+  // reference finder is pruned from the oldest end by a sliding window and
+  // mostly added to at the newest end, which both are cheap here, and the
+  // elements are contiguous in memory. Elements are referred to by their
+  // position, counted from the first element; positions are only stable until
+  // the next insertion or removal. Erasing elements does not release any
+  // resources held by them, so |T| should be a plain value type.
+  template <typename Key, typename T = Key, typename Compare = std::less<Key>>
+  class SortedRing {
+   public:
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    T& operator[](size_t index) { return slots_[Slot(index)]; }
+    const T& operator[](size_t index) const { return slots_[Slot(index)]; }
+    T& front() { return (*this)[0]; }
+    const T& front() const { return (*this)[0]; }
+    T& back() { return (*this)[size_ - 1]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    // Position of the first element not ordered before |key|.
+    size_t lower_bound(const Key& key) const {
+      if (size_ == 0 || Compare()(KeyOf(back()), key))
+        return size_;
+      return PartitionPoint(
+          [&key](const T& element) { return Compare()(KeyOf(element), key); });
+    }
+    // Position of the first element ordered after |key|.
+    size_t upper_bound(const Key& key) const {
+      if (size_ == 0 || !Compare()(key, KeyOf(back())))
+        return size_;
+      return PartitionPoint([&key](const T& element) {
+        return !Compare()(key, KeyOf(element));
+      });
+    }
+    // Position of the element with |key|, or size() if there is none.
+    size_t find(const Key& key) const {
+      size_t index = lower_bound(key);
+      if (index < size_ && !Compare()(key, KeyOf((*this)[index])))
+        return index;
+      return size_;
+    }
+
+    // Inserts |element| unless there already is an element with its key, and
+    // returns the position of the element with that key.
+    size_t insert(T element) {
+      size_t index = lower_bound(KeyOf(element));
+      if (index < size_ && !Compare()(KeyOf(element), KeyOf((*this)[index])))
+        return index;
+      if (size_ == slots_.size())
+        Grow();
+      for (size_t i = size_; i > index; --i)
+        (*this)[i] = std::move((*this)[i - 1]);
+      (*this)[index] = std::move(element);
+      ++size_;
+      return index;
+    }
+
+    // Erases the elements in the positions [|begin|, |end|).
+    void erase(size_t begin, size_t end) {
+      RTC_DCHECK_LE(begin, end);
+      RTC_DCHECK_LE(end, size_);
+      if (begin == 0) {
+        head_ = Slot(end);
+      } else {
+        for (size_t i = end; i < size_; ++i)
+          (*this)[begin + i - end] = std::move((*this)[i]);
+      }
+      size_ -= end - begin;
+    }
+    void erase_at(size_t index) { erase(index, index + 1); }
+    void erase_key(const Key& key) {
+      size_t index = find(key);
+      if (index < size_)
+        erase_at(index);
+    }
+    void clear() {
+      head_ = 0;
+      size_ = 0;
+    }
+
+   private:
+    static const Key& KeyOf(const Key& key) { return key; }
+    template <typename Value>
+    static const Key& KeyOf(const std::pair<Key, Value>& element) {
+      return element.first;
+    }
+
+    // Returns the position of the first element for which |before| is false,
+    // given that it is true for all elements before that and false for all
+    // elements after it.
+    template <typename Predicate>
+    size_t PartitionPoint(Predicate before) const {
+      size_t begin = 0;
+      size_t end = size_;
+      while (begin < end) {
+        size_t middle = begin + (end - begin) / 2;
+        if (before((*this)[middle])) {
+          begin = middle + 1;
+        } else {
+          end = middle;
+        }
+      }
+      return begin;
+    }
+
+    size_t Slot(size_t index) const {
+      return (head_ + index) & (slots_.size() - 1);
+    }
+    void Grow() {
+      std::vector<T> slots(slots_.empty() ? 16 : 2 * slots_.size());
+      for (size_t i = 0; i < size_; ++i)
+        slots[i] = std::move((*this)[i]);
+      slots_.swap(slots);
+      head_ = 0;
+    }
+
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
   };
 
   // Find the relevant group of pictures and update its "last-picture-id-with
@@ -149,9 +274,9 @@ class RtpFrameReferenceFinder {
   // the sequence number of the last packet of the last completed frame, and
   // the second being the sequence number of the last packet of the last
   // completed frame advanced by any potential continuous packets of padding.
-  std::map<uint16_t,
-           std::pair<uint16_t, uint16_t>,
-           DescendingSeqNumComp<uint16_t>>
+  SortedRing<uint16_t,
+             std::pair<uint16_t, std::pair<uint16_t, uint16_t>>,
+             DescendingSeqNumComp<uint16_t>>
       last_seq_num_gop_;
 
   // Save the last picture id in order to detect when there is a gap in frames
@@ -160,16 +285,20 @@ class RtpFrameReferenceFinder {
 
   // Padding packets that have been received but that are not yet continuous
   // with any group of pictures.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> stashed_padding_;
+  SortedRing<uint16_t, uint16_t, DescendingSeqNumComp<uint16_t>>
+      stashed_padding_;
 
   // Frames earlier than the last received frame that have not yet been
   // fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
+  SortedRing<uint16_t,
+             uint16_t,
+             DescendingSeqNumComp<uint16_t, kPicIdLength>>
       not_yet_received_frames_;
 
   // Sequence numbers of frames earlier than the last received frame that
   // have not yet been fully received.
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> not_yet_received_seq_num_;
+  SortedRing<uint16_t, uint16_t, DescendingSeqNumComp<uint16_t>>
+      not_yet_received_seq_num_;
 
   // Frames that have been fully received but didn't have all the information
   // needed to determine their references.
@@ -177,7 +306,9 @@ class RtpFrameReferenceFinder {
 
   // Holds the information about the last completed frame for a given temporal
   // layer given an unwrapped Tl0 picture index.
-  std::map<int64_t, std::array<int64_t, kMaxTemporalLayers>> layer_info_;
+  SortedRing<int64_t,
+             std::pair<int64_t, std::array<int64_t, kMaxTemporalLayers>>>
+      layer_info_;
 
   // Where the current scalability structure is in the
   // |scalability_structures_| array.
@@ -187,15 +318,20 @@ class RtpFrameReferenceFinder {
   std::array<GofInfoVP9, kMaxGofSaved> scalability_structures_;
 
   // Holds the the Gof information for a given unwrapped TL0 picture index.
-  std::map<int64_t, GofInfo> gof_info_;
+  SortedRing<int64_t, std::pair<int64_t, GofInfo>> gof_info_;
 
   // Keep track of which picture id and which temporal layer that had the
   // up switch flag set.
-  std::map<uint16_t, uint8_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>
+  SortedRing<uint16_t,
+             std::pair<uint16_t, uint8_t>,
+             DescendingSeqNumComp<uint16_t, kPicIdLength>>
       up_switch_;
 
-  // For every temporal layer, keep a set of which frames that are missing.
-  std::array<std::set<uint16_t, DescendingSeqNumComp<uint16_t, kPicIdLength>>,
+  // For every temporal layer, keep a set of which frames that are missing,
+  // among the last |kMaxNotYetReceivedFrames| picture ids.
+  std::array<SortedRing<uint16_t,
+                        uint16_t,
+                        DescendingSeqNumComp<uint16_t, kPicIdLength>>,
              kMaxTemporalLayers>
       missing_frames_for_layer_;
 
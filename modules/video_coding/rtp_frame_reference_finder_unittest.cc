@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <map>
@@ -15,11 +16,14 @@
 #include <utility>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "modules/video_coding/frame_object.h"
 #include "modules/video_coding/packet_buffer.h"
 #include "modules/video_coding/rtp_frame_reference_finder.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/random.h"
 #include "rtc_base/ref_count.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gtest.h"
 
@@ -33,12 +37,15 @@ std::unique_ptr<RtpFrameObject> CreateFrame(
     bool keyframe,
     VideoCodecType codec,
     const RTPVideoTypeHeader& video_type_header,
-    const FrameMarking& frame_markings) {
+    const FrameMarking& frame_markings,
+    const absl::optional<RTPVideoHeader::GenericDescriptorInfo>& generic =
+        absl::nullopt) {
   RTPVideoHeader video_header;
   video_header.frame_type = keyframe ? VideoFrameType::kVideoFrameKey
                                      : VideoFrameType::kVideoFrameDelta;
   video_header.video_type_header = video_type_header;
   video_header.frame_marking = frame_markings;
+  video_header.generic = generic;
 
   // clang-format off
   return std::make_unique<RtpFrameObject>(
@@ -1432,6 +1439,32 @@ TEST_F(TestRtpFrameReferenceFinder, Vp9GofZeroFrames) {
   CheckReferencesVp9(pid + 1, 0, pid);
 }
 
+TEST_F(TestRtpFrameReferenceFinder, Vp9GofLostFrameDoesNotBlockAfterPidWrap) {
+  // Temporal layers of the 02120212 pattern.
+  const uint8_t kTemporalIdx[] = {0, 2, 1, 2, 0, 2, 1, 2};
+  // Number of frames after which the picture id has wrapped around to the
+  // same position in the GOF.
+  const int kWrapFrames = 1 << 15;
+  uint16_t pid = Rand();
+  uint16_t sn = Rand();
+  GofInfoVP9 ss;
+  ss.SetGofInfoVP9(kTemporalStructureMode4);
+
+  InsertVp9Gof(sn, sn, true, pid, 0, 0, 0, false, false, &ss);
+  // The frame with pid + 2 is lost.
+  for (int i = 1; i < kWrapFrames + 4; ++i) {
+    if (i != 2) {
+      InsertVp9Gof(sn + i, sn + i, false, pid + i, 0, kTemporalIdx[i % 8],
+                   (i / 4) & 0xFF, false);
+    }
+  }
+
+  // The frame references the frame before it, which has the same picture id
+  // as the lost frame, but is not missing.
+  CheckReferencesVp9(pid + kWrapFrames + 3, 0, pid + kWrapFrames + 2,
+                     pid + kWrapFrames + 1);
+}
+
 TEST_F(TestRtpFrameReferenceFinder, H264KeyFrameReferences) {
   uint16_t sn = Rand();
   InsertH264(sn, sn, true);
@@ -1788,5 +1821,113 @@ TEST_F(TestRtpFrameReferenceFinder, H264Tl0PicIdxWrap) {
   }
 }
 
+namespace {
+class FrameCounter : public OnCompleteFrameCallback {
+ public:
+  void OnCompleteFrame(std::unique_ptr<EncodedFrame> frame) override {
+    ++num_frames_;
+  }
+  int num_frames() const { return num_frames_; }
+
+ private:
+  int num_frames_ = 0;
+};
+
+// Swaps about 10% of the frames after the first one with their successor, as
+// a jittery network would, hands them to a new reference finder and logs how
+// many frames per second it processes.
+void MeasureThroughput(const char* stream,
+                       std::vector<std::unique_ptr<RtpFrameObject>> frames) {
+  Random random(0x8739211);
+  for (size_t i = 1; i + 1 < frames.size(); ++i) {
+    if (random.Rand(9) == 0) {
+      std::swap(frames[i], frames[i + 1]);
+      ++i;
+    }
+  }
+
+  FrameCounter frame_counter;
+  RtpFrameReferenceFinder reference_finder(&frame_counter);
+  const int num_frames = frames.size();
+  int64_t start_us = rtc::TimeMicros();
+  for (std::unique_ptr<RtpFrameObject>& frame : frames)
+    reference_finder.ManageFrame(std::move(frame));
+  int64_t elapsed_us = std::max<int64_t>(rtc::TimeMicros() - start_us, 1);
+  EXPECT_EQ(frame_counter.num_frames(), num_frames) << stream;
+  RTC_LOG(LS_INFO) << stream << ": processed " << num_frames << " frames in "
+                   << elapsed_us << " us, "
+                   << num_frames * int64_t{1000000} / elapsed_us
+                   << " frames/s.";
+}
+}  // namespace
+
+TEST_F(TestRtpFrameReferenceFinder, DISABLED_ManageFrameThroughput) {
+  constexpr int kNumFrames = 20000;
+  // Temporal layers of an L1T3 stream, in the 0212 pattern. The first frames
+  // on the upper layers are layer sync frames.
+  constexpr uint8_t kTemporalIdx[] = {0, 2, 1, 2};
+  constexpr int kNumSyncFrames = 4;
+  uint16_t sn = Rand();
+  uint16_t pid = Rand();
+  std::vector<std::unique_ptr<RtpFrameObject>> frames;
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    RTPVideoHeaderVP8 vp8_header{};
+    vp8_header.pictureId = (pid + i) % (1 << 15);
+    vp8_header.temporalIdx = kTemporalIdx[i % 4];
+    vp8_header.tl0PicIdx = (i / 4) & 0xFF;
+    vp8_header.layerSync = i < kNumSyncFrames;
+    frames.push_back(CreateFrame(sn + i, sn + i, i == 0, kVideoCodecVP8,
+                                 vp8_header, FrameMarking()));
+  }
+  MeasureThroughput("VP8", std::move(frames));
+
+  GofInfoVP9 ss;
+  ss.SetGofInfoVP9(kTemporalStructureMode3);
+  for (int i = 0; i < kNumFrames; ++i) {
+    RTPVideoHeaderVP9 vp9_header{};
+    vp9_header.flexible_mode = false;
+    vp9_header.picture_id = (pid + i) % (1 << 15);
+    vp9_header.temporal_idx = kTemporalIdx[i % 4];
+    vp9_header.spatial_idx = 0;
+    vp9_header.tl0_pic_idx = (i / 4) & 0xFF;
+    vp9_header.inter_pic_predicted = i != 0;
+    if (i == 0) {
+      vp9_header.ss_data_available = true;
+      vp9_header.gof = ss;
+    }
+    frames.push_back(CreateFrame(sn + i, sn + i, i == 0, kVideoCodecVP9,
+                                 vp9_header, FrameMarking()));
+  }
+  MeasureThroughput("VP9", std::move(frames));
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    FrameMarking frame_marking{};
+    frame_marking.temporal_id = kTemporalIdx[i % 4];
+    frame_marking.tl0_pic_idx = (i / 4) & 0xFF;
+    frame_marking.base_layer_sync = i < kNumSyncFrames;
+    frames.push_back(CreateFrame(sn + i, sn + i, i == 0, kVideoCodecH264,
+                                 RTPVideoTypeHeader(), frame_marking));
+  }
+  MeasureThroughput("H264", std::move(frames));
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    frames.push_back(CreateFrame(sn + i, sn + i, i == 0, kVideoCodecGeneric,
+                                 RTPVideoTypeHeader(), FrameMarking()));
+  }
+  MeasureThroughput("Generic", std::move(frames));
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    RTPVideoHeader::GenericDescriptorInfo generic;
+    generic.frame_id = i;
+    if (i > 0)
+      generic.dependencies.push_back(i - 1);
+    frames.push_back(CreateFrame(sn + i, sn + i, i == 0, kVideoCodecGeneric,
+                                 RTPVideoTypeHeader(), FrameMarking(),
+                                 generic));
+  }
+  MeasureThroughput("Generic descriptor", std::move(frames));
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
@@ -82,6 +82,15 @@ int VCMTiming::max_playout_delay() {
   return max_playout_delay_ms_;
 }
 
+bool VCMTiming::UseLowLatencyRendering() const {
+  rtc::CritScope cs(&crit_sect_);
+  return UseLowLatencyRenderingInternal();
+}
+
+bool VCMTiming::UseLowLatencyRenderingInternal() const {
+  return min_playout_delay_ms_ == 0 && max_playout_delay_ms_ == 0;
+}
+
 void VCMTiming::SetJitterDelay(int jitter_delay_ms) {
   rtc::CritScope cs(&crit_sect_);
   if (jitter_delay_ms != jitter_delay_ms_) {
@@ -177,7 +186,7 @@ int64_t VCMTiming::RenderTimeMs(uint32_t frame_timestamp,
 
 int64_t VCMTiming::RenderTimeMsInternal(uint32_t frame_timestamp,
                                         int64_t now_ms) const {
-  if (min_playout_delay_ms_ == 0 && max_playout_delay_ms_ == 0) {
+  if (UseLowLatencyRenderingInternal()) {
     // Render as soon as possible.
     return 0;
   }
@@ -216,6 +225,10 @@ int VCMTiming::TargetVideoDelay() const {
 }
 
 int VCMTiming::TargetDelayInternal() const {
+  if (UseLowLatencyRenderingInternal()) {
+    // Frames are not held back for the jitter, only decoded and rendered.
+    return RequiredDecodeTimeMs() + render_delay_ms_;
+  }
   return std::max(min_playout_delay_ms_,
                   jitter_delay_ms_ + RequiredDecodeTimeMs() + render_delay_ms_);
 }
@@ -49,6 +49,11 @@ class VCMTiming {
   void set_max_playout_delay(int max_playout_delay_ms);
   int max_playout_delay();
 
+  // Returns true when the playout delay range is [0, 0], in which case frames
+  // are rendered as soon as they are decoded and decoded as soon as they are
+  // complete, regardless of the network jitter.
+  bool UseLowLatencyRendering() const;
+
   // Increases or decreases the current delay to get closer to the target delay.
   // Calculates how long it has been since the previous call to this function,
   // and increases/decreases the delay in proportion to the time difference.
@@ -85,7 +90,8 @@ class VCMTiming {
   virtual int64_t MaxWaitingTime(int64_t render_time_ms, int64_t now_ms) const;
 
   // Returns the current target delay which is required delay + decode time +
-  // render delay.
+  // render delay. With low-latency rendering there is no required delay, so
+  // this is the part of the glass-to-glass delay spent in the receiver.
   int TargetVideoDelay() const;
 
   // Return current timing information. Returns true if the first frame has been
@@ -108,6 +114,8 @@ class VCMTiming {
   int64_t RenderTimeMsInternal(uint32_t frame_timestamp, int64_t now_ms) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
   int TargetDelayInternal() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+  bool UseLowLatencyRenderingInternal() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
  private:
   rtc::CriticalSection crit_sect_;
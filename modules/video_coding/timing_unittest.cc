@@ -127,4 +127,29 @@ TEST(ReceiverTiming, WrapAround) {
   }
 }
 
+TEST(ReceiverTiming, LowLatencyRendering) {
+  SimulatedClock clock(0);
+  VCMTiming timing(&clock);
+  const int kJitterDelayMs = 80;
+  const int kDecodeTimeMs = 5;
+  const int kRenderDelayMs = 10;
+  timing.set_render_delay(kRenderDelayMs);
+  timing.SetJitterDelay(kJitterDelayMs);
+  // The first few decode times are ignored.
+  for (int i = 0; i < kFps; ++i) {
+    clock.AdvanceTimeMilliseconds(1000 / kFps);
+    timing.StopDecodeTimer(kDecodeTimeMs, clock.TimeInMilliseconds());
+  }
+  EXPECT_FALSE(timing.UseLowLatencyRendering());
+  EXPECT_EQ(kJitterDelayMs + kDecodeTimeMs + kRenderDelayMs,
+            timing.TargetVideoDelay());
+
+  timing.set_min_playout_delay(0);
+  timing.set_max_playout_delay(0);
+  EXPECT_TRUE(timing.UseLowLatencyRendering());
+  // Rendered right away, and the jitter no longer adds to the delay.
+  EXPECT_EQ(0, timing.RenderTimeMs(90000, clock.TimeInMilliseconds()));
+  EXPECT_EQ(kDecodeTimeMs + kRenderDelayMs, timing.TargetVideoDelay());
+}
+
 }  // namespace webrtc
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "modules/video_coding/utility/ivf_file_writer.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+constexpr size_t AsyncIvfFileWriter::kDefaultMaxQueuedBytes;
+
+// Shared with the queued tasks, so that it outlives the AsyncIvfFileWriter
+// until they have run.
+class AsyncIvfFileWriter::Writer : public rtc::RefCountInterface {
+ public:
+  Writer(FileWrapper file, size_t byte_limit)
+      : writer_(IvfFileWriter::Wrap(std::move(file), byte_limit)) {}
+
+  // Reserves |size| bytes of the queue, unless that takes it above
+  // |max_queued_bytes|.
+  bool Enqueue(size_t size, size_t max_queued_bytes) {
+    rtc::CritScope lock(&crit_);
+    if (stats_.failed)
+      return false;
+    if (stats_.queued_bytes > 0 &&
+        stats_.queued_bytes + size > max_queued_bytes) {
+      ++stats_.frames_dropped;
+      return false;
+    }
+    stats_.queued_bytes += size;
+    stats_.max_queued_bytes =
+        std::max(stats_.max_queued_bytes, stats_.queued_bytes);
+    return true;
+  }
+
+  // Runs on the file queue.
+  void Write(const EncodedImage& encoded_image, VideoCodecType codec_type) {
+    const bool written = writer_->WriteFrame(encoded_image, codec_type);
+    rtc::CritScope lock(&crit_);
+    stats_.queued_bytes -= encoded_image.size();
+    if (written) {
+      ++stats_.frames_written;
+    } else {
+      stats_.failed = true;
+    }
+  }
+
+  // Runs on the file queue.
+  void Close() { writer_->Close(); }
+
+  Stats GetStats() const {
+    rtc::CritScope lock(&crit_);
+    return stats_;
+  }
+
+ private:
+  const std::unique_ptr<IvfFileWriter> writer_;
+  rtc::CriticalSection crit_;
+  Stats stats_ RTC_GUARDED_BY(crit_);
+};
+
+AsyncIvfFileWriter::AsyncIvfFileWriter(TaskQueueBase* file_queue,
+                                       FileWrapper file,
+                                       size_t byte_limit,
+                                       size_t max_queued_bytes)
+    : file_queue_(file_queue),
+      max_queued_bytes_(max_queued_bytes),
+      writer_(new rtc::RefCountedObject<Writer>(std::move(file), byte_limit)) {
+}
+
+AsyncIvfFileWriter::~AsyncIvfFileWriter() {
+  file_queue_->PostTask(ToQueuedTask([writer = writer_] { writer->Close(); }));
+}
+
+bool AsyncIvfFileWriter::WriteFrame(const EncodedImage& encoded_image,
+                                    VideoCodecType codec_type) {
+  if (!writer_->Enqueue(encoded_image.size(), max_queued_bytes_))
+    return false;
+  // The caller's buffer may be reused once this returns.
+  EncodedImage copy = encoded_image;
+  copy.SetEncodedData(
+      EncodedImageBuffer::Create(encoded_image.data(), encoded_image.size()));
+  file_queue_->PostTask(ToQueuedTask(
+      [writer = writer_, copy = std::move(copy), codec_type] {
+        writer->Write(copy, codec_type);
+      }));
+  return true;
+}
+
+AsyncIvfFileWriter::Stats AsyncIvfFileWriter::GetStats() const {
+  return writer_->GetStats();
+}
+
+}  // namespace webrtc
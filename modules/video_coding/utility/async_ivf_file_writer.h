@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ASYNC_IVF_FILE_WRITER_H_
+#define MODULES_VIDEO_CODING_UTILITY_ASYNC_IVF_FILE_WRITER_H_
+
+#include <stddef.h>
+
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/video/encoded_image.h"
+#include "api/video/video_codec_type.h"
+#include "rtc_base/system/file_wrapper.h"
+
+namespace webrtc {
+
+// An IvfFileWriter that writes on |file_queue|, so that the callers don't
+// wait for the disk. Frames are copied and queued, and dropped while more
+// than |max_queued_bytes| are queued, so a slow disk doesn't take unbounded
+// memory. Many writers can share one queue.
+class AsyncIvfFileWriter {
+ public:
+  static constexpr size_t kDefaultMaxQueuedBytes = 8 * 1024 * 1024;
+
+  struct Stats {
+    size_t frames_written = 0;
+    // Frames dropped because too many bytes were queued.
+    size_t frames_dropped = 0;
+    size_t queued_bytes = 0;
+    size_t max_queued_bytes = 0;
+    // Whether a write failed, or the byte limit was reached. No frames are
+    // written after that.
+    bool failed = false;
+  };
+
+  // See IvfFileWriter::Wrap for |byte_limit|.
+  AsyncIvfFileWriter(TaskQueueBase* file_queue,
+                     FileWrapper file,
+                     size_t byte_limit,
+                     size_t max_queued_bytes = kDefaultMaxQueuedBytes);
+  // Closes the file on |file_queue| once the queued frames are written.
+  ~AsyncIvfFileWriter();
+
+  // Queues |encoded_image| for writing. Returns false if it is dropped, or if
+  // the writer has failed. May be called on any thread.
+  bool WriteFrame(const EncodedImage& encoded_image, VideoCodecType codec_type);
+
+  Stats GetStats() const;
+
+ private:
+  class Writer;
+
+  TaskQueueBase* const file_queue_;
+  const size_t max_queued_bytes_;
+  const rtc::scoped_refptr<Writer> writer_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ASYNC_IVF_FILE_WRITER_H_
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
+
+#include <memory>
+#include <string>
+
+#include "modules/video_coding/utility/ivf_file_reader.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_queue_for_test.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint8_t kPayload[4] = {'0', '1', '2', '3'};
+
+EncodedImage MakeFrame(uint32_t timestamp) {
+  EncodedImage frame;
+  frame.SetEncodedData(EncodedImageBuffer::Create(kPayload, sizeof(kPayload)));
+  frame._encodedWidth = 320;
+  frame._encodedHeight = 240;
+  frame.SetTimestamp(timestamp);
+  return frame;
+}
+
+}  // namespace
+
+class AsyncIvfFileWriterTest : public ::testing::Test {
+ protected:
+  AsyncIvfFileWriterTest()
+      : file_name_(test::TempFilename(test::OutputPath(), "async.ivf")),
+        file_queue_("FileQueue") {}
+  ~AsyncIvfFileWriterTest() override { test::RemoveFile(file_name_); }
+
+  std::unique_ptr<AsyncIvfFileWriter> CreateWriter(size_t max_queued_bytes) {
+    return std::make_unique<AsyncIvfFileWriter>(
+        file_queue_.Get(), FileWrapper::OpenWriteOnly(file_name_),
+        /*byte_limit=*/0, max_queued_bytes);
+  }
+
+  // Waits for the tasks posted to the file queue so far.
+  void WaitForFileQueue() { file_queue_.SendTask([] {}, RTC_FROM_HERE); }
+
+  const std::string file_name_;
+  TaskQueueForTest file_queue_;
+};
+
+TEST_F(AsyncIvfFileWriterTest, WritesFramesOnFileQueue) {
+  std::unique_ptr<AsyncIvfFileWriter> writer =
+      CreateWriter(AsyncIvfFileWriter::kDefaultMaxQueuedBytes);
+  EXPECT_TRUE(writer->WriteFrame(MakeFrame(90), kVideoCodecVP8));
+  EXPECT_TRUE(writer->WriteFrame(MakeFrame(180), kVideoCodecVP8));
+  WaitForFileQueue();
+  AsyncIvfFileWriter::Stats stats = writer->GetStats();
+  EXPECT_EQ(stats.frames_written, 2u);
+  EXPECT_EQ(stats.frames_dropped, 0u);
+  EXPECT_EQ(stats.queued_bytes, 0u);
+  EXPECT_FALSE(stats.failed);
+  writer = nullptr;
+  WaitForFileQueue();
+
+  std::unique_ptr<IvfFileReader> reader = IvfFileReader::Open(file_name_);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(reader->GetVideoCodecType(), kVideoCodecVP8);
+  EXPECT_EQ(reader->GetFramesCount(), 2u);
+}
+
+TEST_F(AsyncIvfFileWriterTest, DropsFramesWhileQueueIsFull) {
+  std::unique_ptr<AsyncIvfFileWriter> writer = CreateWriter(sizeof(kPayload));
+  // Hold up the file queue, so that the frames stay queued.
+  rtc::Event blocked;
+  file_queue_.PostTask([&blocked] { blocked.Wait(rtc::Event::kForever); });
+  EXPECT_TRUE(writer->WriteFrame(MakeFrame(90), kVideoCodecVP8));
+  EXPECT_FALSE(writer->WriteFrame(MakeFrame(180), kVideoCodecVP8));
+  AsyncIvfFileWriter::Stats stats = writer->GetStats();
+  EXPECT_EQ(stats.queued_bytes, sizeof(kPayload));
+  EXPECT_EQ(stats.frames_dropped, 1u);
+
+  blocked.Set();
+  WaitForFileQueue();
+  EXPECT_TRUE(writer->WriteFrame(MakeFrame(270), kVideoCodecVP8));
+  WaitForFileQueue();
+  stats = writer->GetStats();
+  EXPECT_EQ(stats.frames_written, 2u);
+  EXPECT_EQ(stats.frames_dropped, 1u);
+  EXPECT_EQ(stats.max_queued_bytes, sizeof(kPayload));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+
+namespace webrtc {
+namespace {
+
+constexpr char kFieldTrialName[] = "WebRTC-EncoderComplexityController";
+constexpr float kEncodeTimeAlpha = 0.9f;
+constexpr double kDefaultFramerateFps = 30.0;
+
+}  // namespace
+
+// static
+absl::optional<EncoderComplexityController::Config>
+EncoderComplexityController::ParseFieldTrial() {
+  Config config;
+  FieldTrialFlag enabled("Enabled");
+  FieldTrialParameter<double> high_usage("high_usage", config.high_usage);
+  FieldTrialParameter<double> low_usage("low_usage", config.low_usage);
+  FieldTrialParameter<int> min_offset("min_offset", config.min_speed_offset);
+  FieldTrialParameter<int> max_offset("max_offset", config.max_speed_offset);
+  FieldTrialParameter<int> min_frames("min_frames",
+                                      config.min_frames_between_changes);
+  webrtc::ParseFieldTrial(
+      {&enabled, &high_usage, &low_usage, &min_offset, &max_offset,
+       &min_frames},
+      field_trial::FindFullName(kFieldTrialName));
+  if (!enabled) {
+    return absl::nullopt;
+  }
+  if (low_usage >= high_usage || min_offset > 0 || max_offset < 0) {
+    RTC_LOG(LS_WARNING) << "Invalid " << kFieldTrialName << " config.";
+    return absl::nullopt;
+  }
+  config.high_usage = high_usage;
+  config.low_usage = low_usage;
+  config.min_speed_offset = min_offset;
+  config.max_speed_offset = max_offset;
+  config.min_frames_between_changes = std::max(1, min_frames.Get());
+  return config;
+}
+
+EncoderComplexityController::EncoderComplexityController(const Config& config)
+    : config_(config),
+      frame_interval_us_(rtc::kNumMicrosecsPerSec / kDefaultFramerateFps),
+      encode_time_us_(kEncodeTimeAlpha) {
+  RTC_DCHECK_LT(config_.low_usage, config_.high_usage);
+  RTC_DCHECK_LE(config_.min_speed_offset, 0);
+  RTC_DCHECK_GE(config_.max_speed_offset, 0);
+  Reset();
+}
+
+void EncoderComplexityController::Reset() {
+  encode_time_us_.Reset(kEncodeTimeAlpha);
+  speed_offset_ = 0;
+  frames_since_change_ = 0;
+}
+
+void EncoderComplexityController::SetFramerate(double framerate_fps) {
+  if (framerate_fps > 0) {
+    frame_interval_us_ = rtc::kNumMicrosecsPerSec / framerate_fps;
+  }
+}
+
+bool EncoderComplexityController::OnFrameEncoded(int64_t encode_time_us) {
+  encode_time_us_.Apply(1.0f, static_cast<float>(encode_time_us));
+  ++frames_since_change_;
+
+  int new_offset = speed_offset_;
+  const double current_usage = usage();
+  if (current_usage > config_.high_usage &&
+      frames_since_change_ >= config_.min_frames_between_changes) {
+    new_offset = std::min(speed_offset_ + 1, config_.max_speed_offset);
+  } else if (current_usage < config_.low_usage &&
+             frames_since_change_ >= 2 * config_.min_frames_between_changes) {
+    new_offset = std::max(speed_offset_ - 1, config_.min_speed_offset);
+  }
+  if (new_offset == speed_offset_) {
+    return false;
+  }
+  RTC_LOG(LS_VERBOSE) << "Encode usage " << current_usage
+                      << ", changing the speed offset to " << new_offset;
+  speed_offset_ = new_offset;
+  frames_since_change_ = 0;
+  return true;
+}
+
+double EncoderComplexityController::usage() const {
+  if (encode_time_us_.filtered() == rtc::ExpFilter::kValueUndefined) {
+    return 0.0;
+  }
+  return encode_time_us_.filtered() / frame_interval_us_;
+}
+
+}  // namespace webrtc
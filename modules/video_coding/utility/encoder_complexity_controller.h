@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ENCODER_COMPLEXITY_CONTROLLER_H_
+#define MODULES_VIDEO_CODING_UTILITY_ENCODER_COMPLEXITY_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "rtc_base/numerics/exp_filter.h"
+
+namespace webrtc {
+
+// Adjusts the speed preset of an encoder, e.g. the libvpx cpu-used setting,
+// so that the time spent encoding a frame stays within a share of the frame
+// interval. The encoder is sped up before the encode usage gets high enough
+// for OveruseFrameDetector to downgrade the resolution, and slowed down again
+// when there is CPU to spare.
+//
+// The controller returns a speed offset, which the encoder maps to its own
+// settings: 0 is the configured preset, and each step up is one step faster.
+class EncoderComplexityController {
+ public:
+  struct Config {
+    // Smoothed encode time over frame interval above which the encoder is sped
+    // up, and below which it is slowed down.
+    double high_usage = 0.7;
+    double low_usage = 0.35;
+    // The range of the speed offset.
+    int min_speed_offset = 0;
+    int max_speed_offset = 4;
+    // Frames to wait after a change before speeding up again. Slowing down
+    // waits twice as long, to avoid oscillating around |high_usage|.
+    int min_frames_between_changes = 10;
+  };
+
+  // Returns the config if the "WebRTC-EncoderComplexityController" field trial
+  // is enabled, e.g. with "Enabled,high_usage:0.7,max_offset:4".
+  static absl::optional<Config> ParseFieldTrial();
+
+  explicit EncoderComplexityController(const Config& config);
+
+  // Restarts at the configured preset, e.g. on reinitialization of the
+  // encoder.
+  void Reset();
+
+  void SetFramerate(double framerate_fps);
+
+  // Reports the wall time spent encoding the latest frame, and returns true if
+  // the speed offset changed.
+  bool OnFrameEncoded(int64_t encode_time_us);
+
+  int speed_offset() const { return speed_offset_; }
+
+  // Smoothed encode time over the frame interval, for tests and logging.
+  double usage() const;
+
+ private:
+  const Config config_;
+  double frame_interval_us_;
+  rtc::ExpFilter encode_time_us_;
+  int speed_offset_;
+  int frames_since_change_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ENCODER_COMPLEXITY_CONTROLLER_H_
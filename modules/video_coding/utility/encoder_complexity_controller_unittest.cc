@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoder_complexity_controller.h"
+
+#include "test/field_trial.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr double kFramerateFps = 30.0;
+constexpr int64_t kFrameIntervalUs = 33333;
+
+EncoderComplexityController::Config TestConfig() {
+  EncoderComplexityController::Config config;
+  config.high_usage = 0.7;
+  config.low_usage = 0.35;
+  config.min_speed_offset = 0;
+  config.max_speed_offset = 2;
+  config.min_frames_between_changes = 5;
+  return config;
+}
+
+// Encodes |num_frames| frames taking |usage| of the frame interval each, and
+// returns the number of speed offset changes.
+int EncodeFrames(EncoderComplexityController* controller,
+                 int num_frames,
+                 double usage) {
+  int changes = 0;
+  for (int i = 0; i < num_frames; ++i) {
+    if (controller->OnFrameEncoded(
+            static_cast<int64_t>(usage * kFrameIntervalUs))) {
+      ++changes;
+    }
+  }
+  return changes;
+}
+
+}  // namespace
+
+TEST(EncoderComplexityControllerTest, KeepsPresetAtModerateUsage) {
+  EncoderComplexityController controller(TestConfig());
+  controller.SetFramerate(kFramerateFps);
+  EXPECT_EQ(EncodeFrames(&controller, 100, 0.5), 0);
+  EXPECT_EQ(controller.speed_offset(), 0);
+  EXPECT_NEAR(controller.usage(), 0.5, 0.01);
+}
+
+TEST(EncoderComplexityControllerTest, SpeedsUpAtHighUsage) {
+  EncoderComplexityController controller(TestConfig());
+  controller.SetFramerate(kFramerateFps);
+  EXPECT_EQ(EncodeFrames(&controller, 5, 0.9), 1);
+  EXPECT_EQ(controller.speed_offset(), 1);
+}
+
+TEST(EncoderComplexityControllerTest, ClampsToMaxSpeedOffset) {
+  EncoderComplexityController controller(TestConfig());
+  controller.SetFramerate(kFramerateFps);
+  EXPECT_EQ(EncodeFrames(&controller, 100, 0.9), 2);
+  EXPECT_EQ(controller.speed_offset(), 2);
+}
+
+TEST(EncoderComplexityControllerTest, SlowsDownAtLowUsage) {
+  EncoderComplexityController controller(TestConfig());
+  controller.SetFramerate(kFramerateFps);
+  EncodeFrames(&controller, 100, 0.9);
+  ASSERT_EQ(controller.speed_offset(), 2);
+
+  // Slowing down waits twice as long as speeding up.
+  EncodeFrames(&controller, 9, 0.1);
+  EXPECT_EQ(controller.speed_offset(), 2);
+  EXPECT_EQ(EncodeFrames(&controller, 100, 0.1), 2);
+  EXPECT_EQ(controller.speed_offset(), 0);
+}
+
+TEST(EncoderComplexityControllerTest, UsageFollowsFramerate) {
+  EncoderComplexityController controller(TestConfig());
+  controller.SetFramerate(kFramerateFps);
+  EncodeFrames(&controller, 100, 0.5);
+  controller.SetFramerate(2 * kFramerateFps);
+  EXPECT_NEAR(controller.usage(), 1.0, 0.02);
+}
+
+TEST(EncoderComplexityControllerTest, ResetRestoresPreset) {
+  EncoderComplexityController controller(TestConfig());
+  controller.SetFramerate(kFramerateFps);
+  EncodeFrames(&controller, 100, 0.9);
+  ASSERT_NE(controller.speed_offset(), 0);
+
+  controller.Reset();
+  EXPECT_EQ(controller.speed_offset(), 0);
+  EXPECT_EQ(controller.usage(), 0.0);
+}
+
+TEST(EncoderComplexityControllerTest, DisabledWithoutFieldTrial) {
+  EXPECT_FALSE(EncoderComplexityController::ParseFieldTrial());
+}
+
+TEST(EncoderComplexityControllerTest, ParsesFieldTrial) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-EncoderComplexityController/"
+      "Enabled,high_usage:0.8,low_usage:0.4,max_offset:3,min_frames:20/");
+  absl::optional<EncoderComplexityController::Config> config =
+      EncoderComplexityController::ParseFieldTrial();
+  ASSERT_TRUE(config);
+  EXPECT_EQ(config->high_usage, 0.8);
+  EXPECT_EQ(config->low_usage, 0.4);
+  EXPECT_EQ(config->min_speed_offset, 0);
+  EXPECT_EQ(config->max_speed_offset, 3);
+  EXPECT_EQ(config->min_frames_between_changes, 20);
+}
+
+TEST(EncoderComplexityControllerTest, RejectsInvalidFieldTrial) {
+  test::ScopedFieldTrials field_trials(
+      "WebRTC-EncoderComplexityController/"
+      "Enabled,high_usage:0.3,low_usage:0.4/");
+  EXPECT_FALSE(EncoderComplexityController::ParseFieldTrial());
+}
+
+}  // namespace webrtc
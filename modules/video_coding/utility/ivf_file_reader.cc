@@ -10,6 +10,9 @@
 
 #include "modules/video_coding/utility/ivf_file_reader.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -23,6 +26,10 @@ namespace {
 constexpr size_t kIvfHeaderSize = 32;
 constexpr size_t kIvfFrameHeaderSize = 12;
 constexpr int kCodecTypeBytesCount = 4;
+// How far ahead of the read position a memory mapped file is prefetched, and
+// how far the read position advances before the next prefetch is issued.
+constexpr size_t kPrefetchSize = 4 * 1024 * 1024;
+constexpr size_t kPrefetchInterval = 1024 * 1024;
 
 constexpr uint8_t kFileHeaderStart[kCodecTypeBytesCount] = {'D', 'K', 'I', 'F'};
 constexpr uint8_t kVp8Header[kCodecTypeBytesCount] = {'V', 'P', '8', '0'};
@@ -39,6 +46,28 @@ std::unique_ptr<IvfFileReader> IvfFileReader::Create(FileWrapper file) {
   }
   return reader;
 }
+
+std::unique_ptr<IvfFileReader> IvfFileReader::Create(
+    rtc::scoped_refptr<MemoryMappedFile> file) {
+  RTC_DCHECK(file);
+  auto reader =
+      std::unique_ptr<IvfFileReader>(new IvfFileReader(std::move(file)));
+  if (!reader->Reset()) {
+    return nullptr;
+  }
+  return reader;
+}
+
+std::unique_ptr<IvfFileReader> IvfFileReader::Open(
+    const std::string& file_name) {
+  rtc::scoped_refptr<MemoryMappedFile> mapped_file =
+      MemoryMappedFile::Open(file_name);
+  if (mapped_file) {
+    return Create(std::move(mapped_file));
+  }
+  return Create(FileWrapper::OpenReadOnly(file_name));
+}
+
 IvfFileReader::~IvfFileReader() {
   Close();
 }
@@ -46,13 +75,13 @@ IvfFileReader::~IvfFileReader() {
 bool IvfFileReader::Reset() {
   // Set error to true while initialization.
   has_error_ = true;
-  if (!file_.Rewind()) {
+  if (!Rewind()) {
     RTC_LOG(LS_ERROR) << "Failed to rewind IVF file";
     return false;
   }
 
   uint8_t ivf_header[kIvfHeaderSize] = {0};
-  size_t read = file_.Read(&ivf_header, kIvfHeaderSize);
+  size_t read = Read(&ivf_header, kIvfHeaderSize);
   if (read != kIvfHeaderSize) {
     RTC_LOG(LS_ERROR) << "Failed to read IVF header";
     return false;
@@ -133,8 +162,8 @@ absl::optional<EncodedImage> IvfFileReader::NextFrame() {
     layer_sizes.push_back(current_layer_size);
 
     // Read next layer into payload
-    size_t read = file_.Read(&payload->data()[current_layer_start_pos],
-                             current_layer_size);
+    size_t read =
+        Read(&payload->data()[current_layer_start_pos], current_layer_size);
     if (read != current_layer_size) {
       RTC_LOG(LS_ERROR) << "Frame #" << num_read_frames_
                         << ": failed to read frame payload";
@@ -176,6 +205,10 @@ absl::optional<EncodedImage> IvfFileReader::NextFrame() {
 }
 
 bool IvfFileReader::Close() {
+  if (mapped_file_) {
+    mapped_file_ = nullptr;
+    return true;
+  }
   if (!file_.is_open())
     return false;
 
@@ -183,6 +216,40 @@ bool IvfFileReader::Close() {
   return true;
 }
 
+bool IvfFileReader::Rewind() {
+  if (!mapped_file_) {
+    return file_.Rewind();
+  }
+  position_ = 0;
+  prefetched_until_ = 0;
+  return true;
+}
+
+size_t IvfFileReader::Read(void* buf, size_t length) {
+  if (!mapped_file_) {
+    return file_.Read(buf, length);
+  }
+  // Keep the OS reading ahead of the read position, so that the copy below
+  // rarely has to wait for the disk.
+  if (position_ + kPrefetchSize >= prefetched_until_ + kPrefetchInterval) {
+    const size_t start = std::max(position_, prefetched_until_);
+    mapped_file_->Prefetch(start, position_ + kPrefetchSize - start);
+    prefetched_until_ = position_ + kPrefetchSize;
+  }
+  const size_t available = mapped_file_->size() - position_;
+  const size_t read = std::min(length, available);
+  memcpy(buf, mapped_file_->data() + position_, read);
+  position_ += read;
+  return read;
+}
+
+bool IvfFileReader::ReadEof() const {
+  if (!mapped_file_) {
+    return file_.ReadEof();
+  }
+  return position_ == mapped_file_->size();
+}
+
 absl::optional<VideoCodecType> IvfFileReader::ParseCodecType(uint8_t* buffer,
                                                              size_t start_pos) {
   if (memcmp(&buffer[start_pos], kVp8Header, kCodecTypeBytesCount) == 0) {
@@ -205,9 +272,9 @@ absl::optional<VideoCodecType> IvfFileReader::ParseCodecType(uint8_t* buffer,
 absl::optional<IvfFileReader::FrameHeader>
 IvfFileReader::ReadNextFrameHeader() {
   uint8_t ivf_frame_header[kIvfFrameHeaderSize] = {0};
-  size_t read = file_.Read(&ivf_frame_header, kIvfFrameHeaderSize);
+  size_t read = Read(&ivf_frame_header, kIvfFrameHeaderSize);
   if (read != kIvfFrameHeaderSize) {
-    if (read != 0 || !file_.ReadEof()) {
+    if (read != 0 || !ReadEof()) {
       has_error_ = true;
       RTC_LOG(LS_ERROR) << "Frame #" << num_read_frames_
                         << ": failed to read IVF frame header";
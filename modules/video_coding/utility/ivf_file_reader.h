@@ -12,11 +12,14 @@
 #define MODULES_VIDEO_CODING_UTILITY_IVF_FILE_READER_H_
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
 #include "api/video/encoded_image.h"
 #include "rtc_base/system/file_wrapper.h"
+#include "rtc_base/system/memory_mapped_file.h"
 
 namespace webrtc {
 
@@ -24,6 +27,14 @@ class IvfFileReader {
  public:
   // Creates IvfFileReader. Returns nullptr if error acquired.
   static std::unique_ptr<IvfFileReader> Create(FileWrapper file);
+  // Creates IvfFileReader reading from a memory mapped file. Several readers
+  // can share the same mapping. Returns nullptr if error acquired.
+  static std::unique_ptr<IvfFileReader> Create(
+      rtc::scoped_refptr<MemoryMappedFile> file);
+  // Creates IvfFileReader reading from a shared memory mapping of |file_name|
+  // where supported, and through FileWrapper otherwise. Returns nullptr if
+  // error acquired.
+  static std::unique_ptr<IvfFileReader> Open(const std::string& file_name);
   ~IvfFileReader();
   // Reinitializes reader. Returns false if any error acquired.
   bool Reset();
@@ -52,6 +63,13 @@ class IvfFileReader {
   };
 
   explicit IvfFileReader(FileWrapper file) : file_(std::move(file)) {}
+  explicit IvfFileReader(rtc::scoped_refptr<MemoryMappedFile> file)
+      : mapped_file_(std::move(file)) {}
+
+  // Read from |mapped_file_| if set, and from |file_| otherwise.
+  bool Rewind();
+  size_t Read(void* buf, size_t length);
+  bool ReadEof() const;
 
   // Parses codec type from specified position of the buffer. Codec type
   // contains kCodecTypeBytesCount bytes and caller has to ensure that buffer
@@ -67,6 +85,11 @@ class IvfFileReader {
   uint16_t height_;
   bool using_capture_timestamps_;
   FileWrapper file_;
+  rtc::scoped_refptr<MemoryMappedFile> mapped_file_;
+  // Read position in |mapped_file_|.
+  size_t position_ = 0;
+  // End of the range of |mapped_file_| that has been prefetched.
+  size_t prefetched_until_ = 0;
 
   absl::optional<FrameHeader> next_frame_header_;
   bool has_error_;
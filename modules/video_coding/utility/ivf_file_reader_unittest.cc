@@ -170,4 +170,32 @@ TEST_F(IvfFileReaderTest, MultilayerH264FileNtpTimestamp) {
   ValidateContent(kVideoCodecH264, false, 3);
 }
 
+TEST_F(IvfFileReaderTest, ReadersShareMemoryMappedFile) {
+  CreateTestFile(kVideoCodecVP9, false, 3);
+  rtc::scoped_refptr<MemoryMappedFile> mapped_file =
+      MemoryMappedFile::Open(file_name_);
+  if (!mapped_file) {
+    // Memory mapping isn't supported on this platform.
+    return;
+  }
+  std::unique_ptr<IvfFileReader> reader1 = IvfFileReader::Create(mapped_file);
+  std::unique_ptr<IvfFileReader> reader2 = IvfFileReader::Create(mapped_file);
+  ASSERT_TRUE(reader1);
+  ASSERT_TRUE(reader2);
+
+  // The readers have independent read positions.
+  ValidateFrame(reader1->NextFrame(), 1, false, 3);
+  ValidateFrame(reader1->NextFrame(), 2, false, 3);
+  ValidateFrame(reader2->NextFrame(), 1, false, 3);
+  ValidateFrame(reader1->NextFrame(), 3, false, 3);
+  EXPECT_FALSE(reader1->HasMoreFrames());
+  EXPECT_FALSE(reader1->HasError());
+  ASSERT_TRUE(reader1->Close());
+
+  ValidateFrame(reader2->NextFrame(), 2, false, 3);
+  ValidateFrame(reader2->NextFrame(), 3, false, 3);
+  EXPECT_FALSE(reader2->NextFrame());
+  EXPECT_FALSE(reader2->HasError());
+}
+
 }  // namespace webrtc
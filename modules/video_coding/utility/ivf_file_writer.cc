@@ -10,6 +10,8 @@
 
 #include "modules/video_coding/utility/ivf_file_writer.h"
 
+#include <string.h>
+
 #include <utility>
 
 #include "api/video_codecs/video_codec.h"
@@ -24,6 +26,8 @@ namespace webrtc {
 
 const size_t kIvfHeaderSize = 32;
 
+constexpr size_t IvfFileWriter::kWriteBlockSize;
+
 IvfFileWriter::IvfFileWriter(FileWrapper file, size_t byte_limit)
     : codec_type_(kVideoCodecGeneric),
       bytes_written_(0),
@@ -48,13 +52,8 @@ std::unique_ptr<IvfFileWriter> IvfFileWriter::Wrap(FileWrapper file,
       new IvfFileWriter(std::move(file), byte_limit));
 }
 
-bool IvfFileWriter::WriteHeader() {
-  if (!file_.Rewind()) {
-    RTC_LOG(LS_WARNING) << "Unable to rewind ivf output file.";
-    return false;
-  }
-
-  uint8_t ivf_header[kIvfHeaderSize] = {0};
+bool IvfFileWriter::MakeHeader(uint8_t* ivf_header) const {
+  memset(ivf_header, 0, kIvfHeaderSize);
   ivf_header[0] = 'D';
   ivf_header[1] = 'K';
   ivf_header[2] = 'I';
@@ -96,16 +95,6 @@ bool IvfFileWriter::WriteHeader() {
   ByteWriter<uint32_t>::WriteLittleEndian(&ivf_header[24],
                                           static_cast<uint32_t>(num_frames_));
   ByteWriter<uint32_t>::WriteLittleEndian(&ivf_header[28], 0);  // Reserved.
-
-  if (!file_.Write(ivf_header, kIvfHeaderSize)) {
-    RTC_LOG(LS_ERROR) << "Unable to write IVF header for ivf output file.";
-    return false;
-  }
-
-  if (bytes_written_ < kIvfHeaderSize) {
-    bytes_written_ = kIvfHeaderSize;
-  }
-
   return true;
 }
 
@@ -119,8 +108,17 @@ bool IvfFileWriter::InitFromFirstFrame(const EncodedImage& encoded_image,
 
   codec_type_ = codec_type;
 
-  if (!WriteHeader())
+  uint8_t ivf_header[kIvfHeaderSize];
+  if (!MakeHeader(ivf_header))
     return false;
+  // Drop the header of an earlier attempt whose frame wasn't written.
+  write_buffer_.Clear();
+  write_buffer_.EnsureCapacity(2 * kWriteBlockSize);
+  if (!WriteBuffered(ivf_header, kIvfHeaderSize)) {
+    RTC_LOG(LS_ERROR) << "Unable to write IVF header for ivf output file.";
+    return false;
+  }
+  bytes_written_ = kIvfHeaderSize;
 
   const char* codec_name = CodecTypeToPayloadString(codec_type_);
   RTC_LOG(LS_WARNING) << "Created IVF file for codec data of type "
@@ -196,8 +194,8 @@ bool IvfFileWriter::WriteOneSpatialLayer(int64_t timestamp,
   ByteWriter<uint32_t>::WriteLittleEndian(&frame_header[0],
                                           static_cast<uint32_t>(size));
   ByteWriter<uint64_t>::WriteLittleEndian(&frame_header[4], timestamp);
-  if (!file_.Write(frame_header, kFrameHeaderSize) ||
-      !file_.Write(data, size)) {
+  if (!WriteBuffered(frame_header, kFrameHeaderSize) ||
+      !WriteBuffered(data, size)) {
     RTC_LOG(LS_ERROR) << "Unable to write frame to file.";
     return false;
   }
@@ -217,9 +215,36 @@ bool IvfFileWriter::Close() {
     return true;
   }
 
-  bool ret = WriteHeader();
+  // Rewrite the header with the final frame count.
+  uint8_t ivf_header[kIvfHeaderSize];
+  bool ret = FlushWriteBuffer() && MakeHeader(ivf_header);
+  if (ret && (!file_.Rewind() || !file_.Write(ivf_header, kIvfHeaderSize))) {
+    RTC_LOG(LS_ERROR) << "Unable to write IVF header for ivf output file.";
+    ret = false;
+  }
   file_.Close();
   return ret;
 }
 
+bool IvfFileWriter::WriteBuffered(const uint8_t* data, size_t size) {
+  write_buffer_.AppendData(data, size);
+  if (write_buffer_.size() < kWriteBlockSize)
+    return true;
+  const size_t write_size =
+      write_buffer_.size() - write_buffer_.size() % kWriteBlockSize;
+  if (!file_.Write(write_buffer_.data(), write_size))
+    return false;
+  memmove(write_buffer_.data(), write_buffer_.data() + write_size,
+          write_buffer_.size() - write_size);
+  write_buffer_.SetSize(write_buffer_.size() - write_size);
+  return true;
+}
+
+bool IvfFileWriter::FlushWriteBuffer() {
+  const bool ret = write_buffer_.empty() ||
+                   file_.Write(write_buffer_.data(), write_buffer_.size());
+  write_buffer_.Clear();
+  return ret;
+}
+
 }  // namespace webrtc
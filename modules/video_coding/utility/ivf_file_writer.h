@@ -17,14 +17,20 @@
 #include <memory>
 
 #include "api/video/encoded_image.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/system/file_wrapper.h"
 #include "rtc_base/time_utils.h"
 
 namespace webrtc {
 
+// Writes encoded frames to an IVF file. The frames are buffered, and written
+// to the file in whole blocks of |kWriteBlockSize| bytes, so the writes are
+// few and at block aligned offsets. The rest is written by Close.
 class IvfFileWriter {
  public:
+  static constexpr size_t kWriteBlockSize = 64 * 1024;
+
   // Takes ownership of the file, which will be closed either through
   // Close or ~IvfFileWriter. If writing a frame would take the file above the
   // |byte_limit| the file will be closed, the write (and all future writes)
@@ -39,12 +45,16 @@ class IvfFileWriter {
  private:
   explicit IvfFileWriter(FileWrapper file, size_t byte_limit);
 
-  bool WriteHeader();
+  // Fills |ivf_header| with the header for the frames written so far.
+  bool MakeHeader(uint8_t* ivf_header) const;
   bool InitFromFirstFrame(const EncodedImage& encoded_image,
                           VideoCodecType codec_type);
   bool WriteOneSpatialLayer(int64_t timestamp,
                             const uint8_t* data,
                             size_t size);
+  // Appends to |write_buffer_|, and writes its whole blocks to the file.
+  bool WriteBuffered(const uint8_t* data, size_t size);
+  bool FlushWriteBuffer();
 
   VideoCodecType codec_type_;
   size_t bytes_written_;
@@ -56,6 +66,9 @@ class IvfFileWriter {
   bool using_capture_timestamps_;
   rtc::TimestampWrapAroundHandler wrap_handler_;
   FileWrapper file_;
+  // The data not yet written to |file_|, less than |kWriteBlockSize| bytes
+  // between writes.
+  rtc::Buffer write_buffer_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(IvfFileWriter);
 };
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "modules/rtp_rtcp/source/byte_io.h"
 #include "test/gtest.h"
@@ -181,4 +182,43 @@ TEST_F(IvfFileWriterTest, ClosesWhenReachesLimit) {
   out_file.Close();
 }
 
+TEST_F(IvfFileWriterTest, WritesWholeBlocksUntilClosed) {
+  file_writer_ = IvfFileWriter::Wrap(FileWrapper::OpenWriteOnly(file_name_), 0);
+  ASSERT_TRUE(file_writer_.get());
+  const size_t kFrameSize = IvfFileWriter::kWriteBlockSize / 3 + 1;
+  const int kNumFrames = 7;
+  std::vector<uint8_t> payload(kFrameSize);
+  EncodedImage frame;
+  frame._encodedWidth = 320;
+  frame._encodedHeight = 240;
+  for (int i = 1; i <= kNumFrames; ++i) {
+    for (uint8_t& byte : payload)
+      byte = static_cast<uint8_t>(i);
+    frame.SetEncodedData(
+        EncodedImageBuffer::Create(payload.data(), payload.size()));
+    frame.SetTimestamp(i);
+    ASSERT_TRUE(file_writer_->WriteFrame(frame, kVideoCodecVP8));
+    EXPECT_EQ(test::GetFileSize(file_name_) % IvfFileWriter::kWriteBlockSize,
+              0u);
+  }
+  EXPECT_GT(test::GetFileSize(file_name_), 0u);
+  EXPECT_TRUE(file_writer_->Close());
+  EXPECT_EQ(test::GetFileSize(file_name_),
+            kHeaderSize + kNumFrames * (kFrameHeaderSize + kFrameSize));
+
+  FileWrapper out_file = FileWrapper::OpenReadOnly(file_name_);
+  const uint8_t fourcc[4] = {'V', 'P', '8', '0'};
+  VerifyIvfHeader(&out_file, fourcc, 320, 240, kNumFrames, false);
+  for (int i = 1; i <= kNumFrames; ++i) {
+    uint8_t frame_header[kFrameHeaderSize];
+    ASSERT_EQ(static_cast<size_t>(kFrameHeaderSize),
+              out_file.Read(frame_header, kFrameHeaderSize));
+    EXPECT_EQ(kFrameSize,
+              ByteReader<uint32_t>::ReadLittleEndian(&frame_header[0]));
+    ASSERT_EQ(kFrameSize, out_file.Read(payload.data(), payload.size()));
+    EXPECT_EQ(std::vector<uint8_t>(kFrameSize, i), payload);
+  }
+  out_file.Close();
+}
+
 }  // namespace webrtc
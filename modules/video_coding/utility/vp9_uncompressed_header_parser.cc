@@ -9,32 +9,27 @@
  */
 #include "modules/video_coding/utility/vp9_uncompressed_header_parser.h"
 
-#include "rtc_base/bit_buffer.h"
+#include "api/array_view.h"
+#include "rtc_base/bitstream_reader.h"
 #include "rtc_base/logging.h"
 
 namespace webrtc {
 
-#define RETURN_FALSE_IF_ERROR(x) \
-  if (!(x)) {                    \
-    return false;                \
-  }
-
 namespace vp9 {
 namespace {
 const size_t kVp9NumRefsPerFrame = 3;
 const size_t kVp9MaxRefLFDeltas = 4;
 const size_t kVp9MaxModeLFDeltas = 2;
 
-bool Vp9ReadProfile(rtc::BitBuffer* br, uint8_t* profile) {
-  uint32_t high_bit;
-  uint32_t low_bit;
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&low_bit, 1));
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&high_bit, 1));
+// The readers below return false on unsupported or invalid bitstreams. Reads
+// past the end of the data are caught by checking BitstreamReader::Ok().
+
+bool Vp9ReadProfile(rtc::BitstreamReader* br, uint8_t* profile) {
+  uint8_t low_bit = br->ReadBit();
+  uint8_t high_bit = br->ReadBit();
   *profile = (high_bit << 1) + low_bit;
   if (*profile > 2) {
-    uint32_t reserved_bit;
-    RETURN_FALSE_IF_ERROR(br->ReadBits(&reserved_bit, 1));
-    if (reserved_bit) {
+    if (br->ReadBit()) {
       RTC_LOG(LS_WARNING) << "Failed to get QP. Unsupported bitstream profile.";
       return false;
     }
@@ -42,44 +37,37 @@ bool Vp9ReadProfile(rtc::BitBuffer* br, uint8_t* profile) {
   return true;
 }
 
-bool Vp9ReadSyncCode(rtc::BitBuffer* br) {
-  uint32_t sync_code;
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&sync_code, 24));
-  if (sync_code != 0x498342) {
+bool Vp9ReadSyncCode(rtc::BitstreamReader* br) {
+  if (br->ReadBits(24) != 0x498342) {
     RTC_LOG(LS_WARNING) << "Failed to get QP. Invalid sync code.";
     return false;
   }
   return true;
 }
 
-bool Vp9ReadColorConfig(rtc::BitBuffer* br, uint8_t profile) {
+bool Vp9ReadColorConfig(rtc::BitstreamReader* br, uint8_t profile) {
   if (profile == 2 || profile == 3) {
     // Bitdepth.
-    RETURN_FALSE_IF_ERROR(br->ConsumeBits(1));
+    br->ConsumeBits(1);
   }
-  uint32_t color_space;
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&color_space, 3));
+  uint64_t color_space = br->ReadBits(3);
 
   // SRGB is 7.
   if (color_space != 7) {
     // YUV range flag.
-    RETURN_FALSE_IF_ERROR(br->ConsumeBits(1));
+    br->ConsumeBits(1);
     if (profile == 1 || profile == 3) {
       // 1 bit: subsampling x.
       // 1 bit: subsampling y.
-      RETURN_FALSE_IF_ERROR(br->ConsumeBits(2));
-      uint32_t reserved_bit;
-      RETURN_FALSE_IF_ERROR(br->ReadBits(&reserved_bit, 1));
-      if (reserved_bit) {
+      br->ConsumeBits(2);
+      if (br->ReadBit()) {
         RTC_LOG(LS_WARNING) << "Failed to get QP. Reserved bit set.";
         return false;
       }
     }
   } else {
     if (profile == 1 || profile == 3) {
-      uint32_t reserved_bit;
-      RETURN_FALSE_IF_ERROR(br->ReadBits(&reserved_bit, 1));
-      if (reserved_bit) {
+      if (br->ReadBit()) {
         RTC_LOG(LS_WARNING) << "Failed to get QP. Reserved bit set.";
         return false;
       }
@@ -93,86 +81,68 @@ bool Vp9ReadColorConfig(rtc::BitBuffer* br, uint8_t profile) {
   return true;
 }
 
-bool Vp9ReadFrameSize(rtc::BitBuffer* br) {
+void Vp9ReadFrameSize(rtc::BitstreamReader* br) {
   // 2 bytes: frame width.
   // 2 bytes: frame height.
-  return br->ConsumeBytes(4);
+  br->ConsumeBits(32);
 }
 
-bool Vp9ReadRenderSize(rtc::BitBuffer* br) {
-  uint32_t bit;
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&bit, 1));
-  if (bit) {
+void Vp9ReadRenderSize(rtc::BitstreamReader* br) {
+  if (br->ReadBit()) {
     // 2 bytes: render width.
     // 2 bytes: render height.
-    RETURN_FALSE_IF_ERROR(br->ConsumeBytes(4));
+    br->ConsumeBits(32);
   }
-  return true;
 }
 
-bool Vp9ReadFrameSizeFromRefs(rtc::BitBuffer* br) {
-  uint32_t found_ref = 0;
+void Vp9ReadFrameSizeFromRefs(rtc::BitstreamReader* br) {
+  bool found_ref = false;
   for (size_t i = 0; i < kVp9NumRefsPerFrame; i++) {
     // Size in refs.
-    RETURN_FALSE_IF_ERROR(br->ReadBits(&found_ref, 1));
+    found_ref = br->ReadBit();
     if (found_ref)
       break;
   }
 
-  if (!found_ref) {
-    if (!Vp9ReadFrameSize(br)) {
-      return false;
-    }
-  }
-  return Vp9ReadRenderSize(br);
+  if (!found_ref)
+    Vp9ReadFrameSize(br);
+  Vp9ReadRenderSize(br);
 }
 
-bool Vp9ReadInterpolationFilter(rtc::BitBuffer* br) {
-  uint32_t bit;
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&bit, 1));
-  if (bit)
-    return true;
+void Vp9ReadInterpolationFilter(rtc::BitstreamReader* br) {
+  if (br->ReadBit())
+    return;
 
-  return br->ConsumeBits(2);
+  br->ConsumeBits(2);
 }
 
-bool Vp9ReadLoopfilter(rtc::BitBuffer* br) {
+void Vp9ReadLoopfilter(rtc::BitstreamReader* br) {
   // 6 bits: filter level.
   // 3 bits: sharpness level.
-  RETURN_FALSE_IF_ERROR(br->ConsumeBits(9));
+  br->ConsumeBits(9);
 
-  uint32_t mode_ref_delta_enabled;
-  RETURN_FALSE_IF_ERROR(br->ReadBits(&mode_ref_delta_enabled, 1));
+  bool mode_ref_delta_enabled = br->ReadBit();
   if (mode_ref_delta_enabled) {
-    uint32_t mode_ref_delta_update;
-    RETURN_FALSE_IF_ERROR(br->ReadBits(&mode_ref_delta_update, 1));
+    bool mode_ref_delta_update = br->ReadBit();
     if (mode_ref_delta_update) {
-      uint32_t bit;
       for (size_t i = 0; i < kVp9MaxRefLFDeltas; i++) {
-        RETURN_FALSE_IF_ERROR(br->ReadBits(&bit, 1));
-        if (bit) {
-          RETURN_FALSE_IF_ERROR(br->ConsumeBits(7));
-        }
+        if (br->ReadBit())
+          br->ConsumeBits(7);
       }
       for (size_t i = 0; i < kVp9MaxModeLFDeltas; i++) {
-        RETURN_FALSE_IF_ERROR(br->ReadBits(&bit, 1));
-        if (bit) {
-          RETURN_FALSE_IF_ERROR(br->ConsumeBits(7));
-        }
+        if (br->ReadBit())
+          br->ConsumeBits(7);
       }
     }
   }
-  return true;
 }
 }  // namespace
 
 bool GetQp(const uint8_t* buf, size_t length, int* qp) {
-  rtc::BitBuffer br(buf, length);
+  rtc::BitstreamReader br(rtc::MakeArrayView(buf, length));
 
   // Frame marker.
-  uint32_t frame_marker;
-  RETURN_FALSE_IF_ERROR(br.ReadBits(&frame_marker, 2));
-  if (frame_marker != 0x2) {
+  if (br.ReadBits(2) != 0x2) {
     RTC_LOG(LS_WARNING) << "Failed to get QP. Frame marker should be 2.";
     return false;
   }
@@ -183,35 +153,27 @@ bool GetQp(const uint8_t* buf, size_t length, int* qp) {
     return false;
 
   // Show existing frame.
-  uint32_t show_existing_frame;
-  RETURN_FALSE_IF_ERROR(br.ReadBits(&show_existing_frame, 1));
-  if (show_existing_frame)
+  if (br.ReadBit())
     return false;
 
   // Frame type: KEY_FRAME(0), INTER_FRAME(1).
-  uint32_t frame_type;
-  uint32_t show_frame;
-  uint32_t error_resilient;
-  RETURN_FALSE_IF_ERROR(br.ReadBits(&frame_type, 1));
-  RETURN_FALSE_IF_ERROR(br.ReadBits(&show_frame, 1));
-  RETURN_FALSE_IF_ERROR(br.ReadBits(&error_resilient, 1));
+  bool frame_type = br.ReadBit();
+  bool show_frame = br.ReadBit();
+  bool error_resilient = br.ReadBit();
 
   if (!frame_type) {
     if (!Vp9ReadSyncCode(&br))
       return false;
     if (!Vp9ReadColorConfig(&br, profile))
       return false;
-    if (!Vp9ReadFrameSize(&br))
-      return false;
-    if (!Vp9ReadRenderSize(&br))
-      return false;
-
+    Vp9ReadFrameSize(&br);
+    Vp9ReadRenderSize(&br);
   } else {
-    uint32_t intra_only = 0;
+    bool intra_only = false;
     if (!show_frame)
-      RETURN_FALSE_IF_ERROR(br.ReadBits(&intra_only, 1));
+      intra_only = br.ReadBit();
     if (!error_resilient)
-      RETURN_FALSE_IF_ERROR(br.ConsumeBits(2));  // Reset frame context.
+      br.ConsumeBits(2);  // Reset frame context.
 
     if (intra_only) {
       if (!Vp9ReadSyncCode(&br))
@@ -222,47 +184,43 @@ bool GetQp(const uint8_t* buf, size_t length, int* qp) {
           return false;
       }
       // Refresh frame flags.
-      RETURN_FALSE_IF_ERROR(br.ConsumeBits(8));
-      if (!Vp9ReadFrameSize(&br))
-        return false;
-      if (!Vp9ReadRenderSize(&br))
-        return false;
+      br.ConsumeBits(8);
+      Vp9ReadFrameSize(&br);
+      Vp9ReadRenderSize(&br);
     } else {
       // Refresh frame flags.
-      RETURN_FALSE_IF_ERROR(br.ConsumeBits(8));
+      br.ConsumeBits(8);
 
       for (size_t i = 0; i < kVp9NumRefsPerFrame; i++) {
         // 3 bits: Ref frame index.
         // 1 bit: Ref frame sign biases.
-        RETURN_FALSE_IF_ERROR(br.ConsumeBits(4));
+        br.ConsumeBits(4);
       }
 
-      if (!Vp9ReadFrameSizeFromRefs(&br))
-        return false;
+      Vp9ReadFrameSizeFromRefs(&br);
 
       // Allow high precision mv.
-      RETURN_FALSE_IF_ERROR(br.ConsumeBits(1));
+      br.ConsumeBits(1);
       // Interpolation filter.
-      if (!Vp9ReadInterpolationFilter(&br))
-        return false;
+      Vp9ReadInterpolationFilter(&br);
     }
   }
 
   if (!error_resilient) {
     // 1 bit: Refresh frame context.
     // 1 bit: Frame parallel decoding mode.
-    RETURN_FALSE_IF_ERROR(br.ConsumeBits(2));
+    br.ConsumeBits(2);
   }
 
   // Frame context index.
-  RETURN_FALSE_IF_ERROR(br.ConsumeBits(2));
+  br.ConsumeBits(2);
 
-  if (!Vp9ReadLoopfilter(&br))
-    return false;
+  Vp9ReadLoopfilter(&br);
 
   // Base QP.
-  uint8_t base_q0;
-  RETURN_FALSE_IF_ERROR(br.ReadUInt8(&base_q0));
+  uint8_t base_q0 = br.Read<uint8_t>();
+  if (!br.Ok())
+    return false;
   *qp = base_q0;
   return true;
 }
@@ -94,6 +94,11 @@ int32_t VideoReceiver2::Decode(const VCMEncodedFrame* frame) {
   return decoder->Decode(*frame, clock_->CurrentTime());
 }
 
+bool VideoReceiver2::PrepareDecoder(uint8_t payload_type) {
+  RTC_DCHECK_RUN_ON(&decoder_thread_checker_);
+  return codecDataBase_.PrepareDecoder(payload_type, &decodedFrameCallback_);
+}
+
 // Register possible receive codecs, can be called multiple times
 int32_t VideoReceiver2::RegisterReceiveCodec(const VideoCodec* receiveCodec,
                                              int32_t numberOfCores,
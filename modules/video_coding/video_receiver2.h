@@ -40,6 +40,11 @@ class VideoReceiver2 {
 
   int32_t Decode(const webrtc::VCMEncodedFrame* frame);
 
+  // Creates and initializes the decoder for |payload_type| before its first
+  // frame arrives, which then no longer waits for the decoder to be set up.
+  // Called on the decoder thread.
+  bool PrepareDecoder(uint8_t payload_type);
+
   // Notification methods that are used to check our internal state and validate
   // threading assumptions. These are called by VideoReceiveStream.
   // See |IsDecoderThreadRunning()| for more details.
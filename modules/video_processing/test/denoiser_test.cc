@@ -16,6 +16,7 @@
 #include <string>
 
 #include "api/scoped_refptr.h"
+#include "api/task_queue/default_task_queue_factory.h"
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame_buffer.h"
 #include "modules/video_processing/util/denoiser_filter.h"
@@ -26,6 +27,31 @@
 #include "test/testsupport/file_utils.h"
 
 namespace webrtc {
+namespace {
+
+// A noisy frame with a square moving to the right.
+rtc::scoped_refptr<I420Buffer> CreateNoisyFrame(int width,
+                                                int height,
+                                                int frame_number) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  uint32_t state = frame_number * 7919 + 1;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      state = state * 1103515245 + 12345;
+      const bool in_square = x >= frame_number * 4 &&
+                             x < frame_number * 4 + 64 && y >= 64 && y < 128;
+      buffer->MutableDataY()[y * buffer->StrideY() + x] =
+          (in_square ? 200 : 60 + x / 4) + (state >> 28);
+    }
+  }
+  memset(buffer->MutableDataU(), 128,
+         buffer->StrideU() * buffer->ChromaHeight());
+  memset(buffer->MutableDataV(), 128,
+         buffer->StrideV() * buffer->ChromaHeight());
+  return buffer;
+}
+
+}  // namespace
 
 TEST(VideoDenoiserTest, CopyMem) {
   std::unique_ptr<DenoiserFilter> df_c(DenoiserFilter::Create(false, nullptr));
@@ -165,4 +191,28 @@ TEST(VideoDenoiserTest, Denoiser) {
   ASSERT_NE(0, feof(source_file)) << "Error reading source file";
 }
 
+TEST(VideoDenoiserTest, DenoisesInBandsLikeSingleBand) {
+  const int kWidth = 320;
+  const int kHeight = 240;
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  VideoDenoiser denoiser(true);
+  VideoDenoiser banded_denoiser(true, task_queue_factory.get(),
+                                /*num_bands=*/3);
+
+  for (int i = 0; i < 30; ++i) {
+    rtc::scoped_refptr<I420BufferInterface> frame =
+        CreateNoisyFrame(kWidth, kHeight, i);
+    rtc::scoped_refptr<I420BufferInterface> denoised =
+        denoiser.DenoiseFrame(frame, /*noise_estimation_enabled=*/true);
+    rtc::scoped_refptr<I420BufferInterface> banded_denoised =
+        banded_denoiser.DenoiseFrame(frame, /*noise_estimation_enabled=*/true);
+
+    ASSERT_TRUE(test::FrameBufsEqual(denoised, banded_denoised));
+    // The chroma planes are not copied.
+    EXPECT_EQ(banded_denoised->DataU(), frame->DataU());
+    EXPECT_EQ(banded_denoised->DataV(), frame->DataV());
+  }
+}
+
 }  // namespace webrtc
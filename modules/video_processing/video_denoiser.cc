@@ -13,11 +13,21 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include "api/video/i420_buffer.h"
+#include "common_video/include/video_frame_buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "third_party/libyuv/include/libyuv/planar_functions.h"
 
 namespace webrtc {
 
+// Bands are filtered on separate threads only if each of them has at least
+// this many macroblock rows.
+constexpr int kMinMbRowsPerBand = 4;
+
 #if DISPLAY || DISPLAYNEON
 static void CopyMem8x8(const uint8_t* src,
                        int src_stride,
@@ -78,7 +88,24 @@ VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection)
     : width_(0),
       height_(0),
       filter_(DenoiserFilter::Create(runtime_cpu_detection, &cpu_type_)),
-      ne_(new NoiseEstimation()) {}
+      ne_(new NoiseEstimation()),
+      band_states_(1) {}
+
+VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection,
+                             TaskQueueFactory* task_queue_factory,
+                             int num_bands)
+    : VideoDenoiser(runtime_cpu_detection) {
+  RTC_DCHECK(task_queue_factory);
+  RTC_DCHECK_GE(num_bands, 1);
+  band_states_.resize(num_bands);
+  for (int i = 1; i < num_bands; ++i) {
+    band_queues_.push_back(
+        std::make_unique<rtc::TaskQueue>(task_queue_factory->CreateTaskQueue(
+            "VideoDenoiser", TaskQueueFactory::Priority::NORMAL)));
+  }
+}
+
+VideoDenoiser::~VideoDenoiser() = default;
 
 void VideoDenoiser::DenoiserReset(
     rtc::scoped_refptr<I420BufferInterface> frame) {
@@ -220,38 +247,24 @@ void VideoDenoiser::CopyLumaOnMargin(const uint8_t* y_src,
   }
 }
 
-rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
-    rtc::scoped_refptr<I420BufferInterface> frame,
-    bool noise_estimation_enabled) {
-  // If previous width and height are different from current frame's, need to
-  // reallocate the buffers and no denoising for the current frame.
-  if (!prev_buffer_ || width_ != frame->width() || height_ != frame->height()) {
-    DenoiserReset(frame);
-    prev_buffer_ = frame;
-    return frame;
-  }
+void VideoDenoiser::DenoiseBand(int mb_row_begin,
+                                int mb_row_end,
+                                const uint8_t* y_src,
+                                int stride_y_src,
+                                const uint8_t* y_dst_prev,
+                                int stride_prev,
+                                uint8_t* y_dst,
+                                int stride_y_dst,
+                                uint8_t noise_level,
+                                BandState* state) {
+  state->x_density.assign(mb_cols_, 0);
+  state->noise_samples.clear();
+  state->low_var_resets.clear();
 
-  // Set buffer pointers.
-  const uint8_t* y_src = frame->DataY();
-  int stride_y_src = frame->StrideY();
-  rtc::scoped_refptr<I420Buffer> dst =
-      buffer_pool_.CreateBuffer(width_, height_);
-
-  uint8_t* y_dst = dst->MutableDataY();
-  int stride_y_dst = dst->StrideY();
-
-  const uint8_t* y_dst_prev = prev_buffer_->DataY();
-  int stride_prev = prev_buffer_->StrideY();
-
-  memset(x_density_.get(), 0, mb_cols_);
-  memset(y_density_.get(), 0, mb_rows_);
-  memset(moving_object_.get(), 1, mb_cols_ * mb_rows_);
-
-  uint8_t noise_level = noise_estimation_enabled ? ne_->GetNoiseLevel() : 0;
   int thr_var_base = 16 * 16 * 2;
   // Loop over blocks to accumulate/extract noise level and update x/y_density
   // factors for moving object detection.
-  for (int mb_row = 0; mb_row < mb_rows_; ++mb_row) {
+  for (int mb_row = mb_row_begin; mb_row < mb_row_end; ++mb_row) {
     const int mb_index_base = mb_row * mb_cols_;
     const uint8_t* mb_src_base = y_src + (mb_row << 4) * stride_y_src;
     uint8_t* mb_dst_base = y_dst + (mb_row << 4) * stride_y_dst;
@@ -291,7 +304,8 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
           // time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
           uint32_t noise_var = filter_->Variance16x8(
               mb_dst_prev, stride_y_dst, mb_src, stride_y_src, &sse_t);
-          ne_->GetNoise(mb_index, noise_var, luma);
+          state->noise_samples.push_back({mb_index, noise_var,
+                                          static_cast<uint32_t>(luma)});
         }
         moving_edge_[mb_index] = 0;  // Not a moving edge block.
       } else {
@@ -302,10 +316,10 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
             mb_dst_prev, stride_prev, mb_dst, stride_y_dst, &sse_t);
         if (noise_var > thr_var_adp) {  // Moving edge checking.
           if (ne_enable) {
-            ne_->ResetConsecLowVar(mb_index);
+            state->low_var_resets.push_back(mb_index);
           }
           moving_edge_[mb_index] = 1;  // Mark as moving edge block.
-          x_density_[mb_col] += (pos_factor < 3);
+          state->x_density[mb_col] += (pos_factor < 3);
           y_density_[mb_row] += (pos_factor < 3);
         } else {
           moving_edge_[mb_index] = 0;
@@ -314,12 +328,84 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
             // in time t (mb_src) and filtered block in time t-1 (mb_dist_prev).
             uint32_t noise_var = filter_->Variance16x8(
                 mb_dst_prev, stride_prev, mb_src, stride_y_src, &sse_t);
-            ne_->GetNoise(mb_index, noise_var, luma);
+            state->noise_samples.push_back({mb_index, noise_var,
+                                            static_cast<uint32_t>(luma)});
           }
         }
       }
     }  // End of for loop
   }    // End of for loop
+}
+
+rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
+    rtc::scoped_refptr<I420BufferInterface> frame,
+    bool noise_estimation_enabled) {
+  // If previous width and height are different from current frame's, need to
+  // reallocate the buffers and no denoising for the current frame.
+  if (!prev_buffer_ || width_ != frame->width() || height_ != frame->height()) {
+    DenoiserReset(frame);
+    prev_buffer_ = frame;
+    return frame;
+  }
+
+  // Set buffer pointers.
+  const uint8_t* y_src = frame->DataY();
+  int stride_y_src = frame->StrideY();
+  rtc::scoped_refptr<I420Buffer> dst =
+      buffer_pool_.CreateBuffer(width_, height_);
+
+  uint8_t* y_dst = dst->MutableDataY();
+  int stride_y_dst = dst->StrideY();
+
+  const uint8_t* y_dst_prev = prev_buffer_->DataY();
+  int stride_prev = prev_buffer_->StrideY();
+
+  memset(y_density_.get(), 0, mb_rows_);
+  memset(moving_object_.get(), 1, mb_cols_ * mb_rows_);
+
+  uint8_t noise_level = noise_estimation_enabled ? ne_->GetNoiseLevel() : 0;
+
+  // Bands write disjoint macroblock rows of the outputs. Their noise samples
+  // and column densities are merged afterwards, which gives the same result
+  // as filtering the whole frame at once: the noise estimator only sums the
+  // samples, and each block gets at most one update per frame.
+  const int num_bands = std::max(
+      1, std::min(static_cast<int>(band_states_.size()),
+                  mb_rows_ / kMinMbRowsPerBand));
+  auto band_begin = [this, num_bands](int band) {
+    return mb_rows_ * band / num_bands;
+  };
+  std::atomic<int> pending_bands(num_bands - 1);
+  rtc::Event done;
+  for (int band = 1; band < num_bands; ++band) {
+    band_queues_[band - 1]->PostTask([&, band] {
+      DenoiseBand(band_begin(band), band_begin(band + 1), y_src, stride_y_src,
+                  y_dst_prev, stride_prev, y_dst, stride_y_dst, noise_level,
+                  &band_states_[band]);
+      if (--pending_bands == 0) {
+        done.Set();
+      }
+    });
+  }
+  DenoiseBand(band_begin(0), band_begin(1), y_src, stride_y_src, y_dst_prev,
+              stride_prev, y_dst, stride_y_dst, noise_level, &band_states_[0]);
+  if (num_bands > 1) {
+    done.Wait(rtc::Event::kForever);
+  }
+
+  memset(x_density_.get(), 0, mb_cols_);
+  for (int band = 0; band < num_bands; ++band) {
+    const BandState& state = band_states_[band];
+    for (int mb_col = 0; mb_col < mb_cols_; ++mb_col) {
+      x_density_[mb_col] += state.x_density[mb_col];
+    }
+    for (const BandState::NoiseSample& sample : state.noise_samples) {
+      ne_->GetNoise(sample.mb_index, sample.var, sample.luma);
+    }
+    for (int mb_index : state.low_var_resets) {
+      ne_->ResetConsecLowVar(mb_index);
+    }
+  }
 
   ReduceFalseDetection(moving_edge_, &moving_object_, noise_level);
 
@@ -330,21 +416,27 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
   if ((mb_rows_ << 4) != height_ || (mb_cols_ << 4) != width_)
     CopyLumaOnMargin(y_src, stride_y_src, y_dst, stride_y_dst);
 
+#if DISPLAY || DISPLAYNEON
   // Copy u/v planes.
   libyuv::CopyPlane(frame->DataU(), frame->StrideU(), dst->MutableDataU(),
                     dst->StrideU(), (width_ + 1) >> 1, (height_ + 1) >> 1);
   libyuv::CopyPlane(frame->DataV(), frame->StrideV(), dst->MutableDataV(),
                     dst->StrideV(), (width_ + 1) >> 1, (height_ + 1) >> 1);
 
-#if DISPLAY || DISPLAYNEON
   // Show rectangular region
   ShowRect(filter_, moving_edge_, moving_object_, x_density_, y_density_,
            frame->DataU(), frame->StrideU(), frame->DataV(), frame->StrideV(),
            dst->MutableDataU(), dst->StrideU(), dst->MutableDataV(),
            dst->StrideV(), mb_rows_, mb_cols_);
-#endif
   prev_buffer_ = dst;
-  return dst;
+#else
+  // The chroma planes are not denoised, so they are shared with |frame|
+  // instead of copied.
+  prev_buffer_ = WrapI420Buffer(
+      width_, height_, dst->DataY(), dst->StrideY(), frame->DataU(),
+      frame->StrideU(), frame->DataV(), frame->StrideV(), [dst, frame] {});
+#endif
+  return prev_buffer_;
 }
 
 }  // namespace webrtc
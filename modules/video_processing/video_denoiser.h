@@ -12,27 +12,66 @@
 #define MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 
 #include <memory>
+#include <vector>
 
 #include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "api/video/video_frame_buffer.h"
 #include "common_video/include/i420_buffer_pool.h"
 #include "modules/video_processing/util/denoiser_filter.h"
 #include "modules/video_processing/util/noise_estimation.h"
 #include "modules/video_processing/util/skin_detection.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
 class VideoDenoiser {
  public:
   explicit VideoDenoiser(bool runtime_cpu_detection);
+  // Same as above, but splits frames into up to |num_bands| horizontal bands
+  // of macroblock rows, which are filtered in parallel on task queues created
+  // by |task_queue_factory|. The output is the same as with a single band.
+  VideoDenoiser(bool runtime_cpu_detection,
+                TaskQueueFactory* task_queue_factory,
+                int num_bands);
+  ~VideoDenoiser();
 
+  // The returned buffer shares the chroma planes of |frame|, which are not
+  // denoised.
   rtc::scoped_refptr<I420BufferInterface> DenoiseFrame(
       rtc::scoped_refptr<I420BufferInterface> frame,
       bool noise_estimation_enabled);
 
  private:
+  // Noise estimation and moving edge data of a band, which are merged once all
+  // bands are filtered.
+  struct BandState {
+    struct NoiseSample {
+      int mb_index;
+      uint32_t var;
+      uint32_t luma;
+    };
+
+    std::vector<uint8_t> x_density;
+    std::vector<NoiseSample> noise_samples;
+    std::vector<int> low_var_resets;
+  };
+
   void DenoiserReset(rtc::scoped_refptr<I420BufferInterface> frame);
 
+  // Filters the macroblock rows [|mb_row_begin|, |mb_row_end|) of the luma
+  // plane into |y_dst|.
+  void DenoiseBand(int mb_row_begin,
+                   int mb_row_end,
+                   const uint8_t* y_src,
+                   int stride_y_src,
+                   const uint8_t* y_dst_prev,
+                   int stride_prev,
+                   uint8_t* y_dst,
+                   int stride_y_dst,
+                   uint8_t noise_level,
+                   BandState* state);
+
   // Check the mb position, return 1: close to the frame center (between 1/8
   // and 7/8 of width/height), 3: close to the border (out of 1/16 and 15/16
   // of width/height), 2: in between.
@@ -77,8 +116,11 @@ class VideoDenoiser {
   std::unique_ptr<uint8_t[]> y_density_;
   // Save the return values by MbDenoise for each block.
   std::unique_ptr<DenoiserDecision[]> mb_filter_decision_;
+  std::vector<BandState> band_states_;
   I420BufferPool buffer_pool_;
   rtc::scoped_refptr<I420BufferInterface> prev_buffer_;
+  // Filter all bands but the first, which is filtered on the calling thread.
+  std::vector<std::unique_ptr<rtc::TaskQueue>> band_queues_;
 };
 
 }  // namespace webrtc
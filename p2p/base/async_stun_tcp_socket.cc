@@ -14,6 +14,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "api/array_view.h"
 #include "api/transport/stun.h"
 #include "rtc_base/byte_order.h"
 #include "rtc_base/checks.h"
@@ -61,7 +62,7 @@ int AsyncStunTCPSocket::Send(const void* pv,
   }
 
   // If we are blocking on send, then silently drop this packet
-  if (!IsOutBufferEmpty())
+  if (IsSendBlocked())
     return static_cast<int>(cb);
 
   int pad_bytes;
@@ -71,22 +72,19 @@ int AsyncStunTCPSocket::Send(const void* pv,
   if (cb != expected_pkt_len)
     return -1;
 
-  AppendToOutBuffer(pv, cb);
-
   RTC_DCHECK(pad_bytes < 4);
-  char padding[4] = {0};
-  AppendToOutBuffer(padding, pad_bytes);
-
-  int res = FlushOutBuffer();
+  static constexpr uint8_t kPadding[4] = {0};
+  const rtc::ArrayView<const uint8_t> buffers[] = {
+      rtc::MakeArrayView(static_cast<const uint8_t*>(pv), cb),
+      rtc::MakeArrayView(kPadding, pad_bytes)};
+  int res = SendPacketBuffers(
+      buffers, rtc::SentPacket(options.packet_id, rtc::TimeMillis()));
   if (res <= 0) {
     // drop packet if we made no progress
     ClearOutBuffer();
     return res;
   }
 
-  rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis());
-  SignalSentPacket(this, sent_packet);
-
   // We claim to have sent the whole thing, even if we only sent partial
   return static_cast<int>(cb);
 }
@@ -116,13 +114,11 @@ void AsyncStunTCPSocket::ProcessInput(char* data, size_t* len) {
       return;
     }
 
-    SignalReadPacket(this, data, expected_pkt_len, remote_addr,
-                     rtc::TimeMicros());
+    NotifyPacketReceived(data, expected_pkt_len, remote_addr,
+                         rtc::TimeMicros());
 
+    data += actual_length;
     *len -= actual_length;
-    if (*len > 0) {
-      memmove(data, data + actual_length, *len);
-    }
   }
 }
 
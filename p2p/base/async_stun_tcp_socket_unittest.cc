@@ -253,6 +253,26 @@ TEST_F(AsyncStunTCPSocketTest, TestWithSmallSendBuffer) {
                         sizeof(kTurnChannelDataMessageWithOddLength)));
 }
 
+// Test that padded and unpadded packets that arrive in one read are all
+// delivered.
+TEST_F(AsyncStunTCPSocketTest, TestMultiplePacketsInOneRead) {
+  rtc::PacketOptions options;
+  for (int i = 0; i < 3; ++i) {
+    send_socket_->Send(kTurnChannelDataMessageWithOddLength,
+                       sizeof(kTurnChannelDataMessageWithOddLength), options);
+    send_socket_->Send(kStunMessageWithZeroLength,
+                       sizeof(kStunMessageWithZeroLength), options);
+  }
+  vss_->ProcessMessagesUntilIdle();
+  ASSERT_EQ(6u, recv_packets_.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(CheckData(kTurnChannelDataMessageWithOddLength,
+                          sizeof(kTurnChannelDataMessageWithOddLength)));
+    EXPECT_TRUE(CheckData(kStunMessageWithZeroLength,
+                          sizeof(kStunMessageWithZeroLength)));
+  }
+}
+
 // Test that SignalSentPacket is fired when a packet is sent.
 TEST_F(AsyncStunTCPSocketTest, SignalSentPacketFiredWhenPacketSent) {
   ASSERT_TRUE(
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Throughput of the ICE-TCP framing in AsyncTCPSocket and AsyncStunTCPSocket,
+// measured on top of an in-memory socket so that only the framing and the
+// buffering are timed, not the kernel.
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "api/array_view.h"
+#include "p2p/base/async_stun_tcp_socket.h"
+#include "rtc_base/async_socket.h"
+#include "rtc_base/async_tcp_socket.h"
+#include "rtc_base/byte_order.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace cricket {
+namespace {
+
+using webrtc::test::ImproveDirection;
+
+constexpr size_t kPacketSizes[] = {100, 1200};
+// Largest chunk handed out by one Recv(), like a kernel socket buffer.
+constexpr size_t kMaxRecvSize = 64 * 1024;
+
+int Iterations(int full_iterations) {
+  return webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest")
+             ? full_iterations / 100
+             : full_iterations;
+}
+
+// Connected stream socket that accepts everything sent, and that returns a
+// given byte stream, over and over, from Recv().
+class FakeStreamSocket : public rtc::AsyncSocket {
+ public:
+  explicit FakeStreamSocket(std::vector<uint8_t> input)
+      : input_(std::move(input)) {}
+
+  // Lets the next |bytes| bytes of the input be received.
+  void AllowRecv(size_t bytes) { recv_allowed_ += bytes; }
+  size_t bytes_sent() const { return bytes_sent_; }
+
+  rtc::SocketAddress GetLocalAddress() const override {
+    return rtc::SocketAddress("1.1.1.1", 1000);
+  }
+  rtc::SocketAddress GetRemoteAddress() const override {
+    return rtc::SocketAddress("2.2.2.2", 2000);
+  }
+  int Bind(const rtc::SocketAddress& addr) override { return 0; }
+  int Connect(const rtc::SocketAddress& addr) override { return 0; }
+  int Send(const void* pv, size_t cb) override {
+    bytes_sent_ += cb;
+    return static_cast<int>(cb);
+  }
+  int SendVectored(
+      rtc::ArrayView<const rtc::ArrayView<const uint8_t>> buffers) override {
+    size_t sent = 0;
+    for (rtc::ArrayView<const uint8_t> buffer : buffers)
+      sent += buffer.size();
+    bytes_sent_ += sent;
+    return static_cast<int>(sent);
+  }
+  int SendTo(const void* pv,
+             size_t cb,
+             const rtc::SocketAddress& addr) override {
+    return Send(pv, cb);
+  }
+  int Recv(void* pv, size_t cb, int64_t* timestamp) override {
+    size_t size = std::min({cb, recv_allowed_, kMaxRecvSize});
+    if (size == 0) {
+      error_ = EWOULDBLOCK;
+      return -1;
+    }
+    recv_allowed_ -= size;
+    uint8_t* out = static_cast<uint8_t*>(pv);
+    for (size_t copied = 0; copied < size;) {
+      const size_t n = std::min(size - copied, input_.size() - input_pos_);
+      memcpy(out + copied, input_.data() + input_pos_, n);
+      copied += n;
+      input_pos_ = (input_pos_ + n) % input_.size();
+    }
+    return static_cast<int>(size);
+  }
+  int RecvFrom(void* pv,
+               size_t cb,
+               rtc::SocketAddress* paddr,
+               int64_t* timestamp) override {
+    return Recv(pv, cb, timestamp);
+  }
+  int Listen(int backlog) override { return -1; }
+  rtc::AsyncSocket* Accept(rtc::SocketAddress* paddr) override {
+    return nullptr;
+  }
+  int Close() override { return 0; }
+  int GetError() const override { return error_; }
+  void SetError(int error) override { error_ = error; }
+  ConnState GetState() const override { return CS_CONNECTED; }
+  int GetOption(Option opt, int* value) override { return -1; }
+  int SetOption(Option opt, int value) override { return -1; }
+
+ private:
+  const std::vector<uint8_t> input_;
+  size_t input_pos_ = 0;
+  size_t recv_allowed_ = 0;
+  size_t bytes_sent_ = 0;
+  int error_ = 0;
+};
+
+class PacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t len,
+                    const rtc::SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) {
+    ++packets_;
+    bytes_ += len;
+  }
+
+  int packets() const { return packets_; }
+  size_t bytes() const { return bytes_; }
+
+ private:
+  int packets_ = 0;
+  size_t bytes_ = 0;
+};
+
+// TURN ChannelData message, which is what AsyncStunTCPSocket carries for
+// media, with |payload_size| bytes of payload.
+std::vector<uint8_t> CreateChannelDataMessage(size_t payload_size) {
+  std::vector<uint8_t> message(4 + payload_size, 0x55);
+  rtc::SetBE16(message.data(), 0x4000);
+  rtc::SetBE16(message.data() + 2, static_cast<uint16_t>(payload_size));
+  return message;
+}
+
+// |num_packets| copies of |framed_packet| back to back.
+std::vector<uint8_t> CreateStream(const std::vector<uint8_t>& framed_packet,
+                                  int num_packets) {
+  std::vector<uint8_t> stream;
+  for (int i = 0; i < num_packets; ++i)
+    stream.insert(stream.end(), framed_packet.begin(), framed_packet.end());
+  return stream;
+}
+
+void ReportThroughput(const std::string& measurement,
+                      const std::string& user_story,
+                      size_t bytes,
+                      int64_t elapsed_us) {
+  webrtc::test::PrintResult(measurement, "", user_story,
+                            bytes * 8.0 * rtc::kNumMicrosecsPerSec /
+                                std::max<int64_t>(elapsed_us, 1),
+                            "bps", /*important=*/false,
+                            ImproveDirection::kBiggerIsBetter);
+}
+
+void MeasureSend(rtc::AsyncTCPSocketBase* socket,
+                 FakeStreamSocket* fake_socket,
+                 const std::vector<uint8_t>& packet,
+                 const std::string& measurement,
+                 const std::string& user_story) {
+  const int iterations = Iterations(1000000);
+  rtc::PacketOptions options;
+  const int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < iterations; ++i) {
+    socket->Send(packet.data(), packet.size(), options);
+  }
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  ASSERT_GE(fake_socket->bytes_sent(), packet.size() * iterations);
+  ReportThroughput(measurement, user_story, packet.size() * iterations,
+                   elapsed_us);
+}
+
+void MeasureRecv(rtc::AsyncTCPSocketBase* socket,
+                 FakeStreamSocket* fake_socket,
+                 size_t framed_packet_size,
+                 const std::string& measurement,
+                 const std::string& user_story) {
+  PacketCounter counter;
+  socket->SignalReadPacket.connect(&counter, &PacketCounter::OnReadPacket);
+  const int iterations = Iterations(1000000);
+  // Hand out the stream in chunks that do not line up with the packets, so
+  // that partial packets are carried over between reads.
+  const size_t chunk_size = 16 * 1024 + 7;
+  size_t remaining = framed_packet_size * iterations;
+  const int64_t start_us = rtc::TimeMicros();
+  while (remaining > 0) {
+    const size_t size = std::min(chunk_size, remaining);
+    fake_socket->AllowRecv(size);
+    remaining -= size;
+    fake_socket->SignalReadEvent(fake_socket);
+  }
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  ASSERT_EQ(iterations, counter.packets());
+  ReportThroughput(measurement, user_story, counter.bytes(), elapsed_us);
+}
+
+}  // namespace
+
+TEST(AsyncTcpSocketPerformanceTest, AsyncTCPSocketSend) {
+  for (size_t packet_size : kPacketSizes) {
+    FakeStreamSocket* fake_socket = new FakeStreamSocket({0});
+    rtc::AsyncTCPSocket socket(fake_socket, /*listen=*/false);
+    MeasureSend(&socket, fake_socket, std::vector<uint8_t>(packet_size, 0x55),
+                "async_tcp_socket_send", std::to_string(packet_size) + "B");
+  }
+}
+
+TEST(AsyncTcpSocketPerformanceTest, AsyncTCPSocketRecv) {
+  for (size_t packet_size : kPacketSizes) {
+    std::vector<uint8_t> framed_packet(2 + packet_size, 0x55);
+    rtc::SetBE16(framed_packet.data(), static_cast<uint16_t>(packet_size));
+    // The stream repeats, so it must hold a whole number of packets.
+    FakeStreamSocket* fake_socket =
+        new FakeStreamSocket(CreateStream(framed_packet, 100));
+    rtc::AsyncTCPSocket socket(fake_socket, /*listen=*/false);
+    MeasureRecv(&socket, fake_socket, framed_packet.size(),
+                "async_tcp_socket_recv", std::to_string(packet_size) + "B");
+  }
+}
+
+TEST(AsyncTcpSocketPerformanceTest, AsyncStunTCPSocketSend) {
+  for (size_t packet_size : kPacketSizes) {
+    FakeStreamSocket* fake_socket = new FakeStreamSocket({0});
+    AsyncStunTCPSocket socket(fake_socket, /*listen=*/false);
+    // An odd payload size, so that the padding is exercised too.
+    MeasureSend(&socket, fake_socket, CreateChannelDataMessage(packet_size + 1),
+                "async_stun_tcp_socket_send",
+                std::to_string(packet_size) + "B");
+  }
+}
+
+TEST(AsyncTcpSocketPerformanceTest, AsyncStunTCPSocketRecv) {
+  for (size_t packet_size : kPacketSizes) {
+    std::vector<uint8_t> framed_packet =
+        CreateChannelDataMessage(packet_size + 1);
+    // Padding to a multiple of four bytes.
+    framed_packet.resize((framed_packet.size() + 3) / 4 * 4, 0);
+    FakeStreamSocket* fake_socket =
+        new FakeStreamSocket(CreateStream(framed_packet, 100));
+    AsyncStunTCPSocket socket(fake_socket, /*listen=*/false);
+    MeasureRecv(&socket, fake_socket, framed_packet.size(),
+                "async_stun_tcp_socket_recv",
+                std::to_string(packet_size) + "B");
+  }
+}
+
+}  // namespace cricket
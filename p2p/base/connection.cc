@@ -21,6 +21,7 @@
 #include "absl/strings/match.h"
 #include "p2p/base/port_allocator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/crc32.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/logging.h"
@@ -449,6 +450,12 @@ void Connection::OnSendStunPacket(const void* data,
   }
 }
 
+void Connection::SetPacketReceiver(ConnectionPacketReceiver* receiver) {
+  RTC_DCHECK(!receiver || !packet_receiver_ || packet_receiver_ == receiver)
+      << "The connection already has a receiver";
+  packet_receiver_ = receiver;
+}
+
 void Connection::OnReadPacket(const char* data,
                               size_t size,
                               int64_t packet_time_us) {
@@ -461,6 +468,8 @@ void Connection::OnReadPacket(const char* data,
     last_data_received_ = rtc::TimeMillis();
     UpdateReceiving(last_data_received_);
     recv_rate_tracker_.AddSamples(size);
+    if (packet_receiver_)
+      packet_receiver_->OnReadPacket(this, data, size, packet_time_us);
     SignalReadPacket(this, data, size, packet_time_us);
 
     // If timed out sending writability checks, start up again
@@ -473,6 +482,7 @@ void Connection::OnReadPacket(const char* data,
   } else if (!msg) {
     // The packet was STUN, but failed a check and was handled internally.
   } else {
+    rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kIce);
     // The packet is STUN and passed the Port checks.
     // Perform our own checks to ensure this packet is valid.
     // If this is a STUN request, then update the receiving bit and respond.
@@ -1381,6 +1391,14 @@ int ProxyConnection::Send(const void* data,
   return sent;
 }
 
+void Connection::StartSendBatch() {
+  port_->StartSendBatch();
+}
+
+void Connection::FlushSendBatch() {
+  port_->FlushSendBatch();
+}
+
 int ProxyConnection::GetError() {
   return error_;
 }
@@ -43,6 +43,19 @@ class Port;
 // Forward declaration so that a ConnectionRequest can contain a Connection.
 class Connection;
 
+// Receives the data packets of a Connection with a direct call, for the
+// packet data path, rather than through SignalReadPacket.
+class ConnectionPacketReceiver {
+ public:
+  virtual void OnReadPacket(Connection* connection,
+                            const char* data,
+                            size_t len,
+                            int64_t packet_time_us) = 0;
+
+ protected:
+  virtual ~ConnectionPacketReceiver() = default;
+};
+
 struct CandidatePair final : public CandidatePairInterface {
   ~CandidatePair() override = default;
 
@@ -158,6 +171,16 @@ class Connection : public CandidatePairInterface,
   // Error if Send() returns < 0
   virtual int GetError() = 0;
 
+  // Batches the packets sent on this connection until FlushSendBatch() is
+  // called, if the underlying port supports it.
+  void StartSendBatch();
+  void FlushSendBatch();
+
+  // Sets the receiver of the data packets, which gets them before
+  // SignalReadPacket. A connection has at most one receiver; null unsets it.
+  // The receiver must unset itself before it is destroyed.
+  void SetPacketReceiver(ConnectionPacketReceiver* receiver);
+
   sigslot::signal4<Connection*, const char*, size_t, int64_t> SignalReadPacket;
 
   sigslot::signal1<Connection*> SignalReadyToSend;
@@ -459,6 +482,8 @@ class Connection : public CandidatePairInterface,
   const IceFieldTrials* field_trials_;
   rtc::EventBasedExponentialMovingAverage rtt_estimate_;
 
+  ConnectionPacketReceiver* packet_receiver_ = nullptr;
+
   friend class Port;
   friend class ConnectionRequest;
   friend class P2PTransportChannel;
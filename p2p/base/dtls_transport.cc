@@ -141,7 +141,10 @@ DtlsTransport::DtlsTransport(IceTransportInternal* ice_transport,
   ConnectToIceTransport();
 }
 
-DtlsTransport::~DtlsTransport() = default;
+DtlsTransport::~DtlsTransport() {
+  if (ice_transport_)
+    ice_transport_->SetPacketReceiver(nullptr);
+}
 
 const webrtc::CryptoOptions& DtlsTransport::crypto_options() const {
   return crypto_options_;
@@ -479,11 +482,19 @@ int DtlsTransport::SetOption(rtc::Socket::Option opt, int value) {
   return ice_transport_->SetOption(opt, value);
 }
 
+void DtlsTransport::StartSendBatch() {
+  ice_transport_->StartSendBatch();
+}
+
+void DtlsTransport::FlushSendBatch() {
+  ice_transport_->FlushSendBatch();
+}
+
 void DtlsTransport::ConnectToIceTransport() {
   RTC_DCHECK(ice_transport_);
   ice_transport_->SignalWritableState.connect(this,
                                               &DtlsTransport::OnWritableState);
-  ice_transport_->SignalReadPacket.connect(this, &DtlsTransport::OnReadPacket);
+  ice_transport_->SetPacketReceiver(this);
   ice_transport_->SignalSentPacket.connect(this, &DtlsTransport::OnSentPacket);
   ice_transport_->SignalReadyToSend.connect(this,
                                             &DtlsTransport::OnReadyToSend);
@@ -567,7 +578,7 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
 
   if (!dtls_active_) {
     // Not doing DTLS.
-    SignalReadPacket(this, data, size, packet_time_us, 0);
+    NotifyPacketReceived(data, size, packet_time_us, 0);
     return;
   }
 
@@ -630,7 +641,7 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
         RTC_DCHECK(!srtp_ciphers_.empty());
 
         // Signal this upwards as a bypass packet.
-        SignalReadPacket(this, data, size, packet_time_us, PF_SRTP_BYPASS);
+        NotifyPacketReceived(data, size, packet_time_us, PF_SRTP_BYPASS);
       }
       break;
     case DTLS_TRANSPORT_FAILED:
@@ -676,7 +687,7 @@ void DtlsTransport::OnDtlsEvent(rtc::StreamInterface* dtls, int sig, int err) {
     do {
       ret = dtls_->Read(buf, sizeof(buf), &read, &read_error);
       if (ret == rtc::SR_SUCCESS) {
-        SignalReadPacket(this, buf, read, rtc::TimeMicros(), 0);
+        NotifyPacketReceived(buf, read, rtc::TimeMicros(), 0);
       } else if (ret == rtc::SR_EOS) {
         // Remote peer shut down the association with no error.
         RTC_LOG(LS_INFO) << ToString() << ": DTLS transport closed by remote";
@@ -18,6 +18,7 @@
 #include "api/crypto/crypto_options.h"
 #include "p2p/base/dtls_transport_internal.h"
 #include "p2p/base/ice_transport_internal.h"
+#include "p2p/base/packet_transport_internal.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/buffer_queue.h"
 #include "rtc_base/constructor_magic.h"
@@ -89,7 +90,8 @@ class StreamInterfaceChannel : public rtc::StreamInterface {
 //
 // This class is not thread safe; all methods must be called on the same thread
 // as the constructor.
-class DtlsTransport : public DtlsTransportInternal {
+class DtlsTransport : public DtlsTransportInternal,
+                      public rtc::PacketTransportReceiver {
  public:
   // |ice_transport| is the ICE transport this DTLS transport is wrapping.  It
   // must outlive this DTLS transport.
@@ -140,6 +142,9 @@ class DtlsTransport : public DtlsTransportInternal {
 
   bool GetOption(rtc::Socket::Option opt, int* value) override;
 
+  void StartSendBatch() override;
+  void FlushSendBatch() override;
+
   bool SetSslMaxProtocolVersion(rtc::SSLProtocolVersion version) override;
 
   // Find out which TLS version was negotiated
@@ -198,11 +203,12 @@ class DtlsTransport : public DtlsTransportInternal {
   void ConnectToIceTransport();
 
   void OnWritableState(rtc::PacketTransportInternal* transport);
+  // rtc::PacketTransportReceiver implementation.
   void OnReadPacket(rtc::PacketTransportInternal* transport,
                     const char* data,
                     size_t size,
                     const int64_t& packet_time_us,
-                    int flags);
+                    int flags) override;
   void OnSentPacket(rtc::PacketTransportInternal* transport,
                     const rtc::SentPacket& sent_packet);
   void OnReadyToSend(rtc::PacketTransportInternal* transport);
@@ -0,0 +1,602 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/ice_lite_transport.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "p2p/base/p2p_constants.h"
+#include "p2p/base/port.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/crc32.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/net_helper.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/string_encode.h"
+#include "rtc_base/strings/string_builder.h"
+#include "rtc_base/time_utils.h"
+
+namespace cricket {
+
+namespace {
+
+enum { MSG_UPDATE_STATE = 1 };
+
+// How often the server updates the receiving and writable states of all its
+// transports. One timer for all of them is much cheaper than one each.
+const int kUpdateStateIntervalMs = 500;
+
+}  // namespace
+
+IceLiteServer::IceLiteServer(rtc::Thread* network_thread,
+                             std::unique_ptr<rtc::AsyncPacketSocket> socket)
+    : network_thread_(network_thread), socket_(std::move(socket)) {
+  RTC_DCHECK(socket_);
+  RTC_DCHECK(!socket_->GetLocalAddress().IsAnyIP());
+  socket_->SignalReadPacket.connect(this, &IceLiteServer::OnReadPacket);
+  socket_->SignalReadyToSend.connect(this, &IceLiteServer::OnReadyToSend);
+}
+
+IceLiteServer::~IceLiteServer() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK(transports_.empty());
+  network_thread_->Clear(this);
+}
+
+std::unique_ptr<IceLiteTransport> IceLiteServer::CreateTransport(
+    const std::string& transport_name,
+    int component) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  std::unique_ptr<IceLiteTransport> transport(
+      new IceLiteTransport(this, transport_name, component));
+  transports_.insert(transport.get());
+  if (!timer_posted_) {
+    network_thread_->PostDelayed(RTC_FROM_HERE, kUpdateStateIntervalMs, this,
+                                 MSG_UPDATE_STATE);
+    timer_posted_ = true;
+  }
+  return transport;
+}
+
+void IceLiteServer::OnMessage(rtc::Message* message) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK_EQ(MSG_UPDATE_STATE, message->message_id);
+  timer_posted_ = false;
+  // The state change signals may destroy transports.
+  std::vector<IceLiteTransport*> transports(transports_.begin(),
+                                            transports_.end());
+  for (IceLiteTransport* transport : transports) {
+    if (transports_.count(transport) > 0) {
+      transport->UpdateState();
+    }
+  }
+  if (!transports_.empty()) {
+    network_thread_->PostDelayed(RTC_FROM_HERE, kUpdateStateIntervalMs, this,
+                                 MSG_UPDATE_STATE);
+    timer_posted_ = true;
+  }
+}
+
+void IceLiteServer::RemoveTransport(IceLiteTransport* transport) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  transports_.erase(transport);
+  auto it = transports_by_ufrag_.find(transport->ice_parameters_.ufrag);
+  if (it != transports_by_ufrag_.end() && it->second == transport) {
+    transports_by_ufrag_.erase(it);
+  }
+  for (const rtc::SocketAddress& address : transport->remote_addresses_) {
+    auto addr_it = transports_by_remote_address_.find(address);
+    if (addr_it != transports_by_remote_address_.end() &&
+        addr_it->second == transport) {
+      transports_by_remote_address_.erase(addr_it);
+    }
+  }
+}
+
+bool IceLiteServer::SetUfrag(IceLiteTransport* transport,
+                             const std::string& old_ufrag,
+                             const std::string& ufrag) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!ufrag.empty() && transports_by_ufrag_.count(ufrag) > 0) {
+    return false;
+  }
+  if (!old_ufrag.empty()) {
+    transports_by_ufrag_.erase(old_ufrag);
+  }
+  if (!ufrag.empty()) {
+    transports_by_ufrag_[ufrag] = transport;
+  }
+  return true;
+}
+
+void IceLiteServer::AddRemoteAddress(IceLiteTransport* transport,
+                                     const rtc::SocketAddress& address) {
+  transports_by_remote_address_[address] = transport;
+}
+
+int IceLiteServer::SendTo(const void* data,
+                          size_t size,
+                          const rtc::SocketAddress& address,
+                          const rtc::PacketOptions& options) {
+  return socket_->SendTo(data, size, address, options);
+}
+
+void IceLiteServer::OnReadPacket(rtc::AsyncPacketSocket* socket,
+                                 const char* data,
+                                 size_t size,
+                                 const rtc::SocketAddress& remote_addr,
+                                 const int64_t& packet_time_us) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK_EQ(socket_.get(), socket);
+  StunMessageView stun_message;
+  if (stun_message.Parse(data, size)) {
+    // Nothing else, e.g. binding indications, needs an answer.
+    if (stun_message.type() == STUN_BINDING_REQUEST) {
+      OnBindingRequest(stun_message, remote_addr);
+    }
+    return;
+  }
+  auto it = transports_by_remote_address_.find(remote_addr);
+  if (it == transports_by_remote_address_.end()) {
+    RTC_LOG(LS_VERBOSE) << "IceLiteServer: dropping packet from unknown "
+                        << remote_addr.ToSensitiveString();
+    return;
+  }
+  it->second->OnReadPacket(data, size, packet_time_us);
+}
+
+void IceLiteServer::OnReadyToSend(rtc::AsyncPacketSocket* socket) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  std::vector<IceLiteTransport*> transports(transports_.begin(),
+                                            transports_.end());
+  for (IceLiteTransport* transport : transports) {
+    if (transports_.count(transport) > 0) {
+      transport->OnReadyToSend();
+    }
+  }
+}
+
+void IceLiteServer::OnBindingRequest(const StunMessageView& request,
+                                     const rtc::SocketAddress& remote_addr) {
+  // The USERNAME is "<local ufrag>:<remote ufrag>".
+  absl::string_view username;
+  if (!request.GetAttribute(STUN_ATTR_USERNAME, &username)) {
+    return;
+  }
+  const absl::string_view local_ufrag = username.substr(0, username.find(':'));
+  auto it = transports_by_ufrag_.find(std::string(local_ufrag));
+  if (it == transports_by_ufrag_.end()) {
+    RTC_LOG(LS_VERBOSE) << "IceLiteServer: dropping check for unknown ufrag "
+                        << std::string(local_ufrag);
+    return;
+  }
+  IceLiteTransport* transport = it->second;
+  const std::string& password = transport->ice_parameters_.pwd;
+  // Like checks for unknown ufrags, these are dropped rather than answered
+  // with an error response; the peer retransmits.
+  if (!request.ValidateFingerprint() ||
+      !request.ValidateMessageIntegrity(password)) {
+    RTC_LOG(LS_WARNING) << transport->ToString()
+                        << ": Dropping check with bad integrity from "
+                        << remote_addr.ToSensitiveString();
+    return;
+  }
+  SendBindingResponse(request, remote_addr, password);
+
+  uint32_t priority = 0;
+  request.GetUInt32(STUN_ATTR_PRIORITY, &priority);
+  transport->OnBindingRequest(
+      remote_addr, priority,
+      request.GetAttribute(STUN_ATTR_USE_CANDIDATE, nullptr));
+}
+
+void IceLiteServer::SendBindingResponse(const StunMessageView& request,
+                                        const rtc::SocketAddress& remote_addr,
+                                        const std::string& password) {
+  StunMessage response;
+  response.SetType(STUN_BINDING_RESPONSE);
+  response.SetTransactionID(std::string(request.transaction_id()));
+  uint32_t retransmit_count;
+  if (request.GetUInt32(STUN_ATTR_RETRANSMIT_COUNT, &retransmit_count)) {
+    // Lets the peer see which of its checks were lost.
+    response.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_RETRANSMIT_COUNT, retransmit_count));
+  }
+  response.AddAttribute(std::make_unique<StunXorAddressAttribute>(
+      STUN_ATTR_XOR_MAPPED_ADDRESS, remote_addr));
+  response.AddMessageIntegrity(password);
+  response.AddFingerprint();
+
+  rtc::ByteBufferWriter buf;
+  response.Write(&buf);
+  rtc::PacketOptions options;
+  options.info_signaled_after_sent.packet_type =
+      rtc::PacketType::kIceConnectivityCheckResponse;
+  if (socket_->SendTo(buf.Data(), buf.Length(), remote_addr, options) < 0) {
+    RTC_LOG(LS_WARNING) << "IceLiteServer: failed to answer a check from "
+                        << remote_addr.ToSensitiveString()
+                        << ", err=" << socket_->GetError();
+  }
+}
+
+IceLiteTransport::IceLiteTransport(IceLiteServer* server,
+                                   const std::string& transport_name,
+                                   int component)
+    : server_(server), transport_name_(transport_name), component_(component) {}
+
+IceLiteTransport::~IceLiteTransport() {
+  server_->RemoveTransport(this);
+}
+
+const std::string& IceLiteTransport::transport_name() const {
+  return transport_name_;
+}
+
+bool IceLiteTransport::writable() const {
+  return writable_;
+}
+
+bool IceLiteTransport::receiving() const {
+  return receiving_;
+}
+
+int IceLiteTransport::SendPacket(const char* data,
+                                 size_t len,
+                                 const rtc::PacketOptions& options,
+                                 int flags) {
+  if (flags != 0) {
+    error_ = EINVAL;
+    return -1;
+  }
+  if (!writable_) {
+    error_ = ENOTCONN;
+    return -1;
+  }
+  last_sent_packet_id_ = options.packet_id;
+  rtc::PacketOptions modified_options(options);
+  modified_options.info_signaled_after_sent.packet_type =
+      rtc::PacketType::kData;
+  int sent = server_->SendTo(data, len, selected_pair_->remote.address(),
+                             modified_options);
+  if (sent < 0) {
+    error_ = server_->socket_->GetError();
+    return sent;
+  }
+  sent_total_bytes_ += sent;
+  ++sent_total_packets_;
+  rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
+                              modified_options.info_signaled_after_sent);
+  rtc::CopySocketInformationToPacketInfo(len, *server_->socket_, true,
+                                         &sent_packet.info);
+  SignalSentPacket(this, sent_packet);
+  return sent;
+}
+
+int IceLiteTransport::SetOption(rtc::Socket::Option opt, int value) {
+  options_[opt] = value;
+  return 0;
+}
+
+bool IceLiteTransport::GetOption(rtc::Socket::Option opt, int* value) {
+  auto it = options_.find(opt);
+  if (it == options_.end()) {
+    return false;
+  }
+  *value = it->second;
+  return true;
+}
+
+int IceLiteTransport::GetError() {
+  return error_;
+}
+
+absl::optional<rtc::NetworkRoute> IceLiteTransport::network_route() const {
+  return network_route_;
+}
+
+IceTransportState IceLiteTransport::GetState() const {
+  return state_;
+}
+
+webrtc::IceTransportState IceLiteTransport::GetIceTransportState() const {
+  return standardized_state_;
+}
+
+int IceLiteTransport::component() const {
+  return component_;
+}
+
+IceRole IceLiteTransport::GetIceRole() const {
+  return role_;
+}
+
+void IceLiteTransport::SetIceRole(IceRole role) {
+  if (role == ICEROLE_CONTROLLING) {
+    RTC_LOG(LS_WARNING) << ToString()
+                        << ": An ICE-lite agent never nominates, ignoring "
+                           "the controlling role.";
+    return;
+  }
+  role_ = role;
+}
+
+void IceLiteTransport::SetIceTiebreaker(uint64_t tiebreaker) {}
+
+void IceLiteTransport::SetIceParameters(const IceParameters& ice_params) {
+  if (ice_params.ufrag != ice_parameters_.ufrag &&
+      !server_->SetUfrag(this, ice_parameters_.ufrag, ice_params.ufrag)) {
+    RTC_LOG(LS_ERROR) << ToString() << ": ufrag " << ice_params.ufrag
+                      << " is in use by another transport.";
+    return;
+  }
+  ice_parameters_ = ice_params;
+}
+
+void IceLiteTransport::SetRemoteIceParameters(const IceParameters& ice_params) {
+  remote_ice_parameters_ = ice_params;
+}
+
+void IceLiteTransport::SetRemoteIceMode(IceMode mode) {
+  if (mode == ICEMODE_LITE) {
+    RTC_LOG(LS_WARNING) << ToString()
+                        << ": Neither side will send checks, since the "
+                           "remote agent is ICE-lite too.";
+  }
+}
+
+void IceLiteTransport::SetIceConfig(const IceConfig& config) {
+  config_ = config;
+}
+
+void IceLiteTransport::MaybeStartGathering() {
+  // Gathers again after an ICE restart, for the new credentials.
+  if (ice_parameters_.ufrag.empty() ||
+      ice_parameters_.ufrag == gathered_ufrag_) {
+    return;
+  }
+  gathered_ufrag_ = ice_parameters_.ufrag;
+  gathering_state_ = kIceGatheringGathering;
+  SignalGatheringState(this);
+
+  const rtc::SocketAddress address = server_->address();
+  local_candidate_ = Candidate(
+      component_, UDP_PROTOCOL_NAME, address, 0, ice_parameters_.ufrag,
+      ice_parameters_.pwd, LOCAL_PORT_TYPE, /*generation=*/0,
+      Port::ComputeFoundation(LOCAL_PORT_TYPE, UDP_PROTOCOL_NAME,
+                              std::string(), address));
+  local_candidate_.set_priority(
+      local_candidate_.GetPriority(ICE_TYPE_PREFERENCE_HOST, 0, 0));
+  SignalCandidateGathered(this, local_candidate_);
+
+  gathering_state_ = kIceGatheringComplete;
+  SignalGatheringState(this);
+}
+
+void IceLiteTransport::AddRemoteCandidate(const Candidate& candidate) {
+  // Only used to describe the selected pair; the checks come from the peer.
+  for (const Candidate& c : remote_candidates_) {
+    if (c.address() == candidate.address() &&
+        c.protocol() == candidate.protocol()) {
+      return;
+    }
+  }
+  remote_candidates_.push_back(candidate);
+}
+
+void IceLiteTransport::RemoveRemoteCandidate(const Candidate& candidate) {
+  remote_candidates_.erase(
+      std::remove_if(remote_candidates_.begin(), remote_candidates_.end(),
+                     [&candidate](const Candidate& c) {
+                       return c.address() == candidate.address() &&
+                              c.protocol() == candidate.protocol();
+                     }),
+      remote_candidates_.end());
+}
+
+void IceLiteTransport::RemoveAllRemoteCandidates() {
+  remote_candidates_.clear();
+}
+
+IceGatheringState IceLiteTransport::gathering_state() const {
+  return gathering_state_;
+}
+
+bool IceLiteTransport::GetStats(IceTransportStats* ice_transport_stats) {
+  ice_transport_stats->candidate_stats_list.clear();
+  ice_transport_stats->connection_infos.clear();
+  if (gathering_state_ == kIceGatheringComplete) {
+    ice_transport_stats->candidate_stats_list.push_back(
+        CandidateStats(local_candidate_));
+  }
+  if (selected_pair_) {
+    ConnectionInfo info;
+    info.best_connection = true;
+    info.writable = writable_;
+    info.receiving = receiving_;
+    info.timeout = !writable_;
+    info.sent_total_bytes = sent_total_bytes_;
+    info.sent_total_packets = sent_total_packets_;
+    info.recv_total_bytes = recv_total_bytes_;
+    info.recv_ping_requests = recv_ping_requests_;
+    info.sent_ping_responses = recv_ping_requests_;
+    info.local_candidate = selected_pair_->local;
+    info.remote_candidate = selected_pair_->remote;
+    info.key = this;
+    info.state = writable_ ? IceCandidatePairState::SUCCEEDED
+                           : IceCandidatePairState::FAILED;
+    info.nominated = true;
+    ice_transport_stats->connection_infos.push_back(info);
+  }
+  ice_transport_stats->selected_candidate_pair_changes =
+      selected_candidate_pair_changes_;
+  return true;
+}
+
+absl::optional<int> IceLiteTransport::GetRttEstimate() {
+  // Measuring the RTT would take checks of our own.
+  return absl::nullopt;
+}
+
+const Connection* IceLiteTransport::selected_connection() const {
+  return nullptr;
+}
+
+absl::optional<const CandidatePair> IceLiteTransport::GetSelectedCandidatePair()
+    const {
+  if (!selected_pair_) {
+    return absl::nullopt;
+  }
+  return *selected_pair_;
+}
+
+std::string IceLiteTransport::ToString() const {
+  rtc::StringBuilder ss;
+  ss << "IceLiteTransport[" << transport_name_ << "|" << component_ << "]";
+  return ss.Release();
+}
+
+void IceLiteTransport::OnBindingRequest(const rtc::SocketAddress& remote_addr,
+                                        uint32_t priority,
+                                        bool use_candidate) {
+  if (std::find(remote_addresses_.begin(), remote_addresses_.end(),
+                remote_addr) == remote_addresses_.end()) {
+    remote_addresses_.push_back(remote_addr);
+  }
+  server_->AddRemoteAddress(this, remote_addr);
+  ++recv_ping_requests_;
+  last_check_received_ms_ = rtc::TimeMillis();
+  last_data_received_ms_ = last_check_received_ms_;
+  if (use_candidate && (!selected_pair_ ||
+                        selected_pair_->remote.address() != remote_addr)) {
+    SelectRemoteAddress(remote_addr, priority);
+  }
+  UpdateState();
+}
+
+void IceLiteTransport::OnReadPacket(const char* data,
+                                    size_t size,
+                                    int64_t packet_time_us) {
+  recv_total_bytes_ += size;
+  last_data_received_ms_ = rtc::TimeMillis();
+  if (!receiving_) {
+    UpdateState();
+  }
+  NotifyPacketReceived(data, size, packet_time_us, 0);
+}
+
+void IceLiteTransport::OnReadyToSend() {
+  if (writable_) {
+    SignalReadyToSend(this);
+  }
+}
+
+void IceLiteTransport::SelectRemoteAddress(
+    const rtc::SocketAddress& remote_addr,
+    uint32_t priority) {
+  selected_pair_.emplace();
+  selected_pair_->local = local_candidate_;
+  selected_pair_->remote = CreateRemoteCandidate(remote_addr, priority);
+  ++selected_candidate_pair_changes_;
+  RTC_LOG(LS_INFO) << ToString() << ": Remote nominated "
+                   << remote_addr.ToSensitiveString();
+
+  network_route_.emplace(rtc::NetworkRoute());
+  network_route_->connected = true;
+  network_route_->local = rtc::RouteEndpoint(
+      local_candidate_.network_type(), 0, local_candidate_.network_id(),
+      /*uses_turn=*/false);
+  network_route_->remote = rtc::RouteEndpoint(
+      selected_pair_->remote.network_type(), 0,
+      selected_pair_->remote.network_id(),
+      /*uses_turn=*/selected_pair_->remote.type() == RELAY_PORT_TYPE);
+  network_route_->last_sent_packet_id = last_sent_packet_id_;
+  network_route_->packet_overhead =
+      remote_addr.ipaddr().overhead() + kUdpHeaderSize;
+  SignalNetworkRouteChanged(network_route_);
+
+  CandidatePairChangeEvent event;
+  event.selected_candidate_pair = *selected_pair_;
+  event.last_data_received_ms = last_data_received_ms_;
+  event.reason = "remote nomination";
+  SignalCandidatePairChanged(event);
+}
+
+Candidate IceLiteTransport::CreateRemoteCandidate(
+    const rtc::SocketAddress& remote_addr,
+    uint32_t priority) const {
+  for (const Candidate& c : remote_candidates_) {
+    if (c.address() == remote_addr && c.protocol() == UDP_PROTOCOL_NAME) {
+      return c;
+    }
+  }
+  // Not signaled (yet), so peer reflexive.
+  Candidate candidate(component_, UDP_PROTOCOL_NAME, remote_addr, priority,
+                      remote_ice_parameters_.ufrag, remote_ice_parameters_.pwd,
+                      PRFLX_PORT_TYPE, /*generation=*/0, std::string());
+  candidate.set_foundation(rtc::ToString(rtc::ComputeCrc32(candidate.id())));
+  return candidate;
+}
+
+void IceLiteTransport::UpdateState() {
+  const int64_t now = rtc::TimeMillis();
+  const bool receiving =
+      last_data_received_ms_ > 0 &&
+      now - last_data_received_ms_ < config_.receiving_timeout_or_default();
+  // The peer keeps checking the selected pair, for consent freshness.
+  const bool writable =
+      selected_pair_.has_value() &&
+      now - last_check_received_ms_ < config_.ice_inactive_timeout_or_default();
+
+  if (writable != writable_) {
+    writable_ = writable;
+    if (network_route_) {
+      network_route_->connected = writable_;
+      SignalNetworkRouteChanged(network_route_);
+    }
+    SignalWritableState(this);
+    if (writable_) {
+      SignalReadyToSend(this);
+    }
+  }
+  if (receiving != receiving_) {
+    receiving_ = receiving;
+    SignalReceivingState(this);
+  }
+
+  IceTransportState state;
+  webrtc::IceTransportState standardized_state;
+  if (!selected_pair_) {
+    state = last_check_received_ms_ > 0 ? IceTransportState::STATE_CONNECTING
+                                        : IceTransportState::STATE_INIT;
+    standardized_state = last_check_received_ms_ > 0
+                             ? webrtc::IceTransportState::kChecking
+                             : webrtc::IceTransportState::kNew;
+  } else if (!writable_) {
+    state = IceTransportState::STATE_FAILED;
+    standardized_state = webrtc::IceTransportState::kFailed;
+  } else {
+    state = IceTransportState::STATE_COMPLETED;
+    standardized_state = receiving_ ? webrtc::IceTransportState::kConnected
+                                    : webrtc::IceTransportState::kDisconnected;
+  }
+  if (state != state_) {
+    state_ = state;
+    SignalStateChanged(this);
+  }
+  if (standardized_state != standardized_state_) {
+    standardized_state_ = standardized_state;
+    SignalIceTransportStateChanged(this);
+  }
+}
+
+}  // namespace cricket
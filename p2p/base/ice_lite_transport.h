@@ -0,0 +1,214 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_ICE_LITE_TRANSPORT_H_
+#define P2P_BASE_ICE_LITE_TRANSPORT_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "api/candidate.h"
+#include "api/transport/stun.h"
+#include "p2p/base/ice_transport_internal.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/message_handler.h"
+#include "rtc_base/network_route.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+class IceLiteTransport;
+
+// Answers the ICE connectivity checks of many ICE-lite transports (RFC 8445,
+// section 2.5) on one UDP socket, for media servers with a public address
+// that terminate many sessions.
+//
+// Binding requests go to the transport whose ufrag is the local part of their
+// USERNAME, and are answered right away, without creating any per-pair state.
+// All other packets go to the transport that a check was last received for
+// from their source address.
+//
+// Must be used on |network_thread|, and outlive the transports it creates.
+class IceLiteServer : public rtc::MessageHandler,
+                      public sigslot::has_slots<> {
+ public:
+  // The transports announce the local address of |socket| as their host
+  // candidate, so it must not be a wildcard address.
+  IceLiteServer(rtc::Thread* network_thread,
+                std::unique_ptr<rtc::AsyncPacketSocket> socket);
+  ~IceLiteServer() override;
+
+  std::unique_ptr<IceLiteTransport> CreateTransport(
+      const std::string& transport_name,
+      int component);
+
+  rtc::SocketAddress address() const { return socket_->GetLocalAddress(); }
+  size_t num_transports() const { return transports_.size(); }
+
+  // rtc::MessageHandler implementation.
+  void OnMessage(rtc::Message* message) override;
+
+ private:
+  friend class IceLiteTransport;
+
+  void RemoveTransport(IceLiteTransport* transport);
+  // Makes |transport| receive the checks for |ufrag| instead of |old_ufrag|.
+  // Returns false if another transport already does.
+  bool SetUfrag(IceLiteTransport* transport,
+                const std::string& old_ufrag,
+                const std::string& ufrag);
+  void AddRemoteAddress(IceLiteTransport* transport,
+                        const rtc::SocketAddress& address);
+  int SendTo(const void* data,
+             size_t size,
+             const rtc::SocketAddress& address,
+             const rtc::PacketOptions& options);
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const int64_t& packet_time_us);
+  void OnReadyToSend(rtc::AsyncPacketSocket* socket);
+  void OnBindingRequest(const StunMessageView& request,
+                        const rtc::SocketAddress& remote_addr);
+  void SendBindingResponse(const StunMessageView& request,
+                           const rtc::SocketAddress& remote_addr,
+                           const std::string& password);
+
+  rtc::Thread* const network_thread_;
+  const std::unique_ptr<rtc::AsyncPacketSocket> socket_;
+  std::set<IceLiteTransport*> transports_;
+  std::map<std::string, IceLiteTransport*> transports_by_ufrag_;
+  std::map<rtc::SocketAddress, IceLiteTransport*>
+      transports_by_remote_address_;
+  // Whether the timer that updates the state of the transports is posted.
+  bool timer_posted_ = false;
+};
+
+// An IceTransportInternal for the ICE-lite side of a session. It never sends
+// connectivity checks, gathers no candidates but the host candidate of its
+// IceLiteServer, and selects the candidate pair that the controlling peer
+// nominates with USE-CANDIDATE. It is receiving while any packet arrives,
+// and writable while the peer's checks, which double as consent freshness
+// checks, keep arriving.
+//
+// There are no Connection objects, so selected_connection() is always null;
+// use GetSelectedCandidatePair() instead. Socket options set on the transport
+// are recorded but not applied, since the socket is shared.
+class IceLiteTransport : public IceTransportInternal {
+ public:
+  ~IceLiteTransport() override;
+
+  // rtc::PacketTransportInternal implementation.
+  const std::string& transport_name() const override;
+  bool writable() const override;
+  bool receiving() const override;
+  int SendPacket(const char* data,
+                 size_t len,
+                 const rtc::PacketOptions& options,
+                 int flags) override;
+  int SetOption(rtc::Socket::Option opt, int value) override;
+  bool GetOption(rtc::Socket::Option opt, int* value) override;
+  int GetError() override;
+  absl::optional<rtc::NetworkRoute> network_route() const override;
+
+  // IceTransportInternal implementation.
+  IceTransportState GetState() const override;
+  webrtc::IceTransportState GetIceTransportState() const override;
+  int component() const override;
+  IceRole GetIceRole() const override;
+  void SetIceRole(IceRole role) override;
+  void SetIceTiebreaker(uint64_t tiebreaker) override;
+  void SetIceParameters(const IceParameters& ice_params) override;
+  void SetRemoteIceParameters(const IceParameters& ice_params) override;
+  void SetRemoteIceMode(IceMode mode) override;
+  void SetIceConfig(const IceConfig& config) override;
+  void MaybeStartGathering() override;
+  void AddRemoteCandidate(const Candidate& candidate) override;
+  void RemoveRemoteCandidate(const Candidate& candidate) override;
+  void RemoveAllRemoteCandidates() override;
+  IceGatheringState gathering_state() const override;
+  bool GetStats(IceTransportStats* ice_transport_stats) override;
+  absl::optional<int> GetRttEstimate() override;
+  const Connection* selected_connection() const override;
+  absl::optional<const CandidatePair> GetSelectedCandidatePair()
+      const override;
+
+  std::string ToString() const;
+
+ private:
+  friend class IceLiteServer;
+
+  IceLiteTransport(IceLiteServer* server,
+                   const std::string& transport_name,
+                   int component);
+
+  // Called by the server for a check that passed the integrity check, after
+  // answering it.
+  void OnBindingRequest(const rtc::SocketAddress& remote_addr,
+                        uint32_t priority,
+                        bool use_candidate);
+  void OnReadPacket(const char* data, size_t size, int64_t packet_time_us);
+  void OnReadyToSend();
+
+  void SelectRemoteAddress(const rtc::SocketAddress& remote_addr,
+                           uint32_t priority);
+  Candidate CreateRemoteCandidate(const rtc::SocketAddress& remote_addr,
+                                  uint32_t priority) const;
+  // Updates the receiving, writable and transport states from the time of
+  // the last packet and check received, and signals the changes.
+  void UpdateState();
+
+  IceLiteServer* const server_;
+  const std::string transport_name_;
+  const int component_;
+  IceRole role_ = ICEROLE_CONTROLLED;
+  IceParameters ice_parameters_;
+  IceParameters remote_ice_parameters_;
+  IceConfig config_;
+  IceGatheringState gathering_state_ = kIceGatheringNew;
+  // The ufrag the host candidate was last gathered with.
+  std::string gathered_ufrag_;
+  Candidate local_candidate_;
+  std::vector<Candidate> remote_candidates_;
+  // Source addresses of the checks received, which the server delivers this
+  // transport's packets from.
+  std::vector<rtc::SocketAddress> remote_addresses_;
+  absl::optional<CandidatePair> selected_pair_;
+  absl::optional<rtc::NetworkRoute> network_route_;
+  std::map<rtc::Socket::Option, int> options_;
+  bool writable_ = false;
+  bool receiving_ = false;
+  IceTransportState state_ = IceTransportState::STATE_INIT;
+  webrtc::IceTransportState standardized_state_ =
+      webrtc::IceTransportState::kNew;
+  int error_ = 0;
+  int last_sent_packet_id_ = -1;
+  int64_t last_check_received_ms_ = 0;
+  int64_t last_data_received_ms_ = 0;
+  uint32_t selected_candidate_pair_changes_ = 0;
+  size_t recv_ping_requests_ = 0;
+  size_t sent_total_bytes_ = 0;
+  size_t sent_total_packets_ = 0;
+  size_t recv_total_bytes_ = 0;
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_ICE_LITE_TRANSPORT_H_
@@ -0,0 +1,42 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/ice_lite_transport_factory.h"
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/ref_counted_object.h"
+
+namespace webrtc {
+
+IceLiteIceTransport::IceLiteIceTransport(
+    std::unique_ptr<cricket::IceLiteTransport> internal)
+    : internal_(std::move(internal)) {}
+
+IceLiteIceTransport::~IceLiteIceTransport() {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+}
+
+IceLiteTransportFactory::IceLiteTransportFactory(
+    cricket::IceLiteServer* server)
+    : server_(server) {
+  RTC_DCHECK(server_);
+}
+
+rtc::scoped_refptr<IceTransportInterface>
+IceLiteTransportFactory::CreateIceTransport(const std::string& transport_name,
+                                            int component,
+                                            IceTransportInit init) {
+  return new rtc::RefCountedObject<IceLiteIceTransport>(
+      server_->CreateTransport(transport_name, component));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_ICE_LITE_TRANSPORT_FACTORY_H_
+#define P2P_BASE_ICE_LITE_TRANSPORT_FACTORY_H_
+
+#include <memory>
+#include <string>
+
+#include "api/ice_transport_interface.h"
+#include "p2p/base/ice_lite_transport.h"
+#include "rtc_base/thread_checker.h"
+
+namespace webrtc {
+
+// Wraps an IceLiteTransport. Like DefaultIceTransport, it must be
+// constructed, used and destroyed on the network thread.
+class IceLiteIceTransport : public IceTransportInterface {
+ public:
+  explicit IceLiteIceTransport(
+      std::unique_ptr<cricket::IceLiteTransport> internal);
+  ~IceLiteIceTransport();
+
+  cricket::IceTransportInternal* internal() override {
+    RTC_DCHECK_RUN_ON(&thread_checker_);
+    return internal_.get();
+  }
+
+ private:
+  const rtc::ThreadChecker thread_checker_{};
+  std::unique_ptr<cricket::IceLiteTransport> internal_
+      RTC_GUARDED_BY(thread_checker_);
+};
+
+// Creates ICE-lite transports that answer connectivity checks on the socket
+// of |server|, instead of full ICE agents, for media servers. The server must
+// outlive the transports. The port allocator, resolver factory and event log
+// of the IceTransportInit are not used.
+class IceLiteTransportFactory : public IceTransportFactory {
+ public:
+  explicit IceLiteTransportFactory(cricket::IceLiteServer* server);
+  ~IceLiteTransportFactory() override = default;
+
+  // Must be called on the network thread and returns an IceLiteIceTransport.
+  rtc::scoped_refptr<IceTransportInterface> CreateIceTransport(
+      const std::string& transport_name,
+      int component,
+      IceTransportInit init) override;
+
+ private:
+  cricket::IceLiteServer* const server_;
+};
+
+}  // namespace webrtc
+
+#endif  // P2P_BASE_ICE_LITE_TRANSPORT_FACTORY_H_
@@ -0,0 +1,262 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Per-session memory and CPU of IceLiteTransport against P2PTransportChannel,
+// for a server answering the checks of many full ICE peers.
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/stun.h"
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "p2p/base/fake_port_allocator.h"
+#include "p2p/base/ice_lite_transport.h"
+#include "p2p/base/p2p_transport_channel.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/memory_usage.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_base/virtual_socket_server.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace cricket {
+namespace {
+
+using webrtc::test::ImproveDirection;
+
+const char kPassword[] = "password_password_pw";
+const char kRemoteUfrag[] = "rfrag";
+const rtc::SocketAddress kServerAddr("11.11.11.11", 0);
+const rtc::SocketAddress kRemoteAddr("22.22.22.22", 0);
+const int kTimeoutMs = 10000;
+
+int NumSessions() {
+  return webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 10 : 1000;
+}
+
+int SteadyStateMs() {
+  return webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 100 : 2000;
+}
+
+std::string Ufrag(int session) {
+  return "ufrag" + std::to_string(session);
+}
+
+// The full ICE peers of all sessions, on one socket. Counts the binding
+// responses, and ignores the checks of full ICE sessions.
+class RemoteAgent : public sigslot::has_slots<> {
+ public:
+  explicit RemoteAgent(rtc::PacketSocketFactory* factory)
+      : socket_(factory->CreateUdpSocket(kRemoteAddr, 0, 0)) {
+    socket_->SignalReadPacket.connect(this, &RemoteAgent::OnReadPacket);
+  }
+
+  // A nominating check, as an aggressive nominator sends.
+  void SendCheck(const rtc::SocketAddress& addr, const std::string& ufrag) {
+    IceMessage request;
+    request.SetType(STUN_BINDING_REQUEST);
+    request.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+    request.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, ufrag + ":" + kRemoteUfrag));
+    request.AddAttribute(
+        std::make_unique<StunUInt32Attribute>(STUN_ATTR_PRIORITY, 1234));
+    request.AddAttribute(std::make_unique<StunUInt64Attribute>(
+        STUN_ATTR_ICE_CONTROLLING, 1));
+    request.AddAttribute(
+        std::make_unique<StunByteStringAttribute>(STUN_ATTR_USE_CANDIDATE));
+    request.AddMessageIntegrity(kPassword);
+    request.AddFingerprint();
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    socket_->SendTo(buf.Data(), buf.Length(), addr, rtc::PacketOptions());
+  }
+
+  int responses() const { return responses_; }
+
+ private:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) {
+    StunMessageView message;
+    if (message.Parse(data, size) &&
+        message.type() == STUN_BINDING_RESPONSE) {
+      ++responses_;
+    }
+  }
+
+  std::unique_ptr<rtc::AsyncPacketSocket> socket_;
+  int responses_ = 0;
+};
+
+// The server side of |num_sessions| sessions.
+class Sessions {
+ public:
+  virtual ~Sessions() = default;
+  // Creates the sessions and gathers their candidates.
+  virtual void Create(int num_sessions) = 0;
+  virtual rtc::SocketAddress address(int session) const = 0;
+};
+
+class IceLiteSessions : public Sessions {
+ public:
+  explicit IceLiteSessions(rtc::PacketSocketFactory* factory)
+      : server_(rtc::Thread::Current(),
+                std::unique_ptr<rtc::AsyncPacketSocket>(
+                    factory->CreateUdpSocket(kServerAddr, 0, 0))) {}
+
+  void Create(int num_sessions) override {
+    for (int i = 0; i < num_sessions; ++i) {
+      transports_.push_back(server_.CreateTransport(
+          "session" + std::to_string(i), ICE_CANDIDATE_COMPONENT_RTP));
+      transports_.back()->SetIceParameters(
+          IceParameters(Ufrag(i), kPassword, false));
+      transports_.back()->MaybeStartGathering();
+    }
+  }
+
+  rtc::SocketAddress address(int session) const override {
+    return server_.address();
+  }
+
+ private:
+  IceLiteServer server_;
+  std::vector<std::unique_ptr<IceLiteTransport>> transports_;
+};
+
+class FullIceSessions : public Sessions, public sigslot::has_slots<> {
+ public:
+  explicit FullIceSessions(rtc::PacketSocketFactory* factory)
+      : allocator_(rtc::Thread::Current(), factory) {}
+
+  void Create(int num_sessions) override {
+    addresses_.resize(num_sessions);
+    for (int i = 0; i < num_sessions; ++i) {
+      auto channel = std::make_unique<P2PTransportChannel>(
+          "session" + std::to_string(i), ICE_CANDIDATE_COMPONENT_RTP,
+          &allocator_);
+      channel->SetIceRole(ICEROLE_CONTROLLED);
+      channel->SetIceParameters(IceParameters(Ufrag(i), kPassword, false));
+      channel->SetRemoteIceParameters(
+          IceParameters(kRemoteUfrag, kPassword, false));
+      channel->SignalCandidateGathered.connect(
+          this, &FullIceSessions::OnCandidateGathered);
+      session_by_channel_[channel.get()] = i;
+      channel->MaybeStartGathering();
+      channels_.push_back(std::move(channel));
+    }
+    const int64_t deadline = rtc::TimeMillis() + kTimeoutMs;
+    while (num_gathered_ < num_sessions && rtc::TimeMillis() < deadline) {
+      rtc::Thread::Current()->ProcessMessages(1);
+    }
+    RTC_CHECK_EQ(num_sessions, num_gathered_);
+  }
+
+  rtc::SocketAddress address(int session) const override {
+    return addresses_[session];
+  }
+
+ private:
+  void OnCandidateGathered(IceTransportInternal* channel,
+                           const Candidate& candidate) {
+    addresses_[session_by_channel_[channel]] = candidate.address();
+    ++num_gathered_;
+  }
+
+  FakePortAllocator allocator_;
+  std::vector<std::unique_ptr<P2PTransportChannel>> channels_;
+  std::map<IceTransportInternal*, int> session_by_channel_;
+  std::vector<rtc::SocketAddress> addresses_;
+  int num_gathered_ = 0;
+};
+
+void ProcessMessagesFor(int ms) {
+  const int64_t end = rtc::TimeMillis() + ms;
+  for (int64_t now = rtc::TimeMillis(); now < end; now = rtc::TimeMillis()) {
+    rtc::Thread::Current()->ProcessMessages(static_cast<int>(end - now));
+  }
+}
+
+// Creates the sessions, sends one check to each, and reports the memory and
+// CPU time per session until all are answered, then the CPU time per session
+// while the peers are idle. The memory is the growth of the resident set, so
+// it is only approximate.
+void MeasureSessions(Sessions* sessions,
+                     RemoteAgent* remote,
+                     const std::string& user_story) {
+  const int num_sessions = NumSessions();
+  const int64_t start_rss_bytes = rtc::GetProcessResidentSizeBytes();
+  int64_t start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  sessions->Create(num_sessions);
+  for (int i = 0; i < num_sessions; ++i) {
+    remote->SendCheck(sessions->address(i), Ufrag(i));
+  }
+  const int64_t deadline = rtc::TimeMillis() + kTimeoutMs;
+  while (remote->responses() < num_sessions && rtc::TimeMillis() < deadline) {
+    rtc::Thread::Current()->ProcessMessages(1);
+  }
+  ASSERT_GE(remote->responses(), num_sessions);
+  const int64_t setup_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+  const int64_t rss_bytes =
+      rtc::GetProcessResidentSizeBytes() - start_rss_bytes;
+
+  webrtc::test::PrintResult(
+      "ice_session_setup_cpu", "", user_story,
+      static_cast<double>(setup_cpu_ns) / rtc::kNumNanosecsPerMicrosec /
+          num_sessions,
+      "us", /*important=*/false, ImproveDirection::kSmallerIsBetter);
+  webrtc::test::PrintResult(
+      "ice_session_memory", "", user_story,
+      static_cast<double>(rss_bytes) / num_sessions, "bytes",
+      /*important=*/false, ImproveDirection::kSmallerIsBetter);
+
+  start_cpu_ns = rtc::GetThreadCpuTimeNanos();
+  ProcessMessagesFor(SteadyStateMs());
+  const int64_t idle_cpu_ns = rtc::GetThreadCpuTimeNanos() - start_cpu_ns;
+  webrtc::test::PrintResult(
+      "ice_session_idle_cpu", "", user_story,
+      static_cast<double>(idle_cpu_ns) / rtc::kNumNanosecsPerMicrosec /
+          num_sessions * rtc::kNumMillisecsPerSec / SteadyStateMs(),
+      "us_per_second", /*important=*/false,
+      ImproveDirection::kSmallerIsBetter);
+}
+
+}  // namespace
+
+TEST(IceLiteTransportPerformanceTest, IceLite) {
+  rtc::VirtualSocketServer vss;
+  rtc::AutoSocketServerThread thread(&vss);
+  rtc::BasicPacketSocketFactory factory(rtc::Thread::Current());
+  RemoteAgent remote(&factory);
+  IceLiteSessions sessions(&factory);
+  MeasureSessions(&sessions, &remote, "ice_lite");
+}
+
+TEST(IceLiteTransportPerformanceTest, FullIce) {
+  rtc::VirtualSocketServer vss;
+  rtc::AutoSocketServerThread thread(&vss);
+  rtc::BasicPacketSocketFactory factory(rtc::Thread::Current());
+  RemoteAgent remote(&factory);
+  FullIceSessions sessions(&factory);
+  MeasureSessions(&sessions, &remote, "full_ice");
+}
+
+}  // namespace cricket
@@ -0,0 +1,281 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/ice_lite_transport.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/stun.h"
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/virtual_socket_server.h"
+
+namespace cricket {
+namespace {
+
+const rtc::SocketAddress kServerAddr("11.11.11.11", 0);
+const rtc::SocketAddress kRemoteAddr1("22.22.22.22", 0);
+const rtc::SocketAddress kRemoteAddr2("33.33.33.33", 0);
+const int kTimeoutMs = 1000;
+
+// A full ICE agent, as far as the server can tell.
+class RemoteAgent : public sigslot::has_slots<> {
+ public:
+  RemoteAgent(rtc::PacketSocketFactory* factory,
+              const rtc::SocketAddress& addr)
+      : socket_(factory->CreateUdpSocket(addr, 0, 0)) {
+    socket_->SignalReadPacket.connect(this, &RemoteAgent::OnReadPacket);
+  }
+
+  void SendCheck(const rtc::SocketAddress& server_addr,
+                 const std::string& ufrag,
+                 const std::string& pwd,
+                 bool use_candidate) {
+    IceMessage request;
+    request.SetType(STUN_BINDING_REQUEST);
+    request.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+    request.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, ufrag + ":rfrag"));
+    request.AddAttribute(
+        std::make_unique<StunUInt32Attribute>(STUN_ATTR_PRIORITY, 1234));
+    if (use_candidate) {
+      request.AddAttribute(
+          std::make_unique<StunByteStringAttribute>(STUN_ATTR_USE_CANDIDATE));
+    }
+    request.AddMessageIntegrity(pwd);
+    request.AddFingerprint();
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    socket_->SendTo(buf.Data(), buf.Length(), server_addr,
+                    rtc::PacketOptions());
+  }
+
+  void Send(const std::string& data, const rtc::SocketAddress& server_addr) {
+    socket_->SendTo(data.data(), data.size(), server_addr,
+                    rtc::PacketOptions());
+  }
+
+  rtc::SocketAddress address() const { return socket_->GetLocalAddress(); }
+  // Binding responses received, by their XOR-MAPPED-ADDRESS.
+  const std::vector<rtc::SocketAddress>& responses() const {
+    return responses_;
+  }
+  const std::vector<std::string>& packets() const { return packets_; }
+
+ private:
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const int64_t& /* packet_time_us */) {
+    rtc::ByteBufferReader buf(data, size);
+    StunMessage response;
+    if (response.Read(&buf)) {
+      ASSERT_EQ(STUN_BINDING_RESPONSE, response.type());
+      const StunAddressAttribute* addr =
+          response.GetAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+      ASSERT_TRUE(addr);
+      responses_.push_back(addr->GetAddress());
+    } else {
+      packets_.push_back(std::string(data, size));
+    }
+  }
+
+  std::unique_ptr<rtc::AsyncPacketSocket> socket_;
+  std::vector<rtc::SocketAddress> responses_;
+  std::vector<std::string> packets_;
+};
+
+class IceLiteTransportTest : public ::testing::Test,
+                             public sigslot::has_slots<> {
+ public:
+  IceLiteTransportTest()
+      : vss_(new rtc::VirtualSocketServer()),
+        thread_(vss_.get()),
+        socket_factory_(rtc::Thread::Current()),
+        server_(rtc::Thread::Current(),
+                std::unique_ptr<rtc::AsyncPacketSocket>(
+                    socket_factory_.CreateUdpSocket(kServerAddr, 0, 0))),
+        remote1_(&socket_factory_, kRemoteAddr1),
+        remote2_(&socket_factory_, kRemoteAddr2) {}
+
+  std::unique_ptr<IceLiteTransport> CreateTransport(
+      const std::string& ufrag,
+      const std::string& pwd,
+      const std::string& transport_name = "data") {
+    std::unique_ptr<IceLiteTransport> transport =
+        server_.CreateTransport(transport_name, ICE_CANDIDATE_COMPONENT_RTP);
+    transport->SetIceParameters(IceParameters(ufrag, pwd, false));
+    transport->SignalCandidateGathered.connect(
+        this, &IceLiteTransportTest::OnCandidateGathered);
+    transport->SignalReadPacket.connect(this,
+                                        &IceLiteTransportTest::OnReadPacket);
+    transport->MaybeStartGathering();
+    return transport;
+  }
+
+  void OnCandidateGathered(IceTransportInternal* transport,
+                           const Candidate& candidate) {
+    candidates_.push_back(candidate);
+  }
+
+  void OnReadPacket(rtc::PacketTransportInternal* transport,
+                    const char* data,
+                    size_t size,
+                    const int64_t& /* packet_time_us */,
+                    int flags) {
+    received_.push_back(std::string(data, size) + "@" +
+                        transport->transport_name());
+  }
+
+ protected:
+  rtc::ScopedFakeClock clock_;
+  std::unique_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::AutoSocketServerThread thread_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  IceLiteServer server_;
+  RemoteAgent remote1_;
+  RemoteAgent remote2_;
+  std::vector<Candidate> candidates_;
+  std::vector<std::string> received_;
+};
+
+TEST_F(IceLiteTransportTest, GathersTheServerAddressOncePerUfrag) {
+  std::unique_ptr<IceLiteTransport> transport =
+      CreateTransport("ufrag1", "password1_password1_");
+  ASSERT_EQ(1u, candidates_.size());
+  EXPECT_EQ(server_.address(), candidates_[0].address());
+  EXPECT_EQ(LOCAL_PORT_TYPE, candidates_[0].type());
+  EXPECT_EQ("ufrag1", candidates_[0].username());
+  EXPECT_EQ(kIceGatheringComplete, transport->gathering_state());
+
+  transport->MaybeStartGathering();
+  EXPECT_EQ(1u, candidates_.size());
+
+  // ICE restart.
+  transport->SetIceParameters(
+      IceParameters("ufrag2", "password2_password2_", false));
+  transport->MaybeStartGathering();
+  ASSERT_EQ(2u, candidates_.size());
+  EXPECT_EQ("ufrag2", candidates_[1].username());
+}
+
+TEST_F(IceLiteTransportTest, AnswersChecksAndSelectsTheNominatedPair) {
+  const std::string pwd = "password1_password1_";
+  std::unique_ptr<IceLiteTransport> transport = CreateTransport("ufrag1", pwd);
+
+  remote1_.SendCheck(server_.address(), "ufrag1", pwd, false);
+  EXPECT_EQ_SIMULATED_WAIT(1u, remote1_.responses().size(), kTimeoutMs,
+                           clock_);
+  EXPECT_EQ(remote1_.address(), remote1_.responses()[0]);
+  EXPECT_EQ(webrtc::IceTransportState::kChecking,
+            transport->GetIceTransportState());
+  EXPECT_FALSE(transport->writable());
+  EXPECT_FALSE(transport->GetSelectedCandidatePair());
+
+  remote1_.SendCheck(server_.address(), "ufrag1", pwd, true);
+  EXPECT_TRUE_SIMULATED_WAIT(transport->writable(), kTimeoutMs, clock_);
+  EXPECT_EQ(2u, remote1_.responses().size());
+  EXPECT_EQ(webrtc::IceTransportState::kConnected,
+            transport->GetIceTransportState());
+  EXPECT_EQ(IceTransportState::STATE_COMPLETED, transport->GetState());
+  ASSERT_TRUE(transport->GetSelectedCandidatePair());
+  EXPECT_EQ(remote1_.address(),
+            transport->GetSelectedCandidatePair()->remote.address());
+  EXPECT_EQ(PRFLX_PORT_TYPE,
+            transport->GetSelectedCandidatePair()->remote.type());
+  ASSERT_TRUE(transport->network_route());
+  EXPECT_TRUE(transport->network_route()->connected);
+
+  const std::string data = "media";
+  EXPECT_EQ(static_cast<int>(data.size()),
+            transport->SendPacket(data.data(), data.size(),
+                                  rtc::PacketOptions(), 0));
+  EXPECT_EQ_SIMULATED_WAIT(1u, remote1_.packets().size(), kTimeoutMs, clock_);
+  EXPECT_EQ(data, remote1_.packets()[0]);
+}
+
+TEST_F(IceLiteTransportTest, DropsChecksWithBadCredentials) {
+  std::unique_ptr<IceLiteTransport> transport =
+      CreateTransport("ufrag1", "password1_password1_");
+  remote1_.SendCheck(server_.address(), "ufrag1", "wrong_password_wrong", true);
+  remote1_.SendCheck(server_.address(), "unknown", "password1_password1_",
+                     true);
+  SIMULATED_WAIT(false, kTimeoutMs, clock_);
+  EXPECT_TRUE(remote1_.responses().empty());
+  EXPECT_EQ(webrtc::IceTransportState::kNew,
+            transport->GetIceTransportState());
+}
+
+TEST_F(IceLiteTransportTest, DemultiplexesSessionsOnTheSharedSocket) {
+  std::unique_ptr<IceLiteTransport> transport1 =
+      CreateTransport("ufrag1", "password1_password1_", "session1");
+  std::unique_ptr<IceLiteTransport> transport2 =
+      CreateTransport("ufrag2", "password2_password2_", "session2");
+
+  // Not delivered before a check from the address.
+  remote1_.Send("a", server_.address());
+  remote1_.SendCheck(server_.address(), "ufrag1", "password1_password1_",
+                     true);
+  remote2_.SendCheck(server_.address(), "ufrag2", "password2_password2_",
+                     true);
+  EXPECT_TRUE_SIMULATED_WAIT(transport1->writable() && transport2->writable(),
+                             kTimeoutMs, clock_);
+  remote2_.Send("b", server_.address());
+  remote1_.Send("c", server_.address());
+  EXPECT_EQ_SIMULATED_WAIT(2u, received_.size(), kTimeoutMs, clock_);
+  EXPECT_EQ((std::vector<std::string>{"b@session2", "c@session1"}),
+            received_);
+
+  // Deleted transports receive nothing.
+  transport2.reset();
+  remote2_.Send("d", server_.address());
+  SIMULATED_WAIT(false, kTimeoutMs, clock_);
+  EXPECT_EQ(2u, received_.size());
+  EXPECT_EQ(1u, server_.num_transports());
+}
+
+TEST_F(IceLiteTransportTest, LosesConsentWhenChecksStop) {
+  const std::string pwd = "password1_password1_";
+  std::unique_ptr<IceLiteTransport> transport = CreateTransport("ufrag1", pwd);
+  IceConfig config;
+  config.receiving_timeout = 2000;
+  config.ice_inactive_timeout = 5000;
+  transport->SetIceConfig(config);
+  remote1_.SendCheck(server_.address(), "ufrag1", pwd, true);
+  EXPECT_TRUE_SIMULATED_WAIT(transport->writable(), kTimeoutMs, clock_);
+
+  EXPECT_TRUE_SIMULATED_WAIT(!transport->receiving(), 3000, clock_);
+  EXPECT_TRUE(transport->writable());
+  EXPECT_EQ(webrtc::IceTransportState::kDisconnected,
+            transport->GetIceTransportState());
+
+  EXPECT_TRUE_SIMULATED_WAIT(!transport->writable(), 4000, clock_);
+  EXPECT_EQ(webrtc::IceTransportState::kFailed,
+            transport->GetIceTransportState());
+  const std::string data = "media";
+  EXPECT_LT(transport->SendPacket(data.data(), data.size(),
+                                  rtc::PacketOptions(), 0),
+            0);
+
+  // The peer checks again.
+  remote1_.SendCheck(server_.address(), "ufrag1", pwd, false);
+  EXPECT_TRUE_SIMULATED_WAIT(transport->writable(), kTimeoutMs, clock_);
+  EXPECT_EQ(webrtc::IceTransportState::kConnected,
+            transport->GetIceTransportState());
+}
+
+}  // namespace
+}  // namespace cricket
@@ -10,6 +10,7 @@
 
 #include "p2p/base/p2p_transport_channel.h"
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 #include <set>
@@ -24,6 +25,7 @@
 #include "p2p/base/connection.h"
 #include "p2p/base/port.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/crc32.h"
 #include "rtc_base/experiments/struct_parameters_parser.h"
 #include "rtc_base/logging.h"
@@ -194,6 +196,8 @@ P2PTransportChannel::P2PTransportChannel(
 P2PTransportChannel::~P2PTransportChannel() {
   std::vector<Connection*> copy(connections().begin(), connections().end());
   for (Connection* con : copy) {
+    // The connection is deleted later, and may receive packets until then.
+    con->SetPacketReceiver(nullptr);
     con->Destroy();
   }
   for (auto& p : resolvers_) {
@@ -201,6 +205,9 @@ P2PTransportChannel::~P2PTransportChannel() {
   }
   resolvers_.clear();
   RTC_DCHECK_RUN_ON(network_thread_);
+  if (ping_scheduler_) {
+    ping_scheduler_->RemoveClient(this);
+  }
 }
 
 // Add the allocator session to our list so that we know which sessions
@@ -239,8 +246,7 @@ void P2PTransportChannel::AddConnection(Connection* connection) {
   connection->set_unwritable_timeout(config_.ice_unwritable_timeout);
   connection->set_unwritable_min_checks(config_.ice_unwritable_min_checks);
   connection->set_inactive_timeout(config_.ice_inactive_timeout);
-  connection->SignalReadPacket.connect(this,
-                                       &P2PTransportChannel::OnReadPacket);
+  connection->SetPacketReceiver(this);
   connection->SignalReadyToSend.connect(this,
                                         &P2PTransportChannel::OnReadyToSend);
   connection->SignalStateChange.connect(
@@ -1447,16 +1453,19 @@ void P2PTransportChannel::RememberRemoteCandidate(
   RTC_DCHECK_RUN_ON(network_thread_);
   // Remove any candidates whose generation is older than this one.  The
   // presence of a new generation indicates that the old ones are not useful.
-  size_t i = 0;
-  while (i < remote_candidates_.size()) {
-    if (remote_candidates_[i].generation() < remote_candidate.generation()) {
-      RTC_LOG(INFO) << "Pruning candidate from old generation: "
-                    << remote_candidates_[i].address().ToSensitiveString();
-      remote_candidates_.erase(remote_candidates_.begin() + i);
-    } else {
-      i += 1;
-    }
-  }
+  remote_candidates_.erase(
+      std::remove_if(remote_candidates_.begin(), remote_candidates_.end(),
+                     [&remote_candidate](const RemoteCandidate& candidate) {
+                       if (candidate.generation() >=
+                           remote_candidate.generation()) {
+                         return false;
+                       }
+                       RTC_LOG(INFO)
+                           << "Pruning candidate from old generation: "
+                           << candidate.address().ToSensitiveString();
+                       return true;
+                     }),
+      remote_candidates_.end());
 
   // Make sure this candidate is not a duplicate.
   if (IsDuplicateRemoteCandidate(remote_candidate)) {
@@ -1539,6 +1548,26 @@ int P2PTransportChannel::SendPacket(const char* data,
   return sent;
 }
 
+void P2PTransportChannel::SetPingScheduler(StunPingScheduler* scheduler) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK(!started_pinging_);
+  ping_scheduler_ = scheduler;
+}
+
+void P2PTransportChannel::StartSendBatch() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  send_batch_active_ = true;
+  if (selected_connection_)
+    selected_connection_->StartSendBatch();
+}
+
+void P2PTransportChannel::FlushSendBatch() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  send_batch_active_ = false;
+  if (selected_connection_)
+    selected_connection_->FlushSendBatch();
+}
+
 bool P2PTransportChannel::GetStats(IceTransportStats* ice_transport_stats) {
   RTC_DCHECK_RUN_ON(network_thread_);
   // Gather candidate and candidate pair stats.
@@ -1621,9 +1650,13 @@ void P2PTransportChannel::MaybeStartPinging() {
     RTC_LOG(LS_INFO) << ToString()
                      << ": Have a pingable connection for the first time; "
                         "starting to ping.";
-    invoker_.AsyncInvoke<void>(
-        RTC_FROM_HERE, thread(),
-        rtc::Bind(&P2PTransportChannel::CheckAndPing, this));
+    if (ping_scheduler_) {
+      ping_scheduler_->Schedule(this, 0);
+    } else {
+      invoker_.AsyncInvoke<void>(
+          RTC_FROM_HERE, thread(),
+          rtc::Bind(&P2PTransportChannel::CheckAndPing, this));
+    }
     regathering_controller_->Start();
     started_pinging_ = true;
   }
@@ -1720,6 +1753,13 @@ void P2PTransportChannel::SwitchSelectedConnection(Connection* conn,
   // Note: if conn is NULL, the previous |selected_connection_| has been
   // destroyed, so don't use it.
   Connection* old_selected_connection = selected_connection_;
+  if (send_batch_active_) {
+    // Don't leave packets queued on a connection that is no longer used.
+    if (conn && old_selected_connection)
+      old_selected_connection->FlushSendBatch();
+    if (conn)
+      conn->StartSendBatch();
+  }
   selected_connection_ = conn;
   LogCandidatePairConfig(conn, webrtc::IceCandidatePairConfigType::kSelected);
   network_route_.reset();
@@ -1906,6 +1946,15 @@ bool P2PTransportChannel::ReadyToSend(Connection* connection) const {
 
 // Handle queued up check-and-ping request
 void P2PTransportChannel::CheckAndPing() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kIce);
+  int delay = PingNextConnection(nullptr);
+  invoker_.AsyncInvokeDelayed<void>(
+      RTC_FROM_HERE, thread(),
+      rtc::Bind(&P2PTransportChannel::CheckAndPing, this), delay);
+}
+
+int P2PTransportChannel::PingNextConnection(StunPingScheduler* scheduler) {
   RTC_DCHECK_RUN_ON(network_thread_);
   // Make sure the states of the connections are up-to-date (since this affects
   // which ones are pingable).
@@ -1914,16 +1963,20 @@ void P2PTransportChannel::CheckAndPing() {
   auto result = ice_controller_->SelectConnectionToPing(last_ping_sent_ms_);
   Connection* conn =
       const_cast<Connection*>(result.connection.value_or(nullptr));
-  int delay = result.recheck_delay_ms;
 
   if (conn) {
+    if (scheduler) {
+      scheduler->AddToSendBatch(conn->port());
+    }
     PingConnection(conn);
     MarkConnectionPinged(conn);
   }
+  return result.recheck_delay_ms;
+}
 
-  invoker_.AsyncInvokeDelayed<void>(
-      RTC_FROM_HERE, thread(),
-      rtc::Bind(&P2PTransportChannel::CheckAndPing, this), delay);
+int P2PTransportChannel::OnPingDue(StunPingScheduler* scheduler) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  return PingNextConnection(scheduler);
 }
 
 // This method is only for unit testing.
@@ -2103,7 +2156,7 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
 
   if (connection == selected_connection_) {
     // Let the client know of an incoming packet
-    SignalReadPacket(this, data, len, packet_time_us, 0);
+    NotifyPacketReceived(data, len, packet_time_us, 0);
     return;
   }
 
@@ -2112,7 +2165,7 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
     return;
 
   // Let the client know of an incoming packet
-  SignalReadPacket(this, data, len, packet_time_us, 0);
+  NotifyPacketReceived(data, len, packet_time_us, 0);
 
   // May need to switch the sending connection based on the receiving media path
   // if this is the controlled side.
@@ -33,6 +33,7 @@
 #include "logging/rtc_event_log/events/rtc_event_ice_candidate_pair_config.h"
 #include "logging/rtc_event_log/ice_logger.h"
 #include "p2p/base/candidate_pair_interface.h"
+#include "p2p/base/connection.h"
 #include "p2p/base/ice_controller_factory_interface.h"
 #include "p2p/base/ice_controller_interface.h"
 #include "p2p/base/ice_transport_internal.h"
@@ -41,6 +42,7 @@
 #include "p2p/base/port_allocator.h"
 #include "p2p/base/port_interface.h"
 #include "p2p/base/regathering_controller.h"
+#include "p2p/base/stun_ping_scheduler.h"
 #include "rtc_base/async_invoker.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/constructor_magic.h"
@@ -80,7 +82,9 @@ class RemoteCandidate : public Candidate {
 
 // P2PTransportChannel manages the candidates and connection process to keep
 // two P2P clients connected to each other.
-class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
+class RTC_EXPORT P2PTransportChannel : public IceTransportInternal,
+                                       public ConnectionPacketReceiver,
+                                       public StunPingScheduler::Client {
  public:
   // For testing only.
   // TODO(zstein): Remove once AsyncResolverFactory is required.
@@ -133,6 +137,8 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
                  size_t len,
                  const rtc::PacketOptions& options,
                  int flags) override;
+  void StartSendBatch() override;
+  void FlushSendBatch() override;
   int SetOption(rtc::Socket::Option opt, int value) override;
   bool GetOption(rtc::Socket::Option opt, int* value) override;
   int GetError() override;
@@ -153,6 +159,11 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
     incoming_only_ = value;
   }
 
+  // Lets |scheduler|, which may be shared with other channels on the network
+  // thread, time the connectivity checks instead of a timer of this channel.
+  // Must be called before pinging starts.
+  void SetPingScheduler(StunPingScheduler* scheduler);
+
   // Note: These are only for testing purpose.
   // |ports_| and |pruned_ports| should not be changed from outside.
   const std::vector<PortInterface*>& ports() {
@@ -282,10 +293,11 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
   void OnRoleConflict(PortInterface* port);
 
   void OnConnectionStateChange(Connection* connection);
+  // ConnectionPacketReceiver implementation.
   void OnReadPacket(Connection* connection,
                     const char* data,
                     size_t len,
-                    int64_t packet_time_us);
+                    int64_t packet_time_us) override;
   void OnSentPacket(const rtc::SentPacket& sent_packet);
   void OnReadyToSend(Connection* connection);
   void OnConnectionDestroyed(Connection* connection);
@@ -293,6 +305,12 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
   void OnNominated(Connection* conn);
 
   void CheckAndPing();
+  // Pings the next connection to ping, if any, and returns the delay in
+  // milliseconds until the next one should be considered. A send batch is
+  // started on its port with |scheduler|, if not null.
+  int PingNextConnection(StunPingScheduler* scheduler);
+  // From StunPingScheduler::Client.
+  int OnPingDue(StunPingScheduler* scheduler) override;
 
   void LogCandidatePairConfig(Connection* conn,
                               webrtc::IceCandidatePairConfigType type);
@@ -368,6 +386,8 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
   std::vector<PortInterface*> pruned_ports_ RTC_GUARDED_BY(network_thread_);
 
   Connection* selected_connection_ RTC_GUARDED_BY(network_thread_) = nullptr;
+  // True between StartSendBatch() and FlushSendBatch().
+  bool send_batch_active_ RTC_GUARDED_BY(network_thread_) = false;
 
   std::vector<RemoteCandidate> remote_candidates_
       RTC_GUARDED_BY(network_thread_);
@@ -398,6 +418,8 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal {
   int last_sent_packet_id_ RTC_GUARDED_BY(network_thread_) =
       -1;  // -1 indicates no packet was sent before.
   bool started_pinging_ RTC_GUARDED_BY(network_thread_) = false;
+  StunPingScheduler* ping_scheduler_ RTC_GUARDED_BY(network_thread_) =
+      nullptr;
   // The value put in the "nomination" attribute for the next nominated
   // connection. A zero-value indicates the connection will not be nominated.
   uint32_t nomination_ RTC_GUARDED_BY(network_thread_) = 0;
@@ -5717,6 +5717,66 @@ TEST_F(P2PTransportChannelPingTest, TestInitialSelectDampeningBoth) {
   EXPECT_EQ_SIMULATED_WAIT(conn1, ch.selected_connection(), 2 * kMargin, clock);
 }
 
+// Tests that channels sharing a StunPingScheduler are pinged by it.
+TEST_F(P2PTransportChannelPingTest, PingsWithSharedPingScheduler) {
+  rtc::ScopedFakeClock clock;
+  StunPingScheduler scheduler(rtc::Thread::Current(),
+                              StunPingScheduler::Config());
+  FakePortAllocator pa1(rtc::Thread::Current(), nullptr);
+  FakePortAllocator pa2(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch1("ping scheduler 1", 1, &pa1);
+  P2PTransportChannel ch2("ping scheduler 2", 1, &pa2);
+  PrepareChannel(&ch1);
+  PrepareChannel(&ch2);
+  ch1.SetPingScheduler(&scheduler);
+  ch2.SetPingScheduler(&scheduler);
+  ch1.MaybeStartGathering();
+  ch2.MaybeStartGathering();
+  ch1.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", 1, 1));
+  ch2.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "2.2.2.2", 2, 1));
+  Connection* conn1 = WaitForConnectionTo(&ch1, "1.1.1.1", 1, &clock);
+  Connection* conn2 = WaitForConnectionTo(&ch2, "2.2.2.2", 2, &clock);
+  ASSERT_TRUE(conn1 != nullptr);
+  ASSERT_TRUE(conn2 != nullptr);
+
+  EXPECT_TRUE_SIMULATED_WAIT(
+      conn1->num_pings_sent() >= 2 && conn2->num_pings_sent() >= 2,
+      kDefaultTimeout, clock);
+  EXPECT_EQ(2u, scheduler.num_clients());
+}
+
+// Measures adding remote candidates to, and sorting, a channel with many
+// candidate pairs.
+TEST_F(P2PTransportChannelPingTest, DISABLED_BenchmarkManyCandidatePairs) {
+  constexpr int kNumCandidates = 1000;
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch("many pairs", 1, &pa);
+  PrepareChannel(&ch);
+  ch.MaybeStartGathering();
+  ch.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", 1, 0));
+  ASSERT_TRUE(WaitForConnectionTo(&ch, "1.1.1.1", 1) != nullptr);
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumCandidates; ++i) {
+    ch.AddRemoteCandidate(
+        CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", i + 2, i));
+  }
+  const int64_t add_us = rtc::TimeMicros() - start_us;
+  ASSERT_EQ(static_cast<size_t>(kNumCandidates + 1), ch.connections().size());
+
+  start_us = rtc::TimeMicros();
+  for (Connection* conn : ch.connections())
+    conn->ReceivedPingResponse(LOW_RTT, "id");
+  rtc::Thread::Current()->ProcessMessages(0);
+  const int64_t sort_us = rtc::TimeMicros() - start_us;
+  EXPECT_TRUE(ch.selected_connection() != nullptr);
+
+  RTC_LOG(LS_INFO) << "Adding " << kNumCandidates
+                   << " remote candidates: " << add_us << " us";
+  RTC_LOG(LS_INFO) << "Making them writable and sorting: " << sort_us
+                   << " us";
+}
+
 TEST(P2PTransportChannel, InjectIceController) {
   MockIceControllerFactory factory;
   FakePortAllocator pa(rtc::Thread::Current(), nullptr);
@@ -10,11 +10,16 @@
 
 #include "p2p/base/packet_transport_internal.h"
 
+#include "rtc_base/checks.h"
+
 namespace rtc {
 
 PacketTransportInternal::PacketTransportInternal() = default;
 
-PacketTransportInternal::~PacketTransportInternal() = default;
+PacketTransportInternal::~PacketTransportInternal() {
+  if (packet_receiver_)
+    packet_receiver_->OnPacketTransportDestroyed(this);
+}
 
 bool PacketTransportInternal::GetOption(rtc::Socket::Option opt, int* value) {
   return false;
@@ -24,4 +29,20 @@ absl::optional<NetworkRoute> PacketTransportInternal::network_route() const {
   return absl::optional<NetworkRoute>();
 }
 
+void PacketTransportInternal::SetPacketReceiver(
+    PacketTransportReceiver* receiver) {
+  RTC_DCHECK(!receiver || !packet_receiver_ || packet_receiver_ == receiver)
+      << "The transport already has a receiver";
+  packet_receiver_ = receiver;
+}
+
+void PacketTransportInternal::NotifyPacketReceived(const char* data,
+                                                   size_t len,
+                                                   int64_t packet_time_us,
+                                                   int flags) {
+  if (packet_receiver_)
+    packet_receiver_->OnReadPacket(this, data, len, packet_time_us, flags);
+  SignalReadPacket(this, data, len, packet_time_us, flags);
+}
+
 }  // namespace rtc
@@ -25,6 +25,24 @@
 namespace rtc {
 struct PacketOptions;
 struct SentPacket;
+class PacketTransportInternal;
+
+// Receives the packets of a PacketTransportInternal with a direct call. This
+// is what the packet data path uses, since a SignalReadPacket emission walks
+// a list of slots for every packet, at every layer the packet goes through.
+class PacketTransportReceiver {
+ public:
+  virtual void OnReadPacket(PacketTransportInternal* transport,
+                            const char* data,
+                            size_t len,
+                            const int64_t& packet_time_us,
+                            int flags) = 0;
+  // Called when |transport| is destroyed while this is its receiver.
+  virtual void OnPacketTransportDestroyed(PacketTransportInternal* transport) {}
+
+ protected:
+  virtual ~PacketTransportReceiver() = default;
+};
 
 class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
  public:
@@ -54,6 +72,12 @@ class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
   // supported by all transport types.
   virtual int SetOption(rtc::Socket::Option opt, int value) = 0;
 
+  // Packets sent between StartSendBatch() and FlushSendBatch() may be queued
+  // and written to the network together, e.g. for a pacing burst. The
+  // default implementation sends every packet immediately.
+  virtual void StartSendBatch() {}
+  virtual void FlushSendBatch() {}
+
   // TODO(pthatcher): Once Chrome's MockPacketTransportInterface implements
   // this, remove the default implementation.
   virtual bool GetOption(rtc::Socket::Option opt, int* value);
@@ -78,7 +102,14 @@ class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
   // Emitted when receiving state changes to true.
   sigslot::signal1<PacketTransportInternal*> SignalReceivingState;
 
-  // Signalled each time a packet is received on this channel.
+  // Sets the receiver of the packets received, which gets them before
+  // SignalReadPacket. A transport has at most one receiver; null unsets it.
+  // The receiver must unset itself before it is destroyed, and is told if the
+  // transport is destroyed first.
+  void SetPacketReceiver(PacketTransportReceiver* receiver);
+
+  // Signalled each time a packet is received on this channel. Implementations
+  // deliver packets with NotifyPacketReceived(), which also emits this.
   sigslot::signal5<PacketTransportInternal*,
                    const char*,
                    size_t,
@@ -101,6 +132,15 @@ class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
  protected:
   PacketTransportInternal();
   ~PacketTransportInternal() override;
+
+  // Passes a packet received to the receiver and to SignalReadPacket.
+  void NotifyPacketReceived(const char* data,
+                            size_t len,
+                            int64_t packet_time_us,
+                            int flags);
+
+ private:
+  PacketTransportReceiver* packet_receiver_ = nullptr;
 };
 
 }  // namespace rtc
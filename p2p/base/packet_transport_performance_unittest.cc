@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Cost of passing a received packet up through the layers of transports, as
+// it goes from the ICE transport through the DTLS transport to the RTP
+// transport, with SignalReadPacket against PacketTransportReceiver.
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "p2p/base/packet_transport_internal.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace rtc {
+namespace {
+
+using webrtc::test::ImproveDirection;
+
+// Number of transports each packet goes through, including the one that
+// receives it from the network.
+constexpr int kNumLayers = 4;
+constexpr char kPacket[1200] = {};
+
+int Iterations(int full_iterations) {
+  return webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest")
+             ? full_iterations / 100
+             : full_iterations;
+}
+
+// A layer that passes the packets of the transport below it on, either from
+// SignalReadPacket or as its receiver.
+class Layer : public PacketTransportInternal, public PacketTransportReceiver {
+ public:
+  // Receives the packets of |below|, if set.
+  Layer(Layer* below, bool use_receiver) {
+    if (!below)
+      return;
+    if (use_receiver) {
+      below->SetPacketReceiver(this);
+    } else {
+      below->SignalReadPacket.connect(this, &Layer::OnSignalReadPacket);
+    }
+  }
+
+  // Delivers a packet from the network.
+  void Receive(const char* data, size_t len, bool use_receiver) {
+    if (use_receiver) {
+      NotifyPacketReceived(data, len, packet_time_us_, 0);
+    } else {
+      SignalReadPacket(this, data, len, packet_time_us_, 0);
+    }
+  }
+
+  // PacketTransportReceiver implementation.
+  void OnReadPacket(PacketTransportInternal* transport,
+                    const char* data,
+                    size_t len,
+                    const int64_t& packet_time_us,
+                    int flags) override {
+    NotifyPacketReceived(data, len, packet_time_us, flags);
+  }
+
+  const std::string& transport_name() const override { return name_; }
+  bool writable() const override { return true; }
+  bool receiving() const override { return true; }
+  int SendPacket(const char* data,
+                 size_t len,
+                 const PacketOptions& options,
+                 int flags) override {
+    return -1;
+  }
+  int SetOption(Socket::Option opt, int value) override { return -1; }
+  int GetError() override { return 0; }
+
+ private:
+  void OnSignalReadPacket(PacketTransportInternal* transport,
+                          const char* data,
+                          size_t len,
+                          const int64_t& packet_time_us,
+                          int flags) {
+    SignalReadPacket(this, data, len, packet_time_us, flags);
+  }
+
+  const std::string name_ = "layer";
+  const int64_t packet_time_us_ = 1234;
+};
+
+// Receives the packets of the top layer.
+class Sink : public PacketTransportReceiver, public sigslot::has_slots<> {
+ public:
+  Sink(Layer* top, bool use_receiver) {
+    if (use_receiver) {
+      top->SetPacketReceiver(this);
+    } else {
+      top->SignalReadPacket.connect(this, &Sink::OnSignalReadPacket);
+    }
+  }
+
+  void OnReadPacket(PacketTransportInternal* transport,
+                    const char* data,
+                    size_t len,
+                    const int64_t& packet_time_us,
+                    int flags) override {
+    bytes_ += len;
+  }
+
+  size_t bytes() const { return bytes_; }
+
+ private:
+  void OnSignalReadPacket(PacketTransportInternal* transport,
+                          const char* data,
+                          size_t len,
+                          const int64_t& packet_time_us,
+                          int flags) {
+    bytes_ += len;
+  }
+
+  size_t bytes_ = 0;
+};
+
+void MeasureDispatch(bool use_receiver, const std::string& user_story) {
+  std::vector<std::unique_ptr<Layer>> layers;
+  for (int i = 0; i < kNumLayers; ++i) {
+    layers.push_back(std::make_unique<Layer>(
+        layers.empty() ? nullptr : layers.back().get(), use_receiver));
+  }
+  Sink sink(layers.back().get(), use_receiver);
+
+  const int iterations = Iterations(10000000);
+  const int64_t start_ns = TimeNanos();
+  for (int i = 0; i < iterations; ++i)
+    layers.front()->Receive(kPacket, sizeof(kPacket), use_receiver);
+  const int64_t elapsed_ns = TimeNanos() - start_ns;
+  layers.back()->SetPacketReceiver(nullptr);
+  ASSERT_EQ(sizeof(kPacket) * iterations, sink.bytes());
+
+  webrtc::test::PrintResult("packet_dispatch_time", "", user_story,
+                            static_cast<double>(elapsed_ns) / iterations, "ns",
+                            /*important=*/false,
+                            ImproveDirection::kSmallerIsBetter);
+}
+
+}  // namespace
+
+TEST(PacketTransportPerformanceTest, SignalReadPacket) {
+  MeasureDispatch(/*use_receiver=*/false, "sigslot");
+}
+
+TEST(PacketTransportPerformanceTest, PacketTransportReceiver) {
+  MeasureDispatch(/*use_receiver=*/true, "receiver");
+}
+
+}  // namespace rtc
@@ -88,6 +88,12 @@ enum {
   // Exclude link-local network interfaces
   // from considertaion after adapter enumeration.
   PORTALLOCATOR_DISABLE_LINK_LOCAL_NETWORKS = 0x10000,
+
+  // When specified, the allocation phases are not separated by the step
+  // delay. The phases of all networks still run in order of priority: every
+  // network gets its UDP and STUN ports before any relay port is allocated,
+  // and relay ports come before TCP ports.
+  PORTALLOCATOR_ENABLE_FAST_GATHERING = 0x20000,
 };
 
 // Defines various reasons that have caused ICE regathering.
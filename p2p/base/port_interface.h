@@ -92,6 +92,11 @@ class PortInterface {
                      const rtc::PacketOptions& options,
                      bool payload) = 0;
 
+  // Starts and flushes a batch of packets sent with SendTo on the underlying
+  // socket. See rtc::AsyncPacketSocket::StartSendBatch().
+  virtual void StartSendBatch() {}
+  virtual void FlushSendBatch() {}
+
   // Indicates that we received a successful STUN binding request from an
   // address that doesn't correspond to any current connection.  To turn this
   // into a real connection, call CreateConnection.
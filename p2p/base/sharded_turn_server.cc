@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/sharded_turn_server.h"
+
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "rtc_base/async_udp_socket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/string_encode.h"
+#include "rtc_base/time_utils.h"
+
+namespace cricket {
+
+namespace {
+
+const size_t kNonceKeySize = 16;
+
+}  // namespace
+
+TurnAuthCache::TurnAuthCache(TurnAuthInterface* auth_hook,
+                             int64_t lifetime_ms,
+                             size_t max_entries)
+    : auth_hook_(auth_hook),
+      lifetime_ms_(lifetime_ms),
+      max_entries_(max_entries) {
+  RTC_DCHECK(auth_hook_);
+  RTC_DCHECK_GT(max_entries_, 0);
+}
+
+TurnAuthCache::~TurnAuthCache() = default;
+
+bool TurnAuthCache::GetKey(const std::string& username,
+                           const std::string& realm,
+                           std::string* key) {
+  const int64_t now_ms = rtc::TimeMillis();
+  rtc::CritScope cs(&crit_);
+  auto name = std::make_pair(username, realm);
+  auto it = entries_.find(name);
+  if (it != entries_.end()) {
+    if (now_ms < it->second.expiry_ms) {
+      *key = it->second.key;
+      return true;
+    }
+    entries_.erase(it);
+  }
+
+  if (!auth_hook_->GetKey(username, realm, key)) {
+    return false;
+  }
+  if (entries_.size() >= max_entries_) {
+    entries_.clear();
+  }
+  entries_[std::move(name)] = Entry{*key, now_ms + lifetime_ms_};
+  return true;
+}
+
+ShardedTurnServer::ShardedTurnServer(const Config& config,
+                                     TurnAuthInterface* auth_hook)
+    : config_(config),
+      auth_cache_(auth_hook,
+                  config.auth_cache_lifetime_ms,
+                  config.auth_cache_max_entries),
+      nonce_key_(rtc::CreateRandomString(kNonceKeySize)) {
+  RTC_DCHECK_GT(config_.num_shards, 0);
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  Stop();
+}
+
+bool ShardedTurnServer::Start() {
+  RTC_DCHECK(shards_.empty());
+  internal_address_ = config_.internal_address;
+  shards_.reserve(config_.num_shards);
+  for (int i = 0; i < config_.num_shards; ++i) {
+    shards_.emplace_back();
+    Shard* shard = &shards_.back();
+    shard->thread = rtc::Thread::CreateWithSocketServer();
+    shard->thread->SetName("TurnShard" + rtc::ToString(i), nullptr);
+    shard->thread->Start();
+    // The other shards bind to the port the first one picked.
+    if (!shard->thread->Invoke<bool>(RTC_FROM_HERE, [this, shard] {
+          return StartShard(shard, &internal_address_);
+        })) {
+      Stop();
+      return false;
+    }
+  }
+  RTC_LOG(LS_INFO) << "Started " << shards_.size()
+                   << " TURN server shards on "
+                   << internal_address_.ToString();
+  return true;
+}
+
+void ShardedTurnServer::Stop() {
+  for (Shard& shard : shards_) {
+    // The server and its sockets are destroyed on their thread.
+    shard.thread->Invoke<void>(RTC_FROM_HERE,
+                               [&shard] { shard.server.reset(); });
+    shard.thread->Stop();
+  }
+  shards_.clear();
+}
+
+size_t ShardedTurnServer::GetNumAllocations(int shard) {
+  RTC_DCHECK_LT(shard, num_shards());
+  TurnServer* server = shards_[shard].server.get();
+  return shards_[shard].thread->Invoke<size_t>(
+      RTC_FROM_HERE, [server] { return server->allocations().size(); });
+}
+
+bool ShardedTurnServer::StartShard(Shard* shard,
+                                   rtc::SocketAddress* address) {
+  rtc::Thread* thread = shard->thread.get();
+  std::unique_ptr<rtc::AsyncSocket> socket(
+      thread->socketserver()->CreateAsyncSocket(address->family(),
+                                                SOCK_DGRAM));
+  if (!socket) {
+    return false;
+  }
+  if (socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) < 0 &&
+      config_.num_shards > 1) {
+    RTC_LOG(LS_ERROR) << "Failed to share the TURN port, error="
+                      << socket->GetError();
+    return false;
+  }
+  if (socket->Bind(*address) < 0) {
+    RTC_LOG(LS_ERROR) << "Failed to bind the TURN socket to "
+                      << address->ToString() << ", error="
+                      << socket->GetError();
+    return false;
+  }
+  *address = socket->GetLocalAddress();
+
+  shard->server = std::make_unique<TurnServer>(thread);
+  shard->server->set_realm(config_.realm);
+  shard->server->set_software(config_.software);
+  shard->server->set_auth_hook(&auth_cache_);
+  shard->server->set_nonce_key(nonce_key_);
+  shard->server->AddInternalSocket(new rtc::AsyncUDPSocket(socket.release()),
+                                   PROTO_UDP);
+  shard->server->SetExternalSocketFactory(
+      new rtc::BasicPacketSocketFactory(thread), config_.external_address);
+  return true;
+}
+
+}  // namespace cricket
@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_SHARDED_TURN_SERVER_H_
+#define P2P_BASE_SHARDED_TURN_SERVER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "p2p/base/turn_server.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace cricket {
+
+// Caches the keys returned by another TurnAuthInterface, for use by many
+// TurnServers at once. Only valid credentials are cached. GetKey() may be
+// called on any thread, and calls to the wrapped hook are serialized.
+class TurnAuthCache : public TurnAuthInterface {
+ public:
+  // Does not take ownership of |auth_hook|. Keys are cached for at most
+  // |lifetime_ms|, and the cache is emptied when it holds |max_entries|.
+  TurnAuthCache(TurnAuthInterface* auth_hook,
+                int64_t lifetime_ms,
+                size_t max_entries);
+  ~TurnAuthCache() override;
+
+  bool GetKey(const std::string& username,
+              const std::string& realm,
+              std::string* key) override;
+
+ private:
+  struct Entry {
+    std::string key;
+    int64_t expiry_ms;
+  };
+
+  TurnAuthInterface* const auth_hook_;
+  const int64_t lifetime_ms_;
+  const size_t max_entries_;
+  rtc::CriticalSection crit_;
+  std::map<std::pair<std::string, std::string>, Entry> entries_
+      RTC_GUARDED_BY(crit_);
+};
+
+// Runs several TurnServers, each on a thread of its own, that listen on the
+// same UDP address. The internal sockets are bound with SO_REUSEPORT, so the
+// kernel hashes the address and port of each client to pick the socket, and
+// thread, that handles all of its packets, and with them its allocation. The
+// servers share their nonce key and an auth cache, so a client that is moved
+// to another server, when the set of sockets changes, is not asked to
+// authenticate again.
+//
+// Needs SO_REUSEPORT to run more than one shard. TCP and TLS are not sharded.
+class ShardedTurnServer {
+ public:
+  struct Config {
+    int num_shards = 1;
+    // The UDP address to listen on. If the port is 0, the first shard picks
+    // one and the others share it.
+    rtc::SocketAddress internal_address;
+    // The address to allocate relayed addresses on, with port 0.
+    rtc::SocketAddress external_address;
+    std::string realm;
+    std::string software;
+    int64_t auth_cache_lifetime_ms = 5 * 60 * 1000;
+    size_t auth_cache_max_entries = 100000;
+  };
+
+  // Does not take ownership of |auth_hook|, which must outlive the server and
+  // may be called on any of its threads.
+  ShardedTurnServer(const Config& config, TurnAuthInterface* auth_hook);
+  ShardedTurnServer(const ShardedTurnServer&) = delete;
+  ShardedTurnServer& operator=(const ShardedTurnServer&) = delete;
+  ~ShardedTurnServer();
+
+  // Starts the threads and binds their sockets. Returns false, with all
+  // shards stopped, if any socket cannot be bound.
+  bool Start();
+  // Stops all shards, dropping their allocations.
+  void Stop();
+
+  // The address the shards listen on, once started.
+  const rtc::SocketAddress& internal_address() const {
+    return internal_address_;
+  }
+  int num_shards() const { return static_cast<int>(shards_.size()); }
+  // Returns the number of allocations of |shard|, from its thread.
+  size_t GetNumAllocations(int shard);
+
+ private:
+  struct Shard {
+    std::unique_ptr<rtc::Thread> thread;
+    std::unique_ptr<TurnServer> server;
+  };
+
+  // Creates the server of |shard| on its thread, listening on |address|,
+  // which is updated with the port that is bound.
+  bool StartShard(Shard* shard, rtc::SocketAddress* address);
+
+  const Config config_;
+  TurnAuthCache auth_cache_;
+  const std::string nonce_key_;
+  rtc::SocketAddress internal_address_;
+  std::vector<Shard> shards_;
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_SHARDED_TURN_SERVER_H_
@@ -0,0 +1,198 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/sharded_turn_server.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/stun.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace cricket {
+
+namespace {
+
+const char kRealm[] = "example.org";
+const char kUsername[] = "user";
+const int kTimeoutMs = 1000;
+
+// Accepts |kUsername|, with itself as the password.
+class CountingAuth : public TurnAuthInterface {
+ public:
+  bool GetKey(const std::string& username,
+              const std::string& realm,
+              std::string* key) override {
+    ++num_calls_;
+    if (username != kUsername) {
+      return false;
+    }
+    return ComputeStunCredentialHash(username, realm, username, key);
+  }
+
+  std::atomic<int> num_calls_{0};
+};
+
+// A TURN client that sends hand-made requests over a real UDP socket.
+class TestClient {
+ public:
+  explicit TestClient(rtc::SocketServer* ss)
+      : socket_(ss->CreateAsyncSocket(AF_INET, SOCK_DGRAM)) {
+    EXPECT_EQ(0, socket_->Bind(
+                     rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0)));
+  }
+
+  // Sends an allocate request, authenticated with |nonce| unless it is empty,
+  // and returns the type of the response, or -1 if none came. Updates |nonce|
+  // when the request is rejected with a new one.
+  int Allocate(const rtc::SocketAddress& server, std::string* nonce) {
+    TurnMessage request;
+    request.SetType(STUN_ALLOCATE_REQUEST);
+    request.SetTransactionID(
+        rtc::CreateRandomString(kStunTransactionIdLength));
+    request.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+    if (!nonce->empty()) {
+      std::string key;
+      ComputeStunCredentialHash(kUsername, kRealm, kUsername, &key);
+      request.AddAttribute(std::make_unique<StunByteStringAttribute>(
+          STUN_ATTR_USERNAME, kUsername));
+      request.AddAttribute(
+          std::make_unique<StunByteStringAttribute>(STUN_ATTR_REALM, kRealm));
+      request.AddAttribute(
+          std::make_unique<StunByteStringAttribute>(STUN_ATTR_NONCE, *nonce));
+      request.AddMessageIntegrity(key);
+    }
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    if (socket_->SendTo(buf.Data(), buf.Length(), server) < 0) {
+      return -1;
+    }
+
+    char data[2048];
+    int received = -1;
+    for (int i = 0; i < kTimeoutMs && received < 0; ++i) {
+      received = socket_->RecvFrom(data, sizeof(data), nullptr, nullptr);
+      if (received < 0) {
+        rtc::Thread::SleepMs(1);
+      }
+    }
+    TurnMessage response;
+    rtc::ByteBufferReader reader(data, received > 0 ? received : 0);
+    if (received < 0 || !response.Read(&reader)) {
+      return -1;
+    }
+    if (response.GetByteString(STUN_ATTR_NONCE)) {
+      *nonce = response.GetByteString(STUN_ATTR_NONCE)->GetString();
+    }
+    return response.type();
+  }
+
+ private:
+  std::unique_ptr<rtc::AsyncSocket> socket_;
+};
+
+class ShardedTurnServerTest : public ::testing::Test {
+ protected:
+  ShardedTurnServerTest() : thread_(&ss_) {}
+
+  ShardedTurnServer::Config MakeConfig(int num_shards) {
+    ShardedTurnServer::Config config;
+    config.num_shards = num_shards;
+    config.internal_address =
+        rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0);
+    config.external_address =
+        rtc::SocketAddress(rtc::IPAddress(INADDR_LOOPBACK), 0);
+    config.realm = kRealm;
+    return config;
+  }
+
+  rtc::PhysicalSocketServer ss_;
+  rtc::AutoSocketServerThread thread_;
+  CountingAuth auth_;
+};
+
+}  // namespace
+
+TEST_F(ShardedTurnServerTest, SharesPortAndNonceAcrossShards) {
+  ShardedTurnServer server(MakeConfig(4), &auth_);
+  ASSERT_TRUE(server.Start());
+  EXPECT_EQ(4, server.num_shards());
+  EXPECT_NE(0, server.internal_address().port());
+
+  // A nonce from one shard is valid on all of them, and thanks to the auth
+  // cache the credentials are only checked once.
+  std::string nonce;
+  TestClient first_client(&ss_);
+  ASSERT_EQ(STUN_ALLOCATE_ERROR_RESPONSE,
+            first_client.Allocate(server.internal_address(), &nonce));
+  ASSERT_FALSE(nonce.empty());
+  const int kNumClients = 16;
+  std::vector<std::unique_ptr<TestClient>> clients;
+  for (int i = 0; i < kNumClients; ++i) {
+    clients.push_back(std::make_unique<TestClient>(&ss_));
+    EXPECT_EQ(STUN_ALLOCATE_RESPONSE,
+              clients.back()->Allocate(server.internal_address(), &nonce));
+  }
+  EXPECT_EQ(1, auth_.num_calls_);
+
+  size_t num_allocations = 0;
+  for (int i = 0; i < server.num_shards(); ++i) {
+    num_allocations += server.GetNumAllocations(i);
+  }
+  EXPECT_EQ(static_cast<size_t>(kNumClients), num_allocations);
+
+  server.Stop();
+  EXPECT_EQ(0, server.num_shards());
+}
+
+TEST_F(ShardedTurnServerTest, FailsToStartOnPortInUse) {
+  std::unique_ptr<rtc::AsyncSocket> socket(
+      ss_.CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(MakeConfig(1).internal_address));
+  ShardedTurnServer::Config config = MakeConfig(2);
+  config.internal_address = socket->GetLocalAddress();
+  ShardedTurnServer server(config, &auth_);
+  EXPECT_FALSE(server.Start());
+  EXPECT_EQ(0, server.num_shards());
+}
+
+TEST(TurnAuthCacheTest, CachesValidKeysForLifetime) {
+  rtc::ScopedFakeClock clock;
+  clock.AdvanceTime(webrtc::TimeDelta::Seconds(1));
+  CountingAuth auth;
+  TurnAuthCache cache(&auth, 1000, 10);
+  std::string key;
+  EXPECT_TRUE(cache.GetKey(kUsername, kRealm, &key));
+  std::string cached_key;
+  EXPECT_TRUE(cache.GetKey(kUsername, kRealm, &cached_key));
+  EXPECT_EQ(key, cached_key);
+  EXPECT_EQ(1, auth.num_calls_);
+
+  // Invalid credentials are checked every time.
+  EXPECT_FALSE(cache.GetKey("other", kRealm, &key));
+  EXPECT_FALSE(cache.GetKey("other", kRealm, &key));
+  EXPECT_EQ(3, auth.num_calls_);
+
+  clock.AdvanceTime(webrtc::TimeDelta::Seconds(1));
+  EXPECT_TRUE(cache.GetKey(kUsername, kRealm, &key));
+  EXPECT_EQ(4, auth.num_calls_);
+}
+
+}  // namespace cricket
@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/stun_ping_scheduler.h"
+
+#include <algorithm>
+
+#include "rtc_base/bind.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/synchronization/sequence_checker.h"
+#include "rtc_base/time_utils.h"
+
+namespace cricket {
+
+StunPingScheduler::StunPingScheduler(rtc::Thread* network_thread,
+                                     const Config& config)
+    : network_thread_(network_thread),
+      config_(config),
+      max_pings_per_tick_(static_cast<int>(std::max<int64_t>(
+          1,
+          static_cast<int64_t>(config.max_pings_per_second) *
+              config.tick_interval_ms / rtc::kNumMillisecsPerSec))),
+      last_tick_ms_(rtc::TimeMillis() - config.tick_interval_ms) {
+  RTC_DCHECK(network_thread_);
+  RTC_DCHECK_GT(config_.tick_interval_ms, 0);
+  RTC_DCHECK_GT(config_.max_pings_per_second, 0);
+}
+
+StunPingScheduler::~StunPingScheduler() {
+  RTC_DCHECK(due_times_.empty());
+}
+
+void StunPingScheduler::Schedule(Client* client, int delay_ms) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RemoveClient(client);
+  const int64_t due_ms = rtc::TimeMillis() + std::max(delay_ms, 0);
+  due_times_[client] = due_ms;
+  queue_.insert(std::make_pair(due_ms, client));
+  if (!in_tick_) {
+    MaybeScheduleTick();
+  }
+}
+
+void StunPingScheduler::RemoveClient(Client* client) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  auto it = due_times_.find(client);
+  if (it == due_times_.end()) {
+    return;
+  }
+  queue_.erase(std::make_pair(it->second, client));
+  due_times_.erase(it);
+}
+
+void StunPingScheduler::AddToSendBatch(PortInterface* port) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK(in_tick_);
+  if (batched_ports_.insert(port).second) {
+    port->StartSendBatch();
+  }
+}
+
+void StunPingScheduler::OnTick() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  next_tick_ms_ = -1;
+  const int64_t now_ms = rtc::TimeMillis();
+  last_tick_ms_ = now_ms;
+  in_tick_ = true;
+  int num_served = 0;
+  while (!queue_.empty() && queue_.begin()->first <= now_ms &&
+         num_served < max_pings_per_tick_) {
+    Client* client = queue_.begin()->second;
+    RemoveClient(client);
+    ++num_served;
+    Schedule(client, client->OnPingDue(this));
+  }
+  for (PortInterface* port : batched_ports_) {
+    port->FlushSendBatch();
+  }
+  batched_ports_.clear();
+  in_tick_ = false;
+  MaybeScheduleTick();
+}
+
+void StunPingScheduler::MaybeScheduleTick() {
+  if (queue_.empty()) {
+    return;
+  }
+  const int64_t tick_ms = std::max(queue_.begin()->first,
+                                   last_tick_ms_ + config_.tick_interval_ms);
+  if (next_tick_ms_ >= 0 && next_tick_ms_ <= tick_ms) {
+    return;
+  }
+  // Only the earliest timer is kept armed.
+  invoker_.Clear();
+  next_tick_ms_ = tick_ms;
+  invoker_.AsyncInvokeDelayed<void>(
+      RTC_FROM_HERE, network_thread_,
+      rtc::Bind(&StunPingScheduler::OnTick, this),
+      static_cast<uint32_t>(std::max<int64_t>(0, tick_ms - rtc::TimeMillis())));
+}
+
+}  // namespace cricket
@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_STUN_PING_SCHEDULER_H_
+#define P2P_BASE_STUN_PING_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <set>
+#include <utility>
+
+#include "p2p/base/port_interface.h"
+#include "rtc_base/async_invoker.h"
+#include "rtc_base/system/rtc_export.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+// Schedules the connectivity checks of many ICE transports on one network
+// thread with a single timer, instead of one timer per transport. Clients that
+// are due are served together at most once per tick, the number of clients
+// served per second is capped across all of them, and the STUN pings sent in
+// a tick are written out in a send batch per port. This is meant for servers
+// that host many ICE sessions, where the timers of the transports would
+// otherwise fire, and send, independently of each other.
+//
+// All methods must be called on the thread passed to the constructor, which
+// must be the network thread of all the clients. The scheduler must outlive
+// its clients.
+class RTC_EXPORT StunPingScheduler {
+ public:
+  struct Config {
+    // The minimum time between two ticks. Clients that become due in between
+    // are served together on the next tick.
+    int tick_interval_ms = 5;
+    // The maximum number of clients served per second, across all clients.
+    // Due clients over the limit wait for the next tick, earliest due first.
+    int max_pings_per_second = 10000;
+  };
+
+  class Client {
+   public:
+    // Sends the next connectivity check, if any, and returns the delay in
+    // milliseconds until the client is due again. Ports used for sending
+    // should be passed to AddToSendBatch() of |scheduler| first.
+    virtual int OnPingDue(StunPingScheduler* scheduler) = 0;
+
+   protected:
+    virtual ~Client() = default;
+  };
+
+  StunPingScheduler(rtc::Thread* network_thread, const Config& config);
+  StunPingScheduler(const StunPingScheduler&) = delete;
+  StunPingScheduler& operator=(const StunPingScheduler&) = delete;
+  ~StunPingScheduler();
+
+  // Makes |client| due |delay_ms| from now, replacing its previous due time.
+  void Schedule(Client* client, int delay_ms);
+  // Stops serving |client|. Must be called before a client is destroyed.
+  void RemoveClient(Client* client);
+
+  // Starts a send batch on |port| that is flushed at the end of the current
+  // tick. May only be called from Client::OnPingDue().
+  void AddToSendBatch(PortInterface* port);
+
+  size_t num_clients() const { return due_times_.size(); }
+
+ private:
+  void OnTick();
+  // Arms the timer for the next tick, if any client is due before the timer
+  // that is currently armed.
+  void MaybeScheduleTick();
+
+  rtc::Thread* const network_thread_;
+  const Config config_;
+  // The number of clients served per tick.
+  const int max_pings_per_tick_;
+  // The due time of each client, in rtc::TimeMillis(), and the clients sorted
+  // by it.
+  std::map<Client*, int64_t> due_times_;
+  std::set<std::pair<int64_t, Client*>> queue_;
+  // The ports with a send batch started in the current tick.
+  std::set<PortInterface*> batched_ports_;
+  bool in_tick_ = false;
+  // When the last tick ran.
+  int64_t last_tick_ms_;
+  // When the armed timer fires, or -1 if none is armed.
+  int64_t next_tick_ms_ = -1;
+  rtc::AsyncInvoker invoker_;
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_STUN_PING_SCHEDULER_H_
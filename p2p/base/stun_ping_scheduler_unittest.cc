@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/stun_ping_scheduler.h"
+
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace cricket {
+
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// Records when it is served and asks to be served again after |delay_ms|.
+class FakeClient : public StunPingScheduler::Client {
+ public:
+  explicit FakeClient(int delay_ms) : delay_ms_(delay_ms) {}
+
+  int OnPingDue(StunPingScheduler* scheduler) override {
+    served_ms_.push_back(rtc::TimeMillis() - start_ms_);
+    return delay_ms_;
+  }
+
+  std::vector<int64_t> served_ms_;
+
+ private:
+  const int delay_ms_;
+  const int64_t start_ms_ = rtc::TimeMillis();
+};
+
+class StunPingSchedulerTest : public ::testing::Test {
+ protected:
+  StunPingSchedulerTest() {
+    clock_.AdvanceTime(webrtc::TimeDelta::Seconds(1));
+  }
+
+  // Serves the clients that are due now and in the next |ms| milliseconds.
+  void AdvanceTimeMs(int ms) {
+    rtc::Thread::Current()->ProcessMessages(0);
+    for (int i = 0; i < ms; ++i) {
+      clock_.AdvanceTime(webrtc::TimeDelta::Millis(1));
+    }
+  }
+
+  rtc::ScopedFakeClock clock_;
+  rtc::AutoThread main_thread_;
+};
+
+}  // namespace
+
+TEST_F(StunPingSchedulerTest, ServesDueClientsOncePerTick) {
+  StunPingScheduler::Config config;
+  config.tick_interval_ms = 5;
+  StunPingScheduler scheduler(rtc::Thread::Current(), config);
+  FakeClient client1(3);
+  FakeClient client2(2);
+  scheduler.Schedule(&client1, 0);
+  scheduler.Schedule(&client2, 1);
+
+  AdvanceTimeMs(20);
+  // The clients ask to be served every few milliseconds, but are only served
+  // on ticks, which are at least 5 ms apart.
+  EXPECT_THAT(client1.served_ms_, ElementsAre(0, 5, 10, 15, 20));
+  EXPECT_THAT(client2.served_ms_, ElementsAre(5, 10, 15, 20));
+
+  scheduler.RemoveClient(&client1);
+  scheduler.RemoveClient(&client2);
+}
+
+TEST_F(StunPingSchedulerTest, LimitsClientsServedPerTick) {
+  StunPingScheduler::Config config;
+  config.tick_interval_ms = 5;
+  config.max_pings_per_second = 400;
+  StunPingScheduler scheduler(rtc::Thread::Current(), config);
+  std::vector<FakeClient> clients(5, FakeClient(1000));
+  for (FakeClient& client : clients) {
+    scheduler.Schedule(&client, 0);
+  }
+
+  // Two clients are served per tick, in the order they became due.
+  AdvanceTimeMs(10);
+  EXPECT_THAT(clients[0].served_ms_, ElementsAre(0));
+  EXPECT_THAT(clients[1].served_ms_, ElementsAre(0));
+  EXPECT_THAT(clients[2].served_ms_, ElementsAre(5));
+  EXPECT_THAT(clients[3].served_ms_, ElementsAre(5));
+  EXPECT_THAT(clients[4].served_ms_, ElementsAre(10));
+
+  for (FakeClient& client : clients) {
+    scheduler.RemoveClient(&client);
+  }
+  EXPECT_EQ(0u, scheduler.num_clients());
+}
+
+TEST_F(StunPingSchedulerTest, ReschedulingEarlierServesSooner) {
+  StunPingScheduler scheduler(rtc::Thread::Current(),
+                              StunPingScheduler::Config());
+  FakeClient client(1000);
+  scheduler.Schedule(&client, 1000);
+  AdvanceTimeMs(10);
+  EXPECT_THAT(client.served_ms_, IsEmpty());
+
+  scheduler.Schedule(&client, 0);
+  AdvanceTimeMs(1);
+  EXPECT_THAT(client.served_ms_, ElementsAre(10));
+  scheduler.RemoveClient(&client);
+}
+
+TEST_F(StunPingSchedulerTest, RemovedClientIsNotServed) {
+  StunPingScheduler scheduler(rtc::Thread::Current(),
+                              StunPingScheduler::Config());
+  FakeClient client1(10);
+  FakeClient client2(10);
+  scheduler.Schedule(&client1, 10);
+  scheduler.Schedule(&client2, 10);
+  scheduler.RemoveClient(&client1);
+  EXPECT_EQ(1u, scheduler.num_clients());
+
+  AdvanceTimeMs(10);
+  EXPECT_THAT(client1.served_ms_, IsEmpty());
+  EXPECT_THAT(client2.served_ms_, ElementsAre(10));
+  scheduler.RemoveClient(&client2);
+}
+
+}  // namespace cricket
@@ -221,7 +221,7 @@ bool UDPPort::Init() {
       RTC_LOG(LS_WARNING) << ToString() << ": UDP socket creation failed";
       return false;
     }
-    socket_->SignalReadPacket.connect(this, &UDPPort::OnReadPacket);
+    socket_->SetPacketReceiver(this);
   }
   socket_->SignalSentPacket.connect(this, &UDPPort::OnSentPacket);
   socket_->SignalReadyToSend.connect(this, &UDPPort::OnReadyToSend);
@@ -291,6 +291,14 @@ Connection* UDPPort::CreateConnection(const Candidate& address,
   return conn;
 }
 
+void UDPPort::StartSendBatch() {
+  socket_->StartSendBatch();
+}
+
+void UDPPort::FlushSendBatch() {
+  socket_->FlushSendBatch();
+}
+
 int UDPPort::SendTo(const void* data,
                     size_t size,
                     const rtc::SocketAddress& addr,
@@ -30,7 +30,7 @@ static const int INFINITE_LIFETIME = -1;
 static const int HIGH_COST_PORT_KEEPALIVE_LIFETIME = 2 * 60 * 1000;
 
 // Communicates using the address on the outside of a NAT.
-class UDPPort : public Port {
+class UDPPort : public Port, public rtc::AsyncPacketSocketReceiver {
  public:
   static std::unique_ptr<UDPPort> Create(
       rtc::Thread* thread,
@@ -145,6 +145,8 @@ class UDPPort : public Port {
              const rtc::SocketAddress& addr,
              const rtc::PacketOptions& options,
              bool payload) override;
+  void StartSendBatch() override;
+  void FlushSendBatch() override;
 
   void UpdateNetworkCost() override;
 
@@ -155,11 +157,12 @@ class UDPPort : public Port {
 
   void PostAddAddress(bool is_final) override;
 
+  // rtc::AsyncPacketSocketReceiver implementation.
   void OnReadPacket(rtc::AsyncPacketSocket* socket,
                     const char* data,
                     size_t size,
                     const rtc::SocketAddress& remote_addr,
-                    const int64_t& packet_time_us);
+                    const int64_t& packet_time_us) override;
 
   void OnSentPacket(rtc::AsyncPacketSocket* socket,
                     const rtc::SentPacket& sent_packet) override;
@@ -10,6 +10,7 @@
 
 #include "p2p/base/stun_server.h"
 
+#include <string>
 #include <utility>
 
 #include "rtc_base/byte_buffer.h"
@@ -30,12 +31,15 @@ void StunServer::OnPacket(rtc::AsyncPacketSocket* socket,
                           size_t size,
                           const rtc::SocketAddress& remote_addr,
                           const int64_t& /* packet_time_us */) {
-  // Parse the STUN message; eat any messages that fail to parse.
-  rtc::ByteBufferReader bbuf(buf, size);
-  StunMessage msg;
-  if (!msg.Read(&bbuf)) {
+  // Parse the STUN message; eat any messages that fail to parse. Only the
+  // header is used, so the attributes are not parsed into objects.
+  StunMessageView view;
+  if (!view.Parse(buf, size)) {
     return;
   }
+  StunMessage msg;
+  msg.SetType(view.type());
+  msg.SetTransactionID(std::string(view.transaction_id()));
 
   // TODO(?): If unknown non-optional (<= 0x7fff) attributes are found, send a
   //          420 "Unknown Attribute" response.
@@ -423,7 +423,7 @@ bool TurnPort::CreateTurnClientSocket() {
 
   if (!SharedSocket()) {
     // If socket is shared, AllocationSequence will receive the packet.
-    socket_->SignalReadPacket.connect(this, &TurnPort::OnReadPacket);
+    socket_->SetPacketReceiver(this);
   }
 
   socket_->SignalReadyToSend.connect(this, &TurnPort::OnReadyToSend);
@@ -620,6 +620,19 @@ int TurnPort::GetError() {
   return error_;
 }
 
+void TurnPort::StartSendBatch() {
+  // A shared socket is batched by the UDPPort that owns it.
+  if (socket_ && !SharedSocket()) {
+    socket_->StartSendBatch();
+  }
+}
+
+void TurnPort::FlushSendBatch() {
+  if (socket_ && !SharedSocket()) {
+    socket_->FlushSendBatch();
+  }
+}
+
 int TurnPort::SendTo(const void* data,
                      size_t size,
                      const rtc::SocketAddress& addr,
@@ -38,7 +38,7 @@ extern const char TURN_PORT_TYPE[];
 class TurnAllocateRequest;
 class TurnEntry;
 
-class TurnPort : public Port {
+class TurnPort : public Port, public rtc::AsyncPacketSocketReceiver {
  public:
   enum PortState {
     STATE_CONNECTING,    // Initial state, cannot send any packets.
@@ -166,6 +166,10 @@ class TurnPort : public Port {
              const rtc::SocketAddress& addr,
              const rtc::PacketOptions& options,
              bool payload) override;
+  // Over TCP and TLS, the batched packets are written together, which over
+  // TLS makes one record of several ChannelData messages.
+  void StartSendBatch() override;
+  void FlushSendBatch() override;
   int SetOption(rtc::Socket::Option opt, int value) override;
   int GetOption(rtc::Socket::Option opt, int* value) override;
   int GetError() override;
@@ -177,11 +181,12 @@ class TurnPort : public Port {
                             int64_t packet_time_us) override;
   bool CanHandleIncomingPacketsFrom(
       const rtc::SocketAddress& addr) const override;
-  virtual void OnReadPacket(rtc::AsyncPacketSocket* socket,
-                            const char* data,
-                            size_t size,
-                            const rtc::SocketAddress& remote_addr,
-                            const int64_t& packet_time_us);
+  // rtc::AsyncPacketSocketReceiver implementation.
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) override;
 
   void OnSentPacket(rtc::AsyncPacketSocket* socket,
                     const rtc::SentPacket& sent_packet) override;
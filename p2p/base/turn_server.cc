@@ -14,7 +14,6 @@
 #include <tuple>  // for std::tie
 #include <utility>
 
-#include "absl/algorithm/container.h"
 #include "api/packet_socket_factory.h"
 #include "api/transport/stun.h"
 #include "p2p/base/async_stun_tcp_socket.h"
@@ -147,7 +146,12 @@ void TurnServer::AddInternalSocket(rtc::AsyncPacketSocket* socket,
                                    ProtocolType proto) {
   RTC_DCHECK(thread_checker_.IsCurrent());
   RTC_DCHECK(server_sockets_.end() == server_sockets_.find(socket));
-  server_sockets_[socket] = proto;
+  InternalSocket& internal_socket = server_sockets_[socket];
+  internal_socket.proto = proto;
+  // UDP sockets are not connected, and looking up their remote address fails.
+  if (proto != PROTO_UDP) {
+    internal_socket.remote_address = socket->GetRemoteAddress();
+  }
   socket->SignalReadPacket.connect(this, &TurnServer::OnInternalPacket);
 }
 
@@ -209,7 +213,8 @@ void TurnServer::OnInternalPacket(rtc::AsyncPacketSocket* socket,
   }
   InternalSocketMap::iterator iter = server_sockets_.find(socket);
   RTC_DCHECK(iter != server_sockets_.end());
-  TurnServerConnection conn(addr, iter->second, socket);
+  TurnServerConnection conn(addr, iter->second.remote_address,
+                            iter->second.proto, socket);
   uint16_t msg_type = rtc::GetBE16(data);
   if (!IsTurnChannelData(msg_type)) {
     // This is a STUN message.
@@ -551,7 +556,8 @@ void TurnServer::OnAllocationDestroyed(TurnServerAllocation* allocation) {
   // by all allocations.
   // Note: We may not find a socket if it's a TCP socket that was closed, and
   // the allocation is only now timing out.
-  if (iter != server_sockets_.end() && iter->second != cricket::PROTO_UDP) {
+  if (iter != server_sockets_.end() &&
+      iter->second.proto != cricket::PROTO_UDP) {
     DestroyInternalSocket(socket);
   }
 
@@ -592,6 +598,12 @@ TurnServerConnection::TurnServerConnection(const rtc::SocketAddress& src,
       proto_(proto),
       socket_(socket) {}
 
+TurnServerConnection::TurnServerConnection(const rtc::SocketAddress& src,
+                                           const rtc::SocketAddress& dst,
+                                           ProtocolType proto,
+                                           rtc::AsyncPacketSocket* socket)
+    : src_(src), dst_(dst), proto_(proto), socket_(socket) {}
+
 bool TurnServerConnection::operator==(const TurnServerConnection& c) const {
   return src_ == c.src_ && dst_ == c.dst_ && proto_ == c.proto_;
 }
@@ -600,6 +612,11 @@ bool TurnServerConnection::operator<(const TurnServerConnection& c) const {
   return std::tie(src_, dst_, proto_) < std::tie(c.src_, c.dst_, c.proto_);
 }
 
+size_t TurnServerConnection::Hash::operator()(
+    const TurnServerConnection& c) const {
+  return c.src_.Hash() ^ (c.dst_.Hash() * 31) ^ c.proto_;
+}
+
 std::string TurnServerConnection::ToString() const {
   const char* const kProtos[] = {"unknown", "udp", "tcp", "ssltcp"};
   rtc::StringBuilder ost;
@@ -623,12 +640,11 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
 }
 
 TurnServerAllocation::~TurnServerAllocation() {
-  for (ChannelList::iterator it = channels_.begin(); it != channels_.end();
-       ++it) {
-    delete *it;
+  for (const auto& entry : channels_) {
+    delete entry.second;
   }
-  for (PermissionList::iterator it = perms_.begin(); it != perms_.end(); ++it) {
-    delete *it;
+  for (const auto& entry : perms_) {
+    delete entry.second;
   }
   thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
   RTC_LOG(LS_INFO) << ToString() << ": Allocation destroyed";
@@ -809,7 +825,8 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
     channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
     channel1->SignalDestroyed.connect(
         this, &TurnServerAllocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    channels_[channel_id] = channel1;
+    channels_by_peer_[channel1->peer()] = channel1;
   } else {
     channel1->Refresh();
   }
@@ -851,11 +868,11 @@ void TurnServerAllocation::OnExternalPacket(
   Channel* channel = FindChannel(addr);
   if (channel) {
     // There is a channel bound to this address. Send as a channel message.
-    rtc::ByteBufferWriter buf;
-    buf.WriteUInt16(channel->id());
-    buf.WriteUInt16(static_cast<uint16_t>(size));
-    buf.WriteBytes(data, size);
-    server_->Send(&conn_, buf);
+    channel_data_.Clear();
+    channel_data_.WriteUInt16(channel->id());
+    channel_data_.WriteUInt16(static_cast<uint16_t>(size));
+    channel_data_.WriteBytes(data, size);
+    server_->Send(&conn_, channel_data_);
   } else if (!server_->enable_permission_checks_ ||
              HasPermission(addr.ipaddr())) {
     // No channel, but a permission exists. Send as a data indication.
@@ -894,7 +911,7 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
     perm = new Permission(thread_, addr);
     perm->SignalDestroyed.connect(this,
                                   &TurnServerAllocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
+    perms_[addr] = perm;
   } else {
     perm->Refresh();
   }
@@ -902,32 +919,20 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
 
 TurnServerAllocation::Permission* TurnServerAllocation::FindPermission(
     const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin(); it != perms_.end();
-       ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  auto it = perms_.find(addr);
+  return (it != perms_.end()) ? it->second : nullptr;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
-  }
-  return NULL;
+  auto it = channels_.find(channel_id);
+  return (it != channels_.end()) ? it->second : nullptr;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  auto it = channels_by_peer_.find(addr);
+  return (it != channels_by_peer_.end()) ? it->second : nullptr;
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -960,15 +965,15 @@ void TurnServerAllocation::OnMessage(rtc::Message* msg) {
 }
 
 void TurnServerAllocation::OnPermissionDestroyed(Permission* perm) {
-  auto it = absl::c_find(perms_, perm);
-  RTC_DCHECK(it != perms_.end());
-  perms_.erase(it);
+  size_t erased = perms_.erase(perm->peer());
+  RTC_DCHECK_EQ(1u, erased);
 }
 
 void TurnServerAllocation::OnChannelDestroyed(Channel* channel) {
-  auto it = absl::c_find(channels_, channel);
-  RTC_DCHECK(it != channels_.end());
-  channels_.erase(it);
+  size_t erased = channels_.erase(channel->id());
+  RTC_DCHECK_EQ(1u, erased);
+  erased = channels_by_peer_.erase(channel->peer());
+  RTC_DCHECK_EQ(1u, erased);
 }
 
 TurnServerAllocation::Permission::Permission(rtc::Thread* thread,
@@ -11,24 +11,25 @@
 #ifndef P2P_BASE_TURN_SERVER_H_
 #define P2P_BASE_TURN_SERVER_H_
 
-#include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "p2p/base/port_interface.h"
 #include "rtc_base/async_invoker.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/ip_address.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/thread_checker.h"
 
 namespace rtc {
-class ByteBufferWriter;
 class PacketSocketFactory;
 }  // namespace rtc
 
@@ -48,12 +49,22 @@ class TurnServerConnection {
   TurnServerConnection(const rtc::SocketAddress& src,
                        ProtocolType proto,
                        rtc::AsyncPacketSocket* socket);
+  // Uses |dst| as the remote address of |socket|, rather than looking it up.
+  TurnServerConnection(const rtc::SocketAddress& src,
+                       const rtc::SocketAddress& dst,
+                       ProtocolType proto,
+                       rtc::AsyncPacketSocket* socket);
   const rtc::SocketAddress& src() const { return src_; }
   rtc::AsyncPacketSocket* socket() { return socket_; }
   bool operator==(const TurnServerConnection& t) const;
   bool operator<(const TurnServerConnection& t) const;
   std::string ToString() const;
 
+  // Hashes connections consistently with operator==.
+  struct Hash {
+    size_t operator()(const TurnServerConnection& c) const;
+  };
+
  private:
   rtc::SocketAddress src_;
   rtc::SocketAddress dst_;
@@ -94,8 +105,23 @@ class TurnServerAllocation : public rtc::MessageHandler,
  private:
   class Channel;
   class Permission;
-  typedef std::list<Permission*> PermissionList;
-  typedef std::list<Channel*> ChannelList;
+  struct IPAddressHash {
+    size_t operator()(const rtc::IPAddress& ip) const {
+      return rtc::HashIP(ip);
+    }
+  };
+  struct SocketAddressHash {
+    size_t operator()(const rtc::SocketAddress& addr) const {
+      return addr.Hash();
+    }
+  };
+  // Permissions by peer address, and channels by id and by peer address, so
+  // that relaying a packet does not scan the permissions and channels.
+  typedef std::unordered_map<rtc::IPAddress, Permission*, IPAddressHash>
+      PermissionMap;
+  typedef std::unordered_map<int, Channel*> ChannelMap;
+  typedef std::unordered_map<rtc::SocketAddress, Channel*, SocketAddressHash>
+      ChannelPeerMap;
 
   void HandleAllocateRequest(const TurnMessage* msg);
   void HandleRefreshRequest(const TurnMessage* msg);
@@ -138,8 +164,11 @@ class TurnServerAllocation : public rtc::MessageHandler,
   std::string username_;
   std::string origin_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  PermissionMap perms_;
+  ChannelMap channels_;
+  ChannelPeerMap channels_by_peer_;
+  // Reused to build the channel data messages relayed to the client.
+  rtc::ByteBufferWriter channel_data_;
 };
 
 // An interface through which the MD5 credential hash can be retrieved.
@@ -175,7 +204,9 @@ class StunMessageObserver {
 // Not yet wired up: TCP support.
 class TurnServer : public sigslot::has_slots<> {
  public:
-  typedef std::map<TurnServerConnection, std::unique_ptr<TurnServerAllocation>>
+  typedef std::unordered_map<TurnServerConnection,
+                             std::unique_ptr<TurnServerAllocation>,
+                             TurnServerConnection::Hash>
       AllocationMap;
 
   explicit TurnServer(rtc::Thread* thread);
@@ -222,6 +253,13 @@ class TurnServer : public sigslot::has_slots<> {
     enable_otu_nonce_ = enable;
   }
 
+  // Sets the key nonces are signed with. Servers that share the key accept
+  // each other's nonces. By default, each server uses a random key.
+  void set_nonce_key(const std::string& nonce_key) {
+    RTC_DCHECK(thread_checker_.IsCurrent());
+    nonce_key_ = nonce_key;
+  }
+
   // If set to true, reject CreatePermission requests to RFC1918 addresses.
   void set_reject_private_addresses(bool filter) {
     RTC_DCHECK(thread_checker_.IsCurrent());
@@ -312,7 +350,13 @@ class TurnServer : public sigslot::has_slots<> {
   // Just clears |sockets_to_delete_|; called asynchronously.
   void FreeSockets();
 
-  typedef std::map<rtc::AsyncPacketSocket*, ProtocolType> InternalSocketMap;
+  // The protocol of an internal socket, and its remote address, which is
+  // looked up once rather than for every packet.
+  struct InternalSocket {
+    ProtocolType proto;
+    rtc::SocketAddress remote_address;
+  };
+  typedef std::map<rtc::AsyncPacketSocket*, InternalSocket> InternalSocketMap;
   typedef std::map<rtc::AsyncSocket*, ProtocolType> ServerSocketMap;
 
   rtc::Thread* thread_;
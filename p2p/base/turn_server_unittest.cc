@@ -10,15 +10,34 @@
 
 #include "p2p/base/turn_server.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/stun.h"
 #include "p2p/base/basic_packet_socket_factory.h"
+#include "p2p/base/test_turn_server.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/byte_order.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
 #include "rtc_base/virtual_socket_server.h"
 #include "test/gtest.h"
 
-// NOTE: This is a work in progress. Currently this file only has tests for
-// TurnServerConnection, a primitive class used by TurnServer.
-
 namespace cricket {
 
+namespace {
+
+const rtc::SocketAddress kTurnIntAddr("99.99.99.3", 3478);
+const rtc::SocketAddress kTurnExtAddr("99.99.99.5", 0);
+const rtc::SocketAddress kClientAddr("11.11.11.11", 0);
+const char kUsername[] = "user";
+const int kTimeoutMs = 1000;
+
+}  // namespace
+
 class TurnServerConnectionTest : public ::testing::Test {
  public:
   TurnServerConnectionTest() : thread_(&vss_) {}
@@ -64,4 +83,239 @@ TEST_F(TurnServerConnectionTest, ComparisonOperators) {
   ExpectNotEqual(connection1, connection4);
 }
 
+// Talks to a TurnServer with hand-made TURN messages, with an allocation, and
+// peers with channels bound to them.
+class TurnServerTest : public ::testing::Test, public sigslot::has_slots<> {
+ public:
+  TurnServerTest()
+      : thread_(&vss_),
+        turn_server_(rtc::Thread::Current(), kTurnIntAddr, kTurnExtAddr) {}
+
+ protected:
+  // Allocates a relayed address, authenticating after the first request is
+  // rejected with a nonce.
+  bool Allocate() {
+    client_socket_.reset(socket_factory_.CreateUdpSocket(kClientAddr, 0, 0));
+    client_socket_->SignalReadPacket.connect(this,
+                                             &TurnServerTest::OnClientPacket);
+    TurnMessage request;
+    InitRequest(STUN_ALLOCATE_REQUEST, &request);
+    request.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+    std::unique_ptr<TurnMessage> response = SendRequest(request);
+    if (!response || response->type() != STUN_ALLOCATE_ERROR_RESPONSE ||
+        !response->GetByteString(STUN_ATTR_NONCE)) {
+      return false;
+    }
+    nonce_ = response->GetByteString(STUN_ATTR_NONCE)->GetString();
+
+    TurnMessage authenticated_request;
+    InitRequest(STUN_ALLOCATE_REQUEST, &authenticated_request);
+    authenticated_request.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+    response = SendAuthenticatedRequest(&authenticated_request);
+    if (!response || response->type() != STUN_ALLOCATE_RESPONSE ||
+        !response->GetAddress(STUN_ATTR_XOR_RELAYED_ADDRESS)) {
+      return false;
+    }
+    relayed_address_ =
+        response->GetAddress(STUN_ATTR_XOR_RELAYED_ADDRESS)->GetAddress();
+    return true;
+  }
+
+  // Adds a peer, and binds |channel_id| to it if |channel_id| is not 0.
+  // Returns the index of the peer.
+  size_t AddPeer(int channel_id) {
+    peer_sockets_.emplace_back(socket_factory_.CreateUdpSocket(
+        rtc::SocketAddress("22.22.22.22", 0), 0, 0));
+    peer_sockets_.back()->SignalReadPacket.connect(
+        this, &TurnServerTest::OnPeerPacket);
+    const size_t peer = peer_sockets_.size() - 1;
+    if (channel_id != 0) {
+      EXPECT_EQ(TURN_CHANNEL_BIND_RESPONSE,
+                BindChannel(channel_id, peer_address(peer)));
+    }
+    return peer;
+  }
+
+  // Returns the type of the response to a channel bind request.
+  int BindChannel(int channel_id, const rtc::SocketAddress& peer) {
+    TurnMessage request;
+    InitRequest(TURN_CHANNEL_BIND_REQUEST, &request);
+    request.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_CHANNEL_NUMBER, channel_id << 16));
+    request.AddAttribute(std::make_unique<StunXorAddressAttribute>(
+        STUN_ATTR_XOR_PEER_ADDRESS, peer));
+    std::unique_ptr<TurnMessage> response = SendAuthenticatedRequest(&request);
+    return response ? response->type() : -1;
+  }
+
+  rtc::SocketAddress peer_address(size_t peer) {
+    return peer_sockets_[peer]->GetLocalAddress();
+  }
+
+  void SendChannelData(int channel_id, const std::string& data) {
+    rtc::ByteBufferWriter buf;
+    buf.WriteUInt16(channel_id);
+    buf.WriteUInt16(static_cast<uint16_t>(data.size()));
+    buf.WriteString(data);
+    client_socket_->SendTo(buf.Data(), buf.Length(), kTurnIntAddr,
+                           rtc::PacketOptions());
+  }
+
+  void SendFromPeer(size_t peer, const std::string& data) {
+    peer_sockets_[peer]->SendTo(data.data(), data.size(), relayed_address_,
+                                rtc::PacketOptions());
+  }
+
+  rtc::VirtualSocketServer vss_;
+  rtc::AutoSocketServerThread thread_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  TestTurnServer turn_server_;
+  std::unique_ptr<rtc::AsyncPacketSocket> client_socket_;
+  std::vector<std::unique_ptr<rtc::AsyncPacketSocket>> peer_sockets_;
+  rtc::SocketAddress relayed_address_;
+  std::string nonce_;
+  std::vector<std::string> client_packets_;
+  std::vector<std::string> peer_packets_;
+
+ private:
+  void InitRequest(int type, TurnMessage* request) {
+    request->SetType(type);
+    request->SetTransactionID(
+        rtc::CreateRandomString(kStunTransactionIdLength));
+  }
+
+  std::unique_ptr<TurnMessage> SendAuthenticatedRequest(TurnMessage* request) {
+    std::string key;
+    ComputeStunCredentialHash(kUsername, kTestRealm, kUsername, &key);
+    request->AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, kUsername));
+    request->AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_REALM, kTestRealm));
+    request->AddAttribute(
+        std::make_unique<StunByteStringAttribute>(STUN_ATTR_NONCE, nonce_));
+    request->AddMessageIntegrity(key);
+    return SendRequest(*request);
+  }
+
+  // Sends |request| and returns the response, or null if none came.
+  std::unique_ptr<TurnMessage> SendRequest(const TurnMessage& request) {
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    client_packets_.clear();
+    client_socket_->SendTo(buf.Data(), buf.Length(), kTurnIntAddr,
+                           rtc::PacketOptions());
+    EXPECT_TRUE_WAIT(!client_packets_.empty(), kTimeoutMs);
+    if (client_packets_.empty()) {
+      return nullptr;
+    }
+    auto response = std::make_unique<TurnMessage>();
+    rtc::ByteBufferReader reader(client_packets_.back().data(),
+                                 client_packets_.back().size());
+    if (!response->Read(&reader)) {
+      return nullptr;
+    }
+    client_packets_.clear();
+    return response;
+  }
+
+  void OnClientPacket(rtc::AsyncPacketSocket* socket,
+                      const char* data,
+                      size_t size,
+                      const rtc::SocketAddress& addr,
+                      const int64_t& packet_time_us) {
+    client_packets_.emplace_back(data, size);
+  }
+
+  void OnPeerPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& addr,
+                    const int64_t& packet_time_us) {
+    EXPECT_EQ(relayed_address_, addr);
+    peer_packets_.emplace_back(data, size);
+  }
+};
+
+TEST_F(TurnServerTest, RelaysChannelDataBothWays) {
+  ASSERT_TRUE(Allocate());
+  size_t peer1 = AddPeer(0x4000);
+  size_t peer2 = AddPeer(0x4001);
+  EXPECT_EQ(1u, turn_server_.server()->allocations().size());
+
+  SendChannelData(0x4001, "to peer2");
+  EXPECT_TRUE_WAIT(peer_packets_.size() == 1u, kTimeoutMs);
+  EXPECT_EQ("to peer2", peer_packets_[0]);
+
+  SendFromPeer(peer1, "from peer1");
+  ASSERT_TRUE_WAIT(client_packets_.size() == 1u, kTimeoutMs);
+  const std::string& channel_data = client_packets_[0];
+  ASSERT_EQ(4u + 10u, channel_data.size());
+  EXPECT_EQ(0x4000, rtc::GetBE16(channel_data.data()));
+  EXPECT_EQ(10, rtc::GetBE16(channel_data.data() + 2));
+  EXPECT_EQ("from peer1", channel_data.substr(4));
+
+  SendFromPeer(peer2, "again");
+  ASSERT_TRUE_WAIT(client_packets_.size() == 2u, kTimeoutMs);
+  EXPECT_EQ(0x4001, rtc::GetBE16(client_packets_[1].data()));
+}
+
+TEST_F(TurnServerTest, RejectsConflictingChannelBinds) {
+  ASSERT_TRUE(Allocate());
+  size_t peer1 = AddPeer(0x4000);
+  size_t peer2 = AddPeer(0);
+  // Rebinding the same channel to the same peer refreshes it.
+  EXPECT_EQ(TURN_CHANNEL_BIND_RESPONSE,
+            BindChannel(0x4000, peer_address(peer1)));
+  EXPECT_EQ(TURN_CHANNEL_BIND_ERROR_RESPONSE,
+            BindChannel(0x4000, peer_address(peer2)));
+  EXPECT_EQ(TURN_CHANNEL_BIND_ERROR_RESPONSE,
+            BindChannel(0x4001, peer_address(peer1)));
+
+  // Data for an unbound channel is dropped.
+  SendChannelData(0x4001, "dropped");
+  SendChannelData(0x4000, "relayed");
+  EXPECT_TRUE_WAIT(peer_packets_.size() == 1u, kTimeoutMs);
+  EXPECT_EQ("relayed", peer_packets_[0]);
+}
+
+// Measures relaying channel data through an allocation with many channels.
+TEST_F(TurnServerTest, DISABLED_BenchmarkChannelDataRelay) {
+  constexpr int kNumChannels = 200;
+  constexpr int kNumPackets = 100000;
+  ASSERT_TRUE(Allocate());
+  for (int i = 0; i < kNumChannels; ++i) {
+    AddPeer(0x4000 + i);
+  }
+  const std::string payload(1000, 'x');
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    SendChannelData(0x4000 + i % kNumChannels, payload);
+    if (i % 100 == 99) {
+      rtc::Thread::Current()->ProcessMessages(0);
+    }
+  }
+  EXPECT_TRUE_WAIT(peer_packets_.size() == static_cast<size_t>(kNumPackets),
+                   kTimeoutMs);
+  const int64_t to_peers_us = rtc::TimeMicros() - start_us;
+
+  client_packets_.clear();
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    SendFromPeer(i % kNumChannels, payload);
+    if (i % 100 == 99) {
+      rtc::Thread::Current()->ProcessMessages(0);
+    }
+  }
+  EXPECT_TRUE_WAIT(
+      client_packets_.size() == static_cast<size_t>(kNumPackets), kTimeoutMs);
+  const int64_t to_client_us = rtc::TimeMicros() - start_us;
+
+  RTC_LOG(LS_INFO) << "Relaying " << kNumPackets << " packets over "
+                   << kNumChannels << " channels to peers: " << to_peers_us
+                   << " us, to the client: " << to_client_us << " us";
+}
+
 }  // namespace cricket
@@ -0,0 +1,301 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/udp_socket_mux.h"
+
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/transport/stun.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/time_utils.h"
+
+namespace cricket {
+
+// The socket of one port. Sends on the shared socket, and receives the
+// packets that the mux demultiplexes to it.
+class UdpSocketMux::MuxedSocket : public rtc::AsyncPacketSocket {
+ public:
+  MuxedSocket(UdpSocketMux* mux, SharedSocket* shared)
+      : mux_(mux), shared_(shared) {}
+  ~MuxedSocket() override {
+    SetUsername(std::string());
+    for (const rtc::SocketAddress& addr : remote_addresses_) {
+      auto it = shared_->sockets_by_remote_address.find(addr);
+      if (it != shared_->sockets_by_remote_address.end() &&
+          it->second == this) {
+        shared_->sockets_by_remote_address.erase(it);
+      }
+    }
+    if (port_) {
+      mux_->sockets_by_port_.erase(port_);
+    }
+  }
+
+  void set_port(Port* port) { port_ = port; }
+
+  // Delivers a packet of the shared socket that is meant for this one.
+  void DeliverPacket(const char* data,
+                     size_t size,
+                     const rtc::SocketAddress& remote_addr,
+                     int64_t packet_time_us) {
+    NotifyPacketReceived(data, size, remote_addr, packet_time_us);
+  }
+
+  // Receives the STUN binding requests for |username| from now on. Returns
+  // false if another socket already does.
+  bool SetUsername(const std::string& username) {
+    if (username == username_) {
+      return true;
+    }
+    if (!username.empty() &&
+        shared_->sockets_by_username.count(username) > 0) {
+      return false;
+    }
+    if (!username_.empty()) {
+      shared_->sockets_by_username.erase(username_);
+    }
+    username_ = username;
+    if (!username_.empty()) {
+      shared_->sockets_by_username[username_] = this;
+    }
+    return true;
+  }
+
+  rtc::SocketAddress GetLocalAddress() const override {
+    return shared_->socket->GetLocalAddress();
+  }
+  rtc::SocketAddress GetRemoteAddress() const override {
+    return rtc::SocketAddress();
+  }
+  int Send(const void* pv,
+           size_t cb,
+           const rtc::PacketOptions& options) override {
+    return shared_->socket->Send(pv, cb, options);
+  }
+  int SendTo(const void* pv,
+             size_t cb,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options) override {
+    // Replies from |addr| come to the port that sent to it last.
+    MuxedSocket*& owner = shared_->sockets_by_remote_address[addr];
+    if (owner != this) {
+      owner = this;
+      remote_addresses_.push_back(addr);
+    }
+    rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
+                                options.info_signaled_after_sent);
+    CopySocketInformationToPacketInfo(cb, *this, true, &sent_packet.info);
+    int ret = shared_->socket->SendTo(pv, cb, addr, options);
+    SignalSentPacket(this, sent_packet);
+    return ret;
+  }
+  // The shared socket stays open for the other ports.
+  int Close() override { return 0; }
+  State GetState() const override { return shared_->socket->GetState(); }
+  int GetOption(rtc::Socket::Option opt, int* value) override {
+    return shared_->socket->GetOption(opt, value);
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override {
+    return shared_->socket->SetOption(opt, value);
+  }
+  int GetError() const override { return shared_->socket->GetError(); }
+  void SetError(int error) override { shared_->socket->SetError(error); }
+
+ private:
+  UdpSocketMux* const mux_;
+  SharedSocket* const shared_;
+  Port* port_ = nullptr;
+  std::string username_;
+  // Remote addresses claimed by this socket, which may since have been
+  // claimed by others.
+  std::vector<rtc::SocketAddress> remote_addresses_;
+};
+
+UdpSocketMux::UdpSocketMux(rtc::PacketSocketFactory* socket_factory)
+    : socket_factory_(socket_factory) {
+  RTC_DCHECK(socket_factory_);
+}
+
+UdpSocketMux::~UdpSocketMux() {
+  RTC_DCHECK(sockets_by_port_.empty());
+}
+
+std::unique_ptr<UDPPort> UdpSocketMux::CreatePort(
+    rtc::Thread* thread,
+    rtc::Network* network,
+    uint16_t min_port,
+    uint16_t max_port,
+    const std::string& username,
+    const std::string& password,
+    const std::string& origin,
+    bool emit_local_for_anyaddress,
+    absl::optional<int> stun_keepalive_interval) {
+  SharedSocket* shared =
+      GetOrCreateSharedSocket(network->GetBestIP(), min_port, max_port);
+  if (!shared) {
+    return nullptr;
+  }
+  std::unique_ptr<MuxedSocket> socket(new MuxedSocket(this, shared));
+  if (!socket->SetUsername(username)) {
+    RTC_LOG(LS_WARNING) << "UdpSocketMux: ufrag " << username << " is in use";
+    return nullptr;
+  }
+  // The port takes the socket from CreateUdpSocket(), and deletes it.
+  pending_socket_ = socket.get();
+  std::unique_ptr<UDPPort> port = UDPPort::Create(
+      thread, this, network, min_port, max_port, username, password, origin,
+      emit_local_for_anyaddress, stun_keepalive_interval);
+  if (pending_socket_) {
+    pending_socket_ = nullptr;
+    return nullptr;
+  }
+  MuxedSocket* muxed_socket = socket.release();
+  if (port) {
+    muxed_socket->set_port(port.get());
+    sockets_by_port_[port.get()] = muxed_socket;
+  }
+  return port;
+}
+
+void UdpSocketMux::UpdateUsername(Port* port) {
+  auto it = sockets_by_port_.find(port);
+  if (it == sockets_by_port_.end()) {
+    return;
+  }
+  if (!it->second->SetUsername(port->username_fragment())) {
+    RTC_LOG(LS_WARNING) << "UdpSocketMux: ufrag " << port->username_fragment()
+                        << " is in use, keeping the previous one.";
+  }
+}
+
+rtc::AsyncPacketSocket* UdpSocketMux::CreateUdpSocket(
+    const rtc::SocketAddress& address,
+    uint16_t min_port,
+    uint16_t max_port) {
+  if (pending_socket_) {
+    MuxedSocket* socket = pending_socket_;
+    pending_socket_ = nullptr;
+    return socket;
+  }
+  return socket_factory_->CreateUdpSocket(address, min_port, max_port);
+}
+
+rtc::AsyncPacketSocket* UdpSocketMux::CreateServerTcpSocket(
+    const rtc::SocketAddress& local_address,
+    uint16_t min_port,
+    uint16_t max_port,
+    int opts) {
+  return socket_factory_->CreateServerTcpSocket(local_address, min_port,
+                                                max_port, opts);
+}
+
+rtc::AsyncPacketSocket* UdpSocketMux::CreateClientTcpSocket(
+    const rtc::SocketAddress& local_address,
+    const rtc::SocketAddress& remote_address,
+    const rtc::ProxyInfo& proxy_info,
+    const std::string& user_agent,
+    const rtc::PacketSocketTcpOptions& tcp_options) {
+  return socket_factory_->CreateClientTcpSocket(
+      local_address, remote_address, proxy_info, user_agent, tcp_options);
+}
+
+rtc::AsyncResolverInterface* UdpSocketMux::CreateAsyncResolver() {
+  return socket_factory_->CreateAsyncResolver();
+}
+
+UdpSocketMux::SharedSocket* UdpSocketMux::GetOrCreateSharedSocket(
+    const rtc::IPAddress& ip,
+    uint16_t min_port,
+    uint16_t max_port) {
+  auto it = shared_sockets_.find(ip);
+  if (it != shared_sockets_.end()) {
+    return it->second.get();
+  }
+  std::unique_ptr<rtc::AsyncPacketSocket> socket(
+      socket_factory_->CreateUdpSocket(rtc::SocketAddress(ip, 0), min_port,
+                                       max_port));
+  if (!socket) {
+    RTC_LOG(LS_WARNING) << "UdpSocketMux: UDP socket creation failed";
+    return nullptr;
+  }
+  socket->SetPacketReceiver(this);
+  socket->SignalReadyToSend.connect(this, &UdpSocketMux::OnReadyToSend);
+  std::unique_ptr<SharedSocket> shared(new SharedSocket());
+  shared->socket = std::move(socket);
+  SharedSocket* shared_ptr = shared.get();
+  shared_sockets_[ip] = std::move(shared);
+  return shared_ptr;
+}
+
+UdpSocketMux::SharedSocket* UdpSocketMux::FindSharedSocket(
+    rtc::AsyncPacketSocket* socket) {
+  // One socket per local address, so there are only a few.
+  for (auto& entry : shared_sockets_) {
+    if (entry.second->socket.get() == socket) {
+      return entry.second.get();
+    }
+  }
+  return nullptr;
+}
+
+UdpSocketMux::MuxedSocket* UdpSocketMux::FindSocketByUsername(
+    const SharedSocket& shared,
+    const char* data,
+    size_t size) {
+  StunMessageView view;
+  if (!view.Parse(data, size) || view.type() != STUN_BINDING_REQUEST) {
+    return nullptr;
+  }
+  absl::string_view username;
+  if (!view.GetAttribute(STUN_ATTR_USERNAME, &username)) {
+    return nullptr;
+  }
+  // The USERNAME is "<local ufrag>:<remote ufrag>".
+  const absl::string_view local_username =
+      username.substr(0, username.find(':'));
+  auto it = shared.sockets_by_username.find(std::string(local_username));
+  return it != shared.sockets_by_username.end() ? it->second : nullptr;
+}
+
+void UdpSocketMux::OnReadPacket(rtc::AsyncPacketSocket* socket,
+                                const char* data,
+                                size_t size,
+                                const rtc::SocketAddress& remote_addr,
+                                const int64_t& packet_time_us) {
+  SharedSocket* shared = FindSharedSocket(socket);
+  RTC_DCHECK(shared);
+  // Binding requests go by ufrag, since one remote address may talk to
+  // several ports, e.g. if the remote side shares its socket too.
+  MuxedSocket* target = FindSocketByUsername(*shared, data, size);
+  if (!target) {
+    auto it = shared->sockets_by_remote_address.find(remote_addr);
+    if (it == shared->sockets_by_remote_address.end()) {
+      RTC_LOG(LS_VERBOSE) << "UdpSocketMux: dropping packet from unknown "
+                          << remote_addr.ToSensitiveString();
+      return;
+    }
+    target = it->second;
+  }
+  target->DeliverPacket(data, size, remote_addr, packet_time_us);
+}
+
+void UdpSocketMux::OnReadyToSend(rtc::AsyncPacketSocket* socket) {
+  SharedSocket* shared = FindSharedSocket(socket);
+  RTC_DCHECK(shared);
+  for (auto& entry : shared->sockets_by_username) {
+    entry.second->SignalReadyToSend(entry.second);
+  }
+}
+
+}  // namespace cricket
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_UDP_SOCKET_MUX_H_
+#define P2P_BASE_UDP_SOCKET_MUX_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "absl/types/optional.h"
+#include "api/packet_socket_factory.h"
+#include "p2p/base/port.h"
+#include "p2p/base/stun_port.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/network.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+// Lets the host UDP ports of many ICE sessions share one UDP socket per local
+// IP address, so that a server with thousands of sessions does not hold a
+// socket, and its file descriptor and poller registration, per session.
+//
+// Incoming STUN binding requests go to the port whose ICE ufrag is the local
+// part of their USERNAME. All other packets go to the port that last sent to
+// their source address. Ports on a shared socket therefore need distinct
+// ufrags, e.g. one component per session as with RTCP muxing, and only
+// gather host candidates: responses from a STUN server that several ports
+// talk to could not be told apart.
+//
+// Must be used on the network thread, and outlive the ports it creates. The
+// shared sockets stay open until the mux is destroyed.
+class UdpSocketMux : public rtc::PacketSocketFactory,
+                     public rtc::AsyncPacketSocketReceiver,
+                     public sigslot::has_slots<> {
+ public:
+  // |socket_factory| creates the shared sockets, and any other socket.
+  explicit UdpSocketMux(rtc::PacketSocketFactory* socket_factory);
+  ~UdpSocketMux() override;
+
+  // Creates a host UDPPort on |network| that uses the shared socket for the
+  // network's best IP address, creating that socket in the range
+  // [|min_port|, |max_port|] if needed. Returns null if the socket can't be
+  // created, or if a port with the same |username| already shares it.
+  std::unique_ptr<UDPPort> CreatePort(
+      rtc::Thread* thread,
+      rtc::Network* network,
+      uint16_t min_port,
+      uint16_t max_port,
+      const std::string& username,
+      const std::string& password,
+      const std::string& origin,
+      bool emit_local_for_anyaddress,
+      absl::optional<int> stun_keepalive_interval);
+
+  // Must be called after the ICE parameters of a port from CreatePort() have
+  // changed, e.g. when a pooled session is taken. Other ports are ignored.
+  void UpdateUsername(Port* port);
+
+  size_t num_shared_sockets() const { return shared_sockets_.size(); }
+
+  // rtc::PacketSocketFactory implementation. The ports use the mux as their
+  // socket factory; all sockets other than their own come from
+  // |socket_factory|.
+  rtc::AsyncPacketSocket* CreateUdpSocket(const rtc::SocketAddress& address,
+                                          uint16_t min_port,
+                                          uint16_t max_port) override;
+  rtc::AsyncPacketSocket* CreateServerTcpSocket(
+      const rtc::SocketAddress& local_address,
+      uint16_t min_port,
+      uint16_t max_port,
+      int opts) override;
+  rtc::AsyncPacketSocket* CreateClientTcpSocket(
+      const rtc::SocketAddress& local_address,
+      const rtc::SocketAddress& remote_address,
+      const rtc::ProxyInfo& proxy_info,
+      const std::string& user_agent,
+      const rtc::PacketSocketTcpOptions& tcp_options) override;
+  rtc::AsyncResolverInterface* CreateAsyncResolver() override;
+
+ private:
+  class MuxedSocket;
+
+  struct SharedSocket {
+    std::unique_ptr<rtc::AsyncPacketSocket> socket;
+    std::map<std::string, MuxedSocket*> sockets_by_username;
+    std::map<rtc::SocketAddress, MuxedSocket*> sockets_by_remote_address;
+  };
+
+  SharedSocket* GetOrCreateSharedSocket(const rtc::IPAddress& ip,
+                                        uint16_t min_port,
+                                        uint16_t max_port);
+  SharedSocket* FindSharedSocket(rtc::AsyncPacketSocket* socket);
+  // Returns the socket that receives a STUN binding request for one of the
+  // ports, or null if the packet is something else.
+  MuxedSocket* FindSocketByUsername(const SharedSocket& shared,
+                                    const char* data,
+                                    size_t size);
+  // rtc::AsyncPacketSocketReceiver implementation.
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) override;
+  void OnReadyToSend(rtc::AsyncPacketSocket* socket);
+
+  rtc::PacketSocketFactory* const socket_factory_;
+  std::map<rtc::IPAddress, std::unique_ptr<SharedSocket>> shared_sockets_;
+  // Ports from CreatePort(), by the port.
+  std::map<Port*, MuxedSocket*> sockets_by_port_;
+  // The socket that CreateUdpSocket() hands out while CreatePort() runs.
+  MuxedSocket* pending_socket_ = nullptr;
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_UDP_SOCKET_MUX_H_
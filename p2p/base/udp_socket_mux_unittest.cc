@@ -0,0 +1,162 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/udp_socket_mux.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/stun.h"
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/virtual_socket_server.h"
+
+namespace cricket {
+namespace {
+
+const rtc::SocketAddress kLocalAddr("11.11.11.11", 0);
+const rtc::SocketAddress kRemoteAddr("22.22.22.22", 0);
+
+class UdpSocketMuxTest : public ::testing::Test, public sigslot::has_slots<> {
+ public:
+  UdpSocketMuxTest()
+      : vss_(new rtc::VirtualSocketServer()),
+        thread_(vss_.get()),
+        network_("unittest", "unittest", kLocalAddr.ipaddr(), 32),
+        socket_factory_(rtc::Thread::Current()),
+        mux_(&socket_factory_) {
+    network_.AddIP(kLocalAddr.ipaddr());
+    remote_socket_.reset(socket_factory_.CreateUdpSocket(kRemoteAddr, 0, 0));
+    remote_socket_->SignalReadPacket.connect(
+        this, &UdpSocketMuxTest::OnRemoteReadPacket);
+  }
+
+  std::unique_ptr<UDPPort> CreatePort(const std::string& ufrag) {
+    std::unique_ptr<UDPPort> port = mux_.CreatePort(
+        rtc::Thread::Current(), &network_, 0, 0, ufrag,
+        rtc::CreateRandomString(22), std::string(), false, absl::nullopt);
+    if (port) {
+      port->EnablePortPackets();
+      port->SignalReadPacket.connect(this, &UdpSocketMuxTest::OnPortPacket);
+      port->PrepareAddress();
+    }
+    return port;
+  }
+
+  // Sends a binding request for |local_ufrag| from the remote socket.
+  void SendBindingRequest(const std::string& local_ufrag,
+                          const rtc::SocketAddress& addr) {
+    IceMessage request;
+    request.SetType(STUN_BINDING_REQUEST);
+    request.SetTransactionID(rtc::CreateRandomString(kStunTransactionIdLength));
+    request.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, local_ufrag + ":rfrag"));
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    remote_socket_->SendTo(buf.Data(), buf.Length(), addr,
+                           rtc::PacketOptions());
+  }
+
+  void SendFromRemote(const std::string& data,
+                      const rtc::SocketAddress& addr) {
+    remote_socket_->SendTo(data.data(), data.size(), addr,
+                           rtc::PacketOptions());
+  }
+
+  void OnPortPacket(PortInterface* port,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr) {
+    received_by_.push_back(port);
+  }
+
+  void OnRemoteReadPacket(rtc::AsyncPacketSocket* socket,
+                          const char* data,
+                          size_t size,
+                          const rtc::SocketAddress& remote_addr,
+                          const int64_t& /* packet_time_us */) {
+    remote_received_.push_back(std::string(data, size));
+  }
+
+ protected:
+  std::unique_ptr<rtc::VirtualSocketServer> vss_;
+  rtc::AutoSocketServerThread thread_;
+  rtc::Network network_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  UdpSocketMux mux_;
+  std::unique_ptr<rtc::AsyncPacketSocket> remote_socket_;
+  std::vector<PortInterface*> received_by_;
+  std::vector<std::string> remote_received_;
+};
+
+TEST_F(UdpSocketMuxTest, PortsShareOneSocket) {
+  std::unique_ptr<UDPPort> port1 = CreatePort("ufrag1");
+  std::unique_ptr<UDPPort> port2 = CreatePort("ufrag2");
+  ASSERT_TRUE(port1);
+  ASSERT_TRUE(port2);
+  EXPECT_EQ(1u, mux_.num_shared_sockets());
+  ASSERT_EQ(1u, port1->Candidates().size());
+  ASSERT_EQ(1u, port2->Candidates().size());
+  EXPECT_EQ(port1->Candidates()[0].address(),
+            port2->Candidates()[0].address());
+  // A second port with the same ufrag can't share the socket.
+  EXPECT_FALSE(CreatePort("ufrag1"));
+}
+
+TEST_F(UdpSocketMuxTest, DemultiplexesBindingRequestsByUfrag) {
+  std::unique_ptr<UDPPort> port1 = CreatePort("ufrag1");
+  std::unique_ptr<UDPPort> port2 = CreatePort("ufrag2");
+  ASSERT_TRUE(port1);
+  ASSERT_TRUE(port2);
+  const rtc::SocketAddress local_addr = port1->GetLocalAddress();
+
+  SendBindingRequest("ufrag2", local_addr);
+  SendBindingRequest("ufrag1", local_addr);
+  SendBindingRequest("unknown", local_addr);
+  rtc::Thread::Current()->ProcessMessages(0);
+  EXPECT_EQ((std::vector<PortInterface*>{port2.get(), port1.get()}),
+            received_by_);
+}
+
+TEST_F(UdpSocketMuxTest, DemultiplexesOtherPacketsBySourceAddress) {
+  std::unique_ptr<UDPPort> port1 = CreatePort("ufrag1");
+  std::unique_ptr<UDPPort> port2 = CreatePort("ufrag2");
+  ASSERT_TRUE(port1);
+  ASSERT_TRUE(port2);
+  const rtc::SocketAddress local_addr = port1->GetLocalAddress();
+  const rtc::SocketAddress remote_addr = remote_socket_->GetLocalAddress();
+
+  // Dropped until a port has sent to the remote address.
+  SendFromRemote("a", local_addr);
+  rtc::Thread::Current()->ProcessMessages(0);
+  EXPECT_TRUE(received_by_.empty());
+
+  const std::string data = "hello";
+  PortInterface* sender = port2.get();
+  sender->SendTo(data.data(), data.size(), remote_addr, rtc::PacketOptions(),
+                 true);
+  rtc::Thread::Current()->ProcessMessages(0);
+  EXPECT_EQ(std::vector<std::string>{data}, remote_received_);
+  SendFromRemote("b", local_addr);
+  rtc::Thread::Current()->ProcessMessages(0);
+  EXPECT_EQ(std::vector<PortInterface*>{port2.get()}, received_by_);
+
+  // Dropped again once that port is gone.
+  port2.reset();
+  SendFromRemote("c", local_addr);
+  rtc::Thread::Current()->ProcessMessages(0);
+  EXPECT_EQ(1u, received_by_.size());
+}
+
+}  // namespace
+}  // namespace cricket
@@ -598,9 +598,13 @@ void BasicPortAllocatorSession::OnMessage(rtc::Message* message) {
 
 void BasicPortAllocatorSession::UpdateIceParametersInternal() {
   RTC_DCHECK_RUN_ON(network_thread_);
+  UdpSocketMux* udp_socket_mux = allocator_->udp_socket_mux();
   for (PortData& port : ports_) {
     port.port()->set_content_name(content_name());
     port.port()->SetIceParameters(component(), ice_ufrag(), ice_pwd());
+    if (udp_socket_mux) {
+      udp_socket_mux->UpdateUsername(port.port());
+    }
   }
 }
 
@@ -1238,8 +1242,7 @@ void AllocationSequence::Init() {
         rtc::SocketAddress(network_->GetBestIP(), 0),
         session_->allocator()->min_port(), session_->allocator()->max_port()));
     if (udp_socket_) {
-      udp_socket_->SignalReadPacket.connect(this,
-                                            &AllocationSequence::OnReadPacket);
+      udp_socket_->SetPacketReceiver(this);
     }
     // Continuing if |udp_socket_| is NULL, as local TCP and RelayPort using TCP
     // are next available options to setup a communication channel.
@@ -1381,9 +1384,16 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
 
   if (state() == kRunning) {
     ++phase_;
-    session_->network_thread()->PostDelayed(RTC_FROM_HERE,
-                                            session_->allocator()->step_delay(),
-                                            this, MSG_ALLOCATION_PHASE);
+    if (IsFlagSet(PORTALLOCATOR_ENABLE_FAST_GATHERING)) {
+      // Queued behind the current phase of the other sequences, which are
+      // started together, so that the phases run in order across networks.
+      session_->network_thread()->Post(RTC_FROM_HERE, this,
+                                       MSG_ALLOCATION_PHASE);
+    } else {
+      session_->network_thread()->PostDelayed(
+          RTC_FROM_HERE, session_->allocator()->step_delay(), this,
+          MSG_ALLOCATION_PHASE);
+    }
   } else {
     // If all phases in AllocationSequence are completed, no allocation
     // steps needed further. Canceling  pending signal.
@@ -1403,6 +1413,20 @@ void AllocationSequence::CreateUDPPorts() {
   std::unique_ptr<UDPPort> port;
   bool emit_local_candidate_for_anyaddress =
       !IsFlagSet(PORTALLOCATOR_DISABLE_DEFAULT_LOCAL_CANDIDATE);
+  UdpSocketMux* udp_socket_mux = session_->allocator()->udp_socket_mux();
+  if (udp_socket_mux) {
+    port = udp_socket_mux->CreatePort(
+        session_->network_thread(), network_,
+        session_->allocator()->min_port(), session_->allocator()->max_port(),
+        session_->username(), session_->password(),
+        session_->allocator()->origin(), emit_local_candidate_for_anyaddress,
+        session_->allocator()->stun_candidate_keepalive_interval());
+    if (port) {
+      session_->AddAllocatedPort(port.release(), this, true);
+      return;
+    }
+    // Fall back to a port of its own, e.g. if the ufrag is in use.
+  }
   if (IsFlagSet(PORTALLOCATOR_ENABLE_SHARED_SOCKET) && udp_socket_) {
     port = UDPPort::Create(
         session_->network_thread(), session_->socket_factory(), network_,
@@ -17,8 +17,10 @@
 
 #include "api/turn_customizer.h"
 #include "p2p/base/port_allocator.h"
+#include "p2p/base/udp_socket_mux.h"
 #include "p2p/client/relay_port_factory_interface.h"
 #include "p2p/client/turn_port_factory.h"
+#include "rtc_base/async_packet_socket.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/network.h"
 #include "rtc_base/system/rtc_export.h"
@@ -75,6 +77,18 @@ class RTC_EXPORT BasicPortAllocator : public PortAllocator {
     return relay_port_factory_;
   }
 
+  // If set, the host UDP ports of all sessions share the sockets of
+  // |udp_socket_mux|, and gather no STUN candidates on them. Must outlive
+  // the sessions. Null by default.
+  void set_udp_socket_mux(UdpSocketMux* udp_socket_mux) {
+    CheckRunOnValidThreadIfInitialized();
+    udp_socket_mux_ = udp_socket_mux;
+  }
+  UdpSocketMux* udp_socket_mux() {
+    CheckRunOnValidThreadIfInitialized();
+    return udp_socket_mux_;
+  }
+
  private:
   void OnIceRegathering(PortAllocatorSession* session,
                         IceRegatheringReason reason);
@@ -93,6 +107,8 @@ class RTC_EXPORT BasicPortAllocator : public PortAllocator {
 
   // This instance is created if caller does pass a factory.
   std::unique_ptr<RelayPortFactoryInterface> default_relay_port_factory_;
+
+  UdpSocketMux* udp_socket_mux_ = nullptr;
 };
 
 struct PortConfiguration;
@@ -324,6 +340,7 @@ class TurnPort;
 // Performs the allocation of ports, in a sequenced (timed) manner, for a given
 // network and IP address.
 class AllocationSequence : public rtc::MessageHandler,
+                           public rtc::AsyncPacketSocketReceiver,
                            public sigslot::has_slots<> {
  public:
   enum State {
@@ -384,11 +401,12 @@ class AllocationSequence : public rtc::MessageHandler,
   void CreateStunPorts();
   void CreateRelayPorts();
 
+  // rtc::AsyncPacketSocketReceiver implementation.
   void OnReadPacket(rtc::AsyncPacketSocket* socket,
                     const char* data,
                     size_t size,
                     const rtc::SocketAddress& remote_addr,
-                    const int64_t& packet_time_us);
+                    const int64_t& packet_time_us) override;
 
   void OnPortDestroyed(PortInterface* port);
 
@@ -1153,6 +1153,23 @@ TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Test that fast gathering does not wait for the step delay between phases.
+TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithFastGathering) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_FAST_GATHERING);
+  ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  // Less than one step delay.
+  ASSERT_TRUE_SIMULATED_WAIT(candidate_allocation_done_, 500, fake_clock);
+  EXPECT_EQ(3U, candidates_.size());
+  EXPECT_EQ(3U, ports_.size());
+  EXPECT_TRUE(HasCandidate(candidates_, "local", "udp", kClientAddr));
+  EXPECT_TRUE(HasCandidate(candidates_, "stun", "udp", kClientAddr));
+  EXPECT_TRUE(HasCandidate(candidates_, "local", "tcp", kClientAddr));
+}
+
 TEST_F(BasicPortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP, CN_VIDEO));
@@ -480,12 +480,14 @@ void BaseChannel::OnRtpPacket(const webrtc::RtpPacketReceived& parsed_packet) {
     return;
   }
 
-  auto packet_buffer = parsed_packet.Buffer();
-
+  // Move the buffer along instead of copying the reference, so that the
+  // closure doesn't keep the packet alive after delivery.
   invoker_.AsyncInvoke<void>(
-      RTC_FROM_HERE, worker_thread_, [this, packet_buffer, packet_time_us] {
+      RTC_FROM_HERE, worker_thread_,
+      [this, packet_buffer = parsed_packet.Buffer(), packet_time_us]() mutable {
         RTC_DCHECK(worker_thread_->IsCurrent());
-        media_channel_->OnPacketReceived(packet_buffer, packet_time_us);
+        media_channel_->OnPacketReceived(std::move(packet_buffer),
+                                         packet_time_us);
       });
 }
 
@@ -251,6 +251,10 @@ uint64_t DataChannel::buffered_amount() const {
   return buffered_amount_;
 }
 
+void DataChannel::SetBufferedAmountLowThreshold(uint64_t threshold) {
+  buffered_amount_low_threshold_ = threshold;
+}
+
 void DataChannel::Close() {
   if (state_ == kClosed)
     return;
@@ -395,11 +399,37 @@ void DataChannel::SetSendSsrc(uint32_t send_ssrc) {
 
 void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
                                  const rtc::CopyOnWriteBuffer& payload) {
+  std::unique_ptr<DataBuffer> buffer = ReceiveDataMessage(params, payload);
+  if (buffer) {
+    observer_->OnMessage(*buffer);
+  }
+}
+
+void DataChannel::OnDataReceivedBatch(
+    const std::vector<ReceivedDataMessage>& messages) {
+  std::vector<DataBuffer> buffers;
+  for (const ReceivedDataMessage& message : messages) {
+    std::unique_ptr<DataBuffer> buffer =
+        ReceiveDataMessage(message.params, message.payload);
+    if (buffer) {
+      buffers.push_back(std::move(*buffer));
+    }
+  }
+  // The observer may have been unregistered if the channel was closed while
+  // handling the batch.
+  if (observer_ && !buffers.empty()) {
+    observer_->OnMessages(buffers);
+  }
+}
+
+std::unique_ptr<DataBuffer> DataChannel::ReceiveDataMessage(
+    const cricket::ReceiveDataParams& params,
+    const rtc::CopyOnWriteBuffer& payload) {
   if (data_channel_type_ == cricket::DCT_RTP && params.ssrc != receive_ssrc_) {
-    return;
+    return nullptr;
   }
   if (IsSctpLike(data_channel_type_) && params.sid != config_.id) {
-    return;
+    return nullptr;
   }
 
   if (params.type == cricket::DMT_CONTROL) {
@@ -409,7 +439,7 @@ void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
       RTC_LOG(LS_WARNING)
           << "DataChannel received unexpected CONTROL message, sid = "
           << params.sid;
-      return;
+      return nullptr;
     }
     if (ParseDataChannelOpenAckMessage(payload)) {
       // We can send unordered as soon as we receive the ACK message.
@@ -421,7 +451,7 @@ void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
           << "DataChannel failed to parse OPEN_ACK message, sid = "
           << params.sid;
     }
-    return;
+    return nullptr;
   }
 
   RTC_DCHECK(params.type == cricket::DMT_BINARY ||
@@ -441,7 +471,7 @@ void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
   if (state_ == kOpen && observer_) {
     ++messages_received_;
     bytes_received_ += buffer->size();
-    observer_->OnMessage(*buffer.get());
+    return buffer;
   } else {
     if (queued_received_data_.byte_count() + payload.size() >
         kMaxQueuedReceivedDataBytes) {
@@ -454,10 +484,11 @@ void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
                      "Queued received data exceeds the max buffer size."));
       }
 
-      return;
+      return nullptr;
     }
     queued_received_data_.PushBack(std::move(buffer));
   }
+  return nullptr;
 }
 
 void DataChannel::OnChannelReady(bool writable) {
@@ -595,11 +626,15 @@ void DataChannel::DeliverQueuedReceivedData() {
     return;
   }
 
+  std::vector<DataBuffer> buffers;
   while (!queued_received_data_.Empty()) {
     std::unique_ptr<DataBuffer> buffer = queued_received_data_.PopFront();
     ++messages_received_;
     bytes_received_ += buffer->size();
-    observer_->OnMessage(*buffer);
+    buffers.push_back(std::move(*buffer));
+  }
+  if (!buffers.empty()) {
+    observer_->OnMessages(buffers);
   }
 }
 
@@ -652,10 +687,16 @@ bool DataChannel::SendDataMessage(const DataBuffer& buffer,
     bytes_sent_ += buffer.size();
 
     RTC_DCHECK(buffered_amount_ >= buffer.size());
+    const bool was_above_threshold =
+        buffered_amount_ > buffered_amount_low_threshold_;
     buffered_amount_ -= buffer.size();
     if (observer_ && buffer.size() > 0) {
       observer_->OnBufferedAmountChange(buffer.size());
     }
+    if (observer_ && was_above_threshold &&
+        buffered_amount_ <= buffered_amount_low_threshold_) {
+      observer_->OnBufferedAmountLow();
+    }
     return true;
   }
 
@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "api/data_channel_interface.h"
 #include "api/priority.h"
@@ -62,6 +63,13 @@ struct InternalDataChannelInit : public DataChannelInit {
   OpenHandshakeRole open_handshake_role;
 };
 
+// A data message received from the data channel transport, as delivered to
+// the DataChannels in batches.
+struct ReceivedDataMessage {
+  cricket::ReceiveDataParams params;
+  rtc::CopyOnWriteBuffer payload;
+};
+
 // Helper class to allocate unique IDs for SCTP DataChannels
 class SctpSidAllocator {
  public:
@@ -148,6 +156,10 @@ class DataChannel : public DataChannelInterface, public sigslot::has_slots<> {
   }
   virtual int internal_id() const { return internal_id_; }
   virtual uint64_t buffered_amount() const;
+  virtual uint64_t buffered_amount_low_threshold() const {
+    return buffered_amount_low_threshold_;
+  }
+  virtual void SetBufferedAmountLowThreshold(uint64_t threshold);
   virtual void Close();
   virtual DataState state() const { return state_; }
   virtual RTCError error() const;
@@ -176,6 +188,9 @@ class DataChannel : public DataChannelInterface, public sigslot::has_slots<> {
   // Slots for provider to connect signals to.
   void OnDataReceived(const cricket::ReceiveDataParams& params,
                       const rtc::CopyOnWriteBuffer& payload);
+  // Like OnDataReceived, but the messages for this channel are delivered to
+  // the observer with a single OnMessages call.
+  void OnDataReceivedBatch(const std::vector<ReceivedDataMessage>& messages);
 
   /********************************************
    * The following methods are for SCTP only. *
@@ -271,6 +286,12 @@ class DataChannel : public DataChannelInterface, public sigslot::has_slots<> {
   void SetState(DataState state);
   void DisconnectFromProvider();
 
+  // Handles a received message, and returns the data buffer that should be
+  // delivered to the observer, if any. Otherwise, the message is either
+  // consumed or queued.
+  std::unique_ptr<DataBuffer> ReceiveDataMessage(
+      const cricket::ReceiveDataParams& params,
+      const rtc::CopyOnWriteBuffer& payload);
   void DeliverQueuedReceivedData();
 
   void SendQueuedDataMessages();
@@ -294,6 +315,7 @@ class DataChannel : public DataChannelInterface, public sigslot::has_slots<> {
   // Number of bytes of data that have been queued using Send(). Increased
   // before each transport send and decreased after each successful send.
   uint64_t buffered_amount_;
+  uint64_t buffered_amount_low_threshold_ = 0;
   cricket::DataChannelType data_channel_type_;
   DataChannelProviderInterface* provider_;
   HandshakeState handshake_state_;
@@ -336,6 +358,8 @@ PROXY_CONSTMETHOD0(uint64_t, bytes_sent)
 PROXY_CONSTMETHOD0(uint32_t, messages_received)
 PROXY_CONSTMETHOD0(uint64_t, bytes_received)
 PROXY_CONSTMETHOD0(uint64_t, buffered_amount)
+PROXY_CONSTMETHOD0(uint64_t, buffered_amount_low_threshold)
+PROXY_METHOD1(void, SetBufferedAmountLowThreshold, uint64_t)
 PROXY_METHOD0(void, Close)
 PROXY_METHOD1(bool, Send, const DataBuffer&)
 END_PROXY_MAP()
@@ -73,7 +73,7 @@ bool DataChannelController::ConnectDataChannel(
     SignalDataChannelTransportWritable_s.connect(webrtc_data_channel,
                                                  &DataChannel::OnChannelReady);
     SignalDataChannelTransportReceivedData_s.connect(
-        webrtc_data_channel, &DataChannel::OnDataReceived);
+        webrtc_data_channel, &DataChannel::OnDataReceivedBatch);
     SignalDataChannelTransportChannelClosing_s.connect(
         webrtc_data_channel, &DataChannel::OnClosingProcedureStartedRemotely);
     SignalDataChannelTransportChannelClosed_s.connect(
@@ -143,17 +143,28 @@ void DataChannelController::OnDataReceived(
   cricket::ReceiveDataParams params;
   params.sid = channel_id;
   params.type = ToCricketDataMessageType(type);
-  data_channel_transport_invoker_->AsyncInvoke<void>(
-      RTC_FROM_HERE, signaling_thread(), [this, params, buffer] {
-        RTC_DCHECK_RUN_ON(signaling_thread());
-        if (!HandleOpenMessage_s(params, buffer)) {
-          SignalDataChannelTransportReceivedData_s(params, buffer);
-        }
-      });
+  bool new_batch;
+  {
+    rtc::CritScope lock(&received_data_crit_);
+    new_batch = received_data_batches_.empty() || received_data_batch_closed_;
+    if (new_batch) {
+      received_data_batches_.emplace_back();
+      received_data_batch_closed_ = false;
+    }
+    received_data_batches_.back().push_back({params, buffer});
+  }
+  if (new_batch) {
+    data_channel_transport_invoker_->AsyncInvoke<void>(
+        RTC_FROM_HERE, signaling_thread(), [this] {
+          RTC_DCHECK_RUN_ON(signaling_thread());
+          DeliverReceivedDataBatch_s();
+        });
+  }
 }
 
 void DataChannelController::OnChannelClosing(int channel_id) {
   RTC_DCHECK_RUN_ON(network_thread());
+  CloseReceivedDataBatch_n();
   data_channel_transport_invoker_->AsyncInvoke<void>(
       RTC_FROM_HERE, signaling_thread(), [this, channel_id] {
         RTC_DCHECK_RUN_ON(signaling_thread());
@@ -163,6 +174,7 @@ void DataChannelController::OnChannelClosing(int channel_id) {
 
 void DataChannelController::OnChannelClosed(int channel_id) {
   RTC_DCHECK_RUN_ON(network_thread());
+  CloseReceivedDataBatch_n();
   data_channel_transport_invoker_->AsyncInvoke<void>(
       RTC_FROM_HERE, signaling_thread(), [this, channel_id] {
         RTC_DCHECK_RUN_ON(signaling_thread());
@@ -172,6 +184,7 @@ void DataChannelController::OnChannelClosed(int channel_id) {
 
 void DataChannelController::OnReadyToSend() {
   RTC_DCHECK_RUN_ON(network_thread());
+  CloseReceivedDataBatch_n();
   data_channel_transport_invoker_->AsyncInvoke<void>(
       RTC_FROM_HERE, signaling_thread(), [this] {
         RTC_DCHECK_RUN_ON(signaling_thread());
@@ -183,6 +196,7 @@ void DataChannelController::OnReadyToSend() {
 
 void DataChannelController::OnTransportClosed() {
   RTC_DCHECK_RUN_ON(network_thread());
+  CloseReceivedDataBatch_n();
   data_channel_transport_invoker_->AsyncInvoke<void>(
       RTC_FROM_HERE, signaling_thread(), [this] {
         RTC_DCHECK_RUN_ON(signaling_thread());
@@ -198,6 +212,12 @@ void DataChannelController::SetupDataChannelTransport_n() {
 void DataChannelController::TeardownDataChannelTransport_n() {
   RTC_DCHECK_RUN_ON(network_thread());
   data_channel_transport_invoker_ = nullptr;
+  {
+    // The tasks that would have delivered these batches were cancelled with
+    // the invoker.
+    rtc::CritScope lock(&received_data_crit_);
+    received_data_batches_.clear();
+  }
   if (data_channel_transport()) {
     data_channel_transport()->SetDataSink(nullptr);
   }
@@ -215,6 +235,7 @@ void DataChannelController::OnTransportChanged(
     set_data_channel_transport(new_data_channel_transport);
     if (new_data_channel_transport) {
       new_data_channel_transport->SetDataSink(this);
+      CloseReceivedDataBatch_n();
 
       // There's a new data channel transport.  This needs to be signaled to the
       // |sctp_data_channels_| so that they can reopen and reconnect.  This is
@@ -230,6 +251,41 @@ void DataChannelController::OnTransportChanged(
   }
 }
 
+void DataChannelController::DeliverReceivedDataBatch_s() {
+  std::vector<ReceivedDataMessage> batch;
+  {
+    rtc::CritScope lock(&received_data_crit_);
+    // Empty if the batches were cleared by a transport teardown.
+    if (received_data_batches_.empty()) {
+      return;
+    }
+    batch = std::move(received_data_batches_.front());
+    received_data_batches_.pop_front();
+  }
+  std::vector<ReceivedDataMessage> messages;
+  for (ReceivedDataMessage& message : batch) {
+    if (message.params.type == cricket::DMT_CONTROL &&
+        IsOpenMessage(message.payload)) {
+      // Deliver the messages before the OPEN message first, so that the data
+      // channel created for it doesn't receive them.
+      if (!messages.empty()) {
+        SignalDataChannelTransportReceivedData_s(messages);
+        messages.clear();
+      }
+      HandleOpenMessage_s(message.params, message.payload);
+      continue;
+    }
+    messages.push_back(std::move(message));
+  }
+  if (!messages.empty()) {
+    SignalDataChannelTransportReceivedData_s(messages);
+  }
+}
+
+void DataChannelController::CloseReceivedDataBatch_n() {
+  received_data_batch_closed_ = true;
+}
+
 bool DataChannelController::HandleOpenMessage_s(
     const cricket::ReceiveDataParams& params,
     const rtc::CopyOnWriteBuffer& buffer) {
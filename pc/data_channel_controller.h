@@ -11,6 +11,7 @@
 #ifndef PC_DATA_CHANNEL_CONTROLLER_H_
 #define PC_DATA_CHANNEL_CONTROLLER_H_
 
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -18,6 +19,7 @@
 
 #include "pc/channel.h"
 #include "pc/data_channel.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/weak_ptr.h"
 
 namespace webrtc {
@@ -133,6 +135,11 @@ class DataChannelController : public DataChannelProviderInterface,
   bool HandleOpenMessage_s(const cricket::ReceiveDataParams& params,
                            const rtc::CopyOnWriteBuffer& buffer)
       RTC_RUN_ON(signaling_thread());
+  // Delivers the oldest batch of received messages to the data channels.
+  void DeliverReceivedDataBatch_s() RTC_RUN_ON(signaling_thread());
+  // Closes the batch of received messages being filled, before another data
+  // channel transport event is posted to the signaling thread.
+  void CloseReceivedDataBatch_n() RTC_RUN_ON(network_thread());
   // Called when a valid data channel OPEN message is received.
   void OnDataChannelOpenMessage(const std::string& label,
                                 const InternalDataChannelInit& config)
@@ -191,8 +198,7 @@ class DataChannelController : public DataChannelProviderInterface,
   // signaling thread.
   sigslot::signal1<bool> SignalDataChannelTransportWritable_s
       RTC_GUARDED_BY(signaling_thread());
-  sigslot::signal2<const cricket::ReceiveDataParams&,
-                   const rtc::CopyOnWriteBuffer&>
+  sigslot::signal1<const std::vector<ReceivedDataMessage>&>
       SignalDataChannelTransportReceivedData_s
           RTC_GUARDED_BY(signaling_thread());
   sigslot::signal1<int> SignalDataChannelTransportChannelClosing_s
@@ -207,6 +213,15 @@ class DataChannelController : public DataChannelProviderInterface,
   std::unique_ptr<rtc::AsyncInvoker> data_channel_transport_invoker_
       RTC_GUARDED_BY(network_thread());
 
+  // Messages received from |data_channel_transport_| are delivered to the
+  // signaling thread in batches, with one task per batch rather than one per
+  // message. A batch is closed when another data channel transport event is
+  // posted, so that the order of messages and events is kept.
+  rtc::CriticalSection received_data_crit_;
+  std::deque<std::vector<ReceivedDataMessage>> received_data_batches_
+      RTC_GUARDED_BY(received_data_crit_);
+  bool received_data_batch_closed_ RTC_GUARDED_BY(network_thread()) = false;
+
   // Owning PeerConnection.
   PeerConnection* const pc_;
   rtc::WeakPtrFactory<DataChannelController> weak_factory_{this};
@@ -39,10 +39,19 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     ++on_buffered_amount_change_count_;
   }
 
+  void OnBufferedAmountLow() override { ++on_buffered_amount_low_count_; }
+
   void OnMessage(const webrtc::DataBuffer& buffer) { ++messages_received_; }
 
+  void OnMessages(rtc::ArrayView<const webrtc::DataBuffer> buffers) override {
+    ++on_messages_count_;
+    DataChannelObserver::OnMessages(buffers);
+  }
+
   size_t messages_received() const { return messages_received_; }
 
+  size_t on_messages_count() const { return on_messages_count_; }
+
   void ResetOnStateChangeCount() { on_state_change_count_ = 0; }
 
   void ResetOnBufferedAmountChangeCount() {
@@ -55,10 +64,16 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     return on_buffered_amount_change_count_;
   }
 
+  size_t on_buffered_amount_low_count() const {
+    return on_buffered_amount_low_count_;
+  }
+
  private:
   size_t messages_received_;
+  size_t on_messages_count_ = 0;
   size_t on_state_change_count_;
   size_t on_buffered_amount_change_count_;
+  size_t on_buffered_amount_low_count_ = 0;
 };
 
 // TODO(deadbeef): The fact that these tests use a fake provider makes them not
@@ -190,6 +205,32 @@ TEST_F(SctpDataChannelTest, BufferedAmountWhenBlocked) {
             observer_->on_buffered_amount_change_count());
 }
 
+// Tests that OnBufferedAmountLow is called once when buffered_amount() drops
+// from above the threshold to at or below it.
+TEST_F(SctpDataChannelTest, BufferedAmountLowWhenDrainedBelowThreshold) {
+  AddObserver();
+  SetChannelReady();
+  webrtc::DataBuffer buffer("abcd");
+  webrtc_data_channel_->SetBufferedAmountLowThreshold(buffer.size());
+  EXPECT_EQ(buffer.size(),
+            webrtc_data_channel_->buffered_amount_low_threshold());
+
+  // Never above the threshold.
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  EXPECT_EQ(0U, observer_->on_buffered_amount_low_count());
+
+  provider_->set_send_blocked(true);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  }
+  EXPECT_EQ(0U, observer_->on_buffered_amount_low_count());
+
+  provider_->set_send_blocked(false);
+  SetChannelReady();
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+}
+
 // Tests that the queued data are sent when the channel transitions from blocked
 // to unblocked.
 TEST_F(SctpDataChannelTest, QueuedDataSentWhenUnblocked) {
@@ -502,6 +543,30 @@ TEST_F(SctpDataChannelTest, VerifyMessagesAndBytesReceived) {
   EXPECT_EQ(bytes_received, webrtc_data_channel_->bytes_received());
 }
 
+// Tests that a batch of received messages, and the messages received before
+// the channel was open, are each delivered with a single OnMessages call.
+TEST_F(SctpDataChannelTest, ReceivedMessagesDeliveredInBatches) {
+  AddObserver();
+  webrtc_data_channel_->SetSctpSid(1);
+  cricket::ReceiveDataParams params;
+  params.ssrc = 1;
+  webrtc::DataBuffer buffer("message");
+
+  webrtc_data_channel_->OnDataReceived(params, buffer.data);
+  webrtc_data_channel_->OnDataReceived(params, buffer.data);
+  SetChannelReady();
+  EXPECT_EQ(2U, observer_->messages_received());
+  EXPECT_EQ(1U, observer_->on_messages_count());
+
+  std::vector<webrtc::ReceivedDataMessage> messages(3, {params, buffer.data});
+  // Messages for other channels are ignored.
+  messages[1].params.ssrc = 2;
+  webrtc_data_channel_->OnDataReceivedBatch(messages);
+  EXPECT_EQ(4U, observer_->messages_received());
+  EXPECT_EQ(2U, observer_->on_messages_count());
+  EXPECT_EQ(4U, webrtc_data_channel_->messages_received());
+}
+
 // Tests that OPEN_ACK message is sent if the datachannel is created from an
 // OPEN message.
 TEST_F(SctpDataChannelTest, OpenAckSentIfCreatedFromOpenMessage) {
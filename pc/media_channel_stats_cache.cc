@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "pc/media_channel_stats_cache.h"
+
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+
+namespace {
+
+// Returns the channels of |stats| that are missing from |cached_stats|.
+template <typename ChannelT, typename InfoT>
+std::vector<ChannelT*> FindUncachedChannels(
+    const std::map<ChannelT*, std::unique_ptr<InfoT>>& stats,
+    const std::map<ChannelT*, std::unique_ptr<InfoT>>& cached_stats) {
+  std::vector<ChannelT*> channels;
+  for (const auto& entry : stats) {
+    if (cached_stats.find(entry.first) == cached_stats.end())
+      channels.push_back(entry.first);
+  }
+  return channels;
+}
+
+template <typename ChannelT, typename InfoT>
+void GetStatsOnWorkerThread(
+    const std::vector<ChannelT*>& channels,
+    std::map<ChannelT*, std::unique_ptr<InfoT>>* cached_stats) {
+  for (ChannelT* channel : channels) {
+    auto info = std::make_unique<InfoT>();
+    if (!channel->GetStats(info.get())) {
+      RTC_LOG(LS_WARNING) << "Failed to get media channel stats.";
+      info = nullptr;
+    }
+    (*cached_stats)[channel] = std::move(info);
+  }
+}
+
+template <typename ChannelT, typename InfoT>
+void CopyCachedStats(
+    const std::map<ChannelT*, std::unique_ptr<InfoT>>& cached_stats,
+    std::map<ChannelT*, std::unique_ptr<InfoT>>* stats) {
+  for (auto& entry : *stats) {
+    const std::unique_ptr<InfoT>& info = cached_stats.at(entry.first);
+    entry.second = info ? std::make_unique<InfoT>(*info) : nullptr;
+  }
+}
+
+}  // namespace
+
+MediaChannelStatsCache::MediaChannelStatsCache(rtc::Thread* worker_thread,
+                                               int64_t lifetime_us)
+    : worker_thread_(worker_thread), lifetime_us_(lifetime_us) {
+  RTC_DCHECK(worker_thread_);
+  RTC_DCHECK_GE(lifetime_us_, 0);
+}
+
+MediaChannelStatsCache::~MediaChannelStatsCache() = default;
+
+void MediaChannelStatsCache::GetStats(VoiceStats* voice_stats,
+                                      VideoStats* video_stats) {
+  const int64_t now_us = rtc::TimeMicros();
+  if (now_us - cache_timestamp_us_ > lifetime_us_) {
+    Clear();
+    cache_timestamp_us_ = now_us;
+  }
+
+  const std::vector<cricket::VoiceMediaChannel*> voice_channels =
+      FindUncachedChannels(*voice_stats, voice_stats_);
+  const std::vector<cricket::VideoMediaChannel*> video_channels =
+      FindUncachedChannels(*video_stats, video_stats_);
+  if (!voice_channels.empty() || !video_channels.empty()) {
+    worker_thread_->Invoke<void>(RTC_FROM_HERE, [&] {
+      rtc::Thread::ScopedDisallowBlockingCalls no_blocking_calls;
+      GetStatsOnWorkerThread(voice_channels, &voice_stats_);
+      GetStatsOnWorkerThread(video_channels, &video_stats_);
+    });
+  }
+
+  CopyCachedStats(voice_stats_, voice_stats);
+  CopyCachedStats(video_stats_, video_stats);
+}
+
+void MediaChannelStatsCache::Clear() {
+  voice_stats_.clear();
+  video_stats_.clear();
+  // Forces the next GetStats() to start over, even with a zero lifetime.
+  cache_timestamp_us_ = rtc::TimeMicros() - lifetime_us_ - 1;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef PC_MEDIA_CHANNEL_STATS_CACHE_H_
+#define PC_MEDIA_CHANNEL_STATS_CACHE_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+
+#include "media/base/media_channel.h"
+#include "rtc_base/thread.h"
+
+namespace webrtc {
+
+// Gets the stats of media channels on the worker thread, in a single hop for
+// all the channels, and keeps them for |lifetime_us|. The legacy
+// StatsCollector and the RTCStatsCollector of a PeerConnection share one, so
+// that polling both kinds of stats blocks on the worker thread, and on the
+// locks of the stream stats behind it, only once. May only be used on the
+// signaling thread.
+class MediaChannelStatsCache {
+ public:
+  using VoiceStats = std::map<cricket::VoiceMediaChannel*,
+                              std::unique_ptr<cricket::VoiceMediaInfo>>;
+  using VideoStats = std::map<cricket::VideoMediaChannel*,
+                              std::unique_ptr<cricket::VideoMediaInfo>>;
+
+  MediaChannelStatsCache(rtc::Thread* worker_thread, int64_t lifetime_us);
+  MediaChannelStatsCache(const MediaChannelStatsCache&) = delete;
+  MediaChannelStatsCache& operator=(const MediaChannelStatsCache&) = delete;
+  ~MediaChannelStatsCache();
+
+  // Sets the stats of each channel keyed in |voice_stats| and |video_stats|,
+  // either from the cache or fresh from the worker thread. The stats of a
+  // channel are null if its GetStats() fails.
+  void GetStats(VoiceStats* voice_stats, VideoStats* video_stats);
+
+  // Makes the next GetStats() get fresh stats.
+  void Clear();
+
+ private:
+  rtc::Thread* const worker_thread_;
+  const int64_t lifetime_us_;
+  // When the cached stats were first gotten, in rtc::TimeMicros().
+  int64_t cache_timestamp_us_ = 0;
+  VoiceStats voice_stats_;
+  VideoStats video_stats_;
+};
+
+}  // namespace webrtc
+
+#endif  // PC_MEDIA_CHANNEL_STATS_CACHE_H_
@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "pc/media_channel_stats_cache.h"
+
+#include <memory>
+
+#include "api/units/time_delta.h"
+#include "media/base/fake_media_engine.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int64_t kLifetimeUs = 50 * rtc::kNumMicrosecsPerMillisec;
+
+// Reports the number of GetStats() calls made on it, on the worker thread.
+class CountingVoiceMediaChannel : public cricket::FakeVoiceMediaChannel {
+ public:
+  explicit CountingVoiceMediaChannel(rtc::Thread* worker_thread)
+      : cricket::FakeVoiceMediaChannel(nullptr, cricket::AudioOptions()),
+        worker_thread_(worker_thread) {}
+
+  bool GetStats(cricket::VoiceMediaInfo* info) override {
+    EXPECT_TRUE(worker_thread_->IsCurrent());
+    ++num_get_stats_;
+    info->device_underrun_count = num_get_stats_;
+    return !fail_;
+  }
+
+  int num_get_stats_ = 0;
+  bool fail_ = false;
+
+ private:
+  rtc::Thread* const worker_thread_;
+};
+
+class CountingVideoMediaChannel : public cricket::FakeVideoMediaChannel {
+ public:
+  explicit CountingVideoMediaChannel(rtc::Thread* worker_thread)
+      : cricket::FakeVideoMediaChannel(nullptr, cricket::VideoOptions()),
+        worker_thread_(worker_thread) {}
+
+  bool GetStats(cricket::VideoMediaInfo* info) override {
+    EXPECT_TRUE(worker_thread_->IsCurrent());
+    ++num_get_stats_;
+    info->aggregated_senders.resize(num_get_stats_);
+    return true;
+  }
+
+  int num_get_stats_ = 0;
+
+ private:
+  rtc::Thread* const worker_thread_;
+};
+
+class MediaChannelStatsCacheTest : public ::testing::Test {
+ protected:
+  MediaChannelStatsCacheTest()
+      : worker_thread_(rtc::Thread::Create()),
+        voice_channel_(worker_thread_.get()),
+        video_channel_(worker_thread_.get()) {
+    worker_thread_->Start();
+  }
+
+  // Returns the device underrun count of the voice stats, which counts the
+  // calls to GetStats(), or -1 if they failed.
+  int GetVoiceStats(MediaChannelStatsCache* cache) {
+    MediaChannelStatsCache::VoiceStats voice_stats;
+    MediaChannelStatsCache::VideoStats video_stats;
+    voice_stats[&voice_channel_] = nullptr;
+    cache->GetStats(&voice_stats, &video_stats);
+    const std::unique_ptr<cricket::VoiceMediaInfo>& info =
+        voice_stats[&voice_channel_];
+    return info ? info->device_underrun_count : -1;
+  }
+
+  rtc::ScopedFakeClock fake_clock_;
+  std::unique_ptr<rtc::Thread> worker_thread_;
+  CountingVoiceMediaChannel voice_channel_;
+  CountingVideoMediaChannel video_channel_;
+};
+
+}  // namespace
+
+TEST_F(MediaChannelStatsCacheTest, GetsStatsOfAllChannels) {
+  MediaChannelStatsCache cache(worker_thread_.get(), kLifetimeUs);
+  MediaChannelStatsCache::VoiceStats voice_stats;
+  MediaChannelStatsCache::VideoStats video_stats;
+  voice_stats[&voice_channel_] = nullptr;
+  video_stats[&video_channel_] = nullptr;
+  cache.GetStats(&voice_stats, &video_stats);
+
+  ASSERT_TRUE(voice_stats[&voice_channel_]);
+  EXPECT_EQ(1, voice_stats[&voice_channel_]->device_underrun_count);
+  ASSERT_TRUE(video_stats[&video_channel_]);
+  EXPECT_EQ(1u, video_stats[&video_channel_]->aggregated_senders.size());
+}
+
+TEST_F(MediaChannelStatsCacheTest, CachesStatsForLifetime) {
+  MediaChannelStatsCache cache(worker_thread_.get(), kLifetimeUs);
+  fake_clock_.AdvanceTime(TimeDelta::Seconds(1));
+  EXPECT_EQ(1, GetVoiceStats(&cache));
+  fake_clock_.AdvanceTime(TimeDelta::Millis(50));
+  EXPECT_EQ(1, GetVoiceStats(&cache));
+  EXPECT_EQ(1, voice_channel_.num_get_stats_);
+
+  fake_clock_.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_EQ(2, GetVoiceStats(&cache));
+
+  cache.Clear();
+  EXPECT_EQ(3, GetVoiceStats(&cache));
+  EXPECT_EQ(3, voice_channel_.num_get_stats_);
+}
+
+TEST_F(MediaChannelStatsCacheTest, GetsUncachedChannelsOnly) {
+  MediaChannelStatsCache cache(worker_thread_.get(), kLifetimeUs);
+  EXPECT_EQ(1, GetVoiceStats(&cache));
+
+  MediaChannelStatsCache::VoiceStats voice_stats;
+  MediaChannelStatsCache::VideoStats video_stats;
+  voice_stats[&voice_channel_] = nullptr;
+  video_stats[&video_channel_] = nullptr;
+  cache.GetStats(&voice_stats, &video_stats);
+  EXPECT_EQ(1, voice_channel_.num_get_stats_);
+  EXPECT_EQ(1, video_channel_.num_get_stats_);
+}
+
+TEST_F(MediaChannelStatsCacheTest, ZeroLifetimeGetsFreshStats) {
+  MediaChannelStatsCache cache(worker_thread_.get(), 0);
+  EXPECT_EQ(1, GetVoiceStats(&cache));
+  fake_clock_.AdvanceTime(TimeDelta::Micros(1));
+  EXPECT_EQ(2, GetVoiceStats(&cache));
+}
+
+TEST_F(MediaChannelStatsCacheTest, FailedStatsAreNull) {
+  MediaChannelStatsCache cache(worker_thread_.get(), kLifetimeUs);
+  voice_channel_.fail_ = true;
+  EXPECT_EQ(-1, GetVoiceStats(&cache));
+  // Failures are cached too.
+  EXPECT_EQ(-1, GetVoiceStats(&cache));
+  EXPECT_EQ(1, voice_channel_.num_get_stats_);
+}
+
+}  // namespace webrtc
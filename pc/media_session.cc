@@ -441,8 +441,12 @@ static bool UpdateTransportInfoForBundle(const ContentGroup& bundle_group,
       selected_transport_info->description.connection_role;
   const absl::optional<OpaqueTransportParameters>& selected_opaque_parameters =
       selected_transport_info->description.opaque_parameters;
+  // A set rather than ContentGroup::HasContentName(), which would make this
+  // quadratic in the number of m-sections.
+  const std::set<std::string> bundled_content_names(
+      bundle_group.content_names().begin(), bundle_group.content_names().end());
   for (TransportInfo& transport_info : sdesc->transport_infos()) {
-    if (bundle_group.HasContentName(transport_info.content_name) &&
+    if (bundled_content_names.count(transport_info.content_name) &&
         transport_info.content_name != selected_content_name) {
       transport_info.description.ice_ufrag = selected_ufrag;
       transport_info.description.ice_pwd = selected_pwd;
@@ -453,22 +457,6 @@ static bool UpdateTransportInfoForBundle(const ContentGroup& bundle_group,
   return true;
 }
 
-// Gets the CryptoParamsVec of the given |content_name| from |sdesc|, and
-// sets it to |cryptos|.
-static bool GetCryptosByName(const SessionDescription* sdesc,
-                             const std::string& content_name,
-                             CryptoParamsVec* cryptos) {
-  if (!sdesc || !cryptos) {
-    return false;
-  }
-  const ContentInfo* content = sdesc->GetContentByName(content_name);
-  if (!content || !content->media_description()) {
-    return false;
-  }
-  *cryptos = content->media_description()->cryptos();
-  return true;
-}
-
 // Prunes the |target_cryptos| by removing the crypto params (cipher_suite)
 // which are not available in |filter|.
 static void PruneCryptos(const CryptoParamsVec& filter,
@@ -491,14 +479,9 @@ static void PruneCryptos(const CryptoParamsVec& filter,
       target_cryptos->end());
 }
 
-static bool IsRtpContent(SessionDescription* sdesc,
-                         const std::string& content_name) {
-  bool is_rtp = false;
-  ContentInfo* content = sdesc->GetContentByName(content_name);
-  if (content && content->media_description()) {
-    is_rtp = IsRtpProtocol(content->media_description()->protocol());
-  }
-  return is_rtp;
+static bool IsRtpContent(const ContentInfo* content) {
+  return content && content->media_description() &&
+         IsRtpProtocol(content->media_description()->protocol());
 }
 
 // Updates the crypto parameters of the |sdesc| according to the given
@@ -512,36 +495,49 @@ static bool UpdateCryptoParamsForBundle(const ContentGroup& bundle_group,
     return false;
   }
 
+  // Looks up the contents and transports by name once, rather than with
+  // SessionDescription::GetContentByName() and GetTransportInfoByName() for
+  // each content of the bundle, which would make this quadratic in the
+  // number of m-sections. Like those, the first one of a name wins.
+  std::map<std::string, ContentInfo*> contents_by_name;
+  for (ContentInfo& content : sdesc->contents()) {
+    contents_by_name.emplace(content.name, &content);
+  }
+  std::map<std::string, const TransportInfo*> transport_infos_by_name;
+  for (const TransportInfo& transport_info : sdesc->transport_infos()) {
+    transport_infos_by_name.emplace(transport_info.content_name,
+                                    &transport_info);
+  }
+  const ContentNames& content_names = bundle_group.content_names();
+  std::vector<ContentInfo*> rtp_contents;
+  rtp_contents.reserve(content_names.size());
+  for (const std::string& content_name : content_names) {
+    auto it = contents_by_name.find(content_name);
+    if (it != contents_by_name.end() && IsRtpContent(it->second)) {
+      rtp_contents.push_back(it->second);
+    }
+  }
+
   bool common_cryptos_needed = false;
   // Get the common cryptos.
-  const ContentNames& content_names = bundle_group.content_names();
   CryptoParamsVec common_cryptos;
   bool first = true;
-  for (const std::string& content_name : content_names) {
-    if (!IsRtpContent(sdesc, content_name)) {
-      continue;
-    }
+  for (const ContentInfo* content : rtp_contents) {
     // The common cryptos are needed if any of the content does not have DTLS
     // enabled.
-    if (!sdesc->GetTransportInfoByName(content_name)->description.secure()) {
+    if (!transport_infos_by_name[content->name]->description.secure()) {
       common_cryptos_needed = true;
     }
     if (first) {
       first = false;
       // Initial the common_cryptos with the first content in the bundle group.
-      if (!GetCryptosByName(sdesc, content_name, &common_cryptos)) {
-        return false;
-      }
+      common_cryptos = content->media_description()->cryptos();
       if (common_cryptos.empty()) {
         // If there's no crypto params, we should just return.
         return true;
       }
     } else {
-      CryptoParamsVec cryptos;
-      if (!GetCryptosByName(sdesc, content_name, &cryptos)) {
-        return false;
-      }
-      PruneCryptos(cryptos, &common_cryptos);
+      PruneCryptos(content->media_description()->cryptos(), &common_cryptos);
     }
   }
 
@@ -550,11 +546,7 @@ static bool UpdateCryptoParamsForBundle(const ContentGroup& bundle_group,
   }
 
   // Update to use the common cryptos.
-  for (const std::string& content_name : content_names) {
-    if (!IsRtpContent(sdesc, content_name)) {
-      continue;
-    }
-    ContentInfo* content = sdesc->GetContentByName(content_name);
+  for (ContentInfo* content : rtp_contents) {
     if (IsMediaContent(content)) {
       MediaContentDescription* media_desc = content->media_description();
       if (!media_desc) {
@@ -1619,6 +1611,11 @@ MediaSessionDescriptionFactory::CreateAnswer(
   // If the offer supports BUNDLE, and we want to use it too, create a BUNDLE
   // group in the answer with the appropriate content names.
   const ContentGroup* offer_bundle = offer->GetGroupByName(GROUP_TYPE_BUNDLE);
+  std::set<std::string> offer_bundle_content_names;
+  if (offer_bundle) {
+    offer_bundle_content_names.insert(offer_bundle->content_names().begin(),
+                                      offer_bundle->content_names().end());
+  }
   ContentGroup answer_bundle(GROUP_TYPE_BUNDLE);
   // Transport info shared by the bundle group.
   std::unique_ptr<TransportInfo> bundle_transport;
@@ -1676,11 +1673,19 @@ MediaSessionDescriptionFactory::CreateAnswer(
     // See if we can add the newly generated m= section to the BUNDLE group in
     // the answer.
     ContentInfo& added = answer->contents().back();
-    if (!added.rejected && session_options.bundle_enabled && offer_bundle &&
-        offer_bundle->HasContentName(added.name)) {
+    if (!added.rejected && session_options.bundle_enabled &&
+        offer_bundle_content_names.count(added.name)) {
       answer_bundle.AddContentName(added.name);
-      bundle_transport.reset(
-          new TransportInfo(*answer->GetTransportInfoByName(added.name)));
+      // The transport of the m-section was just added too, so look for it
+      // from the back.
+      const TransportInfos& transport_infos = answer->transport_infos();
+      auto transport_info = std::find_if(
+          transport_infos.rbegin(), transport_infos.rend(),
+          [&added](const TransportInfo& info) {
+            return info.content_name == added.name;
+          });
+      RTC_DCHECK(transport_info != transport_infos.rend());
+      bundle_transport.reset(new TransportInfo(*transport_info));
     }
   }
 
@@ -30,9 +30,12 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/fake_ssl_identity.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/message_digest.h"
 #include "rtc_base/ssl_adapter.h"
+#include "rtc_base/string_encode.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/time_utils.h"
 #include "rtc_base/unique_id_generator.h"
 #include "test/gmock.h"
 
@@ -4512,6 +4515,92 @@ TEST_F(MediaSessionDescriptionFactoryTest,
   EXPECT_EQ(h264_pm1.id, answer_codec.id);
 }
 
+// Adds |num_sections| sendrecv media sections, alternating audio and video,
+// each with its own sender, after those already in |opts|.
+static void AddSectionsWithSenders(int num_sections,
+                                   MediaSessionOptions* opts) {
+  const int first_index =
+      static_cast<int>(opts->media_description_options.size());
+  for (int i = first_index; i < first_index + num_sections; ++i) {
+    const MediaType type = i % 2 == 0 ? MEDIA_TYPE_AUDIO : MEDIA_TYPE_VIDEO;
+    const std::string mid = rtc::ToString(i);
+    AddMediaDescriptionOptions(type, mid, RtpTransceiverDirection::kSendRecv,
+                               kActive, opts);
+    AttachSenderToMediaDescriptionOptions(mid, type, "track" + mid,
+                                          {"stream" + mid}, 1, opts);
+  }
+}
+
+// Renegotiating a session keeps every existing m-section, so adding one is
+// handled the same way as creating the whole offer from scratch.
+TEST_F(MediaSessionDescriptionFactoryTest,
+       ReofferWithManySectionsKeepsExistingSections) {
+  MediaSessionOptions opts;
+  opts.bundle_enabled = true;
+  AddSectionsWithSenders(100, &opts);
+  std::unique_ptr<SessionDescription> offer = f1_.CreateOffer(opts, nullptr);
+  ASSERT_TRUE(offer);
+
+  AddSectionsWithSenders(1, &opts);
+  std::unique_ptr<SessionDescription> reoffer =
+      f1_.CreateOffer(opts, offer.get());
+  ASSERT_TRUE(reoffer);
+  ASSERT_EQ(101u, reoffer->contents().size());
+  for (size_t i = 0; i < offer->contents().size(); ++i) {
+    const MediaContentDescription* media =
+        offer->contents()[i].media_description();
+    const MediaContentDescription* remedia =
+        reoffer->contents()[i].media_description();
+    EXPECT_EQ(offer->contents()[i].name, reoffer->contents()[i].name);
+    ASSERT_EQ(1u, remedia->streams().size());
+    EXPECT_EQ(media->streams()[0], remedia->streams()[0]);
+  }
+  const cricket::ContentGroup* bundle =
+      reoffer->GetGroupByName(cricket::GROUP_TYPE_BUNDLE);
+  ASSERT_TRUE(bundle);
+  EXPECT_EQ(101u, bundle->content_names().size());
+
+  std::unique_ptr<SessionDescription> answer =
+      f2_.CreateAnswer(reoffer.get(), opts, nullptr);
+  ASSERT_TRUE(answer);
+  EXPECT_EQ(101u, answer->contents().size());
+}
+
+// Not run by default. Logs how long renegotiating to add one m-section takes
+// for sessions of increasing sizes, to check that it scales linearly.
+TEST_F(MediaSessionDescriptionFactoryTest,
+       DISABLED_BenchmarkReofferWithManySections) {
+  const int kIterations = 10;
+  for (int num_sections : {50, 100, 200, 400, 800}) {
+    MediaSessionOptions opts;
+    opts.bundle_enabled = true;
+    AddSectionsWithSenders(num_sections, &opts);
+    std::unique_ptr<SessionDescription> offer = f1_.CreateOffer(opts, nullptr);
+    ASSERT_TRUE(offer);
+    std::unique_ptr<SessionDescription> answer =
+        f2_.CreateAnswer(offer.get(), opts, nullptr);
+    ASSERT_TRUE(answer);
+    AddSectionsWithSenders(1, &opts);
+
+    int64_t start_us = rtc::TimeMicros();
+    std::unique_ptr<SessionDescription> reoffer;
+    for (int i = 0; i < kIterations; ++i)
+      reoffer = f1_.CreateOffer(opts, offer.get());
+    const int64_t offer_us = (rtc::TimeMicros() - start_us) / kIterations;
+
+    start_us = rtc::TimeMicros();
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_TRUE(f2_.CreateAnswer(reoffer.get(), opts, answer.get()));
+    const int64_t answer_us = (rtc::TimeMicros() - start_us) / kIterations;
+
+    RTC_LOG(LS_INFO) << num_sections << " m-sections: CreateOffer " << offer_us
+                     << " us (" << offer_us / num_sections
+                     << " us per m-section), CreateAnswer " << answer_us
+                     << " us (" << answer_us / num_sections
+                     << " us per m-section)";
+  }
+}
+
 class MediaProtocolTest : public ::testing::TestWithParam<const char*> {
  public:
   MediaProtocolTest()
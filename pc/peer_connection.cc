@@ -56,6 +56,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/string_encode.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial.h"
@@ -130,6 +131,11 @@ static const char kDefaultVideoSenderId[] = "defaultv0";
 // The length of RTCP CNAMEs.
 static const int kRtcpCnameLength = 16;
 
+// How long the stats reports and the media channel stats they are made of are
+// cached. This matches the minimum update interval of the legacy stats.
+static const int64_t kMediaChannelStatsCacheLifetimeUs =
+    50 * rtc::kNumMicrosecsPerMillisec;
+
 enum {
   MSG_SET_SESSIONDESCRIPTION_SUCCESS = 0,
   MSG_SET_SESSIONDESCRIPTION_FAILED,
@@ -1369,8 +1375,12 @@ bool PeerConnection::Initialize(
   transport_controller_->SignalIceCandidatePairChanged.connect(
       this, &PeerConnection::OnTransportControllerCandidateChanged);
 
-  stats_.reset(new StatsCollector(this));
-  stats_collector_ = RTCStatsCollector::Create(this);
+  media_channel_stats_cache_ = std::make_unique<MediaChannelStatsCache>(
+      worker_thread(), kMediaChannelStatsCacheLifetimeUs);
+  stats_.reset(new StatsCollector(this, media_channel_stats_cache_.get()));
+  stats_collector_ =
+      RTCStatsCollector::Create(this, kMediaChannelStatsCacheLifetimeUs,
+                                media_channel_stats_cache_.get());
 
   configuration_ = configuration;
 
@@ -2667,6 +2677,8 @@ RTCError PeerConnection::ApplyLocalDescription(
   // Update stats here so that we have the most recent stats for tracks and
   // streams that might be removed by updating the session description.
   stats_->UpdateStats(kStatsOutputLevelStandard);
+  // The new description may change the transports and their certificates.
+  ClearStatsCache();
 
   // Take a reference to the old local description since it's used below to
   // compare against the new local description. When setting the new local
@@ -3122,6 +3134,8 @@ RTCError PeerConnection::ApplyRemoteDescription(
   // Update stats here so that we have the most recent stats for tracks and
   // streams that might be removed by updating the session description.
   stats_->UpdateStats(kStatsOutputLevelStandard);
+  // The new description may change the transports and their certificates.
+  ClearStatsCache();
 
   // Take a reference to the old remote description since it's used below to
   // compare against the new remote description. When setting the new remote
@@ -4275,6 +4289,10 @@ bool PeerConnection::RemoveIceCandidates(
 }
 
 RTCError PeerConnection::SetBitrate(const BitrateSettings& bitrate) {
+  if (signaling_thread()->IsCurrent()) {
+    RTC_DCHECK_RUN_ON(signaling_thread());
+    MaybeCreateCall();
+  }
   if (!worker_thread()->IsCurrent()) {
     return worker_thread()->Invoke<RTCError>(
         RTC_FROM_HERE, [&]() { return SetBitrate(bitrate); });
@@ -6631,8 +6649,20 @@ RTCError PeerConnection::CreateChannels(const SessionDescription& desc) {
 }
 
 // TODO(steveanton): Perhaps this should be managed by the RtpTransceiver.
+void PeerConnection::MaybeCreateCall() {
+  if (call_ptr_ || IsClosed()) {
+    return;
+  }
+  call_ptr_ = worker_thread()->Invoke<Call*>(RTC_FROM_HERE, [this] {
+    RTC_DCHECK_RUN_ON(worker_thread());
+    call_ = factory_->CreateCall_w(event_log_ptr_);
+    return call_.get();
+  });
+}
+
 cricket::VoiceChannel* PeerConnection::CreateVoiceChannel(
     const std::string& mid) {
+  MaybeCreateCall();
   RtpTransportInternal* rtp_transport = GetRtpTransport(mid);
   MediaTransportConfig media_transport_config =
       transport_controller_->GetMediaTransportConfig(mid);
@@ -6656,6 +6686,7 @@ cricket::VoiceChannel* PeerConnection::CreateVoiceChannel(
 // TODO(steveanton): Perhaps this should be managed by the RtpTransceiver.
 cricket::VideoChannel* PeerConnection::CreateVideoChannel(
     const std::string& mid) {
+  MaybeCreateCall();
   RtpTransportInternal* rtp_transport = GetRtpTransport(mid);
   MediaTransportConfig media_transport_config =
       transport_controller_->GetMediaTransportConfig(mid);
@@ -7394,6 +7425,9 @@ void PeerConnection::ClearStatsCache() {
   if (stats_collector_) {
     stats_collector_->ClearCachedStatsReport();
   }
+  if (media_channel_stats_cache_) {
+    media_channel_stats_cache_->Clear();
+  }
 }
 
 void PeerConnection::RequestUsagePatternReportForTesting() {
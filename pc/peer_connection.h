@@ -24,6 +24,7 @@
 #include "pc/data_channel_controller.h"
 #include "pc/ice_server_parsing.h"
 #include "pc/jsep_transport_controller.h"
+#include "pc/media_channel_stats_cache.h"
 #include "pc/peer_connection_factory.h"
 #include "pc/peer_connection_internal.h"
 #include "pc/rtc_stats_collector.h"
@@ -1031,6 +1032,10 @@ class PeerConnection : public PeerConnectionInternal,
       const cricket::SessionDescription& desc) const
       RTC_RUN_ON(signaling_thread());
 
+  // Creates |call_| on the worker thread, unless it exists or the
+  // PeerConnection is closed.
+  void MaybeCreateCall() RTC_RUN_ON(signaling_thread());
+
   // Helper methods to create media channels.
   cricket::VoiceChannel* CreateVoiceChannel(const std::string& mid)
       RTC_RUN_ON(signaling_thread());
@@ -1283,10 +1288,14 @@ class PeerConnection : public PeerConnectionInternal,
 
   rtc::AsyncInvoker rtcp_invoker_ RTC_GUARDED_BY(network_thread());
 
-  // Points to the same thing as `call_`. Since it's const, we may read the
-  // pointer from any thread.
-  Call* const call_ptr_;
+  // Points to the same thing as `call_`, for use on the signaling thread.
+  // Null until the first media channel is created when the factory creates
+  // calls lazily.
+  Call* call_ptr_ RTC_GUARDED_BY(signaling_thread());
 
+  // Shared by |stats_| and |stats_collector_|, which it outlives.
+  std::unique_ptr<MediaChannelStatsCache> media_channel_stats_cache_
+      RTC_GUARDED_BY(signaling_thread());
   std::unique_ptr<StatsCollector> stats_
       RTC_GUARDED_BY(signaling_thread());  // A pointer is passed to senders_
   rtc::scoped_refptr<RTCStatsCollector> stats_collector_
@@ -29,6 +29,7 @@
 #include "api/video_track_source_proxy.h"
 #include "media/base/rtp_data_engine.h"
 #include "media/sctp/sctp_transport.h"
+#include "modules/pacing/shared_pacer.h"
 #include "p2p/base/basic_async_resolver_factory.h"
 #include "p2p/base/basic_packet_socket_factory.h"
 #include "p2p/base/default_ice_transport_factory.h"
@@ -41,16 +42,22 @@
 #include "pc/video_track.h"
 #include "rtc_base/bind.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/experiments/field_trial_units.h"
+#include "rtc_base/memory/aligned_malloc.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/system/file_wrapper.h"
+#include "rtc_base/task_queue_pool.h"
+#include "system_wrappers/include/clock.h"
 
 namespace webrtc {
 
 rtc::scoped_refptr<PeerConnectionFactoryInterface>
 CreateModularPeerConnectionFactory(
     PeerConnectionFactoryDependencies dependencies) {
+  if (dependencies.huge_page_config)
+    SetAlignedMallocHugePageConfig(*dependencies.huge_page_config);
   rtc::scoped_refptr<PeerConnectionFactory> pc_factory(
       new rtc::RefCountedObject<PeerConnectionFactory>(
           std::move(dependencies)));
@@ -82,6 +89,8 @@ PeerConnectionFactory::PeerConnectionFactory(
           std::move(dependencies.network_state_predictor_factory)),
       injected_network_controller_factory_(
           std::move(dependencies.network_controller_factory)),
+      bandwidth_estimate_cache_(
+          std::move(dependencies.bandwidth_estimate_cache)),
       media_transport_factory_(std::move(dependencies.media_transport_factory)),
       neteq_factory_(std::move(dependencies.neteq_factory)),
       trials_(dependencies.trials ? std::move(dependencies.trials)
@@ -109,6 +118,38 @@ PeerConnectionFactory::PeerConnectionFactory(
       wraps_current_thread_ = true;
     }
   }
+
+  // Sharing one Call between peer connections would also share its
+  // congestion controller and SSRC demuxing between unrelated transports.
+  // Share the per-call pacer and codec threads instead.
+  FieldTrialFlag shared_call_modules("Enabled");
+  FieldTrialParameter<int> pacer_task_queues("pacer_queues", 2);
+  FieldTrialParameter<int> codec_threads("codec_threads", 4);
+  // Packets are processed on the worker thread unless this is set.
+  FieldTrialParameter<int> receive_threads("receive_threads", 0);
+  // Threads for the prerenderer smoothing of all video receive streams.
+  FieldTrialParameter<int> render_threads("render_threads", 1);
+  ParseFieldTrial({&shared_call_modules, &pacer_task_queues, &codec_threads,
+                   &receive_threads, &render_threads},
+                  trials_->Lookup("WebRTC-SharedCallModules"));
+  if (shared_call_modules && task_queue_factory_ &&
+      pacer_task_queues.Get() > 0 && codec_threads.Get() > 0) {
+    shared_pacer_ = std::make_unique<SharedPacer>(Clock::GetRealTimeClock(),
+                                                  task_queue_factory_.get(),
+                                                  pacer_task_queues.Get());
+    shared_decode_task_queue_factory_ =
+        CreateTaskQueuePoolFactory(codec_threads.Get());
+    shared_encode_task_queue_factory_ =
+        CreateTaskQueuePoolFactory(codec_threads.Get());
+    if (receive_threads.Get() > 0) {
+      shared_receive_task_queue_factory_ =
+          CreateTaskQueuePoolFactory(receive_threads.Get());
+    }
+    if (render_threads.Get() > 0) {
+      shared_render_task_queue_factory_ = CreateTaskQueuePoolFactory(
+          render_threads.Get(), TaskQueueFactory::Priority::HIGH);
+    }
+  }
 }
 
 PeerConnectionFactory::~PeerConnectionFactory() {
@@ -223,6 +264,10 @@ void PeerConnectionFactory::StopAecDump() {
   channel_manager_->StopAecDump();
 }
 
+rtc::CpuUsageReport PeerConnectionFactory::GetCpuUsage() const {
+  return rtc::GetCpuUsageReport();
+}
+
 rtc::scoped_refptr<PeerConnectionInterface>
 PeerConnectionFactory::CreatePeerConnection(
     const PeerConnectionInterface::RTCConfiguration& configuration,
@@ -248,9 +293,19 @@ PeerConnectionFactory::CreatePeerConnection(
 
   // Set internal defaults if optional dependencies are not set.
   if (!dependencies.cert_generator) {
-    dependencies.cert_generator =
-        std::make_unique<rtc::RTCCertificateGenerator>(signaling_thread_,
-                                                       network_thread_);
+    // Generating on the network thread delays its packets, so generate on a
+    // task queue if enabled. Injecting a task queue factory that runs on a
+    // thread pool also lets the peer connections generate in parallel.
+    if (task_queue_factory_ &&
+        IsTrialEnabled("WebRTC-CertificateGenerationOnTaskQueue")) {
+      dependencies.cert_generator =
+          std::make_unique<rtc::RTCCertificateGenerator>(
+              signaling_thread_, task_queue_factory_.get());
+    } else {
+      dependencies.cert_generator =
+          std::make_unique<rtc::RTCCertificateGenerator>(signaling_thread_,
+                                                         network_thread_);
+    }
   }
   if (!dependencies.allocator) {
     rtc::PacketSocketFactory* packet_socket_factory;
@@ -288,9 +343,16 @@ PeerConnectionFactory::CreatePeerConnection(
           RTC_FROM_HERE,
           rtc::Bind(&PeerConnectionFactory::CreateRtcEventLog_w, this));
 
-  std::unique_ptr<Call> call = worker_thread_->Invoke<std::unique_ptr<Call>>(
-      RTC_FROM_HERE,
-      rtc::Bind(&PeerConnectionFactory::CreateCall_w, this, event_log.get()));
+  // A Call starts several threads and task queues. With lazy creation, the
+  // PeerConnection creates it along with its first media channel instead, so
+  // that peer connections that only use data channels or never connect don't
+  // pay for it.
+  std::unique_ptr<Call> call;
+  if (!IsTrialEnabled("WebRTC-LazyCallCreation")) {
+    call = worker_thread_->Invoke<std::unique_ptr<Call>>(
+        RTC_FROM_HERE, rtc::Bind(&PeerConnectionFactory::CreateCall_w, this,
+                                 event_log.get()));
+  }
 
   rtc::scoped_refptr<PeerConnection> pc(
       new rtc::RefCountedObject<PeerConnection>(this, std::move(event_log),
@@ -379,9 +441,19 @@ std::unique_ptr<Call> PeerConnectionFactory::CreateCall_w(
 
   call_config.fec_controller_factory = fec_controller_factory_.get();
   call_config.task_queue_factory = task_queue_factory_.get();
+  call_config.decode_task_queue_factory =
+      shared_decode_task_queue_factory_.get();
+  call_config.encode_task_queue_factory =
+      shared_encode_task_queue_factory_.get();
+  call_config.receive_task_queue_factory =
+      shared_receive_task_queue_factory_.get();
+  call_config.render_task_queue_factory =
+      shared_render_task_queue_factory_.get();
+  call_config.shared_pacer = shared_pacer_.get();
   call_config.network_state_predictor_factory =
       network_state_predictor_factory_.get();
   call_config.neteq_factory = neteq_factory_.get();
+  call_config.bandwidth_estimate_cache = bandwidth_estimate_cache_.get();
 
   if (IsTrialEnabled("WebRTC-Bwe-InjectedCongestionController")) {
     RTC_LOG(LS_INFO) << "Using injected network controller factory";
@@ -32,6 +32,7 @@ class BasicPacketSocketFactory;
 namespace webrtc {
 
 class RtcEventLog;
+class SharedPacer;
 
 class PeerConnectionFactory : public PeerConnectionFactoryInterface {
  public:
@@ -71,6 +72,7 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
 
   bool StartAecDump(FILE* file, int64_t max_size_bytes) override;
   void StopAecDump() override;
+  rtc::CpuUsageReport GetCpuUsage() const override;
 
   virtual std::unique_ptr<cricket::SctpTransportInternalFactory>
   CreateSctpTransportInternalFactory();
@@ -91,6 +93,11 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
     return media_transport_factory_.get();
   }
 
+  // Creates the Call of a PeerConnection, or returns null without a media
+  // engine. Called on the worker thread, by the PeerConnection itself when
+  // calls are created lazily.
+  std::unique_ptr<Call> CreateCall_w(RtcEventLog* event_log);
+
  protected:
   // This structure allows simple management of all new dependencies being added
   // to the PeerConnectionFactory.
@@ -107,7 +114,6 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   bool IsTrialEnabled(absl::string_view key) const;
 
   std::unique_ptr<RtcEventLog> CreateRtcEventLog_w();
-  std::unique_ptr<Call> CreateCall_w(RtcEventLog* event_log);
 
   bool wraps_current_thread_;
   rtc::Thread* network_thread_;
@@ -128,9 +134,19 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
       network_state_predictor_factory_;
   std::unique_ptr<NetworkControllerFactoryInterface>
       injected_network_controller_factory_;
+  std::unique_ptr<BandwidthEstimateCache> bandwidth_estimate_cache_;
   std::unique_ptr<MediaTransportFactory> media_transport_factory_;
   std::unique_ptr<NetEqFactory> neteq_factory_;
   const std::unique_ptr<WebRtcKeyValueConfig> trials_;
+
+  // Modules shared by the calls of all peer connections, with the
+  // WebRTC-SharedCallModules field trial. Each call still has a congestion
+  // controller of its own.
+  std::unique_ptr<SharedPacer> shared_pacer_;
+  std::unique_ptr<TaskQueueFactory> shared_decode_task_queue_factory_;
+  std::unique_ptr<TaskQueueFactory> shared_encode_task_queue_factory_;
+  std::unique_ptr<TaskQueueFactory> shared_receive_task_queue_factory_;
+  std::unique_ptr<TaskQueueFactory> shared_render_task_queue_factory_;
 };
 
 }  // namespace webrtc
@@ -38,7 +38,12 @@
 #include "p2p/base/port_interface.h"
 #include "pc/test/fake_audio_capture_module.h"
 #include "pc/test/fake_video_track_source.h"
+#include "pc/test/mock_peer_connection_observers.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/socket_address.h"
+#include "rtc_base/time_utils.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 
 #ifdef WEBRTC_ANDROID
@@ -101,14 +106,12 @@ class NullPeerConnectionObserver : public PeerConnectionObserver {
 }  // namespace
 
 class PeerConnectionFactoryTest : public ::testing::Test {
-  void SetUp() {
-#ifdef WEBRTC_ANDROID
-    webrtc::InitializeAndroidObjects();
-#endif
+ protected:
+  static rtc::scoped_refptr<PeerConnectionFactoryInterface> CreateFactory() {
     // Use fake audio device module since we're only testing the interface
     // level, and using a real one could make tests flaky e.g. when run in
     // parallel.
-    factory_ = webrtc::CreatePeerConnectionFactory(
+    return webrtc::CreatePeerConnectionFactory(
         rtc::Thread::Current(), rtc::Thread::Current(), rtc::Thread::Current(),
         rtc::scoped_refptr<webrtc::AudioDeviceModule>(
             FakeAudioCaptureModule::Create()),
@@ -117,6 +120,14 @@ class PeerConnectionFactoryTest : public ::testing::Test {
         webrtc::CreateBuiltinVideoEncoderFactory(),
         webrtc::CreateBuiltinVideoDecoderFactory(), nullptr /* audio_mixer */,
         nullptr /* audio_processing */);
+  }
+
+ private:
+  void SetUp() {
+#ifdef WEBRTC_ANDROID
+    webrtc::InitializeAndroidObjects();
+#endif
+    factory_ = CreateFactory();
 
     ASSERT_TRUE(factory_.get() != NULL);
     port_allocator_.reset(
@@ -481,3 +492,87 @@ TEST_F(PeerConnectionFactoryTest, LocalRendering) {
   EXPECT_EQ(3, local_renderer.num_rendered_frames());
   EXPECT_FALSE(local_renderer.black_frame());
 }
+
+// With lazy call creation, the call is created along with the first media
+// channel, and media can be negotiated as before.
+TEST_F(PeerConnectionFactoryTest, CreatesCallLazily) {
+  webrtc::test::ScopedFieldTrials field_trials(
+      "WebRTC-LazyCallCreation/Enabled/");
+  PeerConnectionInterface::RTCConfiguration config;
+  config.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
+  rtc::scoped_refptr<PeerConnectionInterface> pc(factory_->CreatePeerConnection(
+      config, std::move(port_allocator_),
+      std::make_unique<FakeRTCCertificateGenerator>(), &observer_));
+  ASSERT_TRUE(pc);
+  ASSERT_TRUE(pc->AddTransceiver(cricket::MEDIA_TYPE_AUDIO).ok());
+
+  rtc::scoped_refptr<webrtc::MockSetSessionDescriptionObserver> observer =
+      webrtc::MockSetSessionDescriptionObserver::Create();
+  pc->SetLocalDescription(observer);
+  EXPECT_TRUE_WAIT(observer->called(), 1000);
+  EXPECT_TRUE(observer->result());
+
+  webrtc::BitrateSettings bitrate;
+  bitrate.max_bitrate_bps = 100000;
+  EXPECT_TRUE(pc->SetBitrate(bitrate).ok());
+  pc->Close();
+}
+
+// Different peer connections share the pacer and codec threads of their calls
+// with the field trial.
+TEST_F(PeerConnectionFactoryTest, SharesCallModules) {
+  webrtc::test::ScopedFieldTrials field_trials(
+      "WebRTC-SharedCallModules/Enabled,pacer_queues:1,codec_threads:1/");
+  rtc::scoped_refptr<PeerConnectionFactoryInterface> factory = CreateFactory();
+  ASSERT_TRUE(factory);
+  PeerConnectionInterface::RTCConfiguration config;
+  config.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
+  std::vector<rtc::scoped_refptr<PeerConnectionInterface>> pcs;
+  for (int i = 0; i < 2; ++i) {
+    rtc::scoped_refptr<PeerConnectionInterface> pc(
+        factory->CreatePeerConnection(
+            config,
+            std::make_unique<cricket::FakePortAllocator>(
+                rtc::Thread::Current(), nullptr),
+            std::make_unique<FakeRTCCertificateGenerator>(), &observer_));
+    ASSERT_TRUE(pc);
+    ASSERT_TRUE(pc->AddTransceiver(cricket::MEDIA_TYPE_AUDIO).ok());
+    ASSERT_TRUE(pc->AddTransceiver(cricket::MEDIA_TYPE_VIDEO).ok());
+    rtc::scoped_refptr<webrtc::MockSetSessionDescriptionObserver> observer =
+        webrtc::MockSetSessionDescriptionObserver::Create();
+    pc->SetLocalDescription(observer);
+    EXPECT_TRUE_WAIT(observer->called(), 1000);
+    EXPECT_TRUE(observer->result());
+    pcs.push_back(pc);
+  }
+  for (const auto& pc : pcs) {
+    pc->Close();
+  }
+}
+
+// Reports how many peer connections can be created and closed per second,
+// with and without lazy call creation.
+TEST_F(PeerConnectionFactoryTest, DISABLED_CreateAndCloseRate) {
+  constexpr int kNumPeerConnections = 200;
+  for (const char* field_trials : {"", "WebRTC-LazyCallCreation/Enabled/"}) {
+    webrtc::test::ScopedFieldTrials scoped_field_trials(field_trials);
+    PeerConnectionInterface::RTCConfiguration config;
+    config.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
+    const int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumPeerConnections; ++i) {
+      rtc::scoped_refptr<PeerConnectionInterface> pc(
+          factory_->CreatePeerConnection(
+              config,
+              std::make_unique<cricket::FakePortAllocator>(
+                  rtc::Thread::Current(), nullptr),
+              std::make_unique<FakeRTCCertificateGenerator>(), &observer_));
+      ASSERT_TRUE(pc);
+      pc->Close();
+    }
+    const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+    RTC_LOG(LS_INFO) << "Field trials \"" << field_trials << "\": "
+                     << kNumPeerConnections * rtc::kNumMicrosecsPerSec /
+                            elapsed_us
+                     << " peer connections per second.";
+  }
+}
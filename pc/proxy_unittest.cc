@@ -13,8 +13,10 @@
 #include <memory>
 #include <string>
 
+#include "rtc_base/event.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/ref_count.h"
+#include "system_wrappers/include/metrics.h"
 #include "test/gmock.h"
 
 using ::testing::_;
@@ -34,6 +36,7 @@ class FakeInterface : public rtc::RefCountInterface {
   virtual std::string Method1(std::string s) = 0;
   virtual std::string ConstMethod1(std::string s) const = 0;
   virtual std::string Method2(std::string s1, std::string s2) = 0;
+  virtual void AsyncMethod1(std::string s) = 0;
 
  protected:
   virtual ~FakeInterface() {}
@@ -56,6 +59,7 @@ class Fake : public FakeInterface {
   MOCK_METHOD(std::string, ConstMethod1, (std::string), (const, override));
 
   MOCK_METHOD(std::string, Method2, (std::string, std::string), (override));
+  MOCK_METHOD(void, AsyncMethod1, (std::string), (override));
 
  protected:
   Fake() {}
@@ -71,6 +75,7 @@ PROXY_CONSTMETHOD0(std::string, ConstMethod0)
 PROXY_WORKER_METHOD1(std::string, Method1, std::string)
 PROXY_CONSTMETHOD1(std::string, ConstMethod1, std::string)
 PROXY_WORKER_METHOD2(std::string, Method2, std::string, std::string)
+PROXY_ASYNC_METHOD1(AsyncMethod1, std::string)
 END_PROXY_MAP()
 
 // Preprocessor hack to get a proxy class a name different than FakeProxy.
@@ -84,6 +89,7 @@ PROXY_CONSTMETHOD0(std::string, ConstMethod0)
 PROXY_METHOD1(std::string, Method1, std::string)
 PROXY_CONSTMETHOD1(std::string, ConstMethod1, std::string)
 PROXY_METHOD2(std::string, Method2, std::string, std::string)
+PROXY_ASYNC_METHOD1(AsyncMethod1, std::string)
 END_PROXY_MAP()
 #undef FakeProxy
 
@@ -173,6 +179,32 @@ TEST_F(SignalingProxyTest, Method2) {
   EXPECT_EQ("Method2", fake_signaling_proxy_->Method2(arg1, arg2));
 }
 
+TEST_F(SignalingProxyTest, AsyncMethod1DoesNotWait) {
+  const std::string arg1 = "arg1";
+  rtc::Event unblock;
+  rtc::Event called;
+  signaling_thread_->PostTask(
+      RTC_FROM_HERE, [&unblock] { unblock.Wait(rtc::Event::kForever); });
+  EXPECT_CALL(*fake_, AsyncMethod1(arg1))
+      .Times(Exactly(1))
+      .WillOnce(DoAll(
+          InvokeWithoutArgs(this, &SignalingProxyTest::CheckSignalingThread),
+          InvokeWithoutArgs([&called] { called.Set(); })));
+  // Returns while the signaling thread is still busy.
+  fake_signaling_proxy_->AsyncMethod1(arg1);
+  unblock.Set();
+  EXPECT_TRUE(called.Wait(1000));
+}
+
+TEST_F(SignalingProxyTest, RecordsBlockingTime) {
+  metrics::Reset();
+  EXPECT_CALL(*fake_, Method0()).WillOnce(Return("Method0"));
+  fake_signaling_proxy_->Method0();
+  EXPECT_METRIC_EQ(1, metrics::NumSamples("WebRTC.Proxy.CallBlockingTimeUs"));
+  EXPECT_METRIC_EQ(1,
+                   metrics::NumSamples("WebRTC.Proxy.CallQueueingDelayUs"));
+}
+
 class ProxyTest : public ::testing::Test {
  public:
   // Checks that the functions are called on the right thread.
@@ -553,6 +553,19 @@ void ProduceCertificateStatsFromSSLCertificateStats(
   }
 }
 
+std::unique_ptr<rtc::SSLCertificateStats> CopySSLCertificateStats(
+    const rtc::SSLCertificateStats* certificate_stats) {
+  if (!certificate_stats)
+    return nullptr;
+  std::string fingerprint = certificate_stats->fingerprint;
+  std::string fingerprint_algorithm = certificate_stats->fingerprint_algorithm;
+  std::string base64_certificate = certificate_stats->base64_certificate;
+  return std::make_unique<rtc::SSLCertificateStats>(
+      std::move(fingerprint), std::move(fingerprint_algorithm),
+      std::move(base64_certificate),
+      CopySSLCertificateStats(certificate_stats->issuer.get()));
+}
+
 const std::string& ProduceIceCandidateStats(int64_t timestamp_us,
                                             const cricket::Candidate& candidate,
                                             bool is_local,
@@ -961,19 +974,38 @@ RTCStatsCollector::RequestInfo::RequestInfo(
   RTC_DCHECK(!sender_selector_ || !receiver_selector_);
 }
 
+RTCStatsCollector::CertificateStatsPair
+RTCStatsCollector::CertificateStatsPair::Copy() const {
+  CertificateStatsPair copy;
+  copy.local = CopySSLCertificateStats(local.get());
+  copy.remote = CopySSLCertificateStats(remote.get());
+  return copy;
+}
+
 rtc::scoped_refptr<RTCStatsCollector> RTCStatsCollector::Create(
     PeerConnectionInternal* pc,
-    int64_t cache_lifetime_us) {
+    int64_t cache_lifetime_us,
+    MediaChannelStatsCache* media_channel_stats_cache) {
   return rtc::scoped_refptr<RTCStatsCollector>(
-      new rtc::RefCountedObject<RTCStatsCollector>(pc, cache_lifetime_us));
+      new rtc::RefCountedObject<RTCStatsCollector>(pc, cache_lifetime_us,
+                                                   media_channel_stats_cache));
 }
 
-RTCStatsCollector::RTCStatsCollector(PeerConnectionInternal* pc,
-                                     int64_t cache_lifetime_us)
+RTCStatsCollector::RTCStatsCollector(
+    PeerConnectionInternal* pc,
+    int64_t cache_lifetime_us,
+    MediaChannelStatsCache* media_channel_stats_cache)
     : pc_(pc),
       signaling_thread_(pc->signaling_thread()),
       worker_thread_(pc->worker_thread()),
       network_thread_(pc->network_thread()),
+      owned_media_channel_stats_cache_(
+          media_channel_stats_cache
+              ? nullptr
+              : std::make_unique<MediaChannelStatsCache>(worker_thread_, 0)),
+      media_channel_stats_cache_(media_channel_stats_cache
+                                     ? media_channel_stats_cache
+                                     : owned_media_channel_stats_cache_.get()),
       num_pending_partial_reports_(0),
       partial_report_timestamp_us_(0),
       network_report_event_(true /* manual_reset */,
@@ -1062,7 +1094,8 @@ void RTCStatsCollector::GetStatsReportInternal(
     network_thread_->PostTask(
         RTC_FROM_HERE,
         rtc::Bind(&RTCStatsCollector::ProducePartialResultsOnNetworkThread,
-                  this, timestamp_us));
+                  this, timestamp_us, clear_cached_certificates_));
+    clear_cached_certificates_ = false;
     ProducePartialResultsOnSignalingThread(timestamp_us);
   }
 }
@@ -1070,6 +1103,7 @@ void RTCStatsCollector::GetStatsReportInternal(
 void RTCStatsCollector::ClearCachedStatsReport() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   cached_report_ = nullptr;
+  clear_cached_certificates_ = true;
 }
 
 void RTCStatsCollector::WaitForPendingRequest() {
@@ -1107,8 +1141,11 @@ void RTCStatsCollector::ProducePartialResultsOnSignalingThreadImpl(
 }
 
 void RTCStatsCollector::ProducePartialResultsOnNetworkThread(
-    int64_t timestamp_us) {
+    int64_t timestamp_us,
+    bool clear_cached_certificates) {
   RTC_DCHECK(network_thread_->IsCurrent());
+  if (clear_cached_certificates)
+    cached_certificates_by_transport_.clear();
   // Touching |network_report_| on this thread is safe by this method because
   // |network_report_event_| is reset before this method is invoked.
   network_report_ = RTCStatsReport::Create(timestamp_us);
@@ -1801,12 +1838,19 @@ void RTCStatsCollector::ProduceTransportStats_n(
 std::map<std::string, RTCStatsCollector::CertificateStatsPair>
 RTCStatsCollector::PrepareTransportCertificateStats_n(
     const std::map<std::string, cricket::TransportStats>&
-        transport_stats_by_name) const {
+        transport_stats_by_name) {
   RTC_DCHECK(network_thread_->IsCurrent());
   std::map<std::string, CertificateStatsPair> transport_cert_stats;
   for (const auto& entry : transport_stats_by_name) {
     const std::string& transport_name = entry.first;
 
+    auto it = cached_certificates_by_transport_.find(transport_name);
+    if (it != cached_certificates_by_transport_.end()) {
+      transport_cert_stats.insert(
+          std::make_pair(transport_name, it->second.Copy()));
+      continue;
+    }
+
     CertificateStatsPair certificate_stats_pair;
     rtc::scoped_refptr<rtc::RTCCertificate> local_certificate;
     if (pc_->GetLocalCertificate(transport_name, &local_certificate)) {
@@ -1820,6 +1864,12 @@ RTCStatsCollector::PrepareTransportCertificateStats_n(
       certificate_stats_pair.remote = remote_cert_chain->GetStats();
     }
 
+    // Until the DTLS handshake completes there is no remote certificate yet,
+    // so only complete pairs are cached.
+    if (certificate_stats_pair.local && certificate_stats_pair.remote) {
+      cached_certificates_by_transport_.insert(
+          std::make_pair(transport_name, certificate_stats_pair.Copy()));
+    }
     transport_cert_stats.insert(
         std::make_pair(transport_name, std::move(certificate_stats_pair)));
   }
@@ -1830,14 +1880,9 @@ std::vector<RTCStatsCollector::RtpTransceiverStatsInfo>
 RTCStatsCollector::PrepareTransceiverStatsInfos_s() const {
   std::vector<RtpTransceiverStatsInfo> transceiver_stats_infos;
 
-  // These are used to invoke GetStats for all the media channels together in
-  // one worker thread hop.
-  std::map<cricket::VoiceMediaChannel*,
-           std::unique_ptr<cricket::VoiceMediaInfo>>
-      voice_stats;
-  std::map<cricket::VideoMediaChannel*,
-           std::unique_ptr<cricket::VideoMediaInfo>>
-      video_stats;
+  // These are used to get the stats of all the media channels together.
+  MediaChannelStatsCache::VoiceStats voice_stats;
+  MediaChannelStatsCache::VideoStats video_stats;
 
   for (const auto& transceiver : pc_->GetTransceiversInternal()) {
     cricket::MediaType media_type = transceiver->media_type();
@@ -1862,33 +1907,20 @@ RTCStatsCollector::PrepareTransceiverStatsInfos_s() const {
       auto* voice_channel = static_cast<cricket::VoiceChannel*>(channel);
       RTC_DCHECK(voice_stats.find(voice_channel->media_channel()) ==
                  voice_stats.end());
-      voice_stats[voice_channel->media_channel()] =
-          std::make_unique<cricket::VoiceMediaInfo>();
+      voice_stats[voice_channel->media_channel()] = nullptr;
     } else if (media_type == cricket::MEDIA_TYPE_VIDEO) {
       auto* video_channel = static_cast<cricket::VideoChannel*>(channel);
       RTC_DCHECK(video_stats.find(video_channel->media_channel()) ==
                  video_stats.end());
-      video_stats[video_channel->media_channel()] =
-          std::make_unique<cricket::VideoMediaInfo>();
+      video_stats[video_channel->media_channel()] = nullptr;
     } else {
       RTC_NOTREACHED();
     }
   }
 
-  // Call GetStats for all media channels together on the worker thread in one
-  // hop.
-  worker_thread_->Invoke<void>(RTC_FROM_HERE, [&] {
-    for (const auto& entry : voice_stats) {
-      if (!entry.first->GetStats(entry.second.get())) {
-        RTC_LOG(LS_WARNING) << "Failed to get voice stats.";
-      }
-    }
-    for (const auto& entry : video_stats) {
-      if (!entry.first->GetStats(entry.second.get())) {
-        RTC_LOG(LS_WARNING) << "Failed to get video stats.";
-      }
-    }
-  });
+  // Get the stats of all media channels together, on the worker thread in one
+  // hop unless they are cached.
+  media_channel_stats_cache_->GetStats(&voice_stats, &video_stats);
 
   // Create the TrackMediaInfoMap for each transceiver stats object.
   for (auto& stats : transceiver_stats_infos) {
@@ -1900,15 +1932,18 @@ RTCStatsCollector::PrepareTransceiverStatsInfos_s() const {
       if (media_type == cricket::MEDIA_TYPE_AUDIO) {
         auto* voice_channel =
             static_cast<cricket::VoiceChannel*>(transceiver->channel());
-        RTC_DCHECK(voice_stats[voice_channel->media_channel()]);
         voice_media_info =
             std::move(voice_stats[voice_channel->media_channel()]);
+        // Channels that fail to get stats have none to report.
+        if (!voice_media_info)
+          voice_media_info = std::make_unique<cricket::VoiceMediaInfo>();
       } else if (media_type == cricket::MEDIA_TYPE_VIDEO) {
         auto* video_channel =
             static_cast<cricket::VideoChannel*>(transceiver->channel());
-        RTC_DCHECK(video_stats[video_channel->media_channel()]);
         video_media_info =
             std::move(video_stats[video_channel->media_channel()]);
+        if (!video_media_info)
+          video_media_info = std::make_unique<cricket::VideoMediaInfo>();
       }
     }
     std::vector<rtc::scoped_refptr<RtpSenderInternal>> senders;
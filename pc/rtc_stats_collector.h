@@ -25,6 +25,7 @@
 #include "call/call.h"
 #include "media/base/media_channel.h"
 #include "pc/data_channel.h"
+#include "pc/media_channel_stats_cache.h"
 #include "pc/peer_connection_internal.h"
 #include "pc/track_media_info_map.h"
 #include "rtc_base/event.h"
@@ -45,9 +46,13 @@ class RtpReceiverInternal;
 class RTCStatsCollector : public virtual rtc::RefCountInterface,
                           public sigslot::has_slots<> {
  public:
+  // The media channel stats are gotten through |media_channel_stats_cache|,
+  // which must outlive the collector, if set. Otherwise they are gotten fresh
+  // for every report.
   static rtc::scoped_refptr<RTCStatsCollector> Create(
       PeerConnectionInternal* pc,
-      int64_t cache_lifetime_us = 50 * rtc::kNumMicrosecsPerMillisec);
+      int64_t cache_lifetime_us = 50 * rtc::kNumMicrosecsPerMillisec,
+      MediaChannelStatsCache* media_channel_stats_cache = nullptr);
 
   // Gets a recent stats report. If there is a report cached that is still fresh
   // it is returned, otherwise new stats are gathered and returned. A report is
@@ -65,8 +70,9 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // as: no RTP streams are received by selector). The result is empty.
   void GetStatsReport(rtc::scoped_refptr<RtpReceiverInternal> selector,
                       rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
-  // Clears the cache's reference to the most recent stats report. Subsequently
-  // calling |GetStatsReport| guarantees fresh stats.
+  // Clears the cache's reference to the most recent stats report, and the
+  // cached certificate stats. Subsequently calling |GetStatsReport| guarantees
+  // fresh stats.
   void ClearCachedStatsReport();
 
   // If there is a |GetStatsReport| requests in-flight, waits until it has been
@@ -74,12 +80,16 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   void WaitForPendingRequest();
 
  protected:
-  RTCStatsCollector(PeerConnectionInternal* pc, int64_t cache_lifetime_us);
+  RTCStatsCollector(PeerConnectionInternal* pc,
+                    int64_t cache_lifetime_us,
+                    MediaChannelStatsCache* media_channel_stats_cache);
   ~RTCStatsCollector();
 
   struct CertificateStatsPair {
     std::unique_ptr<rtc::SSLCertificateStats> local;
     std::unique_ptr<rtc::SSLCertificateStats> remote;
+
+    CertificateStatsPair Copy() const;
   };
 
   // Stats gathering on a particular thread. Virtual for the sake of testing.
@@ -214,13 +224,14 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   std::map<std::string, CertificateStatsPair>
   PrepareTransportCertificateStats_n(
       const std::map<std::string, cricket::TransportStats>&
-          transport_stats_by_name) const;
+          transport_stats_by_name);
   std::vector<RtpTransceiverStatsInfo> PrepareTransceiverStatsInfos_s() const;
   std::set<std::string> PrepareTransportNames_s() const;
 
   // Stats gathering on a particular thread.
   void ProducePartialResultsOnSignalingThread(int64_t timestamp_us);
-  void ProducePartialResultsOnNetworkThread(int64_t timestamp_us);
+  void ProducePartialResultsOnNetworkThread(int64_t timestamp_us,
+                                            bool clear_cached_certificates);
   // Merges |network_report_| into |partial_report_| and completes the request.
   // This is a NO-OP if |network_report_| is null.
   void MergeNetworkReport_s();
@@ -235,6 +246,9 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   rtc::Thread* const signaling_thread_;
   rtc::Thread* const worker_thread_;
   rtc::Thread* const network_thread_;
+  const std::unique_ptr<MediaChannelStatsCache>
+      owned_media_channel_stats_cache_;
+  MediaChannelStatsCache* const media_channel_stats_cache_;
 
   int num_pending_partial_reports_;
   int64_t partial_report_timestamp_us_;
@@ -270,6 +284,14 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   int64_t cache_timestamp_us_;
   int64_t cache_lifetime_us_;
   rtc::scoped_refptr<const RTCStatsReport> cached_report_;
+  // The certificate stats of the transports that have both a local and a
+  // remote certificate. Those do not change until the next negotiation, which
+  // clears the cache, and encoding and hashing them every time is costly. Only
+  // touched on the network thread.
+  std::map<std::string, CertificateStatsPair> cached_certificates_by_transport_;
+  // Set by ClearCachedStatsReport(), so that the next request clears
+  // |cached_certificates_by_transport_| on the network thread.
+  bool clear_cached_certificates_ = false;
 
   // Data recorded and maintained by the stats collector during its lifetime.
   // Some stats are produced from this record instead of other components.
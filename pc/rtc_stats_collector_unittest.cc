@@ -812,6 +812,48 @@ TEST_F(RTCStatsCollectorTest, CollectRTCCertificateStatsSingle) {
   ExpectReportContainsCertificateInfo(report, *remote_certinfo);
 }
 
+TEST_F(RTCStatsCollectorTest, CertificateStatsAreCachedUntilCleared) {
+  const char kTransportName[] = "transport";
+
+  pc_->AddVoiceChannel("audio", kTransportName);
+
+  std::unique_ptr<CertificateInfo> local_certinfo =
+      CreateFakeCertificateAndInfoFromDers(
+          std::vector<std::string>({"(local) single certificate"}));
+  pc_->SetLocalCertificate(kTransportName, local_certinfo->certificate);
+  // Without a remote certificate nothing is cached.
+  stats_->GetStatsReport();
+
+  std::unique_ptr<CertificateInfo> remote_certinfo =
+      CreateFakeCertificateAndInfoFromDers(
+          std::vector<std::string>({"(remote) single certificate"}));
+  pc_->SetRemoteCertChain(
+      kTransportName,
+      remote_certinfo->certificate->GetSSLCertificateChain().Clone());
+  fake_clock_.AdvanceTime(TimeDelta::Millis(51));
+  rtc::scoped_refptr<const RTCStatsReport> report = stats_->GetStatsReport();
+  ExpectReportContainsCertificateInfo(report, *local_certinfo);
+  ExpectReportContainsCertificateInfo(report, *remote_certinfo);
+
+  // The certificates only change on negotiation, after which the cache is
+  // cleared, so later changes go unnoticed until then.
+  std::unique_ptr<CertificateInfo> new_remote_certinfo =
+      CreateFakeCertificateAndInfoFromDers(
+          std::vector<std::string>({"(remote) new certificate"}));
+  pc_->SetRemoteCertChain(
+      kTransportName,
+      new_remote_certinfo->certificate->GetSSLCertificateChain().Clone());
+  fake_clock_.AdvanceTime(TimeDelta::Millis(51));
+  report = stats_->GetStatsReport();
+  ExpectReportContainsCertificateInfo(report, *remote_certinfo);
+
+  report = stats_->GetFreshStatsReport();
+  ExpectReportContainsCertificateInfo(report, *local_certinfo);
+  ExpectReportContainsCertificateInfo(report, *new_remote_certinfo);
+  EXPECT_FALSE(report->Get("RTCCertificate_" +
+                           remote_certinfo->fingerprints[0]));
+}
+
 TEST_F(RTCStatsCollectorTest, CollectRTCCodecStats) {
   // Audio
   cricket::VoiceMediaInfo voice_media_info;
@@ -3004,7 +3046,7 @@ class FakeRTCStatsCollector : public RTCStatsCollector,
 
  protected:
   FakeRTCStatsCollector(PeerConnectionInternal* pc, int64_t cache_lifetime)
-      : RTCStatsCollector(pc, cache_lifetime),
+      : RTCStatsCollector(pc, cache_lifetime, nullptr),
         signaling_thread_(pc->signaling_thread()),
         worker_thread_(pc->worker_thread()),
         network_thread_(pc->network_thread()) {}
@@ -11,7 +11,9 @@
 #include "pc/rtp_transport.h"
 
 #include <errno.h>
+#include <string.h>
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -26,6 +28,18 @@
 #include "rtc_base/trace_event.h"
 
 namespace webrtc {
+namespace {
+
+constexpr size_t kReceiveBufferCapacity = 1500;
+
+}  // namespace
+
+RtpTransport::~RtpTransport() {
+  if (rtp_packet_transport_)
+    rtp_packet_transport_->SetPacketReceiver(nullptr);
+  if (rtcp_packet_transport_)
+    rtcp_packet_transport_->SetPacketReceiver(nullptr);
+}
 
 void RtpTransport::SetRtcpMuxEnabled(bool enable) {
   rtcp_mux_enabled_ = enable;
@@ -54,7 +68,8 @@ void RtpTransport::SetRtpPacketTransport(
   }
   if (rtp_packet_transport_) {
     rtp_packet_transport_->SignalReadyToSend.disconnect(this);
-    rtp_packet_transport_->SignalReadPacket.disconnect(this);
+    if (rtp_packet_transport_ != rtcp_packet_transport_)
+      rtp_packet_transport_->SetPacketReceiver(nullptr);
     rtp_packet_transport_->SignalNetworkRouteChanged.disconnect(this);
     rtp_packet_transport_->SignalWritableState.disconnect(this);
     rtp_packet_transport_->SignalSentPacket.disconnect(this);
@@ -64,8 +79,7 @@ void RtpTransport::SetRtpPacketTransport(
   if (new_packet_transport) {
     new_packet_transport->SignalReadyToSend.connect(
         this, &RtpTransport::OnReadyToSend);
-    new_packet_transport->SignalReadPacket.connect(this,
-                                                   &RtpTransport::OnReadPacket);
+    new_packet_transport->SetPacketReceiver(this);
     new_packet_transport->SignalNetworkRouteChanged.connect(
         this, &RtpTransport::OnNetworkRouteChanged);
     new_packet_transport->SignalWritableState.connect(
@@ -90,7 +104,8 @@ void RtpTransport::SetRtcpPacketTransport(
   }
   if (rtcp_packet_transport_) {
     rtcp_packet_transport_->SignalReadyToSend.disconnect(this);
-    rtcp_packet_transport_->SignalReadPacket.disconnect(this);
+    if (rtcp_packet_transport_ != rtp_packet_transport_)
+      rtcp_packet_transport_->SetPacketReceiver(nullptr);
     rtcp_packet_transport_->SignalNetworkRouteChanged.disconnect(this);
     rtcp_packet_transport_->SignalWritableState.disconnect(this);
     rtcp_packet_transport_->SignalSentPacket.disconnect(this);
@@ -100,8 +115,7 @@ void RtpTransport::SetRtcpPacketTransport(
   if (new_packet_transport) {
     new_packet_transport->SignalReadyToSend.connect(
         this, &RtpTransport::OnReadyToSend);
-    new_packet_transport->SignalReadPacket.connect(this,
-                                                   &RtpTransport::OnReadPacket);
+    new_packet_transport->SetPacketReceiver(this);
     new_packet_transport->SignalNetworkRouteChanged.connect(
         this, &RtpTransport::OnNetworkRouteChanged);
     new_packet_transport->SignalWritableState.connect(
@@ -230,7 +244,7 @@ void RtpTransport::OnSentPacket(rtc::PacketTransportInternal* packet_transport,
 
 void RtpTransport::OnRtpPacketReceived(rtc::CopyOnWriteBuffer packet,
                                        int64_t packet_time_us) {
-  DemuxPacket(packet, packet_time_us);
+  DemuxPacket(std::move(packet), packet_time_us);
 }
 
 void RtpTransport::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer packet,
@@ -262,7 +276,11 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
     return;
   }
 
-  rtc::CopyOnWriteBuffer packet(data, len);
+  // Most packets fit in an MTU sized buffer, which keeps the number of
+  // distinct pooled capacities down.
+  rtc::CopyOnWriteBuffer packet = receive_buffer_pool_.Create(
+      len, std::max(len, kReceiveBufferCapacity));
+  memcpy(packet.data(), data, len);
   if (packet_type == cricket::RtpPacketType::kRtcp) {
     OnRtcpPacketReceived(std::move(packet), packet_time_us);
   } else {
@@ -270,6 +288,14 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
   }
 }
 
+void RtpTransport::OnPacketTransportDestroyed(
+    rtc::PacketTransportInternal* transport) {
+  if (transport == rtp_packet_transport_)
+    rtp_packet_transport_ = nullptr;
+  if (transport == rtcp_packet_transport_)
+    rtcp_packet_transport_ = nullptr;
+}
+
 void RtpTransport::SetReadyToSend(bool rtcp, bool ready) {
   if (rtcp) {
     rtcp_ready_to_send_ = ready;
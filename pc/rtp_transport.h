@@ -15,26 +15,35 @@
 
 #include "call/rtp_demuxer.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "p2p/base/packet_transport_internal.h"
 #include "pc/rtp_transport_internal.h"
+#include "rtc_base/copy_on_write_buffer_pool.h"
+#include "rtc_base/memory/buffer_allocator.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 
 namespace rtc {
 
 class CopyOnWriteBuffer;
 struct PacketOptions;
-class PacketTransportInternal;
 
 }  // namespace rtc
 
 namespace webrtc {
 
-class RtpTransport : public RtpTransportInternal {
+class RtpTransport : public RtpTransportInternal,
+                     public rtc::PacketTransportReceiver {
  public:
   RtpTransport(const RtpTransport&) = delete;
   RtpTransport& operator=(const RtpTransport&) = delete;
 
+  // Must be created on the network thread, which received packets are placed
+  // near if it is bound to a NUMA node.
   explicit RtpTransport(bool rtcp_mux_enabled)
-      : rtcp_mux_enabled_(rtcp_mux_enabled) {}
+      : rtcp_mux_enabled_(rtcp_mux_enabled),
+        receive_buffer_pool_(
+            rtc::CopyOnWriteBufferPool::kDefaultMaxFreeBuffersPerSizeClass,
+            GetBufferAllocatorForCurrentThread()) {}
+  ~RtpTransport() override;
 
   bool rtcp_mux_enabled() const override { return rtcp_mux_enabled_; }
   void SetRtcpMuxEnabled(bool enable) override;
@@ -76,6 +85,11 @@ class RtpTransport : public RtpTransportInternal {
 
   bool UnregisterRtpDemuxerSink(RtpPacketSinkInterface* sink) override;
 
+  // Hit rate of the pool backing received packets.
+  rtc::CopyOnWriteBufferPool::Stats GetReceiveBufferPoolStats() const {
+    return receive_buffer_pool_.GetStats();
+  }
+
  protected:
   // These methods will be used in the subclasses.
   void DemuxPacket(rtc::CopyOnWriteBuffer packet, int64_t packet_time_us);
@@ -99,11 +113,14 @@ class RtpTransport : public RtpTransportInternal {
   void OnReadyToSend(rtc::PacketTransportInternal* transport);
   void OnSentPacket(rtc::PacketTransportInternal* packet_transport,
                     const rtc::SentPacket& sent_packet);
+  // rtc::PacketTransportReceiver implementation.
   void OnReadPacket(rtc::PacketTransportInternal* transport,
                     const char* data,
                     size_t len,
                     const int64_t& packet_time_us,
-                    int flags);
+                    int flags) override;
+  void OnPacketTransportDestroyed(
+      rtc::PacketTransportInternal* transport) override;
 
   // Updates "ready to send" for an individual channel and fires
   // SignalReadyToSend.
@@ -126,6 +143,10 @@ class RtpTransport : public RtpTransportInternal {
 
   // Used for identifying the MID for RtpDemuxer.
   RtpHeaderExtensionMap header_extension_map_;
+
+  // Storage for received packets; recycled once the demuxed packet and any
+  // copies held by the receive pipeline are gone.
+  rtc::CopyOnWriteBufferPool receive_buffer_pool_;
 };
 
 }  // namespace webrtc
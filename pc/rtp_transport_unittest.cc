@@ -11,6 +11,7 @@
 #include "pc/rtp_transport.h"
 
 #include <cstdint>
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -322,4 +323,44 @@ TEST(RtpTransportTest, DontSignalUnhandledRtpPayloadType) {
   transport.UnregisterRtpDemuxerSink(&observer);
 }
 
+// Test that packets stop arriving from a packet transport that is replaced,
+// and that the RtpTransport forgets a packet transport that is destroyed.
+TEST(RtpTransportTest, StopsReceivingFromReplacedPacketTransport) {
+  RtpTransport transport(kMuxDisabled);
+  TransportObserver observer(&transport);
+  auto fake_rtp = std::make_unique<rtc::FakePacketTransport>("fake_rtp");
+  fake_rtp->SetDestination(fake_rtp.get(), true);
+  transport.SetRtpPacketTransport(fake_rtp.get());
+
+  const unsigned char rtcp_data[] = {0x80, 73, 0, 0};
+  const char* data = reinterpret_cast<const char*>(rtcp_data);
+  fake_rtp->SendPacket(data, sizeof(rtcp_data), rtc::PacketOptions(), 0);
+  EXPECT_EQ(1, observer.rtcp_count());
+
+  rtc::FakePacketTransport other_rtp("other_rtp");
+  transport.SetRtpPacketTransport(&other_rtp);
+  fake_rtp->SendPacket(data, sizeof(rtcp_data), rtc::PacketOptions(), 0);
+  EXPECT_EQ(1, observer.rtcp_count());
+
+  transport.SetRtpPacketTransport(fake_rtp.get());
+  fake_rtp.reset();
+  EXPECT_EQ(nullptr, transport.rtp_packet_transport());
+}
+
+// Test that one packet transport can carry both RTP and RTCP.
+TEST(RtpTransportTest, ReceivesFromPacketTransportUsedForRtpAndRtcp) {
+  RtpTransport transport(kMuxDisabled);
+  TransportObserver observer(&transport);
+  rtc::FakePacketTransport fake_rtp("fake_rtp");
+  fake_rtp.SetDestination(&fake_rtp, true);
+  transport.SetRtpPacketTransport(&fake_rtp);
+  transport.SetRtcpPacketTransport(&fake_rtp);
+  transport.SetRtcpPacketTransport(nullptr);
+
+  const unsigned char rtcp_data[] = {0x80, 73, 0, 0};
+  fake_rtp.SendPacket(reinterpret_cast<const char*>(rtcp_data),
+                      sizeof(rtcp_data), rtc::PacketOptions(), 0);
+  EXPECT_EQ(1, observer.rtcp_count());
+}
+
 }  // namespace webrtc
@@ -13,9 +13,11 @@
 #include "absl/base/attributes.h"
 #include "media/base/rtp_utils.h"
 #include "pc/external_hmac.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ssl_stream_adapter.h"
+#include "rtc_base/time_utils.h"
 #include "system_wrappers/include/metrics.h"
 #include "third_party/libsrtp/include/srtp.h"
 #include "third_party/libsrtp/include/srtp_priv.h"
@@ -74,25 +76,11 @@ bool SrtpSession::ProtectRtp(void* p, int in_len, int max_len, int* out_len) {
     return false;
   }
 
-  int need_len = in_len + rtp_auth_tag_len_;  // NOLINT
-  if (max_len < need_len) {
-    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packet: The buffer length "
-                        << max_len << " is less than the needed " << need_len;
-    return false;
-  }
-
-  *out_len = in_len;
-  int err = srtp_protect(session_, p, out_len);
-  int seq_num;
-  GetRtpSeqNum(p, in_len, &seq_num);
-  if (err != srtp_err_status_ok) {
-    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packet, seqnum=" << seq_num
-                        << ", err=" << err
-                        << ", last seqnum=" << last_send_seq_num_;
-    return false;
-  }
-  last_send_seq_num_ = seq_num;
-  return true;
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kSrtp);
+  int64_t start_ns = rtc::TimeNanos();
+  bool success = DoProtectRtp(p, in_len, max_len, out_len);
+  crypto_stats_.crypto_time_ns += rtc::TimeNanos() - start_ns;
+  return success;
 }
 
 bool SrtpSession::ProtectRtp(void* p,
@@ -121,7 +109,11 @@ bool SrtpSession::ProtectRtcp(void* p, int in_len, int max_len, int* out_len) {
   }
 
   *out_len = in_len;
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kSrtp);
+  int64_t start_ns = rtc::TimeNanos();
   int err = srtp_protect_rtcp(session_, p, out_len);
+  crypto_stats_.crypto_time_ns += rtc::TimeNanos() - start_ns;
+  ++crypto_stats_.packets;
   if (err != srtp_err_status_ok) {
     RTC_LOG(LS_WARNING) << "Failed to protect SRTCP packet, err=" << err;
     return false;
@@ -136,23 +128,11 @@ bool SrtpSession::UnprotectRtp(void* p, int in_len, int* out_len) {
     return false;
   }
 
-  *out_len = in_len;
-  int err = srtp_unprotect(session_, p, out_len);
-  if (err != srtp_err_status_ok) {
-    // Limit the error logging to avoid excessive logs when there are lots of
-    // bad packets.
-    const int kFailureLogThrottleCount = 100;
-    if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
-      RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err
-                          << ", previous failure count: "
-                          << decryption_failure_count_;
-    }
-    ++decryption_failure_count_;
-    RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtpUnprotectError",
-                              static_cast<int>(err), kSrtpErrorCodeBoundary);
-    return false;
-  }
-  return true;
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kSrtp);
+  int64_t start_ns = rtc::TimeNanos();
+  bool success = DoUnprotectRtp(p, in_len, out_len);
+  crypto_stats_.crypto_time_ns += rtc::TimeNanos() - start_ns;
+  return success;
 }
 
 bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
@@ -163,7 +143,11 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   }
 
   *out_len = in_len;
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kSrtp);
+  int64_t start_ns = rtc::TimeNanos();
   int err = srtp_unprotect_rtcp(session_, p, out_len);
+  crypto_stats_.crypto_time_ns += rtc::TimeNanos() - start_ns;
+  ++crypto_stats_.packets;
   if (err != srtp_err_status_ok) {
     RTC_LOG(LS_WARNING) << "Failed to unprotect SRTCP packet, err=" << err;
     RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtcpUnprotectError",
@@ -173,6 +157,54 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+size_t SrtpSession::ProtectRtpPackets(rtc::ArrayView<Packet> packets) {
+  RTC_DCHECK(thread_checker_.IsCurrent());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    for (Packet& packet : packets)
+      packet.success = false;
+    return 0;
+  }
+
+  size_t num_protected = 0;
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kSrtp);
+  int64_t start_ns = rtc::TimeNanos();
+  for (Packet& packet : packets) {
+    packet.success =
+        DoProtectRtp(packet.data, packet.len, packet.max_len, &packet.len);
+    if (packet.success)
+      ++num_protected;
+  }
+  crypto_stats_.crypto_time_ns += rtc::TimeNanos() - start_ns;
+  return num_protected;
+}
+
+size_t SrtpSession::UnprotectRtpPackets(rtc::ArrayView<Packet> packets) {
+  RTC_DCHECK(thread_checker_.IsCurrent());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    for (Packet& packet : packets)
+      packet.success = false;
+    return 0;
+  }
+
+  size_t num_unprotected = 0;
+  rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kSrtp);
+  int64_t start_ns = rtc::TimeNanos();
+  for (Packet& packet : packets) {
+    packet.success = DoUnprotectRtp(packet.data, packet.len, &packet.len);
+    if (packet.success)
+      ++num_unprotected;
+  }
+  crypto_stats_.crypto_time_ns += rtc::TimeNanos() - start_ns;
+  return num_unprotected;
+}
+
+SrtpSession::CryptoStats SrtpSession::GetCryptoStats() const {
+  RTC_DCHECK(thread_checker_.IsCurrent());
+  return crypto_stats_;
+}
+
 bool SrtpSession::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
   RTC_DCHECK(thread_checker_.IsCurrent());
   RTC_DCHECK(IsExternalAuthActive());
@@ -218,6 +250,50 @@ bool SrtpSession::IsExternalAuthActive() const {
   return external_auth_active_;
 }
 
+bool SrtpSession::DoProtectRtp(void* p, int in_len, int max_len, int* out_len) {
+  int need_len = in_len + rtp_auth_tag_len_;  // NOLINT
+  if (max_len < need_len) {
+    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packet: The buffer length "
+                        << max_len << " is less than the needed " << need_len;
+    return false;
+  }
+
+  *out_len = in_len;
+  int err = srtp_protect(session_, p, out_len);
+  ++crypto_stats_.packets;
+  int seq_num;
+  GetRtpSeqNum(p, in_len, &seq_num);
+  if (err != srtp_err_status_ok) {
+    RTC_LOG(LS_WARNING) << "Failed to protect SRTP packet, seqnum=" << seq_num
+                        << ", err=" << err
+                        << ", last seqnum=" << last_send_seq_num_;
+    return false;
+  }
+  last_send_seq_num_ = seq_num;
+  return true;
+}
+
+bool SrtpSession::DoUnprotectRtp(void* p, int in_len, int* out_len) {
+  *out_len = in_len;
+  int err = srtp_unprotect(session_, p, out_len);
+  ++crypto_stats_.packets;
+  if (err != srtp_err_status_ok) {
+    // Limit the error logging to avoid excessive logs when there are lots of
+    // bad packets.
+    const int kFailureLogThrottleCount = 100;
+    if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
+      RTC_LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err
+                          << ", previous failure count: "
+                          << decryption_failure_count_;
+    }
+    ++decryption_failure_count_;
+    RTC_HISTOGRAM_ENUMERATION("WebRTC.PeerConnection.SrtpUnprotectError",
+                              static_cast<int>(err), kSrtpErrorCodeBoundary);
+    return false;
+  }
+  return true;
+}
+
 bool SrtpSession::GetSendStreamPacketIndex(void* p,
                                            int in_len,
                                            int64_t* index) {
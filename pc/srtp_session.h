@@ -11,8 +11,11 @@
 #ifndef PC_SRTP_SESSION_H_
 #define PC_SRTP_SESSION_H_
 
+#include <stdint.h>
+
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/scoped_refptr.h"
 #include "rtc_base/thread_checker.h"
 
@@ -30,6 +33,26 @@ void ProhibitLibsrtpInitialization();
 // Class that wraps a libSRTP session.
 class SrtpSession {
  public:
+  // An RTP packet for the batch methods below, protected or unprotected
+  // in-place.
+  struct Packet {
+    void* data = nullptr;
+    // Length of the packet, updated when the packet was processed.
+    int len = 0;
+    // Size of the buffer at |data|. Only used for protection.
+    int max_len = 0;
+    // Set by the batch methods.
+    bool success = false;
+  };
+
+  struct CryptoStats {
+    // Number of RTP and RTCP packets handed to libsrtp, including the ones
+    // that failed.
+    int64_t packets = 0;
+    // The time spent protecting or unprotecting those packets.
+    int64_t crypto_time_ns = 0;
+  };
+
   SrtpSession();
   ~SrtpSession();
 
@@ -70,6 +93,15 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Protects/unprotects a batch of RTP packets in the order given. Each packet
+  // gets the same result as from ProtectRtp()/UnprotectRtp(), but the session
+  // checks and the timing for GetCryptoStats() are done once per batch.
+  // Returns the number of packets that succeeded.
+  size_t ProtectRtpPackets(rtc::ArrayView<Packet> packets);
+  size_t UnprotectRtpPackets(rtc::ArrayView<Packet> packets);
+
+  CryptoStats GetCryptoStats() const;
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -104,6 +136,9 @@ class SrtpSession {
                  const uint8_t* key,
                  size_t len,
                  const std::vector<int>& extension_ids);
+  // Protect/unprotect a single RTP packet with an initialized session.
+  bool DoProtectRtp(void* data, int in_len, int max_len, int* out_len);
+  bool DoUnprotectRtp(void* data, int in_len, int* out_len);
   // Returns send stream current packet index from srtp db.
   bool GetSendStreamPacketIndex(void* data, int in_len, int64_t* index);
 
@@ -128,6 +163,7 @@ class SrtpSession {
   bool external_auth_active_ = false;
   bool external_auth_enabled_ = false;
   int decryption_failure_count_ = 0;
+  CryptoStats crypto_stats_;
   RTC_DISALLOW_COPY_AND_ASSIGN(SrtpSession);
 };
 
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+#include <vector>
+
+#include "pc/srtp_session.h"
+#include "rtc_base/byte_order.h"
+#include "rtc_base/ssl_stream_adapter.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace cricket {
+namespace {
+
+constexpr uint8_t kTestKey[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
+constexpr size_t kTestKeyLen = 30;
+constexpr int kRtpHeaderSize = 12;
+constexpr int kPayloadSize = 1100;
+// Room for the authentication tag.
+constexpr int kMaxPacketSize = kRtpHeaderSize + kPayloadSize + 16;
+
+std::vector<char> CreateRtpPacket(uint16_t sequence_number) {
+  std::vector<char> packet(kMaxPacketSize, 0x55);
+  packet[0] = 0x80;
+  packet[1] = 96;
+  rtc::SetBE16(&packet[2], sequence_number);
+  rtc::SetBE32(&packet[4], sequence_number * 3000);
+  rtc::SetBE32(&packet[8], 0x12345678);
+  return packet;
+}
+
+// Reports the time in ms to process 1000 packets.
+void ReportResult(const std::string& user_story,
+                  int64_t elapsed_us,
+                  int num_packets) {
+  webrtc::test::PrintResult("srtp_session", "", user_story,
+                            static_cast<double>(elapsed_us) / num_packets,
+                            "ms", /*important=*/false,
+                            webrtc::test::ImproveDirection::kSmallerIsBetter);
+}
+
+}  // namespace
+
+TEST(SrtpSessionPerformanceTest, ProtectAndUnprotectRtp) {
+  const int kNumPackets =
+      webrtc::field_trial::IsEnabled("WebRTC-QuickPerfTest") ? 1000 : 50000;
+  SrtpSession sender;
+  SrtpSession receiver;
+  ASSERT_TRUE(sender.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey,
+                             kTestKeyLen, std::vector<int>()));
+  ASSERT_TRUE(receiver.SetRecv(rtc::SRTP_AES128_CM_SHA1_80, kTestKey,
+                               kTestKeyLen, std::vector<int>()));
+
+  // SRTP rejects replayed packets, so each packet gets a new sequence number.
+  std::vector<std::vector<char>> packets;
+  packets.reserve(kNumPackets);
+  for (int i = 0; i < kNumPackets; ++i)
+    packets.push_back(CreateRtpPacket(i));
+  std::vector<int> packet_sizes(kNumPackets);
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    ASSERT_TRUE(sender.ProtectRtp(packets[i].data(),
+                                  kRtpHeaderSize + kPayloadSize,
+                                  kMaxPacketSize, &packet_sizes[i]));
+  }
+  ReportResult("protect_rtp", rtc::TimeMicros() - start_us, kNumPackets);
+
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumPackets; ++i) {
+    int unprotected_size = 0;
+    ASSERT_TRUE(receiver.UnprotectRtp(packets[i].data(), packet_sizes[i],
+                                      &unprotected_size));
+  }
+  ReportResult("unprotect_rtp", rtc::TimeMicros() - start_us, kNumPackets);
+}
+
+}  // namespace cricket
@@ -190,6 +190,46 @@ TEST_F(SrtpSessionTest, TestBuffersTooSmall) {
                                sizeof(rtcp_packet_) - 14, &out_len));
 }
 
+// Test that a batch of packets is protected and unprotected like the same
+// packets one at a time, and that bad packets only fail themselves.
+TEST_F(SrtpSessionTest, TestProtectAndUnprotectBatch) {
+  EXPECT_TRUE(s1_.SetSend(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  EXPECT_TRUE(s2_.SetRecv(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  constexpr size_t kNumPackets = 3;
+  char packets[kNumPackets][sizeof(rtp_packet_)];
+  cricket::SrtpSession::Packet batch[kNumPackets];
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    memcpy(packets[i], kPcmuFrame, rtp_len_);
+    SetBE16(packets[i] + 2, static_cast<uint16_t>(i + 1));
+    batch[i].data = packets[i];
+    batch[i].len = rtp_len_;
+    batch[i].max_len = sizeof(packets[i]);
+  }
+  // Too small to fit the auth tag.
+  batch[1].max_len = rtp_len_;
+
+  EXPECT_EQ(s1_.ProtectRtpPackets(batch), 2u);
+  EXPECT_TRUE(batch[0].success);
+  EXPECT_FALSE(batch[1].success);
+  EXPECT_TRUE(batch[2].success);
+  EXPECT_EQ(batch[0].len,
+            rtp_len_ + rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80));
+  EXPECT_EQ(s1_.GetCryptoStats().packets, 2);
+
+  // The packet that was not protected fails authentication.
+  EXPECT_EQ(s2_.UnprotectRtpPackets(batch), 2u);
+  EXPECT_FALSE(batch[1].success);
+  for (int i : {0, 2}) {
+    EXPECT_TRUE(batch[i].success);
+    EXPECT_EQ(batch[i].len, rtp_len_);
+    EXPECT_EQ(0, memcmp(packets[i] + 4, kPcmuFrame + 4, rtp_len_ - 4));
+  }
+  EXPECT_EQ(s2_.GetCryptoStats().packets, 3);
+  EXPECT_GE(s2_.GetCryptoStats().crypto_time_ns, 0);
+}
+
 TEST_F(SrtpSessionTest, TestReplay) {
   static const uint16_t kMaxSeqnum = static_cast<uint16_t>(-1);
   static const uint16_t seqnum_big = 62275;
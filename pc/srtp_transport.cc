@@ -33,6 +33,26 @@
 #include "rtc_base/zero_memory.h"
 
 namespace webrtc {
+namespace {
+
+// Shrinks or grows |packets| to the lengths after protection/unprotection, and
+// removes the packets that failed.
+void ApplyBatchResults(
+    rtc::ArrayView<const cricket::SrtpSession::Packet> batch,
+    std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  RTC_DCHECK_EQ(batch.size(), packets->size());
+  size_t num_succeeded = 0;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (!batch[i].success)
+      continue;
+    if (num_succeeded != i)
+      (*packets)[num_succeeded] = std::move((*packets)[i]);
+    (*packets)[num_succeeded++].SetSize(batch[i].len);
+  }
+  packets->resize(num_succeeded);
+}
+
+}  // namespace
 
 SrtpTransport::SrtpTransport(bool rtcp_mux_enabled)
     : RtpTransport(rtcp_mux_enabled) {}
@@ -434,6 +454,62 @@ bool SrtpTransport::UnprotectRtcp(void* p, int in_len, int* out_len) {
   }
 }
 
+bool SrtpTransport::ProtectRtpPackets(
+    std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_WARNING) << "Failed to ProtectRtpPackets: SRTP not active";
+    return false;
+  }
+  if (IsExternalAuthActive()) {
+    RTC_LOG(LS_WARNING)
+        << "Failed to ProtectRtpPackets: external auth is not supported";
+    return false;
+  }
+  RTC_CHECK(send_session_);
+  TRACE_EVENT0("webrtc", "SRTP Encode");
+  const size_t overhead = send_session_->GetSrtpOverhead();
+  batch_.resize(packets->size());
+  for (size_t i = 0; i < packets->size(); ++i) {
+    rtc::CopyOnWriteBuffer& packet = (*packets)[i];
+    packet.EnsureCapacity(packet.size() + overhead);
+    batch_[i].data = packet.data();
+    batch_[i].len = rtc::checked_cast<int>(packet.size());
+    batch_[i].max_len = rtc::checked_cast<int>(packet.capacity());
+  }
+  send_session_->ProtectRtpPackets(batch_);
+  ApplyBatchResults(batch_, packets);
+  return true;
+}
+
+bool SrtpTransport::UnprotectRtpPackets(
+    std::vector<rtc::CopyOnWriteBuffer>* packets) {
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_WARNING) << "Failed to UnprotectRtpPackets: SRTP not active";
+    return false;
+  }
+  RTC_CHECK(recv_session_);
+  TRACE_EVENT0("webrtc", "SRTP Decode");
+  batch_.resize(packets->size());
+  for (size_t i = 0; i < packets->size(); ++i) {
+    rtc::CopyOnWriteBuffer& packet = (*packets)[i];
+    batch_[i].data = packet.data();
+    batch_[i].len = rtc::checked_cast<int>(packet.size());
+  }
+  recv_session_->UnprotectRtpPackets(batch_);
+  ApplyBatchResults(batch_, packets);
+  return true;
+}
+
+cricket::SrtpSession::CryptoStats SrtpTransport::GetSendCryptoStats() const {
+  return send_session_ ? send_session_->GetCryptoStats()
+                       : cricket::SrtpSession::CryptoStats();
+}
+
+cricket::SrtpSession::CryptoStats SrtpTransport::GetRecvCryptoStats() const {
+  return recv_session_ ? recv_session_->GetCryptoStats()
+                       : cricket::SrtpSession::CryptoStats();
+}
+
 bool SrtpTransport::GetRtpAuthParams(uint8_t** key,
                                      int* key_len,
                                      int* tag_len) {
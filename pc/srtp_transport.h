@@ -52,6 +52,24 @@ class SrtpTransport : public RtpTransport {
                       const rtc::PacketOptions& options,
                       int flags) override;
 
+  // Protects a batch of RTP packets in-place with a single call into the send
+  // session, growing the buffers to fit the auth tag as needed. Unlike
+  // SendRtpPacket(), the packets are not sent. Packets that fail to be
+  // protected are removed from |packets|. Returns false if SRTP is not active
+  // or external auth is active, which is not supported here.
+  bool ProtectRtpPackets(std::vector<rtc::CopyOnWriteBuffer>* packets);
+
+  // Unprotects a batch of received RTP packets in-place with a single call
+  // into the receive session. Unlike received packets, the packets are not
+  // demuxed. Packets that fail to be unprotected are removed from |packets|.
+  // Returns false if SRTP is not active.
+  bool UnprotectRtpPackets(std::vector<rtc::CopyOnWriteBuffer>* packets);
+
+  // Returns the crypto stats of the RTP send/recv sessions, or empty stats if
+  // SRTP is not active.
+  cricket::SrtpSession::CryptoStats GetSendCryptoStats() const;
+  cricket::SrtpSession::CryptoStats GetRecvCryptoStats() const;
+
   // The transport becomes active if the send_session_ and recv_session_ are
   // created.
   bool IsSrtpActive() const override;
@@ -167,6 +185,9 @@ class SrtpTransport : public RtpTransport {
   int rtp_abs_sendtime_extn_id_ = -1;
 
   int decryption_failure_count_ = 0;
+
+  // Reused by the batch methods.
+  std::vector<cricket::SrtpSession::Packet> batch_;
 };
 
 }  // namespace webrtc
@@ -501,7 +501,20 @@ const char* AdapterTypeToStatsType(rtc::AdapterType type) {
 }
 
 StatsCollector::StatsCollector(PeerConnectionInternal* pc)
+    : StatsCollector(pc, nullptr) {}
+
+StatsCollector::StatsCollector(
+    PeerConnectionInternal* pc,
+    MediaChannelStatsCache* media_channel_stats_cache)
     : pc_(pc),
+      owned_media_channel_stats_cache_(
+          media_channel_stats_cache
+              ? nullptr
+              : std::make_unique<MediaChannelStatsCache>(pc->worker_thread(),
+                                                         0)),
+      media_channel_stats_cache_(media_channel_stats_cache
+                                     ? media_channel_stats_cache
+                                     : owned_media_channel_stats_cache_.get()),
       stats_gathering_started_(0),
       use_standard_bytes_stats_(
           webrtc::field_trial::IsEnabled(kUseStandardBytesStats)) {
@@ -955,7 +968,14 @@ class MediaChannelStatsGatherer {
  public:
   virtual ~MediaChannelStatsGatherer() = default;
 
-  virtual bool GetStatsOnWorkerThread() = 0;
+  // Adds the media channel to |voice_stats| or |video_stats|.
+  virtual void AddMediaChannel(
+      MediaChannelStatsCache::VoiceStats* voice_stats,
+      MediaChannelStatsCache::VideoStats* video_stats) const = 0;
+  // Takes the stats of the media channel from |voice_stats| or |video_stats|.
+  // Returns false if there are none.
+  virtual bool TakeStats(MediaChannelStatsCache::VoiceStats* voice_stats,
+                         MediaChannelStatsCache::VideoStats* video_stats) = 0;
 
   virtual void ExtractStats(StatsCollector* collector) const = 0;
 
@@ -990,8 +1010,20 @@ class VoiceMediaChannelStatsGatherer final : public MediaChannelStatsGatherer {
     RTC_DCHECK(voice_media_channel_);
   }
 
-  bool GetStatsOnWorkerThread() override {
-    return voice_media_channel_->GetStats(&voice_media_info);
+  void AddMediaChannel(
+      MediaChannelStatsCache::VoiceStats* voice_stats,
+      MediaChannelStatsCache::VideoStats* video_stats) const override {
+    (*voice_stats)[voice_media_channel_] = nullptr;
+  }
+
+  bool TakeStats(MediaChannelStatsCache::VoiceStats* voice_stats,
+                 MediaChannelStatsCache::VideoStats* video_stats) override {
+    std::unique_ptr<cricket::VoiceMediaInfo>& info =
+        (*voice_stats)[voice_media_channel_];
+    if (!info)
+      return false;
+    voice_media_info = std::move(*info);
+    return true;
   }
 
   void ExtractStats(StatsCollector* collector) const override {
@@ -1022,8 +1054,20 @@ class VideoMediaChannelStatsGatherer final : public MediaChannelStatsGatherer {
     RTC_DCHECK(video_media_channel_);
   }
 
-  bool GetStatsOnWorkerThread() override {
-    return video_media_channel_->GetStats(&video_media_info);
+  void AddMediaChannel(
+      MediaChannelStatsCache::VoiceStats* voice_stats,
+      MediaChannelStatsCache::VideoStats* video_stats) const override {
+    (*video_stats)[video_media_channel_] = nullptr;
+  }
+
+  bool TakeStats(MediaChannelStatsCache::VoiceStats* voice_stats,
+                 MediaChannelStatsCache::VideoStats* video_stats) override {
+    std::unique_ptr<cricket::VideoMediaInfo>& info =
+        (*video_stats)[video_media_channel_];
+    if (!info)
+      return false;
+    video_media_info = std::move(*info);
+    return true;
   }
 
   void ExtractStats(StatsCollector* collector) const override {
@@ -1057,6 +1101,8 @@ void StatsCollector::ExtractMediaInfo() {
   RTC_DCHECK_RUN_ON(pc_->signaling_thread());
 
   std::vector<std::unique_ptr<MediaChannelStatsGatherer>> gatherers;
+  MediaChannelStatsCache::VoiceStats voice_stats;
+  MediaChannelStatsCache::VideoStats video_stats;
 
   {
     rtc::Thread::ScopedDisallowBlockingCalls no_blocking_calls;
@@ -1078,26 +1124,25 @@ void StatsCollector::ExtractMediaInfo() {
         gatherer->receiver_track_id_by_ssrc.insert(std::make_pair(
             receiver->internal()->ssrc(), receiver->track()->id()));
       }
+      gatherer->AddMediaChannel(&voice_stats, &video_stats);
       gatherers.push_back(std::move(gatherer));
     }
   }
 
-  pc_->worker_thread()->Invoke<void>(RTC_FROM_HERE, [&] {
-    rtc::Thread::ScopedDisallowBlockingCalls no_blocking_calls;
-    for (auto it = gatherers.begin(); it != gatherers.end();
-         /* incremented manually */) {
-      MediaChannelStatsGatherer* gatherer = it->get();
-      if (!gatherer->GetStatsOnWorkerThread()) {
-        RTC_LOG(LS_ERROR) << "Failed to get media channel stats for mid="
-                          << gatherer->mid;
-        it = gatherers.erase(it);
-        continue;
-      }
-      ++it;
-    }
-  });
+  media_channel_stats_cache_->GetStats(&voice_stats, &video_stats);
 
   rtc::Thread::ScopedDisallowBlockingCalls no_blocking_calls;
+  for (auto it = gatherers.begin(); it != gatherers.end();
+       /* incremented manually */) {
+    MediaChannelStatsGatherer* gatherer = it->get();
+    if (!gatherer->TakeStats(&voice_stats, &video_stats)) {
+      RTC_LOG(LS_ERROR) << "Failed to get media channel stats for mid="
+                        << gatherer->mid;
+      it = gatherers.erase(it);
+      continue;
+    }
+    ++it;
+  }
 
   bool has_remote_audio = false;
   for (const auto& gatherer : gatherers) {
@@ -26,6 +26,7 @@
 #include "api/peer_connection_interface.h"
 #include "api/stats_types.h"
 #include "p2p/base/port.h"
+#include "pc/media_channel_stats_cache.h"
 #include "pc/peer_connection_internal.h"
 #include "rtc_base/network_constants.h"
 #include "rtc_base/ssl_certificate.h"
@@ -49,6 +50,10 @@ class StatsCollector {
   // The caller is responsible for ensuring that the pc outlives the
   // StatsCollector instance.
   explicit StatsCollector(PeerConnectionInternal* pc);
+  // Gets the media channel stats through |media_channel_stats_cache|, which
+  // must outlive the StatsCollector, instead of fresh on every update.
+  StatsCollector(PeerConnectionInternal* pc,
+                 MediaChannelStatsCache* media_channel_stats_cache);
   virtual ~StatsCollector();
 
   // Adds a MediaStream with tracks that can be used as a |selector| in a call
@@ -144,6 +149,9 @@ class StatsCollector {
   TrackIdMap track_ids_;
   // Raw pointer to the peer connection the statistics are gathered from.
   PeerConnectionInternal* const pc_;
+  const std::unique_ptr<MediaChannelStatsCache>
+      owned_media_channel_stats_cache_;
+  MediaChannelStatsCache* const media_channel_stats_cache_;
   double stats_gathering_started_;
   const bool use_standard_bytes_stats_;
 
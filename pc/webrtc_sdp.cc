@@ -25,6 +25,7 @@
 
 #include "absl/algorithm/container.h"
 #include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
 #include "api/candidate.h"
 #include "api/crypto_params.h"
 #include "api/jsep_ice_candidate.h"
@@ -239,6 +240,12 @@ static const char kAltProtocolLine[] = "x-alt-protocol";
 // types.
 const int kWildcardPayloadType = -1;
 
+// Rough size of a serialized media section with a typical set of codecs,
+// header extensions and SSRCs, used to size the output of SdpSerialize() up
+// front. Offers with hundreds of m-lines would otherwise be reallocated many
+// times as they grow.
+static const size_t kMediaSectionSizeEstimate = 1024;
+
 struct SsrcInfo {
   uint32_t ssrc_id;
   std::string cname;
@@ -485,7 +492,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturnChar)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Assign in place, so that a |line| reused across calls keeps its buffer.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -515,7 +523,7 @@ static void InitLine(const char type,
                      const std::string& value,
                      rtc::StringBuilder* os) {
   os->Clear();
-  *os << std::string(1, type) << kSdpDelimiterEqual << value;
+  *os << absl::string_view(&type, 1) << kSdpDelimiterEqual << value;
 }
 
 // Init |os| to "a=|attribute|".
@@ -581,9 +589,12 @@ static bool GetLineWithType(const std::string& message,
   return true;
 }
 
+// Takes |attribute| as a string_view, since each attribute line is matched
+// against most of the attribute name constants in turn.
 static bool HasAttribute(const std::string& line,
-                         const std::string& attribute) {
-  if (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0) {
+                         absl::string_view attribute) {
+  if (line.compare(kLinePrefixLength, attribute.size(), attribute.data(),
+                   attribute.size()) == 0) {
     // Make sure that the match is not only a partial match. If length of
     // strings doesn't match, the next character of the line must be ':' or ' '.
     // This function is also used for media descriptions (e.g., "m=audio 9..."),
@@ -863,6 +874,7 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
   }
 
   std::string message;
+  message.reserve(desc->contents().size() * kMediaSectionSizeEstimate);
 
   // Session Description.
   AddLine(kSessionVersion, &message);
@@ -2891,22 +2903,9 @@ T GetCodecWithPayloadType(const std::vector<T>& codecs, int payload_type) {
 // Updates or creates a new codec entry in the audio description.
 template <class T, class U>
 void AddOrReplaceCodec(MediaContentDescription* content_desc, const U& codec) {
-  T* desc = static_cast<T*>(content_desc);
-  std::vector<U> codecs = desc->codecs();
-  bool found = false;
-  for (U& existing_codec : codecs) {
-    if (codec.id == existing_codec.id) {
-      // Overwrite existing codec with the new codec.
-      existing_codec = codec;
-      found = true;
-      break;
-    }
-  }
-  if (!found) {
-    desc->AddCodec(codec);
-    return;
-  }
-  desc->set_codecs(codecs);
+  // Replaces the codec in place rather than copying all the codecs of the
+  // description, since this is done for every rtpmap, fmtp and rtcp-fb line.
+  static_cast<T*>(content_desc)->AddOrReplaceCodec(codec);
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -38,10 +38,12 @@
 #include "pc/media_session.h"
 #include "pc/session_description.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/message_digest.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/ssl_fingerprint.h"
 #include "rtc_base/string_encode.h"
+#include "rtc_base/time_utils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -4716,3 +4718,118 @@ TEST_F(WebRtcSdpTest, DeserializeSessionDescriptionWithoutCname) {
                                 jdesc_.session_version()));
   EXPECT_TRUE(CompareSessionDescription(jdesc_, new_jdesc));
 }
+
+// An m-section similar to those browsers put in unified plan offers, with
+// "MID" and "SSRC" to be replaced.
+static const char kVideoSectionTemplate[] =
+    "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101\r\n"
+    "c=IN IP4 0.0.0.0\r\n"
+    "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+    "a=ice-ufrag:ufrag_video\r\n"
+    "a=ice-pwd:pwd_video\r\n"
+    "a=ice-options:trickle\r\n"
+    "a=fingerprint:sha-1 "
+    "4A:AD:B9:B1:3F:82:18:3B:54:02:12:DF:3E:5D:49:6B:19:E5:7C:AB\r\n"
+    "a=setup:actpass\r\n"
+    "a=mid:MID\r\n"
+    "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time\r\n"
+    "a=extmap:4 urn:ietf:params:rtp-hdrext:sdes:mid\r\n"
+    "a=sendrecv\r\n"
+    "a=msid:stream_MID track_MID\r\n"
+    "a=rtcp-mux\r\n"
+    "a=rtcp-rsize\r\n"
+    "a=rtpmap:96 VP8/90000\r\n"
+    "a=rtcp-fb:96 goog-remb\r\n"
+    "a=rtcp-fb:96 transport-cc\r\n"
+    "a=rtcp-fb:96 nack\r\n"
+    "a=rtcp-fb:96 nack pli\r\n"
+    "a=rtpmap:97 rtx/90000\r\n"
+    "a=fmtp:97 apt=96\r\n"
+    "a=rtpmap:98 VP9/90000\r\n"
+    "a=rtcp-fb:98 nack\r\n"
+    "a=fmtp:98 profile-id=0\r\n"
+    "a=rtpmap:99 rtx/90000\r\n"
+    "a=fmtp:99 apt=98\r\n"
+    "a=fmtp:100 level-asymmetry-allowed=1;packetization-mode=1;"
+    "profile-level-id=42e01f\r\n"
+    "a=rtpmap:100 H264/90000\r\n"
+    "a=rtcp-fb:100 nack\r\n"
+    "a=rtpmap:101 rtx/90000\r\n"
+    "a=fmtp:101 apt=100\r\n"
+    "a=ssrc:SSRC cname:stream_cname\r\n"
+    "a=ssrc:SSRC msid:stream_MID track_MID\r\n";
+
+// Creates an SDP with |num_sections| video m-sections, all bundled.
+static std::string CreateSdpWithManyVideoSections(int num_sections) {
+  std::string sdp =
+      "v=0\r\n"
+      "o=- 18446744069414584320 18446462598732840960 IN IP4 127.0.0.1\r\n"
+      "s=-\r\n"
+      "t=0 0\r\n"
+      "a=group:BUNDLE";
+  for (int i = 0; i < num_sections; ++i)
+    sdp += " " + rtc::ToString(i);
+  sdp += "\r\na=msid-semantic: WMS\r\n";
+  for (int i = 0; i < num_sections; ++i) {
+    sdp += absl::StrReplaceAll(
+        kVideoSectionTemplate,
+        {{"MID", rtc::ToString(i)}, {"SSRC", rtc::ToString(1000 + i)}});
+  }
+  return sdp;
+}
+
+TEST_F(WebRtcSdpTest, SerializeAndDeserializeManyMediaSections) {
+  const int kNumSections = 100;
+  JsepSessionDescription jdesc(kDummyType);
+  ASSERT_TRUE(
+      SdpDeserialize(CreateSdpWithManyVideoSections(kNumSections), &jdesc));
+  ASSERT_EQ(static_cast<size_t>(kNumSections),
+            jdesc.description()->contents().size());
+  for (const ContentInfo& content : jdesc.description()->contents()) {
+    const VideoContentDescription* video =
+        content.media_description()->as_video();
+    ASSERT_TRUE(video);
+    // The codecs are in the order of the m-line, whatever the order of their
+    // rtpmap and fmtp lines.
+    ASSERT_EQ(6u, video->codecs().size());
+    EXPECT_EQ(96, video->codecs()[0].id);
+    EXPECT_EQ(100, video->codecs()[4].id);
+    EXPECT_EQ("H264", video->codecs()[4].name);
+    EXPECT_EQ("1", video->codecs()[4].params.at("packetization-mode"));
+    EXPECT_EQ(4u, video->codecs()[0].feedback_params.params().size());
+    ASSERT_EQ(1u, video->streams().size());
+    EXPECT_EQ("stream_" + content.name, video->streams()[0].first_stream_id());
+  }
+
+  JsepSessionDescription jdesc_output(kDummyType);
+  ASSERT_TRUE(SdpDeserialize(webrtc::SdpSerialize(jdesc), &jdesc_output));
+  EXPECT_TRUE(CompareSessionDescription(jdesc, jdesc_output));
+}
+
+// Not run by default. Logs how long parsing and serializing an offer with
+// hundreds of m-sections takes.
+TEST_F(WebRtcSdpTest, DISABLED_BenchmarkManyMediaSections) {
+  const int kNumSections = 300;
+  const int kIterations = 20;
+  const std::string sdp = CreateSdpWithManyVideoSections(kNumSections);
+
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i) {
+    JsepSessionDescription jdesc(kDummyType);
+    ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+  }
+  const int64_t deserialize_us = rtc::TimeMicros() - start_us;
+
+  JsepSessionDescription jdesc(kDummyType);
+  ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+  size_t serialized_size = 0;
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i)
+    serialized_size = webrtc::SdpSerialize(jdesc).size();
+  const int64_t serialize_us = rtc::TimeMicros() - start_us;
+
+  RTC_LOG(LS_INFO) << "SdpDeserialize: " << deserialize_us / kIterations
+                   << " us for " << sdp.size() << " bytes";
+  RTC_LOG(LS_INFO) << "SdpSerialize: " << serialize_us / kIterations
+                   << " us for " << serialized_size << " bytes";
+}
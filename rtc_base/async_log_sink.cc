@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/async_log_sink.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+constexpr size_t AsyncLogSink::kDefaultMaxQueuedMessages;
+constexpr int AsyncLogSink::kDefaultMaxDelayMs;
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<LogSink> sink,
+                           size_t max_queued_messages,
+                           int max_delay_ms)
+    : sink_(std::move(sink)),
+      max_queued_messages_(max_queued_messages),
+      batch_size_(std::max<size_t>(max_queued_messages / 4, 1)),
+      max_delay_ms_(max_delay_ms),
+      writer_thread_(&AsyncLogSink::WriterThread,
+                     this,
+                     "AsyncLogSink",
+                     kLowPriority) {
+  RTC_DCHECK(sink_);
+  RTC_DCHECK_GT(max_queued_messages, 0);
+  RTC_DCHECK_GT(max_delay_ms, 0);
+  writer_thread_.Start();
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  stopping_.store(true, std::memory_order_relaxed);
+  wake_up_.Set();
+  writer_thread_.Stop();
+  // Write what was queued after the writer's last round.
+  WriteQueuedRecords();
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message) {
+  Record record;
+  record.type = Record::Type::kMessage;
+  record.message = message;
+  Enqueue(std::move(record));
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message,
+                                LoggingSeverity severity) {
+  Record record;
+  record.type = Record::Type::kMessageWithSeverity;
+  record.message = message;
+  record.severity = severity;
+  Enqueue(std::move(record));
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message,
+                                LoggingSeverity severity,
+                                const char* tag) {
+  Record record;
+  record.type = Record::Type::kMessageWithTag;
+  record.message = message;
+  record.severity = severity;
+  record.tag = tag;
+  Enqueue(std::move(record));
+}
+
+void AsyncLogSink::Flush() {
+  Event flushed;
+  Record record;
+  record.type = Record::Type::kFlush;
+  record.flushed = &flushed;
+  queue_.Push(std::move(record));
+  wake_up_.Set();
+  flushed.Wait(Event::kForever);
+}
+
+void AsyncLogSink::Enqueue(Record record) {
+  const size_t queued =
+      queued_messages_.fetch_add(1, std::memory_order_relaxed);
+  if (queued >= max_queued_messages_) {
+    queued_messages_.fetch_sub(1, std::memory_order_relaxed);
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    total_dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  queue_.Push(std::move(record));
+  // Only the message that completes a batch wakes the writer, so that most
+  // messages do not touch the event's lock.
+  if (queued + 1 == batch_size_) {
+    wake_up_.Set();
+  }
+}
+
+void AsyncLogSink::WriterThread(void* obj) {
+  static_cast<AsyncLogSink*>(obj)->WriteMessages();
+}
+
+void AsyncLogSink::WriteMessages() {
+  do {
+    wake_up_.Wait(max_delay_ms_);
+  } while (WriteQueuedRecords());
+}
+
+bool AsyncLogSink::WriteQueuedRecords() {
+  // Read before draining, so that messages enqueued before the destructor
+  // started are always written, by this round or by the destructor.
+  const bool stopping = stopping_.load(std::memory_order_relaxed);
+  Record record;
+  while (queue_.Pop(&record)) {
+    switch (record.type) {
+      case Record::Type::kMessage:
+        sink_->OnLogMessage(record.message);
+        break;
+      case Record::Type::kMessageWithSeverity:
+        sink_->OnLogMessage(record.message, record.severity);
+        break;
+      case Record::Type::kMessageWithTag:
+        sink_->OnLogMessage(record.message, record.severity, record.tag);
+        break;
+      case Record::Type::kFlush:
+        WriteDroppedMessages();
+        record.flushed->Set();
+        continue;
+    }
+    queued_messages_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  WriteDroppedMessages();
+  return !stopping;
+}
+
+void AsyncLogSink::WriteDroppedMessages() {
+  const size_t dropped =
+      dropped_messages_.exchange(0, std::memory_order_relaxed);
+  if (dropped > 0) {
+    sink_->OnLogMessage("AsyncLogSink dropped " + std::to_string(dropped) +
+                            " messages.\n",
+                        LS_WARNING);
+  }
+}
+
+}  // namespace rtc
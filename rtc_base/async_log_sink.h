@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_ASYNC_LOG_SINK_H_
+#define RTC_BASE_ASYNC_LOG_SINK_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/mpsc_queue.h"
+#include "rtc_base/platform_thread.h"
+
+namespace rtc {
+
+// Log sink that hands the formatted messages over to a background thread,
+// which writes them to a wrapped sink, e.g. a FileRotatingLogSink. Logging
+// threads then only pay for a copy of the message and a lock-free enqueue,
+// instead of waiting for the disk while holding the global logging lock.
+//
+// The writer thread wakes up every |max_delay_ms|, or earlier once a batch
+// of messages has queued up, and writes all queued messages in one go. At
+// most |max_queued_messages| messages are queued; further messages are
+// dropped and counted, and the writer reports the number of dropped messages
+// to the wrapped sink once it catches up.
+//
+// Like any other sink, it must be removed with LogMessage::RemoveLogToStream()
+// before it is destroyed. The destructor writes out the messages still
+// queued.
+class AsyncLogSink : public LogSink {
+ public:
+  static constexpr size_t kDefaultMaxQueuedMessages = 10000;
+  static constexpr int kDefaultMaxDelayMs = 100;
+
+  // |sink| must not be registered with LogMessage::AddLogToStream() itself.
+  explicit AsyncLogSink(std::unique_ptr<LogSink> sink,
+                        size_t max_queued_messages = kDefaultMaxQueuedMessages,
+                        int max_delay_ms = kDefaultMaxDelayMs);
+  ~AsyncLogSink() override;
+
+  AsyncLogSink(const AsyncLogSink&) = delete;
+  AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+  void OnLogMessage(const std::string& message) override;
+  void OnLogMessage(const std::string& message,
+                    LoggingSeverity severity) override;
+  void OnLogMessage(const std::string& message,
+                    LoggingSeverity severity,
+                    const char* tag) override;
+
+  // Blocks until all messages queued before the call have been written to the
+  // wrapped sink.
+  void Flush();
+
+  // Number of messages dropped because the queue was full, since creation.
+  size_t dropped_messages() const {
+    return total_dropped_messages_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Record {
+    enum class Type { kMessage, kMessageWithSeverity, kMessageWithTag, kFlush };
+    Type type = Type::kMessage;
+    std::string message;
+    LoggingSeverity severity = LS_NONE;
+    const char* tag = nullptr;
+    // Signaled by the writer for kFlush records.
+    Event* flushed = nullptr;
+  };
+
+  void Enqueue(Record record);
+  static void WriterThread(void* obj);
+  void WriteMessages();
+  // Writes out all queued records. Returns false once the sink is stopping
+  // and the queue is empty.
+  bool WriteQueuedRecords();
+  // Reports the number of messages dropped since the last report, if any.
+  void WriteDroppedMessages();
+
+  const std::unique_ptr<LogSink> sink_;
+  const size_t max_queued_messages_;
+  // Number of queued messages at which the writer is woken up early.
+  const size_t batch_size_;
+  const int max_delay_ms_;
+
+  MpscQueue<Record> queue_;
+  // Messages in |queue_|, not counting flush requests.
+  std::atomic<size_t> queued_messages_{0};
+  // Dropped messages not yet reported to |sink_|.
+  std::atomic<size_t> dropped_messages_{0};
+  std::atomic<size_t> total_dropped_messages_{0};
+  std::atomic<bool> stopping_{false};
+
+  Event wake_up_;
+  PlatformThread writer_thread_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_ASYNC_LOG_SINK_H_
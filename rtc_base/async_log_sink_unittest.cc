@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/async_log_sink.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/thread_annotations.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+class RecordingLogSink : public LogSink {
+ public:
+  // Blocks writes until Unblock() is called, if |blocked|.
+  explicit RecordingLogSink(bool blocked = false) {
+    if (!blocked) {
+      unblocked_.Set();
+    }
+  }
+
+  void OnLogMessage(const std::string& message) override {
+    OnLogMessage(message, LS_NONE);
+  }
+  void OnLogMessage(const std::string& message,
+                    LoggingSeverity severity) override {
+    unblocked_.Wait(Event::kForever);
+    CritScope lock(&crit_);
+    messages_.push_back(message);
+    severities_.push_back(severity);
+  }
+
+  void Unblock() { unblocked_.Set(); }
+
+  std::vector<std::string> messages() const {
+    CritScope lock(&crit_);
+    return messages_;
+  }
+  std::vector<LoggingSeverity> severities() const {
+    CritScope lock(&crit_);
+    return severities_;
+  }
+
+ private:
+  // Manual reset, so that it stays signaled once unblocked.
+  Event unblocked_{/*manual_reset=*/true, /*initially_signaled=*/false};
+  CriticalSection crit_;
+  std::vector<std::string> messages_ RTC_GUARDED_BY(crit_);
+  std::vector<LoggingSeverity> severities_ RTC_GUARDED_BY(crit_);
+};
+
+// Lets a test inspect what was written after the AsyncLogSink, which owns its
+// sink, is gone.
+class ForwardingLogSink : public LogSink {
+ public:
+  explicit ForwardingLogSink(LogSink* sink) : sink_(sink) {}
+  void OnLogMessage(const std::string& message) override {
+    sink_->OnLogMessage(message);
+  }
+
+ private:
+  LogSink* const sink_;
+};
+
+TEST(AsyncLogSinkTest, WritesMessagesInOrderOnFlush) {
+  auto recorder = std::make_unique<RecordingLogSink>();
+  RecordingLogSink* recorder_ptr = recorder.get();
+  AsyncLogSink sink(std::move(recorder));
+  sink.OnLogMessage("a\n");
+  sink.OnLogMessage("b\n", LS_INFO);
+  sink.OnLogMessage("c\n", LS_ERROR, "tag");
+  sink.Flush();
+
+  // The default LogSink prepends the tag.
+  EXPECT_EQ(recorder_ptr->messages(),
+            (std::vector<std::string>{"a\n", "b\n", "tag: c\n"}));
+  EXPECT_EQ(recorder_ptr->severities(),
+            (std::vector<LoggingSeverity>{LS_NONE, LS_INFO, LS_ERROR}));
+  EXPECT_EQ(0u, sink.dropped_messages());
+}
+
+TEST(AsyncLogSinkTest, WritesQueuedMessagesOnDestruction) {
+  RecordingLogSink recorder;
+  std::vector<std::string> messages;
+  {
+    AsyncLogSink sink(std::make_unique<ForwardingLogSink>(&recorder),
+                      /*max_queued_messages=*/1000,
+                      /*max_delay_ms=*/60000);
+    for (int i = 0; i < 100; ++i) {
+      messages.push_back(std::to_string(i));
+      sink.OnLogMessage(messages.back());
+    }
+  }
+  EXPECT_EQ(recorder.messages(), messages);
+}
+
+TEST(AsyncLogSinkTest, DropsAndCountsMessagesWhenFull) {
+  auto recorder = std::make_unique<RecordingLogSink>(/*blocked=*/true);
+  RecordingLogSink* recorder_ptr = recorder.get();
+  AsyncLogSink sink(std::move(recorder), /*max_queued_messages=*/10);
+  // A message stays queued until the writer has written it, so the blocked
+  // writer does not make room for more.
+  for (int i = 0; i < 30; ++i) {
+    sink.OnLogMessage(std::to_string(i), LS_INFO);
+  }
+  EXPECT_EQ(20u, sink.dropped_messages());
+
+  recorder_ptr->Unblock();
+  sink.Flush();
+  std::vector<std::string> messages = recorder_ptr->messages();
+  ASSERT_EQ(11u, messages.size());
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(std::to_string(i), messages[i]);
+  }
+  EXPECT_EQ("AsyncLogSink dropped 20 messages.\n", messages.back());
+  EXPECT_EQ(LS_WARNING, recorder_ptr->severities().back());
+}
+
+}  // namespace
+}  // namespace rtc
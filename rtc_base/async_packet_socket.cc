@@ -10,6 +10,8 @@
 
 #include "rtc_base/async_packet_socket.h"
 
+#include "rtc_base/checks.h"
+
 namespace rtc {
 
 PacketTimeUpdateParams::PacketTimeUpdateParams() = default;
@@ -28,6 +30,23 @@ AsyncPacketSocket::AsyncPacketSocket() = default;
 
 AsyncPacketSocket::~AsyncPacketSocket() = default;
 
+void AsyncPacketSocket::SetPacketReceiver(AsyncPacketSocketReceiver* receiver) {
+  RTC_DCHECK(!receiver || !packet_receiver_ || packet_receiver_ == receiver)
+      << "The socket already has a receiver";
+  packet_receiver_ = receiver;
+}
+
+void AsyncPacketSocket::NotifyPacketReceived(const char* data,
+                                             size_t size,
+                                             const SocketAddress& remote_addr,
+                                             int64_t packet_time_us) {
+  if (packet_receiver_) {
+    packet_receiver_->OnReadPacket(this, data, size, remote_addr,
+                                   packet_time_us);
+  }
+  SignalReadPacket(this, data, size, remote_addr, packet_time_us);
+}
+
 void CopySocketInformationToPacketInfo(size_t packet_size_bytes,
                                        const AsyncPacketSocket& socket_from,
                                        bool is_connectionless,
@@ -54,6 +54,23 @@ struct RTC_EXPORT PacketOptions {
   PacketInfo info_signaled_after_sent;
 };
 
+class AsyncPacketSocket;
+
+// Receives the packets read by an AsyncPacketSocket with a direct call. This
+// is what the packet data path uses, since a SignalReadPacket emission walks
+// a list of slots for every packet.
+class AsyncPacketSocketReceiver {
+ public:
+  virtual void OnReadPacket(AsyncPacketSocket* socket,
+                            const char* data,
+                            size_t size,
+                            const SocketAddress& remote_addr,
+                            const int64_t& packet_time_us) = 0;
+
+ protected:
+  virtual ~AsyncPacketSocketReceiver() = default;
+};
+
 // Provides the ability to receive packets asynchronously. Sends are not
 // buffered since it is acceptable to drop packets under high load.
 class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
@@ -83,6 +100,14 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
                      const SocketAddress& addr,
                      const PacketOptions& options) = 0;
 
+  // Send batching. Between StartSendBatch() and FlushSendBatch(), sockets that
+  // support it may queue packets passed to SendTo() and write them out
+  // together on flush, e.g. with a single sendmmsg call. SignalSentPacket is
+  // emitted for queued packets when they are flushed. The default
+  // implementation sends every packet immediately.
+  virtual void StartSendBatch() {}
+  virtual void FlushSendBatch() {}
+
   // Close the socket.
   virtual int Close() = 0;
 
@@ -98,6 +123,12 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int GetError() const = 0;
   virtual void SetError(int error) = 0;
 
+  // Sets the receiver of the packets read, which gets them before
+  // SignalReadPacket. A socket has at most one receiver; null unsets it. The
+  // receiver must unset itself before it is destroyed, unless it owns the
+  // socket.
+  void SetPacketReceiver(AsyncPacketSocketReceiver* receiver);
+
   // Emitted each time a packet is read. Used only for UDP and
   // connected TCP sockets.
   sigslot::signal5<AsyncPacketSocket*,
@@ -132,7 +163,16 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
   // Used only for listening TCP sockets.
   sigslot::signal2<AsyncPacketSocket*, AsyncPacketSocket*> SignalNewConnection;
 
+ protected:
+  // Passes a packet read to the receiver and to SignalReadPacket.
+  void NotifyPacketReceived(const char* data,
+                            size_t size,
+                            const SocketAddress& remote_addr,
+                            int64_t packet_time_us);
+
  private:
+  AsyncPacketSocketReceiver* packet_receiver_ = nullptr;
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AsyncPacketSocket);
 };
 
@@ -14,6 +14,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 
 #include "api/array_view.h"
@@ -97,6 +98,15 @@ SocketAddress AsyncTCPSocketBase::GetRemoteAddress() const {
   return socket_->GetRemoteAddress();
 }
 
+void AsyncTCPSocketBase::StartSendBatch() {
+  batching_sends_ = !listen_;
+}
+
+void AsyncTCPSocketBase::FlushSendBatch() {
+  batching_sends_ = false;
+  WriteSendBatch();
+}
+
 int AsyncTCPSocketBase::Close() {
   return socket_->Close();
 }
@@ -187,6 +197,102 @@ int AsyncTCPSocketBase::FlushOutBuffer() {
   return res;
 }
 
+int AsyncTCPSocketBase::SendPacketBuffers(
+    ArrayView<const ArrayView<const uint8_t>> buffers,
+    const SentPacket& sent_packet) {
+  RTC_DCHECK(!listen_);
+  RTC_DCHECK(!IsSendBlocked());
+  // Enough for a length or channel data header, the payload and padding.
+  static constexpr size_t kMaxBuffers = 4;
+  RTC_DCHECK_LE(buffers.size(), kMaxBuffers);
+  std::array<ArrayView<const uint8_t>, kMaxBuffers> remaining;
+  size_t num_remaining = std::min(buffers.size(), kMaxBuffers);
+  size_t total_size = 0;
+  for (size_t i = 0; i < num_remaining; ++i) {
+    remaining[i] = buffers[i];
+    total_size += buffers[i].size();
+  }
+  RTC_DCHECK_LE(total_size, max_outsize_);
+
+  if (batching_sends_) {
+    if (outbuf_.size() + total_size > max_outsize_) {
+      WriteSendBatch();
+      if (IsSendBlocked()) {
+        // Dropped, like any packet sent while the socket is blocked.
+        return static_cast<int>(total_size);
+      }
+    }
+    for (size_t i = 0; i < num_remaining; ++i) {
+      outbuf_.AppendData(remaining[i].data(), remaining[i].size());
+    }
+    batched_packets_.push_back(sent_packet);
+    return static_cast<int>(total_size);
+  }
+
+  size_t first = 0;
+  size_t sent = 0;
+  int res = 0;
+  while (sent < total_size) {
+    res = socket_->SendVectored(
+        ArrayView<const ArrayView<const uint8_t>>(&remaining[first],
+                                                  num_remaining - first));
+    if (res <= 0) {
+      break;
+    }
+    if (sent + res > total_size) {
+      RTC_NOTREACHED();
+      res = -1;
+      break;
+    }
+    sent += res;
+    // Skip what was sent.
+    size_t skip = res;
+    while (skip > 0) {
+      const size_t n = std::min(skip, remaining[first].size());
+      remaining[first] = remaining[first].subview(n);
+      skip -= n;
+      if (remaining[first].empty()) {
+        ++first;
+      }
+    }
+  }
+  if (sent == 0) {
+    return res;
+  }
+  SignalSentPacket(this, sent_packet);
+  if (sent == total_size) {
+    return static_cast<int>(total_size);
+  }
+  // Keep the rest of the packet for OnWriteEvent(); it must not be dropped
+  // once part of it is on the wire.
+  for (size_t i = first; i < num_remaining; ++i) {
+    outbuf_.AppendData(remaining[i].data(), remaining[i].size());
+  }
+  // In the special case of EWOULDBLOCK, signal that we had a partial write.
+  if (socket_->GetError() == EWOULDBLOCK) {
+    res = static_cast<int>(sent);
+  }
+  return res;
+}
+
+void AsyncTCPSocketBase::WriteSendBatch() {
+  if (batched_packets_.empty()) {
+    return;
+  }
+  std::vector<SentPacket> packets;
+  packets.swap(batched_packets_);
+  if (FlushOutBuffer() <= 0) {
+    // Drop the batch if we made no progress.
+    ClearOutBuffer();
+    return;
+  }
+  const int64_t now_ms = TimeMillis();
+  for (SentPacket& packet : packets) {
+    packet.send_time_ms = now_ms;
+    SignalSentPacket(this, packet);
+  }
+}
+
 void AsyncTCPSocketBase::AppendToOutBuffer(const void* pv, size_t cb) {
   RTC_DCHECK(outbuf_.size() + cb <= max_outsize_);
   RTC_DCHECK(!listen_);
@@ -219,6 +325,14 @@ void AsyncTCPSocketBase::OnReadEvent(AsyncSocket* socket) {
     size_t total_recv = 0;
     while (true) {
       size_t free_size = inbuf_.capacity() - inbuf_.size();
+      if (free_size < kMinimumRecvSize && inbuf_read_pos_ > 0) {
+        // Move the leftover partial packet to the front.
+        const size_t unread_size = inbuf_.size() - inbuf_read_pos_;
+        memmove(inbuf_.data(), inbuf_.data() + inbuf_read_pos_, unread_size);
+        inbuf_.SetSize(unread_size);
+        inbuf_read_pos_ = 0;
+        free_size = inbuf_.capacity() - inbuf_.size();
+      }
       if (free_size < kMinimumRecvSize && inbuf_.capacity() < max_insize_) {
         inbuf_.EnsureCapacity(std::min(max_insize_, inbuf_.capacity() * 2));
         free_size = inbuf_.capacity() - inbuf_.size();
@@ -246,15 +360,20 @@ void AsyncTCPSocketBase::OnReadEvent(AsyncSocket* socket) {
       return;
     }
 
-    size_t size = inbuf_.size();
-    ProcessInput(inbuf_.data<char>(), &size);
+    const size_t unread_size = inbuf_.size() - inbuf_read_pos_;
+    size_t size = unread_size;
+    ProcessInput(inbuf_.data<char>() + inbuf_read_pos_, &size);
 
-    if (size > inbuf_.size()) {
+    if (size > unread_size) {
       RTC_LOG(LS_ERROR) << "input buffer overflow";
       RTC_NOTREACHED();
+      size = 0;
+    }
+    if (size == 0) {
       inbuf_.Clear();
+      inbuf_read_pos_ = 0;
     } else {
-      inbuf_.SetSize(size);
+      inbuf_read_pos_ = inbuf_.size() - size;
     }
   }
 }
@@ -262,11 +381,12 @@ void AsyncTCPSocketBase::OnReadEvent(AsyncSocket* socket) {
 void AsyncTCPSocketBase::OnWriteEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
-  if (outbuf_.size() > 0) {
+  // A batch is only written on FlushSendBatch().
+  if (outbuf_.size() > 0 && batched_packets_.empty()) {
     FlushOutBuffer();
   }
 
-  if (outbuf_.size() == 0) {
+  if (!IsSendBlocked()) {
     SignalReadyToSend(this);
   }
 }
@@ -299,25 +419,25 @@ int AsyncTCPSocket::Send(const void* pv,
   }
 
   // If we are blocking on send, then silently drop this packet
-  if (!IsOutBufferEmpty())
+  if (IsSendBlocked())
     return static_cast<int>(cb);
 
-  PacketLength pkt_len = HostToNetwork16(static_cast<PacketLength>(cb));
-  AppendToOutBuffer(&pkt_len, kPacketLenSize);
-  AppendToOutBuffer(pv, cb);
+  rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
+                              options.info_signaled_after_sent);
+  CopySocketInformationToPacketInfo(cb, *this, false, &sent_packet.info);
 
-  int res = FlushOutBuffer();
+  PacketLength pkt_len = HostToNetwork16(static_cast<PacketLength>(cb));
+  const ArrayView<const uint8_t> buffers[] = {
+      MakeArrayView(reinterpret_cast<const uint8_t*>(&pkt_len),
+                    kPacketLenSize),
+      MakeArrayView(static_cast<const uint8_t*>(pv), cb)};
+  int res = SendPacketBuffers(buffers, sent_packet);
   if (res <= 0) {
     // drop packet if we made no progress
     ClearOutBuffer();
     return res;
   }
 
-  rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
-                              options.info_signaled_after_sent);
-  CopySocketInformationToPacketInfo(cb, *this, false, &sent_packet.info);
-  SignalSentPacket(this, sent_packet);
-
   // We claim to have sent the whole thing, even if we only sent partial
   return static_cast<int>(cb);
 }
@@ -333,13 +453,11 @@ void AsyncTCPSocket::ProcessInput(char* data, size_t* len) {
     if (*len < kPacketLenSize + pkt_len)
       return;
 
-    SignalReadPacket(this, data + kPacketLenSize, pkt_len, remote_addr,
-                     TimeMicros());
+    NotifyPacketReceived(data + kPacketLenSize, pkt_len, remote_addr,
+                         TimeMicros());
 
+    data += kPacketLenSize + pkt_len;
     *len -= kPacketLenSize + pkt_len;
-    if (*len > 0) {
-      memmove(data, data + kPacketLenSize + pkt_len, *len);
-    }
   }
 }
 
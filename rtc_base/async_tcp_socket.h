@@ -12,13 +12,17 @@
 #define RTC_BASE_ASYNC_TCP_SOCKET_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
+#include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/async_socket.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/constructor_magic.h"
+#include "rtc_base/network/sent_packet.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/socket_address.h"
 
@@ -36,6 +40,9 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   int Send(const void* pv,
            size_t cb,
            const rtc::PacketOptions& options) override = 0;
+  // Processes the complete packets at the start of |data| and sets |*len| to
+  // the number of bytes left over at its end, which are kept for the next
+  // call.
   virtual void ProcessInput(char* data, size_t* len) = 0;
   // Signals incoming connection.
   virtual void HandleIncomingConnection(AsyncSocket* socket) = 0;
@@ -46,6 +53,11 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  // Packets sent between StartSendBatch() and FlushSendBatch() are framed
+  // into the output buffer and written with one Send() on flush, e.g. as a
+  // single TLS record on top of an SSL adapter.
+  void StartSendBatch() override;
+  void FlushSendBatch() override;
   int Close() override;
 
   State GetState() const override;
@@ -62,12 +74,25 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
                                     const SocketAddress& bind_address,
                                     const SocketAddress& remote_address);
   int FlushOutBuffer();
+  // Sends the concatenation of |buffers| as one packet with one vectored
+  // write, without copying them to |outbuf_| unless the socket only takes
+  // part of the data. The remainder is then buffered and flushed once the
+  // socket is writable. Emits SignalSentPacket with |sent_packet| once the
+  // packet is written, which for a batched packet is on FlushSendBatch().
+  // Returns like FlushOutBuffer(). Must not be called if IsSendBlocked().
+  int SendPacketBuffers(ArrayView<const ArrayView<const uint8_t>> buffers,
+                        const SentPacket& sent_packet);
   // Add data to |outbuf_|.
   void AppendToOutBuffer(const void* pv, size_t cb);
 
   // Helper methods for |outpos_|.
   bool IsOutBufferEmpty() const { return outbuf_.size() == 0; }
   void ClearOutBuffer() { outbuf_.Clear(); }
+  // True while part of an earlier packet waits for the socket to become
+  // writable. Packets sent meanwhile are dropped.
+  bool IsSendBlocked() const {
+    return outbuf_.size() > 0 && batched_packets_.empty();
+  }
 
  private:
   // Called by the underlying socket
@@ -75,11 +100,20 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   void OnReadEvent(AsyncSocket* socket);
   void OnWriteEvent(AsyncSocket* socket);
   void OnCloseEvent(AsyncSocket* socket, int error);
+  // Writes out the packets batched in |outbuf_|.
+  void WriteSendBatch();
 
   std::unique_ptr<AsyncSocket> socket_;
   bool listen_;
+  // Received data not yet processed starts at |inbuf_read_pos_|. Processed
+  // packets are skipped rather than moved out, and the leftover partial
+  // packet is only moved to the front when the buffer runs out of space.
   Buffer inbuf_;
+  size_t inbuf_read_pos_ = 0;
   Buffer outbuf_;
+  bool batching_sends_ = false;
+  // Packets framed into |outbuf_| since StartSendBatch(), not yet written.
+  std::vector<SentPacket> batched_packets_;
   size_t max_insize_;
   size_t max_outsize_;
 
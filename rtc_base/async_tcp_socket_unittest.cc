@@ -12,8 +12,10 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rtc_base/gunit.h"
+#include "rtc_base/thread.h"
 #include "rtc_base/virtual_socket_server.h"
 
 namespace rtc {
@@ -44,4 +46,106 @@ TEST_F(AsyncTCPSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+class AsyncTCPSocketConnectionTest : public ::testing::Test,
+                                     public sigslot::has_slots<> {
+ public:
+  AsyncTCPSocketConnectionTest()
+      : vss_(new VirtualSocketServer()), thread_(vss_.get()) {
+    AsyncSocket* server = vss_->CreateAsyncSocket(AF_INET, SOCK_STREAM);
+    server->Bind(SocketAddress("22.22.22.22", 0));
+    listen_socket_.reset(new AsyncTCPSocket(server, true));
+    listen_socket_->SignalNewConnection.connect(
+        this, &AsyncTCPSocketConnectionTest::OnNewConnection);
+    send_socket_.reset(AsyncTCPSocket::Create(
+        vss_->CreateAsyncSocket(AF_INET, SOCK_STREAM),
+        SocketAddress("11.11.11.11", 0), listen_socket_->GetLocalAddress()));
+    if (send_socket_) {
+      send_socket_->SignalSentPacket.connect(
+          this, &AsyncTCPSocketConnectionTest::OnSentPacket);
+    }
+    vss_->ProcessMessagesUntilIdle();
+  }
+
+  void OnNewConnection(AsyncPacketSocket* server,
+                       AsyncPacketSocket* new_socket) {
+    recv_socket_.reset(new_socket);
+    new_socket->SignalReadPacket.connect(
+        this, &AsyncTCPSocketConnectionTest::OnReadPacket);
+  }
+
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t len,
+                    const SocketAddress& remote_addr,
+                    const int64_t& /* packet_time_us */) {
+    recv_packets_.push_back(std::string(data, len));
+  }
+
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet) {
+    sent_packet_ids_.push_back(sent_packet.packet_id);
+  }
+
+ protected:
+  std::unique_ptr<VirtualSocketServer> vss_;
+  AutoSocketServerThread thread_;
+  std::unique_ptr<AsyncTCPSocket> listen_socket_;
+  std::unique_ptr<AsyncTCPSocket> send_socket_;
+  std::unique_ptr<AsyncPacketSocket> recv_socket_;
+  std::vector<std::string> recv_packets_;
+  std::vector<int64_t> sent_packet_ids_;
+};
+
+TEST_F(AsyncTCPSocketConnectionTest, DeliversPacketsInOneRead) {
+  ASSERT_TRUE(send_socket_);
+  std::vector<std::string> packets;
+  PacketOptions options;
+  for (int i = 0; i < 20; ++i) {
+    packets.push_back(std::string(i * 10, 'a' + i));
+    ASSERT_EQ(static_cast<int>(packets.back().size()),
+              send_socket_->Send(packets.back().data(), packets.back().size(),
+                                 options));
+  }
+  vss_->ProcessMessagesUntilIdle();
+  EXPECT_EQ(packets, recv_packets_);
+}
+
+TEST_F(AsyncTCPSocketConnectionTest, BuffersRestOfPartiallySentPacket) {
+  ASSERT_TRUE(send_socket_);
+  vss_->set_send_buffer_capacity(10);
+  const std::string packet(1000, 'x');
+  PacketOptions options;
+  EXPECT_EQ(1000, send_socket_->Send(packet.data(), packet.size(), options));
+  vss_->ProcessMessagesUntilIdle();
+  EXPECT_EQ(std::vector<std::string>{packet}, recv_packets_);
+}
+
+TEST_F(AsyncTCPSocketConnectionTest, WritesBatchedPacketsOnFlush) {
+  ASSERT_TRUE(send_socket_);
+  std::vector<std::string> packets;
+  send_socket_->StartSendBatch();
+  for (int i = 0; i < 5; ++i) {
+    packets.push_back(std::string(100, 'a' + i));
+    PacketOptions options;
+    options.packet_id = i;
+    ASSERT_EQ(100, send_socket_->Send(packets.back().data(),
+                                      packets.back().size(), options));
+  }
+  vss_->ProcessMessagesUntilIdle();
+  EXPECT_TRUE(recv_packets_.empty());
+  EXPECT_TRUE(sent_packet_ids_.empty());
+
+  send_socket_->FlushSendBatch();
+  vss_->ProcessMessagesUntilIdle();
+  EXPECT_EQ(packets, recv_packets_);
+  EXPECT_EQ((std::vector<int64_t>{0, 1, 2, 3, 4}), sent_packet_ids_);
+
+  // Sends are immediate again after the flush.
+  PacketOptions options;
+  options.packet_id = 5;
+  send_socket_->Send("abc", 3, options);
+  vss_->ProcessMessagesUntilIdle();
+  EXPECT_EQ("abc", recv_packets_.back());
+  EXPECT_EQ(5, sent_packet_ids_.back());
+}
+
 }  // namespace rtc
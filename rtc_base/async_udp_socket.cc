@@ -12,7 +12,9 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <string>
+#include <utility>
 
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -23,6 +25,8 @@
 namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
+// Queued packets beyond this count are flushed right away.
+static const size_t kMaxSendBatchSize = 64;
 
 AsyncUDPSocket* AsyncUDPSocket::Create(AsyncSocket* socket,
                                        const SocketAddress& bind_address) {
@@ -82,11 +86,53 @@ int AsyncUDPSocket::SendTo(const void* pv,
   rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
                               options.info_signaled_after_sent);
   CopySocketInformationToPacketInfo(cb, *this, true, &sent_packet.info);
+  if (batching_sends_) {
+    if (send_batch_.size() >= kMaxSendBatchSize)
+      FlushSendBatch();
+    const char* data = static_cast<const char*>(pv);
+    send_batch_.push_back(
+        {send_batch_buffer_.size(), cb, addr, std::move(sent_packet)});
+    send_batch_buffer_.insert(send_batch_buffer_.end(), data, data + cb);
+    // The packet is accepted; like a plain UDP send, it may still be dropped.
+    return static_cast<int>(cb);
+  }
   int ret = socket_->SendTo(pv, cb, addr);
   SignalSentPacket(this, sent_packet);
   return ret;
 }
 
+void AsyncUDPSocket::StartSendBatch() {
+  batching_sends_ = true;
+}
+
+void AsyncUDPSocket::FlushSendBatch() {
+  if (send_batch_.empty()) {
+    batching_sends_ = false;
+    return;
+  }
+  std::vector<SendBatchEntry> entries(send_batch_.size());
+  for (size_t i = 0; i < send_batch_.size(); ++i) {
+    entries[i].data = &send_batch_buffer_[send_batch_[i].offset];
+    entries[i].length = send_batch_[i].length;
+    entries[i].remote_address = send_batch_[i].remote_address;
+  }
+  int sent = socket_->SendToBatch(entries);
+  if (sent < static_cast<int>(entries.size())) {
+    RTC_LOG(LS_VERBOSE) << "AsyncUDPSocket dropped "
+                        << entries.size() - std::max(sent, 0)
+                        << " batched packets, error " << socket_->GetError();
+  }
+  int64_t now_ms = rtc::TimeMillis();
+  std::vector<PendingSend> pending;
+  pending.swap(send_batch_);
+  send_batch_buffer_.clear();
+  batching_sends_ = false;
+  for (PendingSend& packet : pending) {
+    packet.sent_packet.send_time_ms = now_ms;
+    SignalSentPacket(this, packet.sent_packet);
+  }
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -111,9 +157,28 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+void AsyncUDPSocket::SetRecvBatchSize(size_t max_batch_size) {
+  if (max_batch_size <= 1) {
+    recv_batch_.clear();
+    recv_batch_buffer_.clear();
+    return;
+  }
+  recv_batch_buffer_.resize(max_batch_size * kRecvBatchSlotSize);
+  recv_batch_.resize(max_batch_size);
+  for (size_t i = 0; i < max_batch_size; ++i) {
+    recv_batch_[i].buffer = &recv_batch_buffer_[i * kRecvBatchSlotSize];
+    recv_batch_[i].capacity = kRecvBatchSlotSize;
+  }
+}
+
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
+  if (!recv_batch_.empty()) {
+    OnReadBatchEvent();
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
   int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
@@ -130,8 +195,30 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
 
   // TODO: Make sure that we got all of the packet.
   // If we did not, then we should resize our buffer to be large enough.
-  SignalReadPacket(this, buf_, static_cast<size_t>(len), remote_addr,
-                   (timestamp > -1 ? timestamp : TimeMicros()));
+  NotifyPacketReceived(buf_, static_cast<size_t>(len), remote_addr,
+                       (timestamp > -1 ? timestamp : TimeMicros()));
+}
+
+void AsyncUDPSocket::OnReadBatchEvent() {
+  int count = socket_->RecvFromBatch(recv_batch_);
+  if (count < 0) {
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                     << "] batched receive failed with error "
+                     << socket_->GetError();
+    return;
+  }
+  int64_t now_us = TimeMicros();
+  for (int i = 0; i < count; ++i) {
+    const RecvBatchEntry& entry = recv_batch_[i];
+    if (entry.truncated) {
+      RTC_LOG(LS_WARNING) << "Dropping truncated datagram from "
+                          << entry.remote_address.ToSensitiveString();
+      continue;
+    }
+    NotifyPacketReceived(entry.buffer, entry.length, entry.remote_address,
+                         (entry.timestamp > -1 ? entry.timestamp : now_us));
+  }
 }
 
 void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
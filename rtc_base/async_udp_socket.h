@@ -14,9 +14,11 @@
 #include <stddef.h>
 
 #include <memory>
+#include <vector>
 
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/async_socket.h"
+#include "rtc_base/network/sent_packet.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/socket_factory.h"
@@ -48,6 +50,8 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  void StartSendBatch() override;
+  void FlushSendBatch() override;
   int Close() override;
 
   State GetState() const override;
@@ -56,15 +60,40 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int GetError() const override;
   void SetError(int error) override;
 
+  // Opt-in batched receive. When |max_batch_size| is larger than one, each
+  // read event drains up to that many datagrams from the underlying socket
+  // (with a single recvmmsg call where supported) into a preallocated buffer
+  // ring, and SignalReadPacket is fired for each of them in order. Datagrams
+  // larger than |kRecvBatchSlotSize| are dropped in this mode.
+  static constexpr size_t kRecvBatchSlotSize = 8 * 1024;
+  void SetRecvBatchSize(size_t max_batch_size);
+
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
+  // Handles a read event when batched receive is enabled.
+  void OnReadBatchEvent();
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
 
   std::unique_ptr<AsyncSocket> socket_;
   char* buf_;
   size_t size_;
+  // Storage for batched receive, |recv_batch_.size()| slots of
+  // |kRecvBatchSlotSize| bytes each. Empty when batching is disabled.
+  std::vector<char> recv_batch_buffer_;
+  std::vector<RecvBatchEntry> recv_batch_;
+
+  // Packets queued between StartSendBatch() and FlushSendBatch().
+  struct PendingSend {
+    size_t offset;
+    size_t length;
+    SocketAddress remote_address;
+    SentPacket sent_packet;
+  };
+  bool batching_sends_ = false;
+  std::vector<char> send_batch_buffer_;
+  std::vector<PendingSend> send_batch_;
 };
 
 }  // namespace rtc
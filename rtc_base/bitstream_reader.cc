@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/bitstream_reader.h"
+
+#include <limits>
+
+namespace rtc {
+
+BitstreamReader::BitstreamReader(rtc::ArrayView<const uint8_t> bytes)
+    : next_byte_(bytes.data()),
+      end_(bytes.data() + bytes.size()),
+      remaining_bits_(static_cast<int>(8 * bytes.size())) {
+  RTC_DCHECK_LE(bytes.size(), std::numeric_limits<int>::max() / 8);
+}
+
+void BitstreamReader::ConsumeBits(int bits) {
+  RTC_DCHECK_GE(bits, 0);
+  if (bits > remaining_bits_) {
+    Invalidate();
+    return;
+  }
+  if (bits < cached_bits_) {
+    cache_ <<= bits;
+    cached_bits_ -= bits;
+    remaining_bits_ -= bits;
+    return;
+  }
+  // Skip the cached bits and the whole bytes after them without reading.
+  bits -= cached_bits_;
+  remaining_bits_ -= cached_bits_;
+  cache_ = 0;
+  cached_bits_ = 0;
+  next_byte_ += bits / 8;
+  remaining_bits_ -= 8 * (bits / 8);
+  ReadBits(bits % 8);
+}
+
+void BitstreamReader::Refill() {
+  RTC_DCHECK_LE(cached_bits_, kMaxCachedRead);
+  if (end_ - next_byte_ >= 8) {
+    uint64_t word = 0;
+    for (int i = 0; i < 8; ++i)
+      word = (word << 8) | next_byte_[i];
+    int bytes = (64 - cached_bits_) / 8;
+    // Keep only the |bytes| whole bytes that fit.
+    word &= ~uint64_t{0} << (64 - 8 * bytes);
+    cache_ |= word >> cached_bits_;
+    cached_bits_ += 8 * bytes;
+    next_byte_ += bytes;
+    return;
+  }
+  while (cached_bits_ <= kMaxCachedRead && next_byte_ != end_) {
+    cache_ |= uint64_t{*next_byte_++} << (kMaxCachedRead - cached_bits_);
+    cached_bits_ += 8;
+  }
+}
+
+}  // namespace rtc
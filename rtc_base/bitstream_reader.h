@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_BITSTREAM_READER_H_
+#define RTC_BASE_BITSTREAM_READER_H_
+
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "api/array_view.h"
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+// A faster alternative to BitBuffer for parsing headers. Big-endian bits are
+// read through a 64-bit cache that is refilled a word at a time, so most reads
+// are a shift and a compare. Rather than returning a status from every read,
+// the reader becomes invalid as soon as a read runs past the end of the data;
+// reads then return 0. Check Ok() once after a group of reads.
+class BitstreamReader {
+ public:
+  explicit BitstreamReader(rtc::ArrayView<const uint8_t> bytes);
+  BitstreamReader(const BitstreamReader&) = delete;
+  BitstreamReader& operator=(const BitstreamReader&) = delete;
+
+  // Returns false if any read so far ran past the end of the data, or if
+  // Invalidate() was called.
+  bool Ok() const { return remaining_bits_ >= 0; }
+  // Marks the data as malformed, e.g. when a parsed value is out of range.
+  void Invalidate() { remaining_bits_ = -1; }
+
+  // The number of bits that are left to read, or -1 once invalid.
+  int RemainingBitCount() const { return remaining_bits_; }
+
+  // Reads |bits| bits, 0 to 64, as an unsigned value.
+  uint64_t ReadBits(int bits);
+  bool ReadBit() { return ReadBits(1) != 0; }
+
+  // Reads sizeof(T) bytes as a big-endian value, or a single bit for bool.
+  template <typename T>
+  T Read() {
+    static_assert(std::is_unsigned<T>::value, "");
+    return static_cast<T>(ReadBits(std::is_same<T, bool>::value
+                                       ? 1
+                                       : static_cast<int>(8 * sizeof(T))));
+  }
+
+  // Skips |bits| bits.
+  void ConsumeBits(int bits);
+
+  // Reads a value in the range [0, num_values - 1], with the same non
+  // symmetric encoding as BitBuffer::ReadNonSymmetric().
+  uint32_t ReadNonSymmetric(uint32_t num_values);
+
+  // Reads an exponential golomb coded value, see
+  // BitBuffer::ReadExponentialGolomb(). Invalidates the reader if the value
+  // wouldn't fit in a uint32_t.
+  uint32_t ReadExponentialGolomb();
+  // Reads a signed exponential golomb coded value, i.e. the unsigned value
+  // mapped to the sequence 0, 1, -1, 2, -2, etc. in order.
+  int32_t ReadSignedExponentialGolomb();
+
+ private:
+  // Reads of more bits than this are split in two, as a refill only
+  // guarantees this many bits in |cache_|.
+  static constexpr int kMaxCachedRead = 56;
+
+  // Moves whole bytes from |next_byte_| into |cache_|, until it holds more
+  // than kMaxCachedRead bits or all of the remaining data.
+  void Refill();
+  // Number of leading zero bits in |value|, which is not 0.
+  static int CountLeadingZeros(uint64_t value);
+
+  const uint8_t* next_byte_;
+  const uint8_t* const end_;
+  // The next |cached_bits_| bits to read, in the most significant bits. The
+  // other bits are 0.
+  uint64_t cache_ = 0;
+  int cached_bits_ = 0;
+  // Bits left in |cache_| and after |next_byte_|, or -1 once invalid.
+  int remaining_bits_;
+};
+
+inline uint64_t BitstreamReader::ReadBits(int bits) {
+  RTC_DCHECK_GE(bits, 0);
+  RTC_DCHECK_LE(bits, 64);
+  if (bits > remaining_bits_) {
+    Invalidate();
+    return 0;
+  }
+  if (bits > kMaxCachedRead) {
+    uint64_t high = ReadBits(bits - 32);
+    return (high << 32) | ReadBits(32);
+  }
+  if (bits == 0)
+    return 0;
+  if (bits > cached_bits_)
+    Refill();
+  uint64_t value = cache_ >> (64 - bits);
+  cache_ <<= bits;
+  cached_bits_ -= bits;
+  remaining_bits_ -= bits;
+  return value;
+}
+
+inline uint32_t BitstreamReader::ReadNonSymmetric(uint32_t num_values) {
+  RTC_DCHECK_GT(num_values, 0);
+  RTC_DCHECK_LE(num_values, uint32_t{1} << 31);
+  int width = 64 - CountLeadingZeros(num_values);
+  uint32_t num_min_bits_values = (uint32_t{1} << width) - num_values;
+  uint32_t value = static_cast<uint32_t>(ReadBits(width - 1));
+  if (value < num_min_bits_values)
+    return value;
+  return (value << 1) + ReadBit() - num_min_bits_values;
+}
+
+inline uint32_t BitstreamReader::ReadExponentialGolomb() {
+  if (cached_bits_ <= kMaxCachedRead)
+    Refill();
+  // The cache now holds either all of the remaining data or more than 32
+  // bits, so it is enough to tell a valid prefix of up to 31 zeros.
+  int zeros = cache_ == 0 ? 64 : CountLeadingZeros(cache_);
+  if (zeros > 31 || 2 * zeros + 1 > remaining_bits_) {
+    Invalidate();
+    return 0;
+  }
+  return static_cast<uint32_t>(ReadBits(2 * zeros + 1) - 1);
+}
+
+inline int32_t BitstreamReader::ReadSignedExponentialGolomb() {
+  uint32_t value = ReadExponentialGolomb();
+  if ((value & 1) == 0)
+    return -static_cast<int32_t>(value / 2);
+  return static_cast<int32_t>(value / 2 + 1);
+}
+
+inline int BitstreamReader::CountLeadingZeros(uint64_t value) {
+  RTC_DCHECK_NE(value, 0);
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clzll(value);
+#else
+  int zeros = 0;
+  for (uint64_t bit = uint64_t{1} << 63; (value & bit) == 0; bit >>= 1)
+    ++zeros;
+  return zeros;
+#endif
+}
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_BITSTREAM_READER_H_
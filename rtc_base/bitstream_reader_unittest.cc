@@ -0,0 +1,166 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/bitstream_reader.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/bit_buffer.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+TEST(BitstreamReaderTest, ReadsBigEndianValues) {
+  const uint8_t bytes[] = {0x0A, 0xBC, 0xDE, 0xF1, 0x23, 0x45, 0x67, 0x89,
+                           0xAB, 0xCD, 0xEF, 0x01, 0x23, 0x45, 0x67, 0x89};
+  BitstreamReader reader(bytes);
+  EXPECT_EQ(reader.Read<uint8_t>(), 0x0Au);
+  EXPECT_EQ(reader.Read<uint16_t>(), 0xBCDEu);
+  EXPECT_EQ(reader.Read<uint32_t>(), 0xF1234567u);
+  EXPECT_EQ(reader.ReadBits(4), 0x8u);
+  EXPECT_EQ(reader.ReadBits(60), uint64_t{0x9ABCDEF01234567});
+  EXPECT_EQ(reader.ReadBits(8), 0x89u);
+  EXPECT_TRUE(reader.Ok());
+  EXPECT_EQ(reader.RemainingBitCount(), 0);
+}
+
+TEST(BitstreamReaderTest, ReadsBits) {
+  const uint8_t bytes[] = {0b1010'0110, 0b1111'0000, 0b0101'1100};
+  BitstreamReader reader(bytes);
+  EXPECT_TRUE(reader.ReadBit());
+  EXPECT_FALSE(reader.Read<bool>());
+  EXPECT_EQ(reader.ReadBits(0), 0u);
+  EXPECT_EQ(reader.ReadBits(3), 0b100u);
+  EXPECT_EQ(reader.ReadBits(7), 0b110'1111u);
+  EXPECT_EQ(reader.ReadBits(11), 0b0000'0101'110u);
+  EXPECT_EQ(reader.RemainingBitCount(), 1);
+  EXPECT_TRUE(reader.Ok());
+}
+
+TEST(BitstreamReaderTest, InvalidatesWhenReadingPastTheEnd) {
+  const uint8_t bytes[] = {0xFF, 0xFF};
+  BitstreamReader reader(bytes);
+  EXPECT_EQ(reader.ReadBits(10), 0x3FFu);
+  EXPECT_EQ(reader.ReadBits(7), 0u);
+  EXPECT_FALSE(reader.Ok());
+  // Later reads fail too, even ones that would have fit.
+  EXPECT_EQ(reader.ReadBits(1), 0u);
+  EXPECT_EQ(reader.ReadExponentialGolomb(), 0u);
+  EXPECT_FALSE(reader.Ok());
+}
+
+TEST(BitstreamReaderTest, ConsumesBits) {
+  uint8_t bytes[32] = {0};
+  bytes[20] = 0b0001'0000;
+  BitstreamReader reader(bytes);
+  reader.ConsumeBits(3);
+  EXPECT_EQ(reader.RemainingBitCount(), 32 * 8 - 3);
+  EXPECT_EQ(reader.ReadBits(5), 0u);
+  reader.ConsumeBits(8 * 19 + 3);
+  EXPECT_TRUE(reader.ReadBit());
+  EXPECT_EQ(reader.RemainingBitCount(), 8 * 11 + 4);
+  reader.ConsumeBits(8 * 11 + 4);
+  EXPECT_TRUE(reader.Ok());
+  reader.ConsumeBits(1);
+  EXPECT_FALSE(reader.Ok());
+}
+
+TEST(BitstreamReaderTest, ReadsExponentialGolomb) {
+  // 1, 010, 011, 00100, 0000'0001'1111'1111 = 0, 1, 2, 3, 510.
+  const uint8_t bytes[] = {0b1010'0110, 0b0100'0000, 0b0000'1111, 0b1111'1000};
+  BitstreamReader reader(bytes);
+  EXPECT_EQ(reader.ReadExponentialGolomb(), 0u);
+  EXPECT_EQ(reader.ReadExponentialGolomb(), 1u);
+  EXPECT_EQ(reader.ReadExponentialGolomb(), 2u);
+  EXPECT_EQ(reader.ReadExponentialGolomb(), 3u);
+  EXPECT_EQ(reader.ReadExponentialGolomb(), 510u);
+  EXPECT_TRUE(reader.Ok());
+}
+
+TEST(BitstreamReaderTest, ReadsSignedExponentialGolomb) {
+  // 1, 010, 011, 00100 = 0, 1, -1, 2.
+  const uint8_t bytes[] = {0b1010'0110, 0b0100'0000};
+  BitstreamReader reader(bytes);
+  EXPECT_EQ(reader.ReadSignedExponentialGolomb(), 0);
+  EXPECT_EQ(reader.ReadSignedExponentialGolomb(), 1);
+  EXPECT_EQ(reader.ReadSignedExponentialGolomb(), -1);
+  EXPECT_EQ(reader.ReadSignedExponentialGolomb(), 2);
+  EXPECT_TRUE(reader.Ok());
+}
+
+TEST(BitstreamReaderTest, FailsOnTruncatedOrTooLongExponentialGolomb) {
+  const uint8_t truncated[] = {0x00, 0x01};
+  BitstreamReader truncated_reader(truncated);
+  truncated_reader.ConsumeBits(1);
+  EXPECT_EQ(truncated_reader.ReadExponentialGolomb(), 0u);
+  EXPECT_FALSE(truncated_reader.Ok());
+
+  // 32 leading zeros don't fit in a uint32_t.
+  const uint8_t too_long[] = {0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+                              0xFF, 0xFF, 0xFF, 0xFF};
+  BitstreamReader too_long_reader(too_long);
+  EXPECT_EQ(too_long_reader.ReadExponentialGolomb(), 0u);
+  EXPECT_FALSE(too_long_reader.Ok());
+
+  // 31 leading zeros do.
+  BitstreamReader max_reader(too_long);
+  max_reader.ConsumeBits(1);
+  EXPECT_EQ(max_reader.ReadExponentialGolomb(), 0xFFFFFFFEu);
+  EXPECT_TRUE(max_reader.Ok());
+}
+
+TEST(BitstreamReaderTest, MatchesBitBufferWriter) {
+  webrtc::Random random(0x5eed);
+  uint8_t bytes[1000] = {0};
+  BitBufferWriter writer(bytes, sizeof(bytes));
+  struct Value {
+    int type;
+    uint32_t value;
+    uint32_t num_values;
+    int bits;
+  };
+  std::vector<Value> values;
+  for (int i = 0; i < 200; ++i) {
+    Value v;
+    v.type = random.Rand(2);
+    v.bits = random.Rand(1, 32);
+    v.num_values = random.Rand(1u, 1000u);
+    if (v.type == 0) {
+      v.value = random.Rand<uint32_t>() >> (32 - v.bits);
+      ASSERT_TRUE(writer.WriteBits(v.value, v.bits));
+    } else if (v.type == 1) {
+      v.value = random.Rand(0u, v.num_values - 1);
+      ASSERT_TRUE(writer.WriteNonSymmetric(v.value, v.num_values));
+    } else {
+      v.value = random.Rand(0u, 100000u);
+      ASSERT_TRUE(writer.WriteExponentialGolomb(v.value));
+    }
+    values.push_back(v);
+  }
+
+  BitstreamReader reader(bytes);
+  for (const Value& v : values) {
+    if (v.type == 0) {
+      EXPECT_EQ(reader.ReadBits(v.bits), v.value);
+    } else if (v.type == 1) {
+      EXPECT_EQ(reader.ReadNonSymmetric(v.num_values), v.value);
+    } else {
+      EXPECT_EQ(reader.ReadExponentialGolomb(), v.value);
+    }
+  }
+  EXPECT_TRUE(reader.Ok());
+}
+
+}  // namespace
+}  // namespace rtc
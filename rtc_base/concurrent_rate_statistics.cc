@@ -0,0 +1,220 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/concurrent_rate_statistics.h"
+
+#include <limits>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+
+ConcurrentRateStatistics::ConcurrentRateStatistics(int64_t window_size_ms,
+                                                   float scale)
+    : window_size_ms_(window_size_ms),
+      scale_(scale),
+      bucket_counts_(new std::atomic<int64_t>[window_size_ms]),
+      bucket_samples_(new std::atomic<int>[window_size_ms]),
+      sequence_(0) {
+  RTC_DCHECK_GT(window_size_ms, 0);
+  Reset();
+}
+
+ConcurrentRateStatistics::~ConcurrentRateStatistics() = default;
+
+void ConcurrentRateStatistics::Reset() {
+  const uint32_t sequence = BeginWrite();
+  for (int64_t i = 0; i < window_size_ms_; ++i) {
+    bucket_counts_[i].store(0, std::memory_order_relaxed);
+    bucket_samples_[i].store(0, std::memory_order_relaxed);
+  }
+  first_timestamp_.store(-1, std::memory_order_relaxed);
+  last_timestamp_.store(-1, std::memory_order_relaxed);
+  accumulated_count_.store(0, std::memory_order_relaxed);
+  num_samples_.store(0, std::memory_order_relaxed);
+  overflow_.store(false, std::memory_order_relaxed);
+  EndWrite(sequence);
+}
+
+void ConcurrentRateStatistics::Update(int64_t count, int64_t now_ms) {
+  RTC_DCHECK_GE(count, 0);
+  const uint32_t sequence = BeginWrite();
+
+  const int64_t last_timestamp =
+      last_timestamp_.load(std::memory_order_relaxed);
+  if (last_timestamp != -1 && now_ms < last_timestamp) {
+    RTC_LOG(LS_WARNING) << "Timestamp " << now_ms
+                        << " is before the last added "
+                           "timestamp in the rate window: "
+                        << last_timestamp << ", aligning to that.";
+    now_ms = last_timestamp;
+  }
+  EraseOld(now_ms);
+  if (first_timestamp_.load(std::memory_order_relaxed) == -1) {
+    first_timestamp_.store(now_ms, std::memory_order_relaxed);
+  }
+
+  // Only this thread writes, so the read-modify-writes need not be atomic.
+  const size_t index = BucketIndex(now_ms);
+  bucket_counts_[index].store(
+      bucket_counts_[index].load(std::memory_order_relaxed) + count,
+      std::memory_order_relaxed);
+  bucket_samples_[index].store(
+      bucket_samples_[index].load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+
+  const int64_t accumulated_count =
+      accumulated_count_.load(std::memory_order_relaxed);
+  if (std::numeric_limits<int64_t>::max() - accumulated_count > count) {
+    accumulated_count_.store(accumulated_count + count,
+                             std::memory_order_relaxed);
+  } else {
+    overflow_.store(true, std::memory_order_relaxed);
+  }
+  num_samples_.store(num_samples_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+  last_timestamp_.store(now_ms, std::memory_order_relaxed);
+
+  EndWrite(sequence);
+}
+
+absl::optional<int64_t> ConcurrentRateStatistics::Rate(int64_t now_ms) const {
+  int64_t first_timestamp;
+  int64_t accumulated_count;
+  int num_samples;
+  bool overflow;
+  uint32_t sequence;
+  do {
+    // Wait for any update in progress to finish.
+    do {
+      sequence = sequence_.load(std::memory_order_acquire);
+    } while (sequence & 1);
+
+    first_timestamp = first_timestamp_.load(std::memory_order_relaxed);
+    const int64_t last_timestamp =
+        last_timestamp_.load(std::memory_order_relaxed);
+    accumulated_count = accumulated_count_.load(std::memory_order_relaxed);
+    num_samples = num_samples_.load(std::memory_order_relaxed);
+    overflow = overflow_.load(std::memory_order_relaxed);
+
+    // Leave out the buckets that have fallen out of the window since the last
+    // update, without clearing them.
+    if (last_timestamp != -1 && now_ms > last_timestamp) {
+      if (now_ms - last_timestamp >= window_size_ms_) {
+        accumulated_count = 0;
+        num_samples = 0;
+      } else {
+        for (int64_t t = last_timestamp - window_size_ms_ + 1;
+             t <= now_ms - window_size_ms_; ++t) {
+          const size_t index = BucketIndex(t);
+          accumulated_count -=
+              bucket_counts_[index].load(std::memory_order_relaxed);
+          num_samples -= bucket_samples_[index].load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while (sequence_.load(std::memory_order_relaxed) != sequence);
+
+  int active_window_size = 0;
+  if (first_timestamp != -1) {
+    if (first_timestamp <= now_ms - window_size_ms_) {
+      // Count window as full even if no data points currently in view, if the
+      // data stream started before the window.
+      active_window_size = window_size_ms_;
+    } else {
+      // Size of a single bucket is 1ms, so even if now_ms == first_timestmap_
+      // the window size should be 1.
+      active_window_size = now_ms - first_timestamp + 1;
+    }
+  }
+
+  // If window is a single bucket or there is only one sample in a data set that
+  // has not grown to the full window size, or if the accumulator has
+  // overflowed, treat this as rate unavailable.
+  if (num_samples == 0 || active_window_size <= 1 ||
+      (num_samples <= 1 && rtc::SafeLt(active_window_size, window_size_ms_)) ||
+      overflow) {
+    return absl::nullopt;
+  }
+
+  float scale = scale_ / active_window_size;
+  float result = accumulated_count * scale + 0.5f;
+
+  // Better return unavailable rate than garbage value (undefined behavior).
+  if (result > static_cast<float>(std::numeric_limits<int64_t>::max())) {
+    return absl::nullopt;
+  }
+  return rtc::dchecked_cast<int64_t>(result);
+}
+
+size_t ConcurrentRateStatistics::BucketIndex(int64_t timestamp_ms) const {
+  const int64_t index = timestamp_ms % window_size_ms_;
+  return static_cast<size_t>(index < 0 ? index + window_size_ms_ : index);
+}
+
+void ConcurrentRateStatistics::EraseOld(int64_t now_ms) {
+  const int64_t last_timestamp =
+      last_timestamp_.load(std::memory_order_relaxed);
+  if (last_timestamp == -1 || now_ms <= last_timestamp) {
+    return;
+  }
+
+  if (now_ms - last_timestamp >= window_size_ms_) {
+    // All buckets are outside the new window.
+    for (int64_t i = 0; i < window_size_ms_; ++i) {
+      bucket_counts_[i].store(0, std::memory_order_relaxed);
+      bucket_samples_[i].store(0, std::memory_order_relaxed);
+    }
+    accumulated_count_.store(0, std::memory_order_relaxed);
+    num_samples_.store(0, std::memory_order_relaxed);
+    return;
+  }
+
+  // Clear the buckets between the oldest time in the old window and the
+  // oldest time in the new window.
+  int64_t accumulated_count =
+      accumulated_count_.load(std::memory_order_relaxed);
+  int num_samples = num_samples_.load(std::memory_order_relaxed);
+  for (int64_t t = last_timestamp - window_size_ms_ + 1;
+       t <= now_ms - window_size_ms_; ++t) {
+    const size_t index = BucketIndex(t);
+    const int64_t bucket_count =
+        bucket_counts_[index].load(std::memory_order_relaxed);
+    const int bucket_samples =
+        bucket_samples_[index].load(std::memory_order_relaxed);
+    RTC_DCHECK_GE(accumulated_count, bucket_count);
+    RTC_DCHECK_GE(num_samples, bucket_samples);
+    accumulated_count -= bucket_count;
+    num_samples -= bucket_samples;
+    bucket_counts_[index].store(0, std::memory_order_relaxed);
+    bucket_samples_[index].store(0, std::memory_order_relaxed);
+  }
+  accumulated_count_.store(accumulated_count, std::memory_order_relaxed);
+  num_samples_.store(num_samples, std::memory_order_relaxed);
+  // This does not clear overflow_ even when counter is empty.
+  // TODO(https://bugs.webrtc.org/11247): Consider if overflow_ can be reset.
+}
+
+uint32_t ConcurrentRateStatistics::BeginWrite() {
+  const uint32_t sequence = sequence_.load(std::memory_order_relaxed) + 1;
+  sequence_.store(sequence, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  return sequence;
+}
+
+void ConcurrentRateStatistics::EndWrite(uint32_t sequence) {
+  sequence_.store(sequence + 1, std::memory_order_release);
+}
+
+}  // namespace webrtc
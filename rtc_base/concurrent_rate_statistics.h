@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_CONCURRENT_RATE_STATISTICS_H_
+#define RTC_BASE_CONCURRENT_RATE_STATISTICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+#include "absl/types/optional.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace webrtc {
+
+// Estimates rates like RateStatistics, with the same results, but lets any
+// thread read the rate while another thread updates it, without locking.
+//
+// The counts are kept in a ring of one bucket per millisecond of the window,
+// allocated up front, so updates never allocate and the memory used does not
+// depend on the packet rate. Update() and Reset() must not be called
+// concurrently with each other, e.g. they can be called on one thread or
+// under a lock, while Rate() can be called concurrently from any thread.
+// Rate() does not modify the instance; a reader that races with an update
+// retries, which is rare as updates are short.
+//
+// Unlike RateStatistics, the window size is fixed. Timestamps must not
+// decrease between two consecutive calls to Update().
+class RTC_EXPORT ConcurrentRateStatistics {
+ public:
+  // window_size_ms = Window size in ms for the rate estimation.
+  // scale = coefficient to convert counts/ms to desired unit
+  //         ex: RateStatistics::kBpsScale (8000) for bits/s if count
+  //         represents bytes.
+  ConcurrentRateStatistics(int64_t window_size_ms, float scale);
+  ~ConcurrentRateStatistics();
+
+  ConcurrentRateStatistics(const ConcurrentRateStatistics&) = delete;
+  ConcurrentRateStatistics& operator=(const ConcurrentRateStatistics&) =
+      delete;
+
+  // Reset instance to original state.
+  void Reset();
+
+  // Update rate with a new data point, moving averaging window as needed.
+  void Update(int64_t count, int64_t now_ms);
+
+  // Returns the rate over the window ending at |now_ms|. Safe to call from any
+  // thread, also concurrently with Update().
+  absl::optional<int64_t> Rate(int64_t now_ms) const;
+
+ private:
+  size_t BucketIndex(int64_t timestamp_ms) const;
+  void EraseOld(int64_t now_ms);
+  uint32_t BeginWrite();
+  void EndWrite(uint32_t sequence);
+
+  const int64_t window_size_ms_;
+  // To convert counts/ms to desired units.
+  const float scale_;
+
+  // Sum and number of samples per millisecond, indexed by timestamp modulo
+  // the window size. Only the buckets from |last_timestamp_| and back over the
+  // window are valid, older ones are cleared as time moves on.
+  const std::unique_ptr<std::atomic<int64_t>[]> bucket_counts_;
+  const std::unique_ptr<std::atomic<int>[]> bucket_samples_;
+
+  // Odd while an update is in progress; readers retry if it changes.
+  std::atomic<uint32_t> sequence_;
+
+  // Timestamp of the first and the last data point seen, or -1 if none seen.
+  std::atomic<int64_t> first_timestamp_;
+  std::atomic<int64_t> last_timestamp_;
+
+  // Total count and number of samples in the valid buckets.
+  std::atomic<int64_t> accumulated_count_;
+  std::atomic<int> num_samples_;
+
+  // True if |accumulated_count_| has ever grown too large to be contained in
+  // its integer type.
+  std::atomic<bool> overflow_;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_CONCURRENT_RATE_STATISTICS_H_
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/concurrent_rate_statistics.h"
+
+#include <limits>
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/random.h"
+#include "rtc_base/rate_statistics.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kWindowMs = 500;
+
+TEST(ConcurrentRateStatisticsTest, MatchesRateStatistics) {
+  ConcurrentRateStatistics stats(kWindowMs, RateStatistics::kBpsScale);
+  RateStatistics reference(kWindowMs, RateStatistics::kBpsScale);
+  Random random(0x1234);
+  int64_t now_ms = 1000;
+  EXPECT_EQ(reference.Rate(now_ms), stats.Rate(now_ms));
+  for (int i = 0; i < 20000; ++i) {
+    // Mostly short gaps, now and then a quiet period longer than the window.
+    now_ms += random.Rand(0, 99) == 0 ? random.Rand(400, 1200)
+                                      : random.Rand(0, 20);
+    const int64_t count = random.Rand(0, 1500);
+    stats.Update(count, now_ms);
+    reference.Update(count, now_ms);
+    ASSERT_EQ(reference.Rate(now_ms), stats.Rate(now_ms)) << "at " << i;
+
+    // RateStatistics moves its window on Rate() too, so time must not go back
+    // after a query.
+    now_ms += random.Rand(0, 30);
+    ASSERT_EQ(reference.Rate(now_ms), stats.Rate(now_ms)) << "at " << i;
+
+    if (i % 5000 == 4999) {
+      stats.Reset();
+      reference.Reset();
+      EXPECT_FALSE(stats.Rate(now_ms));
+    }
+  }
+}
+
+TEST(ConcurrentRateStatisticsTest, AlignsDecreasingTimestamps) {
+  ConcurrentRateStatistics stats(kWindowMs, RateStatistics::kBpsScale);
+  RateStatistics reference(kWindowMs, RateStatistics::kBpsScale);
+  for (int64_t now_ms : {100, 200, 150, 300}) {
+    stats.Update(1000, now_ms);
+    reference.Update(1000, now_ms);
+  }
+  EXPECT_EQ(reference.Rate(300), stats.Rate(300));
+  EXPECT_EQ(reference.Rate(700), stats.Rate(700));
+}
+
+TEST(ConcurrentRateStatisticsTest, HandlesTooLargeNumbers) {
+  ConcurrentRateStatistics stats(kWindowMs, RateStatistics::kBpsScale);
+  stats.Update(std::numeric_limits<int64_t>::max(), 0);
+  // Rate() should not crash on overflow.
+  EXPECT_FALSE(stats.Rate(0));
+  stats.Update(1, 1);
+  EXPECT_FALSE(stats.Rate(1));
+}
+
+// One count per millisecond, with a scale that makes the rate ten times the
+// number of counts in a 100 ms window.
+constexpr int64_t kConcurrentWindowMs = 100;
+constexpr float kConcurrentScale = 1000.0f;
+constexpr int64_t kLastTimestampMs = 100000;
+
+void UpdateEveryMs(void* obj) {
+  ConcurrentRateStatistics* stats = static_cast<ConcurrentRateStatistics*>(obj);
+  for (int64_t now_ms = 0; now_ms <= kLastTimestampMs; ++now_ms) {
+    stats->Update(1, now_ms);
+  }
+}
+
+TEST(ConcurrentRateStatisticsTest, ReadsConsistentRatesDuringUpdates) {
+  ConcurrentRateStatistics stats(kConcurrentWindowMs, kConcurrentScale);
+  rtc::PlatformThread thread(&UpdateEveryMs, &stats, "writer");
+  thread.Start();
+
+  // Seen from the end of the stream, the window fills up as the writer
+  // progresses, so the rate can only grow, in steps of one count.
+  int64_t last_rate = 0;
+  while (last_rate < 1000) {
+    absl::optional<int64_t> rate = stats.Rate(kLastTimestampMs);
+    if (!rate) {
+      continue;
+    }
+    ASSERT_EQ(0, *rate % 10) << *rate;
+    ASSERT_GE(*rate, last_rate);
+    ASSERT_LE(*rate, 1000);
+    last_rate = *rate;
+  }
+  thread.Stop();
+  EXPECT_EQ(1000, stats.Rate(kLastTimestampMs));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -12,8 +12,41 @@
 
 #include <stddef.h>
 
+#include <new>
+
 namespace rtc {
 
+namespace internal {
+
+static_assert(sizeof(CopyOnWriteBufferStorage) % sizeof(void*) == 0,
+              "The data following the storage header must stay aligned.");
+
+CopyOnWriteBufferStorage* CopyOnWriteBufferStorage::Create(
+    size_t size,
+    size_t capacity,
+    Recycler* recycler) {
+  RTC_DCHECK_LE(size, capacity);
+  void* memory = ::operator new(sizeof(CopyOnWriteBufferStorage) + capacity);
+  return new (memory) CopyOnWriteBufferStorage(size, capacity, recycler);
+}
+
+CopyOnWriteBufferStorage* CopyOnWriteBufferStorage::Create(
+    const uint8_t* data,
+    size_t size,
+    size_t capacity) {
+  CopyOnWriteBufferStorage* storage = Create(size, capacity);
+  if (size > 0)
+    std::memcpy(storage->data(), data, size);
+  return storage;
+}
+
+void CopyOnWriteBufferStorage::Destroy(CopyOnWriteBufferStorage* storage) {
+  storage->~CopyOnWriteBufferStorage();
+  ::operator delete(storage);
+}
+
+}  // namespace internal
+
 CopyOnWriteBuffer::CopyOnWriteBuffer() : offset_(0), size_(0) {
   RTC_DCHECK(IsConsistent());
 }
@@ -32,7 +65,7 @@ CopyOnWriteBuffer::CopyOnWriteBuffer(const std::string& s)
     : CopyOnWriteBuffer(s.data(), s.length()) {}
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size)
-    : buffer_(size > 0 ? new RefCountedObject<Buffer>(size) : nullptr),
+    : buffer_(size > 0 ? Storage::Create(size, size) : nullptr),
       offset_(0),
       size_(size) {
   RTC_DCHECK(IsConsistent());
@@ -40,13 +73,21 @@ CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size)
 
 CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size, size_t capacity)
     : buffer_(size > 0 || capacity > 0
-                  ? new RefCountedObject<Buffer>(size, capacity)
+                  ? Storage::Create(size, std::max(size, capacity))
                   : nullptr),
       offset_(0),
       size_(size) {
   RTC_DCHECK(IsConsistent());
 }
 
+CopyOnWriteBuffer::CopyOnWriteBuffer(scoped_refptr<Storage> buffer,
+                                     size_t size)
+    : buffer_(std::move(buffer)), offset_(0), size_(size) {
+  RTC_DCHECK(buffer_->HasOneRef());
+  buffer_->SetSize(size);
+  RTC_DCHECK(IsConsistent());
+}
+
 CopyOnWriteBuffer::~CopyOnWriteBuffer() = default;
 
 bool CopyOnWriteBuffer::operator==(const CopyOnWriteBuffer& buf) const {
@@ -61,7 +102,7 @@ void CopyOnWriteBuffer::SetSize(size_t size) {
   RTC_DCHECK(IsConsistent());
   if (!buffer_) {
     if (size > 0) {
-      buffer_ = new RefCountedObject<Buffer>(size);
+      buffer_ = Storage::Create(size, size);
       offset_ = 0;
       size_ = size;
     }
@@ -84,7 +125,7 @@ void CopyOnWriteBuffer::EnsureCapacity(size_t new_capacity) {
   RTC_DCHECK(IsConsistent());
   if (!buffer_) {
     if (new_capacity > 0) {
-      buffer_ = new RefCountedObject<Buffer>(0, new_capacity);
+      buffer_ = Storage::Create(0, new_capacity);
       offset_ = 0;
       size_ = 0;
     }
@@ -105,7 +146,7 @@ void CopyOnWriteBuffer::Clear() {
   if (buffer_->HasOneRef()) {
     buffer_->Clear();
   } else {
-    buffer_ = new RefCountedObject<Buffer>(0, capacity());
+    buffer_ = Storage::Create(0, capacity());
   }
   offset_ = 0;
   size_ = 0;
@@ -117,8 +158,8 @@ void CopyOnWriteBuffer::UnshareAndEnsureCapacity(size_t new_capacity) {
     return;
   }
 
-  buffer_ = new RefCountedObject<Buffer>(buffer_->data() + offset_, size_,
-                                         new_capacity);
+  buffer_ = Storage::Create(buffer_->data() + offset_, size_,
+                            std::max(size_, new_capacity));
   offset_ = 0;
   RTC_DCHECK(IsConsistent());
 }
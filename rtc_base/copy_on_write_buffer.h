@@ -22,11 +22,107 @@
 #include "api/scoped_refptr.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/ref_count.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/ref_counter.h"
 #include "rtc_base/system/rtc_export.h"
 
 namespace rtc {
 
+namespace internal {
+
+// The shared storage of CopyOnWriteBuffer. The reference count, the sizes and
+// the data live in a single allocation, so that creating a buffer costs one
+// allocation rather than one for the ref counted object and one for its data.
+// The capacity is fixed; growing a buffer replaces its storage.
+class RTC_EXPORT CopyOnWriteBufferStorage {
+ public:
+  // Takes storage whose last reference was dropped, instead of it being freed.
+  class Recycler {
+   public:
+    virtual void Recycle(CopyOnWriteBufferStorage* storage) = 0;
+
+   protected:
+    virtual ~Recycler() = default;
+  };
+
+  // Returns storage of |size| uninitialized bytes, holding no reference.
+  static CopyOnWriteBufferStorage* Create(size_t size,
+                                          size_t capacity,
+                                          Recycler* recycler = nullptr);
+  static CopyOnWriteBufferStorage* Create(const uint8_t* data,
+                                          size_t size,
+                                          size_t capacity);
+  // Frees storage that holds no references, also when it has a recycler.
+  static void Destroy(CopyOnWriteBufferStorage* storage);
+
+  CopyOnWriteBufferStorage(const CopyOnWriteBufferStorage&) = delete;
+  CopyOnWriteBufferStorage& operator=(const CopyOnWriteBufferStorage&) =
+      delete;
+
+  void AddRef() const { ref_count_.IncRef(); }
+  RefCountReleaseStatus Release() const {
+    // The sole owner can't race with anyone taking a new reference, so
+    // freeing unshared storage, the common case for packets, skips the atomic
+    // read-modify-write. Recycled storage is reused, so it must be left with
+    // a count of 0.
+    if ((recycler_ || !ref_count_.HasOneRef()) &&
+        ref_count_.DecRef() == RefCountReleaseStatus::kOtherRefsRemained) {
+      return RefCountReleaseStatus::kOtherRefsRemained;
+    }
+    CopyOnWriteBufferStorage* storage =
+        const_cast<CopyOnWriteBufferStorage*>(this);
+    if (recycler_) {
+      recycler_->Recycle(storage);
+    } else {
+      Destroy(storage);
+    }
+    return RefCountReleaseStatus::kDroppedLastRef;
+  }
+  bool HasOneRef() const { return ref_count_.HasOneRef(); }
+
+  template <typename T = uint8_t>
+  T* data() {
+    return reinterpret_cast<T*>(this + 1);
+  }
+  template <typename T = uint8_t>
+  const T* data() const {
+    return reinterpret_cast<const T*>(this + 1);
+  }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+
+  void SetSize(size_t size) {
+    RTC_DCHECK_LE(size, capacity_);
+    size_ = size;
+  }
+  void SetData(const uint8_t* data, size_t size) {
+    RTC_DCHECK_LE(size, capacity_);
+    if (size > 0)
+      std::memcpy(this->data(), data, size);
+    size_ = size;
+  }
+  void AppendData(const uint8_t* data, size_t size) {
+    RTC_DCHECK_LE(size_ + size, capacity_);
+    if (size > 0)
+      std::memcpy(this->data() + size_, data, size);
+    size_ += size;
+  }
+  void Clear() { size_ = 0; }
+
+ private:
+  CopyOnWriteBufferStorage(size_t size, size_t capacity, Recycler* recycler)
+      : recycler_(recycler), size_(size), capacity_(capacity) {}
+  ~CopyOnWriteBufferStorage() = default;
+
+  mutable webrtc::webrtc_impl::RefCounter ref_count_{0};
+  Recycler* const recycler_;
+  size_t size_;
+  const size_t capacity_;
+};
+
+}  // namespace internal
+
 class RTC_EXPORT CopyOnWriteBuffer {
  public:
   // An empty buffer.
@@ -55,10 +151,8 @@ class RTC_EXPORT CopyOnWriteBuffer {
                 internal::BufferCompat<uint8_t, T>::value>::type* = nullptr>
   CopyOnWriteBuffer(const T* data, size_t size, size_t capacity)
       : CopyOnWriteBuffer(size, capacity) {
-    if (buffer_) {
+    if (buffer_ && size > 0) {
       std::memcpy(buffer_->data(), data, size);
-      offset_ = 0;
-      size_ = size;
     }
   }
 
@@ -163,12 +257,18 @@ class RTC_EXPORT CopyOnWriteBuffer {
                 internal::BufferCompat<uint8_t, T>::value>::type* = nullptr>
   void SetData(const T* data, size_t size) {
     RTC_DCHECK(IsConsistent());
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
     if (!buffer_) {
-      buffer_ = size > 0 ? new RefCountedObject<Buffer>(data, size) : nullptr;
+      buffer_ = size > 0 ? Storage::Create(bytes, size, size) : nullptr;
     } else if (!buffer_->HasOneRef()) {
-      buffer_ = new RefCountedObject<Buffer>(data, size, capacity());
+      buffer_ = Storage::Create(bytes, size, std::max(size, capacity()));
+    } else if (size > buffer_->capacity()) {
+      // Grow like rtc::Buffer does, with headroom for further growth.
+      buffer_ = Storage::Create(
+          bytes, size,
+          std::max(size, buffer_->capacity() + buffer_->capacity() / 2));
     } else {
-      buffer_->SetData(data, size);
+      buffer_->SetData(bytes, size);
     }
     offset_ = 0;
     size_ = size;
@@ -200,8 +300,9 @@ class RTC_EXPORT CopyOnWriteBuffer {
                 internal::BufferCompat<uint8_t, T>::value>::type* = nullptr>
   void AppendData(const T* data, size_t size) {
     RTC_DCHECK(IsConsistent());
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
     if (!buffer_) {
-      buffer_ = new RefCountedObject<Buffer>(data, size);
+      buffer_ = Storage::Create(bytes, size, size);
       offset_ = 0;
       size_ = size;
       RTC_DCHECK(IsConsistent());
@@ -212,7 +313,7 @@ class RTC_EXPORT CopyOnWriteBuffer {
 
     buffer_->SetSize(offset_ +
                      size_);  // Remove data to the right of the slice.
-    buffer_->AppendData(data, size);
+    buffer_->AppendData(bytes, size);
     size_ += size;
 
     RTC_DCHECK(IsConsistent());
@@ -262,6 +363,12 @@ class RTC_EXPORT CopyOnWriteBuffer {
   }
 
  private:
+  friend class CopyOnWriteBufferPool;
+  using Storage = internal::CopyOnWriteBufferStorage;
+
+  // Wrap storage owned by CopyOnWriteBufferPool. |buffer| must not be shared.
+  CopyOnWriteBuffer(scoped_refptr<Storage> buffer, size_t size);
+
   // Create a copy of the underlying data if it is referenced from other Buffer
   // objects or there is not enough capacity.
   void UnshareAndEnsureCapacity(size_t new_capacity);
@@ -276,8 +383,8 @@ class RTC_EXPORT CopyOnWriteBuffer {
     }
   }
 
-  // buffer_ is either null, or points to an rtc::Buffer with capacity > 0.
-  scoped_refptr<RefCountedObject<Buffer>> buffer_;
+  // buffer_ is either null, or points to storage with capacity > 0.
+  scoped_refptr<Storage> buffer_;
   // This buffer may represent a slice of a original data.
   size_t offset_;  // Offset of a current slice in the original data in buffer_.
                    // Should be 0 if the buffer_ is empty.
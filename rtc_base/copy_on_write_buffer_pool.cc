@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/copy_on_write_buffer_pool.h"
+
+#include <string.h>
+
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/ref_counted_object.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// State shared between the pool and the buffers it created, so that buffers
+// can outlive the pool. Each pooled storage, in use or free, holds a
+// reference to the core.
+class CopyOnWriteBufferPool::Core
+    : public RefCountInterface,
+      public internal::CopyOnWriteBufferStorage::Recycler {
+ public:
+  Core(size_t max_free_buffers_per_size_class,
+       absl::optional<int> numa_node)
+      : max_free_buffers_per_size_class_(max_free_buffers_per_size_class),
+        numa_node_(numa_node) {}
+
+  scoped_refptr<Storage> Allocate(size_t capacity);
+  // Takes ownership of |storage|, which has no references left.
+  void Recycle(Storage* storage) override;
+  // Frees all unused storage. Storage returned afterwards is freed directly.
+  void Close();
+
+  Stats GetStats() const {
+    CritScope lock(&lock_);
+    return stats_;
+  }
+
+ protected:
+  ~Core() override { RTC_DCHECK(closed_); }
+
+ private:
+  struct SizeClass {
+    size_t capacity;
+    std::vector<Storage*> free_buffers;
+  };
+
+  // Frees pooled storage and drops its reference to |this|.
+  void Free(Storage* storage);
+
+  const size_t max_free_buffers_per_size_class_;
+  const absl::optional<int> numa_node_;
+  CriticalSection lock_;
+  bool closed_ RTC_GUARDED_BY(lock_) = false;
+  std::vector<SizeClass> size_classes_ RTC_GUARDED_BY(lock_);
+  Stats stats_ RTC_GUARDED_BY(lock_);
+};
+
+scoped_refptr<CopyOnWriteBufferPool::Storage>
+CopyOnWriteBufferPool::Core::Allocate(size_t capacity) {
+  bool pooled = false;
+  {
+    CritScope lock(&lock_);
+    RTC_DCHECK(!closed_);
+    SizeClass* size_class = nullptr;
+    for (SizeClass& candidate : size_classes_) {
+      if (candidate.capacity == capacity) {
+        size_class = &candidate;
+        break;
+      }
+    }
+    if (!size_class && size_classes_.size() < kMaxSizeClasses) {
+      size_classes_.push_back(SizeClass{capacity, {}});
+      size_class = &size_classes_.back();
+    }
+    if (size_class && !size_class->free_buffers.empty()) {
+      Storage* buffer = size_class->free_buffers.back();
+      size_class->free_buffers.pop_back();
+      ++stats_.hits;
+      return buffer;
+    }
+    ++stats_.misses;
+    pooled = size_class != nullptr;
+  }
+  if (!pooled)
+    return Storage::Create(0, capacity);
+  AddRef();
+  if (!numa_node_)
+    return Storage::Create(0, capacity, this);
+  webrtc::ScopedNumaMemoryPolicy memory_policy(numa_node_);
+  Storage* buffer = Storage::Create(0, capacity, this);
+  memset(buffer->data(), 0, capacity);
+  return buffer;
+}
+
+void CopyOnWriteBufferPool::Core::Recycle(Storage* buffer) {
+  {
+    CritScope lock(&lock_);
+    if (!closed_) {
+      for (SizeClass& size_class : size_classes_) {
+        if (size_class.capacity == buffer->capacity()) {
+          if (size_class.free_buffers.size() <
+              max_free_buffers_per_size_class_) {
+            buffer->Clear();
+            size_class.free_buffers.push_back(buffer);
+            return;
+          }
+          break;
+        }
+      }
+    }
+  }
+  // Freeing the buffer may drop the last reference to |this|, so it must
+  // happen outside the lock.
+  Free(buffer);
+}
+
+void CopyOnWriteBufferPool::Core::Free(Storage* storage) {
+  Storage::Destroy(storage);
+  Release();
+}
+
+void CopyOnWriteBufferPool::Core::Close() {
+  std::vector<SizeClass> size_classes;
+  {
+    CritScope lock(&lock_);
+    closed_ = true;
+    size_classes.swap(size_classes_);
+  }
+  for (SizeClass& size_class : size_classes) {
+    for (Storage* buffer : size_class.free_buffers)
+      Free(buffer);
+  }
+}
+
+CopyOnWriteBufferPool::CopyOnWriteBufferPool()
+    : CopyOnWriteBufferPool(kDefaultMaxFreeBuffersPerSizeClass) {}
+
+CopyOnWriteBufferPool::CopyOnWriteBufferPool(
+    size_t max_free_buffers_per_size_class)
+    : CopyOnWriteBufferPool(max_free_buffers_per_size_class,
+                            webrtc::GetDefaultBufferAllocator()) {}
+
+CopyOnWriteBufferPool::CopyOnWriteBufferPool(
+    size_t max_free_buffers_per_size_class,
+    webrtc::BufferAllocator* allocator)
+    : core_(new RefCountedObject<Core>(max_free_buffers_per_size_class,
+                                       allocator->numa_node())) {}
+
+CopyOnWriteBufferPool::~CopyOnWriteBufferPool() {
+  core_->Close();
+}
+
+CopyOnWriteBuffer CopyOnWriteBufferPool::Create(size_t size,
+                                                size_t capacity) {
+  RTC_DCHECK_LE(size, capacity);
+  if (capacity == 0)
+    return CopyOnWriteBuffer();
+  return CopyOnWriteBuffer(core_->Allocate(capacity), size);
+}
+
+CopyOnWriteBufferPool::Stats CopyOnWriteBufferPool::GetStats() const {
+  return core_->GetStats();
+}
+
+}  // namespace rtc
@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_COPY_ON_WRITE_BUFFER_POOL_H_
+#define RTC_BASE_COPY_ON_WRITE_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api/scoped_refptr.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/memory/buffer_allocator.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace rtc {
+
+// Recycles the storage of CopyOnWriteBuffers that are created at a high rate
+// with a handful of distinct capacities, e.g. RTP packets sized to the MTU.
+// Buffers returned by Create() are not shared, so writing to them never
+// copies. When the last CopyOnWriteBuffer referencing the storage goes away,
+// on whichever thread that happens, the storage goes back to the pool instead
+// of being freed.
+//
+// Storage is pooled per exact capacity, since the capacity of a buffer is
+// observable (e.g. through RtpPacket::FreeCapacity()). The first
+// kMaxSizeClasses distinct capacities requested become the pooled size
+// classes; buffers with other capacities are allocated as usual.
+//
+// The pool may be destroyed while buffers created by it are still in use.
+// Thread safe, but intended to be owned by a single component, so that
+// contention on the internal lock stays low.
+class RTC_EXPORT CopyOnWriteBufferPool {
+ public:
+  struct Stats {
+    // Number of buffers that reused pooled storage.
+    int64_t hits = 0;
+    // Number of buffers that needed a new allocation.
+    int64_t misses = 0;
+  };
+
+  static constexpr size_t kMaxSizeClasses = 4;
+  static constexpr size_t kDefaultMaxFreeBuffersPerSizeClass = 256;
+
+  CopyOnWriteBufferPool();
+  // At most |max_free_buffers_per_size_class| unused buffers are kept per size
+  // class; storage returned beyond that is freed.
+  explicit CopyOnWriteBufferPool(size_t max_free_buffers_per_size_class);
+  // Places new storage on the NUMA node of |allocator|, if it has one, e.g.
+  // the node of the threads that process the buffers. CopyOnWriteBuffers
+  // allocate their storage themselves, so the pool can't use |allocator| for
+  // it; instead the pool touches new storage while the thread prefers the
+  // node, which places the pages that are new to the process there.
+  CopyOnWriteBufferPool(size_t max_free_buffers_per_size_class,
+                        webrtc::BufferAllocator* allocator);
+  ~CopyOnWriteBufferPool();
+
+  CopyOnWriteBufferPool(const CopyOnWriteBufferPool&) = delete;
+  CopyOnWriteBufferPool& operator=(const CopyOnWriteBufferPool&) = delete;
+
+  // Returns an unshared buffer of |size| uninitialized bytes with exactly
+  // |capacity| bytes of capacity.
+  CopyOnWriteBuffer Create(size_t size, size_t capacity);
+
+  Stats GetStats() const;
+
+ private:
+  class Core;
+  using Storage = internal::CopyOnWriteBufferStorage;
+
+  const scoped_refptr<Core> core_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_COPY_ON_WRITE_BUFFER_POOL_H_
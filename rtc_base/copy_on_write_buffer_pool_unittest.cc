@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/copy_on_write_buffer_pool.h"
+
+#include <string.h>
+
+#include <memory>
+#include <utility>
+
+#include "rtc_base/event.h"
+#include "rtc_base/memory/buffer_allocator.h"
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace rtc {
+
+TEST(CopyOnWriteBufferPoolTest, CreatesBufferWithRequestedSizeAndCapacity) {
+  CopyOnWriteBufferPool pool;
+  CopyOnWriteBuffer buffer = pool.Create(12, 1500);
+  EXPECT_EQ(buffer.size(), 12u);
+  EXPECT_EQ(buffer.capacity(), 1500u);
+}
+
+TEST(CopyOnWriteBufferPoolTest, ReusesReleasedStorage) {
+  CopyOnWriteBufferPool pool;
+  const uint8_t* data;
+  {
+    CopyOnWriteBuffer buffer = pool.Create(100, 1500);
+    data = buffer.data();
+  }
+  CopyOnWriteBuffer buffer = pool.Create(50, 1500);
+  EXPECT_EQ(buffer.cdata(), data);
+  EXPECT_EQ(buffer.size(), 50u);
+  EXPECT_EQ(pool.GetStats().hits, 1);
+  EXPECT_EQ(pool.GetStats().misses, 1);
+}
+
+TEST(CopyOnWriteBufferPoolTest, DoesNotReuseStorageThatIsStillShared) {
+  CopyOnWriteBufferPool pool;
+  CopyOnWriteBuffer shared;
+  {
+    CopyOnWriteBuffer buffer = pool.Create(100, 1500);
+    shared = buffer;
+  }
+  CopyOnWriteBuffer buffer = pool.Create(100, 1500);
+  EXPECT_NE(buffer.cdata(), shared.cdata());
+  EXPECT_EQ(pool.GetStats().hits, 0);
+  EXPECT_EQ(pool.GetStats().misses, 2);
+}
+
+TEST(CopyOnWriteBufferPoolTest, WritingToPooledBufferDoesNotCopy) {
+  CopyOnWriteBufferPool pool;
+  CopyOnWriteBuffer buffer = pool.Create(10, 100);
+  const uint8_t* data = buffer.cdata();
+  EXPECT_EQ(buffer.data(), data);
+  buffer.SetSize(100);
+  EXPECT_EQ(buffer.cdata(), data);
+}
+
+TEST(CopyOnWriteBufferPoolTest, PoolsCapacitiesSeparately) {
+  CopyOnWriteBufferPool pool;
+  pool.Create(10, 1200);
+  CopyOnWriteBuffer buffer = pool.Create(10, 1500);
+  EXPECT_EQ(buffer.capacity(), 1500u);
+  EXPECT_EQ(pool.GetStats().hits, 0);
+  pool.Create(10, 1200);
+  EXPECT_EQ(pool.GetStats().hits, 1);
+}
+
+TEST(CopyOnWriteBufferPoolTest, LimitsNumberOfSizeClasses) {
+  CopyOnWriteBufferPool pool;
+  for (size_t i = 0; i < CopyOnWriteBufferPool::kMaxSizeClasses; ++i) {
+    pool.Create(0, 100 + i);
+  }
+  pool.Create(0, 1000);
+  pool.Create(0, 1000);
+  EXPECT_EQ(pool.GetStats().hits, 0);
+  pool.Create(0, 100);
+  EXPECT_EQ(pool.GetStats().hits, 1);
+}
+
+TEST(CopyOnWriteBufferPoolTest, LimitsNumberOfFreeBuffers) {
+  CopyOnWriteBufferPool pool(/*max_free_buffers_per_size_class=*/1);
+  {
+    CopyOnWriteBuffer first = pool.Create(0, 100);
+    CopyOnWriteBuffer second = pool.Create(0, 100);
+  }
+  CopyOnWriteBuffer first = pool.Create(0, 100);
+  CopyOnWriteBuffer second = pool.Create(0, 100);
+  EXPECT_EQ(pool.GetStats().hits, 1);
+  EXPECT_EQ(pool.GetStats().misses, 3);
+}
+
+TEST(CopyOnWriteBufferPoolTest, BuffersMayOutliveThePool) {
+  auto pool = std::make_unique<CopyOnWriteBufferPool>();
+  CopyOnWriteBuffer buffer = pool->Create(3, 100);
+  pool.reset();
+  buffer.data()[0] = 1;
+  EXPECT_EQ(buffer.size(), 3u);
+}
+
+TEST(CopyOnWriteBufferPoolTest, StorageReleasedOnOtherThreadIsReused) {
+  CopyOnWriteBufferPool pool;
+  struct Context {
+    CopyOnWriteBuffer buffer;
+    Event done;
+  } context;
+  context.buffer = pool.Create(100, 1500);
+  PlatformThread thread(
+      [](void* param) {
+        Context* context = static_cast<Context*>(param);
+        context->buffer = CopyOnWriteBuffer();
+        context->done.Set();
+      },
+      &context, "BufferReleaser");
+  thread.Start();
+  context.done.Wait(Event::kForever);
+  thread.Stop();
+
+  pool.Create(100, 1500);
+  EXPECT_EQ(pool.GetStats().hits, 1);
+}
+
+TEST(CopyOnWriteBufferPoolTest, CreatesBuffersOnNumaNode) {
+  CopyOnWriteBufferPool pool(
+      CopyOnWriteBufferPool::kDefaultMaxFreeBuffersPerSizeClass,
+      webrtc::GetNumaBufferAllocator(0));
+  CopyOnWriteBuffer buffer = pool.Create(100, 1500);
+  EXPECT_EQ(100u, buffer.size());
+  EXPECT_EQ(1500u, buffer.capacity());
+  memset(buffer.data(), 0xab, buffer.size());
+  buffer = CopyOnWriteBuffer();
+
+  pool.Create(100, 1500);
+  EXPECT_EQ(pool.GetStats().hits, 1);
+}
+
+}  // namespace rtc
@@ -0,0 +1,184 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/cpu_accounting.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "absl/base/config.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+namespace {
+
+std::atomic<bool> g_cpu_accounting_enabled{false};
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+class ThreadCpuUsage;
+
+// Keeps track of the threads that have accounted CPU time, so that it can be
+// reported from any thread.
+class CpuUsageRegistry {
+ public:
+  void AddThread(ThreadCpuUsage* thread);
+  void RemoveThread(ThreadCpuUsage* thread);
+  CpuUsageReport GetReport();
+
+ private:
+  CriticalSection crit_;
+  std::vector<ThreadCpuUsage*> threads_ RTC_GUARDED_BY(crit_);
+  int64_t exited_threads_nanos_[kNumCpuSubsystems] RTC_GUARDED_BY(crit_) = {};
+};
+
+CpuUsageRegistry& GetRegistry() {
+  // google.github.io/styleguide/cppguide.html#Static_and_Global_Variables
+  static auto& registry = *new CpuUsageRegistry();
+  return registry;
+}
+
+class ThreadCpuUsage {
+ public:
+  ~ThreadCpuUsage() {
+    if (registered_)
+      GetRegistry().RemoveThread(this);
+  }
+
+  void Add(CpuSubsystem subsystem, int64_t nanos) {
+    if (!registered_) {
+      thread_id_ = CurrentThreadId();
+      registered_ = true;
+      GetRegistry().AddThread(this);
+    }
+    // Only written by the owning thread, so relaxed ordering is enough.
+    cpu_time_nanos_[static_cast<int>(subsystem)].fetch_add(
+        nanos, std::memory_order_relaxed);
+  }
+
+  int64_t cpu_time_nanos(int subsystem) const {
+    return cpu_time_nanos_[subsystem].load(std::memory_order_relaxed);
+  }
+  PlatformThreadId thread_id() const { return thread_id_; }
+
+  ScopedCpuAccounting* current_scope = nullptr;
+
+ private:
+  bool registered_ = false;
+  PlatformThreadId thread_id_ = 0;
+  std::atomic<int64_t> cpu_time_nanos_[kNumCpuSubsystems] = {};
+};
+
+thread_local ThreadCpuUsage g_thread_cpu_usage;
+
+void CpuUsageRegistry::AddThread(ThreadCpuUsage* thread) {
+  CritScope lock(&crit_);
+  threads_.push_back(thread);
+}
+
+void CpuUsageRegistry::RemoveThread(ThreadCpuUsage* thread) {
+  CritScope lock(&crit_);
+  for (int i = 0; i < kNumCpuSubsystems; ++i)
+    exited_threads_nanos_[i] += thread->cpu_time_nanos(i);
+  threads_.erase(std::find(threads_.begin(), threads_.end(), thread));
+}
+
+CpuUsageReport CpuUsageRegistry::GetReport() {
+  CpuUsageReport report;
+  CritScope lock(&crit_);
+  std::copy(std::begin(exited_threads_nanos_), std::end(exited_threads_nanos_),
+            std::begin(report.cpu_time_nanos));
+  report.threads.reserve(threads_.size());
+  for (const ThreadCpuUsage* thread : threads_) {
+    CpuUsageReport::ThreadUsage usage;
+    usage.thread_id = thread->thread_id();
+    for (int i = 0; i < kNumCpuSubsystems; ++i) {
+      usage.cpu_time_nanos[i] = thread->cpu_time_nanos(i);
+      report.cpu_time_nanos[i] += usage.cpu_time_nanos[i];
+    }
+    report.threads.push_back(usage);
+  }
+  return report;
+}
+#endif  // defined(ABSL_HAVE_THREAD_LOCAL)
+
+}  // namespace
+
+const char* CpuSubsystemToString(CpuSubsystem subsystem) {
+  switch (subsystem) {
+    case CpuSubsystem::kEncoder:
+      return "encoder";
+    case CpuSubsystem::kDecoder:
+      return "decoder";
+    case CpuSubsystem::kAudioProcessing:
+      return "audio_processing";
+    case CpuSubsystem::kSrtp:
+      return "srtp";
+    case CpuSubsystem::kPacing:
+      return "pacing";
+    case CpuSubsystem::kIce:
+      return "ice";
+    case CpuSubsystem::kNumSubsystems:
+      break;
+  }
+  RTC_NOTREACHED();
+  return "";
+}
+
+CpuUsageReport::CpuUsageReport() : cpu_time_nanos{} {}
+CpuUsageReport::CpuUsageReport(const CpuUsageReport&) = default;
+CpuUsageReport::~CpuUsageReport() = default;
+
+void EnableCpuAccounting(bool enable) {
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+  g_cpu_accounting_enabled.store(enable, std::memory_order_relaxed);
+#else
+  if (enable)
+    RTC_LOG(LS_WARNING) << "CPU accounting needs thread_local support.";
+#endif
+}
+
+CpuUsageReport GetCpuUsageReport() {
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+  return GetRegistry().GetReport();
+#else
+  return CpuUsageReport();
+#endif
+}
+
+ScopedCpuAccounting::ScopedCpuAccounting(CpuSubsystem subsystem)
+    : subsystem_(subsystem),
+      enabled_(g_cpu_accounting_enabled.load(std::memory_order_relaxed)) {
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+  if (!enabled_)
+    return;
+  parent_ = g_thread_cpu_usage.current_scope;
+  g_thread_cpu_usage.current_scope = this;
+  start_nanos_ = GetThreadCpuTimeNanos();
+#endif
+}
+
+ScopedCpuAccounting::~ScopedCpuAccounting() {
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+  if (!enabled_)
+    return;
+  const int64_t elapsed_nanos = GetThreadCpuTimeNanos() - start_nanos_;
+  g_thread_cpu_usage.Add(subsystem_, elapsed_nanos - nested_nanos_);
+  if (parent_)
+    parent_->nested_nanos_ += elapsed_nanos;
+  RTC_DCHECK_EQ(g_thread_cpu_usage.current_scope, this);
+  g_thread_cpu_usage.current_scope = parent_;
+#endif
+}
+
+}  // namespace rtc
@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_CPU_ACCOUNTING_H_
+#define RTC_BASE_CPU_ACCOUNTING_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace rtc {
+
+// Subsystems that CPU time is attributed to.
+enum class CpuSubsystem {
+  kEncoder = 0,
+  kDecoder,
+  kAudioProcessing,
+  kSrtp,
+  kPacing,
+  kIce,
+  kNumSubsystems,
+};
+
+constexpr int kNumCpuSubsystems = static_cast<int>(CpuSubsystem::kNumSubsystems);
+
+RTC_EXPORT const char* CpuSubsystemToString(CpuSubsystem subsystem);
+
+// CPU time attributed to each subsystem, indexed by CpuSubsystem, since
+// accounting was enabled.
+struct RTC_EXPORT CpuUsageReport {
+  struct ThreadUsage {
+    PlatformThreadId thread_id;
+    int64_t cpu_time_nanos[kNumCpuSubsystems];
+  };
+
+  CpuUsageReport();
+  CpuUsageReport(const CpuUsageReport&);
+  ~CpuUsageReport();
+
+  // Includes threads that have exited.
+  int64_t cpu_time_nanos[kNumCpuSubsystems];
+  // Threads that are still running and have spent time in any subsystem.
+  std::vector<ThreadUsage> threads;
+};
+
+// Accounting is off by default, in which case ScopedCpuAccounting costs an
+// atomic load. When on, every scope reads the thread CPU time twice.
+RTC_EXPORT void EnableCpuAccounting(bool enable);
+
+RTC_EXPORT CpuUsageReport GetCpuUsageReport();
+
+// Attributes the CPU time the current thread spends in the scope to
+// |subsystem|. Time spent in a nested scope is only attributed to the
+// subsystem of the nested scope.
+class RTC_EXPORT ScopedCpuAccounting {
+ public:
+  explicit ScopedCpuAccounting(CpuSubsystem subsystem);
+  ScopedCpuAccounting(const ScopedCpuAccounting&) = delete;
+  ScopedCpuAccounting& operator=(const ScopedCpuAccounting&) = delete;
+  ~ScopedCpuAccounting();
+
+ private:
+  const CpuSubsystem subsystem_;
+  const bool enabled_;
+  ScopedCpuAccounting* parent_ = nullptr;
+  int64_t start_nanos_ = 0;
+  int64_t nested_nanos_ = 0;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_CPU_ACCOUNTING_H_
@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/cpu_accounting.h"
+
+#include "absl/base/config.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+const int kProcessingTimeMillisecs = 50;
+
+void ConsumeCpuTime() {
+  int64_t stop_cpu_time = GetThreadCpuTimeNanos() +
+                          kProcessingTimeMillisecs * kNumNanosecsPerMillisec;
+  while (GetThreadCpuTimeNanos() < stop_cpu_time) {
+  }
+}
+
+int64_t SubsystemNanos(const CpuUsageReport& report, CpuSubsystem subsystem) {
+  return report.cpu_time_nanos[static_cast<int>(subsystem)];
+}
+
+int64_t CurrentThreadSubsystemNanos(CpuSubsystem subsystem) {
+  for (const CpuUsageReport::ThreadUsage& usage :
+       GetCpuUsageReport().threads) {
+    if (usage.thread_id == CurrentThreadId())
+      return usage.cpu_time_nanos[static_cast<int>(subsystem)];
+  }
+  return 0;
+}
+}  // namespace
+
+TEST(CpuAccountingTest, NothingIsAccountedWhenDisabled) {
+  const CpuUsageReport before = GetCpuUsageReport();
+  {
+    ScopedCpuAccounting scope(CpuSubsystem::kEncoder);
+    ConsumeCpuTime();
+  }
+  EXPECT_EQ(SubsystemNanos(before, CpuSubsystem::kEncoder),
+            SubsystemNanos(GetCpuUsageReport(), CpuSubsystem::kEncoder));
+}
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+TEST(CpuAccountingTest, NestedScopeIsOnlyAccountedToItsSubsystem) {
+  EnableCpuAccounting(true);
+  const int64_t encoder_before =
+      CurrentThreadSubsystemNanos(CpuSubsystem::kEncoder);
+  const int64_t srtp_before = CurrentThreadSubsystemNanos(CpuSubsystem::kSrtp);
+  {
+    ScopedCpuAccounting encoder_scope(CpuSubsystem::kEncoder);
+    ConsumeCpuTime();
+    ScopedCpuAccounting srtp_scope(CpuSubsystem::kSrtp);
+    ConsumeCpuTime();
+    ConsumeCpuTime();
+  }
+  EnableCpuAccounting(false);
+
+  const int64_t encoder_nanos =
+      CurrentThreadSubsystemNanos(CpuSubsystem::kEncoder) - encoder_before;
+  const int64_t srtp_nanos =
+      CurrentThreadSubsystemNanos(CpuSubsystem::kSrtp) - srtp_before;
+  EXPECT_GE(encoder_nanos, kProcessingTimeMillisecs * kNumNanosecsPerMillisec);
+  EXPECT_GE(srtp_nanos, 2 * kProcessingTimeMillisecs * kNumNanosecsPerMillisec);
+  EXPECT_LT(encoder_nanos, srtp_nanos);
+}
+
+TEST(CpuAccountingTest, KeepsTimeOfExitedThreads) {
+  EnableCpuAccounting(true);
+  const int64_t decoder_before =
+      SubsystemNanos(GetCpuUsageReport(), CpuSubsystem::kDecoder);
+  PlatformThread thread(
+      [](void*) {
+        ScopedCpuAccounting scope(CpuSubsystem::kDecoder);
+        ConsumeCpuTime();
+      },
+      nullptr, "CpuAccountingTest");
+  thread.Start();
+  thread.Stop();
+  EnableCpuAccounting(false);
+
+  EXPECT_GE(SubsystemNanos(GetCpuUsageReport(), CpuSubsystem::kDecoder) -
+                decoder_before,
+            kProcessingTimeMillisecs * kNumNanosecsPerMillisec);
+}
+#endif  // defined(ABSL_HAVE_THREAD_LOCAL)
+
+}  // namespace rtc
@@ -34,4 +34,23 @@ TEST(Crc32Test, TestMultipleUpdates) {
   EXPECT_EQ(0x171A3F5FU, c);
 }
 
+// Checks the 8-byte steps against byte-wise updates, for every length and
+// alignment of the input that mixes them.
+TEST(Crc32Test, TestLengthsAndAlignments) {
+  std::string input;
+  for (int i = 0; i < 64; ++i) {
+    input.push_back(static_cast<char>(i * 37 + 11));
+  }
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t len = 0; offset + len <= input.size(); ++len) {
+      uint32_t expected = 0;
+      for (size_t i = 0; i < len; ++i) {
+        expected = UpdateCrc32(expected, &input[offset + i], 1);
+      }
+      EXPECT_EQ(expected, ComputeCrc32(input.data() + offset, len))
+          << "offset " << offset << ", length " << len;
+    }
+  }
+}
+
 }  // namespace rtc
@@ -14,8 +14,10 @@
 
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/lock_profiler.h"
 #include "rtc_base/platform_thread_types.h"
 #include "rtc_base/system/unused.h"
+#include "rtc_base/time_utils.h"
 
 // TODO(tommi): Split this file up to per-platform implementation files.
 
@@ -27,7 +29,14 @@
 
 namespace rtc {
 
-CriticalSection::CriticalSection() {
+CriticalSection::CriticalSection() : CriticalSection(nullptr) {}
+
+#if defined(RTC_LOCK_PROFILING)
+CriticalSection::CriticalSection(const char* profiling_tag)
+    : profiling_tag_(profiling_tag) {
+#else
+CriticalSection::CriticalSection(const char* /*profiling_tag*/) {
+#endif
 #if defined(WEBRTC_WIN)
   InitializeCriticalSection(&crit_);
 #elif defined(WEBRTC_POSIX)
@@ -72,7 +81,18 @@ CriticalSection::~CriticalSection() {
 
 void CriticalSection::Enter() const RTC_EXCLUSIVE_LOCK_FUNCTION() {
 #if defined(WEBRTC_WIN)
+#if defined(RTC_LOCK_PROFILING)
+  if (!TryEnterCriticalSection(&crit_)) {
+    PlatformThreadId holder = holder_.load(std::memory_order_relaxed);
+    int64_t wait_start_ns = SystemTimeNanos();
+    EnterCriticalSection(&crit_);
+    RecordLockContention(profiling_tag_, holder,
+                         SystemTimeNanos() - wait_start_ns);
+  }
+  holder_.store(CurrentThreadId(), std::memory_order_relaxed);
+#else
   EnterCriticalSection(&crit_);
+#endif
 #elif defined(WEBRTC_POSIX)
 #if defined(WEBRTC_MAC) && !RTC_USE_NATIVE_MUTEX_ON_MAC
   int spin = 3000;
@@ -111,6 +131,15 @@ void CriticalSection::Enter() const RTC_EXCLUSIVE_LOCK_FUNCTION() {
   owning_thread_ = self;
   ++recursion_;
 
+#elif defined(RTC_LOCK_PROFILING)
+  if (pthread_mutex_trylock(&mutex_) != 0) {
+    PlatformThreadId holder = holder_.load(std::memory_order_relaxed);
+    int64_t wait_start_ns = SystemTimeNanos();
+    pthread_mutex_lock(&mutex_);
+    RecordLockContention(profiling_tag_, holder,
+                         SystemTimeNanos() - wait_start_ns);
+  }
+  holder_.store(CurrentThreadId(), std::memory_order_relaxed);
 #else
   pthread_mutex_lock(&mutex_);
 #endif
@@ -146,6 +175,9 @@ bool CriticalSection::TryEnter() const RTC_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
 #else
   if (pthread_mutex_trylock(&mutex_) != 0)
     return false;
+#if defined(RTC_LOCK_PROFILING)
+  holder_.store(CurrentThreadId(), std::memory_order_relaxed);
+#endif
 #endif
 #if RTC_DCHECK_IS_ON
   if (!recursion_count_) {
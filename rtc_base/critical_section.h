@@ -11,6 +11,10 @@
 #ifndef RTC_BASE_CRITICAL_SECTION_H_
 #define RTC_BASE_CRITICAL_SECTION_H_
 
+#if defined(RTC_LOCK_PROFILING)
+#include <atomic>
+#endif
+
 #include "rtc_base/checks.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/platform_thread_types.h"
@@ -49,6 +53,10 @@ namespace rtc {
 class RTC_LOCKABLE RTC_EXPORT CriticalSection {
  public:
   CriticalSection();
+  // |profiling_tag| names the lock in lock contention profiles, see
+  // rtc_base/lock_profiler.h. It must outlive the CriticalSection, e.g. be a
+  // string literal.
+  explicit CriticalSection(const char* profiling_tag);
   ~CriticalSection();
 
   void Enter() const RTC_EXCLUSIVE_LOCK_FUNCTION();
@@ -59,6 +67,13 @@ class RTC_LOCKABLE RTC_EXPORT CriticalSection {
   // Use only for RTC_DCHECKing.
   bool CurrentThreadIsOwner() const;
 
+#if defined(RTC_LOCK_PROFILING)
+  const char* const profiling_tag_;
+  // The thread that acquired the lock last, reported as the holder when
+  // another thread has to wait.
+  mutable std::atomic<PlatformThreadId> holder_{0};
+#endif
+
 #if defined(WEBRTC_WIN)
   mutable CRITICAL_SECTION crit_;
 #elif defined(WEBRTC_POSIX)
@@ -14,9 +14,15 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/base/attributes.h"
+#include "absl/base/config.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/critical_section.h"
@@ -24,6 +30,8 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/platform_thread_types.h"
+#include "rtc_base/spsc_queue.h"
+#include "rtc_base/string_utils.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
 #include "rtc_base/time_utils.h"
@@ -84,11 +92,53 @@ static void EventTracingThreadFunc(void* params);
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
 
+// Identifies an EventLogger instance, so that per-thread buffers of a logger
+// that has been shut down aren't reused by the next one.
+static std::atomic<uint64_t> g_next_logger_generation{1};
+
+// Trace events are copied into fixed-size records, so that they can be queued
+// without allocating.
+constexpr int kMaxTraceArgs = 2;
+constexpr size_t kMaxCopiedStringLength = 48;
+
+struct TraceRecord {
+  const char* name;
+  const unsigned char* category_enabled;
+  char phase;
+  int num_args;
+  const char* arg_names[kMaxTraceArgs];
+  unsigned char arg_types[kMaxTraceArgs];
+  unsigned long long arg_values[kMaxTraceArgs];
+  // Storage for TRACE_VALUE_TYPE_COPY_STRING arguments, truncated if needed.
+  char copied_strings[kMaxTraceArgs][kMaxCopiedStringLength];
+  uint64_t timestamp;
+  rtc::PlatformThreadId tid;
+};
+
+// Events traced on one thread, until the logging thread drains them.
+struct ThreadBuffer {
+  static constexpr size_t kCapacity = 1024;
+
+  explicit ThreadBuffer(uint64_t generation)
+      : generation(generation), events(kCapacity) {}
+
+  const uint64_t generation;
+  // Pushed to by the traced thread, popped by the EventLogger.
+  SpscQueue<TraceRecord> events;
+};
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+// Also owned by the EventLogger, which can tell from the use count when the
+// thread has exited.
+ABSL_CONST_INIT thread_local std::shared_ptr<ThreadBuffer> g_thread_buffer;
+#endif
+
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
  public:
   EventLogger()
-      : logging_thread_(EventTracingThreadFunc,
+      : generation_(g_next_logger_generation++),
+        logging_thread_(EventTracingThreadFunc,
                         this,
                         "EventTracingThread",
                         kLowPriority) {}
@@ -102,87 +152,69 @@ class EventLogger final {
                      const unsigned char* arg_types,
                      const unsigned long long* arg_values,
                      uint64_t timestamp,
-                     int pid,
                      rtc::PlatformThreadId thread_id) {
-    std::vector<TraceArg> args(num_args);
-    for (int i = 0; i < num_args; ++i) {
-      TraceArg& arg = args[i];
-      arg.name = arg_names[i];
-      arg.type = arg_types[i];
-      arg.value.as_uint = arg_values[i];
-
+    RTC_DCHECK_LE(num_args, kMaxTraceArgs);
+    TraceRecord record;
+    record.name = name;
+    record.category_enabled = category_enabled;
+    record.phase = phase;
+    record.num_args = std::min(num_args, kMaxTraceArgs);
+    for (int i = 0; i < record.num_args; ++i) {
+      record.arg_names[i] = arg_names[i];
+      record.arg_types[i] = arg_types[i];
+      record.arg_values[i] = arg_values[i];
       // Value is a pointer to a temporary string, so we have to make a copy.
-      if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-        // Space for the string and for the terminating null character.
-        size_t str_length = strlen(arg.value.as_string) + 1;
-        char* str_copy = new char[str_length];
-        memcpy(str_copy, arg.value.as_string, str_length);
-        arg.value.as_string = str_copy;
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+        rtc::strcpyn(record.copied_strings[i], kMaxCopiedStringLength,
+                     reinterpret_cast<const char*>(arg_values[i]));
       }
     }
-    rtc::CritScope lock(&crit_);
-    trace_events_.push_back(
-        {name, category_enabled, phase, args, timestamp, 1, thread_id});
+    record.timestamp = timestamp;
+    record.tid = thread_id;
+
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+    std::shared_ptr<ThreadBuffer>& buffer = g_thread_buffer;
+    if (!buffer || buffer->generation != generation_) {
+      buffer = std::make_shared<ThreadBuffer>(generation_);
+      rtc::CritScope lock(&buffers_crit_);
+      thread_buffers_.push_back(buffer);
+    }
+    bool queued = buffer->events.Push(record);
+#else
+    bool queued;
+    {
+      // Without thread-local storage, all threads share one buffer.
+      rtc::CritScope lock(&shared_buffer_crit_);
+      queued = shared_buffer_.events.Push(record);
+    }
+#endif
+    if (!queued)
+      ++dropped_events_;
   }
 
   // The TraceEvent format is documented here:
   // https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
   void Log() {
-    RTC_DCHECK(output_file_);
     static const int kLoggingIntervalMs = 100;
-    fprintf(output_file_, "{ \"traceEvents\": [\n");
+    if (output_file_)
+      fprintf(output_file_, "{ \"traceEvents\": [\n");
     bool has_logged_event = false;
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
-      {
-        rtc::CritScope lock(&crit_);
-        trace_events_.swap(events);
-      }
-      std::string args_str;
-      args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
-      for (TraceEvent& e : events) {
-        args_str.clear();
-        if (!e.args.empty()) {
-          args_str += ", \"args\": {";
-          bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
-            if (!is_first_argument)
-              args_str += ",";
-            is_first_argument = false;
-            args_str += " \"";
-            args_str += arg.name;
-            args_str += "\": ";
-            args_str += TraceArgValueAsString(arg);
-
-            // Delete our copy of the string.
-            if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-              delete[] arg.value.as_string;
-              arg.value.as_string = nullptr;
-            }
-          }
-          args_str += " }";
-        }
-        fprintf(output_file_,
-                "%s{ \"name\": \"%s\""
-                ", \"cat\": \"%s\""
-                ", \"ph\": \"%c\""
-                ", \"ts\": %" PRIu64
-                ", \"pid\": %d"
-#if defined(WEBRTC_WIN)
-                ", \"tid\": %lu"
-#else
-                ", \"tid\": %d"
-#endif  // defined(WEBRTC_WIN)
-                "%s"
-                "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
-        has_logged_event = true;
+      std::vector<TraceRecord> records;
+      DrainThreadBuffers(&records);
+      if (output_file_) {
+        WriteRecords(output_file_, records.begin(), records.end(),
+                     &has_logged_event);
+      } else {
+        rtc::CritScope lock(&history_crit_);
+        AddToHistory(records);
       }
       if (shutting_down)
         break;
     }
+    if (!output_file_)
+      return;
     fprintf(output_file_, "]}\n");
     if (output_file_owned_)
       fclose(output_file_);
@@ -195,22 +227,35 @@ class EventLogger final {
     RTC_DCHECK(!output_file_);
     output_file_ = file;
     output_file_owned_ = owned;
+    StartLoggingThread();
+  }
+
+  void StartRecording(int64_t history_ms) {
+    RTC_DCHECK(thread_checker_.IsCurrent());
+    RTC_DCHECK(!output_file_);
+    RTC_DCHECK_GT(history_ms, 0);
     {
-      rtc::CritScope lock(&crit_);
-      // Since the atomic fast-path for adding events to the queue can be
-      // bypassed while the logging thread is shutting down there may be some
-      // stale events in the queue, hence the vector needs to be cleared to not
-      // log events from a previous logging session (which may be days old).
-      trace_events_.clear();
+      rtc::CritScope lock(&history_crit_);
+      history_.clear();
+      history_us_ = history_ms * rtc::kNumMicrosecsPerMillisec;
     }
-    // Enable event logging (fast-path). This should be disabled since starting
-    // shouldn't be done twice.
-    RTC_CHECK_EQ(0,
-                 rtc::AtomicOps::CompareAndSwap(&g_event_logging_active, 0, 1));
+    StartLoggingThread();
+    recording_ = true;
+  }
 
-    // Finally start, everything should be set up now.
-    logging_thread_.Start();
-    TRACE_EVENT_INSTANT0("webrtc", "EventLogger::Start");
+  bool WriteSnapshot(FILE* file) {
+    if (!recording_)
+      return false;
+    // Catch up with the events traced since the logging thread last ran.
+    std::vector<TraceRecord> records;
+    DrainThreadBuffers(&records);
+    rtc::CritScope lock(&history_crit_);
+    AddToHistory(records);
+    fprintf(file, "{ \"traceEvents\": [\n");
+    bool has_logged_event = false;
+    WriteRecords(file, history_.begin(), history_.end(), &has_logged_event);
+    fprintf(file, "]}\n");
+    return true;
   }
 
   void Stop() {
@@ -219,11 +264,16 @@ class EventLogger final {
     // Try to stop. Abort if we're not currently logging.
     if (rtc::AtomicOps::CompareAndSwap(&g_event_logging_active, 1, 0) == 0)
       return;
+    recording_ = false;
 
     // Wake up logging thread to finish writing.
     shutdown_event_.Set();
     // Join the logging thread.
     logging_thread_.Stop();
+    if (dropped_events_ > 0) {
+      RTC_LOG(LS_WARNING) << "Dropped " << dropped_events_.load()
+                          << " trace events.";
+    }
   }
 
  private:
@@ -247,15 +297,107 @@ class EventLogger final {
                   "the uint field of that union.");
   };
 
-  struct TraceEvent {
-    const char* name;
-    const unsigned char* category_enabled;
-    char phase;
-    std::vector<TraceArg> args;
-    uint64_t timestamp;
-    int pid;
-    rtc::PlatformThreadId tid;
-  };
+  void StartLoggingThread() {
+    // Since the atomic fast-path for adding events to the buffers can be
+    // bypassed while the logging thread is shutting down there may be some
+    // stale events left, hence the buffers need to be cleared to not log
+    // events from a previous logging session (which may be days old).
+    std::vector<TraceRecord> stale_records;
+    DrainThreadBuffers(&stale_records);
+    dropped_events_ = 0;
+    // Enable event logging (fast-path). This should be disabled since starting
+    // shouldn't be done twice.
+    RTC_CHECK_EQ(0,
+                 rtc::AtomicOps::CompareAndSwap(&g_event_logging_active, 0, 1));
+
+    // Finally start, everything should be set up now.
+    logging_thread_.Start();
+    TRACE_EVENT_INSTANT0("webrtc", "EventLogger::Start");
+  }
+
+  // Moves the queued events of all threads to |records|, and forgets the
+  // buffers of threads that have exited.
+  void DrainThreadBuffers(std::vector<TraceRecord>* records) {
+    TraceRecord record;
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+    // Also serializes the consumers of the buffers.
+    rtc::CritScope lock(&buffers_crit_);
+    for (const std::shared_ptr<ThreadBuffer>& buffer : thread_buffers_) {
+      while (buffer->events.Pop(&record))
+        records->push_back(record);
+    }
+    thread_buffers_.erase(
+        std::remove_if(thread_buffers_.begin(), thread_buffers_.end(),
+                       [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                         return buffer.use_count() == 1;
+                       }),
+        thread_buffers_.end());
+#else
+    rtc::CritScope lock(&buffers_crit_);
+    while (shared_buffer_.events.Pop(&record))
+      records->push_back(record);
+#endif
+  }
+
+  void AddToHistory(const std::vector<TraceRecord>& records)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(history_crit_) {
+    static constexpr size_t kMaxHistorySize = 1000000;
+    if (records.empty())
+      return;
+    history_.insert(history_.end(), records.begin(), records.end());
+    const uint64_t newest = history_.back().timestamp;
+    while (history_.size() > kMaxHistorySize ||
+           history_.front().timestamp + history_us_ < newest) {
+      history_.pop_front();
+    }
+  }
+
+  template <typename Iterator>
+  static void WriteRecords(FILE* file,
+                           Iterator begin,
+                           Iterator end,
+                           bool* has_logged_event) {
+    std::string args_str;
+    args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
+    for (Iterator it = begin; it != end; ++it) {
+      const TraceRecord& e = *it;
+      args_str.clear();
+      if (e.num_args > 0) {
+        args_str += ", \"args\": {";
+        for (int i = 0; i < e.num_args; ++i) {
+          if (i > 0)
+            args_str += ",";
+          TraceArg arg;
+          arg.name = e.arg_names[i];
+          arg.type = e.arg_types[i];
+          arg.value.as_uint = e.arg_values[i];
+          if (arg.type == TRACE_VALUE_TYPE_COPY_STRING)
+            arg.value.as_string = e.copied_strings[i];
+          args_str += " \"";
+          args_str += arg.name;
+          args_str += "\": ";
+          args_str += TraceArgValueAsString(arg);
+        }
+        args_str += " }";
+      }
+      fprintf(file,
+              "%s{ \"name\": \"%s\""
+              ", \"cat\": \"%s\""
+              ", \"ph\": \"%c\""
+              ", \"ts\": %" PRIu64
+              ", \"pid\": %d"
+#if defined(WEBRTC_WIN)
+              ", \"tid\": %lu"
+#else
+              ", \"tid\": %d"
+#endif  // defined(WEBRTC_WIN)
+              "%s"
+              "}\n",
+              *has_logged_event ? "," : " ", e.name, e.category_enabled,
+              e.phase, e.timestamp, 1, e.tid, args_str.c_str());
+      *has_logged_event = true;
+    }
+  }
 
   static std::string TraceArgValueAsString(TraceArg arg) {
     std::string output;
@@ -317,8 +459,21 @@ class EventLogger final {
     return output;
   }
 
-  rtc::CriticalSection crit_;
-  std::vector<TraceEvent> trace_events_ RTC_GUARDED_BY(crit_);
+  const uint64_t generation_;
+  rtc::CriticalSection buffers_crit_;
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+  std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers_
+      RTC_GUARDED_BY(buffers_crit_);
+#else
+  rtc::CriticalSection shared_buffer_crit_;
+  ThreadBuffer shared_buffer_{0};
+#endif
+  std::atomic<int> dropped_events_{0};
+  // Recent events, when recording rather than writing to a file.
+  rtc::CriticalSection history_crit_;
+  std::deque<TraceRecord> history_ RTC_GUARDED_BY(history_crit_);
+  int64_t history_us_ RTC_GUARDED_BY(history_crit_) = 0;
+  std::atomic<bool> recording_{false};
   rtc::PlatformThread logging_thread_;
   rtc::Event shutdown_event_;
   rtc::ThreadChecker thread_checker_;
@@ -359,7 +514,7 @@ void InternalAddTraceEvent(char phase,
 
   g_event_logger->AddTraceEvent(name, category_enabled, phase, num_args,
                                 arg_names, arg_types, arg_values,
-                                rtc::TimeMicros(), 1, rtc::CurrentThreadId());
+                                rtc::TimeMicros(), rtc::CurrentThreadId());
 }
 
 }  // namespace
@@ -391,6 +546,16 @@ bool StartInternalCapture(const char* filename) {
   return true;
 }
 
+void StartInternalRecording(int64_t history_ms) {
+  if (g_event_logger) {
+    g_event_logger->StartRecording(history_ms);
+  }
+}
+
+bool SnapshotInternalRecording(FILE* file) {
+  return g_event_logger && g_event_logger->WriteSnapshot(file);
+}
+
 void StopInternalCapture() {
   if (g_event_logger) {
     g_event_logger->Stop();
@@ -26,6 +26,7 @@
 #ifndef RTC_BASE_EVENT_TRACER_H_
 #define RTC_BASE_EVENT_TRACER_H_
 
+#include <stdint.h>
 #include <stdio.h>
 
 namespace webrtc {
@@ -73,6 +74,12 @@ namespace tracing {
 void SetupInternalTracer();
 bool StartInternalCapture(const char* filename);
 void StartInternalCaptureToFile(FILE* file);
+// Keeps the last |history_ms| of events in memory instead of writing them to
+// a file, cheap enough to leave running. Stopped by StopInternalCapture().
+void StartInternalRecording(int64_t history_ms);
+// Writes the recorded events to |file| in the same JSON format as the file
+// capture. Returns false if not recording.
+bool SnapshotInternalRecording(FILE* file);
 void StopInternalCapture();
 // Make sure we run this, this will tear down the internal tracing.
 void ShutdownInternalTracer();
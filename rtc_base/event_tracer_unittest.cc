@@ -10,6 +10,10 @@
 
 #include "rtc_base/event_tracer.h"
 
+#include <stdio.h>
+
+#include <string>
+
 #include "rtc_base/critical_section.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/trace_event.h"
@@ -76,6 +80,28 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   EXPECT_EQ(2, TestStatistics::Get()->Count());
   TestStatistics::Get()->Reset();
 }
+
+TEST(EventTracerTest, SnapshotsInternalRecording) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalRecording(/*history_ms=*/10000);
+  TRACE_EVENT_INSTANT1("test", "RecordedEvent", "value", 17);
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file);
+  EXPECT_TRUE(rtc::tracing::SnapshotInternalRecording(file));
+  rtc::tracing::StopInternalCapture();
+  EXPECT_FALSE(rtc::tracing::SnapshotInternalRecording(file));
+  rtc::tracing::ShutdownInternalTracer();
+
+  std::string snapshot;
+  char buffer[256];
+  rewind(file);
+  while (fgets(buffer, sizeof(buffer), file))
+    snapshot += buffer;
+  fclose(file);
+  EXPECT_EQ(0u, snapshot.find("{ \"traceEvents\": ["));
+  EXPECT_NE(std::string::npos, snapshot.find("\"name\": \"RecordedEvent\""));
+  EXPECT_NE(std::string::npos, snapshot.find("\"value\": 17"));
+}
 #endif
 
 }  // namespace webrtc
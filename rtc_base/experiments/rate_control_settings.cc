@@ -15,7 +15,6 @@
 
 #include <string>
 
-#include "absl/strings/match.h"
 #include "api/transport/field_trial_based_config.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
@@ -36,11 +35,6 @@ const char* kVideoHysteresisFieldTrialname =
 const char* kScreenshareHysteresisFieldTrialname =
     "WebRTC-SimulcastScreenshareUpswitchHysteresisPercent";
 
-bool IsEnabled(const WebRtcKeyValueConfig* const key_value_config,
-               absl::string_view key) {
-  return absl::StartsWith(key_value_config->Lookup(key), "Enabled");
-}
-
 void ParseHysteresisFactor(const WebRtcKeyValueConfig* const key_value_config,
                            absl::string_view key,
                            double* output_value) {
@@ -96,8 +90,8 @@ RateControlSettings::RateControlSettings(
     const WebRtcKeyValueConfig* const key_value_config)
     : congestion_window_config_(CongestionWindowConfig::Parse(
           key_value_config->Lookup(CongestionWindowConfig::kKey))) {
-  video_config_.vp8_base_heavy_tl3_alloc = IsEnabled(
-      key_value_config, kUseBaseHeavyVp8Tl3RateAllocationFieldTrialName);
+  video_config_.vp8_base_heavy_tl3_alloc = key_value_config->IsEnabled(
+      kUseBaseHeavyVp8Tl3RateAllocationFieldTrialName);
   ParseHysteresisFactor(key_value_config, kVideoHysteresisFieldTrialname,
                         &video_config_.video_hysteresis);
   ParseHysteresisFactor(key_value_config, kScreenshareHysteresisFieldTrialname,
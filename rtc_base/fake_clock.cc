@@ -51,6 +51,14 @@ ScopedBaseFakeClock::~ScopedBaseFakeClock() {
   SetClockForTesting(prev_clock_);
 }
 
+ScopedThreadBaseFakeClock::ScopedThreadBaseFakeClock() {
+  prev_clock_ = SetThreadClockForTesting(this);
+}
+
+ScopedThreadBaseFakeClock::~ScopedThreadBaseFakeClock() {
+  SetThreadClockForTesting(prev_clock_);
+}
+
 ScopedFakeClock::ScopedFakeClock() {
   prev_clock_ = SetClockForTesting(this);
 }
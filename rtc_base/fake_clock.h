@@ -68,6 +68,18 @@ class ScopedBaseFakeClock : public FakeClock {
   ClockInterface* prev_clock_;
 };
 
+// Like ScopedBaseFakeClock, but only sets itself as the clock of the thread
+// constructing it, see SetThreadClockForTesting(). Must be destroyed on the
+// same thread.
+class ScopedThreadBaseFakeClock : public FakeClock {
+ public:
+  ScopedThreadBaseFakeClock();
+  ~ScopedThreadBaseFakeClock() override;
+
+ private:
+  ClockInterface* prev_clock_;
+};
+
 // TODO(srte): Rename this to reflect that it also does thread processing.
 class ScopedFakeClock : public ThreadProcessingFakeClock {
  public:
@@ -0,0 +1,664 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/io_uring_socket_server.h"
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/time_utils.h"
+
+namespace rtc {
+
+namespace {
+
+// The operation a completion is for, in the low bits of its user data.
+enum Operation : uint64_t {
+  kReceive = 0,
+  kSend = 1,
+  kCancel = 2,
+};
+constexpr int kOperationBits = 2;
+constexpr uint64_t kOperationMask = (1 << kOperationBits) - 1;
+
+constexpr unsigned kSubmissionQueueSize = 256;
+// Each datagram received takes one completion, so the completion queue is
+// made large enough to hold one for every receive and send buffer.
+constexpr unsigned kCompletionQueueSize = 1024;
+constexpr uint16_t kBufferGroup = 0;
+
+uint64_t MakeUserData(Operation operation, uint64_t value) {
+  return (value << kOperationBits) | operation;
+}
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd,
+                 unsigned to_submit,
+                 unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+// The message header of the multishot receives. Only the sizes of the address
+// and the control data are used; the kernel puts them at the start of each
+// receive buffer, after an io_uring_recvmsg_out, followed by the payload.
+const msghdr& ReceiveMessageHeader() {
+  static const msghdr header = [] {
+    msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_namelen = sizeof(sockaddr_storage);
+    header.msg_controllen = kRecvTimestampControlSize;
+    return header;
+  }();
+  return header;
+}
+
+}  // namespace
+
+struct IoUringSocketServer::SendSlot {
+  msghdr message;
+  iovec iov;
+  sockaddr_storage address;
+  uint8_t data[kSendSlotSize];
+};
+
+// Processes the completions when the ring descriptor becomes readable.
+class IoUringSocketServer::RingDispatcher : public Dispatcher {
+ public:
+  explicit RingDispatcher(IoUringSocketServer* ss) : ss_(ss) {
+    ss_->Add(this);
+  }
+  ~RingDispatcher() override { ss_->Remove(this); }
+
+  uint32_t GetRequestedEvents() override { return DE_READ; }
+  void OnPreEvent(uint32_t ff) override {}
+  void OnEvent(uint32_t ff, int err) override { ss_->ProcessCompletions(); }
+  int GetDescriptor() override { return ss_->ring_fd_; }
+  bool IsDescriptorClosed() override { return false; }
+
+ private:
+  IoUringSocketServer* const ss_;
+};
+
+class IoUringSocketServer::UdpSocket : public SocketDispatcher {
+ public:
+  explicit UdpSocket(IoUringSocketServer* ss)
+      : SocketDispatcher(ss), server_(ss) {}
+  ~UdpSocket() override { Close(); }
+
+  using SocketDispatcher::Create;
+  bool Create(int family, int type) override {
+    if (!SocketDispatcher::Create(family, type))
+      return false;
+    // Makes the kernel put the receive time next to each datagram.
+    int value = 1;
+    ::setsockopt(s_, SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value));
+    server_->AddSocket(this);
+    return true;
+  }
+
+  // Reads are signaled from the completions rather than by epoll.
+  uint32_t GetRequestedEvents() override {
+    return SocketDispatcher::GetRequestedEvents() & ~DE_READ;
+  }
+
+  int Recv(void* buffer, size_t length, int64_t* timestamp) override {
+    return RecvFrom(buffer, length, nullptr, timestamp);
+  }
+
+  int RecvFrom(void* buffer,
+               size_t length,
+               SocketAddress* out_addr,
+               int64_t* timestamp) override {
+    CritScope cs(&server_->ring_crit_);
+    if (datagrams_.empty()) {
+      SetError(EWOULDBLOCK);
+      return SOCKET_ERROR;
+    }
+    const Datagram& datagram = datagrams_.front();
+    size_t received = std::min(length, datagram.size);
+    memcpy(buffer, datagram.data, received);
+    if (out_addr)
+      *out_addr = datagram.remote_address;
+    if (timestamp)
+      *timestamp = datagram.timestamp;
+    server_->ReturnBuffer(datagram.buffer_id);
+    datagrams_.pop_front();
+    return static_cast<int>(received);
+  }
+
+  int RecvFromBatch(ArrayView<RecvBatchEntry> entries) override {
+    CritScope cs(&server_->ring_crit_);
+    if (datagrams_.empty()) {
+      SetError(EWOULDBLOCK);
+      return SOCKET_ERROR;
+    }
+    size_t count = std::min(entries.size(), datagrams_.size());
+    for (size_t i = 0; i < count; ++i) {
+      const Datagram& datagram = datagrams_.front();
+      RecvBatchEntry& entry = entries[i];
+      entry.length = std::min(entry.capacity, datagram.size);
+      memcpy(entry.buffer, datagram.data, entry.length);
+      entry.remote_address = datagram.remote_address;
+      entry.timestamp = datagram.timestamp;
+      entry.truncated = datagram.truncated || entry.length < datagram.size;
+      server_->ReturnBuffer(datagram.buffer_id);
+      datagrams_.pop_front();
+    }
+    return static_cast<int>(count);
+  }
+
+  int SendTo(const void* buffer,
+             size_t length,
+             const SocketAddress& addr) override {
+    if (server_->SubmitSend(s_, buffer, length, addr))
+      return static_cast<int>(length);
+    return SocketDispatcher::SendTo(buffer, length, addr);
+  }
+
+  int SendToBatch(ArrayView<const SendBatchEntry> entries) override {
+    // Sends one by one, but submits them together.
+    server_->StartBatch();
+    int sent = AsyncSocket::SendToBatch(entries);
+    server_->FinishBatch();
+    return sent;
+  }
+
+  int Close() override {
+    if (s_ != INVALID_SOCKET && id_ != 0)
+      server_->RemoveSocket(this);
+    return SocketDispatcher::Close();
+  }
+
+ private:
+  friend class IoUringSocketServer;
+
+  struct Datagram {
+    uint16_t buffer_id;
+    const uint8_t* data;
+    size_t size;
+    bool truncated;
+    SocketAddress remote_address;
+    // In units of microseconds, -1 if not available.
+    int64_t timestamp;
+  };
+
+  // Queues the datagram the kernel put in |buffer_id|, |size| bytes including
+  // the io_uring_recvmsg_out, address and control data in front. Returns
+  // false if the buffer holds no datagram. |now_us| and |now_utc_us| are the
+  // current rtc::TimeMicros() and rtc::TimeUTCMicros().
+  bool QueueDatagram(uint16_t buffer_id,
+                     size_t size,
+                     int64_t now_us,
+                     int64_t now_utc_us) {
+    const uint8_t* buffer = server_->buffer(buffer_id);
+    const msghdr& header = ReceiveMessageHeader();
+    const size_t payload_offset =
+        sizeof(io_uring_recvmsg_out) + header.msg_namelen +
+        header.msg_controllen;
+    if (size < payload_offset)
+      return false;
+    io_uring_recvmsg_out out;
+    memcpy(&out, buffer, sizeof(out));
+
+    Datagram datagram;
+    datagram.buffer_id = buffer_id;
+    datagram.data = buffer + payload_offset;
+    datagram.size = size - payload_offset;
+    datagram.truncated =
+        (out.flags & MSG_TRUNC) != 0 || out.payloadlen > datagram.size;
+    sockaddr_storage addr;
+    memset(&addr, 0, sizeof(addr));
+    memcpy(&addr, buffer + sizeof(out),
+           std::min<size_t>(out.namelen, sizeof(addr)));
+    SocketAddressFromSockAddrStorage(addr, &datagram.remote_address);
+    msghdr control;
+    memset(&control, 0, sizeof(control));
+    control.msg_control =
+        const_cast<uint8_t*>(buffer + sizeof(out) + header.msg_namelen);
+    control.msg_controllen = out.controllen;
+    datagram.timestamp =
+        GetRecvTimestampFromControl(control, now_us, now_utc_us);
+    datagrams_.push_back(datagram);
+    return true;
+  }
+
+  IoUringSocketServer* const server_;
+  // Guarded by the server's |ring_crit_|. The id is 0 while the socket isn't
+  // registered.
+  uint64_t id_ = 0;
+  bool receive_armed_ = false;
+  std::deque<Datagram> datagrams_;
+};
+
+std::unique_ptr<IoUringSocketServer> IoUringSocketServer::Create() {
+  std::unique_ptr<IoUringSocketServer> ss(new IoUringSocketServer());
+  if (!ss->Initialize())
+    return nullptr;
+  return ss;
+}
+
+IoUringSocketServer::IoUringSocketServer() = default;
+
+IoUringSocketServer::~IoUringSocketServer() {
+  ring_dispatcher_.reset();
+  {
+    CritScope cs(&ring_crit_);
+    RTC_DCHECK(sockets_.empty());
+  }
+  if (send_slots_)
+    WaitForSends();
+  // Closing the ring cancels the receives still armed, and unregisters the
+  // buffer ring.
+  if (ring_fd_ != -1)
+    close(ring_fd_);
+  if (buf_ring_)
+    munmap(buf_ring_, buf_ring_size_);
+  if (sqes_)
+    munmap(sqes_, sqes_size_);
+  if (sq_ring_)
+    munmap(sq_ring_, sq_ring_size_);
+}
+
+bool IoUringSocketServer::Initialize() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionQueueSize;
+  ring_fd_ = IoUringSetup(kSubmissionQueueSize, &params);
+  if (ring_fd_ < 0) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "io_uring_setup";
+    ring_fd_ = -1;
+    return false;
+  }
+  // Completions that don't fit into the completion queue must not be lost,
+  // since they carry receive buffers.
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_NODROP)) {
+    RTC_LOG(LS_WARNING) << "io_uring lacks required features: "
+                        << params.features;
+    return false;
+  }
+
+  sq_ring_size_ =
+      std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+               params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  void* sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap io_uring";
+    return false;
+  }
+  sq_ring_ = sq_ring;
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap io_uring";
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+  uint8_t* base = static_cast<uint8_t*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(base + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+  sq_flags_ = reinterpret_cast<unsigned*>(base + params.sq_off.flags);
+  sq_mask_ = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  sq_array_ = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+  cqes_ = base + params.cq_off.cqes;
+
+  // The buffer ring must be page aligned.
+  buf_ring_size_ = kNumRecvBuffers * sizeof(io_uring_buf);
+  void* buf_ring = mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buf_ring == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap io_uring buffer ring";
+    return false;
+  }
+  buf_ring_ = buf_ring;
+  io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uintptr_t>(buf_ring_);
+  reg.ring_entries = kNumRecvBuffers;
+  reg.bgid = kBufferGroup;
+  if (IoUringRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "io_uring_register buffer ring";
+    return false;
+  }
+
+  recv_buffers_.resize(kNumRecvBuffers * kRecvBufferSize);
+  send_slots_.reset(new SendSlot[kNumSendSlots]);
+  {
+    CritScope cs(&ring_crit_);
+    for (size_t i = 0; i < kNumRecvBuffers; ++i)
+      ReturnBuffer(static_cast<uint16_t>(i));
+    free_send_slots_.reserve(kNumSendSlots);
+    for (size_t i = kNumSendSlots; i > 0; --i)
+      free_send_slots_.push_back(static_cast<uint16_t>(i - 1));
+  }
+  ring_dispatcher_ = std::make_unique<RingDispatcher>(this);
+  return true;
+}
+
+AsyncSocket* IoUringSocketServer::CreateAsyncSocket(int family, int type) {
+  if (type != SOCK_DGRAM)
+    return PhysicalSocketServer::CreateAsyncSocket(family, type);
+
+  UdpSocket* socket = new UdpSocket(this);
+  if (socket->Create(family, type)) {
+    return socket;
+  } else {
+    delete socket;
+    return nullptr;
+  }
+}
+
+io_uring_sqe* IoUringSocketServer::GetSqe() {
+  if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >=
+      sq_entries_) {
+    SubmitNow();
+    if (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >=
+        sq_entries_) {
+      return nullptr;
+    }
+  }
+  unsigned index = sq_local_tail_ & sq_mask_;
+  sq_array_[index] = index;
+  ++sq_local_tail_;
+  ++sq_pending_;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+void IoUringSocketServer::Submit() {
+  if (batch_depth_ == 0)
+    SubmitNow();
+}
+
+void IoUringSocketServer::SubmitNow() {
+  __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+  while (sq_pending_ > 0) {
+    int submitted = IoUringEnter(ring_fd_, sq_pending_, 0, 0);
+    if (submitted < 0) {
+      if (errno == EINTR)
+        continue;
+      // The entries stay queued, and are submitted with the next ones.
+      RTC_LOG_E(LS_ERROR, EN, errno) << "io_uring_enter";
+      return;
+    }
+    if (submitted == 0)
+      return;
+    sq_pending_ -= submitted;
+  }
+}
+
+void IoUringSocketServer::StartBatch() {
+  CritScope cs(&ring_crit_);
+  ++batch_depth_;
+}
+
+void IoUringSocketServer::FinishBatch() {
+  CritScope cs(&ring_crit_);
+  RTC_DCHECK_GT(batch_depth_, 0);
+  if (--batch_depth_ == 0)
+    SubmitNow();
+}
+
+void IoUringSocketServer::AddSocket(UdpSocket* socket) {
+  CritScope cs(&ring_crit_);
+  RTC_DCHECK_EQ(socket->id_, 0);
+  socket->id_ = next_socket_id_++;
+  sockets_[socket->id_] = socket;
+  if (!ArmReceive(socket))
+    RTC_LOG(LS_ERROR) << "Failed to arm io_uring receive";
+}
+
+void IoUringSocketServer::RemoveSocket(UdpSocket* socket) {
+  CritScope cs(&ring_crit_);
+  if (socket->receive_armed_) {
+    // The receive keeps the socket open until it's cancelled.
+    io_uring_sqe* sqe = GetSqe();
+    if (sqe) {
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->fd = -1;
+      sqe->addr = MakeUserData(kReceive, socket->id_);
+      sqe->user_data = MakeUserData(kCancel, 0);
+      Submit();
+    } else {
+      RTC_LOG(LS_ERROR) << "Failed to cancel io_uring receive";
+    }
+    socket->receive_armed_ = false;
+  }
+  for (const UdpSocket::Datagram& datagram : socket->datagrams_)
+    ReturnBuffer(datagram.buffer_id);
+  socket->datagrams_.clear();
+  sockets_.erase(socket->id_);
+  starved_sockets_.erase(std::remove(starved_sockets_.begin(),
+                                     starved_sockets_.end(), socket->id_),
+                         starved_sockets_.end());
+  socket->id_ = 0;
+}
+
+bool IoUringSocketServer::ArmReceive(UdpSocket* socket) {
+  io_uring_sqe* sqe = GetSqe();
+  if (!sqe)
+    return false;
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = socket->GetDescriptor();
+  sqe->addr = reinterpret_cast<uintptr_t>(&ReceiveMessageHeader());
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kBufferGroup;
+  sqe->user_data = MakeUserData(kReceive, socket->id_);
+  socket->receive_armed_ = true;
+  Submit();
+  return true;
+}
+
+bool IoUringSocketServer::SubmitSend(int fd,
+                                     const void* data,
+                                     size_t length,
+                                     const SocketAddress& addr) {
+  CritScope cs(&ring_crit_);
+  io_uring_sqe* sqe = nullptr;
+  if (length <= kSendSlotSize && !free_send_slots_.empty())
+    sqe = GetSqe();
+  if (!sqe) {
+    // Submits the batched sends first, so that they go out before the
+    // synchronous one.
+    SubmitNow();
+    return false;
+  }
+  uint16_t index = free_send_slots_.back();
+  free_send_slots_.pop_back();
+  SendSlot& slot = send_slots_[index];
+  memcpy(slot.data, data, length);
+  slot.iov.iov_base = slot.data;
+  slot.iov.iov_len = length;
+  memset(&slot.message, 0, sizeof(slot.message));
+  slot.message.msg_name = &slot.address;
+  slot.message.msg_namelen = addr.ToSockAddrStorage(&slot.address);
+  slot.message.msg_iov = &slot.iov;
+  slot.message.msg_iovlen = 1;
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uintptr_t>(&slot.message);
+  sqe->len = 1;
+  // Suppress SIGPIPE, as PhysicalSocket does.
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = MakeUserData(kSend, index);
+  Submit();
+  return true;
+}
+
+void IoUringSocketServer::ReturnBuffer(uint16_t buffer_id) {
+  // The entries start at the ring, overlaid by its tail. io_uring_buf_ring's
+  // flexible array member isn't used, since it's misplaced in C++.
+  io_uring_buf& buf = static_cast<io_uring_buf*>(
+      buf_ring_)[buf_ring_tail_ & (kNumRecvBuffers - 1)];
+  buf.addr = reinterpret_cast<uintptr_t>(buffer(buffer_id));
+  buf.len = kRecvBufferSize;
+  buf.bid = buffer_id;
+  ++buf_ring_tail_;
+  __atomic_store_n(&static_cast<io_uring_buf_ring*>(buf_ring_)->tail,
+                   buf_ring_tail_, __ATOMIC_RELEASE);
+
+  if (!starved_sockets_.empty()) {
+    std::vector<uint64_t> starved;
+    starved.swap(starved_sockets_);
+    for (uint64_t id : starved) {
+      auto it = sockets_.find(id);
+      if (it != sockets_.end() && !it->second->receive_armed_)
+        ArmReceive(it->second);
+    }
+  }
+}
+
+void IoUringSocketServer::ReapCompletions(
+    std::vector<uint64_t>* ready_sockets) {
+  const io_uring_cqe* cqes = static_cast<const io_uring_cqe*>(cqes_);
+  const int64_t now_us = TimeMicros();
+  const int64_t now_utc_us = TimeUTCMicros();
+  while (true) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const io_uring_cqe& cqe = cqes[head & cq_mask_];
+      const uint64_t value = cqe.user_data >> kOperationBits;
+      switch (cqe.user_data & kOperationMask) {
+        case kSend:
+          if (cqe.res < 0) {
+            RTC_LOG(LS_VERBOSE) << "io_uring send failed: "
+                                << strerror(-cqe.res);
+          }
+          free_send_slots_.push_back(static_cast<uint16_t>(value));
+          break;
+        case kReceive: {
+          auto it = sockets_.find(value);
+          UdpSocket* socket = it != sockets_.end() ? it->second : nullptr;
+          if (cqe.flags & IORING_CQE_F_BUFFER) {
+            uint16_t buffer_id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+            if (socket && cqe.res >= 0 &&
+                socket->QueueDatagram(buffer_id, cqe.res, now_us,
+                                      now_utc_us)) {
+              if (std::find(ready_sockets->begin(), ready_sockets->end(),
+                            value) == ready_sockets->end()) {
+                ready_sockets->push_back(value);
+              }
+            } else {
+              ReturnBuffer(buffer_id);
+            }
+          }
+          if (socket && !(cqe.flags & IORING_CQE_F_MORE)) {
+            // The multishot receive ended. Rearm it, once buffers are
+            // returned if that's what it ran out of.
+            socket->receive_armed_ = false;
+            if (cqe.res == -ENOBUFS) {
+              starved_sockets_.push_back(value);
+            } else {
+              if (cqe.res < 0) {
+                RTC_LOG(LS_VERBOSE) << "io_uring receive failed: "
+                                    << strerror(-cqe.res);
+              }
+              ArmReceive(socket);
+            }
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    // Completions that didn't fit into the completion queue are moved into
+    // it by the kernel when asked for completions.
+    if (!(__atomic_load_n(sq_flags_, __ATOMIC_ACQUIRE) &
+          IORING_SQ_CQ_OVERFLOW)) {
+      return;
+    }
+    IoUringEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+  }
+}
+
+void IoUringSocketServer::ProcessCompletions() {
+  std::vector<uint64_t> ready_sockets;
+  // The sends done while signaling are submitted together.
+  StartBatch();
+  {
+    CritScope cs(&ring_crit_);
+    ReapCompletions(&ready_sockets);
+  }
+  for (uint64_t id : ready_sockets) {
+    // Signal until the socket is drained, as each signal may read only one
+    // datagram. Stop if the socket is closed, or doesn't read any more.
+    while (true) {
+      UdpSocket* socket;
+      size_t queued;
+      {
+        CritScope cs(&ring_crit_);
+        auto it = sockets_.find(id);
+        if (it == sockets_.end())
+          break;
+        socket = it->second;
+        queued = socket->datagrams_.size();
+      }
+      if (queued == 0)
+        break;
+      socket->SignalReadEvent(socket);
+      CritScope cs(&ring_crit_);
+      auto it = sockets_.find(id);
+      if (it == sockets_.end() || it->second->datagrams_.size() >= queued)
+        break;
+    }
+  }
+  FinishBatch();
+}
+
+void IoUringSocketServer::WaitForSends() {
+  CritScope cs(&ring_crit_);
+  SubmitNow();
+  std::vector<uint64_t> ready_sockets;
+  while (true) {
+    ReapCompletions(&ready_sockets);
+    if (free_send_slots_.size() == kNumSendSlots)
+      return;
+    if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR) {
+      RTC_LOG_E(LS_ERROR, EN, errno) << "io_uring_enter";
+      return;
+    }
+  }
+}
+
+}  // namespace rtc
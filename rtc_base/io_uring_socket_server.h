@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_IO_URING_SOCKET_SERVER_H_
+#define RTC_BASE_IO_URING_SOCKET_SERVER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/thread_annotations.h"
+
+struct io_uring_sqe;
+
+namespace rtc {
+
+// A PhysicalSocketServer whose UDP sockets receive and send through an
+// io_uring (Linux 6.0 or later) instead of readiness polling.
+//
+// Every UDP socket keeps one multishot receive armed, which the kernel
+// completes once per datagram into a ring of provided receive buffers, so
+// receiving costs no system call per datagram. The datagrams are queued on
+// the socket until RecvFrom() or RecvFromBatch() copies them out, which
+// returns their buffers to the kernel. Sends are copied into preallocated
+// send buffers and submitted without waiting for their completion; the
+// sends of one SendToBatch() call, or of one round of completions, are
+// submitted with a single system call. All other sockets use epoll as in
+// PhysicalSocketServer, and the ring itself is one more descriptor there.
+class IoUringSocketServer : public PhysicalSocketServer {
+ public:
+  // Returns null if the kernel lacks io_uring or the features used here, in
+  // which case a PhysicalSocketServer should be used instead.
+  static std::unique_ptr<IoUringSocketServer> Create();
+
+  ~IoUringSocketServer() override;
+
+  // SocketFactory:
+  AsyncSocket* CreateAsyncSocket(int family, int type) override;
+
+ private:
+  class RingDispatcher;
+  class UdpSocket;
+  struct SendSlot;
+
+  // The receive buffers; they're large enough for a full UDP datagram over
+  // Ethernet along with the address and timestamp the kernel puts in front.
+  static constexpr size_t kNumRecvBuffers = 512;
+  static constexpr size_t kRecvBufferSize = 2048;
+  // Sends that are larger or find all send buffers in use are sent
+  // synchronously.
+  static constexpr size_t kNumSendSlots = 256;
+  static constexpr size_t kSendSlotSize = 2048;
+
+  IoUringSocketServer();
+
+  bool Initialize();
+
+  // Returns a free submission queue entry, submitting the queued ones first
+  // if there is none. Returns null if the submission queue stays full.
+  io_uring_sqe* GetSqe() RTC_EXCLUSIVE_LOCKS_REQUIRED(ring_crit_);
+  // Submits the queued entries, unless they're being batched.
+  void Submit() RTC_EXCLUSIVE_LOCKS_REQUIRED(ring_crit_);
+  void SubmitNow() RTC_EXCLUSIVE_LOCKS_REQUIRED(ring_crit_);
+  void StartBatch();
+  void FinishBatch();
+
+  // Registers |socket| and arms its multishot receive.
+  void AddSocket(UdpSocket* socket);
+  void RemoveSocket(UdpSocket* socket);
+  bool ArmReceive(UdpSocket* socket) RTC_EXCLUSIVE_LOCKS_REQUIRED(ring_crit_);
+  // Returns false if the send has to be done synchronously.
+  bool SubmitSend(int fd,
+                  const void* data,
+                  size_t length,
+                  const SocketAddress& addr);
+  // Gives a receive buffer back to the kernel, and rearms the receives that
+  // ran out of buffers.
+  void ReturnBuffer(uint16_t buffer_id)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(ring_crit_);
+  uint8_t* buffer(uint16_t buffer_id) {
+    return recv_buffers_.data() + buffer_id * kRecvBufferSize;
+  }
+
+  // Reaps all completions, then signals the sockets that received data.
+  void ProcessCompletions();
+  // Reaps all completions, adding the ids of the sockets that received
+  // datagrams to |ready_sockets|.
+  void ReapCompletions(std::vector<uint64_t>* ready_sockets)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(ring_crit_);
+  // Blocks until no sends are in flight, so that the send buffers can be
+  // freed.
+  void WaitForSends();
+
+  CriticalSection ring_crit_;
+  int ring_fd_ = -1;
+  void* sq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  // Pointers into the shared rings.
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_flags_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  void* cqes_ = nullptr;
+  // The tail of the queued entries, and how many of them aren't submitted
+  // yet.
+  unsigned sq_local_tail_ RTC_GUARDED_BY(ring_crit_) = 0;
+  unsigned sq_pending_ RTC_GUARDED_BY(ring_crit_) = 0;
+  int batch_depth_ RTC_GUARDED_BY(ring_crit_) = 0;
+
+  // The provided buffer ring the multishot receives take buffers from.
+  void* buf_ring_ = nullptr;
+  size_t buf_ring_size_ = 0;
+  uint16_t buf_ring_tail_ RTC_GUARDED_BY(ring_crit_) = 0;
+  std::vector<uint8_t> recv_buffers_;
+
+  std::unique_ptr<SendSlot[]> send_slots_;
+  std::vector<uint16_t> free_send_slots_ RTC_GUARDED_BY(ring_crit_);
+
+  // Sockets by id. Completions carry the id rather than the pointer, so the
+  // ones for sockets closed in the meantime are recognized.
+  std::map<uint64_t, UdpSocket*> sockets_ RTC_GUARDED_BY(ring_crit_);
+  uint64_t next_socket_id_ RTC_GUARDED_BY(ring_crit_) = 1;
+  // Sockets whose receive stopped for lack of buffers.
+  std::vector<uint64_t> starved_sockets_ RTC_GUARDED_BY(ring_crit_);
+
+  std::unique_ptr<RingDispatcher> ring_dispatcher_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_IO_URING_SOCKET_SERVER_H_
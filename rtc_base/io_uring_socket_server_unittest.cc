@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/io_uring_socket_server.h"
+
+#include <string.h>
+
+#include <memory>
+
+#include "rtc_base/arraysize.h"
+#include "rtc_base/async_udp_socket.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/net_helpers.h"
+#include "rtc_base/socket_unittest.h"
+#include "rtc_base/test_utils.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace rtc {
+
+#define MAYBE_SKIP_IO_URING                         \
+  if (!server_) {                                   \
+    RTC_LOG(LS_INFO) << "No io_uring... skipping"; \
+    return;                                         \
+  }
+
+#define MAYBE_SKIP_IPV4                        \
+  if (!HasIPv4Enabled()) {                     \
+    RTC_LOG(LS_INFO) << "No IPv4... skipping"; \
+    return;                                    \
+  }
+
+class IoUringSocketServerTest : public SocketTest {
+ protected:
+  IoUringSocketServerTest() : server_(IoUringSocketServer::Create()) {
+    if (server_)
+      thread_ = std::make_unique<AutoSocketServerThread>(server_.get());
+  }
+
+  std::unique_ptr<IoUringSocketServer> server_;
+  std::unique_ptr<AutoSocketServerThread> thread_;
+};
+
+class PacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const int64_t& packet_time_us) {
+    ++num_packets;
+    last_packet_time_us = packet_time_us;
+  }
+
+  int num_packets = 0;
+  int64_t last_packet_time_us = -1;
+};
+
+TEST_F(IoUringSocketServerTest, TestUdpIPv4) {
+  MAYBE_SKIP_IO_URING;
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestUdpIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpIPv6) {
+  MAYBE_SKIP_IO_URING;
+  SocketTest::TestUdpIPv6();
+}
+
+// TCP sockets aren't affected and keep working through epoll.
+TEST_F(IoUringSocketServerTest, TestTcpIPv4) {
+  MAYBE_SKIP_IO_URING;
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, AsyncUdpSocketReceivesWithTimestamps) {
+  MAYBE_SKIP_IO_URING;
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver(AsyncUDPSocket::Create(
+      server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(AsyncUDPSocket::Create(
+      server_.get(), SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver);
+  ASSERT_TRUE(sender);
+  PacketCounter counter;
+  receiver->SignalReadPacket.connect(&counter, &PacketCounter::OnReadPacket);
+
+  // The timestamps are the kernel's receive times.
+  const char kPayload[] = "hello";
+  EXPECT_EQ(static_cast<int>(sizeof(kPayload)),
+            sender->SendTo(kPayload, sizeof(kPayload),
+                           receiver->GetLocalAddress(), PacketOptions()));
+  EXPECT_EQ_WAIT(1, counter.num_packets, kTimeout);
+  const int64_t first_packet_time_us = counter.last_packet_time_us;
+  Thread::SleepMs(100);
+  EXPECT_EQ(static_cast<int>(sizeof(kPayload)),
+            sender->SendTo(kPayload, sizeof(kPayload),
+                           receiver->GetLocalAddress(), PacketOptions()));
+  EXPECT_EQ_WAIT(2, counter.num_packets, kTimeout);
+  EXPECT_GE(counter.last_packet_time_us - first_packet_time_us, 90000);
+}
+
+TEST_F(IoUringSocketServerTest, ReceivesMoreDatagramsThanBuffers) {
+  MAYBE_SKIP_IO_URING;
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  // Nothing reads while the datagrams arrive, so they use up all receive
+  // buffers, and the rest waits in the socket until buffers are returned.
+  const int kNumDatagrams = 600;
+  for (int i = 0; i < kNumDatagrams; ++i) {
+    ASSERT_EQ(4, sender->SendTo(&i, sizeof(i), receiver->GetLocalAddress()));
+    if (i % 50 == 49)
+      thread_->ProcessMessages(10);
+  }
+
+  char buffers[16][8];
+  RecvBatchEntry entries[16];
+  for (size_t i = 0; i < arraysize(entries); ++i) {
+    entries[i].buffer = buffers[i];
+    entries[i].capacity = sizeof(buffers[i]);
+  }
+  int received = 0;
+  const int64_t deadline = TimeAfter(kTimeout);
+  while (received < kNumDatagrams && TimeMillis() < deadline) {
+    int count = receiver->RecvFromBatch(entries);
+    if (count <= 0) {
+      thread_->ProcessMessages(10);
+      continue;
+    }
+    for (int i = 0; i < count; ++i) {
+      int value;
+      ASSERT_EQ(sizeof(value), entries[i].length);
+      memcpy(&value, entries[i].buffer, sizeof(value));
+      EXPECT_EQ(received, value);
+      EXPECT_EQ(sender->GetLocalAddress(), entries[i].remote_address);
+      ++received;
+    }
+  }
+  EXPECT_EQ(kNumDatagrams, received);
+}
+
+TEST_F(IoUringSocketServerTest, ClosingSocketWithQueuedDatagrams) {
+  MAYBE_SKIP_IO_URING;
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  const SocketAddress address = receiver->GetLocalAddress();
+  for (int i = 0; i < 10; ++i)
+    ASSERT_EQ(4, sender->SendTo(&i, sizeof(i), address));
+  thread_->ProcessMessages(10);
+  receiver.reset();
+
+  // The buffers of the closed socket are available to the next one.
+  receiver.reset(server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  const int kValue = 42;
+  ASSERT_EQ(4, sender->SendTo(&kValue, sizeof(kValue),
+                              receiver->GetLocalAddress()));
+  int value = 0;
+  SocketAddress remote_address;
+  EXPECT_EQ_WAIT(4, receiver->RecvFrom(&value, sizeof(value), &remote_address,
+                                       nullptr),
+                 kTimeout);
+  EXPECT_EQ(kValue, value);
+  EXPECT_EQ(sender->GetLocalAddress(), remote_address);
+}
+
+}  // namespace rtc
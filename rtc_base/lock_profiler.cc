@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/lock_profiler.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/time_utils.h"
+
+namespace rtc {
+namespace {
+
+constexpr char kUntaggedLock[] = "untagged";
+
+// CriticalSection can't be used here, since it reports to the profiler.
+GlobalLock g_lock_profiler_lock;
+
+std::map<std::string, LockContentionStats>& GetStats()
+    RTC_EXCLUSIVE_LOCKS_REQUIRED(g_lock_profiler_lock) {
+  // google.github.io/styleguide/cppguide.html#Static_and_Global_Variables
+  static auto& stats = *new std::map<std::string, LockContentionStats>();
+  return stats;
+}
+
+}  // namespace
+
+LockContentionStats::LockContentionStats() = default;
+LockContentionStats::LockContentionStats(const LockContentionStats&) = default;
+LockContentionStats::~LockContentionStats() = default;
+
+std::vector<LockContentionStats> GetLockContentionStats() {
+  std::vector<LockContentionStats> result;
+  {
+    GlobalLockScope lock(&g_lock_profiler_lock);
+    for (const auto& tag_and_stats : GetStats())
+      result.push_back(tag_and_stats.second);
+  }
+  std::sort(result.begin(), result.end(),
+            [](const LockContentionStats& a, const LockContentionStats& b) {
+              return a.total_wait_ns > b.total_wait_ns;
+            });
+  return result;
+}
+
+void ResetLockContentionStats() {
+  GlobalLockScope lock(&g_lock_profiler_lock);
+  GetStats().clear();
+}
+
+void DumpLockContentionStats(FILE* file) {
+  for (const LockContentionStats& stats : GetLockContentionStats()) {
+    fprintf(file,
+            "%s: %" PRId64 " contended, total wait %" PRId64
+            " us, max wait %" PRId64 " us\n",
+            stats.tag.c_str(), stats.contended_acquisitions,
+            stats.total_wait_ns / kNumNanosecsPerMicrosec,
+            stats.max_wait_ns / kNumNanosecsPerMicrosec);
+    for (const auto& holder_and_wait : stats.wait_ns_by_holder) {
+      fprintf(file, "  held by thread %lu: %" PRId64 " us\n",
+              static_cast<unsigned long>(holder_and_wait.first),
+              holder_and_wait.second / kNumNanosecsPerMicrosec);
+    }
+  }
+}
+
+void RecordLockContention(const char* tag,
+                          PlatformThreadId holder,
+                          int64_t wait_ns) {
+  if (!tag)
+    tag = kUntaggedLock;
+  GlobalLockScope lock(&g_lock_profiler_lock);
+  LockContentionStats& stats = GetStats()[tag];
+  if (stats.tag.empty())
+    stats.tag = tag;
+  ++stats.contended_acquisitions;
+  stats.total_wait_ns += wait_ns;
+  stats.max_wait_ns = std::max(stats.max_wait_ns, wait_ns);
+  stats.wait_ns_by_holder[holder] += wait_ns;
+}
+
+}  // namespace rtc
@@ -0,0 +1,71 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_LOCK_PROFILER_H_
+#define RTC_BASE_LOCK_PROFILER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/system/rtc_export.h"
+
+// Contention profiling for rtc::CriticalSection. In builds with the GN arg
+// rtc_enable_lock_profiling = true, a thread that finds a CriticalSection
+// taken measures how long it waits for it, and the wait is added to the
+// profile of the lock's profiling tag, see CriticalSection(const char*).
+// Uncontended locking costs the same as without profiling. Without the GN
+// arg nothing is recorded.
+
+namespace rtc {
+
+struct RTC_EXPORT LockContentionStats {
+  LockContentionStats();
+  LockContentionStats(const LockContentionStats&);
+  ~LockContentionStats();
+
+  // The tag of the contended locks, or "untagged".
+  std::string tag;
+  int64_t contended_acquisitions = 0;
+  int64_t total_wait_ns = 0;
+  int64_t max_wait_ns = 0;
+  // Wait time per thread that held the lock when the wait started.
+  std::map<PlatformThreadId, int64_t> wait_ns_by_holder;
+};
+
+constexpr bool LockProfilingEnabled() {
+#if defined(RTC_LOCK_PROFILING)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Returns the recorded contention, most waited for tag first.
+RTC_EXPORT std::vector<LockContentionStats> GetLockContentionStats();
+
+RTC_EXPORT void ResetLockContentionStats();
+
+// Writes GetLockContentionStats() to |file| in a human readable format.
+RTC_EXPORT void DumpLockContentionStats(FILE* file);
+
+// Called by CriticalSection after waiting |wait_ns| for a lock held by
+// |holder|.
+void RecordLockContention(const char* tag,
+                          PlatformThreadId holder,
+                          int64_t wait_ns);
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_LOCK_PROFILER_H_
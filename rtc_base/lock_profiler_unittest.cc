@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/lock_profiler.h"
+
+#include <vector>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/time_utils.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+struct LockHolder {
+  CriticalSection lock{"LockProfilerTest"};
+  Event locked;
+  Event release;
+  PlatformThreadId thread_id = 0;
+};
+
+void HoldLock(void* param) {
+  LockHolder* holder = static_cast<LockHolder*>(param);
+  CritScope scope(&holder->lock);
+  holder->thread_id = CurrentThreadId();
+  holder->locked.Set();
+  holder->release.Wait(Event::kForever);
+}
+
+}  // namespace
+
+TEST(LockProfilerTest, UncontendedLockIsNotRecorded) {
+  ResetLockContentionStats();
+  CriticalSection lock("LockProfilerTest");
+  { CritScope scope(&lock); }
+  EXPECT_TRUE(GetLockContentionStats().empty());
+}
+
+TEST(LockProfilerTest, RecordsWaitForContendedLock) {
+  ResetLockContentionStats();
+  LockHolder holder;
+  PlatformThread thread(&HoldLock, &holder, "LockHolder");
+  thread.Start();
+  ASSERT_TRUE(holder.locked.Wait(Event::kForever));
+
+  PlatformThread releaser(
+      [](void* param) {
+        webrtc::SleepMs(20);
+        static_cast<LockHolder*>(param)->release.Set();
+      },
+      &holder, "LockReleaser");
+  releaser.Start();
+  { CritScope scope(&holder.lock); }
+  thread.Stop();
+  releaser.Stop();
+
+  std::vector<LockContentionStats> stats = GetLockContentionStats();
+  if (!LockProfilingEnabled()) {
+    EXPECT_TRUE(stats.empty());
+    return;
+  }
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ("LockProfilerTest", stats[0].tag);
+  EXPECT_EQ(1, stats[0].contended_acquisitions);
+  EXPECT_GT(stats[0].total_wait_ns, 0);
+  EXPECT_EQ(stats[0].total_wait_ns, stats[0].max_wait_ns);
+  ASSERT_EQ(1u, stats[0].wait_ns_by_holder.size());
+  EXPECT_EQ(holder.thread_id, stats[0].wait_ns_by_holder.begin()->first);
+}
+
+}  // namespace rtc
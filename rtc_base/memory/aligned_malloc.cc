@@ -13,7 +13,11 @@
 #include <stdlib.h>  // for free, malloc
 #include <string.h>  // for memcpy
 
+#include <atomic>
+#include <map>
+
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -21,6 +25,10 @@
 #include <stdint.h>
 #endif
 
+#if defined(WEBRTC_LINUX)
+#include <sys/mman.h>
+#endif
+
 // Reference on memory alignment:
 // http://stackoverflow.com/questions/227897/solve-the-memory-alignment-in-c-interview-question-that-stumped-me
 namespace webrtc {
@@ -31,6 +39,104 @@ uintptr_t GetRightAlign(uintptr_t start_pos, size_t alignment) {
   return (start_pos + alignment - 1) & ~(alignment - 1);
 }
 
+namespace {
+
+std::atomic<int> g_huge_page_mode{static_cast<int>(HugePageConfig::Mode::kOff)};
+std::atomic<size_t> g_huge_page_min_allocation_size{1024 * 1024};
+
+#if defined(WEBRTC_LINUX)
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+// Freed mappings kept for reuse.
+constexpr size_t kMaxCachedMappings = 16;
+// Set in the header word of mapped allocations; malloc never returns odd
+// addresses.
+constexpr uintptr_t kMappedFlag = 1;
+
+size_t RoundUpToHugePages(size_t size) {
+  return (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+rtc::CriticalSection& MappingCacheLock() {
+  static rtc::CriticalSection* const lock = new rtc::CriticalSection();
+  return *lock;
+}
+
+// Freed mappings by length.
+std::multimap<size_t, void*>& MappingCache() {
+  static auto* const cache = new std::multimap<size_t, void*>();
+  return *cache;
+}
+
+// Maps |length| bytes, a multiple of kHugePageSize, backed by huge pages as
+// far as possible. Returns null on failure.
+void* MapHugePages(size_t length, HugePageConfig::Mode mode) {
+  {
+    rtc::CritScope lock(&MappingCacheLock());
+    auto it = MappingCache().find(length);
+    if (it != MappingCache().end()) {
+      void* mapping = it->second;
+      MappingCache().erase(it);
+      return mapping;
+    }
+  }
+  if (mode == HugePageConfig::Mode::kExplicit) {
+    void* mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mapping != MAP_FAILED)
+      return mapping;
+  }
+  // Transparent huge pages need ranges aligned to the huge page size, so map
+  // an extra huge page and trim the mapping to an aligned range.
+  void* mapping = mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED)
+    return nullptr;
+  const uintptr_t start = reinterpret_cast<uintptr_t>(mapping);
+  const uintptr_t aligned_start = GetRightAlign(start, kHugePageSize);
+  if (aligned_start > start)
+    munmap(mapping, aligned_start - start);
+  munmap(reinterpret_cast<void*>(aligned_start + length),
+         start + kHugePageSize - aligned_start);
+  mapping = reinterpret_cast<void*>(aligned_start);
+  madvise(mapping, length, MADV_HUGEPAGE);
+  return mapping;
+}
+
+void UnmapHugePages(void* mapping, size_t length) {
+  {
+    rtc::CritScope lock(&MappingCacheLock());
+    if (MappingCache().size() < kMaxCachedMappings) {
+      MappingCache().emplace(length, mapping);
+      return;
+    }
+  }
+  munmap(mapping, length);
+}
+
+// Allocates from huge pages, with the mapping and its length stored in front
+// of the returned memory. Returns null if the memory can't be mapped.
+void* HugePageAlignedMalloc(size_t size,
+                            size_t alignment,
+                            HugePageConfig::Mode mode) {
+  if (alignment > kHugePageSize)
+    return nullptr;
+  const size_t header_size = GetRightAlign(2 * sizeof(uintptr_t), alignment);
+  const size_t length = RoundUpToHugePages(size + header_size);
+  void* mapping = MapHugePages(length, mode);
+  if (!mapping)
+    return nullptr;
+  const uintptr_t aligned_pos =
+      reinterpret_cast<uintptr_t>(mapping) + header_size;
+  const uintptr_t header[2] = {
+      length, reinterpret_cast<uintptr_t>(mapping) | kMappedFlag};
+  memcpy(reinterpret_cast<void*>(aligned_pos - sizeof(header)), header,
+         sizeof(header));
+  return reinterpret_cast<void*>(aligned_pos);
+}
+#endif  // defined(WEBRTC_LINUX)
+
+}  // namespace
+
 // Alignment must be an integer power of two.
 bool ValidAlignment(size_t alignment) {
   if (!alignment) {
@@ -58,6 +164,17 @@ void* AlignedMalloc(size_t size, size_t alignment) {
     return NULL;
   }
 
+#if defined(WEBRTC_LINUX)
+  const auto huge_page_mode =
+      static_cast<HugePageConfig::Mode>(g_huge_page_mode.load());
+  if (huge_page_mode != HugePageConfig::Mode::kOff &&
+      size >= g_huge_page_min_allocation_size.load()) {
+    void* memory = HugePageAlignedMalloc(size, alignment, huge_page_mode);
+    if (memory)
+      return memory;
+  }
+#endif  // defined(WEBRTC_LINUX)
+
   // The memory is aligned towards the lowest address that so only
   // alignment - 1 bytes needs to be allocated.
   // A pointer to the start of the memory must be stored so that it can be
@@ -91,8 +208,29 @@ void AlignedFree(void* mem_block) {
 
   // Read out the address of the AlignedMemory struct from the header.
   uintptr_t memory_start_pos = *reinterpret_cast<uintptr_t*>(header_pos);
+#if defined(WEBRTC_LINUX)
+  if (memory_start_pos & kMappedFlag) {
+    const uintptr_t length =
+        *reinterpret_cast<uintptr_t*>(header_pos - sizeof(uintptr_t));
+    UnmapHugePages(reinterpret_cast<void*>(memory_start_pos & ~kMappedFlag),
+                   length);
+    return;
+  }
+#endif  // defined(WEBRTC_LINUX)
   void* memory_start = reinterpret_cast<void*>(memory_start_pos);
   free(memory_start);
 }
 
+void SetAlignedMallocHugePageConfig(const HugePageConfig& config) {
+  g_huge_page_min_allocation_size.store(config.min_allocation_size);
+  g_huge_page_mode.store(static_cast<int>(config.mode));
+}
+
+HugePageConfig GetAlignedMallocHugePageConfig() {
+  HugePageConfig config;
+  config.mode = static_cast<HugePageConfig::Mode>(g_huge_page_mode.load());
+  config.min_allocation_size = g_huge_page_min_allocation_size.load();
+  return config;
+}
+
 }  // namespace webrtc
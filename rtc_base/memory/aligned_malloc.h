@@ -34,6 +34,32 @@ void* AlignedMalloc(size_t size, size_t alignment);
 // De-allocates memory created using the AlignedMalloc() API.
 void AlignedFree(void* mem_block);
 
+// How AlignedMalloc() backs large allocations, e.g. 4K video frames, with
+// huge pages, which take far fewer TLB entries to cover them. Huge pages are
+// only supported on Linux.
+struct HugePageConfig {
+  enum class Mode {
+    // Large allocations come from malloc like the others.
+    kOff,
+    // Large allocations are mapped and marked for transparent huge pages,
+    // which the kernel provides if it can.
+    kTransparent,
+    // Large allocations come from the reserved huge page pool (see
+    // vm.nr_hugepages), or are made as with kTransparent once it runs out.
+    kExplicit,
+  };
+
+  Mode mode = Mode::kOff;
+  // Smaller allocations come from malloc.
+  size_t min_allocation_size = 1024 * 1024;
+};
+
+// Sets how AlignedMalloc() makes allocations from now on, in the whole
+// process. Freed huge page allocations are kept for reuse by allocations of
+// the same number of huge pages, up to a few.
+void SetAlignedMallocHugePageConfig(const HugePageConfig& config);
+HugePageConfig GetAlignedMallocHugePageConfig();
+
 // Templated versions to facilitate usage of aligned malloc without casting
 // to and from void*.
 template <typename T>
@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Measures the data TLB misses of reading 4K frames allocated with and without
+// huge pages. The counter is read with perf_event_open(), so the results are
+// only reported on Linux where the kernel allows it, see
+// /proc/sys/kernel/perf_event_paranoid.
+
+#if defined(WEBRTC_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "rtc_base/memory/aligned_malloc.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kWidth = 3840;
+constexpr int kHeight = 2160;
+constexpr size_t kFrameSize = kWidth * kHeight * 3 / 2;
+constexpr int kNumFrames = 8;
+constexpr int kNumPasses = 10;
+
+#if defined(WEBRTC_LINUX)
+// Returns the number of data TLB read misses of the calling thread while
+// running |operation|, or nullopt if the counter can't be read.
+template <typename Operation>
+absl::optional<uint64_t> CountDtlbMisses(Operation operation) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HW_CACHE;
+  attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  const int fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0)
+    return absl::nullopt;
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  operation();
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  uint64_t misses = 0;
+  const bool read_ok = read(fd, &misses, sizeof(misses)) == sizeof(misses);
+  close(fd);
+  if (!read_ok)
+    return absl::nullopt;
+  return misses;
+}
+
+// Allocates the frames with |config| and reads them column by column, as a
+// scaler or a motion search does, so that each row is on another page.
+// Returns the data TLB misses per frame, or nullopt if they can't be counted.
+absl::optional<double> MeasureDtlbMissesPerFrame(
+    const HugePageConfig& config) {
+  SetAlignedMallocHugePageConfig(config);
+  std::vector<uint8_t*> frames;
+  for (int i = 0; i < kNumFrames; ++i) {
+    frames.push_back(static_cast<uint8_t*>(AlignedMalloc(kFrameSize, 64)));
+    memset(frames.back(), i, kFrameSize);
+  }
+  SetAlignedMallocHugePageConfig(HugePageConfig());
+
+  volatile uint8_t sink = 0;
+  absl::optional<uint64_t> misses = CountDtlbMisses([&] {
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+      for (uint8_t* frame : frames) {
+        uint8_t sum = 0;
+        for (int x = 0; x < kWidth; x += 64) {
+          for (int y = 0; y < kHeight; ++y)
+            sum += frame[y * kWidth + x];
+        }
+        sink = sink + sum;
+      }
+    }
+  });
+  for (uint8_t* frame : frames)
+    AlignedFree(frame);
+  if (!misses)
+    return absl::nullopt;
+  return static_cast<double>(*misses) / (kNumFrames * kNumPasses);
+}
+#endif  // defined(WEBRTC_LINUX)
+
+}  // namespace
+
+#if defined(WEBRTC_LINUX)
+TEST(AlignedMallocPerformanceTest, DtlbMissesWithHugePages) {
+  HugePageConfig config;
+  absl::optional<double> misses = MeasureDtlbMissesPerFrame(config);
+  if (!misses) {
+    printf("Skipped, data TLB misses can't be counted.\n");
+    return;
+  }
+  test::PrintResult("dtlb_misses_per_frame", "", "huge_pages_off", *misses,
+                    "count", /*important=*/false,
+                    test::ImproveDirection::kSmallerIsBetter);
+
+  config.mode = HugePageConfig::Mode::kTransparent;
+  misses = MeasureDtlbMissesPerFrame(config);
+  ASSERT_TRUE(misses);
+  test::PrintResult("dtlb_misses_per_frame", "", "huge_pages_transparent",
+                    *misses, "count", /*important=*/false,
+                    test::ImproveDirection::kSmallerIsBetter);
+
+  config.mode = HugePageConfig::Mode::kExplicit;
+  misses = MeasureDtlbMissesPerFrame(config);
+  ASSERT_TRUE(misses);
+  test::PrintResult("dtlb_misses_per_frame", "", "huge_pages_explicit",
+                    *misses, "count", /*important=*/false,
+                    test::ImproveDirection::kSmallerIsBetter);
+}
+#endif  // defined(WEBRTC_LINUX)
+
+}  // namespace webrtc
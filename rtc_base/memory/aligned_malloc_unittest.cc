@@ -10,6 +10,8 @@
 
 #include "rtc_base/memory/aligned_malloc.h"
 
+#include <string.h>
+
 #include <memory>
 
 #ifdef _WIN32
@@ -78,4 +80,52 @@ TEST(AlignedMalloc, AlignTo128Bytes) {
   EXPECT_TRUE(CorrectUsage(size, alignment));
 }
 
+TEST(AlignedMalloc, SmallAllocationsIgnoreHugePageConfig) {
+  HugePageConfig config;
+  config.mode = HugePageConfig::Mode::kTransparent;
+  SetAlignedMallocHugePageConfig(config);
+  EXPECT_TRUE(CorrectUsage(100, 64));
+  SetAlignedMallocHugePageConfig(HugePageConfig());
+}
+
+#if defined(WEBRTC_LINUX)
+TEST(AlignedMalloc, AllocatesFromHugePages) {
+  HugePageConfig config;
+  config.mode = HugePageConfig::Mode::kTransparent;
+  config.min_allocation_size = 4096;
+  SetAlignedMallocHugePageConfig(config);
+  EXPECT_EQ(HugePageConfig::Mode::kTransparent,
+            GetAlignedMallocHugePageConfig().mode);
+
+  // Large enough for a 4K I420 frame.
+  const size_t size = 3840 * 2160 * 3 / 2;
+  for (size_t alignment : {2, 64, 4096}) {
+    void* memory = AlignedMalloc(size, alignment);
+    ASSERT_TRUE(memory);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(memory) % alignment);
+    memset(memory, 1, size);
+    AlignedFree(memory);
+  }
+
+  // Freed mappings are reused.
+  void* memory = AlignedMalloc(size, 64);
+  AlignedFree(memory);
+  EXPECT_EQ(memory, AlignedMalloc(size, 64));
+  AlignedFree(memory);
+
+  SetAlignedMallocHugePageConfig(HugePageConfig());
+}
+
+TEST(AlignedMalloc, FreesMemoryAllocatedBeforeHugePagesWereEnabled) {
+  void* memory = AlignedMalloc(1024 * 1024, 64);
+  HugePageConfig config;
+  config.mode = HugePageConfig::Mode::kExplicit;
+  SetAlignedMallocHugePageConfig(config);
+  void* huge_page_memory = AlignedMalloc(1024 * 1024, 64);
+  SetAlignedMallocHugePageConfig(HugePageConfig());
+  AlignedFree(memory);
+  AlignedFree(huge_page_memory);
+}
+#endif
+
 }  // namespace webrtc
@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/memory/buffer_allocator.h"
+
+#if defined(WEBRTC_LINUX)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/memory/aligned_malloc.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace {
+
+class DefaultBufferAllocator : public BufferAllocator {
+ public:
+  void* Allocate(size_t size) override {
+    void* data = AlignedMalloc(size, kAlignment);
+    RTC_CHECK(data);
+    return data;
+  }
+  void Free(void* data, size_t size) override { AlignedFree(data); }
+};
+
+#if defined(WEBRTC_LINUX)
+// Number of NUMA nodes that fit in the node masks passed to the kernel.
+constexpr int kMaxNumaNodes = 8 * sizeof(unsigned long);  // NOLINT
+
+// Sets the policy of the memory at |data| to prefer |numa_node|.
+bool BindToNumaNode(void* data, size_t size, int numa_node) {
+  const unsigned long node_mask = 1UL << numa_node;  // NOLINT
+  // The kernel reads one bit less than the maximum node says.
+  return syscall(SYS_mbind, data, size, MPOL_PREFERRED, &node_mask,
+                 kMaxNumaNodes + 1, 0) == 0;
+}
+
+// Carves allocations of up to kMaxSlabAllocation bytes out of slabs that are
+// bound to the node, and maps larger ones separately.
+class NumaBufferAllocator : public BufferAllocator {
+ public:
+  explicit NumaBufferAllocator(int numa_node)
+      : numa_node_(numa_node), page_size_(sysconf(_SC_PAGESIZE)) {}
+
+  void* Allocate(size_t size) override;
+  void Free(void* data, size_t size) override;
+  absl::optional<int> numa_node() const override { return numa_node_; }
+
+ private:
+  static constexpr size_t kSlabSize = 2 * 1024 * 1024;
+  static constexpr size_t kMaxSlabAllocation = 64 * 1024;
+
+  static size_t RoundUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+  // Maps |size| bytes, a multiple of the page size, bound to the node.
+  void* Map(size_t size);
+
+  const int numa_node_;
+  const size_t page_size_;
+  rtc::CriticalSection lock_;
+  // Unused slab allocations by rounded size.
+  std::map<size_t, std::vector<void*>> free_allocations_ RTC_GUARDED_BY(lock_);
+  uint8_t* slab_ RTC_GUARDED_BY(lock_) = nullptr;
+  size_t slab_left_ RTC_GUARDED_BY(lock_) = 0;
+};
+
+void* NumaBufferAllocator::Allocate(size_t size) {
+  if (size > kMaxSlabAllocation)
+    return Map(RoundUp(size, page_size_));
+
+  const size_t rounded_size = RoundUp(std::max<size_t>(size, 1), kAlignment);
+  rtc::CritScope lock(&lock_);
+  std::vector<void*>& free_allocations = free_allocations_[rounded_size];
+  if (!free_allocations.empty()) {
+    void* data = free_allocations.back();
+    free_allocations.pop_back();
+    return data;
+  }
+  if (slab_left_ < rounded_size) {
+    // The rest of the old slab is lost, which is at most one allocation.
+    slab_ = static_cast<uint8_t*>(Map(kSlabSize));
+    slab_left_ = kSlabSize;
+  }
+  void* data = slab_;
+  slab_ += rounded_size;
+  slab_left_ -= rounded_size;
+  return data;
+}
+
+void NumaBufferAllocator::Free(void* data, size_t size) {
+  if (!data)
+    return;
+  if (size > kMaxSlabAllocation) {
+    munmap(data, RoundUp(size, page_size_));
+    return;
+  }
+  const size_t rounded_size = RoundUp(std::max<size_t>(size, 1), kAlignment);
+  rtc::CritScope lock(&lock_);
+  free_allocations_[rounded_size].push_back(data);
+}
+
+void* NumaBufferAllocator::Map(size_t size) {
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  RTC_CHECK(data != MAP_FAILED) << "Failed to map " << size << " bytes";
+  // The memory stays usable, just not as close, if it can't be bound.
+  if (!BindToNumaNode(data, size, numa_node_)) {
+    RTC_LOG_ERR(LS_WARNING) << "Failed to bind memory to NUMA node "
+                            << numa_node_;
+  }
+  return data;
+}
+
+// Returns the single node the calling thread allocates memory on, if any.
+absl::optional<int> GetCurrentThreadNumaNode() {
+  int mode = 0;
+  unsigned long node_mask = 0;  // NOLINT
+  if (syscall(SYS_get_mempolicy, &mode, &node_mask, kMaxNumaNodes + 1, nullptr,
+              0) != 0) {
+    return absl::nullopt;
+  }
+  if ((mode != MPOL_PREFERRED && mode != MPOL_BIND) || node_mask == 0 ||
+      (node_mask & (node_mask - 1)) != 0) {
+    return absl::nullopt;
+  }
+  int numa_node = 0;
+  while (!(node_mask & (1UL << numa_node)))
+    ++numa_node;
+  return numa_node;
+}
+#endif  // defined(WEBRTC_LINUX)
+
+}  // namespace
+
+BufferAllocator* GetDefaultBufferAllocator() {
+  static BufferAllocator* const allocator = new DefaultBufferAllocator();
+  return allocator;
+}
+
+BufferAllocator* GetNumaBufferAllocator(int numa_node) {
+#if defined(WEBRTC_LINUX)
+  if (numa_node < 0 || numa_node >= kMaxNumaNodes)
+    return GetDefaultBufferAllocator();
+  static rtc::CriticalSection* const lock = new rtc::CriticalSection();
+  static auto* const allocators =
+      new std::map<int, std::unique_ptr<NumaBufferAllocator>>();
+  rtc::CritScope scope(lock);
+  std::unique_ptr<NumaBufferAllocator>& allocator = (*allocators)[numa_node];
+  if (!allocator)
+    allocator = std::make_unique<NumaBufferAllocator>(numa_node);
+  return allocator.get();
+#else
+  return GetDefaultBufferAllocator();
+#endif  // defined(WEBRTC_LINUX)
+}
+
+BufferAllocator* GetBufferAllocatorForCurrentThread() {
+#if defined(WEBRTC_LINUX)
+  absl::optional<int> numa_node = GetCurrentThreadNumaNode();
+  if (numa_node)
+    return GetNumaBufferAllocator(*numa_node);
+#endif  // defined(WEBRTC_LINUX)
+  return GetDefaultBufferAllocator();
+}
+
+ScopedNumaMemoryPolicy::ScopedNumaMemoryPolicy(
+    absl::optional<int> numa_node) {
+#if defined(WEBRTC_LINUX)
+  if (!numa_node || *numa_node < 0 || *numa_node >= kMaxNumaNodes)
+    return;
+  if (syscall(SYS_get_mempolicy, &previous_mode_, &previous_nodes_,
+              kMaxNumaNodes + 1, nullptr, 0) != 0) {
+    return;
+  }
+  const unsigned long node_mask = 1UL << *numa_node;  // NOLINT
+  restore_ = syscall(SYS_set_mempolicy, MPOL_PREFERRED, &node_mask,
+                     kMaxNumaNodes + 1) == 0;
+#endif  // defined(WEBRTC_LINUX)
+}
+
+ScopedNumaMemoryPolicy::~ScopedNumaMemoryPolicy() {
+#if defined(WEBRTC_LINUX)
+  if (restore_) {
+    syscall(SYS_set_mempolicy, previous_mode_,
+            previous_mode_ == MPOL_DEFAULT ? nullptr : &previous_nodes_,
+            kMaxNumaNodes + 1);
+  }
+#endif  // defined(WEBRTC_LINUX)
+}
+
+}  // namespace webrtc
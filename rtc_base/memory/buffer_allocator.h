@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_MEMORY_BUFFER_ALLOCATOR_H_
+#define RTC_BASE_MEMORY_BUFFER_ALLOCATOR_H_
+
+#include <stddef.h>
+
+#include "absl/types/optional.h"
+
+namespace webrtc {
+
+// Allocates the storage of pooled media buffers, e.g. packets and frames, so
+// that a pool can place its buffers near the threads that process them.
+class BufferAllocator {
+ public:
+  // Alignment of all allocations, enough for SIMD loads and stores.
+  static constexpr size_t kAlignment = 64;
+
+  virtual ~BufferAllocator() = default;
+
+  // Returns |size| bytes of uninitialized memory. Never returns null.
+  virtual void* Allocate(size_t size) = 0;
+  // Frees memory returned by Allocate(size).
+  virtual void Free(void* data, size_t size) = 0;
+
+  // The NUMA node the memory is on, if it is bound to one.
+  virtual absl::optional<int> numa_node() const { return absl::nullopt; }
+};
+
+// Deleter for memory of |size| bytes allocated by |allocator|.
+struct BufferAllocatorDeleter {
+  void operator()(void* data) const { allocator->Free(data, size); }
+
+  BufferAllocator* allocator;
+  size_t size;
+};
+
+// Returns the allocator that uses the aligned heap, as unpooled buffers do.
+BufferAllocator* GetDefaultBufferAllocator();
+
+// Returns an allocator whose memory is on NUMA node |numa_node|, as far as the
+// kernel allows. Memory that is freed is kept for reuse rather than returned
+// to the system, so this is meant for the storage of pools, which allocate
+// only when they run short. The allocators live for the rest of the process.
+// Where NUMA isn't supported, returns the default allocator.
+BufferAllocator* GetNumaBufferAllocator(int numa_node);
+
+// Returns the allocator for the NUMA node that the calling thread allocates
+// its memory on, as set up by its ThreadSchedulingConfig, or the default
+// allocator if the thread isn't bound to a single node.
+BufferAllocator* GetBufferAllocatorForCurrentThread();
+
+// Makes the calling thread put the memory it touches for the first time on
+// |numa_node|, if set, while it lives. For buffers whose storage is allocated
+// by the buffer itself rather than through a BufferAllocator; such storage
+// must be touched within the scope, which places it only where the pages are
+// new to the process.
+class ScopedNumaMemoryPolicy {
+ public:
+  explicit ScopedNumaMemoryPolicy(absl::optional<int> numa_node);
+  ~ScopedNumaMemoryPolicy();
+
+  ScopedNumaMemoryPolicy(const ScopedNumaMemoryPolicy&) = delete;
+  ScopedNumaMemoryPolicy& operator=(const ScopedNumaMemoryPolicy&) = delete;
+
+ private:
+  bool restore_ = false;
+  int previous_mode_ = 0;
+  unsigned long previous_nodes_ = 0;  // NOLINT
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_MEMORY_BUFFER_ALLOCATOR_H_
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/memory/buffer_allocator.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+bool IsAligned(const void* data) {
+  return reinterpret_cast<uintptr_t>(data) % BufferAllocator::kAlignment == 0;
+}
+
+void ExpectAllocatesUsableMemory(BufferAllocator* allocator) {
+  for (size_t size : {size_t{1}, size_t{1500}, size_t{1 << 20}}) {
+    void* data = allocator->Allocate(size);
+    ASSERT_TRUE(data);
+    EXPECT_TRUE(IsAligned(data));
+    memset(data, 0xab, size);
+    allocator->Free(data, size);
+  }
+}
+
+}  // namespace
+
+TEST(BufferAllocatorTest, DefaultAllocator) {
+  EXPECT_FALSE(GetDefaultBufferAllocator()->numa_node());
+  ExpectAllocatesUsableMemory(GetDefaultBufferAllocator());
+}
+
+#if defined(WEBRTC_LINUX)
+TEST(BufferAllocatorTest, NumaAllocator) {
+  BufferAllocator* allocator = GetNumaBufferAllocator(0);
+  EXPECT_EQ(allocator, GetNumaBufferAllocator(0));
+  EXPECT_EQ(0, allocator->numa_node());
+  ExpectAllocatesUsableMemory(allocator);
+
+  // Small allocations of the same rounded size reuse freed memory.
+  void* data = allocator->Allocate(1500);
+  allocator->Free(data, 1500);
+  EXPECT_EQ(data, allocator->Allocate(1490));
+  allocator->Free(data, 1490);
+}
+
+TEST(BufferAllocatorTest, AllocatorForCurrentThreadFollowsMemoryPolicy) {
+  EXPECT_EQ(GetDefaultBufferAllocator(), GetBufferAllocatorForCurrentThread());
+  {
+    ScopedNumaMemoryPolicy memory_policy(0);
+    EXPECT_EQ(GetNumaBufferAllocator(0), GetBufferAllocatorForCurrentThread());
+  }
+  EXPECT_EQ(GetDefaultBufferAllocator(), GetBufferAllocatorForCurrentThread());
+}
+#endif
+
+}  // namespace webrtc
@@ -101,37 +101,64 @@ size_t ComputeHmac(MessageDigest* digest,
                    size_t in_len,
                    void* output,
                    size_t out_len) {
+  const ArrayView<const uint8_t> inputs[] = {
+      ArrayView<const uint8_t>(static_cast<const uint8_t*>(input), in_len)};
+  return ComputeHmac(digest, key, key_len, inputs, output, out_len);
+}
+
+// Copies |key| to the block-sized buffer |padded_key|, hashing it first with
+// |digest| if it is longer than a block. Returns false if |digest| has a block
+// size other than kBlockSize.
+static bool PadHmacKey(MessageDigest* digest,
+                       const void* key,
+                       size_t key_len,
+                       uint8_t padded_key[kBlockSize]) {
   // We only handle algorithms with a 64-byte blocksize.
   // TODO: Add BlockSize() method to MessageDigest.
-  size_t block_len = kBlockSize;
+  const size_t block_len = kBlockSize;
   if (digest->Size() > 32) {
-    return 0;
+    return false;
   }
   // Copy the key to a block-sized buffer to simplify padding.
   // If the key is longer than a block, hash it and use the result instead.
-  std::unique_ptr<uint8_t[]> new_key(new uint8_t[block_len]);
   if (key_len > block_len) {
-    ComputeDigest(digest, key, key_len, new_key.get(), block_len);
-    memset(new_key.get() + digest->Size(), 0, block_len - digest->Size());
+    ComputeDigest(digest, key, key_len, padded_key, block_len);
+    memset(padded_key + digest->Size(), 0, block_len - digest->Size());
   } else {
-    memcpy(new_key.get(), key, key_len);
-    memset(new_key.get() + key_len, 0, block_len - key_len);
+    memcpy(padded_key, key, key_len);
+    memset(padded_key + key_len, 0, block_len - key_len);
+  }
+  return true;
+}
+
+size_t ComputeHmac(MessageDigest* digest,
+                   const void* key,
+                   size_t key_len,
+                   ArrayView<const ArrayView<const uint8_t>> inputs,
+                   void* output,
+                   size_t out_len) {
+  const size_t block_len = kBlockSize;
+  uint8_t new_key[kBlockSize];
+  if (!PadHmacKey(digest, key, key_len, new_key)) {
+    return 0;
   }
   // Set up the padding from the key, salting appropriately for each padding.
-  std::unique_ptr<uint8_t[]> o_pad(new uint8_t[block_len]);
-  std::unique_ptr<uint8_t[]> i_pad(new uint8_t[block_len]);
+  uint8_t o_pad[kBlockSize];
+  uint8_t i_pad[kBlockSize];
   for (size_t i = 0; i < block_len; ++i) {
     o_pad[i] = 0x5c ^ new_key[i];
     i_pad[i] = 0x36 ^ new_key[i];
   }
-  // Inner hash; hash the inner padding, and then the input buffer.
-  std::unique_ptr<uint8_t[]> inner(new uint8_t[digest->Size()]);
-  digest->Update(i_pad.get(), block_len);
-  digest->Update(input, in_len);
-  digest->Finish(inner.get(), digest->Size());
+  // Inner hash; hash the inner padding, and then the input buffers.
+  uint8_t inner[kBlockSize];
+  digest->Update(i_pad, block_len);
+  for (const ArrayView<const uint8_t>& input : inputs) {
+    digest->Update(input.data(), input.size());
+  }
+  digest->Finish(inner, digest->Size());
   // Outer hash; hash the outer padding, and then the result of the inner hash.
-  digest->Update(o_pad.get(), block_len);
-  digest->Update(inner.get(), digest->Size());
+  digest->Update(o_pad, block_len);
+  digest->Update(inner, digest->Size());
   return digest->Finish(output, out_len);
 }
 
@@ -179,4 +206,48 @@ std::string ComputeHmac(const std::string& alg,
   return output;
 }
 
+std::unique_ptr<PrecomputedHmac> PrecomputedHmac::Create(const std::string& alg,
+                                                         const void* key,
+                                                         size_t key_len) {
+  std::unique_ptr<PrecomputedHmac> hmac(new PrecomputedHmac(alg));
+  uint8_t new_key[kBlockSize];
+  if (hmac->digest_->Size() == 0 ||
+      !PadHmacKey(hmac->digest_.get(), key, key_len, new_key)) {
+    return nullptr;
+  }
+  uint8_t pad[kBlockSize];
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    pad[i] = 0x36 ^ new_key[i];
+  }
+  hmac->inner_->Update(pad, kBlockSize);
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    pad[i] = 0x5c ^ new_key[i];
+  }
+  hmac->outer_->Update(pad, kBlockSize);
+  return hmac;
+}
+
+PrecomputedHmac::PrecomputedHmac(const std::string& alg)
+    : inner_(new OpenSSLDigest(alg)),
+      outer_(new OpenSSLDigest(alg)),
+      digest_(new OpenSSLDigest(alg)) {}
+
+PrecomputedHmac::~PrecomputedHmac() = default;
+
+size_t PrecomputedHmac::Compute(
+    ArrayView<const ArrayView<const uint8_t>> inputs,
+    void* output,
+    size_t out_len) {
+  const size_t digest_len = digest_->Size();
+  uint8_t inner[kBlockSize];
+  digest_->CopyStateFrom(*inner_);
+  for (const ArrayView<const uint8_t>& input : inputs) {
+    digest_->Update(input.data(), input.size());
+  }
+  digest_->Finish(inner, digest_len);
+  digest_->CopyStateFrom(*outer_);
+  digest_->Update(inner, digest_len);
+  return digest_->Finish(output, out_len);
+}
+
 }  // namespace rtc
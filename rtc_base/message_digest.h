@@ -13,10 +13,15 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <string>
 
+#include "api/array_view.h"
+
 namespace rtc {
 
+class OpenSSLDigest;
+
 // Definitions for the digest algorithms.
 extern const char DIGEST_MD5[];
 extern const char DIGEST_SHA_1[];
@@ -98,7 +103,15 @@ size_t ComputeHmac(MessageDigest* digest,
                    size_t in_len,
                    void* output,
                    size_t out_len);
-// Like the previous function, but creates a digest implementation based on
+// Like the previous function, but computes the HMAC of the concatenation of
+// |inputs|, without copying them into one buffer.
+size_t ComputeHmac(MessageDigest* digest,
+                   const void* key,
+                   size_t key_len,
+                   ArrayView<const ArrayView<const uint8_t>> inputs,
+                   void* output,
+                   size_t out_len);
+// Like the first function, but creates a digest implementation based on
 // the desired digest name |alg|, e.g. DIGEST_SHA_1. Returns 0 if there is no
 // digest with the given name.
 size_t ComputeHmac(const std::string& alg,
@@ -125,6 +138,32 @@ bool ComputeHmac(const std::string& alg,
                  const std::string& input,
                  std::string* output);
 
+// Computes RFC 2104 HMACs with a fixed key. The padded key is hashed once, up
+// front, and each HMAC starts from a copy of the resulting digest states, so
+// it costs two fewer hash blocks than ComputeHmac(). Not thread safe.
+class PrecomputedHmac {
+ public:
+  // Returns null if there is no digest with the given name |alg|, or if it
+  // isn't one that ComputeHmac() supports.
+  static std::unique_ptr<PrecomputedHmac> Create(const std::string& alg,
+                                                 const void* key,
+                                                 size_t key_len);
+  ~PrecomputedHmac();
+
+  // Like ComputeHmac(), with the key and digest of this object.
+  size_t Compute(ArrayView<const ArrayView<const uint8_t>> inputs,
+                 void* output,
+                 size_t out_len);
+
+ private:
+  explicit PrecomputedHmac(const std::string& alg);
+
+  // The states after hashing the inner and outer padded keys.
+  const std::unique_ptr<OpenSSLDigest> inner_;
+  const std::unique_ptr<OpenSSLDigest> outer_;
+  const std::unique_ptr<OpenSSLDigest> digest_;
+};
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_MESSAGE_DIGEST_H_
@@ -10,6 +10,9 @@
 
 #include "rtc_base/message_digest.h"
 
+#include <memory>
+#include <string>
+
 #include "rtc_base/string_encode.h"
 #include "test/gtest.h"
 
@@ -146,6 +149,32 @@ TEST(MessageDigestTest, TestSha1Hmac) {
                         input.size(), output, sizeof(output) - 1));
 }
 
+TEST(MessageDigestTest, TestPrecomputedHmac) {
+  const std::string keys[] = {"Jefe", std::string(20, '\x0b'),
+                              std::string(80, '\xaa')};
+  const std::string input = "what do ya want for nothing?";
+  const ArrayView<const uint8_t> inputs[] = {
+      ArrayView<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(input.data()), 10),
+      ArrayView<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(input.data()) + 10,
+          input.size() - 10)};
+  for (const std::string& key : keys) {
+    std::unique_ptr<PrecomputedHmac> hmac =
+        PrecomputedHmac::Create(DIGEST_SHA_1, key.data(), key.size());
+    ASSERT_TRUE(hmac);
+    // Twice, to check that the key states are reused, not consumed.
+    for (int i = 0; i < 2; ++i) {
+      char output[20];
+      EXPECT_EQ(sizeof(output), hmac->Compute(inputs, output, sizeof(output)));
+      EXPECT_EQ(ComputeHmac(DIGEST_SHA_1, key, input),
+                hex_encode(output, sizeof(output)));
+    }
+  }
+  EXPECT_FALSE(PrecomputedHmac::Create("sha-9000", "key", 3));
+  EXPECT_FALSE(PrecomputedHmac::Create(DIGEST_SHA_512, "key", 3));
+}
+
 TEST(MessageDigestTest, TestBadHmac) {
   std::string output;
   EXPECT_FALSE(ComputeHmac("sha-9000", "key", "abc", &output));
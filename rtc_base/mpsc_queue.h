@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_MPSC_QUEUE_H_
+#define RTC_BASE_MPSC_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <utility>
+
+#include "rtc_base/constructor_magic.h"
+
+namespace rtc {
+
+// Unbounded multi-producer single-consumer FIFO queue. Push() may be called
+// concurrently from any number of threads and never blocks; it costs one
+// allocation and one atomic exchange. Pop() must not be called concurrently
+// with itself; callers with more than one consumer thread have to serialize
+// Pop() externally.
+//
+// A Pop() racing with a Push() may transiently report the queue as empty
+// even though the pushed element is already counted by size(); the element
+// becomes visible once the producer completes Push().
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_.load()) {}
+  ~MpscQueue() {
+    T value;
+    while (Pop(&value)) {
+    }
+    delete tail_;
+  }
+
+  void Push(T value) {
+    Node* node = new Node();
+    node->value = std::move(value);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Returns false if no element is available.
+  bool Pop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr)
+      return false;
+    *value = std::move(next->value);
+    // |next| becomes the new stub node.
+    tail_ = next;
+    delete tail;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Approximate number of queued elements.
+  size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  // Most recently pushed node, written by producers.
+  std::atomic<Node*> head_;
+  // Stub node preceding the oldest element, owned by the consumer.
+  Node* tail_;
+  std::atomic<size_t> size_{0};
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MpscQueue);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_MPSC_QUEUE_H_
@@ -0,0 +1,104 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/mpsc_queue.h"
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+  MpscQueue<int> queue;
+  int value = 0;
+  EXPECT_FALSE(queue.Pop(&value));
+  queue.Push(1);
+  queue.Push(2);
+  queue.Push(3);
+  EXPECT_EQ(3u, queue.size());
+  for (int expected = 1; expected <= 3; ++expected) {
+    ASSERT_TRUE(queue.Pop(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(queue.Pop(&value));
+  EXPECT_EQ(0u, queue.size());
+}
+
+TEST(MpscQueueTest, SupportsMoveOnlyTypes) {
+  MpscQueue<std::unique_ptr<int>> queue;
+  queue.Push(std::make_unique<int>(17));
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_TRUE(value);
+  EXPECT_EQ(17, *value);
+}
+
+TEST(MpscQueueTest, DestroysRemainingElements) {
+  auto shared = std::make_shared<int>(0);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.Push(shared);
+    queue.Push(shared);
+    EXPECT_EQ(3, shared.use_count());
+  }
+  EXPECT_EQ(1, shared.use_count());
+}
+
+struct ProducerContext {
+  MpscQueue<int>* queue;
+  int producer_id;
+};
+
+constexpr int kItemsPerProducer = 10000;
+
+void Produce(void* obj) {
+  ProducerContext* context = static_cast<ProducerContext*>(obj);
+  for (int i = 0; i < kItemsPerProducer; ++i)
+    context->queue->Push(context->producer_id * kItemsPerProducer + i);
+}
+
+TEST(MpscQueueTest, KeepsPerProducerOrderWithConcurrentProducers) {
+  constexpr int kNumProducers = 4;
+  MpscQueue<int> queue;
+  std::vector<ProducerContext> contexts;
+  std::vector<std::unique_ptr<PlatformThread>> threads;
+  for (int i = 0; i < kNumProducers; ++i)
+    contexts.push_back({&queue, i});
+  for (int i = 0; i < kNumProducers; ++i) {
+    threads.push_back(
+        std::make_unique<PlatformThread>(&Produce, &contexts[i], "producer"));
+    threads.back()->Start();
+  }
+
+  std::vector<int> last_seen(kNumProducers, -1);
+  int popped = 0;
+  while (popped < kNumProducers * kItemsPerProducer) {
+    int value;
+    if (!queue.Pop(&value))
+      continue;
+    int producer = value / kItemsPerProducer;
+    int sequence = value % kItemsPerProducer;
+    ASSERT_LT(producer, kNumProducers);
+    EXPECT_GT(sequence, last_seen[producer]);
+    last_seen[producer] = sequence;
+    ++popped;
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  int value;
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+}  // namespace
+}  // namespace rtc
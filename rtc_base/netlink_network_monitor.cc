@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/netlink_network_monitor.h"
+
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+namespace {
+
+// Owns the process wide netlink socket and the thread reading it, while any
+// monitor is started.
+class NetlinkListener {
+ public:
+  static NetlinkListener* Get() {
+    // Leaked on purpose, monitors may be stopped during static destruction.
+    static NetlinkListener* const listener = new NetlinkListener();
+    return listener;
+  }
+
+  // Returns false if notifications can't be received.
+  bool AddMonitor(NetworkMonitorInterface* monitor) {
+    CritScope start_lock(&start_lock_);
+    if (monitor_count_ == 0 && !Open())
+      return false;
+    ++monitor_count_;
+    CritScope lock(&lock_);
+    monitors_.push_back(monitor);
+    return true;
+  }
+
+  void RemoveMonitor(NetworkMonitorInterface* monitor) {
+    CritScope start_lock(&start_lock_);
+    {
+      CritScope lock(&lock_);
+      auto it = std::find(monitors_.begin(), monitors_.end(), monitor);
+      if (it == monitors_.end())
+        return;
+      monitors_.erase(it);
+    }
+    if (--monitor_count_ == 0)
+      Close();
+  }
+
+ private:
+  NetlinkListener() = default;
+
+  bool Open() RTC_EXCLUSIVE_LOCKS_REQUIRED(start_lock_) {
+    netlink_fd_ =
+        socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK,
+               NETLINK_ROUTE);
+    if (netlink_fd_ < 0) {
+      RTC_LOG_ERR(LS_WARNING) << "Failed to open a netlink socket";
+      return false;
+    }
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (bind(netlink_fd_, reinterpret_cast<sockaddr*>(&address),
+             sizeof(address)) < 0 ||
+        wake_fd_ < 0) {
+      RTC_LOG_ERR(LS_WARNING) << "Failed to listen to netlink notifications";
+      CloseFds();
+      return false;
+    }
+    thread_.reset(new PlatformThread(&NetlinkListener::Run, this,
+                                     "NetlinkListener"));
+    thread_->Start();
+    return true;
+  }
+
+  void Close() RTC_EXCLUSIVE_LOCKS_REQUIRED(start_lock_) {
+    uint64_t value = 1;
+    if (write(wake_fd_, &value, sizeof(value)) != sizeof(value))
+      RTC_LOG_ERR(LS_ERROR) << "Failed to wake up the netlink listener";
+    thread_->Stop();
+    thread_.reset();
+    CloseFds();
+  }
+
+  void CloseFds() {
+    if (netlink_fd_ >= 0)
+      close(netlink_fd_);
+    if (wake_fd_ >= 0)
+      close(wake_fd_);
+    netlink_fd_ = -1;
+    wake_fd_ = -1;
+  }
+
+  static void Run(void* obj) {
+    NetlinkListener* listener = static_cast<NetlinkListener*>(obj);
+    while (listener->WaitForChange()) {
+      CritScope lock(&listener->lock_);
+      for (NetworkMonitorInterface* monitor : listener->monitors_)
+        monitor->OnNetworksChanged();
+    }
+  }
+
+  // Blocks until a link or an address changed. Returns false when Close() is
+  // called or the socket fails.
+  bool WaitForChange() {
+    while (true) {
+      pollfd fds[2] = {{netlink_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+      if (poll(fds, 2, -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        RTC_LOG_ERR(LS_ERROR) << "Failed to poll the netlink socket";
+        return false;
+      }
+      if (fds[1].revents != 0)
+        return false;
+      if (fds[0].revents & (POLLERR | POLLNVAL)) {
+        RTC_LOG(LS_ERROR) << "The netlink socket failed";
+        return false;
+      }
+      if (ReadNotifications())
+        return true;
+    }
+  }
+
+  // Reads all queued notifications, and returns true if any of them is about
+  // a link or address change.
+  bool ReadNotifications() {
+    bool changed = false;
+    alignas(nlmsghdr) char buffer[8192];
+    while (true) {
+      ssize_t length = recv(netlink_fd_, buffer, sizeof(buffer), 0);
+      if (length < 0) {
+        if (errno == EINTR)
+          continue;
+        // Notifications were lost when the socket's buffer overran, so assume
+        // that something changed.
+        if (errno == ENOBUFS) {
+          changed = true;
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+          RTC_LOG_ERR(LS_WARNING) << "Failed to read the netlink socket";
+        return changed;
+      }
+      int remaining = static_cast<int>(length);
+      for (const nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer);
+           NLMSG_OK(header, remaining);
+           header = NLMSG_NEXT(header, remaining)) {
+        switch (header->nlmsg_type) {
+          case RTM_NEWLINK:
+          case RTM_DELLINK:
+          case RTM_NEWADDR:
+          case RTM_DELADDR:
+            changed = true;
+            break;
+          default:
+            break;
+        }
+      }
+    }
+  }
+
+  // Serializes adding and removing monitors, which may open and close the
+  // socket. Separate from |lock_|, so that the thread can be joined while it
+  // notifies the monitors.
+  CriticalSection start_lock_;
+  int monitor_count_ RTC_GUARDED_BY(start_lock_) = 0;
+  std::unique_ptr<PlatformThread> thread_ RTC_GUARDED_BY(start_lock_);
+  // Written while the thread isn't running.
+  int netlink_fd_ = -1;
+  int wake_fd_ = -1;
+
+  CriticalSection lock_;
+  std::vector<NetworkMonitorInterface*> monitors_ RTC_GUARDED_BY(lock_);
+};
+
+}  // namespace
+
+NetlinkNetworkMonitor::NetlinkNetworkMonitor() = default;
+
+NetlinkNetworkMonitor::~NetlinkNetworkMonitor() {
+  Stop();
+}
+
+void NetlinkNetworkMonitor::Start() {
+  RTC_DCHECK(worker_thread()->IsCurrent());
+  if (started_)
+    return;
+  started_ = true;
+  listening_ = NetlinkListener::Get()->AddMonitor(this);
+}
+
+void NetlinkNetworkMonitor::Stop() {
+  RTC_DCHECK(worker_thread()->IsCurrent());
+  if (!started_)
+    return;
+  started_ = false;
+  if (listening_)
+    NetlinkListener::Get()->RemoveMonitor(this);
+  listening_ = false;
+}
+
+AdapterType NetlinkNetworkMonitor::GetAdapterType(
+    const std::string& interface_name) {
+  return ADAPTER_TYPE_UNKNOWN;
+}
+
+bool NetlinkNetworkMonitor::SignalsAllNetworkChanges() const {
+  return listening_;
+}
+
+NetlinkNetworkMonitorFactory::NetlinkNetworkMonitorFactory() = default;
+NetlinkNetworkMonitorFactory::~NetlinkNetworkMonitorFactory() = default;
+
+NetworkMonitorInterface* NetlinkNetworkMonitorFactory::CreateNetworkMonitor() {
+  return new NetlinkNetworkMonitor();
+}
+
+}  // namespace rtc
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_NETLINK_NETWORK_MONITOR_H_
+#define RTC_BASE_NETLINK_NETWORK_MONITOR_H_
+
+#include <string>
+
+#include "rtc_base/network_monitor.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace rtc {
+
+// A network monitor for Linux that listens to the kernel's rtnetlink
+// notifications for links and addresses coming and going, so that
+// BasicNetworkManager enumerates the networks when they change instead of
+// polling them. All started monitors in the process share one netlink socket
+// and one thread that reads it; a burst of notifications that is already
+// queued when the thread wakes up results in a single SignalNetworksChanged.
+//
+// Must be created, started and stopped on the thread that runs the network
+// manager, like NetworkMonitorBase.
+class RTC_EXPORT NetlinkNetworkMonitor : public NetworkMonitorBase {
+ public:
+  NetlinkNetworkMonitor();
+  ~NetlinkNetworkMonitor() override;
+
+  void Start() override;
+  void Stop() override;
+
+  // Leaves the adapter type to BasicNetworkManager's name based guess.
+  AdapterType GetAdapterType(const std::string& interface_name) override;
+
+  // True once started, unless the netlink socket couldn't be opened.
+  bool SignalsAllNetworkChanges() const override;
+
+ private:
+  bool started_ = false;
+  bool listening_ = false;
+};
+
+// Install with NetworkMonitorFactory::SetFactory() to have every
+// BasicNetworkManager use a NetlinkNetworkMonitor.
+class RTC_EXPORT NetlinkNetworkMonitorFactory : public NetworkMonitorFactory {
+ public:
+  NetlinkNetworkMonitorFactory();
+  ~NetlinkNetworkMonitorFactory() override;
+
+  NetworkMonitorInterface* CreateNetworkMonitor() override;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_NETLINK_NETWORK_MONITOR_H_
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/netlink_network_monitor.h"
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/network.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+#define MAYBE_SKIP_NETLINK(monitor)                      \
+  if (!(monitor).SignalsAllNetworkChanges()) {           \
+    RTC_LOG(LS_INFO) << "No netlink socket... skipping"; \
+    return;                                              \
+  }
+
+class NetworkChangeCounter : public sigslot::has_slots<> {
+ public:
+  void OnNetworksChanged() { ++num_changes; }
+
+  int num_changes = 0;
+};
+
+TEST(NetlinkNetworkMonitorTest, SharesTheListenerBetweenMonitors) {
+  AutoThread thread;
+  NetlinkNetworkMonitor first;
+  NetlinkNetworkMonitor second;
+  EXPECT_FALSE(first.SignalsAllNetworkChanges());
+  first.Start();
+  MAYBE_SKIP_NETLINK(first);
+  second.Start();
+  EXPECT_TRUE(second.SignalsAllNetworkChanges());
+
+  first.Stop();
+  EXPECT_FALSE(first.SignalsAllNetworkChanges());
+  EXPECT_TRUE(second.SignalsAllNetworkChanges());
+
+  // The listener is closed with the last monitor and opened again.
+  second.Stop();
+  first.Start();
+  EXPECT_TRUE(first.SignalsAllNetworkChanges());
+  first.Stop();
+}
+
+TEST(NetlinkNetworkMonitorTest, ForwardsChangesToTheMonitorThread) {
+  AutoThread thread;
+  NetlinkNetworkMonitor monitor;
+  NetworkChangeCounter counter;
+  monitor.SignalNetworksChanged.connect(
+      &counter, &NetworkChangeCounter::OnNetworksChanged);
+  monitor.Start();
+  monitor.OnNetworksChanged();
+  EXPECT_EQ_WAIT(1, counter.num_changes, 1000);
+  monitor.Stop();
+}
+
+TEST(NetlinkNetworkMonitorTest, NetworkManagerDoesNotPoll) {
+  AutoThread thread;
+  {
+    NetlinkNetworkMonitor monitor;
+    monitor.Start();
+    MAYBE_SKIP_NETLINK(monitor);
+    monitor.Stop();
+  }
+  NetlinkNetworkMonitorFactory* factory = new NetlinkNetworkMonitorFactory();
+  NetworkMonitorFactory::SetFactory(factory);
+
+  BasicNetworkManager manager;
+  NetworkChangeCounter counter;
+  manager.SignalNetworksChanged.connect(
+      &counter, &NetworkChangeCounter::OnNetworksChanged);
+  manager.StartUpdating();
+  EXPECT_EQ_WAIT(1, counter.num_changes, 1000);
+  // The networks were enumerated once, and no further update is scheduled.
+  EXPECT_TRUE(thread.empty());
+
+  manager.StopUpdating();
+  NetworkMonitorFactory::ReleaseFactory(factory);
+}
+
+}  // namespace
+}  // namespace rtc
@@ -806,6 +806,10 @@ void BasicNetworkManager::StartUpdating() {
     if (sent_first_update_)
       thread_->Post(RTC_FROM_HERE, this, kSignalNetworksMessage);
   } else {
+    if (signal_cached_networks_ && has_enumerated_networks_) {
+      thread_->Post(RTC_FROM_HERE, this, kSignalNetworksMessage);
+      sent_first_update_ = true;
+    }
     thread_->Post(RTC_FROM_HERE, this, kUpdateNetworksMessage);
     StartNetworkMonitor();
   }
@@ -904,6 +908,7 @@ void BasicNetworkManager::UpdateNetworksOnce() {
     MergeNetworkList(list, &changed, &stats);
     set_default_local_addresses(QueryDefaultLocalAddress(AF_INET),
                                 QueryDefaultLocalAddress(AF_INET6));
+    has_enumerated_networks_ = true;
     if (changed || !sent_first_update_) {
       SignalNetworksChanged();
       sent_first_update_ = true;
@@ -913,6 +918,8 @@ void BasicNetworkManager::UpdateNetworksOnce() {
 
 void BasicNetworkManager::UpdateNetworksContinually() {
   UpdateNetworksOnce();
+  if (network_monitor_ && network_monitor_->SignalsAllNetworkChanges())
+    return;
   thread_->PostDelayed(RTC_FROM_HERE, kNetworksUpdateIntervalMs, this,
                        kUpdateNetworksMessage);
 }
@@ -238,6 +238,15 @@ class RTC_EXPORT BasicNetworkManager : public NetworkManagerBase,
     network_ignore_list_ = list;
   }
 
+  // If true, StartUpdating() after all clients have stopped updating signals
+  // the networks of the previous enumeration right away, so that new clients
+  // can start allocating ports without waiting for the enumeration. The
+  // networks are still enumerated again, and signaled if they changed. False
+  // by default.
+  void set_signal_cached_networks(bool signal_cached_networks) {
+    signal_cached_networks_ = signal_cached_networks;
+  }
+
  protected:
 #if defined(WEBRTC_POSIX)
   // Separated from CreateNetworks for tests.
@@ -269,7 +278,8 @@ class RTC_EXPORT BasicNetworkManager : public NetworkManagerBase,
   // Called when it receives updates from the network monitor.
   void OnNetworksChanged();
 
-  // Updates the networks and reschedules the next update.
+  // Updates the networks and reschedules the next update, unless the network
+  // monitor signals all changes.
   void UpdateNetworksContinually();
   // Only updates the networks; does not reschedule the next update.
   void UpdateNetworksOnce();
@@ -277,6 +287,9 @@ class RTC_EXPORT BasicNetworkManager : public NetworkManagerBase,
   Thread* thread_;
   bool sent_first_update_;
   int start_count_;
+  bool signal_cached_networks_ = false;
+  // True once the networks have been enumerated successfully.
+  bool has_enumerated_networks_ = false;
   std::vector<std::string> network_ignore_list_;
   std::unique_ptr<NetworkMonitorInterface> network_monitor_;
 };
@@ -75,6 +75,11 @@ class NetworkMonitorInterface {
   virtual AdapterType GetAdapterType(const std::string& interface_name) = 0;
   virtual AdapterType GetVpnUnderlyingAdapterType(
       const std::string& interface_name) = 0;
+
+  // Returns true if SignalNetworksChanged fires for every change to the
+  // network interfaces and their addresses, so that the network manager
+  // doesn't need to poll them.
+  virtual bool SignalsAllNetworkChanges() const { return false; }
 };
 
 class NetworkMonitorBase : public NetworkMonitorInterface,
@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/network_thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+NetworkThreadPool::NetworkThreadPool(size_t num_shards,
+                                     const std::string& name_prefix)
+    : users_(num_shards, 0) {
+  RTC_DCHECK_GT(num_shards, 0);
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    std::unique_ptr<Thread> thread = Thread::CreateWithSocketServer();
+    thread->SetName(name_prefix + std::to_string(i), nullptr);
+    RTC_CHECK(thread->Start());
+    shards_.push_back(std::move(thread));
+  }
+}
+
+NetworkThreadPool::~NetworkThreadPool() {
+  for (auto& shard : shards_)
+    shard->Stop();
+}
+
+Thread* NetworkThreadPool::shard(size_t index) const {
+  RTC_DCHECK_LT(index, shards_.size());
+  return shards_[index].get();
+}
+
+Thread* NetworkThreadPool::AcquireShard() {
+  CritScope lock(&crit_);
+  size_t index =
+      std::min_element(users_.begin(), users_.end()) - users_.begin();
+  ++users_[index];
+  return shards_[index].get();
+}
+
+void NetworkThreadPool::ReleaseShard(Thread* shard) {
+  CritScope lock(&crit_);
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    if (shards_[i].get() == shard) {
+      RTC_DCHECK_GT(users_[i], 0);
+      --users_[i];
+      return;
+    }
+  }
+  RTC_NOTREACHED() << "Shard doesn't belong to this pool.";
+}
+
+int NetworkThreadPool::ShardUsers(size_t index) const {
+  CritScope lock(&crit_);
+  RTC_DCHECK_LT(index, users_.size());
+  return users_[index];
+}
+
+}  // namespace rtc
@@ -0,0 +1,62 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_NETWORK_THREAD_POOL_H_
+#define RTC_BASE_NETWORK_THREAD_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/constructor_magic.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/system/rtc_export.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// A fixed set of network threads ("shards"), each owning its own
+// PhysicalSocketServer and thus its own epoll loop. A socket is serviced by
+// the shard that created it, so everything layered on top of a socket
+// (BasicPacketSocketFactory, ports, P2PTransportChannel) must run on that same
+// shard. The intended use is to give each PeerConnectionFactory, or each
+// group of PeerConnections, one shard as its network thread, spreading the
+// socket load of a process over several cores.
+class RTC_EXPORT NetworkThreadPool {
+ public:
+  // Creates and starts |num_shards| threads named "<name_prefix><index>".
+  NetworkThreadPool(size_t num_shards, const std::string& name_prefix);
+  ~NetworkThreadPool();
+
+  size_t size() const { return shards_.size(); }
+  Thread* shard(size_t index) const;
+
+  // Returns the shard with the fewest current users and counts the caller
+  // as one of them. Every call must be matched by ReleaseShard().
+  Thread* AcquireShard();
+  void ReleaseShard(Thread* shard);
+
+  // Returns the number of current users of shard |index|.
+  int ShardUsers(size_t index) const;
+
+ private:
+  std::vector<std::unique_ptr<Thread>> shards_;
+  rtc::CriticalSection crit_;
+  std::vector<int> users_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkThreadPool);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_NETWORK_THREAD_POOL_H_
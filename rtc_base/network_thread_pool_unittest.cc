@@ -0,0 +1,65 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/network_thread_pool.h"
+
+#include <memory>
+#include <set>
+
+#include "rtc_base/location.h"
+#include "rtc_base/physical_socket_server.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+TEST(NetworkThreadPoolTest, CreatesRunningShardsWithOwnSocketServers) {
+  NetworkThreadPool pool(3, "net");
+  ASSERT_EQ(3u, pool.size());
+  std::set<SocketServer*> socket_servers;
+  for (size_t i = 0; i < pool.size(); ++i) {
+    Thread* shard = pool.shard(i);
+    EXPECT_TRUE(shard->Invoke<bool>(RTC_FROM_HERE,
+                                    [shard] { return shard->IsCurrent(); }));
+    socket_servers.insert(shard->socketserver());
+  }
+  EXPECT_EQ(3u, socket_servers.size());
+}
+
+TEST(NetworkThreadPoolTest, AcquireBalancesUsersAcrossShards) {
+  NetworkThreadPool pool(2, "net");
+  Thread* first = pool.AcquireShard();
+  Thread* second = pool.AcquireShard();
+  EXPECT_NE(first, second);
+  EXPECT_EQ(1, pool.ShardUsers(0));
+  EXPECT_EQ(1, pool.ShardUsers(1));
+
+  pool.ReleaseShard(first);
+  EXPECT_EQ(first, pool.AcquireShard());
+  pool.ReleaseShard(first);
+  pool.ReleaseShard(second);
+  EXPECT_EQ(0, pool.ShardUsers(0));
+  EXPECT_EQ(0, pool.ShardUsers(1));
+}
+
+TEST(NetworkThreadPoolTest, SocketsAreCreatedOnTheShardSocketServer) {
+  NetworkThreadPool pool(1, "net");
+  Thread* shard = pool.AcquireShard();
+  bool created = shard->Invoke<bool>(RTC_FROM_HERE, [shard] {
+    std::unique_ptr<AsyncSocket> socket(
+        shard->socketserver()->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+    return socket != nullptr;
+  });
+  EXPECT_TRUE(created);
+  pool.ReleaseShard(shard);
+}
+
+}  // namespace
+}  // namespace rtc
@@ -356,6 +356,31 @@ TEST_F(NetworkTest, TestUpdateNetworks) {
   EXPECT_TRUE(callback_called_);
 }
 
+// Test that a restarted manager signals the networks of the previous
+// enumeration before it enumerates them again.
+TEST_F(NetworkTest, TestSignalCachedNetworksOnRestart) {
+  BasicNetworkManager manager;
+  manager.set_signal_cached_networks(true);
+  manager.SignalNetworksChanged.connect(static_cast<NetworkTest*>(this),
+                                        &NetworkTest::OnNetworksChanged);
+  manager.StartUpdating();
+  Thread::Current()->ProcessMessages(0);
+  EXPECT_TRUE(callback_called_);
+  manager.StopUpdating();
+
+  callback_called_ = false;
+  manager.StartUpdating();
+  Message msg;
+  ASSERT_TRUE(Thread::Current()->Get(&msg, 0));
+  Thread::Current()->Dispatch(&msg);
+  EXPECT_TRUE(callback_called_);
+  // The enumeration is still pending.
+  ASSERT_TRUE(Thread::Current()->Get(&msg, 0));
+  EXPECT_EQ(&manager, msg.phandler);
+  Thread::Current()->Dispatch(&msg);
+  manager.StopUpdating();
+}
+
 // Verify that MergeNetworkList() merges network lists properly.
 TEST_F(NetworkTest, TestBasicMergeNetworkList) {
   Network ipv4_network1("test_eth0", "Test Network Adapter 1",
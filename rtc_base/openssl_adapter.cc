@@ -569,6 +569,21 @@ int OpenSSLAdapter::Send(const void* pv, size_t cb) {
   return ret;
 }
 
+int OpenSSLAdapter::SendVectored(
+    ArrayView<const ArrayView<const uint8_t>> buffers) {
+  if (state_ == SSL_NONE) {
+    return socket_->SendVectored(buffers);
+  }
+  if (state_ != SSL_CONNECTED || buffers.size() <= 1) {
+    return AsyncSocketAdapter::SendVectored(buffers);
+  }
+  vectored_data_.Clear();
+  for (ArrayView<const uint8_t> buffer : buffers) {
+    vectored_data_.AppendData(buffer.data(), buffer.size());
+  }
+  return Send(vectored_data_.data(), vectored_data_.size());
+}
+
 int OpenSSLAdapter::SendTo(const void* pv,
                            size_t cb,
                            const SocketAddress& addr) {
@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 
+#include "api/array_view.h"
 #include "rtc_base/async_socket.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/message_handler.h"
@@ -58,6 +59,9 @@ class OpenSSLAdapter final : public SSLAdapter, public MessageHandler {
   AsyncSocket* Accept(SocketAddress* paddr) override;
   int StartSSL(const char* hostname) override;
   int Send(const void* pv, size_t cb) override;
+  // Joins |buffers| so that they are written with one SSL_write(), which
+  // produces as few TLS records as possible.
+  int SendVectored(ArrayView<const ArrayView<const uint8_t>> buffers) override;
   int SendTo(const void* pv, size_t cb, const SocketAddress& addr) override;
   int Recv(void* pv, size_t cb, int64_t* timestamp) override;
   int RecvFrom(void* pv,
@@ -131,6 +135,8 @@ class OpenSSLAdapter final : public SSLAdapter, public MessageHandler {
   // means we need to keep retrying with *the same exact data* until it
   // succeeds. Afterwards it will be cleared.
   Buffer pending_data_;
+  // Reused by SendVectored() to join the buffers.
+  Buffer vectored_data_;
   SSL* ssl_;
   // Holds the SSL context, which may be shared if an session cache is provided.
   SSL_CTX* ssl_ctx_;
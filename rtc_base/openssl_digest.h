@@ -32,6 +32,9 @@ class OpenSSLDigest final : public MessageDigest {
   void Update(const void* buf, size_t len) override;
   // Outputs the digest value to |buf| with length |len|.
   size_t Finish(void* buf, size_t len) override;
+  // Replaces the state of this digest with that of |other|, which must use
+  // the same hash algorithm, as if the same data had been passed to Update().
+  void CopyStateFrom(const OpenSSLDigest& other);
 
   // Helper function to look up a digest's EVP by name.
   static bool GetDigestEVP(const std::string& algorithm, const EVP_MD** md);
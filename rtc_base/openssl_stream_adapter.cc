@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/openssl.h"
@@ -34,6 +35,7 @@
 #include "rtc_base/openssl_identity.h"
 #include "rtc_base/ssl_certificate.h"
 #include "rtc_base/stream.h"
+#include "rtc_base/string_encode.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/time_utils.h"
 #include "system_wrappers/include/field_trial.h"
@@ -134,6 +136,60 @@ constexpr SslCipherMapEntry kSslCipherMap[] = {
     {0, nullptr}};
 #endif  // #ifndef OPENSSL_IS_BORINGSSL
 
+// Session ID context of the DTLS sessions that can be resumed. OpenSSL
+// refuses to resume sessions without one when peer verification is enabled.
+const char kDtlsSessionIdContext[] = "WebRTC-DTLS";
+
+// Size of the session ticket key material; a 16-byte key name followed by
+// the HMAC and AES keys.
+#ifdef OPENSSL_IS_BORINGSSL
+constexpr size_t kTicketKeysSize = 48;
+#else
+constexpr size_t kTicketKeysSize = 80;
+#endif
+
+// The DTLS sessions and session ticket keys shared by all the
+// OpenSSLStreamAdapters of the process, used when session resumption is
+// enabled. Tickets issued by one server stream can be decrypted by any other,
+// and clients keep the last session with each pair of local and remote
+// certificates.
+class DtlsSessionStore {
+ public:
+  static DtlsSessionStore* Get() {
+    static DtlsSessionStore* const store = new DtlsSessionStore();
+    return store;
+  }
+
+  const uint8_t* ticket_keys() const { return ticket_keys_; }
+
+  // Applies the cached session for |key| to |ssl|, if any. Returns true if a
+  // session was applied.
+  bool ApplySession(const std::string& key, SSL* ssl) {
+    CritScope lock(&crit_);
+    SSL_SESSION* session = cache_->LookupSession(key);
+    return session && SSL_set_session(ssl, session) == 1;
+  }
+
+  // Takes ownership of |session|.
+  void AddSession(const std::string& key, SSL_SESSION* session) {
+    CritScope lock(&crit_);
+    cache_->AddSession(key, session);
+  }
+
+ private:
+  DtlsSessionStore() {
+    SSL_CTX* ctx = SSL_CTX_new(DTLS_method());
+    RTC_CHECK(ctx);
+    cache_ = std::make_unique<OpenSSLSessionCache>(SSL_MODE_DTLS, ctx);
+    SSL_CTX_free(ctx);
+    RTC_CHECK_EQ(RAND_bytes(ticket_keys_, sizeof(ticket_keys_)), 1);
+  }
+
+  CriticalSection crit_;
+  std::unique_ptr<OpenSSLSessionCache> cache_ RTC_GUARDED_BY(crit_);
+  uint8_t ticket_keys_[kTicketKeysSize];
+};
+
 #ifdef OPENSSL_IS_BORINGSSL
 // Enabled by EnableTimeCallbackForTesting. Should never be set in production
 // code.
@@ -279,7 +335,9 @@ OpenSSLStreamAdapter::OpenSSLStreamAdapter(
       // Default is to support legacy TLS protocols.
       // This will be changed to default non-support in M82 or M83.
       support_legacy_tls_protocols_flag_(
-          !webrtc::field_trial::IsDisabled("WebRTC-LegacyTlsProtocols")) {}
+          !webrtc::field_trial::IsDisabled("WebRTC-LegacyTlsProtocols")),
+      session_resumption_enabled_(
+          webrtc::field_trial::IsEnabled("WebRTC-DtlsSessionResumption")) {}
 
 OpenSSLStreamAdapter::~OpenSSLStreamAdapter() {
   Cleanup(0);
@@ -483,6 +541,10 @@ bool OpenSSLStreamAdapter::GetDtlsSrtpCryptoSuite(int* crypto_suite) {
   return true;
 }
 
+bool OpenSSLStreamAdapter::IsResumedSession() const {
+  return state_ == SSL_CONNECTED && SSL_session_reused(ssl_);
+}
+
 bool OpenSSLStreamAdapter::IsTlsConnected() {
   return state_ == SSL_CONNECTED;
 }
@@ -828,6 +890,15 @@ int OpenSSLStreamAdapter::BeginSSL() {
   SSL_set_mode(ssl_, SSL_MODE_ENABLE_PARTIAL_WRITE |
                          SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 
+  if (ResumesSessions() && role_ == SSL_CLIENT) {
+    // The sessions are cached per peer certificate, so the digest must be
+    // known to offer one.
+    const std::string key = SessionCacheKey();
+    if (!key.empty() && DtlsSessionStore::Get()->ApplySession(key, ssl_)) {
+      RTC_LOG(LS_INFO) << "Attempting to resume DTLS session.";
+    }
+  }
+
   // Do the connect
   return ContinueSSL();
 }
@@ -845,6 +916,20 @@ int OpenSSLStreamAdapter::ContinueSSL() {
   switch (ssl_error) {
     case SSL_ERROR_NONE:
       RTC_LOG(LS_VERBOSE) << " -- success";
+      if (SSL_session_reused(ssl_)) {
+        RTC_LOG(LS_INFO) << "Resumed DTLS session.";
+        // The certificate verification callback isn't called for resumed
+        // sessions, so check the certificate the session was established
+        // with instead.
+        if (!peer_cert_chain_) {
+          peer_cert_chain_ = GetSessionPeerCertChain(ssl_);
+        }
+        if (HasPeerCertificateDigest() && !peer_certificate_verified_ &&
+            !VerifyPeerCertificate()) {
+          Error("ContinueSSL", -1, SSL_AD_BAD_CERTIFICATE, false);
+          return -1;
+        }
+      }
       // By this point, OpenSSL should have given us a certificate, or errored
       // out if one was missing.
       RTC_DCHECK(peer_cert_chain_ || !GetClientAuthEnabled());
@@ -1041,9 +1126,81 @@ SSL_CTX* OpenSSLStreamAdapter::SetupSSLContext() {
     }
   }
 
+  if (ResumesSessions()) {
+    SSL_CTX_set_session_id_context(
+        ctx, reinterpret_cast<const unsigned char*>(kDtlsSessionIdContext),
+        sizeof(kDtlsSessionIdContext) - 1);
+    if (role_ == SSL_SERVER) {
+      // Each stream has its own context, so the session ticket keys are
+      // shared for another stream to accept the tickets.
+      SSL_CTX_set_tlsext_ticket_keys(
+          ctx, const_cast<uint8_t*>(DtlsSessionStore::Get()->ticket_keys()),
+          kTicketKeysSize);
+    } else {
+      SSL_CTX_set_session_cache_mode(
+          ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+      SSL_CTX_sess_set_new_cb(ctx,
+                              &OpenSSLStreamAdapter::NewSSLSessionCallback);
+    }
+  }
+
   return ctx;
 }
 
+std::string OpenSSLStreamAdapter::SessionCacheKey() const {
+  if (!identity_ || !HasPeerCertificateDigest()) {
+    return std::string();
+  }
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  size_t digest_length;
+  if (!identity_->certificate().ComputeDigest(DIGEST_SHA_256, digest,
+                                              sizeof(digest), &digest_length)) {
+    return std::string();
+  }
+  return peer_certificate_digest_algorithm_ + ":" +
+         hex_encode(peer_certificate_digest_value_.data<char>(),
+                    peer_certificate_digest_value_.size()) +
+         ":" + hex_encode(reinterpret_cast<const char*>(digest), digest_length);
+}
+
+// static
+std::unique_ptr<SSLCertChain> OpenSSLStreamAdapter::GetSessionPeerCertChain(
+    SSL* ssl) {
+#if defined(OPENSSL_IS_BORINGSSL)
+  STACK_OF(X509)* chain = SSL_get_peer_full_cert_chain(ssl);
+  if (!chain) {
+    return nullptr;
+  }
+  std::vector<std::unique_ptr<SSLCertificate>> cert_chain;
+  for (X509* cert : chain) {
+    cert_chain.emplace_back(new OpenSSLCertificate(cert));
+  }
+  return std::make_unique<SSLCertChain>(std::move(cert_chain));
+#else
+  X509* cert = SSL_get_peer_certificate(ssl);
+  if (!cert) {
+    return nullptr;
+  }
+  auto cert_chain = std::make_unique<SSLCertChain>(
+      std::make_unique<OpenSSLCertificate>(cert));
+  X509_free(cert);
+  return cert_chain;
+#endif
+}
+
+// static
+int OpenSSLStreamAdapter::NewSSLSessionCallback(SSL* ssl,
+                                                SSL_SESSION* session) {
+  OpenSSLStreamAdapter* stream =
+      reinterpret_cast<OpenSSLStreamAdapter*>(SSL_get_app_data(ssl));
+  const std::string key = stream->SessionCacheKey();
+  if (key.empty() || !stream->peer_certificate_verified_) {
+    return 0;
+  }
+  DtlsSessionStore::Get()->AddSession(key, session);
+  return 1;  // We've taken ownership of the session; OpenSSL shouldn't free it.
+}
+
 bool OpenSSLStreamAdapter::VerifyPeerCertificate() {
   if (!HasPeerCertificateDigest() || !peer_cert_chain_ ||
       !peer_cert_chain_->GetSize()) {
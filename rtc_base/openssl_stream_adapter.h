@@ -21,6 +21,7 @@
 
 #include "rtc_base/buffer.h"
 #include "rtc_base/openssl_identity.h"
+#include "rtc_base/openssl_session_cache.h"
 #include "rtc_base/ssl_identity.h"
 #include "rtc_base/ssl_stream_adapter.h"
 #include "rtc_base/stream.h"
@@ -111,6 +112,7 @@ class OpenSSLStreamAdapter final : public SSLStreamAdapter {
   bool GetDtlsSrtpCryptoSuite(int* crypto_suite) override;
 
   bool IsTlsConnected() override;
+  bool IsResumedSession() const override;
 
   // Capabilities interfaces.
   static bool IsBoringSsl();
@@ -174,6 +176,18 @@ class OpenSSLStreamAdapter final : public SSLStreamAdapter {
   // SSL certificate verification callback. See
   // SSL_CTX_set_cert_verify_callback.
   static int SSLVerifyCallback(X509_STORE_CTX* store, void* arg);
+  // Returns the certificate chain of the peer of the session of |ssl|.
+  static std::unique_ptr<SSLCertChain> GetSessionPeerCertChain(SSL* ssl);
+  // Caches the sessions established by the client, when resuming sessions.
+  static int NewSSLSessionCallback(SSL* ssl, SSL_SESSION* session);
+
+  // The key of the sessions cached for the local and the peer certificates,
+  // or empty if either isn't known yet.
+  std::string SessionCacheKey() const;
+
+  bool ResumesSessions() const {
+    return session_resumption_enabled_ && ssl_mode_ == SSL_MODE_DTLS;
+  }
 
   bool WaitingToVerifyPeerCertificate() const {
     return GetClientAuthEnabled() && !peer_certificate_verified_;
@@ -220,6 +234,10 @@ class OpenSSLStreamAdapter final : public SSLStreamAdapter {
 
   // TODO(https://bugs.webrtc.org/10261): Completely remove this option in M84.
   const bool support_legacy_tls_protocols_flag_;
+
+  // Whether DTLS sessions are resumed with the session tickets shared between
+  // the streams of the process, see "WebRTC-DtlsSessionResumption".
+  const bool session_resumption_enabled_;
 };
 
 /////////////////////////////////////////////////////////////////////////////
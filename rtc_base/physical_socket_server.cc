@@ -40,6 +40,7 @@
 #include <errno.h>
 
 #include <algorithm>
+#include <array>
 #include <map>
 
 #include "rtc_base/arraysize.h"
@@ -79,7 +80,8 @@ int64_t GetSocketRecvTimestamp(int socket) {
   int64_t timestamp =
       rtc::kNumMicrosecsPerSec * static_cast<int64_t>(tv_ioctl.tv_sec) +
       static_cast<int64_t>(tv_ioctl.tv_usec);
-  return timestamp;
+  return rtc::RecvTimestampToTimeMicros(timestamp, rtc::TimeMicros(),
+                                        rtc::TimeUTCMicros());
 }
 
 #else
@@ -105,6 +107,34 @@ typedef char* SockOptArg;
 
 namespace rtc {
 
+int64_t RecvTimestampToTimeMicros(int64_t timestamp_us,
+                                  int64_t now_us,
+                                  int64_t now_utc_us) {
+  // The datagram's age carries over to the other clock. A negative age means
+  // that the realtime clock was set back since; the datagram is then taken
+  // to be received now.
+  return now_us - std::max<int64_t>(0, now_utc_us - timestamp_us);
+}
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+int64_t GetRecvTimestampFromControl(const msghdr& msg,
+                                    int64_t now_us,
+                                    int64_t now_utc_us) {
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+       cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&msg), cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS) {
+      timespec ts;
+      memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+      int64_t timestamp_us =
+          kNumMicrosecsPerSec * static_cast<int64_t>(ts.tv_sec) +
+          static_cast<int64_t>(ts.tv_nsec) / kNumNanosecsPerMicrosec;
+      return RecvTimestampToTimeMicros(timestamp_us, now_us, now_utc_us);
+    }
+  }
+  return -1;
+}
+#endif
+
 std::unique_ptr<SocketServer> SocketServer::CreateDefault() {
 #if defined(__native_client__)
   return std::unique_ptr<SocketServer>(new rtc::NullSocketServer);
@@ -144,6 +174,15 @@ bool PhysicalSocket::Create(int family, int type) {
   if (udp_) {
     SetEnabledEvents(DE_READ | DE_WRITE);
   }
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (udp_ && s_ != INVALID_SOCKET) {
+    // Have the kernel attach the receive time to each datagram, so that
+    // RecvFrom() and RecvFromBatch() report when the datagram arrived rather
+    // than when it was read.
+    int value = 1;
+    ::setsockopt(s_, SOL_SOCKET, SO_TIMESTAMPNS, &value, sizeof(value));
+  }
+#endif
   return s_ != INVALID_SOCKET;
 }
 
@@ -377,6 +416,92 @@ int PhysicalSocket::SendTo(const void* buffer,
   return sent;
 }
 
+int PhysicalSocket::SendToBatch(ArrayView<const SendBatchEntry> entries) {
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (!udp_ || entries.size() <= 1)
+    return AsyncSocket::SendToBatch(entries);
+
+  // Maximum number of datagrams written with one call to "sendmmsg".
+  static constexpr size_t kMaxSendBatchSize = 64;
+  int total_sent = 0;
+  while (static_cast<size_t>(total_sent) < entries.size()) {
+    ArrayView<const SendBatchEntry> chunk = entries.subview(
+        total_sent, std::min(entries.size() - total_sent, kMaxSendBatchSize));
+    std::array<mmsghdr, kMaxSendBatchSize> msgs;
+    std::array<iovec, kMaxSendBatchSize> iovs;
+    std::array<sockaddr_storage, kMaxSendBatchSize> addrs;
+    for (size_t i = 0; i < chunk.size(); ++i) {
+      iovs[i].iov_base = const_cast<char*>(chunk[i].data);
+      iovs[i].iov_len = chunk[i].length;
+      memset(&msgs[i], 0, sizeof(msgs[i]));
+      msgs[i].msg_hdr.msg_name = &addrs[i];
+      msgs[i].msg_hdr.msg_namelen =
+          chunk[i].remote_address.ToSockAddrStorage(&addrs[i]);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    // Suppress SIGPIPE. See above for explanation.
+    int sent =
+        ::sendmmsg(s_, msgs.data(), static_cast<unsigned int>(chunk.size()),
+                   MSG_NOSIGNAL);
+    UpdateLastError();
+    MaybeRemapSendError();
+    if (sent < 0 && GetError() == ENOSYS && total_sent == 0) {
+      // Kernel without sendmmsg support.
+      return AsyncSocket::SendToBatch(entries);
+    }
+    if (sent <= 0) {
+      if (sent < 0 && IsBlockingError(GetError()))
+        EnableEvents(DE_WRITE);
+      return total_sent > 0 ? total_sent : sent;
+    }
+    total_sent += sent;
+    if (static_cast<size_t>(sent) < chunk.size()) {
+      // The socket buffer is full; wait for it to become writable again.
+      EnableEvents(DE_WRITE);
+      break;
+    }
+  }
+  return total_sent;
+#else
+  return AsyncSocket::SendToBatch(entries);
+#endif
+}
+
+int PhysicalSocket::SendVectored(
+    ArrayView<const ArrayView<const uint8_t>> buffers) {
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Maximum number of buffers written with one call to "sendmsg".
+  static constexpr size_t kMaxSendBuffers = 16;
+  if (udp_ || buffers.size() <= 1 || buffers.size() > kMaxSendBuffers)
+    return AsyncSocket::SendVectored(buffers);
+
+  std::array<iovec, kMaxSendBuffers> iovs;
+  size_t length = 0;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    iovs[i].iov_base = const_cast<uint8_t*>(buffers[i].data());
+    iovs[i].iov_len = buffers[i].size();
+    length += buffers[i].size();
+  }
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iovs.data();
+  msg.msg_iovlen = buffers.size();
+  // Suppress SIGPIPE. See above for explanation.
+  int sent = ::sendmsg(s_, &msg, MSG_NOSIGNAL);
+  UpdateLastError();
+  MaybeRemapSendError();
+  RTC_DCHECK(sent <= static_cast<int>(length));
+  if ((sent > 0 && sent < static_cast<int>(length)) ||
+      (sent < 0 && IsBlockingError(GetError()))) {
+    EnableEvents(DE_WRITE);
+  }
+  return sent;
+#else
+  return AsyncSocket::SendVectored(buffers);
+#endif
+}
+
 int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   int received =
       ::recv(s_, static_cast<char*>(buffer), static_cast<int>(length), 0);
@@ -413,10 +538,37 @@ int PhysicalSocket::RecvFrom(void* buffer,
   sockaddr_storage addr_storage;
   socklen_t addr_len = sizeof(addr_storage);
   sockaddr* addr = reinterpret_cast<sockaddr*>(&addr_storage);
-  int received = ::recvfrom(s_, static_cast<char*>(buffer),
-                            static_cast<int>(length), 0, addr, &addr_len);
-  if (timestamp) {
-    *timestamp = GetSocketRecvTimestamp(s_);
+  int received;
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (udp_) {
+    // Reads the datagram along with its receive time.
+    iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = length;
+    char control[kRecvTimestampControlSize];
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = addr;
+    msg.msg_namelen = addr_len;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    received = ::recvmsg(s_, &msg, 0);
+    if (timestamp) {
+      *timestamp = received >= 0 ? GetRecvTimestampFromControl(
+                                       msg, TimeMicros(), TimeUTCMicros())
+                                 : -1;
+    }
+  } else {
+#else
+  {
+#endif
+    received = ::recvfrom(s_, static_cast<char*>(buffer),
+                          static_cast<int>(length), 0, addr, &addr_len);
+    if (timestamp) {
+      *timestamp = GetSocketRecvTimestamp(s_);
+    }
   }
   UpdateLastError();
   if ((received >= 0) && (out_addr != nullptr))
@@ -432,6 +584,59 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+int PhysicalSocket::RecvFromBatch(ArrayView<RecvBatchEntry> entries) {
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (!udp_ || entries.size() <= 1)
+    return AsyncSocket::RecvFromBatch(entries);
+
+  // Maximum number of datagrams drained with one call to "recvmmsg".
+  static constexpr size_t kMaxRecvBatchSize = 64;
+  const size_t count = std::min(entries.size(), kMaxRecvBatchSize);
+  std::array<mmsghdr, kMaxRecvBatchSize> msgs;
+  std::array<iovec, kMaxRecvBatchSize> iovs;
+  std::array<sockaddr_storage, kMaxRecvBatchSize> addrs;
+  std::array<std::array<char, kRecvTimestampControlSize>, kMaxRecvBatchSize>
+      controls;
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = entries[i].buffer;
+    iovs[i].iov_len = entries[i].capacity;
+    memset(&msgs[i], 0, sizeof(msgs[i]));
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_control = controls[i].data();
+    msgs[i].msg_hdr.msg_controllen = controls[i].size();
+  }
+  int received =
+      ::recvmmsg(s_, msgs.data(), static_cast<unsigned int>(count), 0, nullptr);
+  UpdateLastError();
+  if (received < 0 && GetError() == ENOSYS) {
+    // Kernel without recvmmsg support.
+    return AsyncSocket::RecvFromBatch(entries);
+  }
+  const int64_t now_us = received > 0 ? TimeMicros() : 0;
+  const int64_t now_utc_us = received > 0 ? TimeUTCMicros() : 0;
+  for (int i = 0; i < received; ++i) {
+    RecvBatchEntry& entry = entries[i];
+    entry.length = msgs[i].msg_len;
+    entry.truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    entry.timestamp =
+        GetRecvTimestampFromControl(msgs[i].msg_hdr, now_us, now_utc_us);
+    SocketAddressFromSockAddrStorage(addrs[i], &entry.remote_address);
+  }
+  // Always re-enable reads; a full batch means more datagrams may be queued,
+  // which the level triggered poll will report right away.
+  EnableEvents(DE_READ);
+  if (received < 0 && !IsBlockingError(GetError())) {
+    RTC_LOG_F(LS_VERBOSE) << "Error = " << GetError();
+  }
+  return received;
+#else
+  return AsyncSocket::RecvFromBatch(entries);
+#endif
+}
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -586,6 +791,15 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
 #endif
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_REUSEPORT:
+#if defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
+#endif
     default:
       RTC_NOTREACHED();
       return -1;
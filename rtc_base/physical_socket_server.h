@@ -13,6 +13,7 @@
 
 #if defined(WEBRTC_POSIX) && defined(WEBRTC_LINUX)
 #include <sys/epoll.h>
+#include <sys/socket.h>
 #define WEBRTC_USE_EPOLL 1
 #endif
 
@@ -44,6 +45,25 @@ enum DispatcherEvent {
 
 class Signaler;
 
+// Converts the receive time that the kernel reports for a datagram, in
+// microseconds of the realtime clock, to the rtc::TimeMicros() clock that
+// packet times are compared with. |now_us| and |now_utc_us| are the current
+// rtc::TimeMicros() and rtc::TimeUTCMicros().
+int64_t RecvTimestampToTimeMicros(int64_t timestamp_us,
+                                  int64_t now_us,
+                                  int64_t now_utc_us);
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Space for the control message that SO_TIMESTAMPNS adds to a datagram.
+constexpr size_t kRecvTimestampControlSize = CMSG_SPACE(sizeof(timespec));
+
+// Returns the receive time in the SO_TIMESTAMPNS control message of |msg|,
+// converted as by RecvTimestampToTimeMicros(), or -1 if there is none.
+int64_t GetRecvTimestampFromControl(const msghdr& msg,
+                                    int64_t now_us,
+                                    int64_t now_utc_us);
+#endif
+
 class Dispatcher {
  public:
   virtual ~Dispatcher() {}
@@ -144,12 +164,15 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   int SendTo(const void* buffer,
              size_t length,
              const SocketAddress& addr) override;
+  int SendToBatch(ArrayView<const SendBatchEntry> entries) override;
+  int SendVectored(ArrayView<const ArrayView<const uint8_t>> buffers) override;
 
   int Recv(void* buffer, size_t length, int64_t* timestamp) override;
   int RecvFrom(void* buffer,
                size_t length,
                SocketAddress* out_addr,
                int64_t* timestamp) override;
+  int RecvFromBatch(ArrayView<RecvBatchEntry> entries) override;
 
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
@@ -14,7 +14,10 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
+#include "rtc_base/arraysize.h"
+#include "rtc_base/async_udp_socket.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/ip_address.h"
 #include "rtc_base/logging.h"
@@ -22,6 +25,7 @@
 #include "rtc_base/socket_unittest.h"
 #include "rtc_base/test_utils.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
 #include "test/gtest.h"
 
 namespace rtc {
@@ -501,6 +505,175 @@ TEST_F(PhysicalSocketTest,
   server_->set_network_binder(nullptr);
 }
 
+TEST_F(PhysicalSocketTest, RecvFromBatchReceivesAllQueuedDatagrams) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const char kPayloads[][4] = {"abc", "def", "ghi"};
+  for (const char* payload : kPayloads) {
+    ASSERT_EQ(3, sender->SendTo(payload, 3, receiver->GetLocalAddress()));
+  }
+  // Give the loopback interface a moment to queue all datagrams.
+  Thread::SleepMs(100);
+
+  char buffers[4][16];
+  RecvBatchEntry entries[4];
+  for (size_t i = 0; i < arraysize(entries); ++i) {
+    entries[i].buffer = buffers[i];
+    entries[i].capacity = sizeof(buffers[i]);
+  }
+  int received = 0;
+  while (received < 3) {
+    int count = receiver->RecvFromBatch(
+        ArrayView<RecvBatchEntry>(entries).subview(received));
+    ASSERT_GT(count, 0);
+    received += count;
+  }
+  EXPECT_EQ(3, received);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(3u, entries[i].length);
+    EXPECT_FALSE(entries[i].truncated);
+    EXPECT_EQ(0, memcmp(kPayloads[i], entries[i].buffer, 3));
+    EXPECT_EQ(sender->GetLocalAddress(), entries[i].remote_address);
+  }
+}
+
+TEST_F(PhysicalSocketTest, RecvTimestampsAreInTimeMicrosClock) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> socket(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const int64_t send_time_us = TimeMicros();
+  ASSERT_EQ(3, socket->SendTo("foo", 3, socket->GetLocalAddress()));
+  // The datagram is read well after it was received.
+  Thread::SleepMs(100);
+  char buffer[3];
+  int64_t timestamp = -1;
+  ASSERT_EQ(3, socket->RecvFrom(buffer, sizeof(buffer), nullptr, &timestamp));
+  EXPECT_GE(timestamp, send_time_us);
+  EXPECT_LT(timestamp, send_time_us + 50000);
+}
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+TEST_F(PhysicalSocketTest, RecvFromBatchReportsReceiveTimeOfEachDatagram) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  int64_t send_times_us[3];
+  for (int64_t& send_time_us : send_times_us) {
+    send_time_us = TimeMicros();
+    ASSERT_EQ(3, sender->SendTo("abc", 3, receiver->GetLocalAddress()));
+    Thread::SleepMs(50);
+  }
+
+  char buffers[3][16];
+  RecvBatchEntry entries[3];
+  for (size_t i = 0; i < arraysize(entries); ++i) {
+    entries[i].buffer = buffers[i];
+    entries[i].capacity = sizeof(buffers[i]);
+  }
+  ASSERT_EQ(3, receiver->RecvFromBatch(entries));
+  for (size_t i = 0; i < arraysize(entries); ++i) {
+    EXPECT_GE(entries[i].timestamp, send_times_us[i]);
+    EXPECT_LT(entries[i].timestamp, send_times_us[i] + 25000);
+  }
+}
+#endif
+
+TEST(RecvTimestampToTimeMicrosTest, KeepsAgeOfDatagram) {
+  EXPECT_EQ(9000, RecvTimestampToTimeMicros(/*timestamp_us=*/49000,
+                                            /*now_us=*/10000,
+                                            /*now_utc_us=*/50000));
+  // The realtime clock was set back since the datagram was received.
+  EXPECT_EQ(10000, RecvTimestampToTimeMicros(/*timestamp_us=*/51000,
+                                             /*now_us=*/10000,
+                                             /*now_utc_us=*/50000));
+}
+
+TEST_F(PhysicalSocketTest, SendVectoredSendsConcatenatedBuffers) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> listener(
+      server_->CreateAsyncSocket(AF_INET, SOCK_STREAM));
+  ASSERT_EQ(0, listener->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, listener->Listen(1));
+  std::unique_ptr<AsyncSocket> client(
+      server_->CreateAsyncSocket(AF_INET, SOCK_STREAM));
+  client->Connect(listener->GetLocalAddress());
+  // Give the loopback interface a moment to complete the handshake.
+  Thread::SleepMs(100);
+  std::unique_ptr<AsyncSocket> accepted(listener->Accept(nullptr));
+  ASSERT_TRUE(accepted);
+
+  const uint8_t kHeader[] = {0, 5};
+  const uint8_t kPayload[] = {'h', 'e', 'l', 'l', 'o'};
+  const ArrayView<const uint8_t> buffers[] = {kHeader, kPayload};
+  EXPECT_EQ(7, accepted->SendVectored(buffers));
+  Thread::SleepMs(100);
+
+  char received[16];
+  ASSERT_EQ(7, client->Recv(received, sizeof(received), nullptr));
+  EXPECT_EQ(0, memcmp("\0\5hello", received, 7));
+}
+
+class SentPacketRecorder : public sigslot::has_slots<> {
+ public:
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet) {
+    sent_packet_ids.push_back(sent_packet.packet_id);
+  }
+
+  std::vector<int64_t> sent_packet_ids;
+};
+
+TEST_F(PhysicalSocketTest, BatchedUdpSendsAreWrittenOnFlush) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(AsyncUDPSocket::Create(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM),
+      SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(sender);
+  SentPacketRecorder recorder;
+  sender->SignalSentPacket.connect(&recorder, &SentPacketRecorder::OnSentPacket);
+  const std::vector<int64_t>& sent_packet_ids = recorder.sent_packet_ids;
+
+  const char kPayloads[][4] = {"abc", "def", "ghi"};
+  sender->StartSendBatch();
+  for (int i = 0; i < 3; ++i) {
+    PacketOptions options;
+    options.packet_id = i;
+    EXPECT_EQ(3, sender->SendTo(kPayloads[i], 3, receiver->GetLocalAddress(),
+                                options));
+  }
+  EXPECT_TRUE(sent_packet_ids.empty());
+  char buffer[16];
+  EXPECT_LT(receiver->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr), 0);
+
+  sender->FlushSendBatch();
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 2}), sent_packet_ids);
+  for (int i = 0; i < 3; ++i) {
+    int received = -1;
+    for (int attempt = 0; attempt < 100 && received < 0; ++attempt) {
+      received = receiver->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr);
+      if (received < 0)
+        Thread::SleepMs(1);
+    }
+    ASSERT_EQ(3, received);
+    EXPECT_EQ(0, memcmp(kPayloads[i], buffer, 3));
+  }
+}
+
 #endif
 
 }  // namespace rtc
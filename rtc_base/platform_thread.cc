@@ -19,6 +19,7 @@
 #include <algorithm>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/thread_scheduling.h"
 
 namespace rtc {
 namespace {
@@ -127,6 +128,7 @@ void PlatformThread::Run() {
   RTC_DCHECK(spawned_thread_checker_.IsCurrent());
   rtc::SetCurrentThreadName(name_.c_str());
   SetPriority(priority_);
+  ApplyThreadSchedulingConfig(name_);
   run_function_(obj_);
 }
 
@@ -15,12 +15,15 @@
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/location.h"
 #include "rtc_base/message_handler.h"
 #include "rtc_base/ref_counted_object.h"
 #include "rtc_base/ssl_identity.h"
+#include "rtc_base/time_utils.h"
 
 namespace rtc {
 
@@ -35,6 +38,38 @@ enum {
   MSG_GENERATE_DONE,
 };
 
+// The pool of certificates generated ahead of time, see
+// |RTCCertificateGenerator::SetEcdsaCertificatePoolSize|.
+GlobalLock g_pool_lock;
+size_t g_pool_size = 0;
+
+std::vector<scoped_refptr<RTCCertificate>>* PooledCertificates() {
+  static std::vector<scoped_refptr<RTCCertificate>>* const certificates =
+      new std::vector<scoped_refptr<RTCCertificate>>();
+  return certificates;
+}
+
+bool IsPooled(const KeyParams& key_params,
+              const absl::optional<uint64_t>& expires_ms) {
+  return !expires_ms && key_params.type() == KT_ECDSA &&
+         key_params.ec_curve() == EC_NIST_P256;
+}
+
+scoped_refptr<RTCCertificate> TakePooledCertificate() {
+  GlobalLockScope lock(&g_pool_lock);
+  std::vector<scoped_refptr<RTCCertificate>>* certificates =
+      PooledCertificates();
+  const uint64_t now = TimeUTCMillis();
+  while (!certificates->empty()) {
+    scoped_refptr<RTCCertificate> certificate = certificates->back();
+    certificates->pop_back();
+    if (!certificate->HasExpired(now)) {
+      return certificate;
+    }
+  }
+  return nullptr;
+}
+
 // Helper class for generating certificates asynchronously; a single task
 // instance is responsible for a single asynchronous certificate generation
 // request. We are using a separate helper class so that a generation request
@@ -54,23 +89,33 @@ class RTCCertificateGenerationTask : public RefCountInterface,
         expires_ms_(expires_ms),
         callback_(callback) {
     RTC_DCHECK(signaling_thread_);
-    RTC_DCHECK(worker_thread_);
     RTC_DCHECK(callback_);
   }
   ~RTCCertificateGenerationTask() override {}
 
+  // Generates the certificate on the current thread and posts the result to
+  // the signaling thread. |msg_data| references |this| with ref counting and
+  // is passed on to the signaling thread.
+  void Generate(MessageData* msg_data) {
+    certificate_ =
+        RTCCertificateGenerator::GenerateCertificate(key_params_, expires_ms_);
+    const bool refill_pool = IsPooled(key_params_, expires_ms_);
+    // This may result in |this| being deleted - do not touch member variables
+    // after this line.
+    signaling_thread_->Post(RTC_FROM_HERE, this, MSG_GENERATE_DONE, msg_data);
+    // Replace the pooled certificate after the result has been posted.
+    if (refill_pool) {
+      RTCCertificateGenerator::RefillCertificatePool();
+    }
+  }
+
   // Handles |MSG_GENERATE| and its follow-up |MSG_GENERATE_DONE|.
   void OnMessage(Message* msg) override {
     switch (msg->message_id) {
       case MSG_GENERATE:
-        RTC_DCHECK(worker_thread_->IsCurrent());
+        RTC_DCHECK(worker_thread_ && worker_thread_->IsCurrent());
         // Perform the certificate generation work here on the worker thread.
-        certificate_ = RTCCertificateGenerator::GenerateCertificate(
-            key_params_, expires_ms_);
-        // Handle callbacks on signaling thread. Pass on the |msg->pdata|
-        // (which references |this| with ref counting) to that thread.
-        signaling_thread_->Post(RTC_FROM_HERE, this, MSG_GENERATE_DONE,
-                                msg->pdata);
+        Generate(msg->pdata);
         break;
       case MSG_GENERATE_DONE:
         RTC_DCHECK(signaling_thread_->IsCurrent());
@@ -108,6 +153,12 @@ scoped_refptr<RTCCertificate> RTCCertificateGenerator::GenerateCertificate(
   if (!key_params.IsValid()) {
     return nullptr;
   }
+  if (IsPooled(key_params, expires_ms)) {
+    scoped_refptr<RTCCertificate> certificate = TakePooledCertificate();
+    if (certificate) {
+      return certificate;
+    }
+  }
 
   std::unique_ptr<SSLIdentity> identity;
   if (!expires_ms) {
@@ -131,6 +182,45 @@ scoped_refptr<RTCCertificate> RTCCertificateGenerator::GenerateCertificate(
   return RTCCertificate::Create(std::move(identity));
 }
 
+// static
+void RTCCertificateGenerator::SetEcdsaCertificatePoolSize(size_t size) {
+  {
+    GlobalLockScope lock(&g_pool_lock);
+    g_pool_size = size;
+    std::vector<scoped_refptr<RTCCertificate>>* certificates =
+        PooledCertificates();
+    if (certificates->size() > size) {
+      certificates->resize(size);
+    }
+  }
+  RefillCertificatePool();
+}
+
+// static
+void RTCCertificateGenerator::RefillCertificatePool() {
+  for (;;) {
+    {
+      GlobalLockScope lock(&g_pool_lock);
+      if (PooledCertificates()->size() >= g_pool_size) {
+        return;
+      }
+    }
+    // Generate outside of the lock, so that certificates can be taken from
+    // the pool meanwhile.
+    std::unique_ptr<SSLIdentity> identity =
+        SSLIdentity::Create(kIdentityName, KeyParams::ECDSA(EC_NIST_P256));
+    if (!identity) {
+      return;
+    }
+    GlobalLockScope lock(&g_pool_lock);
+    if (PooledCertificates()->size() >= g_pool_size) {
+      return;
+    }
+    PooledCertificates()->push_back(
+        RTCCertificate::Create(std::move(identity)));
+  }
+}
+
 RTCCertificateGenerator::RTCCertificateGenerator(Thread* signaling_thread,
                                                  Thread* worker_thread)
     : signaling_thread_(signaling_thread), worker_thread_(worker_thread) {
@@ -138,6 +228,20 @@ RTCCertificateGenerator::RTCCertificateGenerator(Thread* signaling_thread,
   RTC_DCHECK(worker_thread_);
 }
 
+RTCCertificateGenerator::RTCCertificateGenerator(
+    Thread* signaling_thread,
+    webrtc::TaskQueueFactory* task_queue_factory)
+    : signaling_thread_(signaling_thread),
+      worker_thread_(nullptr),
+      generation_queue_(std::make_unique<TaskQueue>(
+          task_queue_factory->CreateTaskQueue(
+              "RTCCertificateGenerator",
+              webrtc::TaskQueueFactory::Priority::LOW))) {
+  RTC_DCHECK(signaling_thread_);
+}
+
+RTCCertificateGenerator::~RTCCertificateGenerator() = default;
+
 void RTCCertificateGenerator::GenerateCertificateAsync(
     const KeyParams& key_params,
     const absl::optional<uint64_t>& expires_ms,
@@ -145,6 +249,18 @@ void RTCCertificateGenerator::GenerateCertificateAsync(
   RTC_DCHECK(signaling_thread_->IsCurrent());
   RTC_DCHECK(callback);
 
+  if (generation_queue_) {
+    scoped_refptr<RTCCertificateGenerationTask> task(
+        new RefCountedObject<RTCCertificateGenerationTask>(
+            signaling_thread_, nullptr, key_params, expires_ms, callback));
+    generation_queue_->PostTask([task] {
+      MessageData* msg_data =
+          new ScopedRefMessageData<RTCCertificateGenerationTask>(task.get());
+      task->Generate(msg_data);
+    });
+    return;
+  }
+
   // Create a new |RTCCertificateGenerationTask| for this generation request. It
   // is reference counted and referenced by the message data, ensuring it lives
   // until the task has completed (independent of |RTCCertificateGenerator|).
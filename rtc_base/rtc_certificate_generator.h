@@ -15,10 +15,12 @@
 
 #include "absl/types/optional.h"
 #include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "rtc_base/ref_count.h"
 #include "rtc_base/rtc_certificate.h"
 #include "rtc_base/ssl_identity.h"
 #include "rtc_base/system/rtc_export.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread.h"
 
 namespace rtc {
@@ -66,8 +68,26 @@ class RTC_EXPORT RTCCertificateGenerator
       const KeyParams& key_params,
       const absl::optional<uint64_t>& expires_ms);
 
+  // Keeps |size| ECDSA P-256 certificates with the default expiration time
+  // generated ahead of time in a process-wide pool. GenerateCertificate takes
+  // such certificates from the pool, if there are any, instead of generating
+  // a new key. Each pooled certificate is handed out once. The certificates
+  // taken by GenerateCertificateAsync are replaced on the worker thread after
+  // the callback has been posted. The missing certificates are generated on
+  // the current thread. A |size| of 0, the default, disables the pool.
+  static void SetEcdsaCertificatePoolSize(size_t size);
+  // Generates the certificates missing from the pool, see above.
+  static void RefillCertificatePool();
+
   RTCCertificateGenerator(Thread* signaling_thread, Thread* worker_thread);
-  ~RTCCertificateGenerator() override {}
+  // Generates certificates asynchronously on a task queue created from
+  // |task_queue_factory| instead of on a worker thread. Generators sharing a
+  // factory that runs its task queues on a thread pool generate in parallel.
+  // Generations that have not started when the generator is destroyed are
+  // dropped without invoking their callbacks.
+  RTCCertificateGenerator(Thread* signaling_thread,
+                          webrtc::TaskQueueFactory* task_queue_factory);
+  ~RTCCertificateGenerator() override;
 
   // |RTCCertificateGeneratorInterface| overrides.
   // If |expires_ms| is specified, the certificate will expire in approximately
@@ -82,6 +102,8 @@ class RTC_EXPORT RTCCertificateGenerator
  private:
   Thread* const signaling_thread_;
   Thread* const worker_thread_;
+  // Set instead of |worker_thread_| when created with a task queue factory.
+  std::unique_ptr<TaskQueue> generation_queue_;
 };
 
 }  // namespace rtc
@@ -13,9 +13,11 @@
 #include <memory>
 
 #include "absl/types/optional.h"
+#include "api/task_queue/default_task_queue_factory.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/ssl_certificate.h"
 #include "rtc_base/thread.h"
 #include "test/gtest.h"
 
@@ -34,6 +36,12 @@ class RTCCertificateGeneratorFixture : public RTCCertificateGeneratorCallback {
   }
   ~RTCCertificateGeneratorFixture() override {}
 
+  // Generates on a task queue instead of |worker_thread_|.
+  void UseTaskQueue() {
+    generator_.reset(new RTCCertificateGenerator(signaling_thread_,
+                                                 task_queue_factory_.get()));
+  }
+
   RTCCertificateGenerator* generator() const { return generator_.get(); }
   RTCCertificate* certificate() const { return certificate_.get(); }
 
@@ -62,6 +70,8 @@ class RTCCertificateGeneratorFixture : public RTCCertificateGeneratorCallback {
  protected:
   Thread* const signaling_thread_;
   std::unique_ptr<Thread> worker_thread_;
+  const std::unique_ptr<webrtc::TaskQueueFactory> task_queue_factory_ =
+      webrtc::CreateDefaultTaskQueueFactory();
   std::unique_ptr<RTCCertificateGenerator> generator_;
   scoped_refptr<RTCCertificate> certificate_;
   bool generate_async_completed_;
@@ -101,6 +111,20 @@ TEST_F(RTCCertificateGeneratorTest, GenerateAsyncECDSA) {
   EXPECT_TRUE(fixture_->certificate());
 }
 
+TEST_F(RTCCertificateGeneratorTest, GenerateAsyncOnTaskQueue) {
+  fixture_->UseTaskQueue();
+  fixture_->generator()->GenerateCertificateAsync(KeyParams::ECDSA(),
+                                                  absl::nullopt, fixture_);
+  EXPECT_FALSE(fixture_->GenerateAsyncCompleted());
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+
+  fixture_->generator()->GenerateCertificateAsync(KeyParams::RSA(0, 0),
+                                                  absl::nullopt, fixture_);
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_FALSE(fixture_->certificate());
+}
+
 TEST_F(RTCCertificateGeneratorTest, GenerateWithExpires) {
   // By generating two certificates with different expiration we can compare the
   // two expiration times relative to each other without knowing the current
@@ -141,4 +165,24 @@ TEST_F(RTCCertificateGeneratorTest, GenerateWithInvalidParamsShouldFail) {
   EXPECT_FALSE(fixture_->certificate());
 }
 
+TEST_F(RTCCertificateGeneratorTest, GenerateFromCertificatePool) {
+  RTCCertificateGenerator::SetEcdsaCertificatePoolSize(2);
+  scoped_refptr<RTCCertificate> first = RTCCertificateGenerator::
+      GenerateCertificate(KeyParams::ECDSA(), absl::nullopt);
+  scoped_refptr<RTCCertificate> second = RTCCertificateGenerator::
+      GenerateCertificate(KeyParams::ECDSA(), absl::nullopt);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  // Pooled certificates are handed out once.
+  EXPECT_NE(first->GetSSLCertificate().ToPEMString(),
+            second->GetSSLCertificate().ToPEMString());
+
+  // A certificate is generated when the pool is empty.
+  fixture_->generator()->GenerateCertificateAsync(KeyParams::ECDSA(),
+                                                  absl::nullopt, fixture_);
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  ASSERT_TRUE(fixture_->certificate());
+  RTCCertificateGenerator::SetEcdsaCertificatePoolSize(0);
+}
+
 }  // namespace rtc
@@ -10,4 +10,44 @@
 
 #include "rtc_base/socket.h"
 
-namespace rtc {}  // namespace rtc
+namespace rtc {
+
+int Socket::RecvFromBatch(ArrayView<RecvBatchEntry> entries) {
+  if (entries.empty())
+    return 0;
+  RecvBatchEntry& entry = entries[0];
+  int received = RecvFrom(entry.buffer, entry.capacity, &entry.remote_address,
+                          &entry.timestamp);
+  if (received < 0)
+    return SOCKET_ERROR;
+  entry.length = static_cast<size_t>(received);
+  entry.truncated = false;
+  return 1;
+}
+
+int Socket::SendToBatch(ArrayView<const SendBatchEntry> entries) {
+  int sent = 0;
+  for (const SendBatchEntry& entry : entries) {
+    if (SendTo(entry.data, entry.length, entry.remote_address) < 0)
+      return sent > 0 ? sent : SOCKET_ERROR;
+    ++sent;
+  }
+  return sent;
+}
+
+int Socket::SendVectored(ArrayView<const ArrayView<const uint8_t>> buffers) {
+  int sent = 0;
+  for (ArrayView<const uint8_t> buffer : buffers) {
+    if (buffer.empty())
+      continue;
+    int res = Send(buffer.data(), buffer.size());
+    if (res < 0)
+      return sent > 0 ? sent : SOCKET_ERROR;
+    sent += res;
+    if (static_cast<size_t>(res) < buffer.size())
+      break;
+  }
+  return sent;
+}
+
+}  // namespace rtc
@@ -25,6 +25,7 @@
 #include "rtc_base/win32.h"
 #endif
 
+#include "api/array_view.h"
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/socket_address.h"
 
@@ -74,6 +75,26 @@ inline bool IsBlockingError(int e) {
   return (e == EWOULDBLOCK) || (e == EAGAIN) || (e == EINPROGRESS);
 }
 
+// One slot for Socket::RecvFromBatch. |buffer| and |capacity| are provided by
+// the caller; the remaining fields are filled in for each received datagram.
+struct RecvBatchEntry {
+  char* buffer = nullptr;
+  size_t capacity = 0;
+  size_t length = 0;
+  SocketAddress remote_address;
+  // In units of microseconds, -1 if not available.
+  int64_t timestamp = -1;
+  // True if the datagram didn't fit into |buffer| and was cut off.
+  bool truncated = false;
+};
+
+// One datagram for Socket::SendToBatch.
+struct SendBatchEntry {
+  const char* data = nullptr;
+  size_t length = 0;
+  SocketAddress remote_address;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -98,6 +119,19 @@ class Socket {
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Receives up to |entries.size()| datagrams, returning the number of
+  // entries filled in, or SOCKET_ERROR. Implementations that can't drain
+  // several datagrams with one system call receive a single one.
+  virtual int RecvFromBatch(ArrayView<RecvBatchEntry> entries);
+  // Sends the datagrams in |entries| in order, returning the number of
+  // datagrams sent, or SOCKET_ERROR if the first one couldn't be sent.
+  // Implementations without a batched system call loop over SendTo.
+  virtual int SendToBatch(ArrayView<const SendBatchEntry> entries);
+  // Sends the concatenation of |buffers| on a stream socket, as one Send()
+  // of the joined data would, returning the number of bytes sent or
+  // SOCKET_ERROR. Implementations without a vectored system call loop over
+  // Send.
+  virtual int SendVectored(ArrayView<const ArrayView<const uint8_t>> buffers);
   virtual int Listen(int backlog) = 0;
   virtual Socket* Accept(SocketAddress* paddr) = 0;
   virtual int Close() = 0;
@@ -118,6 +152,9 @@ class Socket {
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
+    OPT_REUSEPORT,             // Whether other sockets may bind to the same
+                               // address and port, to share its packets. Must
+                               // be set before Bind().
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
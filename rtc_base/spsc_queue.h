@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SPSC_QUEUE_H_
+#define RTC_BASE_SPSC_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "rtc_base/constructor_magic.h"
+
+namespace rtc {
+
+// Bounded single-producer single-consumer FIFO queue. Push() and Pop() never
+// block or allocate, and may be called concurrently with each other. Callers
+// with more than one producer thread, or more than one consumer thread, have
+// to serialize their calls externally.
+template <typename T>
+class SpscQueue {
+ public:
+  // |capacity| is rounded up to a power of two.
+  explicit SpscQueue(size_t capacity)
+      : mask_(RoundUpToPowerOfTwo(capacity) - 1), slots_(new T[mask_ + 1]) {}
+
+  // Returns false, without queuing |value|, if the queue is full.
+  bool Push(T value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) > mask_)
+      return false;
+    slots_[head & mask_] = std::move(value);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns false if no element is available.
+  bool Pop(T* value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire))
+      return false;
+    *value = std::move(slots_[tail & mask_]);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t size) {
+    size_t capacity = 1;
+    while (capacity < size)
+      capacity *= 2;
+    return capacity;
+  }
+
+  const size_t mask_;
+  const std::unique_ptr<T[]> slots_;
+  // Number of elements pushed, written by the producer.
+  std::atomic<size_t> head_{0};
+  // Number of elements popped, written by the consumer.
+  std::atomic<size_t> tail_{0};
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SpscQueue);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_SPSC_QUEUE_H_
@@ -0,0 +1,97 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/spsc_queue.h"
+
+#include <memory>
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+TEST(SpscQueueTest, PopsInPushOrder) {
+  SpscQueue<int> queue(4);
+  int value = 0;
+  EXPECT_FALSE(queue.Pop(&value));
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_TRUE(queue.Push(2));
+  EXPECT_TRUE(queue.Push(3));
+  for (int expected = 1; expected <= 3; ++expected) {
+    ASSERT_TRUE(queue.Pop(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+TEST(SpscQueueTest, RejectsPushWhenFull) {
+  SpscQueue<int> queue(3);
+  EXPECT_EQ(4u, queue.capacity());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue.Push(i));
+  EXPECT_FALSE(queue.Push(4));
+
+  // Wraps around once there is room again.
+  int value = 0;
+  ASSERT_TRUE(queue.Pop(&value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(queue.Push(4));
+  for (int expected = 1; expected <= 4; ++expected) {
+    ASSERT_TRUE(queue.Pop(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+TEST(SpscQueueTest, SupportsMoveOnlyTypes) {
+  SpscQueue<std::unique_ptr<int>> queue(1);
+  EXPECT_TRUE(queue.Push(std::make_unique<int>(17)));
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_TRUE(value);
+  EXPECT_EQ(17, *value);
+}
+
+constexpr int kNumItems = 20000;
+
+void Produce(void* obj) {
+  SpscQueue<int>* queue = static_cast<SpscQueue<int>*>(obj);
+  for (int i = 0; i < kNumItems;) {
+    if (queue->Push(i)) {
+      ++i;
+    } else {
+      // Let the consumer catch up.
+      Thread::SleepMs(1);
+    }
+  }
+}
+
+TEST(SpscQueueTest, KeepsOrderWithConcurrentProducer) {
+  SpscQueue<int> queue(256);
+  PlatformThread thread(&Produce, &queue, "producer");
+  thread.Start();
+  for (int expected = 0; expected < kNumItems;) {
+    int value;
+    if (!queue.Pop(&value)) {
+      Thread::SleepMs(1);
+      continue;
+    }
+    ASSERT_EQ(expected, value);
+    ++expected;
+  }
+  thread.Stop();
+  int value;
+  EXPECT_FALSE(queue.Pop(&value));
+}
+
+}  // namespace
+}  // namespace rtc
@@ -234,6 +234,10 @@ class SSLStreamAdapter : public StreamAdapterInterface {
   // SS_OPENING but IsTlsConnected should return true.
   virtual bool IsTlsConnected() = 0;
 
+  // Returns true if the connection was established by resuming an earlier
+  // session, without a full handshake.
+  virtual bool IsResumedSession() const { return false; }
+
   // Capabilities testing.
   // Used to have "DTLS supported", "DTLS-SRTP supported" etc. methods, but now
   // that's assumed.
@@ -1630,3 +1630,84 @@ TEST_F(SSLStreamAdapterTestDTLSLegacyProtocols,
   SetupProtocolVersions(rtc::SSL_PROTOCOL_DTLS_10, rtc::SSL_PROTOCOL_DTLS_10);
   TestHandshake(false);
 }
+
+// Tests for resuming DTLS sessions between streams with the same identities.
+class SSLStreamAdapterTestDTLSSessionResumption
+    : public SSLStreamAdapterTestDTLSBase {
+ public:
+  SSLStreamAdapterTestDTLSSessionResumption()
+      : SSLStreamAdapterTestDTLSBase(rtc::KeyParams::ECDSA(rtc::EC_NIST_P256),
+                                     rtc::KeyParams::ECDSA(rtc::EC_NIST_P256)) {
+  }
+
+  // The streams are created by Connect.
+  void SetUp() override {
+    client_identity_ = rtc::SSLIdentity::Create("client", client_key_type_);
+    server_identity_ = rtc::SSLIdentity::Create("server", server_key_type_);
+  }
+
+  // Replaces the client and server streams with new ones using the identities
+  // of the fixture, and runs the handshake. The session resumption field
+  // trial is read when the streams are created.
+  void Connect() {
+    client_ssl_.reset();
+    server_ssl_.reset();
+    client_buffer_.Clear();
+    server_buffer_.Clear();
+    CreateStreams();
+    client_ssl_ =
+        rtc::SSLStreamAdapter::Create(absl::WrapUnique(client_stream_));
+    server_ssl_ =
+        rtc::SSLStreamAdapter::Create(absl::WrapUnique(server_stream_));
+    client_ssl_->SignalEvent.connect(
+        static_cast<SSLStreamAdapterTestBase*>(this),
+        &SSLStreamAdapterTestBase::OnEvent);
+    server_ssl_->SignalEvent.connect(
+        static_cast<SSLStreamAdapterTestBase*>(this),
+        &SSLStreamAdapterTestBase::OnEvent);
+    client_ssl_->SetIdentity(client_identity_->Clone());
+    server_ssl_->SetIdentity(server_identity_->Clone());
+    SetPeerIdentitiesByDigest(true, true);
+    TestHandshake();
+  }
+
+ protected:
+  std::unique_ptr<rtc::SSLIdentity> client_identity_;
+  std::unique_ptr<rtc::SSLIdentity> server_identity_;
+};
+
+TEST_F(SSLStreamAdapterTestDTLSSessionResumption, ResumesSession) {
+  webrtc::test::ScopedFieldTrials trial(
+      "WebRTC-DtlsSessionResumption/Enabled/");
+  Connect();
+  EXPECT_FALSE(client_ssl_->IsResumedSession());
+  EXPECT_FALSE(server_ssl_->IsResumedSession());
+
+  Connect();
+  EXPECT_TRUE(client_ssl_->IsResumedSession());
+  EXPECT_TRUE(server_ssl_->IsResumedSession());
+  std::unique_ptr<rtc::SSLCertChain> peer_chain =
+      client_ssl_->GetPeerSSLCertChain();
+  ASSERT_TRUE(peer_chain);
+  EXPECT_EQ(server_identity_->certificate().ToPEMString(),
+            peer_chain->Get(0).ToPEMString());
+  TestTransfer(10);
+}
+
+TEST_F(SSLStreamAdapterTestDTLSSessionResumption,
+       FullHandshakeWithNewPeerCertificate) {
+  webrtc::test::ScopedFieldTrials trial(
+      "WebRTC-DtlsSessionResumption/Enabled/");
+  Connect();
+  server_identity_ = rtc::SSLIdentity::Create("server", server_key_type_);
+  Connect();
+  EXPECT_FALSE(client_ssl_->IsResumedSession());
+  EXPECT_FALSE(server_ssl_->IsResumedSession());
+}
+
+TEST_F(SSLStreamAdapterTestDTLSSessionResumption, DisabledByDefault) {
+  Connect();
+  Connect();
+  EXPECT_FALSE(client_ssl_->IsResumedSession());
+  EXPECT_FALSE(server_ssl_->IsResumedSession());
+}
@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/system/memory_mapped_file.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace webrtc {
+namespace {
+
+rtc::CriticalSection& RegistryLock() {
+  static rtc::CriticalSection* const lock = new rtc::CriticalSection();
+  return *lock;
+}
+
+// Files that are currently mapped, by file name.
+std::map<std::string, const MemoryMappedFile*>& Registry() {
+  static auto* const registry =
+      new std::map<std::string, const MemoryMappedFile*>();
+  return *registry;
+}
+
+}  // namespace
+
+rtc::scoped_refptr<MemoryMappedFile> MemoryMappedFile::Open(
+    const std::string& file_name_utf8) {
+  rtc::CritScope lock(&RegistryLock());
+  auto it = Registry().find(file_name_utf8);
+  if (it != Registry().end()) {
+    return const_cast<MemoryMappedFile*>(it->second);
+  }
+
+#if defined(WEBRTC_POSIX)
+  const int fd = open(file_name_utf8.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0 &&
+      static_cast<uint64_t>(file_stat.st_size) <= SIZE_MAX) {
+    data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ,
+                MAP_SHARED, fd, 0);
+  }
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  rtc::scoped_refptr<MemoryMappedFile> file =
+      new MemoryMappedFile(file_name_utf8, static_cast<const uint8_t*>(data),
+                           static_cast<size_t>(file_stat.st_size));
+  Registry()[file_name_utf8] = file.get();
+  return file;
+#else
+  return nullptr;
+#endif
+}
+
+MemoryMappedFile::MemoryMappedFile(std::string file_name,
+                                   const uint8_t* data,
+                                   size_t size)
+    : file_name_(std::move(file_name)), data_(data), size_(size) {}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#if defined(WEBRTC_POSIX)
+  munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+}
+
+void MemoryMappedFile::Prefetch(size_t offset, size_t length) const {
+#if defined(WEBRTC_POSIX)
+  if (offset >= size_) {
+    return;
+  }
+  length = std::min(length, size_ - offset);
+  // madvise() needs a page aligned start address.
+  static const size_t kPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t aligned_offset = offset - offset % kPageSize;
+  madvise(const_cast<uint8_t*>(data_) + aligned_offset,
+          length + (offset - aligned_offset), MADV_WILLNEED);
+#endif
+}
+
+void MemoryMappedFile::AddRef() const {
+  rtc::CritScope lock(&RegistryLock());
+  ++ref_count_;
+}
+
+rtc::RefCountReleaseStatus MemoryMappedFile::Release() const {
+  {
+    rtc::CritScope lock(&RegistryLock());
+    RTC_DCHECK_GT(ref_count_, 0);
+    if (--ref_count_ > 0) {
+      return rtc::RefCountReleaseStatus::kOtherRefsRemained;
+    }
+    Registry().erase(file_name_);
+  }
+  delete this;
+  return rtc::RefCountReleaseStatus::kDroppedLastRef;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYSTEM_MEMORY_MAPPED_FILE_H_
+#define RTC_BASE_SYSTEM_MEMORY_MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "api/scoped_refptr.h"
+#include "rtc_base/ref_count.h"
+
+namespace webrtc {
+
+// Read-only memory mapping of a whole file. Test and replay tools that read
+// the same large file from many streams share one mapping per file instead of
+// each copying the data through their own FILE* buffers. All methods are
+// thread safe.
+class MemoryMappedFile : public rtc::RefCountInterface {
+ public:
+  // Maps the file, or returns the existing mapping if the same |file_name_utf8|
+  // is already mapped. Returns null if the file cannot be opened or mapped,
+  // if it is empty, or if memory mapping isn't supported on this platform;
+  // callers are expected to fall back to reading the file with FileWrapper.
+  static rtc::scoped_refptr<MemoryMappedFile> Open(
+      const std::string& file_name_utf8);
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Asks the OS to start reading the given range of the file in the
+  // background, so that it's in memory by the time it's accessed. Does not
+  // block. The range is clipped to the size of the file.
+  void Prefetch(size_t offset, size_t length) const;
+
+  void AddRef() const override;
+  rtc::RefCountReleaseStatus Release() const override;
+
+ private:
+  MemoryMappedFile(std::string file_name, const uint8_t* data, size_t size);
+  ~MemoryMappedFile() override;
+
+  const std::string file_name_;
+  const uint8_t* const data_;
+  const size_t size_;
+  // Guarded by the lock of the registry of open files, so that Open() can't
+  // return a mapping that is being destroyed.
+  mutable int ref_count_ = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SYSTEM_MEMORY_MAPPED_FILE_H_
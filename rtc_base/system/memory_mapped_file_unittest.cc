@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/system/memory_mapped_file.h"
+
+#include <stdio.h>
+
+#include <string>
+
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+
+class MemoryMappedFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    file_name_ = test::TempFilename(test::OutputPath(), "memory_mapped_file");
+    WriteFile("0123456789");
+  }
+  void TearDown() override { test::RemoveFile(file_name_); }
+
+  void WriteFile(const std::string& content) {
+    FILE* file = fopen(file_name_.c_str(), "wb");
+    ASSERT_TRUE(file);
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+  }
+
+  std::string file_name_;
+};
+
+TEST_F(MemoryMappedFileTest, MapsFileContent) {
+  rtc::scoped_refptr<MemoryMappedFile> file =
+      MemoryMappedFile::Open(file_name_);
+#if defined(WEBRTC_POSIX)
+  ASSERT_TRUE(file);
+  EXPECT_EQ("0123456789",
+            std::string(reinterpret_cast<const char*>(file->data()),
+                        file->size()));
+  // Prefetching is only a hint, and ranges outside the file are ignored.
+  file->Prefetch(0, file->size());
+  file->Prefetch(5, 1000);
+  file->Prefetch(1000, 10);
+#else
+  EXPECT_FALSE(file);
+#endif
+}
+
+TEST_F(MemoryMappedFileTest, SharesMappingOfSameFile) {
+  rtc::scoped_refptr<MemoryMappedFile> file1 =
+      MemoryMappedFile::Open(file_name_);
+  if (!file1)
+    return;
+  rtc::scoped_refptr<MemoryMappedFile> file2 =
+      MemoryMappedFile::Open(file_name_);
+  EXPECT_EQ(file1, file2);
+
+  // Once the last reference is gone, the file is mapped anew.
+  file1 = nullptr;
+  file2 = nullptr;
+  WriteFile("abc");
+  rtc::scoped_refptr<MemoryMappedFile> file3 =
+      MemoryMappedFile::Open(file_name_);
+  ASSERT_TRUE(file3);
+  EXPECT_EQ(3u, file3->size());
+}
+
+TEST_F(MemoryMappedFileTest, FailsForMissingOrEmptyFile) {
+  EXPECT_FALSE(MemoryMappedFile::Open(file_name_ + "_missing"));
+  WriteFile("");
+  EXPECT_FALSE(MemoryMappedFile::Open(file_name_));
+}
+
+}  // namespace webrtc
@@ -0,0 +1,513 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_queue_pool.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/queued_task.h"
+#include "api/task_queue/task_queue_base.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/ref_counter.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_base/timer_wheel.h"
+
+namespace webrtc {
+namespace {
+
+// A task queue with many pending tasks yields its worker after this many, so
+// that the other task queues scheduled on the worker are not starved.
+constexpr int kMaxTasksPerTurn = 8;
+
+constexpr int64_t kNoDelayedTasks = std::numeric_limits<int64_t>::max();
+
+rtc::ThreadPriority TaskQueuePriorityToThreadPriority(
+    TaskQueueFactory::Priority priority) {
+  switch (priority) {
+    case TaskQueueFactory::Priority::HIGH:
+      return rtc::kRealtimePriority;
+    case TaskQueueFactory::Priority::LOW:
+      return rtc::kLowPriority;
+    case TaskQueueFactory::Priority::NORMAL:
+      return rtc::kNormalPriority;
+    default:
+      RTC_NOTREACHED();
+      return rtc::kNormalPriority;
+  }
+}
+
+class WorkerPool;
+
+class PooledTaskQueue final : public TaskQueueBase {
+ public:
+  PooledTaskQueue(WorkerPool* pool, size_t worker_index);
+
+  void Delete() override;
+  void PostTask(std::unique_ptr<QueuedTask> task) override;
+  void PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                       uint32_t milliseconds) override;
+
+  // The owner holds one reference until Delete(). While the task queue is
+  // scheduled on a worker, the worker holds another, and so does every
+  // pending delayed task.
+  void AddRef() { ref_count_.IncRef(); }
+  void Release() {
+    if (ref_count_.DecRef() == rtc::RefCountReleaseStatus::kDroppedLastRef)
+      delete this;
+  }
+
+  // Runs up to |kMaxTasksPerTurn| pending tasks on the calling worker. Returns
+  // true if tasks remain, in which case the task queue stays scheduled and
+  // the caller must schedule it again; otherwise the caller must drop its
+  // reference.
+  bool RunTasks(size_t worker_index);
+
+ private:
+  ~PooledTaskQueue() override;
+
+  WorkerPool* const pool_;
+  webrtc_impl::RefCounter ref_count_{1};
+
+  // Signaled when a task finishes running after Delete() was called.
+  rtc::Event stopped_;
+
+  rtc::CriticalSection lock_;
+  std::deque<std::unique_ptr<QueuedTask>> tasks_ RTC_GUARDED_BY(lock_);
+  // Whether the task queue is in the run queue of a worker, or running on one.
+  bool scheduled_ RTC_GUARDED_BY(lock_) = false;
+  bool running_ RTC_GUARDED_BY(lock_) = false;
+  bool deleted_ RTC_GUARDED_BY(lock_) = false;
+  // The worker the task queue is scheduled on next; the worker it last ran on,
+  // so that its data tends to stay in that worker's cache.
+  size_t worker_index_ RTC_GUARDED_BY(lock_);
+};
+
+// Each worker has its own run queue of scheduled task queues. A worker runs
+// the task queues in its own run queue in FIFO order, and when that is empty
+// steals the most recently scheduled task queue of another worker. Delayed
+// tasks are kept in a shared timer wheel and posted to their task queue when
+// they expire, by whichever worker notices first; one of the idle workers
+// sleeps until the next one expires.
+class WorkerPool {
+ public:
+  WorkerPool(size_t num_threads, rtc::ThreadPriority priority);
+  ~WorkerPool();
+
+  // Spreads new task queues over the workers.
+  size_t NextWorkerIndex();
+
+  // Adds |queue| to the run queue of the worker at |worker_index|, handing
+  // over a reference to it.
+  void Schedule(PooledTaskQueue* queue, size_t worker_index);
+
+  void PostDelayedTask(PooledTaskQueue* queue,
+                       std::unique_ptr<QueuedTask> task,
+                       uint32_t milliseconds);
+  // Destroys the pending delayed tasks of |queue|.
+  void RemoveDelayedTasks(PooledTaskQueue* queue);
+
+ private:
+  struct Worker {
+    Worker(WorkerPool* pool, size_t index, rtc::ThreadPriority priority);
+
+    WorkerPool* const pool;
+    const size_t index;
+    // Signaled when the worker is taken out of |idle_workers_|.
+    rtc::Event wake;
+    rtc::CriticalSection lock;
+    std::deque<PooledTaskQueue*> run_queue RTC_GUARDED_BY(lock);
+    rtc::PlatformThread thread;
+  };
+
+  struct DelayedTask {
+    rtc::scoped_refptr<PooledTaskQueue> queue;
+    std::unique_ptr<QueuedTask> task;
+  };
+  using DelayedQueue = rtc::TimerWheel<DelayedTask>;
+
+  static void ThreadMain(void* context);
+  void Run(Worker* worker);
+
+  // Takes a task queue, and its reference, off the run queue of the worker at
+  // |worker_index|, or else off the run queue of another worker.
+  PooledTaskQueue* TakeTaskQueue(size_t worker_index);
+  // Posts the delayed tasks that are due. Returns false if there were none.
+  bool PostExpiredDelayedTasks();
+  void UpdateNextDelayedTaskTime() RTC_EXCLUSIVE_LOCKS_REQUIRED(delayed_lock_);
+
+  // Wakes |preferred| if it is idle, or else another idle worker, if any.
+  void WakeIdleWorker(Worker* preferred);
+  void RemoveIdleWorker(Worker* worker)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(idle_lock_);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_worker_index_{0};
+
+  // The number of task queues in run queues, and the number of idle workers.
+  // A worker only goes to sleep after registering as idle and then seeing no
+  // scheduled task queues, while a task queue is scheduled before checking for
+  // idle workers, so a wake-up can't be lost.
+  std::atomic<int> num_scheduled_{0};
+  std::atomic<int> num_idle_{0};
+  // Lower bound of the time of the next delayed task, or |kNoDelayedTasks|.
+  std::atomic<int64_t> next_delayed_task_ms_{kNoDelayedTasks};
+
+  rtc::CriticalSection idle_lock_;
+  bool stopping_ RTC_GUARDED_BY(idle_lock_) = false;
+  std::vector<Worker*> idle_workers_ RTC_GUARDED_BY(idle_lock_);
+  // The idle worker that sleeps until the next delayed task is due.
+  Worker* timer_worker_ RTC_GUARDED_BY(idle_lock_) = nullptr;
+
+  rtc::CriticalSection delayed_lock_;
+  uint64_t delayed_order_ RTC_GUARDED_BY(delayed_lock_) = 0;
+  DelayedQueue delayed_tasks_ RTC_GUARDED_BY(delayed_lock_);
+};
+
+PooledTaskQueue::PooledTaskQueue(WorkerPool* pool, size_t worker_index)
+    : pool_(pool),
+      stopped_(/*manual_reset=*/false, /*initially_signaled=*/false),
+      worker_index_(worker_index) {}
+
+PooledTaskQueue::~PooledTaskQueue() {
+  RTC_DCHECK(deleted_);
+  RTC_DCHECK(!scheduled_);
+}
+
+void PooledTaskQueue::Delete() {
+  RTC_DCHECK(!IsCurrent());
+
+  std::deque<std::unique_ptr<QueuedTask>> tasks;
+  bool wait_for_running_task;
+  {
+    rtc::CritScope lock(&lock_);
+    deleted_ = true;
+    tasks.swap(tasks_);
+    wait_for_running_task = running_;
+  }
+  pool_->RemoveDelayedTasks(this);
+
+  if (wait_for_running_task)
+    stopped_.Wait(rtc::Event::kForever);
+  // Pending tasks are destroyed here, outside of |lock_|, since they may post
+  // tasks themselves.
+  tasks.clear();
+  Release();
+}
+
+void PooledTaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+  size_t worker_index;
+  {
+    rtc::CritScope lock(&lock_);
+    if (deleted_)
+      return;
+    tasks_.push_back(std::move(task));
+    if (scheduled_)
+      return;
+    scheduled_ = true;
+    worker_index = worker_index_;
+    AddRef();
+  }
+  pool_->Schedule(this, worker_index);
+}
+
+void PooledTaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                      uint32_t milliseconds) {
+  pool_->PostDelayedTask(this, std::move(task), milliseconds);
+}
+
+bool PooledTaskQueue::RunTasks(size_t worker_index) {
+  for (int i = 0; i < kMaxTasksPerTurn; ++i) {
+    std::unique_ptr<QueuedTask> task;
+    {
+      rtc::CritScope lock(&lock_);
+      if (deleted_ || tasks_.empty()) {
+        scheduled_ = false;
+        return false;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      running_ = true;
+      worker_index_ = worker_index;
+    }
+
+    {
+      CurrentTaskQueueSetter set_current(this);
+      QueuedTask* release_ptr = task.release();
+      if (release_ptr->Run())
+        delete release_ptr;
+    }
+
+    bool deleted;
+    {
+      rtc::CritScope lock(&lock_);
+      running_ = false;
+      deleted = deleted_;
+    }
+    if (deleted)
+      stopped_.Set();
+  }
+
+  rtc::CritScope lock(&lock_);
+  if (deleted_ || tasks_.empty()) {
+    scheduled_ = false;
+    return false;
+  }
+  return true;
+}
+
+WorkerPool::Worker::Worker(WorkerPool* pool,
+                           size_t index,
+                           rtc::ThreadPriority priority)
+    : pool(pool),
+      index(index),
+      wake(/*manual_reset=*/false, /*initially_signaled=*/false),
+      thread(&WorkerPool::ThreadMain, this, "TaskQueuePool", priority) {}
+
+WorkerPool::WorkerPool(size_t num_threads, rtc::ThreadPriority priority) {
+  RTC_DCHECK_GT(num_threads, 0);
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i)
+    workers_.push_back(std::make_unique<Worker>(this, i, priority));
+  // Workers steal from each other, so all of them must exist before any of
+  // them starts.
+  for (auto& worker : workers_)
+    worker->thread.Start();
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    rtc::CritScope lock(&idle_lock_);
+    stopping_ = true;
+  }
+  // Workers only stop once they run out of scheduled task queues, so that the
+  // references held by run queues of deleted task queues are dropped.
+  for (auto& worker : workers_)
+    worker->wake.Set();
+  for (auto& worker : workers_)
+    worker->thread.Stop();
+}
+
+size_t WorkerPool::NextWorkerIndex() {
+  return next_worker_index_.fetch_add(1, std::memory_order_relaxed) %
+         workers_.size();
+}
+
+void WorkerPool::Schedule(PooledTaskQueue* queue, size_t worker_index) {
+  Worker* worker = workers_[worker_index].get();
+  {
+    rtc::CritScope lock(&worker->lock);
+    worker->run_queue.push_back(queue);
+  }
+  num_scheduled_.fetch_add(1);
+  if (num_idle_.load() > 0)
+    WakeIdleWorker(worker);
+}
+
+void WorkerPool::PostDelayedTask(PooledTaskQueue* queue,
+                                 std::unique_ptr<QueuedTask> task,
+                                 uint32_t milliseconds) {
+  int64_t now = rtc::TimeMillis();
+  bool earliest;
+  {
+    rtc::CritScope lock(&delayed_lock_);
+    delayed_tasks_.Insert(now, now + milliseconds, delayed_order_++,
+                          DelayedTask{queue, std::move(task)});
+    int64_t previous = next_delayed_task_ms_.load();
+    UpdateNextDelayedTaskTime();
+    earliest = next_delayed_task_ms_.load() < previous;
+  }
+  if (!earliest || num_idle_.load() == 0)
+    return;
+
+  Worker* timer_worker;
+  {
+    rtc::CritScope lock(&idle_lock_);
+    timer_worker = timer_worker_;
+  }
+  // The timer worker, if any, has to recompute how long to sleep.
+  WakeIdleWorker(timer_worker);
+}
+
+void WorkerPool::RemoveDelayedTasks(PooledTaskQueue* queue) {
+  std::vector<DelayedQueue::Entry> removed;
+  {
+    rtc::CritScope lock(&delayed_lock_);
+    delayed_tasks_.RemoveIf(
+        [queue](const DelayedTask& delayed) { return delayed.queue == queue; },
+        &removed);
+    UpdateNextDelayedTaskTime();
+  }
+  // |removed| is destroyed outside of |delayed_lock_|, since destroying the
+  // tasks may post tasks, and dropping the references may delete task queues.
+}
+
+void WorkerPool::ThreadMain(void* context) {
+  Worker* worker = static_cast<Worker*>(context);
+  worker->pool->Run(worker);
+}
+
+void WorkerPool::Run(Worker* worker) {
+  while (true) {
+    if (PooledTaskQueue* queue = TakeTaskQueue(worker->index)) {
+      if (queue->RunTasks(worker->index)) {
+        Schedule(queue, worker->index);
+      } else {
+        queue->Release();
+      }
+      // Busy workers post expired delayed tasks too, so that they are not
+      // delayed until a worker goes idle.
+      PostExpiredDelayedTasks();
+      continue;
+    }
+    if (PostExpiredDelayedTasks())
+      continue;
+
+    int wait_ms = rtc::Event::kForever;
+    {
+      rtc::CritScope lock(&idle_lock_);
+      if (stopping_)
+        return;
+      idle_workers_.push_back(worker);
+      num_idle_.fetch_add(1);
+      if (num_scheduled_.load() > 0) {
+        RemoveIdleWorker(worker);
+        continue;
+      }
+      int64_t next_delayed_task_ms = next_delayed_task_ms_.load();
+      if (next_delayed_task_ms != kNoDelayedTasks && !timer_worker_) {
+        int64_t delay_ms = next_delayed_task_ms - rtc::TimeMillis();
+        if (delay_ms <= 0) {
+          RemoveIdleWorker(worker);
+          continue;
+        }
+        timer_worker_ = worker;
+        wait_ms = static_cast<int>(
+            std::min<int64_t>(delay_ms, std::numeric_limits<int>::max()));
+      }
+    }
+
+    worker->wake.Wait(wait_ms);
+
+    rtc::CritScope lock(&idle_lock_);
+    RemoveIdleWorker(worker);
+  }
+}
+
+PooledTaskQueue* WorkerPool::TakeTaskQueue(size_t worker_index) {
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker* worker = workers_[(worker_index + i) % workers_.size()].get();
+    PooledTaskQueue* queue = nullptr;
+    {
+      rtc::CritScope lock(&worker->lock);
+      if (worker->run_queue.empty())
+        continue;
+      if (i == 0) {
+        queue = worker->run_queue.front();
+        worker->run_queue.pop_front();
+      } else {
+        queue = worker->run_queue.back();
+        worker->run_queue.pop_back();
+      }
+    }
+    num_scheduled_.fetch_sub(1);
+    return queue;
+  }
+  return nullptr;
+}
+
+bool WorkerPool::PostExpiredDelayedTasks() {
+  int64_t now = rtc::TimeMillis();
+  if (now < next_delayed_task_ms_.load(std::memory_order_relaxed))
+    return false;
+
+  std::vector<DelayedQueue::Entry> expired;
+  {
+    rtc::CritScope lock(&delayed_lock_);
+    delayed_tasks_.PopExpired(now, &expired);
+    UpdateNextDelayedTaskTime();
+  }
+  // Entries are in firing order, so delayed tasks for the same task queue are
+  // posted in the order they are due.
+  for (DelayedQueue::Entry& entry : expired)
+    entry.value.queue->PostTask(std::move(entry.value.task));
+  return !expired.empty();
+}
+
+void WorkerPool::UpdateNextDelayedTaskTime() {
+  next_delayed_task_ms_.store(
+      delayed_tasks_.NextWakeUpMs().value_or(kNoDelayedTasks));
+}
+
+void WorkerPool::WakeIdleWorker(Worker* preferred) {
+  Worker* worker = nullptr;
+  {
+    rtc::CritScope lock(&idle_lock_);
+    if (idle_workers_.empty())
+      return;
+    auto it =
+        std::find(idle_workers_.begin(), idle_workers_.end(), preferred);
+    worker = it != idle_workers_.end() ? *it : idle_workers_.back();
+    RemoveIdleWorker(worker);
+  }
+  worker->wake.Set();
+}
+
+void WorkerPool::RemoveIdleWorker(Worker* worker) {
+  auto it = std::find(idle_workers_.begin(), idle_workers_.end(), worker);
+  if (it != idle_workers_.end()) {
+    idle_workers_.erase(it);
+    num_idle_.fetch_sub(1);
+  }
+  if (timer_worker_ == worker)
+    timer_worker_ = nullptr;
+}
+
+class TaskQueuePoolFactory final : public TaskQueueFactory {
+ public:
+  TaskQueuePoolFactory(size_t num_threads, rtc::ThreadPriority priority)
+      : pool_(std::make_unique<WorkerPool>(num_threads, priority)) {}
+  ~TaskQueuePoolFactory() override = default;
+
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateTaskQueue(
+      absl::string_view name,
+      Priority priority) const override {
+    return std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(
+        new PooledTaskQueue(pool_.get(), pool_->NextWorkerIndex()));
+  }
+
+ private:
+  // Task queues are created by a const method, but share the pool.
+  const std::unique_ptr<WorkerPool> pool_;
+};
+
+}  // namespace
+
+std::unique_ptr<TaskQueueFactory> CreateTaskQueuePoolFactory(
+    size_t num_threads,
+    TaskQueueFactory::Priority priority) {
+  return std::make_unique<TaskQueuePoolFactory>(
+      num_threads, TaskQueuePriorityToThreadPriority(priority));
+}
+
+}  // namespace webrtc
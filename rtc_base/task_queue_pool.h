@@ -0,0 +1,37 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef RTC_BASE_TASK_QUEUE_POOL_H_
+#define RTC_BASE_TASK_QUEUE_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "api/task_queue/task_queue_factory.h"
+
+namespace webrtc {
+
+// Creates a factory whose task queues all run on a fixed pool of
+// |num_threads| threads, instead of getting a thread each. Tasks posted to the
+// same task queue still run one at a time and in posting order, but an idle
+// thread steals task queues from busy ones, so that many mostly idle queues,
+// such as the decode queues of video receive streams, need neither a thread
+// each nor wait behind each other. A task queue keeps to the thread it last ran
+// on as long as that thread has no backlog.
+//
+// The threads run with |priority|; the priority passed to CreateTaskQueue() is
+// ignored. All task queues must be deleted before the factory.
+std::unique_ptr<TaskQueueFactory> CreateTaskQueuePoolFactory(
+    size_t num_threads,
+    TaskQueueFactory::Priority priority = TaskQueueFactory::Priority::NORMAL);
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_TASK_QUEUE_POOL_H_
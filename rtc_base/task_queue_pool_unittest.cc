@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_queue_pool.h"
+
+#include <memory>
+#include <vector>
+
+#include "api/task_queue/task_queue_test.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_utils/to_queued_task.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kWaitMs = 1000;
+
+std::unique_ptr<TaskQueueFactory> CreateSingleThreadPoolFactory() {
+  return CreateTaskQueuePoolFactory(1);
+}
+
+std::unique_ptr<TaskQueueFactory> CreateTwoThreadPoolFactory() {
+  return CreateTaskQueuePoolFactory(2);
+}
+
+INSTANTIATE_TEST_SUITE_P(Pool,
+                         TaskQueueTest,
+                         ::testing::Values(CreateSingleThreadPoolFactory,
+                                           CreateTwoThreadPoolFactory));
+
+std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateQueue(
+    const TaskQueueFactory& factory) {
+  return factory.CreateTaskQueue("queue", TaskQueueFactory::Priority::NORMAL);
+}
+
+TEST(TaskQueuePoolTest, RunsTasksOfEachQueueInPostingOrder) {
+  constexpr int kNumQueues = 16;
+  constexpr int kNumTasks = 200;
+  // Declared before the task queues, which are deleted first.
+  std::vector<std::vector<int>> runs(kNumQueues);
+  rtc::Event done;
+  rtc::CriticalSection done_lock;
+  int num_done = 0;
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePoolFactory(2);
+  std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> queues;
+  for (int q = 0; q < kNumQueues; ++q)
+    queues.push_back(CreateQueue(*factory));
+
+  for (int i = 0; i < kNumTasks; ++i) {
+    for (int q = 0; q < kNumQueues; ++q) {
+      TaskQueueBase* queue = queues[q].get();
+      std::vector<int>* run = &runs[q];
+      queue->PostTask(ToQueuedTask([&, queue, run, i] {
+        EXPECT_TRUE(queue->IsCurrent());
+        run->push_back(i);
+        if (i + 1 == kNumTasks) {
+          rtc::CritScope lock(&done_lock);
+          if (++num_done == kNumQueues)
+            done.Set();
+        }
+      }));
+    }
+  }
+
+  ASSERT_TRUE(done.Wait(kWaitMs));
+  for (const std::vector<int>& run : runs) {
+    ASSERT_EQ(run.size(), static_cast<size_t>(kNumTasks));
+    for (int i = 0; i < kNumTasks; ++i)
+      EXPECT_EQ(run[i], i);
+  }
+}
+
+TEST(TaskQueuePoolTest, IdleThreadStealsQueueFromBusyThread) {
+  rtc::Event stolen_ran;
+  rtc::Event blocked_done;
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePoolFactory(2);
+  // Queues are spread round-robin, so |blocked| and |stolen| start out on the
+  // same thread.
+  auto blocked = CreateQueue(*factory);
+  auto other = CreateQueue(*factory);
+  auto stolen = CreateQueue(*factory);
+
+  blocked->PostTask(ToQueuedTask([&] {
+    EXPECT_TRUE(stolen_ran.Wait(kWaitMs));
+    blocked_done.Set();
+  }));
+  stolen->PostTask(ToQueuedTask([&] { stolen_ran.Set(); }));
+
+  EXPECT_TRUE(blocked_done.Wait(2 * kWaitMs));
+}
+
+TEST(TaskQueuePoolTest, SingleThreadRunsQueuesOneAtATime) {
+  bool first_running = false;
+  rtc::Event done;
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePoolFactory(1);
+  auto first = CreateQueue(*factory);
+  auto second = CreateQueue(*factory);
+
+  first->PostTask(ToQueuedTask([&] {
+    first_running = true;
+    // |second| can't run until this task has returned.
+    EXPECT_FALSE(done.Wait(50));
+    first_running = false;
+  }));
+  second->PostTask(ToQueuedTask([&] {
+    EXPECT_FALSE(first_running);
+    done.Set();
+  }));
+
+  EXPECT_TRUE(done.Wait(kWaitMs));
+}
+
+TEST(TaskQueuePoolTest, DeleteDropsPendingDelayedTasks) {
+  rtc::Event deleted;
+  bool ran = false;
+  std::unique_ptr<TaskQueueFactory> factory = CreateTaskQueuePoolFactory(2);
+  auto queue = CreateQueue(*factory);
+
+  queue->PostDelayedTask(ToQueuedTask([&] { ran = true; }, [&] {
+                           deleted.Set();
+                         }),
+                         /*milliseconds=*/100000);
+  queue = nullptr;
+
+  EXPECT_TRUE(deleted.Wait(0));
+  EXPECT_FALSE(ran);
+}
+
+}  // namespace
+}  // namespace webrtc
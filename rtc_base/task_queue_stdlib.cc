@@ -13,12 +13,13 @@
 #include <string.h>
 
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <queue>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "api/task_queue/queued_task.h"
 #include "api/task_queue/task_queue_base.h"
 #include "rtc_base/checks.h"
@@ -28,6 +29,7 @@
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/time_utils.h"
+#include "rtc_base/timer_wheel.h"
 
 namespace webrtc {
 namespace {
@@ -59,16 +61,7 @@ class TaskQueueStdlib final : public TaskQueueBase {
 
  private:
   using OrderId = uint64_t;
-
-  struct DelayedEntryTimeout {
-    int64_t next_fire_at_ms_{};
-    OrderId order_{};
-
-    bool operator<(const DelayedEntryTimeout& o) const {
-      return std::tie(next_fire_at_ms_, order_) <
-             std::tie(o.next_fire_at_ms_, o.order_);
-    }
-  };
+  using DelayedQueue = rtc::TimerWheel<std::unique_ptr<QueuedTask>>;
 
   struct NextTask {
     bool final_task_{false};
@@ -114,11 +107,15 @@ class TaskQueueStdlib final : public TaskQueueBase {
   // The list of all pending tasks that need to be processed at a future
   // time based upon a delay. On the off change the delayed task should
   // happen at exactly the same time interval as another task then the
-  // task is processed based on FIFO ordering. std::priority_queue was
-  // considered but rejected due to its inability to extract the
-  // std::unique_ptr out of the queue without the presence of a hack.
-  std::map<DelayedEntryTimeout, std::unique_ptr<QueuedTask>> delayed_queue_
+  // task is processed based on FIFO ordering. A timer wheel keeps inserts
+  // O(1) when many repeating tasks are live.
+  DelayedQueue delayed_queue_ RTC_GUARDED_BY(pending_lock_);
+
+  // Delayed tasks that are due, in firing order, starting at
+  // |next_expired_delayed_|.
+  std::vector<DelayedQueue::Entry> expired_delayed_
       RTC_GUARDED_BY(pending_lock_);
+  size_t next_expired_delayed_ RTC_GUARDED_BY(pending_lock_) = 0;
 };
 
 TaskQueueStdlib::TaskQueueStdlib(absl::string_view queue_name,
@@ -160,15 +157,13 @@ void TaskQueueStdlib::PostTask(std::unique_ptr<QueuedTask> task) {
 
 void TaskQueueStdlib::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                       uint32_t milliseconds) {
-  auto fire_at = rtc::TimeMillis() + milliseconds;
-
-  DelayedEntryTimeout delay;
-  delay.next_fire_at_ms_ = fire_at;
+  auto now = rtc::TimeMillis();
+  auto fire_at = now + milliseconds;
 
   {
     rtc::CritScope lock(&pending_lock_);
-    delay.order_ = ++thread_posting_order_;
-    delayed_queue_[delay] = std::move(task);
+    OrderId order = ++thread_posting_order_;
+    delayed_queue_.Insert(now, fire_at, order, std::move(task));
   }
 
   NotifyWake();
@@ -186,28 +181,31 @@ TaskQueueStdlib::NextTask TaskQueueStdlib::GetNextTask() {
     return result;
   }
 
-  if (delayed_queue_.size() > 0) {
-    auto delayed_entry = delayed_queue_.begin();
-    const auto& delay_info = delayed_entry->first;
-    auto& delay_run = delayed_entry->second;
-    if (tick >= delay_info.next_fire_at_ms_) {
-      if (pending_queue_.size() > 0) {
-        auto& entry = pending_queue_.front();
-        auto& entry_order = entry.first;
-        auto& entry_run = entry.second;
-        if (entry_order < delay_info.order_) {
-          result.run_task_ = std::move(entry_run);
-          pending_queue_.pop();
-          return result;
-        }
+  delayed_queue_.PopExpired(tick, &expired_delayed_);
+  if (next_expired_delayed_ < expired_delayed_.size()) {
+    auto& delayed_entry = expired_delayed_[next_expired_delayed_];
+    if (pending_queue_.size() > 0) {
+      auto& entry = pending_queue_.front();
+      auto& entry_order = entry.first;
+      auto& entry_run = entry.second;
+      if (entry_order < delayed_entry.order) {
+        result.run_task_ = std::move(entry_run);
+        pending_queue_.pop();
+        return result;
       }
+    }
 
-      result.run_task_ = std::move(delay_run);
-      delayed_queue_.erase(delayed_entry);
-      return result;
+    result.run_task_ = std::move(delayed_entry.value);
+    if (++next_expired_delayed_ == expired_delayed_.size()) {
+      expired_delayed_.clear();
+      next_expired_delayed_ = 0;
     }
+    return result;
+  }
 
-    result.sleep_time_ms_ = delay_info.next_fire_at_ms_ - tick;
+  absl::optional<int64_t> next_wake_up = delayed_queue_.NextWakeUpMs();
+  if (next_wake_up) {
+    result.sleep_time_ms_ = std::max<int64_t>(*next_wake_up - tick, 1);
   }
 
   if (pending_queue_.size() > 0) {
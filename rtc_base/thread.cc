@@ -26,15 +26,19 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/types/optional.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/critical_section.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/null_socket_server.h"
 #include "rtc_base/task_utils/to_queued_task.h"
+#include "rtc_base/thread_scheduling.h"
 #include "rtc_base/time_utils.h"
 #include "rtc_base/trace_event.h"
 
@@ -468,17 +472,21 @@ bool Thread::Get(Message* pmsg, int cmsWait, bool process_io) {
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!delayed_messages_.empty()) {
-            if (msCurrent < delayed_messages_.top().run_time_ms_) {
-              cmsDelayNext =
-                  TimeDiff(delayed_messages_.top().run_time_ms_, msCurrent);
-              break;
-            }
-            messages_.push_back(delayed_messages_.top().msg_);
-            delayed_messages_.pop();
+          DrainInbox();
+          delayed_messages_.PopExpired(msCurrent, &expired_delayed_messages_);
+          for (const auto& entry : expired_delayed_messages_)
+            messages_.push_back(entry.value);
+          expired_delayed_messages_.clear();
+          absl::optional<int64_t> next_wake_up =
+              delayed_messages_.NextWakeUpMs();
+          if (next_wake_up) {
+            cmsDelayNext =
+                std::max<int64_t>(0, TimeDiff(*next_wake_up, msCurrent));
           }
         }
         // Pull a message off the message queue, if available.
+        if (messages_.empty())
+          DrainInbox();
         if (messages_.empty()) {
           break;
         } else {
@@ -544,18 +552,33 @@ void Thread::Post(const Location& posted_from,
   // Add the message to the end of the queue
   // Signal for the multiplexer to return
 
-  {
+  Message msg;
+  msg.posted_from = posted_from;
+  msg.phandler = phandler;
+  msg.message_id = id;
+  msg.pdata = pdata;
+  if (lock_free_posting_.load(std::memory_order_acquire)) {
+    inbox_.Push(msg);
+  } else {
     CritScope cs(&crit_);
-    Message msg;
-    msg.posted_from = posted_from;
-    msg.phandler = phandler;
-    msg.message_id = id;
-    msg.pdata = pdata;
     messages_.push_back(msg);
   }
   WakeUpSocketServer();
 }
 
+void Thread::SetLockFreePosting(bool enabled) {
+  CritScope cs(&crit_);
+  lock_free_posting_.store(enabled, std::memory_order_release);
+  if (!enabled)
+    DrainInbox();
+}
+
+void Thread::DrainInbox() {
+  Message msg;
+  while (inbox_.Pop(&msg))
+    messages_.push_back(msg);
+}
+
 void Thread::PostDelayed(const Location& posted_from,
                          int delay_ms,
                          MessageHandler* phandler,
@@ -596,25 +619,22 @@ void Thread::DoDelayPost(const Location& posted_from,
     msg.phandler = phandler;
     msg.message_id = id;
     msg.pdata = pdata;
-    DelayedMessage delayed(delay_ms, run_at_ms, delayed_next_num_, msg);
-    delayed_messages_.push(delayed);
-    // If this message queue processes 1 message every millisecond for 50 days,
-    // we will wrap this number.  Even then, only messages with identical times
-    // will be misordered, and then only briefly.  This is probably ok.
+    delayed_messages_.Insert(TimeMillis(), run_at_ms, delayed_next_num_, msg);
     ++delayed_next_num_;
-    RTC_DCHECK_NE(0, delayed_next_num_);
   }
   WakeUpSocketServer();
 }
 
 int Thread::GetDelay() {
   CritScope cs(&crit_);
+  DrainInbox();
 
   if (!messages_.empty())
     return 0;
 
-  if (!delayed_messages_.empty()) {
-    int delay = TimeUntil(delayed_messages_.top().run_time_ms_);
+  absl::optional<int64_t> next_wake_up = delayed_messages_.NextWakeUpMs();
+  if (next_wake_up) {
+    int delay = TimeUntil(*next_wake_up);
     if (delay < 0)
       delay = 0;
     return delay;
@@ -639,6 +659,7 @@ void Thread::ClearInternal(MessageHandler* phandler,
 
   // Remove from ordered message queue
 
+  DrainInbox();
   for (auto it = messages_.begin(); it != messages_.end();) {
     if (it->Match(phandler, id)) {
       if (removed) {
@@ -652,23 +673,19 @@ void Thread::ClearInternal(MessageHandler* phandler,
     }
   }
 
-  // Remove from priority queue. Not directly iterable, so use this approach
+  // Remove from delayed messages
 
-  auto new_end = delayed_messages_.container().begin();
-  for (auto it = new_end; it != delayed_messages_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
-      }
+  std::vector<DelayedMessageQueue::Entry> removed_delayed;
+  delayed_messages_.RemoveIf(
+      [phandler, id](const Message& msg) { return msg.Match(phandler, id); },
+      &removed_delayed);
+  for (const auto& entry : removed_delayed) {
+    if (removed) {
+      removed->push_back(entry.value);
     } else {
-      *new_end++ = *it;
+      delete entry.value.pdata;
     }
   }
-  delayed_messages_.container().erase(new_end,
-                                      delayed_messages_.container().end());
-  delayed_messages_.reheap();
 }
 
 void Thread::Dispatch(Message* pmsg) {
@@ -839,6 +856,7 @@ void* Thread::PreRun(void* pv) {
   Thread* thread = static_cast<Thread*>(pv);
   ThreadManager::Instance()->SetCurrentThread(thread);
   rtc::SetCurrentThreadName(thread->name_.c_str());
+  ApplyThreadSchedulingConfig(thread->name_);
 #if defined(WEBRTC_MAC)
   ScopedAutoReleasePool pool;
 #endif
@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
@@ -32,11 +33,13 @@
 #include "rtc_base/critical_section.h"
 #include "rtc_base/location.h"
 #include "rtc_base/message_handler.h"
+#include "rtc_base/mpsc_queue.h"
 #include "rtc_base/platform_thread_types.h"
 #include "rtc_base/socket_server.h"
 #include "rtc_base/system/rtc_export.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_message.h"
+#include "rtc_base/timer_wheel.h"
 
 #if defined(WEBRTC_WIN)
 #include "rtc_base/win32.h"
@@ -266,9 +269,17 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
   bool empty() const { return size() == 0u; }
   size_t size() const {
     CritScope cs(&crit_);
-    return messages_.size() + delayed_messages_.size() + (fPeekKeep_ ? 1u : 0u);
+    return messages_.size() + inbox_.size() + delayed_messages_.size() +
+           (fPeekKeep_ ? 1u : 0u);
   }
 
+  // When enabled, Post() and PostTask() of immediate messages push onto a
+  // lock-free queue instead of taking the thread's lock, which avoids lock
+  // contention when many threads post to this one. The queue is drained into
+  // the regular message list by the thread itself. Delivery order of
+  // immediate messages is unchanged. May be called at any time.
+  void SetLockFreePosting(bool enabled);
+
   // Internally posts a message which causes the doomed object to be deleted
   template <class T>
   void Dispose(T* doomed) {
@@ -451,38 +462,10 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
     rtc::Thread* const previous_;
   };
 
-  // DelayedMessage goes into a priority queue, sorted by trigger time. Messages
-  // with the same trigger time are processed in num_ (FIFO) order.
-  class DelayedMessage {
-   public:
-    DelayedMessage(int64_t delay,
-                   int64_t run_time_ms,
-                   uint32_t num,
-                   const Message& msg)
-        : delay_ms_(delay),
-          run_time_ms_(run_time_ms),
-          message_number_(num),
-          msg_(msg) {}
-
-    bool operator<(const DelayedMessage& dmsg) const {
-      return (dmsg.run_time_ms_ < run_time_ms_) ||
-             ((dmsg.run_time_ms_ == run_time_ms_) &&
-              (dmsg.message_number_ < message_number_));
-    }
-
-    int64_t delay_ms_;  // for debugging
-    int64_t run_time_ms_;
-    // Monotonicaly incrementing number used for ordering of messages
-    // targeted to execute at the same time.
-    uint32_t message_number_;
-    Message msg_;
-  };
-
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
-  };
+  // Delayed messages are kept in a timer wheel, sorted by trigger time.
+  // Messages with the same trigger time are processed in FIFO order of their
+  // sequence number.
+  using DelayedMessageQueue = TimerWheel<Message>;
 
   void DoDelayPost(const Location& posted_from,
                    int64_t cmsDelay,
@@ -557,6 +540,9 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
   // Called by the ThreadManager when being unset as the current thread.
   void ClearCurrentTaskQueue();
 
+  // Moves messages posted through the lock-free inbox to |messages_|.
+  void DrainInbox() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Returns a static-lifetime MessageHandler which runs message with
   // MessageLikeTask payload data.
   static MessageHandler* GetPostTaskMessageHandler();
@@ -564,8 +550,17 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
   bool fPeekKeep_;
   Message msgPeek_;
   MessageList messages_ RTC_GUARDED_BY(crit_);
-  PriorityQueue delayed_messages_ RTC_GUARDED_BY(crit_);
-  uint32_t delayed_next_num_ RTC_GUARDED_BY(crit_);
+  // Immediate messages posted while |lock_free_posting_| is set. Pushed to
+  // without holding |crit_|; only popped while holding it.
+  MpscQueue<Message> inbox_;
+  std::atomic<bool> lock_free_posting_{false};
+  DelayedMessageQueue delayed_messages_ RTC_GUARDED_BY(crit_);
+  // Scratch space for delayed messages that have become due.
+  std::vector<DelayedMessageQueue::Entry> expired_delayed_messages_
+      RTC_GUARDED_BY(crit_);
+  // Monotonically incrementing number used for ordering of messages
+  // targeted to execute at the same time.
+  uint64_t delayed_next_num_ RTC_GUARDED_BY(crit_);
   CriticalSection crit_;
   bool fInitialized_;
   bool fDestroyed_;
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/thread_scheduling.h"
+
+#if defined(WEBRTC_LINUX)
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+
+namespace rtc {
+namespace {
+
+CriticalSection& ConfigsLock() {
+  static CriticalSection* const lock = new CriticalSection();
+  return *lock;
+}
+
+// Configs by thread name prefix.
+std::map<std::string, ThreadSchedulingConfig>& Configs() {
+  static auto* const configs =
+      new std::map<std::string, ThreadSchedulingConfig>();
+  return *configs;
+}
+
+#if defined(WEBRTC_LINUX)
+// Returns the CPUs of NUMA node |node|, or an empty list if there is no such
+// node.
+std::vector<int> GetNumaNodeCpus(int node) {
+  const std::string path =
+      "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+  FILE* file = fopen(path.c_str(), "r");
+  if (!file)
+    return std::vector<int>();
+  char cpu_list[1024];
+  const size_t length = fread(cpu_list, 1, sizeof(cpu_list), file);
+  fclose(file);
+  absl::string_view contents(cpu_list, length);
+  while (!contents.empty() && contents.back() == '\n')
+    contents.remove_suffix(1);
+  return ParseCpuList(contents);
+}
+
+bool SetAffinity(const ThreadSchedulingConfig& config) {
+  if (config.cpus.empty() && !config.numa_node)
+    return true;
+  std::vector<int> cpus = config.cpus;
+  if (config.numa_node) {
+    std::vector<int> node_cpus = GetNumaNodeCpus(*config.numa_node);
+    if (node_cpus.empty()) {
+      RTC_LOG(LS_ERROR) << "No CPUs found on NUMA node " << *config.numa_node;
+      return false;
+    }
+    if (cpus.empty()) {
+      cpus = node_cpus;
+    } else {
+      cpus.erase(std::remove_if(cpus.begin(), cpus.end(),
+                                [&node_cpus](int cpu) {
+                                  return std::find(node_cpus.begin(),
+                                                   node_cpus.end(),
+                                                   cpu) == node_cpus.end();
+                                }),
+                 cpus.end());
+    }
+  }
+  if (cpus.empty()) {
+    RTC_LOG(LS_ERROR) << "None of the CPUs are on NUMA node "
+                      << *config.numa_node;
+    return false;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &cpu_set);
+  }
+  const int error =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error != 0) {
+    RTC_LOG(LS_ERROR) << "Failed to set the CPU affinity, error " << error;
+    return false;
+  }
+  return true;
+}
+
+bool SetMemoryPolicy(int numa_node) {
+  // Prefers the node but falls back to others when it runs out of memory.
+  const size_t kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT
+  std::vector<unsigned long> node_mask(  // NOLINT
+      numa_node / kBitsPerWord + 1);
+  node_mask[numa_node / kBitsPerWord] |= 1UL << (numa_node % kBitsPerWord);
+  // The kernel reads one bit less than |max_node| says.
+  const unsigned long max_node = node_mask.size() * kBitsPerWord + 1;  // NOLINT
+  if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, node_mask.data(),
+              max_node) != 0) {
+    RTC_LOG_ERR(LS_ERROR) << "Failed to prefer NUMA node " << numa_node;
+    return false;
+  }
+  return true;
+}
+
+bool SetScheduling(const ThreadSchedulingConfig& config) {
+  if (config.realtime_priority) {
+    sched_param param = {};
+    param.sched_priority = *config.realtime_priority;
+    const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error != 0) {
+      RTC_LOG(LS_ERROR) << "Failed to set SCHED_FIFO priority "
+                        << *config.realtime_priority << ", error " << error;
+      return false;
+    }
+    return true;
+  }
+  if (config.nice) {
+    // The thread may have been made real-time for its ThreadPriority.
+    sched_param param = {};
+    int error = pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    if (error != 0) {
+      RTC_LOG(LS_ERROR) << "Failed to set SCHED_OTHER, error " << error;
+      return false;
+    }
+    // On Linux the nice value of a thread id applies to that thread alone.
+    if (setpriority(PRIO_PROCESS, CurrentThreadId(), *config.nice) != 0) {
+      RTC_LOG_ERR(LS_ERROR) << "Failed to set nice value " << *config.nice;
+      return false;
+    }
+  }
+  return true;
+}
+#endif  // defined(WEBRTC_LINUX)
+
+}  // namespace
+
+ThreadSchedulingConfig::ThreadSchedulingConfig() = default;
+ThreadSchedulingConfig::ThreadSchedulingConfig(const ThreadSchedulingConfig&) =
+    default;
+ThreadSchedulingConfig::~ThreadSchedulingConfig() = default;
+
+void SetThreadSchedulingConfig(absl::string_view name_prefix,
+                               const ThreadSchedulingConfig& config) {
+  CritScope lock(&ConfigsLock());
+  Configs()[std::string(name_prefix)] = config;
+}
+
+void ClearThreadSchedulingConfigs() {
+  CritScope lock(&ConfigsLock());
+  Configs().clear();
+}
+
+absl::optional<ThreadSchedulingConfig> GetThreadSchedulingConfig(
+    absl::string_view thread_name) {
+  CritScope lock(&ConfigsLock());
+  const std::pair<const std::string, ThreadSchedulingConfig>* longest_match =
+      nullptr;
+  for (const auto& prefix_and_config : Configs()) {
+    const std::string& prefix = prefix_and_config.first;
+    if (thread_name.substr(0, prefix.size()) == prefix &&
+        (!longest_match || prefix.size() > longest_match->first.size())) {
+      longest_match = &prefix_and_config;
+    }
+  }
+  if (!longest_match)
+    return absl::nullopt;
+  return longest_match->second;
+}
+
+bool ApplyThreadSchedulingConfig(absl::string_view thread_name) {
+  absl::optional<ThreadSchedulingConfig> config =
+      GetThreadSchedulingConfig(thread_name);
+  if (!config)
+    return true;
+#if defined(WEBRTC_LINUX)
+  bool applied = SetAffinity(*config);
+  if (config->numa_node)
+    applied &= SetMemoryPolicy(*config->numa_node);
+  applied &= SetScheduling(*config);
+  if (!applied) {
+    RTC_LOG(LS_WARNING) << "Scheduling of thread " << thread_name
+                        << " is not fully as configured.";
+  }
+  return applied;
+#else
+  return true;
+#endif  // defined(WEBRTC_LINUX)
+}
+
+std::vector<int> ParseCpuList(absl::string_view cpu_list) {
+  std::vector<int> cpus;
+  // Parses the number at the front of |text| and removes it from there.
+  auto parse_number = [](absl::string_view* text, int* number) {
+    size_t digits = 0;
+    int value = 0;
+    while (digits < text->size() && (*text)[digits] >= '0' &&
+           (*text)[digits] <= '9' && value < 1000000) {
+      value = value * 10 + ((*text)[digits] - '0');
+      ++digits;
+    }
+    if (digits == 0)
+      return false;
+    text->remove_prefix(digits);
+    *number = value;
+    return true;
+  };
+  while (!cpu_list.empty()) {
+    int first;
+    if (!parse_number(&cpu_list, &first))
+      return std::vector<int>();
+    int last = first;
+    if (!cpu_list.empty() && cpu_list[0] == '-') {
+      cpu_list.remove_prefix(1);
+      if (!parse_number(&cpu_list, &last) || last < first)
+        return std::vector<int>();
+    }
+    for (int cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+    if (!cpu_list.empty()) {
+      if (cpu_list[0] != ',' || cpu_list.size() == 1)
+        return std::vector<int>();
+      cpu_list.remove_prefix(1);
+    }
+  }
+  return cpus;
+}
+
+}  // namespace rtc
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_THREAD_SCHEDULING_H_
+#define RTC_BASE_THREAD_SCHEDULING_H_
+
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace rtc {
+
+// How the threads of one role are scheduled, for dedicated servers that keep
+// each role on its own cores to avoid migrations between them. The settings
+// are only applied on Linux, and are ignored elsewhere.
+struct ThreadSchedulingConfig {
+  ThreadSchedulingConfig();
+  ThreadSchedulingConfig(const ThreadSchedulingConfig&);
+  ~ThreadSchedulingConfig();
+
+  // The CPUs the threads may run on. Empty for no restriction.
+  std::vector<int> cpus;
+  // Keeps the threads on the CPUs of this NUMA node, of those in |cpus| if
+  // that isn't empty, and makes them allocate memory on the node if it can.
+  absl::optional<int> numa_node;
+  // Runs the threads with SCHED_FIFO at this priority, from 1 to 99, instead
+  // of the one their ThreadPriority maps to.
+  absl::optional<int> realtime_priority;
+  // Runs the threads with SCHED_OTHER at this nice value, from -20 to 19.
+  // Ignored if |realtime_priority| is set.
+  absl::optional<int> nice;
+};
+
+// Sets the config of the threads whose name starts with |name_prefix|,
+// replacing the previous one of the same prefix. Where several prefixes
+// match, the longest one applies. PlatformThread and rtc::Thread, and so the
+// task queues and the network thread pool, apply the config as they start,
+// so only threads started afterwards are affected. The roles are told apart
+// by the names the threads are given, for instance "pc_network_thread",
+// "EncoderQueue", "DecodingQueue", "ApmCapturePipeline" and "TaskQueuePool".
+void SetThreadSchedulingConfig(absl::string_view name_prefix,
+                               const ThreadSchedulingConfig& config);
+void ClearThreadSchedulingConfigs();
+
+// Returns the config that applies to the thread named |thread_name|, if any.
+absl::optional<ThreadSchedulingConfig> GetThreadSchedulingConfig(
+    absl::string_view thread_name);
+
+// Applies the config of |thread_name|, if any, to the calling thread. Returns
+// false if some of it could not be applied, which is logged.
+bool ApplyThreadSchedulingConfig(absl::string_view thread_name);
+
+// Parses a CPU list in the format the kernel uses in sysfs, e.g. "0-3,8,10".
+// Returns an empty list if |cpu_list| is malformed.
+std::vector<int> ParseCpuList(absl::string_view cpu_list);
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_THREAD_SCHEDULING_H_
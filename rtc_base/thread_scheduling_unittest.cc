@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/thread_scheduling.h"
+
+#if defined(WEBRTC_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/platform_thread_types.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class ThreadSchedulingTest : public ::testing::Test {
+ protected:
+  ~ThreadSchedulingTest() override { ClearThreadSchedulingConfigs(); }
+};
+
+#if defined(WEBRTC_LINUX)
+struct ThreadState {
+  cpu_set_t cpus;
+  int nice = 0;
+};
+
+void GetThreadState(void* obj) {
+  ThreadState* state = static_cast<ThreadState*>(obj);
+  pthread_getaffinity_np(pthread_self(), sizeof(state->cpus), &state->cpus);
+  state->nice = getpriority(PRIO_PROCESS, CurrentThreadId());
+}
+#endif
+
+}  // namespace
+
+TEST_F(ThreadSchedulingTest, LongestPrefixApplies) {
+  ThreadSchedulingConfig encoders;
+  encoders.nice = 1;
+  ThreadSchedulingConfig audio_encoders;
+  audio_encoders.nice = 2;
+  SetThreadSchedulingConfig("Encoder", encoders);
+  SetThreadSchedulingConfig("EncoderAudio", audio_encoders);
+
+  EXPECT_EQ(1, GetThreadSchedulingConfig("EncoderQueue")->nice);
+  EXPECT_EQ(2, GetThreadSchedulingConfig("EncoderAudio1")->nice);
+  EXPECT_FALSE(GetThreadSchedulingConfig("DecodingQueue"));
+  EXPECT_FALSE(GetThreadSchedulingConfig("Enc"));
+
+  ClearThreadSchedulingConfigs();
+  EXPECT_FALSE(GetThreadSchedulingConfig("EncoderQueue"));
+}
+
+TEST_F(ThreadSchedulingTest, ParsesCpuList) {
+  EXPECT_THAT(ParseCpuList("0-3,8,10-11"), ElementsAre(0, 1, 2, 3, 8, 10, 11));
+  EXPECT_THAT(ParseCpuList("5"), ElementsAre(5));
+  EXPECT_THAT(ParseCpuList(""), IsEmpty());
+  EXPECT_THAT(ParseCpuList("3-1"), IsEmpty());
+  EXPECT_THAT(ParseCpuList("1,"), IsEmpty());
+  EXPECT_THAT(ParseCpuList("a"), IsEmpty());
+}
+
+#if defined(WEBRTC_LINUX)
+TEST_F(ThreadSchedulingTest, PlatformThreadAppliesConfig) {
+  cpu_set_t allowed;
+  ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed))
+    ++cpu;
+
+  // Lowering the priority needs no privileges.
+  ThreadSchedulingConfig config;
+  config.cpus = {cpu};
+  config.nice = 19;
+  SetThreadSchedulingConfig("Pinned", config);
+
+  ThreadState state;
+  PlatformThread thread(&GetThreadState, &state, "PinnedThread");
+  thread.Start();
+  thread.Stop();
+  EXPECT_EQ(1, CPU_COUNT(&state.cpus));
+  EXPECT_TRUE(CPU_ISSET(cpu, &state.cpus));
+  EXPECT_EQ(19, state.nice);
+
+  ThreadState unpinned_state;
+  PlatformThread unpinned_thread(&GetThreadState, &unpinned_state, "Other");
+  unpinned_thread.Start();
+  unpinned_thread.Stop();
+  EXPECT_EQ(CPU_COUNT(&allowed), CPU_COUNT(&unpinned_state.cpus));
+}
+#endif
+
+}  // namespace rtc
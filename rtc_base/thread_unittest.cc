@@ -10,7 +10,9 @@
 
 #include "rtc_base/thread.h"
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "api/task_queue/task_queue_factory.h"
 #include "api/task_queue/task_queue_test.h"
@@ -19,11 +21,13 @@
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/event.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/null_socket_server.h"
 #include "rtc_base/physical_socket_server.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/task_utils/to_queued_task.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/time_utils.h"
 #include "test/testsupport/rtc_expect_death.h"
 
 #if defined(WEBRTC_WIN)
@@ -1104,6 +1108,86 @@ TEST(ThreadPostTaskTest, InvokesInPostedOrder) {
   fourth.Wait(Event::kForever);
 }
 
+TEST(ThreadPostTaskTest, LockFreePostingInvokesInPostedOrder) {
+  std::unique_ptr<rtc::Thread> background_thread(rtc::Thread::Create());
+  background_thread->SetLockFreePosting(true);
+  background_thread->Start();
+
+  Event first;
+  Event second;
+  Event third;
+  Event fourth;
+
+  background_thread->PostTask(RTC_FROM_HERE,
+                              Bind(&WaitAndSetEvent, &first, &second));
+  background_thread->PostTask(RTC_FROM_HERE,
+                              Bind(&WaitAndSetEvent, &second, &third));
+  background_thread->PostTask(RTC_FROM_HERE,
+                              Bind(&WaitAndSetEvent, &third, &fourth));
+
+  first.Set();
+  fourth.Wait(Event::kForever);
+}
+
+TEST(ThreadPostTaskTest, LockFreePostingCanBeToggledWithPendingTasks) {
+  std::unique_ptr<rtc::Thread> background_thread(rtc::Thread::Create());
+  background_thread->SetLockFreePosting(true);
+
+  int counter = 0;
+  for (int i = 0; i < 10; ++i)
+    background_thread->PostTask(RTC_FROM_HERE, [&counter] { ++counter; });
+  EXPECT_EQ(10u, background_thread->size());
+  background_thread->SetLockFreePosting(false);
+  EXPECT_EQ(10u, background_thread->size());
+
+  Event done;
+  background_thread->PostTask(RTC_FROM_HERE, [&done] { done.Set(); });
+  background_thread->Start();
+  done.Wait(Event::kForever);
+  EXPECT_EQ(10, counter);
+}
+
+// Measures how fast several threads can post to one thread, with and without
+// lock-free posting. Disabled since it only logs the results.
+TEST(ThreadPostTaskTest, DISABLED_PostingThroughput) {
+  constexpr int kNumPosters = 4;
+  constexpr int kPostsPerPoster = 100000;
+  for (bool lock_free : {false, true}) {
+    std::unique_ptr<rtc::Thread> target(rtc::Thread::Create());
+    target->SetLockFreePosting(lock_free);
+    target->Start();
+
+    std::atomic<int> received(0);
+    std::vector<std::unique_ptr<rtc::Thread>> posters;
+    std::vector<Event> posters_done(kNumPosters);
+    int64_t start_us = rtc::TimeMicros();
+    for (int i = 0; i < kNumPosters; ++i) {
+      posters.push_back(rtc::Thread::Create());
+      posters.back()->Start();
+      Event* poster_done = &posters_done[i];
+      posters.back()->PostTask(RTC_FROM_HERE, [&target, &received,
+                                               poster_done] {
+        for (int j = 0; j < kPostsPerPoster; ++j) {
+          target->PostTask(RTC_FROM_HERE, [&received] {
+            received.fetch_add(1, std::memory_order_relaxed);
+          });
+        }
+        poster_done->Set();
+      });
+    }
+    for (Event& poster_done : posters_done)
+      poster_done.Wait(Event::kForever);
+    Event done;
+    target->PostTask(RTC_FROM_HERE, [&done] { done.Set(); });
+    done.Wait(Event::kForever);
+    int64_t elapsed_us = rtc::TimeMicros() - start_us;
+    EXPECT_EQ(kNumPosters * kPostsPerPoster, received.load());
+    RTC_LOG(LS_INFO) << (lock_free ? "Lock-free" : "Locked") << " posting: "
+                     << kNumPosters * kPostsPerPoster * 1000000LL / elapsed_us
+                     << " posts/s";
+  }
+}
+
 TEST(ThreadPostDelayedTaskTest, InvokesAsynchronously) {
   std::unique_ptr<rtc::Thread> background_thread(rtc::Thread::Create());
   background_thread->Start();
@@ -1172,11 +1256,29 @@ class ThreadFactory : public webrtc::TaskQueueFactory {
   }
 };
 
+class LockFreePostingThreadFactory : public webrtc::TaskQueueFactory {
+ public:
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter>
+  CreateTaskQueue(absl::string_view /* name */,
+                  Priority /*priority*/) const override {
+    std::unique_ptr<Thread> thread = Thread::Create();
+    thread->SetLockFreePosting(true);
+    thread->Start();
+    return std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter>(
+        thread.release());
+  }
+};
+
 using ::webrtc::TaskQueueTest;
 
 INSTANTIATE_TEST_SUITE_P(RtcThread,
                          TaskQueueTest,
                          ::testing::Values(std::make_unique<ThreadFactory>));
 
+INSTANTIATE_TEST_SUITE_P(
+    RtcThreadLockFreePosting,
+    TaskQueueTest,
+    ::testing::Values(std::make_unique<LockFreePostingThreadFactory>));
+
 }  // namespace
 }  // namespace rtc
@@ -27,6 +27,8 @@
 // clang-format on
 #endif
 
+#include "absl/base/attributes.h"
+#include "absl/base/config.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/time_utils.h"
@@ -45,6 +47,42 @@ ClockInterface* GetClockForTesting() {
   return g_clock;
 }
 
+#if defined(ABSL_HAVE_THREAD_LOCAL)
+
+namespace {
+
+ABSL_CONST_INIT thread_local ClockInterface* g_thread_clock = nullptr;
+
+// Returns the clock replacing the system clock on the calling thread, if any.
+ClockInterface* CurrentClock() {
+  return g_thread_clock ? g_thread_clock : g_clock;
+}
+
+}  // namespace
+
+ClockInterface* SetThreadClockForTesting(ClockInterface* clock) {
+  ClockInterface* prev = g_thread_clock;
+  g_thread_clock = clock;
+  return prev;
+}
+
+#else
+
+namespace {
+
+ClockInterface* CurrentClock() {
+  return g_clock;
+}
+
+}  // namespace
+
+ClockInterface* SetThreadClockForTesting(ClockInterface* clock) {
+  // Without thread local storage, the clock can only be set globally.
+  return SetClockForTesting(clock);
+}
+
+#endif
+
 #if defined(WINUWP)
 
 namespace {
@@ -201,8 +239,8 @@ int64_t SystemTimeMillis() {
 }
 
 int64_t TimeNanos() {
-  if (g_clock) {
-    return g_clock->TimeNanos();
+  if (ClockInterface* clock = CurrentClock()) {
+    return clock->TimeNanos();
   }
   return SystemTimeNanos();
 }
@@ -301,8 +339,8 @@ int64_t TmToSeconds(const tm& tm) {
 }
 
 int64_t TimeUTCMicros() {
-  if (g_clock) {
-    return g_clock->TimeNanos() / kNumNanosecsPerMicrosec;
+  if (ClockInterface* clock = CurrentClock()) {
+    return clock->TimeNanos() / kNumNanosecsPerMicrosec;
   }
 #if defined(WEBRTC_POSIX)
   struct timeval time;
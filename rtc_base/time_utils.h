@@ -57,6 +57,12 @@ RTC_EXPORT ClockInterface* SetClockForTesting(ClockInterface* clock);
 // Returns previously set clock, or nullptr if no custom clock is being used.
 RTC_EXPORT ClockInterface* GetClockForTesting();
 
+// Like SetClockForTesting(), but only sets the source of time for the calling
+// thread. A clock set this way takes precedence over the global one, which
+// allows independent simulations, each with its own clock, to run on different
+// threads. Returns the clock previously set for the calling thread.
+RTC_EXPORT ClockInterface* SetThreadClockForTesting(ClockInterface* clock);
+
 #if defined(WINUWP)
 // Synchronizes the current clock based upon an NTP server's epoch in
 // milliseconds.
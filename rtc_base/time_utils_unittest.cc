@@ -230,6 +230,25 @@ TEST(FakeClock, TimeFunctionsUseFakeClock) {
   EXPECT_NE(987, TimeMillis());
 }
 
+TEST(FakeClock, ThreadClockOnlyAffectsCallingThread) {
+  FakeClock global_clock;
+  FakeClock thread_clock;
+  SetClockForTesting(&global_clock);
+  SetThreadClockForTesting(&thread_clock);
+  global_clock.SetTime(webrtc::Timestamp::Millis(123));
+  thread_clock.SetTime(webrtc::Timestamp::Millis(456));
+  EXPECT_EQ(456, TimeMillis());
+
+  std::unique_ptr<Thread> other(Thread::Create());
+  other->Start();
+  EXPECT_EQ(123, other->Invoke<int64_t>(RTC_FROM_HERE, &TimeMillis));
+  other->Stop();
+
+  SetThreadClockForTesting(nullptr);
+  EXPECT_EQ(123, TimeMillis());
+  SetClockForTesting(nullptr);
+}
+
 TEST(FakeClock, InitialTime) {
   FakeClock clock;
   EXPECT_EQ(0, clock.TimeNanos());
@@ -0,0 +1,244 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TIMER_WHEEL_H_
+#define RTC_BASE_TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+// Hierarchical timer wheel for delayed tasks. Insertion is O(1) and expiry is
+// amortized O(1) per entry, regardless of how many timers are pending, which
+// makes it a better fit than a binary heap when thousands of repeating timers
+// are live.
+//
+// Time is divided into ticks of |tick_ms| milliseconds. Entries are never
+// reported before their fire time; all entries whose fire time falls within
+// the same tick expire together at the end of that tick, so a coarser tick
+// coalesces nearby timers into a single wake-up. With the default tick of 1
+// ms the wheel behaves like an exact priority queue.
+//
+// Expired entries are reported in (fire time, order) order, where |order| is
+// a caller provided tie-breaker, e.g. a posting sequence number.
+//
+// Not thread safe.
+template <typename T>
+class TimerWheel {
+ public:
+  struct Entry {
+    int64_t fire_at_ms;
+    uint64_t order;
+    T value;
+  };
+
+  explicit TimerWheel(int64_t tick_ms = 1) : tick_ms_(tick_ms) {
+    RTC_DCHECK_GT(tick_ms_, 0);
+  }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void Insert(int64_t now_ms, int64_t fire_at_ms, uint64_t order, T value) {
+    if (size_ == 0) {
+      // Resynchronize with the current time, so that an idle wheel doesn't
+      // have to catch up with time that has passed since it was last used.
+      current_tick_ = FloorTick(now_ms);
+    }
+    ++size_;
+    Place(Entry{fire_at_ms, order, std::move(value)});
+  }
+
+  // Appends all entries with a fire time at or before |now_ms|, rounded up to
+  // the tick they belong to, to |expired|.
+  void PopExpired(int64_t now_ms, std::vector<Entry>* expired) {
+    const size_t first = expired->size();
+    MoveAll(&due_, expired);
+    const int64_t target_tick = FloorTick(now_ms);
+    while (size_ > expired->size() - first && current_tick_ <= target_tick) {
+      if ((current_tick_ & kSlotMask) == 0)
+        Cascade();
+      if (level_sizes_[0] == 0) {
+        // Nothing can expire before the next cascade.
+        current_tick_ =
+            std::min(NextCascadeTick(current_tick_ + 1), target_tick + 1);
+        continue;
+      }
+      std::vector<Entry>& slot = levels_[0][current_tick_ & kSlotMask];
+      level_sizes_[0] -= slot.size();
+      MoveAll(&slot, expired);
+      ++current_tick_;
+    }
+    if (current_tick_ <= target_tick)
+      current_tick_ = target_tick + 1;
+    // Cascading may have found entries that were already due.
+    MoveAll(&due_, expired);
+    size_ -= expired->size() - first;
+    std::sort(expired->begin() + first, expired->end(),
+              [](const Entry& a, const Entry& b) {
+                return std::tie(a.fire_at_ms, a.order) <
+                       std::tie(b.fire_at_ms, b.order);
+              });
+  }
+
+  // Returns the earliest time at which PopExpired() may return entries. This
+  // may be earlier than the next fire time, when entries far in the future
+  // need to move to a finer level, but never later. Returns nullopt when the
+  // wheel is empty.
+  absl::optional<int64_t> NextWakeUpMs() const {
+    if (size_ == 0)
+      return absl::nullopt;
+    if (!due_.empty())
+      return due_.front().fire_at_ms;
+    // Higher levels may hold entries that become due before the first
+    // non-empty level 0 slot, so stop scanning at the next cascade.
+    const bool has_higher_levels = size_ > level_sizes_[0];
+    const int64_t next_cascade_tick = NextCascadeTick(current_tick_);
+    if (level_sizes_[0] > 0) {
+      for (int64_t tick = current_tick_; tick < current_tick_ + kSlotsPerLevel;
+           ++tick) {
+        if (has_higher_levels && tick >= next_cascade_tick)
+          break;
+        if (!levels_[0][tick & kSlotMask].empty())
+          return tick * tick_ms_;
+      }
+    }
+    return next_cascade_tick * tick_ms_;
+  }
+
+  // Moves all entries for which |pred(value)| returns true to |removed|.
+  template <typename Predicate>
+  void RemoveIf(Predicate pred, std::vector<Entry>* removed) {
+    const size_t first = removed->size();
+    RemoveFromSlot(pred, &due_, removed);
+    for (size_t level = 0; level < kNumLevels; ++level) {
+      if (level_sizes_[level] == 0)
+        continue;
+      for (std::vector<Entry>& slot : levels_[level]) {
+        size_t before = removed->size();
+        RemoveFromSlot(pred, &slot, removed);
+        level_sizes_[level] -= removed->size() - before;
+      }
+    }
+    size_ -= removed->size() - first;
+  }
+
+ private:
+  static constexpr int kBitsPerLevel = 8;
+  static constexpr size_t kNumLevels = 4;
+  static constexpr int64_t kSlotsPerLevel = int64_t{1} << kBitsPerLevel;
+  static constexpr int64_t kSlotMask = kSlotsPerLevel - 1;
+  // Entries further away than this are parked in the last level and
+  // re-placed when that slot is cascaded.
+  static constexpr int64_t kMaxDeltaTicks =
+      (int64_t{1} << (kBitsPerLevel * kNumLevels)) - 1;
+
+  int64_t FloorTick(int64_t time_ms) const {
+    int64_t tick = time_ms / tick_ms_;
+    return (tick * tick_ms_ > time_ms) ? tick - 1 : tick;
+  }
+  void Place(Entry entry) {
+    const int64_t tick = CeilTickOf(entry.fire_at_ms);
+    if (tick < current_tick_) {
+      due_.push_back(std::move(entry));
+      return;
+    }
+    const int64_t delta = std::min(tick - current_tick_, kMaxDeltaTicks);
+    const int64_t slot_tick = current_tick_ + delta;
+    size_t level = 0;
+    while (level + 1 < kNumLevels &&
+           delta >= (int64_t{1} << (kBitsPerLevel * (level + 1)))) {
+      ++level;
+    }
+    size_t index = (slot_tick >> (kBitsPerLevel * level)) & kSlotMask;
+    levels_[level][index].push_back(std::move(entry));
+    ++level_sizes_[level];
+  }
+
+  int64_t CeilTickOf(int64_t time_ms) const {
+    int64_t tick = FloorTick(time_ms);
+    return (tick * tick_ms_ < time_ms) ? tick + 1 : tick;
+  }
+
+  // Called when |current_tick_| is a multiple of kSlotsPerLevel; moves the
+  // entries of the higher level slots that are now in range one level down.
+  void Cascade() {
+    for (size_t level = 1; level < kNumLevels; ++level) {
+      size_t index = (current_tick_ >> (kBitsPerLevel * level)) & kSlotMask;
+      std::vector<Entry> slot;
+      slot.swap(levels_[level][index]);
+      level_sizes_[level] -= slot.size();
+      for (Entry& entry : slot)
+        Place(std::move(entry));
+      if (index != 0)
+        break;
+    }
+  }
+
+  // Returns the first tick at or after |from_tick| at which the lowest
+  // non-empty level above level 0 is cascaded.
+  int64_t NextCascadeTick(int64_t from_tick) const {
+    for (size_t level = 1; level < kNumLevels; ++level) {
+      if (level_sizes_[level] > 0) {
+        const int64_t granularity = int64_t{1} << (kBitsPerLevel * level);
+        return (from_tick + granularity - 1) / granularity * granularity;
+      }
+    }
+    // Only |due_| or level 0 entries, if any.
+    return from_tick;
+  }
+
+  static void MoveAll(std::vector<Entry>* from, std::vector<Entry>* to) {
+    for (Entry& entry : *from)
+      to->push_back(std::move(entry));
+    from->clear();
+  }
+
+  template <typename Predicate>
+  static void RemoveFromSlot(Predicate& pred,
+                             std::vector<Entry>* slot,
+                             std::vector<Entry>* removed) {
+    auto kept = slot->begin();
+    for (auto it = slot->begin(); it != slot->end(); ++it) {
+      if (pred(it->value)) {
+        removed->push_back(std::move(*it));
+      } else {
+        if (kept != it)
+          *kept = std::move(*it);
+        ++kept;
+      }
+    }
+    slot->erase(kept, slot->end());
+  }
+
+  const int64_t tick_ms_;
+  // The next tick to be processed by PopExpired().
+  int64_t current_tick_ = 0;
+  size_t size_ = 0;
+  // Entries that were already due when inserted.
+  std::vector<Entry> due_;
+  std::array<std::array<std::vector<Entry>, kSlotsPerLevel>, kNumLevels>
+      levels_;
+  std::array<size_t, kNumLevels> level_sizes_{};
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_TIMER_WHEEL_H_
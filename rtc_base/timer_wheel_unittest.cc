@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/timer_wheel.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+using Wheel = TimerWheel<int>;
+
+std::vector<int> PopExpiredValues(Wheel* wheel, int64_t now_ms) {
+  std::vector<Wheel::Entry> expired;
+  wheel->PopExpired(now_ms, &expired);
+  std::vector<int> values;
+  for (const Wheel::Entry& entry : expired)
+    values.push_back(entry.value);
+  return values;
+}
+
+TEST(TimerWheelTest, EmptyWheelHasNoWakeUp) {
+  Wheel wheel;
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.NextWakeUpMs());
+  EXPECT_TRUE(PopExpiredValues(&wheel, 1000).empty());
+}
+
+TEST(TimerWheelTest, ExpiresInFireTimeThenOrderOrder) {
+  Wheel wheel;
+  wheel.Insert(1000, 1020, 0, 0);
+  wheel.Insert(1000, 1010, 1, 1);
+  wheel.Insert(1000, 1010, 2, 2);
+  EXPECT_EQ(3u, wheel.size());
+  EXPECT_EQ(1010, wheel.NextWakeUpMs());
+
+  EXPECT_TRUE(PopExpiredValues(&wheel, 1009).empty());
+  EXPECT_EQ(std::vector<int>({1, 2}), PopExpiredValues(&wheel, 1010));
+  EXPECT_EQ(1020, wheel.NextWakeUpMs());
+  EXPECT_EQ(std::vector<int>({0}), PopExpiredValues(&wheel, 5000));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, EntriesInThePastExpireOnNextPop) {
+  Wheel wheel;
+  wheel.Insert(1000, 2000, 0, 0);
+  EXPECT_TRUE(PopExpiredValues(&wheel, 1500).empty());
+  wheel.Insert(1500, 1200, 1, 1);
+  EXPECT_EQ(std::vector<int>({1}), PopExpiredValues(&wheel, 1500));
+}
+
+TEST(TimerWheelTest, CoalescesEntriesWithinOneTick) {
+  Wheel wheel(/*tick_ms=*/10);
+  wheel.Insert(1000, 1001, 0, 0);
+  wheel.Insert(1000, 1009, 1, 1);
+  wheel.Insert(1000, 1011, 2, 2);
+  // Nothing fires before its time; both entries of the first tick fire at
+  // the end of it.
+  EXPECT_EQ(1010, wheel.NextWakeUpMs());
+  EXPECT_TRUE(PopExpiredValues(&wheel, 1009).empty());
+  EXPECT_EQ(std::vector<int>({0, 1}), PopExpiredValues(&wheel, 1010));
+  EXPECT_EQ(1020, wheel.NextWakeUpMs());
+}
+
+TEST(TimerWheelTest, HandlesEntriesFarInTheFuture) {
+  Wheel wheel;
+  const int64_t kHourMs = 60 * 60 * 1000;
+  wheel.Insert(0, kHourMs, 0, 0);
+  wheel.Insert(0, 100 * 24 * kHourMs, 1, 1);
+  ASSERT_TRUE(wheel.NextWakeUpMs());
+  EXPECT_LE(*wheel.NextWakeUpMs(), kHourMs);
+  EXPECT_TRUE(PopExpiredValues(&wheel, kHourMs - 1).empty());
+  EXPECT_EQ(std::vector<int>({0}), PopExpiredValues(&wheel, kHourMs));
+  EXPECT_TRUE(PopExpiredValues(&wheel, 50 * 24 * kHourMs).empty());
+  EXPECT_EQ(std::vector<int>({1}),
+            PopExpiredValues(&wheel, 100 * 24 * kHourMs));
+}
+
+TEST(TimerWheelTest, RemoveIf) {
+  Wheel wheel;
+  for (int i = 0; i < 10; ++i)
+    wheel.Insert(0, i * 300, i, i);
+  std::vector<Wheel::Entry> removed;
+  wheel.RemoveIf([](int value) { return value % 2 == 1; }, &removed);
+  EXPECT_EQ(5u, removed.size());
+  EXPECT_EQ(5u, wheel.size());
+  EXPECT_EQ(std::vector<int>({0, 2, 4, 6, 8}), PopExpiredValues(&wheel, 3000));
+}
+
+TEST(TimerWheelTest, MatchesOrderedMapWithRandomOperations) {
+  for (int64_t tick_ms : {1, 7}) {
+    Wheel wheel(tick_ms);
+    std::multimap<std::pair<int64_t, uint64_t>, int> reference;
+    webrtc::Random random(4711);
+    int64_t now_ms = 100000;
+    for (int i = 0; i < 20000; ++i) {
+      if (random.Rand(1) != 0) {
+        int64_t fire_at_ms =
+            now_ms + static_cast<int64_t>(random.Rand(0, 5000)) - 10;
+        wheel.Insert(now_ms, fire_at_ms, i, i);
+        reference.emplace(std::make_pair(fire_at_ms, i), i);
+        continue;
+      }
+      now_ms += random.Rand(0, 100);
+      std::vector<int> expected;
+      while (!reference.empty()) {
+        int64_t fire_at_ms = reference.begin()->first.first;
+        int64_t tick_end_ms = (fire_at_ms + tick_ms - 1) / tick_ms * tick_ms;
+        if (tick_end_ms > now_ms)
+          break;
+        expected.push_back(reference.begin()->second);
+        reference.erase(reference.begin());
+      }
+      EXPECT_EQ(expected, PopExpiredValues(&wheel, now_ms));
+      EXPECT_EQ(reference.size(), wheel.size());
+    }
+  }
+}
+
+}  // namespace
+}  // namespace rtc
@@ -26,6 +26,7 @@
 #include "rtc_tools/frame_analyzer/video_temporal_aligner.h"
 #include "rtc_tools/video_file_reader.h"
 #include "rtc_tools/video_file_writer.h"
+#include "system_wrappers/include/cpu_info.h"
 #include "test/testsupport/perf_test.h"
 
 ABSL_FLAG(int32_t, width, -1, "The width of the reference and test files");
@@ -52,6 +53,11 @@ ABSL_FLAG(std::string,
           "",
           "Where to write aligned YUV ref+test output files, if not present, "
           "no files will be written");
+ABSL_FLAG(int,
+          num_threads,
+          0,
+          "Number of threads used for aligning and analyzing the frames; 0 "
+          "means one per core");
 ABSL_FLAG(std::string,
           chartjson_result_file,
           "",
@@ -86,6 +92,7 @@ std::string JoinFilename(std::string directory, std::string filename) {
  * Usage:
  * frame_analyzer --label=<test_label> --reference_file=<name_of_file>
  * --test_file_ref=<name_of_file> --width=<frame_width> --height=<frame_height>
+ * [--num_threads=<threads>]
  */
 int main(int argc, char* argv[]) {
   absl::ParseCommandLine(argc, argv);
@@ -117,8 +124,14 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  int num_threads = absl::GetFlag(FLAGS_num_threads);
+  if (num_threads <= 0) {
+    num_threads = webrtc::CpuInfo::DetectNumberOfCores();
+  }
+
   const std::vector<size_t> matching_indices =
-      webrtc::test::FindMatchingFrameIndices(reference_video, test_video);
+      webrtc::test::FindMatchingFrameIndices(reference_video, test_video,
+                                             num_threads);
 
   // Align the reference video both temporally and geometrically. I.e. align the
   // frames to match up in order to the test video, and align a crop region of
@@ -147,8 +160,10 @@ int main(int argc, char* argv[]) {
   const rtc::scoped_refptr<webrtc::test::Video> color_adjusted_test_video =
       AdjustColors(color_transformation, test_video);
 
-  results.frames = webrtc::test::RunAnalysis(
-      aligned_reference_video, color_adjusted_test_video, matching_indices);
+  results.frames =
+      webrtc::test::RunAnalysis(aligned_reference_video,
+                                color_adjusted_test_video, matching_indices,
+                                num_threads);
 
   const std::vector<webrtc::test::Cluster> clusters =
       webrtc::test::CalculateFrameClusters(matching_indices);
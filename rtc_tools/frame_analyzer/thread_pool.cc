@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/thread_pool.h"
+
+namespace webrtc {
+namespace test {
+
+ThreadPool::ThreadPool(int num_threads) {
+  for (int i = 1; i < num_threads; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->pool = this;
+    worker->thread = std::make_unique<rtc::PlatformThread>(
+        &ThreadPool::WorkerThread, worker.get(), "FrameAnalyzerWorker");
+    worker->thread->Start();
+    workers_.push_back(std::move(worker));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    rtc::CritScope lock(&crit_);
+    stopping_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker->wake_up.Set();
+    worker->thread->Stop();
+  }
+}
+
+void ThreadPool::ParallelFor(size_t count,
+                             rtc::FunctionView<void(size_t)> function) {
+  if (workers_.empty() || count <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  {
+    rtc::CritScope lock(&crit_);
+    function_ = &function;
+    count_ = count;
+    next_index_ = 0;
+    active_workers_ = workers_.size();
+  }
+  for (auto& worker : workers_) {
+    worker->wake_up.Set();
+  }
+  ProcessIndices();
+  done_.Wait(rtc::Event::kForever, rtc::Event::kForever);
+}
+
+void ThreadPool::WorkerThread(void* obj) {
+  Worker* worker = static_cast<Worker*>(obj);
+  worker->pool->RunWorker(worker);
+}
+
+void ThreadPool::RunWorker(Worker* worker) {
+  while (true) {
+    // Idle workers may wait for a long time, so don't warn about it.
+    worker->wake_up.Wait(rtc::Event::kForever, rtc::Event::kForever);
+    {
+      rtc::CritScope lock(&crit_);
+      if (stopping_) {
+        return;
+      }
+    }
+    ProcessIndices();
+    rtc::CritScope lock(&crit_);
+    if (--active_workers_ == 0) {
+      done_.Set();
+    }
+  }
+}
+
+void ThreadPool::ProcessIndices() {
+  while (true) {
+    rtc::FunctionView<void(size_t)>* function;
+    size_t index;
+    {
+      rtc::CritScope lock(&crit_);
+      if (next_index_ >= count_) {
+        return;
+      }
+      function = function_;
+      index = next_index_++;
+    }
+    (*function)(index);
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_FRAME_ANALYZER_THREAD_POOL_H_
+#define RTC_TOOLS_FRAME_ANALYZER_THREAD_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/function_view.h"
+#include "rtc_base/critical_section.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+namespace test {
+
+// A fixed set of threads for spreading per-frame work, e.g. computing PSNR and
+// SSIM, over several cores. The threads are kept alive between calls to
+// ParallelFor(), so that it is cheap to run many small batches.
+class ThreadPool {
+ public:
+  // |num_threads| includes the thread calling ParallelFor(). With one thread,
+  // all work runs on the calling thread.
+  explicit ThreadPool(int num_threads);
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Calls |function| once for every index in [0, count) and returns when all
+  // calls are done. The calls run concurrently on the threads of the pool in
+  // no particular order. Must not be called from |function|, nor from several
+  // threads at once.
+  void ParallelFor(size_t count, rtc::FunctionView<void(size_t)> function);
+
+ private:
+  struct Worker {
+    ThreadPool* pool;
+    rtc::Event wake_up;
+    std::unique_ptr<rtc::PlatformThread> thread;
+  };
+
+  static void WorkerThread(void* obj);
+  void RunWorker(Worker* worker);
+  void ProcessIndices();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  rtc::Event done_;
+
+  rtc::CriticalSection crit_;
+  bool stopping_ RTC_GUARDED_BY(crit_) = false;
+  rtc::FunctionView<void(size_t)>* function_ RTC_GUARDED_BY(crit_) = nullptr;
+  size_t count_ RTC_GUARDED_BY(crit_) = 0;
+  size_t next_index_ RTC_GUARDED_BY(crit_) = 0;
+  size_t active_workers_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_FRAME_ANALYZER_THREAD_POOL_H_
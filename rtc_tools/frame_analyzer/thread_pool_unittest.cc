@@ -0,0 +1,34 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/frame_analyzer/thread_pool.h"
+
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+
+TEST(ThreadPoolTest, CallsFunctionOnceForEachIndex) {
+  for (int num_threads : {1, 2, 5}) {
+    ThreadPool thread_pool(num_threads);
+    EXPECT_EQ(num_threads, thread_pool.num_threads());
+    // Run several batches to check that the threads are reused correctly.
+    for (size_t count : {0, 1, 3, 100}) {
+      std::vector<int> calls(count, 0);
+      thread_pool.ParallelFor(count, [&](size_t i) { ++calls[i]; });
+      EXPECT_EQ(std::vector<int>(count, 1), calls);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
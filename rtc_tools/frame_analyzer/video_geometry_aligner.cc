@@ -14,7 +14,9 @@
 
 #include "api/video/i420_buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_tools/frame_analyzer/video_quality_analysis.h"
 #include "third_party/libyuv/include/libyuv/scale.h"
 
@@ -155,20 +157,32 @@ rtc::scoped_refptr<Video> AdjustCropping(
           reference_video_->GetFrame(index);
 
       // Only calculate cropping region once per frame since it's expensive.
-      if (!crop_regions_.count(index)) {
-        crop_regions_[index] =
+      CropRegion crop_region;
+      bool is_cached;
+      {
+        rtc::CritScope lock(&crit_);
+        auto it = crop_regions_.find(index);
+        is_cached = it != crop_regions_.end();
+        if (is_cached)
+          crop_region = it->second;
+      }
+      if (!is_cached) {
+        crop_region =
             CalculateCropRegion(reference_frame, test_video_->GetFrame(index));
+        rtc::CritScope lock(&crit_);
+        crop_regions_[index] = crop_region;
       }
 
-      return CropAndZoom(crop_regions_[index], reference_frame);
+      return CropAndZoom(crop_region, reference_frame);
     }
 
    private:
     const rtc::scoped_refptr<Video> reference_video_;
     const rtc::scoped_refptr<Video> test_video_;
+    rtc::CriticalSection crit_;
     // Mutable since this is a cache that affects performance and not logical
     // behavior.
-    mutable std::map<size_t, CropRegion> crop_regions_;
+    mutable std::map<size_t, CropRegion> crop_regions_ RTC_GUARDED_BY(crit_);
   };
 
   return new CroppedVideo(reference_video, test_video);
@@ -16,6 +16,7 @@
 
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_tools/frame_analyzer/thread_pool.h"
 #include "test/testsupport/perf_test.h"
 #include "third_party/libyuv/include/libyuv/compare.h"
 
@@ -56,21 +57,22 @@ double Ssim(const rtc::scoped_refptr<I420BufferInterface>& ref_buffer,
 std::vector<AnalysisResult> RunAnalysis(
     const rtc::scoped_refptr<webrtc::test::Video>& reference_video,
     const rtc::scoped_refptr<webrtc::test::Video>& test_video,
-    const std::vector<size_t>& test_frame_indices) {
-  std::vector<AnalysisResult> results;
-  for (size_t i = 0; i < test_video->number_of_frames(); ++i) {
-    const rtc::scoped_refptr<I420BufferInterface>& test_frame =
+    const std::vector<size_t>& test_frame_indices,
+    int num_threads) {
+  std::vector<AnalysisResult> results(test_video->number_of_frames());
+  ThreadPool thread_pool(num_threads);
+  thread_pool.ParallelFor(results.size(), [&](size_t i) {
+    const rtc::scoped_refptr<I420BufferInterface> test_frame =
         test_video->GetFrame(i);
-    const rtc::scoped_refptr<I420BufferInterface>& reference_frame =
+    const rtc::scoped_refptr<I420BufferInterface> reference_frame =
         reference_video->GetFrame(i);
 
     // Fill in the result struct.
-    AnalysisResult result;
+    AnalysisResult& result = results[i];
     result.frame_number = test_frame_indices[i];
     result.psnr_value = Psnr(reference_frame, test_frame);
     result.ssim_value = Ssim(reference_frame, test_frame);
-    results.push_back(result);
-  }
+  });
 
   return results;
 }
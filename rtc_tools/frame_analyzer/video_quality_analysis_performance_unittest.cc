@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Throughput of the frame_analyzer steps, in frames per second, for one
+// thread and for one thread per core.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "api/function_view.h"
+#include "rtc_base/time_utils.h"
+#include "rtc_tools/frame_analyzer/video_quality_analysis.h"
+#include "rtc_tools/frame_analyzer/video_temporal_aligner.h"
+#include "rtc_tools/video_file_reader.h"
+#include "system_wrappers/include/cpu_info.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+// Runs |operation| on |num_frames| frames and reports the number of frames
+// processed per second.
+void MeasureAndReport(const std::string& measurement,
+                      int num_threads,
+                      size_t num_frames,
+                      rtc::FunctionView<void()> operation) {
+  const int64_t start_us = rtc::TimeMicros();
+  operation();
+  const int64_t elapsed_us = std::max<int64_t>(rtc::TimeMicros() - start_us, 1);
+  PrintResult(measurement, "", std::to_string(num_threads) + "_threads",
+              num_frames * 1e6 / elapsed_us, "fps", /*important=*/false,
+              ImproveDirection::kBiggerIsBetter);
+}
+
+std::vector<int> ThreadCounts() {
+  const int num_cores = CpuInfo::DetectNumberOfCores();
+  return num_cores > 1 ? std::vector<int>{1, num_cores}
+                       : std::vector<int>{1};
+}
+
+class VideoQualityAnalysisPerformanceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    reference_video_ =
+        OpenYuvFile(ResourcePath("foreman_cif", "yuv"), 352, 288);
+    ASSERT_TRUE(reference_video_);
+
+    // Every third reference frame is missing from the test video, and the test
+    // video loops twice over the reference video.
+    const size_t num_test_frames =
+        field_trial::IsEnabled("WebRTC-QuickPerfTest")
+            ? 30
+            : 2 * reference_video_->number_of_frames();
+    for (size_t i = 0; test_frame_indices_.size() < num_test_frames; ++i) {
+      if (i % 3 != 2)
+        test_frame_indices_.push_back(i);
+    }
+    test_video_ = ReorderVideo(reference_video_, test_frame_indices_);
+  }
+
+  rtc::scoped_refptr<Video> reference_video_;
+  std::vector<size_t> test_frame_indices_;
+  rtc::scoped_refptr<Video> test_video_;
+};
+
+TEST_F(VideoQualityAnalysisPerformanceTest, RunAnalysis) {
+  const rtc::scoped_refptr<Video> aligned_reference_video =
+      ReorderVideo(reference_video_, test_frame_indices_);
+  for (int num_threads : ThreadCounts()) {
+    MeasureAndReport("frame_analyzer_psnr_ssim", num_threads,
+                     test_frame_indices_.size(), [&] {
+                       RunAnalysis(aligned_reference_video, test_video_,
+                                   test_frame_indices_, num_threads);
+                     });
+  }
+}
+
+TEST_F(VideoQualityAnalysisPerformanceTest, FindMatchingFrameIndices) {
+  for (int num_threads : ThreadCounts()) {
+    std::vector<size_t> matched_indices;
+    MeasureAndReport("frame_analyzer_temporal_alignment", num_threads,
+                     test_frame_indices_.size(), [&] {
+                       matched_indices = FindMatchingFrameIndices(
+                           reference_video_, test_video_, num_threads);
+                     });
+    EXPECT_EQ(test_frame_indices_.size(), matched_indices.size());
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
@@ -20,7 +20,10 @@
 
 #include "api/video/i420_buffer.h"
 #include "api/video/video_frame_buffer.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_tools/frame_analyzer/thread_pool.h"
 #include "rtc_tools/frame_analyzer/video_quality_analysis.h"
 
 namespace webrtc {
@@ -36,6 +39,10 @@ namespace {
 // real match.
 const int kNumberOfFramesLookAhead = 60;
 
+// Number of test frames that are read and downscaled in parallel before they
+// are matched one by one.
+const size_t kTestFrameBatchSize = 64;
+
 // Helper class that takes a video and generates an infinite looping video.
 class LoopingVideo : public rtc::RefCountedObject<Video> {
  public:
@@ -126,12 +133,18 @@ class CachedVideo : public rtc::RefCountedObject<Video> {
 
   rtc::scoped_refptr<I420BufferInterface> GetFrame(
       size_t index) const override {
-    for (const CachedFrame& cached_frame : cache_) {
-      if (cached_frame.index == index)
-        return cached_frame.frame;
+    {
+      rtc::CritScope lock(&crit_);
+      for (const CachedFrame& cached_frame : cache_) {
+        if (cached_frame.index == index)
+          return cached_frame.frame;
+      }
     }
 
+    // Don't hold the lock while reading the frame, so that several threads
+    // can read frames at the same time.
     rtc::scoped_refptr<I420BufferInterface> frame = video_->GetFrame(index);
+    rtc::CritScope lock(&crit_);
     cache_.push_front({index, frame});
     if (cache_.size() > max_cache_size_)
       cache_.pop_back();
@@ -147,43 +160,65 @@ class CachedVideo : public rtc::RefCountedObject<Video> {
 
   const size_t max_cache_size_;
   const rtc::scoped_refptr<Video> video_;
-  mutable std::deque<CachedFrame> cache_;
+  rtc::CriticalSection crit_;
+  mutable std::deque<CachedFrame> cache_ RTC_GUARDED_BY(crit_);
 };
 
 // Try matching the test frame against all frames in the reference video and
 // return the index of the best matching frame.
 size_t FindBestMatch(const rtc::scoped_refptr<I420BufferInterface>& test_frame,
-                     const Video& reference_video) {
-  std::vector<double> ssim;
-  for (const auto& ref_frame : reference_video)
-    ssim.push_back(Ssim(test_frame, ref_frame));
+                     const Video& reference_video,
+                     ThreadPool* thread_pool) {
+  std::vector<double> ssim(reference_video.number_of_frames());
+  thread_pool->ParallelFor(ssim.size(), [&](size_t i) {
+    ssim[i] = Ssim(test_frame, reference_video.GetFrame(i));
+  });
   return std::distance(ssim.begin(),
                        std::max_element(ssim.begin(), ssim.end()));
 }
 
 // Find and return the index of the frame matching the test frame. The search
 // starts at the starting index and continues until there is no better match
-// within the next kNumberOfFramesLookAhead frames.
+// within the next kNumberOfFramesLookAhead frames. The SSIM values of a whole
+// look ahead window are calculated in parallel, and reused when the search
+// restarts at a better match.
 size_t FindNextMatch(const rtc::scoped_refptr<I420BufferInterface>& test_frame,
                      const Video& reference_video,
-                     size_t start_index) {
-  const double start_ssim =
-      Ssim(test_frame, reference_video.GetFrame(start_index));
-  for (int i = 1; i < kNumberOfFramesLookAhead; ++i) {
-    const size_t next_index = start_index + i;
+                     size_t start_index,
+                     ThreadPool* thread_pool) {
+  // |ssim[i]| is the SSIM of the reference frame at |start_index| + i.
+  std::vector<double> ssim;
+  size_t best_offset = 0;
+  while (true) {
+    const size_t calculated = ssim.size();
+    ssim.resize(best_offset + kNumberOfFramesLookAhead);
+    thread_pool->ParallelFor(ssim.size() - calculated, [&](size_t i) {
+      ssim[calculated + i] = Ssim(
+          test_frame, reference_video.GetFrame(start_index + calculated + i));
+    });
+
     // If we find a better match, restart the search at that point.
-    if (start_ssim < Ssim(test_frame, reference_video.GetFrame(next_index)))
-      return FindNextMatch(test_frame, reference_video, next_index);
+    size_t next_offset = best_offset;
+    for (size_t i = best_offset + 1; i < ssim.size(); ++i) {
+      if (ssim[best_offset] < ssim[i]) {
+        next_offset = i;
+        break;
+      }
+    }
+    if (next_offset == best_offset) {
+      // The current index was the best match.
+      return start_index + best_offset;
+    }
+    best_offset = next_offset;
   }
-  // The starting index was the best match.
-  return start_index;
 }
 
 }  // namespace
 
 std::vector<size_t> FindMatchingFrameIndices(
     const rtc::scoped_refptr<Video>& reference_video,
-    const rtc::scoped_refptr<Video>& test_video) {
+    const rtc::scoped_refptr<Video>& test_video,
+    int num_threads) {
   // This is done to get a 10x speedup. We don't need the full resolution in
   // order to match frames, and we should limit file access and not read the
   // same memory tens of times.
@@ -198,16 +233,33 @@ std::vector<size_t> FindMatchingFrameIndices(
   const rtc::scoped_refptr<Video> looping_reference_video =
       new LoopingVideo(cached_downscaled_reference_video);
 
+  ThreadPool thread_pool(num_threads);
   std::vector<size_t> match_indices;
-  for (const rtc::scoped_refptr<I420BufferInterface>& test_frame :
-       *downscaled_test_video) {
-    if (match_indices.empty()) {
-      // First frame.
-      match_indices.push_back(
-          FindBestMatch(test_frame, *cached_downscaled_reference_video));
-    } else {
-      match_indices.push_back(FindNextMatch(
-          test_frame, *looping_reference_video, match_indices.back()));
+  std::vector<rtc::scoped_refptr<I420BufferInterface>> test_frames;
+  const size_t number_of_test_frames =
+      downscaled_test_video->number_of_frames();
+  while (match_indices.size() < number_of_test_frames) {
+    // Each match depends on the previous one, so only the reading and
+    // downscaling of the test frames is done in batches in parallel.
+    const size_t first_frame = match_indices.size();
+    test_frames.resize(std::min(kTestFrameBatchSize,
+                                number_of_test_frames - first_frame));
+    thread_pool.ParallelFor(test_frames.size(), [&](size_t i) {
+      test_frames[i] = downscaled_test_video->GetFrame(first_frame + i);
+    });
+
+    for (const rtc::scoped_refptr<I420BufferInterface>& test_frame :
+         test_frames) {
+      if (match_indices.empty()) {
+        // First frame.
+        match_indices.push_back(FindBestMatch(
+            test_frame, *cached_downscaled_reference_video, &thread_pool));
+      } else {
+        match_indices.push_back(FindNextMatch(test_frame,
+                                              *looping_reference_video,
+                                              match_indices.back(),
+                                              &thread_pool));
+      }
     }
   }
 
@@ -26,10 +26,12 @@ namespace test {
 // indices are strictly increasing and might loop around the reference video,
 // e.g. their values can be bigger than the number of frames in the reference
 // video and they should be interpreted modulo that size. The matching frames
-// will be determined by maximizing SSIM.
+// will be determined by maximizing SSIM. The SSIM calculations are spread over
+// |num_threads| threads; the result does not depend on the number of threads.
 std::vector<size_t> FindMatchingFrameIndices(
     const rtc::scoped_refptr<Video>& reference_video,
-    const rtc::scoped_refptr<Video>& test_video);
+    const rtc::scoped_refptr<Video>& test_video,
+    int num_threads = 1);
 
 // Generate a new video using the frames from the original video. The returned
 // video will have the same number of frames as the size of |indices|, and
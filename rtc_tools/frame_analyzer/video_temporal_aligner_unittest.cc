@@ -101,6 +101,17 @@ TEST_F(VideoTemporalAlignerTest, FindMatchingFrameIndicesStressTest) {
   EXPECT_EQ(indices, matched_indices);
 }
 
+TEST_F(VideoTemporalAlignerTest, FindMatchingFrameIndicesMultipleThreads) {
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < reference_video->number_of_frames() * 2; i += 3)
+    indices.push_back(i % reference_video->number_of_frames());
+  rtc::scoped_refptr<Video> test_video = ReorderVideo(reference_video, indices);
+
+  EXPECT_EQ(FindMatchingFrameIndices(reference_video, test_video),
+            FindMatchingFrameIndices(reference_video, test_video,
+                                     /*num_threads=*/4));
+}
+
 TEST_F(VideoTemporalAlignerTest, GenerateAlignedReferenceVideo) {
   // Arbitrary start index.
   const size_t start_index = 12345;
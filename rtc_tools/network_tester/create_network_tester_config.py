@@ -13,11 +13,13 @@ import network_tester_config_pb2
 def AddConfig(all_configs,
               packet_send_interval_ms,
               packet_size,
-              execution_time_ms):
+              execution_time_ms,
+              packets_per_send=1):
   config = all_configs.configs.add()
   config.packet_send_interval_ms = packet_send_interval_ms
   config.packet_size = packet_size
   config.execution_time_ms = execution_time_ms
+  config.packets_per_send = packets_per_send
 
 def main():
   all_configs = network_tester_config_pb2.NetworkTesterAllConfigs()
@@ -11,34 +11,59 @@
 
 #include <string>
 
+#include "rtc_base/byte_order.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
 
+namespace {
+
+constexpr char kFileHeader[] = "NTPLOG01";
+constexpr size_t kFileHeaderSize = sizeof(kFileHeader) - 1;
+constexpr size_t kRecordSize = 28;
+constexpr size_t kFlushSize = 64 * 1024;
+
+}  // namespace
+
 PacketLogger::PacketLogger(const std::string& log_file_path)
     : packet_logger_stream_(log_file_path,
                             std::ios_base::out | std::ios_base::binary) {
   RTC_DCHECK(packet_logger_stream_.is_open());
   RTC_DCHECK(packet_logger_stream_.good());
+  packet_logger_stream_.write(kFileHeader, kFileHeaderSize);
+  buffer_.reserve(kFlushSize + kRecordSize);
 }
 
-PacketLogger::~PacketLogger() = default;
+PacketLogger::~PacketLogger() {
+  Flush();
+}
 
 void PacketLogger::LogPacket(const NetworkTesterPacket& packet) {
-  // The protobuffer message will be saved in the following format to the file:
+  // After the "NTPLOG01" file header, every received test packet is saved as
+  // a fixed size record of little endian values:
   // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  // |      1 byte      |  X byte |      1 byte      | ... |  X byte |
+  // |     8 bytes     |    8 bytes     |     8 bytes     |  4 bytes  |
   // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  // | Size of the next | proto   | Size of the next | ... | proto   |
-  // | proto message    | message | proto message    |     | message |
+  // | sequence number | send timestamp | arrival         | packet    |
+  // |                 | [us]           | timestamp [us]  | size      |
   // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-  std::string packet_data;
-  packet.SerializeToString(&packet_data);
-  RTC_DCHECK_LE(packet_data.length(), 255);
-  RTC_DCHECK_GE(packet_data.length(), 0);
-  char proto_size = packet_data.length();
-  packet_logger_stream_.write(&proto_size, sizeof(proto_size));
-  packet_logger_stream_.write(packet_data.data(), packet_data.length());
+  // Records are buffered and written in large chunks, so that logging keeps
+  // up with high packet rates.
+  size_t offset = buffer_.size();
+  buffer_.resize(offset + kRecordSize);
+  char* record = &buffer_[offset];
+  rtc::SetLE64(record, packet.sequence_number());
+  rtc::SetLE64(record + 8, packet.send_timestamp());
+  rtc::SetLE64(record + 16, packet.arrival_timestamp());
+  rtc::SetLE32(record + 24, packet.packet_size());
+  if (buffer_.size() >= kFlushSize)
+    Flush();
+}
+
+void PacketLogger::Flush() {
+  packet_logger_stream_.write(buffer_.data(), buffer_.size());
+  packet_logger_stream_.flush();
+  buffer_.clear();
 }
 
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "rtc_base/constructor_magic.h"
 #include "rtc_base/ignore_wundef.h"
@@ -35,8 +36,12 @@ class PacketLogger {
 
   void LogPacket(const NetworkTesterPacket& packet);
 
+  // Writes the buffered records to the file.
+  void Flush();
+
  private:
   std::ofstream packet_logger_stream_;
+  std::vector<char> buffer_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketLogger);
 };
@@ -14,6 +14,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "api/task_queue/default_task_queue_factory.h"
@@ -35,7 +36,7 @@ class SendPacketTask : public QueuedTask {
  private:
   bool Run() override {
     if (packet_sender_->IsSending()) {
-      packet_sender_->SendPacket();
+      packet_sender_->SendPackets();
       target_time_ms_ += packet_sender_->GetSendIntervalMs();
       int64_t delay_ms = std::max(static_cast<int64_t>(0),
                                   target_time_ms_ - rtc::TimeMillis());
@@ -62,7 +63,8 @@ class UpdateTestSettingTask : public QueuedTask {
     auto config = config_reader_->GetNextConfig();
     if (config) {
       packet_sender_->UpdateTestSetting((*config).packet_size,
-                                        (*config).packet_send_interval_ms);
+                                        (*config).packet_send_interval_ms,
+                                        (*config).packets_per_send);
       TaskQueueBase::Current()->PostDelayedTask(
           std::unique_ptr<QueuedTask>(this), (*config).execution_time_ms);
       return false;
@@ -81,6 +83,7 @@ PacketSender::PacketSender(TestController* test_controller,
                            const std::string& config_file_path)
     : packet_size_(0),
       send_interval_ms_(0),
+      packets_per_send_(1),
       sequence_number_(0),
       sending_(false),
       config_file_path_(config_file_path),
@@ -114,13 +117,15 @@ bool PacketSender::IsSending() const {
   return sending_;
 }
 
-void PacketSender::SendPacket() {
+void PacketSender::SendPackets() {
   RTC_DCHECK_RUN_ON(&worker_queue_checker_);
-  NetworkTesterPacket packet;
-  packet.set_type(NetworkTesterPacket::TEST_DATA);
-  packet.set_sequence_number(sequence_number_++);
-  packet.set_send_timestamp(rtc::TimeMicros());
-  test_controller_->SendData(packet, packet_size_);
+  std::vector<NetworkTesterPacket> packets(packets_per_send_);
+  for (NetworkTesterPacket& packet : packets) {
+    packet.set_type(NetworkTesterPacket::TEST_DATA);
+    packet.set_sequence_number(sequence_number_++);
+    packet.set_send_timestamp(rtc::TimeMicros());
+  }
+  test_controller_->SendDataBatch(packets, packet_size_);
 }
 
 int64_t PacketSender::GetSendIntervalMs() const {
@@ -129,10 +134,12 @@ int64_t PacketSender::GetSendIntervalMs() const {
 }
 
 void PacketSender::UpdateTestSetting(size_t packet_size,
-                                     int64_t send_interval_ms) {
+                                     int64_t send_interval_ms,
+                                     int packets_per_send) {
   RTC_DCHECK_RUN_ON(&worker_queue_checker_);
   send_interval_ms_ = send_interval_ms;
   packet_size_ = packet_size;
+  packets_per_send_ = packets_per_send;
 }
 
 }  // namespace webrtc
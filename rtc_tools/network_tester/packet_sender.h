@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "api/task_queue/task_queue_factory.h"
 #include "rtc_base/constructor_magic.h"
@@ -43,15 +44,19 @@ class PacketSender {
   void StopSending();
   bool IsSending() const;
 
-  void SendPacket();
+  // Sends the configured number of packets for one send interval.
+  void SendPackets();
 
   int64_t GetSendIntervalMs() const;
-  void UpdateTestSetting(size_t packet_size, int64_t send_interval_ms);
+  void UpdateTestSetting(size_t packet_size,
+                         int64_t send_interval_ms,
+                         int packets_per_send);
 
  private:
   SequenceChecker worker_queue_checker_;
   size_t packet_size_ RTC_GUARDED_BY(worker_queue_checker_);
   int64_t send_interval_ms_ RTC_GUARDED_BY(worker_queue_checker_);
+  int packets_per_send_ RTC_GUARDED_BY(worker_queue_checker_);
   int64_t sequence_number_ RTC_GUARDED_BY(worker_queue_checker_);
   bool sending_ RTC_GUARDED_BY(worker_queue_checker_);
   const std::string config_file_path_;
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/network_tester/packet_statistics.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "rtc_base/strings/string_builder.h"
+
+namespace webrtc {
+
+namespace {
+
+// Returns the value below which |percentile| of |values| fall, reordering
+// |values| in the process.
+int64_t Percentile(std::vector<int64_t>* values, double percentile) {
+  size_t index = static_cast<size_t>(percentile * (values->size() - 1));
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
+}  // namespace
+
+std::string PacketStatistics::Summary::ToString() const {
+  rtc::StringBuilder sb;
+  sb << "received: " << received_packets << ", lost: " << lost_packets
+     << ", bitrate: " << bitrate_bps / 1000 << " kbps"
+     << ", jitter: " << jitter_us << " us"
+     << ", delay p50/p95/p99/max: " << delay_p50_us << "/" << delay_p95_us
+     << "/" << delay_p99_us << "/" << delay_max_us << " us";
+  return sb.Release();
+}
+
+PacketStatistics::PacketStatistics() {
+  Reset();
+}
+
+PacketStatistics::~PacketStatistics() = default;
+
+void PacketStatistics::AddPacket(int64_t sequence_number,
+                                 int64_t send_time_us,
+                                 int64_t arrival_time_us,
+                                 size_t packet_size) {
+  if (!has_packets_) {
+    has_packets_ = true;
+    // Packets before the first one received were lost too.
+    interval_start_sequence_number_ = -1;
+    interval_start_time_us_ = arrival_time_us;
+  } else {
+    int64_t transit_change = (arrival_time_us - last_arrival_time_us_) -
+                             (send_time_us - last_send_time_us_);
+    jitter_us_ += (std::abs(transit_change) - jitter_us_) / 16;
+  }
+  last_arrival_time_us_ = arrival_time_us;
+  last_send_time_us_ = send_time_us;
+  highest_sequence_number_ =
+      std::max(highest_sequence_number_, sequence_number);
+
+  int64_t delay_us = arrival_time_us - send_time_us;
+  min_delay_us_ = std::min(min_delay_us_, delay_us);
+  interval_delays_us_.push_back(delay_us);
+  ++interval_packets_;
+  interval_bytes_ += packet_size;
+}
+
+PacketStatistics::Summary PacketStatistics::GetIntervalSummary() {
+  Summary summary;
+  summary.received_packets = interval_packets_;
+  summary.lost_packets = std::max<int64_t>(
+      0, highest_sequence_number_ - interval_start_sequence_number_ -
+             interval_packets_);
+  int64_t duration_us = last_arrival_time_us_ - interval_start_time_us_;
+  if (duration_us > 0)
+    summary.bitrate_bps = interval_bytes_ * 8 * 1000000 / duration_us;
+  summary.jitter_us = static_cast<int64_t>(jitter_us_);
+  if (!interval_delays_us_.empty()) {
+    for (int64_t& delay_us : interval_delays_us_)
+      delay_us -= min_delay_us_;
+    summary.delay_max_us = *std::max_element(interval_delays_us_.begin(),
+                                             interval_delays_us_.end());
+    summary.delay_p99_us = Percentile(&interval_delays_us_, 0.99);
+    summary.delay_p95_us = Percentile(&interval_delays_us_, 0.95);
+    summary.delay_p50_us = Percentile(&interval_delays_us_, 0.5);
+  }
+
+  interval_start_sequence_number_ = highest_sequence_number_;
+  interval_start_time_us_ = last_arrival_time_us_;
+  interval_packets_ = 0;
+  interval_bytes_ = 0;
+  interval_delays_us_.clear();
+  return summary;
+}
+
+void PacketStatistics::Reset() {
+  has_packets_ = false;
+  highest_sequence_number_ = -1;
+  interval_start_sequence_number_ = -1;
+  interval_start_time_us_ = 0;
+  last_arrival_time_us_ = 0;
+  last_send_time_us_ = 0;
+  min_delay_us_ = std::numeric_limits<int64_t>::max();
+  jitter_us_ = 0;
+  interval_packets_ = 0;
+  interval_bytes_ = 0;
+  interval_delays_us_.clear();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_NETWORK_TESTER_PACKET_STATISTICS_H_
+#define RTC_TOOLS_NETWORK_TESTER_PACKET_STATISTICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace webrtc {
+
+// Summarizes the test packets received from the remote side, in intervals,
+// so that loss, jitter and one-way delay can be followed while a test runs.
+// The clocks of the two sides aren't synchronized, so the one-way delay is
+// reported relative to the smallest delay seen since the test started.
+class PacketStatistics {
+ public:
+  struct Summary {
+    std::string ToString() const;
+
+    int64_t received_packets = 0;
+    int64_t lost_packets = 0;
+    int64_t bitrate_bps = 0;
+    // Interarrival jitter, estimated as in RFC 3550 section 6.4.1.
+    int64_t jitter_us = 0;
+    // Distribution of the one-way delay above the smallest delay.
+    int64_t delay_p50_us = 0;
+    int64_t delay_p95_us = 0;
+    int64_t delay_p99_us = 0;
+    int64_t delay_max_us = 0;
+  };
+
+  PacketStatistics();
+  ~PacketStatistics();
+
+  void AddPacket(int64_t sequence_number,
+                 int64_t send_time_us,
+                 int64_t arrival_time_us,
+                 size_t packet_size);
+
+  // Returns the summary of the packets added since the previous call, and
+  // starts a new interval.
+  Summary GetIntervalSummary();
+
+  // Forgets everything, for when the remote side starts a new test and its
+  // sequence numbers start over.
+  void Reset();
+
+ private:
+  bool has_packets_;
+  int64_t highest_sequence_number_;
+  int64_t interval_start_sequence_number_;
+  int64_t interval_start_time_us_;
+  int64_t last_arrival_time_us_;
+  int64_t last_send_time_us_;
+  int64_t min_delay_us_;
+  double jitter_us_;
+  int64_t interval_packets_;
+  int64_t interval_bytes_;
+  // Raw one-way delays of the packets in the current interval.
+  std::vector<int64_t> interval_delays_us_;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_NETWORK_TESTER_PACKET_STATISTICS_H_
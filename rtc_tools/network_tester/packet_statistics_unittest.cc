@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/network_tester/packet_statistics.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int64_t kClockOffsetUs = 123456789;
+constexpr size_t kPacketSize = 1000;
+
+TEST(PacketStatisticsTest, CountsLostPacketsPerInterval) {
+  PacketStatistics statistics;
+  // Packets 0 to 9 every millisecond, without 3 and 4.
+  for (int64_t i = 0; i < 10; ++i) {
+    if (i == 3 || i == 4)
+      continue;
+    statistics.AddPacket(i, i * 1000, kClockOffsetUs + i * 1000, kPacketSize);
+  }
+  PacketStatistics::Summary summary = statistics.GetIntervalSummary();
+  EXPECT_EQ(8, summary.received_packets);
+  EXPECT_EQ(2, summary.lost_packets);
+  // 8 packets of 8000 bits over 9 ms.
+  EXPECT_EQ(8 * 8000 * 1000 / 9, summary.bitrate_bps);
+  EXPECT_EQ(0, summary.jitter_us);
+  EXPECT_EQ(0, summary.delay_max_us);
+
+  // A reordered packet from the previous interval makes up for one lost in
+  // this one.
+  statistics.AddPacket(11, 11000, kClockOffsetUs + 11000, kPacketSize);
+  statistics.AddPacket(3, 3000, kClockOffsetUs + 11500, kPacketSize);
+  summary = statistics.GetIntervalSummary();
+  EXPECT_EQ(2, summary.received_packets);
+  EXPECT_EQ(0, summary.lost_packets);
+}
+
+TEST(PacketStatisticsTest, ReportsDelayAboveTheSmallestDelay) {
+  PacketStatistics statistics;
+  // Delays of 0 to 99 ms above the clock offset, in a shuffled order.
+  for (int64_t i = 0; i < 100; ++i) {
+    int64_t extra_delay_us = (i * 37 % 100) * 1000;
+    statistics.AddPacket(i, i * 1000,
+                         kClockOffsetUs + i * 1000 + extra_delay_us,
+                         kPacketSize);
+  }
+  PacketStatistics::Summary summary = statistics.GetIntervalSummary();
+  EXPECT_EQ(0, summary.lost_packets);
+  EXPECT_EQ(49000, summary.delay_p50_us);
+  EXPECT_EQ(94000, summary.delay_p95_us);
+  EXPECT_EQ(98000, summary.delay_p99_us);
+  EXPECT_EQ(99000, summary.delay_max_us);
+  EXPECT_GT(summary.jitter_us, 0);
+}
+
+TEST(PacketStatisticsTest, StartsOverAfterReset) {
+  PacketStatistics statistics;
+  statistics.AddPacket(100, 0, kClockOffsetUs, kPacketSize);
+  statistics.GetIntervalSummary();
+  statistics.Reset();
+
+  statistics.AddPacket(0, 0, kClockOffsetUs, kPacketSize);
+  statistics.AddPacket(1, 1000, kClockOffsetUs + 1000, kPacketSize);
+  PacketStatistics::Summary summary = statistics.GetIntervalSummary();
+  EXPECT_EQ(2, summary.received_packets);
+  EXPECT_EQ(0, summary.lost_packets);
+
+  summary = statistics.GetIntervalSummary();
+  EXPECT_EQ(0, summary.received_packets);
+  EXPECT_EQ(0, summary.lost_packets);
+  EXPECT_EQ(0, summary.bitrate_bps);
+}
+
+}  // namespace
+}  // namespace webrtc
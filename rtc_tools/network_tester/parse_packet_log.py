@@ -6,19 +6,28 @@
 #  in the file PATENTS.  All contributing project authors may
 #  be found in the AUTHORS file in the root of the source tree.
 
-#  To run this script please copy "out/<build_name>/pyproto/webrtc/rtc_tools/
-#  network_tester/network_tester_packet_pb2.py" next to this script.
-#  The you can run this script with:
+#  You can run this script with:
 #  "python parse_packet_log.py -f packet_log.dat"
 #  for more information call:
 #  "python parse_packet_log.py --help"
+#  To parse logs written before the compact log format, please copy
+#  "out/<build_name>/pyproto/webrtc/rtc_tools/network_tester/
+#  network_tester_packet_pb2.py" next to this script.
 
+import collections
 from optparse import OptionParser
 import struct
 
 import matplotlib.pyplot as plt
 
-import network_tester_packet_pb2
+FILE_HEADER = b'NTPLOG01'
+# Sequence number, send timestamp, arrival timestamp and packet size.
+RECORD_FORMAT = '<qqqi'
+
+Packet = collections.namedtuple('Packet', [
+    'sequence_number', 'send_timestamp', 'arrival_timestamp', 'packet_size'
+])
+
 
 def GetSize(file_to_parse):
   data = file_to_parse.read(1)
@@ -27,22 +36,41 @@ def GetSize(file_to_parse):
   return struct.unpack('<b', data)[0]
 
 
-def ParsePacketLog(packet_log_file_to_parse):
+def ParseProtoPacketLog(file_to_parse):
+  import network_tester_packet_pb2
   packets = []
-  with open(packet_log_file_to_parse, 'rb') as file_to_parse:
-    while True:
-      size = GetSize(file_to_parse)
-      if size == 0:
-        break
-      try:
-        packet = network_tester_packet_pb2.NetworkTesterPacket()
-        packet.ParseFromString(file_to_parse.read(size))
-        packets.append(packet)
-      except IOError:
-        break
+  while True:
+    size = GetSize(file_to_parse)
+    if size == 0:
+      break
+    try:
+      packet = network_tester_packet_pb2.NetworkTesterPacket()
+      packet.ParseFromString(file_to_parse.read(size))
+      packets.append(packet)
+    except IOError:
+      break
+  return packets
+
+
+def ParseCompactPacketLog(file_to_parse):
+  record_size = struct.calcsize(RECORD_FORMAT)
+  packets = []
+  while True:
+    data = file_to_parse.read(record_size)
+    if len(data) < record_size:
+      break
+    packets.append(Packet(*struct.unpack(RECORD_FORMAT, data)))
   return packets
 
 
+def ParsePacketLog(packet_log_file_to_parse):
+  with open(packet_log_file_to_parse, 'rb') as file_to_parse:
+    if file_to_parse.read(len(FILE_HEADER)) == FILE_HEADER:
+      return ParseCompactPacketLog(file_to_parse)
+    file_to_parse.seek(0)
+    return ParseProtoPacketLog(file_to_parse)
+
+
 def GetTimeAxis(packets):
   first_arrival_time = packets[0].arrival_timestamp
   return [(packet.arrival_timestamp - first_arrival_time) / 1000000.0
@@ -11,14 +11,23 @@
 #include "rtc_tools/network_tester/test_controller.h"
 
 #include <limits>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/ip_address.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/time_utils.h"
 
 namespace webrtc {
 
+namespace {
+
+constexpr int64_t kStatisticsIntervalMs = 1000;
+
+}  // namespace
+
 TestController::TestController(int min_port,
                                int max_port,
                                const std::string& config_file_path,
@@ -27,10 +36,14 @@ TestController::TestController(int min_port,
       config_file_path_(config_file_path),
       packet_logger_(log_file_path),
       local_test_done_(false),
-      remote_test_done_(false) {
+      remote_test_done_(false),
+      next_statistics_time_ms_(0) {
   RTC_DCHECK_RUN_ON(&test_controller_thread_checker_);
   packet_sender_checker_.Detach();
-  send_data_.fill(42);
+  {
+    rtc::CritScope lock(&send_lock_);
+    send_data_.fill(42);
+  }
   udp_socket_ =
       std::unique_ptr<rtc::AsyncPacketSocket>(socket_factory_.CreateUdpSocket(
           rtc::SocketAddress(rtc::GetAnyIP(AF_INET), 0), min_port, max_port));
@@ -56,6 +69,22 @@ void TestController::Run() {
 void TestController::SendData(const NetworkTesterPacket& packet,
                               absl::optional<size_t> data_size) {
   // Can be call from packet_sender or from test_controller thread.
+  rtc::CritScope lock(&send_lock_);
+  SendDataLocked(packet, data_size);
+}
+
+void TestController::SendDataBatch(
+    const std::vector<NetworkTesterPacket>& packets,
+    size_t data_size) {
+  rtc::CritScope lock(&send_lock_);
+  udp_socket_->StartSendBatch();
+  for (const NetworkTesterPacket& packet : packets)
+    SendDataLocked(packet, data_size);
+  udp_socket_->FlushSendBatch();
+}
+
+void TestController::SendDataLocked(const NetworkTesterPacket& packet,
+                                    absl::optional<size_t> data_size) {
   size_t packet_size = packet.ByteSizeLong();
   send_data_[0] = packet_size;
   packet_size++;
@@ -100,6 +129,7 @@ void TestController::OnReadPacket(rtc::AsyncPacketSocket* socket,
       SendData(packet, absl::nullopt);
       packet_sender_.reset(new PacketSender(this, config_file_path_));
       packet_sender_->StartSending();
+      packet_statistics_.Reset();
       rtc::CritScope scoped_lock(&local_test_done_lock_);
       local_test_done_ = false;
       remote_test_done_ = false;
@@ -108,6 +138,7 @@ void TestController::OnReadPacket(rtc::AsyncPacketSocket* socket,
     case NetworkTesterPacket::TEST_START: {
       packet_sender_.reset(new PacketSender(this, config_file_path_));
       packet_sender_->StartSending();
+      packet_statistics_.Reset();
       rtc::CritScope scoped_lock(&local_test_done_lock_);
       local_test_done_ = false;
       remote_test_done_ = false;
@@ -117,10 +148,17 @@ void TestController::OnReadPacket(rtc::AsyncPacketSocket* socket,
       packet.set_arrival_timestamp(packet_time_us);
       packet.set_packet_size(len);
       packet_logger_.LogPacket(packet);
+      packet_statistics_.AddPacket(packet.sequence_number(),
+                                   packet.send_timestamp(), packet_time_us,
+                                   len);
+      if (rtc::TimeMillis() >= next_statistics_time_ms_)
+        LogStatistics();
       break;
     }
     case NetworkTesterPacket::TEST_DONE: {
       remote_test_done_ = true;
+      LogStatistics();
+      packet_logger_.Flush();
       break;
     }
     default: {
@@ -129,4 +167,11 @@ void TestController::OnReadPacket(rtc::AsyncPacketSocket* socket,
   }
 }
 
+void TestController::LogStatistics() {
+  RTC_DCHECK_RUN_ON(&test_controller_thread_checker_);
+  next_statistics_time_ms_ = rtc::TimeMillis() + kStatisticsIntervalMs;
+  RTC_LOG(LS_INFO) << "Received from " << remote_address_.ToString() << ": "
+                   << packet_statistics_.GetIntervalSummary().ToString();
+}
+
 }  // namespace webrtc
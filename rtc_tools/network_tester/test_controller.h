@@ -17,6 +17,7 @@
 #include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "p2p/base/basic_packet_socket_factory.h"
@@ -31,6 +32,7 @@
 #include "rtc_base/thread_checker.h"
 #include "rtc_tools/network_tester/packet_logger.h"
 #include "rtc_tools/network_tester/packet_sender.h"
+#include "rtc_tools/network_tester/packet_statistics.h"
 
 #ifdef WEBRTC_NETWORK_TESTER_PROTO
 RTC_PUSH_IGNORING_WUNDEF()
@@ -60,6 +62,11 @@ class TestController : public sigslot::has_slots<> {
   void SendData(const NetworkTesterPacket& packet,
                 absl::optional<size_t> data_size);
 
+  // Sends |packets| padded to |data_size| with as few socket writes as the
+  // socket supports.
+  void SendDataBatch(const std::vector<NetworkTesterPacket>& packets,
+                     size_t data_size);
+
   void OnTestDone();
 
   bool IsTestDone();
@@ -70,6 +77,11 @@ class TestController : public sigslot::has_slots<> {
                     size_t len,
                     const rtc::SocketAddress& remote_addr,
                     const int64_t& packet_time_us);
+  void SendDataLocked(const NetworkTesterPacket& packet,
+                      absl::optional<size_t> data_size)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(send_lock_);
+  void LogStatistics();
+
   rtc::ThreadChecker test_controller_thread_checker_;
   SequenceChecker packet_sender_checker_;
   rtc::BasicPacketSocketFactory socket_factory_;
@@ -78,7 +90,12 @@ class TestController : public sigslot::has_slots<> {
   rtc::CriticalSection local_test_done_lock_;
   bool local_test_done_ RTC_GUARDED_BY(local_test_done_lock_);
   bool remote_test_done_;
-  std::array<char, kEthernetMtu> send_data_;
+  // Packets are sent both from the packet sender's queue and from this
+  // thread.
+  rtc::CriticalSection send_lock_;
+  std::array<char, kEthernetMtu> send_data_ RTC_GUARDED_BY(send_lock_);
+  PacketStatistics packet_statistics_;
+  int64_t next_statistics_time_ms_;
   std::unique_ptr<rtc::AsyncPacketSocket> udp_socket_;
   rtc::SocketAddress remote_address_;
   std::unique_ptr<PacketSender> packet_sender_;
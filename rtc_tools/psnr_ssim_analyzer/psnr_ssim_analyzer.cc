@@ -13,14 +13,17 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
 #include "api/scoped_refptr.h"
 #include "api/video/video_frame_buffer.h"
+#include "rtc_tools/frame_analyzer/thread_pool.h"
 #include "rtc_tools/frame_analyzer/video_quality_analysis.h"
 #include "rtc_tools/video_file_reader.h"
+#include "system_wrappers/include/cpu_info.h"
 
 ABSL_FLAG(std::string,
           results_file,
@@ -34,26 +37,37 @@ ABSL_FLAG(std::string,
           test_file,
           "test.yuv",
           "The test YUV file to run the analysis for");
+ABSL_FLAG(int,
+          num_threads,
+          0,
+          "Number of frames to analyze in parallel; 0 means one per core");
 
 void CompareFiles(
     const rtc::scoped_refptr<webrtc::test::Video>& reference_video,
     const rtc::scoped_refptr<webrtc::test::Video>& test_video,
-    const char* results_file_name) {
+    const char* results_file_name,
+    int num_threads) {
   FILE* results_file = fopen(results_file_name, "w");
 
   const size_t num_frames = std::min(reference_video->number_of_frames(),
                                      test_video->number_of_frames());
-  for (size_t i = 0; i < num_frames; ++i) {
+  std::vector<double> psnr(num_frames);
+  std::vector<double> ssim(num_frames);
+  webrtc::test::ThreadPool thread_pool(num_threads);
+  thread_pool.ParallelFor(num_frames, [&](size_t i) {
     const rtc::scoped_refptr<webrtc::I420BufferInterface> ref_buffer =
         reference_video->GetFrame(i);
     const rtc::scoped_refptr<webrtc::I420BufferInterface> test_buffer =
         test_video->GetFrame(i);
 
     // Calculate the PSNR and SSIM.
-    double result_psnr = webrtc::test::Psnr(ref_buffer, test_buffer);
-    double result_ssim = webrtc::test::Ssim(ref_buffer, test_buffer);
-    fprintf(results_file, "Frame: %zu, PSNR: %f, SSIM: %f\n", i, result_psnr,
-            result_ssim);
+    psnr[i] = webrtc::test::Psnr(ref_buffer, test_buffer);
+    ssim[i] = webrtc::test::Ssim(ref_buffer, test_buffer);
+  });
+
+  for (size_t i = 0; i < num_frames; ++i) {
+    fprintf(results_file, "Frame: %zu, PSNR: %f, SSIM: %f\n", i, psnr[i],
+            ssim[i]);
   }
 
   fclose(results_file);
@@ -102,7 +116,12 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  int num_threads = absl::GetFlag(FLAGS_num_threads);
+  if (num_threads <= 0) {
+    num_threads = webrtc::CpuInfo::DetectNumberOfCores();
+  }
+
   CompareFiles(reference_video, test_video,
-               absl::GetFlag(FLAGS_results_file).c_str());
+               absl::GetFlag(FLAGS_results_file).c_str(), num_threads);
   return 0;
 }
@@ -2190,6 +2190,7 @@ void EventLogAnalyzer::CreateIceCandidatePairConfigGraph(Plot* plot) {
           TimeSeries("[" + std::to_string(config.candidate_pair_id) + "]" +
                          candidate_pair_desc,
                      LineStyle::kNone, PointStyle::kHighlight);
+      rtc::CritScope lock(&candidate_pair_desc_crit_);
       candidate_pair_desc_by_id_[config.candidate_pair_id] =
           candidate_pair_desc;
     }
@@ -2220,6 +2221,7 @@ void EventLogAnalyzer::CreateIceCandidatePairConfigGraph(Plot* plot) {
 
 std::string EventLogAnalyzer::GetCandidatePairLogDescriptionFromId(
     uint32_t candidate_pair_id) {
+  rtc::CritScope lock(&candidate_pair_desc_crit_);
   if (candidate_pair_desc_by_id_.find(candidate_pair_id) !=
       candidate_pair_desc_by_id_.end()) {
     return candidate_pair_desc_by_id_[candidate_pair_id];
@@ -20,7 +20,9 @@
 
 #include "logging/rtc_event_log/rtc_event_log_parser.h"
 #include "modules/audio_coding/neteq/tools/neteq_stats_getter.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_tools/rtc_event_log_visualizer/analyzer_common.h"
 #include "rtc_tools/rtc_event_log_visualizer/plot_base.h"
 
@@ -137,7 +139,10 @@ class EventLogAnalyzer {
   // If left empty, all SSRCs will be considered relevant.
   std::vector<uint32_t> desired_ssrc_;
 
-  std::map<uint32_t, std::string> candidate_pair_desc_by_id_;
+  // Plots may be created concurrently, and the ICE plots share this cache.
+  rtc::CriticalSection candidate_pair_desc_crit_;
+  std::map<uint32_t, std::string> candidate_pair_desc_by_id_
+      RTC_GUARDED_BY(candidate_pair_desc_crit_);
 
   AnalyzerConfig config_;
 };
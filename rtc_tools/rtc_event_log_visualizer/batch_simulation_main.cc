@@ -0,0 +1,338 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Replays a set of RTC event logs through a set of network controller
+// configurations and prints aggregate metrics, one CSV line per log and
+// configuration. Used to evaluate congestion controller changes against
+// recorded traffic.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "api/transport/goog_cc_factory.h"
+#include "api/transport/webrtc_key_value_config.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "logging/rtc_event_log/rtc_event_log_parser.h"
+#include "modules/congestion_controller/pcc/pcc_factory.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_tools/rtc_event_log_visualizer/log_simulation.h"
+
+ABSL_FLAG(std::string,
+          controllers,
+          "goog_cc",
+          "Semicolon separated list of controller configurations, each on the "
+          "form [label=]type[:field_trials], where type is goog_cc or pcc and "
+          "field_trials is a field trial string, e.g. "
+          "\"base=goog_cc;no_alr=goog_cc:WebRTC-ProbingScreenshareBwe/"
+          "Disabled/\".");
+
+ABSL_FLAG(std::string,
+          log_list,
+          "",
+          "File with one event log path per line, in addition to the logs "
+          "given on the command line.");
+
+ABSL_FLAG(int, threads, 1, "Number of logs to simulate in parallel.");
+
+namespace webrtc {
+namespace {
+
+constexpr TimeDelta kSamplingInterval = TimeDelta::Millis(100);
+
+// Field trials of a single controller configuration, on the usual
+// "Key1/Value1/Key2/Value2/" form. Unlike the global field trials, several of
+// these can be used at the same time.
+class FieldTrialStringConfig : public WebRtcKeyValueConfig {
+ public:
+  explicit FieldTrialStringConfig(absl::string_view field_trials) {
+    size_t pos = 0;
+    while (pos < field_trials.size()) {
+      size_t key_end = field_trials.find('/', pos);
+      if (key_end == absl::string_view::npos)
+        break;
+      size_t value_end = field_trials.find('/', key_end + 1);
+      if (value_end == absl::string_view::npos)
+        break;
+      trials_[std::string(field_trials.substr(pos, key_end - pos))] =
+          std::string(
+              field_trials.substr(key_end + 1, value_end - key_end - 1));
+      pos = value_end + 1;
+    }
+  }
+
+  std::string Lookup(absl::string_view key) const override {
+    auto it = trials_.find(std::string(key));
+    return it != trials_.end() ? it->second : "";
+  }
+
+ private:
+  std::map<std::string, std::string> trials_;
+};
+
+struct ControllerConfig {
+  std::string label;
+  std::string type;
+  std::unique_ptr<FieldTrialStringConfig> field_trials;
+};
+
+bool ParseControllerConfigs(const std::string& flag,
+                            std::vector<ControllerConfig>* configs) {
+  size_t pos = 0;
+  while (pos < flag.size()) {
+    size_t end = std::min(flag.find(';', pos), flag.size());
+    std::string spec = flag.substr(pos, end - pos);
+    pos = end + 1;
+    if (spec.empty())
+      continue;
+    ControllerConfig config;
+    size_t label_end = spec.find('=');
+    size_t type_begin = label_end == std::string::npos ? 0 : label_end + 1;
+    size_t type_end = std::min(spec.find(':', type_begin), spec.size());
+    config.type = spec.substr(type_begin, type_end - type_begin);
+    config.label = label_end == std::string::npos ? spec.substr(0, type_end)
+                                                  : spec.substr(0, label_end);
+    config.field_trials = std::make_unique<FieldTrialStringConfig>(
+        type_end < spec.size() ? spec.substr(type_end + 1) : "");
+    if (config.type != "goog_cc" && config.type != "pcc") {
+      std::cerr << "Unknown controller type '" << config.type << "'."
+                << std::endl;
+      return false;
+    }
+    configs->push_back(std::move(config));
+  }
+  return !configs->empty();
+}
+
+std::unique_ptr<NetworkControllerFactoryInterface> CreateFactory(
+    const ControllerConfig& config) {
+  if (config.type == "pcc")
+    return std::make_unique<PccNetworkControllerFactory>();
+  return std::make_unique<GoogCcNetworkControllerFactory>();
+}
+
+// A piecewise constant rate, sampled at regular intervals.
+class RateSampler {
+ public:
+  explicit RateSampler(std::vector<std::pair<Timestamp, DataRate>> rates)
+      : rates_(std::move(rates)) {}
+
+  // Returns the last rate set at or before |at_time|, if any.
+  absl::optional<DataRate> RateAt(Timestamp at_time) {
+    while (next_ < rates_.size() && rates_[next_].first <= at_time)
+      ++next_;
+    if (next_ == 0)
+      return absl::nullopt;
+    return rates_[next_ - 1].second;
+  }
+
+ private:
+  const std::vector<std::pair<Timestamp, DataRate>> rates_;
+  size_t next_ = 0;
+};
+
+struct SimulationMetrics {
+  bool ok = false;
+  double duration_s = 0;
+  double mean_target_kbps = 0;
+  double mean_logged_target_kbps = 0;
+  // Mean absolute difference between the simulated target rate and the rate
+  // the logged (real) controller used, over the time both were known.
+  double mean_target_error_kbps = 0;
+  int probe_clusters = 0;
+  int logged_probe_clusters = 0;
+};
+
+SimulationMetrics Simulate(const ParsedRtcEventLog& parsed_log,
+                           const ControllerConfig& config) {
+  SimulationMetrics metrics;
+  std::vector<std::pair<Timestamp, DataRate>> target_rates;
+  LogBasedNetworkControllerSimulation simulation(
+      CreateFactory(config),
+      [&](const NetworkControlUpdate& update, Timestamp at_time) {
+        if (update.target_rate) {
+          target_rates.emplace_back(at_time, update.target_rate->target_rate);
+        }
+        metrics.probe_clusters += update.probe_cluster_configs.size();
+      },
+      config.field_trials.get());
+  simulation.ProcessEventsInLog(parsed_log);
+
+  std::vector<std::pair<Timestamp, DataRate>> logged_rates;
+  for (const auto& logged : parsed_log.bwe_loss_updates()) {
+    logged_rates.emplace_back(Timestamp::Micros(logged.log_time_us()),
+                              DataRate::BitsPerSec(logged.bitrate_bps));
+  }
+  metrics.logged_probe_clusters =
+      parsed_log.bwe_probe_cluster_created_events().size();
+
+  const Timestamp begin = Timestamp::Micros(parsed_log.first_timestamp());
+  const Timestamp end = Timestamp::Micros(parsed_log.last_timestamp());
+  if (end <= begin)
+    return metrics;
+  metrics.ok = true;
+  metrics.duration_s = (end - begin).seconds<double>();
+
+  RateSampler simulated(std::move(target_rates));
+  RateSampler logged(std::move(logged_rates));
+  int num_simulated = 0;
+  int num_logged = 0;
+  int num_both = 0;
+  double sum_simulated_kbps = 0;
+  double sum_logged_kbps = 0;
+  double sum_error_kbps = 0;
+  for (Timestamp t = begin; t <= end; t += kSamplingInterval) {
+    absl::optional<DataRate> simulated_rate = simulated.RateAt(t);
+    absl::optional<DataRate> logged_rate = logged.RateAt(t);
+    if (simulated_rate) {
+      ++num_simulated;
+      sum_simulated_kbps += simulated_rate->kbps<double>();
+    }
+    if (logged_rate) {
+      ++num_logged;
+      sum_logged_kbps += logged_rate->kbps<double>();
+    }
+    if (simulated_rate && logged_rate) {
+      ++num_both;
+      sum_error_kbps += std::abs(simulated_rate->kbps<double>() -
+                                 logged_rate->kbps<double>());
+    }
+  }
+  if (num_simulated > 0)
+    metrics.mean_target_kbps = sum_simulated_kbps / num_simulated;
+  if (num_logged > 0)
+    metrics.mean_logged_target_kbps = sum_logged_kbps / num_logged;
+  if (num_both > 0)
+    metrics.mean_target_error_kbps = sum_error_kbps / num_both;
+  return metrics;
+}
+
+// The logs to simulate, shared by the threads simulating them. Each log is
+// parsed once and replayed through every configuration.
+struct SimulationQueue {
+  std::vector<std::string> log_files;
+  const std::vector<ControllerConfig>* configs;
+  // Indexed by log, then by configuration.
+  std::vector<std::vector<SimulationMetrics>> results;
+  std::atomic<size_t> next_log{0};
+};
+
+void RunSimulationsOnCurrentThread(void* obj) {
+  SimulationQueue* queue = static_cast<SimulationQueue*>(obj);
+  for (size_t i = queue->next_log++; i < queue->log_files.size();
+       i = queue->next_log++) {
+    ParsedRtcEventLog parsed_log(
+        ParsedRtcEventLog::UnconfiguredHeaderExtensions::
+            kAttemptWebrtcDefaultConfig,
+        /*allow_incomplete_logs=*/true);
+    auto status = parsed_log.ParseFile(queue->log_files[i]);
+    if (!status.ok()) {
+      RTC_LOG(LS_WARNING) << "Failed to parse " << queue->log_files[i] << ": "
+                          << status.message();
+      continue;
+    }
+    for (size_t j = 0; j < queue->configs->size(); ++j) {
+      queue->results[i][j] = Simulate(parsed_log, (*queue->configs)[j]);
+    }
+  }
+}
+
+void RunSimulations(SimulationQueue* queue, int num_threads) {
+  num_threads =
+      std::min(num_threads, static_cast<int>(queue->log_files.size()));
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        &RunSimulationsOnCurrentThread, queue, "simulation_worker"));
+    threads.back()->Start();
+  }
+  RunSimulationsOnCurrentThread(queue);
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  absl::SetProgramUsageMessage(
+      "Replays RTC event logs through network controllers and prints "
+      "aggregate metrics as CSV.\n"
+      "Example usage:\n"
+      "./event_log_batch_simulation --threads=8 "
+      "--controllers=\"goog_cc;pcc\" <logfile>...\n");
+  std::vector<char*> args = absl::ParseCommandLine(argc, argv);
+  rtc::LogMessage::LogToDebug(rtc::LS_WARNING);
+  rtc::LogMessage::SetLogToStderr(true);
+
+  std::vector<webrtc::ControllerConfig> configs;
+  if (!webrtc::ParseControllerConfigs(absl::GetFlag(FLAGS_controllers),
+                                      &configs)) {
+    std::cerr << "No valid controller configurations." << std::endl;
+    return 1;
+  }
+
+  webrtc::SimulationQueue queue;
+  queue.configs = &configs;
+  queue.log_files.assign(args.begin() + 1, args.end());
+  if (!absl::GetFlag(FLAGS_log_list).empty()) {
+    std::ifstream log_list(  // no-presubmit-check TODO(webrtc:8982)
+        absl::GetFlag(FLAGS_log_list));
+    std::string line;
+    while (std::getline(log_list, line)) {
+      if (!line.empty())
+        queue.log_files.push_back(line);
+    }
+  }
+  if (queue.log_files.empty()) {
+    std::cerr << absl::ProgramUsageMessage();
+    return 1;
+  }
+  queue.results.assign(
+      queue.log_files.size(),
+      std::vector<webrtc::SimulationMetrics>(configs.size()));
+
+  webrtc::RunSimulations(&queue, absl::GetFlag(FLAGS_threads));
+
+  printf(
+      "log,controller,duration_s,mean_target_kbps,mean_logged_target_kbps,"
+      "mean_target_error_kbps,probe_clusters,logged_probe_clusters\n");
+  for (size_t i = 0; i < queue.log_files.size(); ++i) {
+    for (size_t j = 0; j < configs.size(); ++j) {
+      const webrtc::SimulationMetrics& metrics = queue.results[i][j];
+      if (!metrics.ok)
+        continue;
+      printf("%s,%s,%.1f,%.1f,%.1f,%.1f,%d,%d\n", queue.log_files[i].c_str(),
+             configs[j].label.c_str(), metrics.duration_s,
+             metrics.mean_target_kbps, metrics.mean_logged_target_kbps,
+             metrics.mean_target_error_kbps, metrics.probe_clusters,
+             metrics.logged_probe_clusters);
+    }
+  }
+  return 0;
+}
@@ -19,8 +19,11 @@ namespace webrtc {
 
 LogBasedNetworkControllerSimulation::LogBasedNetworkControllerSimulation(
     std::unique_ptr<NetworkControllerFactoryInterface> factory,
-    std::function<void(const NetworkControlUpdate&, Timestamp)> update_handler)
-    : update_handler_(update_handler), factory_(std::move(factory)) {}
+    std::function<void(const NetworkControlUpdate&, Timestamp)> update_handler,
+    const WebRtcKeyValueConfig* key_value_config)
+    : key_value_config_(key_value_config),
+      update_handler_(update_handler),
+      factory_(std::move(factory)) {}
 
 LogBasedNetworkControllerSimulation::~LogBasedNetworkControllerSimulation() {}
 
@@ -36,6 +39,7 @@ void LogBasedNetworkControllerSimulation::ProcessUntil(Timestamp to_time) {
     config.constraints.min_data_rate = DataRate::KilobitsPerSec(30);
     config.constraints.starting_rate = DataRate::KilobitsPerSec(300);
     config.event_log = &null_event_log_;
+    config.key_value_config = key_value_config_;
     controller_ = factory_->Create(config);
   }
   if (last_process_.IsInfinite() ||
@@ -24,10 +24,13 @@ namespace webrtc {
 
 class LogBasedNetworkControllerSimulation {
  public:
-  explicit LogBasedNetworkControllerSimulation(
+  // If |key_value_config| is set, it is passed on to the controller instead of
+  // the global field trials, and must outlive the simulation.
+  LogBasedNetworkControllerSimulation(
       std::unique_ptr<NetworkControllerFactoryInterface> factory,
       std::function<void(const NetworkControlUpdate&, Timestamp)>
-          update_handler);
+          update_handler,
+      const WebRtcKeyValueConfig* key_value_config = nullptr);
   ~LogBasedNetworkControllerSimulation();
   void ProcessEventsInLog(const ParsedRtcEventLog& parsed_log_);
 
@@ -46,6 +49,7 @@ class LogBasedNetworkControllerSimulation {
   void OnReceiverReport(const LoggedRtcpPacketReceiverReport& report);
   void OnIceConfig(const LoggedIceCandidatePairConfig& candidate);
   RtcEventLogNull null_event_log_;
+  const WebRtcKeyValueConfig* const key_value_config_;
 
   const std::function<void(const NetworkControlUpdate&, Timestamp)>
       update_handler_;
@@ -11,6 +11,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -29,7 +31,9 @@
 #include "logging/rtc_event_log/rtc_event_log_parser.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_tools/rtc_event_log_visualizer/alerts.h"
 #include "rtc_tools/rtc_event_log_visualizer/analyzer.h"
 #include "rtc_tools/rtc_event_log_visualizer/plot_base.h"
@@ -98,6 +102,13 @@ ABSL_FLAG(bool,
           false,
           "Output charts as protobuf instead of python code.");
 
+ABSL_FLAG(int,
+          plot_threads,
+          1,
+          "Number of threads used to compute the plots. The plots are "
+          "independent, so the simulations behind the slowest ones can run "
+          "side by side.");
+
 ABSL_FLAG(bool,
           list_plots,
           false,
@@ -184,6 +195,36 @@ class PlotMap {
   std::vector<PlotDeclaration> plots_;
 };
 
+// Plots to compute, shared by the threads computing them.
+struct PlotTaskQueue {
+  std::vector<std::pair<const PlotDeclaration*, Plot*>> tasks;
+  std::atomic<size_t> next_task{0};
+};
+
+void RunPlotTasksOnCurrentThread(void* obj) {
+  PlotTaskQueue* queue = static_cast<PlotTaskQueue*>(obj);
+  for (size_t i = queue->next_task++; i < queue->tasks.size();
+       i = queue->next_task++) {
+    queue->tasks[i].first->plot_func(queue->tasks[i].second);
+  }
+}
+
+// Computes the plots on |num_threads| threads. The plot functions only read
+// the parsed log, and each of them writes to its own plot.
+void RunPlotTasks(PlotTaskQueue* queue, int num_threads) {
+  num_threads = std::min(num_threads, static_cast<int>(queue->tasks.size()));
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        &RunPlotTasksOnCurrentThread, queue, "plot_worker"));
+    threads.back()->Start();
+  }
+  RunPlotTasksOnCurrentThread(queue);
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+}
+
 bool ContainsHelppackageFlags(absl::string_view filename) {
   return absl::EndsWith(filename, "main.cc");
 }
@@ -474,14 +515,22 @@ int main(int argc, char* argv[]) {
     wav_path = webrtc::test::ResourcePath(
         "audio_processing/conversational_speech/EN_script2_F_sp2_B1", "wav");
   }
+  // The NetEq simulation is shared by all the NetEq plots, and is run by
+  // whichever of them is computed first.
+  rtc::CriticalSection neteq_stats_crit;
   absl::optional<webrtc::EventLogAnalyzer::NetEqStatsGetterMap> neteq_stats;
-
-  plots.RegisterPlot("simulated_neteq_expand_rate", [&](Plot* plot) {
+  auto get_neteq_stats =
+      [&]() -> const webrtc::EventLogAnalyzer::NetEqStatsGetterMap& {
+    rtc::CritScope lock(&neteq_stats_crit);
     if (!neteq_stats) {
       neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
     }
+    return *neteq_stats;
+  };
+
+  plots.RegisterPlot("simulated_neteq_expand_rate", [&](Plot* plot) {
     analyzer.CreateNetEqNetworkStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqNetworkStatistics& stats) {
           return stats.expand_rate / 16384.f;
         },
@@ -489,11 +538,8 @@ int main(int argc, char* argv[]) {
   });
 
   plots.RegisterPlot("simulated_neteq_speech_expand_rate", [&](Plot* plot) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
     analyzer.CreateNetEqNetworkStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqNetworkStatistics& stats) {
           return stats.speech_expand_rate / 16384.f;
         },
@@ -501,11 +547,8 @@ int main(int argc, char* argv[]) {
   });
 
   plots.RegisterPlot("simulated_neteq_accelerate_rate", [&](Plot* plot) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
     analyzer.CreateNetEqNetworkStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqNetworkStatistics& stats) {
           return stats.accelerate_rate / 16384.f;
         },
@@ -513,11 +556,8 @@ int main(int argc, char* argv[]) {
   });
 
   plots.RegisterPlot("simulated_neteq_preemptive_rate", [&](Plot* plot) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
     analyzer.CreateNetEqNetworkStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqNetworkStatistics& stats) {
           return stats.preemptive_rate / 16384.f;
         },
@@ -525,11 +565,8 @@ int main(int argc, char* argv[]) {
   });
 
   plots.RegisterPlot("simulated_neteq_packet_loss_rate", [&](Plot* plot) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
     analyzer.CreateNetEqNetworkStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqNetworkStatistics& stats) {
           return stats.packet_loss_rate / 16384.f;
         },
@@ -537,11 +574,8 @@ int main(int argc, char* argv[]) {
   });
 
   plots.RegisterPlot("simulated_neteq_concealment_events", [&](Plot* plot) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
     analyzer.CreateNetEqLifetimeStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqLifetimeStatistics& stats) {
           return static_cast<float>(stats.concealment_events);
         },
@@ -549,11 +583,8 @@ int main(int argc, char* argv[]) {
   });
 
   plots.RegisterPlot("simulated_neteq_preferred_buffer_size", [&](Plot* plot) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
     analyzer.CreateNetEqNetworkStatsGraph(
-        *neteq_stats,
+        get_neteq_stats(),
         [](const webrtc::NetEqNetworkStatistics& stats) {
           return stats.preferred_buffer_size_ms;
         },
@@ -598,13 +629,17 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  // The plots are appended in registration order, but may then be computed in
+  // any order.
+  PlotTaskQueue plot_tasks;
   for (const auto& plot : plots) {
     if (plot.enabled) {
       Plot* output = collection->AppendNewPlot();
-      plot.plot_func(output);
       output->SetId(plot.label);
+      plot_tasks.tasks.emplace_back(&plot, output);
     }
   }
+  RunPlotTasks(&plot_tasks, absl::GetFlag(FLAGS_plot_threads));
 
   // The model we use for registering plots assumes that the each plot label
   // can be mapped to a lambda that will produce exactly one plot. The
@@ -613,12 +648,11 @@ int main(int argc, char* argv[]) {
   // calls.
   if (absl::c_find(plot_flags, "simulated_neteq_jitter_buffer_delay") !=
       plot_flags.end()) {
-    if (!neteq_stats) {
-      neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    }
+    const webrtc::EventLogAnalyzer::NetEqStatsGetterMap& stats =
+        get_neteq_stats();
     for (webrtc::EventLogAnalyzer::NetEqStatsGetterMap::const_iterator it =
-             neteq_stats->cbegin();
-         it != neteq_stats->cend(); ++it) {
+             stats.cbegin();
+         it != stats.cend(); ++it) {
       analyzer.CreateAudioJitterBufferGraph(it->first, it->second.get(),
                                             collection->AppendNewPlot());
     }
@@ -10,24 +10,35 @@
 
 #include "rtc_tools/video_file_reader.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/match.h"
 #include "absl/types/optional.h"
 #include "api/video/i420_buffer.h"
+#include "common_video/include/video_frame_buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/critical_section.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ref_counted_object.h"
 #include "rtc_base/string_encode.h"
 #include "rtc_base/string_to_number.h"
+#include "rtc_base/system/memory_mapped_file.h"
+#include "rtc_base/thread_annotations.h"
+
 
 namespace webrtc {
 namespace test {
 
 namespace {
 
+// Number of frames after the last read frame of a memory mapped video that are
+// read ahead in the background.
+constexpr size_t kPrefetchFrames = 4;
+
 bool ReadBytes(uint8_t* dst, size_t n, FILE* file) {
   return fread(reinterpret_cast<char*>(dst), /* size= */ 1, n, file) == n;
 }
@@ -73,8 +84,100 @@ class VideoFile : public Video {
   const int width_;
   const int height_;
   const std::vector<fpos_t> frame_positions_;
-  FILE* const file_;
+  rtc::CriticalSection crit_;
+  FILE* const file_ RTC_GUARDED_BY(crit_);
+};
+
+#if defined(WEBRTC_POSIX)
+// Video backed by a read-only memory mapping of the whole file, which is
+// shared with other videos opened from the same file. Frames point directly
+// into the mapping instead of being copied, and keep the video alive until they
+// are released. Since there is no shared file position, frames can be read
+// from several threads without locking.
+class MappedVideoFile : public Video {
+ public:
+  MappedVideoFile(int width,
+                  int height,
+                  const std::vector<size_t>& frame_offsets,
+                  rtc::scoped_refptr<MemoryMappedFile> file)
+      : width_(width),
+        height_(height),
+        frame_offsets_(frame_offsets),
+        file_(std::move(file)) {}
+
+  size_t number_of_frames() const override { return frame_offsets_.size(); }
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+
+  rtc::scoped_refptr<I420BufferInterface> GetFrame(
+      size_t frame_index) const override {
+    RTC_CHECK_LT(frame_index, frame_offsets_.size());
+
+    const int chroma_width = (width_ + 1) / 2;
+    const int chroma_height = (height_ + 1) / 2;
+    const size_t y_size = width_ * height_;
+    const size_t chroma_size = chroma_width * chroma_height;
+    const size_t frame_size = y_size + 2 * chroma_size;
+    const size_t offset = frame_offsets_[frame_index];
+    if (offset > file_->size() || file_->size() - offset < frame_size) {
+      RTC_LOG(LS_ERROR) << "Could not read YUV data for frame " << frame_index;
+      return nullptr;
+    }
+
+    // Most readers go through the frames in order, so let the OS read the
+    // next few frames in the background.
+    if (frame_index + 1 < frame_offsets_.size()) {
+      const size_t last_prefetched_index = std::min(
+          frame_index + kPrefetchFrames, frame_offsets_.size() - 1);
+      const size_t prefetch_start = frame_offsets_[frame_index + 1];
+      file_->Prefetch(prefetch_start, frame_offsets_[last_prefetched_index] +
+                                          frame_size - prefetch_start);
+    }
+
+    const uint8_t* const data_y = file_->data() + offset;
+    const uint8_t* const data_u = data_y + y_size;
+    const uint8_t* const data_v = data_u + chroma_size;
+    const rtc::scoped_refptr<const Video> video(this);
+    return WrapI420Buffer(width_, height_, data_y, width_, data_u,
+                          chroma_width, data_v, chroma_width, [video] {});
+  }
+
+ private:
+  const int width_;
+  const int height_;
+  const std::vector<size_t> frame_offsets_;
+  const rtc::scoped_refptr<MemoryMappedFile> file_;
 };
+#endif
+
+// Returns a video reading the frames at |frame_positions| from |file|, and
+// takes ownership of |file|. The file is memory mapped where that is
+// supported, and read through |file| otherwise.
+rtc::scoped_refptr<Video> CreateVideo(
+    const std::string& file_name,
+    int width,
+    int height,
+    const std::vector<fpos_t>& frame_positions,
+    FILE* file) {
+#if defined(WEBRTC_POSIX)
+  rtc::scoped_refptr<MemoryMappedFile> mapped_file =
+      MemoryMappedFile::Open(file_name);
+  if (mapped_file) {
+    std::vector<size_t> frame_offsets;
+    for (const fpos_t& position : frame_positions) {
+      fsetpos(file, &position);
+      frame_offsets.push_back(static_cast<size_t>(ftello(file)));
+    }
+    fclose(file);
+    return new rtc::RefCountedObject<MappedVideoFile>(
+        width, height, frame_offsets, std::move(mapped_file));
+  }
+  RTC_LOG(LS_WARNING) << "Could not memory map video file, reading it "
+                         "through the file API instead";
+#endif
+  return new rtc::RefCountedObject<VideoFile>(width, height, frame_positions,
+                                              file);
+}
 
 }  // namespace
 
@@ -224,8 +327,7 @@ rtc::scoped_refptr<Video> OpenY4mFile(const std::string& file_name) {
   }
   RTC_LOG(LS_INFO) << "Video has " << frame_positions.size() << " frames";
 
-  return new rtc::RefCountedObject<VideoFile>(*width, *height, frame_positions,
-                                              file);
+  return CreateVideo(file_name, *width, *height, frame_positions, file);
 }
 
 rtc::scoped_refptr<Video> OpenYuvFile(const std::string& file_name,
@@ -266,8 +368,7 @@ rtc::scoped_refptr<Video> OpenYuvFile(const std::string& file_name,
   }
   RTC_LOG(LS_INFO) << "Video has " << frame_positions.size() << " frames";
 
-  return new rtc::RefCountedObject<VideoFile>(width, height, frame_positions,
-                                              file);
+  return CreateVideo(file_name, width, height, frame_positions, file);
 }
 
 rtc::scoped_refptr<Video> OpenYuvOrY4mFile(const std::string& file_name,
@@ -23,8 +23,8 @@
 namespace webrtc {
 namespace test {
 
-// Iterable class representing a sequence of I420 buffers. This class is not
-// thread safe because it is expected to be backed by a file.
+// Iterable class representing a sequence of I420 buffers. GetFrame() may be
+// called from several threads at once, e.g. to analyze frames in parallel.
 class Video : public rtc::RefCountInterface {
  public:
   class Iterator {
@@ -64,6 +64,9 @@ class Video : public rtc::RefCountInterface {
       size_t index) const = 0;
 };
 
+// The files are memory mapped where supported, in which case the returned
+// frames point into the mapping rather than holding a copy of the data, and
+// videos opened from the same file share one mapping.
 rtc::scoped_refptr<Video> OpenY4mFile(const std::string& file_name);
 
 rtc::scoped_refptr<Video> OpenYuvFile(const std::string& file_name,
@@ -73,6 +73,12 @@ TEST_F(Y4mFileReaderTest, TestPixelContent) {
   }
 }
 
+TEST_F(Y4mFileReaderTest, FrameOutlivesVideo) {
+  const rtc::scoped_refptr<I420BufferInterface> frame = video->GetFrame(1);
+  video = nullptr;
+  EXPECT_EQ(6 * 4 * 3 / 2, frame->DataY()[0]);
+}
+
 class YuvFileReaderTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -85,6 +85,11 @@ class WrappedNativeI420Buffer implements VideoFrame.I420Buffer {
     return strideV;
   }
 
+  @CalledByNative
+  long getNativeBuffer() {
+    return nativeBuffer;
+  }
+
   @Override
   public VideoFrame.I420Buffer toI420() {
     retain();
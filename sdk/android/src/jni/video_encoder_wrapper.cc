@@ -129,11 +129,13 @@ int32_t VideoEncoderWrapper::Encode(
 
   JNIEnv* jni = AttachCurrentThreadIfNeeded();
 
-  // Construct encode info.
-  ScopedJavaLocalRef<jobjectArray> j_frame_types =
-      NativeToJavaFrameTypeArray(jni, *frame_types);
-  ScopedJavaLocalRef<jobject> encode_info =
-      Java_EncodeInfo_Constructor(jni, j_frame_types);
+  // Construct encode info, unless the last one has the same frame types.
+  if (encode_info_.is_null() || *frame_types != encode_info_frame_types_) {
+    ScopedJavaLocalRef<jobjectArray> j_frame_types =
+        NativeToJavaFrameTypeArray(jni, *frame_types);
+    encode_info_ = Java_EncodeInfo_Constructor(jni, j_frame_types);
+    encode_info_frame_types_ = *frame_types;
+  }
 
   FrameExtraInfo info;
   info.capture_time_ns = frame.timestamp_us() * rtc::kNumNanosecsPerMicrosec;
@@ -142,7 +144,7 @@ int32_t VideoEncoderWrapper::Encode(
 
   ScopedJavaLocalRef<jobject> j_frame = NativeToJavaVideoFrame(jni, frame);
   ScopedJavaLocalRef<jobject> ret =
-      Java_VideoEncoder_encode(jni, encoder_, j_frame, encode_info);
+      Java_VideoEncoder_encode(jni, encoder_, j_frame, encode_info_);
   ReleaseJavaVideoFrame(jni, j_frame);
   return HandleReturnCode(jni, ret, "encode");
 }
@@ -85,6 +85,11 @@ class VideoEncoderWrapper : public VideoEncoder {
   const ScopedJavaGlobalRef<jclass> int_array_class_;
 
   std::deque<FrameExtraInfo> frame_extra_infos_;
+  // The Java EncodeInfo of the last Encode() call and its frame types. It is
+  // reused for as long as the frame types stay the same, i.e. for all frames
+  // but those around key frame requests.
+  std::vector<VideoFrameType> encode_info_frame_types_;
+  ScopedJavaGlobalRef<jobject> encode_info_;
   EncodedImageCallback* callback_;
   bool initialized_;
   int num_resets_;
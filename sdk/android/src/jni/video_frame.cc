@@ -182,6 +182,15 @@ rtc::scoped_refptr<I420BufferInterface> AndroidVideoBuffer::ToI420() {
   ScopedJavaLocalRef<jobject> j_i420_buffer =
       Java_Buffer_toI420(jni, j_video_frame_buffer_);
 
+  // A buffer that wraps a C++ buffer is used directly, without reading the
+  // planes through JNI.
+  rtc::scoped_refptr<I420BufferInterface> native_buffer =
+      UnwrapI420Buffer(jni, j_i420_buffer);
+  if (native_buffer) {
+    Java_Buffer_release(jni, j_i420_buffer);
+    return native_buffer;
+  }
+
   // We don't need to retain the buffer because toI420 returns a new object that
   // we are assumed to take the ownership of.
   return AndroidVideoI420Buffer::Adopt(jni, width_, height_, j_i420_buffer);
@@ -194,8 +203,11 @@ VideoFrame JavaToNativeFrame(JNIEnv* jni,
       Java_VideoFrame_getBuffer(jni, j_video_frame);
   int rotation = Java_VideoFrame_getRotation(jni, j_video_frame);
   int64_t timestamp_ns = Java_VideoFrame_getTimestampNs(jni, j_video_frame);
-  rtc::scoped_refptr<AndroidVideoBuffer> buffer =
-      AndroidVideoBuffer::Create(jni, j_video_frame_buffer);
+  // Frames that wrap a C++ buffer get it back, so that ToI420() is free.
+  rtc::scoped_refptr<VideoFrameBuffer> buffer =
+      UnwrapI420Buffer(jni, j_video_frame_buffer);
+  if (!buffer)
+    buffer = AndroidVideoBuffer::Create(jni, j_video_frame_buffer);
   return VideoFrame::Builder()
       .set_video_frame_buffer(buffer)
       .set_timestamp_rtp(timestamp_rtp)
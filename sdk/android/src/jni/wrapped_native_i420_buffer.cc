@@ -36,5 +36,18 @@ ScopedJavaLocalRef<jobject> WrapI420Buffer(
       i420_buffer->StrideV(), jlongFromPointer(i420_buffer.get()));
 }
 
+rtc::scoped_refptr<I420BufferInterface> UnwrapI420Buffer(
+    JNIEnv* jni,
+    const JavaRef<jobject>& j_buffer) {
+  if (j_buffer.is_null() ||
+      !jni->IsInstanceOf(j_buffer.obj(),
+                         org_webrtc_WrappedNativeI420Buffer_clazz(jni))) {
+    return nullptr;
+  }
+  // The Java buffer holds a reference to the C++ buffer until released.
+  return reinterpret_cast<I420BufferInterface*>(
+      Java_WrappedNativeI420Buffer_getNativeBuffer(jni, j_buffer));
+}
+
 }  // namespace jni
 }  // namespace webrtc
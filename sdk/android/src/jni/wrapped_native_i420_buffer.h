@@ -25,6 +25,13 @@ ScopedJavaLocalRef<jobject> WrapI420Buffer(
     JNIEnv* jni,
     const rtc::scoped_refptr<I420BufferInterface>& i420_buffer);
 
+// Returns the C++ buffer that |j_buffer| wraps if it was created by
+// WrapI420Buffer(), and null otherwise. This lets frames that make a round trip
+// through Java come back without a copy or per-plane JNI calls.
+rtc::scoped_refptr<I420BufferInterface> UnwrapI420Buffer(
+    JNIEnv* jni,
+    const JavaRef<jobject>& j_buffer);
+
 }  // namespace jni
 }  // namespace webrtc
 
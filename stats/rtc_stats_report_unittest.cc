@@ -139,4 +139,40 @@ TEST(RTCStatsReport, TakeMembersFrom) {
   EXPECT_EQ(i, static_cast<int64_t>(6));
 }
 
+TEST(RTCStatsReport, CopyChangedSince) {
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1);
+  std::unique_ptr<RTCTestStats1> unchanged(new RTCTestStats1("A", 1));
+  unchanged->integer = 1;
+  previous->AddStats(std::move(unchanged));
+  std::unique_ptr<RTCTestStats1> changed(new RTCTestStats1("B", 1));
+  changed->integer = 2;
+  previous->AddStats(changed->copy());
+  previous->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats1("C", 1)));
+  previous->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats1("D", 1)));
+
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(2);
+  // Only the timestamp differs.
+  unchanged.reset(new RTCTestStats1("A", 2));
+  unchanged->integer = 1;
+  report->AddStats(std::move(unchanged));
+  changed->integer = 3;
+  report->AddStats(std::move(changed));
+  // Same ID, other type.
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats2("C", 2)));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats1("E", 2)));
+
+  rtc::scoped_refptr<RTCStatsReport> delta =
+      report->CopyChangedSince(*previous);
+  EXPECT_EQ(delta->timestamp_us(), 2);
+  EXPECT_EQ(delta->size(), 3u);
+  EXPECT_FALSE(delta->Get("A"));
+  ASSERT_TRUE(delta->GetAs<RTCTestStats1>("B"));
+  EXPECT_EQ(*delta->GetAs<RTCTestStats1>("B")->integer, 3);
+  EXPECT_TRUE(delta->GetAs<RTCTestStats2>("C"));
+  EXPECT_FALSE(delta->Get("D"));
+  EXPECT_TRUE(delta->Get("E"));
+  // |report| is left untouched.
+  EXPECT_EQ(report->size(), 4u);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,407 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/stats/rtc_stats_snapshot.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace webrtc {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x53435452;  // "RTCS", read as little endian.
+constexpr uint32_t kVersion = 1;
+constexpr size_t kSlotSize = 8;
+
+bool IsVariableSize(RTCStatsMemberInterface::Type type) {
+  return type == RTCStatsMemberInterface::kString ||
+         type >= RTCStatsMemberInterface::kSequenceBool;
+}
+
+size_t BitmapSize(size_t num_members) {
+  return (num_members + 7) / 8;
+}
+
+template <typename T>
+void Append(const T& value, std::vector<uint8_t>* buffer) {
+  const size_t size = buffer->size();
+  buffer->resize(size + sizeof(T));
+  memcpy(buffer->data() + size, &value, sizeof(T));
+}
+
+void AppendBytes(const char* data, size_t size, std::vector<uint8_t>* buffer) {
+  buffer->insert(buffer->end(), data, data + size);
+}
+
+void AppendShortString(absl::string_view value, std::vector<uint8_t>* buffer) {
+  RTC_DCHECK_LE(value.size(), std::numeric_limits<uint16_t>::max());
+  Append(static_cast<uint16_t>(value.size()), buffer);
+  AppendBytes(value.data(), value.size(), buffer);
+}
+
+template <typename T>
+void WriteScalar(const RTCStatsMemberInterface& member, uint8_t* slot) {
+  static_assert(sizeof(T) <= kSlotSize, "");
+  const T& value = *member.cast_to<RTCStatsMember<T>>();
+  memcpy(slot, &value, sizeof(T));
+}
+
+template <typename T>
+void AppendSequence(const RTCStatsMemberInterface& member,
+                    std::vector<uint8_t>* buffer) {
+  for (const T value : *member.cast_to<RTCStatsMember<std::vector<T>>>())
+    Append(value, buffer);
+}
+
+void AppendMemberData(const RTCStatsMemberInterface& member,
+                      std::vector<uint8_t>* buffer) {
+  switch (member.type()) {
+    case RTCStatsMemberInterface::kString: {
+      const std::string& value =
+          *member.cast_to<RTCStatsMember<std::string>>();
+      AppendBytes(value.data(), value.size(), buffer);
+      break;
+    }
+    case RTCStatsMemberInterface::kSequenceBool:
+      AppendSequence<bool>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceInt32:
+      AppendSequence<int32_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceUint32:
+      AppendSequence<uint32_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceInt64:
+      AppendSequence<int64_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceUint64:
+      AppendSequence<uint64_t>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceDouble:
+      AppendSequence<double>(member, buffer);
+      break;
+    case RTCStatsMemberInterface::kSequenceString:
+      for (const std::string& value :
+           *member.cast_to<RTCStatsMember<std::vector<std::string>>>()) {
+        Append(static_cast<uint32_t>(value.size()), buffer);
+        AppendBytes(value.data(), value.size(), buffer);
+      }
+      break;
+    default:
+      RTC_NOTREACHED();
+  }
+}
+
+void WriteScalarMember(const RTCStatsMemberInterface& member, uint8_t* slot) {
+  switch (member.type()) {
+    case RTCStatsMemberInterface::kBool:
+      WriteScalar<bool>(member, slot);
+      break;
+    case RTCStatsMemberInterface::kInt32:
+      WriteScalar<int32_t>(member, slot);
+      break;
+    case RTCStatsMemberInterface::kUint32:
+      WriteScalar<uint32_t>(member, slot);
+      break;
+    case RTCStatsMemberInterface::kInt64:
+      WriteScalar<int64_t>(member, slot);
+      break;
+    case RTCStatsMemberInterface::kUint64:
+      WriteScalar<uint64_t>(member, slot);
+      break;
+    case RTCStatsMemberInterface::kDouble:
+      WriteScalar<double>(member, slot);
+      break;
+    default:
+      RTC_NOTREACHED();
+  }
+}
+
+void WriteObject(const RTCStats& stats,
+                 size_t schema_index,
+                 std::vector<uint8_t>* buffer) {
+  const size_t object_offset = buffer->size();
+  Append(uint32_t{0}, buffer);  // The size, written last.
+  Append(static_cast<uint16_t>(schema_index), buffer);
+  Append(stats.timestamp_us(), buffer);
+  AppendShortString(stats.id(), buffer);
+
+  const std::vector<const RTCStatsMemberInterface*> members = stats.Members();
+  const size_t bitmap_offset = buffer->size();
+  const size_t slots_offset = bitmap_offset + BitmapSize(members.size());
+  const size_t data_offset = slots_offset + members.size() * kSlotSize;
+  buffer->resize(data_offset, 0);
+  for (size_t i = 0; i < members.size(); ++i) {
+    const RTCStatsMemberInterface& member = *members[i];
+    if (!member.is_defined())
+      continue;
+    (*buffer)[bitmap_offset + i / 8] |= 1 << (i % 8);
+    const size_t slot_offset = slots_offset + i * kSlotSize;
+    if (!IsVariableSize(member.type())) {
+      WriteScalarMember(member, buffer->data() + slot_offset);
+      continue;
+    }
+    const size_t member_offset = buffer->size();
+    AppendMemberData(member, buffer);
+    const uint32_t offset_and_size[] = {
+        static_cast<uint32_t>(member_offset - data_offset),
+        static_cast<uint32_t>(buffer->size() - member_offset)};
+    memcpy(buffer->data() + slot_offset, offset_and_size, kSlotSize);
+  }
+
+  const uint32_t object_size =
+      static_cast<uint32_t>(buffer->size() - object_offset);
+  memcpy(buffer->data() + object_offset, &object_size, sizeof(object_size));
+}
+
+// Reads a snapshot front to back, failing once it would read past the end.
+class Reader {
+ public:
+  explicit Reader(rtc::ArrayView<const uint8_t> data) : data_(data) {}
+
+  template <typename T>
+  bool Read(T* value) {
+    const uint8_t* bytes;
+    if (!ReadBytes(sizeof(T), &bytes))
+      return false;
+    memcpy(value, bytes, sizeof(T));
+    return true;
+  }
+
+  bool ReadBytes(size_t size, const uint8_t** bytes) {
+    if (size > data_.size() - position_)
+      return false;
+    *bytes = data_.data() + position_;
+    position_ += size;
+    return true;
+  }
+
+  bool ReadShortString(absl::string_view* value) {
+    uint16_t size;
+    const uint8_t* characters;
+    if (!Read(&size) || !ReadBytes(size, &characters))
+      return false;
+    *value = absl::string_view(reinterpret_cast<const char*>(characters), size);
+    return true;
+  }
+
+  rtc::ArrayView<const uint8_t> remaining() const {
+    return data_.subview(position_);
+  }
+  bool done() const { return position_ == data_.size(); }
+
+ private:
+  const rtc::ArrayView<const uint8_t> data_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+void WriteRTCStatsSnapshot(const RTCStatsReport& report,
+                           std::vector<uint8_t>* buffer) {
+  buffer->clear();
+  Append(kMagic, buffer);
+  Append(kVersion, buffer);
+  Append(report.timestamp_us(), buffer);
+  const size_t num_schemas_offset = buffer->size();
+  Append(uint32_t{0}, buffer);  // The number of schemas, written below.
+  Append(static_cast<uint32_t>(report.size()), buffer);
+
+  // The types are told apart by the address of their |kType|.
+  std::vector<const char*> types;
+  for (const RTCStats& stats : report) {
+    if (std::find(types.begin(), types.end(), stats.type()) != types.end())
+      continue;
+    types.push_back(stats.type());
+    AppendShortString(stats.type(), buffer);
+    const std::vector<const RTCStatsMemberInterface*> members = stats.Members();
+    Append(static_cast<uint16_t>(members.size()), buffer);
+    for (const RTCStatsMemberInterface* member : members) {
+      Append(static_cast<uint8_t>(member->type()), buffer);
+      AppendShortString(member->name(), buffer);
+    }
+  }
+  const uint32_t num_schemas = static_cast<uint32_t>(types.size());
+  memcpy(buffer->data() + num_schemas_offset, &num_schemas,
+         sizeof(num_schemas));
+
+  for (const RTCStats& stats : report) {
+    const size_t schema_index =
+        std::find(types.begin(), types.end(), stats.type()) - types.begin();
+    WriteObject(stats, schema_index, buffer);
+  }
+}
+
+RTCStatsSnapshotReader::Schema::Schema() = default;
+RTCStatsSnapshotReader::Schema::Schema(const Schema&) = default;
+RTCStatsSnapshotReader::Schema::~Schema() = default;
+
+bool RTCStatsSnapshotReader::Object::IsDefined(size_t member_index) const {
+  RTC_DCHECK_LT(member_index, num_members_);
+  return defined_members_[member_index / 8] & (1 << (member_index % 8));
+}
+
+absl::string_view RTCStatsSnapshotReader::Object::GetString(
+    size_t member_index) const {
+  rtc::ArrayView<const uint8_t> data = Data(member_index);
+  return absl::string_view(reinterpret_cast<const char*>(data.data()),
+                           data.size());
+}
+
+std::vector<absl::string_view>
+RTCStatsSnapshotReader::Object::GetStringSequence(size_t member_index) const {
+  // Parse() has checked that the strings are within bounds.
+  Reader reader(Data(member_index));
+  std::vector<absl::string_view> sequence;
+  uint32_t size;
+  const uint8_t* characters;
+  while (reader.Read(&size) && reader.ReadBytes(size, &characters)) {
+    sequence.push_back(
+        absl::string_view(reinterpret_cast<const char*>(characters), size));
+  }
+  return sequence;
+}
+
+const uint8_t* RTCStatsSnapshotReader::Object::Slot(size_t member_index) const {
+  RTC_DCHECK_LT(member_index, num_members_);
+  return slots_ + member_index * kSlotSize;
+}
+
+rtc::ArrayView<const uint8_t> RTCStatsSnapshotReader::Object::Data(
+    size_t member_index) const {
+  RTC_DCHECK(IsDefined(member_index));
+  uint32_t offset_and_size[2];
+  memcpy(offset_and_size, Slot(member_index), kSlotSize);
+  return data_.subview(offset_and_size[0], offset_and_size[1]);
+}
+
+RTCStatsSnapshotReader::RTCStatsSnapshotReader() = default;
+
+RTCStatsSnapshotReader::~RTCStatsSnapshotReader() = default;
+
+bool RTCStatsSnapshotReader::Parse(rtc::ArrayView<const uint8_t> snapshot) {
+  timestamp_us_ = 0;
+  schemas_.clear();
+  objects_.clear();
+
+  Reader reader(snapshot);
+  uint32_t magic;
+  uint32_t version;
+  int64_t timestamp_us;
+  uint32_t num_schemas;
+  uint32_t num_objects;
+  if (!reader.Read(&magic) || magic != kMagic || !reader.Read(&version) ||
+      version != kVersion || !reader.Read(&timestamp_us) ||
+      !reader.Read(&num_schemas) || !reader.Read(&num_objects)) {
+    return false;
+  }
+
+  bool valid = true;
+  for (uint32_t i = 0; valid && i < num_schemas; ++i) {
+    Schema schema;
+    uint16_t num_members;
+    valid = reader.ReadShortString(&schema.type) && reader.Read(&num_members);
+    for (uint16_t j = 0; valid && j < num_members; ++j) {
+      uint8_t type;
+      Member member;
+      valid = reader.Read(&type) &&
+              type <= RTCStatsMemberInterface::kSequenceString &&
+              reader.ReadShortString(&member.name);
+      member.type = static_cast<RTCStatsMemberInterface::Type>(type);
+      schema.members.push_back(member);
+    }
+    schemas_.push_back(std::move(schema));
+  }
+
+  for (uint32_t i = 0; valid && i < num_objects; ++i) {
+    uint32_t object_size;
+    const uint8_t* object;
+    valid = Reader(reader.remaining()).Read(&object_size) &&
+            reader.ReadBytes(object_size, &object) &&
+            ParseObject(rtc::ArrayView<const uint8_t>(object, object_size));
+  }
+
+  if (!valid || !reader.done()) {
+    schemas_.clear();
+    objects_.clear();
+    return false;
+  }
+  timestamp_us_ = timestamp_us;
+  return true;
+}
+
+bool RTCStatsSnapshotReader::ParseObject(rtc::ArrayView<const uint8_t> data) {
+  Reader reader(data);
+  Object object;
+  uint32_t object_size;
+  uint16_t schema_index;
+  if (!reader.Read(&object_size) || !reader.Read(&schema_index) ||
+      schema_index >= schemas_.size() || !reader.Read(&object.timestamp_us_) ||
+      !reader.ReadShortString(&object.id_)) {
+    return false;
+  }
+  const Schema& schema = schemas_[schema_index];
+  object.schema_index_ = schema_index;
+  object.num_members_ = schema.members.size();
+  if (!reader.ReadBytes(BitmapSize(object.num_members_),
+                        &object.defined_members_) ||
+      !reader.ReadBytes(object.num_members_ * kSlotSize, &object.slots_)) {
+    return false;
+  }
+  object.data_ = reader.remaining();
+
+  // Check the variable sized members, so that their getters need not.
+  for (size_t i = 0; i < object.num_members_; ++i) {
+    const RTCStatsMemberInterface::Type type = schema.members[i].type;
+    if (!object.IsDefined(i) || !IsVariableSize(type))
+      continue;
+    uint32_t offset_and_size[2];
+    memcpy(offset_and_size, object.Slot(i), kSlotSize);
+    if (offset_and_size[0] > object.data_.size() ||
+        offset_and_size[1] > object.data_.size() - offset_and_size[0]) {
+      return false;
+    }
+    if (type != RTCStatsMemberInterface::kSequenceString)
+      continue;
+    Reader strings(object.Data(i));
+    while (!strings.done()) {
+      uint32_t size;
+      const uint8_t* characters;
+      if (!strings.Read(&size) || !strings.ReadBytes(size, &characters))
+        return false;
+    }
+  }
+  objects_.push_back(object);
+  return true;
+}
+
+int RTCStatsSnapshotReader::FindSchema(absl::string_view type) const {
+  for (size_t i = 0; i < schemas_.size(); ++i) {
+    if (schemas_[i].type == type)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+int RTCStatsSnapshotReader::FindMember(size_t schema_index,
+                                       absl::string_view name) const {
+  RTC_DCHECK_LT(schema_index, schemas_.size());
+  const std::vector<Member>& members = schemas_[schema_index].members;
+  for (size_t i = 0; i < members.size(); ++i) {
+    if (members[i].name == name)
+      return static_cast<int>(i);
+  }
+  return -1;
+}
+
+}  // namespace webrtc
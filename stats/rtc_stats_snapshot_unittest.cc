@@ -0,0 +1,220 @@
+/*
+ *  Copyright 2020 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/stats/rtc_stats_snapshot.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/stats/rtcstats_objects.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+#include "stats/test/rtc_test_stats.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+using ::testing::ElementsAre;
+
+int MemberIndex(const RTCStatsSnapshotReader& reader,
+                const RTCStatsSnapshotReader::Object& object,
+                const char* name) {
+  return reader.FindMember(object.schema_index(), name);
+}
+
+rtc::scoped_refptr<RTCStatsReport> CreateReportWithInboundRtpStreams(
+    int num_streams) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(1000);
+  for (int i = 0; i < num_streams; ++i) {
+    std::unique_ptr<RTCInboundRTPStreamStats> stats(
+        new RTCInboundRTPStreamStats("RTCInboundRTPAudioStream_" +
+                                         std::to_string(i),
+                                     1000));
+    stats->ssrc = i;
+    stats->is_remote = false;
+    stats->media_type = "audio";
+    stats->kind = "audio";
+    stats->track_id = "RTCMediaStreamTrack_receiver_" + std::to_string(i);
+    stats->transport_id = "RTCTransport_0_1";
+    stats->codec_id = "RTCCodec_0_Inbound_111";
+    stats->nack_count = 2;
+    stats->packets_received = 1000 + i;
+    stats->bytes_received = 100000 + i;
+    stats->header_bytes_received = 12000;
+    stats->packets_lost = 3;
+    stats->last_packet_received_timestamp = 123456.5;
+    stats->jitter = 0.002;
+    report->AddStats(std::move(stats));
+  }
+  return report;
+}
+
+}  // namespace
+
+TEST(RTCStatsSnapshotTest, RoundTripsAllMemberTypes) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(42);
+  std::unique_ptr<RTCTestStats> stats(new RTCTestStats("test", 43));
+  stats->m_bool = true;
+  stats->m_int32 = -123;
+  stats->m_uint32 = 123;
+  stats->m_int64 = -1234567890123;
+  stats->m_uint64 = 1234567890123;
+  stats->m_double = 0.5;
+  stats->m_string = "string";
+  stats->m_sequence_bool = std::vector<bool>{true, false, true};
+  stats->m_sequence_int32 = std::vector<int32_t>{-1, 2};
+  stats->m_sequence_uint32 = std::vector<uint32_t>{1, 2, 3};
+  stats->m_sequence_int64 = std::vector<int64_t>{-4};
+  stats->m_sequence_uint64 = std::vector<uint64_t>{5, 6};
+  stats->m_sequence_double = std::vector<double>{0.25, -0.75};
+  stats->m_sequence_string = std::vector<std::string>{"a", "", "bc"};
+  report->AddStats(std::move(stats));
+
+  std::vector<uint8_t> buffer;
+  WriteRTCStatsSnapshot(*report, &buffer);
+  RTCStatsSnapshotReader reader;
+  ASSERT_TRUE(reader.Parse(buffer));
+  EXPECT_EQ(42, reader.timestamp_us());
+  ASSERT_EQ(1u, reader.schemas().size());
+  EXPECT_EQ(RTCTestStats::kType, reader.schemas()[0].type);
+  EXPECT_EQ(14u, reader.schemas()[0].members.size());
+  ASSERT_EQ(1u, reader.objects().size());
+
+  const RTCStatsSnapshotReader::Object& object = reader.objects()[0];
+  EXPECT_EQ("test", object.id());
+  EXPECT_EQ(43, object.timestamp_us());
+  EXPECT_TRUE(object.GetValue<bool>(MemberIndex(reader, object, "mBool")));
+  EXPECT_EQ(-123,
+            object.GetValue<int32_t>(MemberIndex(reader, object, "mInt32")));
+  EXPECT_EQ(123u,
+            object.GetValue<uint32_t>(MemberIndex(reader, object, "mUint32")));
+  EXPECT_EQ(-1234567890123,
+            object.GetValue<int64_t>(MemberIndex(reader, object, "mInt64")));
+  EXPECT_EQ(1234567890123u,
+            object.GetValue<uint64_t>(MemberIndex(reader, object, "mUint64")));
+  EXPECT_EQ(0.5,
+            object.GetValue<double>(MemberIndex(reader, object, "mDouble")));
+  EXPECT_EQ("string",
+            object.GetString(MemberIndex(reader, object, "mString")));
+  EXPECT_THAT(object.GetSequence<bool>(
+                  MemberIndex(reader, object, "mSequenceBool")),
+              ElementsAre(true, false, true));
+  EXPECT_THAT(object.GetSequence<int32_t>(
+                  MemberIndex(reader, object, "mSequenceInt32")),
+              ElementsAre(-1, 2));
+  EXPECT_THAT(object.GetSequence<uint32_t>(
+                  MemberIndex(reader, object, "mSequenceUint32")),
+              ElementsAre(1u, 2u, 3u));
+  EXPECT_THAT(object.GetSequence<int64_t>(
+                  MemberIndex(reader, object, "mSequenceInt64")),
+              ElementsAre(-4));
+  EXPECT_THAT(object.GetSequence<uint64_t>(
+                  MemberIndex(reader, object, "mSequenceUint64")),
+              ElementsAre(5u, 6u));
+  EXPECT_THAT(object.GetSequence<double>(
+                  MemberIndex(reader, object, "mSequenceDouble")),
+              ElementsAre(0.25, -0.75));
+  EXPECT_THAT(object.GetStringSequence(
+                  MemberIndex(reader, object, "mSequenceString")),
+              ElementsAre("a", "", "bc"));
+}
+
+TEST(RTCStatsSnapshotTest, ObjectsOfATypeShareASchema) {
+  rtc::scoped_refptr<RTCStatsReport> report =
+      CreateReportWithInboundRtpStreams(3);
+  report->AddStats(
+      std::unique_ptr<RTCStats>(new RTCTestStats("test", 1000)));
+
+  std::vector<uint8_t> buffer;
+  WriteRTCStatsSnapshot(*report, &buffer);
+  RTCStatsSnapshotReader reader;
+  ASSERT_TRUE(reader.Parse(buffer));
+  EXPECT_EQ(2u, reader.schemas().size());
+  ASSERT_EQ(4u, reader.objects().size());
+
+  const int schema_index = reader.FindSchema(RTCInboundRTPStreamStats::kType);
+  ASSERT_GE(schema_index, 0);
+  const int packets_received =
+      reader.FindMember(schema_index, "packetsReceived");
+  const int fec_packets_received =
+      reader.FindMember(schema_index, "fecPacketsReceived");
+  ASSERT_GE(packets_received, 0);
+  ASSERT_GE(fec_packets_received, 0);
+  EXPECT_EQ(-1, reader.FindMember(schema_index, "unknown"));
+  EXPECT_EQ(-1, reader.FindSchema("unknown"));
+
+  uint32_t total_packets_received = 0;
+  for (const RTCStatsSnapshotReader::Object& object : reader.objects()) {
+    if (object.schema_index() != static_cast<size_t>(schema_index))
+      continue;
+    EXPECT_FALSE(object.IsDefined(fec_packets_received));
+    ASSERT_TRUE(object.IsDefined(packets_received));
+    total_packets_received += object.GetValue<uint32_t>(packets_received);
+  }
+  EXPECT_EQ(1000u + 1001u + 1002u, total_packets_received);
+}
+
+TEST(RTCStatsSnapshotTest, RejectsMalformedSnapshots) {
+  rtc::scoped_refptr<RTCStatsReport> report =
+      CreateReportWithInboundRtpStreams(2);
+  std::vector<uint8_t> buffer;
+  WriteRTCStatsSnapshot(*report, &buffer);
+
+  RTCStatsSnapshotReader reader;
+  for (size_t size = 0; size < buffer.size(); ++size) {
+    EXPECT_FALSE(reader.Parse(
+        rtc::ArrayView<const uint8_t>(buffer.data(), size)));
+    EXPECT_TRUE(reader.objects().empty());
+  }
+  buffer.push_back(0);
+  EXPECT_FALSE(reader.Parse(buffer));
+  buffer.pop_back();
+  buffer[0] ^= 1;
+  EXPECT_FALSE(reader.Parse(buffer));
+}
+
+TEST(RTCStatsSnapshotTest, WritesEmptyReport) {
+  std::vector<uint8_t> buffer = {1, 2, 3};
+  WriteRTCStatsSnapshot(*RTCStatsReport::Create(7), &buffer);
+  RTCStatsSnapshotReader reader;
+  ASSERT_TRUE(reader.Parse(buffer));
+  EXPECT_EQ(7, reader.timestamp_us());
+  EXPECT_TRUE(reader.schemas().empty());
+  EXPECT_TRUE(reader.objects().empty());
+}
+
+TEST(RTCStatsSnapshotTest, DISABLED_BenchmarkAgainstToJson) {
+  constexpr int kIterations = 1000;
+  rtc::scoped_refptr<RTCStatsReport> report =
+      CreateReportWithInboundRtpStreams(100);
+
+  int64_t start_us = rtc::TimeMicros();
+  size_t json_size = 0;
+  for (int i = 0; i < kIterations; ++i)
+    json_size = report->ToJson().size();
+  const int64_t json_us = rtc::TimeMicros() - start_us;
+
+  std::vector<uint8_t> buffer;
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kIterations; ++i)
+    WriteRTCStatsSnapshot(*report, &buffer);
+  const int64_t snapshot_us = rtc::TimeMicros() - start_us;
+
+  RTC_LOG(LS_INFO) << "ToJson: " << json_us / kIterations << " us, "
+                   << json_size << " bytes";
+  RTC_LOG(LS_INFO) << "Snapshot: " << snapshot_us / kIterations << " us, "
+                   << buffer.size() << " bytes";
+}
+
+}  // namespace webrtc
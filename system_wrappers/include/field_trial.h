@@ -80,6 +80,8 @@ inline bool IsDisabled(const char* name) {
 // This method can be called at most once before any other call into webrtc.
 // E.g. before the peer connection factory is constructed.
 // Note: trials_string must never be destroyed.
+// The default implementation parses trials_string here, so that lookups don't
+// have to; changes to the string after this call are not seen by lookups.
 void InitFieldTrialsFromString(const char* trials_string);
 
 const char* GetFieldTrialString();
@@ -10,10 +10,13 @@
 
 // Parts of this file derived from Chromium's base/cpu.cc.
 
+#include <stdint.h>
+
 #include "rtc_base/system/arch.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
 #if defined(WEBRTC_ARCH_X86_FAMILY) && defined(_MSC_VER)
+#include <immintrin.h>
 #include <intrin.h>
 #endif
 
@@ -44,6 +47,33 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
                    : "a"(info_type));
 }
 #endif
+
+// Intrinsic for "cpuid" with a sub-leaf.
+#if defined(__pic__) && defined(__i386__)
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
+  __asm__ volatile(
+      "mov %%ebx, %%edi\n"
+      "cpuid\n"
+      "xchg %%edi, %%ebx\n"
+      : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]),
+        "=d"(cpu_info[3])
+      : "a"(info_type), "c"(sub_leaf));
+}
+#else
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_leaf) {
+  __asm__ volatile("cpuid\n"
+                   : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]),
+                     "=d"(cpu_info[3])
+                   : "a"(info_type), "c"(sub_leaf));
+}
+#endif
+
+// Intrinsic for "xgetbv".
+static inline uint64_t _xgetbv(uint32_t xcr) {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
@@ -58,6 +88,21 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX2) {
+    // AVX2 needs the OS to save the YMM registers, as reported through OSXSAVE
+    // and XCR0.
+    const bool has_osxsave = 0 != (cpu_info[2] & 0x08000000);
+    const bool has_avx = 0 != (cpu_info[2] & 0x10000000);
+    if (!has_osxsave || !has_avx || (_xgetbv(0) & 0x6) != 0x6) {
+      return 0;
+    }
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7) {
+      return 0;
+    }
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
@@ -14,6 +14,7 @@
 #include <map>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -29,6 +30,39 @@ static const char* trials_init_string = NULL;
 #ifndef WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
 namespace {
 constexpr char kPersistentStringSeparator = '/';
+
+// Group names keyed by trial name, parsed from |trials_init_string| once in
+// InitFieldTrialsFromString(), so that lookups don't have to parse the string.
+// Replaced together with |trials_init_string|, with the same requirement that
+// this does not race with lookups.
+using FieldTrialMap = absl::flat_hash_map<std::string, std::string>;
+const FieldTrialMap* trials_map = nullptr;
+
+// Parses like FindFullName() used to scan the string: parsing stops at the
+// first malformed entry, and the first group of a duplicate trial wins.
+const FieldTrialMap* ParseFieldTrials(const absl::string_view trials) {
+  FieldTrialMap* field_trials = new FieldTrialMap();
+  size_t next_item = 0;
+  while (next_item < trials.length()) {
+    // Find next name/value pair in field trial configuration string.
+    size_t field_name_end = trials.find(kPersistentStringSeparator, next_item);
+    if (field_name_end == trials.npos || field_name_end == next_item)
+      break;
+    size_t field_value_end =
+        trials.find(kPersistentStringSeparator, field_name_end + 1);
+    if (field_value_end == trials.npos ||
+        field_value_end == field_name_end + 1)
+      break;
+    absl::string_view field_name =
+        trials.substr(next_item, field_name_end - next_item);
+    absl::string_view field_value = trials.substr(
+        field_name_end + 1, field_value_end - field_name_end - 1);
+    next_item = field_value_end + 1;
+
+    field_trials->emplace(std::string(field_name), std::string(field_value));
+  }
+  return field_trials;
+}
 // Validates the given field trial string.
 //  E.g.:
 //    "WebRTC-experimentFoo/Enabled/WebRTC-experimentBar/Enabled100kbps/"
@@ -103,35 +137,11 @@ std::string MergeFieldTrialsStrings(const char* first, const char* second) {
 }
 
 std::string FindFullName(const std::string& name) {
-  if (trials_init_string == NULL)
+  if (trials_map == nullptr)
     return std::string();
 
-  std::string trials_string(trials_init_string);
-  if (trials_string.empty())
-    return std::string();
-
-  size_t next_item = 0;
-  while (next_item < trials_string.length()) {
-    // Find next name/value pair in field trial configuration string.
-    size_t field_name_end =
-        trials_string.find(kPersistentStringSeparator, next_item);
-    if (field_name_end == trials_string.npos || field_name_end == next_item)
-      break;
-    size_t field_value_end =
-        trials_string.find(kPersistentStringSeparator, field_name_end + 1);
-    if (field_value_end == trials_string.npos ||
-        field_value_end == field_name_end + 1)
-      break;
-    std::string field_name(trials_string, next_item,
-                           field_name_end - next_item);
-    std::string field_value(trials_string, field_name_end + 1,
-                            field_value_end - field_name_end - 1);
-    next_item = field_value_end + 1;
-
-    if (name == field_name)
-      return field_value;
-  }
-  return std::string();
+  auto it = trials_map->find(name);
+  return it != trials_map->end() ? it->second : std::string();
 }
 #endif  // WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
 
@@ -143,6 +153,8 @@ void InitFieldTrialsFromString(const char* trials_string) {
     RTC_DCHECK(FieldTrialsStringIsValidInternal(trials_string))
         << "Invalid field trials string:" << trials_string;
   };
+  delete trials_map;
+  trials_map = trials_string ? ParseFieldTrials(trials_string) : nullptr;
 #endif  // WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT
   trials_init_string = trials_string;
 }
@@ -103,5 +103,26 @@ TEST(FieldTrialMergingTest, HandlesEmptyInput) {
 #endif  // GTEST_HAS_DEATH_TEST && RTC_DCHECK_IS_ON && !defined(WEBRTC_ANDROID)
         // && !defined(WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT)
 
+#if !defined(WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT)
+TEST(FieldTrialTest, FindsGroupNames) {
+  const char* previous_trials = GetFieldTrialString();
+  InitFieldTrialsFromString("Audio/Enabled/Video/Disabled-10/");
+  EXPECT_EQ("Enabled", FindFullName("Audio"));
+  EXPECT_EQ("Disabled-10", FindFullName("Video"));
+  EXPECT_EQ("", FindFullName("Data"));
+  EXPECT_EQ("", FindFullName("Audio/Enabled"));
+  EXPECT_TRUE(IsEnabled("Audio"));
+  EXPECT_TRUE(IsDisabled("Video"));
+
+  InitFieldTrialsFromString("Data/Enabled/");
+  EXPECT_EQ("", FindFullName("Audio"));
+  EXPECT_EQ("Enabled", FindFullName("Data"));
+
+  InitFieldTrialsFromString(nullptr);
+  EXPECT_EQ("", FindFullName("Data"));
+  InitFieldTrialsFromString(previous_trials);
+}
+#endif  // !defined(WEBRTC_EXCLUDE_FIELD_TRIAL_DEFAULT)
+
 }  // namespace field_trial
 }  // namespace webrtc
@@ -9,7 +9,11 @@
 
 #include "system_wrappers/include/metrics.h"
 
+#include <stdint.h>
+
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "rtc_base/critical_section.h"
 #include "rtc_base/thread_annotations.h"
@@ -26,11 +30,24 @@ namespace {
 // TODO(asapersson): Consider using bucket count (and set up
 // linearly/exponentially spaced buckets) if samples are logged more frequently.
 const int kMaxSampleMapSize = 300;
-
+// Maximum number of slots in the sample table of a histogram. A power of two
+// well above kMaxSampleMapSize, which keeps probe sequences short.
+const size_t kMaxSampleSlots = 512;
+
+// Samples are counted per exact value in a fixed size open addressing table,
+// where each slot packs a value and its count into one atomic word, so that
+// Add() never takes a lock. A slot is claimed for a value with a compare and
+// swap and incremented the same way, and reset by swapping in an empty word,
+// so a sample is never counted for a value it wasn't added for.
 class RtcHistogram {
  public:
   RtcHistogram(const std::string& name, int min, int max, int bucket_count)
-      : min_(min), max_(max), info_(name, min, max, bucket_count) {
+      : min_(min),
+        max_(max),
+        name_(name),
+        bucket_count_(bucket_count),
+        num_slots_(NumSlots(min, max)),
+        slots_(new std::atomic<uint64_t>[num_slots_]()) {
     RTC_DCHECK_GT(bucket_count, 0);
   }
 
@@ -38,66 +55,136 @@ class RtcHistogram {
     sample = std::min(sample, max_);
     sample = std::max(sample, min_ - 1);  // Underflow bucket.
 
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.size() == kMaxSampleMapSize &&
-        info_.samples.find(sample) == info_.samples.end()) {
-      return;
+    const uint64_t key = Key(sample);
+    size_t index = FirstSlot(sample);
+    for (size_t probes = 0; probes < num_slots_; ++probes) {
+      std::atomic<uint64_t>& slot = slots_[index];
+      uint64_t word = slot.load(std::memory_order_relaxed);
+      while (true) {
+        if (word == kEmptySlot) {
+          if (num_values_.load(std::memory_order_relaxed) >=
+              kMaxSampleMapSize) {
+            return;
+          }
+          if (slot.compare_exchange_weak(word, key | 1,
+                                         std::memory_order_relaxed)) {
+            num_values_.fetch_add(1, std::memory_order_relaxed);
+            return;
+          }
+        } else if ((word & kKeyMask) == key) {
+          if (slot.compare_exchange_weak(word, word + 1,
+                                         std::memory_order_relaxed)) {
+            return;
+          }
+        } else {
+          break;
+        }
+      }
+      index = (index + 1) & (num_slots_ - 1);
     }
-    ++info_.samples[sample];
   }
 
   // Returns a copy (or nullptr if there are no samples) and clears samples.
   std::unique_ptr<SampleInfo> GetAndReset() {
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.empty())
+    std::map<int, int> samples = TakeSamples();
+    if (samples.empty())
       return nullptr;
 
-    SampleInfo* copy =
-        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
-
-    std::swap(info_.samples, copy->samples);
-
+    SampleInfo* copy = new SampleInfo(name_, min_, max_, bucket_count_);
+    std::swap(samples, copy->samples);
     return std::unique_ptr<SampleInfo>(copy);
   }
 
-  const std::string& name() const { return info_.name; }
+  const std::string& name() const { return name_; }
 
   // Functions only for testing.
-  void Reset() {
-    rtc::CritScope cs(&crit_);
-    info_.samples.clear();
-  }
+  void Reset() { TakeSamples(); }
 
   int NumEvents(int sample) const {
-    rtc::CritScope cs(&crit_);
-    const auto it = info_.samples.find(sample);
-    return (it == info_.samples.end()) ? 0 : it->second;
+    const std::map<int, int> samples = Samples();
+    const auto it = samples.find(sample);
+    return (it == samples.end()) ? 0 : it->second;
   }
 
   int NumSamples() const {
     int num_samples = 0;
-    rtc::CritScope cs(&crit_);
-    for (const auto& sample : info_.samples) {
+    for (const auto& sample : Samples()) {
       num_samples += sample.second;
     }
     return num_samples;
   }
 
   int MinSample() const {
-    rtc::CritScope cs(&crit_);
-    return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
+    const std::map<int, int> samples = Samples();
+    return (samples.empty()) ? -1 : samples.begin()->first;
   }
 
   std::map<int, int> Samples() const {
-    rtc::CritScope cs(&crit_);
-    return info_.samples;
+    std::map<int, int> samples;
+    for (size_t i = 0; i < num_slots_; ++i) {
+      uint64_t word = slots_[i].load(std::memory_order_relaxed);
+      if (word != kEmptySlot)
+        samples[Sample(word)] += Count(word);
+    }
+    return samples;
   }
 
  private:
-  rtc::CriticalSection crit_;
+  static constexpr uint64_t kEmptySlot = 0;
+  static constexpr uint64_t kKeyMask = ~uint64_t{0} << 32;
+
+  // A table with twice as many slots as there are possible values, up to
+  // kMaxSampleSlots.
+  static size_t NumSlots(int min, int max) {
+    const int64_t num_values = int64_t{max} - min + 2;
+    size_t num_slots = 1;
+    while (num_slots < kMaxSampleSlots &&
+           static_cast<int64_t>(num_slots) < 2 * num_values) {
+      num_slots <<= 1;
+    }
+    return num_slots;
+  }
+
+  // The count of a value lives in the low 32 bits of its slot, so a slot
+  // holding a value is never equal to kEmptySlot.
+  static uint64_t Key(int sample) {
+    return uint64_t{static_cast<uint32_t>(sample)} << 32;
+  }
+  static int Sample(uint64_t word) {
+    return static_cast<int32_t>(static_cast<uint32_t>(word >> 32));
+  }
+  static int Count(uint64_t word) {
+    return static_cast<int>(static_cast<uint32_t>(word));
+  }
+
+  // Multiplying by an odd constant spreads nearby values over the table,
+  // without collisions for values that differ by less than the table size.
+  size_t FirstSlot(int sample) const {
+    return (static_cast<uint32_t>(sample) * 0x9E3779B1u) & (num_slots_ - 1);
+  }
+
+  // Empties the table. A value that is added concurrently may briefly occupy
+  // two slots; readers sum the counts of both.
+  std::map<int, int> TakeSamples() {
+    std::map<int, int> samples;
+    for (size_t i = 0; i < num_slots_; ++i) {
+      uint64_t word = slots_[i].exchange(kEmptySlot, std::memory_order_relaxed);
+      if (word != kEmptySlot) {
+        num_values_.fetch_sub(1, std::memory_order_relaxed);
+        samples[Sample(word)] += Count(word);
+      }
+    }
+    return samples;
+  }
+
   const int min_;
   const int max_;
-  SampleInfo info_ RTC_GUARDED_BY(crit_);
+  const std::string name_;
+  const size_t bucket_count_;
+  const size_t num_slots_;
+  const std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  // Number of occupied slots, used to limit the number of distinct values.
+  std::atomic<int> num_values_{0};
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
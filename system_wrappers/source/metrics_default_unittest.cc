@@ -12,8 +12,10 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
 #include "system_wrappers/include/metrics.h"
 #include "test/gtest.h"
 
@@ -164,5 +166,44 @@ TEST_F(MetricsDefaultTest, TestMinMaxBucket) {
   EXPECT_EQ(1u, histograms.begin()->second->samples.size());
 }
 
+TEST_F(MetricsDefaultTest, LimitsNumberOfDistinctSamples) {
+  const std::string kName = "Distinct";
+  for (int i = 0; i < 400; ++i)
+    RTC_HISTOGRAM_COUNTS_10000(kName, i + 1);
+  // Values seen before are still counted once the limit is reached.
+  RTC_HISTOGRAM_COUNTS_10000(kName, 1);
+  EXPECT_EQ(301, metrics::NumSamples(kName));
+  EXPECT_EQ(2, metrics::NumEvents(kName, 1));
+  EXPECT_EQ(0, metrics::NumEvents(kName, 400));
+
+  // Resetting makes room for new values.
+  metrics::Reset();
+  RTC_HISTOGRAM_COUNTS_10000(kName, 400);
+  EXPECT_EQ(1, metrics::NumEvents(kName, 400));
+}
+
+TEST_F(MetricsDefaultTest, AddsSamplesFromManyThreads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kSamplesPerThread = 10000;
+  auto add_samples = [](void*) {
+    for (int i = 0; i < kSamplesPerThread; ++i)
+      RTC_HISTOGRAM_COUNTS_100("Threads", i % 10 + 1);
+  };
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.push_back(
+        std::make_unique<rtc::PlatformThread>(add_samples, nullptr, "adder"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, metrics::NumSamples("Threads"));
+  for (int sample = 1; sample <= 10; ++sample) {
+    EXPECT_EQ(kNumThreads * kSamplesPerThread / 10,
+              metrics::NumEvents("Threads", sample));
+  }
+}
+
 }  // namespace webrtc
 #endif
@@ -32,7 +32,7 @@ bool FileLogWriter::IsActive() const {
   return true;
 }
 
-bool FileLogWriter::Write(const std::string& value) {
+bool FileLogWriter::Write(absl::string_view value) {
   // We don't expect the write to fail. If it does, we don't want to risk
   // silently ignoring it.
   RTC_CHECK_EQ(std::fwrite(value.data(), 1, value.size(), out_), value.size())
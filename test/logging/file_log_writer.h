@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "test/logging/log_writer.h"
 
 namespace webrtc {
@@ -24,7 +25,7 @@ class FileLogWriter final : public RtcEventLogOutput {
   explicit FileLogWriter(std::string file_path);
   ~FileLogWriter() final;
   bool IsActive() const override;
-  bool Write(const std::string& value) override;
+  bool Write(absl::string_view value) override;
   void Flush() override;
 
  private:
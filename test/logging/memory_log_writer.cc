@@ -11,6 +11,7 @@
 
 #include <memory>
 
+#include "absl/strings/string_view.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
@@ -27,7 +28,7 @@ class MemoryLogWriter final : public RtcEventLogOutput {
     target_->insert({filename_, std::string(buffer_.GetBuffer(), size)});
   }
   bool IsActive() const override { return true; }
-  bool Write(const std::string& value) override {
+  bool Write(absl::string_view value) override {
     size_t written;
     int error;
     return buffer_.WriteAll(value.data(), value.size(), &written, &error) ==
@@ -20,6 +20,7 @@ class MockTransformableFrame : public TransformableFrameInterface {
  public:
   MOCK_METHOD(rtc::ArrayView<const uint8_t>, GetData, (), (const, override));
   MOCK_METHOD(void, SetData, (rtc::ArrayView<const uint8_t>), (override));
+  MOCK_METHOD(rtc::ArrayView<uint8_t>, GetMutableData, (size_t), (override));
   MOCK_METHOD(uint32_t, GetTimestamp, (), (const, override));
   MOCK_METHOD(uint32_t, GetSsrc, (), (const, override));
 };
@@ -117,6 +117,11 @@ void NetworkRouterNode::SetReceiver(
 }
 
 void NetworkRouterNode::RemoveReceiver(const rtc::IPAddress& dest_ip) {
+  if (!task_queue_->IsCurrent()) {
+    SendTask(RTC_FROM_HERE, task_queue_->Get(),
+             [this, dest_ip] { RemoveReceiver(dest_ip); });
+    return;
+  }
   RTC_DCHECK_RUN_ON(task_queue_);
   routing_.erase(dest_ip);
 }
@@ -213,13 +218,17 @@ void EmulatedEndpointImpl::SendPacket(const rtc::SocketAddress& from,
   task_queue_->PostTask([this, packet = std::move(packet)]() mutable {
     RTC_DCHECK_RUN_ON(task_queue_);
     Timestamp current_time = clock_->CurrentTime();
-    if (stats_.first_packet_sent_time.IsInfinite()) {
-      stats_.first_packet_sent_time = current_time;
-      stats_.first_sent_packet_size = DataSize::Bytes(packet.ip_packet_size());
+    {
+      rtc::CritScope crit(&receiver_lock_);
+      if (stats_.first_packet_sent_time.IsInfinite()) {
+        stats_.first_packet_sent_time = current_time;
+        stats_.first_sent_packet_size =
+            DataSize::Bytes(packet.ip_packet_size());
+      }
+      stats_.last_packet_sent_time = current_time;
+      stats_.packets_sent++;
+      stats_.bytes_sent += DataSize::Bytes(packet.ip_packet_size());
     }
-    stats_.last_packet_sent_time = current_time;
-    stats_.packets_sent++;
-    stats_.bytes_sent += DataSize::Bytes(packet.ip_packet_size());
 
     router_.OnPacketReceived(std::move(packet));
   });
@@ -276,6 +285,12 @@ rtc::IPAddress EmulatedEndpointImpl::GetPeerLocalAddress() const {
 }
 
 void EmulatedEndpointImpl::OnPacketReceived(EmulatedIpPacket packet) {
+  if (!task_queue_->IsCurrent()) {
+    task_queue_->PostTask([this, packet = std::move(packet)]() mutable {
+      OnPacketReceived(std::move(packet));
+    });
+    return;
+  }
   RTC_DCHECK_RUN_ON(task_queue_);
   RTC_CHECK(packet.to.ipaddr() == peer_local_addr_)
       << "Routing error: wrong destination endpoint. Packet.to.ipaddr()=: "
@@ -318,12 +333,11 @@ bool EmulatedEndpointImpl::Enabled() const {
 }
 
 EmulatedNetworkStats EmulatedEndpointImpl::stats() {
-  RTC_DCHECK_RUN_ON(task_queue_);
+  rtc::CritScope crit(&receiver_lock_);
   return stats_;
 }
 
 void EmulatedEndpointImpl::UpdateReceiveStats(const EmulatedIpPacket& packet) {
-  RTC_DCHECK_RUN_ON(task_queue_);
   Timestamp current_time = clock_->CurrentTime();
   if (stats_.first_packet_received_time.IsInfinite()) {
     stats_.first_packet_received_time = current_time;
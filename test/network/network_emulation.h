@@ -72,6 +72,7 @@ class NetworkRouterNode : public EmulatedNetworkReceiverInterface {
   void OnPacketReceived(EmulatedIpPacket packet) override;
   void SetReceiver(const rtc::IPAddress& dest_ip,
                    EmulatedNetworkReceiverInterface* receiver);
+  // Can be called from any thread, and returns once the receiver is removed.
   void RemoveReceiver(const rtc::IPAddress& dest_ip);
   void SetWatcher(std::function<void(const EmulatedIpPacket&)> watcher);
   void SetFilter(std::function<bool(const EmulatedIpPacket&)> filter);
@@ -152,7 +153,9 @@ class EmulatedEndpointImpl : public EmulatedEndpoint {
 
   rtc::IPAddress GetPeerLocalAddress() const override;
 
-  // Will be called to deliver packet into endpoint from network node.
+  // Will be called to deliver packet into endpoint from network node. The
+  // node may run on another task queue than the endpoint, in which case the
+  // packet is passed on to the endpoint's task queue.
   void OnPacketReceived(EmulatedIpPacket packet) override;
 
   void Enable();
@@ -166,7 +169,8 @@ class EmulatedEndpointImpl : public EmulatedEndpoint {
  private:
   static constexpr uint16_t kFirstEphemeralPort = 49152;
   uint16_t NextPort() RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_lock_);
-  void UpdateReceiveStats(const EmulatedIpPacket& packet);
+  void UpdateReceiveStats(const EmulatedIpPacket& packet)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(receiver_lock_);
 
   rtc::CriticalSection receiver_lock_;
   rtc::ThreadChecker enabled_state_checker_;
@@ -185,7 +189,9 @@ class EmulatedEndpointImpl : public EmulatedEndpoint {
   std::map<uint16_t, EmulatedNetworkReceiverInterface*> port_to_receiver_
       RTC_GUARDED_BY(receiver_lock_);
 
-  EmulatedNetworkStats stats_ RTC_GUARDED_BY(task_queue_);
+  // Guarded by the lock rather than the task queue, because the stats of
+  // endpoints on different task queues are read together.
+  EmulatedNetworkStats stats_ RTC_GUARDED_BY(receiver_lock_);
 };
 
 class EmulatedRoute {
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
 
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
@@ -43,14 +44,29 @@ std::unique_ptr<TimeController> CreateTimeController(TimeMode mode) {
 }
 }  // namespace
 
-NetworkEmulationManagerImpl::NetworkEmulationManagerImpl(TimeMode mode)
-    : time_controller_(CreateTimeController(mode)),
+NetworkEmulationManagerImpl::NetworkEmulationManagerImpl(TimeMode mode,
+                                                         int num_task_queues)
+    : NetworkEmulationManagerImpl(CreateTimeController(mode),
+                                  num_task_queues) {}
+
+NetworkEmulationManagerImpl::NetworkEmulationManagerImpl(
+    std::unique_ptr<TimeController> time_controller,
+    int num_task_queues)
+    : time_controller_(std::move(time_controller)),
       clock_(time_controller_->GetClock()),
       next_node_id_(1),
       next_ip4_address_(kMinIPv4Address),
       task_queue_(time_controller_->GetTaskQueueFactory()->CreateTaskQueue(
           "NetworkEmulation",
-          TaskQueueFactory::Priority::NORMAL)) {}
+          TaskQueueFactory::Priority::NORMAL)) {
+  RTC_CHECK_GE(num_task_queues, 1);
+  for (int i = 1; i < num_task_queues; ++i) {
+    extra_task_queues_.push_back(std::make_unique<TaskQueueForTest>(
+        time_controller_->GetTaskQueueFactory()->CreateTaskQueue(
+            "NetworkEmulation" + std::to_string(i),
+            TaskQueueFactory::Priority::NORMAL)));
+  }
+}
 
 // TODO(srte): Ensure that any pending task that must be run for consistency
 // (such as stats collection tasks) are not cancelled when the task queue is
@@ -65,7 +81,7 @@ EmulatedNetworkNode* NetworkEmulationManagerImpl::CreateEmulatedNode(
 EmulatedNetworkNode* NetworkEmulationManagerImpl::CreateEmulatedNode(
     std::unique_ptr<NetworkBehaviorInterface> network_behavior) {
   auto node = std::make_unique<EmulatedNetworkNode>(
-      clock_, &task_queue_, std::move(network_behavior));
+      clock_, NextTaskQueue(), std::move(network_behavior));
   EmulatedNetworkNode* out = node.get();
   task_queue_.PostTask([this, node = std::move(node)]() mutable {
     network_nodes_.push_back(std::move(node));
@@ -80,6 +96,12 @@ NetworkEmulationManagerImpl::NodeBuilder() {
 
 EmulatedEndpoint* NetworkEmulationManagerImpl::CreateEndpoint(
     EmulatedEndpointConfig config) {
+  return CreateEndpointOnTaskQueue(config, NextTaskQueue());
+}
+
+EmulatedEndpointImpl* NetworkEmulationManagerImpl::CreateEndpointOnTaskQueue(
+    EmulatedEndpointConfig config,
+    rtc::TaskQueue* task_queue) {
   absl::optional<rtc::IPAddress> ip = config.ip;
   if (!ip) {
     switch (config.generated_ip_family) {
@@ -98,9 +120,9 @@ EmulatedEndpoint* NetworkEmulationManagerImpl::CreateEndpoint(
   bool res = used_ip_addresses_.insert(*ip).second;
   RTC_CHECK(res) << "IP=" << ip->ToString() << " already in use";
   auto node = std::make_unique<EmulatedEndpointImpl>(
-      next_node_id_++, *ip, config.start_as_enabled, config.type, &task_queue_,
+      next_node_id_++, *ip, config.start_as_enabled, config.type, task_queue,
       clock_);
-  EmulatedEndpoint* out = node.get();
+  EmulatedEndpointImpl* out = node.get();
   endpoints_.push_back(std::move(node));
   return out;
 }
@@ -147,31 +169,32 @@ EmulatedRoute* NetworkEmulationManagerImpl::CreateRoute(
 
 EmulatedRoute* NetworkEmulationManagerImpl::CreateRoute(
     const std::vector<EmulatedNetworkNode*>& via_nodes) {
-  EmulatedEndpoint* from = CreateEndpoint(EmulatedEndpointConfig());
-  EmulatedEndpoint* to = CreateEndpoint(EmulatedEndpointConfig());
+  // The cross traffic and TCP message routes using these endpoints run on
+  // |task_queue_|.
+  EmulatedEndpoint* from =
+      CreateEndpointOnTaskQueue(EmulatedEndpointConfig(), &task_queue_);
+  EmulatedEndpoint* to =
+      CreateEndpointOnTaskQueue(EmulatedEndpointConfig(), &task_queue_);
   return CreateRoute(from, via_nodes, to);
 }
 
 void NetworkEmulationManagerImpl::ClearRoute(EmulatedRoute* route) {
   RTC_CHECK(route->active) << "Route already cleared";
-  task_queue_.SendTask(
-      [route]() {
-        // Remove receiver from intermediate nodes.
-        for (auto* node : route->via_nodes) {
-          node->router()->RemoveReceiver(route->to->GetPeerLocalAddress());
-        }
-        // Remove destination endpoint from source endpoint's router.
-        route->from->router()->RemoveReceiver(route->to->GetPeerLocalAddress());
-
-        route->active = false;
-      },
-      RTC_FROM_HERE);
+  // Remove receiver from intermediate nodes.
+  for (auto* node : route->via_nodes) {
+    node->router()->RemoveReceiver(route->to->GetPeerLocalAddress());
+  }
+  // Remove destination endpoint from source endpoint's router.
+  route->from->router()->RemoveReceiver(route->to->GetPeerLocalAddress());
+
+  route->active = false;
 }
 
 TrafficRoute* NetworkEmulationManagerImpl::CreateTrafficRoute(
     const std::vector<EmulatedNetworkNode*>& via_nodes) {
   RTC_CHECK(!via_nodes.empty());
-  EmulatedEndpoint* endpoint = CreateEndpoint(EmulatedEndpointConfig());
+  EmulatedEndpoint* endpoint =
+      CreateEndpointOnTaskQueue(EmulatedEndpointConfig(), &task_queue_);
 
   // Setup a route via specified nodes.
   EmulatedNetworkNode* cur_node = via_nodes[0];
@@ -295,6 +318,13 @@ NetworkEmulationManagerImpl::CreateEmulatedNetworkManagerInterface(
   return out;
 }
 
+rtc::TaskQueue* NetworkEmulationManagerImpl::NextTaskQueue() {
+  const size_t index = next_task_queue_index_;
+  next_task_queue_index_ =
+      (next_task_queue_index_ + 1) % (extra_task_queues_.size() + 1);
+  return index == 0 ? &task_queue_ : extra_task_queues_[index - 1].get();
+}
+
 absl::optional<rtc::IPAddress>
 NetworkEmulationManagerImpl::GetNextIPv4Address() {
   uint32_t addresses_count = kMaxIPv4Address - kMinIPv4Address;
@@ -39,7 +39,15 @@ namespace test {
 
 class NetworkEmulationManagerImpl : public NetworkEmulationManager {
  public:
-  explicit NetworkEmulationManagerImpl(TimeMode mode);
+  // Emulated nodes and endpoints are spread over |num_task_queues| task
+  // queues, so that independent network paths can be processed in parallel in
+  // real time mode. Packets crossing from one task queue to another are
+  // posted to the receiving one.
+  explicit NetworkEmulationManagerImpl(TimeMode mode, int num_task_queues = 1);
+  // Uses |time_controller| instead of creating one from a TimeMode.
+  explicit NetworkEmulationManagerImpl(
+      std::unique_ptr<TimeController> time_controller,
+      int num_task_queues = 1);
   ~NetworkEmulationManagerImpl();
 
   EmulatedNetworkNode* CreateEmulatedNode(
@@ -88,6 +96,10 @@ class NetworkEmulationManagerImpl : public NetworkEmulationManager {
   Timestamp Now() const;
 
  private:
+  EmulatedEndpointImpl* CreateEndpointOnTaskQueue(EmulatedEndpointConfig config,
+                                                 rtc::TaskQueue* task_queue);
+  // Returns the task queue for the next created node or endpoint.
+  rtc::TaskQueue* NextTaskQueue();
   absl::optional<rtc::IPAddress> GetNextIPv4Address();
   const std::unique_ptr<TimeController> time_controller_;
   Clock* const clock_;
@@ -113,6 +125,12 @@ class NetworkEmulationManagerImpl : public NetworkEmulationManager {
   std::map<EmulatedEndpoint*, EmulatedNetworkManager*>
       endpoint_to_network_manager_;
 
+  size_t next_task_queue_index_ = 0;
+  // Task queues used for nodes and endpoints in addition to |task_queue_|.
+  // They must be deleted before the nodes and endpoints, for the same reason
+  // as |task_queue_|.
+  std::vector<std::unique_ptr<TaskQueueForTest>> extra_task_queues_;
+
   // Must be the last field, so it will be deleted first, because tasks
   // in the TaskQueue can access other fields of the instance of this class.
   TaskQueueForTest task_queue_;
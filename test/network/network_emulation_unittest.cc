@@ -73,6 +73,15 @@ class MockReceiver : public EmulatedNetworkReceiverInterface {
   MOCK_METHOD(void, OnPacketReceived, (EmulatedIpPacket packet), (override));
 };
 
+class CountingReceiver : public EmulatedNetworkReceiverInterface {
+ public:
+  void OnPacketReceived(EmulatedIpPacket packet) override { ++count_; }
+  int count() const { return count_.load(); }
+
+ private:
+  std::atomic<int> count_{0};
+};
+
 class NetworkEmulationManagerThreeNodesRoutingTest : public ::testing::Test {
  public:
   NetworkEmulationManagerThreeNodesRoutingTest() {
@@ -345,6 +354,66 @@ TEST(NetworkEmulationManagerTest, ThroughputStats) {
   t2->Invoke<void>(RTC_FROM_HERE, [&] { delete s2; });
 }
 
+TEST(NetworkEmulationManagerTest, DeliversPacketsBetweenTaskQueues) {
+  constexpr int kNumPairs = 4;
+  constexpr int kNumPackets = 100;
+  constexpr uint16_t kSendPort = 80;
+  // Receivers must be destroyed after emulation, so they are declared before.
+  CountingReceiver receivers[kNumPairs][2];
+  NetworkEmulationManagerImpl network_manager(TimeMode::kRealTime,
+                                              /*num_task_queues=*/3);
+
+  EmulatedEndpoint* endpoints[kNumPairs][2];
+  EmulatedRoute* routes[kNumPairs][2];
+  uint16_t ports[kNumPairs][2];
+  for (int i = 0; i < kNumPairs; ++i) {
+    for (int j = 0; j < 2; ++j) {
+      endpoints[i][j] =
+          network_manager.CreateEndpoint(EmulatedEndpointConfig());
+      ports[i][j] = *endpoints[i][j]->BindReceiver(0, &receivers[i][j]);
+    }
+    for (int j = 0; j < 2; ++j) {
+      routes[i][j] = network_manager.CreateRoute(
+          endpoints[i][j],
+          {CreateEmulatedNodeWithDefaultBuiltInConfig(&network_manager)},
+          endpoints[i][1 - j]);
+    }
+  }
+
+  auto send_packets = [&] {
+    for (int n = 0; n < kNumPackets; ++n) {
+      for (int i = 0; i < kNumPairs; ++i) {
+        for (int j = 0; j < 2; ++j) {
+          EmulatedEndpoint* to = endpoints[i][1 - j];
+          endpoints[i][j]->SendPacket(
+              rtc::SocketAddress(endpoints[i][j]->GetPeerLocalAddress(),
+                                 kSendPort),
+              rtc::SocketAddress(to->GetPeerLocalAddress(), ports[i][1 - j]),
+              rtc::CopyOnWriteBuffer(10));
+        }
+      }
+    }
+    network_manager.time_controller()->AdvanceTime(kNetworkPacketWaitTimeout);
+  };
+
+  send_packets();
+  for (int i = 0; i < kNumPairs; ++i) {
+    EXPECT_EQ(receivers[i][0].count(), kNumPackets);
+    EXPECT_EQ(receivers[i][1].count(), kNumPackets);
+  }
+
+  // Packets are no longer delivered over a cleared route, while the other
+  // routes are unaffected.
+  network_manager.ClearRoute(routes[0][0]);
+  send_packets();
+  EXPECT_EQ(receivers[0][1].count(), kNumPackets);
+  EXPECT_EQ(receivers[0][0].count(), 2 * kNumPackets);
+  for (int i = 1; i < kNumPairs; ++i) {
+    EXPECT_EQ(receivers[i][0].count(), 2 * kNumPackets);
+    EXPECT_EQ(receivers[i][1].count(), 2 * kNumPackets);
+  }
+}
+
 // Testing that packets are delivered via all routes using a routing scheme as
 // follows:
 //  * e1 -> n1 -> e2
@@ -25,7 +25,6 @@ namespace webrtc {
 namespace webrtc_pc_e2e {
 namespace {
 
-constexpr int kMaxActiveComparisons = 10;
 constexpr int kFreezeThresholdMs = 150;
 constexpr int kMicrosPerSecond = 1000000;
 constexpr int kBitsInByte = 8;
@@ -46,6 +45,24 @@ void LogStreamInternalStats(const std::string& name, const StreamStats& stats) {
                 << stats.dropped_before_encoder;
 }
 
+// Returns a copy of |frame| holding its own I420 buffer, downscaled by
+// |downscale_factor| in each dimension.
+VideoFrame CopyFrame(const VideoFrame& frame, int downscale_factor) {
+  rtc::scoped_refptr<I420BufferInterface> buffer =
+      frame.video_frame_buffer()->ToI420();
+  VideoFrame copy = frame;
+  if (downscale_factor <= 1) {
+    copy.set_video_frame_buffer(I420Buffer::Copy(*buffer));
+    return copy;
+  }
+  rtc::scoped_refptr<I420Buffer> scaled =
+      I420Buffer::Create(std::max(1, buffer->width() / downscale_factor),
+                         std::max(1, buffer->height() / downscale_factor));
+  scaled->ScaleFrom(*buffer);
+  copy.set_video_frame_buffer(scaled);
+  return copy;
+}
+
 }  // namespace
 
 void RateCounter::AddEvent(Timestamp event_time) {
@@ -68,10 +85,25 @@ double RateCounter::GetEventsPerSecond() const {
 DefaultVideoQualityAnalyzer::DefaultVideoQualityAnalyzer(
     bool heavy_metrics_computation_enabled,
     int max_frames_in_flight_per_stream_count)
-    : heavy_metrics_computation_enabled_(heavy_metrics_computation_enabled),
+    : DefaultVideoQualityAnalyzer([&] {
+        DefaultVideoQualityAnalyzerOptions options;
+        options.heavy_metrics_computation_enabled =
+            heavy_metrics_computation_enabled;
+        options.max_frames_in_flight_per_stream_count =
+            max_frames_in_flight_per_stream_count;
+        return options;
+      }()) {}
+DefaultVideoQualityAnalyzer::DefaultVideoQualityAnalyzer(
+    DefaultVideoQualityAnalyzerOptions options)
+    : heavy_metrics_computation_enabled_(
+          options.heavy_metrics_computation_enabled),
       max_frames_in_flight_per_stream_count_(
-          max_frames_in_flight_per_stream_count),
-      clock_(Clock::GetRealTimeClock()) {}
+          options.max_frames_in_flight_per_stream_count),
+      frames_downscale_factor_(options.frames_downscale_factor),
+      max_comparisons_queue_size_(options.max_comparisons_queue_size),
+      clock_(Clock::GetRealTimeClock()) {
+  RTC_CHECK_GE(frames_downscale_factor_, 1);
+}
 DefaultVideoQualityAnalyzer::~DefaultVideoQualityAnalyzer() {
   Stop();
 }
@@ -113,14 +145,21 @@ uint16_t DefaultVideoQualityAnalyzer::OnFrameCaptured(
   {
     // Ensure stats for this stream exists.
     rtc::CritScope crit(&comparison_lock_);
-    if (stream_stats_.find(stream_label) == stream_stats_.end()) {
-      stream_stats_.insert({stream_label, StreamStats()});
+    if (stream_comparison_states_.find(stream_label) ==
+        stream_comparison_states_.end()) {
       // Assume that the first freeze was before first stream frame captured.
       // This way time before the first freeze would be counted as time between
       // freezes.
-      stream_last_freeze_end_time_.insert({stream_label, start_time});
+      stream_comparison_states_.emplace(
+          stream_label, std::make_unique<StreamComparisonState>(start_time));
     }
   }
+  // Keeping a reference to the captured buffer is cheap, so the frame is only
+  // copied, outside of the lock, when it has to be downscaled.
+  VideoFrame captured_frame =
+      frames_downscale_factor_ > 1 ? CopyFrame(frame, frames_downscale_factor_)
+                                   : frame;
+  captured_frame.set_id(frame_id);
   {
     rtc::CritScope crit(&lock_);
     frame_counters_.captured++;
@@ -147,9 +186,7 @@ uint16_t DefaultVideoQualityAnalyzer::OnFrameCaptured(
       frame_stats_.erase(stats_it);
     }
     captured_frames_in_flight_.insert(
-        std::pair<uint16_t, VideoFrame>(frame_id, frame));
-    // Set frame id on local copy of the frame
-    captured_frames_in_flight_.at(frame_id).set_id(frame_id);
+        std::pair<uint16_t, VideoFrame>(frame_id, std::move(captured_frame)));
     frame_stats_.insert(std::pair<uint16_t, FrameStats>(
         frame_id, FrameStats(stream_label, /*captured_time=*/Now())));
 
@@ -252,9 +289,7 @@ void DefaultVideoQualityAnalyzer::OnFrameRendered(
     const webrtc::VideoFrame& raw_frame) {
   // Copy entire video frame including video buffer to ensure that analyzer
   // won't hold any WebRTC internal buffers.
-  VideoFrame frame = raw_frame;
-  frame.set_video_frame_buffer(
-      I420Buffer::Copy(*raw_frame.video_frame_buffer()->ToI420()));
+  VideoFrame frame = CopyFrame(raw_frame, frames_downscale_factor_);
 
   rtc::CritScope crit(&lock_);
   auto stats_it = frame_stats_.find(frame.id());
@@ -266,8 +301,8 @@ void DefaultVideoQualityAnalyzer::OnFrameRendered(
 
   // Update current frame stats.
   frame_stats->rendered_time = Now();
-  frame_stats->rendered_frame_width = frame.width();
-  frame_stats->rendered_frame_height = frame.height();
+  frame_stats->rendered_frame_width = raw_frame.width();
+  frame_stats->rendered_frame_height = raw_frame.height();
 
   // Find corresponding captured frame.
   auto frame_it = captured_frames_in_flight_.find(frame.id());
@@ -320,9 +355,10 @@ void DefaultVideoQualityAnalyzer::OnFrameRendered(
   }
   state->set_last_rendered_frame_time(frame_stats->rendered_time);
   {
-    rtc::CritScope cr(&comparison_lock_);
-    stream_stats_[stream_label].skipped_between_rendered.AddSample(
-        dropped_count);
+    StreamComparisonState* comparison_state =
+        GetStreamComparisonState(stream_label);
+    rtc::CritScope cr(&comparison_state->lock);
+    comparison_state->stats.skipped_between_rendered.AddSample(dropped_count);
   }
   AddComparison(captured_frame, frame, false, *frame_stats);
 
@@ -371,17 +407,19 @@ void DefaultVideoQualityAnalyzer::Stop() {
     // between freezes.
     rtc::CritScope crit1(&lock_);
     rtc::CritScope crit2(&comparison_lock_);
-    for (auto& item : stream_stats_) {
+    for (auto& item : stream_comparison_states_) {
       const StreamState& state = stream_states_[item.first];
+      StreamComparisonState* comparison_state = item.second.get();
+      rtc::CritScope crit3(&comparison_state->lock);
       // If there are no freezes in the call we have to report
       // time_between_freezes_ms as call duration and in such case
-      // |stream_last_freeze_end_time_| for this stream will be |start_time_|.
+      // |last_freeze_end_time| for this stream will be |start_time_|.
       // If there is freeze, then we need add time from last rendered frame
       // to last freeze end as time between freezes.
       if (state.last_rendered_frame_time()) {
-        item.second.time_between_freezes_ms.AddSample(
+        comparison_state->stats.time_between_freezes_ms.AddSample(
             (state.last_rendered_frame_time().value() -
-             stream_last_freeze_end_time_.at(item.first))
+             comparison_state->last_freeze_end_time)
                 .ms());
       }
     }
@@ -409,7 +447,7 @@ std::set<std::string> DefaultVideoQualityAnalyzer::GetKnownVideoStreams()
     const {
   rtc::CritScope crit2(&comparison_lock_);
   std::set<std::string> out;
-  for (auto& item : stream_stats_) {
+  for (auto& item : stream_comparison_states_) {
     out.insert(item.first);
   }
   return out;
@@ -429,7 +467,12 @@ DefaultVideoQualityAnalyzer::GetPerStreamCounters() const {
 std::map<std::string, StreamStats> DefaultVideoQualityAnalyzer::GetStats()
     const {
   rtc::CritScope cri(&comparison_lock_);
-  return stream_stats_;
+  std::map<std::string, StreamStats> stats;
+  for (auto& item : stream_comparison_states_) {
+    rtc::CritScope crit(&item.second->lock);
+    stats.emplace(item.first, item.second->stats);
+  }
+  return stats;
 }
 
 AnalyzerStats DefaultVideoQualityAnalyzer::GetAnalyzerStats() const {
@@ -447,7 +490,7 @@ void DefaultVideoQualityAnalyzer::AddComparison(
   analyzer_stats_.comparisons_queue_size.AddSample(comparisons_.size());
   // If there too many computations waiting in the queue, we won't provide
   // frames itself to make future computations lighter.
-  if (comparisons_.size() >= kMaxActiveComparisons) {
+  if (comparisons_.size() >= max_comparisons_queue_size_) {
     comparisons_.emplace_back(absl::nullopt, absl::nullopt, dropped,
                               frame_stats, OverloadReason::kCpu);
   } else {
@@ -462,6 +505,15 @@ void DefaultVideoQualityAnalyzer::AddComparison(
   StopExcludingCpuThreadTime();
 }
 
+DefaultVideoQualityAnalyzer::StreamComparisonState*
+DefaultVideoQualityAnalyzer::GetStreamComparisonState(
+    const std::string& stream_label) const {
+  rtc::CritScope crit(&comparison_lock_);
+  auto it = stream_comparison_states_.find(stream_label);
+  RTC_CHECK(it != stream_comparison_states_.end());
+  return it->second.get();
+}
+
 void DefaultVideoQualityAnalyzer::ProcessComparisonsThread(void* obj) {
   static_cast<DefaultVideoQualityAnalyzer*>(obj)->ProcessComparisons();
 }
@@ -515,16 +567,20 @@ void DefaultVideoQualityAnalyzer::ProcessComparison(
 
   const FrameStats& frame_stats = comparison.frame_stats;
 
-  rtc::CritScope crit(&comparison_lock_);
-  auto stats_it = stream_stats_.find(frame_stats.stream_label);
-  RTC_CHECK(stats_it != stream_stats_.end());
-  StreamStats* stats = &stats_it->second;
-  analyzer_stats_.comparisons_done++;
-  if (comparison.overload_reason == OverloadReason::kCpu) {
-    analyzer_stats_.cpu_overloaded_comparisons_done++;
-  } else if (comparison.overload_reason == OverloadReason::kMemory) {
-    analyzer_stats_.memory_overloaded_comparisons_done++;
+  {
+    rtc::CritScope crit(&comparison_lock_);
+    analyzer_stats_.comparisons_done++;
+    if (comparison.overload_reason == OverloadReason::kCpu) {
+      analyzer_stats_.cpu_overloaded_comparisons_done++;
+    } else if (comparison.overload_reason == OverloadReason::kMemory) {
+      analyzer_stats_.memory_overloaded_comparisons_done++;
+    }
   }
+
+  StreamComparisonState* comparison_state =
+      GetStreamComparisonState(frame_stats.stream_label);
+  rtc::CritScope crit(&comparison_state->lock);
+  StreamStats* stats = &comparison_state->stats;
   if (psnr > 0) {
     stats->psnr.AddSample(psnr);
   }
@@ -569,13 +625,11 @@ void DefaultVideoQualityAnalyzer::ProcessComparison(
           std::max(kFreezeThresholdMs + average_time_between_rendered_frames_ms,
                    3 * average_time_between_rendered_frames_ms)) {
         stats->freeze_time_ms.AddSample(time_between_rendered_frames.ms());
-        auto freeze_end_it =
-            stream_last_freeze_end_time_.find(frame_stats.stream_label);
-        RTC_DCHECK(freeze_end_it != stream_last_freeze_end_time_.end());
         stats->time_between_freezes_ms.AddSample(
-            (frame_stats.prev_frame_rendered_time - freeze_end_it->second)
+            (frame_stats.prev_frame_rendered_time -
+             comparison_state->last_freeze_end_time)
                 .ms());
-        freeze_end_it->second = frame_stats.rendered_time;
+        comparison_state->last_freeze_end_time = frame_stats.rendered_time;
       }
     }
   }
@@ -586,16 +640,18 @@ void DefaultVideoQualityAnalyzer::ReportResults() {
 
   rtc::CritScope crit1(&lock_);
   rtc::CritScope crit2(&comparison_lock_);
-  for (auto& item : stream_stats_) {
-    ReportResults(GetTestCaseName(item.first), item.second,
+  for (auto& item : stream_comparison_states_) {
+    rtc::CritScope crit3(&item.second->lock);
+    ReportResults(GetTestCaseName(item.first), item.second->stats,
                   stream_frame_counters_.at(item.first));
   }
   test::PrintResult("cpu_usage", "", test_label_.c_str(), GetCpuUsagePercent(),
                     "%", false, ImproveDirection::kSmallerIsBetter);
   LogFrameCounters("Global", frame_counters_);
-  for (auto& item : stream_stats_) {
+  for (auto& item : stream_comparison_states_) {
+    rtc::CritScope crit3(&item.second->lock);
     LogFrameCounters(item.first, stream_frame_counters_.at(item.first));
-    LogStreamInternalStats(item.first, item.second);
+    LogStreamInternalStats(item.first, item.second->stats);
   }
   if (!analyzer_stats_.comparisons_queue_size.IsEmpty()) {
     RTC_LOG(INFO) << "comparisons_queue_size min="
@@ -38,6 +38,26 @@ namespace webrtc_pc_e2e {
 // key frame request.
 constexpr int kDefaultMaxFramesInFlightPerStream = 270;
 
+struct DefaultVideoQualityAnalyzerOptions {
+  // Tells DefaultVideoQualityAnalyzer if heavy metrics like PSNR and SSIM have
+  // to be computed or not.
+  bool heavy_metrics_computation_enabled = true;
+  // Amount of frames that are queued in the DefaultVideoQualityAnalyzer from
+  // the point they were captured to the point they were rendered on all
+  // receivers per stream.
+  int max_frames_in_flight_per_stream_count =
+      kDefaultMaxFramesInFlightPerStream;
+  // If greater than 1, captured and rendered frames are kept downscaled by
+  // this factor in each dimension and PSNR and SSIM are computed on the
+  // downscaled frames. This reduces the memory used by frames in flight and
+  // the cost of the comparisons, at the price of less precise metrics.
+  int frames_downscale_factor = 1;
+  // Max number of comparisons waiting to be processed. Comparisons added
+  // while the queue is full are done without PSNR and SSIM and are counted
+  // in AnalyzerStats::cpu_overloaded_comparisons_done.
+  int max_comparisons_queue_size = 10;
+};
+
 class RateCounter {
  public:
   void AddEvent(Timestamp event_time);
@@ -132,6 +152,8 @@ class DefaultVideoQualityAnalyzer : public VideoQualityAnalyzerInterface {
       bool heavy_metrics_computation_enabled = true,
       int max_frames_in_flight_per_stream_count =
           kDefaultMaxFramesInFlightPerStream);
+  explicit DefaultVideoQualityAnalyzer(
+      DefaultVideoQualityAnalyzerOptions options);
   ~DefaultVideoQualityAnalyzer() override;
 
   void Start(std::string test_case_name, int max_threads_count) override;
@@ -278,12 +300,27 @@ class DefaultVideoQualityAnalyzer : public VideoQualityAnalyzerInterface {
     absl::optional<Timestamp> last_rendered_frame_time_ = absl::nullopt;
   };
 
+  // Stats of a single stream. Each stream has its own lock, so that the
+  // comparisons of different streams don't wait for each other.
+  struct StreamComparisonState {
+    explicit StreamComparisonState(Timestamp last_freeze_end_time)
+        : last_freeze_end_time(last_freeze_end_time) {}
+
+    rtc::CriticalSection lock;
+    StreamStats stats RTC_GUARDED_BY(lock);
+    Timestamp last_freeze_end_time RTC_GUARDED_BY(lock);
+  };
+
   enum State { kNew, kActive, kStopped };
 
   void AddComparison(absl::optional<VideoFrame> captured,
                      absl::optional<VideoFrame> rendered,
                      bool dropped,
                      FrameStats frame_stats);
+  // Returns the state of an already known stream. The returned state lives as
+  // long as the analyzer.
+  StreamComparisonState* GetStreamComparisonState(
+      const std::string& stream_label) const;
   static void ProcessComparisonsThread(void* obj);
   void ProcessComparisons();
   void ProcessComparison(const FrameComparison& comparison);
@@ -312,6 +349,8 @@ class DefaultVideoQualityAnalyzer : public VideoQualityAnalyzerInterface {
 
   const bool heavy_metrics_computation_enabled_;
   const int max_frames_in_flight_per_stream_count_;
+  const int frames_downscale_factor_;
+  const size_t max_comparisons_queue_size_;
   webrtc::Clock* const clock_;
   std::atomic<uint16_t> next_frame_id_{0};
 
@@ -345,10 +384,10 @@ class DefaultVideoQualityAnalyzer : public VideoQualityAnalyzerInterface {
       RTC_GUARDED_BY(lock_);
 
   rtc::CriticalSection comparison_lock_;
-  std::map<std::string, StreamStats> stream_stats_
-      RTC_GUARDED_BY(comparison_lock_);
-  std::map<std::string, Timestamp> stream_last_freeze_end_time_
-      RTC_GUARDED_BY(comparison_lock_);
+  // Streams are never removed, so the states can be used without holding
+  // |comparison_lock_| once found.
+  std::map<std::string, std::unique_ptr<StreamComparisonState>>
+      stream_comparison_states_ RTC_GUARDED_BY(comparison_lock_);
   std::deque<FrameComparison> comparisons_ RTC_GUARDED_BY(comparison_lock_);
   AnalyzerStats analyzer_stats_ RTC_GUARDED_BY(comparison_lock_);
 
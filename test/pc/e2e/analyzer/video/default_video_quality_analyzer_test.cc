@@ -215,6 +215,96 @@ TEST(DefaultVideoQualityAnalyzerTest, NormalScenario) {
   EXPECT_EQ(frame_counters.dropped, kMaxFramesInFlightPerStream / 2);
 }
 
+TEST(DefaultVideoQualityAnalyzerTest, ComparesDownscaledFrames) {
+  std::unique_ptr<test::FrameGeneratorInterface> frame_generator =
+      test::CreateSquareFrameGenerator(kFrameWidth, kFrameHeight,
+                                       /*type=*/absl::nullopt,
+                                       /*num_squares=*/absl::nullopt);
+
+  DefaultVideoQualityAnalyzerOptions options;
+  options.max_frames_in_flight_per_stream_count = kMaxFramesInFlightPerStream;
+  options.frames_downscale_factor = 2;
+  options.max_comparisons_queue_size = kMaxFramesInFlightPerStream;
+  DefaultVideoQualityAnalyzer analyzer(options);
+  analyzer.Start("test_case", kAnalyzerMaxThreadsCount);
+
+  for (int i = 0; i < kMaxFramesInFlightPerStream; ++i) {
+    VideoFrame frame = NextFrame(frame_generator.get(), i);
+    frame.set_id(
+        analyzer.OnFrameCaptured(kSenderPeerName, kStreamLabel, frame));
+    analyzer.OnFramePreEncode(kSenderPeerName, frame);
+    analyzer.OnFrameEncoded(kSenderPeerName, frame.id(), FakeEncode(frame),
+                            VideoQualityAnalyzerInterface::EncoderStats());
+    VideoFrame received_frame = DeepCopy(frame);
+    analyzer.OnFramePreDecode(kReceiverPeerName, received_frame.id(),
+                              FakeEncode(received_frame));
+    analyzer.OnFrameDecoded(kReceiverPeerName, received_frame,
+                            VideoQualityAnalyzerInterface::DecoderStats());
+    analyzer.OnFrameRendered(kReceiverPeerName, received_frame);
+  }
+
+  // Give analyzer some time to process frames on async thread.
+  SleepMs(1000);
+  analyzer.Stop();
+
+  AnalyzerStats analyzer_stats = analyzer.GetAnalyzerStats();
+  EXPECT_EQ(analyzer_stats.comparisons_done, kMaxFramesInFlightPerStream);
+  EXPECT_EQ(analyzer_stats.cpu_overloaded_comparisons_done, 0);
+  std::map<std::string, StreamStats> stats = analyzer.GetStats();
+  ASSERT_EQ(stats.size(), 1lu);
+  const StreamStats& stream_stats = stats.at(kStreamLabel);
+  // Identical frames give the max PSNR and SSIM also when downscaled.
+  ASSERT_EQ(stream_stats.psnr.GetSamples().size(),
+            static_cast<size_t>(kMaxFramesInFlightPerStream));
+  EXPECT_GE(stream_stats.psnr.GetMin(), 48.0);
+  EXPECT_NEAR(stream_stats.ssim.GetMin(), 1.0, 1e-6);
+  // The resolution is the one of the rendered frames, not of the downscaled
+  // copies.
+  EXPECT_DOUBLE_EQ(stream_stats.resolution_of_rendered_frame.GetMin(),
+                   kFrameWidth * kFrameHeight);
+}
+
+TEST(DefaultVideoQualityAnalyzerTest,
+     ComparisonsBeyondQueueSizeSkipHeavyMetrics) {
+  std::unique_ptr<test::FrameGeneratorInterface> frame_generator =
+      test::CreateSquareFrameGenerator(kFrameWidth, kFrameHeight,
+                                       /*type=*/absl::nullopt,
+                                       /*num_squares=*/absl::nullopt);
+
+  DefaultVideoQualityAnalyzerOptions options;
+  options.max_frames_in_flight_per_stream_count = kMaxFramesInFlightPerStream;
+  options.max_comparisons_queue_size = 0;
+  DefaultVideoQualityAnalyzer analyzer(options);
+  analyzer.Start("test_case", kAnalyzerMaxThreadsCount);
+
+  for (int i = 0; i < kMaxFramesInFlightPerStream; ++i) {
+    VideoFrame frame = NextFrame(frame_generator.get(), i);
+    frame.set_id(
+        analyzer.OnFrameCaptured(kSenderPeerName, kStreamLabel, frame));
+    analyzer.OnFramePreEncode(kSenderPeerName, frame);
+    analyzer.OnFrameEncoded(kSenderPeerName, frame.id(), FakeEncode(frame),
+                            VideoQualityAnalyzerInterface::EncoderStats());
+    VideoFrame received_frame = DeepCopy(frame);
+    analyzer.OnFramePreDecode(kReceiverPeerName, received_frame.id(),
+                              FakeEncode(received_frame));
+    analyzer.OnFrameDecoded(kReceiverPeerName, received_frame,
+                            VideoQualityAnalyzerInterface::DecoderStats());
+    analyzer.OnFrameRendered(kReceiverPeerName, received_frame);
+  }
+
+  // Give analyzer some time to process frames on async thread. The computations
+  // have to be fast (heavy metrics are skipped!), so if doesn't fit 100ms it
+  // means we have an issue!
+  SleepMs(100);
+  analyzer.Stop();
+
+  AnalyzerStats analyzer_stats = analyzer.GetAnalyzerStats();
+  EXPECT_EQ(analyzer_stats.comparisons_done, kMaxFramesInFlightPerStream);
+  EXPECT_EQ(analyzer_stats.cpu_overloaded_comparisons_done,
+            kMaxFramesInFlightPerStream);
+  EXPECT_TRUE(analyzer.GetStats().at(kStreamLabel).psnr.IsEmpty());
+}
+
 }  // namespace
 }  // namespace webrtc_pc_e2e
 }  // namespace webrtc
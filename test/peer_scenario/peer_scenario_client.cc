@@ -26,6 +26,7 @@
 #include "test/fake_decoder.h"
 #include "test/fake_vp8_encoder.h"
 #include "test/frame_generator_capturer.h"
+#include "test/peer_scenario/pre_encoded_video_encoder.h"
 #include "test/peer_scenario/sdp_callbacks.h"
 
 namespace webrtc {
@@ -211,7 +212,13 @@ PeerScenarioClient::PeerScenarioClient(
       TestAudioDeviceModule::CreateDiscardRenderer(config.audio.sample_rate));
 
   media_deps.audio_processing = AudioProcessingBuilder().Create();
-  if (config.video.use_fake_codecs) {
+  if (config.video.pre_encoded_ivf_file) {
+    media_deps.video_encoder_factory =
+        std::make_unique<PreEncodedVideoEncoderFactory>(
+            *config.video.pre_encoded_ivf_file);
+    media_deps.video_decoder_factory =
+        std::make_unique<FakeVideoDecoderFactory>();
+  } else if (config.video.use_fake_codecs) {
     media_deps.video_encoder_factory =
         std::make_unique<FakeVideoEncoderFactory>(
             net->time_controller()->GetClock());
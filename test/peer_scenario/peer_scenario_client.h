@@ -82,6 +82,10 @@ class PeerScenarioClient {
     } audio;
     struct Video {
       bool use_fake_codecs = false;
+      // If set, sent video is read from this VP8 IVF file instead of being
+      // encoded, and received video is not decoded. This is much cheaper than
+      // |use_fake_codecs| and allows running many clients for load testing.
+      absl::optional<std::string> pre_encoded_ivf_file;
     } video;
     // The created endpoints can be accessed using the map key as |index| in
     // PeerScenarioClient::endpoint(index).
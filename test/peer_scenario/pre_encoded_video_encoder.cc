@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "test/peer_scenario/pre_encoded_video_encoder.h"
+
+#include <utility>
+
+#include "absl/algorithm/container.h"
+#include "absl/types/optional.h"
+#include "modules/video_coding/codecs/interface/common_constants.h"
+#include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+std::unique_ptr<IvfFileReader> OpenIvfFile(const std::string& path) {
+  std::unique_ptr<IvfFileReader> reader = IvfFileReader::Open(path);
+  RTC_CHECK(reader) << "Cannot read IVF file " << path;
+  RTC_CHECK_EQ(reader->GetVideoCodecType(), kVideoCodecVP8)
+      << "Only VP8 IVF files are supported";
+  return reader;
+}
+
+bool IsVp8KeyFrame(const EncodedImage& image) {
+  // The lowest bit of the VP8 frame tag is zero for key frames.
+  return image.size() > 0 && (image.data()[0] & 0x01) == 0;
+}
+
+}  // namespace
+
+PreEncodedVideoEncoder::PreEncodedVideoEncoder(
+    const std::string& ivf_file_path)
+    : reader_(OpenIvfFile(ivf_file_path)) {}
+
+PreEncodedVideoEncoder::~PreEncodedVideoEncoder() = default;
+
+int32_t PreEncodedVideoEncoder::InitEncode(const VideoCodec* codec_settings,
+                                           const Settings& settings) {
+  RTC_DCHECK_EQ(codec_settings->codecType, kVideoCodecVP8);
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PreEncodedVideoEncoder::RegisterEncodeCompleteCallback(
+    EncodedImageCallback* callback) {
+  callback_ = callback;
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PreEncodedVideoEncoder::Release() {
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t PreEncodedVideoEncoder::Encode(
+    const VideoFrame& frame,
+    const std::vector<VideoFrameType>* frame_types) {
+  if (!callback_)
+    return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
+  const bool key_frame_requested =
+      frame_types &&
+      absl::c_linear_search(*frame_types, VideoFrameType::kVideoFrameKey);
+  if (key_frame_requested || !reader_->HasMoreFrames()) {
+    if (!reader_->Reset())
+      return WEBRTC_VIDEO_CODEC_ERROR;
+  }
+  absl::optional<EncodedImage> image = reader_->NextFrame();
+  if (!image)
+    return WEBRTC_VIDEO_CODEC_ERROR;
+
+  // The timing of the file is replaced by the one of the input, so that the
+  // send side pacing and congestion control see a live source.
+  image->SetTimestamp(frame.timestamp());
+  image->capture_time_ms_ = frame.render_time_ms();
+  image->SetSpatialIndex(absl::nullopt);
+  image->_encodedWidth = reader_->GetFrameWidth();
+  image->_encodedHeight = reader_->GetFrameHeight();
+  image->_frameType = IsVp8KeyFrame(*image) ? VideoFrameType::kVideoFrameKey
+                                            : VideoFrameType::kVideoFrameDelta;
+  image->rotation_ = frame.rotation();
+
+  CodecSpecificInfo codec_specific;
+  codec_specific.codecType = kVideoCodecVP8;
+  codec_specific.codecSpecific.VP8.nonReference = false;
+  codec_specific.codecSpecific.VP8.temporalIdx = kNoTemporalIdx;
+  codec_specific.codecSpecific.VP8.layerSync = false;
+  codec_specific.codecSpecific.VP8.keyIdx = kNoKeyIdx;
+  callback_->OnEncodedImage(*image, &codec_specific, nullptr);
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+void PreEncodedVideoEncoder::SetRates(const RateControlParameters& parameters) {
+}
+
+VideoEncoder::EncoderInfo PreEncodedVideoEncoder::GetEncoderInfo() const {
+  EncoderInfo info;
+  info.implementation_name = "PreEncodedVideoEncoder";
+  info.supports_native_handle = true;
+  return info;
+}
+
+PreEncodedVideoEncoderFactory::PreEncodedVideoEncoderFactory(
+    std::string ivf_file_path)
+    : ivf_file_path_(std::move(ivf_file_path)) {}
+
+std::vector<SdpVideoFormat> PreEncodedVideoEncoderFactory::GetSupportedFormats()
+    const {
+  return {SdpVideoFormat("VP8")};
+}
+
+VideoEncoderFactory::CodecInfo PreEncodedVideoEncoderFactory::QueryVideoEncoder(
+    const SdpVideoFormat& format) const {
+  RTC_CHECK_EQ(format.name, "VP8");
+  CodecInfo info;
+  info.has_internal_source = false;
+  info.is_hardware_accelerated = false;
+  return info;
+}
+
+std::unique_ptr<VideoEncoder> PreEncodedVideoEncoderFactory::CreateVideoEncoder(
+    const SdpVideoFormat& format) {
+  return std::make_unique<PreEncodedVideoEncoder>(ivf_file_path_);
+}
+
+}  // namespace test
+}  // namespace webrtc
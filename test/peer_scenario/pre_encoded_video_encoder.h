@@ -0,0 +1,68 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef TEST_PEER_SCENARIO_PRE_ENCODED_VIDEO_ENCODER_H_
+#define TEST_PEER_SCENARIO_PRE_ENCODED_VIDEO_ENCODER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/video_codecs/video_encoder.h"
+#include "api/video_codecs/video_encoder_factory.h"
+#include "modules/video_coding/utility/ivf_file_reader.h"
+
+namespace webrtc {
+namespace test {
+
+// Video encoder that ignores the content of the input frames and instead
+// outputs the frames of a VP8 IVF file, one per input frame, looping when the
+// end of the file is reached. It's intended for load testing, where many
+// clients need to send realistic video without the cost of encoding it. The
+// file is restarted on key frame requests, so the first frame of the file must
+// be a key frame. Rate updates are ignored, the bitrate is the one of the file.
+class PreEncodedVideoEncoder : public VideoEncoder {
+ public:
+  explicit PreEncodedVideoEncoder(const std::string& ivf_file_path);
+  ~PreEncodedVideoEncoder() override;
+
+  int32_t InitEncode(const VideoCodec* codec_settings,
+                     const Settings& settings) override;
+  int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) override;
+  int32_t Release() override;
+  int32_t Encode(const VideoFrame& frame,
+                 const std::vector<VideoFrameType>* frame_types) override;
+  void SetRates(const RateControlParameters& parameters) override;
+  EncoderInfo GetEncoderInfo() const override;
+
+ private:
+  const std::unique_ptr<IvfFileReader> reader_;
+  EncodedImageCallback* callback_ = nullptr;
+};
+
+// Creates a PreEncodedVideoEncoder reading from the same file for every
+// stream. Only VP8 is offered.
+class PreEncodedVideoEncoderFactory : public VideoEncoderFactory {
+ public:
+  explicit PreEncodedVideoEncoderFactory(std::string ivf_file_path);
+
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override;
+  CodecInfo QueryVideoEncoder(const SdpVideoFormat& format) const override;
+  std::unique_ptr<VideoEncoder> CreateVideoEncoder(
+      const SdpVideoFormat& format) override;
+
+ private:
+  const std::string ivf_file_path_;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_PEER_SCENARIO_PRE_ENCODED_VIDEO_ENCODER_H_
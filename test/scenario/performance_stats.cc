@@ -43,5 +43,12 @@ void VideoQualityStats::AddStats(const VideoQualityStats& other) {
   time_between_freezes.AddSamples(other.time_between_freezes);
 }
 
+void CollectedCallStats::AddStats(const CollectedCallStats& other) {
+  target_rate.AddSamples(other.target_rate);
+  pacer_delay.AddSamples(other.pacer_delay);
+  round_trip_time.AddSamples(other.round_trip_time);
+  memory_usage.AddSamples(other.memory_usage);
+}
+
 }  // namespace test
 }  // namespace webrtc
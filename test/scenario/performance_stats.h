@@ -82,6 +82,7 @@ struct CollectedCallStats {
   SampleStats<TimeDelta> pacer_delay;
   SampleStats<TimeDelta> round_trip_time;
   SampleStats<double> memory_usage;
+  void AddStats(const CollectedCallStats& other);
 };
 
 struct CollectedAudioReceiveStats {
@@ -73,6 +73,18 @@ Scenario::Scenario(
                       ->CreateTaskQueue("Scenario",
                                         TaskQueueFactory::Priority::NORMAL)) {}
 
+Scenario::Scenario(std::string file_name,
+                   std::unique_ptr<TimeController> time_controller)
+    : log_writer_factory_(GetScenarioLogManager(file_name)),
+      network_manager_(std::move(time_controller)),
+      clock_(network_manager_.time_controller()->GetClock()),
+      audio_decoder_factory_(CreateBuiltinAudioDecoderFactory()),
+      audio_encoder_factory_(CreateBuiltinAudioEncoderFactory()),
+      task_queue_(network_manager_.time_controller()
+                      ->GetTaskQueueFactory()
+                      ->CreateTaskQueue("Scenario",
+                                        TaskQueueFactory::Priority::NORMAL)) {}
+
 Scenario::~Scenario() {
   if (start_time_.IsFinite())
     Stop();
@@ -47,6 +47,10 @@ class Scenario {
   Scenario(std::string file_name, bool real_time);
   Scenario(std::unique_ptr<LogWriterFactoryInterface> log_writer_manager,
            bool real_time);
+  // Runs on the given time controller, e.g. one with a thread local clock so
+  // that several scenarios can run in parallel, see ScenarioRunner.
+  Scenario(std::string file_name,
+           std::unique_ptr<TimeController> time_controller);
   RTC_DISALLOW_COPY_AND_ASSIGN(Scenario);
   ~Scenario();
   NetworkEmulationManagerImpl* net() { return &network_manager_; }
@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "test/scenario/scenario_runner.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "rtc_base/platform_thread.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+// Same start time as used by scenarios created with TimeMode::kSimulated.
+const Timestamp kSimulatedStartTime = Timestamp::Seconds(100000);
+}  // namespace
+
+void ScenarioRunner::Stats::AddStats(const Stats& other) {
+  call.AddStats(other.call);
+  video_quality.AddStats(other.video_quality);
+}
+
+ScenarioRunner::ScenarioRunner(int num_threads)
+    : num_threads_(std::max(num_threads, 1)) {}
+
+ScenarioRunner::~ScenarioRunner() = default;
+
+void ScenarioRunner::AddScenario(std::string name, ScenarioFunction function) {
+  jobs_.push_back({std::move(name), std::move(function)});
+}
+
+std::vector<ScenarioRunner::Stats> ScenarioRunner::RunAll() {
+  {
+    rtc::CritScope lock(&crit_);
+    next_job_ = 0;
+    stats_.clear();
+    stats_.resize(jobs_.size());
+  }
+
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  const int num_threads = std::min<int>(num_threads_, jobs_.size());
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::make_unique<rtc::PlatformThread>(
+        &ScenarioRunner::WorkerThread, this, "ScenarioRunner"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Stop();
+  }
+
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+ScenarioRunner::Stats ScenarioRunner::Aggregate(
+    const std::vector<Stats>& stats) {
+  Stats total;
+  for (const Stats& scenario_stats : stats)
+    total.AddStats(scenario_stats);
+  return total;
+}
+
+void ScenarioRunner::WorkerThread(void* obj) {
+  static_cast<ScenarioRunner*>(obj)->ProcessJobs();
+}
+
+void ScenarioRunner::ProcessJobs() {
+  while (true) {
+    size_t job;
+    {
+      rtc::CritScope lock(&crit_);
+      if (next_job_ >= jobs_.size()) {
+        return;
+      }
+      job = next_job_++;
+    }
+    Stats stats;
+    {
+      Scenario s(jobs_[job].name,
+                 std::make_unique<GlobalSimulatedTimeController>(
+                     kSimulatedStartTime, /*thread_local_clock=*/true));
+      jobs_[job].function(&s, &stats);
+    }
+    rtc::CritScope lock(&crit_);
+    stats_[job] = std::move(stats);
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,76 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef TEST_SCENARIO_SCENARIO_RUNNER_H_
+#define TEST_SCENARIO_SCENARIO_RUNNER_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "rtc_base/critical_section.h"
+#include "rtc_base/thread_annotations.h"
+#include "test/scenario/performance_stats.h"
+#include "test/scenario/scenario.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs independent scenarios in parallel on a number of threads. Each scenario
+// runs in simulated time on a time controller of its own, whose clock is only
+// visible to the thread running the scenario. The results are therefore the
+// same as when running the scenarios one after another, regardless of the
+// number of threads. Note that field trials are process wide, so they can't
+// differ between the scenarios.
+class ScenarioRunner {
+ public:
+  // Statistics reported by a scenario.
+  struct Stats {
+    CollectedCallStats call;
+    VideoQualityStats video_quality;
+    void AddStats(const Stats& other);
+  };
+  // Sets up and runs the scenario, and reports its statistics in |stats|.
+  using ScenarioFunction = std::function<void(Scenario* s, Stats* stats)>;
+
+  explicit ScenarioRunner(int num_threads);
+  ~ScenarioRunner();
+
+  // |name| is used for the log files of the scenario, like the file name given
+  // to the Scenario constructor.
+  void AddScenario(std::string name, ScenarioFunction function);
+
+  // Runs all added scenarios and returns their statistics in the order they
+  // were added.
+  std::vector<Stats> RunAll();
+
+  // Returns the statistics of all scenarios in |stats| combined.
+  static Stats Aggregate(const std::vector<Stats>& stats);
+
+ private:
+  struct Job {
+    std::string name;
+    ScenarioFunction function;
+  };
+
+  static void WorkerThread(void* obj);
+  void ProcessJobs();
+
+  const int num_threads_;
+  std::vector<Job> jobs_;
+
+  rtc::CriticalSection crit_;
+  size_t next_job_ RTC_GUARDED_BY(crit_) = 0;
+  std::vector<Stats> stats_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_SCENARIO_SCENARIO_RUNNER_H_
@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "test/scenario/scenario_runner.h"
+
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+const int kNumScenarios = 4;
+
+void AddScenarios(ScenarioRunner* runner) {
+  for (int i = 0; i < kNumScenarios; ++i) {
+    runner->AddScenario("", [i](Scenario* s, ScenarioRunner::Stats* stats) {
+      CallClientConfig call_config;
+      auto* alice = s->CreateClient("alice", call_config);
+      auto* bob = s->CreateClient("bob", call_config);
+      NetworkSimulationConfig network_config;
+      network_config.bandwidth = DataRate::KilobitsPerSec(250 * (i + 1));
+      network_config.delay = TimeDelta::Millis(50);
+      auto route =
+          s->CreateRoutes(alice, {s->CreateSimulationNode(network_config)}, bob,
+                          {s->CreateSimulationNode(NetworkSimulationConfig())});
+      s->CreateVideoStream(route->forward(), VideoStreamConfig());
+      s->Every(TimeDelta::Millis(100), [alice, stats] {
+        stats->call.target_rate.AddSampleBps(
+            alice->GetStats().send_bandwidth_bps);
+      });
+      s->RunFor(TimeDelta::Seconds(5));
+    });
+  }
+}
+}  // namespace
+
+TEST(ScenarioRunnerTest, ParallelRunsGiveSameResultsAsSequentialRuns) {
+  ScenarioRunner sequential(1);
+  AddScenarios(&sequential);
+  std::vector<ScenarioRunner::Stats> sequential_stats = sequential.RunAll();
+
+  ScenarioRunner parallel(kNumScenarios);
+  AddScenarios(&parallel);
+  std::vector<ScenarioRunner::Stats> parallel_stats = parallel.RunAll();
+
+  ASSERT_EQ(sequential_stats.size(), static_cast<size_t>(kNumScenarios));
+  ASSERT_EQ(parallel_stats.size(), static_cast<size_t>(kNumScenarios));
+  for (int i = 0; i < kNumScenarios; ++i) {
+    EXPECT_GT(sequential_stats[i].call.target_rate.Count(), 0);
+    EXPECT_EQ(parallel_stats[i].call.target_rate.Count(),
+              sequential_stats[i].call.target_rate.Count());
+    EXPECT_EQ(parallel_stats[i].call.target_rate.Mean(),
+              sequential_stats[i].call.target_rate.Mean());
+  }
+  // More capacity gives a higher target rate.
+  EXPECT_LT(parallel_stats[0].call.target_rate.Mean(),
+            parallel_stats[kNumScenarios - 1].call.target_rate.Mean());
+
+  ScenarioRunner::Stats total = ScenarioRunner::Aggregate(parallel_stats);
+  int total_count = 0;
+  for (ScenarioRunner::Stats& stats : parallel_stats)
+    total_count += stats.call.target_rate.Count();
+  EXPECT_EQ(total.call.target_rate.Count(), total_count);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -21,7 +21,6 @@
 #include "modules/video_coding/codecs/vp9/include/vp9.h"
 #include "modules/video_coding/include/video_error_codes.h"
 #include "rtc_base/checks.h"
-#include "rtc_base/system/file_wrapper.h"
 
 namespace webrtc {
 namespace test {
@@ -33,7 +32,7 @@ constexpr int kMaxNextFrameWaitTemeoutMs = 1000;
 
 IvfVideoFrameGenerator::IvfVideoFrameGenerator(const std::string& file_name)
     : callback_(this),
-      file_reader_(IvfFileReader::Create(FileWrapper::OpenReadOnly(file_name))),
+      file_reader_(IvfFileReader::Open(file_name)),
       video_decoder_(CreateVideoDecoder(file_reader_->GetVideoCodecType())),
       width_(file_reader_->GetFrameWidth()),
       height_(file_reader_->GetFrameHeight()) {
@@ -174,9 +174,17 @@ void SimulatedTimeControllerImpl::StopYield(TaskQueueBase* yielding_from) {
 }  // namespace sim_time_impl
 
 GlobalSimulatedTimeController::GlobalSimulatedTimeController(
-    Timestamp start_time)
-    : sim_clock_(start_time.us()), impl_(start_time), yield_policy_(&impl_) {
-  global_clock_.SetTime(start_time);
+    Timestamp start_time,
+    bool thread_local_clock)
+    : global_clock_(thread_local_clock
+                        ? std::unique_ptr<rtc::FakeClock>(
+                              new rtc::ScopedThreadBaseFakeClock())
+                        : std::unique_ptr<rtc::FakeClock>(
+                              new rtc::ScopedBaseFakeClock())),
+      sim_clock_(start_time.us()),
+      impl_(start_time),
+      yield_policy_(&impl_) {
+  global_clock_->SetTime(start_time);
   auto main_thread = std::make_unique<SimulatedMainThread>(&impl_);
   impl_.Register(main_thread.get());
   main_thread_ = std::move(main_thread);
@@ -219,7 +227,7 @@ void GlobalSimulatedTimeController::AdvanceTime(TimeDelta duration) {
     auto delta = next_time - current_time;
     current_time = next_time;
     sim_clock_.AdvanceTimeMicroseconds(delta.us());
-    global_clock_.AdvanceTime(delta);
+    global_clock_->AdvanceTime(delta);
   }
   // After time has been simulated up until |target_time| we also need to run
   // tasks meant to be executed at |target_time|.
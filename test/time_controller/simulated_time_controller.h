@@ -126,7 +126,12 @@ class TokenTaskQueue : public TaskQueueBase {
 // since it modifies global state.
 class GlobalSimulatedTimeController : public TimeController {
  public:
-  explicit GlobalSimulatedTimeController(Timestamp start_time);
+  // If |thread_local_clock| is true, the clock backing rtc::TimeMillis() and
+  // rtc::TimeMicros() is only overridden for the constructing thread, which
+  // must then also be the only thread using the controller. This allows
+  // independent controllers to run in parallel on different threads.
+  explicit GlobalSimulatedTimeController(Timestamp start_time,
+                                         bool thread_local_clock = false);
   ~GlobalSimulatedTimeController() override;
 
   Clock* GetClock() override;
@@ -141,7 +146,7 @@ class GlobalSimulatedTimeController : public TimeController {
   void AdvanceTime(TimeDelta duration) override;
 
  private:
-  rtc::ScopedBaseFakeClock global_clock_;
+  const std::unique_ptr<rtc::FakeClock> global_clock_;
   // Provides simulated CurrentNtpInMilliseconds()
   SimulatedClock sim_clock_;
   sim_time_impl::SimulatedTimeControllerImpl impl_;
@@ -13,6 +13,7 @@
 #include <atomic>
 #include <memory>
 
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/task_utils/repeating_task.h"
 #include "test/gmock.h"
@@ -149,4 +150,33 @@ TEST(SimulatedTimeControllerTest, ThreadYeildsOnInvoke) {
   ASSERT_TRUE(task_has_run);
 }
 
+TEST(SimulatedTimeControllerTest, ThreadLocalClocksRunIndependently) {
+  struct Simulation {
+    static void Run(void* obj) {
+      Simulation* simulation = static_cast<Simulation*>(obj);
+      GlobalSimulatedTimeController sim(simulation->start_time,
+                                        /*thread_local_clock=*/true);
+      rtc::TaskQueue task_queue(sim.GetTaskQueueFactory()->CreateTaskQueue(
+          "TestQueue", TaskQueueFactory::Priority::NORMAL));
+      task_queue.PostDelayedTask(
+          [simulation] { simulation->task_run_at_ms = rtc::TimeMillis(); },
+          simulation->task_delay_ms);
+      sim.AdvanceTime(TimeDelta::Seconds(1));
+    }
+    Timestamp start_time;
+    int task_delay_ms;
+    int64_t task_run_at_ms = 0;
+  };
+  Simulation first{Timestamp::Seconds(1000), 10};
+  Simulation second{Timestamp::Seconds(2000), 20};
+  rtc::PlatformThread first_thread(&Simulation::Run, &first, "first");
+  rtc::PlatformThread second_thread(&Simulation::Run, &second, "second");
+  first_thread.Start();
+  second_thread.Start();
+  first_thread.Stop();
+  second_thread.Stop();
+  EXPECT_EQ(first.task_run_at_ms, 1000010);
+  EXPECT_EQ(second.task_run_at_ms, 2000020);
+}
+
 }  // namespace webrtc
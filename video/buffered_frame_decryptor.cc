@@ -15,28 +15,70 @@
 
 #include "modules/rtp_rtcp/source/rtp_descriptor_authentication.h"
 #include "modules/video_coding/frame_object.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/task_utils/to_queued_task.h"
 #include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
 BufferedFrameDecryptor::BufferedFrameDecryptor(
     OnDecryptedFrameCallback* decrypted_frame_callback,
-    OnDecryptionStatusChangeCallback* decryption_status_change_callback)
+    OnDecryptionStatusChangeCallback* decryption_status_change_callback,
+    TaskQueueFactory* decryption_queue_factory)
     : generic_descriptor_auth_experiment_(
           !field_trial::IsDisabled("WebRTC-GenericDescriptorAuth")),
       decrypted_frame_callback_(decrypted_frame_callback),
-      decryption_status_change_callback_(decryption_status_change_callback) {}
+      decryption_status_change_callback_(decryption_status_change_callback) {
+  if (decryption_queue_factory) {
+    decryption_queue_ = std::make_unique<rtc::TaskQueue>(
+        decryption_queue_factory->CreateTaskQueue(
+            "FrameDecryptor", TaskQueueFactory::Priority::NORMAL));
+  }
+}
 
-BufferedFrameDecryptor::~BufferedFrameDecryptor() {}
+BufferedFrameDecryptor::~BufferedFrameDecryptor() {
+  // Waits for a running decryption task and drops the pending ones, then
+  // drops the results that are still on their way to the callbacks.
+  decryption_queue_ = nullptr;
+  if (callback_safety_) {
+    RTC_DCHECK(callback_queue_->IsCurrent());
+    callback_safety_->SetNotAlive();
+  }
+}
 
 void BufferedFrameDecryptor::SetFrameDecryptor(
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor) {
+  if (decryption_queue_) {
+    decryption_queue_->PostTask(
+        [this, frame_decryptor = std::move(frame_decryptor)]() mutable {
+          frame_decryptor_ = std::move(frame_decryptor);
+        });
+    return;
+  }
   frame_decryptor_ = std::move(frame_decryptor);
 }
 
 void BufferedFrameDecryptor::ManageEncryptedFrame(
     std::unique_ptr<video_coding::RtpFrameObject> encrypted_frame) {
+  if (!decryption_queue_) {
+    DecryptOrStashFrame(std::move(encrypted_frame));
+    return;
+  }
+  if (!callback_queue_) {
+    callback_queue_ = TaskQueueBase::Current();
+    RTC_DCHECK(callback_queue_);
+    callback_safety_ = PendingTaskSafetyFlag::Create();
+  }
+  RTC_DCHECK(callback_queue_->IsCurrent());
+  decryption_queue_->PostTask(
+      [this, encrypted_frame = std::move(encrypted_frame)]() mutable {
+        DecryptOrStashFrame(std::move(encrypted_frame));
+      });
+}
+
+void BufferedFrameDecryptor::DecryptOrStashFrame(
+    std::unique_ptr<video_coding::RtpFrameObject> encrypted_frame) {
   switch (DecryptFrame(encrypted_frame.get())) {
     case FrameDecision::kStash:
       if (stashed_frames_.size() >= kMaxStashedFrames) {
@@ -47,7 +89,7 @@ void BufferedFrameDecryptor::ManageEncryptedFrame(
       break;
     case FrameDecision::kDecrypted:
       RetryStashedFrames();
-      decrypted_frame_callback_->OnDecryptedFrame(std::move(encrypted_frame));
+      DeliverDecryptedFrame(std::move(encrypted_frame));
       break;
     case FrameDecision::kDrop:
       break;
@@ -90,8 +132,7 @@ BufferedFrameDecryptor::FrameDecision BufferedFrameDecryptor::DecryptFrame(
   // Optionally call the callback if there was a change in status
   if (decrypt_result.status != last_status_) {
     last_status_ = decrypt_result.status;
-    decryption_status_change_callback_->OnDecryptionStatusChange(
-        decrypt_result.status);
+    DeliverDecryptionStatus(decrypt_result.status);
   }
 
   if (!decrypt_result.IsOk()) {
@@ -118,10 +159,33 @@ void BufferedFrameDecryptor::RetryStashedFrames() {
   }
   for (auto& frame : stashed_frames_) {
     if (DecryptFrame(frame.get()) == FrameDecision::kDecrypted) {
-      decrypted_frame_callback_->OnDecryptedFrame(std::move(frame));
+      DeliverDecryptedFrame(std::move(frame));
     }
   }
   stashed_frames_.clear();
 }
 
+void BufferedFrameDecryptor::DeliverDecryptedFrame(
+    std::unique_ptr<video_coding::RtpFrameObject> frame) {
+  if (!callback_queue_) {
+    decrypted_frame_callback_->OnDecryptedFrame(std::move(frame));
+    return;
+  }
+  callback_queue_->PostTask(ToQueuedTask(
+      callback_safety_, [this, frame = std::move(frame)]() mutable {
+        decrypted_frame_callback_->OnDecryptedFrame(std::move(frame));
+      }));
+}
+
+void BufferedFrameDecryptor::DeliverDecryptionStatus(
+    FrameDecryptorInterface::Status status) {
+  if (!callback_queue_) {
+    decryption_status_change_callback_->OnDecryptionStatusChange(status);
+    return;
+  }
+  callback_queue_->PostTask(ToQueuedTask(callback_safety_, [this, status] {
+    decryption_status_change_callback_->OnDecryptionStatusChange(status);
+  }));
+}
+
 }  // namespace webrtc
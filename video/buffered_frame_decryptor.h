@@ -16,7 +16,11 @@
 
 #include "api/crypto/crypto_options.h"
 #include "api/crypto/frame_decryptor_interface.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "modules/video_coding/frame_object.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/task_utils/pending_task_safety_flag.h"
 
 namespace webrtc {
 
@@ -53,12 +57,19 @@ class OnDecryptionStatusChangeCallback {
 // particularly important on low bandwidth networks. Note stashing is only ever
 // done if we have never sucessfully decrypted a frame before. After the first
 // successful decryption payloads will never be stashed.
+//
+// Frames are decrypted in place, in the buffers they were received in. If a
+// |decryption_queue_factory| is provided, the frames are decrypted in order on
+// a task queue created with it rather than on the thread that receives them,
+// and the callbacks are posted back to the thread that called
+// ManageEncryptedFrame(). The decryptor must then be destroyed on that thread.
 class BufferedFrameDecryptor final {
  public:
   // Constructs a new BufferedFrameDecryptor that can hold
   explicit BufferedFrameDecryptor(
       OnDecryptedFrameCallback* decrypted_frame_callback,
-      OnDecryptionStatusChangeCallback* decryption_status_change_callback);
+      OnDecryptionStatusChangeCallback* decryption_status_change_callback,
+      TaskQueueFactory* decryption_queue_factory = nullptr);
   ~BufferedFrameDecryptor();
   // This object cannot be copied.
   BufferedFrameDecryptor(const BufferedFrameDecryptor&) = delete;
@@ -79,6 +90,10 @@ class BufferedFrameDecryptor final {
   // Represents what should be done with a given frame.
   enum class FrameDecision { kStash, kDecrypted, kDrop };
 
+  // Does the work of ManageEncryptedFrame(), on the decryption queue if there
+  // is one.
+  void DecryptOrStashFrame(
+      std::unique_ptr<video_coding::RtpFrameObject> encrypted_frame);
   // Attempts to decrypt the frame, if it fails and no prior frames have been
   // decrypted it will return kStash. Otherwise fail to decrypts will return
   // kDrop. Successful decryptions will always return kDecrypted.
@@ -86,6 +101,11 @@ class BufferedFrameDecryptor final {
   // Retries all the stashed frames this is triggered each time a kDecrypted
   // event occurs.
   void RetryStashedFrames();
+  // Pass the results on to the callbacks, on the thread that called
+  // ManageEncryptedFrame().
+  void DeliverDecryptedFrame(
+      std::unique_ptr<video_coding::RtpFrameObject> frame);
+  void DeliverDecryptionStatus(FrameDecryptorInterface::Status status);
 
   static const size_t kMaxStashedFrames = 24;
 
@@ -97,6 +117,14 @@ class BufferedFrameDecryptor final {
   OnDecryptedFrameCallback* const decrypted_frame_callback_;
   OnDecryptionStatusChangeCallback* const decryption_status_change_callback_;
   std::deque<std::unique_ptr<video_coding::RtpFrameObject>> stashed_frames_;
+
+  // Set on the first call to ManageEncryptedFrame() if frames are decrypted
+  // on |decryption_queue_|.
+  TaskQueueBase* callback_queue_ = nullptr;
+  rtc::scoped_refptr<PendingTaskSafetyFlag> callback_safety_;
+  // Declared last so that no decryption task runs while the members above
+  // are destroyed.
+  std::unique_ptr<rtc::TaskQueue> decryption_queue_;
 };
 
 }  // namespace webrtc
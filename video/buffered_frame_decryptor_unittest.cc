@@ -14,13 +14,18 @@
 #include <memory>
 #include <vector>
 
+#include "api/task_queue/default_task_queue_factory.h"
 #include "api/test/mock_frame_decryptor.h"
 #include "modules/video_coding/packet_buffer.h"
+#include "rtc_base/event.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/task_queue_for_test.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
+using ::testing::ElementsAre;
+using ::testing::InvokeWithoutArgs;
 using ::testing::Return;
 
 namespace webrtc {
@@ -46,6 +51,9 @@ class BufferedFrameDecryptorTest : public ::testing::Test,
   void OnDecryptedFrame(
       std::unique_ptr<video_coding::RtpFrameObject> frame) override {
     decrypted_frame_call_count_++;
+    decrypted_seq_nums_.push_back(frame->first_seq_num());
+    if (decrypted_frame_call_count_ == expected_decrypted_frames_)
+      expected_frames_decrypted_.Set();
   }
 
   void OnDecryptionStatusChange(FrameDecryptorInterface::Status status) {
@@ -102,6 +110,9 @@ class BufferedFrameDecryptorTest : public ::testing::Test,
   size_t decrypted_frame_call_count_;
   size_t decryption_status_change_count_ = 0;
   uint16_t seq_num_;
+  std::vector<uint16_t> decrypted_seq_nums_;
+  size_t expected_decrypted_frames_ = 0;
+  rtc::Event expected_frames_decrypted_;
 };
 
 const size_t BufferedFrameDecryptorTest::kMaxStashedFrames = 24;
@@ -228,4 +239,46 @@ TEST_F(BufferedFrameDecryptorTest, FramesStoredIfDecryptorNull) {
   EXPECT_EQ(decrypted_frame_call_count_, kMaxStashedFrames + 1);
 }
 
+// Frames are decrypted in order on the decryption queue, and the callbacks
+// are called on the queue that the frames came from.
+TEST_F(BufferedFrameDecryptorTest, DecryptsOnDecryptionQueue) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  TaskQueueForTest receive_queue("ReceiveQueue");
+  receive_queue.SendTask(
+      [&] {
+        buffered_frame_decryptor_ = std::make_unique<BufferedFrameDecryptor>(
+            this, this, task_queue_factory.get());
+        buffered_frame_decryptor_->SetFrameDecryptor(mock_frame_decryptor_);
+      },
+      RTC_FROM_HERE);
+
+  EXPECT_CALL(*mock_frame_decryptor_, Decrypt)
+      .Times(3)
+      .WillRepeatedly(InvokeWithoutArgs([&] {
+        EXPECT_FALSE(receive_queue.IsCurrent());
+        return DecryptSuccess();
+      }));
+  EXPECT_CALL(*mock_frame_decryptor_, GetMaxPlaintextByteSize)
+      .WillRepeatedly(Return(0));
+  expected_decrypted_frames_ = 3;
+  receive_queue.SendTask(
+      [&] {
+        for (int i = 0; i < 3; ++i) {
+          buffered_frame_decryptor_->ManageEncryptedFrame(
+              CreateRtpFrameObject(true));
+        }
+      },
+      RTC_FROM_HERE);
+  ASSERT_TRUE(expected_frames_decrypted_.Wait(1000));
+
+  receive_queue.SendTask(
+      [&] {
+        EXPECT_THAT(decrypted_seq_nums_, ElementsAre(1, 2, 3));
+        EXPECT_EQ(decryption_status_change_count_, static_cast<size_t>(1));
+        buffered_frame_decryptor_ = nullptr;
+      },
+      RTC_FROM_HERE);
+}
+
 }  // namespace webrtc
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/encoded_frame_recorder.h"
+
+#include <utility>
+
+#include "api/video/encoded_image.h"
+
+namespace webrtc {
+
+EncodedFrameRecorder::EncodedFrameRecorder(TaskQueueBase* file_queue,
+                                           FileWrapper file,
+                                           size_t byte_limit)
+    : writer_(file_queue, std::move(file), byte_limit) {}
+
+EncodedFrameRecorder::~EncodedFrameRecorder() = default;
+
+void EncodedFrameRecorder::OnFrame(const RecordableEncodedFrame& frame) {
+  // The file starts with a key frame, which gives the resolution of its
+  // header.
+  if (!started_) {
+    if (!frame.is_key_frame() || frame.resolution().width == 0 ||
+        frame.resolution().height == 0) {
+      return;
+    }
+    started_ = true;
+  }
+  // The IVF frame timestamps are the render times, in milliseconds.
+  // WriteFrame copies the data, so the image may point into the frame's
+  // buffer.
+  rtc::scoped_refptr<const EncodedImageBufferInterface> buffer =
+      frame.encoded_buffer();
+  EncodedImage image(const_cast<uint8_t*>(buffer->data()), buffer->size(),
+                     buffer->size());
+  image._frameType = frame.is_key_frame() ? VideoFrameType::kVideoFrameKey
+                                          : VideoFrameType::kVideoFrameDelta;
+  image._encodedWidth = frame.resolution().width;
+  image._encodedHeight = frame.resolution().height;
+  image.capture_time_ms_ = frame.render_time().ms();
+  writer_.WriteFrame(image, frame.codec());
+}
+
+}  // namespace webrtc
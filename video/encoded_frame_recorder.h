@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_ENCODED_FRAME_RECORDER_H_
+#define VIDEO_ENCODED_FRAME_RECORDER_H_
+
+#include <stddef.h>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/video/recordable_encoded_frame.h"
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
+#include "rtc_base/system/file_wrapper.h"
+
+namespace webrtc {
+
+// Writes the encoded frames of a video receive stream to an IVF file, with
+// the file I/O on |file_queue|. Together with
+// VideoReceiveStream::Config::decode_frames set to false, this records a
+// stream without decoding it, and many recorders can share one queue.
+class EncodedFrameRecorder {
+ public:
+  // A |byte_limit| of 0 means no limit, see IvfFileWriter::Wrap.
+  EncodedFrameRecorder(TaskQueueBase* file_queue,
+                       FileWrapper file,
+                       size_t byte_limit);
+  // Closes the file on |file_queue| once the frames passed before are
+  // written.
+  ~EncodedFrameRecorder();
+
+  // Queues |frame| for writing, dropping the frames before the first key
+  // frame. Frames must be passed on one sequence at a time, e.g. from the
+  // callback set with VideoReceiveStream::SetAndGetRecordingState.
+  void OnFrame(const RecordableEncodedFrame& frame);
+
+  AsyncIvfFileWriter::Stats GetStats() const { return writer_.GetStats(); }
+
+ private:
+  // Whether a frame was queued, i.e. the leading key frame.
+  bool started_ = false;
+  AsyncIvfFileWriter writer_;
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_ENCODED_FRAME_RECORDER_H_
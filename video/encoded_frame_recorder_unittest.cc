@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2020 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/encoded_frame_recorder.h"
+
+#include <memory>
+#include <string>
+
+#include "api/video/encoded_image.h"
+#include "modules/video_coding/utility/ivf_file_reader.h"
+#include "rtc_base/task_queue_for_test.h"
+#include "test/gtest.h"
+#include "test/testsupport/file_utils.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint8_t kPayload[4] = {'0', '1', '2', '3'};
+
+class FakeRecordableFrame : public RecordableEncodedFrame {
+ public:
+  FakeRecordableFrame(bool key_frame, unsigned width, int64_t render_time_ms)
+      : buffer_(EncodedImageBuffer::Create(kPayload, sizeof(kPayload))),
+        key_frame_(key_frame),
+        width_(width),
+        render_time_ms_(render_time_ms) {}
+
+  rtc::scoped_refptr<const EncodedImageBufferInterface> encoded_buffer()
+      const override {
+    return buffer_;
+  }
+  absl::optional<ColorSpace> color_space() const override {
+    return absl::nullopt;
+  }
+  VideoCodecType codec() const override { return kVideoCodecVP8; }
+  bool is_key_frame() const override { return key_frame_; }
+  EncodedResolution resolution() const override {
+    return EncodedResolution{width_, width_ / 2};
+  }
+  Timestamp render_time() const override {
+    return Timestamp::Millis(render_time_ms_);
+  }
+
+ private:
+  const rtc::scoped_refptr<EncodedImageBuffer> buffer_;
+  const bool key_frame_;
+  const unsigned width_;
+  const int64_t render_time_ms_;
+};
+
+}  // namespace
+
+class EncodedFrameRecorderTest : public ::testing::Test {
+ protected:
+  EncodedFrameRecorderTest()
+      : file_name_(test::TempFilename(test::OutputPath(), "recorder.ivf")),
+        file_queue_("FileQueue") {}
+  ~EncodedFrameRecorderTest() override { test::RemoveFile(file_name_); }
+
+  std::unique_ptr<IvfFileReader> Record(
+      std::initializer_list<FakeRecordableFrame> frames) {
+    {
+      EncodedFrameRecorder recorder(
+          file_queue_.Get(), FileWrapper::OpenWriteOnly(file_name_), 0);
+      for (const FakeRecordableFrame& frame : frames)
+        recorder.OnFrame(frame);
+    }
+    // Wait for the file to be closed.
+    file_queue_.SendTask([] {}, RTC_FROM_HERE);
+    return IvfFileReader::Open(file_name_);
+  }
+
+  const std::string file_name_;
+  TaskQueueForTest file_queue_;
+};
+
+TEST_F(EncodedFrameRecorderTest, WritesFramesFromFirstKeyFrame) {
+  std::unique_ptr<IvfFileReader> reader =
+      Record({FakeRecordableFrame(/*key_frame=*/false, 320, 10),
+              FakeRecordableFrame(/*key_frame=*/true, 640, 20),
+              FakeRecordableFrame(/*key_frame=*/false, 0, 30)});
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(reader->GetVideoCodecType(), kVideoCodecVP8);
+  EXPECT_EQ(reader->GetFrameWidth(), 640);
+  EXPECT_EQ(reader->GetFrameHeight(), 320);
+  ASSERT_EQ(reader->GetFramesCount(), 2u);
+  absl::optional<EncodedImage> frame = reader->NextFrame();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(frame->size(), sizeof(kPayload));
+  EXPECT_EQ(frame->capture_time_ms_, 20);
+  frame = reader->NextFrame();
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(frame->capture_time_ms_, 30);
+}
+
+TEST_F(EncodedFrameRecorderTest, WritesNoFramesWithoutKeyFrame) {
+  std::unique_ptr<IvfFileReader> reader =
+      Record({FakeRecordableFrame(/*key_frame=*/false, 320, 10)});
+  // The file is left without a header.
+  EXPECT_FALSE(reader);
+}
+
+}  // namespace webrtc
@@ -10,7 +10,10 @@
 
 #include "video/encoder_rtcp_feedback.h"
 
+#include <utility>
+
 #include "absl/types/optional.h"
+#include "api/video/video_codec_constants.h"
 #include "api/video_codecs/video_encoder.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/experiments/keyframe_interval_settings.h"
@@ -29,6 +32,7 @@ EncoderRtcpFeedback::EncoderRtcpFeedback(Clock* clock,
       rtp_video_sender_(nullptr),
       video_stream_encoder_(encoder),
       time_last_intra_request_ms_(-1),
+      encoded_frame_source_(nullptr),
       min_keyframe_send_interval_ms_(
           KeyframeIntervalSettings::ParseFromFieldTrials()
               .MinKeyframeSendIntervalMs()
@@ -37,12 +41,18 @@ EncoderRtcpFeedback::EncoderRtcpFeedback(Clock* clock,
 }
 
 void EncoderRtcpFeedback::SetRtpVideoSender(
-    const RtpVideoSenderInterface* rtp_video_sender) {
+    RtpVideoSenderInterface* rtp_video_sender) {
   RTC_DCHECK(rtp_video_sender);
   RTC_DCHECK(!rtp_video_sender_);
   rtp_video_sender_ = rtp_video_sender;
 }
 
+void EncoderRtcpFeedback::SetEncodedFrameSource(
+    VideoSendStream::EncodedFrameSource* source) {
+  rtc::CritScope lock(&crit_);
+  encoded_frame_source_ = source;
+}
+
 bool EncoderRtcpFeedback::HasSsrc(uint32_t ssrc) {
   for (uint32_t registered_ssrc : ssrcs_) {
     if (registered_ssrc == ssrc) {
@@ -63,6 +73,20 @@ void EncoderRtcpFeedback::OnReceivedIntraFrameRequest(uint32_t ssrc) {
     time_last_intra_request_ms_ = now_ms;
   }
 
+  // A receiver that joins late can start from the cached key frame.
+  if (rtp_video_sender_ && rtp_video_sender_->SendCachedKeyFrame(ssrc)) {
+    return;
+  }
+
+  {
+    // Held while calling the source, so that it isn't called once unset.
+    rtc::CritScope lock(&crit_);
+    if (encoded_frame_source_) {
+      encoded_frame_source_->OnKeyFrameRequested();
+      return;
+    }
+  }
+
   // Always produce key frame for all streams.
   video_stream_encoder_->SendKeyFrame();
 }
@@ -144,4 +168,18 @@ void EncoderRtcpFeedback::OnReceivedLossNotification(
   video_stream_encoder_->OnLossNotification(loss_notification);
 }
 
+void EncoderRtcpFeedback::OnBitrateAllocationUpdated(
+    const VideoBitrateAllocation& allocation) {
+  std::vector<bool> paused_layers(kMaxSpatialLayers);
+  for (size_t si = 0; si < kMaxSpatialLayers; ++si)
+    paused_layers[si] = allocation.GetSpatialLayerSum(si) == 0;
+  {
+    rtc::CritScope lock(&crit_);
+    if (paused_layers == paused_layers_)
+      return;
+    paused_layers_ = paused_layers;
+  }
+  video_stream_encoder_->SetPausedLayers(std::move(paused_layers));
+}
+
 }  // namespace webrtc
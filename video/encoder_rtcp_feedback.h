@@ -12,8 +12,11 @@
 
 #include <vector>
 
+#include "api/video/video_bitrate_allocation.h"
+#include "api/video/video_bitrate_allocator.h"
 #include "api/video/video_stream_encoder_interface.h"
 #include "call/rtp_video_sender_interface.h"
+#include "call/video_send_stream.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/critical_section.h"
 #include "system_wrappers/include/clock.h"
@@ -22,17 +25,20 @@ namespace webrtc {
 
 class VideoStreamEncoderInterface;
 
-// This class passes feedback (such as key frame requests or loss notifications)
-// from the RtpRtcp module.
+// This class passes feedback (such as key frame requests, loss notifications or
+// the layers the receiver asks for) from the RtpRtcp module.
 class EncoderRtcpFeedback : public RtcpIntraFrameObserver,
-                            public RtcpLossNotificationObserver {
+                            public RtcpLossNotificationObserver,
+                            public VideoBitrateAllocationObserver {
  public:
   EncoderRtcpFeedback(Clock* clock,
                       const std::vector<uint32_t>& ssrcs,
                       VideoStreamEncoderInterface* encoder);
   ~EncoderRtcpFeedback() override = default;
 
-  void SetRtpVideoSender(const RtpVideoSenderInterface* rtp_video_sender);
+  void SetRtpVideoSender(RtpVideoSenderInterface* rtp_video_sender);
+  // Sends key frame requests to |source| instead of the encoder while set.
+  void SetEncodedFrameSource(VideoSendStream::EncodedFrameSource* source);
 
   void OnReceivedIntraFrameRequest(uint32_t ssrc) override;
 
@@ -42,16 +48,24 @@ class EncoderRtcpFeedback : public RtcpIntraFrameObserver,
                                   uint16_t seq_num_of_last_received,
                                   bool decodability_flag) override;
 
+  // Implements VideoBitrateAllocationObserver, for the allocation requested
+  // by the receiver. Pauses encoding of the layers it asks no bitrate for.
+  void OnBitrateAllocationUpdated(
+      const VideoBitrateAllocation& allocation) override;
+
  private:
   bool HasSsrc(uint32_t ssrc);
 
   Clock* const clock_;
   const std::vector<uint32_t> ssrcs_;
-  const RtpVideoSenderInterface* rtp_video_sender_;
+  RtpVideoSenderInterface* rtp_video_sender_;
   VideoStreamEncoderInterface* const video_stream_encoder_;
 
   rtc::CriticalSection crit_;
   int64_t time_last_intra_request_ms_ RTC_GUARDED_BY(crit_);
+  VideoSendStream::EncodedFrameSource* encoded_frame_source_
+      RTC_GUARDED_BY(crit_);
+  std::vector<bool> paused_layers_ RTC_GUARDED_BY(crit_);
 
   const int min_keyframe_send_interval_ms_;
 };
@@ -11,7 +11,10 @@
 #include "video/encoder_rtcp_feedback.h"
 
 #include <memory>
+#include <vector>
 
+#include "api/video/video_bitrate_allocation.h"
+#include "api/video/video_codec_constants.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 #include "video/test/mock_video_stream_encoder.h"
@@ -55,4 +58,43 @@ TEST_F(VieKeyRequestTest, TooManyOnReceivedIntraFrameRequest) {
   encoder_rtcp_feedback_.OnReceivedIntraFrameRequest(kSsrc);
 }
 
+TEST_F(VieKeyRequestTest, SendsRequestsToEncodedFrameSource) {
+  class KeyFrameCounter : public VideoSendStream::EncodedFrameSource {
+   public:
+    void OnTargetBitrateChanged(DataRate target_bitrate) override {}
+    void OnKeyFrameRequested() override { ++num_requests; }
+    int num_requests = 0;
+  } source;
+  encoder_rtcp_feedback_.SetEncodedFrameSource(&source);
+  EXPECT_CALL(encoder_, SendKeyFrame()).Times(0);
+  encoder_rtcp_feedback_.OnReceivedIntraFrameRequest(kSsrc);
+  EXPECT_EQ(1, source.num_requests);
+
+  encoder_rtcp_feedback_.SetEncodedFrameSource(nullptr);
+  EXPECT_CALL(encoder_, SendKeyFrame()).Times(1);
+  simulated_clock_.AdvanceTimeMilliseconds(300);
+  encoder_rtcp_feedback_.OnReceivedIntraFrameRequest(kSsrc);
+  EXPECT_EQ(1, source.num_requests);
+}
+
+TEST_F(VieKeyRequestTest, PausesLayersWithoutRequestedBitrate) {
+  VideoBitrateAllocation allocation;
+  allocation.SetBitrate(0, 0, 100000);
+  allocation.SetBitrate(1, 0, 300000);
+  allocation.SetBitrate(2, 0, 0);
+  std::vector<bool> paused_layers(kMaxSpatialLayers, true);
+  paused_layers[0] = false;
+  paused_layers[1] = false;
+  EXPECT_CALL(encoder_, SetPausedLayers(paused_layers)).Times(1);
+  encoder_rtcp_feedback_.OnBitrateAllocationUpdated(allocation);
+  // Repeated requests for the same layers are not passed on.
+  allocation.SetBitrate(1, 0, 200000);
+  encoder_rtcp_feedback_.OnBitrateAllocationUpdated(allocation);
+
+  allocation.SetBitrate(2, 0, 900000);
+  paused_layers[2] = false;
+  EXPECT_CALL(encoder_, SetPausedLayers(paused_layers)).Times(1);
+  encoder_rtcp_feedback_.OnBitrateAllocationUpdated(allocation);
+}
+
 }  // namespace webrtc
@@ -14,14 +14,18 @@
 #include <utility>
 
 #include "modules/video_coding/include/video_codec_interface.h"
-#include "modules/video_coding/utility/ivf_file_writer.h"
+#include "modules/video_coding/utility/async_ivf_file_writer.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 namespace {
 
 class FrameDumpingDecoder : public VideoDecoder {
  public:
-  FrameDumpingDecoder(std::unique_ptr<VideoDecoder> decoder, FileWrapper file);
+  FrameDumpingDecoder(std::unique_ptr<VideoDecoder> decoder,
+                      FileWrapper file,
+                      TaskQueueFactory* task_queue_factory);
   ~FrameDumpingDecoder() override;
 
   int32_t InitDecode(const VideoCodec* codec_settings,
@@ -38,16 +42,30 @@ class FrameDumpingDecoder : public VideoDecoder {
  private:
   std::unique_ptr<VideoDecoder> decoder_;
   VideoCodecType codec_type_ = VideoCodecType::kVideoCodecGeneric;
-  std::unique_ptr<IvfFileWriter> writer_;
+  rtc::TaskQueue file_queue_;
+  std::unique_ptr<AsyncIvfFileWriter> writer_;
 };
 
 FrameDumpingDecoder::FrameDumpingDecoder(std::unique_ptr<VideoDecoder> decoder,
-                                         FileWrapper file)
+                                         FileWrapper file,
+                                         TaskQueueFactory* task_queue_factory)
     : decoder_(std::move(decoder)),
-      writer_(IvfFileWriter::Wrap(std::move(file),
-                                  /* byte_limit= */ 100000000)) {}
-
-FrameDumpingDecoder::~FrameDumpingDecoder() = default;
+      file_queue_(task_queue_factory->CreateTaskQueue(
+          "FrameDumpingQueue",
+          TaskQueueFactory::Priority::LOW)),
+      writer_(std::make_unique<AsyncIvfFileWriter>(
+          file_queue_.Get(),
+          std::move(file),
+          /* byte_limit= */ 100000000)) {}
+
+FrameDumpingDecoder::~FrameDumpingDecoder() {
+  // Wait for the file to be closed, since the queue drops pending tasks when
+  // deleted.
+  writer_ = nullptr;
+  rtc::Event closed;
+  file_queue_.PostTask([&closed] { closed.Set(); });
+  closed.Wait(rtc::Event::kForever);
+}
 
 int32_t FrameDumpingDecoder::InitDecode(const VideoCodec* codec_settings,
                                         int32_t number_of_cores) {
@@ -85,9 +103,10 @@ const char* FrameDumpingDecoder::ImplementationName() const {
 
 std::unique_ptr<VideoDecoder> CreateFrameDumpingDecoderWrapper(
     std::unique_ptr<VideoDecoder> decoder,
-    FileWrapper file) {
-  return std::make_unique<FrameDumpingDecoder>(std::move(decoder),
-                                               std::move(file));
+    FileWrapper file,
+    TaskQueueFactory* task_queue_factory) {
+  return std::make_unique<FrameDumpingDecoder>(
+      std::move(decoder), std::move(file), task_queue_factory);
 }
 
 }  // namespace webrtc
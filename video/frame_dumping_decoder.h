@@ -13,15 +13,18 @@
 
 #include <memory>
 
+#include "api/task_queue/task_queue_factory.h"
 #include "api/video_codecs/video_decoder.h"
 #include "rtc_base/system/file_wrapper.h"
 
 namespace webrtc {
 
-// Creates a decoder wrapper that writes the encoded frames to an IVF file.
+// Creates a decoder wrapper that writes the encoded frames to an IVF file, on
+// a task queue of its own so that decoding doesn't wait for the disk.
 std::unique_ptr<VideoDecoder> CreateFrameDumpingDecoderWrapper(
     std::unique_ptr<VideoDecoder> decoder,
-    FileWrapper file);
+    FileWrapper file,
+    TaskQueueFactory* task_queue_factory);
 
 }  // namespace webrtc
 
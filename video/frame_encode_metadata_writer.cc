@@ -220,12 +220,15 @@ FrameEncodeMetadataWriter::UpdateBitstream(
 
   // Make sure that the data is not copied if owned by EncodedImage.
   const EncodedImage& buffer = *encoded_image;
-  SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
-      buffer, fragmentation->fragmentationVectorSize,
-      fragmentation->fragmentationOffset, fragmentation->fragmentationLength,
-      encoded_image->ColorSpace(), &modified_buffer,
-      modified_fragmentation->fragmentationOffset,
-      modified_fragmentation->fragmentationLength);
+  if (!SpsVuiRewriter::ParseOutgoingBitstreamAndRewriteSps(
+          buffer, fragmentation->fragmentationVectorSize,
+          fragmentation->fragmentationOffset,
+          fragmentation->fragmentationLength, encoded_image->ColorSpace(),
+          &modified_buffer, modified_fragmentation->fragmentationOffset,
+          modified_fragmentation->fragmentationLength)) {
+    // The bitstream is sent as is.
+    return nullptr;
+  }
 
   encoded_image->SetEncodedData(
       new rtc::RefCountedObject<EncodedImageBufferWrapper>(
@@ -541,5 +541,31 @@ TEST(FrameEncodeMetadataWriterTest, RewritesH264BitstreamWithNonOptimalSps) {
             sizeof(kRewrittenSps) - 4);
 }
 
+TEST(FrameEncodeMetadataWriterTest, DoesNotCopyH264BitstreamWithOptimalSps) {
+  uint8_t optimal_sps[] = {0,    0,    0,    1,    H264::NaluType::kSps,
+                           0x00, 0x00, 0x03, 0x03, 0xF4,
+                           0x05, 0x03, 0xC7, 0xE0, 0x1B,
+                           0x41, 0x10, 0x8D, 0x00};
+
+  EncodedImage image(optimal_sps, sizeof(optimal_sps), sizeof(optimal_sps));
+  image._frameType = VideoFrameType::kVideoFrameKey;
+
+  CodecSpecificInfo codec_specific_info;
+  codec_specific_info.codecType = kVideoCodecH264;
+
+  RTPFragmentationHeader fragmentation;
+  fragmentation.VerifyAndAllocateFragmentationHeader(1);
+  fragmentation.fragmentationOffset[0] = 4;
+  fragmentation.fragmentationLength[0] = sizeof(optimal_sps) - 4;
+
+  FakeEncodedImageCallback sink;
+  FrameEncodeMetadataWriter encode_metadata_writer(&sink);
+  EXPECT_EQ(encode_metadata_writer.UpdateBitstream(&codec_specific_info,
+                                                   &fragmentation, &image),
+            nullptr);
+  EXPECT_EQ(image.data(), optimal_sps);
+  EXPECT_EQ(image.size(), sizeof(optimal_sps));
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <utility>
 
 #include "modules/video_coding/include/video_codec_interface.h"
@@ -106,6 +107,8 @@ ReceiveStatisticsProxy::ReceiveStatisticsProxy(
       start_ms_(clock->TimeInMilliseconds()),
       enable_decode_time_histograms_(
           !field_trial::IsEnabled("WebRTC-DecodeTimeHistogramsKillSwitch")),
+      enable_frame_latency_breakdown_(
+          field_trial::IsEnabled("WebRTC-Video-FrameLatencyBreakdown")),
       last_sample_time_(clock->TimeInMilliseconds()),
       fps_threshold_(kLowFpsThreshold,
                      kHighFpsThreshold,
@@ -259,6 +262,31 @@ void ReceiveStatisticsProxy::UpdateHistograms(
     RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.DecodeTimeInMs", *decode_ms);
     log_stream << "WebRTC.Video.DecodeTimeInMs " << *decode_ms << '\n';
   }
+  absl::optional<int> assembly_ms =
+      frame_assembly_time_counter_.Avg(kMinRequiredSamples);
+  if (assembly_ms) {
+    RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.FrameLatency.AssemblyTimeInMs",
+                              *assembly_ms);
+    log_stream << "WebRTC.Video.FrameLatency.AssemblyTimeInMs " << *assembly_ms
+               << '\n';
+  }
+  absl::optional<int> buffering_ms =
+      frame_buffering_time_counter_.Avg(kMinRequiredSamples);
+  if (buffering_ms) {
+    RTC_HISTOGRAM_COUNTS_10000("WebRTC.Video.FrameLatency.BufferingTimeInMs",
+                               *buffering_ms);
+    log_stream << "WebRTC.Video.FrameLatency.BufferingTimeInMs "
+               << *buffering_ms << '\n';
+  }
+  absl::optional<int> first_packet_to_decoded_ms =
+      first_packet_to_decoded_counter_.Avg(kMinRequiredSamples);
+  if (first_packet_to_decoded_ms) {
+    RTC_HISTOGRAM_COUNTS_10000(
+        "WebRTC.Video.FrameLatency.FirstPacketToDecodedInMs",
+        *first_packet_to_decoded_ms);
+    log_stream << "WebRTC.Video.FrameLatency.FirstPacketToDecodedInMs "
+               << *first_packet_to_decoded_ms << '\n';
+  }
   absl::optional<int> jb_delay_ms =
       jitter_buffer_delay_counter_.Avg(kMinRequiredSamples);
   if (jb_delay_ms) {
@@ -698,6 +726,7 @@ VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
   stats_.jitter_buffer_emitted_count = current_delay_counter_.NumSamples();
   stats_.estimated_playout_ntp_timestamp_ms =
       GetCurrentEstimatedPlayoutNtpTimestampMs(now_ms);
+  stats_.frames_dropped = frames_dropped_.load(std::memory_order_relaxed);
   return stats_;
 }
 
@@ -822,12 +851,42 @@ void ReceiveStatisticsProxy::OnDecodedFrame(const VideoFrame& frame,
   // may be on. E.g. on iOS this gets called on
   // "com.apple.coremedia.decompressionsession.clientcallback"
   VideoFrameMetaData meta(frame, clock_->CurrentTime());
+  absl::optional<FrameReceiveTimeline> timeline;
+  if (enable_frame_latency_breakdown_ && frame.processing_time() &&
+      !frame.packet_infos().empty()) {
+    timeline.emplace();
+    timeline->first_packet_received_ms = std::numeric_limits<int64_t>::max();
+    timeline->last_packet_received_ms = std::numeric_limits<int64_t>::min();
+    for (const RtpPacketInfo& packet_info : frame.packet_infos()) {
+      timeline->first_packet_received_ms = std::min(
+          timeline->first_packet_received_ms, packet_info.receive_time_ms());
+      timeline->last_packet_received_ms = std::max(
+          timeline->last_packet_received_ms, packet_info.receive_time_ms());
+    }
+    timeline->decode_start_ms = frame.processing_time()->start.ms();
+    timeline->decode_finish_ms = frame.processing_time()->finish.ms();
+  }
   worker_thread_->PostTask(ToQueuedTask(
-      task_safety_, [meta, qp, decode_time_ms, content_type, this]() {
+      task_safety_, [meta, qp, decode_time_ms, content_type, timeline, this]() {
         OnDecodedFrame(meta, qp, decode_time_ms, content_type);
+        if (timeline)
+          UpdateFrameLatencyBreakdown(*timeline);
       }));
 }
 
+void ReceiveStatisticsProxy::UpdateFrameLatencyBreakdown(
+    const FrameReceiveTimeline& timeline) {
+  RTC_DCHECK_RUN_ON(&main_thread_);
+  frame_assembly_time_counter_.Add(timeline.last_packet_received_ms -
+                                   timeline.first_packet_received_ms);
+  // Time spent in the frame buffer, waiting for references and the playout
+  // delay.
+  frame_buffering_time_counter_.Add(timeline.decode_start_ms -
+                                    timeline.last_packet_received_ms);
+  first_packet_to_decoded_counter_.Add(timeline.decode_finish_ms -
+                                       timeline.first_packet_received_ms);
+}
+
 void ReceiveStatisticsProxy::OnDecodedFrame(
     const VideoFrameMetaData& frame_meta,
     absl::optional<uint8_t> qp,
@@ -897,6 +956,10 @@ void ReceiveStatisticsProxy::OnDecodedFrame(
   }
   if (stats_.frames_decoded == 1) {
     first_decoded_frame_time_ms_.emplace(frame_meta.decode_timestamp.ms());
+    if (decoder_start_time_ms_) {
+      stats_.start_to_first_frame_decoded_ms =
+          *first_decoded_frame_time_ms_ - *decoder_start_time_ms_;
+    }
   }
   last_decoded_frame_time_ms_.emplace(frame_meta.decode_timestamp.ms());
 }
@@ -937,6 +1000,7 @@ void ReceiveStatisticsProxy::OnRenderedFrame(
         clock_->CurrentNtpInMilliseconds() - frame_meta.ntp_time_ms;
     if (delay_ms >= 0) {
       content_specific_stats->e2e_delay_counter.Add(delay_ms);
+      stats_.e2e_delay_ms = delay_ms;
     }
   }
 
@@ -971,6 +1035,16 @@ void ReceiveStatisticsProxy::OnSyncOffsetUpdated(int64_t video_playout_ntp_ms,
 void ReceiveStatisticsProxy::OnCompleteFrame(bool is_keyframe,
                                              size_t size_bytes,
                                              VideoContentType content_type) {
+  if (!IsCurrentTaskQueueOrThread(worker_thread_)) {
+    // Called on the packet queue of the stream, when packets are processed
+    // off the worker thread.
+    worker_thread_->PostTask(ToQueuedTask(
+        task_safety_, [is_keyframe, size_bytes, content_type, this]() {
+          OnCompleteFrame(is_keyframe, size_bytes, content_type);
+        }));
+    return;
+  }
+
   RTC_DCHECK_RUN_ON(&main_thread_);
 
   if (is_keyframe) {
@@ -1004,10 +1078,7 @@ void ReceiveStatisticsProxy::OnCompleteFrame(bool is_keyframe,
 void ReceiveStatisticsProxy::OnDroppedFrames(uint32_t frames_dropped) {
   // Can be called on either the decode queue or the worker thread
   // See FrameBuffer2 for more details.
-  worker_thread_->PostTask(ToQueuedTask(task_safety_, [frames_dropped, this]() {
-    RTC_DCHECK_RUN_ON(&main_thread_);
-    stats_.frames_dropped += frames_dropped;
-  }));
+  frames_dropped_.fetch_add(frames_dropped, std::memory_order_relaxed);
 }
 
 void ReceiveStatisticsProxy::OnPreDecode(VideoCodecType codec_type, int qp) {
@@ -1040,6 +1111,7 @@ void ReceiveStatisticsProxy::OnRttUpdate(int64_t avg_rtt_ms) {
 
 void ReceiveStatisticsProxy::DecoderThreadStarting() {
   RTC_DCHECK_RUN_ON(&main_thread_);
+  decoder_start_time_ms_ = clock_->TimeInMilliseconds();
 }
 
 void ReceiveStatisticsProxy::DecoderThreadStopped() {
@@ -11,6 +11,7 @@
 #ifndef VIDEO_RECEIVE_STATISTICS_PROXY2_H_
 #define VIDEO_RECEIVE_STATISTICS_PROXY2_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -139,8 +140,21 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
     rtc::HistogramPercentileCounter interframe_delay_percentiles;
   };
 
+  // Receive side timestamps of a decoded frame, taken from its packet infos
+  // and processing time.
+  struct FrameReceiveTimeline {
+    int64_t first_packet_received_ms;
+    int64_t last_packet_received_ms;
+    int64_t decode_start_ms;
+    int64_t decode_finish_ms;
+  };
+
   void QualitySample(Timestamp now);
 
+  // Adds the per-stage delays of a decoded frame, only called when the
+  // "WebRTC-Video-FrameLatencyBreakdown" field trial is enabled.
+  void UpdateFrameLatencyBreakdown(const FrameReceiveTimeline& timeline);
+
   // Removes info about old frames and then updates the framerate.
   void UpdateFramerate(int64_t now_ms) const;
 
@@ -154,6 +168,7 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   Clock* const clock_;
   const int64_t start_ms_;
   const bool enable_decode_time_histograms_;
+  const bool enable_frame_latency_breakdown_;
 
   int64_t last_sample_time_ RTC_GUARDED_BY(main_thread_);
 
@@ -167,12 +182,21 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   mutable VideoReceiveStream::Stats stats_ RTC_GUARDED_BY(main_thread_);
   // Same as stats_.ssrc, but const (no lock required).
   const uint32_t remote_ssrc_;
+  // |stats_.frames_dropped|, counted where the frames are dropped, which is on
+  // the decode queue or the worker thread, instead of posting every drop to
+  // the worker thread. Copied into |stats_| by GetStats().
+  std::atomic<uint32_t> frames_dropped_{0};
   RateStatistics decode_fps_estimator_ RTC_GUARDED_BY(main_thread_);
   RateStatistics renders_fps_estimator_ RTC_GUARDED_BY(main_thread_);
   rtc::RateTracker render_fps_tracker_ RTC_GUARDED_BY(main_thread_);
   rtc::RateTracker render_pixel_tracker_ RTC_GUARDED_BY(main_thread_);
   rtc::SampleCounter sync_offset_counter_ RTC_GUARDED_BY(main_thread_);
   rtc::SampleCounter decode_time_counter_ RTC_GUARDED_BY(main_thread_);
+  rtc::SampleCounter frame_assembly_time_counter_ RTC_GUARDED_BY(main_thread_);
+  rtc::SampleCounter frame_buffering_time_counter_
+      RTC_GUARDED_BY(main_thread_);
+  rtc::SampleCounter first_packet_to_decoded_counter_
+      RTC_GUARDED_BY(main_thread_);
   rtc::SampleCounter jitter_buffer_delay_counter_ RTC_GUARDED_BY(main_thread_);
   rtc::SampleCounter target_delay_counter_ RTC_GUARDED_BY(main_thread_);
   rtc::SampleCounter current_delay_counter_ RTC_GUARDED_BY(main_thread_);
@@ -193,6 +217,7 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
       RTC_GUARDED_BY(main_thread_);
   absl::optional<int64_t> first_decoded_frame_time_ms_
       RTC_GUARDED_BY(main_thread_);
+  absl::optional<int64_t> decoder_start_time_ms_ RTC_GUARDED_BY(main_thread_);
   absl::optional<int64_t> last_decoded_frame_time_ms_
       RTC_GUARDED_BY(main_thread_);
   size_t num_delayed_frames_rendered_ RTC_GUARDED_BY(main_thread_);
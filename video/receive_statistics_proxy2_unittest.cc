@@ -126,6 +126,22 @@ TEST_F(ReceiveStatisticsProxy2Test, OnDecodedFrameIncreasesFramesDecoded) {
   }
 }
 
+TEST_F(ReceiveStatisticsProxy2Test, ReportsStartToFirstFrameDecoded) {
+  EXPECT_EQ(-1, statistics_proxy_->GetStats().start_to_first_frame_decoded_ms);
+  statistics_proxy_->DecoderThreadStarting();
+  fake_clock_.AdvanceTimeMilliseconds(120);
+  webrtc::VideoFrame frame = CreateFrame(kWidth, kHeight);
+  statistics_proxy_->OnDecodedFrame(frame, absl::nullopt, 0,
+                                    VideoContentType::UNSPECIFIED);
+  EXPECT_EQ(120, FlushAndGetStats().start_to_first_frame_decoded_ms);
+
+  // Only the first decoded frame is counted.
+  fake_clock_.AdvanceTimeMilliseconds(30);
+  statistics_proxy_->OnDecodedFrame(frame, absl::nullopt, 0,
+                                    VideoContentType::UNSPECIFIED);
+  EXPECT_EQ(120, FlushAndGetStats().start_to_first_frame_decoded_ms);
+}
+
 TEST_F(ReceiveStatisticsProxy2Test, DecodedFpsIsReported) {
   const int kFps = 20;
   const int kRequiredSamples = metrics::kMinRunTimeInSeconds * kFps;
@@ -462,6 +478,15 @@ TEST_F(ReceiveStatisticsProxy2Test, OnRenderedFrameIncreasesFramesRendered) {
   }
 }
 
+TEST_F(ReceiveStatisticsProxy2Test, OnRenderedFrameReportsEndToEndDelay) {
+  EXPECT_EQ(-1, statistics_proxy_->GetStats().e2e_delay_ms);
+  webrtc::VideoFrame frame = CreateFrame(kWidth, kHeight);
+  const int64_t kEndToEndDelayMs = 42;
+  fake_clock_.AdvanceTimeMilliseconds(kEndToEndDelayMs);
+  statistics_proxy_->OnRenderedFrame(MetaData(frame));
+  EXPECT_EQ(kEndToEndDelayMs, statistics_proxy_->GetStats().e2e_delay_ms);
+}
+
 TEST_F(ReceiveStatisticsProxy2Test, GetStatsReportsSsrc) {
   EXPECT_EQ(kRemoteSsrc, statistics_proxy_->GetStats().ssrc);
 }
@@ -1728,6 +1753,70 @@ TEST_P(ReceiveStatisticsProxy2TestWithContent,
   }
 }
 
+TEST_F(ReceiveStatisticsProxy2Test, FrameLatencyBreakdownOffByDefault) {
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    VideoFrame frame = CreateFrame(kWidth, kHeight);
+    frame.set_packet_infos(RtpPacketInfos(
+        {RtpPacketInfo(kRemoteSsrc, {}, 0, absl::nullopt, absl::nullopt,
+                       fake_clock_.TimeInMilliseconds())}));
+    frame.set_processing_time({Now(), Now()});
+    statistics_proxy_->OnDecodedFrame(frame, absl::nullopt, 0,
+                                      VideoContentType::UNSPECIFIED);
+    fake_clock_.AdvanceTimeMilliseconds(33);
+  }
+  FlushAndUpdateHistograms(absl::nullopt, StreamDataCounters(), nullptr);
+  EXPECT_METRIC_EQ(
+      0, metrics::NumSamples("WebRTC.Video.FrameLatency.AssemblyTimeInMs"));
+}
+
+class ReceiveStatisticsProxy2TestWithFrameLatencyBreakdown
+    : public ReceiveStatisticsProxy2Test {
+ public:
+  ReceiveStatisticsProxy2TestWithFrameLatencyBreakdown()
+      : field_trial_("WebRTC-Video-FrameLatencyBreakdown/Enabled/") {
+    statistics_proxy_.reset(
+        new ReceiveStatisticsProxy(&config_, &fake_clock_, loop_.task_queue()));
+  }
+
+ private:
+  webrtc::test::ScopedFieldTrials field_trial_;
+};
+
+TEST_F(ReceiveStatisticsProxy2TestWithFrameLatencyBreakdown,
+       HistogramsAreUpdated) {
+  constexpr int kAssemblyTimeMs = 4;
+  constexpr int kBufferingTimeMs = 20;
+  constexpr int kDecodeTimeMs = 6;
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    const int64_t first_packet_ms = fake_clock_.TimeInMilliseconds();
+    const int64_t last_packet_ms = first_packet_ms + kAssemblyTimeMs;
+    // Packets may complete the frame out of order.
+    VideoFrame frame = CreateFrame(kWidth, kHeight);
+    frame.set_packet_infos(RtpPacketInfos(
+        {RtpPacketInfo(kRemoteSsrc, {}, 0, absl::nullopt, absl::nullopt,
+                       last_packet_ms),
+         RtpPacketInfo(kRemoteSsrc, {}, 0, absl::nullopt, absl::nullopt,
+                       first_packet_ms)}));
+    const Timestamp decode_start =
+        Timestamp::Millis(last_packet_ms + kBufferingTimeMs);
+    frame.set_processing_time(
+        {decode_start, decode_start + TimeDelta::Millis(kDecodeTimeMs)});
+    statistics_proxy_->OnDecodedFrame(frame, absl::nullopt, kDecodeTimeMs,
+                                      VideoContentType::UNSPECIFIED);
+    fake_clock_.AdvanceTimeMilliseconds(33);
+  }
+  FlushAndUpdateHistograms(absl::nullopt, StreamDataCounters(), nullptr);
+  EXPECT_METRIC_EQ(
+      1, metrics::NumEvents("WebRTC.Video.FrameLatency.AssemblyTimeInMs",
+                            kAssemblyTimeMs));
+  EXPECT_METRIC_EQ(
+      1, metrics::NumEvents("WebRTC.Video.FrameLatency.BufferingTimeInMs",
+                            kBufferingTimeMs));
+  EXPECT_METRIC_EQ(1, metrics::NumEvents(
+                          "WebRTC.Video.FrameLatency.FirstPacketToDecodedInMs",
+                          kAssemblyTimeMs + kBufferingTimeMs + kDecodeTimeMs));
+}
+
 class DecodeTimeHistogramsKillswitch {
  public:
   explicit DecodeTimeHistogramsKillswitch(bool disable_histograms)
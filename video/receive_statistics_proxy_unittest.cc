@@ -434,6 +434,15 @@ TEST_F(ReceiveStatisticsProxyTest, OnRenderedFrameIncreasesFramesRendered) {
   }
 }
 
+TEST_F(ReceiveStatisticsProxyTest, OnRenderedFrameReportsEndToEndDelay) {
+  EXPECT_EQ(-1, statistics_proxy_->GetStats().e2e_delay_ms);
+  webrtc::VideoFrame frame = CreateFrame(kWidth, kHeight);
+  const int64_t kEndToEndDelayMs = 42;
+  fake_clock_.AdvanceTimeMilliseconds(kEndToEndDelayMs);
+  statistics_proxy_->OnRenderedFrame(frame);
+  EXPECT_EQ(kEndToEndDelayMs, statistics_proxy_->GetStats().e2e_delay_ms);
+}
+
 TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsSsrc) {
   EXPECT_EQ(kRemoteSsrc, statistics_proxy_->GetStats().ssrc);
 }
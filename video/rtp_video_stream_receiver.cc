@@ -361,10 +361,11 @@ void RtpVideoStreamReceiver::AddReceiveCodec(
     const VideoCodec& video_codec,
     const std::map<std::string, std::string>& codec_params,
     bool raw_payload) {
-  payload_type_map_.emplace(
-      video_codec.plType,
+  std::unique_ptr<VideoRtpDepacketizer> depacketizer =
       raw_payload ? std::make_unique<VideoRtpDepacketizerRaw>()
-                  : CreateVideoRtpDepacketizer(video_codec.codecType));
+                  : CreateVideoRtpDepacketizer(video_codec.codecType);
+  depacketizer->SetFrameBufferPool(&frame_buffer_pool_);
+  payload_type_map_.emplace(video_codec.plType, std::move(depacketizer));
   pt_codec_params_.emplace(video_codec.plType, codec_params);
 }
 
@@ -754,6 +755,7 @@ void RtpVideoStreamReceiver::OnInsertedPacket(
   int64_t max_recv_time;
   std::vector<rtc::ArrayView<const uint8_t>> payloads;
   RtpPacketInfos::vector_type packet_infos;
+  payloads.reserve(result.packets.size());
 
   bool frame_boundary = true;
   for (auto& packet : result.packets) {
@@ -782,7 +784,7 @@ void RtpVideoStreamReceiver::OnInsertedPacket(
       auto depacketizer_it = payload_type_map_.find(first_packet->payload_type);
       RTC_CHECK(depacketizer_it != payload_type_map_.end());
 
-      rtc::scoped_refptr<EncodedImageBuffer> bitstream =
+      rtc::scoped_refptr<EncodedImageBufferInterface> bitstream =
           depacketizer_it->second->AssembleFrame(payloads);
       if (!bitstream) {
         // Failed to assemble a frame. Discard and continue.
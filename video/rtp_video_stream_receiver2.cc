@@ -46,7 +46,9 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/memory/buffer_allocator.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/thread.h"
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
 #include "system_wrappers/include/ntp_time.h"
@@ -131,17 +133,19 @@ RtpVideoStreamReceiver2::RtcpFeedbackBuffer::RtcpFeedbackBuffer(
   RTC_DCHECK(key_frame_request_sender_);
   RTC_DCHECK(nack_sender_);
   RTC_DCHECK(loss_notification_sender_);
+  // Bound to the packet queue on first use.
+  packet_sequence_checker_.Detach();
 }
 
 void RtpVideoStreamReceiver2::RtcpFeedbackBuffer::RequestKeyFrame() {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   request_key_frame_ = true;
 }
 
 void RtpVideoStreamReceiver2::RtcpFeedbackBuffer::SendNack(
     const std::vector<uint16_t>& sequence_numbers,
     bool buffering_allowed) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   RTC_DCHECK(!sequence_numbers.empty());
   nack_sequence_numbers_.insert(nack_sequence_numbers_.end(),
                                 sequence_numbers.cbegin(),
@@ -158,7 +162,7 @@ void RtpVideoStreamReceiver2::RtcpFeedbackBuffer::SendLossNotification(
     uint16_t last_received_seq_num,
     bool decodability_flag,
     bool buffering_allowed) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   RTC_DCHECK(buffering_allowed);
   RTC_DCHECK(!lntf_state_)
       << "SendLossNotification() called twice in a row with no call to "
@@ -168,7 +172,7 @@ void RtpVideoStreamReceiver2::RtcpFeedbackBuffer::SendLossNotification(
 }
 
 void RtpVideoStreamReceiver2::RtcpFeedbackBuffer::SendBufferedRtcpFeedback() {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
 
   bool request_key_frame = false;
   std::vector<uint16_t> nack_sequence_numbers;
@@ -213,11 +217,15 @@ RtpVideoStreamReceiver2::RtpVideoStreamReceiver2(
     KeyFrameRequestSender* keyframe_request_sender,
     video_coding::OnCompleteFrameCallback* complete_frame_callback,
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
-    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer)
+    rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+    TaskQueueBase* packet_queue,
+    TaskQueueFactory* decryption_queue_factory)
     : clock_(clock),
       config_(*config),
       packet_router_(packet_router),
       process_thread_(process_thread),
+      packet_queue_(packet_queue != current_queue ? packet_queue : nullptr),
+      decryption_queue_factory_(decryption_queue_factory),
       ntp_estimator_(clock),
       rtp_header_extensions_(config_.rtp.extensions),
       forced_playout_delay_max_ms_("max_ms", absl::nullopt),
@@ -240,12 +248,16 @@ RtpVideoStreamReceiver2::RtpVideoStreamReceiver2(
       // TODO(bugs.webrtc.org/10336): Let |rtcp_feedback_buffer_| communicate
       // directly with |rtp_rtcp_|.
       rtcp_feedback_buffer_(this, nack_sender, this),
-      nack_module_(MaybeConstructNackModule(current_queue,
+      nack_module_(MaybeConstructNackModule(packet_queue_ ? packet_queue_
+                                                          : current_queue,
                                             config_,
                                             clock_,
                                             &rtcp_feedback_buffer_,
                                             &rtcp_feedback_buffer_)),
       packet_buffer_(clock_, kPacketBufferStartSize, PacketBufferMaxSize()),
+      frame_buffer_pool_(
+          EncodedImageBufferPool::kDefaultMaxFreeBuffersPerCapacity,
+          GetBufferAllocatorForCurrentThread()),
       has_received_frame_(false),
       frames_decryptable_(false),
       absolute_capture_time_receiver_(clock) {
@@ -297,19 +309,18 @@ RtpVideoStreamReceiver2::RtpVideoStreamReceiver2(
 
   // Only construct the encrypted receiver if frame encryption is enabled.
   if (config_.crypto_options.sframe.require_frame_encryption) {
-    buffered_frame_decryptor_ =
-        std::make_unique<BufferedFrameDecryptor>(this, this);
+    buffered_frame_decryptor_ = std::make_unique<BufferedFrameDecryptor>(
+        this, this, decryption_queue_factory_);
     if (frame_decryptor != nullptr) {
       buffered_frame_decryptor_->SetFrameDecryptor(std::move(frame_decryptor));
     }
   }
 
+  // Bound to the packet queue on first use.
+  packet_sequence_checker_.Detach();
+
   if (frame_transformer) {
-    frame_transformer_delegate_ = new rtc::RefCountedObject<
-        RtpVideoStreamReceiverFrameTransformerDelegate>(
-        this, std::move(frame_transformer), rtc::Thread::Current(),
-        config_.rtp.remote_ssrc);
-    frame_transformer_delegate_->Init();
+    SetDepacketizerToDecoderFrameTransformer(std::move(frame_transformer));
   }
 }
 
@@ -321,8 +332,15 @@ RtpVideoStreamReceiver2::~RtpVideoStreamReceiver2() {
   if (packet_router_)
     packet_router_->RemoveReceiveRtpModule(rtp_rtcp_.get());
   UpdateHistograms();
-  if (frame_transformer_delegate_)
-    frame_transformer_delegate_->Reset();
+  // Stop the NACK timer, the frame decryption and the frame transformer
+  // callbacks on the packet queue. Nothing is left to run there after this.
+  InvokeOnPacketQueue([this] {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    nack_module_.reset();
+    buffered_frame_decryptor_.reset();
+    if (frame_transformer_delegate_)
+      frame_transformer_delegate_->Reset();
+  });
 }
 
 void RtpVideoStreamReceiver2::AddReceiveCodec(
@@ -330,11 +348,17 @@ void RtpVideoStreamReceiver2::AddReceiveCodec(
     const std::map<std::string, std::string>& codec_params,
     bool raw_payload) {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
-  payload_type_map_.emplace(
-      video_codec.plType,
-      raw_payload ? std::make_unique<VideoRtpDepacketizerRaw>()
-                  : CreateVideoRtpDepacketizer(video_codec.codecType));
-  pt_codec_params_.emplace(video_codec.plType, codec_params);
+  RunOnPacketQueue([this, payload_type = video_codec.plType,
+                    codec_type = video_codec.codecType, codec_params,
+                    raw_payload] {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    std::unique_ptr<VideoRtpDepacketizer> depacketizer =
+        raw_payload ? std::make_unique<VideoRtpDepacketizerRaw>()
+                    : CreateVideoRtpDepacketizer(codec_type);
+    depacketizer->SetFrameBufferPool(&frame_buffer_pool_);
+    payload_type_map_.emplace(payload_type, std::move(depacketizer));
+    pt_codec_params_.emplace(payload_type, codec_params);
+  });
 }
 
 absl::optional<Syncable::Info> RtpVideoStreamReceiver2::GetSyncInfo() const {
@@ -465,7 +489,7 @@ void RtpVideoStreamReceiver2::OnReceivedPayloadData(
     rtc::CopyOnWriteBuffer codec_payload,
     const RtpPacketReceived& rtp_packet,
     const RTPVideoHeader& video) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   auto packet = std::make_unique<video_coding::PacketBuffer::Packet>(
       rtp_packet, video, ntp_estimator_.Estimate(rtp_packet.Timestamp()),
       clock_->TimeInMilliseconds());
@@ -551,6 +575,19 @@ void RtpVideoStreamReceiver2::OnReceivedPayloadData(
     }
   }
 
+  // Ask for a key frame as soon as the first packet shows that the stream
+  // starts with a delta frame, rather than once that frame is assembled.
+  // |loss_notification_controller_|, if present, has already done so.
+  if (!has_received_packet_) {
+    has_received_packet_ = true;
+    if (!loss_notification_controller_ &&
+        video_header.is_first_packet_in_frame &&
+        video_header.frame_type != VideoFrameType::kVideoFrameKey) {
+      rtcp_feedback_buffer_.RequestKeyFrame();
+      requested_key_frame_on_first_packet_ = true;
+    }
+  }
+
   if (nack_module_) {
     const bool is_keyframe =
         video_header.is_first_packet_in_frame &&
@@ -605,6 +642,7 @@ void RtpVideoStreamReceiver2::OnReceivedPayloadData(
 
 void RtpVideoStreamReceiver2::OnRecoveredPacket(const uint8_t* rtp_packet,
                                                 size_t rtp_packet_length) {
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   RtpPacketReceived packet;
   if (!packet.Parse(rtp_packet, rtp_packet_length))
     return;
@@ -661,7 +699,14 @@ void RtpVideoStreamReceiver2::OnRtpPacket(const RtpPacketReceived& packet) {
     }
   }
 
-  ReceivePacket(packet);
+  if (packet_queue_) {
+    packet_queue_->PostTask(ToQueuedTask([this, packet] {
+      RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+      ReceivePacket(packet);
+    }));
+  } else {
+    ReceivePacket(packet);
+  }
 
   // Update receive statistics after ReceivePacket.
   // Receive statistics will be reset if the payload type changes (make sure
@@ -676,7 +721,6 @@ void RtpVideoStreamReceiver2::OnRtpPacket(const RtpPacketReceived& packet) {
 }
 
 void RtpVideoStreamReceiver2::RequestKeyFrame() {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
   // TODO(bugs.webrtc.org/10336): Allow the sender to ignore key frame requests
   // issued by anything other than the LossNotificationController if it (the
   // sender) is relying on LNTF alone.
@@ -707,24 +751,25 @@ bool RtpVideoStreamReceiver2::IsRetransmissionsEnabled() const {
 
 void RtpVideoStreamReceiver2::RequestPacketRetransmit(
     const std::vector<uint16_t>& sequence_numbers) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   rtp_rtcp_->SendNack(sequence_numbers);
 }
 
 bool RtpVideoStreamReceiver2::IsDecryptable() const {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
-  return frames_decryptable_;
+  return frames_decryptable_.load(std::memory_order_relaxed);
 }
 
 void RtpVideoStreamReceiver2::OnInsertedPacket(
     video_coding::PacketBuffer::InsertResult result) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   video_coding::PacketBuffer::Packet* first_packet = nullptr;
   int max_nack_count;
   int64_t min_recv_time;
   int64_t max_recv_time;
   std::vector<rtc::ArrayView<const uint8_t>> payloads;
   RtpPacketInfos::vector_type packet_infos;
+  payloads.reserve(result.packets.size());
 
   bool frame_boundary = true;
   for (auto& packet : result.packets) {
@@ -753,7 +798,7 @@ void RtpVideoStreamReceiver2::OnInsertedPacket(
       auto depacketizer_it = payload_type_map_.find(first_packet->payload_type);
       RTC_CHECK(depacketizer_it != payload_type_map_.end());
 
-      rtc::scoped_refptr<EncodedImageBuffer> bitstream =
+      rtc::scoped_refptr<EncodedImageBufferInterface> bitstream =
           depacketizer_it->second->AssembleFrame(payloads);
       if (!bitstream) {
         // Failed to assemble a frame. Discard and continue.
@@ -789,7 +834,7 @@ void RtpVideoStreamReceiver2::OnInsertedPacket(
 
 void RtpVideoStreamReceiver2::OnAssembledFrame(
     std::unique_ptr<video_coding::RtpFrameObject> frame) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   RTC_DCHECK(frame);
 
   const absl::optional<RTPVideoHeader::GenericDescriptorInfo>& descriptor =
@@ -810,7 +855,9 @@ void RtpVideoStreamReceiver2::OnAssembledFrame(
       // |loss_notification_controller_|, if present, would have already
       // requested a key frame when the first packet for the non-key frame
       // had arrived, so no need to replicate the request.
-      if (!loss_notification_controller_) {
+      // The same goes if one was requested on the first packet.
+      if (!loss_notification_controller_ &&
+          !requested_key_frame_on_first_packet_) {
         RequestKeyFrame();
       }
     }
@@ -858,7 +905,7 @@ void RtpVideoStreamReceiver2::OnAssembledFrame(
 
 void RtpVideoStreamReceiver2::OnCompleteFrame(
     std::unique_ptr<video_coding::EncodedFrame> frame) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   video_coding::RtpFrameObject* rtp_frame =
       static_cast<video_coding::RtpFrameObject*>(frame.get());
   last_seq_num_for_pic_id_[rtp_frame->id.picture_id] =
@@ -871,43 +918,56 @@ void RtpVideoStreamReceiver2::OnCompleteFrame(
 
 void RtpVideoStreamReceiver2::OnDecryptedFrame(
     std::unique_ptr<video_coding::RtpFrameObject> frame) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   reference_finder_->ManageFrame(std::move(frame));
 }
 
 void RtpVideoStreamReceiver2::OnDecryptionStatusChange(
     FrameDecryptorInterface::Status status) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   // Called from BufferedFrameDecryptor::DecryptFrame.
-  frames_decryptable_ =
+  frames_decryptable_.store(
       (status == FrameDecryptorInterface::Status::kOk) ||
-      (status == FrameDecryptorInterface::Status::kRecoverable);
+          (status == FrameDecryptorInterface::Status::kRecoverable),
+      std::memory_order_relaxed);
 }
 
 void RtpVideoStreamReceiver2::SetFrameDecryptor(
     rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor) {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
-  if (buffered_frame_decryptor_ == nullptr) {
-    buffered_frame_decryptor_ =
-        std::make_unique<BufferedFrameDecryptor>(this, this);
-  }
-  buffered_frame_decryptor_->SetFrameDecryptor(std::move(frame_decryptor));
+  RunOnPacketQueue([this, frame_decryptor = std::move(frame_decryptor)]() {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    if (buffered_frame_decryptor_ == nullptr) {
+      buffered_frame_decryptor_ = std::make_unique<BufferedFrameDecryptor>(
+          this, this, decryption_queue_factory_);
+    }
+    buffered_frame_decryptor_->SetFrameDecryptor(frame_decryptor);
+  });
 }
 
 void RtpVideoStreamReceiver2::SetDepacketizerToDecoderFrameTransformer(
     rtc::scoped_refptr<FrameTransformerInterface> frame_transformer) {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
-  frame_transformer_delegate_ =
-      new rtc::RefCountedObject<RtpVideoStreamReceiverFrameTransformerDelegate>(
-          this, std::move(frame_transformer), rtc::Thread::Current(),
-          config_.rtp.remote_ssrc);
-  frame_transformer_delegate_->Init();
+  TaskQueueBase* const transformed_frame_queue =
+      packet_queue_ ? packet_queue_ : rtc::Thread::Current();
+  RunOnPacketQueue([this, transformed_frame_queue,
+                    frame_transformer = std::move(frame_transformer)]() {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    frame_transformer_delegate_ = new rtc::RefCountedObject<
+        RtpVideoStreamReceiverFrameTransformerDelegate>(
+        this, frame_transformer, transformed_frame_queue,
+        config_.rtp.remote_ssrc);
+    frame_transformer_delegate_->Init();
+  });
 }
 
 void RtpVideoStreamReceiver2::UpdateRtt(int64_t max_rtt_ms) {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
-  if (nack_module_)
-    nack_module_->UpdateRtt(max_rtt_ms);
+  RunOnPacketQueue([this, max_rtt_ms] {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    if (nack_module_)
+      nack_module_->UpdateRtt(max_rtt_ms);
+  });
 }
 
 absl::optional<int64_t> RtpVideoStreamReceiver2::LastReceivedPacketMs() const {
@@ -941,12 +1001,12 @@ void RtpVideoStreamReceiver2::RemoveSecondarySink(
 
 void RtpVideoStreamReceiver2::ManageFrame(
     std::unique_ptr<video_coding::RtpFrameObject> frame) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   reference_finder_->ManageFrame(std::move(frame));
 }
 
 void RtpVideoStreamReceiver2::ReceivePacket(const RtpPacketReceived& packet) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   if (packet.payload_size() == 0) {
     // Padding or keep-alive packet.
     // TODO(nisse): Could drop empty packets earlier, but need to figure out how
@@ -976,7 +1036,7 @@ void RtpVideoStreamReceiver2::ReceivePacket(const RtpPacketReceived& packet) {
 
 void RtpVideoStreamReceiver2::ParseAndHandleEncapsulatingHeader(
     const RtpPacketReceived& packet) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   if (packet.PayloadType() == config_.rtp.red_payload_type &&
       packet.payload_size() > 0) {
     if (packet.payload()[0] == config_.rtp.ulpfec_payload_type) {
@@ -996,7 +1056,7 @@ void RtpVideoStreamReceiver2::ParseAndHandleEncapsulatingHeader(
 // RtpFrameReferenceFinder will need to know about padding to
 // correctly calculate frame references.
 void RtpVideoStreamReceiver2::NotifyReceiverOfEmptyPacket(uint16_t seq_num) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
 
   reference_finder_->PaddingReceived(seq_num);
 
@@ -1043,20 +1103,25 @@ bool RtpVideoStreamReceiver2::DeliverRtcp(const uint8_t* rtcp_packet,
       clock_->CurrentNtpInMilliseconds() - recieved_ntp.ToMs();
   // Don't use old SRs to estimate time.
   if (time_since_recieved <= 1) {
-    ntp_estimator_.UpdateRtcpTimestamp(rtt, ntp_secs, ntp_frac, rtp_timestamp);
-    absl::optional<int64_t> remote_to_local_clock_offset_ms =
-        ntp_estimator_.EstimateRemoteToLocalClockOffsetMs();
-    if (remote_to_local_clock_offset_ms.has_value()) {
-      absolute_capture_time_receiver_.SetRemoteToLocalClockOffset(
-          Int64MsToQ32x32(*remote_to_local_clock_offset_ms));
-    }
+    // The estimate is used to timestamp the received packets.
+    RunOnPacketQueue([this, rtt, ntp_secs, ntp_frac, rtp_timestamp] {
+      RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+      ntp_estimator_.UpdateRtcpTimestamp(rtt, ntp_secs, ntp_frac,
+                                         rtp_timestamp);
+      absl::optional<int64_t> remote_to_local_clock_offset_ms =
+          ntp_estimator_.EstimateRemoteToLocalClockOffsetMs();
+      if (remote_to_local_clock_offset_ms.has_value()) {
+        absolute_capture_time_receiver_.SetRemoteToLocalClockOffset(
+            Int64MsToQ32x32(*remote_to_local_clock_offset_ms));
+      }
+    });
   }
 
   return true;
 }
 
 void RtpVideoStreamReceiver2::FrameContinuous(int64_t picture_id) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   if (!nack_module_)
     return;
 
@@ -1070,19 +1135,21 @@ void RtpVideoStreamReceiver2::FrameContinuous(int64_t picture_id) {
 
 void RtpVideoStreamReceiver2::FrameDecoded(int64_t picture_id) {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
-  // Running on the decoder thread.
-  int seq_num = -1;
-  auto seq_num_it = last_seq_num_for_pic_id_.find(picture_id);
-  if (seq_num_it != last_seq_num_for_pic_id_.end()) {
-    seq_num = seq_num_it->second;
-    last_seq_num_for_pic_id_.erase(last_seq_num_for_pic_id_.begin(),
-                                   ++seq_num_it);
-  }
+  RunOnPacketQueue([this, picture_id] {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    int seq_num = -1;
+    auto seq_num_it = last_seq_num_for_pic_id_.find(picture_id);
+    if (seq_num_it != last_seq_num_for_pic_id_.end()) {
+      seq_num = seq_num_it->second;
+      last_seq_num_for_pic_id_.erase(last_seq_num_for_pic_id_.begin(),
+                                     ++seq_num_it);
+    }
 
-  if (seq_num != -1) {
-    packet_buffer_.ClearTo(seq_num);
-    reference_finder_->ClearTo(seq_num);
-  }
+    if (seq_num != -1) {
+      packet_buffer_.ClearTo(seq_num);
+      reference_finder_->ClearTo(seq_num);
+    }
+  });
 }
 
 void RtpVideoStreamReceiver2::SignalNetworkState(NetworkState state) {
@@ -1099,6 +1166,19 @@ void RtpVideoStreamReceiver2::StartReceive() {
 void RtpVideoStreamReceiver2::StopReceive() {
   RTC_DCHECK_RUN_ON(&worker_task_checker_);
   receiving_ = false;
+  // Packets are no longer dispatched; let those already dispatched complete
+  // their frames, so that none are completed after this returns.
+  InvokeOnPacketQueue([] {});
+}
+
+int RtpVideoStreamReceiver2::GetUniqueFramesSeen() const {
+  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  int unique_frames_seen = 0;
+  InvokeOnPacketQueue([this, &unique_frames_seen] {
+    RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
+    unique_frames_seen = frame_counter_.GetUniqueSeen();
+  });
+  return unique_frames_seen;
 }
 
 void RtpVideoStreamReceiver2::UpdateHistograms() {
@@ -1129,7 +1209,7 @@ void RtpVideoStreamReceiver2::UpdateHistograms() {
 }
 
 void RtpVideoStreamReceiver2::InsertSpsPpsIntoTracker(uint8_t payload_type) {
-  RTC_DCHECK_RUN_ON(&worker_task_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
 
   auto codec_params_it = pt_codec_params_.find(payload_type);
   if (codec_params_it == pt_codec_params_.end())
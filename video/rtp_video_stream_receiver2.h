@@ -11,6 +11,7 @@
 #ifndef VIDEO_RTP_VIDEO_STREAM_RECEIVER2_H_
 #define VIDEO_RTP_VIDEO_STREAM_RECEIVER2_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -18,11 +19,14 @@
 
 #include "absl/types/optional.h"
 #include "api/crypto/frame_decryptor_interface.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
 #include "api/video/color_space.h"
 #include "api/video_codecs/video_codec.h"
 #include "call/rtp_packet_sink_interface.h"
 #include "call/syncable.h"
 #include "call/video_receive_stream.h"
+#include "common_video/include/encoded_image_buffer_pool.h"
 #include "modules/rtp_rtcp/include/receive_statistics.h"
 #include "modules/rtp_rtcp/include/remote_ntp_time_estimator.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
@@ -39,9 +43,11 @@
 #include "modules/video_coding/rtp_frame_reference_finder.h"
 #include "modules/video_coding/unique_timestamp_counter.h"
 #include "rtc_base/constructor_magic.h"
+#include "rtc_base/event.h"
 #include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/synchronization/sequence_checker.h"
+#include "rtc_base/task_utils/to_queued_task.h"
 #include "rtc_base/thread_annotations.h"
 #include "video/buffered_frame_decryptor.h"
 #include "video/rtp_video_stream_receiver_frame_transformer_delegate.h"
@@ -57,6 +63,17 @@ class RtpPacketReceived;
 class Transport;
 class UlpfecReceiver;
 
+// Receives the RTP packets of a video stream on the worker thread
+// |current_queue|, which also handles RTCP. By default the packets are also
+// processed there. If |packet_queue| is set, e.g. to a queue of a task queue
+// pool shared by all streams, the worker thread only dispatches the packets,
+// and their processing - depacketization, the packet buffer, frame assembly,
+// reference finding and NACK - runs on |packet_queue| instead, so that
+// streams are processed in parallel. |complete_frame_callback| and
+// |nack_sender| are then called on |packet_queue|.
+//
+// Unless documented otherwise, the public methods must be called on the worker
+// thread.
 class RtpVideoStreamReceiver2 : public LossNotificationSender,
                                 public RecoveredPacketReceiver,
                                 public RtpPacketSinkInterface,
@@ -86,7 +103,11 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
       KeyFrameRequestSender* keyframe_request_sender,
       video_coding::OnCompleteFrameCallback* complete_frame_callback,
       rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor,
-      rtc::scoped_refptr<FrameTransformerInterface> frame_transformer);
+      rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
+      TaskQueueBase* packet_queue = nullptr,
+      // If provided, encrypted frames are decrypted on a task queue created
+      // with it rather than on the packet queue.
+      TaskQueueFactory* decryption_queue_factory = nullptr);
   ~RtpVideoStreamReceiver2() override;
 
   void AddReceiveCodec(const VideoCodec& video_codec,
@@ -94,6 +115,7 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
                        bool raw_payload);
 
   void StartReceive();
+  // Waits for the packets already received to be processed.
   void StopReceive();
 
   // Produces the transport-related timestamps; current_delay_ms is left unset.
@@ -101,6 +123,7 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
 
   bool DeliverRtcp(const uint8_t* rtcp_packet, size_t rtcp_packet_length);
 
+  // Called on the packet queue, by |complete_frame_callback|.
   void FrameContinuous(int64_t seq_num);
 
   void FrameDecoded(int64_t seq_num);
@@ -108,16 +131,14 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   void SignalNetworkState(NetworkState state);
 
   // Returns number of different frames seen.
-  int GetUniqueFramesSeen() const {
-    RTC_DCHECK_RUN_ON(&worker_task_checker_);
-    return frame_counter_.GetUniqueSeen();
-  }
+  int GetUniqueFramesSeen() const;
 
   // Implements RtpPacketSinkInterface.
   void OnRtpPacket(const RtpPacketReceived& packet) override;
 
   // TODO(philipel): Stop using VCMPacket in the new jitter buffer and then
-  //                 remove this function. Public only for tests.
+  //                 remove this function. Public only for tests. Called on the
+  //                 packet queue.
   void OnReceivedPayloadData(rtc::CopyOnWriteBuffer codec_payload,
                              const RtpPacketReceived& rtp_packet,
                              const RTPVideoHeader& video);
@@ -125,7 +146,8 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   // Implements RecoveredPacketReceiver.
   void OnRecoveredPacket(const uint8_t* packet, size_t packet_length) override;
 
-  // Send an RTCP keyframe request.
+  // Send an RTCP keyframe request. Can be called on the worker thread or the
+  // packet queue.
   void RequestKeyFrame() override;
 
   // Implements LossNotificationSender.
@@ -142,7 +164,8 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   // Decryption not SRTP.
   bool IsDecryptable() const;
 
-  // Don't use, still experimental.
+  // Don't use, still experimental. Called on the packet queue, by
+  // |nack_sender|.
   void RequestPacketRetransmit(const std::vector<uint16_t>& sequence_numbers);
 
   // Implements OnCompleteFrameCallback.
@@ -232,20 +255,20 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
       bool decodability_flag;
     };
 
-    SequenceChecker worker_task_checker_;
+    SequenceChecker packet_sequence_checker_;
     KeyFrameRequestSender* const key_frame_request_sender_;
     NackSender* const nack_sender_;
     LossNotificationSender* const loss_notification_sender_;
 
     // Key-frame-request-related state.
-    bool request_key_frame_ RTC_GUARDED_BY(worker_task_checker_);
+    bool request_key_frame_ RTC_GUARDED_BY(packet_sequence_checker_);
 
     // NACK-related state.
     std::vector<uint16_t> nack_sequence_numbers_
-        RTC_GUARDED_BY(worker_task_checker_);
+        RTC_GUARDED_BY(packet_sequence_checker_);
 
     absl::optional<LossNotificationState> lntf_state_
-        RTC_GUARDED_BY(worker_task_checker_);
+        RTC_GUARDED_BY(packet_sequence_checker_);
   };
   enum ParseGenericDependenciesResult {
     kDropPacket,
@@ -266,16 +289,47 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   void OnInsertedPacket(video_coding::PacketBuffer::InsertResult result);
   ParseGenericDependenciesResult ParseGenericDependenciesExtension(
       const RtpPacketReceived& rtp_packet,
-      RTPVideoHeader* video_header) RTC_RUN_ON(worker_task_checker_);
+      RTPVideoHeader* video_header) RTC_RUN_ON(packet_sequence_checker_);
   void OnAssembledFrame(std::unique_ptr<video_coding::RtpFrameObject> frame);
 
+  // Runs |closure| on the packet queue, or right away if there is none.
+  template <typename Closure>
+  void RunOnPacketQueue(Closure&& closure) const {
+    if (!packet_queue_) {
+      closure();
+      return;
+    }
+    packet_queue_->PostTask(ToQueuedTask(std::forward<Closure>(closure)));
+  }
+  // Like RunOnPacketQueue(), but waits for |closure| to have run.
+  template <typename Closure>
+  void InvokeOnPacketQueue(Closure&& closure) const {
+    if (!packet_queue_) {
+      closure();
+      return;
+    }
+    rtc::Event done;
+    packet_queue_->PostTask(ToQueuedTask([&closure, &done] {
+      closure();
+      done.Set();
+    }));
+    done.Wait(rtc::Event::kForever);
+  }
+
   Clock* const clock_;
   // Ownership of this object lies with VideoReceiveStream, which owns |this|.
   const VideoReceiveStream::Config& config_;
   PacketRouter* const packet_router_;
   ProcessThread* const process_thread_;
+  // Null if packets are processed on the worker thread.
+  TaskQueueBase* const packet_queue_;
+  TaskQueueFactory* const decryption_queue_factory_;
+
+  // Bound to the packet queue, or to the worker thread if there is none.
+  SequenceChecker packet_sequence_checker_;
 
-  RemoteNtpTimeEstimator ntp_estimator_;
+  RemoteNtpTimeEstimator ntp_estimator_
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   RtpHeaderExtensionMap rtp_header_extensions_;
   // Set by the field trial WebRTC-ForcePlayoutDelay to override any playout
@@ -295,47 +349,58 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   KeyFrameRequestSender* const keyframe_request_sender_;
 
   RtcpFeedbackBuffer rtcp_feedback_buffer_;
-  const std::unique_ptr<NackModule2> nack_module_;
-  std::unique_ptr<LossNotificationController> loss_notification_controller_;
+  std::unique_ptr<NackModule2> nack_module_
+      RTC_GUARDED_BY(packet_sequence_checker_);
+  std::unique_ptr<LossNotificationController> loss_notification_controller_
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   video_coding::PacketBuffer packet_buffer_;
-  UniqueTimestampCounter frame_counter_ RTC_GUARDED_BY(worker_task_checker_);
+  UniqueTimestampCounter frame_counter_
+      RTC_GUARDED_BY(packet_sequence_checker_);
   SeqNumUnwrapper<uint16_t> frame_id_unwrapper_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   // Video structure provided in the dependency descriptor in a first packet
   // of a key frame. It is required to parse dependency descriptor in the
   // following delta packets.
   std::unique_ptr<FrameDependencyStructure> video_structure_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
   // Frame id of the last frame with the attached video structure.
   // absl::nullopt when `video_structure_ == nullptr`;
   absl::optional<int64_t> video_structure_frame_id_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   std::unique_ptr<video_coding::RtpFrameReferenceFinder> reference_finder_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
   absl::optional<VideoCodecType> current_codec_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
   uint32_t last_assembled_frame_rtp_timestamp_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   std::map<int64_t, uint16_t> last_seq_num_for_pic_id_
-      RTC_GUARDED_BY(worker_task_checker_);
-  video_coding::H264SpsPpsTracker tracker_ RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
+  video_coding::H264SpsPpsTracker tracker_ RTC_GUARDED_BY(packet_sequence_checker_);
 
+  // The buffers that the depacketizers assemble frames into, on the NUMA node
+  // of the worker thread if it is bound to one.
+  EncodedImageBufferPool frame_buffer_pool_;
   // Maps payload id to the depacketizer.
   std::map<uint8_t, std::unique_ptr<VideoRtpDepacketizer>> payload_type_map_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   // TODO(johan): Remove pt_codec_params_ once
   // https://bugs.chromium.org/p/webrtc/issues/detail?id=6883 is resolved.
   // Maps a payload type to a map of out-of-band supplied codec parameters.
   std::map<uint8_t, std::map<std::string, std::string>> pt_codec_params_
-      RTC_GUARDED_BY(worker_task_checker_);
-  int16_t last_payload_type_ RTC_GUARDED_BY(worker_task_checker_) = -1;
+      RTC_GUARDED_BY(packet_sequence_checker_);
+  int16_t last_payload_type_ RTC_GUARDED_BY(packet_sequence_checker_) = -1;
 
-  bool has_received_frame_ RTC_GUARDED_BY(worker_task_checker_);
+  bool has_received_frame_ RTC_GUARDED_BY(packet_sequence_checker_);
+  bool has_received_packet_ RTC_GUARDED_BY(packet_sequence_checker_) = false;
+  // Set if the first packet was of a delta frame, and a key frame has already
+  // been requested for it.
+  bool requested_key_frame_on_first_packet_
+      RTC_GUARDED_BY(packet_sequence_checker_) = false;
 
   std::vector<RtpPacketSinkInterface*> secondary_sinks_
       RTC_GUARDED_BY(worker_task_checker_);
@@ -348,17 +413,20 @@ class RtpVideoStreamReceiver2 : public LossNotificationSender,
   // Handles incoming encrypted frames and forwards them to the
   // rtp_reference_finder if they are decryptable.
   std::unique_ptr<BufferedFrameDecryptor> buffered_frame_decryptor_
-      RTC_PT_GUARDED_BY(worker_task_checker_);
-  bool frames_decryptable_ RTC_GUARDED_BY(worker_task_checker_);
-  absl::optional<ColorSpace> last_color_space_;
+      RTC_GUARDED_BY(packet_sequence_checker_);
+  // Written on the packet queue, read on the worker thread.
+  std::atomic<bool> frames_decryptable_;
+  absl::optional<ColorSpace> last_color_space_
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
   AbsoluteCaptureTimeReceiver absolute_capture_time_receiver_
-      RTC_GUARDED_BY(worker_task_checker_);
+      RTC_GUARDED_BY(packet_sequence_checker_);
 
-  int64_t last_completed_picture_id_ = 0;
+  int64_t last_completed_picture_id_ RTC_GUARDED_BY(packet_sequence_checker_) =
+      0;
 
   rtc::scoped_refptr<RtpVideoStreamReceiverFrameTransformerDelegate>
-      frame_transformer_delegate_;
+      frame_transformer_delegate_ RTC_GUARDED_BY(packet_sequence_checker_);
 };
 
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 #include <memory>
 #include <utility>
 
+#include "api/task_queue/default_task_queue_factory.h"
 #include "api/video/video_codec_type.h"
 #include "api/video/video_frame_type.h"
 #include "common_video/h264/h264_common.h"
@@ -664,6 +665,28 @@ TEST_F(RtpVideoStreamReceiver2Test, RequestKeyframeIfFirstFrameIsDelta) {
                                                     video_header);
 }
 
+TEST_F(RtpVideoStreamReceiver2Test,
+       RequestKeyframeOnFirstPacketIfFirstFrameIsDelta) {
+  RtpPacketReceived rtp_packet;
+  rtp_packet.SetPayloadType(kPayloadType);
+  rtc::CopyOnWriteBuffer data({1, 2, 3, 4});
+  rtp_packet.SetSequenceNumber(1);
+  RTPVideoHeader video_header =
+      GetGenericVideoHeader(VideoFrameType::kVideoFrameDelta);
+  video_header.is_last_packet_in_frame = false;
+  // Requested before the frame is complete.
+  EXPECT_CALL(mock_key_frame_request_sender_, RequestKeyFrame());
+  rtp_video_stream_receiver_->OnReceivedPayloadData(data, rtp_packet,
+                                                    video_header);
+
+  // Not requested again once the frame is assembled.
+  rtp_packet.SetSequenceNumber(2);
+  video_header.is_first_packet_in_frame = false;
+  video_header.is_last_packet_in_frame = true;
+  rtp_video_stream_receiver_->OnReceivedPayloadData(data, rtp_packet,
+                                                    video_header);
+}
+
 TEST_F(RtpVideoStreamReceiver2Test, RequestKeyframeWhenPacketBufferGetsFull) {
   constexpr int kPacketBufferMaxSize = 2048;
 
@@ -1157,6 +1180,52 @@ TEST_F(RtpVideoStreamReceiver2Test, TransformFrame) {
   receiver = nullptr;
 }
 
+TEST_F(RtpVideoStreamReceiver2Test, ProcessesPacketsOnPacketQueue) {
+  std::unique_ptr<TaskQueueFactory> task_queue_factory =
+      CreateDefaultTaskQueueFactory();
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> packet_queue =
+      task_queue_factory->CreateTaskQueue("PacketQueue",
+                                          TaskQueueFactory::Priority::NORMAL);
+  auto receiver = std::make_unique<RtpVideoStreamReceiver2>(
+      TaskQueueBase::Current(), Clock::GetRealTimeClock(), &mock_transport_,
+      nullptr, nullptr, &config_, rtp_receive_statistics_.get(), nullptr,
+      nullptr, process_thread_.get(), &mock_nack_sender_,
+      &mock_key_frame_request_sender_, &mock_on_complete_frame_callback_,
+      nullptr, nullptr, packet_queue.get());
+  const std::vector<uint8_t> data = {0, 1, 2, 3, 4};
+  const int kRawPayloadType = 123;
+  VideoCodec codec;
+  codec.plType = kRawPayloadType;
+  receiver->AddReceiveCodec(codec, {}, /*raw_payload=*/true);
+  receiver->StartReceive();
+
+  RtpHeaderExtensionMap extension_map;
+  extension_map.Register<RtpGenericFrameDescriptorExtension00>(5);
+  RtpPacketReceived rtp_packet(&extension_map);
+  RtpGenericFrameDescriptor generic_descriptor;
+  generic_descriptor.SetFirstPacketInSubFrame(true);
+  generic_descriptor.SetLastPacketInSubFrame(true);
+  ASSERT_TRUE(rtp_packet.SetExtension<RtpGenericFrameDescriptorExtension00>(
+      generic_descriptor));
+  uint8_t* payload = rtp_packet.SetPayloadSize(data.size());
+  memcpy(payload, data.data(), data.size());
+  mock_on_complete_frame_callback_.AppendExpectedBitstream(data.data(),
+                                                           data.size());
+  rtp_packet.SetMarker(true);
+  rtp_packet.SetPayloadType(kRawPayloadType);
+  rtp_packet.SetSequenceNumber(1);
+
+  EXPECT_CALL(mock_on_complete_frame_callback_, DoOnCompleteFrame)
+      .WillOnce([&](video_coding::EncodedFrame*) {
+        EXPECT_TRUE(packet_queue->IsCurrent());
+      });
+  receiver->OnRtpPacket(rtp_packet);
+  // Returns once the packet has been processed.
+  receiver->StopReceive();
+  EXPECT_EQ(1, receiver->GetUniqueFramesSeen());
+  receiver = nullptr;
+}
+
 // Test default behavior and when playout delay is overridden by field trial.
 const PlayoutDelay kTransmittedPlayoutDelay = {100, 200};
 const PlayoutDelay kForcedPlayoutDelay = {70, 90};
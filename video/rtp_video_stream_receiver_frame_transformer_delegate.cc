@@ -10,6 +10,8 @@
 
 #include "video/rtp_video_stream_receiver_frame_transformer_delegate.h"
 
+#include <string.h>
+
 #include <utility>
 #include <vector>
 
@@ -34,7 +36,7 @@ class TransformableVideoReceiverFrame
 
   // Implements TransformableVideoFrameInterface.
   rtc::ArrayView<const uint8_t> GetData() const override {
-    return *frame_->GetEncodedData();
+    return rtc::ArrayView<const uint8_t>(frame_->data(), frame_->size());
   }
 
   void SetData(rtc::ArrayView<const uint8_t> data) override {
@@ -42,6 +44,19 @@ class TransformableVideoReceiverFrame
         EncodedImageBuffer::Create(data.data(), data.size()));
   }
 
+  rtc::ArrayView<uint8_t> GetMutableData(size_t size) override {
+    // The frame owns the buffer it was assembled into, so it only needs a new
+    // one to grow.
+    if (size > frame_->GetEncodedData()->size()) {
+      rtc::scoped_refptr<EncodedImageBuffer> buffer =
+          EncodedImageBuffer::Create(size);
+      memcpy(buffer->data(), frame_->data(), frame_->size());
+      frame_->SetEncodedData(buffer);
+    }
+    frame_->set_size(size);
+    return rtc::ArrayView<uint8_t>(frame_->data(), size);
+  }
+
   uint32_t GetTimestamp() const override { return frame_->Timestamp(); }
   uint32_t GetSsrc() const override { return ssrc_; }
 
@@ -70,7 +85,7 @@ RtpVideoStreamReceiverFrameTransformerDelegate::
     RtpVideoStreamReceiverFrameTransformerDelegate(
         RtpVideoFrameReceiver* receiver,
         rtc::scoped_refptr<FrameTransformerInterface> frame_transformer,
-        rtc::Thread* network_thread,
+        TaskQueueBase* network_thread,
         uint32_t ssrc)
     : receiver_(receiver),
       frame_transformer_(std::move(frame_transformer)),
@@ -124,6 +124,48 @@ TEST(RtpVideoStreamReceiverFrameTransformerDelegateTest,
   rtc::ThreadManager::ProcessAllMessageQueuesForTesting();
 }
 
+TEST(RtpVideoStreamReceiverFrameTransformerDelegateTest,
+     TransformsFrameInPlace) {
+  TestRtpVideoFrameReceiver receiver;
+  rtc::scoped_refptr<MockFrameTransformer> mock_frame_transformer(
+      new rtc::RefCountedObject<NiceMock<MockFrameTransformer>>());
+  rtc::scoped_refptr<RtpVideoStreamReceiverFrameTransformerDelegate> delegate =
+      new rtc::RefCountedObject<RtpVideoStreamReceiverFrameTransformerDelegate>(
+          &receiver, mock_frame_transformer, rtc::Thread::Current(),
+          /*remote_ssrc*/ 1111);
+  rtc::scoped_refptr<TransformedFrameCallback> callback;
+  EXPECT_CALL(*mock_frame_transformer, RegisterTransformedFrameSinkCallback)
+      .WillOnce(SaveArg<0>(&callback));
+  delegate->Init();
+  ASSERT_TRUE(callback);
+
+  const uint8_t data[] = {1, 2, 3, 4};
+  auto frame = CreateRtpFrameObject();
+  frame->SetEncodedData(EncodedImageBuffer::Create(data, sizeof(data)));
+  const uint8_t* const frame_data = frame->data();
+
+  // Drops the last byte and inverts the others, in the frame's own buffer.
+  ON_CALL(*mock_frame_transformer, Transform)
+      .WillByDefault([&](std::unique_ptr<TransformableFrameInterface>
+                             transformable_frame) {
+        rtc::ArrayView<uint8_t> transformed_data =
+            transformable_frame->GetMutableData(3);
+        EXPECT_EQ(frame_data, transformed_data.data());
+        for (uint8_t& byte : transformed_data)
+          byte = ~byte;
+        EXPECT_THAT(transformable_frame->GetData(),
+                    ElementsAre(0xfe, 0xfd, 0xfc));
+        callback->OnTransformedFrame(std::move(transformable_frame));
+      });
+  EXPECT_CALL(receiver, ManageFrame)
+      .WillOnce([](std::unique_ptr<video_coding::RtpFrameObject> frame) {
+        EXPECT_THAT(rtc::MakeArrayView(frame->data(), frame->size()),
+                    ElementsAre(0xfe, 0xfd, 0xfc));
+      });
+  delegate->TransformFrame(std::move(frame));
+  rtc::ThreadManager::ProcessAllMessageQueuesForTesting();
+}
+
 TEST(RtpVideoStreamReceiverFrameTransformerDelegateTest,
      TransformableFrameMetadataHasCorrectValue) {
   TestRtpVideoFrameReceiver receiver;
@@ -138,9 +138,12 @@ SendStatisticsProxy::SendStatisticsProxy(
       rtp_config_(config.rtp),
       fallback_max_pixels_(GetFallbackMaxPixelsIfFieldTrialEnabled()),
       fallback_max_pixels_disabled_(GetFallbackMaxPixelsIfFieldTrialDisabled()),
+      enable_frame_latency_breakdown_(
+          field_trial::IsEnabled("WebRTC-Video-FrameLatencyBreakdown")),
       content_type_(content_type),
       start_ms_(clock->TimeInMilliseconds()),
       encode_time_(kEncodeTimeWeigthFactor),
+      encoder_queue_delay_(kEncodeTimeWeigthFactor),
       quality_limitation_reason_tracker_(clock_),
       media_byte_rate_tracker_(kBucketSizeMs, kBucketCount),
       encoded_frame_rate_tracker_(kBucketSizeMs, kBucketCount),
@@ -150,12 +153,17 @@ SendStatisticsProxy::SendStatisticsProxy(
       bw_limited_layers_(false),
       internal_encoder_scaler_(false),
       uma_container_(
-          new UmaSamplesContainer(GetUmaPrefix(content_type_), stats_, clock)) {
-}
+          new UmaSamplesContainer(GetUmaPrefix(content_type_), stats_, clock)),
+      uma_packet_counters_(new UmaPacketCounters(packet_substreams_, clock)) {}
 
 SendStatisticsProxy::~SendStatisticsProxy() {
   rtc::CritScope lock(&crit_);
-  uma_container_->UpdateHistograms(rtp_config_, stats_);
+  {
+    rtc::CritScope packet_lock(&packet_crit_);
+    MergePacketStats();
+    uma_container_->UpdateHistograms(rtp_config_, stats_,
+                                     uma_packet_counters_.get());
+  }
 
   int64_t elapsed_sec = (clock_->TimeInMilliseconds() - start_ms_) / 1000;
   RTC_HISTOGRAM_COUNTS_100000("WebRTC.Video.SendStreamLifetimeInSeconds",
@@ -167,37 +175,23 @@ SendStatisticsProxy::~SendStatisticsProxy() {
 
 SendStatisticsProxy::FallbackEncoderInfo::FallbackEncoderInfo() = default;
 
-SendStatisticsProxy::UmaSamplesContainer::UmaSamplesContainer(
-    const char* prefix,
-    const VideoSendStream::Stats& stats,
-    Clock* const clock)
-    : uma_prefix_(prefix),
-      clock_(clock),
-      input_frame_rate_tracker_(100, 10u),
-      input_fps_counter_(clock, nullptr, true),
-      sent_fps_counter_(clock, nullptr, true),
-      total_byte_counter_(clock, nullptr, true),
+SendStatisticsProxy::UmaPacketCounters::UmaPacketCounters(
+    const std::map<uint32_t, VideoSendStream::StreamStats>& substreams,
+    Clock* clock)
+    : total_byte_counter_(clock, nullptr, true),
       media_byte_counter_(clock, nullptr, true),
       rtx_byte_counter_(clock, nullptr, true),
       padding_byte_counter_(clock, nullptr, true),
       retransmit_byte_counter_(clock, nullptr, true),
-      fec_byte_counter_(clock, nullptr, true),
-      first_rtcp_stats_time_ms_(-1),
-      first_rtp_stats_time_ms_(-1),
-      start_stats_(stats),
-      num_streams_(0),
-      num_pixels_highest_stream_(0) {
-  InitializeBitrateCounters(stats);
-  static_assert(
-      kMaxEncodedFrameTimestampDiff < std::numeric_limits<uint32_t>::max() / 2,
-      "has to be smaller than half range");
+      fec_byte_counter_(clock, nullptr, true) {
+  InitializeBitrateCounters(substreams);
 }
 
-SendStatisticsProxy::UmaSamplesContainer::~UmaSamplesContainer() {}
+SendStatisticsProxy::UmaPacketCounters::~UmaPacketCounters() = default;
 
-void SendStatisticsProxy::UmaSamplesContainer::InitializeBitrateCounters(
-    const VideoSendStream::Stats& stats) {
-  for (const auto& it : stats.substreams) {
+void SendStatisticsProxy::UmaPacketCounters::InitializeBitrateCounters(
+    const std::map<uint32_t, VideoSendStream::StreamStats>& substreams) {
+  for (const auto& it : substreams) {
     uint32_t ssrc = it.first;
     total_byte_counter_.SetLast(it.second.rtp_stats.transmitted.TotalBytes(),
                                 ssrc);
@@ -221,6 +215,27 @@ void SendStatisticsProxy::UmaSamplesContainer::InitializeBitrateCounters(
   }
 }
 
+SendStatisticsProxy::UmaSamplesContainer::UmaSamplesContainer(
+    const char* prefix,
+    const VideoSendStream::Stats& stats,
+    Clock* const clock)
+    : uma_prefix_(prefix),
+      clock_(clock),
+      input_frame_rate_tracker_(100, 10u),
+      input_fps_counter_(clock, nullptr, true),
+      sent_fps_counter_(clock, nullptr, true),
+      first_rtcp_stats_time_ms_(-1),
+      first_rtp_stats_time_ms_(-1),
+      start_stats_(stats),
+      num_streams_(0),
+      num_pixels_highest_stream_(0) {
+  static_assert(
+      kMaxEncodedFrameTimestampDiff < std::numeric_limits<uint32_t>::max() / 2,
+      "has to be smaller than half range");
+}
+
+SendStatisticsProxy::UmaSamplesContainer::~UmaSamplesContainer() {}
+
 void SendStatisticsProxy::UmaSamplesContainer::RemoveOld(int64_t now_ms) {
   while (!encoded_frames_.empty()) {
     auto it = encoded_frames_.begin();
@@ -292,7 +307,8 @@ bool SendStatisticsProxy::UmaSamplesContainer::InsertEncodedFrame(
 
 void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
     const RtpConfig& rtp_config,
-    const VideoSendStream::Stats& current_stats) {
+    const VideoSendStream::Stats& current_stats,
+    UmaPacketCounters* packet_counters) {
   RTC_DCHECK(uma_prefix_ == kRealtimePrefix || uma_prefix_ == kScreenPrefix);
   const int kIndex = uma_prefix_ == kScreenPrefix ? 1 : 0;
   const int kMinRequiredPeriodicSamples = 6;
@@ -360,6 +376,24 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
                                encode_ms);
     log_stream << uma_prefix_ << "EncodeTimeInMs " << encode_ms << "\n";
   }
+  int capture_to_encode_start_ms =
+      capture_to_encode_start_counter_.Avg(kMinRequiredMetricsSamples);
+  if (capture_to_encode_start_ms != -1) {
+    RTC_HISTOGRAMS_COUNTS_1000(
+        kIndex, uma_prefix_ + "FrameLatency.CaptureToEncodeStartInMs",
+        capture_to_encode_start_ms);
+    log_stream << uma_prefix_ << "FrameLatency.CaptureToEncodeStartInMs "
+               << capture_to_encode_start_ms << "\n";
+  }
+  int capture_to_encoded_ms =
+      capture_to_encoded_counter_.Avg(kMinRequiredMetricsSamples);
+  if (capture_to_encoded_ms != -1) {
+    RTC_HISTOGRAMS_COUNTS_1000(
+        kIndex, uma_prefix_ + "FrameLatency.CaptureToEncodedInMs",
+        capture_to_encoded_ms);
+    log_stream << uma_prefix_ << "FrameLatency.CaptureToEncodedInMs "
+               << capture_to_encoded_ms << "\n";
+  }
   int key_frames_permille =
       key_frame_counter_.Permille(kMinRequiredMetricsSamples);
   if (key_frames_permille != -1) {
@@ -403,12 +437,14 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
         kIndex, uma_prefix_ + "BandwidthLimitedResolutionsDisabled",
         num_disabled, 10);
   }
-  int delay_ms = delay_counter_.Avg(kMinRequiredMetricsSamples);
+  int delay_ms =
+      packet_counters->delay_counter_.Avg(kMinRequiredMetricsSamples);
   if (delay_ms != -1)
     RTC_HISTOGRAMS_COUNTS_100000(kIndex, uma_prefix_ + "SendSideDelayInMs",
                                  delay_ms);
 
-  int max_delay_ms = max_delay_counter_.Avg(kMinRequiredMetricsSamples);
+  int max_delay_ms =
+      packet_counters->max_delay_counter_.Avg(kMinRequiredMetricsSamples);
   if (max_delay_ms != -1) {
     RTC_HISTOGRAMS_COUNTS_100000(kIndex, uma_prefix_ + "SendSideDelayMaxInMs",
                                  max_delay_ms);
@@ -588,21 +624,24 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
     }
   }
 
-  AggregatedStats total_bytes_per_sec = total_byte_counter_.GetStats();
+  AggregatedStats total_bytes_per_sec =
+      packet_counters->total_byte_counter_.GetStats();
   if (total_bytes_per_sec.num_samples > kMinRequiredPeriodicSamples) {
     RTC_HISTOGRAMS_COUNTS_10000(kIndex, uma_prefix_ + "BitrateSentInKbps",
                                 total_bytes_per_sec.average * 8 / 1000);
     log_stream << uma_prefix_ << "BitrateSentInBps "
                << total_bytes_per_sec.ToStringWithMultiplier(8) << "\n";
   }
-  AggregatedStats media_bytes_per_sec = media_byte_counter_.GetStats();
+  AggregatedStats media_bytes_per_sec =
+      packet_counters->media_byte_counter_.GetStats();
   if (media_bytes_per_sec.num_samples > kMinRequiredPeriodicSamples) {
     RTC_HISTOGRAMS_COUNTS_10000(kIndex, uma_prefix_ + "MediaBitrateSentInKbps",
                                 media_bytes_per_sec.average * 8 / 1000);
     log_stream << uma_prefix_ << "MediaBitrateSentInBps "
                << media_bytes_per_sec.ToStringWithMultiplier(8) << "\n";
   }
-  AggregatedStats padding_bytes_per_sec = padding_byte_counter_.GetStats();
+  AggregatedStats padding_bytes_per_sec =
+      packet_counters->padding_byte_counter_.GetStats();
   if (padding_bytes_per_sec.num_samples > kMinRequiredPeriodicSamples) {
     RTC_HISTOGRAMS_COUNTS_10000(kIndex,
                                 uma_prefix_ + "PaddingBitrateSentInKbps",
@@ -611,7 +650,7 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
                << padding_bytes_per_sec.ToStringWithMultiplier(8) << "\n";
   }
   AggregatedStats retransmit_bytes_per_sec =
-      retransmit_byte_counter_.GetStats();
+      packet_counters->retransmit_byte_counter_.GetStats();
   if (retransmit_bytes_per_sec.num_samples > kMinRequiredPeriodicSamples) {
     RTC_HISTOGRAMS_COUNTS_10000(kIndex,
                                 uma_prefix_ + "RetransmittedBitrateSentInKbps",
@@ -620,7 +659,8 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
                << retransmit_bytes_per_sec.ToStringWithMultiplier(8) << "\n";
   }
   if (!rtp_config.rtx.ssrcs.empty()) {
-    AggregatedStats rtx_bytes_per_sec = rtx_byte_counter_.GetStats();
+    AggregatedStats rtx_bytes_per_sec =
+        packet_counters->rtx_byte_counter_.GetStats();
     int rtx_bytes_per_sec_avg = -1;
     if (rtx_bytes_per_sec.num_samples > kMinRequiredPeriodicSamples) {
       rtx_bytes_per_sec_avg = rtx_bytes_per_sec.average;
@@ -636,7 +676,8 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
   }
   if (rtp_config.flexfec.payload_type != -1 ||
       rtp_config.ulpfec.red_payload_type != -1) {
-    AggregatedStats fec_bytes_per_sec = fec_byte_counter_.GetStats();
+    AggregatedStats fec_bytes_per_sec =
+        packet_counters->fec_byte_counter_.GetStats();
     if (fec_bytes_per_sec.num_samples > kMinRequiredPeriodicSamples) {
       RTC_HISTOGRAMS_COUNTS_10000(kIndex, uma_prefix_ + "FecBitrateSentInKbps",
                                   fec_bytes_per_sec.average * 8 / 1000);
@@ -673,9 +714,14 @@ void SendStatisticsProxy::OnEncoderReconfigured(
   rtc::CritScope lock(&crit_);
 
   if (content_type_ != config.content_type) {
-    uma_container_->UpdateHistograms(rtp_config_, stats_);
+    rtc::CritScope packet_lock(&packet_crit_);
+    MergePacketStats();
+    uma_container_->UpdateHistograms(rtp_config_, stats_,
+                                     uma_packet_counters_.get());
     uma_container_.reset(new UmaSamplesContainer(
         GetUmaPrefix(config.content_type), stats_, clock_));
+    uma_packet_counters_.reset(
+        new UmaPacketCounters(packet_substreams_, clock_));
     content_type_ = config.content_type;
   }
   uma_container_->encoded_frames_.clear();
@@ -705,13 +751,17 @@ void SendStatisticsProxy::OnSuspendChange(bool is_suspended) {
     const int64_t kMinMs = 500;
     uma_container_->input_fps_counter_.ProcessAndPauseForDuration(kMinMs);
     uma_container_->sent_fps_counter_.ProcessAndPauseForDuration(kMinMs);
-    // Pause bitrate stats.
-    uma_container_->total_byte_counter_.ProcessAndPauseForDuration(kMinMs);
-    uma_container_->media_byte_counter_.ProcessAndPauseForDuration(kMinMs);
-    uma_container_->rtx_byte_counter_.ProcessAndPauseForDuration(kMinMs);
-    uma_container_->padding_byte_counter_.ProcessAndPauseForDuration(kMinMs);
-    uma_container_->retransmit_byte_counter_.ProcessAndPauseForDuration(kMinMs);
-    uma_container_->fec_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+    {
+      // Pause bitrate stats.
+      rtc::CritScope packet_lock(&packet_crit_);
+      UmaPacketCounters* counters = uma_packet_counters_.get();
+      counters->total_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+      counters->media_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+      counters->rtx_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+      counters->padding_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+      counters->retransmit_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+      counters->fec_byte_counter_.ProcessAndPauseForDuration(kMinMs);
+    }
     // Stop adaptation stats.
     uma_container_->cpu_adapt_timer_.Stop(now_ms);
     uma_container_->quality_adapt_timer_.Stop(now_ms);
@@ -723,15 +773,20 @@ void SendStatisticsProxy::OnSuspendChange(bool is_suspended) {
       uma_container_->quality_adapt_timer_.Start(now_ms);
     // Stop pause explicitly for stats that may be zero/not updated for some
     // time.
-    uma_container_->rtx_byte_counter_.ProcessAndStopPause();
-    uma_container_->padding_byte_counter_.ProcessAndStopPause();
-    uma_container_->retransmit_byte_counter_.ProcessAndStopPause();
-    uma_container_->fec_byte_counter_.ProcessAndStopPause();
+    rtc::CritScope packet_lock(&packet_crit_);
+    uma_packet_counters_->rtx_byte_counter_.ProcessAndStopPause();
+    uma_packet_counters_->padding_byte_counter_.ProcessAndStopPause();
+    uma_packet_counters_->retransmit_byte_counter_.ProcessAndStopPause();
+    uma_packet_counters_->fec_byte_counter_.ProcessAndStopPause();
   }
 }
 
 VideoSendStream::Stats SendStatisticsProxy::GetStats() {
   rtc::CritScope lock(&crit_);
+  {
+    rtc::CritScope packet_lock(&packet_crit_);
+    MergePacketStats();
+  }
   PurgeOldStats();
   stats_.input_frame_rate =
       round(uma_container_->input_frame_rate_tracker_.ComputeRate());
@@ -759,11 +814,30 @@ void SendStatisticsProxy::PurgeOldStats() {
   }
 }
 
+void SendStatisticsProxy::MergePacketStats() {
+  for (const auto& it : packet_substreams_) {
+    VideoSendStream::StreamStats* stats = GetStatsEntry(it.first);
+    RTC_DCHECK(stats);
+    stats->rtp_stats = it.second.rtp_stats;
+    stats->total_bitrate_bps = it.second.total_bitrate_bps;
+    stats->retransmit_bitrate_bps = it.second.retransmit_bitrate_bps;
+    stats->avg_delay_ms = it.second.avg_delay_ms;
+    stats->max_delay_ms = it.second.max_delay_ms;
+    stats->total_packet_send_delay_ms = it.second.total_packet_send_delay_ms;
+  }
+}
+
 VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
     uint32_t ssrc) {
+  return GetStatsEntry(&stats_.substreams, ssrc);
+}
+
+VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
+    std::map<uint32_t, VideoSendStream::StreamStats>* substreams,
+    uint32_t ssrc) const {
   std::map<uint32_t, VideoSendStream::StreamStats>::iterator it =
-      stats_.substreams.find(ssrc);
-  if (it != stats_.substreams.end())
+      substreams->find(ssrc);
+  if (it != substreams->end())
     return &it->second;
 
   bool is_media = rtp_config_.IsMediaSsrc(ssrc);
@@ -774,7 +848,7 @@ VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
     return nullptr;
 
   // Insert new entry and return ptr.
-  VideoSendStream::StreamStats* entry = &stats_.substreams[ssrc];
+  VideoSendStream::StreamStats* entry = &(*substreams)[ssrc];
   if (is_media) {
     entry->type = VideoSendStream::StreamStats::StreamType::kMedia;
   } else if (is_rtx) {
@@ -806,10 +880,14 @@ void SendStatisticsProxy::OnInactiveSsrc(uint32_t ssrc) {
   if (!stats)
     return;
 
-  stats->total_bitrate_bps = 0;
-  stats->retransmit_bitrate_bps = 0;
   stats->height = 0;
   stats->width = 0;
+
+  rtc::CritScope packet_lock(&packet_crit_);
+  VideoSendStream::StreamStats* packet_stats =
+      GetStatsEntry(&packet_substreams_, ssrc);
+  packet_stats->total_bitrate_bps = 0;
+  packet_stats->retransmit_bitrate_bps = 0;
 }
 
 void SendStatisticsProxy::OnSetEncoderTargetRate(uint32_t bitrate_bps) {
@@ -982,6 +1060,17 @@ void SendStatisticsProxy::OnSendEncodedImage(
   uma_container_->key_frame_counter_.Add(encoded_image._frameType ==
                                          VideoFrameType::kVideoFrameKey);
 
+  // Encode timestamps are invalid for encoders with internal sources, see
+  // FrameEncodeMetadataWriter::FillTimingInfo.
+  if (enable_frame_latency_breakdown_ &&
+      encoded_image.timing_.flags != VideoSendTiming::kInvalid) {
+    uma_container_->capture_to_encode_start_counter_.Add(
+        encoded_image.timing_.encode_start_ms - encoded_image.capture_time_ms_);
+    uma_container_->capture_to_encoded_counter_.Add(
+        encoded_image.timing_.encode_finish_ms -
+        encoded_image.capture_time_ms_);
+  }
+
   if (encoded_image.qp_ != -1) {
     if (!stats->qp_sum)
       stats->qp_sum = 0;
@@ -1050,6 +1139,14 @@ int SendStatisticsProxy::GetSendFrameRate() const {
   return round(encoded_frame_rate_tracker_.ComputeRate());
 }
 
+void SendStatisticsProxy::OnEncoderQueueDelayMeasured(int64_t queue_delay_us) {
+  RTC_DCHECK_GE(queue_delay_us, 0);
+  rtc::CritScope lock(&crit_);
+  encoder_queue_delay_.Apply(1.0f, queue_delay_us);
+  stats_.avg_encoder_queue_delay_us =
+      std::round(encoder_queue_delay_.filtered());
+}
+
 void SendStatisticsProxy::OnIncomingFrame(int width, int height) {
   rtc::CritScope lock(&crit_);
   uma_container_->input_frame_rate_tracker_.AddSamples(1);
@@ -1304,50 +1401,65 @@ void SendStatisticsProxy::OnReportBlockDataUpdated(
 void SendStatisticsProxy::DataCountersUpdated(
     const StreamDataCounters& counters,
     uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
-  RTC_DCHECK(stats) << "DataCountersUpdated reported for unknown ssrc " << ssrc;
+  {
+    rtc::CritScope packet_lock(&packet_crit_);
+    VideoSendStream::StreamStats* stats =
+        GetStatsEntry(&packet_substreams_, ssrc);
+    RTC_DCHECK(stats) << "DataCountersUpdated reported for unknown ssrc "
+                      << ssrc;
+
+    if (stats->type == VideoSendStream::StreamStats::StreamType::kFlexfec) {
+      // The same counters are reported for both the media ssrc and flexfec
+      // ssrc. Bitrate stats are summed for all SSRCs. Use fec stats from media
+      // update.
+      return;
+    }
 
-  if (stats->type == VideoSendStream::StreamStats::StreamType::kFlexfec) {
-    // The same counters are reported for both the media ssrc and flexfec ssrc.
-    // Bitrate stats are summed for all SSRCs. Use fec stats from media update.
-    return;
+    stats->rtp_stats = counters;
+
+    UmaPacketCounters* uma_counters = uma_packet_counters_.get();
+    uma_counters->total_byte_counter_.Set(counters.transmitted.TotalBytes(),
+                                          ssrc);
+    uma_counters->padding_byte_counter_.Set(counters.transmitted.padding_bytes,
+                                            ssrc);
+    uma_counters->retransmit_byte_counter_.Set(
+        counters.retransmitted.TotalBytes(), ssrc);
+    uma_counters->fec_byte_counter_.Set(counters.fec.TotalBytes(), ssrc);
+    switch (stats->type) {
+      case VideoSendStream::StreamStats::StreamType::kMedia:
+        uma_counters->media_byte_counter_.Set(counters.MediaPayloadBytes(),
+                                              ssrc);
+        break;
+      case VideoSendStream::StreamStats::StreamType::kRtx:
+        uma_counters->rtx_byte_counter_.Set(counters.transmitted.TotalBytes(),
+                                            ssrc);
+        break;
+      case VideoSendStream::StreamStats::StreamType::kFlexfec:
+        break;
+    }
+
+    if (uma_counters->rtp_stats_reported_)
+      return;
+    uma_counters->rtp_stats_reported_ = true;
   }
 
-  stats->rtp_stats = counters;
+  // The first RTP stats since the UMA stats were reset start the adaptation
+  // timers, which the encoder callbacks own.
+  rtc::CritScope lock(&crit_);
   if (uma_container_->first_rtp_stats_time_ms_ == -1) {
     int64_t now_ms = clock_->TimeInMilliseconds();
     uma_container_->first_rtp_stats_time_ms_ = now_ms;
     uma_container_->cpu_adapt_timer_.Restart(now_ms);
     uma_container_->quality_adapt_timer_.Restart(now_ms);
   }
-
-  uma_container_->total_byte_counter_.Set(counters.transmitted.TotalBytes(),
-                                          ssrc);
-  uma_container_->padding_byte_counter_.Set(counters.transmitted.padding_bytes,
-                                            ssrc);
-  uma_container_->retransmit_byte_counter_.Set(
-      counters.retransmitted.TotalBytes(), ssrc);
-  uma_container_->fec_byte_counter_.Set(counters.fec.TotalBytes(), ssrc);
-  switch (stats->type) {
-    case VideoSendStream::StreamStats::StreamType::kMedia:
-      uma_container_->media_byte_counter_.Set(counters.MediaPayloadBytes(),
-                                              ssrc);
-      break;
-    case VideoSendStream::StreamStats::StreamType::kRtx:
-      uma_container_->rtx_byte_counter_.Set(counters.transmitted.TotalBytes(),
-                                            ssrc);
-      break;
-    case VideoSendStream::StreamStats::StreamType::kFlexfec:
-      break;
-  }
 }
 
 void SendStatisticsProxy::Notify(uint32_t total_bitrate_bps,
                                  uint32_t retransmit_bitrate_bps,
                                  uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
+  rtc::CritScope packet_lock(&packet_crit_);
+  VideoSendStream::StreamStats* stats =
+      GetStatsEntry(&packet_substreams_, ssrc);
   if (!stats)
     return;
 
@@ -1369,16 +1481,17 @@ void SendStatisticsProxy::SendSideDelayUpdated(int avg_delay_ms,
                                                int max_delay_ms,
                                                uint64_t total_delay_ms,
                                                uint32_t ssrc) {
-  rtc::CritScope lock(&crit_);
-  VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
+  rtc::CritScope packet_lock(&packet_crit_);
+  VideoSendStream::StreamStats* stats =
+      GetStatsEntry(&packet_substreams_, ssrc);
   if (!stats)
     return;
   stats->avg_delay_ms = avg_delay_ms;
   stats->max_delay_ms = max_delay_ms;
   stats->total_packet_send_delay_ms = total_delay_ms;
 
-  uma_container_->delay_counter_.Add(avg_delay_ms);
-  uma_container_->max_delay_counter_.Add(max_delay_ms);
+  uma_packet_counters_->delay_counter_.Add(avg_delay_ms);
+  uma_packet_counters_->max_delay_counter_.Add(max_delay_ms);
 }
 
 void SendStatisticsProxy::StatsTimer::Start(int64_t now_ms) {
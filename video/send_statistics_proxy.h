@@ -66,6 +66,8 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
   // Used to update incoming frame rate.
   void OnIncomingFrame(int width, int height) override;
 
+  void OnEncoderQueueDelayMeasured(int64_t queue_delay_us) override;
+
   // Dropped frame stats.
   void OnFrameDropped(DropReason) override;
 
@@ -226,6 +228,13 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
   void PurgeOldStats() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
   VideoSendStream::StreamStats* GetStatsEntry(uint32_t ssrc)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Returns the entry of |ssrc| in |substreams|, adding it if |ssrc| is
+  // configured, or null if it is not.
+  VideoSendStream::StreamStats* GetStatsEntry(
+      std::map<uint32_t, VideoSendStream::StreamStats>* substreams,
+      uint32_t ssrc) const;
+  // Copies the stats reported by the packet callbacks into |stats_|.
+  void MergePacketStats() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_, packet_crit_);
 
   struct MaskedAdaptationCounts {
     absl::optional<int> resolution_adaptations = absl::nullopt;
@@ -275,12 +284,23 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
   const RtpConfig rtp_config_;
   const absl::optional<int> fallback_max_pixels_;
   const absl::optional<int> fallback_max_pixels_disabled_;
-  rtc::CriticalSection crit_;
+  // Set by the "WebRTC-Video-FrameLatencyBreakdown" field trial.
+  const bool enable_frame_latency_breakdown_;
+  // Guards the state of the encoder and RTCP callbacks. Must be taken before
+  // |packet_crit_| when both are needed.
+  rtc::CriticalSection crit_{"SendStatisticsProxy"};
+  // Guards the state of the callbacks made for every packet sent, i.e.
+  // DataCountersUpdated(), Notify() and SendSideDelayUpdated(). These come
+  // from the pacer thread, and keeping them off |crit_| means that sending
+  // packets does not contend with the encoder thread. GetStats() merges their
+  // stats into |stats_|.
+  rtc::CriticalSection packet_crit_{"SendStatisticsProxy::Packets"};
   VideoEncoderConfig::ContentType content_type_ RTC_GUARDED_BY(crit_);
   const int64_t start_ms_;
   VideoSendStream::Stats stats_ RTC_GUARDED_BY(crit_);
   std::map<uint32_t, StatsUpdateTimes> update_times_ RTC_GUARDED_BY(crit_);
   rtc::ExpFilter encode_time_ RTC_GUARDED_BY(crit_);
+  rtc::ExpFilter encoder_queue_delay_ RTC_GUARDED_BY(crit_);
   QualityLimitationReasonTracker quality_limitation_reason_tracker_
       RTC_GUARDED_BY(crit_);
   rtc::RateTracker media_byte_rate_tracker_ RTC_GUARDED_BY(crit_);
@@ -309,6 +329,29 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
   // the event can be consumed.
   absl::optional<EncoderChangeEvent> encoder_changed_;
 
+  // Contains the stats used for UMA histograms that the packet callbacks
+  // sample. Reset along with UmaSamplesContainer.
+  struct UmaPacketCounters {
+    UmaPacketCounters(
+        const std::map<uint32_t, VideoSendStream::StreamStats>& substreams,
+        Clock* clock);
+    ~UmaPacketCounters();
+
+    void InitializeBitrateCounters(
+        const std::map<uint32_t, VideoSendStream::StreamStats>& substreams);
+
+    SampleCounter delay_counter_;
+    SampleCounter max_delay_counter_;
+    RateAccCounter total_byte_counter_;
+    RateAccCounter media_byte_counter_;
+    RateAccCounter rtx_byte_counter_;
+    RateAccCounter padding_byte_counter_;
+    RateAccCounter retransmit_byte_counter_;
+    RateAccCounter fec_byte_counter_;
+    // Whether RTP stats have been reported since the counters were created.
+    bool rtp_stats_reported_ = false;
+  };
+
   // Contains stats used for UMA histograms. These stats will be reset if
   // content type changes between real-time video and screenshare, since these
   // will be reported separately.
@@ -319,9 +362,8 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
     ~UmaSamplesContainer();
 
     void UpdateHistograms(const RtpConfig& rtp_config,
-                          const VideoSendStream::Stats& current_stats);
-
-    void InitializeBitrateCounters(const VideoSendStream::Stats& stats);
+                          const VideoSendStream::Stats& current_stats,
+                          UmaPacketCounters* packet_counters);
 
     bool InsertEncodedFrame(const EncodedImage& encoded_frame,
                             int simulcast_idx);
@@ -334,23 +376,17 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
     SampleCounter sent_width_counter_;
     SampleCounter sent_height_counter_;
     SampleCounter encode_time_counter_;
+    SampleCounter capture_to_encode_start_counter_;
+    SampleCounter capture_to_encoded_counter_;
     BoolSampleCounter key_frame_counter_;
     BoolSampleCounter quality_limited_frame_counter_;
     SampleCounter quality_downscales_counter_;
     BoolSampleCounter cpu_limited_frame_counter_;
     BoolSampleCounter bw_limited_frame_counter_;
     SampleCounter bw_resolutions_disabled_counter_;
-    SampleCounter delay_counter_;
-    SampleCounter max_delay_counter_;
     rtc::RateTracker input_frame_rate_tracker_;
     RateCounter input_fps_counter_;
     RateCounter sent_fps_counter_;
-    RateAccCounter total_byte_counter_;
-    RateAccCounter media_byte_counter_;
-    RateAccCounter rtx_byte_counter_;
-    RateAccCounter padding_byte_counter_;
-    RateAccCounter retransmit_byte_counter_;
-    RateAccCounter fec_byte_counter_;
     int64_t first_rtcp_stats_time_ms_;
     int64_t first_rtp_stats_time_ms_;
     StatsTimer cpu_adapt_timer_;
@@ -372,6 +408,13 @@ class SendStatisticsProxy : public VideoStreamEncoderObserver,
   };
 
   std::unique_ptr<UmaSamplesContainer> uma_container_ RTC_GUARDED_BY(crit_);
+
+  // The packet callbacks' part of the substream stats: |rtp_stats|, the send
+  // delays and the bitrates.
+  std::map<uint32_t, VideoSendStream::StreamStats> packet_substreams_
+      RTC_GUARDED_BY(packet_crit_);
+  std::unique_ptr<UmaPacketCounters> uma_packet_counters_
+      RTC_GUARDED_BY(packet_crit_);
 };
 
 }  // namespace webrtc
@@ -350,6 +350,15 @@ TEST_F(SendStatisticsProxyTest, OnEncodedFrameTimeMeasured) {
   EXPECT_EQ(encode_usage_percent, stats.encode_usage_percent);
 }
 
+TEST_F(SendStatisticsProxyTest, OnEncoderQueueDelayMeasured) {
+  EXPECT_EQ(0, statistics_proxy_->GetStats().avg_encoder_queue_delay_us);
+  statistics_proxy_->OnEncoderQueueDelayMeasured(400);
+  EXPECT_EQ(400, statistics_proxy_->GetStats().avg_encoder_queue_delay_us);
+  // The delay is smoothed like the encode time.
+  statistics_proxy_->OnEncoderQueueDelayMeasured(200);
+  EXPECT_EQ(300, statistics_proxy_->GetStats().avg_encoder_queue_delay_us);
+}
+
 TEST_F(SendStatisticsProxyTest, TotalEncodeTimeIncreasesPerFrameMeasured) {
   const int kEncodeUsagePercent = 0;  // Don't care for this test.
   EXPECT_EQ(0u, statistics_proxy_->GetStats().total_encode_time_ms);
@@ -2974,4 +2983,51 @@ TEST_F(ForcedFallbackEnabled, FallbackIfAtMaxPixels) {
       1, metrics::NumSamples(kPrefix + "FallbackChangesPerMinute.Vp8"));
 }
 
+class FrameLatencyBreakdownTest : public SendStatisticsProxyTest {
+ public:
+  FrameLatencyBreakdownTest()
+      : SendStatisticsProxyTest("WebRTC-Video-FrameLatencyBreakdown/Enabled/") {
+  }
+};
+
+TEST_F(FrameLatencyBreakdownTest, CaptureToEncodeHistogramsAreUpdated) {
+  const int kEncodeStartDelayMs = 5;
+  const int kEncodeTimeMs = 9;
+  EncodedImage encoded_image;
+  for (int i = 0; i < SendStatisticsProxy::kMinRequiredMetricsSamples; ++i) {
+    encoded_image.capture_time_ms_ = fake_clock_.TimeInMilliseconds();
+    encoded_image.SetEncodeTime(
+        encoded_image.capture_time_ms_ + kEncodeStartDelayMs,
+        encoded_image.capture_time_ms_ + kEncodeStartDelayMs + kEncodeTimeMs);
+    encoded_image.timing_.flags = VideoSendTiming::kNotTriggered;
+    statistics_proxy_->OnSendEncodedImage(encoded_image, nullptr);
+    fake_clock_.AdvanceTimeMilliseconds(33);
+  }
+
+  statistics_proxy_.reset();
+  EXPECT_METRIC_EQ(1, metrics::NumEvents(
+                          "WebRTC.Video.FrameLatency.CaptureToEncodeStartInMs",
+                          kEncodeStartDelayMs));
+  EXPECT_METRIC_EQ(
+      1, metrics::NumEvents("WebRTC.Video.FrameLatency.CaptureToEncodedInMs",
+                            kEncodeStartDelayMs + kEncodeTimeMs));
+}
+
+TEST_F(SendStatisticsProxyTest, CaptureToEncodeHistogramsOffByDefault) {
+  EncodedImage encoded_image;
+  for (int i = 0; i < SendStatisticsProxy::kMinRequiredMetricsSamples; ++i) {
+    encoded_image.capture_time_ms_ = fake_clock_.TimeInMilliseconds();
+    encoded_image.SetEncodeTime(encoded_image.capture_time_ms_ + 5,
+                                encoded_image.capture_time_ms_ + 10);
+    encoded_image.timing_.flags = VideoSendTiming::kNotTriggered;
+    statistics_proxy_->OnSendEncodedImage(encoded_image, nullptr);
+    fake_clock_.AdvanceTimeMilliseconds(33);
+  }
+
+  statistics_proxy_.reset();
+  EXPECT_METRIC_EQ(
+      0, metrics::NumSamples(
+             "WebRTC.Video.FrameLatency.CaptureToEncodeStartInMs"));
+}
+
 }  // namespace webrtc
@@ -10,6 +10,8 @@
 #ifndef VIDEO_TEST_MOCK_VIDEO_STREAM_ENCODER_H_
 #define VIDEO_TEST_MOCK_VIDEO_STREAM_ENCODER_H_
 
+#include <vector>
+
 #include "api/video/video_stream_encoder_interface.h"
 #include "test/gmock.h"
 
@@ -34,6 +36,7 @@ class MockVideoStreamEncoder : public VideoStreamEncoderInterface {
               (DataRate, DataRate, DataRate, uint8_t, int64_t, double),
               (override));
   MOCK_METHOD(void, OnFrame, (const VideoFrame&), (override));
+  MOCK_METHOD(void, SetPausedLayers, (std::vector<bool>), (override));
   MOCK_METHOD(void,
               SetBitrateAllocationObserver,
               (VideoBitrateAllocationObserver*),
@@ -316,7 +316,8 @@ std::unique_ptr<VideoDecoder> VideoQualityTest::CreateVideoDecoder(
     std::string path =
         params_.logging.encoded_frame_base_path + "." + str.str() + ".recv.ivf";
     decoder = CreateFrameDumpingDecoderWrapper(
-        std::move(decoder), FileWrapper::OpenWriteOnly(path));
+        std::move(decoder), FileWrapper::OpenWriteOnly(path),
+        task_queue_factory_.get());
   }
   return decoder;
 }
@@ -364,7 +364,8 @@ void VideoReceiveStream::Start() {
           << this->config_.rtp.remote_ssrc << "-" << rtc::TimeMicros()
           << ".ivf";
       video_decoder = CreateFrameDumpingDecoderWrapper(
-          std::move(video_decoder), FileWrapper::OpenWriteOnly(ssb.str()));
+          std::move(video_decoder), FileWrapper::OpenWriteOnly(ssb.str()),
+          task_queue_factory_);
     }
 
     video_decoders_.push_back(std::move(video_decoder));
@@ -188,8 +188,13 @@ VideoReceiveStream2::VideoReceiveStream2(
     ProcessThread* process_thread,
     CallStats* call_stats,
     Clock* clock,
-    VCMTiming* timing)
+    VCMTiming* timing,
+    TaskQueueFactory* decode_queue_factory,
+    TaskQueueFactory* packet_queue_factory,
+    TaskQueueFactory* render_queue_factory)
     : task_queue_factory_(task_queue_factory),
+      render_queue_factory_(render_queue_factory ? render_queue_factory
+                                                 : task_queue_factory),
       transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
       num_cpu_cores_(num_cpu_cores),
@@ -201,6 +206,11 @@ VideoReceiveStream2::VideoReceiveStream2(
       rtp_receive_statistics_(ReceiveStatistics::Create(clock_)),
       timing_(timing),
       video_receiver_(clock_, timing_.get()),
+      packet_queue_(packet_queue_factory
+                        ? packet_queue_factory->CreateTaskQueue(
+                              "RtpReceivePackets",
+                              TaskQueueFactory::Priority::HIGH)
+                        : nullptr),
       rtp_video_stream_receiver_(worker_thread_,
                                  clock_,
                                  &transport_adapter_,
@@ -215,7 +225,9 @@ VideoReceiveStream2::VideoReceiveStream2(
                                  nullptr,  // Use default KeyFrameRequestSender
                                  this,     // OnCompleteFrameCallback
                                  config_.frame_decryptor,
-                                 config_.frame_transformer),
+                                 config_.frame_transformer,
+                                 packet_queue_.get(),
+                                 packet_queue_factory),
       rtp_stream_sync_(current_queue, this),
       max_wait_for_keyframe_ms_(KeyframeIntervalSettings::ParseFromFieldTrials()
                                     .MaxWaitForKeyframeMs()
@@ -223,21 +235,24 @@ VideoReceiveStream2::VideoReceiveStream2(
       max_wait_for_frame_ms_(KeyframeIntervalSettings::ParseFromFieldTrials()
                                  .MaxWaitForFrameMs()
                                  .value_or(kMaxWaitForFrameMs)),
-      decode_queue_(task_queue_factory_->CreateTaskQueue(
-          "DecodingQueue",
-          TaskQueueFactory::Priority::HIGH)) {
+      decode_queue_((decode_queue_factory ? decode_queue_factory
+                                          : task_queue_factory_)
+                        ->CreateTaskQueue("DecodingQueue",
+                                          TaskQueueFactory::Priority::HIGH)) {
   RTC_LOG(LS_INFO) << "VideoReceiveStream2: " << config_.ToString();
 
   RTC_DCHECK(worker_thread_);
-  RTC_DCHECK(config_.renderer);
+  RTC_DCHECK(config_.renderer || !config_.decode_frames);
   RTC_DCHECK(call_stats_);
 
   module_process_sequence_checker_.Detach();
+  if (packet_queue_)
+    packet_sequence_checker_.Detach();
 
   RTC_DCHECK(!config_.decoders.empty());
   std::set<int> decoder_payload_types;
   for (const Decoder& decoder : config_.decoders) {
-    RTC_CHECK(decoder.decoder_factory);
+    RTC_CHECK(decoder.decoder_factory || !config_.decode_frames);
     RTC_CHECK(decoder_payload_types.find(decoder.payload_type) ==
               decoder_payload_types.end())
         << "Duplicate payload type (" << decoder.payload_type
@@ -303,10 +318,45 @@ void VideoReceiveStream2::Start() {
   }
 
   transport_adapter_.Enable();
+  if (config_.decode_frames) {
+    CreateDecoders();
+  } else {
+    // Only the depacketization is needed to pass on the frames.
+    for (const Decoder& decoder : config_.decoders) {
+      VideoCodec codec = CreateDecoderVideoCodec(decoder);
+      const bool raw_payload =
+          config_.rtp.raw_payload_types.count(codec.plType) > 0;
+      rtp_video_stream_receiver_.AddReceiveCodec(
+          codec, decoder.video_format.parameters, raw_payload);
+    }
+  }
+
+  // Make sure we register as a stats observer *after* we've prepared the
+  // |video_stream_decoder_|.
+  call_stats_->RegisterStatsObserver(this);
+
+  // Start decoding on task queue.
+  video_receiver_.DecoderThreadStarting();
+  stats_proxy_.DecoderThreadStarting();
+  decode_queue_.PostTask([this] {
+    RTC_DCHECK_RUN_ON(&decode_queue_);
+    decoder_stopped_ = false;
+    // Set up the preferred decoder now, rather than when its first frame is
+    // already waiting to be decoded.
+    if (config_.decode_frames && !config_.decoders.empty())
+      video_receiver_.PrepareDecoder(config_.decoders[0].payload_type);
+    StartNextDecode();
+  });
+  decoder_running_ = true;
+  rtp_video_stream_receiver_.StartReceive();
+}
+
+void VideoReceiveStream2::CreateDecoders() {
+  RTC_DCHECK_RUN_ON(&worker_sequence_checker_);
   rtc::VideoSinkInterface<VideoFrame>* renderer = nullptr;
   if (config_.enable_prerenderer_smoothing) {
     incoming_video_stream_.reset(new IncomingVideoStream(
-        task_queue_factory_, config_.render_delay_ms, this));
+        render_queue_factory_, config_.render_delay_ms, this));
     renderer = incoming_video_stream_.get();
   } else {
     renderer = this;
@@ -340,7 +390,8 @@ void VideoReceiveStream2::Start() {
           << this->config_.rtp.remote_ssrc << "-" << rtc::TimeMicros()
           << ".ivf";
       video_decoder = CreateFrameDumpingDecoderWrapper(
-          std::move(video_decoder), FileWrapper::OpenWriteOnly(ssb.str()));
+          std::move(video_decoder), FileWrapper::OpenWriteOnly(ssb.str()),
+          task_queue_factory_);
     }
 
     video_decoders_.push_back(std::move(video_decoder));
@@ -360,21 +411,6 @@ void VideoReceiveStream2::Start() {
   RTC_DCHECK(renderer != nullptr);
   video_stream_decoder_.reset(
       new VideoStreamDecoder(&video_receiver_, &stats_proxy_, renderer));
-
-  // Make sure we register as a stats observer *after* we've prepared the
-  // |video_stream_decoder_|.
-  call_stats_->RegisterStatsObserver(this);
-
-  // Start decoding on task queue.
-  video_receiver_.DecoderThreadStarting();
-  stats_proxy_.DecoderThreadStarting();
-  decode_queue_.PostTask([this] {
-    RTC_DCHECK_RUN_ON(&decode_queue_);
-    decoder_stopped_ = false;
-    StartNextDecode();
-  });
-  decoder_running_ = true;
-  rtp_video_stream_receiver_.StartReceive();
 }
 
 void VideoReceiveStream2::Stop() {
@@ -404,8 +440,10 @@ void VideoReceiveStream2::Stop() {
     // destruction. This effectively stops the VCM since the decoder thread is
     // stopped, the VCM is deregistered and no asynchronous decoder threads are
     // running.
-    for (const Decoder& decoder : config_.decoders)
-      video_receiver_.RegisterExternalDecoder(nullptr, decoder.payload_type);
+    if (config_.decode_frames) {
+      for (const Decoder& decoder : config_.decoders)
+        video_receiver_.RegisterExternalDecoder(nullptr, decoder.payload_type);
+    }
 
     UpdateHistograms();
   }
@@ -518,7 +556,7 @@ void VideoReceiveStream2::SetDepacketizerToDecoderFrameTransformer(
 void VideoReceiveStream2::SendNack(
     const std::vector<uint16_t>& sequence_numbers,
     bool buffering_allowed) {
-  RTC_DCHECK_RUN_ON(&worker_sequence_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
   RTC_DCHECK(buffering_allowed);
   rtp_video_stream_receiver_.RequestPacketRetransmit(sequence_numbers);
 }
@@ -536,7 +574,7 @@ void VideoReceiveStream2::RequestKeyFrame(int64_t timestamp_ms) {
 
 void VideoReceiveStream2::OnCompleteFrame(
     std::unique_ptr<video_coding::EncodedFrame> frame) {
-  RTC_DCHECK_RUN_ON(&worker_sequence_checker_);
+  RTC_DCHECK_RUN_ON(&packet_sequence_checker_);
 
   // TODO(https://bugs.webrtc.org/9974): Consider removing this workaround.
   int64_t time_now_ms = clock_->TimeInMilliseconds();
@@ -547,14 +585,17 @@ void VideoReceiveStream2::OnCompleteFrame(
   last_complete_frame_time_ms_ = time_now_ms;
 
   const PlayoutDelay& playout_delay = frame->EncodedImage().playout_delay_;
-  if (playout_delay.min_ms >= 0) {
-    frame_minimum_playout_delay_ms_ = playout_delay.min_ms;
-    UpdatePlayoutDelays();
-  }
-
-  if (playout_delay.max_ms >= 0) {
-    frame_maximum_playout_delay_ms_ = playout_delay.max_ms;
-    UpdatePlayoutDelays();
+  if (playout_delay.min_ms >= 0 || playout_delay.max_ms >= 0) {
+    if (packet_queue_) {
+      worker_thread_->PostTask(
+          ToQueuedTask(task_safety_, [this, playout_delay]() {
+            RTC_DCHECK_RUN_ON(&worker_sequence_checker_);
+            OnFramePlayoutDelay(playout_delay);
+          }));
+    } else {
+      RTC_DCHECK_RUN_ON(&worker_sequence_checker_);
+      OnFramePlayoutDelay(playout_delay);
+    }
   }
 
   int64_t last_continuous_pid = frame_buffer_->InsertFrame(std::move(frame));
@@ -562,6 +603,17 @@ void VideoReceiveStream2::OnCompleteFrame(
     rtp_video_stream_receiver_.FrameContinuous(last_continuous_pid);
 }
 
+void VideoReceiveStream2::OnFramePlayoutDelay(
+    const PlayoutDelay& playout_delay) {
+  if (playout_delay.min_ms >= 0)
+    frame_minimum_playout_delay_ms_ = playout_delay.min_ms;
+
+  if (playout_delay.max_ms >= 0)
+    frame_maximum_playout_delay_ms_ = playout_delay.max_ms;
+
+  UpdatePlayoutDelays();
+}
+
 void VideoReceiveStream2::OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) {
   RTC_DCHECK_RUN_ON(&worker_sequence_checker_);
   frame_buffer_->UpdateRtt(max_rtt_ms);
@@ -657,7 +709,11 @@ void VideoReceiveStream2::HandleEncodedFrame(
   const bool keyframe_request_is_due =
       now_ms >= (last_keyframe_request_ms_ + max_wait_for_keyframe_ms_);
 
-  int decode_result = video_receiver_.Decode(frame.get());
+  // Without decoding, the frame buffer hands out a key frame first and then
+  // only frames whose references were handed out, so all are decodable.
+  int decode_result = config_.decode_frames
+                          ? video_receiver_.Decode(frame.get())
+                          : WEBRTC_VIDEO_CODEC_OK;
   if (decode_result == WEBRTC_VIDEO_CODEC_OK ||
       decode_result == WEBRTC_VIDEO_CODEC_OK_REQUEST_KEYFRAME) {
     keyframe_required_ = false;
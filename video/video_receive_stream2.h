@@ -95,7 +95,10 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
                       ProcessThread* process_thread,
                       CallStats* call_stats,
                       Clock* clock,
-                      VCMTiming* timing);
+                      VCMTiming* timing,
+                      TaskQueueFactory* decode_queue_factory = nullptr,
+                      TaskQueueFactory* packet_queue_factory = nullptr,
+                      TaskQueueFactory* render_queue_factory = nullptr);
   ~VideoReceiveStream2() override;
 
   const Config& config() const { return config_; }
@@ -130,11 +133,13 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
 
   // Implements NackSender.
   // For this particular override of the interface,
-  // only (buffering_allowed == true) is acceptable.
+  // only (buffering_allowed == true) is acceptable. Called on the packet
+  // queue.
   void SendNack(const std::vector<uint16_t>& sequence_numbers,
                 bool buffering_allowed) override;
 
-  // Implements video_coding::OnCompleteFrameCallback.
+  // Implements video_coding::OnCompleteFrameCallback. Called on the packet
+  // queue.
   void OnCompleteFrame(
       std::unique_ptr<video_coding::EncodedFrame> frame) override;
 
@@ -159,6 +164,8 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
   void GenerateKeyFrame() override;
 
  private:
+  // Creates the decoders and the renderer path for |config_.decoders|.
+  void CreateDecoders() RTC_RUN_ON(worker_sequence_checker_);
   int64_t GetMaxWaitMs() const RTC_RUN_ON(decode_queue_);
   void StartNextDecode() RTC_RUN_ON(decode_queue_);
   void HandleEncodedFrame(std::unique_ptr<video_coding::EncodedFrame> frame)
@@ -167,6 +174,8 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
       RTC_RUN_ON(worker_sequence_checker_);
   void UpdatePlayoutDelays() const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(worker_sequence_checker_);
+  void OnFramePlayoutDelay(const PlayoutDelay& playout_delay)
+      RTC_RUN_ON(worker_sequence_checker_);
   void RequestKeyFrame(int64_t timestamp_ms)
       RTC_RUN_ON(worker_sequence_checker_);
   void HandleKeyFrameGeneration(bool received_frame_is_keyframe,
@@ -181,8 +190,12 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
 
   SequenceChecker worker_sequence_checker_;
   SequenceChecker module_process_sequence_checker_;
+  // The sequence of |packet_queue_|, or of the worker thread if there is none.
+  SequenceChecker packet_sequence_checker_;
 
   TaskQueueFactory* const task_queue_factory_;
+  // Creates the queue of |incoming_video_stream_|.
+  TaskQueueFactory* const render_queue_factory_;
 
   TransportAdapter transport_adapter_;
   const VideoReceiveStream::Config config_;
@@ -204,6 +217,9 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
   std::unique_ptr<VCMTiming> timing_;  // Jitter buffer experiment.
   VideoReceiver2 video_receiver_;
   std::unique_ptr<rtc::VideoSinkInterface<VideoFrame>> incoming_video_stream_;
+  // Runs the packet processing of |rtp_video_stream_receiver_|, if set.
+  // Defined before it, since its destruction waits on the queue.
+  const std::unique_ptr<TaskQueueBase, TaskQueueDeleter> packet_queue_;
   RtpVideoStreamReceiver2 rtp_video_stream_receiver_;
   std::unique_ptr<VideoStreamDecoder> video_stream_decoder_;
   RtpStreamsSynchronizer rtp_stream_sync_;
@@ -228,7 +244,7 @@ class VideoReceiveStream2 : public webrtc::VideoReceiveStream,
 
   int64_t last_keyframe_request_ms_ RTC_GUARDED_BY(decode_queue_) = 0;
   int64_t last_complete_frame_time_ms_
-      RTC_GUARDED_BY(worker_sequence_checker_) = 0;
+      RTC_GUARDED_BY(packet_sequence_checker_) = 0;
 
   // Keyframe request intervals are configurable through field trials.
   const int max_wait_for_keyframe_ms_;
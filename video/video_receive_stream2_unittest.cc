@@ -178,6 +178,23 @@ TEST_F(VideoReceiveStream2Test, CreateFrameFromH264FmtpSpropAndIdr) {
   init_decode_event_.Wait(kDefaultTimeOutMs);
 }
 
+TEST_F(VideoReceiveStream2Test, InitializesDecoderOnStart) {
+  // The first configured decoder is initialized before any packet arrives.
+  rtc::Event init_decode_event;
+  EXPECT_CALL(mock_h264_video_decoder_, InitDecode(_, _))
+      .WillOnce(Invoke([&init_decode_event](const VideoCodec* config,
+                                            int32_t number_of_cores) {
+        init_decode_event.Set();
+        return 0;
+      }));
+  EXPECT_CALL(mock_h264_video_decoder_, RegisterDecodeCompleteCallback(_));
+  EXPECT_CALL(mock_null_video_decoder_, InitDecode(_, _)).Times(0);
+  video_receive_stream_->Start();
+  EXPECT_TRUE(init_decode_event.Wait(kDefaultTimeOutMs));
+  EXPECT_CALL(mock_h264_video_decoder_, Release());
+  video_receive_stream_->Stop();
+}
+
 TEST_F(VideoReceiveStream2Test, PlayoutDelay) {
   const PlayoutDelay kPlayoutDelayMs = {123, 321};
   std::unique_ptr<FrameObjectFake> test_frame(new FrameObjectFake());
@@ -448,6 +465,35 @@ TEST_F(VideoReceiveStream2TestWithFakeDecoder,
   video_receive_stream_->Stop();
 }
 
+TEST_F(VideoReceiveStream2TestWithFakeDecoder,
+       PassesFramesWithoutDecodingWhenNotDecoding) {
+  config_.decode_frames = false;
+  config_.renderer = nullptr;
+  config_.decoders[0].decoder_factory = nullptr;
+  rtc::Event recorded;
+  int num_recorded = 0;
+  ReCreateReceiveStream(VideoReceiveStream::RecordingState(
+      [&](const RecordableEncodedFrame& frame) {
+        EXPECT_EQ(frame.is_key_frame(), num_recorded == 0);
+        if (++num_recorded == 2)
+          recorded.Set();
+      }));
+  video_receive_stream_->Start();
+
+  auto key_frame = MakeFrame(VideoFrameType::kVideoFrameKey, 0);
+  key_frame->SetTimestamp(90);
+  video_receive_stream_->OnCompleteFrame(std::move(key_frame));
+  auto delta_frame = MakeFrame(VideoFrameType::kVideoFrameDelta, 1);
+  delta_frame->SetTimestamp(180);
+  delta_frame->num_references = 1;
+  delta_frame->references[0] = 0;
+  video_receive_stream_->OnCompleteFrame(std::move(delta_frame));
+
+  EXPECT_TRUE(recorded.Wait(kDefaultTimeOutMs));
+  video_receive_stream_->Stop();
+  EXPECT_EQ(fake_renderer_.num_rendered_frames(), 0);
+}
+
 class VideoReceiveStream2TestWithSimulatedClock : public ::testing::Test {
  public:
   class FakeDecoder2 : public test::FakeDecoder {
@@ -80,7 +80,8 @@ VideoSendStream::VideoSendStream(
     VideoEncoderConfig encoder_config,
     const std::map<uint32_t, RtpState>& suspended_ssrcs,
     const std::map<uint32_t, RtpPayloadState>& suspended_payload_states,
-    std::unique_ptr<FecController> fec_controller)
+    std::unique_ptr<FecController> fec_controller,
+    TaskQueueFactory* encoder_queue_factory)
     : worker_queue_(transport->GetWorkerQueue()),
       stats_proxy_(clock, config, encoder_config.content_type),
       config_(std::move(config)),
@@ -88,9 +89,9 @@ VideoSendStream::VideoSendStream(
   RTC_DCHECK(config_.encoder_settings.encoder_factory);
   RTC_DCHECK(config_.encoder_settings.bitrate_allocator_factory);
 
-  video_stream_encoder_ =
-      CreateVideoStreamEncoder(clock, task_queue_factory, num_cpu_cores,
-                               &stats_proxy_, config_.encoder_settings);
+  video_stream_encoder_ = CreateVideoStreamEncoder(
+      clock, task_queue_factory, num_cpu_cores, &stats_proxy_,
+      config_.encoder_settings, encoder_queue_factory);
   // TODO(srte): Initialization should not be done posted on a task queue.
   // Note that the posted task must not outlive this scope since the closure
   // references local variables.
@@ -186,6 +187,22 @@ void VideoSendStream::SetSource(
   video_stream_encoder_->SetSource(source, degradation_preference);
 }
 
+void VideoSendStream::SetEncodedFrameSource(EncodedFrameSource* source) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  VideoSendStreamImpl* send_stream = send_stream_.get();
+  worker_queue_->PostTask([this, send_stream, source] {
+    send_stream->SetEncodedFrameSource(source);
+    thread_sync_event_.Set();
+  });
+
+  // |source| must not be called once unset.
+  thread_sync_event_.Wait(rtc::Event::kForever);
+}
+
+void VideoSendStream::SendEncodedFrame(const RecordableEncodedFrame& frame) {
+  send_stream_->SendEncodedFrame(frame);
+}
+
 void VideoSendStream::ReconfigureVideoEncoder(VideoEncoderConfig config) {
   // TODO(perkj): Some test cases in VideoSendStreamTest call
   // ReconfigureVideoEncoder from the network thread.
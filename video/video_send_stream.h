@@ -67,7 +67,8 @@ class VideoSendStream : public webrtc::VideoSendStream {
       VideoEncoderConfig encoder_config,
       const std::map<uint32_t, RtpState>& suspended_ssrcs,
       const std::map<uint32_t, RtpPayloadState>& suspended_payload_states,
-      std::unique_ptr<FecController> fec_controller);
+      std::unique_ptr<FecController> fec_controller,
+      TaskQueueFactory* encoder_queue_factory = nullptr);
 
   ~VideoSendStream() override;
 
@@ -81,6 +82,8 @@ class VideoSendStream : public webrtc::VideoSendStream {
 
   void SetSource(rtc::VideoSourceInterface<webrtc::VideoFrame>* source,
                  const DegradationPreference& degradation_preference) override;
+  void SetEncodedFrameSource(EncodedFrameSource* source) override;
+  void SendEncodedFrame(const RecordableEncodedFrame& frame) override;
 
   void ReconfigureVideoEncoder(VideoEncoderConfig) override;
   Stats GetStats() override;
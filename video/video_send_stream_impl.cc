@@ -23,7 +23,9 @@
 #include "api/video_codecs/video_codec.h"
 #include "call/rtp_transport_controller_send_interface.h"
 #include "call/video_send_stream.h"
+#include "common_video/h264/h264_common.h"
 #include "modules/pacing/paced_sender.h"
+#include "modules/video_coding/codecs/interface/common_constants.h"
 #include "rtc_base/atomic_ops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/experiments/alr_experiment.h"
@@ -139,6 +141,12 @@ RtpSenderObservers CreateObservers(RtcpRttStats* call_stats,
   observers.rtcp_type_observer = stats_proxy;
   observers.send_delay_observer = stats_proxy;
   observers.send_packet_observer = send_delay_stats;
+  // Lets the receiver, typically an SFU, pause the layers it does not forward
+  // by requesting no bitrate for them in an RTCP XR target bitrate report.
+  observers.requested_bitrate_allocation_observer =
+      field_trial::IsEnabled("WebRTC-Video-PauseUnrequestedLayers")
+          ? encoder_feedback
+          : nullptr;
   return observers;
 }
 
@@ -163,6 +171,66 @@ bool SameStreamsEnabled(const VideoBitrateAllocation& lhs,
   }
   return true;
 }
+
+// Describes |encoded_image| of |codec|, which was encoded elsewhere, as its
+// encoder would if it had a single spatial and temporal layer.
+void PopulateEncodedFrameInfo(const EncodedImage& encoded_image,
+                              VideoCodecType codec,
+                              CodecSpecificInfo* codec_specific_info,
+                              RTPFragmentationHeader* fragmentation) {
+  const bool is_key_frame =
+      encoded_image._frameType == VideoFrameType::kVideoFrameKey;
+  codec_specific_info->codecType = codec;
+  switch (codec) {
+    case kVideoCodecVP8: {
+      CodecSpecificInfoVP8& vp8 = codec_specific_info->codecSpecific.VP8;
+      vp8.nonReference = false;
+      vp8.temporalIdx = kNoTemporalIdx;
+      vp8.layerSync = false;
+      vp8.keyIdx = kNoKeyIdx;
+      break;
+    }
+    case kVideoCodecVP9: {
+      CodecSpecificInfoVP9& vp9 = codec_specific_info->codecSpecific.VP9;
+      vp9.first_frame_in_picture = true;
+      vp9.inter_pic_predicted = !is_key_frame;
+      vp9.flexible_mode = false;
+      vp9.ss_data_available = is_key_frame;
+      vp9.non_ref_for_inter_layer_pred = true;
+      vp9.temporal_idx = kNoTemporalIdx;
+      vp9.temporal_up_switch = false;
+      vp9.inter_layer_predicted = false;
+      vp9.gof_idx = 0;
+      vp9.num_spatial_layers = 1;
+      vp9.first_active_layer = 0;
+      vp9.spatial_layer_resolution_present = is_key_frame;
+      vp9.width[0] = encoded_image._encodedWidth;
+      vp9.height[0] = encoded_image._encodedHeight;
+      vp9.gof.SetGofInfoVP9(kTemporalStructureMode1);
+      vp9.num_ref_pics = 0;
+      vp9.end_of_picture = true;
+      break;
+    }
+    case kVideoCodecH264: {
+      CodecSpecificInfoH264& h264 = codec_specific_info->codecSpecific.H264;
+      h264.packetization_mode = H264PacketizationMode::NonInterleaved;
+      h264.temporal_idx = kNoTemporalIdx;
+      h264.base_layer_sync = false;
+      h264.idr_frame = is_key_frame;
+      // The packetizer needs the NAL units, which the encoder would report.
+      std::vector<H264::NaluIndex> nalus =
+          H264::FindNaluIndices(encoded_image.data(), encoded_image.size());
+      fragmentation->VerifyAndAllocateFragmentationHeader(nalus.size());
+      for (size_t i = 0; i < nalus.size(); ++i) {
+        fragmentation->fragmentationOffset[i] = nalus[i].payload_start_offset;
+        fragmentation->fragmentationLength[i] = nalus[i].payload_size;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
 }  // namespace
 
 PacingConfig::PacingConfig()
@@ -198,6 +266,7 @@ VideoSendStreamImpl::VideoSendStreamImpl(
       pacing_config_(PacingConfig()),
       stats_proxy_(stats_proxy),
       config_(config),
+      content_type_(content_type),
       worker_queue_(worker_queue),
       timed_out_(false),
       transport_(transport),
@@ -210,6 +279,9 @@ VideoSendStreamImpl::VideoSendStreamImpl(
       has_packet_feedback_(false),
       video_stream_encoder_(video_stream_encoder),
       encoder_feedback_(clock, config_->rtp.ssrcs, video_stream_encoder),
+      encoded_frame_source_(nullptr),
+      sending_encoded_frames_(false),
+      encoded_frame_resolution_({0, 0}),
       bandwidth_observer_(transport->GetBandwidthObserver()),
       rtp_video_sender_(
           transport_->CreateRtpVideoSender(suspended_ssrcs,
@@ -378,7 +450,11 @@ void VideoSendStreamImpl::StartupVideoSendStream() {
         });
   }
 
-  video_stream_encoder_->SendKeyFrame();
+  if (encoded_frame_source_) {
+    encoded_frame_source_->OnKeyFrameRequested();
+  } else {
+    video_stream_encoder_->SendKeyFrame();
+  }
 }
 
 void VideoSendStreamImpl::Stop() {
@@ -396,9 +472,82 @@ void VideoSendStreamImpl::StopVideoSendStream() {
   check_encoder_activity_task_.Stop();
   video_stream_encoder_->OnBitrateUpdated(DataRate::Zero(), DataRate::Zero(),
                                           DataRate::Zero(), 0, 0, 0);
+  if (encoded_frame_source_)
+    encoded_frame_source_->OnTargetBitrateChanged(DataRate::Zero());
   stats_proxy_->OnSetEncoderTargetRate(0);
 }
 
+void VideoSendStreamImpl::SetEncodedFrameSource(
+    VideoSendStream::EncodedFrameSource* source) {
+  RTC_DCHECK_RUN_ON(worker_queue_);
+  encoded_frame_source_ = source;
+  encoder_feedback_.SetEncodedFrameSource(source);
+  {
+    // The next key frame configures the stream for its resolution.
+    rtc::CritScope lock(&encoded_frame_crit_);
+    encoded_frame_resolution_ = {0, 0};
+  }
+  sending_encoded_frames_ = source != nullptr;
+  if (!source || !rtp_video_sender_->IsActive())
+    return;
+  // Receivers can only decode the frames of |source| from a key frame.
+  source->OnKeyFrameRequested();
+  source->OnTargetBitrateChanged(
+      DataRate::BitsPerSec(encoder_target_rate_bps_));
+}
+
+void VideoSendStreamImpl::SendEncodedFrame(
+    const RecordableEncodedFrame& frame) {
+  if (!sending_encoded_frames_)
+    return;
+
+  const RecordableEncodedFrame::EncodedResolution resolution =
+      frame.resolution();
+  if (frame.is_key_frame() && resolution.width > 0 && resolution.height > 0) {
+    bool resolution_changed;
+    {
+      rtc::CritScope lock(&encoded_frame_crit_);
+      resolution_changed =
+          resolution.width != encoded_frame_resolution_.width ||
+          resolution.height != encoded_frame_resolution_.height;
+      encoded_frame_resolution_ = resolution;
+    }
+    if (resolution_changed) {
+      rtc::WeakPtr<VideoSendStreamImpl> send_stream = weak_ptr_;
+      worker_queue_->PostTask([send_stream, resolution] {
+        if (send_stream) {
+          RTC_DCHECK_RUN_ON(send_stream->worker_queue_);
+          send_stream->ConfigureEncodedFrameStream(resolution.width,
+                                                   resolution.height);
+        }
+      });
+    }
+  }
+
+  rtc::scoped_refptr<const EncodedImageBufferInterface> buffer =
+      frame.encoded_buffer();
+  EncodedImage encoded_image;
+  encoded_image.SetEncodedData(
+      EncodedImageBuffer::Create(buffer->data(), buffer->size()));
+  encoded_image._frameType = frame.is_key_frame()
+                                 ? VideoFrameType::kVideoFrameKey
+                                 : VideoFrameType::kVideoFrameDelta;
+  encoded_image._encodedWidth = resolution.width;
+  encoded_image._encodedHeight = resolution.height;
+  encoded_image.capture_time_ms_ = frame.render_time().ms();
+  encoded_image.SetTimestamp(
+      static_cast<uint32_t>(frame.render_time().ms() *
+                            (kVideoPayloadTypeFrequency / 1000)));
+  encoded_image.SetColorSpace(frame.color_space());
+
+  CodecSpecificInfo codec_specific_info;
+  RTPFragmentationHeader fragmentation;
+  PopulateEncodedFrameInfo(encoded_image, frame.codec(), &codec_specific_info,
+                           &fragmentation);
+  SendEncodedImage(encoded_image, &codec_specific_info,
+                   frame.codec() == kVideoCodecH264 ? &fragmentation : nullptr);
+}
+
 void VideoSendStreamImpl::SignalEncoderTimedOut() {
   RTC_DCHECK_RUN_ON(worker_queue_);
   // If the encoder has not produced anything the last kEncoderTimeOut and it
@@ -547,10 +696,36 @@ void VideoSendStreamImpl::OnEncoderConfigurationChanged(
   }
 }
 
+void VideoSendStreamImpl::ConfigureEncodedFrameStream(size_t width,
+                                                      size_t height) {
+  VideoStream stream;
+  stream.width = width;
+  stream.height = height;
+  stream.min_bitrate_bps = kDefaultMinVideoBitrateBps;
+  stream.target_bitrate_bps = encoder_max_bitrate_bps_;
+  stream.max_bitrate_bps = encoder_max_bitrate_bps_;
+  stream.num_temporal_layers = 1;
+  stream.bitrate_priority = encoder_bitrate_priority_;
+  stream.active = true;
+  OnEncoderConfigurationChanged({stream}, /*is_svc=*/false, content_type_,
+                                /*min_transmit_bitrate_bps=*/0);
+}
+
 EncodedImageCallback::Result VideoSendStreamImpl::OnEncodedImage(
     const EncodedImage& encoded_image,
     const CodecSpecificInfo* codec_specific_info,
     const RTPFragmentationHeader* fragmentation) {
+  // The encoder's frames are not sent while those of an encoded frame source
+  // are.
+  if (sending_encoded_frames_)
+    return Result(Result::OK);
+  return SendEncodedImage(encoded_image, codec_specific_info, fragmentation);
+}
+
+EncodedImageCallback::Result VideoSendStreamImpl::SendEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const RTPFragmentationHeader* fragmentation) {
   // Encoded is called on whatever thread the real encoder implementation run
   // on. In the case of hardware encoders, there might be several encoders
   // running in parallel on different threads.
@@ -652,6 +827,8 @@ uint32_t VideoSendStreamImpl::OnBitrateUpdated(BitrateAllocationUpdate update) {
       encoder_target_rate, encoder_stable_target_rate, link_allocation,
       rtc::dchecked_cast<uint8_t>(update.packet_loss_ratio * 256),
       update.round_trip_time.ms(), update.cwnd_reduce_ratio);
+  if (encoded_frame_source_)
+    encoded_frame_source_->OnTargetBitrateChanged(encoder_target_rate);
   stats_proxy_->OnSetEncoderTargetRate(encoder_target_rate_bps_);
   return protection_bitrate_bps;
 }
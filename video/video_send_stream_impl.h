@@ -22,6 +22,7 @@
 #include "api/fec_controller.h"
 #include "api/rtc_event_log/rtc_event_log.h"
 #include "api/video/encoded_image.h"
+#include "api/video/recordable_encoded_frame.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "api/video/video_bitrate_allocator.h"
 #include "api/video/video_stream_encoder_interface.h"
@@ -102,6 +103,10 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
   void Start();
   void Stop();
 
+  void SetEncodedFrameSource(VideoSendStream::EncodedFrameSource* source);
+  // May be called on any thread.
+  void SendEncodedFrame(const RecordableEncodedFrame& frame);
+
   // TODO(holmer): Move these to RtpTransportControllerSend.
   std::map<uint32_t, RtpState> GetRtpStates() const;
 
@@ -130,6 +135,17 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
   // Implements EncodedImageCallback.
   void OnDroppedFrame(EncodedImageCallback::DropReason reason) override;
 
+  // Routes |encoded_image| to the |rtp_video_sender_|, from the encoder or
+  // SendEncodedFrame.
+  EncodedImageCallback::Result SendEncodedImage(
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation);
+  // Configures a single stream of |width| x |height| for the frames of the
+  // encoded frame source.
+  void ConfigureEncodedFrameStream(size_t width, size_t height)
+      RTC_RUN_ON(worker_queue_);
+
   // Implements VideoBitrateAllocationObserver.
   void OnBitrateAllocationUpdated(
       const VideoBitrateAllocation& allocation) override;
@@ -152,6 +168,7 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
 
   SendStatisticsProxy* const stats_proxy_;
   const VideoSendStream::Config* const config_;
+  const VideoEncoderConfig::ContentType content_type_;
 
   rtc::TaskQueue* const worker_queue_;
 
@@ -177,6 +194,15 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
   VideoStreamEncoderInterface* const video_stream_encoder_;
   EncoderRtcpFeedback encoder_feedback_;
 
+  VideoSendStream::EncodedFrameSource* encoded_frame_source_
+      RTC_GUARDED_BY(worker_queue_);
+  // Whether frames are sent from SendEncodedFrame instead of the encoder.
+  std::atomic<bool> sending_encoded_frames_;
+  rtc::CriticalSection encoded_frame_crit_;
+  // The resolution of the last key frame from SendEncodedFrame.
+  RecordableEncodedFrame::EncodedResolution encoded_frame_resolution_
+      RTC_GUARDED_BY(encoded_frame_crit_);
+
   RtcpBandwidthObserver* const bandwidth_observer_;
   RtpVideoSenderInterface* const rtp_video_sender_;
 
@@ -95,10 +95,42 @@ class MockRtpVideoSender : public RtpVideoSenderInterface {
               GetSentRtpPacketInfos,
               (uint32_t ssrc, rtc::ArrayView<const uint16_t> sequence_numbers),
               (const, override));
+  MOCK_METHOD(bool, SendCachedKeyFrame, (uint32_t ssrc), (override));
 
   MOCK_METHOD(void, SetFecAllowed, (bool fec_allowed), (override));
 };
 
+class MockEncodedFrameSource : public VideoSendStream::EncodedFrameSource {
+ public:
+  MOCK_METHOD(void, OnTargetBitrateChanged, (DataRate), (override));
+  MOCK_METHOD(void, OnKeyFrameRequested, (), (override));
+};
+
+class FakeRecordableEncodedFrame : public RecordableEncodedFrame {
+ public:
+  FakeRecordableEncodedFrame(bool is_key_frame, unsigned width, unsigned height)
+      : buffer_(EncodedImageBuffer::Create(100)),
+        is_key_frame_(is_key_frame),
+        resolution_{width, height} {}
+
+  rtc::scoped_refptr<const EncodedImageBufferInterface> encoded_buffer()
+      const override {
+    return buffer_;
+  }
+  absl::optional<ColorSpace> color_space() const override {
+    return absl::nullopt;
+  }
+  VideoCodecType codec() const override { return kVideoCodecVP8; }
+  bool is_key_frame() const override { return is_key_frame_; }
+  EncodedResolution resolution() const override { return resolution_; }
+  Timestamp render_time() const override { return Timestamp::Millis(1000); }
+
+ private:
+  const rtc::scoped_refptr<EncodedImageBuffer> buffer_;
+  const bool is_key_frame_;
+  const EncodedResolution resolution_;
+};
+
 BitrateAllocationUpdate CreateAllocation(int bitrate_bps) {
   BitrateAllocationUpdate update;
   update.target_bitrate = DataRate::BitsPerSec(bitrate_bps);
@@ -1014,5 +1046,62 @@ TEST_F(VideoSendStreamImplTest, ConfiguresBitratesForSvcNoAlr) {
       },
       RTC_FROM_HERE);
 }
+
+TEST_F(VideoSendStreamImplTest, SendsFramesOfEncodedFrameSource) {
+  MockEncodedFrameSource source;
+  std::unique_ptr<VideoSendStreamImpl> vss_impl;
+  test_queue_.SendTask(
+      [&] {
+        vss_impl = CreateVideoSendStreamImpl(
+            kDefaultInitialBitrateBps, kDefaultBitratePriority,
+            VideoEncoderConfig::ContentType::kRealtimeVideo);
+        vss_impl->Start();
+        EXPECT_CALL(source, OnKeyFrameRequested());
+        EXPECT_CALL(source, OnTargetBitrateChanged(DataRate::Zero()));
+        vss_impl->SetEncodedFrameSource(&source);
+
+        EXPECT_CALL(rtp_video_sender_,
+                    OnEncodedImage(
+                        ::testing::Field(&EncodedImage::_frameType,
+                                         VideoFrameType::kVideoFrameKey),
+                        ::testing::Field(&CodecSpecificInfo::codecType,
+                                         kVideoCodecVP8),
+                        nullptr))
+            .WillOnce(Return(EncodedImageCallback::Result(
+                EncodedImageCallback::Result::OK)));
+        vss_impl->SendEncodedFrame(FakeRecordableEncodedFrame(true, 640, 360));
+
+        // The output of the encoder is not sent meanwhile.
+        EncodedImage encoded_image;
+        CodecSpecificInfo codec_specific;
+        static_cast<EncodedImageCallback*>(vss_impl.get())
+            ->OnEncodedImage(encoded_image, &codec_specific, nullptr);
+
+        // The stream is configured for the resolution of the key frame.
+        EXPECT_CALL(rtp_video_sender_, SetEncodingData(640, 360, 1));
+      },
+      RTC_FROM_HERE);
+
+  test_queue_.SendTask(
+      [&] {
+        const uint32_t kBitrateBps = 100000;
+        EXPECT_CALL(rtp_video_sender_, GetPayloadBitrateBps())
+            .WillOnce(Return(kBitrateBps));
+        EXPECT_CALL(source, OnTargetBitrateChanged(
+                                DataRate::BitsPerSec(kBitrateBps)));
+        static_cast<BitrateAllocatorObserver*>(vss_impl.get())
+            ->OnBitrateUpdated(CreateAllocation(kBitrateBps));
+
+        EXPECT_CALL(source, OnTargetBitrateChanged(DataRate::Zero()));
+        vss_impl->Stop();
+        vss_impl->SetEncodedFrameSource(nullptr);
+
+        // Frames are not sent without a source.
+        vss_impl->SendEncodedFrame(FakeRecordableEncodedFrame(true, 640, 360));
+        vss_impl.reset();
+      },
+      RTC_FROM_HERE);
+}
+
 }  // namespace internal
 }  // namespace webrtc
@@ -30,6 +30,7 @@
 #include "modules/video_coding/include/video_codec_initializer.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/cpu_accounting.h"
 #include "rtc_base/experiments/alr_experiment.h"
 #include "rtc_base/experiments/rate_control_settings.h"
 #include "rtc_base/location.h"
@@ -172,6 +173,28 @@ VideoBitrateAllocation UpdateAllocationFromEncoderInfo(
   return new_allocation;
 }
 
+// Removes the spatial layers set in |paused_layers| from the allocation.
+// Returns |allocation| unchanged if no bitrate would be left, as that stops
+// the encoder altogether rather than pausing some of the layers.
+VideoBitrateAllocation RemovePausedLayers(
+    const VideoBitrateAllocation& allocation,
+    const std::vector<bool>& paused_layers) {
+  VideoBitrateAllocation new_allocation;
+  for (size_t si = 0; si < kMaxSpatialLayers; ++si) {
+    if (si < paused_layers.size() && paused_layers[si])
+      continue;
+    for (size_t ti = 0; ti < kMaxTemporalStreams; ++ti) {
+      if (allocation.HasBitrate(si, ti))
+        new_allocation.SetBitrate(si, ti, allocation.GetBitrate(si, ti));
+    }
+  }
+  if (new_allocation.get_sum_bps() == 0) {
+    return allocation;
+  }
+  new_allocation.set_bw_limited(allocation.is_bw_limited());
+  return new_allocation;
+}
+
 }  //  namespace
 
 VideoStreamEncoder::EncoderRateSettings::EncoderRateSettings()
@@ -207,7 +230,8 @@ VideoStreamEncoder::VideoStreamEncoder(
     VideoStreamEncoderObserver* encoder_stats_observer,
     const VideoStreamEncoderSettings& settings,
     std::unique_ptr<OveruseFrameDetector> overuse_detector,
-    TaskQueueFactory* task_queue_factory)
+    TaskQueueFactory* task_queue_factory,
+    TaskQueueFactory* encoder_queue_factory)
     : shutdown_event_(true /* manual_reset */, false),
       number_of_cores_(number_of_cores),
       quality_scaling_experiment_enabled_(QualityScalingExperiment::Enabled()),
@@ -272,9 +296,10 @@ VideoStreamEncoder::VideoStreamEncoder(
       resource_adaptation_queue_(task_queue_factory->CreateTaskQueue(
           "ResourceAdaptationQueue",
           TaskQueueFactory::Priority::NORMAL)),
-      encoder_queue_(task_queue_factory->CreateTaskQueue(
-          "EncoderQueue",
-          TaskQueueFactory::Priority::NORMAL)) {
+      encoder_queue_(
+          (encoder_queue_factory ? encoder_queue_factory : task_queue_factory)
+              ->CreateTaskQueue("EncoderQueue",
+                                TaskQueueFactory::Priority::NORMAL)) {
   RTC_DCHECK(encoder_stats_observer);
   RTC_DCHECK_GE(number_of_cores, 1);
 
@@ -353,6 +378,23 @@ void VideoStreamEncoder::Stop() {
   shutdown_event_.Wait(rtc::Event::kForever);
 }
 
+void VideoStreamEncoder::SetPausedLayers(std::vector<bool> paused_layers) {
+  encoder_queue_.PostTask(
+      [this, paused_layers = std::move(paused_layers)]() mutable {
+        RTC_DCHECK_RUN_ON(&encoder_queue_);
+        if (paused_layers == paused_layers_)
+          return;
+        paused_layers_ = std::move(paused_layers);
+        if (last_encoder_rate_settings_) {
+          // Clone rate settings before update, so that SetEncoderRates()
+          // detects the change in allocation.
+          EncoderRateSettings new_rate_settings = *last_encoder_rate_settings_;
+          SetEncoderRates(
+              UpdateBitrateAllocationAndNotifyObserver(new_rate_settings));
+        }
+      });
+}
+
 void VideoStreamEncoder::SetBitrateAllocationObserver(
     VideoBitrateAllocationObserver* bitrate_observer) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
@@ -890,6 +932,8 @@ void VideoStreamEncoder::OnFrame(const VideoFrame& video_frame) {
   encoder_queue_.PostTask(
       [this, incoming_frame, post_time_us, log_stats]() {
         RTC_DCHECK_RUN_ON(&encoder_queue_);
+        encoder_stats_observer_->OnEncoderQueueDelayMeasured(rtc::TimeMicros() -
+                                                             post_time_us);
         encoder_stats_observer_->OnIncomingFrame(incoming_frame.width(),
                                                  incoming_frame.height());
         ++captured_frame_count_;
@@ -978,6 +1022,8 @@ VideoStreamEncoder::UpdateBitrateAllocationAndNotifyObserver(
     new_allocation = rate_allocator_->Allocate(VideoBitrateAllocationParameters(
         rate_settings.encoder_target, rate_settings.stable_encoder_target,
         rate_settings.rate_control.framerate_fps));
+    if (!paused_layers_.empty())
+      new_allocation = RemovePausedLayers(new_allocation, paused_layers_);
   }
 
   if (bitrate_observer_ && new_allocation.get_sum_bps() > 0) {
@@ -1238,65 +1284,33 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 
   VideoFrame out_frame(video_frame);
 
-  const VideoFrameBuffer::Type buffer_type =
-      out_frame.video_frame_buffer()->type();
-  const bool is_buffer_type_supported =
-      buffer_type == VideoFrameBuffer::Type::kI420 ||
-      (buffer_type == VideoFrameBuffer::Type::kNative &&
-       info.supports_native_handle);
-
-  if (!is_buffer_type_supported) {
-    // This module only supports software encoding.
-    rtc::scoped_refptr<I420BufferInterface> converted_buffer(
-        out_frame.video_frame_buffer()->ToI420());
-
-    if (!converted_buffer) {
-      RTC_LOG(LS_ERROR) << "Frame conversion failed, dropping frame.";
-      return;
-    }
-
-    VideoFrame::UpdateRect update_rect = out_frame.update_rect();
-    if (!update_rect.IsEmpty() &&
-        out_frame.video_frame_buffer()->GetI420() == nullptr) {
-      // UpdatedRect is reset to full update if it's not empty, and buffer was
-      // converted, therefore we can't guarantee that pixels outside of
-      // UpdateRect didn't change comparing to the previous frame.
-      update_rect =
-          VideoFrame::UpdateRect{0, 0, out_frame.width(), out_frame.height()};
-    }
-
-    out_frame.set_video_frame_buffer(converted_buffer);
-    out_frame.set_update_rect(update_rect);
-  }
+  const bool is_native_buffer_supported =
+      out_frame.video_frame_buffer()->type() ==
+          VideoFrameBuffer::Type::kNative &&
+      info.supports_native_handle;
 
-  // Crop frame if needed.
-  if ((crop_width_ > 0 || crop_height_ > 0) &&
-      out_frame.video_frame_buffer()->type() !=
-          VideoFrameBuffer::Type::kNative) {
-    // If the frame can't be converted to I420, drop it.
-    auto i420_buffer = video_frame.video_frame_buffer()->ToI420();
-    if (!i420_buffer) {
-      RTC_LOG(LS_ERROR) << "Frame conversion for crop failed, dropping frame.";
-      return;
-    }
+  // Crop frame if needed. This is done before any I420 conversion, so that
+  // native buffers that implement CropAndScale() only have the cropped area
+  // converted. Native frames are left to the encoder if it supports them.
+  if ((crop_width_ > 0 || crop_height_ > 0) && !is_native_buffer_supported) {
     int cropped_width = video_frame.width() - crop_width_;
     int cropped_height = video_frame.height() - crop_height_;
-    rtc::scoped_refptr<I420Buffer> cropped_buffer =
-        I420Buffer::Create(cropped_width, cropped_height);
+    rtc::scoped_refptr<VideoFrameBuffer> cropped_buffer;
     // TODO(ilnik): Remove scaling if cropping is too big, as it should never
     // happen after SinkWants signaled correctly from ReconfigureEncoder.
     VideoFrame::UpdateRect update_rect = video_frame.update_rect();
     if (crop_width_ < 4 && crop_height_ < 4) {
-      cropped_buffer->CropAndScaleFrom(*i420_buffer, crop_width_ / 2,
-                                       crop_height_ / 2, cropped_width,
-                                       cropped_height);
+      cropped_buffer = video_frame.video_frame_buffer()->CropAndScale(
+          crop_width_ / 2, crop_height_ / 2, cropped_width, cropped_height,
+          cropped_width, cropped_height);
       update_rect.offset_x -= crop_width_ / 2;
       update_rect.offset_y -= crop_height_ / 2;
       update_rect.Intersect(
           VideoFrame::UpdateRect{0, 0, cropped_width, cropped_height});
 
     } else {
-      cropped_buffer->ScaleFrom(*i420_buffer);
+      cropped_buffer = video_frame.video_frame_buffer()->Scale(cropped_width,
+                                                               cropped_height);
       if (!update_rect.IsEmpty()) {
         // Since we can't reason about pixels after scaling, we invalidate whole
         // picture, if anything changed.
@@ -1304,6 +1318,10 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
             VideoFrame::UpdateRect{0, 0, cropped_width, cropped_height};
       }
     }
+    if (!cropped_buffer) {
+      RTC_LOG(LS_ERROR) << "Frame conversion for crop failed, dropping frame.";
+      return;
+    }
     out_frame.set_video_frame_buffer(cropped_buffer);
     out_frame.set_update_rect(update_rect);
     out_frame.set_ntp_time_ms(video_frame.ntp_time_ms());
@@ -1317,6 +1335,37 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
     }
   }
 
+  const VideoFrameBuffer::Type buffer_type =
+      out_frame.video_frame_buffer()->type();
+  const bool is_buffer_type_supported =
+      absl::c_linear_search(info.preferred_pixel_formats, buffer_type) ||
+      (buffer_type == VideoFrameBuffer::Type::kNative &&
+       info.supports_native_handle);
+
+  if (!is_buffer_type_supported) {
+    // This module only supports software encoding.
+    rtc::scoped_refptr<I420BufferInterface> converted_buffer(
+        out_frame.video_frame_buffer()->ToI420());
+
+    if (!converted_buffer) {
+      RTC_LOG(LS_ERROR) << "Frame conversion failed, dropping frame.";
+      return;
+    }
+
+    VideoFrame::UpdateRect update_rect = out_frame.update_rect();
+    if (!update_rect.IsEmpty() &&
+        out_frame.video_frame_buffer()->GetI420() == nullptr) {
+      // UpdatedRect is reset to full update if it's not empty, and buffer was
+      // converted, therefore we can't guarantee that pixels outside of
+      // UpdateRect didn't change comparing to the previous frame.
+      update_rect =
+          VideoFrame::UpdateRect{0, 0, out_frame.width(), out_frame.height()};
+    }
+
+    out_frame.set_video_frame_buffer(converted_buffer);
+    out_frame.set_update_rect(update_rect);
+  }
+
   if (!accumulated_update_rect_is_valid_) {
     out_frame.clear_update_rect();
   } else if (!accumulated_update_rect_.IsEmpty() &&
@@ -1348,7 +1397,11 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 
   frame_encode_metadata_writer_.OnEncodeStarted(out_frame);
 
-  const int32_t encode_status = encoder_->Encode(out_frame, &next_frame_types_);
+  int32_t encode_status;
+  {
+    rtc::ScopedCpuAccounting cpu_accounting(rtc::CpuSubsystem::kEncoder);
+    encode_status = encoder_->Encode(out_frame, &next_frame_types_);
+  }
   was_encode_called_since_last_initialization_ = true;
 
   if (encode_status < 0) {
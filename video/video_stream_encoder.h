@@ -67,7 +67,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
                      VideoStreamEncoderObserver* encoder_stats_observer,
                      const VideoStreamEncoderSettings& settings,
                      std::unique_ptr<OveruseFrameDetector> overuse_detector,
-                     TaskQueueFactory* task_queue_factory);
+                     TaskQueueFactory* task_queue_factory,
+                     TaskQueueFactory* encoder_queue_factory = nullptr);
   ~VideoStreamEncoder() override;
 
   void SetSource(rtc::VideoSourceInterface<VideoFrame>* source,
@@ -78,6 +79,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   // TODO(perkj): Can we remove VideoCodec.startBitrate ?
   void SetStartBitrate(int start_bitrate_bps) override;
 
+  void SetPausedLayers(std::vector<bool> paused_layers) override;
+
   void SetBitrateAllocationObserver(
       VideoBitrateAllocationObserver* bitrate_observer) override;
 
@@ -256,6 +259,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   size_t max_data_payload_length_ RTC_GUARDED_BY(&encoder_queue_);
   absl::optional<EncoderRateSettings> last_encoder_rate_settings_
       RTC_GUARDED_BY(&encoder_queue_);
+  // Layers that get no bitrate, see SetPausedLayers().
+  std::vector<bool> paused_layers_ RTC_GUARDED_BY(&encoder_queue_);
   bool encoder_paused_and_dropped_frame_ RTC_GUARDED_BY(&encoder_queue_);
 
   // Set to true if at least one frame was sent to encoder since last encoder
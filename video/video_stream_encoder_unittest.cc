@@ -55,6 +55,7 @@ namespace webrtc {
 
 using ::testing::_;
 using ::testing::AllOf;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::Field;
 using ::testing::Ge;
@@ -129,6 +130,42 @@ class FakeNativeBuffer : public webrtc::VideoFrameBuffer {
   const int height_;
 };
 
+// A native buffer that crops and scales without converting, and records the
+// resolutions it is converted to I420 at.
+class FakeScalableNativeBuffer : public webrtc::VideoFrameBuffer {
+ public:
+  FakeScalableNativeBuffer(std::vector<int>* converted_widths,
+                           int width,
+                           int height)
+      : converted_widths_(converted_widths), width_(width), height_(height) {}
+  webrtc::VideoFrameBuffer::Type type() const override { return Type::kNative; }
+  int width() const override { return width_; }
+  int height() const override { return height_; }
+  rtc::scoped_refptr<webrtc::I420BufferInterface> ToI420() override {
+    converted_widths_->push_back(width_);
+    rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width_, height_);
+    I420Buffer::SetBlack(buffer);
+    return buffer;
+  }
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> CropAndScale(
+      int offset_x,
+      int offset_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height) override {
+    return new rtc::RefCountedObject<FakeScalableNativeBuffer>(
+        converted_widths_, scaled_width, scaled_height);
+  }
+
+ private:
+  friend class rtc::RefCountedObject<FakeScalableNativeBuffer>;
+  ~FakeScalableNativeBuffer() override = default;
+  std::vector<int>* const converted_widths_;
+  const int width_;
+  const int height_;
+};
+
 class CpuOveruseDetectorProxy : public OveruseFrameDetector {
  public:
   explicit CpuOveruseDetectorProxy(CpuOveruseMetricsObserver* metrics_observer)
@@ -1457,6 +1494,40 @@ TEST_F(VideoStreamEncoderTest, DropFrameWithFailedI420ConversionWithCrop) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, CropsNativeFrameBeforeI420Conversion) {
+  // Use the cropping factory.
+  video_encoder_config_.video_stream_factory =
+      new rtc::RefCountedObject<CroppingVideoStreamFactory>(1, 30);
+  video_stream_encoder_->ConfigureEncoder(std::move(video_encoder_config_),
+                                          kMaxPayloadLength);
+  video_stream_encoder_->WaitUntilTaskQueueIsIdle();
+
+  video_stream_encoder_->OnBitrateUpdatedAndWaitForManagedResources(
+      DataRate::BitsPerSec(kTargetBitrateBps),
+      DataRate::BitsPerSec(kTargetBitrateBps),
+      DataRate::BitsPerSec(kTargetBitrateBps), 0, 0, 0);
+  video_source_.IncomingCapturedFrame(CreateFrame(1, nullptr));
+  WaitForEncodedFrame(1);
+
+  // Send in a native frame that needs to be cropped. The encoder doesn't
+  // support native frames, so only the cropped buffer is converted.
+  std::vector<int> converted_widths;
+  VideoFrame frame =
+      VideoFrame::Builder()
+          .set_video_frame_buffer(
+              new rtc::RefCountedObject<FakeScalableNativeBuffer>(
+                  &converted_widths, codec_width_ + 1, codec_height_ + 1))
+          .set_timestamp_rtp(99)
+          .set_timestamp_ms(99)
+          .set_rotation(kVideoRotation_0)
+          .build();
+  frame.set_ntp_time_ms(2);
+  video_source_.IncomingCapturedFrame(frame);
+  WaitForEncodedFrame(2);
+  EXPECT_THAT(converted_widths, ElementsAre(codec_width_));
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, DropsFramesWhenCongestionWindowPushbackSet) {
   video_stream_encoder_->OnBitrateUpdatedAndWaitForManagedResources(
       DataRate::BitsPerSec(kTargetBitrateBps),
@@ -3842,6 +3913,32 @@ TEST_F(VideoStreamEncoderTest, VerifyBitrateAllocationForTwoStreams) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, PausedLayersGetNoBitrate) {
+  ResetEncoder("VP8", 2, /*num_temporal_layers*/ 1, 1, /*screenshare*/ false);
+  video_stream_encoder_->SetPausedLayers({false, true});
+  video_stream_encoder_->OnBitrateUpdatedAndWaitForManagedResources(
+      DataRate::BitsPerSec(kTargetBitrateBps),
+      DataRate::BitsPerSec(kTargetBitrateBps),
+      DataRate::BitsPerSec(kTargetBitrateBps), 0, 0, 0);
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(1, codec_width_, codec_height_));
+  WaitForEncodedFrame(1);
+  VideoBitrateAllocation allocation =
+      fake_encoder_.GetAndResetLastRateControlSettings()->bitrate;
+  EXPECT_GT(allocation.GetSpatialLayerSum(0), 0u);
+  EXPECT_EQ(allocation.GetSpatialLayerSum(1), 0u);
+
+  // Resuming the layer updates the encoder rates right away.
+  video_stream_encoder_->SetPausedLayers({false, false});
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(2, codec_width_, codec_height_));
+  WaitForEncodedFrame(2);
+  allocation = fake_encoder_.GetAndResetLastRateControlSettings()->bitrate;
+  EXPECT_GT(allocation.GetSpatialLayerSum(0), 0u);
+  EXPECT_GT(allocation.GetSpatialLayerSum(1), 0u);
+  video_stream_encoder_->Stop();
+}
+
 TEST_F(VideoStreamEncoderTest, OveruseDetectorUpdatedOnReconfigureAndAdaption) {
   const int kFrameWidth = 1280;
   const int kFrameHeight = 720;